@@ -550,6 +550,26 @@ if (PKG_CONFIG_FOUND)
     BUILD_WARNING ("GNU Triangulation Surface library not found - Gazebo will not have CSG support.")
   endif ()
 
+  ########################################
+  # Find zstd and lz4, for fast log compression
+  pkg_check_modules(zstd libzstd)
+  if (zstd_FOUND)
+    message (STATUS "Looking for zstd - found")
+    set (HAVE_ZSTD TRUE)
+  else ()
+    set (HAVE_ZSTD FALSE)
+    BUILD_WARNING ("zstd not found - log files can't use the zstd encoding.")
+  endif ()
+
+  pkg_check_modules(lz4 liblz4)
+  if (lz4_FOUND)
+    message (STATUS "Looking for lz4 - found")
+    set (HAVE_LZ4 TRUE)
+  else ()
+    set (HAVE_LZ4 FALSE)
+    BUILD_WARNING ("lz4 not found - log files can't use the lz4 encoding.")
+  endif ()
+
   #################################################
   # Find bullet
   # First and preferred option is to look for bullet standard pkgconfig,
@@ -573,6 +593,12 @@ if (PKG_CONFIG_FOUND)
     add_definitions( -DLIBBULLET_VERSION_GT_282 )
   endif()
 
+  # btDiscreteDynamicsWorldMt and btSequentialImpulseConstraintSolverMt,
+  # used when the bullet thread_count parameter is set
+  if (BULLET_FOUND AND NOT BULLET_VERSION VERSION_LESS 2.88)
+    add_definitions( -DLIBBULLET_VERSION_GE_288 )
+  endif()
+
   ########################################
   # Find libusb
   pkg_check_modules(libusb-1.0 libusb-1.0)
@@ -661,6 +687,17 @@ else ()
   set (HAVE_GDAL ON CACHE BOOL "HAVE GDAL" FORCE)
 endif ()
 
+########################################
+# Find google benchmark, for the gazebo_benchmarks microbenchmarks
+find_package(benchmark QUIET)
+if (benchmark_FOUND)
+  message (STATUS "Looking for google benchmark - found")
+  set (HAVE_BENCHMARK TRUE)
+else ()
+  message (STATUS "Looking for google benchmark - not found")
+  set (HAVE_BENCHMARK FALSE)
+endif ()
+
 ########################################
 # Include man pages stuff
 include (${gazebo_cmake_dir}/Ronn2Man.cmake)
@@ -796,6 +833,44 @@ else()
   link_directories(${ignition-fuel_tools4_LIBRARY_DIRS})
 endif()
 
+################################################
+# The bundled parallel quickstep solver is opt-in: it is built on the
+# internals of the bundled ODE, and only its CPU version is enabled.
+option(ENABLE_PARALLEL_QUICKSTEP
+  "Build the bundled parallel quickstep ODE solver" FALSE)
+if (ENABLE_PARALLEL_QUICKSTEP)
+  message (STATUS "Parallel quickstep solver - enabled")
+  set (HAVE_PARALLEL_QUICKSTEP TRUE)
+else ()
+  set (HAVE_PARALLEL_QUICKSTEP FALSE)
+endif ()
+
+################################################
+# The bundled FCL is opt-in: it is an old snapshot, and it is only used
+# to collide triangle meshes in ODE.
+option(ENABLE_FCL "Build the bundled FCL mesh collider for ODE" FALSE)
+if (ENABLE_FCL)
+  message (STATUS "FCL mesh collider - enabled")
+  set (HAVE_FCL TRUE)
+else ()
+  set (HAVE_FCL FALSE)
+endif ()
+
+################################################
+# The bundled ODE is built in double precision unless single precision is
+# requested, which halves the size of its state for worlds with many
+# simple bodies at the cost of accuracy.
+option(ENABLE_ODE_SINGLE_PRECISION
+  "Build the bundled ODE in single precision" FALSE)
+if (ENABLE_ODE_SINGLE_PRECISION)
+  message (STATUS "ODE single precision - enabled")
+  set (ODE_SINGLE_PRECISION TRUE)
+  set (ODE_PRECISION dSINGLE)
+else ()
+  set (ODE_SINGLE_PRECISION FALSE)
+  set (ODE_PRECISION dDOUBLE)
+endif ()
+
 ################################################
 # Find Valgrind for checking memory leaks in the
 # tests
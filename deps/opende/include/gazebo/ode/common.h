@@ -22,6 +22,18 @@
 
 #ifndef _ODE_COMMON_H_
 #define _ODE_COMMON_H_
+#include <gazebo/gazebo_config.h>
+
+/* Gazebo builds the bundled ODE in double precision, unless it is
+   configured with ENABLE_ODE_SINGLE_PRECISION. */
+#ifndef dSINGLE
+#ifdef ODE_SINGLE_PRECISION
+#define dSINGLE 1
+#elif !defined(dDOUBLE)
+#define dDOUBLE 1
+#endif
+#endif
+
 #include <gazebo/ode/odeconfig.h>
 #include <gazebo/ode/error.h>
 #include <math.h>
@@ -31,7 +43,6 @@
 extern "C" {
 #endif
 
-#define dDOUBLE 1
 #define __ODE__ 1
 
 
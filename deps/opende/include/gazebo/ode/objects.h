@@ -71,6 +71,21 @@ ODE_API dWorldID dWorldCreate(void);
 ODE_API int dWorldGetBodyCount(dWorldID world);
 ODE_API dBodyID dWorldGetBody(dWorldID world, int id);
 
+/**
+ * @brief Get the first body of a world, to iterate over all bodies in
+ * linear time together with dBodyGetNextBody.
+ * @return The first body, or 0 if the world has no bodies.
+ * @ingroup world
+ */
+ODE_API dBodyID dWorldGetFirstBody(dWorldID world);
+
+/**
+ * @brief Get the body following a body in its world.
+ * @return The next body, or 0 if the body is the last one.
+ * @ingroup bodies
+ */
+ODE_API dBodyID dBodyGetNextBody(dBodyID body);
+
 
 /**
  * @brief Destroy a world and everything in it.
@@ -1599,6 +1614,16 @@ ODE_API void dBodyEnable (dBodyID);
  */
 ODE_API void dBodyDisable (dBodyID);
 
+/**
+ * @brief Enable a body without restarting its auto-disable countdown.
+ * @ingroup bodies
+ * @remarks
+ * Unlike dBodyEnable, the body keeps the number of steps and the time it
+ * has already been idle, so a body briefly disabled with dBodyDisable
+ * still auto-disables when it would have.
+ */
+ODE_API void dBodyResume (dBodyID);
+
 /**
  * @brief Check wether a body is enabled.
  * @ingroup bodies
@@ -2131,6 +2156,25 @@ ODE_API void dJointSetFeedback (dJointID, dJointFeedback *);
  */
 ODE_API dJointFeedback *dJointGetFeedback (dJointID);
 
+/**
+ * @brief Get the constraint forces computed by the last step, which are
+ * used to warm start the next step.
+ * @param lambda Array of 6 values that receives the constraint forces.
+ * @param lambda_erp Array of 6 values that receives the erp version of
+ * the constraint forces.
+ * @ingroup joints
+ */
+ODE_API void dJointGetLambda (dJointID, dReal *lambda, dReal *lambda_erp);
+
+/**
+ * @brief Set the constraint forces used to warm start the next step.
+ * @param lambda Array of 6 constraint forces.
+ * @param lambda_erp Array of 6 erp version of the constraint forces.
+ * @ingroup joints
+ */
+ODE_API void dJointSetLambda (dJointID, const dReal *lambda,
+    const dReal *lambda_erp);
+
 /**
  * @brief Set the joint anchor point.
  * @ingroup joints
@@ -38,6 +38,7 @@ typedef struct _ccd_sphere_t ccd_sphere_t;
 struct _ccd_convex_t {
     ccd_obj_t o;
     dxConvex *convex;
+    ccd_vec3_t center; // centroid of the points in world frame
 };
 typedef struct _ccd_convex_t ccd_convex_t;
 
@@ -58,6 +59,7 @@ static void ccdSupportConvex(const void *obj, const ccd_vec3_t *_dir, ccd_vec3_t
 
 /** Center function */
 static void ccdCenter(const void *obj, ccd_vec3_t *c);
+static void ccdConvexCenter(const void *obj, ccd_vec3_t *c);
 
 /** General collide function */
 static int ccdCollide(dGeomID o1, dGeomID o2, int flags,
@@ -121,8 +123,25 @@ static void ccdGeomToSphere(const dGeomID g, ccd_sphere_t *s)
 
 static void ccdGeomToConvex(const dGeomID g, ccd_convex_t *c)
 {
+    size_t i;
+    dReal *curp;
+
     ccdGeomToObj(g, (ccd_obj_t *)c);
     c->convex = (dxConvex *)g;
+
+    // MPR needs a point inside the shape, and the origin of a convex
+    // doesn't have to be, so use the centroid of its points
+    ccdVec3Set(&c->center, CCD_ZERO, CCD_ZERO, CCD_ZERO);
+    curp = c->convex->points;
+    for (i = 0; i < c->convex->pointcount; i++, curp += 3){
+        c->center.v[0] += curp[0];
+        c->center.v[1] += curp[1];
+        c->center.v[2] += curp[2];
+    }
+    if (c->convex->pointcount > 0)
+        ccdVec3Scale(&c->center, CCD_ONE / c->convex->pointcount);
+    ccdQuatRotVec(&c->center, &c->o.rot);
+    ccdVec3Add(&c->center, &c->o.pos);
 }
 
 
@@ -247,6 +266,12 @@ static void ccdCenter(const void *obj, ccd_vec3_t *c)
     ccdVec3Copy(c, &o->pos);
 }
 
+static void ccdConvexCenter(const void *obj, ccd_vec3_t *c)
+{
+    const ccd_convex_t *o = (const ccd_convex_t *)obj;
+    ccdVec3Copy(c, &o->center);
+}
+
 static int ccdCollide(dGeomID o1, dGeomID o2, int flags,
                       dContactGeom *contact, int /*skip*/,
                       void *obj1, ccd_support_fn supp1, ccd_center_fn cen1,
@@ -353,7 +378,7 @@ int dCollideConvexBoxCCD(dxGeom *o1, dxGeom *o2, int flags,
     ccdGeomToBox(o2, &box);
 
     return ccdCollide(o1, o2, flags, contact, skip,
-                      &conv, ccdSupportConvex, ccdCenter,
+                      &conv, ccdSupportConvex, ccdConvexCenter,
                       &box, ccdSupportBox, ccdCenter);
 }
 
@@ -367,7 +392,7 @@ int dCollideConvexCapsuleCCD(dxGeom *o1, dxGeom *o2, int flags,
     ccdGeomToCap(o2, &cap);
 
     return ccdCollide(o1, o2, flags, contact, skip,
-                      &conv, ccdSupportConvex, ccdCenter,
+                      &conv, ccdSupportConvex, ccdConvexCenter,
                       &cap, ccdSupportCap, ccdCenter);
 }
 
@@ -381,7 +406,7 @@ int dCollideConvexSphereCCD(dxGeom *o1, dxGeom *o2, int flags,
     ccdGeomToSphere(o2, &sphere);
 
     return ccdCollide(o1, o2, flags, contact, skip,
-                      &conv, ccdSupportConvex, ccdCenter,
+                      &conv, ccdSupportConvex, ccdConvexCenter,
                       &sphere, ccdSupportSphere, ccdCenter);
 }
 
@@ -395,7 +420,7 @@ int dCollideConvexCylinderCCD(dxGeom *o1, dxGeom *o2, int flags,
     ccdGeomToCyl(o2, &cyl);
 
     return ccdCollide(o1, o2, flags, contact, skip,
-                      &conv, ccdSupportConvex, ccdCenter,
+                      &conv, ccdSupportConvex, ccdConvexCenter,
                       &cyl, ccdSupportCyl, ccdCenter);
 }
 
@@ -408,6 +433,6 @@ int dCollideConvexConvexCCD(dxGeom *o1, dxGeom *o2, int flags,
     ccdGeomToConvex(o2, &c2);
 
     return ccdCollide(o1, o2, flags, contact, skip,
-                      &c1, ccdSupportConvex, ccdCenter,
-                      &c2, ccdSupportConvex, ccdCenter);
+                      &c1, ccdSupportConvex, ccdConvexCenter,
+                      &c2, ccdSupportConvex, ccdConvexCenter);
 }
@@ -27,6 +27,7 @@
 // this source file is mostly concerned with the data structures, not the
 // numerics.
 
+#include <string.h>
 #include <gazebo/ode/ode.h>
 #include <gazebo/ode/odemath.h>
 #include <gazebo/ode/matrix.h>
@@ -903,6 +904,13 @@ void dBodyDisable (dBodyID b)
 }
 
 
+void dBodyResume (dBodyID b)
+{
+  dAASSERT (b);
+  b->flags &= ~dxBodyDisabled;
+}
+
+
 int dBodyIsEnabled (dBodyID b)
 {
   dAASSERT (b);
@@ -1542,6 +1550,21 @@ dJointFeedback *dJointGetFeedback (dxJoint *joint)
   return joint->feedback;
 }
 
+void dJointGetLambda (dxJoint *joint, dReal *lambda, dReal *lambda_erp)
+{
+  dAASSERT (joint && lambda && lambda_erp);
+  memcpy (lambda, joint->lambda, sizeof(joint->lambda));
+  memcpy (lambda_erp, joint->lambda_erp, sizeof(joint->lambda_erp));
+}
+
+void dJointSetLambda (dxJoint *joint, const dReal *lambda,
+    const dReal *lambda_erp)
+{
+  dAASSERT (joint && lambda && lambda_erp);
+  memcpy (joint->lambda, lambda, sizeof(joint->lambda));
+  memcpy (joint->lambda_erp, lambda_erp, sizeof(joint->lambda_erp));
+}
+
 
 
 dJointID dConnectingJoint (dBodyID in_b1, dBodyID in_b2)
@@ -1712,6 +1735,18 @@ dBodyID dWorldGetBody(dxWorld *w, int id)
     return 0;
 }
 
+dBodyID dWorldGetFirstBody(dxWorld *w)
+{
+  dAASSERT (w);
+  return w->firstbody;
+}
+
+dBodyID dBodyGetNextBody(dxBody *b)
+{
+  dAASSERT (b);
+  return (dxBody*)b->next;
+}
+
 void dWorldDestroy (dxWorld *w)
 {
   // delete all bodies and joints
@@ -27,6 +27,7 @@
 #include "util.h"
 #include <boost/thread/recursive_mutex.hpp>
 #include <boost/bind.hpp>
+#include <vector>
 #include <gazebo/ode/timer.h>
 
 #undef REPORT_THREAD_TIMING
@@ -593,6 +594,30 @@ void dxProcessOneIsland(dxWorldProcessContext *island_context, dxWorld *world, d
 #endif
 }
 
+// one island of a batch stepped by a single threadpool task
+struct dxIslandWork
+{
+  dxWorldProcessContext *context;
+  dxBody *const *bodystart;
+  int bcount;
+  dxJoint *const *jointstart;
+  int jcount;
+};
+
+static void dxProcessIslandBatch(const dxIslandWork *islands, int count,
+                                 dxWorld *world, dReal stepsize,
+                                 dstepper_fn_t stepper)
+{
+  for (int i = 0; i < count; ++i)
+    dxProcessOneIsland(islands[i].context, world, stepsize, stepper,
+                       islands[i].bodystart, islands[i].bcount,
+                       islands[i].jointstart, islands[i].jcount);
+}
+
+// number of batches scheduled per thread, so that threads that finish early
+// pick up the remaining batches
+static const int dISLAND_BATCHES_PER_THREAD = 4;
+
 void dxProcessIslands (dxWorld *world, dReal stepsize, dstepper_fn_t stepper)
 {
   const int sizeelements = 2;
@@ -624,6 +649,43 @@ void dxProcessIslands (dxWorld *world, dReal stepsize, dstepper_fn_t stepper)
   printf(">>>>>>>>>>>> start island spawn threads at time %f\n",cur_time);
 #endif
 
+  const int threadcount = world->threadpool ? (int)world->threadpool->size() : 0;
+  if (threadcount > 0 && islandcount > threadcount) {
+    // scheduling a task costs more than stepping a small island, e.g. a
+    // vehicle of a fleet, so consecutive islands are stepped in batches of
+    // about the same number of bodies and joints
+    std::vector<dxIslandWork> islands(islandcount);
+    size_t totalcost = 0;
+    for (int i = 0; i < islandcount; ++i) {
+      dxIslandWork &work = islands[i];
+      work.context = world->island_wmems[i]->GetWorldProcessingContext();
+      work.bodystart = bodystart;
+      work.bcount = islandsizes[i * sizeelements];
+      work.jointstart = jointstart;
+      work.jcount = islandsizes[i * sizeelements + 1];
+      totalcost += work.bcount + work.jcount;
+      bodystart += work.bcount;
+      jointstart += work.jcount;
+    }
+
+    IFTIMING(dTimerNow("scheduling island batches"));
+    const size_t batchcost = totalcost / (threadcount * dISLAND_BATCHES_PER_THREAD) + 1;
+    int first = 0;
+    size_t cost = 0;
+    for (int i = 0; i < islandcount; ++i) {
+      cost += islands[i].bcount + islands[i].jcount;
+      if (cost >= batchcost || i == islandcount - 1) {
+        world->threadpool->schedule(boost::bind(dxProcessIslandBatch,
+          &islands[first], i + 1 - first, world, stepsize, stepper));
+        first = i + 1;
+        cost = 0;
+      }
+    }
+
+    IFTIMING(dTimerNow("islands wait"));
+    world->threadpool->wait();
+  }
+  else {
   for (int const *sizescurr = islandsizes; sizescurr != sizesend; sizescurr += sizeelements) {
     int bcount = sizescurr[0];
     int jcount = sizescurr[1];
@@ -653,6 +715,7 @@ void dxProcessIslands (dxWorld *world, dReal stepsize, dstepper_fn_t stepper)
   if (world->threadpool && world->threadpool->size() > 0)
     world->threadpool->wait();
 #endif
+  }
   IFTIMING(dTimerEnd());
   IFTIMING(dTimerReport (stdout,1));
 
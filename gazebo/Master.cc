@@ -16,8 +16,11 @@
 */
 
 #include <functional>
+#include <iterator>
 #include <thread>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include <boost/bind.hpp>
 #include <boost/make_shared.hpp>
@@ -35,12 +38,24 @@ namespace gazebo
 {
   struct MasterPrivate
   {
-    /// \brief All the known publishers.
+    /// \brief All the known publishers, in the order they advertised.
     gazebo::Master::PubList publishers;
 
     /// \brief All the known subscribers.
     gazebo::Master::SubList subscribers;
 
+    /// \brief Publishers of each topic.
+    std::unordered_map<std::string,
+        std::vector<gazebo::Master::PubList::iterator> > topicPublishers;
+
+    /// \brief Subscribers of each topic.
+    std::unordered_map<std::string,
+        std::vector<gazebo::Master::SubList::iterator> > topicSubscribers;
+
+    /// \brief Publishers advertised since the connections were last
+    /// notified.
+    msgs::Publishers pendingPublishers;
+
     /// \brief All the known connections.
     gazebo::Master::Connection_M connections;
 
@@ -100,6 +115,12 @@ void Master::Init(uint16_t _port)
 //////////////////////////////////////////////////
 void Master::OnAccept(transport::ConnectionPtr _newConnection)
 {
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->connectionMutex);
+
+  // The new connection gets every publisher in publishers_init, so the
+  // others must be notified of the pending ones first
+  this->FlushPublishers();
+
   // Send the gazebo version string
   msgs::GzString versionMsg;
   versionMsg.set_data(std::string("gazebo ") + GAZEBO_VERSION);
@@ -130,7 +151,6 @@ void Master::OnAccept(transport::ConnectionPtr _newConnection)
 
   // Add the connection to our list
   {
-    std::lock_guard<std::recursive_mutex> lock(this->dataPtr->connectionMutex);
     int index = this->dataPtr->connections.size();
 
     this->dataPtr->connections[index] = _newConnection;
@@ -177,11 +197,14 @@ void Master::OnRead(const unsigned int _connectionIndex,
 void Master::SendSubscribers(const std::string &_topic,
                              const std::string &_buffer)
 {
+  auto subs = this->dataPtr->topicSubscribers.find(_topic);
+  if (subs == this->dataPtr->topicSubscribers.end())
+    return;
+
   // Find all subscribers for this topic
   std::set<transport::ConnectionPtr> uniqueConnections;
-  for (auto const &subscriber : this->dataPtr->subscribers)
-    if (subscriber.first.topic() == _topic)
-      uniqueConnections.insert(subscriber.second);
+  for (auto const &subscriber : subs->second)
+    uniqueConnections.insert(subscriber->second);
 
   // Send message to all unique connections
   for (auto &conn : uniqueConnections)
@@ -215,12 +238,13 @@ void Master::ProcessMessage(const unsigned int _connectionIndex,
           lock(this->dataPtr->connectionMutex);
       this->dataPtr->worldNames.push_back(worldNameMsg.data());
 
+      const std::string data =
+          msgs::Package("topic_namespace_add", worldNameMsg);
       Connection_M::iterator iter2;
       for (iter2 = this->dataPtr->connections.begin();
           iter2 != this->dataPtr->connections.end(); ++iter2)
       {
-        iter2->second->EnqueueMsg(
-            msgs::Package("topic_namespace_add", worldNameMsg));
+        iter2->second->EnqueueMsg(data);
       }
     }
   }
@@ -230,14 +254,13 @@ void Master::ProcessMessage(const unsigned int _connectionIndex,
     msgs::Publish pub;
     pub.ParseFromString(packet.serialized_data());
 
-    Connection_M::iterator iter2;
-    for (iter2 = this->dataPtr->connections.begin();
-         iter2 != this->dataPtr->connections.end(); ++iter2)
-    {
-      iter2->second->EnqueueMsg(msgs::Package("publisher_add", pub));
-    }
+    // The connections are notified of all the publishers advertised in
+    // this iteration at once, see FlushPublishers
+    this->dataPtr->pendingPublishers.add_publisher()->CopyFrom(pub);
 
     this->dataPtr->publishers.push_back(std::make_pair(pub, conn));
+    this->dataPtr->topicPublishers[pub.topic()].push_back(
+        std::prev(this->dataPtr->publishers.end()));
 
     this->SendSubscribers(pub.topic(),
         msgs::Package("publisher_advertise", pub));
@@ -260,17 +283,15 @@ void Master::ProcessMessage(const unsigned int _connectionIndex,
     sub.ParseFromString(packet.serialized_data());
 
     this->dataPtr->subscribers.push_back(std::make_pair(sub, conn));
-
-    PubList::iterator iter;
+    this->dataPtr->topicSubscribers[sub.topic()].push_back(
+        std::prev(this->dataPtr->subscribers.end()));
 
     // Find all publishers of the topic
-    for (iter = this->dataPtr->publishers.begin();
-        iter != this->dataPtr->publishers.end(); ++iter)
+    auto pubs = this->dataPtr->topicPublishers.find(sub.topic());
+    if (pubs != this->dataPtr->topicPublishers.end())
     {
-      if (iter->first.topic() == sub.topic())
-      {
-        conn->EnqueueMsg(msgs::Package("publisher_subscribe", iter->first));
-      }
+      for (auto const &pub : pubs->second)
+        conn->EnqueueMsg(msgs::Package("publisher_subscribe", pub->first));
     }
   }
   else if (packet.type() == "request")
@@ -296,18 +317,12 @@ void Master::ProcessMessage(const unsigned int _connectionIndex,
       msgs::GzString_V msg;
 
       // Add all topics that are published
-      for (PubList::iterator iter = this->dataPtr->publishers.begin();
-          iter != this->dataPtr->publishers.end(); ++iter)
-      {
-        topics.insert(iter->first.topic());
-      }
+      for (auto const &pubs : this->dataPtr->topicPublishers)
+        topics.insert(pubs.first);
 
       // Add all topics that are subscribed
-      for (SubList::iterator iter = this->dataPtr->subscribers.begin();
-           iter != this->dataPtr->subscribers.end(); ++iter)
-      {
-        topics.insert(iter->first.topic());
-      }
+      for (auto const &subs : this->dataPtr->topicSubscribers)
+        topics.insert(subs.first);
 
       // Construct the message of only unique names
       for (std::set<std::string>::iterator iter =
@@ -325,33 +340,30 @@ void Master::ProcessMessage(const unsigned int _connectionIndex,
       msgs::TopicInfo ti;
       ti.set_msg_type(pub.msg_type());
 
-      PubList::iterator piter;
-      SubList::iterator siter;
-
       // Find all publishers of the topic
-      for (piter = this->dataPtr->publishers.begin();
-          piter != this->dataPtr->publishers.end(); ++piter)
+      auto pubs = this->dataPtr->topicPublishers.find(req.data());
+      if (pubs != this->dataPtr->topicPublishers.end())
       {
-        if (piter->first.topic() == req.data())
+        for (auto const &pub : pubs->second)
         {
           msgs::Publish *pubPtr = ti.add_publisher();
-          pubPtr->CopyFrom(piter->first);
+          pubPtr->CopyFrom(pub->first);
         }
       }
 
       // Find all subscribers of the topic
-      for (siter = this->dataPtr->subscribers.begin();
-          siter != this->dataPtr->subscribers.end(); ++siter)
+      auto subs = this->dataPtr->topicSubscribers.find(req.data());
+      if (subs != this->dataPtr->topicSubscribers.end())
       {
-        if (siter->first.topic() == req.data())
+        for (auto const &subscriber : subs->second)
         {
           // If the topic info message type has not been set or the
           // topic info message type is an empty string, then set the topic
           // info message type based on a subscriber's message type.
           if (!ti.has_msg_type() || ti.msg_type().empty())
-            ti.set_msg_type(siter->first.msg_type());
+            ti.set_msg_type(subscriber->first.msg_type());
           msgs::Subscribe *sub = ti.add_subscriber();
-          sub->CopyFrom(siter->first);
+          sub->CopyFrom(subscriber->first);
         }
       }
 
@@ -410,6 +422,8 @@ void Master::RunOnce()
     }
   }
 
+  this->FlushPublishers();
+
   // Process all the connections
   {
     std::lock_guard<std::recursive_mutex> lock(this->dataPtr->connectionMutex);
@@ -450,45 +464,25 @@ void Master::RemoveConnection(Connection_M::iterator _connIter)
     }
   }
 
-  // Remove all publishers for this connection
-  bool done = false;
-  while (!done)
+  // Remove all publishers for this connection, in a single pass
+  std::vector<msgs::Publish> pubs;
+  for (auto const &pub : this->dataPtr->publishers)
   {
-    done = true;
-    PubList::iterator pubIter = this->dataPtr->publishers.begin();
-    while (pubIter != this->dataPtr->publishers.end())
-    {
-      if ((*pubIter).second->GetId() == _connIter->second->GetId())
-      {
-        this->RemovePublisher((*pubIter).first);
-        done = false;
-        break;
-      }
-      else
-        ++pubIter;
-    }
+    if (pub.second->GetId() == _connIter->second->GetId())
+      pubs.push_back(pub.first);
   }
+  for (auto const &pub : pubs)
+    this->RemovePublisher(pub);
 
-
-  done = false;
-  while (!done)
+  // Remove all subscribers for this connection
+  std::vector<msgs::Subscribe> subs;
+  for (auto const &sub : this->dataPtr->subscribers)
   {
-    done = true;
-
-    // Remove all subscribers for this connection
-    SubList::iterator subIter = this->dataPtr->subscribers.begin();
-    while (subIter != this->dataPtr->subscribers.end())
-    {
-      if ((*subIter).second->GetId() == _connIter->second->GetId())
-      {
-        this->RemoveSubscriber((*subIter).first);
-        done = false;
-        break;
-      }
-      else
-        ++subIter;
-    }
+    if (sub.second->GetId() == _connIter->second->GetId())
+      subs.push_back(sub.first);
   }
+  for (auto const &sub : subs)
+    this->RemoveSubscriber(sub);
 
   this->dataPtr->connections.erase(_connIter);
 }
@@ -498,56 +492,94 @@ void Master::RemovePublisher(const msgs::Publish _pub)
 {
   {
     std::lock_guard<std::recursive_mutex> lock(this->dataPtr->connectionMutex);
+
+    // The publisher may still be pending, it must be added before removed
+    this->FlushPublishers();
+
+    const std::string data = msgs::Package("publisher_del", _pub);
     Connection_M::iterator iter2;
     for (iter2 = this->dataPtr->connections.begin();
         iter2 != this->dataPtr->connections.end(); ++iter2)
     {
-      iter2->second->EnqueueMsg(msgs::Package("publisher_del", _pub));
+      iter2->second->EnqueueMsg(data);
     }
   }
 
   this->SendSubscribers(_pub.topic(), msgs::Package("unadvertise", _pub));
 
-  PubList::iterator pubIter = this->dataPtr->publishers.begin();
-  while (pubIter != this->dataPtr->publishers.end())
+  auto pubs = this->dataPtr->topicPublishers.find(_pub.topic());
+  if (pubs == this->dataPtr->topicPublishers.end())
+    return;
+
+  auto pubIter = pubs->second.begin();
+  while (pubIter != pubs->second.end())
   {
-    if (pubIter->first.topic() == _pub.topic() &&
-        pubIter->first.host() == _pub.host() &&
-        pubIter->first.port() == _pub.port())
+    if ((*pubIter)->first.host() == _pub.host() &&
+        (*pubIter)->first.port() == _pub.port())
     {
-      pubIter = this->dataPtr->publishers.erase(pubIter);
+      this->dataPtr->publishers.erase(*pubIter);
+      pubIter = pubs->second.erase(pubIter);
     }
     else
       ++pubIter;
   }
+
+  if (pubs->second.empty())
+    this->dataPtr->topicPublishers.erase(pubs);
 }
 
 /////////////////////////////////////////////////
 void Master::RemoveSubscriber(const msgs::Subscribe _sub)
 {
   // Find all publishers of the topic, and remove the subscriptions
-  for (PubList::iterator iter = this->dataPtr->publishers.begin();
-      iter != this->dataPtr->publishers.end(); ++iter)
+  auto pubs = this->dataPtr->topicPublishers.find(_sub.topic());
+  if (pubs != this->dataPtr->topicPublishers.end())
   {
-    if (iter->first.topic() == _sub.topic())
-    {
-      iter->second->EnqueueMsg(msgs::Package("unsubscribe", _sub));
-    }
+    const std::string data = msgs::Package("unsubscribe", _sub);
+    for (auto const &pub : pubs->second)
+      pub->second->EnqueueMsg(data);
   }
 
   // Remove the subscribers from our list
-  SubList::iterator subiter = this->dataPtr->subscribers.begin();
-  while (subiter != this->dataPtr->subscribers.end())
+  auto subs = this->dataPtr->topicSubscribers.find(_sub.topic());
+  if (subs == this->dataPtr->topicSubscribers.end())
+    return;
+
+  auto subiter = subs->second.begin();
+  while (subiter != subs->second.end())
   {
-    if (subiter->first.topic() == _sub.topic() &&
-        subiter->first.host() == _sub.host() &&
-        subiter->first.port() == _sub.port())
+    if ((*subiter)->first.host() == _sub.host() &&
+        (*subiter)->first.port() == _sub.port())
     {
-      subiter = this->dataPtr->subscribers.erase(subiter);
+      this->dataPtr->subscribers.erase(*subiter);
+      subiter = subs->second.erase(subiter);
     }
     else
       ++subiter;
   }
+
+  if (subs->second.empty())
+    this->dataPtr->topicSubscribers.erase(subs);
+}
+
+//////////////////////////////////////////////////
+void Master::FlushPublishers()
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->connectionMutex);
+
+  const int count = this->dataPtr->pendingPublishers.publisher_size();
+  if (count == 0)
+    return;
+
+  // A single publisher uses the message older clients understand
+  const std::string data = count == 1 ?
+      msgs::Package("publisher_add",
+          this->dataPtr->pendingPublishers.publisher(0)) :
+      msgs::Package("publishers_add", this->dataPtr->pendingPublishers);
+  this->dataPtr->pendingPublishers.Clear();
+
+  for (auto &conn : this->dataPtr->connections)
+    conn.second->EnqueueMsg(data);
 }
 
 //////////////////////////////////////////////////
@@ -578,6 +610,9 @@ void Master::Fini()
   this->dataPtr->msgs.clear();
   this->dataPtr->worldNames.clear();
   this->dataPtr->connections.clear();
+  this->dataPtr->topicSubscribers.clear();
+  this->dataPtr->topicPublishers.clear();
+  this->dataPtr->pendingPublishers.Clear();
   this->dataPtr->subscribers.clear();
   this->dataPtr->publishers.clear();
 }
@@ -587,18 +622,10 @@ msgs::Publish Master::GetPublisher(const std::string &_topic)
 {
   msgs::Publish msg;
 
-  PubList::iterator iter;
-
-  // Find all publishers of the topic
-  for (iter = this->dataPtr->publishers.begin();
-       iter != this->dataPtr->publishers.end(); ++iter)
-  {
-    if (iter->first.topic() == _topic)
-    {
-      msg = iter->first;
-      break;
-    }
-  }
+  // Find the first publisher of the topic
+  auto pubs = this->dataPtr->topicPublishers.find(_topic);
+  if (pubs != this->dataPtr->topicPublishers.end() && !pubs->second.empty())
+    msg = pubs->second.front()->first;
 
   return msg;
 }
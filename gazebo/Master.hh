@@ -128,6 +128,10 @@ namespace gazebo
     /// remove a subscriber.
     private: void RemoveSubscriber(const msgs::Subscribe _sub);
 
+    /// \brief Notify all the connections of the publishers advertised
+    /// since the last call, in a single message.
+    private: void FlushPublishers();
+
     /// \internal
     /// \brief Pointer to private data.
     private: std::unique_ptr<MasterPrivate> dataPtr;
@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <signal.h>
+#include <algorithm>
 #include <mutex>
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
@@ -45,6 +46,7 @@
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Events.hh"
+#include "gazebo/common/SdfCache.hh"
 
 #include "gazebo/msgs/msgs.hh"
 
@@ -128,6 +130,9 @@ void Server::PrintUsage()
   std::cerr << "Gazebo server runs simulation and handles commandline "
     << "options, starts a Master, runs World update and sensor generation "
     << "loops.\n\n";
+  std::cerr << "With GAZEBO_MASTER_EXTERNAL=1, the Master at "
+    << "GAZEBO_MASTER_URI is used instead, e.g. by the servers of a world "
+    << "distributed with <gz:partition>.\n\n";
 }
 
 /////////////////////////////////////////////////
@@ -152,9 +157,16 @@ bool Server::ParseArgs(int _argc, char **_argv)
     ("physics,e", po::value<std::string>(),
      "Specify a physics engine (ode|bullet|dart|simbody).")
     ("play,p", po::value<std::string>(), "Play a log file.")
+    ("resume", po::value<std::string>(),
+     "Resume the simulation from a checkpoint file, written by a world "
+     "with <gz:checkpoint>. The world file is ignored.")
+    ("play_period", po::value<double>()->default_value(0),
+     "Simulation time between the log states that are played (seconds), "
+     "0 to play all of them.")
     ("record,r", "Record state data.")
     ("record_encoding", po::value<std::string>()->default_value("zlib"),
-     "Compression encoding format for log data (zlib|bz2|txt).")
+     "Compression encoding format for log data "
+     "(zlib|bz2|txt|zstd[:level]|lz4).")
     ("record_path", po::value<std::string>()->default_value(""),
      "Absolute path in which to store state data")
     ("record_period", po::value<double>()->default_value(-1),
@@ -162,13 +174,31 @@ bool Server::ParseArgs(int _argc, char **_argv)
     ("record_filter", po::value<std::string>()->default_value(""),
      "Recording filter (supports wildcard and regular expression).")
     ("record_resources", "Recording with model meshes and materials.")
+    ("record_resource_store", po::value<std::string>()->default_value(""),
+     "Directory of a store of resources shared by all logs, which are "
+     "linked from the logs instead of copied.")
+    ("record_binary_states", "Record world states in a binary format.")
+    ("record_binary_chunks",
+     "Write compressed log data as raw bytes instead of Base64.")
+    ("record_keyframe_period", po::value<double>()->default_value(0),
+     "Simulation time between log keyframes (seconds), 0 to disable.")
+    ("record_buffer_size", po::value<double>()->default_value(0),
+     "Largest amount of log data not written to disk yet (MB), "
+     "0 for no limit.")
+    ("record_buffer_policy", po::value<std::string>()->default_value("block"),
+     "What to do when the log buffer is full "
+     "(block|drop_oldest|degrade_period).")
+    ("record_topic", po::value<std::vector<std::string> >()->composing(),
+     "Record the messages of a topic in the state log. May be repeated.")
     ("seed",  po::value<double>(), "Start with a given random number seed.")
     ("iters",  po::value<unsigned int>(), "Number of iterations to simulate.")
     ("minimal_comms", "Reduce the TCP/IP traffic output by gzserver")
     ("server-plugin,s", po::value<std::vector<std::string> >(),
      "Load a plugin.")
     ("profile,o", po::value<std::string>(),
-     "Physics preset profile name from the options in the world file.");
+     "Physics preset profile name from the options in the world file.")
+    ("copies", po::value<unsigned int>()->default_value(1),
+     "Number of independent copies of the world to load.");
 
   po::options_description hiddenDesc("Hidden options");
   hiddenDesc.add_options()
@@ -265,6 +295,10 @@ bool Server::ParseArgs(int _argc, char **_argv)
       this->dataPtr->vm["record_encoding"].as<std::string>();
     if (this->dataPtr->vm.count("record_resources"))
       this->dataPtr->params["record_resources"] = "true";
+    if (this->dataPtr->vm.count("record_binary_states"))
+      this->dataPtr->params["record_binary_states"] = "true";
+    if (this->dataPtr->vm.count("record_binary_chunks"))
+      this->dataPtr->params["record_binary_chunks"] = "true";
   }
 
   if (this->dataPtr->vm.count("iters"))
@@ -299,6 +333,8 @@ bool Server::ParseArgs(int _argc, char **_argv)
     // Load the log file
     util::LogPlay::Instance()->Open(
         this->dataPtr->vm["play"].as<std::string>());
+    util::LogPlay::Instance()->SetPlayPeriod(
+        this->dataPtr->vm["play_period"].as<double>());
 
     gzmsg << "\nLog playback:\n"
       << "  Log Version: "
@@ -320,6 +356,22 @@ bool Server::ParseArgs(int _argc, char **_argv)
     if (!this->LoadString(sdfString))
       return false;
   }
+  // The checkpoint holds the world description too, with the models
+  // inserted after the world was loaded.
+  else if (this->dataPtr->vm.count("resume"))
+  {
+    const std::string filename = this->dataPtr->vm["resume"].as<std::string>();
+    physics::WorldCheckpoint checkpoint;
+    if (!checkpoint.Read(filename) || !this->LoadString(checkpoint.sdf))
+      return false;
+
+    physics::WorldPtr world =
+        physics::get_world(checkpoint.snapshot.worldName);
+    if (!world || !world->ResumeCheckpoint(checkpoint))
+      return false;
+    gzmsg << "Resuming checkpoint[" << filename << "] of sim time["
+          << checkpoint.snapshot.simTime << "]\n";
+  }
   else
   {
     // Get the world file name from the command line, or use "empty.world"
@@ -334,11 +386,13 @@ bool Server::ParseArgs(int _argc, char **_argv)
     if (this->dataPtr->vm.count("physics"))
       physics = this->dataPtr->vm["physics"].as<std::string>();
 
+    unsigned int copies = this->dataPtr->vm["copies"].as<unsigned int>();
+
     // Load the server
-    if (!this->LoadFile(configFilename, physics))
+    if (!this->LoadFileCopies(configFilename, copies, physics))
     {
       gzwarn << "Falling back on worlds/empty.world\n";
-      if (!this->LoadFile("worlds/empty.world", physics))
+      if (!this->LoadFileCopies("worlds/empty.world", copies, physics))
         return false;
     }
 
@@ -374,6 +428,21 @@ bool Server::GetInitialized() const
 bool Server::LoadFile(const std::string &_filename,
                       const std::string &_physics)
 {
+  return this->LoadFileCopies(_filename, 1, _physics);
+}
+
+/////////////////////////////////////////////////
+bool Server::LoadFileCopies(const std::string &_filename,
+                            const unsigned int _copies,
+                            const std::string &_physics)
+{
+  if (_copies == 0)
+  {
+    gzerr << "At least one copy of world file[" << _filename
+          << "] must be loaded\n";
+    return false;
+  }
+
   // Quick test for a valid file
   FILE *test = fopen(common::find_file(_filename).c_str(), "r");
   if (!test)
@@ -383,6 +452,11 @@ bool Server::LoadFile(const std::string &_filename,
   }
   fclose(test);
 
+  // Download the included models in parallel, instead of one at a time
+  // as the parser finds them
+  common::ModelDatabase::Instance()->DownloadIncludedModels(
+      common::find_file(_filename));
+
   // Load the world file
   sdf::SDFPtr sdf(new sdf::SDF);
   if (!sdf::init(sdf))
@@ -391,13 +465,13 @@ bool Server::LoadFile(const std::string &_filename,
     return false;
   }
 
-  if (!sdf::readFile(common::find_file(_filename), sdf))
+  if (!common::SdfCache::ReadFile(common::find_file(_filename), sdf))
   {
     gzerr << "Unable to read sdf file[" << _filename << "]\n";
     return false;
   }
 
-  return this->LoadImpl(sdf->Root(), _physics);
+  return this->LoadImpl(sdf->Root(), _physics, _copies);
 }
 
 /////////////////////////////////////////////////
@@ -430,7 +504,8 @@ bool Server::PreLoad()
 
 /////////////////////////////////////////////////
 bool Server::LoadImpl(sdf::ElementPtr _elem,
-                      const std::string &_physics)
+                      const std::string &_physics,
+                      const unsigned int _copies)
 {
   // If a physics engine is specified,
   if (_physics.length())
@@ -458,16 +533,30 @@ bool Server::LoadImpl(sdf::ElementPtr _elem,
   sdf::ElementPtr worldElem = _elem->GetElement("world");
   if (worldElem)
   {
-    physics::WorldPtr world = physics::create_world();
-
-    // Create the world
-    try
-    {
-      physics::load_world(world, worldElem);
-    }
-    catch(common::Exception &e)
+    std::string worldName = worldElem->Get<std::string>("name");
+    for (unsigned int i = 0; i < _copies; ++i)
     {
-      gzthrow("Failed to load the World\n"  << e);
+      // Every copy needs its own SDF, since the world modifies it, and its
+      // own name, since the name is the transport namespace.
+      sdf::ElementPtr copyElem = worldElem;
+      if (_copies > 1)
+      {
+        copyElem = worldElem->Clone();
+        copyElem->GetAttribute("name")->Set(
+            worldName + "_" + std::to_string(i));
+      }
+
+      physics::WorldPtr world = physics::create_world();
+
+      // Create the world
+      try
+      {
+        physics::load_world(world, copyElem);
+      }
+      catch(common::Exception &e)
+      {
+        gzthrow("Failed to load the World\n"  << e);
+      }
     }
   }
 
@@ -497,7 +586,10 @@ bool Server::LoadImpl(sdf::ElementPtr _elem,
       << " seconds for namespaces. Giving up.\n";
   }
 
-  physics::init_worlds(rendering::update_scene_poses);
+  // Scenes created in this process, e.g. by sensors, get their poses
+  // from the worlds directly
+  rendering::set_direct_scene_poses(true);
+  physics::init_worlds(rendering::update_scene_poses, rendering::has_scene);
   this->dataPtr->stop = false;
 
   return true;
@@ -620,6 +712,32 @@ void Server::ProcessParams()
       params.filter = this->dataPtr->vm["record_filter"].as<std::string>();
       params.recordResources =
           this->dataPtr->params.count("record_resources") > 0;
+      params.resourceStore =
+          this->dataPtr->vm["record_resource_store"].as<std::string>();
+      params.binaryStates =
+          this->dataPtr->params.count("record_binary_states") > 0;
+      params.binaryChunks =
+          this->dataPtr->params.count("record_binary_chunks") > 0;
+      params.keyframePeriod =
+          this->dataPtr->vm["record_keyframe_period"].as<double>();
+      params.bufferLimit = static_cast<std::size_t>(std::max(0.0,
+          this->dataPtr->vm["record_buffer_size"].as<double>()) * 1e6);
+      const std::string policy =
+        this->dataPtr->vm["record_buffer_policy"].as<std::string>();
+      if (policy == "drop_oldest")
+        params.bufferPolicy = util::LogBufferPolicy::DROP_OLDEST;
+      else if (policy == "degrade_period")
+        params.bufferPolicy = util::LogBufferPolicy::DEGRADE_PERIOD;
+      else if (policy != "block")
+      {
+        gzerr << "Invalid log buffer policy[" << policy << "], using "
+              << "[block]\n";
+      }
+      if (this->dataPtr->vm.count("record_topic"))
+      {
+        params.topics =
+          this->dataPtr->vm["record_topic"].as<std::vector<std::string> >();
+      }
       util::LogRecord::Instance()->Start(params);
     }
   }
@@ -66,6 +66,19 @@ namespace gazebo
     public: bool LoadFile(const std::string &_filename="worlds/empty.world",
                           const std::string &_physics="");
 
+    /// \brief Load several independent copies of a world file in this
+    /// process. The file is parsed once and the copies share the meshes
+    /// loaded by the MeshManager. Copy i is named "<world_name>_<i>", use
+    /// physics::step_worlds to step all of them in lockstep.
+    /// \param[in] _filename Name of the world file to load.
+    /// \param[in] _copies Number of copies, a single copy keeps the name
+    /// of the world.
+    /// \param[in] _physics Physics engine type (ode|bullet|dart|simbody).
+    /// \return True on success.
+    public: bool LoadFileCopies(const std::string &_filename,
+                                const unsigned int _copies,
+                                const std::string &_physics="");
+
     /// \brief Load the Server from an SDF string.
     /// \param[in] _sdfString SDF string from which to load a World.
     /// \return True on success.
@@ -91,8 +104,10 @@ namespace gazebo
     /// \brief Load implementation.
     /// \param[in] _elem Description of the world to load.
     /// \param[in] _physics Physics engine type (ode|bullet|dart|simbody).
+    /// \param[in] _copies Number of copies of the world to create.
     private: bool LoadImpl(sdf::ElementPtr _elem,
-                           const std::string &_physics="");
+                           const std::string &_physics="",
+                           const unsigned int _copies = 1);
 
     /// \brief SIGINT handler
     /// \param[in] _v Unused.
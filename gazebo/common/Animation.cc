@@ -26,19 +26,6 @@
 using namespace gazebo;
 using namespace common;
 
-namespace
-{
-  struct KeyFrameTimeLess
-  {
-    bool operator() (const common::KeyFrame *_kf,
-        const common::KeyFrame *_kf2) const
-    {
-      return _kf->GetTime() < _kf2->GetTime();
-    }
-  };
-}
-
-
 /////////////////////////////////////////////////
 Animation::Animation(const std::string &_name, double _length, bool _loop)
 : name(_name), length(_length), loop(_loop)
@@ -135,34 +122,32 @@ double Animation::GetKeyFramesAtTime(double _time, KeyFrame **_kf1,
   while (_time > this->length && this->length > 0.0)
     _time -= this->length;
 
-  KeyFrame_V::const_iterator iter;
-  KeyFrame timeKey(_time);
-  iter = std::lower_bound(this->keyFrames.begin(), this->keyFrames.end(),
-      &timeKey, KeyFrameTimeLess());
+  const unsigned int index = this->KeyFrameIndex(_time);
+  unsigned int first = index;
 
-  if (iter == this->keyFrames.end())
+  if (index == this->keyFrames.size())
   {
     // There is no keyframe after this time, wrap back to first
     *_kf2 = this->keyFrames.front();
-    t2 = this->length + (*_kf2)->GetTime();
+    t2 = this->length + this->keyTimes.front();
 
     // Use the last keyframe as the previous keyframe
-    --iter;
+    --first;
   }
   else
   {
-    *_kf2 = *iter;
-    t2 = (*_kf2)->GetTime();
+    *_kf2 = this->keyFrames[index];
+    t2 = this->keyTimes[index];
 
     // Find last keyframe before or on current time
-    if (iter != this->keyFrames.begin() && _time < (*iter)->GetTime())
-      --iter;
+    if (index > 0 && _time < t2)
+      --first;
   }
 
-  _firstKeyIndex = std::distance(this->keyFrames.begin(), iter);
+  _firstKeyIndex = first;
 
-  *_kf1 = *iter;
-  t1 = (*_kf1)->GetTime();
+  *_kf1 = this->keyFrames[first];
+  t1 = this->keyTimes[first];
 
   if (ignition::math::equal(t1, t2))
     return 0.0;
@@ -170,6 +155,41 @@ double Animation::GetKeyFramesAtTime(double _time, KeyFrame **_kf1,
     return (_time - t1) / (t2 - t1);
 }
 
+/////////////////////////////////////////////////
+unsigned int Animation::KeyFrameIndex(double _time) const
+{
+  const std::vector<double> &times = this->keyTimes;
+  const unsigned int count = times.size();
+
+  // Check the last segment, then the one after it
+  for (unsigned int index = this->keyIndex;
+       index <= count && index <= this->keyIndex + 1; ++index)
+  {
+    if ((index == 0 || times[index - 1] < _time) &&
+        (index == count || _time <= times[index]))
+    {
+      this->keyIndex = index;
+      return index;
+    }
+  }
+
+  this->keyIndex = std::lower_bound(times.begin(), times.end(), _time) -
+      times.begin();
+  return this->keyIndex;
+}
+
+/////////////////////////////////////////////////
+void Animation::InsertKeyFrame(KeyFrame *_frame)
+{
+  const auto index = std::upper_bound(this->keyTimes.begin(),
+      this->keyTimes.end(), _frame->GetTime()) - this->keyTimes.begin();
+
+  this->keyTimes.insert(this->keyTimes.begin() + index, _frame->GetTime());
+  this->keyFrames.insert(this->keyFrames.begin() + index, _frame);
+  this->keyIndex = 0;
+  this->build = true;
+}
+
 /////////////////////////////////////////////////
 PoseAnimation::PoseAnimation(const std::string &_name,
     double _length, bool _loop, double _tension)
@@ -191,13 +211,7 @@ PoseAnimation::~PoseAnimation()
 PoseKeyFrame *PoseAnimation::CreateKeyFrame(double _time)
 {
   PoseKeyFrame *frame = new PoseKeyFrame(_time);
-  std::vector<KeyFrame*>::iterator iter =
-    std::upper_bound(this->keyFrames.begin(), this->keyFrames.end(),
-        reinterpret_cast<KeyFrame*>(frame), KeyFrameTimeLess());
-
-  this->keyFrames.insert(iter, frame);
-  this->build = true;
-
+  this->InsertKeyFrame(frame);
   return frame;
 }
 
@@ -279,18 +293,18 @@ NumericAnimation::~NumericAnimation()
 NumericKeyFrame *NumericAnimation::CreateKeyFrame(double _time)
 {
   NumericKeyFrame *frame = new NumericKeyFrame(_time);
-  std::vector<KeyFrame*>::iterator iter =
-    std::upper_bound(this->keyFrames.begin(), this->keyFrames.end(),
-        reinterpret_cast<KeyFrame*>(frame),
-        KeyFrameTimeLess());
-
-  this->keyFrames.insert(iter, frame);
-  this->build = true;
+  this->InsertKeyFrame(frame);
   return frame;
 }
 
 /////////////////////////////////////////////////
 void NumericAnimation::GetInterpolatedKeyFrame(NumericKeyFrame &_kf) const
+{
+  _kf.SetValue(this->InterpolatedValue());
+}
+
+/////////////////////////////////////////////////
+double NumericAnimation::InterpolatedValue() const
 {
   // Keyframe pointers
   KeyFrame *kBase1, *kBase2;
@@ -306,12 +320,20 @@ void NumericAnimation::GetInterpolatedKeyFrame(NumericKeyFrame &_kf) const
   if (ignition::math::equal(t, 0.0))
   {
     // Just use k1
-    _kf.SetValue(k1->GetValue());
-  }
-  else
-  {
-    // Interpolate by t
-    double diff = k2->GetValue() - k1->GetValue();
-    _kf.SetValue(k1->GetValue() + diff * t);
+    return k1->GetValue();
   }
+
+  // Interpolate by t
+  double diff = k2->GetValue() - k1->GetValue();
+  return k1->GetValue() + diff * t;
+}
+
+/////////////////////////////////////////////////
+void NumericAnimation::InterpolatedValues(
+    const std::vector<NumericAnimationPtr> &_animations,
+    std::vector<double> &_values)
+{
+  _values.resize(_animations.size());
+  for (std::size_t i = 0; i < _animations.size(); ++i)
+    _values[i] = _animations[i]->InterpolatedValue();
 }
@@ -21,6 +21,7 @@
 #include <vector>
 #include <ignition/math/Spline.hh>
 #include <ignition/math/RotationSpline.hh>
+#include "gazebo/common/CommonTypes.hh"
 #include "gazebo/util/system.hh"
 
 namespace gazebo
@@ -90,6 +91,17 @@ namespace gazebo
                                            KeyFrame **_kf2,
                                            unsigned int &_firstKeyIndex) const;
 
+      /// \brief Get the index of the first key frame at or after a time.
+      /// The segment found by the previous call is checked first, so that
+      /// playing the animation forward doesn't search the key frames.
+      /// \param[in] _time The time in seconds, within the animation.
+      /// \return The index, GetKeyFrameCount() if all the key frames are
+      /// before _time.
+      protected: unsigned int KeyFrameIndex(double _time) const;
+
+      /// \brief Insert a key frame after the ones with the same time.
+      /// \param[in] _frame The key frame, owned by the animation.
+      protected: void InsertKeyFrame(KeyFrame *_frame);
 
       /// \brief animation name
       protected: std::string name;
@@ -111,6 +123,13 @@ namespace gazebo
 
       /// \brief array of key frames
       protected: KeyFrame_V keyFrames;
+
+      /// \brief Times of the key frames, in the order of keyFrames, to be
+      /// searched without dereferencing the key frames.
+      protected: std::vector<double> keyTimes;
+
+      /// \brief Index returned by the last call to KeyFrameIndex.
+      protected: mutable unsigned int keyIndex = 0;
     };
     /// \}
 
@@ -184,6 +203,18 @@ namespace gazebo
       /// \param[out] _kf NumericKeyFrame reference to hold the
       /// interpolated result
       public: void GetInterpolatedKeyFrame(NumericKeyFrame &_kf) const;
+
+      /// \brief Get the value of the animation at its current time.
+      /// \return The interpolated value.
+      public: double InterpolatedValue() const;
+
+      /// \brief Get the values of many animations at their current times.
+      /// \param[in] _animations The animations.
+      /// \param[out] _values The interpolated value of each animation,
+      /// resized to the number of animations.
+      public: static void InterpolatedValues(
+                  const std::vector<NumericAnimationPtr> &_animations,
+                  std::vector<double> &_values);
     };
     /// \}
   }
@@ -16,6 +16,8 @@
 */
 
 #include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
 
 #include <ignition/math/Quaternion.hh>
 #include <ignition/math/Vector3.hh>
@@ -103,6 +105,55 @@ TEST_F(AnimationTest, NumericAnimation)
   EXPECT_DOUBLE_EQ(12, interpolatedKey.GetValue());
 }
 
+/////////////////////////////////////////////////
+TEST_F(AnimationTest, NumericAnimationSearch)
+{
+  // Key frames created out of order
+  common::NumericAnimationPtr anim(
+      new common::NumericAnimation("search_test", 4, true));
+  for (double time : {2.0, 0.0, 3.0, 1.0})
+    anim->CreateKeyFrame(time)->SetValue(time * time);
+  ASSERT_EQ(4u, anim->GetKeyFrameCount());
+  for (unsigned int i = 0; i < 4u; ++i)
+    EXPECT_DOUBLE_EQ(i, anim->GetKeyFrame(i)->GetTime());
+
+  // Forward, backward and across the wrap back to the first key frame
+  for (double time : {0.0, 0.5, 1.0, 1.25, 2.5, 3.0, 3.5, 0.5, 2.0, 1.5})
+  {
+    anim->SetTime(time);
+    double expected;
+    if (time < 3.0)
+    {
+      const double t1 = std::floor(time);
+      expected = t1 * t1 + (time - t1) * ((t1 + 1) * (t1 + 1) - t1 * t1);
+    }
+    else
+    {
+      // Between the last key frame and the first one, one length later
+      expected = 9.0 + (time - 3.0) * -9.0;
+    }
+    EXPECT_DOUBLE_EQ(expected, anim->InterpolatedValue()) << time;
+
+    common::NumericKeyFrame key(0);
+    anim->GetInterpolatedKeyFrame(key);
+    EXPECT_DOUBLE_EQ(expected, key.GetValue()) << time;
+  }
+
+  // Values of many animations at once
+  common::NumericAnimationPtr other(
+      new common::NumericAnimation("other_test", 2, false));
+  other->CreateKeyFrame(0.0)->SetValue(1.0);
+  other->CreateKeyFrame(2.0)->SetValue(3.0);
+  other->SetTime(1.0);
+  anim->SetTime(2.5);
+
+  std::vector<double> values;
+  common::NumericAnimation::InterpolatedValues({anim, other}, values);
+  ASSERT_EQ(2u, values.size());
+  EXPECT_DOUBLE_EQ(6.5, values[0]);
+  EXPECT_DOUBLE_EQ(2.0, values[1]);
+}
+
 
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
@@ -17,6 +17,7 @@
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/BatteryPrivate.hh"
 #include "gazebo/common/Battery.hh"
+#include "gazebo/common/PowerSystem.hh"
 
 using namespace gazebo;
 using namespace common;
@@ -31,11 +32,15 @@ Battery::Battery()
 
   this->SetUpdateFunc(std::bind(&Battery::UpdateDefault, this,
         std::placeholders::_1));
+  this->dataPtr->customUpdate = false;
 }
 
 /////////////////////////////////////////////////
 Battery::~Battery()
 {
+  if (this->dataPtr->system)
+    this->dataPtr->system->RemoveBattery(this);
+
   delete this->dataPtr;
   this->dataPtr = nullptr;
 }
@@ -78,6 +83,7 @@ void Battery::InitConsumers()
 {
   std::lock_guard<std::mutex> lock(this->dataPtr->powerLoadsMutex);
   this->dataPtr->powerLoads.clear();
+  this->dataPtr->totalPowerLoad = 0.0;
 }
 
 /////////////////////////////////////////////////
@@ -95,6 +101,7 @@ bool Battery::RemoveConsumer(uint32_t _consumerId)
   std::lock_guard<std::mutex> lock(this->dataPtr->powerLoadsMutex);
   if (this->dataPtr->powerLoads.erase(_consumerId))
   {
+    this->UpdateTotalPowerLoad();
     return true;
   }
   else
@@ -116,9 +123,19 @@ bool Battery::SetPowerLoad(const uint32_t _consumerId, const double _powerLoad)
   }
 
   iter->second = _powerLoad;
+  this->UpdateTotalPowerLoad();
   return true;
 }
 
+/////////////////////////////////////////////////
+void Battery::UpdateTotalPowerLoad()
+{
+  double total = 0.0;
+  for (const auto &powerLoad : this->dataPtr->powerLoads)
+    total += powerLoad.second;
+  this->dataPtr->totalPowerLoad = total;
+}
+
 /////////////////////////////////////////////////
 bool Battery::PowerLoad(const uint32_t _consumerId, double &_powerLoad) const
 {
@@ -166,4 +183,5 @@ void Battery::SetUpdateFunc(
     std::function<double (const BatteryPtr &)> _updateFunc)
 {
   this->dataPtr->updateFunc = _updateFunc;
+  this->dataPtr->customUpdate = true;
 }
@@ -46,6 +46,9 @@ namespace gazebo
     /// simulation iteration. The update function takes the power loads for each
     /// consumer and current voltage value as inputs and returns a new voltage
     /// value.
+    ///
+    /// The batteries of links are updated by the PowerSystem of their world,
+    /// which can also replace the update function with a linear model.
     class GZ_COMMON_VISIBLE Battery :
       public std::enable_shared_from_this<Battery>
     {
@@ -129,11 +132,17 @@ namespace gazebo
       /// \brief Initialize the list of consumers.
       protected: void InitConsumers();
 
+      /// \brief Sum the power loads, called with powerLoadsMutex locked.
+      private: void UpdateTotalPowerLoad();
+
       /// \brief Update voltage using an ideal battery model.
       /// \param[in] _battery Pointer to the battery.
       /// \return New battery voltage.
       private: double UpdateDefault(const BatteryPtr &_battery);
 
+      /// \brief The power system updates the battery in place.
+      private: friend class PowerSystem;
+
       /// \internal
       /// \brief Private data pointer.
       private: BatteryPrivate *dataPtr;
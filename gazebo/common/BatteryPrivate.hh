@@ -17,6 +17,7 @@
 #ifndef _GAZEBO_BATTERY_PRIVATE_HH_
 #define _GAZEBO_BATTERY_PRIVATE_HH_
 
+#include <atomic>
 #include <string>
 #include <map>
 #include <functional>
@@ -52,6 +53,19 @@ namespace gazebo
 
       /// \brief Mutex that protects the powerLoads map
       public: std::mutex powerLoadsMutex;
+
+      /// \brief Sum of the power loads in watts.
+      public: std::atomic<double> totalPowerLoad{0.0};
+
+      /// \brief True when the voltage is updated by an update function set
+      /// with Battery::SetUpdateFunc.
+      public: bool customUpdate = false;
+
+      /// \brief Power system updating the battery, null if none.
+      public: PowerSystem *system = nullptr;
+
+      /// \brief Index of the battery in the arrays of the power system.
+      public: size_t systemIndex = 0;
     };
   }
 }
@@ -76,12 +76,15 @@ namespace gazebo
     class Color;
     class DiagnosticTimer;
     class Image;
+    class LatencyHistogram;
     class Mesh;
+    class MeshDistanceField;
     class SubMesh;
     class MouseEvent;
     class NumericAnimation;
     class Param;
     class PoseAnimation;
+    class PowerSystem;
     class SkeletonAnimation;
     class SphericalCoordinates;
     class Time;
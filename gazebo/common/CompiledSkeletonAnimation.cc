@@ -0,0 +1,289 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <ignition/math/Helpers.hh>
+#include <ignition/math/Quaternion.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/SkeletonAnimation.hh"
+#include "gazebo/common/CompiledSkeletonAnimation.hh"
+
+using namespace gazebo;
+using namespace common;
+
+namespace
+{
+  /// \brief Key frames of one node, in the arrays of
+  /// CompiledSkeletonAnimationPrivate.
+  class NodeTrack
+  {
+    /// \brief Index of the first key frame.
+    public: std::size_t first = 0;
+
+    /// \brief Number of key frames, 0 if the node isn't animated.
+    public: std::size_t count = 0;
+
+    /// \brief Time of the last key frame.
+    public: double length = 0.0;
+  };
+}
+
+/// \brief Private data for CompiledSkeletonAnimation.
+class gazebo::common::CompiledSkeletonAnimationPrivate
+{
+  /// \brief Normalize a time, and find the key frame that follows it.
+  /// \param[in] _track Key frames of a node.
+  /// \param[in,out] _time The time, wrapped or clamped to the track.
+  /// \param[in] _loop True to wrap the time.
+  /// \return Index of the first key frame after _time, relative to the
+  /// track.
+  public: std::size_t Next(const NodeTrack &_track, double &_time,
+              const bool _loop) const;
+
+  /// \brief Sample the transform of a node.
+  /// \param[in] _track Key frames of the node.
+  /// \param[in] _time Time given by Next.
+  /// \param[in] _next Key frame given by Next.
+  /// \return The transform.
+  public: ignition::math::Matrix4d Sample(const NodeTrack &_track,
+              const double _time, const std::size_t _next) const;
+
+  /// \brief Key frames of each node, by index.
+  public: std::vector<NodeTrack> tracks;
+
+  /// \brief Times of the key frames of all the nodes.
+  public: std::vector<double> times;
+
+  /// \brief Transforms of the key frames of all the nodes.
+  public: std::vector<ignition::math::Matrix4d> transforms;
+
+  /// \brief Translations of the key frames of all the nodes.
+  public: std::vector<ignition::math::Vector3d> positions;
+
+  /// \brief Rotations of the key frames of all the nodes.
+  public: std::vector<ignition::math::Quaterniond> rotations;
+
+  /// \brief True if all the animated nodes have the same key frame times.
+  public: bool sharedTimes = true;
+
+  /// \brief Index of an animated node, tracks.size() if there is none.
+  public: std::size_t firstAnimated = 0;
+
+  /// \brief Time of the last key frame.
+  public: double length = 0.0;
+};
+
+//////////////////////////////////////////////////
+std::size_t CompiledSkeletonAnimationPrivate::Next(const NodeTrack &_track,
+    double &_time, const bool _loop) const
+{
+  if (_time > _track.length)
+  {
+    if (_loop && _track.length > 0.0)
+    {
+      while (_time > _track.length)
+        _time = _time - _track.length;
+    }
+    else
+      _time = _track.length;
+  }
+
+  if (ignition::math::equal(_time, _track.length))
+    return _track.count - 1;
+
+  const auto begin = this->times.begin() + _track.first;
+  return std::upper_bound(begin, begin + _track.count, _time) - begin;
+}
+
+//////////////////////////////////////////////////
+ignition::math::Matrix4d CompiledSkeletonAnimationPrivate::Sample(
+    const NodeTrack &_track, const double _time, const std::size_t _next) const
+{
+  const std::size_t last = _track.first + _track.count - 1;
+  if (_next >= _track.count || ignition::math::equal(_time, _track.length))
+    return this->transforms[last];
+
+  // Before the first key frame, or at a key frame
+  const std::size_t next = _track.first + _next;
+  if (_next == 0 || ignition::math::equal(this->times[next], _time))
+    return this->transforms[next];
+
+  const std::size_t prev = next - 1;
+  const double t = (_time - this->times[prev]) /
+      (this->times[next] - this->times[prev]);
+  if (t < 0.0 || t > 1.0)
+  {
+    gzerr << "Invalid time range for node animation: previous ["
+          << this->times[prev] << "], next [" << this->times[next] << "]"
+          << std::endl;
+    return ignition::math::Matrix4d();
+  }
+
+  const ignition::math::Vector3d &prevPos = this->positions[prev];
+  const ignition::math::Vector3d &nextPos = this->positions[next];
+  ignition::math::Matrix4d trans(ignition::math::Quaterniond::Slerp(t,
+        this->rotations[prev], this->rotations[next], true));
+  trans.SetTranslation(ignition::math::Vector3d(
+      prevPos.X() + ((nextPos.X() - prevPos.X()) * t),
+      prevPos.Y() + ((nextPos.Y() - prevPos.Y()) * t),
+      prevPos.Z() + ((nextPos.Z() - prevPos.Z()) * t)));
+  return trans;
+}
+
+//////////////////////////////////////////////////
+CompiledSkeletonAnimation::CompiledSkeletonAnimation(
+    const SkeletonAnimation &_animation,
+    const std::vector<std::string> &_nodes)
+  : dataPtr(new CompiledSkeletonAnimationPrivate)
+{
+  this->dataPtr->tracks.resize(_nodes.size());
+  this->dataPtr->firstAnimated = _nodes.size();
+
+  for (std::size_t i = 0; i < _nodes.size(); ++i)
+  {
+    const NodeAnimation *node = _animation.NodeAnimationByName(_nodes[i]);
+    if (!node || node->GetFrameCount() == 0)
+      continue;
+
+    NodeTrack &track = this->dataPtr->tracks[i];
+    track.first = this->dataPtr->times.size();
+    track.count = node->GetFrameCount();
+    track.length = node->GetLength();
+    this->dataPtr->length = std::max(this->dataPtr->length, track.length);
+
+    for (unsigned int k = 0; k < track.count; ++k)
+    {
+      const auto frame = node->KeyFrame(k);
+      this->dataPtr->times.push_back(frame.first);
+      this->dataPtr->transforms.push_back(frame.second);
+      this->dataPtr->positions.push_back(frame.second.Translation());
+      this->dataPtr->rotations.push_back(frame.second.Rotation());
+    }
+
+    if (this->dataPtr->firstAnimated == _nodes.size())
+    {
+      this->dataPtr->firstAnimated = i;
+    }
+    else
+    {
+      const NodeTrack &first =
+          this->dataPtr->tracks[this->dataPtr->firstAnimated];
+      this->dataPtr->sharedTimes = this->dataPtr->sharedTimes &&
+          first.count == track.count &&
+          std::equal(this->dataPtr->times.begin() + track.first,
+              this->dataPtr->times.end(),
+              this->dataPtr->times.begin() + first.first);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+CompiledSkeletonAnimation::~CompiledSkeletonAnimation()
+{
+}
+
+//////////////////////////////////////////////////
+unsigned int CompiledSkeletonAnimation::NodeCount() const
+{
+  return this->dataPtr->tracks.size();
+}
+
+//////////////////////////////////////////////////
+bool CompiledSkeletonAnimation::Animated(const unsigned int _index) const
+{
+  return _index < this->dataPtr->tracks.size() &&
+      this->dataPtr->tracks[_index].count > 0;
+}
+
+//////////////////////////////////////////////////
+double CompiledSkeletonAnimation::Length() const
+{
+  return this->dataPtr->length;
+}
+
+//////////////////////////////////////////////////
+void CompiledSkeletonAnimation::PoseAt(const double _time,
+    std::vector<ignition::math::Matrix4d> &_pose, const bool _loop) const
+{
+  const std::vector<NodeTrack> &tracks = this->dataPtr->tracks;
+  if (_pose.size() != tracks.size())
+    _pose.resize(tracks.size(), ignition::math::Matrix4d::Identity);
+
+  if (this->dataPtr->firstAnimated >= tracks.size())
+    return;
+
+  // Search the key frames once if all the nodes share them
+  double sharedTime = _time;
+  const std::size_t sharedNext = this->dataPtr->Next(
+      tracks[this->dataPtr->firstAnimated], sharedTime, _loop);
+
+  for (std::size_t i = this->dataPtr->firstAnimated; i < tracks.size(); ++i)
+  {
+    const NodeTrack &track = tracks[i];
+    if (track.count == 0)
+      continue;
+
+    if (this->dataPtr->sharedTimes)
+    {
+      _pose[i] = this->dataPtr->Sample(track, sharedTime, sharedNext);
+    }
+    else
+    {
+      double time = _time;
+      const std::size_t next = this->dataPtr->Next(track, time, _loop);
+      _pose[i] = this->dataPtr->Sample(track, time, next);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+double CompiledSkeletonAnimation::TimeAtX(const double _x,
+    const unsigned int _index, const bool _loop) const
+{
+  if (!this->Animated(_index))
+    return 0.0;
+
+  const NodeTrack &track = this->dataPtr->tracks[_index];
+  const ignition::math::Vector3d *positions =
+      this->dataPtr->positions.data() + track.first;
+  const double *times = this->dataPtr->times.data() + track.first;
+
+  double x = std::max(_x, positions[0].X());
+  const double lastX = positions[track.count - 1].X();
+  if (x > lastX && !_loop)
+    x = lastX;
+  if (lastX > 0.0)
+  {
+    while (x > lastX)
+      x -= lastX;
+  }
+
+  std::size_t i = 0;
+  while (i + 1 < track.count && positions[i].X() < x)
+    ++i;
+
+  if (i == 0 || ignition::math::equal(positions[i].X(), x))
+    return times[i];
+
+  const double x1 = positions[i - 1].X();
+  const double x2 = positions[i].X();
+  return times[i - 1] + ((times[i] - times[i - 1]) * (x - x1) / (x2 - x1));
+}
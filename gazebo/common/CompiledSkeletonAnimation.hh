@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_COMPILEDSKELETONANIMATION_HH_
+#define GAZEBO_COMMON_COMPILEDSKELETONANIMATION_HH_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/math/Matrix4.hh>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    // Forward declarations.
+    class CompiledSkeletonAnimationPrivate;
+    class SkeletonAnimation;
+
+    /// \addtogroup gazebo_common Common Animation
+    /// \{
+
+    /// \class CompiledSkeletonAnimation CompiledSkeletonAnimation.hh
+    /// common/common.hh
+    /// \brief A skeleton animation laid out to be sampled every frame.
+    ///
+    /// Nodes are addressed by index instead of by name, and the key frames
+    /// of all the nodes are stored in flat arrays, with their rotations
+    /// already extracted. When all the nodes share the same key frame
+    /// times, as in BVH animations, the key frames around a time are
+    /// searched once for all the nodes. Samples are the same as the ones of
+    /// SkeletonAnimation::PoseAt.
+    class GZ_COMMON_VISIBLE CompiledSkeletonAnimation
+    {
+      /// \brief Constructor.
+      /// \param[in] _animation The animation, which isn't used after
+      /// construction.
+      /// \param[in] _nodes Names of the animation nodes, in the order of the
+      /// sampled transforms. Nodes the animation doesn't have aren't
+      /// animated.
+      public: CompiledSkeletonAnimation(const SkeletonAnimation &_animation,
+                  const std::vector<std::string> &_nodes);
+
+      /// \brief Destructor.
+      public: ~CompiledSkeletonAnimation();
+
+      /// \brief Get the number of nodes.
+      /// \return The number of nodes given to the constructor.
+      public: unsigned int NodeCount() const;
+
+      /// \brief Get whether a node is animated.
+      /// \param[in] _index Index of the node.
+      /// \return True if the animation has key frames for the node.
+      public: bool Animated(const unsigned int _index) const;
+
+      /// \brief Get the duration of the animation.
+      /// \return Time of the last key frame of the animated nodes.
+      public: double Length() const;
+
+      /// \brief Get the transforms of the animated nodes at a time.
+      /// \param[in] _time The time.
+      /// \param[in,out] _pose Transforms of the nodes, by index. It's
+      /// resized to NodeCount() if needed. The transforms of the nodes that
+      /// aren't animated are left untouched.
+      /// \param[in] _loop True to wrap times after the end of the animation.
+      public: void PoseAt(const double _time,
+                  std::vector<ignition::math::Matrix4d> &_pose,
+                  const bool _loop = true) const;
+
+      /// \brief Get the time where the translation along X of a node is
+      /// equal to _x, as SkeletonAnimation::PoseAtX does.
+      /// \param[in] _x The value along X.
+      /// \param[in] _index Index of an animated node.
+      /// \param[in] _loop True to wrap values after the end of the
+      /// animation.
+      /// \return The time, 0 if the node isn't animated.
+      public: double TimeAtX(const double _x, const unsigned int _index,
+                  const bool _loop = true) const;
+
+      /// \brief Private data.
+      private: std::unique_ptr<CompiledSkeletonAnimationPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
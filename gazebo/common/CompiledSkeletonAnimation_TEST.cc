@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gazebo/common/CompiledSkeletonAnimation.hh"
+#include "gazebo/common/SkeletonAnimation.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class CompiledSkeletonAnimationTest : public gazebo::testing::AutoLogFixture
+{
+};
+
+/// \brief Expect the samples of a compiled animation to match the ones of
+/// its animation.
+/// \param[in] _animation The animation.
+/// \param[in] _compiled The compiled animation.
+/// \param[in] _nodes Names of the nodes of the compiled animation.
+static void ExpectSamePoses(const common::SkeletonAnimation &_animation,
+    const common::CompiledSkeletonAnimation &_compiled,
+    const std::vector<std::string> &_nodes)
+{
+  std::vector<ignition::math::Matrix4d> pose;
+  for (double time = -0.5; time < 7.0; time += 0.1)
+  {
+    for (bool loop : {true, false})
+    {
+      std::map<std::string, ignition::math::Matrix4d> expected =
+          _animation.PoseAt(time, loop);
+      _compiled.PoseAt(time, pose, loop);
+      ASSERT_EQ(_nodes.size(), pose.size());
+      for (unsigned int i = 0; i < _nodes.size(); ++i)
+      {
+        if (!_compiled.Animated(i))
+          continue;
+        EXPECT_EQ(expected[_nodes[i]], pose[i]) << _nodes[i] << " " << time;
+      }
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+TEST_F(CompiledSkeletonAnimationTest, SharedTimes)
+{
+  // Nodes with the same key frame times, as in BVH files
+  common::SkeletonAnimation animation("walk");
+  for (double time : {0.0, 1.0, 2.5})
+  {
+    animation.AddKeyFrame("root", time, ignition::math::Pose3d(
+          time, 0, 1, 0, 0, time * 0.5));
+    animation.AddKeyFrame("arm", time, ignition::math::Pose3d(
+          0, time, 0, time * 0.2, 0, 0));
+  }
+
+  const std::vector<std::string> nodes = {"arm", "missing", "root"};
+  common::CompiledSkeletonAnimation compiled(animation, nodes);
+  EXPECT_EQ(3u, compiled.NodeCount());
+  EXPECT_TRUE(compiled.Animated(0));
+  EXPECT_FALSE(compiled.Animated(1));
+  EXPECT_TRUE(compiled.Animated(2));
+  EXPECT_FALSE(compiled.Animated(3));
+  EXPECT_DOUBLE_EQ(2.5, compiled.Length());
+
+  ExpectSamePoses(animation, compiled, nodes);
+
+  // Nodes which aren't animated keep their transform
+  std::vector<ignition::math::Matrix4d> pose(3,
+      ignition::math::Matrix4d::Identity);
+  pose[1].SetTranslation(ignition::math::Vector3d(1, 2, 3));
+  compiled.PoseAt(0.5, pose);
+  EXPECT_EQ(ignition::math::Vector3d(1, 2, 3), pose[1].Translation());
+
+  // Same times as PoseAtX
+  for (double x : {-1.0, 0.0, 0.5, 1.0, 2.0, 3.0})
+  {
+    EXPECT_EQ(animation.PoseAtX(x, "root")["arm"],
+        animation.PoseAt(compiled.TimeAtX(x, 2))["arm"]) << x;
+  }
+  EXPECT_DOUBLE_EQ(0.0, compiled.TimeAtX(1.0, 1));
+}
+
+/////////////////////////////////////////////////
+TEST_F(CompiledSkeletonAnimationTest, NodeTimes)
+{
+  // Nodes with their own key frame times, as in COLLADA files
+  common::SkeletonAnimation animation("wave");
+  for (double time : {0.0, 1.0, 2.5})
+  {
+    animation.AddKeyFrame("root", time, ignition::math::Pose3d(
+          time, 0, 1, 0, 0, time * 0.5));
+  }
+  for (double time : {0.5, 1.5})
+  {
+    animation.AddKeyFrame("hand", time, ignition::math::Pose3d(
+          0, 0, time, 0, time, 0));
+  }
+
+  const std::vector<std::string> nodes = {"root", "hand"};
+  common::CompiledSkeletonAnimation compiled(animation, nodes);
+  EXPECT_DOUBLE_EQ(2.5, compiled.Length());
+  ExpectSamePoses(animation, compiled, nodes);
+
+  // An animation without nodes
+  common::CompiledSkeletonAnimation empty(animation, {"missing"});
+  std::vector<ignition::math::Matrix4d> pose;
+  empty.PoseAt(1.0, pose);
+  ASSERT_EQ(1u, pose.size());
+  EXPECT_EQ(ignition::math::Matrix4d::Identity, pose[0]);
+  EXPECT_DOUBLE_EQ(0.0, empty.Length());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
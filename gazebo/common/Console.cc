@@ -14,7 +14,20 @@
  * limitations under the License.
  *
  */
+#ifndef _WIN32
+  #include <pthread.h>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
 #include <boost/filesystem.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string/regex.hpp>
@@ -29,6 +42,539 @@
 using namespace gazebo;
 using namespace common;
 
+namespace
+{
+  /// \brief Number of fragments the queue holds, a power of two.
+  const size_t kQueueSize = 1u << 13;
+
+  /// \brief Number of times a push into a full queue is retried.
+  const int kPushRetries = 64;
+
+  /// \brief Time during which repeats of a line are counted rather than
+  /// written.
+  const std::chrono::seconds kRepeatWindow(1);
+
+  /// \brief Longest time the writer sleeps without being woken up.
+  const std::chrono::milliseconds kWriterSleep(100);
+
+  /// \brief Fragment of a message, queued for the writer.
+  struct LogEntry
+  {
+    /// \brief Stream to write the fragment into.
+    std::ostream *out = nullptr;
+
+    /// \brief ANSI color of the fragment, 0 for none.
+    int color = 0;
+
+    /// \brief The text.
+    std::string text;
+  };
+
+  /// \brief Bounded lock free queue for several producers, see Vyukov,
+  /// Bounded MPMC queue. Each slot has a sequence number telling whether
+  /// it is free for the push of a position, or holds the entry of a pop.
+  class LogQueue
+  {
+    /// \brief Constructor.
+    /// \param[in] _size Number of slots, a power of two.
+    public: explicit LogQueue(const size_t _size)
+      : slots(new Slot[_size]), mask(_size - 1)
+    {
+      for (size_t i = 0; i < _size; ++i)
+        this->slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    /// \brief Add an entry.
+    /// \param[in] _entry The entry, moved into the queue on success.
+    /// \return False if the queue is full.
+    public: bool Push(LogEntry &_entry)
+    {
+      size_t pos = this->pushPos.load(std::memory_order_relaxed);
+      Slot *slot;
+      for (;;)
+      {
+        slot = &this->slots[pos & this->mask];
+        const size_t seq = slot->sequence.load(std::memory_order_acquire);
+        const intptr_t diff =
+            static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (diff == 0)
+        {
+          if (this->pushPos.compare_exchange_weak(pos, pos + 1,
+                std::memory_order_relaxed))
+          {
+            break;
+          }
+        }
+        else if (diff < 0)
+          return false;
+        else
+          pos = this->pushPos.load(std::memory_order_relaxed);
+      }
+
+      slot->entry = std::move(_entry);
+      slot->sequence.store(pos + 1, std::memory_order_release);
+      return true;
+    }
+
+    /// \brief Remove the oldest entry.
+    /// \param[out] _entry The entry.
+    /// \return False if the queue is empty.
+    public: bool Pop(LogEntry &_entry)
+    {
+      size_t pos = this->popPos.load(std::memory_order_relaxed);
+      Slot *slot;
+      for (;;)
+      {
+        slot = &this->slots[pos & this->mask];
+        const size_t seq = slot->sequence.load(std::memory_order_acquire);
+        const intptr_t diff =
+            static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+        if (diff == 0)
+        {
+          if (this->popPos.compare_exchange_weak(pos, pos + 1,
+                std::memory_order_relaxed))
+          {
+            break;
+          }
+        }
+        else if (diff < 0)
+          return false;
+        else
+          pos = this->popPos.load(std::memory_order_relaxed);
+      }
+
+      _entry = std::move(slot->entry);
+      slot->sequence.store(pos + this->mask + 1, std::memory_order_release);
+      return true;
+    }
+
+    /// \brief Slot of the queue.
+    private: struct Slot
+    {
+      /// \brief Position the slot is ready for.
+      std::atomic<size_t> sequence;
+
+      /// \brief The entry.
+      LogEntry entry;
+    };
+
+    /// \brief The slots.
+    private: std::unique_ptr<Slot[]> slots;
+
+    /// \brief Mask of the positions.
+    private: const size_t mask;
+
+    /// \brief Position of the next push.
+    private: std::atomic<size_t> pushPos{0};
+
+    /// \brief Keeps the positions on separate cache lines, so that the
+    /// producers and the writer don't contend for one line.
+    private: char padding[64];
+
+    /// \brief Position of the next pop.
+    private: std::atomic<size_t> popPos{0};
+  };
+
+  /// \brief Write a fragment with its color.
+  /// \param[in] _out The stream.
+  /// \param[in] _color ANSI color, 0 for none.
+  /// \param[in] _text The fragment.
+  void WriteFragment(std::ostream &_out, const int _color,
+      const std::string &_text)
+  {
+    if (_text.empty())
+      return;
+
+    if (_color)
+      _out << "\033[1;" << _color << "m" << _text << "\033[0m";
+    else
+      _out << _text;
+  }
+
+  /// \brief Background thread writing the queued messages. The streams
+  /// are flushed when the queue is empty rather than for each fragment.
+  class LogWriter
+  {
+    /// \brief Get the writer, which is never destroyed so that loggers
+    /// used during static destruction find it.
+    /// \return The writer.
+    public: static LogWriter &Instance()
+    {
+      static LogWriter *writer = new LogWriter();
+      return *writer;
+    }
+
+    /// \brief Queue a fragment.
+    /// \param[in] _out The stream.
+    /// \param[in] _color ANSI color, 0 for none.
+    /// \param[in] _text The fragment.
+    /// \return False if the writer doesn't run, in which case the caller
+    /// writes the fragment itself.
+    public: bool Write(std::ostream *_out, const int _color,
+                const std::string &_text)
+    {
+      if (!this->running.load(std::memory_order_acquire))
+        return false;
+
+      // Streams sync for each insertion, often with nothing to write
+      if (_text.empty())
+        return true;
+
+      LogEntry entry;
+      entry.out = _out;
+      entry.color = _color;
+      entry.text = _text;
+      // Give the writer a moment to make room before dropping
+      bool queued = this->queue.Push(entry);
+      for (int i = 0; !queued && i < kPushRetries; ++i)
+      {
+        this->wake.notify_one();
+        std::this_thread::yield();
+        queued = this->queue.Push(entry);
+      }
+
+      if (!queued)
+        this->dropped.fetch_add(1, std::memory_order_relaxed);
+      else
+        this->pushed.fetch_add(1, std::memory_order_release);
+
+      if (this->sleeping.load(std::memory_order_acquire))
+        this->wake.notify_one();
+      return true;
+    }
+
+    /// \brief Start or stop the writer thread.
+    /// \param[in] _enable True to start it.
+    public: void SetEnabled(const bool _enable)
+    {
+      std::lock_guard<std::mutex> lock(this->controlMutex);
+      this->enabled = _enable;
+      if (_enable && !this->thread)
+      {
+        this->stop = false;
+        this->running.store(true, std::memory_order_release);
+        this->thread.reset(new std::thread(&LogWriter::Run, this));
+      }
+      else if (!_enable && this->thread)
+      {
+        // Producers write on their own thread from now on, the writer
+        // drains what they queued before.
+        this->running.store(false, std::memory_order_release);
+        {
+          std::lock_guard<std::mutex> wakeLock(this->wakeMutex);
+          this->stop = true;
+        }
+        this->wake.notify_one();
+        this->thread->join();
+        this->thread.reset();
+      }
+    }
+
+    /// \brief Get whether the writer is enabled.
+    /// \return True if enabled.
+    public: bool Enabled()
+    {
+      std::lock_guard<std::mutex> lock(this->controlMutex);
+      return this->enabled;
+    }
+
+    /// \brief Wait until the fragments queued so far are written.
+    public: void Flush()
+    {
+      if (!this->running.load(std::memory_order_acquire))
+        return;
+
+      const uint64_t target = this->pushed.load(std::memory_order_acquire);
+      std::unique_lock<std::mutex> lock(this->wakeMutex);
+      this->flushes = target;
+      this->wake.notify_one();
+      this->flushed.wait(lock, [&]
+          {
+            return (this->written >= target && this->idle) ||
+                   !this->running.load(std::memory_order_acquire);
+          });
+    }
+
+    /// \brief Get the number of dropped fragments.
+    /// \return The number of fragments.
+    public: uint64_t Dropped() const
+    {
+      return this->dropped.load(std::memory_order_relaxed);
+    }
+
+    /// \brief Forget the writer thread in a forked child, where it doesn't
+    /// exist, so that the child writes on its own threads.
+    public: void OnFork()
+    {
+      this->running.store(false, std::memory_order_release);
+      this->thread.release();
+    }
+
+    /// \brief Constructor, starts the writer unless GAZEBO_LOG_ASYNC is 0.
+    private: LogWriter()
+      : queue(kQueueSize)
+    {
+      const char *env = getenv("GAZEBO_LOG_ASYNC");
+      if (!env || std::string(env) != "0")
+        this->SetEnabled(true);
+
+      // Queued messages are written before the static loggers are
+      // destroyed, which then write on their own.
+      std::atexit([] { LogWriter::Instance().SetEnabled(false); });
+#ifndef _WIN32
+      pthread_atfork(nullptr, nullptr,
+          [] { LogWriter::Instance().OnFork(); });
+#endif
+    }
+
+    /// \brief Lines being assembled for a stream.
+    private: struct Output
+    {
+      /// \brief Start of a line not ended yet.
+      std::string partial;
+
+      /// \brief Color of the line not ended.
+      int partialColor = 0;
+
+      /// \brief True if the start of the line was already written.
+      bool partialWritten = false;
+
+      /// \brief Last complete line, without its time stamp.
+      std::string last;
+
+      /// \brief Color of the last line.
+      int color = 0;
+
+      /// \brief Repeats of the last line not written.
+      unsigned int repeats = 0;
+
+      /// \brief When the last line was written.
+      std::chrono::steady_clock::time_point lastTime;
+
+      /// \brief True if something was written since the last flush.
+      bool dirty = false;
+    };
+
+    /// \brief Thread writing the queue.
+    private: void Run()
+    {
+      std::unique_lock<std::mutex> lock(this->wakeMutex);
+      bool timeout = false;
+      for (;;)
+      {
+        // Lines not ended or counted are kept until the writer slept for
+        // nothing, or a flush waits for them.
+        const bool all = timeout || this->stop || this->flushes > this->written;
+        this->idle = false;
+        lock.unlock();
+
+        LogEntry entry;
+        uint64_t count = 0;
+        while (this->queue.Pop(entry))
+        {
+          this->WriteEntry(entry);
+          ++count;
+        }
+        this->FlushOutputs(all);
+
+        lock.lock();
+        this->written += count;
+        this->idle = true;
+        this->flushed.notify_all();
+
+        if (this->stop && !this->Pending())
+          break;
+
+        // Sleep unless fragments were queued meanwhile
+        this->sleeping.store(true, std::memory_order_release);
+        timeout = !this->Pending() && this->flushes <= this->written &&
+            this->wake.wait_for(lock, kWriterSleep) ==
+            std::cv_status::timeout;
+        this->sleeping.store(false, std::memory_order_release);
+      }
+
+      this->FlushOutputs(true);
+    }
+
+    /// \brief Get whether fragments were pushed and not written.
+    /// \return True if there are fragments to write.
+    private: bool Pending() const
+    {
+      return this->pushed.load(std::memory_order_acquire) > this->written;
+    }
+
+    /// \brief Write a fragment, line by line so that repeated lines are
+    /// counted.
+    /// \param[in] _entry The fragment.
+    private: void WriteEntry(const LogEntry &_entry)
+    {
+      Output &output = this->outputs[_entry.out];
+      size_t start = 0;
+      for (size_t end = _entry.text.find('\n'); end != std::string::npos;
+           start = end + 1, end = _entry.text.find('\n', start))
+      {
+        output.partial.append(_entry.text, start, end + 1 - start);
+        this->WriteLine(*_entry.out, _entry.color, output);
+      }
+      output.partial.append(_entry.text, start, std::string::npos);
+      output.partialColor = _entry.color;
+    }
+
+    /// \brief Write the complete line of an output, or count it if it
+    /// repeats the previous one.
+    /// \param[in] _out The stream.
+    /// \param[in] _color ANSI color, 0 for none.
+    /// \param[in] _output The output, whose partial line is complete.
+    private: void WriteLine(std::ostream &_out, const int _color,
+                 Output &_output)
+    {
+      const auto now = std::chrono::steady_clock::now();
+
+      // A line whose start was written isn't compared
+      if (_output.partialWritten)
+      {
+        WriteFragment(_out, _color, _output.partial);
+        _output.partial.clear();
+        _output.partialWritten = false;
+        _output.last.clear();
+        _output.dirty = true;
+        return;
+      }
+
+      // Lines of the log file differ by their time stamp
+      std::string key = _output.partial;
+      if (!key.empty() && key[0] == '(')
+      {
+        const size_t close = key.find(") ");
+        if (close != std::string::npos)
+          key.erase(0, close + 2);
+      }
+
+      if (!_output.last.empty() && key == _output.last &&
+          now - _output.lastTime < kRepeatWindow)
+      {
+        ++_output.repeats;
+        _output.partial.clear();
+        return;
+      }
+
+      this->WriteRepeats(_out, _output);
+      WriteFragment(_out, _color, _output.partial);
+      _output.partial.clear();
+      _output.last = key;
+      _output.color = _color;
+      _output.lastTime = now;
+      _output.dirty = true;
+    }
+
+    /// \brief Write the number of repeats of the last line, if any.
+    /// \param[in] _out The stream.
+    /// \param[in] _output The output.
+    private: void WriteRepeats(std::ostream &_out, Output &_output)
+    {
+      if (_output.repeats == 0)
+        return;
+
+      std::ostringstream stream;
+      stream << "Last message repeated " << _output.repeats << " times\n";
+      WriteFragment(_out, _output.color, stream.str());
+      _output.repeats = 0;
+      _output.dirty = true;
+    }
+
+    /// \brief Flush the streams, once the queue is empty.
+    /// \param[in] _all True to also write the lines not ended, and the
+    /// repeats counted.
+    private: void FlushOutputs(const bool _all)
+    {
+      const uint64_t total = this->dropped.load(std::memory_order_relaxed);
+      if (total != this->droppedReported)
+      {
+        std::cerr << "[Wrn] " << total - this->droppedReported
+                  << " log messages dropped, the log queue was full\n";
+        this->droppedReported = total;
+      }
+
+      for (auto &output : this->outputs)
+      {
+        std::ostream &out = *output.first;
+        if (_all)
+        {
+          this->WriteRepeats(out, output.second);
+          if (!output.second.partial.empty())
+          {
+            WriteFragment(out, output.second.partialColor,
+                output.second.partial);
+            output.second.partial.clear();
+            output.second.partialWritten = true;
+            output.second.dirty = true;
+          }
+        }
+        if (output.second.dirty)
+        {
+          out.flush();
+          output.second.dirty = false;
+        }
+      }
+      std::cerr.flush();
+    }
+
+    /// \brief Fragments waiting to be written.
+    private: LogQueue queue;
+
+    /// \brief True while the writer thread accepts fragments.
+    private: std::atomic<bool> running{false};
+
+    /// \brief True while the writer thread sleeps.
+    private: std::atomic<bool> sleeping{false};
+
+    /// \brief Number of fragments pushed.
+    private: std::atomic<uint64_t> pushed{0};
+
+    /// \brief Number of fragments dropped because the queue was full.
+    private: std::atomic<uint64_t> dropped{0};
+
+    /// \brief Number of dropped fragments reported, used by the writer.
+    private: uint64_t droppedReported = 0;
+
+    /// \brief Lines being written, by stream. Used by the writer.
+    private: std::map<std::ostream *, Output> outputs;
+
+    /// \brief Number of fragments written, protected by wakeMutex.
+    private: uint64_t written = 0;
+
+    /// \brief Number of pushed fragments a flush waits for, protected by
+    /// wakeMutex.
+    private: uint64_t flushes = 0;
+
+    /// \brief True when the writer emptied the queue, protected by
+    /// wakeMutex.
+    private: bool idle = true;
+
+    /// \brief True when the writer thread should end, protected by
+    /// wakeMutex.
+    private: bool stop = false;
+
+    /// \brief Protects the waits of the writer and of the flushes.
+    private: std::mutex wakeMutex;
+
+    /// \brief Wakes the writer.
+    private: std::condition_variable wake;
+
+    /// \brief Signals that the writer emptied the queue.
+    private: std::condition_variable flushed;
+
+    /// \brief True if the writer was enabled, protected by controlMutex.
+    private: bool enabled = false;
+
+    /// \brief Protects enabled and thread.
+    private: std::mutex controlMutex;
+
+    /// \brief The writer thread.
+    private: std::unique_ptr<std::thread> thread;
+  };
+}
+
 FileLogger gazebo::common::Console::log("");
 Logger Console::msg("[Msg] ", 32, Logger::STDOUT);
 Logger Console::err("[Err] ", 31, Logger::STDERR);
@@ -49,6 +595,30 @@ bool Console::GetQuiet()
   return quiet;
 }
 
+//////////////////////////////////////////////////
+void Console::SetAsync(const bool _async)
+{
+  LogWriter::Instance().SetEnabled(_async);
+}
+
+//////////////////////////////////////////////////
+bool Console::GetAsync()
+{
+  return LogWriter::Instance().Enabled();
+}
+
+//////////////////////////////////////////////////
+void Console::Flush()
+{
+  LogWriter::Instance().Flush();
+}
+
+//////////////////////////////////////////////////
+uint64_t Console::DroppedMessages()
+{
+  return LogWriter::Instance().Dropped();
+}
+
 /////////////////////////////////////////////////
 Logger::Logger(const std::string &_prefix, int _color, LogType _type)
   : std::ostream(new Buffer(_type, _color)), color(_color), prefix(_prefix)
@@ -116,22 +686,16 @@ int Logger::Buffer::sync()
   // Output to terminal
   if (!Console::GetQuiet())
   {
-    if (this->type == Logger::STDOUT)
-    {
-      #ifndef _WIN32
-      std::cout << "\033[1;" << this->color << "m" << this->str() << "\033[0m";
-      #else
-      std::cout << this->str();
-      #endif
-    }
-    else
-    {
-      #ifndef _WIN32
-      std::cerr << "\033[1;" << this->color << "m" << this->str() << "\033[0m";
-      #else
-      std::cerr << this->str();
-      #endif
-    }
+    std::ostream *out =
+        this->type == Logger::STDOUT ? &std::cout : &std::cerr;
+    #ifndef _WIN32
+    const int termColor = this->color;
+    #else
+    const int termColor = 0;
+    #endif
+    // Queued for the writer thread, unless it doesn't run
+    if (!LogWriter::Instance().Write(out, termColor, this->str()))
+      WriteFragment(*out, termColor, this->str());
   }
 
   this->str("");
@@ -149,6 +713,8 @@ FileLogger::FileLogger(const std::string &_filename)
 /////////////////////////////////////////////////
 FileLogger::~FileLogger()
 {
+  // The writer thread may still hold messages for the file
+  Console::Flush();
   delete this->rdbuf();
 }
 
@@ -182,6 +748,7 @@ void FileLogger::Init(const std::string &_prefix, const std::string &_filename)
 
   // Check if the Init method has been already called, and if so
   // remove current buffer.
+  Console::Flush();
   if (buf->stream && buf->stream->is_open())
   {
     buf->stream->flush();
@@ -294,6 +861,13 @@ int FileLogger::Buffer::sync()
   if (!this->stream)
     return -1;
 
+  // The writer thread flushes the stream once its queue is empty
+  if (LogWriter::Instance().Write(this->stream, 0, this->str()))
+  {
+    this->str("");
+    return 0;
+  }
+
   *this->stream << this->str();
 
   this->stream->flush();
@@ -18,6 +18,7 @@
 #ifndef _GAZEBO_CONSOLE_HH_
 #define _GAZEBO_CONSOLE_HH_
 
+#include <cstdint>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -212,6 +213,34 @@ namespace gazebo
       /// \return True to if quiet output is set.
       public: static bool GetQuiet();
 
+      /// \brief Set whether messages are written by a background thread.
+      /// The loggers then only queue their messages, and a writer thread
+      /// outputs them and flushes the streams once the queue is empty, so
+      /// that a slow disk or terminal doesn't stall the threads that log.
+      /// When the queue is full messages are dropped and counted, see
+      /// DroppedMessages. A line repeated within a second is written once,
+      /// followed by the number of repeats. On by default, unless the
+      /// GAZEBO_LOG_ASYNC environment variable is 0. Messages still queued
+      /// when the process crashes are lost.
+      /// \param[in] _async True to write in the background, false to write
+      /// on the calling thread, after the queued messages are written.
+      public: static void SetAsync(const bool _async);
+
+      /// \brief Get whether messages are written by a background thread.
+      /// \return True if messages are written in the background.
+      /// \sa SetAsync
+      public: static bool GetAsync();
+
+      /// \brief Wait until the messages queued so far are written and the
+      /// streams flushed. Returns immediately when messages are written on
+      /// the calling thread.
+      public: static void Flush();
+
+      /// \brief Get the number of message fragments dropped because the
+      /// queue of the background writer was full.
+      /// \return Number of dropped fragments since the start.
+      public: static uint64_t DroppedMessages();
+
       /// \brief Global instance of the message logger.
       public: static Logger msg;
 
@@ -274,6 +274,43 @@ TEST_F(Console_TEST, ColorErr)
   EXPECT_TRUE(logContent.find(logString) != std::string::npos);
 }
 
+/////////////////////////////////////////////////
+/// \brief Test that repeated lines are written once, and that messages are
+/// written on the calling thread once asynchronous output is disabled.
+TEST_F(Console_TEST, Async)
+{
+  gazebo::common::Console::SetAsync(true);
+  EXPECT_TRUE(gazebo::common::Console::GetAsync());
+
+  const std::string logString = "this is a repeated warning";
+  for (int i = 0; i < 100; ++i)
+    gzwarn << logString << std::endl;
+  gzwarn << "this ends the repeats" << std::endl;
+
+  std::string logContent = this->GetLogContent();
+  EXPECT_NE(logContent.find(logString), std::string::npos);
+  EXPECT_NE(logContent.find("Last message repeated"), std::string::npos);
+
+  size_t count = 0;
+  for (size_t pos = logContent.find(logString); pos != std::string::npos;
+       pos = logContent.find(logString, pos + 1))
+  {
+    ++count;
+  }
+  EXPECT_LT(count, 100u);
+  EXPECT_EQ(gazebo::common::Console::DroppedMessages(), 0u);
+
+  gazebo::common::Console::SetAsync(false);
+  EXPECT_FALSE(gazebo::common::Console::GetAsync());
+
+  const std::string syncString = "this is a synchronous message";
+  gzmsg << syncString << std::endl;
+  EXPECT_NE(this->GetLogContent().find(syncString), std::string::npos);
+
+  gazebo::common::Console::SetAsync(true);
+  EXPECT_TRUE(gazebo::common::Console::GetAsync());
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -15,7 +15,19 @@
  *
 */
 
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
 #include <boost/filesystem.hpp>
 #include <gazebo/gazebo_config.h>
 
@@ -32,12 +44,37 @@
 #include "gazebo/common/DemPrivate.hh"
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/SphericalCoordinates.hh"
+#include "gazebo/common/SystemPaths.hh"
 
 using namespace gazebo;
 using namespace common;
 
 #ifdef HAVE_GDAL
 
+namespace
+{
+  /// \brief Identifies a pyramid cache file.
+  const char kPyramidMagic[4] = {'G', 'Z', 'D', 'P'};
+
+  /// \brief Version of the pyramid cache file layout.
+  const uint32_t kPyramidVersion = 1;
+
+  /// \brief Offset of the first level in a pyramid cache file. The header
+  /// is padded so the levels start on a page boundary.
+  const size_t kPyramidDataOffset = 4096;
+
+  /// \brief Header at the start of a pyramid cache file.
+  struct PyramidHeader
+  {
+    char magic[4];
+    uint32_t version;
+    uint32_t side;
+    uint32_t levelCount;
+    double minElevation;
+    double maxElevation;
+  };
+}
+
 //////////////////////////////////////////////////
 Dem::Dem()
   : dataPtr(new DemPrivate)
@@ -51,6 +88,11 @@ Dem::~Dem()
 {
   this->dataPtr->demData.clear();
 
+#ifndef _WIN32
+  if (this->dataPtr->map)
+    munmap(this->dataPtr->map, this->dataPtr->mapSize);
+#endif
+
   if (this->dataPtr->dataSet)
     GDALClose(reinterpret_cast<GDALDataset *>(this->dataPtr->dataSet));
 
@@ -139,6 +181,26 @@ int Dem::Load(const std::string &_filename)
 
   this->dataPtr->side = std::max(width, height);
 
+  // Sides of the levels, each one keeps every other height of the previous
+  // one, down to 2x2 heights.
+  this->dataPtr->level = 0;
+  this->dataPtr->levelSides.clear();
+  this->dataPtr->levelOffsets.clear();
+  size_t offset = 0;
+  for (unsigned int side = this->dataPtr->side; ; side = (side - 1) / 2 + 1)
+  {
+    this->dataPtr->levelSides.push_back(side);
+    this->dataPtr->levelOffsets.push_back(offset);
+    offset += static_cast<size_t>(side) * side;
+    if (side <= 2)
+      break;
+  }
+
+  // Map the levels cached by a previous load
+  std::string pyramidFilename = this->PyramidFilename(fullName);
+  if (!pyramidFilename.empty() && this->MapPyramid(pyramidFilename))
+    return 0;
+
   // Preload the DEM's data
   if (this->LoadData() != 0)
     return -1;
@@ -156,8 +218,11 @@ int Dem::Load(const std::string &_filename)
 
   double min = ignition::math::MAX_D;
   double max = -ignition::math::MAX_D;
-  for (auto d : this->dataPtr->demData)
+  const size_t count =
+      static_cast<size_t>(this->dataPtr->side) * this->dataPtr->side;
+  for (size_t i = 0; i < count; ++i)
   {
+    const double d = this->dataPtr->demData[i];
     if (d < min && d > noDataValue)
       min = d;
     if (d > max && d > noDataValue)
@@ -170,6 +235,17 @@ int Dem::Load(const std::string &_filename)
   this->dataPtr->minElevation = min;
   this->dataPtr->maxElevation = max;
 
+  this->BuildLevels();
+  this->dataPtr->pyramid = this->dataPtr->demData.data();
+
+  // Cache the levels, and release them so only the pages of the levels in
+  // use are read back from the file.
+  if (!pyramidFilename.empty() && this->SavePyramid(pyramidFilename) &&
+      this->MapPyramid(pyramidFilename))
+  {
+    std::vector<float>().swap(this->dataPtr->demData);
+  }
+
   return 0;
 }
 
@@ -183,7 +259,9 @@ double Dem::GetElevation(double _x, double _y)
            " x " << this->GetHeight() << "]\n");
   }
 
-  return this->dataPtr->demData.at(_y * this->GetWidth() + _x);
+  return this->dataPtr->pyramid[
+      this->dataPtr->levelOffsets[this->dataPtr->level] +
+      static_cast<size_t>(_y) * this->GetWidth() + static_cast<size_t>(_x)];
 }
 
 //////////////////////////////////////////////////
@@ -239,13 +317,39 @@ void Dem::GetGeoReferenceOrigin(ignition::math::Angle &_latitude,
 //////////////////////////////////////////////////
 unsigned int Dem::GetHeight() const
 {
-  return this->dataPtr->side;
+  return this->dataPtr->levelSides[this->dataPtr->level];
 }
 
 //////////////////////////////////////////////////
 unsigned int Dem::GetWidth() const
 {
-  return this->dataPtr->side;
+  return this->dataPtr->levelSides[this->dataPtr->level];
+}
+
+//////////////////////////////////////////////////
+unsigned int Dem::GetLevelCount() const
+{
+  return this->dataPtr->levelSides.size();
+}
+
+//////////////////////////////////////////////////
+bool Dem::SetLevel(const unsigned int _level)
+{
+  if (_level >= this->GetLevelCount())
+  {
+    gzerr << "Invalid DEM level [" << _level << "], the DEM has "
+          << this->GetLevelCount() << " levels" << std::endl;
+    return false;
+  }
+
+  this->dataPtr->level = _level;
+  return true;
+}
+
+//////////////////////////////////////////////////
+unsigned int Dem::GetLevel() const
+{
+  return this->dataPtr->level;
 }
 
 //////////////////////////////////////////////////
@@ -275,14 +379,18 @@ void Dem::FillHeightMap(int _subSampling, unsigned int _vertSize,
   // Resize the vector to match the size of the vertices.
   _heights.resize(_vertSize * _vertSize);
 
+  const unsigned int side = this->GetWidth();
+  const float *data = this->dataPtr->pyramid +
+      this->dataPtr->levelOffsets[this->dataPtr->level];
+
   // Iterate over all the vertices
   for (unsigned int y = 0; y < _vertSize; ++y)
   {
     double yf = y / static_cast<double>(_subSampling);
     unsigned int y1 = floor(yf);
     unsigned int y2 = ceil(yf);
-    if (y2 >= this->dataPtr->side)
-      y2 = this->dataPtr->side - 1;
+    if (y2 >= side)
+      y2 = side - 1;
     double dy = yf - y1;
 
     for (unsigned int x = 0; x < _vertSize; ++x)
@@ -290,16 +398,16 @@ void Dem::FillHeightMap(int _subSampling, unsigned int _vertSize,
       double xf = x / static_cast<double>(_subSampling);
       unsigned int x1 = floor(xf);
       unsigned int x2 = ceil(xf);
-      if (x2 >= this->dataPtr->side)
-        x2 = this->dataPtr->side - 1;
+      if (x2 >= side)
+        x2 = side - 1;
       double dx = xf - x1;
 
-      double px1 = this->dataPtr->demData[y1 * this->dataPtr->side + x1];
-      double px2 = this->dataPtr->demData[y1 * this->dataPtr->side + x2];
+      double px1 = data[y1 * side + x1];
+      double px2 = data[y1 * side + x2];
       float h1 = (px1 - ((px1 - px2) * dx));
 
-      double px3 = this->dataPtr->demData[y2 * this->dataPtr->side + x1];
-      double px4 = this->dataPtr->demData[y2 * this->dataPtr->side + x2];
+      double px3 = data[y2 * side + x1];
+      double px4 = data[y2 * side + x2];
       float h2 = (px3 - ((px3 - px4) * dx));
 
       float h = this->dataPtr->minElevation +
@@ -332,7 +440,6 @@ int Dem::LoadData()
     unsigned int nXSize = this->dataPtr->dataSet->GetRasterXSize();
     unsigned int nYSize = this->dataPtr->dataSet->GetRasterYSize();
     float ratio;
-    std::vector<float> buffer;
 
     if (nXSize == 0 || nYSize == 0)
     {
@@ -357,28 +464,183 @@ int Dem::LoadData()
       destWidth = static_cast<float>(destHeight) / static_cast<float>(ratio);
     }
 
+    // Room for all the levels. The vector is initialized to 0, so all the
+    // points not read from the raster will be extra padding
+    const unsigned int side = this->dataPtr->side;
+    const unsigned int lastSide = this->dataPtr->levelSides.back();
+    this->dataPtr->demData.assign(this->dataPtr->levelOffsets.back() +
+        static_cast<size_t>(lastSide) * lastSide, 0.0f);
+
     // Read the whole raster data and convert it to a GDT_Float32 array.
-    // In this step the DEM is scaled to destWidth x destHeight
-    buffer.resize(destWidth * destHeight);
-    if (this->dataPtr->band->RasterIO(GF_Read, 0, 0, nXSize, nYSize, &buffer[0],
-                         destWidth, destHeight, GDT_Float32, 0, 0) != CE_None)
+    // In this step the DEM is scaled to destWidth x destHeight, and written
+    // with a line stride of the padded side straight into level 0.
+    if (this->dataPtr->band->RasterIO(GF_Read, 0, 0, nXSize, nYSize,
+          &this->dataPtr->demData[0], destWidth, destHeight, GDT_Float32, 0,
+          static_cast<int>(side * sizeof(float))) != CE_None)
     {
       gzerr << "Failure calling RasterIO while loading a DEM file\n";
       return -1;
     }
 
-    // Copy and align 'buffer' into the target vector. The destination vector is
-    // initialized to 0, so all the points not contained in 'buffer' will be
-    // extra padding
-    this->dataPtr->demData.resize(this->GetWidth() * this->GetHeight());
-    for (unsigned int y = 0; y < destHeight; ++y)
+    return 0;
+}
+
+//////////////////////////////////////////////////
+void Dem::BuildLevels()
+{
+  for (size_t l = 1; l < this->dataPtr->levelSides.size(); ++l)
+  {
+    const unsigned int prevSide = this->dataPtr->levelSides[l - 1];
+    const unsigned int side = this->dataPtr->levelSides[l];
+    const float *prev =
+        &this->dataPtr->demData[this->dataPtr->levelOffsets[l - 1]];
+    float *level = &this->dataPtr->demData[this->dataPtr->levelOffsets[l]];
+
+    for (unsigned int y = 0; y < side; ++y)
+    {
+      const unsigned int py = std::min(y * 2, prevSide - 1);
+      for (unsigned int x = 0; x < side; ++x)
+      {
+        const unsigned int px = std::min(x * 2, prevSide - 1);
+        level[y * side + x] = prev[py * prevSide + px];
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+std::string Dem::PyramidFilename(const std::string &_filename) const
+{
+#ifndef _WIN32
+  // The cache file is named after the DEM file path, modification time and
+  // size, so a changed DEM creates a new file.
+  std::ostringstream key;
+  try
+  {
+    boost::filesystem::path path = boost::filesystem::absolute(_filename);
+    key << path.string() << " " << boost::filesystem::last_write_time(path)
+        << " " << boost::filesystem::file_size(path) << " "
+        << this->dataPtr->side;
+  }
+  catch(const boost::filesystem::filesystem_error &_e)
+  {
+    gzwarn << "Unable to cache the levels of DEM file [" << _filename
+           << "]: " << _e.what() << std::endl;
+    return "";
+  }
+
+  boost::filesystem::path dir =
+      boost::filesystem::path(common::SystemPaths::Instance()->GetLogPath()) /
+      "paging" / "dem";
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(dir, ec);
+  if (ec)
+  {
+    gzwarn << "Unable to create the DEM cache directory [" << dir.string()
+           << "]: " << ec.message() << std::endl;
+    return "";
+  }
+
+  return (dir / (common::get_sha1<std::string>(key.str()) + ".pyramid"))
+      .string();
+#else
+  (void)_filename;
+  return "";
+#endif
+}
+
+//////////////////////////////////////////////////
+bool Dem::MapPyramid(const std::string &_filename)
+{
+#ifndef _WIN32
+  int fd = open(_filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  const unsigned int lastSide = this->dataPtr->levelSides.back();
+  const size_t mapSize = kPyramidDataOffset + sizeof(float) *
+      (this->dataPtr->levelOffsets.back() +
+       static_cast<size_t>(lastSide) * lastSide);
+
+  struct stat st;
+  PyramidHeader header;
+  if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < mapSize ||
+      pread(fd, &header, sizeof(header), 0) !=
+      static_cast<ssize_t>(sizeof(header)) ||
+      std::memcmp(header.magic, kPyramidMagic, sizeof(kPyramidMagic)) != 0 ||
+      header.version != kPyramidVersion ||
+      header.side != this->dataPtr->side ||
+      header.levelCount != this->dataPtr->levelSides.size())
+  {
+    close(fd);
+    return false;
+  }
+
+  void *map = mmap(nullptr, mapSize, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+    return false;
+
+  if (this->dataPtr->map)
+    munmap(this->dataPtr->map, this->dataPtr->mapSize);
+
+  this->dataPtr->map = map;
+  this->dataPtr->mapSize = mapSize;
+  this->dataPtr->pyramid = reinterpret_cast<const float *>(
+      static_cast<const char *>(map) + kPyramidDataOffset);
+  this->dataPtr->minElevation = header.minElevation;
+  this->dataPtr->maxElevation = header.maxElevation;
+
+  return true;
+#else
+  (void)_filename;
+  return false;
+#endif
+}
+
+//////////////////////////////////////////////////
+bool Dem::SavePyramid(const std::string &_filename) const
+{
+  // Write to a temporary file first, so a concurrent load never maps a
+  // partial file.
+  std::string tmpFilename = _filename + ".tmp";
+  {
+    std::ofstream out(tmpFilename, std::ios::binary | std::ios::trunc);
+    if (!out)
+      return false;
+
+    PyramidHeader header;
+    std::memcpy(header.magic, kPyramidMagic, sizeof(kPyramidMagic));
+    header.version = kPyramidVersion;
+    header.side = this->dataPtr->side;
+    header.levelCount = this->dataPtr->levelSides.size();
+    header.minElevation = this->dataPtr->minElevation;
+    header.maxElevation = this->dataPtr->maxElevation;
+
+    std::vector<char> padding(kPyramidDataOffset, 0);
+    std::memcpy(padding.data(), &header, sizeof(header));
+    out.write(padding.data(), padding.size());
+    out.write(reinterpret_cast<const char *>(this->dataPtr->demData.data()),
+        this->dataPtr->demData.size() * sizeof(float));
+
+    if (!out)
     {
-        std::copy(&buffer[destWidth * y], &buffer[destWidth * y] + destWidth,
-                  this->dataPtr->demData.begin() + this->GetWidth() * y);
+      gzwarn << "Unable to write DEM cache file [" << tmpFilename << "]\n";
+      return false;
     }
-    buffer.clear();
+  }
 
-    return 0;
+  boost::system::error_code ec;
+  boost::filesystem::rename(tmpFilename, _filename, ec);
+  if (ec)
+  {
+    gzwarn << "Unable to write DEM cache file [" << _filename << "]: "
+           << ec.message() << std::endl;
+    boost::filesystem::remove(tmpFilename, ec);
+    return false;
+  }
+
+  return true;
 }
 
 #endif
@@ -75,8 +75,8 @@ namespace gazebo
       public: void GetGeoReferenceOrigin(ignition::math::Angle &_latitude,
                   ignition::math::Angle &_longitude) const;
 
-      /// \brief Get the terrain's height. Due to the Ogre constrains, this
-      /// value will be a power of two plus one. The value returned might be
+      /// \brief Get the terrain's height at the selected level. Due to the
+      /// Ogre constrains, this value will be a power of two plus one. The value returned might be
       /// different that the original DEM height because GetData() adds the
       /// padding if necessary.
       /// \return The terrain's height (points) satisfying the ogre constrains
@@ -84,8 +84,8 @@ namespace gazebo
       /// one).
       public: unsigned int GetHeight() const;
 
-      /// \brief Get the terrain's width. Due to the Ogre constrains, this
-      /// value will be a power of two plus one. The value returned might be
+      /// \brief Get the terrain's width at the selected level. Due to the
+      /// Ogre constrains, this value will be a power of two plus one. The value returned might be
       /// different that the original DEM width because GetData() adds the
       /// padding if necessary.
       /// \return The terrain's width (points) satisfying the ogre constrains
@@ -93,6 +93,26 @@ namespace gazebo
       /// one).
       public: unsigned int GetWidth() const;
 
+      /// \brief Get the number of resolution levels. Level 0 is the full
+      /// resolution, and each level has half the resolution of the previous
+      /// one. The levels are built once and cached in the paging directory
+      /// of the log path, later loads of the same file map the cache instead
+      /// of reading the DEM.
+      /// \return Number of levels.
+      public: unsigned int GetLevelCount() const;
+
+      /// \brief Select the resolution level used by GetWidth, GetHeight,
+      /// GetElevation and FillHeightMap. Only the selected level is read
+      /// from the cache.
+      /// \param[in] _level Level, 0 for the full resolution.
+      /// \return False if _level is not less than GetLevelCount().
+      public: bool SetLevel(const unsigned int _level);
+
+      /// \brief Get the selected resolution level.
+      /// \return The level.
+      /// \sa SetLevel
+      public: unsigned int GetLevel() const;
+
       /// \brief Get the real world width in meters.
       /// \return Terrain's real world width in meters.
       public: double GetWorldWidth() const;
@@ -134,6 +154,26 @@ namespace gazebo
       /// \return 0 when the operation succeeds to open a file.
       private: int LoadData();
 
+      /// \brief Fill the lower resolution levels from level 0, by keeping
+      /// every other height of the previous level.
+      private: void BuildLevels();
+
+      /// \brief Get the path of the pyramid cache file of a DEM file.
+      /// \param[in] _filename Full path of the DEM file.
+      /// \return Path of the cache file, or an empty string if the levels
+      /// can't be cached.
+      private: std::string PyramidFilename(const std::string &_filename) const;
+
+      /// \brief Map a pyramid cache file.
+      /// \param[in] _filename Path of the cache file.
+      /// \return False if the file doesn't exist or doesn't match the DEM.
+      private: bool MapPyramid(const std::string &_filename);
+
+      /// \brief Write the levels to a pyramid cache file.
+      /// \param[in] _filename Path of the cache file.
+      /// \return True if the file was written.
+      private: bool SavePyramid(const std::string &_filename) const;
+
       /// internal
       /// \brief Pointer to the private data.
       private: DemPrivate *dataPtr;
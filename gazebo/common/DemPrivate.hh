@@ -23,6 +23,7 @@
 
 #ifdef HAVE_GDAL
 # include <gdal_priv.h>
+# include <cstddef>
 # include <vector>
 
 namespace gazebo
@@ -57,8 +58,28 @@ namespace gazebo
       /// \brief Maximum elevation in meters.
       public: double maxElevation;
 
-      /// \brief DEM data converted to be OGRE-compatible.
+      /// \brief DEM data converted to be OGRE-compatible, followed by the
+      /// lower resolution levels. Empty if the levels are memory-mapped.
       public: std::vector<float> demData;
+
+      /// \brief Side of each level, level 0 is the full resolution.
+      public: std::vector<unsigned int> levelSides;
+
+      /// \brief Offset of each level in the pyramid, in heights.
+      public: std::vector<size_t> levelOffsets;
+
+      /// \brief Level used by GetElevation and FillHeightMap.
+      public: unsigned int level = 0;
+
+      /// \brief Heights of all the levels, in demData or in the mapped
+      /// cache file.
+      public: const float *pyramid = nullptr;
+
+      /// \brief Memory-mapped pyramid cache file, null if not mapped.
+      public: void *map = nullptr;
+
+      /// \brief Size of the memory-mapped file in bytes.
+      public: size_t mapSize = 0;
     };
     /// \}
   }
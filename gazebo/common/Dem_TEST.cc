@@ -167,6 +167,60 @@ TEST_F(DemTest, FillHeightmap)
   EXPECT_FLOAT_EQ(213.42966, elevations.at(elevations.size() / 2));
 }
 
+/////////////////////////////////////////////////
+TEST_F(DemTest, Levels)
+{
+  common::Dem dem;
+  boost::filesystem::path path = TEST_PATH;
+
+  path /= "data/dem_squared.tif";
+  EXPECT_EQ(dem.Load(path.string()), 0);
+
+  // 129, 65, 33, 17, 9, 5, 3 and 2 heights per side
+  EXPECT_EQ(8u, dem.GetLevelCount());
+  EXPECT_EQ(0u, dem.GetLevel());
+  EXPECT_FALSE(dem.SetLevel(8));
+  EXPECT_EQ(0u, dem.GetLevel());
+
+  double corner = dem.GetElevation(128, 128);
+  double center = dem.GetElevation(64, 64);
+
+  // Each level keeps every other height of the previous one
+  EXPECT_TRUE(dem.SetLevel(1));
+  EXPECT_EQ(1u, dem.GetLevel());
+  EXPECT_EQ(65u, dem.GetWidth());
+  EXPECT_EQ(65u, dem.GetHeight());
+  EXPECT_FLOAT_EQ(215.82324, dem.GetElevation(0, 0));
+  EXPECT_FLOAT_EQ(corner, dem.GetElevation(64, 64));
+  EXPECT_FLOAT_EQ(center, dem.GetElevation(32, 32));
+  ASSERT_ANY_THROW(dem.GetElevation(65, 0));
+
+  EXPECT_TRUE(dem.SetLevel(7));
+  EXPECT_EQ(2u, dem.GetWidth());
+  EXPECT_FLOAT_EQ(corner, dem.GetElevation(1, 1));
+
+  // Fill a height map from a lower level
+  EXPECT_TRUE(dem.SetLevel(2));
+  std::vector<float> elevations;
+  ignition::math::Vector3d size(dem.GetWorldWidth(), dem.GetWorldHeight(),
+      dem.GetMaxElevation() - dem.GetMinElevation());
+  dem.FillHeightMap(1, dem.GetWidth(), size, ignition::math::Vector3d::One,
+      false, elevations);
+  EXPECT_EQ(33u * 33u, elevations.size());
+  EXPECT_FLOAT_EQ(center, elevations.at(16 * 33 + 16));
+
+  // A second load maps the cached levels
+  common::Dem cached;
+  EXPECT_EQ(cached.Load(path.string()), 0);
+  EXPECT_EQ(8u, cached.GetLevelCount());
+  EXPECT_FLOAT_EQ(dem.GetMinElevation(), cached.GetMinElevation());
+  EXPECT_FLOAT_EQ(dem.GetMaxElevation(), cached.GetMaxElevation());
+  EXPECT_FLOAT_EQ(215.82324, cached.GetElevation(0, 0));
+  EXPECT_FLOAT_EQ(corner, cached.GetElevation(128, 128));
+  EXPECT_TRUE(cached.SetLevel(1));
+  EXPECT_FLOAT_EQ(center, cached.GetElevation(32, 32));
+}
+
 /////////////////////////////////////////////////
 TEST_F(DemTest, NegDem)
 {
@@ -15,12 +15,53 @@
  *
  */
 
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Event.hh"
 
 using namespace gazebo;
 using namespace event;
 
+namespace
+{
+  /// \brief Get whether GAZEBO_PLUGIN_COSTS enables accounting.
+  /// \return True if it's enabled.
+  bool CostsEnabledByEnv()
+  {
+    const char *env = common::getEnv("GAZEBO_PLUGIN_COSTS");
+    return env && std::string(env) == "1";
+  }
+
+  /// \brief The costs of all the owners.
+  class CallbackCosts
+  {
+    /// \brief Protects costs.
+    public: std::mutex mutex;
+
+    /// \brief The costs, by owner.
+    public: std::map<std::string, std::shared_ptr<CallbackCost>> costs;
+  };
+
+  /// \brief Get the costs of all the owners.
+  /// \return The costs.
+  CallbackCosts &Costs()
+  {
+    static CallbackCosts costs;
+    return costs;
+  }
+
+  /// \brief Cost of the current owner of the thread.
+  thread_local std::shared_ptr<CallbackCost> g_currentCost;
+}
+
+std::atomic<bool> CallbackCost::enabled(CostsEnabledByEnv());
+
 //////////////////////////////////////////////////
 Event::Event()
   : signaled(false)
@@ -75,3 +116,57 @@ int Connection::Id() const
 {
   return this->id;
 }
+
+//////////////////////////////////////////////////
+CallbackCost::CallbackCost(const std::string &_owner)
+  : owner(_owner)
+{
+}
+
+//////////////////////////////////////////////////
+void CallbackCost::SetEnabled(const bool _enabled)
+{
+  enabled = _enabled;
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<CallbackCost> CallbackCost::Find(const std::string &_owner)
+{
+  CallbackCosts &costs = Costs();
+  std::lock_guard<std::mutex> lock(costs.mutex);
+  auto &cost = costs.costs[_owner];
+  if (!cost)
+    cost = std::make_shared<CallbackCost>(_owner);
+  return cost;
+}
+
+//////////////////////////////////////////////////
+std::vector<std::shared_ptr<CallbackCost>> CallbackCost::All()
+{
+  CallbackCosts &costs = Costs();
+  std::lock_guard<std::mutex> lock(costs.mutex);
+  std::vector<std::shared_ptr<CallbackCost>> result;
+  result.reserve(costs.costs.size());
+  for (const auto &cost : costs.costs)
+    result.push_back(cost.second);
+  return result;
+}
+
+//////////////////////////////////////////////////
+ConnectionOwner::ConnectionOwner(const std::string &_owner)
+  : previous(g_currentCost)
+{
+  g_currentCost = CallbackCost::Find(_owner);
+}
+
+//////////////////////////////////////////////////
+ConnectionOwner::~ConnectionOwner()
+{
+  g_currentCost = this->previous;
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<CallbackCost> ConnectionOwner::Current()
+{
+  return g_currentCost;
+}
@@ -19,14 +19,17 @@
 
 #include <atomic>
 #include <functional>
-#include <list>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <gazebo/gazebo_config.h>
 #include <gazebo/common/Time.hh>
 #include <gazebo/common/CommonTypes.hh>
+#include <gazebo/common/Profiler.hh>
 #include "gazebo/util/system.hh"
 
 namespace gazebo
@@ -64,6 +67,84 @@ namespace gazebo
       private: bool signaled;
     };
 
+    /// \class CallbackCost Event.hh common/common.hh
+    /// \brief Time spent in the callbacks of the connections of an owner,
+    /// such as a plugin, and number of calls. Callbacks are only timed
+    /// while accounting is enabled.
+    ///
+    /// \remarks Environment Variables:
+    /// GAZEBO_PLUGIN_COSTS: Set to 1 to enable accounting at startup.
+    class GZ_COMMON_VISIBLE CallbackCost
+    {
+      /// \brief Constructor.
+      /// \param[in] _owner Name of the owner.
+      public: explicit CallbackCost(const std::string &_owner);
+
+      /// \brief Add the time of a call.
+      /// \param[in] _nanoseconds Time of the call.
+      public: void Add(const int64_t _nanoseconds)
+              {
+                ++this->calls;
+                this->nanoseconds += _nanoseconds;
+              }
+
+      /// \brief Get whether callbacks are timed.
+      /// \return True if accounting is enabled.
+      public: static bool Enabled()
+              {
+                return enabled.load(std::memory_order_relaxed);
+              }
+
+      /// \brief Enable or disable accounting. The costs accounted while
+      /// it was enabled are kept.
+      /// \param[in] _enabled True to time callbacks.
+      public: static void SetEnabled(const bool _enabled);
+
+      /// \brief Get the cost of an owner, created on first use.
+      /// \param[in] _owner Name of the owner.
+      /// \return The cost, shared by the connections of the owner.
+      public: static std::shared_ptr<CallbackCost> Find(
+                  const std::string &_owner);
+
+      /// \brief Get the costs of all the owners.
+      /// \return The costs, ordered by owner.
+      public: static std::vector<std::shared_ptr<CallbackCost>> All();
+
+      /// \brief Name of the owner.
+      public: const std::string owner;
+
+      /// \brief Number of timed calls.
+      public: std::atomic<uint64_t> calls{0};
+
+      /// \brief Total time of the timed calls, in nanoseconds.
+      public: std::atomic<int64_t> nanoseconds{0};
+
+      /// \brief True if callbacks are timed.
+      private: static std::atomic<bool> enabled;
+    };
+
+    /// \class ConnectionOwner Event.hh common/common.hh
+    /// \brief Accounts the callbacks of the connections made by the
+    /// calling thread during the lifetime of this object to an owner.
+    /// Plugins are owners of the connections made in their Load and Init
+    /// functions.
+    class GZ_COMMON_VISIBLE ConnectionOwner
+    {
+      /// \brief Constructor.
+      /// \param[in] _owner Name of the owner.
+      public: explicit ConnectionOwner(const std::string &_owner);
+
+      /// \brief Destructor, which restores the previous owner.
+      public: ~ConnectionOwner();
+
+      /// \brief Get the cost of the current owner of the thread.
+      /// \return The cost, or nullptr if there is no owner.
+      public: static std::shared_ptr<CallbackCost> Current();
+
+      /// \brief Cost of the owner which was current before this one.
+      private: std::shared_ptr<CallbackCost> previous;
+    };
+
     /// \brief A class that encapsulates a connection.
     class GZ_COMMON_VISIBLE Connection
     {
@@ -93,6 +174,13 @@ namespace gazebo
     };
 
     /// \brief A class for event processing.
+    ///
+    /// Signal iterates an immutable snapshot of the connections without
+    /// locking, so that events signaled at every step cost a call per
+    /// connection. Connect and Disconnect copy the connections into a new
+    /// snapshot instead. A callback may connect and disconnect while the
+    /// event is signaled: connections it disconnects aren't called anymore,
+    /// and the ones it connects are called from the next signal.
     template<typename T>
     class EventT : public Event
     {
@@ -268,13 +356,12 @@ namespace gazebo
       /// \brief Signal the event for all subscribers.
       public: void Signal()
       {
-        this->Cleanup();
-
         this->SetSignaled(true);
-        for (const auto &iter: this->connections)
+        const auto conns = this->Connections();
+        for (const auto &conn : *conns)
         {
-          if (iter.second->on)
-            iter.second->callback();
+          if (conn->on)
+            conn->Call();
         }
       }
 
@@ -283,13 +370,12 @@ namespace gazebo
       public: template< typename P >
               void Signal(const P &_p)
       {
-        this->Cleanup();
-
         this->SetSignaled(true);
-        for (const auto &iter: this->connections)
+        const auto conns = this->Connections();
+        for (const auto &conn : *conns)
         {
-          if (iter.second->on)
-            iter.second->callback(_p);
+          if (conn->on)
+            conn->Call(_p);
         }
       }
 
@@ -299,13 +385,12 @@ namespace gazebo
       public: template< typename P1, typename P2 >
               void Signal(const P1 &_p1, const P2 &_p2)
       {
-        this->Cleanup();
-
         this->SetSignaled(true);
-        for (const auto &iter: this->connections)
+        const auto conns = this->Connections();
+        for (const auto &conn : *conns)
         {
-          if (iter.second->on)
-            iter.second->callback(_p1, _p2);
+          if (conn->on)
+            conn->Call(_p1, _p2);
         }
       }
 
@@ -316,13 +401,12 @@ namespace gazebo
       public: template< typename P1, typename P2, typename P3 >
               void Signal(const P1 &_p1, const P2 &_p2, const P3 &_p3)
       {
-        this->Cleanup();
-
         this->SetSignaled(true);
-        for (const auto &iter: this->connections)
+        const auto conns = this->Connections();
+        for (const auto &conn : *conns)
         {
-          if (iter.second->on)
-            iter.second->callback(_p1, _p2, _p3);
+          if (conn->on)
+            conn->Call(_p1, _p2, _p3);
         }
       }
 
@@ -335,13 +419,12 @@ namespace gazebo
               void Signal(const P1 &_p1, const P2 &_p2, const P3 &_p3,
                           const P4 &_p4)
       {
-        this->Cleanup();
-
         this->SetSignaled(true);
-        for (const auto &iter: this->connections)
+        const auto conns = this->Connections();
+        for (const auto &conn : *conns)
         {
-          if (iter.second->on)
-            iter.second->callback(_p1, _p2, _p3, _p4);
+          if (conn->on)
+            conn->Call(_p1, _p2, _p3, _p4);
         }
       }
 
@@ -356,13 +439,12 @@ namespace gazebo
               void Signal(const P1 &_p1, const P2 &_p2, const P3 &_p3,
                           const P4 &_p4, const P5 &_p5)
       {
-        this->Cleanup();
-
         this->SetSignaled(true);
-        for (const auto &iter: this->connections)
+        const auto conns = this->Connections();
+        for (const auto &conn : *conns)
         {
-          if (iter.second->on)
-            iter.second->callback(_p1, _p2, _p3, _p4, _p5);
+          if (conn->on)
+            conn->Call(_p1, _p2, _p3, _p4, _p5);
         }
       }
 
@@ -378,13 +460,12 @@ namespace gazebo
               void Signal(const P1 &_p1, const P2 &_p2, const P3 &_p3,
                   const P4 &_p4, const P5 &_p5, const P6 &_p6)
       {
-        this->Cleanup();
-
         this->SetSignaled(true);
-        for (const auto &iter: this->connections)
+        const auto conns = this->Connections();
+        for (const auto &conn : *conns)
         {
-          if (iter.second->on)
-            iter.second->callback(_p1, _p2, _p3, _p4, _p5, _p6);
+          if (conn->on)
+            conn->Call(_p1, _p2, _p3, _p4, _p5, _p6);
         }
       }
 
@@ -401,13 +482,12 @@ namespace gazebo
               void Signal(const P1 &_p1, const P2 &_p2, const P3 &_p3,
                   const P4 &_p4, const P5 &_p5, const P6 &_p6, const P7 &_p7)
       {
-        this->Cleanup();
-
         this->SetSignaled(true);
-        for (const auto &iter: this->connections)
+        const auto conns = this->Connections();
+        for (const auto &conn : *conns)
         {
-          if (iter.second->on)
-            iter.second->callback(_p1, _p2, _p3, _p4, _p5, _p6, _p7);
+          if (conn->on)
+            conn->Call(_p1, _p2, _p3, _p4, _p5, _p6, _p7);
         }
       }
 
@@ -426,14 +506,13 @@ namespace gazebo
                   const P4 &_p4, const P5 &_p5, const P6 &_p6, const P7 &_p7,
                   const P8 &_p8)
       {
-        this->Cleanup();
-
         this->SetSignaled(true);
-        for (const auto &iter: this->connections)
+        const auto conns = this->Connections();
+        for (const auto &conn : *conns)
         {
-          if (iter.second->on)
+          if (conn->on)
           {
-            iter.second->callback(_p1, _p2, _p3, _p4, _p5, _p6, _p7, _p8);
+            conn->Call(_p1, _p2, _p3, _p4, _p5, _p6, _p7, _p8);
           }
         }
       }
@@ -455,14 +534,13 @@ namespace gazebo
                   const P4 &_p4, const P5 &_p5, const P6 &_p6, const P7 &_p7,
                   const P8 &_p8, const P9 &_p9)
       {
-        this->Cleanup();
-
         this->SetSignaled(true);
-        for (const auto &iter: this->connections)
+        const auto conns = this->Connections();
+        for (const auto &conn : *conns)
         {
-          if (iter.second->on)
+          if (conn->on)
           {
-            iter.second->callback(
+            conn->Call(
                 _p1, _p2, _p3, _p4, _p5, _p6, _p7, _p8, _p9);
           }
         }
@@ -486,24 +564,18 @@ namespace gazebo
                   const P4 &_p4, const P5 &_p5, const P6 &_p6, const P7 &_p7,
                   const P8 &_p8, const P9 &_p9, const P10 &_p10)
       {
-        this->Cleanup();
-
         this->SetSignaled(true);
-        for (const auto &iter: this->connections)
+        const auto conns = this->Connections();
+        for (const auto &conn : *conns)
         {
-          if (iter.second->on)
+          if (conn->on)
           {
-            iter.second->callback(
+            conn->Call(
                 _p1, _p2, _p3, _p4, _p5, _p6, _p7, _p8, _p9, _p10);
           }
         }
       }
 
-      /// \internal
-      /// \brief Removes queued connections.
-      /// We assume that this function is called from a Signal function.
-      private: void Cleanup();
-
       /// \brief A private helper class used in maintaining connections.
       private: class EventConnection
       {
@@ -519,29 +591,69 @@ namespace gazebo
         /// \brief On/off value for the event callback
         public: std::atomic_bool on;
 
+        /// \brief Call the callback, timing it if it has an owner and
+        /// accounting is enabled.
+        /// \param[in] _args Arguments of the callback.
+        public: template<typename... Args>
+                void Call(const Args &... _args)
+        {
+          if (this->cost && CallbackCost::Enabled())
+          {
+            const int64_t start = common::Profiler::Now();
+            this->callback(_args...);
+            this->cost->Add(common::Profiler::Now() - start);
+          }
+          else
+          {
+            this->callback(_args...);
+          }
+        }
+
         /// \brief Callback function
         public: std::function<T> callback;
+
+        /// \brief Cost of the owner of the connection, or nullptr.
+        public: std::shared_ptr<CallbackCost> cost;
       };
 
       /// \def EvtConnectionMap
       /// \brief Event Connection map typedef.
-      typedef std::map<int, std::unique_ptr<EventConnection>> EvtConnectionMap;
+      typedef std::map<int, std::shared_ptr<EventConnection>> EvtConnectionMap;
+
+      /// \def EvtConnectionList
+      /// \brief Event Connection snapshot typedef.
+      typedef std::vector<std::shared_ptr<EventConnection>> EvtConnectionList;
 
-      /// \brief Array of connection callbacks.
+      /// \internal
+      /// \brief Get the snapshot of the connections to signal.
+      /// \return The connections, in the order they were connected.
+      private: std::shared_ptr<const EvtConnectionList> Connections() const;
+
+      /// \internal
+      /// \brief Replace the snapshot of the connections to signal with
+      /// the current connections. The mutex must be locked.
+      private: void Publish();
+
+      /// \brief Array of connection callbacks, by id.
       private: EvtConnectionMap connections;
 
-      /// \brief A thread lock.
-      private: std::mutex mutex;
+      /// \brief Snapshot of the connections, which Signal iterates. It's
+      /// only accessed through std::atomic_load and std::atomic_store.
+      /// Signals in progress keep the previous snapshots, and their
+      /// connections, alive.
+      private: std::shared_ptr<const EvtConnectionList> signalConnections;
+
+      /// \brief Id of the next connection.
+      private: int nextId = 0;
 
-      /// \brief List of connections to remove
-      private: std::list<typename EvtConnectionMap::const_iterator>
-              connectionsToRemove;
+      /// \brief A thread lock, for Connect and Disconnect.
+      private: std::mutex mutex;
     };
 
     /// \brief Constructor.
     template<typename T>
     EventT<T>::EventT()
-    : Event()
+    : Event(), signalConnections(std::make_shared<const EvtConnectionList>())
     {
     }
 
@@ -549,7 +661,9 @@ namespace gazebo
     template<typename T>
     EventT<T>::~EventT()
     {
+      std::lock_guard<std::mutex> lock(this->mutex);
       this->connections.clear();
+      this->Publish();
     }
 
     /// \brief Adds a connection.
@@ -557,13 +671,15 @@ namespace gazebo
     template<typename T>
     ConnectionPtr EventT<T>::Connect(const std::function<T> &_subscriber)
     {
-      int index = 0;
-      if (!this->connections.empty())
-      {
-        auto const &iter = this->connections.rbegin();
-        index = iter->first + 1;
-      }
-      this->connections[index].reset(new EventConnection(true, _subscriber));
+      std::lock_guard<std::mutex> lock(this->mutex);
+
+      // Ids aren't reused, so that disconnecting an id twice doesn't
+      // disconnect a newer connection
+      const int index = this->nextId++;
+      auto connection = std::make_shared<EventConnection>(true, _subscriber);
+      connection->cost = ConnectionOwner::Current();
+      this->connections[index] = connection;
+      this->Publish();
       return ConnectionPtr(new Connection(this, index));
     }
 
@@ -572,7 +688,7 @@ namespace gazebo
     template<typename T>
     unsigned int EventT<T>::ConnectionCount() const
     {
-      return this->connections.size();
+      return this->Connections()->size();
     }
 
     /// \brief Removes a connection.
@@ -580,25 +696,39 @@ namespace gazebo
     template<typename T>
     void EventT<T>::Disconnect(int _id)
     {
+      std::lock_guard<std::mutex> lock(this->mutex);
+
       // Find the connection
       auto const &it = this->connections.find(_id);
 
       if (it != this->connections.end())
       {
+        // A signal in progress may still hold the connection in its
+        // snapshot, and must skip it
         it->second->on = false;
-        this->connectionsToRemove.push_back(it);
+        this->connections.erase(it);
+        this->Publish();
       }
     }
 
     /////////////////////////////////////////////
     template<typename T>
-    void EventT<T>::Cleanup()
+    std::shared_ptr<const typename EventT<T>::EvtConnectionList>
+    EventT<T>::Connections() const
     {
-      std::lock_guard<std::mutex> lock(this->mutex);
-      // Remove all queue connections.
-      for (auto &conn : this->connectionsToRemove)
-        this->connections.erase(conn);
-      this->connectionsToRemove.clear();
+      return std::atomic_load(&this->signalConnections);
+    }
+
+    /////////////////////////////////////////////
+    template<typename T>
+    void EventT<T>::Publish()
+    {
+      auto conns = std::make_shared<EvtConnectionList>();
+      conns->reserve(this->connections.size());
+      for (const auto &iter : this->connections)
+        conns->push_back(iter.second);
+      std::atomic_store(&this->signalConnections,
+          std::shared_ptr<const EvtConnectionList>(std::move(conns)));
     }
     /// \}
   }
@@ -15,7 +15,10 @@
  *
 */
 
+#include <atomic>
 #include <functional>
+#include <thread>
+#include <vector>
 #include <gtest/gtest.h>
 #include <gazebo/common/Time.hh>
 #include <gazebo/common/Event.hh>
@@ -220,6 +223,120 @@ TEST_F(EventTest, ManyChanges)
   EXPECT_EQ(g_callback1, 2);
 }
 
+/////////////////////////////////////////////////
+TEST_F(EventTest, ConnectionCount)
+{
+  event::EventT<void ()> evt;
+  EXPECT_EQ(0u, evt.ConnectionCount());
+
+  event::ConnectionPtr conn = evt.Connect(std::bind(&callback));
+  event::ConnectionPtr conn1 = evt.Connect(std::bind(&callback1));
+  EXPECT_EQ(2u, evt.ConnectionCount());
+
+  // Disconnecting is immediate, without waiting for a signal
+  conn.reset();
+  EXPECT_EQ(1u, evt.ConnectionCount());
+
+  // Ids aren't reused
+  conn = evt.Connect(std::bind(&callback));
+  EXPECT_NE(conn->Id(), conn1->Id());
+  evt.Disconnect(conn1->Id());
+  EXPECT_EQ(1u, evt.ConnectionCount());
+}
+
+/////////////////////////////////////////////////
+TEST_F(EventTest, CallbackConnect)
+{
+  g_callback = 0;
+  g_callback1 = 0;
+
+  // A connection made in a callback is signaled from the next signal
+  event::EventT<void ()> evt;
+  event::ConnectionPtr conn1;
+  event::ConnectionPtr conn = evt.Connect([&]()
+      {
+        if (!conn1)
+          conn1 = evt.Connect(std::bind(&callback1));
+        callback();
+      });
+
+  evt();
+  EXPECT_EQ(1, g_callback);
+  EXPECT_EQ(0, g_callback1);
+
+  evt();
+  EXPECT_EQ(2, g_callback);
+  EXPECT_EQ(1, g_callback1);
+}
+
+/////////////////////////////////////////////////
+TEST_F(EventTest, SignalWhileConnecting)
+{
+  event::EventT<void (int)> evt;
+  std::atomic<int> sum(0);
+  event::ConnectionPtr conn = evt.Connect([&](int _v) {sum += _v;});
+
+  evt(1);
+
+  // Connect and disconnect from another thread while signaling
+  std::vector<event::ConnectionPtr> others;
+  std::thread thread([&]()
+      {
+        for (unsigned int i = 0; i < 1000; ++i)
+        {
+          others.push_back(evt.Connect([](int) {}));
+          evt.Disconnect(others.back()->Id());
+        }
+      });
+
+  for (unsigned int i = 1; i < 1000; ++i)
+    evt(1);
+  thread.join();
+  others.clear();
+
+  EXPECT_EQ(1000, sum);
+  EXPECT_EQ(1u, evt.ConnectionCount());
+}
+
+/////////////////////////////////////////////////
+TEST_F(EventTest, CallbackCost)
+{
+  g_callback = 0;
+  g_callback1 = 0;
+
+  event::EventT<void ()> evt;
+  event::ConnectionPtr conn;
+  {
+    event::ConnectionOwner owner("EventTest::CallbackCost");
+    conn = evt.Connect(std::bind(&callback));
+  }
+  event::ConnectionPtr conn1 = evt.Connect(std::bind(&callback1));
+
+  EXPECT_FALSE(event::ConnectionOwner::Current());
+  auto cost = event::CallbackCost::Find("EventTest::CallbackCost");
+  ASSERT_TRUE(cost != nullptr);
+  EXPECT_EQ("EventTest::CallbackCost", cost->owner);
+
+  // Not timed while disabled
+  event::CallbackCost::SetEnabled(false);
+  evt();
+  EXPECT_EQ(0u, cost->calls.load());
+
+  event::CallbackCost::SetEnabled(true);
+  evt();
+  evt();
+  event::CallbackCost::SetEnabled(false);
+  EXPECT_EQ(2u, cost->calls.load());
+  EXPECT_GE(cost->nanoseconds.load(), 0);
+  EXPECT_EQ(3, g_callback);
+  EXPECT_EQ(3, g_callback1);
+
+  bool found = false;
+  for (const auto &other : event::CallbackCost::All())
+    found = found || other == cost;
+  EXPECT_TRUE(found);
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -18,8 +18,12 @@
 #include <sys/stat.h>
 #include <tinyxml.h>
 
+#include <algorithm>
+#include <atomic>
 #include <functional>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <thread>
 #include <vector>
@@ -238,6 +242,60 @@ std::string FuelModelDatabase::ModelPath(const std::string &_uri,
   return path;
 }
 
+/////////////////////////////////////////////////
+std::vector<std::string> FuelModelDatabase::DownloadModels(
+    const std::vector<std::string> &_uris)
+{
+  static const unsigned int maxThreads = []() -> unsigned int
+  {
+    const char *env = getenv("GAZEBO_MODEL_DOWNLOAD_THREADS");
+    if (env)
+    {
+      try
+      {
+        return std::max(1, std::stoi(env));
+      }
+      catch(...)
+      {
+        gzwarn << "Invalid GAZEBO_MODEL_DOWNLOAD_THREADS[" << env
+               << "], downloading one model at a time.\n";
+        return 1;
+      }
+    }
+    return 8;
+  }();
+
+  const std::set<std::string> unique(_uris.begin(), _uris.end());
+  const std::vector<std::string> uris(unique.begin(), unique.end());
+  std::vector<std::string> paths(uris.size());
+
+  std::atomic<std::size_t> next(0);
+  auto downloadModels = [&]()
+  {
+    for (std::size_t i = next++; i < uris.size(); i = next++)
+      paths[i] = this->ModelPath(uris[i]);
+  };
+
+  const unsigned int threadCount =
+      std::min<std::size_t>(maxThreads, uris.size());
+  std::vector<std::thread> threads;
+  for (unsigned int i = 1; i < threadCount; ++i)
+    threads.emplace_back(downloadModels);
+  if (threadCount > 0)
+    downloadModels();
+  for (auto &thread : threads)
+    thread.join();
+
+  std::map<std::string, std::string> pathsByUri;
+  for (std::size_t i = 0; i < uris.size(); ++i)
+    pathsByUri[uris[i]] = paths[i];
+
+  std::vector<std::string> result;
+  for (auto const &uri : _uris)
+    result.push_back(pathsByUri[uri]);
+  return result;
+}
+
 /////////////////////////////////////////////////
 std::string FuelModelDatabase::CachedFilePath(const std::string &_uri)
 {
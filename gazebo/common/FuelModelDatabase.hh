@@ -49,6 +49,11 @@ namespace gazebo
     /// \class FuelModelDatabase FuelModelDatabase.hh common/common.hh
     /// \brief Connects to an Igniiton Fuel model database, and has utility
     /// functions to find models.
+    ///
+    /// \remarks
+    ///  Environment Variables:
+    ///   - GAZEBO_MODEL_DOWNLOAD_THREADS: Number of models DownloadModels
+    ///     fetches at the same time. Defaults to 8.
     class GZ_COMMON_VISIBLE FuelModelDatabase
       : public SingletonT<FuelModelDatabase>
     {
@@ -103,6 +108,14 @@ namespace gazebo
       public: std::string ModelPath(const std::string &_uri,
         const bool _forceDownload = false);
 
+      /// \brief Get the local paths of several models, downloading the
+      /// ones that aren't cached in parallel.
+      /// \param[in] _uris The model URIs.
+      /// \return Local paths to the model directories, in the order of
+      /// _uris. A path is empty if its model can't be downloaded.
+      public: std::vector<std::string> DownloadModels(
+          const std::vector<std::string> &_uris);
+
       /// \brief Get the full local path to a cached file based on its URI.
       /// \param[in] _uri The file's URI
       /// \return Local path to the file
@@ -15,6 +15,12 @@
  *
 */
 
+#include <atomic>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <boost/filesystem.hpp>
 #include <gazebo/gazebo_config.h>
 
 #ifdef HAVE_GDAL
@@ -26,6 +32,7 @@
 #endif
 
 #include "gazebo/common/Console.hh"
+#include "gazebo/common/MemoryTracker.hh"
 #include "gazebo/common/ImageHeightmap.hh"
 #include "gazebo/common/HeightmapData.hh"
 #include "gazebo/common/Dem.hh"
@@ -34,6 +41,14 @@
 using namespace gazebo;
 using namespace common;
 
+/// \brief Lookup tables filled by HeightmapCache, by everything the
+/// heights depend on. The entries of released tables are expired.
+static std::map<std::string, std::weak_ptr<const std::vector<float>>>
+    heightsCache;
+
+/// \brief Mutex that protects heightsCache.
+static std::mutex heightsCacheMutex;
+
 //////////////////////////////////////////////////
 HeightmapData *HeightmapDataLoader::LoadImageAsTerrain(
     const std::string &_filename)
@@ -103,3 +118,88 @@ HeightmapData *HeightmapDataLoader::LoadTerrainFile(
   return LoadImageAsTerrain(_filename);
 }
 #endif
+
+//////////////////////////////////////////////////
+std::shared_ptr<const std::vector<float>> HeightmapCache::Heights(
+    const std::string &_filename, const unsigned int _level,
+    HeightmapData &_data, const int _subSampling,
+    const unsigned int _vertSize, const ignition::math::Vector3d &_size,
+    const ignition::math::Vector3d &_scale, const bool _flipY)
+{
+  std::string key;
+  if (!_filename.empty())
+  {
+    std::ostringstream stream;
+    stream << std::setprecision(17) << _filename;
+    boost::system::error_code ec;
+    const std::time_t time = boost::filesystem::last_write_time(_filename, ec);
+    if (!ec)
+      stream << " " << time;
+    stream << " " << _level << " " << _subSampling << " " << _vertSize
+           << " " << _size << " " << _scale << " " << _flipY;
+    key = stream.str();
+
+    std::lock_guard<std::mutex> lock(heightsCacheMutex);
+    auto iter = heightsCache.find(key);
+    if (iter != heightsCache.end())
+    {
+      auto heights = iter->second.lock();
+      if (heights)
+        return heights;
+    }
+  }
+
+  // Filled outside of the lock, which would otherwise serialize the loading
+  // of different terrains.
+  std::unique_ptr<std::vector<float>> filled(new std::vector<float>());
+  _data.FillHeightMap(_subSampling, _vertSize, _size, _scale, _flipY,
+      *filled);
+
+  // The table counts against the heightmaps until its last user releases
+  // it
+  std::atomic<int64_t> &memory =
+      MemoryTracker::Instance()->Counter("heightmaps");
+  const int64_t bytes = filled->capacity() * sizeof(float);
+  memory += bytes;
+  std::shared_ptr<const std::vector<float>> heights(filled.release(),
+      [&memory, bytes](const std::vector<float> *_table)
+      {
+        memory -= bytes;
+        delete _table;
+      });
+  if (key.empty())
+    return heights;
+
+  std::lock_guard<std::mutex> lock(heightsCacheMutex);
+
+  // Drop the released tables
+  for (auto iter = heightsCache.begin(); iter != heightsCache.end();)
+  {
+    if (iter->second.expired())
+      iter = heightsCache.erase(iter);
+    else
+      ++iter;
+  }
+
+  // Another caller may have filled the same table in the meantime
+  auto &entry = heightsCache[key];
+  auto existing = entry.lock();
+  if (existing)
+    return existing;
+
+  entry = heights;
+  return heights;
+}
+
+//////////////////////////////////////////////////
+size_t HeightmapCache::Count()
+{
+  std::lock_guard<std::mutex> lock(heightsCacheMutex);
+  size_t count = 0;
+  for (const auto &entry : heightsCache)
+  {
+    if (!entry.second.expired())
+      ++count;
+  }
+  return count;
+}
@@ -18,6 +18,7 @@
 #ifndef GAZEBO_COMMON_HEIGHTMAPDATA_HH_
 #define GAZEBO_COMMON_HEIGHTMAPDATA_HH_
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <ignition/math/Vector3.hh>
@@ -94,6 +95,40 @@ namespace gazebo
       private: static HeightmapData *LoadImageAsTerrain(
           const std::string &_filename);
     };
+
+    /// \class HeightmapCache HeightmapData.hh common/common.hh
+    /// \brief Process-wide cache of the lookup tables filled by
+    /// HeightmapData::FillHeightMap, so that the physics and rendering
+    /// heightmaps of a terrain share the same immutable heights. A table
+    /// is released when the last pointer to it is, and counts against the
+    /// "heightmaps" subsystem of the MemoryTracker until then.
+    class GZ_COMMON_VISIBLE HeightmapCache
+    {
+      /// \brief Get the lookup table of a terrain, filled on the first
+      /// call with these parameters.
+      /// \param[in] _filename Path of the file _data was loaded from,
+      /// with the modification time of the file it identifies the
+      /// terrain. The table isn't cached if it's empty.
+      /// \param[in] _level Level selected in the DEM cache, 0 for the
+      /// full resolution and for images.
+      /// \param[in] _data The terrain data.
+      /// \param[in] _subSampling Multiplier used to increase the resolution.
+      /// \param[in] _vertSize Number of points per row.
+      /// \param[in] _size Real dimensions of the terrain.
+      /// \param[in] _scale Vector3 used to scale the height.
+      /// \param[in] _flipY If true, it inverts the order in which the vector
+      /// is filled.
+      /// \return The heights, which must not be modified.
+      public: static std::shared_ptr<const std::vector<float>> Heights(
+          const std::string &_filename, const unsigned int _level,
+          HeightmapData &_data, const int _subSampling,
+          const unsigned int _vertSize, const ignition::math::Vector3d &_size,
+          const ignition::math::Vector3d &_scale, const bool _flipY);
+
+      /// \brief Get the number of tables in use.
+      /// \return Number of cached tables that are still referenced.
+      public: static size_t Count();
+    };
     /// \}
   }
 }
@@ -15,6 +15,9 @@
  *
 */
 
+#include <memory>
+#include <string>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <gtest/gtest.h>
 
@@ -55,6 +58,57 @@ TEST_F(HeightmapDataLoaderTest, ImageHeightmap)
   EXPECT_NEAR(0.99607843, img->GetMaxElevation(), ELEVATION_TOL);
 }
 
+/////////////////////////////////////////////////
+TEST_F(HeightmapDataLoaderTest, HeightmapCache)
+{
+  const std::string filename =
+      common::find_file("file://media/materials/textures/heightmap_bowl.png");
+  std::unique_ptr<common::HeightmapData> heightmapData(
+      common::HeightmapDataLoader::LoadTerrainFile(filename));
+  ASSERT_TRUE(heightmapData != nullptr);
+
+  const unsigned int vertSize = heightmapData->GetWidth();
+  const ignition::math::Vector3d size(129, 129, 10);
+  const ignition::math::Vector3d scale(1, 1, 10);
+  const size_t count = common::HeightmapCache::Count();
+
+  std::vector<float> expected;
+  heightmapData->FillHeightMap(1, vertSize, size, scale, false, expected);
+
+  // The same parameters share one table
+  auto heights = common::HeightmapCache::Heights(filename, 0, *heightmapData,
+      1, vertSize, size, scale, false);
+  ASSERT_TRUE(heights != nullptr);
+  EXPECT_EQ(expected, *heights);
+  EXPECT_EQ(count + 1, common::HeightmapCache::Count());
+  EXPECT_EQ(heights, common::HeightmapCache::Heights(filename, 0,
+        *heightmapData, 1, vertSize, size, scale, false));
+
+  // Any other parameter fills another table
+  auto flipped = common::HeightmapCache::Heights(filename, 0, *heightmapData,
+      1, vertSize, size, scale, true);
+  EXPECT_NE(heights, flipped);
+  EXPECT_NE(heights, common::HeightmapCache::Heights(filename, 1,
+        *heightmapData, 1, vertSize, size, scale, false));
+  EXPECT_EQ(count + 2, common::HeightmapCache::Count());
+
+  // Data without a file isn't cached
+  auto uncached = common::HeightmapCache::Heights("", 0, *heightmapData,
+      1, vertSize, size, scale, false);
+  EXPECT_EQ(expected, *uncached);
+  EXPECT_NE(heights, uncached);
+  EXPECT_EQ(count + 2, common::HeightmapCache::Count());
+
+  // The tables are released with their last pointer
+  heights.reset();
+  flipped.reset();
+  EXPECT_EQ(count, common::HeightmapCache::Count());
+  heights = common::HeightmapCache::Heights(filename, 0, *heightmapData,
+      1, vertSize, size, scale, false);
+  EXPECT_EQ(expected, *heights);
+  EXPECT_EQ(count + 1, common::HeightmapCache::Count());
+}
+
 #ifdef HAVE_GDAL
 /////////////////////////////////////////////////
 TEST_F(HeightmapDataLoaderTest, DemHeightmap)
@@ -21,6 +21,7 @@
 
 #include <FreeImage.h>
 #include <boost/filesystem.hpp>
+#include <algorithm>
 #include <string>
 
 #include "gazebo/common/Assert.hh"
@@ -108,6 +109,56 @@ void Image::SavePNG(const std::string &_filename)
   FreeImage_Save(FIF_PNG, this->bitmap, _filename.c_str(), 0);
 }
 
+//////////////////////////////////////////////////
+bool Image::Encode(const std::string &_format, std::string &_data,
+    const int _quality) const
+{
+  if (!this->Valid())
+    return false;
+
+  FREE_IMAGE_FORMAT fif;
+  int flags;
+  FIBITMAP *bmp = this->bitmap;
+  if (_format == "jpeg" || _format == "jpg")
+  {
+    fif = FIF_JPEG;
+    flags = std::max(1, std::min(_quality, 100));
+
+    // JPEG has no alpha channel
+    if (FreeImage_GetBPP(this->bitmap) == 32)
+      bmp = FreeImage_ConvertTo24Bits(this->bitmap);
+  }
+  else if (_format == "png")
+  {
+    fif = FIF_PNG;
+    flags = PNG_Z_BEST_SPEED;
+  }
+  else
+  {
+    gzerr << "Unable to encode an image in format[" << _format << "]\n";
+    return false;
+  }
+
+  bool result = false;
+  FIMEMORY *memory = FreeImage_OpenMemory();
+  if (bmp && FreeImage_SaveToMemory(fif, bmp, memory, flags))
+  {
+    BYTE *bytes = nullptr;
+    DWORD size = 0;
+    if (FreeImage_AcquireMemory(memory, &bytes, &size))
+    {
+      _data.assign(reinterpret_cast<const char *>(bytes), size);
+      result = true;
+    }
+  }
+  FreeImage_CloseMemory(memory);
+
+  if (bmp != this->bitmap)
+    FreeImage_Unload(bmp);
+
+  return result;
+}
+
 //////////////////////////////////////////////////
 void Image::SetFromData(const unsigned char *_data, unsigned int _width,
     unsigned int _height, PixelFormat _format)
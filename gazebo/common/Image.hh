@@ -112,6 +112,15 @@ namespace gazebo
       /// \param[in] _filename The name of the saved image
       public: void SavePNG(const std::string &_filename);
 
+      /// \brief Encode the image in a compressed file format, in memory.
+      /// \param[in] _format "jpeg" or "png".
+      /// \param[out] _data The encoded image.
+      /// \param[in] _quality JPEG quality, in [1, 100]. Ignored for PNG.
+      /// \return False if the image is empty, the format is unsupported or
+      /// the encoding failed.
+      public: bool Encode(const std::string &_format, std::string &_data,
+                  const int _quality = 80) const;
+
       /// \brief Set the image from raw data
       /// \param[in] _data Pointer to the raw image data
       /// \param[in] _width Width in pixels
@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "gazebo/common/ImageConvert.hh"
+
+using namespace gazebo;
+using namespace common;
+
+namespace
+{
+  /// \brief Map depths linearly to integer values, as
+  /// ImageConvert::DepthToL8 does.
+  /// \param[in] _depth The depths.
+  /// \param[out] _dst The values.
+  /// \param[in] _count Number of depths.
+  /// \param[in] _near Depth mapped to 0.
+  /// \param[in] _far Depth mapped to _max.
+  /// \param[in] _max Greatest value.
+  template<typename T>
+  void DepthToInt(const float *_depth, T *_dst, const std::size_t _count,
+      const float _near, const float _far, const float _max)
+  {
+    const float scale = _far != _near ? _max / (_far - _near) : 0.0f;
+    for (std::size_t i = 0; i < _count; ++i)
+    {
+      // Comparisons which are false for NaN map it to 0
+      float v = (_depth[i] - _near) * scale;
+      v = v > 0.0f ? v : 0.0f;
+      v = v < _max ? v : _max;
+      _dst[i] = static_cast<T>(v + 0.5f);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void ImageConvert::SwapRedBlue(const unsigned char *_src,
+    unsigned char *_dst, const std::size_t _pixels,
+    const unsigned int _channels)
+{
+  if (_channels == 4)
+  {
+    for (std::size_t i = 0; i < _pixels * 4; i += 4)
+    {
+      const unsigned char r = _src[i];
+      const unsigned char g = _src[i + 1];
+      const unsigned char b = _src[i + 2];
+      const unsigned char a = _src[i + 3];
+      _dst[i] = b;
+      _dst[i + 1] = g;
+      _dst[i + 2] = r;
+      _dst[i + 3] = a;
+    }
+  }
+  else
+  {
+    for (std::size_t i = 0; i < _pixels * 3; i += 3)
+    {
+      const unsigned char r = _src[i];
+      const unsigned char g = _src[i + 1];
+      const unsigned char b = _src[i + 2];
+      _dst[i] = b;
+      _dst[i + 1] = g;
+      _dst[i + 2] = r;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void ImageConvert::RGBAToRGB(const unsigned char *_src,
+    unsigned char *_dst, const std::size_t _pixels)
+{
+  // Pixel i is read before it's overwritten when converting in place,
+  // since it's written at 3 * i <= 4 * i
+  for (std::size_t i = 0; i < _pixels; ++i)
+  {
+    const unsigned char r = _src[i * 4];
+    const unsigned char g = _src[i * 4 + 1];
+    const unsigned char b = _src[i * 4 + 2];
+    _dst[i * 3] = r;
+    _dst[i * 3 + 1] = g;
+    _dst[i * 3 + 2] = b;
+  }
+}
+
+//////////////////////////////////////////////////
+void ImageConvert::RGBAToRGB(const unsigned char *_src,
+    const std::size_t _pixels, std::vector<unsigned char> &_dst)
+{
+  if (_dst.size() < _pixels * 3)
+    _dst.resize(_pixels * 3);
+  RGBAToRGB(_src, _dst.data(), _pixels);
+}
+
+//////////////////////////////////////////////////
+void ImageConvert::DepthToL8(const float *_depth, unsigned char *_dst,
+    const std::size_t _count, const float _near, const float _far)
+{
+  DepthToInt(_depth, _dst, _count, _near, _far, 255.0f);
+}
+
+//////////////////////////////////////////////////
+void ImageConvert::DepthToL16(const float *_depth, uint16_t *_dst,
+    const std::size_t _count, const float _near, const float _far)
+{
+  DepthToInt(_depth, _dst, _count, _near, _far, 65535.0f);
+}
+
+//////////////////////////////////////////////////
+float ImageConvert::MaxDepth(const float *_depth, const std::size_t _count)
+{
+  float maxDepth = 0.0f;
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    if (_depth[i] > maxDepth && !std::isinf(_depth[i]))
+      maxDepth = _depth[i];
+  }
+  return maxDepth;
+}
+
+//////////////////////////////////////////////////
+void ImageConvert::Int16ToInt8(const uint16_t *_src, unsigned char *_dst,
+    const std::size_t _count)
+{
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    const uint32_t v = _src[i];
+    _dst[i] = static_cast<unsigned char>((v * 255u + 32767u) / 65535u);
+  }
+}
+
+//////////////////////////////////////////////////
+void ImageConvert::ResizeBilinear(const unsigned char *_src,
+    const unsigned int _width, const unsigned int _height,
+    const unsigned int _channels, unsigned char *_dst,
+    const unsigned int _dstWidth, const unsigned int _dstHeight)
+{
+  if (_width == 0 || _height == 0 || _dstWidth == 0 || _dstHeight == 0)
+    return;
+
+  // Source columns and weights of each destination column, which are the
+  // same for all the rows. Pixel centers are aligned.
+  const float scaleX = static_cast<float>(_width) / _dstWidth;
+  std::vector<unsigned int> x0(_dstWidth);
+  std::vector<unsigned int> x1(_dstWidth);
+  std::vector<float> fx(_dstWidth);
+  for (unsigned int x = 0; x < _dstWidth; ++x)
+  {
+    const float sx = std::max(0.0f, (x + 0.5f) * scaleX - 0.5f);
+    x0[x] = std::min(static_cast<unsigned int>(sx), _width - 1);
+    x1[x] = std::min(x0[x] + 1, _width - 1);
+    fx[x] = sx - x0[x];
+    x0[x] *= _channels;
+    x1[x] *= _channels;
+  }
+
+  const float scaleY = static_cast<float>(_height) / _dstHeight;
+  const std::size_t srcStride = static_cast<std::size_t>(_width) * _channels;
+  const std::size_t dstStride =
+      static_cast<std::size_t>(_dstWidth) * _channels;
+  for (unsigned int y = 0; y < _dstHeight; ++y)
+  {
+    const float sy = std::max(0.0f, (y + 0.5f) * scaleY - 0.5f);
+    const unsigned int y0 = std::min(static_cast<unsigned int>(sy),
+        _height - 1);
+    const unsigned int y1 = std::min(y0 + 1, _height - 1);
+    const float fy = sy - y0;
+
+    const unsigned char *row0 = _src + y0 * srcStride;
+    const unsigned char *row1 = _src + y1 * srcStride;
+    unsigned char *out = _dst + y * dstStride;
+    for (unsigned int x = 0; x < _dstWidth; ++x)
+    {
+      for (unsigned int c = 0; c < _channels; ++c)
+      {
+        const float top = row0[x0[x] + c] +
+            (row0[x1[x] + c] - row0[x0[x] + c]) * fx[x];
+        const float bottom = row1[x0[x] + c] +
+            (row1[x1[x] + c] - row1[x0[x] + c]) * fx[x];
+        out[x * _channels + c] =
+            static_cast<unsigned char>(top + (bottom - top) * fy + 0.5f);
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void ImageConvert::ResizeBilinear(const unsigned char *_src,
+    const unsigned int _width, const unsigned int _height,
+    const unsigned int _channels, const unsigned int _dstWidth,
+    const unsigned int _dstHeight, std::vector<unsigned char> &_dst)
+{
+  const std::size_t size = static_cast<std::size_t>(_dstWidth) *
+      _dstHeight * _channels;
+  if (_dst.size() < size)
+    _dst.resize(size);
+  ResizeBilinear(_src, _width, _height, _channels, _dst.data(), _dstWidth,
+      _dstHeight);
+}
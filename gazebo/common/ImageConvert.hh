@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_IMAGECONVERT_HH_
+#define GAZEBO_COMMON_IMAGECONVERT_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \addtogroup gazebo_common Common
+    /// \{
+
+    /// \class ImageConvert ImageConvert.hh common/common.hh
+    /// \brief Conversions between the pixel formats of raw image data, and
+    /// resampling, without going through FreeImage.
+    ///
+    /// The kernels work on tightly packed pixels, one row after the other.
+    /// Their loops have no branches between pixels, so that the compiler
+    /// vectorizes them. Kernels that keep or reduce the size of a pixel
+    /// can convert in place, with the same source and destination. The
+    /// overloads that take a std::vector resize it only when it's too
+    /// small, so that a buffer reused across frames isn't reallocated.
+    class GZ_COMMON_VISIBLE ImageConvert
+    {
+      /// \brief Swap the first and third channels of 8 bit pixels, to
+      /// convert between RGB and BGR.
+      /// \param[in] _src The source pixels.
+      /// \param[out] _dst The converted pixels, which may be _src.
+      /// \param[in] _pixels Number of pixels.
+      /// \param[in] _channels Number of channels of a pixel, 3 or 4.
+      public: static void SwapRedBlue(const unsigned char *_src,
+                  unsigned char *_dst, const std::size_t _pixels,
+                  const unsigned int _channels = 3);
+
+      /// \brief Drop the alpha channel of RGBA or BGRA 8 bit pixels.
+      /// \param[in] _src The source pixels.
+      /// \param[out] _dst The converted pixels, which may be _src.
+      /// \param[in] _pixels Number of pixels.
+      public: static void RGBAToRGB(const unsigned char *_src,
+                  unsigned char *_dst, const std::size_t _pixels);
+
+      /// \brief Drop the alpha channel of RGBA or BGRA 8 bit pixels, in a
+      /// reused buffer.
+      /// \param[in] _src The source pixels.
+      /// \param[in] _pixels Number of pixels.
+      /// \param[in,out] _dst The converted pixels, resized to fit them.
+      public: static void RGBAToRGB(const unsigned char *_src,
+                  const std::size_t _pixels, std::vector<unsigned char> &_dst);
+
+      /// \brief Convert depths to 8 bit luminance, mapping _near to 0 and
+      /// _far to 255. Depths outside of the range, infinities and NaNs are
+      /// clamped to it, NaNs to _near.
+      /// \param[in] _depth The depths.
+      /// \param[out] _dst The luminance values.
+      /// \param[in] _count Number of depths.
+      /// \param[in] _near Depth mapped to 0. It can be greater than _far
+      /// to show near depths brighter.
+      /// \param[in] _far Depth mapped to 255.
+      public: static void DepthToL8(const float *_depth, unsigned char *_dst,
+                  const std::size_t _count, const float _near,
+                  const float _far);
+
+      /// \brief Convert depths to 16 bit luminance, mapping _near to 0 and
+      /// _far to 65535, as DepthToL8 does.
+      /// \param[in] _depth The depths.
+      /// \param[out] _dst The luminance values.
+      /// \param[in] _count Number of depths.
+      /// \param[in] _near Depth mapped to 0.
+      /// \param[in] _far Depth mapped to 65535.
+      public: static void DepthToL16(const float *_depth, uint16_t *_dst,
+                  const std::size_t _count, const float _near,
+                  const float _far);
+
+      /// \brief Get the greatest finite depth.
+      /// \param[in] _depth The depths.
+      /// \param[in] _count Number of depths.
+      /// \return The greatest depth, 0 if there is no finite positive one.
+      public: static float MaxDepth(const float *_depth,
+                  const std::size_t _count);
+
+      /// \brief Convert 16 bit channels to 8 bit.
+      /// \param[in] _src The 16 bit channels.
+      /// \param[out] _dst The 8 bit channels, which may alias _src.
+      /// \param[in] _count Number of channels, the number of pixels times
+      /// the number of channels of a pixel.
+      public: static void Int16ToInt8(const uint16_t *_src,
+                  unsigned char *_dst, const std::size_t _count);
+
+      /// \brief Resize 8 bit pixels with bilinear filtering.
+      /// \param[in] _src The source pixels.
+      /// \param[in] _width Width of the source, in pixels.
+      /// \param[in] _height Height of the source, in pixels.
+      /// \param[in] _channels Number of channels of a pixel.
+      /// \param[out] _dst The resized pixels, which can't overlap _src.
+      /// \param[in] _dstWidth Width of the destination, in pixels.
+      /// \param[in] _dstHeight Height of the destination, in pixels.
+      public: static void ResizeBilinear(const unsigned char *_src,
+                  const unsigned int _width, const unsigned int _height,
+                  const unsigned int _channels, unsigned char *_dst,
+                  const unsigned int _dstWidth,
+                  const unsigned int _dstHeight);
+
+      /// \brief Resize 8 bit pixels with bilinear filtering, in a reused
+      /// buffer.
+      /// \param[in] _src The source pixels.
+      /// \param[in] _width Width of the source, in pixels.
+      /// \param[in] _height Height of the source, in pixels.
+      /// \param[in] _channels Number of channels of a pixel.
+      /// \param[in] _dstWidth Width of the destination, in pixels.
+      /// \param[in] _dstHeight Height of the destination, in pixels.
+      /// \param[in,out] _dst The resized pixels, resized to fit them.
+      public: static void ResizeBilinear(const unsigned char *_src,
+                  const unsigned int _width, const unsigned int _height,
+                  const unsigned int _channels, const unsigned int _dstWidth,
+                  const unsigned int _dstHeight,
+                  std::vector<unsigned char> &_dst);
+    };
+    /// \}
+  }
+}
+#endif
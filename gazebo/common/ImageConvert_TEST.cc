@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "gazebo/common/ImageConvert.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class ImageConvertTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(ImageConvertTest, SwapRedBlue)
+{
+  const std::vector<unsigned char> rgb = {1, 2, 3, 4, 5, 6};
+  std::vector<unsigned char> bgr(rgb.size());
+  common::ImageConvert::SwapRedBlue(rgb.data(), bgr.data(), 2);
+  EXPECT_EQ(std::vector<unsigned char>({3, 2, 1, 6, 5, 4}), bgr);
+
+  // In place, and back
+  common::ImageConvert::SwapRedBlue(bgr.data(), bgr.data(), 2);
+  EXPECT_EQ(rgb, bgr);
+
+  std::vector<unsigned char> rgba = {1, 2, 3, 4, 5, 6, 7, 8};
+  common::ImageConvert::SwapRedBlue(rgba.data(), rgba.data(), 2, 4);
+  EXPECT_EQ(std::vector<unsigned char>({3, 2, 1, 4, 7, 6, 5, 8}), rgba);
+}
+
+/////////////////////////////////////////////////
+TEST_F(ImageConvertTest, RGBAToRGB)
+{
+  std::vector<unsigned char> rgba = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+  std::vector<unsigned char> rgb;
+  common::ImageConvert::RGBAToRGB(rgba.data(), 3, rgb);
+  EXPECT_EQ(std::vector<unsigned char>({1, 2, 3, 5, 6, 7, 9, 10, 11}), rgb);
+
+  // The buffer is reused, and only grows
+  const unsigned char *data = rgb.data();
+  common::ImageConvert::RGBAToRGB(rgba.data(), 2, rgb);
+  EXPECT_EQ(data, rgb.data());
+  EXPECT_EQ(9u, rgb.size());
+
+  // In place
+  common::ImageConvert::RGBAToRGB(rgba.data(), rgba.data(), 3);
+  EXPECT_EQ(std::vector<unsigned char>({1, 2, 3, 5, 6, 7, 9, 10, 11}),
+      std::vector<unsigned char>(rgba.begin(), rgba.begin() + 9));
+}
+
+/////////////////////////////////////////////////
+TEST_F(ImageConvertTest, Depth)
+{
+  const float inf = std::numeric_limits<float>::infinity();
+  const std::vector<float> depth = {0.0f, 1.0f, 2.0f, 4.0f, 5.0f, inf,
+      std::numeric_limits<float>::quiet_NaN()};
+  EXPECT_FLOAT_EQ(5.0f, common::ImageConvert::MaxDepth(depth.data(),
+        depth.size()));
+
+  std::vector<unsigned char> l8(depth.size());
+  common::ImageConvert::DepthToL8(depth.data(), l8.data(), depth.size(),
+      1.0f, 3.0f);
+  EXPECT_EQ(std::vector<unsigned char>({0, 0, 128, 255, 255, 255, 0}), l8);
+
+  // Near depths brighter
+  common::ImageConvert::DepthToL8(depth.data(), l8.data(), 5, 4.0f, 0.0f);
+  EXPECT_EQ(std::vector<unsigned char>({255, 191, 128, 0, 0}),
+      std::vector<unsigned char>(l8.begin(), l8.begin() + 5));
+
+  std::vector<uint16_t> l16(depth.size());
+  common::ImageConvert::DepthToL16(depth.data(), l16.data(), depth.size(),
+      0.0f, 4.0f);
+  EXPECT_EQ(std::vector<uint16_t>({0, 16384, 32768, 65535, 65535, 65535, 0}),
+      l16);
+}
+
+/////////////////////////////////////////////////
+TEST_F(ImageConvertTest, Int16ToInt8)
+{
+  std::vector<uint16_t> src = {0, 257, 32768, 65535};
+  std::vector<unsigned char> dst(src.size());
+  common::ImageConvert::Int16ToInt8(src.data(), dst.data(), src.size());
+  EXPECT_EQ(std::vector<unsigned char>({0, 1, 128, 255}), dst);
+
+  // In place
+  common::ImageConvert::Int16ToInt8(src.data(),
+      reinterpret_cast<unsigned char *>(src.data()), src.size());
+  EXPECT_EQ(0, std::memcmp(dst.data(), src.data(), dst.size()));
+}
+
+/////////////////////////////////////////////////
+TEST_F(ImageConvertTest, ResizeBilinear)
+{
+  // 2x2 RGB image
+  const std::vector<unsigned char> src = {
+      0, 0, 0,      100, 0, 200,
+      100, 100, 0,  200, 100, 200};
+
+  // Same size gives the same pixels
+  std::vector<unsigned char> dst;
+  common::ImageConvert::ResizeBilinear(src.data(), 2, 2, 3, 2, 2, dst);
+  EXPECT_EQ(src, dst);
+
+  // Down to one pixel averages them
+  common::ImageConvert::ResizeBilinear(src.data(), 2, 2, 3, 1, 1, dst);
+  EXPECT_EQ(100, dst[0]);
+  EXPECT_EQ(50, dst[1]);
+  EXPECT_EQ(100, dst[2]);
+
+  // Up, the corners keep their values and the values are monotonic
+  std::vector<unsigned char> up(4 * 4 * 3);
+  common::ImageConvert::ResizeBilinear(src.data(), 2, 2, 3, up.data(), 4, 4);
+  EXPECT_EQ(0, up[0]);
+  EXPECT_EQ(200, up[(4 * 4 - 1) * 3]);
+  EXPECT_EQ(200, up[(4 * 4 - 1) * 3 + 2]);
+  for (unsigned int x = 1; x < 4; ++x)
+    EXPECT_LE(up[(x - 1) * 3], up[x * 3]);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
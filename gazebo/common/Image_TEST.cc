@@ -16,6 +16,8 @@
 */
 
 #include <gtest/gtest.h>
+#include <string>
+#include <vector>
 #include <ignition/math/Color.hh>
 
 #include "gazebo/common/Image.hh"
@@ -52,6 +54,41 @@ TEST_F(ImageTest, Image)
                   common::Image::RGB_INT8);
 }
 
+/////////////////////////////////////////////////
+TEST_F(ImageTest, Encode)
+{
+  common::Image img;
+  std::string data;
+  EXPECT_FALSE(img.Encode("png", data));
+
+  // A gradient, so the compressed sizes are meaningful
+  const unsigned int width = 64;
+  const unsigned int height = 48;
+  std::vector<unsigned char> pixels(width * height * 4);
+  for (unsigned int i = 0; i < pixels.size(); ++i)
+    pixels[i] = static_cast<unsigned char>(i % 251);
+
+  img.SetFromData(pixels.data(), width, height, common::Image::RGB_INT8);
+  ASSERT_TRUE(img.Valid());
+  EXPECT_FALSE(img.Encode("tiff", data));
+
+  ASSERT_TRUE(img.Encode("png", data));
+  ASSERT_GT(data.size(), 8u);
+  EXPECT_EQ(data.substr(1, 3), "PNG");
+
+  std::string low;
+  ASSERT_TRUE(img.Encode("jpeg", data, 95));
+  ASSERT_TRUE(img.Encode("jpeg", low, 10));
+  EXPECT_EQ(static_cast<unsigned char>(data[0]), 0xFF);
+  EXPECT_EQ(static_cast<unsigned char>(data[1]), 0xD8);
+  EXPECT_LT(low.size(), data.size());
+
+  // The alpha channel is dropped for JPEG
+  img.SetFromData(pixels.data(), width, height, common::Image::RGBA_INT8);
+  EXPECT_TRUE(img.Encode("jpeg", data));
+  EXPECT_TRUE(img.Encode("png", data));
+}
+
 /////////////////////////////////////////////////
 TEST_F(ImageTest, ConvertPixelFormat)
 {
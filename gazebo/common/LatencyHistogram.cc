@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#include "gazebo/common/LatencyHistogram.hh"
+
+using namespace gazebo;
+using namespace common;
+
+namespace
+{
+  /// \brief Log2 of the number of buckets of each power of two.
+  const unsigned int kSubBits = 5;
+
+  /// \brief Number of buckets of each power of two.
+  const uint64_t kSubBuckets = 1 << kSubBits;
+
+  /// \brief Log2 of the first duration past the range, about 18 minutes.
+  const unsigned int kMaxBits = 40;
+
+  /// \brief Number of buckets: durations below kSubBuckets each have a
+  /// bucket, and each power of two above has kSubBuckets.
+  const uint64_t kBuckets = kSubBuckets * (kMaxBits - kSubBits + 1);
+
+  /// \brief Get the bucket of a duration.
+  /// \param[in] _ns Duration.
+  /// \return Index of the bucket.
+  uint64_t BucketIndex(const uint64_t _ns)
+  {
+    if (_ns < kSubBuckets)
+      return _ns;
+
+    const uint64_t ns = std::min<uint64_t>(_ns, (uint64_t(1) << kMaxBits) - 1);
+    unsigned int msb = 0;
+    while ((ns >> msb) > 1)
+      ++msb;
+
+    // The bits below the leading one give the bucket within its power
+    const unsigned int shift = msb - kSubBits;
+    return kSubBuckets * (shift + 1) + ((ns >> shift) - kSubBuckets);
+  }
+
+  /// \brief Get the middle duration of a bucket.
+  /// \param[in] _index Index of the bucket.
+  /// \return Duration.
+  uint64_t BucketMiddle(const uint64_t _index)
+  {
+    if (_index < kSubBuckets)
+      return _index;
+
+    const uint64_t shift = _index / kSubBuckets - 1;
+    const uint64_t lower = (kSubBuckets + _index % kSubBuckets) << shift;
+    return lower + ((uint64_t(1) << shift) >> 1);
+  }
+}
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \internal
+    /// \brief Private data for LatencyHistogram.
+    class LatencyHistogramPrivate
+    {
+      /// \brief Count of each bucket.
+      public: std::atomic<uint64_t> buckets[kBuckets];
+
+      /// \brief Number of recorded durations.
+      public: std::atomic<uint64_t> count{0};
+
+      /// \brief Longest recorded duration.
+      public: std::atomic<uint64_t> max{0};
+    };
+  }
+}
+
+//////////////////////////////////////////////////
+LatencyHistogram::LatencyHistogram()
+  : dataPtr(new LatencyHistogramPrivate)
+{
+  this->Reset();
+}
+
+//////////////////////////////////////////////////
+LatencyHistogram::~LatencyHistogram()
+{
+}
+
+//////////////////////////////////////////////////
+void LatencyHistogram::Record(const uint64_t _ns)
+{
+  this->dataPtr->buckets[BucketIndex(_ns)].fetch_add(1,
+      std::memory_order_relaxed);
+  this->dataPtr->count.fetch_add(1, std::memory_order_relaxed);
+
+  uint64_t max = this->dataPtr->max.load(std::memory_order_relaxed);
+  while (_ns > max && !this->dataPtr->max.compare_exchange_weak(max, _ns,
+        std::memory_order_relaxed))
+  {
+  }
+}
+
+//////////////////////////////////////////////////
+uint64_t LatencyHistogram::Count() const
+{
+  return this->dataPtr->count.load(std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+uint64_t LatencyHistogram::Max() const
+{
+  return this->dataPtr->max.load(std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+uint64_t LatencyHistogram::Percentile(const double _percentile) const
+{
+  // Sum the buckets, which may change while they're read
+  uint64_t total = 0;
+  for (const auto &bucket : this->dataPtr->buckets)
+    total += bucket.load(std::memory_order_relaxed);
+  if (total == 0)
+    return 0;
+
+  if (_percentile >= 100.0)
+    return this->Max();
+
+  const double percentile = std::max(0.0, _percentile);
+  // Rank of the percentile, tolerant to the rounding of e.g. 99.9 / 100
+  const uint64_t rank = std::max<uint64_t>(1,
+      static_cast<uint64_t>(std::ceil(percentile / 100.0 * total - 1e-6)));
+
+  uint64_t seen = 0;
+  for (uint64_t i = 0; i < kBuckets; ++i)
+  {
+    seen += this->dataPtr->buckets[i].load(std::memory_order_relaxed);
+    if (seen >= rank)
+      return std::min(BucketMiddle(i), this->Max());
+  }
+  return this->Max();
+}
+
+//////////////////////////////////////////////////
+void LatencyHistogram::Reset()
+{
+  for (auto &bucket : this->dataPtr->buckets)
+    bucket.store(0, std::memory_order_relaxed);
+  this->dataPtr->count = 0;
+  this->dataPtr->max = 0;
+}
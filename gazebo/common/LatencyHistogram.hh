@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_LATENCYHISTOGRAM_HH_
+#define GAZEBO_COMMON_LATENCYHISTOGRAM_HH_
+
+#include <cstdint>
+#include <memory>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    // Forward declare private data class
+    class LatencyHistogramPrivate;
+
+    /// \addtogroup gazebo_common
+    /// \{
+
+    /// \class LatencyHistogram LatencyHistogram.hh common/common.hh
+    /// \brief A histogram of durations with a relative precision of about
+    /// 3%, from nanoseconds to about 18 minutes, like HdrHistogram.
+    ///
+    /// Each power of two is split in 32 buckets of atomic counters, so
+    /// durations can be recorded and percentiles read concurrently
+    /// without locking.
+    class GZ_COMMON_VISIBLE LatencyHistogram
+    {
+      /// \brief Constructor.
+      public: LatencyHistogram();
+
+      /// \brief Destructor.
+      public: ~LatencyHistogram();
+
+      /// \brief Record a duration.
+      /// \param[in] _ns Duration in nanoseconds. Longer durations than the
+      /// range are counted in the last bucket.
+      public: void Record(const uint64_t _ns);
+
+      /// \brief Get the number of recorded durations.
+      /// \return The count.
+      public: uint64_t Count() const;
+
+      /// \brief Get the longest recorded duration.
+      /// \return Nanoseconds, or 0 if none was recorded.
+      public: uint64_t Max() const;
+
+      /// \brief Get a percentile of the recorded durations.
+      /// \param[in] _percentile Percentile, in [0, 100], such as 99.9.
+      /// \return Nanoseconds, the middle of the bucket of the percentile
+      /// and at most Max(), Max() for 100, or 0 if none was recorded.
+      public: uint64_t Percentile(const double _percentile) const;
+
+      /// \brief Discard the recorded durations.
+      public: void Reset();
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<LatencyHistogramPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
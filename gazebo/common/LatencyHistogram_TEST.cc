@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "gazebo/common/LatencyHistogram.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class LatencyHistogramTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(LatencyHistogramTest, Empty)
+{
+  common::LatencyHistogram histogram;
+  EXPECT_EQ(0u, histogram.Count());
+  EXPECT_EQ(0u, histogram.Max());
+  EXPECT_EQ(0u, histogram.Percentile(50));
+}
+
+/////////////////////////////////////////////////
+TEST_F(LatencyHistogramTest, Percentiles)
+{
+  common::LatencyHistogram histogram;
+
+  // Small durations are exact
+  for (uint64_t i = 1; i <= 10; ++i)
+    histogram.Record(i);
+  EXPECT_EQ(10u, histogram.Count());
+  EXPECT_EQ(10u, histogram.Max());
+  EXPECT_EQ(5u, histogram.Percentile(50));
+  EXPECT_EQ(10u, histogram.Percentile(100));
+  EXPECT_EQ(1u, histogram.Percentile(0));
+
+  // 1 ms steps, with a 1% of 20 ms spikes and one 100 ms step
+  histogram.Reset();
+  EXPECT_EQ(0u, histogram.Count());
+  for (unsigned int i = 0; i < 989; ++i)
+    histogram.Record(1000000);
+  for (unsigned int i = 0; i < 10; ++i)
+    histogram.Record(20000000);
+  histogram.Record(100000000);
+
+  EXPECT_EQ(1000u, histogram.Count());
+  EXPECT_EQ(100000000u, histogram.Max());
+  EXPECT_NEAR(1e6, histogram.Percentile(50), 0.03e6);
+  EXPECT_NEAR(1e6, histogram.Percentile(98.9), 0.03e6);
+  EXPECT_NEAR(20e6, histogram.Percentile(99), 0.6e6);
+  EXPECT_NEAR(20e6, histogram.Percentile(99.9), 0.6e6);
+  EXPECT_EQ(100000000u, histogram.Percentile(100));
+
+  // Durations past the range are in the last bucket
+  histogram.Record(uint64_t(1) << 50);
+  EXPECT_EQ(uint64_t(1) << 50, histogram.Max());
+  EXPECT_LT(histogram.Percentile(99.99), uint64_t(1) << 50);
+}
+
+/////////////////////////////////////////////////
+TEST_F(LatencyHistogramTest, Threads)
+{
+  common::LatencyHistogram histogram;
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < 4; ++t)
+  {
+    threads.emplace_back([&histogram, t]()
+        {
+          for (uint64_t i = 0; i < 10000; ++i)
+            histogram.Record(1000 * (t + 1) + i % 7);
+        });
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  EXPECT_EQ(40000u, histogram.Count());
+  EXPECT_EQ(4006u, histogram.Max());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
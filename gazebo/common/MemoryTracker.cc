@@ -0,0 +1,291 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <cctype>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#include "gazebo/common/CommonIface.hh"
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/MemoryTracker.hh"
+
+using namespace gazebo;
+using namespace common;
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \internal
+    /// \brief Counter and budget of a subsystem.
+    class MemorySubsystem
+    {
+      /// \brief Bytes held by the subsystem.
+      public: std::atomic<int64_t> bytes{0};
+
+      /// \brief Soft budget of the subsystem, zero for none.
+      public: std::atomic<uint64_t> budget{0};
+    };
+
+    /// \internal
+    /// \brief A registered evictor.
+    class MemoryEvictor
+    {
+      /// \brief Id returned by AddEvictor.
+      public: int id;
+
+      /// \brief Subsystem the evictor frees memory of.
+      public: MemorySubsystem *subsystem;
+
+      /// \brief The evictor.
+      public: MemoryTracker::Evictor evictor;
+    };
+
+    /// \internal
+    /// \brief Private data for the MemoryTracker class
+    class MemoryTrackerPrivate
+    {
+      /// \brief Get a subsystem, adding it if it's new.
+      /// \param[in] _name Name of the subsystem.
+      /// \return The subsystem, which lives as long as the tracker.
+      public: MemorySubsystem &Subsystem(const std::string &_name)
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        auto &subsystem = this->subsystems[_name];
+        if (!subsystem)
+          subsystem.reset(new MemorySubsystem);
+        return *subsystem;
+      }
+
+      /// \brief Get a subsystem.
+      /// \param[in] _name Name of the subsystem.
+      /// \return The subsystem, nullptr if it hasn't been counted yet.
+      public: const MemorySubsystem *Find(const std::string &_name) const
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        auto iter = this->subsystems.find(_name);
+        return iter != this->subsystems.end() ? iter->second.get() : nullptr;
+      }
+
+      /// \brief Subsystems by name. They are never removed, so that the
+      /// counters handed out stay valid.
+      public: std::map<std::string, std::unique_ptr<MemorySubsystem>>
+              subsystems;
+
+      /// \brief Protects subsystems.
+      public: mutable std::mutex mutex;
+
+      /// \brief Registered evictors, in registration order.
+      public: std::vector<MemoryEvictor> evictors;
+
+      /// \brief Id of the next evictor.
+      public: int nextEvictorId = 0;
+
+      /// \brief Protects evictors, and is held while they run so that
+      /// RemoveEvictor waits for them.
+      public: std::mutex evictorsMutex;
+    };
+  }
+}
+
+//////////////////////////////////////////////////
+MemoryTracker::MemoryTracker()
+  : dataPtr(new MemoryTrackerPrivate)
+{
+  const char *env = getEnv("GAZEBO_MEMORY_BUDGETS");
+  if (!env)
+    return;
+
+  std::map<std::string, uint64_t> budgets;
+  if (!ParseBudgets(env, budgets))
+  {
+    gzwarn << "Invalid GAZEBO_MEMORY_BUDGETS[" << env
+           << "], ignoring the entries after the first invalid one.\n";
+  }
+  for (auto const &budget : budgets)
+    this->SetBudget(budget.first, budget.second);
+}
+
+//////////////////////////////////////////////////
+MemoryTracker::~MemoryTracker()
+{
+}
+
+//////////////////////////////////////////////////
+std::atomic<int64_t> &MemoryTracker::Counter(const std::string &_subsystem)
+{
+  return this->dataPtr->Subsystem(_subsystem).bytes;
+}
+
+//////////////////////////////////////////////////
+void MemoryTracker::Add(const std::string &_subsystem, const int64_t _bytes)
+{
+  this->Counter(_subsystem) += _bytes;
+}
+
+//////////////////////////////////////////////////
+void MemoryTracker::Set(const std::string &_subsystem, const uint64_t _bytes)
+{
+  this->Counter(_subsystem) = static_cast<int64_t>(_bytes);
+}
+
+//////////////////////////////////////////////////
+uint64_t MemoryTracker::Bytes(const std::string &_subsystem) const
+{
+  const MemorySubsystem *subsystem = this->dataPtr->Find(_subsystem);
+  if (!subsystem)
+    return 0;
+
+  const int64_t bytes = subsystem->bytes;
+  return bytes > 0 ? static_cast<uint64_t>(bytes) : 0u;
+}
+
+//////////////////////////////////////////////////
+std::map<std::string, uint64_t> MemoryTracker::Usage() const
+{
+  std::map<std::string, uint64_t> usage;
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  for (auto const &subsystem : this->dataPtr->subsystems)
+  {
+    const int64_t bytes = subsystem.second->bytes;
+    usage[subsystem.first] = bytes > 0 ? static_cast<uint64_t>(bytes) : 0u;
+  }
+  return usage;
+}
+
+//////////////////////////////////////////////////
+void MemoryTracker::SetBudget(const std::string &_subsystem,
+    const uint64_t _bytes)
+{
+  this->dataPtr->Subsystem(_subsystem).budget = _bytes;
+}
+
+//////////////////////////////////////////////////
+uint64_t MemoryTracker::Budget(const std::string &_subsystem) const
+{
+  const MemorySubsystem *subsystem = this->dataPtr->Find(_subsystem);
+  return subsystem ? subsystem->budget.load() : 0u;
+}
+
+//////////////////////////////////////////////////
+int MemoryTracker::AddEvictor(const std::string &_subsystem,
+    const Evictor &_evictor)
+{
+  MemorySubsystem *subsystem = &this->dataPtr->Subsystem(_subsystem);
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->evictorsMutex);
+  const int id = this->dataPtr->nextEvictorId++;
+  this->dataPtr->evictors.push_back({id, subsystem, _evictor});
+  return id;
+}
+
+//////////////////////////////////////////////////
+void MemoryTracker::RemoveEvictor(const int _id)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->evictorsMutex);
+  auto &evictors = this->dataPtr->evictors;
+  for (auto iter = evictors.begin(); iter != evictors.end(); ++iter)
+  {
+    if (iter->id == _id)
+    {
+      evictors.erase(iter);
+      return;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+uint64_t MemoryTracker::Enforce()
+{
+  uint64_t freed = 0;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->evictorsMutex);
+  for (auto const &evictor : this->dataPtr->evictors)
+  {
+    const int64_t budget =
+        static_cast<int64_t>(evictor.subsystem->budget.load());
+    const int64_t bytes = evictor.subsystem->bytes;
+    if (budget == 0 || bytes <= budget)
+      continue;
+
+    evictor.evictor(static_cast<uint64_t>(bytes - budget));
+
+    const int64_t after = evictor.subsystem->bytes;
+    if (after < bytes)
+      freed += static_cast<uint64_t>(bytes - after);
+  }
+  return freed;
+}
+
+//////////////////////////////////////////////////
+bool MemoryTracker::ParseBudgets(const std::string &_text,
+    std::map<std::string, uint64_t> &_budgets)
+{
+  std::istringstream stream(_text);
+  std::string entry;
+  while (std::getline(stream, entry, ','))
+  {
+    if (entry.empty())
+      continue;
+
+    const size_t equal = entry.find('=');
+    if (equal == 0 || equal == std::string::npos || equal + 1 == entry.size())
+      return false;
+
+    const std::string value = entry.substr(equal + 1);
+    if (!std::isdigit(static_cast<unsigned char>(value[0])))
+      return false;
+
+    size_t end = 0;
+    uint64_t bytes = 0;
+    try
+    {
+      bytes = std::stoull(value, &end);
+    }
+    catch(...)
+    {
+      return false;
+    }
+
+    if (end + 1 == value.size())
+    {
+      switch (value[end])
+      {
+        case 'k':
+        case 'K':
+          bytes <<= 10;
+          break;
+        case 'm':
+        case 'M':
+          bytes <<= 20;
+          break;
+        case 'g':
+        case 'G':
+          bytes <<= 30;
+          break;
+        default:
+          return false;
+      }
+    }
+    else if (end != value.size())
+      return false;
+
+    _budgets[entry.substr(0, equal)] = bytes;
+  }
+  return true;
+}
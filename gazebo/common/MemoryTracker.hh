@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_MEMORYTRACKER_HH_
+#define GAZEBO_COMMON_MEMORYTRACKER_HH_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "gazebo/common/SingletonT.hh"
+#include "gazebo/util/system.hh"
+
+GZ_SINGLETON_DECLARE(GZ_COMMON_VISIBLE, gazebo, common, MemoryTracker)
+
+namespace gazebo
+{
+  namespace common
+  {
+    // Forward declare private data class.
+    class MemoryTrackerPrivate;
+
+    /// \addtogroup gazebo_common Common
+    /// \{
+
+    /// \class MemoryTracker MemoryTracker.hh common/common.hh
+    /// \brief Bytes held by each subsystem of the process, and their soft
+    /// budgets. Caches register an evictor with the subsystem they count
+    /// against, which Enforce calls while the subsystem is over budget.
+    ///
+    /// The subsystems are:
+    ///   - meshes: Meshes of the MeshManager and their levels of detail.
+    ///     Over budget, the levels of detail are dropped.
+    ///   - heightmaps: Heightmap lookup tables and resident tiles. Over
+    ///     budget, the pages of the tiles are released, and read from the
+    ///     tile file again on their next use.
+    ///   - log: Chunks waiting to be written by LogRecord, and decoded
+    ///     chunks of the log being played. Over budget, the least recently
+    ///     used decoded chunks are dropped.
+    ///   - transport: Messages queued for writing and free read buffers.
+    ///     Over budget, the free buffers are dropped.
+    ///   - contacts: Contact pools of the worlds.
+    ///   - sdf: SDF trees kept by the SdfCache, counted by the size of
+    ///     their text. Over budget, they are dropped, and parsed again on
+    ///     their next use.
+    ///   - ogre: Meshes and textures of the render engine, whose budget is
+    ///     passed to the Ogre resource managers.
+    ///
+    /// \remarks
+    ///  Environment Variables:
+    ///   - GAZEBO_MEMORY_BUDGETS: Comma separated budgets, as
+    ///     subsystem=bytes with an optional K, M or G suffix, e.g.
+    ///     "meshes=512M,log=64M". Subsystems without one are unbounded.
+    class GZ_COMMON_VISIBLE MemoryTracker : public SingletonT<MemoryTracker>
+    {
+      /// \brief Signature of an evictor.
+      /// \param[in] _bytes Number of bytes the subsystem is over budget.
+      /// The evictor frees what it can towards it, and subtracts what it
+      /// freed from the counter of the subsystem.
+      public: using Evictor = std::function<void (const uint64_t _bytes)>;
+
+      /// \brief Constructor, reads GAZEBO_MEMORY_BUDGETS.
+      private: MemoryTracker();
+
+      /// \brief Destructor.
+      private: virtual ~MemoryTracker();
+
+      /// \brief Get the counter of a subsystem. The counter stays valid for
+      /// the life of the tracker, so that frequent updates skip the lookup.
+      /// \param[in] _subsystem Name of the subsystem.
+      /// \return Bytes held by the subsystem.
+      public: std::atomic<int64_t> &Counter(const std::string &_subsystem);
+
+      /// \brief Count bytes against a subsystem.
+      /// \param[in] _subsystem Name of the subsystem.
+      /// \param[in] _bytes Bytes allocated, negative for bytes released.
+      public: void Add(const std::string &_subsystem, const int64_t _bytes);
+
+      /// \brief Set the bytes held by a subsystem, for subsystems which
+      /// measure their usage instead of counting it.
+      /// \param[in] _subsystem Name of the subsystem.
+      /// \param[in] _bytes Bytes held by the subsystem.
+      public: void Set(const std::string &_subsystem, const uint64_t _bytes);
+
+      /// \brief Get the bytes held by a subsystem.
+      /// \param[in] _subsystem Name of the subsystem.
+      /// \return Bytes held, zero for an unknown subsystem.
+      public: uint64_t Bytes(const std::string &_subsystem) const;
+
+      /// \brief Get the bytes held by every subsystem counted so far.
+      /// \return Bytes held, by subsystem name.
+      public: std::map<std::string, uint64_t> Usage() const;
+
+      /// \brief Set the soft budget of a subsystem.
+      /// \param[in] _subsystem Name of the subsystem.
+      /// \param[in] _bytes The budget, zero for none.
+      public: void SetBudget(const std::string &_subsystem,
+                  const uint64_t _bytes);
+
+      /// \brief Get the soft budget of a subsystem.
+      /// \param[in] _subsystem Name of the subsystem.
+      /// \return The budget, zero if the subsystem has none.
+      public: uint64_t Budget(const std::string &_subsystem) const;
+
+      /// \brief Register an evictor of a subsystem.
+      /// \param[in] _subsystem Name of the subsystem.
+      /// \param[in] _evictor The evictor. It must not add or remove
+      /// evictors.
+      /// \return Id of the evictor, for RemoveEvictor.
+      public: int AddEvictor(const std::string &_subsystem,
+                  const Evictor &_evictor);
+
+      /// \brief Unregister an evictor. Once this returns, the evictor is
+      /// no longer called.
+      /// \param[in] _id Id returned by AddEvictor.
+      public: void RemoveEvictor(const int _id);
+
+      /// \brief Call the evictors of the subsystems over budget, in the
+      /// order they were registered, until the subsystem fits.
+      /// \return Number of bytes freed.
+      public: uint64_t Enforce();
+
+      /// \brief Parse a list of budgets.
+      /// \param[in] _text Comma separated subsystem=bytes entries, where
+      /// bytes may end with K, M or G.
+      /// \param[out] _budgets The budgets, by subsystem name.
+      /// \return False if an entry is invalid, in which case _budgets
+      /// holds the entries before it.
+      public: static bool ParseBudgets(const std::string &_text,
+                  std::map<std::string, uint64_t> &_budgets);
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<MemoryTrackerPrivate> dataPtr;
+
+      // Singleton implementation
+      private: friend class SingletonT<MemoryTracker>;
+    };
+    /// \}
+  }
+}
+#endif
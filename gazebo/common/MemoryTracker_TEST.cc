@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gazebo/common/MemoryTracker.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class MemoryTrackerTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(MemoryTrackerTest, ParseBudgets)
+{
+  std::map<std::string, uint64_t> budgets;
+  EXPECT_TRUE(common::MemoryTracker::ParseBudgets("", budgets));
+  EXPECT_TRUE(budgets.empty());
+
+  EXPECT_TRUE(common::MemoryTracker::ParseBudgets(
+        "meshes=512M,log=64k,,sdf=100,ogre=2G", budgets));
+  ASSERT_EQ(budgets.size(), 4u);
+  EXPECT_EQ(budgets["meshes"], 512u << 20);
+  EXPECT_EQ(budgets["log"], 64u << 10);
+  EXPECT_EQ(budgets["sdf"], 100u);
+  EXPECT_EQ(budgets["ogre"], uint64_t(2) << 30);
+
+  budgets.clear();
+  EXPECT_FALSE(common::MemoryTracker::ParseBudgets("a=1,b", budgets));
+  EXPECT_EQ(budgets.size(), 1u);
+  EXPECT_FALSE(common::MemoryTracker::ParseBudgets("=1", budgets));
+  EXPECT_FALSE(common::MemoryTracker::ParseBudgets("a=", budgets));
+  EXPECT_FALSE(common::MemoryTracker::ParseBudgets("a=-1", budgets));
+  EXPECT_FALSE(common::MemoryTracker::ParseBudgets("a=1T", budgets));
+  EXPECT_FALSE(common::MemoryTracker::ParseBudgets("a=1MB", budgets));
+}
+
+/////////////////////////////////////////////////
+TEST_F(MemoryTrackerTest, Counters)
+{
+  common::MemoryTracker *tracker = common::MemoryTracker::Instance();
+  EXPECT_EQ(tracker->Bytes("__test_counters__"), 0u);
+  EXPECT_EQ(tracker->Usage().count("__test_counters__"), 0u);
+
+  tracker->Add("__test_counters__", 100);
+  tracker->Counter("__test_counters__") += 20;
+  EXPECT_EQ(tracker->Bytes("__test_counters__"), 120u);
+  EXPECT_EQ(tracker->Usage()["__test_counters__"], 120u);
+
+  // Counters don't go below zero
+  tracker->Add("__test_counters__", -200);
+  EXPECT_EQ(tracker->Bytes("__test_counters__"), 0u);
+
+  tracker->Set("__test_counters__", 42);
+  EXPECT_EQ(tracker->Bytes("__test_counters__"), 42u);
+  EXPECT_EQ(&tracker->Counter("__test_counters__"),
+      &tracker->Counter("__test_counters__"));
+}
+
+/////////////////////////////////////////////////
+TEST_F(MemoryTrackerTest, Enforce)
+{
+  common::MemoryTracker *tracker = common::MemoryTracker::Instance();
+  const std::string name = "__test_enforce__";
+
+  std::vector<uint64_t> requests;
+  const int first = tracker->AddEvictor(name, [&](const uint64_t _bytes)
+      {
+        requests.push_back(_bytes);
+        tracker->Add(name, -10);
+      });
+  const int second = tracker->AddEvictor(name, [&](const uint64_t _bytes)
+      {
+        requests.push_back(_bytes);
+        tracker->Add(name, -static_cast<int64_t>(_bytes));
+      });
+
+  // Without a budget, nothing is evicted
+  tracker->Set(name, 100);
+  EXPECT_EQ(tracker->Budget(name), 0u);
+  EXPECT_EQ(tracker->Enforce(), 0u);
+  EXPECT_TRUE(requests.empty());
+
+  // Within the budget
+  tracker->SetBudget(name, 100);
+  EXPECT_EQ(tracker->Budget(name), 100u);
+  EXPECT_EQ(tracker->Enforce(), 0u);
+  EXPECT_TRUE(requests.empty());
+
+  // The second evictor frees what the first one couldn't
+  tracker->Set(name, 150);
+  EXPECT_EQ(tracker->Enforce(), 50u);
+  ASSERT_EQ(requests.size(), 2u);
+  EXPECT_EQ(requests[0], 50u);
+  EXPECT_EQ(requests[1], 40u);
+  EXPECT_EQ(tracker->Bytes(name), 100u);
+
+  // The first evictor is enough
+  requests.clear();
+  tracker->Set(name, 105);
+  EXPECT_EQ(tracker->Enforce(), 10u);
+  ASSERT_EQ(requests.size(), 1u);
+  EXPECT_EQ(tracker->Bytes(name), 95u);
+
+  requests.clear();
+  tracker->RemoveEvictor(first);
+  tracker->RemoveEvictor(second);
+  tracker->Set(name, 200);
+  EXPECT_EQ(tracker->Enforce(), 0u);
+  EXPECT_TRUE(requests.empty());
+  EXPECT_EQ(tracker->Bytes(name), 200u);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -777,6 +777,57 @@ void SubMesh::FillArrays(float **_vertArr, int **_indArr) const
   }
 }
 
+//////////////////////////////////////////////////
+unsigned int SubMeshBuffer::Stride() const
+{
+  return this->hasNormals ? 6 : 3;
+}
+
+//////////////////////////////////////////////////
+void SubMesh::FillBuffer(SubMeshBuffer &_buffer,
+    const ignition::math::Vector3d &_offset) const
+{
+  const std::size_t count = this->vertices.size();
+  _buffer.vertexCount = count;
+  _buffer.hasNormals = !this->normals.empty();
+
+  // Vertices without a normal or texture coordinate get zeros
+  const unsigned int stride = _buffer.Stride();
+  _buffer.vertices.assign(count * stride, 0.0f);
+  _buffer.texCoords.assign(this->texCoords.empty() ? 0 : count * 2, 0.0f);
+
+  float *v = _buffer.vertices.data();
+  for (std::size_t i = 0; i < count; ++i, v += stride)
+  {
+    const ignition::math::Vector3d p = this->vertices[i] + _offset;
+    v[0] = static_cast<float>(p.X());
+    v[1] = static_cast<float>(p.Y());
+    v[2] = static_cast<float>(p.Z());
+  }
+
+  if (_buffer.hasNormals)
+  {
+    v = _buffer.vertices.data() + 3;
+    const std::size_t normalCount = std::min(count, this->normals.size());
+    for (std::size_t i = 0; i < normalCount; ++i, v += stride)
+    {
+      v[0] = static_cast<float>(this->normals[i].X());
+      v[1] = static_cast<float>(this->normals[i].Y());
+      v[2] = static_cast<float>(this->normals[i].Z());
+    }
+  }
+
+  const std::size_t texCoordCount = std::min(count, this->texCoords.size());
+  for (std::size_t i = 0; i < texCoordCount; ++i)
+  {
+    _buffer.texCoords[i * 2] = static_cast<float>(this->texCoords[i].X());
+    _buffer.texCoords[i * 2 + 1] =
+        static_cast<float>(this->texCoords[i].Y());
+  }
+
+  _buffer.indices.assign(this->indices.begin(), this->indices.end());
+}
+
 //////////////////////////////////////////////////
 void SubMesh::RecalculateNormals()
 {
@@ -17,6 +17,7 @@
 #ifndef _GAZEBO_MESH_HH_
 #define _GAZEBO_MESH_HH_
 
+#include <cstdint>
 #include <vector>
 #include <string>
 
@@ -210,6 +211,35 @@ namespace gazebo
       public: float weight;
     };
 
+    /// \brief Single precision vertex data of a submesh, laid out the way
+    /// physics and rendering engines take it, so it can be copied to them
+    /// without converting each vertex.
+    /// \sa SubMesh::FillBuffer
+    class GZ_COMMON_VISIBLE SubMeshBuffer
+    {
+      /// \brief Get the number of floats of each vertex in vertices.
+      /// \return 6 with normals, otherwise 3.
+      public: unsigned int Stride() const;
+
+      /// \brief Number of vertices.
+      public: unsigned int vertexCount = 0;
+
+      /// \brief True if vertices holds a normal after each position.
+      public: bool hasNormals = false;
+
+      /// \brief Positions, each followed by its normal if hasNormals, so
+      /// x y z [nx ny nz] for each vertex.
+      public: std::vector<float> vertices;
+
+      /// \brief Texture coordinates, u v for each vertex. Empty if the
+      /// submesh has none. They're apart from the positions, since vertex
+      /// animation needs positions and normals in their own buffer.
+      public: std::vector<float> texCoords;
+
+      /// \brief Vertex indices.
+      public: std::vector<uint32_t> indices;
+    };
+
     /// \brief A child mesh
     class GZ_COMMON_VISIBLE SubMesh
     {
@@ -396,6 +426,17 @@ namespace gazebo
       /// \param[in] _indArr
       public: void FillArrays(float **_vertArr, int **_indArr) const;
 
+      /// \brief Fill a single precision buffer with the vertices, normals,
+      /// texture coordinates and indices, in one pass. The buffer's
+      /// vectors keep their memory, so it can be reused for other
+      /// submeshes.
+      /// \param[out] _buffer The buffer.
+      /// \param[in] _offset Offset added to the positions, such as the
+      /// one which centers the submesh.
+      public: void FillBuffer(SubMeshBuffer &_buffer,
+                  const ignition::math::Vector3d &_offset =
+                  ignition::math::Vector3d::Zero) const;
+
       /// \brief Recalculate all the normals.
       public: void RecalculateNormals();
 
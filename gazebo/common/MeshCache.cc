@@ -0,0 +1,504 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/CommonIface.hh"
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Material.hh"
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshCache.hh"
+
+using namespace gazebo;
+using namespace common;
+
+namespace
+{
+  /// \brief Identifies a mesh cache file.
+  const char kMeshCacheMagic[4] = {'G', 'Z', 'M', 'C'};
+
+  /// \brief Version of the mesh cache file layout. Part of the file names,
+  /// so files of other versions are never read.
+  const uint32_t kMeshCacheVersion = 1;
+
+  /// \brief Appends the fields of a cache file to a buffer. Arrays start on
+  /// 8 byte boundaries, so they can be read in place from the mapping.
+  class MeshCacheWriter
+  {
+    /// \brief Append a value.
+    /// \param[in] _value The value.
+    public: template<typename T> void Put(const T &_value)
+    {
+      this->data.append(reinterpret_cast<const char *>(&_value),
+          sizeof(_value));
+    }
+
+    /// \brief Append a string.
+    /// \param[in] _value The string.
+    public: void PutString(const std::string &_value)
+    {
+      this->Put<uint32_t>(_value.size());
+      this->data.append(_value);
+      this->Align();
+    }
+
+    /// \brief Append an array.
+    /// \param[in] _values The values.
+    /// \param[in] _count Number of values.
+    public: template<typename T> void PutArray(const T *_values,
+                const std::size_t _count)
+    {
+      this->data.append(reinterpret_cast<const char *>(_values),
+          _count * sizeof(T));
+      this->Align();
+    }
+
+    /// \brief Pad the buffer to the next 8 byte boundary.
+    public: void Align()
+    {
+      this->data.append((8 - this->data.size() % 8) % 8, '\0');
+    }
+
+    /// \brief The buffer.
+    public: std::string data;
+  };
+
+  /// \brief Reads the fields of a cache file. Reads past the end of the
+  /// file fail, and are remembered in the ok flag.
+  class MeshCacheReader
+  {
+    /// \brief Constructor.
+    /// \param[in] _data Contents of the file.
+    /// \param[in] _size Size of the file, in bytes.
+    public: MeshCacheReader(const char *_data, const std::size_t _size)
+      : data(_data), size(_size)
+    {
+    }
+
+    /// \brief Read a value.
+    /// \param[out] _value The value.
+    public: template<typename T> void Get(T &_value)
+    {
+      if (const char *p = this->Take(sizeof(_value)))
+        std::memcpy(&_value, p, sizeof(_value));
+      else
+        _value = T();
+    }
+
+    /// \brief Read a string.
+    /// \return The string.
+    public: std::string GetString()
+    {
+      uint32_t length = 0;
+      this->Get(length);
+      const char *p = this->Take(length);
+      this->Align();
+      return p ? std::string(p, length) : std::string();
+    }
+
+    /// \brief Get an array in place.
+    /// \param[in] _count Number of values.
+    /// \return The values, or nullptr if the file is too short.
+    public: template<typename T> const T *GetArray(const std::size_t _count)
+    {
+      if (_count > this->size / sizeof(T))
+      {
+        this->ok = false;
+        return nullptr;
+      }
+      const T *values = reinterpret_cast<const T *>(
+          this->Take(_count * sizeof(T)));
+      this->Align();
+      return values;
+    }
+
+    /// \brief Skip to the next 8 byte boundary.
+    public: void Align()
+    {
+      this->Take((8 - this->offset % 8) % 8);
+    }
+
+    /// \brief Take bytes of the file.
+    /// \param[in] _bytes Number of bytes.
+    /// \return The bytes, or nullptr if the file is too short.
+    private: const char *Take(const std::size_t _bytes)
+    {
+      if (!this->ok || _bytes > this->size - this->offset)
+      {
+        this->ok = false;
+        return nullptr;
+      }
+      const char *p = this->data + this->offset;
+      this->offset += _bytes;
+      return p;
+    }
+
+    /// \brief True while all the reads were in the file.
+    public: bool ok = true;
+
+    /// \brief Contents of the file.
+    private: const char *data;
+
+    /// \brief Size of the file, in bytes.
+    private: std::size_t size;
+
+    /// \brief Offset of the next read.
+    private: std::size_t offset = 0;
+  };
+
+  /// \brief Append a color.
+  /// \param[in] _writer The writer.
+  /// \param[in] _color The color.
+  void PutColor(MeshCacheWriter &_writer, const ignition::math::Color &_color)
+  {
+    _writer.Put<float>(_color.R());
+    _writer.Put<float>(_color.G());
+    _writer.Put<float>(_color.B());
+    _writer.Put<float>(_color.A());
+  }
+
+  /// \brief Read a color.
+  /// \param[in] _reader The reader.
+  /// \return The color.
+  ignition::math::Color GetColor(MeshCacheReader &_reader)
+  {
+    float rgba[4];
+    for (float &c : rgba)
+      _reader.Get(c);
+    return ignition::math::Color(rgba[0], rgba[1], rgba[2], rgba[3]);
+  }
+}
+
+//////////////////////////////////////////////////
+std::string MeshCache::Filename(const std::string &_meshFilename,
+    const std::string &_cacheDir)
+{
+  const boost::filesystem::path path =
+      boost::filesystem::absolute(_meshFilename);
+
+  std::ifstream file(path.string(), std::ios::binary);
+  if (!file)
+    return "";
+
+  // The key is the directory which textures are resolved in, and the
+  // contents of the mesh file
+  std::string key = path.parent_path().string() + "\n";
+  key.append(std::istreambuf_iterator<char>(file),
+      std::istreambuf_iterator<char>());
+  if (file.bad())
+    return "";
+
+  return KeyFilename(key, _cacheDir);
+}
+
+//////////////////////////////////////////////////
+std::string MeshCache::KeyFilename(const std::string &_key,
+    const std::string &_cacheDir)
+{
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(_cacheDir, ec);
+  if (ec)
+  {
+    gzwarn << "Unable to create the mesh cache directory [" << _cacheDir
+           << "]: " << ec.message() << std::endl;
+    return "";
+  }
+
+  const std::string key = std::to_string(kMeshCacheVersion) + "\n" + _key;
+  return (boost::filesystem::path(_cacheDir) /
+      (common::get_sha1<std::string>(key) + ".mesh")).string();
+}
+
+//////////////////////////////////////////////////
+bool MeshCache::Save(const Mesh &_mesh, const std::string &_filename)
+{
+  if (_mesh.HasSkeleton())
+    return false;
+
+  MeshCacheWriter writer;
+  writer.data.append(kMeshCacheMagic, sizeof(kMeshCacheMagic));
+  writer.Put<uint32_t>(kMeshCacheVersion);
+  writer.Put<uint32_t>(_mesh.GetMaterialCount());
+  writer.Put<uint32_t>(_mesh.GetSubMeshCount());
+  writer.PutString(_mesh.GetPath());
+
+  for (unsigned int i = 0; i < _mesh.GetMaterialCount(); ++i)
+  {
+    const Material *material = _mesh.GetMaterial(i);
+    writer.PutString(material->GetTextureImage());
+    PutColor(writer, material->Ambient());
+    PutColor(writer, material->Diffuse());
+    PutColor(writer, material->Specular());
+    PutColor(writer, material->Emissive());
+
+    double srcFactor, dstFactor;
+    material->GetBlendFactors(srcFactor, dstFactor);
+    writer.Put<double>(material->GetTransparency());
+    writer.Put<double>(material->GetShininess());
+    writer.Put<double>(material->GetPointSize());
+    writer.Put<double>(srcFactor);
+    writer.Put<double>(dstFactor);
+    writer.Put<uint32_t>(material->GetBlendMode());
+    writer.Put<uint32_t>(material->GetShadeMode());
+    writer.Put<uint32_t>(material->GetDepthWrite());
+    writer.Put<uint32_t>(material->GetLighting());
+  }
+
+  std::vector<double> values;
+  std::vector<uint32_t> indices;
+  for (unsigned int i = 0; i < _mesh.GetSubMeshCount(); ++i)
+  {
+    const SubMesh *subMesh = _mesh.GetSubMesh(i);
+    if (subMesh->GetNodeAssignmentsCount() > 0)
+      return false;
+
+    writer.PutString(subMesh->GetName());
+    writer.Put<uint32_t>(subMesh->GetPrimitiveType());
+    writer.Put<int32_t>(static_cast<int32_t>(subMesh->GetMaterialIndex()));
+    writer.Put<uint32_t>(subMesh->GetVertexCount());
+    writer.Put<uint32_t>(subMesh->GetNormalCount());
+    writer.Put<uint32_t>(subMesh->GetTexCoordCount());
+    writer.Put<uint32_t>(subMesh->GetIndexCount());
+
+    values.clear();
+    for (unsigned int v = 0; v < subMesh->GetVertexCount(); ++v)
+    {
+      const ignition::math::Vector3d vertex = subMesh->Vertex(v);
+      values.insert(values.end(), {vertex.X(), vertex.Y(), vertex.Z()});
+    }
+    writer.PutArray(values.data(), values.size());
+
+    values.clear();
+    for (unsigned int n = 0; n < subMesh->GetNormalCount(); ++n)
+    {
+      const ignition::math::Vector3d normal = subMesh->Normal(n);
+      values.insert(values.end(), {normal.X(), normal.Y(), normal.Z()});
+    }
+    writer.PutArray(values.data(), values.size());
+
+    values.clear();
+    for (unsigned int t = 0; t < subMesh->GetTexCoordCount(); ++t)
+    {
+      const ignition::math::Vector2d texCoord = subMesh->TexCoord(t);
+      values.insert(values.end(), {texCoord.X(), texCoord.Y()});
+    }
+    writer.PutArray(values.data(), values.size());
+
+    indices.clear();
+    for (unsigned int n = 0; n < subMesh->GetIndexCount(); ++n)
+      indices.push_back(subMesh->GetIndex(n));
+    writer.PutArray(indices.data(), indices.size());
+  }
+
+  // Write to a temporary file first, so a concurrent load never maps a
+  // partial file.
+  boost::system::error_code ec;
+  const boost::filesystem::path tmpFilename = _filename +
+      boost::filesystem::unique_path(".%%%%-%%%%.tmp").string();
+  {
+    std::ofstream out(tmpFilename.string(), std::ios::binary | std::ios::trunc);
+    out.write(writer.data.data(), writer.data.size());
+    if (!out)
+    {
+      gzwarn << "Unable to write mesh cache file [" << tmpFilename.string()
+             << "]\n";
+      out.close();
+      boost::filesystem::remove(tmpFilename, ec);
+      return false;
+    }
+  }
+
+  boost::filesystem::rename(tmpFilename, _filename, ec);
+  if (ec)
+  {
+    gzwarn << "Unable to write mesh cache file [" << _filename << "]: "
+           << ec.message() << std::endl;
+    boost::filesystem::remove(tmpFilename, ec);
+    return false;
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+Mesh *MeshCache::Load(const std::string &_filename)
+{
+  // The file stays mapped until the mesh is built
+  std::shared_ptr<const char> contents;
+  std::size_t size = 0;
+#ifndef _WIN32
+  int fd = open(_filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    return nullptr;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0)
+  {
+    close(fd);
+    return nullptr;
+  }
+  size = static_cast<std::size_t>(st.st_size);
+
+  void *map = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+    return nullptr;
+  contents.reset(static_cast<const char *>(map), [size](const char *_map)
+      {
+        munmap(const_cast<char *>(_map), size);
+      });
+#else
+  std::ifstream file(_filename, std::ios::binary);
+  if (!file)
+    return nullptr;
+  auto buffer = std::make_shared<std::vector<char>>(
+      (std::istreambuf_iterator<char>(file)),
+      std::istreambuf_iterator<char>());
+  size = buffer->size();
+  contents = std::shared_ptr<const char>(buffer, buffer->data());
+#endif
+
+  MeshCacheReader reader(contents.get(), size);
+  char magic[sizeof(kMeshCacheMagic)];
+  for (char &c : magic)
+    reader.Get(c);
+  uint32_t version = 0, materialCount = 0, subMeshCount = 0;
+  reader.Get(version);
+  reader.Get(materialCount);
+  reader.Get(subMeshCount);
+  if (!reader.ok ||
+      std::memcmp(magic, kMeshCacheMagic, sizeof(kMeshCacheMagic)) != 0 ||
+      version != kMeshCacheVersion)
+  {
+    return nullptr;
+  }
+
+  std::unique_ptr<Mesh> mesh(new Mesh());
+  mesh->SetPath(reader.GetString());
+
+  for (uint32_t i = 0; i < materialCount && reader.ok; ++i)
+  {
+    Material *material = new Material();
+    mesh->AddMaterial(material);
+
+    material->SetTextureImage(reader.GetString());
+    material->SetAmbient(GetColor(reader));
+    material->SetDiffuse(GetColor(reader));
+    material->SetSpecular(GetColor(reader));
+    material->SetEmissive(GetColor(reader));
+
+    double transparency, shininess, pointSize, srcFactor, dstFactor;
+    reader.Get(transparency);
+    reader.Get(shininess);
+    reader.Get(pointSize);
+    reader.Get(srcFactor);
+    reader.Get(dstFactor);
+    uint32_t blendMode, shadeMode, depthWrite, lighting;
+    reader.Get(blendMode);
+    reader.Get(shadeMode);
+    reader.Get(depthWrite);
+    reader.Get(lighting);
+    if (blendMode >= Material::BLEND_COUNT ||
+        shadeMode >= Material::SHADE_COUNT)
+    {
+      return nullptr;
+    }
+
+    material->SetTransparency(transparency);
+    material->SetShininess(shininess);
+    material->SetPointSize(pointSize);
+    material->SetBlendFactors(srcFactor, dstFactor);
+    material->SetBlendMode(static_cast<Material::BlendMode>(blendMode));
+    material->SetShadeMode(static_cast<Material::ShadeMode>(shadeMode));
+    material->SetDepthWrite(depthWrite != 0);
+    material->SetLighting(lighting != 0);
+  }
+
+  for (uint32_t i = 0; i < subMeshCount && reader.ok; ++i)
+  {
+    SubMesh *subMesh = new SubMesh();
+    mesh->AddSubMesh(subMesh);
+
+    subMesh->SetName(reader.GetString());
+    uint32_t primitiveType = 0, vertexCount = 0, normalCount = 0,
+             texCoordCount = 0, indexCount = 0;
+    int32_t materialIndex = -1;
+    reader.Get(primitiveType);
+    reader.Get(materialIndex);
+    reader.Get(vertexCount);
+    reader.Get(normalCount);
+    reader.Get(texCoordCount);
+    reader.Get(indexCount);
+    if (primitiveType > SubMesh::TRISTRIPS)
+      return nullptr;
+
+    subMesh->SetPrimitiveType(
+        static_cast<SubMesh::PrimitiveType>(primitiveType));
+    if (materialIndex >= 0)
+      subMesh->SetMaterialIndex(materialIndex);
+
+    const double *vertices = reader.GetArray<double>(vertexCount * 3ul);
+    const double *normals = reader.GetArray<double>(normalCount * 3ul);
+    const double *texCoords = reader.GetArray<double>(texCoordCount * 2ul);
+    const uint32_t *indices = reader.GetArray<uint32_t>(indexCount);
+    if (!reader.ok)
+      return nullptr;
+
+    subMesh->SetVertexCount(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; ++v)
+    {
+      subMesh->SetVertex(v, ignition::math::Vector3d(
+            vertices[v * 3], vertices[v * 3 + 1], vertices[v * 3 + 2]));
+    }
+
+    subMesh->SetNormalCount(normalCount);
+    for (uint32_t n = 0; n < normalCount; ++n)
+    {
+      subMesh->SetNormal(n, ignition::math::Vector3d(
+            normals[n * 3], normals[n * 3 + 1], normals[n * 3 + 2]));
+    }
+
+    subMesh->SetTexCoordCount(texCoordCount);
+    for (uint32_t t = 0; t < texCoordCount; ++t)
+    {
+      subMesh->SetTexCoord(t, ignition::math::Vector2d(
+            texCoords[t * 2], texCoords[t * 2 + 1]));
+    }
+
+    for (uint32_t n = 0; n < indexCount; ++n)
+      subMesh->AddIndex(indices[n]);
+  }
+
+  if (!reader.ok)
+    return nullptr;
+
+  return mesh.release();
+}
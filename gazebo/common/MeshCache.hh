@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_MESHCACHE_HH_
+#define GAZEBO_COMMON_MESHCACHE_HH_
+
+#include <string>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    class Mesh;
+
+    /// \addtogroup gazebo_common Common
+    /// \{
+
+    /// \class MeshCache MeshCache.hh common/common.hh
+    /// \brief Binary cache of loaded meshes on disk, so that mesh files
+    /// are only parsed once.
+    ///
+    /// Meshes generated from other meshes or shapes, such as boolean
+    /// meshes and extrusions, are cached too, named after a hash of their
+    /// inputs.
+    ///
+    /// A cache file holds the vertices, normals, texture coordinates and
+    /// indices of the submeshes of a mesh, as flat arrays, and its
+    /// materials. It's memory-mapped when loaded. Cache files are named
+    /// after a hash of the contents and directory of the mesh file, so a
+    /// changed mesh gets a new cache file. The directory is part of the
+    /// name because texture paths are resolved relative to it.
+    ///
+    /// Meshes with a skeleton aren't cached, since their animations can't
+    /// be read back through the Skeleton API.
+    class GZ_COMMON_VISIBLE MeshCache
+    {
+      /// \brief Get the cache file of a mesh file.
+      /// \param[in] _meshFilename Path of the mesh file.
+      /// \param[in] _cacheDir Directory of the cache files. It's created if
+      /// needed.
+      /// \return Path of the cache file, which may not exist. Empty if the
+      /// mesh file can't be read, or the directory created.
+      public: static std::string Filename(const std::string &_meshFilename,
+                  const std::string &_cacheDir);
+
+      /// \brief Get the cache file of a generated mesh.
+      /// \param[in] _key Inputs the mesh is generated from, such as the
+      /// geometry and parameters of a boolean operation.
+      /// \param[in] _cacheDir Directory of the cache files. It's created if
+      /// needed.
+      /// \return Path of the cache file, which may not exist. Empty if the
+      /// directory can't be created.
+      public: static std::string KeyFilename(const std::string &_key,
+                  const std::string &_cacheDir);
+
+      /// \brief Save a mesh to a cache file.
+      /// \param[in] _mesh The mesh.
+      /// \param[in] _filename Path of the cache file.
+      /// \return False if the mesh can't be cached, or the file written.
+      public: static bool Save(const Mesh &_mesh,
+                  const std::string &_filename);
+
+      /// \brief Load a mesh from a cache file.
+      /// \param[in] _filename Path of the cache file.
+      /// \return The mesh, which the caller owns, or nullptr if the file
+      /// doesn't exist or isn't a valid cache file.
+      public: static Mesh *Load(const std::string &_filename);
+    };
+    /// \}
+  }
+}
+#endif
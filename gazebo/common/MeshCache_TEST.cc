@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/ColladaLoader.hh"
+#include "gazebo/common/Material.hh"
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshCache.hh"
+#include "test_config.h"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class MeshCacheTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+#ifndef _WIN32
+TEST_F(MeshCacheTest, SaveLoad)
+{
+  namespace fs = boost::filesystem;
+  const fs::path cacheDir = fs::temp_directory_path() /
+    fs::unique_path("gazebo-MeshCache-%%%%-%%%%");
+  const std::string meshFilename =
+      std::string(PROJECT_SOURCE_PATH) + "/test/data/box.dae";
+
+  // The name depends on the contents of the file
+  const std::string filename =
+      common::MeshCache::Filename(meshFilename, cacheDir.string());
+  ASSERT_FALSE(filename.empty());
+  EXPECT_TRUE(fs::is_directory(cacheDir));
+  EXPECT_EQ(filename,
+      common::MeshCache::Filename(meshFilename, cacheDir.string()));
+  EXPECT_TRUE(common::MeshCache::Filename(
+        PROJECT_SOURCE_PATH "/test/data/missing.dae",
+        cacheDir.string()).empty());
+  EXPECT_NE(filename, common::MeshCache::Filename(
+        PROJECT_SOURCE_PATH "/test/data/box_offset.dae", cacheDir.string()));
+
+  // Nothing is cached yet
+  EXPECT_EQ(nullptr, common::MeshCache::Load(filename));
+
+  common::ColladaLoader loader;
+  std::unique_ptr<common::Mesh> mesh(loader.Load(meshFilename));
+  ASSERT_NE(nullptr, mesh);
+  ASSERT_FALSE(mesh->HasSkeleton());
+
+  // Give it a material with non default values
+  common::Material *material = new common::Material();
+  material->SetTextureImage("/textures/box.png");
+  material->SetDiffuse(ignition::math::Color(0.1f, 0.2f, 0.3f, 0.4f));
+  material->SetTransparency(0.5);
+  material->SetShininess(2.0);
+  material->SetBlendMode(common::Material::ADD);
+  material->SetShadeMode(common::Material::FLAT);
+  material->SetLighting(false);
+  const int materialIndex = mesh->AddMaterial(material);
+
+  EXPECT_TRUE(common::MeshCache::Save(*mesh, filename));
+  std::unique_ptr<common::Mesh> cached(common::MeshCache::Load(filename));
+  ASSERT_NE(nullptr, cached);
+
+  EXPECT_EQ(mesh->GetPath(), cached->GetPath());
+  EXPECT_EQ(mesh->Min(), cached->Min());
+  EXPECT_EQ(mesh->Max(), cached->Max());
+  ASSERT_EQ(mesh->GetSubMeshCount(), cached->GetSubMeshCount());
+  for (unsigned int i = 0; i < mesh->GetSubMeshCount(); ++i)
+  {
+    const common::SubMesh *subMesh = mesh->GetSubMesh(i);
+    const common::SubMesh *cachedSubMesh = cached->GetSubMesh(i);
+    EXPECT_EQ(subMesh->GetName(), cachedSubMesh->GetName());
+    EXPECT_EQ(subMesh->GetPrimitiveType(),
+        cachedSubMesh->GetPrimitiveType());
+    EXPECT_EQ(subMesh->GetMaterialIndex(),
+        cachedSubMesh->GetMaterialIndex());
+    ASSERT_EQ(subMesh->GetVertexCount(), cachedSubMesh->GetVertexCount());
+    ASSERT_EQ(subMesh->GetNormalCount(), cachedSubMesh->GetNormalCount());
+    ASSERT_EQ(subMesh->GetTexCoordCount(),
+        cachedSubMesh->GetTexCoordCount());
+    ASSERT_EQ(subMesh->GetIndexCount(), cachedSubMesh->GetIndexCount());
+    for (unsigned int v = 0; v < subMesh->GetVertexCount(); ++v)
+      EXPECT_EQ(subMesh->Vertex(v), cachedSubMesh->Vertex(v));
+    for (unsigned int n = 0; n < subMesh->GetNormalCount(); ++n)
+      EXPECT_EQ(subMesh->Normal(n), cachedSubMesh->Normal(n));
+    for (unsigned int t = 0; t < subMesh->GetTexCoordCount(); ++t)
+      EXPECT_EQ(subMesh->TexCoord(t), cachedSubMesh->TexCoord(t));
+    for (unsigned int n = 0; n < subMesh->GetIndexCount(); ++n)
+      EXPECT_EQ(subMesh->GetIndex(n), cachedSubMesh->GetIndex(n));
+  }
+
+  ASSERT_EQ(mesh->GetMaterialCount(), cached->GetMaterialCount());
+  const common::Material *cachedMaterial =
+      cached->GetMaterial(materialIndex);
+  ASSERT_NE(nullptr, cachedMaterial);
+  EXPECT_EQ("/textures/box.png", cachedMaterial->GetTextureImage());
+  EXPECT_EQ(material->Diffuse(), cachedMaterial->Diffuse());
+  EXPECT_EQ(material->Ambient(), cachedMaterial->Ambient());
+  EXPECT_DOUBLE_EQ(0.5, cachedMaterial->GetTransparency());
+  EXPECT_DOUBLE_EQ(2.0, cachedMaterial->GetShininess());
+  EXPECT_EQ(common::Material::ADD, cachedMaterial->GetBlendMode());
+  EXPECT_EQ(common::Material::FLAT, cachedMaterial->GetShadeMode());
+  EXPECT_FALSE(cachedMaterial->GetLighting());
+  EXPECT_TRUE(cachedMaterial->GetDepthWrite());
+
+  // A truncated file isn't loaded
+  fs::resize_file(filename, fs::file_size(filename) / 2);
+  EXPECT_EQ(nullptr, common::MeshCache::Load(filename));
+
+  fs::remove_all(cacheDir);
+}
+#endif
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,431 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <memory>
+#include <set>
+#include <utility>
+
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshDecomposition.hh"
+
+using namespace gazebo;
+using namespace common;
+
+namespace
+{
+  /// \brief Convex polygon of the surface of a mesh.
+  typedef std::vector<ignition::math::Vector3d> Polygon;
+
+  /// \brief Plane of a hull face.
+  struct Plane
+  {
+    /// \brief Signed distance of a point to the plane.
+    /// \param[in] _point The point.
+    /// \return The distance, positive outside the hull.
+    double Distance(const ignition::math::Vector3d &_point) const
+    {
+      return this->normal.Dot(_point) - this->offset;
+    }
+
+    /// \brief Unit normal, pointing outside the hull.
+    ignition::math::Vector3d normal;
+
+    /// \brief Distance of the plane to the origin along the normal.
+    double offset = 0.0;
+  };
+
+  /// \brief Triangle of a hull being built.
+  struct Face
+  {
+    /// \brief Indices of the points, counter-clockwise seen from outside.
+    std::array<unsigned int, 3> v;
+
+    /// \brief Plane of the triangle.
+    Plane plane;
+
+    /// \brief True once a point outside the face has replaced it.
+    bool removed = false;
+  };
+
+  /// \brief Part of a mesh being decomposed.
+  struct Part
+  {
+    /// \brief Surface of the part.
+    std::vector<Polygon> polygons;
+
+    /// \brief Hull of the surface, nullptr if it is flat.
+    std::unique_ptr<SubMesh> hull;
+
+    /// \brief Largest depth of the surface under the hull.
+    double concavity = 0.0;
+  };
+
+  /// \brief Make a hull face.
+  /// \param[in] _points Points of the hull.
+  /// \param[in] _a First point, the others follow counter-clockwise.
+  /// \param[in] _b Second point.
+  /// \param[in] _c Third point.
+  /// \return The face.
+  Face MakeFace(const std::vector<ignition::math::Vector3d> &_points,
+      const unsigned int _a, const unsigned int _b, const unsigned int _c)
+  {
+    Face face;
+    face.v = {{_a, _b, _c}};
+    face.plane.normal = (_points[_b] - _points[_a]).Cross(
+        _points[_c] - _points[_a]).Normalize();
+    face.plane.offset = face.plane.normal.Dot(_points[_a]);
+    return face;
+  }
+
+  /// \brief Get the planes of the faces of a hull.
+  /// \param[in] _hull The hull, see MeshDecomposition::ConvexHull.
+  /// \return The planes.
+  std::vector<Plane> HullPlanes(const SubMesh &_hull)
+  {
+    std::vector<Plane> planes;
+    for (unsigned int i = 0; i + 2 < _hull.GetIndexCount(); i += 3)
+    {
+      const ignition::math::Vector3d a = _hull.Vertex(_hull.GetIndex(i));
+      Plane plane;
+      plane.normal = (_hull.Vertex(_hull.GetIndex(i + 1)) - a).Cross(
+          _hull.Vertex(_hull.GetIndex(i + 2)) - a).Normalize();
+      plane.offset = plane.normal.Dot(a);
+      planes.push_back(plane);
+    }
+    return planes;
+  }
+
+  /// \brief Keep the part of a polygon under a bound along an axis.
+  /// \param[in] _polygon The polygon.
+  /// \param[in] _axis Index of the axis.
+  /// \param[in] _bound The bound.
+  /// \param[in] _sign 1 to keep the part below the bound, -1 to keep the
+  /// part above it.
+  /// \return The clipped polygon, empty if it is all on the other side.
+  Polygon Clip(const Polygon &_polygon, const unsigned int _axis,
+      const double _bound, const double _sign)
+  {
+    Polygon result;
+    for (unsigned int i = 0; i < _polygon.size(); ++i)
+    {
+      const ignition::math::Vector3d &a = _polygon[i];
+      const ignition::math::Vector3d &b = _polygon[(i + 1) % _polygon.size()];
+      const double da = _sign * (a[_axis] - _bound);
+      const double db = _sign * (b[_axis] - _bound);
+      if (da <= 0.0)
+        result.push_back(a);
+      if ((da < 0.0 && db > 0.0) || (da > 0.0 && db < 0.0))
+        result.push_back(a + (b - a) * (da / (da - db)));
+    }
+    if (result.size() < 3u)
+      result.clear();
+    return result;
+  }
+
+  /// \brief Make a part from its surface, and measure how concave it is.
+  /// \param[in] _polygons The surface of the part.
+  /// \return The part.
+  Part MakePart(std::vector<Polygon> &&_polygons)
+  {
+    Part part;
+    part.polygons = std::move(_polygons);
+
+    std::vector<ignition::math::Vector3d> points;
+    for (auto const &polygon : part.polygons)
+      points.insert(points.end(), polygon.begin(), polygon.end());
+    part.hull.reset(MeshDecomposition::ConvexHull(points));
+    if (!part.hull)
+      return part;
+
+    const std::vector<Plane> planes = HullPlanes(*part.hull);
+    for (auto const &polygon : part.polygons)
+    {
+      ignition::math::Vector3d centroid;
+      for (auto const &point : polygon)
+        centroid += point;
+      centroid /= static_cast<double>(polygon.size());
+
+      double depth = std::numeric_limits<double>::max();
+      for (auto const &plane : planes)
+        depth = std::min(depth, -plane.Distance(centroid));
+      part.concavity = std::max(part.concavity, depth);
+    }
+    return part;
+  }
+}
+
+//////////////////////////////////////////////////
+SubMesh *MeshDecomposition::ConvexHull(
+    const std::vector<ignition::math::Vector3d> &_points)
+{
+  const std::vector<ignition::math::Vector3d> &p = _points;
+  if (p.size() < 4u)
+    return nullptr;
+
+  ignition::math::Vector3d min = p[0];
+  ignition::math::Vector3d max = p[0];
+  for (auto const &point : p)
+  {
+    min.Min(point);
+    max.Max(point);
+  }
+  const double eps = 1e-9 * (max - min).Length();
+  if (!std::isfinite(eps) || eps <= 0.0)
+    return nullptr;
+
+  // Start with a tetrahedron of extreme points
+  unsigned int i0 = 0;
+  for (unsigned int i = 1; i < p.size(); ++i)
+  {
+    if (p[i].X() < p[i0].X())
+      i0 = i;
+  }
+
+  unsigned int i1 = i0;
+  double best = 0.0;
+  for (unsigned int i = 0; i < p.size(); ++i)
+  {
+    const double d = p[i].Distance(p[i0]);
+    if (d > best)
+    {
+      best = d;
+      i1 = i;
+    }
+  }
+  if (best <= eps)
+    return nullptr;
+
+  const ignition::math::Vector3d axis = (p[i1] - p[i0]).Normalize();
+  unsigned int i2 = i0;
+  best = 0.0;
+  for (unsigned int i = 0; i < p.size(); ++i)
+  {
+    const double d = (p[i] - p[i0]).Cross(axis).Length();
+    if (d > best)
+    {
+      best = d;
+      i2 = i;
+    }
+  }
+  if (best <= eps)
+    return nullptr;
+
+  const ignition::math::Vector3d normal =
+      (p[i1] - p[i0]).Cross(p[i2] - p[i0]).Normalize();
+  unsigned int i3 = i0;
+  best = 0.0;
+  for (unsigned int i = 0; i < p.size(); ++i)
+  {
+    const double d = std::abs(normal.Dot(p[i] - p[i0]));
+    if (d > best)
+    {
+      best = d;
+      i3 = i;
+    }
+  }
+  if (best <= eps)
+    return nullptr;
+
+  // Orient the tetrahedron so that its faces point outside
+  if (normal.Dot(p[i3] - p[i0]) > 0.0)
+    std::swap(i1, i2);
+
+  std::vector<Face> faces;
+  faces.push_back(MakeFace(p, i0, i1, i2));
+  faces.push_back(MakeFace(p, i0, i3, i1));
+  faces.push_back(MakeFace(p, i1, i3, i2));
+  faces.push_back(MakeFace(p, i2, i3, i0));
+  unsigned int liveFaces = faces.size();
+
+  // Add the points outside the hull one at a time
+  std::vector<unsigned int> visible;
+  std::set<std::pair<unsigned int, unsigned int>> edges;
+  for (unsigned int i = 0; i < p.size(); ++i)
+  {
+    visible.clear();
+    for (unsigned int f = 0; f < faces.size(); ++f)
+    {
+      if (!faces[f].removed && faces[f].plane.Distance(p[i]) > eps)
+        visible.push_back(f);
+    }
+    if (visible.empty())
+      continue;
+
+    // The faces the point sees are replaced by a cone from the point to
+    // the horizon, the edges whose opposite edge isn't seen
+    edges.clear();
+    for (auto f : visible)
+    {
+      faces[f].removed = true;
+      for (unsigned int j = 0; j < 3; ++j)
+        edges.insert(std::make_pair(faces[f].v[j], faces[f].v[(j + 1) % 3]));
+    }
+    liveFaces -= visible.size();
+
+    for (auto const &edge : edges)
+    {
+      if (edges.count(std::make_pair(edge.second, edge.first)) == 0)
+      {
+        faces.push_back(MakeFace(p, edge.first, edge.second, i));
+        ++liveFaces;
+      }
+    }
+
+    if (faces.size() > 2 * liveFaces + 64)
+    {
+      faces.erase(std::remove_if(faces.begin(), faces.end(),
+          [](const Face &_face) { return _face.removed; }), faces.end());
+    }
+  }
+
+  SubMesh *hull = new SubMesh();
+  hull->SetPrimitiveType(SubMesh::TRIANGLES);
+  std::map<unsigned int, unsigned int> vertices;
+  for (auto const &face : faces)
+  {
+    if (face.removed)
+      continue;
+
+    for (auto v : face.v)
+    {
+      auto inserted = vertices.insert(std::make_pair(v, vertices.size()));
+      if (inserted.second)
+        hull->AddVertex(p[v]);
+      hull->AddIndex(inserted.first->second);
+    }
+  }
+  return hull;
+}
+
+//////////////////////////////////////////////////
+Mesh *MeshDecomposition::Generate(const Mesh &_mesh,
+    const unsigned int _maxHulls, const double _concavity)
+{
+  if (_maxHulls == 0)
+    return nullptr;
+
+  std::vector<Polygon> polygons;
+  for (unsigned int i = 0; i < _mesh.GetSubMeshCount(); ++i)
+  {
+    const SubMesh *subMesh = _mesh.GetSubMesh(i);
+    if (subMesh->GetPrimitiveType() != SubMesh::TRIANGLES)
+      continue;
+
+    const unsigned int vertexCount = subMesh->GetVertexCount();
+    for (unsigned int j = 0; j + 2 < subMesh->GetIndexCount(); j += 3)
+    {
+      Polygon triangle;
+      for (unsigned int k = 0; k < 3; ++k)
+      {
+        const unsigned int index = subMesh->GetIndex(j + k);
+        if (index < vertexCount)
+          triangle.push_back(subMesh->Vertex(index));
+      }
+      if (triangle.size() == 3u)
+        polygons.push_back(triangle);
+    }
+  }
+  if (polygons.empty())
+    return nullptr;
+
+  ignition::math::Vector3d min = polygons[0][0];
+  ignition::math::Vector3d max = polygons[0][0];
+  for (auto const &polygon : polygons)
+  {
+    for (auto const &point : polygon)
+    {
+      min.Min(point);
+      max.Max(point);
+    }
+  }
+  const double tolerance = _concavity * (max - min).Length();
+
+  std::vector<Part> parts;
+  parts.push_back(MakePart(std::move(polygons)));
+  while (parts.size() < _maxHulls)
+  {
+    auto worst = std::max_element(parts.begin(), parts.end(),
+        [](const Part &_a, const Part &_b)
+        {
+          return _a.concavity < _b.concavity;
+        });
+    if (worst->concavity <= tolerance)
+      break;
+
+    // Cut the part in halves across the longest side of its bounds
+    ignition::math::Vector3d partMin = worst->polygons[0][0];
+    ignition::math::Vector3d partMax = worst->polygons[0][0];
+    for (auto const &polygon : worst->polygons)
+    {
+      for (auto const &point : polygon)
+      {
+        partMin.Min(point);
+        partMax.Max(point);
+      }
+    }
+    const ignition::math::Vector3d size = partMax - partMin;
+    unsigned int axis = 0;
+    for (unsigned int i = 1; i < 3; ++i)
+    {
+      if (size[i] > size[axis])
+        axis = i;
+    }
+    const double bound = 0.5 * (partMin[axis] + partMax[axis]);
+
+    std::vector<Polygon> below;
+    std::vector<Polygon> above;
+    for (auto const &polygon : worst->polygons)
+    {
+      Polygon clipped = Clip(polygon, axis, bound, 1.0);
+      if (!clipped.empty())
+        below.push_back(clipped);
+      clipped = Clip(polygon, axis, bound, -1.0);
+      if (!clipped.empty())
+        above.push_back(clipped);
+    }
+
+    // Keep parts whose halves would lose a flat piece of the surface
+    Part low = MakePart(std::move(below));
+    Part high = MakePart(std::move(above));
+    if (!low.hull || !high.hull)
+    {
+      worst->concavity = 0.0;
+      continue;
+    }
+
+    *worst = std::move(low);
+    parts.push_back(std::move(high));
+  }
+
+  Mesh *mesh = new Mesh();
+  for (auto &part : parts)
+  {
+    if (part.hull)
+      mesh->AddSubMesh(part.hull.release());
+  }
+  if (mesh->GetSubMeshCount() == 0)
+  {
+    delete mesh;
+    return nullptr;
+  }
+  return mesh;
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_MESHDECOMPOSITION_HH_
+#define GAZEBO_COMMON_MESHDECOMPOSITION_HH_
+
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    class Mesh;
+    class SubMesh;
+
+    /// \addtogroup gazebo_common Common
+    /// \{
+
+    /// \class MeshDecomposition MeshDecomposition.hh common/common.hh
+    /// \brief Approximates meshes by convex hulls, which physics engines
+    /// collide much faster and more smoothly than triangles. The
+    /// triangles of a mesh are split in halves along the longest axis of
+    /// their bounding box, until the surface of each part lies close
+    /// enough to the hull of the part.
+    class GZ_COMMON_VISIBLE MeshDecomposition
+    {
+      /// \brief Compute the convex hull of points.
+      /// \param[in] _points The points.
+      /// \return A triangle list of the hull, with the triangles
+      /// counter-clockwise seen from outside, which the caller owns.
+      /// Nullptr if the points are all on a plane.
+      public: static SubMesh *ConvexHull(
+                  const std::vector<ignition::math::Vector3d> &_points);
+
+      /// \brief Decompose a mesh into convex hulls.
+      /// \param[in] _mesh The mesh, whose triangle lists are decomposed.
+      /// \param[in] _maxHulls Maximum number of hulls.
+      /// \param[in] _concavity Largest distance between the surface of a
+      /// part and its hull, relative to the diagonal of the bounding box of
+      /// the mesh, under which the part isn't split anymore.
+      /// \return A mesh with one submesh per hull, see ConvexHull, which
+      /// the caller owns. Nullptr if the mesh has no volume.
+      public: static Mesh *Generate(const Mesh &_mesh,
+                  const unsigned int _maxHulls = 16u,
+                  const double _concavity = 0.02);
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshDecomposition.hh"
+#include "gazebo/common/MeshManager.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class MeshDecompositionTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(MeshDecompositionTest, ConvexHull)
+{
+  // Corners of a unit cube, with points inside and on its faces
+  std::vector<ignition::math::Vector3d> points;
+  for (int i = 0; i < 8; ++i)
+    points.push_back(ignition::math::Vector3d(i & 1, (i >> 1) & 1, i >> 2));
+  points.push_back(ignition::math::Vector3d(0.5, 0.5, 0.5));
+  points.push_back(ignition::math::Vector3d(0.2, 0.7, 0.4));
+  points.push_back(ignition::math::Vector3d(0.5, 0.5, 1.0));
+
+  std::unique_ptr<common::SubMesh> hull(
+      common::MeshDecomposition::ConvexHull(points));
+  ASSERT_TRUE(hull != nullptr);
+  EXPECT_EQ(hull->GetVertexCount(), 8u);
+  EXPECT_EQ(hull->GetIndexCount(), 36u);
+
+  // The faces point outside
+  const ignition::math::Vector3d center(0.5, 0.5, 0.5);
+  for (unsigned int i = 0; i < hull->GetIndexCount(); i += 3)
+  {
+    ignition::math::Vector3d a = hull->Vertex(hull->GetIndex(i));
+    ignition::math::Vector3d b = hull->Vertex(hull->GetIndex(i + 1));
+    ignition::math::Vector3d c = hull->Vertex(hull->GetIndex(i + 2));
+    EXPECT_GT((b - a).Cross(c - a).Dot(a - center), 0.0) << i;
+  }
+
+  // Flat and too few points have no hull
+  std::vector<ignition::math::Vector3d> flat(points.begin(),
+      points.begin() + 4);
+  EXPECT_TRUE(common::MeshDecomposition::ConvexHull(flat) == nullptr);
+  flat.resize(3);
+  EXPECT_TRUE(common::MeshDecomposition::ConvexHull(flat) == nullptr);
+}
+
+/////////////////////////////////////////////////
+TEST_F(MeshDecompositionTest, Generate)
+{
+  common::MeshManager *manager = common::MeshManager::Instance();
+  const common::Mesh *box = manager->GetMesh("unit_box");
+  ASSERT_TRUE(box != nullptr);
+
+  // A box is its own hull
+  std::unique_ptr<common::Mesh> hulls(
+      common::MeshDecomposition::Generate(*box));
+  ASSERT_TRUE(hulls != nullptr);
+  ASSERT_EQ(hulls->GetSubMeshCount(), 1u);
+  EXPECT_EQ(hulls->GetSubMesh(0)->GetVertexCount(), 8u);
+
+  // Two boxes apart are split
+  common::Mesh twoBoxes;
+  for (double x : {-2.0, 2.0})
+  {
+    common::SubMesh *subMesh = new common::SubMesh(box->GetSubMesh(0));
+    subMesh->Translate(ignition::math::Vector3d(x, 0, 0));
+    twoBoxes.AddSubMesh(subMesh);
+  }
+  hulls.reset(common::MeshDecomposition::Generate(twoBoxes));
+  ASSERT_TRUE(hulls != nullptr);
+  ASSERT_EQ(hulls->GetSubMeshCount(), 2u);
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    ignition::math::Vector3d size = hulls->GetSubMesh(i)->Max() -
+        hulls->GetSubMesh(i)->Min();
+    EXPECT_NEAR(size.X(), 1.0, 1e-6);
+  }
+
+  // Unless there is a single hull
+  hulls.reset(common::MeshDecomposition::Generate(twoBoxes, 1u));
+  ASSERT_TRUE(hulls != nullptr);
+  EXPECT_EQ(hulls->GetSubMeshCount(), 1u);
+  EXPECT_TRUE(common::MeshDecomposition::Generate(twoBoxes, 0u) == nullptr);
+
+  // The manager keeps the hulls by the mesh data
+  const common::Mesh *cached = manager->ConvexDecomposition(&twoBoxes);
+  ASSERT_TRUE(cached != nullptr);
+  EXPECT_EQ(cached->GetSubMeshCount(), 2u);
+  EXPECT_EQ(cached, manager->ConvexDecomposition(&twoBoxes));
+  EXPECT_NE(cached, manager->ConvexDecomposition(&twoBoxes, 1u));
+  EXPECT_TRUE(manager->ConvexDecomposition(nullptr) == nullptr);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,611 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshDistanceField.hh"
+
+using namespace gazebo;
+using namespace common;
+
+namespace
+{
+  /// \brief Identifies distance field files.
+  const char kDistanceFieldMagic[4] = {'G', 'Z', 'D', 'F'};
+
+  /// \brief Version of the file layout.
+  const uint32_t kDistanceFieldVersion = 1;
+
+  /// \brief Cells along the largest side of a mesh by default.
+  const double kDefaultCells = 64.0;
+
+  /// \brief Largest number of nodes, 8MB of distances.
+  const uint64_t kMaxNodes = 1u << 21;
+
+  /// \brief Triangle with scaled vertices.
+  typedef std::array<ignition::math::Vector3d, 3> Triangle;
+
+  /// \brief Distance of a point to a triangle, see Ericson, Real-Time
+  /// Collision Detection, 5.1.5.
+  /// \param[in] _p The point.
+  /// \param[in] _t The triangle.
+  /// \return The distance.
+  double TriangleDistance(const ignition::math::Vector3d &_p,
+      const Triangle &_t)
+  {
+    const ignition::math::Vector3d &a = _t[0];
+    const ignition::math::Vector3d &b = _t[1];
+    const ignition::math::Vector3d &c = _t[2];
+    const ignition::math::Vector3d ab = b - a;
+    const ignition::math::Vector3d ac = c - a;
+
+    const ignition::math::Vector3d ap = _p - a;
+    const double d1 = ab.Dot(ap);
+    const double d2 = ac.Dot(ap);
+    if (d1 <= 0 && d2 <= 0)
+      return ap.Length();
+
+    const ignition::math::Vector3d bp = _p - b;
+    const double d3 = ab.Dot(bp);
+    const double d4 = ac.Dot(bp);
+    if (d3 >= 0 && d4 <= d3)
+      return bp.Length();
+
+    const double vc = d1 * d4 - d3 * d2;
+    if (vc <= 0 && d1 >= 0 && d3 <= 0)
+      return (_p - (a + ab * (d1 / (d1 - d3)))).Length();
+
+    const ignition::math::Vector3d cp = _p - c;
+    const double d5 = ab.Dot(cp);
+    const double d6 = ac.Dot(cp);
+    if (d6 >= 0 && d5 <= d6)
+      return cp.Length();
+
+    const double vb = d5 * d2 - d1 * d6;
+    if (vb <= 0 && d2 >= 0 && d6 <= 0)
+      return (_p - (a + ac * (d2 / (d2 - d6)))).Length();
+
+    const double va = d3 * d6 - d5 * d4;
+    if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0)
+    {
+      const double w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+      return (_p - (b + (c - b) * w)).Length();
+    }
+
+    const double denom = 1.0 / (va + vb + vc);
+    return (_p - (a + ab * (vb * denom) + ac * (vc * denom))).Length();
+  }
+
+  /// \brief Orientation of the origin relative to a 2D edge, with a tie
+  /// breaking rule so that a point on an edge shared by two triangles is
+  /// inside exactly one of them.
+  /// \param[in] _x1 X of the first point.
+  /// \param[in] _y1 Y of the first point.
+  /// \param[in] _x2 X of the second point.
+  /// \param[in] _y2 Y of the second point.
+  /// \param[out] _area Twice the signed area of the origin and the edge.
+  /// \return 1 or -1 for each side, 0 if the points are the same.
+  int Orientation(const double _x1, const double _y1, const double _x2,
+      const double _y2, double &_area)
+  {
+    _area = _y1 * _x2 - _x1 * _y2;
+    if (_area > 0)
+      return 1;
+    if (_area < 0)
+      return -1;
+    if (_y2 > _y1)
+      return 1;
+    if (_y2 < _y1)
+      return -1;
+    if (_x1 > _x2)
+      return 1;
+    if (_x1 < _x2)
+      return -1;
+    return 0;
+  }
+
+  /// \brief Find whether a 2D point is inside a triangle.
+  /// \param[in] _x X of the point.
+  /// \param[in] _y Y of the point.
+  /// \param[in] _t Coordinates of the vertices.
+  /// \param[out] _w Barycentric coordinates of the point.
+  /// \return True if the point is inside.
+  bool InTriangle(const double _x, const double _y,
+      const std::array<double, 6> &_t, std::array<double, 3> &_w)
+  {
+    const double x1 = _t[0] - _x, y1 = _t[1] - _y;
+    const double x2 = _t[2] - _x, y2 = _t[3] - _y;
+    const double x3 = _t[4] - _x, y3 = _t[5] - _y;
+
+    const int sign = Orientation(x2, y2, x3, y3, _w[0]);
+    if (sign == 0 || Orientation(x3, y3, x1, y1, _w[1]) != sign ||
+        Orientation(x1, y1, x2, y2, _w[2]) != sign)
+    {
+      return false;
+    }
+
+    const double sum = _w[0] + _w[1] + _w[2];
+    if (sum == 0)
+      return false;
+    for (double &w : _w)
+      w /= sum;
+    return true;
+  }
+}
+
+/// \brief Private data for the MeshDistanceField class.
+class gazebo::common::MeshDistanceFieldPrivate
+{
+  /// \brief Get the index of a node.
+  /// \param[in] _i X index.
+  /// \param[in] _j Y index.
+  /// \param[in] _k Z index.
+  /// \return Index in distances.
+  public: size_t Index(const size_t _i, const size_t _j,
+              const size_t _k) const
+  {
+    return (_k * this->size[1] + _j) * this->size[0] + _i;
+  }
+
+  /// \brief Get the position of a node.
+  /// \param[in] _i X index.
+  /// \param[in] _j Y index.
+  /// \param[in] _k Z index.
+  /// \return The position.
+  public: ignition::math::Vector3d Node(const size_t _i, const size_t _j,
+              const size_t _k) const
+  {
+    return this->origin + ignition::math::Vector3d(static_cast<double>(_i),
+        static_cast<double>(_j), static_cast<double>(_k)) * this->cellSize;
+  }
+
+  /// \brief Update the distances of the nodes from the closest triangles
+  /// of their neighbors, in one of the eight sweep directions.
+  /// \param[in] _dir Direction along each axis, 1 or -1.
+  /// \param[in] _triangles The triangles.
+  /// \param[in,out] _closest Closest triangle of each node, -1 if unknown.
+  public: void Sweep(const std::array<int, 3> &_dir,
+              const std::vector<Triangle> &_triangles,
+              std::vector<int> &_closest)
+  {
+    const int n[3] = {static_cast<int>(this->size[0]),
+        static_cast<int>(this->size[1]), static_cast<int>(this->size[2])};
+    const int i0 = _dir[0] > 0 ? 1 : n[0] - 2;
+    const int i1 = _dir[0] > 0 ? n[0] : -1;
+    const int j0 = _dir[1] > 0 ? 1 : n[1] - 2;
+    const int j1 = _dir[1] > 0 ? n[1] : -1;
+    const int k0 = _dir[2] > 0 ? 1 : n[2] - 2;
+    const int k1 = _dir[2] > 0 ? n[2] : -1;
+
+    for (int k = k0; k != k1; k += _dir[2])
+    {
+      for (int j = j0; j != j1; j += _dir[1])
+      {
+        for (int i = i0; i != i1; i += _dir[0])
+        {
+          const size_t index = this->Index(i, j, k);
+          const ignition::math::Vector3d p = this->Node(i, j, k);
+
+          // The neighbors already visited by this sweep
+          for (int m = 1; m < 8; ++m)
+          {
+            const size_t neighbor = this->Index(i - (m & 1 ? _dir[0] : 0),
+                j - (m & 2 ? _dir[1] : 0), k - (m & 4 ? _dir[2] : 0));
+            const int t = _closest[neighbor];
+            if (t < 0 || t == _closest[index])
+              continue;
+
+            const double d = TriangleDistance(p, _triangles[t]);
+            if (d < this->distances[index])
+            {
+              this->distances[index] = static_cast<float>(d);
+              _closest[index] = t;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /// \brief Get the corner distances of the cell of a point, clamped to
+  /// the grid.
+  /// \param[in] _point The point.
+  /// \param[out] _corners Distances of the corners, x varying fastest.
+  /// \param[out] _fraction Position of the point in the cell.
+  /// \param[out] _outside Offset of the point from the grid.
+  public: void Cell(const ignition::math::Vector3d &_point,
+              std::array<double, 8> &_corners,
+              ignition::math::Vector3d &_fraction,
+              ignition::math::Vector3d &_outside) const
+  {
+    size_t index[3];
+    for (unsigned int a = 0; a < 3; ++a)
+    {
+      const double g = (_point[a] - this->origin[a]) / this->cellSize;
+      const double max = static_cast<double>(this->size[a] - 1);
+      const double clamped = std::min(std::max(g, 0.0), max);
+      _outside[a] = (g - clamped) * this->cellSize;
+      index[a] = std::min(static_cast<size_t>(std::floor(clamped)),
+          this->size[a] - 2);
+      _fraction[a] = clamped - static_cast<double>(index[a]);
+    }
+
+    for (unsigned int c = 0; c < 8; ++c)
+    {
+      _corners[c] = this->distances[this->Index(index[0] + (c & 1),
+          index[1] + ((c >> 1) & 1), index[2] + ((c >> 2) & 1))];
+    }
+  }
+
+  /// \brief Position of the first node.
+  public: ignition::math::Vector3d origin;
+
+  /// \brief Distance between the nodes.
+  public: double cellSize = 0;
+
+  /// \brief Number of nodes along each axis.
+  public: size_t size[3] = {0, 0, 0};
+
+  /// \brief Signed distances of the nodes, x varying fastest.
+  public: std::vector<float> distances;
+};
+
+//////////////////////////////////////////////////
+MeshDistanceField::MeshDistanceField()
+  : dataPtr(new MeshDistanceFieldPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+MeshDistanceField::~MeshDistanceField()
+{
+}
+
+//////////////////////////////////////////////////
+bool MeshDistanceField::Generate(const Mesh &_mesh,
+    const ignition::math::Vector3d &_scale, const double _cellSize)
+{
+  std::vector<Triangle> triangles;
+  ignition::math::Vector3d min(ignition::math::MAX_D, ignition::math::MAX_D,
+      ignition::math::MAX_D);
+  ignition::math::Vector3d max = -min;
+  for (unsigned int i = 0; i < _mesh.GetSubMeshCount(); ++i)
+  {
+    const SubMesh *subMesh = _mesh.GetSubMesh(i);
+    if (subMesh->GetPrimitiveType() != SubMesh::TRIANGLES)
+      continue;
+
+    for (unsigned int j = 0; j + 2 < subMesh->GetIndexCount(); j += 3)
+    {
+      Triangle t;
+      bool valid = true;
+      for (unsigned int v = 0; v < 3 && valid; ++v)
+      {
+        const unsigned int index = subMesh->GetIndex(j + v);
+        valid = index < subMesh->GetVertexCount();
+        if (valid)
+          t[v] = subMesh->Vertex(index) * _scale;
+      }
+      if (!valid)
+        continue;
+
+      for (auto const &v : t)
+      {
+        min.Min(v);
+        max.Max(v);
+      }
+      triangles.push_back(t);
+    }
+  }
+
+  const ignition::math::Vector3d extent = max - min;
+  const double largest = triangles.empty() ? 0.0 : extent.Max();
+  if (largest <= 0)
+    return false;
+
+  double cellSize = _cellSize > 0 ? _cellSize : largest / kDefaultCells;
+  size_t size[3];
+  double padding = 0;
+  while (true)
+  {
+    // Two cells around the mesh keep the gradient valid at its surface
+    padding = 2 * cellSize;
+    uint64_t nodes = 1;
+    for (unsigned int a = 0; a < 3; ++a)
+    {
+      size[a] = static_cast<size_t>(
+          std::ceil((extent[a] + 2 * padding) / cellSize)) + 1;
+      nodes *= size[a];
+    }
+    if (nodes <= kMaxNodes)
+      break;
+    cellSize *= 1.25;
+  }
+
+  if (_cellSize > 0 && cellSize > _cellSize)
+  {
+    gzwarn << "Distance field of mesh [" << _mesh.GetName() << "] uses "
+           << cellSize << "m cells instead of " << _cellSize << "m\n";
+  }
+
+  MeshDistanceFieldPrivate &d = *this->dataPtr;
+  d.origin = min - ignition::math::Vector3d(padding, padding, padding);
+  d.cellSize = cellSize;
+  std::copy(size, size + 3, d.size);
+  d.distances.assign(size[0] * size[1] * size[2],
+      std::numeric_limits<float>::max());
+  std::vector<int> closest(d.distances.size(), -1);
+
+  // Exact distances one cell around each triangle
+  for (size_t t = 0; t < triangles.size(); ++t)
+  {
+    size_t lo[3], hi[3];
+    for (unsigned int a = 0; a < 3; ++a)
+    {
+      double tmin = triangles[t][0][a], tmax = tmin;
+      for (auto const &v : triangles[t])
+      {
+        tmin = std::min(tmin, v[a]);
+        tmax = std::max(tmax, v[a]);
+      }
+      const double last = static_cast<double>(size[a] - 1);
+      lo[a] = static_cast<size_t>(std::min(std::max(
+          std::floor((tmin - d.origin[a]) / cellSize) - 1, 0.0), last));
+      hi[a] = static_cast<size_t>(std::min(std::max(
+          std::ceil((tmax - d.origin[a]) / cellSize) + 1, 0.0), last));
+    }
+
+    for (size_t k = lo[2]; k <= hi[2]; ++k)
+    {
+      for (size_t j = lo[1]; j <= hi[1]; ++j)
+      {
+        for (size_t i = lo[0]; i <= hi[0]; ++i)
+        {
+          const size_t index = d.Index(i, j, k);
+          const double dist = TriangleDistance(d.Node(i, j, k), triangles[t]);
+          if (dist < d.distances[index])
+          {
+            d.distances[index] = static_cast<float>(dist);
+            closest[index] = static_cast<int>(t);
+          }
+        }
+      }
+    }
+  }
+
+  // Propagate the closest triangles to the other nodes
+  const std::array<std::array<int, 3>, 8> directions = {{
+      {{1, 1, 1}}, {{-1, -1, -1}}, {{1, 1, -1}}, {{-1, -1, 1}},
+      {{1, -1, 1}}, {{-1, 1, -1}}, {{1, -1, -1}}, {{-1, 1, 1}}}};
+  for (unsigned int pass = 0; pass < 2; ++pass)
+  {
+    for (auto const &dir : directions)
+      d.Sweep(dir, triangles, closest);
+  }
+
+  // Count the triangles crossed by the grid lines along x, a node is
+  // inside if an odd number of them lies before it.
+  std::vector<int> crossings(d.distances.size(), 0);
+  for (auto const &t : triangles)
+  {
+    std::array<double, 6> yz;
+    double x[3];
+    for (unsigned int v = 0; v < 3; ++v)
+    {
+      const ignition::math::Vector3d g = (t[v] - d.origin) / cellSize;
+      x[v] = g.X();
+      yz[2 * v] = g.Y();
+      yz[2 * v + 1] = g.Z();
+    }
+
+    const int j0 = std::max(0, static_cast<int>(std::ceil(
+        std::min(yz[0], std::min(yz[2], yz[4])))));
+    const int j1 = std::min(static_cast<int>(size[1]) - 1, static_cast<int>(
+        std::floor(std::max(yz[0], std::max(yz[2], yz[4])))));
+    const int k0 = std::max(0, static_cast<int>(std::ceil(
+        std::min(yz[1], std::min(yz[3], yz[5])))));
+    const int k1 = std::min(static_cast<int>(size[2]) - 1, static_cast<int>(
+        std::floor(std::max(yz[1], std::max(yz[3], yz[5])))));
+
+    for (int k = k0; k <= k1; ++k)
+    {
+      for (int j = j0; j <= j1; ++j)
+      {
+        std::array<double, 3> w;
+        if (!InTriangle(j, k, yz, w))
+          continue;
+
+        const int i = static_cast<int>(std::ceil(
+            w[0] * x[0] + w[1] * x[1] + w[2] * x[2]));
+        if (i < static_cast<int>(size[0]))
+          ++crossings[d.Index(std::max(i, 0), j, k)];
+      }
+    }
+  }
+
+  for (size_t k = 0; k < size[2]; ++k)
+  {
+    for (size_t j = 0; j < size[1]; ++j)
+    {
+      int count = 0;
+      for (size_t i = 0; i < size[0]; ++i)
+      {
+        const size_t index = d.Index(i, j, k);
+        count += crossings[index];
+        if (count % 2 == 1)
+          d.distances[index] = -d.distances[index];
+      }
+    }
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+double MeshDistanceField::Distance(const ignition::math::Vector3d &_point)
+    const
+{
+  if (this->Empty())
+    return 0.0;
+
+  std::array<double, 8> c;
+  ignition::math::Vector3d f, outside;
+  this->dataPtr->Cell(_point, c, f, outside);
+
+  const double x00 = c[0] + (c[1] - c[0]) * f.X();
+  const double x10 = c[2] + (c[3] - c[2]) * f.X();
+  const double x01 = c[4] + (c[5] - c[4]) * f.X();
+  const double x11 = c[6] + (c[7] - c[6]) * f.X();
+  const double y0 = x00 + (x10 - x00) * f.Y();
+  const double y1 = x01 + (x11 - x01) * f.Y();
+  return y0 + (y1 - y0) * f.Z() + outside.Length();
+}
+
+//////////////////////////////////////////////////
+ignition::math::Vector3d MeshDistanceField::Gradient(
+    const ignition::math::Vector3d &_point) const
+{
+  if (this->Empty())
+    return ignition::math::Vector3d::Zero;
+
+  std::array<double, 8> c;
+  ignition::math::Vector3d f, outside;
+  this->dataPtr->Cell(_point, c, f, outside);
+
+  // Derivatives of the trilinear interpolation
+  const double fx = f.X(), fy = f.Y(), fz = f.Z();
+  ignition::math::Vector3d gradient(
+      (1 - fy) * (1 - fz) * (c[1] - c[0]) + fy * (1 - fz) * (c[3] - c[2]) +
+      (1 - fy) * fz * (c[5] - c[4]) + fy * fz * (c[7] - c[6]),
+      (1 - fx) * (1 - fz) * (c[2] - c[0]) + fx * (1 - fz) * (c[3] - c[1]) +
+      (1 - fx) * fz * (c[6] - c[4]) + fx * fz * (c[7] - c[5]),
+      (1 - fx) * (1 - fy) * (c[4] - c[0]) + fx * (1 - fy) * (c[5] - c[1]) +
+      (1 - fx) * fy * (c[6] - c[2]) + fx * fy * (c[7] - c[3]));
+  gradient /= this->dataPtr->cellSize;
+
+  // Outside the grid, the distance grows along the offset from the grid
+  const double offset = outside.Length();
+  if (offset > 0)
+  {
+    for (unsigned int a = 0; a < 3; ++a)
+    {
+      if (!ignition::math::equal(outside[a], 0.0))
+        gradient[a] = outside[a] / offset;
+    }
+  }
+
+  const double length = gradient.Length();
+  return length > 0 ? gradient / length : ignition::math::Vector3d::UnitZ;
+}
+
+//////////////////////////////////////////////////
+ignition::math::AxisAlignedBox MeshDistanceField::Box() const
+{
+  if (this->Empty())
+    return ignition::math::AxisAlignedBox();
+
+  const MeshDistanceFieldPrivate &d = *this->dataPtr;
+  return ignition::math::AxisAlignedBox(d.origin,
+      d.Node(d.size[0] - 1, d.size[1] - 1, d.size[2] - 1));
+}
+
+//////////////////////////////////////////////////
+double MeshDistanceField::CellSize() const
+{
+  return this->dataPtr->cellSize;
+}
+
+//////////////////////////////////////////////////
+bool MeshDistanceField::Empty() const
+{
+  return this->dataPtr->distances.empty();
+}
+
+//////////////////////////////////////////////////
+bool MeshDistanceField::Save(const std::string &_filename) const
+{
+  if (this->Empty())
+    return false;
+
+  std::ofstream file(_filename, std::ios::binary | std::ios::trunc);
+  if (!file)
+  {
+    gzwarn << "Unable to write distance field [" << _filename << "]\n";
+    return false;
+  }
+
+  const MeshDistanceFieldPrivate &d = *this->dataPtr;
+  const double header[4] = {d.origin.X(), d.origin.Y(), d.origin.Z(),
+      d.cellSize};
+  const uint32_t size[3] = {static_cast<uint32_t>(d.size[0]),
+      static_cast<uint32_t>(d.size[1]), static_cast<uint32_t>(d.size[2])};
+
+  file.write(kDistanceFieldMagic, sizeof(kDistanceFieldMagic));
+  file.write(reinterpret_cast<const char *>(&kDistanceFieldVersion),
+      sizeof(kDistanceFieldVersion));
+  file.write(reinterpret_cast<const char *>(header), sizeof(header));
+  file.write(reinterpret_cast<const char *>(size), sizeof(size));
+  file.write(reinterpret_cast<const char *>(d.distances.data()),
+      d.distances.size() * sizeof(d.distances[0]));
+  return static_cast<bool>(file);
+}
+
+//////////////////////////////////////////////////
+bool MeshDistanceField::Load(const std::string &_filename)
+{
+  std::ifstream file(_filename, std::ios::binary);
+  if (!file)
+    return false;
+
+  char magic[sizeof(kDistanceFieldMagic)];
+  uint32_t version = 0;
+  double header[4];
+  uint32_t size[3];
+  file.read(magic, sizeof(magic));
+  file.read(reinterpret_cast<char *>(&version), sizeof(version));
+  file.read(reinterpret_cast<char *>(header), sizeof(header));
+  file.read(reinterpret_cast<char *>(size), sizeof(size));
+  if (!file || std::memcmp(magic, kDistanceFieldMagic, sizeof(magic)) != 0 ||
+      version != kDistanceFieldVersion || !(header[3] > 0) ||
+      size[0] < 2 || size[1] < 2 || size[2] < 2 ||
+      static_cast<uint64_t>(size[0]) * size[1] * size[2] > kMaxNodes)
+  {
+    return false;
+  }
+
+  std::vector<float> distances(
+      static_cast<size_t>(size[0]) * size[1] * size[2]);
+  file.read(reinterpret_cast<char *>(distances.data()),
+      distances.size() * sizeof(distances[0]));
+  if (!file)
+    return false;
+
+  MeshDistanceFieldPrivate &d = *this->dataPtr;
+  d.origin.Set(header[0], header[1], header[2]);
+  d.cellSize = header[3];
+  std::copy(size, size + 3, d.size);
+  d.distances.swap(distances);
+  return true;
+}
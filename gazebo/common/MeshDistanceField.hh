@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_MESHDISTANCEFIELD_HH_
+#define GAZEBO_COMMON_MESHDISTANCEFIELD_HH_
+
+#include <memory>
+#include <string>
+
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    class Mesh;
+    class MeshDistanceFieldPrivate;
+
+    /// \addtogroup gazebo_common Common
+    /// \{
+
+    /// \class MeshDistanceField MeshDistanceField.hh common/common.hh
+    /// \brief Signed distance to the surface of a mesh, sampled on a
+    /// regular grid around the mesh, negative inside. Distances between
+    /// the nodes are interpolated trilinearly, so a query costs the same
+    /// whatever the number of triangles.
+    ///
+    /// The distances near the triangles are exact, the others are
+    /// propagated from the neighbor nodes. The sign comes from the parity
+    /// of the triangles crossed along the x axis, so the mesh should be
+    /// closed. The inside of an open mesh is the side its triangles face
+    /// away from, e.g. below a floor.
+    class GZ_COMMON_VISIBLE MeshDistanceField
+    {
+      /// \brief Constructor, the field is empty.
+      public: MeshDistanceField();
+
+      /// \brief Destructor.
+      public: ~MeshDistanceField();
+
+      /// \brief Sample the distance to a mesh.
+      /// \param[in] _mesh The mesh, whose triangle lists are sampled.
+      /// \param[in] _scale Scaling factor of the vertices.
+      /// \param[in] _cellSize Distance between the nodes. The cells are
+      /// enlarged for meshes that would need too many of them. Zero to
+      /// fit 64 cells along the largest side of the mesh.
+      /// \return False if the mesh has no triangles.
+      public: bool Generate(const Mesh &_mesh,
+                  const ignition::math::Vector3d &_scale =
+                  ignition::math::Vector3d::One,
+                  const double _cellSize = 0.0);
+
+      /// \brief Get the signed distance of a point to the mesh. Points
+      /// outside the grid add their distance to the grid.
+      /// \param[in] _point The point, in the frame of the mesh.
+      /// \return The distance, negative inside the mesh. Zero if the
+      /// field is empty.
+      public: double Distance(const ignition::math::Vector3d &_point) const;
+
+      /// \brief Get the gradient of the distance, which points away from
+      /// the surface.
+      /// \param[in] _point The point, in the frame of the mesh.
+      /// \return The unit gradient, zero if the field is empty.
+      public: ignition::math::Vector3d Gradient(
+                  const ignition::math::Vector3d &_point) const;
+
+      /// \brief Get the box covered by the grid.
+      /// \return The box, with no volume if the field is empty.
+      public: ignition::math::AxisAlignedBox Box() const;
+
+      /// \brief Get the distance between the nodes.
+      /// \return The size of a cell, zero if the field is empty.
+      public: double CellSize() const;
+
+      /// \brief Get whether the field has been generated or loaded.
+      /// \return True if the field is empty.
+      public: bool Empty() const;
+
+      /// \brief Write the field to a file.
+      /// \param[in] _filename Path of the file.
+      /// \return False if the field is empty, or the file can't be
+      /// written.
+      public: bool Save(const std::string &_filename) const;
+
+      /// \brief Read a field written by Save.
+      /// \param[in] _filename Path of the file.
+      /// \return False if the file doesn't exist or isn't a valid field,
+      /// in which case the field is left unchanged.
+      public: bool Load(const std::string &_filename);
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<MeshDistanceFieldPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
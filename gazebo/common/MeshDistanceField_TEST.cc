@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshDistanceField.hh"
+#include "gazebo/common/MeshManager.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class MeshDistanceFieldTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(MeshDistanceFieldTest, Generate)
+{
+  common::MeshManager *manager = common::MeshManager::Instance();
+  const common::Mesh *box = manager->GetMesh("unit_box");
+  ASSERT_TRUE(box != nullptr);
+
+  common::MeshDistanceField field;
+  EXPECT_TRUE(field.Empty());
+  EXPECT_DOUBLE_EQ(field.Distance(ignition::math::Vector3d::Zero), 0.0);
+  EXPECT_FALSE(field.Generate(common::Mesh()));
+
+  ASSERT_TRUE(field.Generate(*box, ignition::math::Vector3d::One, 0.05));
+  EXPECT_FALSE(field.Empty());
+  EXPECT_DOUBLE_EQ(field.CellSize(), 0.05);
+
+  // The grid covers the box with a margin
+  EXPECT_LT(field.Box().Max().X(), 0.7);
+  EXPECT_GT(field.Box().Max().X(), 0.5);
+
+  // Negative inside, positive outside, the gradient points away from the
+  // closest face.
+  EXPECT_NEAR(field.Distance(ignition::math::Vector3d(0.3, 0, 0)), -0.2, 1e-3);
+  EXPECT_NEAR(field.Distance(ignition::math::Vector3d(0, 0, -0.45)), -0.05,
+      1e-3);
+  EXPECT_NEAR(field.Distance(ignition::math::Vector3d(0.6, 0, 0)), 0.1, 1e-3);
+  EXPECT_NEAR(field.Distance(ignition::math::Vector3d(0.7, 0.7, 0)),
+      0.2 * std::sqrt(2.0), 1e-3);
+  EXPECT_EQ(field.Gradient(ignition::math::Vector3d(0.3, 0, 0)),
+      ignition::math::Vector3d::UnitX);
+  EXPECT_EQ(field.Gradient(ignition::math::Vector3d(0.1, 0.1, 0.49)),
+      ignition::math::Vector3d::UnitZ);
+
+  // Points outside the grid add their distance to it
+  EXPECT_NEAR(field.Distance(ignition::math::Vector3d(3, 0, 0)), 2.5, 1e-3);
+  EXPECT_EQ(field.Gradient(ignition::math::Vector3d(3, 0, 0)),
+      ignition::math::Vector3d::UnitX);
+
+  // Scaled vertices
+  ASSERT_TRUE(field.Generate(*box, ignition::math::Vector3d(4, 4, 1)));
+  EXPECT_NEAR(field.Distance(ignition::math::Vector3d(1.5, 0, 0)), -0.5,
+      field.CellSize());
+  EXPECT_NEAR(field.Distance(ignition::math::Vector3d(0, 0, 1)), 0.5,
+      field.CellSize());
+}
+
+/////////////////////////////////////////////////
+TEST_F(MeshDistanceFieldTest, SaveLoad)
+{
+  common::MeshManager *manager = common::MeshManager::Instance();
+  const common::Mesh *box = manager->GetMesh("unit_box");
+  ASSERT_TRUE(box != nullptr);
+
+  namespace fs = boost::filesystem;
+  const std::string filename = (fs::temp_directory_path() /
+      fs::unique_path("gazebo-MeshDistanceField-%%%%-%%%%")).string();
+
+  common::MeshDistanceField field;
+  EXPECT_FALSE(field.Save(filename));
+  EXPECT_FALSE(field.Load(filename));
+  ASSERT_TRUE(field.Generate(*box));
+  ASSERT_TRUE(field.Save(filename));
+
+  common::MeshDistanceField loaded;
+  ASSERT_TRUE(loaded.Load(filename));
+  EXPECT_DOUBLE_EQ(loaded.CellSize(), field.CellSize());
+  for (double x = -1; x <= 1; x += 0.1)
+  {
+    const ignition::math::Vector3d p(x, 0.5 * x, 0.2);
+    EXPECT_DOUBLE_EQ(loaded.Distance(p), field.Distance(p));
+  }
+  fs::remove(filename);
+
+  // The manager keeps the fields by the mesh data
+  const common::MeshDistanceField *cached = manager->DistanceField(box);
+  ASSERT_TRUE(cached != nullptr);
+  EXPECT_EQ(cached, manager->DistanceField(box));
+  EXPECT_NE(cached, manager->DistanceField(box,
+        ignition::math::Vector3d(2, 2, 2)));
+  EXPECT_TRUE(manager->DistanceField(nullptr) == nullptr);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshLod.hh"
+
+using namespace gazebo;
+using namespace common;
+
+namespace
+{
+  /// \brief Grid resolutions of the generated levels.
+  const std::array<unsigned int, 3> kResolutions = {{64u, 32u, 16u}};
+
+  /// \brief Cluster of vertices in a grid cell.
+  struct Cluster
+  {
+    /// \brief Sum of the vertex positions.
+    ignition::math::Vector3d sum;
+
+    /// \brief Number of vertices.
+    unsigned int count = 0;
+
+    /// \brief Vertex closest to the center.
+    unsigned int vertex = 0;
+
+    /// \brief Squared distance of vertex to the center.
+    double distance = -1.0;
+  };
+
+  /// \brief Get the cell of a position, packed in 21 bits per axis.
+  /// \param[in] _pos The position.
+  /// \param[in] _origin Origin of the grid.
+  /// \param[in] _cellSize Size of the cells.
+  /// \return Key of the cell.
+  uint64_t CellKey(const ignition::math::Vector3d &_pos,
+      const ignition::math::Vector3d &_origin, const double _cellSize)
+  {
+    const uint64_t mask = (1u << 21) - 1u;
+    ignition::math::Vector3d cell = (_pos - _origin) / _cellSize;
+    uint64_t x = static_cast<uint64_t>(std::max(std::floor(cell.X()), 0.0));
+    uint64_t y = static_cast<uint64_t>(std::max(std::floor(cell.Y()), 0.0));
+    uint64_t z = static_cast<uint64_t>(std::max(std::floor(cell.Z()), 0.0));
+    return ((x & mask) << 42) | ((y & mask) << 21) | (z & mask);
+  }
+}
+
+//////////////////////////////////////////////////
+std::vector<unsigned int> MeshLod::Simplify(const SubMesh &_subMesh,
+    const ignition::math::Vector3d &_origin, const double _cellSize)
+{
+  std::vector<unsigned int> result;
+  if (_cellSize <= 0.0 ||
+      _subMesh.GetPrimitiveType() != SubMesh::TRIANGLES)
+  {
+    return result;
+  }
+
+  const unsigned int vertexCount = _subMesh.GetVertexCount();
+  std::vector<uint64_t> keys(vertexCount);
+  std::unordered_map<uint64_t, Cluster> clusters;
+
+  for (unsigned int i = 0; i < vertexCount; ++i)
+  {
+    ignition::math::Vector3d pos = _subMesh.Vertex(i);
+    keys[i] = CellKey(pos, _origin, _cellSize);
+    Cluster &cluster = clusters[keys[i]];
+    cluster.sum += pos;
+    cluster.count++;
+  }
+
+  // Keep the vertex closest to the center of each cluster
+  for (unsigned int i = 0; i < vertexCount; ++i)
+  {
+    Cluster &cluster = clusters[keys[i]];
+    double distance =
+        (_subMesh.Vertex(i) - cluster.sum / cluster.count).SquaredLength();
+    if (cluster.distance < 0 || distance < cluster.distance)
+    {
+      cluster.vertex = i;
+      cluster.distance = distance;
+    }
+  }
+
+  std::set<std::array<unsigned int, 3>> triangles;
+  const unsigned int indexCount = _subMesh.GetIndexCount() / 3 * 3;
+  for (unsigned int i = 0; i < indexCount; i += 3)
+  {
+    std::array<unsigned int, 3> tri;
+    bool valid = true;
+    for (unsigned int j = 0; j < 3 && valid; ++j)
+    {
+      unsigned int index = _subMesh.GetIndex(i + j);
+      valid = index < vertexCount;
+      if (valid)
+        tri[j] = clusters[keys[index]].vertex;
+    }
+
+    if (!valid || tri[0] == tri[1] || tri[1] == tri[2] || tri[0] == tri[2])
+      continue;
+
+    // Drop duplicates, keeping the winding of the triangle
+    std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end()),
+        tri.end());
+    if (triangles.insert(tri).second)
+      result.insert(result.end(), tri.begin(), tri.end());
+  }
+
+  return result;
+}
+
+//////////////////////////////////////////////////
+std::vector<MeshLodLevel> MeshLod::Generate(const Mesh &_mesh,
+    const unsigned int _minTriangles)
+{
+  std::vector<MeshLodLevel> levels;
+  if (_mesh.HasSkeleton())
+    return levels;
+
+  unsigned int triangleCount = 0;
+  for (unsigned int i = 0; i < _mesh.GetSubMeshCount(); ++i)
+  {
+    const SubMesh *subMesh = _mesh.GetSubMesh(i);
+    if (subMesh->GetPrimitiveType() == SubMesh::TRIANGLES)
+      triangleCount += subMesh->GetIndexCount() / 3;
+  }
+  if (triangleCount < _minTriangles)
+    return levels;
+
+  // One grid for the whole mesh, so that the submeshes stay joined
+  ignition::math::Vector3d min = _mesh.Min();
+  ignition::math::Vector3d size = _mesh.Max() - min;
+  double extent = std::max(size.X(), std::max(size.Y(), size.Z()));
+  if (!std::isfinite(extent) || extent <= 0.0)
+    return levels;
+
+  unsigned int previous = triangleCount;
+  for (auto resolution : kResolutions)
+  {
+    MeshLodLevel level;
+    level.resolution = resolution;
+    double cellSize = extent / resolution;
+
+    for (unsigned int i = 0; i < _mesh.GetSubMeshCount(); ++i)
+    {
+      const SubMesh *subMesh = _mesh.GetSubMesh(i);
+      if (subMesh->GetPrimitiveType() == SubMesh::TRIANGLES)
+      {
+        level.indices.push_back(Simplify(*subMesh, min, cellSize));
+        level.triangleCount += level.indices.back().size() / 3;
+      }
+      else
+      {
+        std::vector<unsigned int> indices(subMesh->GetIndexCount());
+        for (unsigned int j = 0; j < indices.size(); ++j)
+          indices[j] = subMesh->GetIndex(j);
+        level.indices.push_back(indices);
+      }
+    }
+
+    if (level.triangleCount == 0 || level.triangleCount * 5 > previous * 4)
+      continue;
+
+    previous = level.triangleCount;
+    levels.push_back(level);
+  }
+
+  return levels;
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_MESHLOD_HH_
+#define GAZEBO_COMMON_MESHLOD_HH_
+
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    class Mesh;
+    class SubMesh;
+
+    /// \addtogroup gazebo_common Common
+    /// \{
+
+    /// \class MeshLodLevel MeshLod.hh common/common.hh
+    /// \brief A simplified level of detail of a mesh. The level only holds
+    /// indices, which refer to the vertices of the full resolution
+    /// submeshes, so all levels share the same vertex data.
+    class GZ_COMMON_VISIBLE MeshLodLevel
+    {
+      /// \brief Number of grid cells along the largest dimension of the
+      /// mesh the level was simplified to. Details smaller than a cell
+      /// are removed, so the level looks the same as the full mesh while
+      /// the mesh covers less than about two pixels per cell.
+      public: unsigned int resolution = 0;
+
+      /// \brief Number of triangles of the level.
+      public: unsigned int triangleCount = 0;
+
+      /// \brief Indices of each submesh, in the order of the submeshes of
+      /// the mesh. Submeshes which aren't triangle lists keep their
+      /// indices.
+      public: std::vector<std::vector<unsigned int>> indices;
+    };
+
+    /// \class MeshLod MeshLod.hh common/common.hh
+    /// \brief Generates levels of detail of meshes by vertex clustering.
+    /// The vertices of each cell of a grid are merged into the vertex
+    /// closest to their center, and the triangles which collapse are
+    /// dropped.
+    class GZ_COMMON_VISIBLE MeshLod
+    {
+      /// \brief Simplify the triangles of a submesh.
+      /// \param[in] _subMesh The submesh, with a triangle list.
+      /// \param[in] _origin Origin of the grid.
+      /// \param[in] _cellSize Size of the grid cells.
+      /// \return Indices of the remaining triangles, which refer to the
+      /// vertices of _subMesh. Empty if _cellSize is not positive or the
+      /// submesh isn't a triangle list.
+      public: static std::vector<unsigned int> Simplify(
+                  const SubMesh &_subMesh,
+                  const ignition::math::Vector3d &_origin,
+                  const double _cellSize);
+
+      /// \brief Generate the levels of detail of a mesh. Meshes with a
+      /// skeleton or with less than _minTriangles triangles have none, and
+      /// levels which don't remove at least a fifth of the triangles of
+      /// the previous level are skipped.
+      /// \param[in] _mesh The mesh.
+      /// \param[in] _minTriangles Number of triangles under which a mesh
+      /// is drawn at full resolution.
+      /// \return The levels, from the most to the least detailed.
+      public: static std::vector<MeshLodLevel> Generate(const Mesh &_mesh,
+                  const unsigned int _minTriangles = 5000u);
+    };
+    /// \}
+  }
+}
+#endif
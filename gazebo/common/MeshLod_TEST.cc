@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshLod.hh"
+#include "gazebo/common/MeshManager.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class MeshLodTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(MeshLodTest, Simplify)
+{
+  // Two triangles of a unit square
+  common::SubMesh subMesh;
+  subMesh.SetPrimitiveType(common::SubMesh::TRIANGLES);
+  subMesh.AddVertex(0, 0, 0);
+  subMesh.AddVertex(1, 0, 0);
+  subMesh.AddVertex(1, 1, 0);
+  subMesh.AddVertex(0, 1, 0);
+  for (auto index : {0u, 1u, 2u, 0u, 2u, 3u})
+    subMesh.AddIndex(index);
+
+  // Small cells keep both triangles, with their winding
+  std::vector<unsigned int> indices = common::MeshLod::Simplify(subMesh,
+      ignition::math::Vector3d::Zero, 0.1);
+  ASSERT_EQ(indices.size(), 6u);
+  EXPECT_EQ(indices[0], 0u);
+  EXPECT_EQ(indices[1], 1u);
+  EXPECT_EQ(indices[2], 2u);
+
+  // One cell collapses everything
+  indices = common::MeshLod::Simplify(subMesh,
+      ignition::math::Vector3d::Zero, 10.0);
+  EXPECT_TRUE(indices.empty());
+
+  // Invalid cell size and primitive type
+  EXPECT_TRUE(common::MeshLod::Simplify(subMesh,
+      ignition::math::Vector3d::Zero, 0.0).empty());
+  subMesh.SetPrimitiveType(common::SubMesh::LINES);
+  EXPECT_TRUE(common::MeshLod::Simplify(subMesh,
+      ignition::math::Vector3d::Zero, 0.1).empty());
+}
+
+/////////////////////////////////////////////////
+TEST_F(MeshLodTest, Generate)
+{
+  common::MeshManager *manager = common::MeshManager::Instance();
+
+  // Small meshes are drawn at full resolution
+  const common::Mesh *box = manager->GetMesh("unit_box");
+  ASSERT_TRUE(box != nullptr);
+  EXPECT_TRUE(common::MeshLod::Generate(*box).empty());
+  EXPECT_TRUE(manager->MeshLods(box).empty());
+
+  manager->CreateSphere("lod_sphere", 1.0, 128, 128);
+  const common::Mesh *sphere = manager->GetMesh("lod_sphere");
+  ASSERT_TRUE(sphere != nullptr);
+  ASSERT_EQ(sphere->GetSubMeshCount(), 1u);
+  const common::SubMesh *subMesh = sphere->GetSubMesh(0);
+  unsigned int triangles = subMesh->GetIndexCount() / 3;
+  ASSERT_GT(triangles, 5000u);
+
+  std::vector<common::MeshLodLevel> levels = manager->MeshLods(sphere);
+  ASSERT_FALSE(levels.empty());
+
+  unsigned int previous = triangles;
+  unsigned int resolution = 1000;
+  for (auto const &level : levels)
+  {
+    EXPECT_LT(level.resolution, resolution);
+    resolution = level.resolution;
+
+    // Each level removes triangles, and refers to the full mesh vertices
+    EXPECT_LT(level.triangleCount, previous);
+    previous = level.triangleCount;
+    ASSERT_EQ(level.indices.size(), 1u);
+    EXPECT_EQ(level.indices[0].size(), level.triangleCount * 3);
+    for (auto index : level.indices[0])
+      EXPECT_LT(index, subMesh->GetVertexCount());
+  }
+
+  // The levels are kept with the mesh
+  std::vector<common::MeshLodLevel> cached = manager->MeshLods(sphere);
+  ASSERT_EQ(cached.size(), levels.size());
+  EXPECT_EQ(cached[0].indices, levels[0].indices);
+  EXPECT_TRUE(manager->MeshLods(nullptr).empty());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -16,17 +16,32 @@
  */
 
 #include <sys/stat.h>
+#include <algorithm>
+#include <atomic>
+#include <set>
 #include <string>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <boost/filesystem.hpp>
 
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Console.hh"
+#include "gazebo/common/MemoryTracker.hh"
 #include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshCache.hh"
+#include "gazebo/common/MeshDecomposition.hh"
+#include "gazebo/common/MeshDistanceField.hh"
+#include "gazebo/common/MeshRayTree.hh"
 #include "gazebo/common/ColladaLoader.hh"
 #include "gazebo/common/ColladaExporter.hh"
 #include "gazebo/common/STLLoader.hh"
 #include "gazebo/common/OBJLoader.hh"
+#include "gazebo/common/SystemPaths.hh"
 #include "gazebo/gazebo_config.h"
 
 #ifdef HAVE_GTS
@@ -40,6 +55,70 @@ namespace gazebo
 {
 namespace common
 {
+/// \brief Append a value to the inputs of a generated mesh.
+/// \param[in,out] _key The inputs.
+/// \param[in] _value The value.
+template<typename T>
+static void PutKey(std::string &_key, const T &_value)
+{
+  _key.append(reinterpret_cast<const char *>(&_value), sizeof(_value));
+}
+
+//////////////////////////////////////////////////
+/// \brief Append the geometry of a mesh to the inputs of a generated mesh.
+/// \param[in,out] _key The inputs.
+/// \param[in] _mesh The mesh.
+static void PutKey(std::string &_key, const Mesh &_mesh)
+{
+  PutKey(_key, _mesh.GetSubMeshCount());
+  for (unsigned int i = 0; i < _mesh.GetSubMeshCount(); ++i)
+  {
+    const SubMesh *subMesh = _mesh.GetSubMesh(i);
+    PutKey(_key, subMesh->GetVertexCount());
+    for (unsigned int j = 0; j < subMesh->GetVertexCount(); ++j)
+    {
+      const ignition::math::Vector3d &v = subMesh->Vertex(j);
+      PutKey(_key, v.X());
+      PutKey(_key, v.Y());
+      PutKey(_key, v.Z());
+    }
+    PutKey(_key, subMesh->GetIndexCount());
+    for (unsigned int j = 0; j < subMesh->GetIndexCount(); ++j)
+      PutKey(_key, subMesh->GetIndex(j));
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Estimate the memory held by the geometry of a mesh.
+/// \param[in] _mesh The mesh.
+/// \return Bytes of its vertices, normals, texture coordinates and
+/// indices.
+static int64_t MeshBytes(const Mesh &_mesh)
+{
+  return static_cast<int64_t>(_mesh.GetVertexCount()) *
+      sizeof(ignition::math::Vector3d) +
+      static_cast<int64_t>(_mesh.GetNormalCount()) *
+      sizeof(ignition::math::Vector3d) +
+      static_cast<int64_t>(_mesh.GetTexCoordCount()) *
+      sizeof(ignition::math::Vector2d) +
+      static_cast<int64_t>(_mesh.GetIndexCount()) * sizeof(unsigned int);
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the memory held by the levels of detail of a mesh.
+/// \param[in] _lods The levels.
+/// \return Bytes of their indices.
+static int64_t LodBytes(const std::vector<MeshLodLevel> &_lods)
+{
+  int64_t bytes = 0;
+  for (auto const &lod : _lods)
+  {
+    for (auto const &indices : lod.indices)
+      bytes += indices.size() * sizeof(unsigned int);
+  }
+  return bytes;
+}
+
 //////////////////////////////////////////////////
 class MeshManagerPrivate
 {
@@ -65,6 +144,259 @@ class MeshManagerPrivate
   /// \brief Mutex to protect from loading the same mesh in different threads
   /// at the same time.
   public: boost::mutex mutex;
+
+  /// \brief Directory of the mesh cache, empty if it's disabled.
+  public: std::string cacheDir;
+
+  /// \brief Levels of detail of the meshes, indexed by mesh name.
+  public: std::map<std::string, std::vector<MeshLodLevel>> lods;
+
+  /// \brief Protects lods.
+  public: std::mutex lodsMutex;
+
+  /// \brief Protects meshes, which are loaded from several threads.
+  public: std::mutex meshesMutex;
+
+  /// \brief Meshes generated by boolean operations and extrusions,
+  /// indexed by the hash of their inputs. They are owned by meshes, and
+  /// protected by meshesMutex.
+  public: std::map<std::string, const Mesh *> generated;
+
+  /// \brief Distance fields of meshes, indexed by the hash of their
+  /// inputs.
+  public: std::map<std::string, std::unique_ptr<MeshDistanceField>>
+          distanceFields;
+
+  /// \brief Protects distanceFields, and generates each field once.
+  public: std::mutex distanceFieldsMutex;
+
+  /// \brief Ray trees of the meshes, indexed by mesh name. A null tree
+  /// marks a mesh without triangles.
+  public: std::map<std::string, std::unique_ptr<MeshRayTree>> rayTrees;
+
+  /// \brief Protects rayTrees.
+  public: std::mutex rayTreesMutex;
+
+  /// \brief Bytes held by the meshes and their levels of detail, in the
+  /// "meshes" subsystem of the MemoryTracker.
+  public: std::atomic<int64_t> *memory = nullptr;
+
+  /// \brief Id of the evictor of the levels of detail.
+  public: int evictor = -1;
+
+  /// \brief Drop levels of detail, which are generated again on their
+  /// next use.
+  /// \param[in] _bytes Number of bytes to free.
+  public: void EvictLods(const uint64_t _bytes)
+  {
+    std::lock_guard<std::mutex> lock(this->lodsMutex);
+    int64_t freed = 0;
+    while (!this->lods.empty() && freed < static_cast<int64_t>(_bytes))
+    {
+      freed += LodBytes(this->lods.begin()->second);
+      this->lods.erase(this->lods.begin());
+    }
+    *this->memory -= freed;
+  }
+
+  /// \brief Get a mesh.
+  /// \param[in] _name Name of the mesh.
+  /// \return The mesh, or nullptr if there is none with that name.
+  public: Mesh *Find(const std::string &_name)
+  {
+    std::lock_guard<std::mutex> lock(this->meshesMutex);
+    auto iter = this->meshes.find(_name);
+    return iter != this->meshes.end() ? iter->second : nullptr;
+  }
+
+  /// \brief Add a mesh, unless there is already one with its name.
+  /// \param[in] _name Name of the mesh.
+  /// \param[in] _mesh The mesh.
+  /// \return False if there is already a mesh with that name.
+  public: bool Insert(const std::string &_name, Mesh *_mesh)
+  {
+    std::lock_guard<std::mutex> lock(this->meshesMutex);
+    if (!this->meshes.insert(std::make_pair(_name, _mesh)).second)
+      return false;
+
+    // The shapes created by the manager are added before their geometry,
+    // and aren't counted; they are small.
+    *this->memory += MeshBytes(*_mesh);
+    return true;
+  }
+
+  /// \brief Get the loader of a mesh file.
+  /// \param[in] _filename Path of the mesh file.
+  /// \param[in] _collada Loader of COLLADA files.
+  /// \param[in] _stl Loader of STL files.
+  /// \param[in] _obj Loader of OBJ files.
+  /// \return The loader, or nullptr if the format isn't supported.
+  public: static MeshLoader *Loader(const std::string &_filename,
+              ColladaLoader *_collada, STLLoader *_stl, OBJLoader *_obj)
+  {
+    std::string extension = _filename.substr(_filename.rfind(".")+1,
+        _filename.size());
+    std::transform(extension.begin(), extension.end(),
+        extension.begin(), ::tolower);
+
+    if (extension == "stl" || extension == "stlb" || extension == "stla")
+      return _stl;
+    else if (extension == "dae")
+      return _collada;
+    else if (extension == "obj")
+      return _obj;
+    return nullptr;
+  }
+
+  /// \brief Load a mesh file, from the mesh cache if it's there. A parsed
+  /// file is added to the cache.
+  /// \param[in] _filename Path of the mesh file.
+  /// \param[in] _loader Loader of the file.
+  /// \return The mesh, or nullptr on error.
+  public: Mesh *LoadFile(const std::string &_filename,
+              MeshLoader *_loader) const
+  {
+    std::string cacheFilename;
+    if (!this->cacheDir.empty())
+      cacheFilename = MeshCache::Filename(_filename, this->cacheDir);
+
+    Mesh *mesh = nullptr;
+    if (!cacheFilename.empty())
+      mesh = MeshCache::Load(cacheFilename);
+
+    if (!mesh && (mesh = _loader->Load(_filename)) != nullptr &&
+        !cacheFilename.empty())
+    {
+      MeshCache::Save(*mesh, cacheFilename);
+    }
+    return mesh;
+  }
+
+  /// \brief Get a copy of a generated mesh, from memory or from the mesh
+  /// cache.
+  /// \param[in] _key Hash of the inputs of the mesh.
+  /// \return The mesh, which the caller owns, or nullptr if it hasn't
+  /// been generated yet.
+  public: Mesh *Generated(const std::string &_key)
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->meshesMutex);
+      auto iter = this->generated.find(_key);
+      if (iter != this->generated.end())
+      {
+        Mesh *mesh = new Mesh();
+        for (unsigned int i = 0; i < iter->second->GetSubMeshCount(); ++i)
+          mesh->AddSubMesh(new SubMesh(iter->second->GetSubMesh(i)));
+        return mesh;
+      }
+    }
+
+    if (this->cacheDir.empty())
+      return nullptr;
+    const std::string filename = MeshCache::KeyFilename(_key, this->cacheDir);
+    return filename.empty() ? nullptr : MeshCache::Load(filename);
+  }
+
+  /// \brief Add a generated mesh, unless there is already one with its
+  /// name, and remember it in memory and in the mesh cache.
+  /// \param[in] _key Hash of the inputs of the mesh.
+  /// \param[in] _name Name of the mesh.
+  /// \param[in] _mesh The mesh, which is deleted if it isn't added.
+  /// \return False if there is already a mesh with that name.
+  public: bool InsertGenerated(const std::string &_key,
+              const std::string &_name, Mesh *_mesh)
+  {
+    _mesh->SetName(_name);
+    {
+      std::lock_guard<std::mutex> lock(this->meshesMutex);
+      if (!this->meshes.insert(std::make_pair(_name, _mesh)).second)
+      {
+        delete _mesh;
+        return false;
+      }
+      this->generated.insert(std::make_pair(_key, _mesh));
+    }
+
+    if (!this->cacheDir.empty())
+    {
+      const std::string filename =
+          MeshCache::KeyFilename(_key, this->cacheDir);
+      if (!filename.empty() && !boost::filesystem::exists(filename))
+        MeshCache::Save(*_mesh, filename);
+    }
+    return true;
+  }
+
+#ifdef HAVE_GTS
+  /// \brief Get the hash of the inputs of a boolean mesh.
+  /// \param[in] _m1 The parent mesh in the boolean operation.
+  /// \param[in] _m2 The child mesh in the boolean operation.
+  /// \param[in] _operation The boolean operation.
+  /// \param[in] _offset _m2's pose offset from _m1.
+  /// \return The hash.
+  public: static std::string BooleanKey(const Mesh &_m1, const Mesh &_m2,
+              const int _operation, const ignition::math::Pose3d &_offset)
+  {
+    std::string key = "boolean\n";
+    PutKey(key, _operation);
+    for (unsigned int i = 0; i < 3; ++i)
+      PutKey(key, _offset.Pos()[i]);
+    PutKey(key, _offset.Rot().W());
+    PutKey(key, _offset.Rot().X());
+    PutKey(key, _offset.Rot().Y());
+    PutKey(key, _offset.Rot().Z());
+    PutKey(key, _m1);
+    PutKey(key, _m2);
+    return get_sha1<std::string>(key);
+  }
+
+  /// \brief Create a boolean mesh, or get it from the mesh caches.
+  /// \param[in] _key Hash of the inputs, given by BooleanKey.
+  /// \param[in] _m1 The parent mesh in the boolean operation.
+  /// \param[in] _m2 The child mesh in the boolean operation.
+  /// \param[in] _operation The boolean operation.
+  /// \param[in] _offset _m2's pose offset from _m1.
+  /// \return The mesh, which the caller owns, or nullptr on error.
+  public: Mesh *Boolean(const std::string &_key, const Mesh *_m1,
+              const Mesh *_m2, const int _operation,
+              const ignition::math::Pose3d &_offset)
+  {
+    Mesh *mesh = this->Generated(_key);
+    if (!mesh)
+    {
+      MeshCSG csg;
+      mesh = csg.CreateBoolean(_m1, _m2, _operation, _offset);
+    }
+    return mesh;
+  }
+#endif
+
+  /// \brief Number of threads that load meshes in Prefetch, and create
+  /// them in CreateBooleans.
+  /// \return The number of threads.
+  public: static unsigned int PrefetchThreads()
+  {
+    static const unsigned int threads = []() -> unsigned int
+    {
+      const char *env = getEnv("GAZEBO_MESH_LOAD_THREADS");
+      if (env)
+      {
+        try
+        {
+          return std::max(1, std::stoi(env));
+        }
+        catch(...)
+        {
+          gzwarn << "Invalid GAZEBO_MESH_LOAD_THREADS[" << env
+                 << "], loading meshes on one thread.\n";
+          return 1;
+        }
+      }
+      return std::max(1u, std::thread::hardware_concurrency());
+    }();
+
+    return threads;
+  }
 };
 
 // added here for ABI compatibility
@@ -75,6 +407,15 @@ static OBJLoader objLoader;
 MeshManager::MeshManager()
   : dataPtr(new MeshManagerPrivate)
 {
+  // The tracker is created first, so it outlives the manager
+  MemoryTracker *tracker = MemoryTracker::Instance();
+  this->dataPtr->memory = &tracker->Counter("meshes");
+  this->dataPtr->evictor = tracker->AddEvictor("meshes",
+      [this](const uint64_t _bytes)
+      {
+        this->dataPtr->EvictLods(_bytes);
+      });
+
   this->dataPtr->colladaLoader = new ColladaLoader();
   this->dataPtr->colladaExporter = new ColladaExporter();
   this->dataPtr->stlLoader = new STLLoader();
@@ -111,19 +452,31 @@ MeshManager::MeshManager()
   this->dataPtr->fileExtensions.push_back("stlb");
   this->dataPtr->fileExtensions.push_back("dae");
   this->dataPtr->fileExtensions.push_back("obj");
+
+  const char *cacheEnv = getEnv("GAZEBO_MESH_CACHE");
+  if (!cacheEnv || std::string(cacheEnv) != "0")
+  {
+    this->dataPtr->cacheDir = (boost::filesystem::path(
+          SystemPaths::Instance()->GetLogPath()) / "mesh_cache").string();
+  }
 }
 
 //////////////////////////////////////////////////
 MeshManager::~MeshManager()
 {
+  MemoryTracker::Instance()->RemoveEvictor(this->dataPtr->evictor);
+
   delete this->dataPtr->colladaLoader;
   delete this->dataPtr->colladaExporter;
   delete this->dataPtr->stlLoader;
   for (auto &pairNameMesh : this->dataPtr->meshes)
   {
+    *this->dataPtr->memory -= MeshBytes(*pairNameMesh.second);
     delete pairNameMesh.second;
   }
   this->dataPtr->meshes.clear();
+  for (auto const &lods : this->dataPtr->lods)
+    *this->dataPtr->memory -= LodBytes(lods.second);
 
   delete this->dataPtr;
   this->dataPtr = nullptr;
@@ -140,11 +493,9 @@ const Mesh *MeshManager::Load(const std::string &_filename)
 
   Mesh *mesh = nullptr;
 
-  std::string extension;
-
   if (this->HasMesh(_filename))
   {
-    return this->dataPtr->meshes[_filename];
+    return this->GetMesh(_filename);
 
     // This breaks trimesh geom. Each new trimesh should have a unique name.
     /*
@@ -163,18 +514,9 @@ const Mesh *MeshManager::Load(const std::string &_filename)
 
   if (!fullname.empty())
   {
-    extension = fullname.substr(fullname.rfind(".")+1, fullname.size());
-    std::transform(extension.begin(), extension.end(),
-        extension.begin(), ::tolower);
-    MeshLoader *loader = nullptr;
-
-    if (extension == "stl" || extension == "stlb" || extension == "stla")
-      loader = this->dataPtr->stlLoader;
-    else if (extension == "dae")
-      loader = this->dataPtr->colladaLoader;
-    else if (extension == "obj")
-      loader = &objLoader;
-    else
+    MeshLoader *loader = MeshManagerPrivate::Loader(fullname,
+        this->dataPtr->colladaLoader, this->dataPtr->stlLoader, &objLoader);
+    if (!loader)
     {
       gzerr << "Unsupported mesh format for file[" << _filename << "]\n";
       return nullptr;
@@ -187,17 +529,24 @@ const Mesh *MeshManager::Load(const std::string &_filename)
       boost::mutex::scoped_lock lock(this->dataPtr->mutex);
       if (!this->HasMesh(_filename))
       {
-        if ((mesh = loader->Load(fullname)) != nullptr)
+        mesh = this->dataPtr->LoadFile(fullname, loader);
+        if (mesh)
         {
           mesh->SetName(_filename);
-          this->dataPtr->meshes.insert(std::make_pair(_filename, mesh));
+
+          // Prefetch may have added it in the meantime
+          if (!this->dataPtr->Insert(_filename, mesh))
+          {
+            delete mesh;
+            mesh = this->dataPtr->Find(_filename);
+          }
         }
         else
           gzerr << "Unable to load mesh[" << fullname << "]\n";
       }
       else
       {
-        mesh = this->dataPtr->meshes[_filename];
+        mesh = this->dataPtr->Find(_filename);
       }
     }
     catch(gazebo::common::Exception &e)
@@ -213,6 +562,77 @@ const Mesh *MeshManager::Load(const std::string &_filename)
   return mesh;
 }
 
+//////////////////////////////////////////////////
+unsigned int MeshManager::Prefetch(const std::vector<std::string> &_uris)
+{
+  // Resolve the files on this thread, since resolving a URI may download
+  // a model
+  std::vector<std::string> filenames;
+  std::set<std::string> unique;
+  for (auto const &uri : _uris)
+  {
+    const std::string filename = common::find_file(uri);
+    if (filename.empty() || !this->IsValidFilename(filename) ||
+        this->HasMesh(filename) || !unique.insert(filename).second)
+    {
+      // Load reports the errors of these ones
+      continue;
+    }
+    filenames.push_back(filename);
+  }
+
+  if (filenames.empty())
+    return 0;
+
+  // Each thread parses with its own loaders, which keep the state of the
+  // file they are parsing
+  std::atomic<std::size_t> next(0);
+  std::atomic<unsigned int> loaded(0);
+  auto loadMeshes = [&]()
+  {
+    ColladaLoader collada;
+    STLLoader stl;
+    OBJLoader obj;
+    for (std::size_t i = next++; i < filenames.size(); i = next++)
+    {
+      const std::string &filename = filenames[i];
+      MeshLoader *loader = MeshManagerPrivate::Loader(filename, &collada,
+          &stl, &obj);
+
+      Mesh *mesh = nullptr;
+      try
+      {
+        mesh = this->dataPtr->LoadFile(filename, loader);
+      }
+      catch(gazebo::common::Exception &e)
+      {
+        gzerr << "Error loading mesh[" << filename << "]\n" << e << "\n";
+        continue;
+      }
+
+      if (!mesh)
+        continue;
+
+      mesh->SetName(filename);
+      if (this->dataPtr->Insert(filename, mesh))
+        ++loaded;
+      else
+        delete mesh;
+    }
+  };
+
+  const unsigned int threadCount = std::min<std::size_t>(
+      MeshManagerPrivate::PrefetchThreads(), filenames.size());
+  std::vector<std::thread> threads;
+  for (unsigned int i = 1; i < threadCount; ++i)
+    threads.emplace_back(loadMeshes);
+  loadMeshes();
+  for (auto &thread : threads)
+    thread.join();
+
+  return loaded;
+}
+
 //////////////////////////////////////////////////
 void MeshManager::Export(const Mesh *_mesh, const std::string &_filename,
     const std::string &_extension, bool _exportTextures)
@@ -249,36 +669,30 @@ void MeshManager::GetMeshAABB(const Mesh *_mesh,
     ignition::math::Vector3d &_center,
     ignition::math::Vector3d &_minXYZ, ignition::math::Vector3d &_maxXYZ)
 {
-  if (this->HasMesh(_mesh->GetName()))
-    this->dataPtr->meshes[_mesh->GetName()]->GetAABB(_center, _minXYZ, _maxXYZ);
+  Mesh *mesh = this->dataPtr->Find(_mesh->GetName());
+  if (mesh)
+    mesh->GetAABB(_center, _minXYZ, _maxXYZ);
 }
 
 //////////////////////////////////////////////////
 void MeshManager::GenSphericalTexCoord(const Mesh *_mesh,
     const ignition::math::Vector3d &_center)
 {
-  if (this->HasMesh(_mesh->GetName()))
-    this->dataPtr->meshes[_mesh->GetName()]->GenSphericalTexCoord(_center);
+  Mesh *mesh = this->dataPtr->Find(_mesh->GetName());
+  if (mesh)
+    mesh->GenSphericalTexCoord(_center);
 }
 
 //////////////////////////////////////////////////
 void MeshManager::AddMesh(Mesh *_mesh)
 {
-  if (!this->HasMesh(_mesh->GetName()))
-    this->dataPtr->meshes[_mesh->GetName()] = _mesh;
+  this->dataPtr->Insert(_mesh->GetName(), _mesh);
 }
 
 //////////////////////////////////////////////////
 const Mesh *MeshManager::GetMesh(const std::string &_name) const
 {
-  std::map<std::string, Mesh*>::const_iterator iter;
-
-  iter = this->dataPtr->meshes.find(_name);
-
-  if (iter != this->dataPtr->meshes.end())
-    return iter->second;
-
-  return nullptr;
+  return this->dataPtr->Find(_name);
 }
 
 //////////////////////////////////////////////////
@@ -287,10 +701,121 @@ bool MeshManager::HasMesh(const std::string &_name) const
   if (_name.empty())
     return false;
 
-  std::map<std::string, Mesh*>::const_iterator iter;
-  iter = this->dataPtr->meshes.find(_name);
+  return this->dataPtr->Find(_name) != nullptr;
+}
+
+//////////////////////////////////////////////////
+std::vector<MeshLodLevel> MeshManager::MeshLods(const Mesh *_mesh)
+{
+  if (!_mesh)
+    return std::vector<MeshLodLevel>();
+
+  // Meshes the manager doesn't own may be deleted, and their name reused
+  if (this->GetMesh(_mesh->GetName()) != _mesh)
+    return MeshLod::Generate(*_mesh);
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->lodsMutex);
+  auto iter = this->dataPtr->lods.find(_mesh->GetName());
+  if (iter == this->dataPtr->lods.end())
+  {
+    iter = this->dataPtr->lods.insert(
+        std::make_pair(_mesh->GetName(), MeshLod::Generate(*_mesh))).first;
+    *this->dataPtr->memory += LodBytes(iter->second);
+  }
+  return iter->second;
+}
+
+//////////////////////////////////////////////////
+const Mesh *MeshManager::ConvexDecomposition(const Mesh *_mesh,
+    const unsigned int _maxHulls)
+{
+  if (!_mesh)
+    return nullptr;
+
+  std::string key = "convex_decomposition\n";
+  PutKey(key, _maxHulls);
+  PutKey(key, *_mesh);
+  key = get_sha1<std::string>(key);
+
+  const std::string name = "__convex_decomposition__" + key;
+  const Mesh *hulls = this->GetMesh(name);
+  if (hulls)
+    return hulls;
+
+  Mesh *mesh = this->dataPtr->Generated(key);
+  if (!mesh)
+    mesh = MeshDecomposition::Generate(*_mesh, _maxHulls);
+  if (!mesh)
+    return nullptr;
+
+  this->dataPtr->InsertGenerated(key, name, mesh);
+  return this->GetMesh(name);
+}
+
+//////////////////////////////////////////////////
+const MeshDistanceField *MeshManager::DistanceField(const Mesh *_mesh,
+    const ignition::math::Vector3d &_scale, const double _cellSize)
+{
+  if (!_mesh)
+    return nullptr;
+
+  std::string key = "distance_field\n";
+  PutKey(key, _cellSize);
+  PutKey(key, _scale.X());
+  PutKey(key, _scale.Y());
+  PutKey(key, _scale.Z());
+  PutKey(key, *_mesh);
+  key = get_sha1<std::string>(key);
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->distanceFieldsMutex);
+  auto iter = this->dataPtr->distanceFields.find(key);
+  if (iter != this->dataPtr->distanceFields.end())
+    return iter->second.get();
+
+  // Fields are cached next to the meshes, with an extension of their own
+  std::string filename;
+  if (!this->dataPtr->cacheDir.empty())
+  {
+    filename = MeshCache::KeyFilename(key, this->dataPtr->cacheDir);
+    if (!filename.empty())
+    {
+      filename = boost::filesystem::path(filename).replace_extension(
+          ".distance").string();
+    }
+  }
+
+  std::unique_ptr<MeshDistanceField> field(new MeshDistanceField());
+  if (filename.empty() || !field->Load(filename))
+  {
+    if (!field->Generate(*_mesh, _scale, _cellSize))
+      return nullptr;
+    if (!filename.empty())
+      field->Save(filename);
+  }
+
+  const MeshDistanceField *result = field.get();
+  this->dataPtr->distanceFields[key] = std::move(field);
+  return result;
+}
+
+//////////////////////////////////////////////////
+const MeshRayTree *MeshManager::RayTree(const Mesh *_mesh)
+{
+  // Meshes the manager doesn't own may be deleted, and their name reused
+  if (!_mesh || this->GetMesh(_mesh->GetName()) != _mesh)
+    return nullptr;
 
-  return iter != this->dataPtr->meshes.end();
+  std::lock_guard<std::mutex> lock(this->dataPtr->rayTreesMutex);
+  auto iter = this->dataPtr->rayTrees.find(_mesh->GetName());
+  if (iter == this->dataPtr->rayTrees.end())
+  {
+    std::unique_ptr<MeshRayTree> tree(new MeshRayTree());
+    if (!tree->Build(*_mesh))
+      tree.reset();
+    iter = this->dataPtr->rayTrees.insert(
+        std::make_pair(_mesh->GetName(), std::move(tree))).first;
+  }
+  return iter->second.get();
 }
 
 //////////////////////////////////////////////////
@@ -310,7 +835,7 @@ void MeshManager::CreateSphere(const std::string &name, float radius,
 
   Mesh *mesh = new Mesh();
   mesh->SetName(name);
-  this->dataPtr->meshes.insert(std::make_pair(name, mesh));
+  this->dataPtr->Insert(name, mesh);
 
   SubMesh *subMesh = new SubMesh();
   mesh->AddSubMesh(subMesh);
@@ -378,7 +903,7 @@ void MeshManager::CreatePlane(const std::string &_name,
 
   Mesh *mesh = new Mesh();
   mesh->SetName(_name);
-  this->dataPtr->meshes.insert(std::make_pair(_name, mesh));
+  this->dataPtr->Insert(_name, mesh);
 
   SubMesh *subMesh = new SubMesh();
   mesh->AddSubMesh(subMesh);
@@ -458,7 +983,7 @@ void MeshManager::CreateBox(const std::string &_name,
 
   Mesh *mesh = new Mesh();
   mesh->SetName(_name);
-  this->dataPtr->meshes.insert(std::make_pair(_name, mesh));
+  this->dataPtr->Insert(_name, mesh);
 
   SubMesh *subMesh = new SubMesh();
   mesh->AddSubMesh(subMesh);
@@ -581,7 +1106,27 @@ void MeshManager::CreateExtrudedPolyline(const std::string &_name,
     return;
   }
 
-  Mesh *mesh = new Mesh();
+  std::string key = "extrusion\n";
+  PutKey(key, _height);
+  for (auto const &poly : polys)
+  {
+    PutKey(key, poly.size());
+    for (auto const &point : poly)
+    {
+      PutKey(key, point.X());
+      PutKey(key, point.Y());
+    }
+  }
+  key = get_sha1<std::string>(key);
+
+  Mesh *mesh = this->dataPtr->Generated(key);
+  if (mesh)
+  {
+    this->dataPtr->InsertGenerated(key, _name, mesh);
+    return;
+  }
+
+  mesh = new Mesh();
   mesh->SetName(_name);
 
   SubMesh *subMesh = new SubMesh();
@@ -759,8 +1304,7 @@ void MeshManager::CreateExtrudedPolyline(const std::string &_name,
     }
   }
 
-  this->dataPtr->meshes.insert(std::make_pair(_name, mesh));
-  return;
+  this->dataPtr->InsertGenerated(key, _name, mesh);
 }
 
 //////////////////////////////////////////////////
@@ -775,7 +1319,7 @@ void MeshManager::CreateCamera(const std::string &_name, float _scale)
 
   Mesh *mesh = new Mesh();
   mesh->SetName(_name);
-  this->dataPtr->meshes.insert(std::make_pair(_name, mesh));
+  this->dataPtr->Insert(_name, mesh);
 
   SubMesh *subMesh = new SubMesh();
   mesh->AddSubMesh(subMesh);
@@ -876,7 +1420,7 @@ void MeshManager::CreateCylinder(const std::string &name, float radius,
 
   Mesh *mesh = new Mesh();
   mesh->SetName(name);
-  this->dataPtr->meshes.insert(std::make_pair(name, mesh));
+  this->dataPtr->Insert(name, mesh);
 
   SubMesh *subMesh = new SubMesh();
   mesh->AddSubMesh(subMesh);
@@ -993,7 +1537,7 @@ void MeshManager::CreateCone(const std::string &name, float radius,
 
   Mesh *mesh = new Mesh();
   mesh->SetName(name);
-  this->dataPtr->meshes.insert(std::make_pair(name, mesh));
+  this->dataPtr->Insert(name, mesh);
 
   SubMesh *subMesh = new SubMesh();
   mesh->AddSubMesh(subMesh);
@@ -1110,7 +1654,7 @@ void MeshManager::CreateTube(const std::string &_name, float _innerRadius,
 
   Mesh *mesh = new Mesh();
   mesh->SetName(_name);
-  this->dataPtr->meshes.insert(std::make_pair(_name, mesh));
+  this->dataPtr->Insert(_name, mesh);
   SubMesh *subMesh = new SubMesh();
   mesh->AddSubMesh(subMesh);
 
@@ -1328,10 +1872,81 @@ void MeshManager::CreateBoolean(const std::string &_name, const Mesh *_m1,
   if (this->HasMesh(_name))
     return;
 
-  MeshCSG csg;
-  Mesh *mesh = csg.CreateBoolean(_m1, _m2, _operation, _offset);
-  mesh->SetName(_name);
-  this->dataPtr->meshes.insert(std::make_pair(_name, mesh));
+  const std::string key =
+      MeshManagerPrivate::BooleanKey(*_m1, *_m2, _operation, _offset);
+  Mesh *mesh = this->dataPtr->Boolean(key, _m1, _m2, _operation, _offset);
+  if (!mesh)
+  {
+    gzerr << "Unable to create boolean mesh[" << _name << "]\n";
+    return;
+  }
+  this->dataPtr->InsertGenerated(key, _name, mesh);
+}
+
+//////////////////////////////////////////////////
+unsigned int MeshManager::CreateBooleans(
+    const std::vector<MeshBooleanOperation> &_operations)
+{
+  std::vector<const MeshBooleanOperation *> operations;
+  std::set<std::string> unique;
+  for (auto const &operation : _operations)
+  {
+    if (!this->HasMesh(operation.name) &&
+        unique.insert(operation.name).second)
+    {
+      operations.push_back(&operation);
+    }
+  }
+
+  if (operations.empty())
+    return 0;
+
+  // GTS creates its object classes on first use, without locking, so a
+  // small operation creates them on this thread before starting others
+  const unsigned int threadCount = std::min<std::size_t>(
+      MeshManagerPrivate::PrefetchThreads(), operations.size());
+  if (threadCount > 1)
+  {
+    static std::once_flag gtsClasses;
+    std::call_once(gtsClasses, [this]()
+    {
+      const Mesh *box = this->GetMesh("unit_box");
+      MeshCSG csg;
+      delete csg.CreateBoolean(box, box, MeshCSG::UNION,
+          ignition::math::Pose3d(0.5, 0.5, 0.5, 0, 0, 0));
+    });
+  }
+
+  std::atomic<std::size_t> next(0);
+  std::atomic<unsigned int> created(0);
+  auto createMeshes = [&]()
+  {
+    for (std::size_t i = next++; i < operations.size(); i = next++)
+    {
+      const MeshBooleanOperation &operation = *operations[i];
+      const std::string key = MeshManagerPrivate::BooleanKey(*operation.m1,
+          *operation.m2, operation.operation, operation.offset);
+      Mesh *mesh = this->dataPtr->Boolean(key, operation.m1, operation.m2,
+          operation.operation, operation.offset);
+      if (!mesh)
+      {
+        gzerr << "Unable to create boolean mesh[" << operation.name << "]\n";
+        continue;
+      }
+
+      if (this->dataPtr->InsertGenerated(key, operation.name, mesh))
+        ++created;
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (unsigned int i = 1; i < threadCount; ++i)
+    threads.emplace_back(createMeshes);
+  createMeshes();
+  for (auto &thread : threads)
+    thread.join();
+
+  return created;
 }
 #endif
 
@@ -28,6 +28,7 @@
 
 #include "gazebo/common/SingletonT.hh"
 #include "gazebo/common/CommonTypes.hh"
+#include "gazebo/common/MeshLod.hh"
 #include "gazebo/util/system.hh"
 
 /// \brief Explicit instantiation for typed SingletonT.
@@ -40,13 +41,55 @@ namespace gazebo
     // Forward declarations.
     class MeshManagerPrivate;
     class Mesh;
+    class MeshDistanceField;
+    class MeshRayTree;
     class SubMesh;
 
     /// \addtogroup gazebo_common Common
     /// \{
 
+#ifdef HAVE_GTS
+    /// \class MeshBooleanOperation MeshManager.hh common/common.hh
+    /// \brief A boolean operation between two meshes, to be run by
+    /// MeshManager::CreateBooleans.
+    class GZ_COMMON_VISIBLE MeshBooleanOperation
+    {
+      /// \brief Name of the new mesh.
+      public: std::string name;
+
+      /// \brief The parent mesh in the boolean operation.
+      public: const Mesh *m1 = nullptr;
+
+      /// \brief The child mesh in the boolean operation.
+      public: const Mesh *m2 = nullptr;
+
+      /// \brief The operation, one of MeshCSG::BooleanOperation.
+      public: int operation = 0;
+
+      /// \brief m2's pose offset from m1.
+      public: ignition::math::Pose3d offset;
+    };
+#endif
+
     /// \class MeshManager MeshManager.hh common/common.hh
     /// \brief Maintains and manages all meshes
+    ///
+    /// Meshes loaded from files are cached on disk in
+    /// <log path>/mesh_cache, so that later loads skip parsing the file.
+    /// Boolean meshes and extruded polylines are cached in memory and on
+    /// disk, so that they are only computed once for the same inputs.
+    /// The meshes and their levels of detail count against the "meshes"
+    /// budget of the MemoryTracker, over which the levels of detail are
+    /// dropped until their next use.
+    /// \sa MeshCache
+    ///
+    /// \remarks
+    ///  Environment Variables:
+    ///   - GAZEBO_MESH_CACHE: Set it to 0 to always parse mesh files, and
+    ///     only cache generated meshes in memory.
+    ///   - GAZEBO_MESH_LOAD_THREADS: Number of threads that load meshes in
+    ///     Prefetch and create them in CreateBooleans. Defaults to the
+    ///     number of cores.
     class GZ_COMMON_VISIBLE MeshManager : public SingletonT<MeshManager>
     {
       /// \brief Constructor
@@ -62,6 +105,15 @@ namespace gazebo
       /// \return a pointer to the created mesh
       public: const Mesh *Load(const std::string &_filename);
 
+      /// \brief Load several meshes in parallel, so that later calls to
+      /// Load find them loaded. Meshes are named after their resolved
+      /// file path, like the ones loaded by shapes and visuals.
+      /// Meshes that can't be loaded are skipped, Load reports their
+      /// errors.
+      /// \param[in] _uris Paths or URIs of the mesh files.
+      /// \return Number of meshes loaded.
+      public: unsigned int Prefetch(const std::vector<std::string> &_uris);
+
       /// \brief Export a mesh to a file
       /// \param[in] _mesh Pointer to the mesh to be exported
       /// \param[in] _filename Exported file's path and name
@@ -107,6 +159,51 @@ namespace gazebo
       /// \param[in] _name the name of the mesh
       public: bool HasMesh(const std::string &_name) const;
 
+      /// \brief Get the levels of detail of a mesh. The levels of the
+      /// meshes owned by the manager are generated on first use and kept
+      /// with the mesh.
+      /// \param[in] _mesh The mesh.
+      /// \return The levels, from the most to the least detailed, empty if
+      /// the mesh is drawn at full resolution at every distance.
+      /// \sa MeshLod::Generate
+      public: std::vector<MeshLodLevel> MeshLods(const Mesh *_mesh);
+
+      /// \brief Get the decomposition of a mesh into convex hulls. The
+      /// hulls are generated on first use, and kept by the manager and in
+      /// the mesh cache by the hash of the mesh data, so that meshes with
+      /// the same triangles share them.
+      /// \param[in] _mesh The mesh.
+      /// \param[in] _maxHulls Maximum number of hulls.
+      /// \return A mesh with one submesh per hull, owned by the manager, or
+      /// nullptr if _mesh has no volume.
+      /// \sa MeshDecomposition::Generate
+      public: const Mesh *ConvexDecomposition(const Mesh *_mesh,
+                  const unsigned int _maxHulls = 16u);
+
+      /// \brief Get the signed distance field of a mesh. The field is
+      /// generated on first use, and kept by the manager and in the mesh
+      /// cache by the hash of the mesh data, so that meshes with the same
+      /// triangles share it.
+      /// \param[in] _mesh The mesh.
+      /// \param[in] _scale Scaling factor of the vertices.
+      /// \param[in] _cellSize Distance between the nodes of the field, zero
+      /// to pick it from the size of the mesh.
+      /// \return The field, owned by the manager, or nullptr if _mesh has
+      /// no triangles.
+      /// \sa MeshDistanceField::Generate
+      public: const MeshDistanceField *DistanceField(const Mesh *_mesh,
+                  const ignition::math::Vector3d &_scale =
+                  ignition::math::Vector3d::One,
+                  const double _cellSize = 0.0);
+
+      /// \brief Get the ray tree of a mesh owned by the manager, built on
+      /// first use and kept with the mesh.
+      /// \param[in] _mesh The mesh.
+      /// \return The tree, owned by the manager, or nullptr if _mesh isn't
+      /// owned by the manager or has no triangles.
+      /// \sa MeshRayTree::Build
+      public: const MeshRayTree *RayTree(const Mesh *_mesh);
+
       /// \brief Create a sphere mesh.
       /// \param[in] _name the name of the mesh
       /// \param[in] _radius radius of the sphere in meter
@@ -233,6 +330,14 @@ namespace gazebo
       public: void CreateBoolean(const std::string &_name, const Mesh *_m1,
           const Mesh *_m2, const int _operation,
           const ignition::math::Pose3d &_offset = ignition::math::Pose3d::Zero);
+
+      /// \brief Create several boolean meshes in parallel, as
+      /// CreateBoolean does. The operations must be independent, none of
+      /// them can use the result of another one.
+      /// \param[in] _operations The operations.
+      /// \return Number of meshes created.
+      public: unsigned int CreateBooleans(
+                  const std::vector<MeshBooleanOperation> &_operations);
 #endif
 
       /// \brief Converts a vector of polylines into a table of vertices and
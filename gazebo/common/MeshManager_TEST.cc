@@ -18,9 +18,12 @@
 #include <gtest/gtest.h>
 
 #include "test_config.h"
+#include "gazebo/gazebo_config.h"
 #include "gazebo/common/Mesh.hh"
 #include "gazebo/common/MeshManager.hh"
-#include "gazebo/gazebo_config.h"
+#ifdef HAVE_GTS
+  #include "gazebo/common/MeshCSG.hh"
+#endif
 #include "test/util.hh"
 
 using namespace gazebo;
@@ -243,6 +246,99 @@ TEST_F(MeshManager, CreateExtrudedPolylineClosedPath)
     }
   }
 }
+
+/////////////////////////////////////////////////
+/// \brief Expect two meshes to have the same geometry.
+/// \param[in] _mesh1 A mesh.
+/// \param[in] _mesh2 Another mesh.
+static void ExpectSameGeometry(const common::Mesh *_mesh1,
+    const common::Mesh *_mesh2)
+{
+  ASSERT_NE(nullptr, _mesh1);
+  ASSERT_NE(nullptr, _mesh2);
+  ASSERT_EQ(_mesh1->GetSubMeshCount(), _mesh2->GetSubMeshCount());
+  for (unsigned int i = 0; i < _mesh1->GetSubMeshCount(); ++i)
+  {
+    const common::SubMesh *subMesh1 = _mesh1->GetSubMesh(i);
+    const common::SubMesh *subMesh2 = _mesh2->GetSubMesh(i);
+    ASSERT_EQ(subMesh1->GetVertexCount(), subMesh2->GetVertexCount());
+    ASSERT_EQ(subMesh1->GetIndexCount(), subMesh2->GetIndexCount());
+    for (unsigned int j = 0; j < subMesh1->GetVertexCount(); ++j)
+      EXPECT_EQ(subMesh1->Vertex(j), subMesh2->Vertex(j));
+    for (unsigned int j = 0; j < subMesh1->GetIndexCount(); ++j)
+      EXPECT_EQ(subMesh1->GetIndex(j), subMesh2->GetIndex(j));
+  }
+}
+
+/////////////////////////////////////////////////
+TEST_F(MeshManager, CreateExtrudedPolylineCached)
+{
+  common::MeshManager *meshManager = common::MeshManager::Instance();
+  std::vector<std::vector<ignition::math::Vector2d> > path = {{
+      ignition::math::Vector2d(0, 0), ignition::math::Vector2d(2, 0),
+      ignition::math::Vector2d(2, 1), ignition::math::Vector2d(0, 1)}};
+
+  // The same inputs give a copy of the first mesh
+  meshManager->CreateExtrudedPolyline("extruded_cached_1", path, 0.5);
+  meshManager->CreateExtrudedPolyline("extruded_cached_2", path, 0.5);
+  const common::Mesh *mesh1 = meshManager->GetMesh("extruded_cached_1");
+  const common::Mesh *mesh2 = meshManager->GetMesh("extruded_cached_2");
+  EXPECT_NE(mesh1, mesh2);
+  ExpectSameGeometry(mesh1, mesh2);
+  EXPECT_EQ("extruded_cached_2", mesh2->GetName());
+
+  // Other inputs give another mesh
+  meshManager->CreateExtrudedPolyline("extruded_cached_3", path, 1.0);
+  const common::Mesh *mesh3 = meshManager->GetMesh("extruded_cached_3");
+  ASSERT_NE(nullptr, mesh3);
+  EXPECT_DOUBLE_EQ(1.0, mesh3->Max().Z());
+  EXPECT_DOUBLE_EQ(0.5, mesh1->Max().Z());
+}
+
+/////////////////////////////////////////////////
+TEST_F(MeshManager, CreateBooleans)
+{
+  common::MeshManager *meshManager = common::MeshManager::Instance();
+  const common::Mesh *box = meshManager->GetMesh("unit_box");
+  const common::Mesh *sphere = meshManager->GetMesh("unit_sphere");
+  ASSERT_NE(nullptr, box);
+  ASSERT_NE(nullptr, sphere);
+
+  std::vector<common::MeshBooleanOperation> operations(3);
+  operations[0].name = "boolean_union";
+  operations[0].m1 = box;
+  operations[0].m2 = box;
+  operations[0].operation = common::MeshCSG::UNION;
+  operations[0].offset = ignition::math::Pose3d(0.5, 0.5, 0.5, 0, 0, 0);
+  operations[1] = operations[0];
+  operations[1].name = "boolean_difference";
+  operations[1].m2 = sphere;
+  operations[1].operation = common::MeshCSG::DIFFERENCE;
+  operations[2] = operations[0];
+  operations[2].name = "boolean_union_copy";
+
+  // Duplicate names are skipped
+  operations.push_back(operations[0]);
+  EXPECT_EQ(3u, meshManager->CreateBooleans(operations));
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    const common::Mesh *mesh = meshManager->GetMesh(operations[i].name);
+    ASSERT_NE(nullptr, mesh);
+    EXPECT_LT(0u, mesh->GetVertexCount());
+  }
+  ExpectSameGeometry(meshManager->GetMesh("boolean_union"),
+      meshManager->GetMesh("boolean_union_copy"));
+
+  // Same as a single operation
+  meshManager->CreateBoolean("boolean_single", box, sphere,
+      common::MeshCSG::DIFFERENCE,
+      ignition::math::Pose3d(0.5, 0.5, 0.5, 0, 0, 0));
+  ExpectSameGeometry(meshManager->GetMesh("boolean_difference"),
+      meshManager->GetMesh("boolean_single"));
+
+  // Created meshes aren't created again
+  EXPECT_EQ(0u, meshManager->CreateBooleans(operations));
+}
 #endif
 
 /////////////////////////////////////////////////
@@ -266,6 +362,34 @@ TEST_F(MeshManager, CreateExtrudedPolylineInvalid)
   EXPECT_TRUE(!common::MeshManager::Instance()->HasMesh(meshName));
 }
 
+/////////////////////////////////////////////////
+TEST_F(MeshManager, Prefetch)
+{
+  common::MeshManager *meshManager = common::MeshManager::Instance();
+  const std::string dae = PROJECT_SOURCE_PATH "/test/data/box_offset.dae";
+  const std::string obj = PROJECT_SOURCE_PATH "/test/data/box.obj";
+  const std::string stl = PROJECT_SOURCE_PATH "/test/data/twoFaces.stl";
+  EXPECT_FALSE(meshManager->HasMesh(dae));
+
+  // Duplicates, missing files and unsupported formats are skipped
+  EXPECT_EQ(3u, meshManager->Prefetch({dae, obj, stl, dae,
+        PROJECT_SOURCE_PATH "/test/data/missing.dae",
+        PROJECT_SOURCE_PATH "/test/data/box.png"}));
+  EXPECT_TRUE(meshManager->HasMesh(dae));
+  EXPECT_TRUE(meshManager->HasMesh(obj));
+  EXPECT_TRUE(meshManager->HasMesh(stl));
+
+  // Load returns the prefetched mesh
+  const common::Mesh *mesh = meshManager->GetMesh(dae);
+  ASSERT_NE(nullptr, mesh);
+  EXPECT_EQ(dae, mesh->GetName());
+  EXPECT_EQ(mesh, meshManager->Load(dae));
+  EXPECT_LT(0u, mesh->GetVertexCount());
+
+  // Loaded meshes aren't loaded again
+  EXPECT_EQ(0u, meshManager->Prefetch({dae, obj}));
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -0,0 +1,390 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshRayTree.hh"
+
+using namespace gazebo;
+using namespace common;
+
+namespace
+{
+  /// \brief Most triangles in a leaf.
+  const unsigned int kLeafSize = 4;
+
+  /// \brief Depth of the traversal stack. Median splits keep the depth
+  /// logarithmic, 64 levels is far more than any mesh needs.
+  const unsigned int kMaxDepth = 64;
+
+  /// \brief Triangle vertices.
+  typedef std::array<ignition::math::Vector3d, 3> Triangle;
+
+  /// \brief Node of the tree. The first child of an inner node follows
+  /// it, the second one is at index second.
+  struct Node
+  {
+    /// \brief Lower corner of the box around the triangles of the node.
+    ignition::math::Vector3d min;
+
+    /// \brief Upper corner of the box around the triangles of the node.
+    ignition::math::Vector3d max;
+
+    /// \brief Index of the first triangle of a leaf, or of the second
+    /// child of an inner node.
+    uint32_t first = 0;
+
+    /// \brief Number of triangles of a leaf, zero for an inner node.
+    uint32_t count = 0;
+  };
+
+  /// \brief Distance at which a ray enters a box.
+  /// \param[in] _origin Origin of the ray.
+  /// \param[in] _invDir Inverse of the direction of the ray.
+  /// \param[in] _node The node with the box.
+  /// \param[in] _maxDistance Farthest distance of interest.
+  /// \param[out] _distance Entry distance, zero if the origin is inside.
+  /// \return True if the ray crosses the box before _maxDistance.
+  bool IntersectBox(const ignition::math::Vector3d &_origin,
+      const ignition::math::Vector3d &_invDir, const Node &_node,
+      const double _maxDistance, double &_distance)
+  {
+    double near = 0.0;
+    double far = _maxDistance;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      double t1 = (_node.min[i] - _origin[i]) * _invDir[i];
+      double t2 = (_node.max[i] - _origin[i]) * _invDir[i];
+      if (t1 > t2)
+        std::swap(t1, t2);
+      // NaN from 0 * inf, a ray along a face, leaves the bounds alone
+      if (t1 > near)
+        near = t1;
+      if (t2 < far)
+        far = t2;
+      if (near > far)
+        return false;
+    }
+    _distance = near;
+    return true;
+  }
+
+  /// \brief Intersection of a ray with a triangle, see Moller and
+  /// Trumbore, Fast, Minimum Storage Ray/Triangle Intersection.
+  /// \param[in] _origin Origin of the ray.
+  /// \param[in] _dir Direction of the ray.
+  /// \param[in] _t The triangle.
+  /// \param[in] _backFacing True to hit the back of the triangle, false
+  /// for its front.
+  /// \param[out] _distance Distance to the hit.
+  /// \return True if the triangle is hit at a positive distance.
+  bool IntersectTriangle(const ignition::math::Vector3d &_origin,
+      const ignition::math::Vector3d &_dir, const Triangle &_t,
+      const bool _backFacing, double &_distance)
+  {
+    const ignition::math::Vector3d e1 = _t[1] - _t[0];
+    const ignition::math::Vector3d e2 = _t[2] - _t[0];
+    const ignition::math::Vector3d p = _dir.Cross(e2);
+    const double det = e1.Dot(p);
+
+    // The front faces a ray with a positive determinant
+    if (_backFacing ? det >= 0.0 : det <= 0.0)
+      return false;
+
+    const double invDet = 1.0 / det;
+    const ignition::math::Vector3d s = _origin - _t[0];
+    const double u = s.Dot(p) * invDet;
+    if (u < 0.0 || u > 1.0)
+      return false;
+
+    const ignition::math::Vector3d q = s.Cross(e1);
+    const double v = _dir.Dot(q) * invDet;
+    if (v < 0.0 || u + v > 1.0)
+      return false;
+
+    _distance = e2.Dot(q) * invDet;
+    return _distance >= 0.0;
+  }
+}
+
+/// \brief Private data for MeshRayTree.
+class gazebo::common::MeshRayTreePrivate
+{
+  /// \brief Build the nodes over a range of triangles.
+  /// \param[in] _begin First triangle of the range.
+  /// \param[in] _end End of the range.
+  /// \param[in] _centroids Centroids of the triangles.
+  public: void BuildNode(const uint32_t _begin, const uint32_t _end,
+              const std::vector<ignition::math::Vector3d> &_centroids)
+  {
+    const size_t index = this->nodes.size();
+    this->nodes.push_back(Node());
+
+    ignition::math::Vector3d min = this->triangles[_begin][0];
+    ignition::math::Vector3d max = min;
+    ignition::math::Vector3d cmin = _centroids[this->order[_begin]];
+    ignition::math::Vector3d cmax = cmin;
+    for (uint32_t i = _begin; i < _end; ++i)
+    {
+      for (const auto &v : this->triangles[i])
+      {
+        min.Min(v);
+        max.Max(v);
+      }
+      cmin.Min(_centroids[this->order[i]]);
+      cmax.Max(_centroids[this->order[i]]);
+    }
+    this->nodes[index].min = min;
+    this->nodes[index].max = max;
+
+    const ignition::math::Vector3d extent = cmax - cmin;
+    if (_end - _begin <= kLeafSize || extent == ignition::math::Vector3d::Zero)
+    {
+      this->nodes[index].first = _begin;
+      this->nodes[index].count = _end - _begin;
+      return;
+    }
+
+    // Split at the median centroid along the largest extent
+    unsigned int axis = 0;
+    if (extent.Y() > extent[axis])
+      axis = 1;
+    if (extent.Z() > extent[axis])
+      axis = 2;
+
+    const uint32_t mid = _begin + (_end - _begin) / 2;
+    std::vector<uint32_t> range(this->order.begin() + _begin,
+        this->order.begin() + _end);
+    std::nth_element(range.begin(), range.begin() + (mid - _begin),
+        range.end(), [&](const uint32_t _a, const uint32_t _b)
+        {
+          return _centroids[_a][axis] < _centroids[_b][axis];
+        });
+
+    std::vector<Triangle> sorted;
+    sorted.reserve(range.size());
+    for (const uint32_t i : range)
+      sorted.push_back(this->source[i]);
+    std::copy(sorted.begin(), sorted.end(), this->triangles.begin() + _begin);
+    std::copy(range.begin(), range.end(), this->order.begin() + _begin);
+
+    this->BuildNode(_begin, mid, _centroids);
+    this->nodes[index].first = static_cast<uint32_t>(this->nodes.size());
+    this->BuildNode(mid, _end, _centroids);
+  }
+
+  /// \brief Triangles, ordered so that each leaf has a range of them.
+  public: std::vector<Triangle> triangles;
+
+  /// \brief Nodes, the root first.
+  public: std::vector<Node> nodes;
+
+  /// \brief Triangles in input order, only used while building.
+  public: std::vector<Triangle> source;
+
+  /// \brief Input index of each triangle, only used while building.
+  public: std::vector<uint32_t> order;
+};
+
+//////////////////////////////////////////////////
+MeshRayTree::MeshRayTree()
+  : dataPtr(new MeshRayTreePrivate)
+{
+}
+
+//////////////////////////////////////////////////
+MeshRayTree::~MeshRayTree()
+{
+}
+
+//////////////////////////////////////////////////
+bool MeshRayTree::Build(const Mesh &_mesh)
+{
+  std::vector<ignition::math::Vector3d> vertices;
+  std::vector<unsigned int> indices;
+  for (unsigned int i = 0; i < _mesh.GetSubMeshCount(); ++i)
+  {
+    const SubMesh *subMesh = _mesh.GetSubMesh(i);
+    if (subMesh->GetPrimitiveType() != SubMesh::TRIANGLES)
+      continue;
+
+    const unsigned int offset = static_cast<unsigned int>(vertices.size());
+    for (unsigned int j = 0; j < subMesh->GetVertexCount(); ++j)
+      vertices.push_back(subMesh->Vertex(j));
+    for (unsigned int j = 0; j + 2 < subMesh->GetIndexCount(); j += 3)
+    {
+      for (unsigned int v = 0; v < 3; ++v)
+        indices.push_back(offset + subMesh->GetIndex(j + v));
+    }
+  }
+
+  return this->Build(vertices, indices);
+}
+
+//////////////////////////////////////////////////
+bool MeshRayTree::Build(const std::vector<ignition::math::Vector3d> &_vertices,
+    const std::vector<unsigned int> &_indices)
+{
+  this->dataPtr->triangles.clear();
+  this->dataPtr->nodes.clear();
+
+  std::vector<Triangle> &source = this->dataPtr->source;
+  source.clear();
+  source.reserve(_indices.size() / 3);
+  for (size_t i = 0; i + 2 < _indices.size(); i += 3)
+  {
+    if (_indices[i] >= _vertices.size() ||
+        _indices[i + 1] >= _vertices.size() ||
+        _indices[i + 2] >= _vertices.size())
+    {
+      continue;
+    }
+
+    source.push_back({{_vertices[_indices[i]], _vertices[_indices[i + 1]],
+        _vertices[_indices[i + 2]]}});
+  }
+
+  if (source.empty())
+    return false;
+
+  std::vector<ignition::math::Vector3d> centroids;
+  centroids.reserve(source.size());
+  this->dataPtr->order.resize(source.size());
+  for (uint32_t i = 0; i < source.size(); ++i)
+  {
+    centroids.push_back((source[i][0] + source[i][1] + source[i][2]) / 3.0);
+    this->dataPtr->order[i] = i;
+  }
+
+  this->dataPtr->triangles = source;
+  this->dataPtr->nodes.reserve(2 * source.size() / kLeafSize + 1);
+  this->dataPtr->BuildNode(0, static_cast<uint32_t>(source.size()),
+      centroids);
+
+  std::vector<Triangle>().swap(this->dataPtr->source);
+  std::vector<uint32_t>().swap(this->dataPtr->order);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool MeshRayTree::Intersect(const ignition::math::Vector3d &_origin,
+    const ignition::math::Vector3d &_dir, double &_distance,
+    ignition::math::Triangle3d &_triangle, const double _maxDistance,
+    const bool _backFacing) const
+{
+  const std::vector<Node> &nodes = this->dataPtr->nodes;
+  if (nodes.empty() || _dir == ignition::math::Vector3d::Zero)
+    return false;
+
+  // Division by zero gives the infinities the slab test expects
+  const ignition::math::Vector3d invDir(1.0 / _dir.X(), 1.0 / _dir.Y(),
+      1.0 / _dir.Z());
+
+  double best = _maxDistance;
+  const Triangle *hit = nullptr;
+
+  std::array<uint32_t, kMaxDepth> stack;
+  unsigned int depth = 0;
+  double entry;
+  if (!IntersectBox(_origin, invDir, nodes[0], best, entry))
+    return false;
+  stack[depth++] = 0;
+
+  while (depth > 0)
+  {
+    const Node &node = nodes[stack[--depth]];
+    if (!IntersectBox(_origin, invDir, node, best, entry))
+      continue;
+
+    if (node.count > 0)
+    {
+      for (uint32_t i = node.first; i < node.first + node.count; ++i)
+      {
+        double distance;
+        if (IntersectTriangle(_origin, _dir, this->dataPtr->triangles[i],
+              _backFacing, distance) && distance <= best)
+        {
+          best = distance;
+          hit = &this->dataPtr->triangles[i];
+        }
+      }
+      continue;
+    }
+
+    // Visit the nearest child first, so that the farther one is more
+    // likely to be pruned.
+    uint32_t first = static_cast<uint32_t>(&node - &nodes[0]) + 1;
+    uint32_t second = node.first;
+    double firstEntry, secondEntry;
+    const bool firstHit =
+        IntersectBox(_origin, invDir, nodes[first], best, firstEntry);
+    const bool secondHit =
+        IntersectBox(_origin, invDir, nodes[second], best, secondEntry);
+    if (firstHit && secondHit && secondEntry < firstEntry)
+      std::swap(first, second);
+
+    if (depth + 2 > kMaxDepth)
+      continue;
+    if (firstHit && secondHit)
+    {
+      stack[depth++] = second;
+      stack[depth++] = first;
+    }
+    else if (firstHit)
+    {
+      stack[depth++] = first;
+    }
+    else if (secondHit)
+    {
+      stack[depth++] = second;
+    }
+  }
+
+  if (!hit)
+    return false;
+
+  _distance = best;
+  _triangle.Set((*hit)[0], (*hit)[1], (*hit)[2]);
+  return true;
+}
+
+//////////////////////////////////////////////////
+ignition::math::AxisAlignedBox MeshRayTree::Box() const
+{
+  if (this->dataPtr->nodes.empty())
+    return ignition::math::AxisAlignedBox();
+
+  return ignition::math::AxisAlignedBox(this->dataPtr->nodes[0].min,
+      this->dataPtr->nodes[0].max);
+}
+
+//////////////////////////////////////////////////
+unsigned int MeshRayTree::TriangleCount() const
+{
+  return static_cast<unsigned int>(this->dataPtr->triangles.size());
+}
+
+//////////////////////////////////////////////////
+bool MeshRayTree::Empty() const
+{
+  return this->dataPtr->nodes.empty();
+}
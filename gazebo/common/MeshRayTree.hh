@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_MESHRAYTREE_HH_
+#define GAZEBO_COMMON_MESHRAYTREE_HH_
+
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Triangle3.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    class Mesh;
+    class MeshRayTreePrivate;
+
+    /// \addtogroup gazebo_common Common
+    /// \{
+
+    /// \class MeshRayTree MeshRayTree.hh common/common.hh
+    /// \brief Bounding volume hierarchy of the triangles of a mesh, to
+    /// find the first triangle hit by a ray without testing all of them.
+    ///
+    /// The tree is built in the frame of the mesh. Rays in another frame
+    /// are transformed into it by the caller, so that a moving or scaled
+    /// mesh is queried without transforming its vertices.
+    class GZ_COMMON_VISIBLE MeshRayTree
+    {
+      /// \brief Constructor, the tree is empty.
+      public: MeshRayTree();
+
+      /// \brief Destructor.
+      public: ~MeshRayTree();
+
+      /// \brief Build the tree from the triangle lists of a mesh.
+      /// \param[in] _mesh The mesh.
+      /// \return False if the mesh has no triangles.
+      public: bool Build(const Mesh &_mesh);
+
+      /// \brief Build the tree from a triangle list.
+      /// \param[in] _vertices The vertices.
+      /// \param[in] _indices Three indices of _vertices per triangle.
+      /// Triangles with an index out of range are skipped.
+      /// \return False if there are no triangles.
+      public: bool Build(const std::vector<ignition::math::Vector3d> &_vertices,
+                  const std::vector<unsigned int> &_indices);
+
+      /// \brief Find the first triangle hit by a ray. Only the front of
+      /// the triangles, the side their vertices are counter clockwise
+      /// from, is hit.
+      /// \param[in] _origin Origin of the ray.
+      /// \param[in] _dir Direction of the ray, which doesn't need to be
+      /// normalized.
+      /// \param[out] _distance Distance to the hit, in lengths of _dir, so
+      /// that the hit point is _origin + _dir * _distance.
+      /// \param[out] _triangle The triangle hit.
+      /// \param[in] _maxDistance Hits farther than this are ignored, in
+      /// lengths of _dir.
+      /// \param[in] _backFacing True to hit the back of the triangles
+      /// instead, e.g. when the ray comes from a mirroring transform.
+      /// \return True if a triangle is hit.
+      public: bool Intersect(const ignition::math::Vector3d &_origin,
+                  const ignition::math::Vector3d &_dir, double &_distance,
+                  ignition::math::Triangle3d &_triangle,
+                  const double _maxDistance =
+                  std::numeric_limits<double>::max(),
+                  const bool _backFacing = false) const;
+
+      /// \brief Get the box around the triangles.
+      /// \return The box, with no volume if the tree is empty.
+      public: ignition::math::AxisAlignedBox Box() const;
+
+      /// \brief Get the number of triangles in the tree.
+      /// \return The number of triangles.
+      public: unsigned int TriangleCount() const;
+
+      /// \brief Get whether the tree has been built.
+      /// \return True if the tree is empty.
+      public: bool Empty() const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<MeshRayTreePrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshManager.hh"
+#include "gazebo/common/MeshRayTree.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class MeshRayTreeTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(MeshRayTreeTest, Box)
+{
+  common::MeshManager *manager = common::MeshManager::Instance();
+  const common::Mesh *box = manager->GetMesh("unit_box");
+  ASSERT_TRUE(box != nullptr);
+
+  double distance;
+  ignition::math::Triangle3d triangle;
+
+  common::MeshRayTree tree;
+  EXPECT_TRUE(tree.Empty());
+  EXPECT_FALSE(tree.Build(common::Mesh()));
+  EXPECT_FALSE(tree.Intersect(ignition::math::Vector3d(2, 0, 0),
+        -ignition::math::Vector3d::UnitX, distance, triangle));
+
+  ASSERT_TRUE(tree.Build(*box));
+  EXPECT_FALSE(tree.Empty());
+  EXPECT_EQ(tree.TriangleCount(), 12u);
+  EXPECT_EQ(tree.Box().Min(), ignition::math::Vector3d(-0.5, -0.5, -0.5));
+  EXPECT_EQ(tree.Box().Max(), ignition::math::Vector3d(0.5, 0.5, 0.5));
+
+  // The distance is in lengths of the direction
+  ASSERT_TRUE(tree.Intersect(ignition::math::Vector3d(2, 0.1, 0.2),
+        -ignition::math::Vector3d::UnitX, distance, triangle));
+  EXPECT_DOUBLE_EQ(distance, 1.5);
+  EXPECT_DOUBLE_EQ(triangle[0].X(), 0.5);
+  EXPECT_DOUBLE_EQ(triangle[1].X(), 0.5);
+  EXPECT_DOUBLE_EQ(triangle[2].X(), 0.5);
+  ASSERT_TRUE(tree.Intersect(ignition::math::Vector3d(0.1, 0.2, 3),
+        ignition::math::Vector3d(0, 0, -2), distance, triangle));
+  EXPECT_DOUBLE_EQ(distance, 1.25);
+
+  // Misses, hits past the maximum distance and behind the origin
+  EXPECT_FALSE(tree.Intersect(ignition::math::Vector3d(2, 0.6, 0),
+        -ignition::math::Vector3d::UnitX, distance, triangle));
+  EXPECT_FALSE(tree.Intersect(ignition::math::Vector3d(2, 0, 0),
+        -ignition::math::Vector3d::UnitX, distance, triangle, 1.0));
+  EXPECT_FALSE(tree.Intersect(ignition::math::Vector3d(2, 0, 0),
+        ignition::math::Vector3d::UnitX, distance, triangle));
+
+  // From inside, only the backs of the faces are in sight
+  EXPECT_FALSE(tree.Intersect(ignition::math::Vector3d::Zero,
+        ignition::math::Vector3d::UnitX, distance, triangle));
+  ASSERT_TRUE(tree.Intersect(ignition::math::Vector3d::Zero,
+        ignition::math::Vector3d::UnitX, distance, triangle,
+        std::numeric_limits<double>::max(), true));
+  EXPECT_DOUBLE_EQ(distance, 0.5);
+
+  // The manager keeps the trees of its meshes
+  const common::MeshRayTree *cached = manager->RayTree(box);
+  ASSERT_TRUE(cached != nullptr);
+  EXPECT_EQ(cached, manager->RayTree(box));
+  EXPECT_EQ(cached->TriangleCount(), 12u);
+  common::Mesh unowned;
+  unowned.SetName("unit_box");
+  EXPECT_TRUE(manager->RayTree(&unowned) == nullptr);
+  EXPECT_TRUE(manager->RayTree(nullptr) == nullptr);
+}
+
+/////////////////////////////////////////////////
+TEST_F(MeshRayTreeTest, Triangles)
+{
+  // A grid of triangles facing up, and one with an invalid index
+  std::vector<ignition::math::Vector3d> vertices;
+  std::vector<unsigned int> indices;
+  const unsigned int n = 32;
+  for (unsigned int i = 0; i <= n; ++i)
+  {
+    for (unsigned int j = 0; j <= n; ++j)
+      vertices.push_back(ignition::math::Vector3d(i, j, 0.1 * i));
+  }
+  for (unsigned int i = 0; i < n; ++i)
+  {
+    for (unsigned int j = 0; j < n; ++j)
+    {
+      const unsigned int a = i * (n + 1) + j;
+      const unsigned int b = a + n + 1;
+      indices.insert(indices.end(), {a, b, b + 1, a, b + 1, a + 1});
+    }
+  }
+  indices.insert(indices.end(), {0, 1, 100000});
+
+  common::MeshRayTree tree;
+  ASSERT_TRUE(tree.Build(vertices, indices));
+  EXPECT_EQ(tree.TriangleCount(), 2 * n * n);
+
+  double distance;
+  ignition::math::Triangle3d triangle;
+  for (double x = 0.25; x < n; x += 1.5)
+  {
+    const double y = std::fmod(x * 7.0, n);
+    ASSERT_TRUE(tree.Intersect(ignition::math::Vector3d(x, y, 10),
+          -ignition::math::Vector3d::UnitZ, distance, triangle));
+    EXPECT_NEAR(distance, 10 - 0.1 * x, 1e-9);
+    EXPECT_TRUE(triangle.Contains(ignition::math::Vector3d(x, y, 0.1 * x)));
+
+    // Upwards the rays see the backs
+    EXPECT_FALSE(tree.Intersect(ignition::math::Vector3d(x, y, -10),
+          ignition::math::Vector3d::UnitZ, distance, triangle));
+  }
+  EXPECT_FALSE(tree.Intersect(ignition::math::Vector3d(-1, 2, 10),
+        -ignition::math::Vector3d::UnitZ, distance, triangle));
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -297,6 +297,49 @@ TEST_F(MeshTest, SubMeshCenter)
   EXPECT_EQ(ignition::math::Vector3d(3.46555, 0.180391, 2.8431), mesh->Min());
 }
 
+/////////////////////////////////////////////////
+// Test filling single precision vertex buffers from a submesh.
+TEST_F(MeshTest, SubMeshFillBuffer)
+{
+  common::SubMesh submesh;
+  submesh.AddVertex(ignition::math::Vector3d(1, 2, 3));
+  submesh.AddVertex(ignition::math::Vector3d(4, 5, 6));
+  submesh.AddIndex(1);
+  submesh.AddIndex(0);
+
+  // Positions only
+  common::SubMeshBuffer buffer;
+  submesh.FillBuffer(buffer);
+  EXPECT_EQ(2u, buffer.vertexCount);
+  EXPECT_FALSE(buffer.hasNormals);
+  EXPECT_EQ(3u, buffer.Stride());
+  ASSERT_EQ(6u, buffer.vertices.size());
+  EXPECT_FLOAT_EQ(4.0f, buffer.vertices[3]);
+  EXPECT_TRUE(buffer.texCoords.empty());
+  ASSERT_EQ(2u, buffer.indices.size());
+  EXPECT_EQ(1u, buffer.indices[0]);
+  EXPECT_EQ(0u, buffer.indices[1]);
+
+  // Normals are interleaved with the positions, which are offset. The
+  // vertex without a normal or texture coordinate gets zeros.
+  submesh.AddNormal(ignition::math::Vector3d(0, 0, 1));
+  submesh.AddTexCoord(0.25, 0.75);
+  submesh.FillBuffer(buffer, ignition::math::Vector3d(-1, -1, -1));
+  EXPECT_TRUE(buffer.hasNormals);
+  EXPECT_EQ(6u, buffer.Stride());
+  ASSERT_EQ(12u, buffer.vertices.size());
+  const float expected[] = {0, 1, 2, 0, 0, 1, 3, 4, 5, 0, 0, 0};
+  for (unsigned int i = 0; i < 12u; ++i)
+    EXPECT_FLOAT_EQ(expected[i], buffer.vertices[i]);
+  ASSERT_EQ(4u, buffer.texCoords.size());
+  EXPECT_FLOAT_EQ(0.25f, buffer.texCoords[0]);
+  EXPECT_FLOAT_EQ(0.75f, buffer.texCoords[1]);
+  EXPECT_FLOAT_EQ(0.0f, buffer.texCoords[3]);
+
+  // The submesh doesn't change
+  EXPECT_EQ(ignition::math::Vector3d(1, 2, 3), submesh.Vertex(0));
+}
+
 /////////////////////////////////////////////////
 // Test STL import
 TEST_F(MeshTest, STLRead)
@@ -22,9 +22,15 @@
 #include <curl/curl.h>
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <algorithm>
+#include <deque>
+#include <fstream>
 #include <iostream>
+#include <thread>
 
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string/replace.hpp>
+#include <boost/algorithm/string/trim.hpp>
 #include <boost/bind.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/function.hpp>
@@ -37,6 +43,7 @@
 #include "gazebo/common/Time.hh"
 #include "gazebo/common/SystemPaths.hh"
 #include "gazebo/common/Console.hh"
+#include "gazebo/common/FuelModelDatabase.hh"
 #include "gazebo/common/ModelDatabasePrivate.hh"
 #include "gazebo/common/ModelDatabase.hh"
 #include "gazebo/common/SemanticVersion.hh"
@@ -65,11 +72,282 @@ size_t get_models_cb(void *_buffer, size_t _size, size_t _nmemb, void *_userp)
   return _size;
 }
 
+/////////////////////////////////////////////////
+/// \brief Curl callback that keeps the ETag of a response.
+static size_t etag_cb(char *_buffer, size_t _size, size_t _nitems,
+    void *_userp)
+{
+  const size_t size = _size * _nitems;
+  const std::string header(_buffer, size);
+  if (boost::istarts_with(header, "etag:"))
+    *static_cast<std::string*>(_userp) = boost::trim_copy(header.substr(5));
+  return size;
+}
+
+/////////////////////////////////////////////////
+/// \brief Curl callback that locks the data of a share.
+static void lock_share_cb(CURL * /*_handle*/, curl_lock_data _data,
+    curl_lock_access /*_access*/, void *_userp)
+{
+  static_cast<ModelDatabasePrivate*>(_userp)->shareMutexes[_data].lock();
+}
+
+/////////////////////////////////////////////////
+/// \brief Curl callback that unlocks the data of a share.
+static void unlock_share_cb(CURL * /*_handle*/, curl_lock_data _data,
+    void *_userp)
+{
+  static_cast<ModelDatabasePrivate*>(_userp)->shareMutexes[_data].unlock();
+}
+
+/////////////////////////////////////////////////
+/// \brief Number of models downloaded at the same time.
+/// \return The number of models.
+static unsigned int DownloadThreads()
+{
+  static const unsigned int threads = []() -> unsigned int
+  {
+    const char *env = getenv("GAZEBO_MODEL_DOWNLOAD_THREADS");
+    if (env)
+    {
+      try
+      {
+        return std::max(1, std::stoi(env));
+      }
+      catch(...)
+      {
+        gzwarn << "Invalid GAZEBO_MODEL_DOWNLOAD_THREADS[" << env
+               << "], downloading one model at a time.\n";
+        return 1;
+      }
+    }
+    return 8;
+  }();
+
+  return threads;
+}
+
+/////////////////////////////////////////////////
+/// \brief Download a model tarball and extract it in ~/.gazebo/models.
+/// \param[in] _dataPtr Data of the model database.
+/// \param[in] _url URL of the tarball.
+/// \param[in] _modelName Name of the model.
+/// \param[in] _revalidate True to keep the installed model if the ETag
+/// of the tarball didn't change.
+/// \return Path to the installed model, empty on error.
+static std::string InstallModel(ModelDatabasePrivate *_dataPtr,
+    const std::string &_url, const std::string &_modelName, bool _revalidate)
+{
+  const char *home = getenv("HOME");
+  if (!home)
+  {
+    gzerr << "Could not download model[" << _url << "] because HOME "
+          << "isn't set.\n";
+    return std::string();
+  }
+  const std::string outputPath = std::string(home) + "/.gazebo/models";
+  const std::string modelPath = outputPath + "/" + _modelName;
+  const std::string etagFilename = modelPath + "/.etag";
+
+  // The ETag of the installed tarball
+  std::string etag;
+  if (_revalidate)
+  {
+    std::ifstream etagFile(etagFilename);
+    std::getline(etagFile, etag);
+  }
+
+  // Store downloaded .tar.gz and intermediate .tar files in temp location
+  boost::filesystem::path tmppath = boost::filesystem::temp_directory_path();
+  tmppath /= boost::filesystem::unique_path("gz_model-%%%%-%%%%-%%%%-%%%%");
+  std::string tarfilename = tmppath.string() + ".tar";
+  std::string tgzfilename = tarfilename + ".gz";
+
+  CURL *curl = _dataPtr->AcquireHandle();
+  if (!curl)
+  {
+    gzerr << "Unable to initialize libcurl\n";
+    return std::string();
+  }
+
+  std::string newEtag;
+  curl_easy_setopt(curl, CURLOPT_URL, _url.c_str());
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_data);
+  curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, etag_cb);
+  curl_easy_setopt(curl, CURLOPT_HEADERDATA, &newEtag);
+
+  struct curl_slist *headers = nullptr;
+  if (!etag.empty())
+  {
+    headers = curl_slist_append(headers, ("If-None-Match: " + etag).c_str());
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+  }
+
+  std::string path;
+  bool retry = true;
+  int iterations = 0;
+  while (retry && iterations < 4)
+  {
+    retry = false;
+    iterations++;
+
+    FILE *fp = fopen(tgzfilename.c_str(), "wb");
+    if (!fp)
+    {
+      gzerr << "Could not download model[" << _url << "] because we were"
+        << "unable to write to file[" << tgzfilename << "]."
+        << "Please fix file permissions.";
+      retry = true;
+      break;
+    }
+
+    /// Download the model tarball
+    newEtag.clear();
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, fp);
+    CURLcode success = curl_easy_perform(curl);
+    fclose(fp);
+
+    if (success != CURLE_OK)
+    {
+      gzwarn << "Unable to connect to model database using ["
+             << _url << "]\n";
+      retry = true;
+      continue;
+    }
+
+    long responseCode = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &responseCode);
+    if (responseCode == 304)
+    {
+      // The installed model is up to date
+      path = modelPath;
+      break;
+    }
+    else if (responseCode >= 400)
+    {
+      gzerr << "Model database returned HTTP error[" << responseCode
+            << "] for [" << _url << "]\n";
+      retry = true;
+      break;
+    }
+
+    try
+    {
+      // Unzip model tarball
+      std::ifstream file(tgzfilename.c_str(),
+          std::ios_base::in | std::ios_base::binary);
+      std::ofstream out(tarfilename.c_str(),
+          std::ios_base::out | std::ios_base::binary);
+      boost::iostreams::filtering_streambuf<boost::iostreams::input> in;
+      in.push(boost::iostreams::gzip_decompressor());
+      in.push(file);
+      boost::iostreams::copy(in, out);
+    }
+    catch(...)
+    {
+      gzerr << "Failed to unzip model tarball. Trying again...\n";
+      retry = true;
+      continue;
+    }
+
+#ifndef _WIN32
+    TAR *tar;
+    if (tar_open(&tar, const_cast<char*>(tarfilename.c_str()),
+          nullptr, O_RDONLY, 0644, TAR_GNU) != 0)
+    {
+      gzerr << "Failed to open model tarball. Trying again...\n";
+      retry = true;
+      continue;
+    }
+
+    tar_extract_all(tar, const_cast<char*>(outputPath.c_str()));
+    tar_close(tar);
+    path = modelPath;
+
+    if (!newEtag.empty())
+    {
+      std::ofstream etagFile(etagFilename);
+      etagFile << newEtag << "\n";
+    }
+#endif
+  }
+
+  curl_easy_setopt(curl, CURLOPT_HTTPHEADER, nullptr);
+  curl_slist_free_all(headers);
+  _dataPtr->ReleaseHandle(curl);
+
+  if (retry)
+  {
+    gzerr << "Could not download model[" << _url << "]."
+      << "The model may be corrupt.\n";
+    path.clear();
+  }
+
+  // Clean up
+  try
+  {
+    boost::filesystem::remove(tarfilename);
+    boost::filesystem::remove(tgzfilename);
+  }
+  catch(...)
+  {
+    gzwarn << "Failed to remove temporary model files after download.";
+  }
+
+  return path;
+}
+
+/////////////////////////////////////////////////
+CURL *ModelDatabasePrivate::AcquireHandle()
+{
+  CURL *handle = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(this->handlesMutex);
+    if (!this->handles.empty())
+    {
+      handle = this->handles.back();
+      this->handles.pop_back();
+    }
+  }
+
+  // Resetting keeps the connections of the handle
+  if (handle)
+    curl_easy_reset(handle);
+  else if ((handle = curl_easy_init()) == nullptr)
+    return nullptr;
+
+  if (this->share)
+    curl_easy_setopt(handle, CURLOPT_SHARE, this->share);
+  return handle;
+}
+
+/////////////////////////////////////////////////
+void ModelDatabasePrivate::ReleaseHandle(CURL *_handle)
+{
+  std::lock_guard<std::mutex> lock(this->handlesMutex);
+  this->handles.push_back(_handle);
+}
+
 /////////////////////////////////////////////////
 ModelDatabase::ModelDatabase()
   : dataPtr(new ModelDatabasePrivate)
 {
   this->dataPtr->updateCacheThread = nullptr;
+
+  this->dataPtr->share = curl_share_init();
+  if (this->dataPtr->share)
+  {
+    CURLSH *share = this->dataPtr->share;
+    curl_share_setopt(share, CURLSHOPT_LOCKFUNC, lock_share_cb);
+    curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, unlock_share_cb);
+    curl_share_setopt(share, CURLSHOPT_USERDATA, this->dataPtr);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+#if LIBCURL_VERSION_NUM >= 0x073900
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+#endif
+  }
+
   this->Start();
 }
 
@@ -77,6 +355,12 @@ ModelDatabase::ModelDatabase()
 ModelDatabase::~ModelDatabase()
 {
   this->Fini();
+
+  for (auto handle : this->dataPtr->handles)
+    curl_easy_cleanup(handle);
+  if (this->dataPtr->share)
+    curl_share_cleanup(this->dataPtr->share);
+
   delete this->dataPtr;
   this->dataPtr = nullptr;
 }
@@ -200,7 +484,12 @@ std::string ModelDatabase::GetManifestImpl(const std::string &_uri)
   std::string xmlString;
   if (!_uri.empty())
   {
-    CURL *curl = curl_easy_init();
+    CURL *curl = this->dataPtr->AcquireHandle();
+    if (!curl)
+    {
+      gzerr << "Unable to initialize libcurl\n";
+      return xmlString;
+    }
     curl_easy_setopt(curl, CURLOPT_URL, _uri.c_str());
 
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, get_models_cb);
@@ -213,7 +502,7 @@ std::string ModelDatabase::GetManifestImpl(const std::string &_uri)
         << "]. Only locally installed models will be available.\n";
     }
 
-    curl_easy_cleanup(curl);
+    this->dataPtr->ReleaseHandle(curl);
   }
 
   return xmlString;
@@ -400,6 +689,18 @@ std::string ModelDatabase::GetModelName(const std::string &_uri)
 std::string ModelDatabase::GetModelPath(const std::string &_uri,
                                         bool _forceDownload)
 {
+  std::string downloaded;
+  const std::string path = this->ModelPath(_uri, _forceDownload, downloaded);
+  if (!downloaded.empty())
+    this->DownloadDependencies(downloaded);
+  return path;
+}
+
+/////////////////////////////////////////////////
+std::string ModelDatabase::ModelPath(const std::string &_uri,
+    bool _forceDownload, std::string &_downloaded)
+{
+  _downloaded.clear();
   std::string path, suffix;
 
   if (!_forceDownload)
@@ -407,143 +708,214 @@ std::string ModelDatabase::GetModelPath(const std::string &_uri,
 
   struct stat st;
 
-  if (path.empty() || stat(path.c_str(), &st) != 0 )
+  if (!path.empty() && stat(path.c_str(), &st) == 0)
+    return path;
+
+  if (!ModelDatabase::HasModel(_uri))
   {
-    if (!ModelDatabase::HasModel(_uri))
-    {
-      return std::string();
-    }
+    return std::string();
+  }
 
-    // Get the model name from the uri
-    size_t startIndex = _uri.find_first_of("://");
-    if (startIndex == std::string::npos)
-    {
-      gzerr << "URI[" << _uri << "] is missing ://\n";
-      return std::string();
-    }
+  // Get the model name from the uri
+  size_t startIndex = _uri.find_first_of("://");
+  if (startIndex == std::string::npos)
+  {
+    gzerr << "URI[" << _uri << "] is missing ://\n";
+    return std::string();
+  }
 
-    std::string modelName = _uri;
-    boost::replace_first(modelName, "model://", "");
-    boost::replace_first(modelName, ModelDatabase::GetURI(), "");
+  std::string modelName = _uri;
+  boost::replace_first(modelName, "model://", "");
+  boost::replace_first(modelName, ModelDatabase::GetURI(), "");
 
-    startIndex = modelName[0] == '/' ? 1 : 0;
-    size_t endIndex = modelName.find_first_of("/", startIndex);
-    size_t modelNameLen = endIndex == std::string::npos ? std::string::npos :
-      endIndex - startIndex;
+  startIndex = modelName[0] == '/' ? 1 : 0;
+  size_t endIndex = modelName.find_first_of("/", startIndex);
+  size_t modelNameLen = endIndex == std::string::npos ? std::string::npos :
+    endIndex - startIndex;
 
-    if (endIndex != std::string::npos)
-      suffix = modelName.substr(endIndex, std::string::npos);
+  if (endIndex != std::string::npos)
+    suffix = modelName.substr(endIndex, std::string::npos);
 
-    modelName = modelName.substr(startIndex, modelNameLen);
+  modelName = modelName.substr(startIndex, modelNameLen);
 
-    // Store downloaded .tar.gz and intermediate .tar files in temp location
-    boost::filesystem::path tmppath = boost::filesystem::temp_directory_path();
-    tmppath /= boost::filesystem::unique_path("gz_model-%%%%-%%%%-%%%%-%%%%");
-    std::string tarfilename = tmppath.string() + ".tar";
-    std::string tgzfilename = tarfilename + ".gz";
+  path = this->FetchModel(modelName, _forceDownload);
+  if (path.empty())
+    return std::string();
 
-    CURL *curl = curl_easy_init();
-    if (!curl)
+  _downloaded = path;
+  return path + suffix;
+}
+
+/////////////////////////////////////////////////
+std::string ModelDatabase::FetchModel(const std::string &_modelName,
+    bool _revalidate)
+{
+  {
+    std::unique_lock<std::mutex> lock(this->dataPtr->downloadMutex);
+    if (this->dataPtr->downloading.count(_modelName))
     {
-      gzerr << "Unable to initialize libcurl\n";
+      // Another thread is downloading the model, use its result
+      this->dataPtr->downloadCondition.wait(lock, [&]
+      {
+        return this->dataPtr->downloading.count(_modelName) == 0;
+      });
+
+      const char *home = getenv("HOME");
+      boost::filesystem::path path = std::string(home ? home : "");
+      path = path / ".gazebo" / "models" / _modelName;
+      if (home && boost::filesystem::exists(path / GZ_MODEL_MANIFEST_FILENAME))
+        return path.string();
       return std::string();
     }
+    this->dataPtr->downloading.insert(_modelName);
+  }
 
-    curl_easy_setopt(curl, CURLOPT_URL,
-        (ModelDatabase::GetURI() + "/" +
-         modelName + "/model.tar.gz").c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_data);
-
-    bool retry = true;
-    int iterations = 0;
-    while (retry && iterations < 4)
-    {
-      retry = false;
-      iterations++;
+  const std::string path = InstallModel(this->dataPtr,
+      ModelDatabase::GetURI() + "/" + _modelName + "/model.tar.gz",
+      _modelName, _revalidate);
 
-      FILE *fp = fopen(tgzfilename.c_str(), "wb");
-      if (!fp)
-      {
-        gzerr << "Could not download model[" << _uri << "] because we were"
-          << "unable to write to file[" << tgzfilename << "]."
-          << "Please fix file permissions.";
-        return std::string();
-      }
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->downloadMutex);
+    this->dataPtr->downloading.erase(_modelName);
+  }
+  this->dataPtr->downloadCondition.notify_all();
 
-      /// Download the model tarball
-      curl_easy_setopt(curl, CURLOPT_WRITEDATA, fp);
-      CURLcode success = curl_easy_perform(curl);
+  return path;
+}
 
-      if (success != CURLE_OK)
+/////////////////////////////////////////////////
+std::vector<std::string> ModelDatabase::DownloadModels(
+    const std::vector<std::string> &_uris)
+{
+  // Models to resolve, and the ones already queued
+  std::deque<std::string> queue(_uris.begin(), _uris.end());
+  std::set<std::string> queued(_uris.begin(), _uris.end());
+  std::map<std::string, std::string> paths;
+  unsigned int busy = 0;
+  std::mutex mutex;
+  std::condition_variable condition;
+
+  // Each worker resolves models until the queue is empty and no other
+  // worker can add dependencies to it
+  auto resolveModels = [&]()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+      condition.wait(lock, [&]
       {
-        gzwarn << "Unable to connect to model database using ["
-               << _uri << "]\n";
-        retry = true;
-        continue;
-      }
+        return !queue.empty() || busy == 0;
+      });
+      if (queue.empty())
+        break;
 
-      fclose(fp);
+      const std::string uri = queue.front();
+      queue.pop_front();
+      ++busy;
+      lock.unlock();
 
-      try
-      {
-        // Unzip model tarball
-        std::ifstream file(tgzfilename.c_str(),
-            std::ios_base::in | std::ios_base::binary);
-        std::ofstream out(tarfilename.c_str(),
-            std::ios_base::out | std::ios_base::binary);
-        boost::iostreams::filtering_streambuf<boost::iostreams::input> in;
-        in.push(boost::iostreams::gzip_decompressor());
-        in.push(file);
-        boost::iostreams::copy(in, out);
-      }
-      catch(...)
+      std::string downloaded;
+      const std::string path = this->ModelPath(uri, false, downloaded);
+      std::vector<std::string> dependencies;
+      if (!downloaded.empty())
+        dependencies = ModelDatabase::Dependencies(downloaded);
+
+      lock.lock();
+      paths[uri] = path;
+      for (auto const &dependency : dependencies)
       {
-        gzerr << "Failed to unzip model tarball. Trying again...\n";
-        retry = true;
-        continue;
+        if (queued.insert(dependency).second)
+          queue.push_back(dependency);
       }
-
-#ifndef _WIN32
-      TAR *tar;
-      tar_open(&tar, const_cast<char*>(tarfilename.c_str()),
-          nullptr, O_RDONLY, 0644, TAR_GNU);
-
-      std::string outputPath = getenv("HOME");
-      outputPath += "/.gazebo/models";
-
-      tar_extract_all(tar, const_cast<char*>(outputPath.c_str()));
-      path = outputPath + "/" + modelName;
-
-      ModelDatabase::DownloadDependencies(path);
-#endif
+      --busy;
+      condition.notify_all();
     }
+  };
+
+  const unsigned int threadCount = std::min<std::size_t>(DownloadThreads(),
+      queue.size());
+  std::vector<std::thread> threads;
+  for (unsigned int i = 1; i < threadCount; ++i)
+    threads.emplace_back(resolveModels);
+  if (threadCount > 0)
+    resolveModels();
+  for (auto &thread : threads)
+    thread.join();
+
+  std::vector<std::string> result;
+  for (auto const &uri : _uris)
+    result.push_back(paths[uri]);
+  return result;
+}
 
-    curl_easy_cleanup(curl);
-    if (retry)
+/////////////////////////////////////////////////
+/// \brief Collect the URIs of the <include> elements of an XML element and
+/// of its descendants.
+/// \param[in] _elem The XML element.
+/// \param[out] _uris The URIs.
+static void IncludeUris(const TiXmlElement *_elem,
+    std::vector<std::string> &_uris)
+{
+  for (const TiXmlElement *child = _elem->FirstChildElement(); child;
+       child = child->NextSiblingElement())
+  {
+    if (std::string(child->Value()) == "include")
     {
-      gzerr << "Could not download model[" << _uri << "]."
-        << "The model may be corrupt.\n";
-      path.clear();
+      const TiXmlElement *uriXML = child->FirstChildElement("uri");
+      if (uriXML && uriXML->GetText())
+        _uris.push_back(boost::trim_copy(std::string(uriXML->GetText())));
     }
+    else
+      IncludeUris(child, _uris);
+  }
+}
 
-    // Clean up
-    try
-    {
-      boost::filesystem::remove(tarfilename);
-      boost::filesystem::remove(tgzfilename);
-    }
-    catch(...)
-    {
-      gzwarn << "Failed to remove temporary model files after download.";
-    }
+/////////////////////////////////////////////////
+void ModelDatabase::DownloadIncludedModels(const std::string &_filename)
+{
+  // The SDF parser reports invalid files
+  TiXmlDocument xmlDoc;
+  if (!xmlDoc.LoadFile(_filename) || !xmlDoc.RootElement())
+    return;
+
+  std::vector<std::string> uris;
+  IncludeUris(xmlDoc.RootElement(), uris);
+
+  std::vector<std::string> modelUris;
+  std::vector<std::string> fuelUris;
+  for (auto const &uri : uris)
+  {
+    if (boost::starts_with(uri, "model://"))
+      modelUris.push_back(uri);
+    else if (boost::starts_with(uri, "http://") ||
+             boost::starts_with(uri, "https://"))
+      fuelUris.push_back(uri);
   }
 
-  return path + suffix;
+  std::thread fuelThread;
+  if (!fuelUris.empty())
+  {
+    fuelThread = std::thread([&fuelUris]()
+    {
+      FuelModelDatabase::Instance()->DownloadModels(fuelUris);
+    });
+  }
+  if (!modelUris.empty())
+    this->DownloadModels(modelUris);
+  if (fuelThread.joinable())
+    fuelThread.join();
 }
 
 /////////////////////////////////////////////////
 void ModelDatabase::DownloadDependencies(const std::string &_path)
 {
+  this->DownloadModels(ModelDatabase::Dependencies(_path));
+}
+
+/////////////////////////////////////////////////
+std::vector<std::string> ModelDatabase::Dependencies(const std::string &_path)
+{
+  std::vector<std::string> dependencies;
   boost::filesystem::path manifestPath = _path;
 
   // Get the GZ_MODEL_MANIFEST_FILENAME.
@@ -562,21 +934,20 @@ void ModelDatabase::DownloadDependencies(const std::string &_path)
     if (!modelXML)
     {
       gzerr << "No <model> element in manifest file[" << _path << "]\n";
-      return;
+      return dependencies;
     }
 
     TiXmlElement *dependXML = modelXML->FirstChildElement("depend");
     if (!dependXML)
-      return;
+      return dependencies;
 
     for (TiXmlElement *depXML = dependXML->FirstChildElement("model");
          depXML; depXML = depXML->NextSiblingElement())
     {
       TiXmlElement *uriXML = depXML->FirstChildElement("uri");
-      if (uriXML)
+      if (uriXML && uriXML->GetText())
       {
-        // Download the model if it doesn't exist.
-        ModelDatabase::GetModelPath(uriXML->GetText());
+        dependencies.push_back(uriXML->GetText());
       }
       else
       {
@@ -587,6 +958,8 @@ void ModelDatabase::DownloadDependencies(const std::string &_path)
   }
   else
     gzerr << "Unable to load manifest file[" << manifestPath << "]\n";
+
+  return dependencies;
 }
 
 /////////////////////////////////////////////////
@@ -20,6 +20,7 @@
 #include <string>
 #include <map>
 #include <utility>
+#include <vector>
 
 #include <boost/function.hpp>
 #include "gazebo/common/Event.hh"
@@ -49,6 +50,15 @@ namespace gazebo
     /// \class ModelDatabase ModelDatabase.hh common/common.hh
     /// \brief Connects to model database, and has utility functions to find
     /// models.
+    ///
+    /// Requests to the database reuse a pool of connections. Downloaded
+    /// models are installed in ~/.gazebo/models, along with the ETag of
+    /// their tarball, so that forced downloads only fetch changed models.
+    ///
+    /// \remarks
+    ///  Environment Variables:
+    ///   - GAZEBO_MODEL_DOWNLOAD_THREADS: Number of models DownloadModels
+    ///     fetches at the same time. Defaults to 8.
     class GZ_COMMON_VISIBLE ModelDatabase : public SingletonT<ModelDatabase>
     {
       /// \brief Constructor. This will update the model cache
@@ -129,6 +139,21 @@ namespace gazebo
       /// \param[in] _path Path to a model.
       public: void DownloadDependencies(const std::string &_path);
 
+      /// \brief Get the local paths of several models, downloading the
+      /// missing ones and their dependencies in parallel.
+      /// \param[in] _uris URIs of the models.
+      /// \return Paths of the models, in the order of _uris. A path is
+      /// empty if its model can't be found.
+      public: std::vector<std::string> DownloadModels(
+                  const std::vector<std::string> &_uris);
+
+      /// \brief Download the models an SDF file includes, from the model
+      /// database and from Ignition Fuel, in parallel. Their dependencies
+      /// are downloaded too. This saves the SDF parser from downloading
+      /// them one at a time.
+      /// \param[in] _filename Path of the SDF file.
+      public: void DownloadIncludedModels(const std::string &_filename);
+
       /// \brief Returns true if the model exists on the database.
       ///
       /// \param[in] _modelName URI of the model (eg:
@@ -141,6 +166,30 @@ namespace gazebo
       /// \return The contents of the manifest file.
       private: std::string GetManifestImpl(const std::string &_uri);
 
+      /// \brief Get the local path to a model, downloading it if needed.
+      /// \param[in] _uri The model URI.
+      /// \param[in] _forceDownload True to skip searching local paths.
+      /// \param[out] _downloaded Path to the model if it was downloaded,
+      /// empty otherwise.
+      /// \return Path to the model, or its file if _uri has a suffix.
+      private: std::string ModelPath(const std::string &_uri,
+                   bool _forceDownload, std::string &_downloaded);
+
+      /// \brief Download and install a model tarball. Concurrent requests
+      /// for the same model wait for a single download.
+      /// \param[in] _modelName Name of the model in the database.
+      /// \param[in] _revalidate True to download the model again, unless
+      /// its ETag didn't change.
+      /// \return Path to the installed model, empty on error.
+      private: std::string FetchModel(const std::string &_modelName,
+                   bool _revalidate);
+
+      /// \brief Get the dependencies listed in a model's manifest.
+      /// \param[in] _path Path to the model.
+      /// \return URIs of the dependencies.
+      private: static std::vector<std::string> Dependencies(
+                   const std::string &_path);
+
       /// \brief Used by a thread to update the model cache.
       /// \param[in] _fetchImmediately True to fetch the models without
       /// waiting.
@@ -17,9 +17,15 @@
 #ifndef _GAZEBO_MODELDATABSE_PRIVATE_HH_
 #define _GAZEBO_MODELDATABSE_PRIVATE_HH_
 
+#include <curl/curl.h>
+
+#include <condition_variable>
 #include <list>
 #include <map>
+#include <mutex>
+#include <set>
 #include <string>
+#include <vector>
 
 #include <boost/function.hpp>
 #include <boost/thread.hpp>
@@ -68,6 +74,38 @@ namespace gazebo
       /// calling ModelDatabase::GetModels()
       public: event::EventT<
                void (std::map<std::string, std::string>)> modelDBUpdated;
+
+      /// \brief Get a curl handle from the pool, reset to the default
+      /// options. Reusing handles keeps their connections alive between
+      /// requests.
+      /// \return The handle, nullptr if curl can't be initialized.
+      public: CURL *AcquireHandle();
+
+      /// \brief Return a curl handle to the pool.
+      /// \param[in] _handle The handle.
+      public: void ReleaseHandle(CURL *_handle);
+
+      /// \brief Share of DNS entries, TLS sessions and connections between
+      /// the curl handles.
+      public: CURLSH *share = nullptr;
+
+      /// \brief Locks of the data in share, indexed by curl_lock_data.
+      public: std::mutex shareMutexes[CURL_LOCK_DATA_LAST];
+
+      /// \brief Curl handles which aren't in use.
+      public: std::vector<CURL *> handles;
+
+      /// \brief Protects handles.
+      public: std::mutex handlesMutex;
+
+      /// \brief Names of the models being downloaded.
+      public: std::set<std::string> downloading;
+
+      /// \brief Protects downloading.
+      public: std::mutex downloadMutex;
+
+      /// \brief Notified when a model download finishes.
+      public: std::condition_variable downloadCondition;
     };
   }
 }
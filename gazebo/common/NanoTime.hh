@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_NANOTIME_HH_
+#define GAZEBO_COMMON_NANOTIME_HH_
+
+#include <cstdint>
+
+#include "gazebo/common/Time.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \addtogroup gazebo_common
+    /// \{
+
+    /// \class NanoTime NanoTime.hh common/common.hh
+    /// \brief A time, or a duration, held as a single count of
+    /// nanoseconds. Unlike Time, its arithmetic needs no normalization and
+    /// its comparisons are single integer comparisons, which suits the
+    /// checks done at every step, such as sensor and publisher throttling.
+    /// Converts to and from Time, and covers about 292 years.
+    class NanoTime
+    {
+      /// \brief Constructor, zero time.
+      public: constexpr NanoTime() = default;
+
+      /// \brief Constructor.
+      /// \param[in] _nsec Nanoseconds.
+      public: explicit constexpr NanoTime(const int64_t _nsec)
+              : nsec(_nsec)
+              {
+              }
+
+      /// \brief Constructor.
+      /// \param[in] _time Time to convert.
+      public: explicit NanoTime(const Time &_time)
+              : nsec(static_cast<int64_t>(_time.sec) * kNsInSec + _time.nsec)
+              {
+              }
+
+      /// \brief Get a time from seconds, rounded to the nanosecond.
+      /// \param[in] _sec Seconds.
+      /// \return The time.
+      public: static constexpr NanoTime FromSeconds(const double _sec)
+              {
+                return NanoTime(static_cast<int64_t>(
+                      _sec * kNsInSec + (_sec < 0 ? -0.5 : 0.5)));
+              }
+
+      /// \brief Get the number of nanoseconds.
+      /// \return Nanoseconds.
+      public: constexpr int64_t Nanoseconds() const
+              {
+                return this->nsec;
+              }
+
+      /// \brief Get the time in seconds.
+      /// \return Seconds.
+      public: constexpr double Double() const
+              {
+                return static_cast<double>(this->nsec) / kNsInSec;
+              }
+
+      /// \brief Convert to Time. Times beyond Time::Maximum() wrap.
+      /// \return The time.
+      public: Time ToTime() const
+              {
+                // Both parts take the sign of the time, as in Time
+                return Time(static_cast<int32_t>(this->nsec / kNsInSec),
+                    static_cast<int32_t>(this->nsec % kNsInSec));
+              }
+
+      /// \brief Addition operator.
+      /// \param[in] _time Time to add.
+      /// \return The sum.
+      public: constexpr NanoTime operator+(const NanoTime &_time) const
+              {
+                return NanoTime(this->nsec + _time.nsec);
+              }
+
+      /// \brief Subtraction operator.
+      /// \param[in] _time Time to subtract.
+      /// \return The difference.
+      public: constexpr NanoTime operator-(const NanoTime &_time) const
+              {
+                return NanoTime(this->nsec - _time.nsec);
+              }
+
+      /// \brief Negation operator.
+      /// \return The opposite time.
+      public: constexpr NanoTime operator-() const
+              {
+                return NanoTime(-this->nsec);
+              }
+
+      /// \brief Multiplication operator, rounded to the nanosecond.
+      /// \param[in] _scale Factor.
+      /// \return The scaled time.
+      public: constexpr NanoTime operator*(const double _scale) const
+              {
+                return FromSeconds(this->Double() * _scale);
+              }
+
+      /// \brief Addition assignment operator.
+      /// \param[in] _time Time to add.
+      /// \return Reference to this time.
+      public: NanoTime &operator+=(const NanoTime &_time)
+              {
+                this->nsec += _time.nsec;
+                return *this;
+              }
+
+      /// \brief Subtraction assignment operator.
+      /// \param[in] _time Time to subtract.
+      /// \return Reference to this time.
+      public: NanoTime &operator-=(const NanoTime &_time)
+              {
+                this->nsec -= _time.nsec;
+                return *this;
+              }
+
+      /// \brief Equality operator.
+      /// \param[in] _time Time to compare to.
+      /// \return True if equal.
+      public: constexpr bool operator==(const NanoTime &_time) const
+              {
+                return this->nsec == _time.nsec;
+              }
+
+      /// \brief Inequality operator.
+      /// \param[in] _time Time to compare to.
+      /// \return True if not equal.
+      public: constexpr bool operator!=(const NanoTime &_time) const
+              {
+                return this->nsec != _time.nsec;
+              }
+
+      /// \brief Less than operator.
+      /// \param[in] _time Time to compare to.
+      /// \return True if this time is earlier.
+      public: constexpr bool operator<(const NanoTime &_time) const
+              {
+                return this->nsec < _time.nsec;
+              }
+
+      /// \brief Less than or equal operator.
+      /// \param[in] _time Time to compare to.
+      /// \return True if this time is earlier or equal.
+      public: constexpr bool operator<=(const NanoTime &_time) const
+              {
+                return this->nsec <= _time.nsec;
+              }
+
+      /// \brief Greater than operator.
+      /// \param[in] _time Time to compare to.
+      /// \return True if this time is later.
+      public: constexpr bool operator>(const NanoTime &_time) const
+              {
+                return this->nsec > _time.nsec;
+              }
+
+      /// \brief Greater than or equal operator.
+      /// \param[in] _time Time to compare to.
+      /// \return True if this time is later or equal.
+      public: constexpr bool operator>=(const NanoTime &_time) const
+              {
+                return this->nsec >= _time.nsec;
+              }
+
+      /// \brief Stream insertion operator, in seconds.
+      /// \param[in] _out The output stream.
+      /// \param[in] _time Time to write.
+      /// \return The output stream.
+      public: friend std::ostream &operator<<(std::ostream &_out,
+                  const NanoTime &_time)
+              {
+                _out << _time.Double();
+                return _out;
+              }
+
+      /// \brief Nanoseconds in a second.
+      private: static constexpr int64_t kNsInSec = 1000000000;
+
+      /// \brief Nanoseconds.
+      private: int64_t nsec = 0;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include "gazebo/common/NanoTime.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class NanoTimeTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(NanoTimeTest, Arithmetic)
+{
+  constexpr common::NanoTime period = common::NanoTime::FromSeconds(0.001);
+  static_assert(period.Nanoseconds() == 1000000, "1 ms");
+  static_assert(period + period > period, "addition");
+  static_assert((period - period) == common::NanoTime(), "subtraction");
+
+  EXPECT_EQ(common::NanoTime().Nanoseconds(), 0);
+  EXPECT_EQ(common::NanoTime::FromSeconds(-1.5).Nanoseconds(), -1500000000);
+  EXPECT_DOUBLE_EQ(common::NanoTime(2500000000).Double(), 2.5);
+  EXPECT_EQ((period * 0.5).Nanoseconds(), 500000);
+  EXPECT_EQ((-period).Nanoseconds(), -1000000);
+
+  common::NanoTime time(10);
+  time += common::NanoTime(5);
+  EXPECT_EQ(time.Nanoseconds(), 15);
+  time -= common::NanoTime(20);
+  EXPECT_EQ(time.Nanoseconds(), -5);
+  EXPECT_TRUE(time < common::NanoTime());
+  EXPECT_TRUE(time <= common::NanoTime(-5));
+  EXPECT_TRUE(time != common::NanoTime());
+}
+
+/////////////////////////////////////////////////
+TEST_F(NanoTimeTest, Time)
+{
+  EXPECT_EQ(common::NanoTime(common::Time(3, 250)).Nanoseconds(),
+      3000000250);
+  EXPECT_EQ(common::NanoTime(common::Time(-1.25)).Nanoseconds(),
+      -1250000000);
+  EXPECT_EQ(common::NanoTime(common::Time::Maximum()).ToTime(),
+      common::Time::Maximum());
+
+  EXPECT_EQ(common::NanoTime(3000000250).ToTime(), common::Time(3, 250));
+  EXPECT_EQ(common::NanoTime(-1250000000).ToTime(), common::Time(-1.25));
+
+  // Same results as the arithmetic of Time
+  const common::Time a(12, 999999999);
+  const common::Time b(0.75);
+  EXPECT_EQ((common::NanoTime(a) + common::NanoTime(b)).ToTime(), a + b);
+  EXPECT_EQ((common::NanoTime(b) - common::NanoTime(a)).ToTime(), b - a);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,363 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "gazebo/common/PIDBank.hh"
+
+using namespace gazebo;
+using namespace common;
+
+namespace
+{
+  /// \brief Select one of two values with a bit mask. Unlike a
+  /// conditional, which the compiler may turn into a branch or a
+  /// conditional store, it keeps the loop vectorizable.
+  /// \param[in] _mask All ones to select _a, zero to select _b.
+  /// \param[in] _a First value.
+  /// \param[in] _b Second value.
+  /// \return The selected value.
+  inline double Select(const uint64_t _mask, const double _a,
+      const double _b)
+  {
+    uint64_t a, b;
+    std::memcpy(&a, &_a, sizeof(a));
+    std::memcpy(&b, &_b, sizeof(b));
+    const uint64_t bits = (a & _mask) | (b & ~_mask);
+    double result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+  }
+
+  /// \brief Update PID controllers, see PIDBank::Update. The arrays
+  /// don't overlap.
+  void UpdateControllers(const size_t _count,
+      const double *__restrict _errors,
+      const unsigned char *__restrict _active, const double _dt,
+      const double *__restrict _pGain, const double *__restrict _iGain,
+      const double *__restrict _dGain, const double *__restrict _iMax,
+      const double *__restrict _iMin, const double *__restrict _iErrHigh,
+      const double *__restrict _iErrLow, const double *__restrict _cmdHigh,
+      const double *__restrict _cmdLow, double *__restrict _pErrLast,
+      double *__restrict _pErr, double *__restrict _iErr,
+      double *__restrict _dErr, double *__restrict _cmd,
+      double *__restrict _cmds)
+  {
+    // Every quantity is computed for every controller, then selected, so
+    // that the loop has no branches. Inactive controllers and those with
+    // a non finite error keep their state.
+    for (size_t i = 0; i < _count; ++i)
+    {
+      const double error = _errors[i];
+
+      // Finite errors give a zero difference, infinite and NaN ones NaN
+      const uint64_t valid =
+        (_active[i] != 0) & (error - error == 0.0) ? ~uint64_t(0) : 0;
+
+      const double pTerm = _pGain[i] * error;
+
+      // Limit the integral term, so that the limit is meaningful in the
+      // output, and the integral error with it
+      const double ie = std::min(std::max(
+            _iErr[i] + _dt * error, _iErrLow[i]), _iErrHigh[i]);
+      const double iTerm = std::min(std::max(
+            _iGain[i] * (_iErr[i] + _dt * error), _iMin[i]), _iMax[i]);
+
+      const double de = (error - _pErrLast[i]) / _dt;
+      const double dTerm = _dGain[i] * de;
+
+      const double c = std::max(std::min(-pTerm - iTerm - dTerm,
+            _cmdHigh[i]), _cmdLow[i]);
+
+      _pErr[i] = Select(valid, error, _pErr[i]);
+      _iErr[i] = Select(valid, ie, _iErr[i]);
+      _dErr[i] = Select(valid, de, _dErr[i]);
+      _pErrLast[i] = Select(valid, error, _pErrLast[i]);
+      _cmd[i] = Select(valid, c, _cmd[i]);
+      _cmds[i] = Select(valid, c, 0.0);
+    }
+  }
+}
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \brief Private data for PIDBank, one array per quantity.
+    class PIDBankPrivate
+    {
+      /// \brief Proportional gains.
+      public: std::vector<double> pGain;
+
+      /// \brief Integral gains.
+      public: std::vector<double> iGain;
+
+      /// \brief Derivative gains.
+      public: std::vector<double> dGain;
+
+      /// \brief Integral upper limits.
+      public: std::vector<double> iMax;
+
+      /// \brief Integral lower limits.
+      public: std::vector<double> iMin;
+
+      /// \brief Command upper limits.
+      public: std::vector<double> cmdMax;
+
+      /// \brief Command lower limits.
+      public: std::vector<double> cmdMin;
+
+      /// \brief Upper limits of the integral errors, from the integral
+      /// limits and gains.
+      public: std::vector<double> iErrHigh;
+
+      /// \brief Lower limits of the integral errors.
+      public: std::vector<double> iErrLow;
+
+      /// \brief Upper limits of the commands, infinite when clamping is
+      /// disabled.
+      public: std::vector<double> cmdHigh;
+
+      /// \brief Lower limits of the commands.
+      public: std::vector<double> cmdLow;
+
+      /// \brief Proportional errors of the previous updates.
+      public: std::vector<double> pErrLast;
+
+      /// \brief Proportional errors.
+      public: std::vector<double> pErr;
+
+      /// \brief Integral errors.
+      public: std::vector<double> iErr;
+
+      /// \brief Derivative errors.
+      public: std::vector<double> dErr;
+
+      /// \brief Commands.
+      public: std::vector<double> cmd;
+
+      /// \brief Get all the arrays.
+      /// \return Pointers to the arrays.
+      public: std::vector<std::vector<double> *> Arrays()
+              {
+                return {&this->pGain, &this->iGain, &this->dGain,
+                  &this->iMax, &this->iMin, &this->cmdMax, &this->cmdMin,
+                  &this->iErrHigh, &this->iErrLow, &this->cmdHigh,
+                  &this->cmdLow, &this->pErrLast, &this->pErr, &this->iErr,
+                  &this->dErr, &this->cmd};
+              }
+
+      /// \brief Update the limits which Update uses, after a gain or a
+      /// limit changed.
+      /// \param[in] _index Index of the controller.
+      public: void UpdateLimits(const size_t _index)
+              {
+                const double inf = std::numeric_limits<double>::infinity();
+
+                // The integral term is over its upper limit when the
+                // integral error is over iMax / iGain, or under it for a
+                // negative gain. A zero gain gives a zero term.
+                const double gain = this->iGain[_index];
+                double high = inf;
+                double low = -inf;
+                if (gain > 0)
+                {
+                  high = this->iMax[_index] / gain;
+                  low = this->iMin[_index] / gain;
+                }
+                else if (gain < 0)
+                {
+                  high = this->iMin[_index] / gain;
+                  low = this->iMax[_index] / gain;
+                }
+                this->iErrHigh[_index] = high;
+                this->iErrLow[_index] = low;
+
+                const bool clamp =
+                  this->cmdMax[_index] >= this->cmdMin[_index];
+                this->cmdHigh[_index] = clamp ? this->cmdMax[_index] : inf;
+                this->cmdLow[_index] = clamp ? this->cmdMin[_index] : -inf;
+              }
+    };
+  }
+}
+
+//////////////////////////////////////////////////
+PIDBank::PIDBank()
+  : dataPtr(new PIDBankPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+PIDBank::~PIDBank()
+{
+}
+
+//////////////////////////////////////////////////
+size_t PIDBank::Size() const
+{
+  return this->dataPtr->pGain.size();
+}
+
+//////////////////////////////////////////////////
+size_t PIDBank::Add(const PID &_pid)
+{
+  for (auto *array : this->dataPtr->Arrays())
+    array->push_back(0.0);
+
+  const size_t index = this->Size() - 1;
+  this->Set(index, _pid);
+  return index;
+}
+
+//////////////////////////////////////////////////
+void PIDBank::Remove(const size_t _index)
+{
+  if (_index >= this->Size())
+    return;
+
+  for (auto *array : this->dataPtr->Arrays())
+  {
+    (*array)[_index] = array->back();
+    array->pop_back();
+  }
+}
+
+//////////////////////////////////////////////////
+void PIDBank::Set(const size_t _index, const PID &_pid)
+{
+  this->dataPtr->pGain[_index] = _pid.GetPGain();
+  this->dataPtr->iGain[_index] = _pid.GetIGain();
+  this->dataPtr->dGain[_index] = _pid.GetDGain();
+  this->dataPtr->iMax[_index] = _pid.GetIMax();
+  this->dataPtr->iMin[_index] = _pid.GetIMin();
+  this->dataPtr->cmdMax[_index] = _pid.GetCmdMax();
+  this->dataPtr->cmdMin[_index] = _pid.GetCmdMin();
+  this->dataPtr->UpdateLimits(_index);
+  this->Reset(_index);
+}
+
+//////////////////////////////////////////////////
+PID PIDBank::Get(const size_t _index) const
+{
+  return PID(this->dataPtr->pGain[_index], this->dataPtr->iGain[_index],
+      this->dataPtr->dGain[_index], this->dataPtr->iMax[_index],
+      this->dataPtr->iMin[_index], this->dataPtr->cmdMax[_index],
+      this->dataPtr->cmdMin[_index]);
+}
+
+//////////////////////////////////////////////////
+void PIDBank::SetPGain(const size_t _index, const double _p)
+{
+  this->dataPtr->pGain[_index] = _p;
+}
+
+//////////////////////////////////////////////////
+void PIDBank::SetIGain(const size_t _index, const double _i)
+{
+  this->dataPtr->iGain[_index] = _i;
+  this->dataPtr->UpdateLimits(_index);
+}
+
+//////////////////////////////////////////////////
+void PIDBank::SetDGain(const size_t _index, const double _d)
+{
+  this->dataPtr->dGain[_index] = _d;
+}
+
+//////////////////////////////////////////////////
+void PIDBank::SetIMax(const size_t _index, const double _i)
+{
+  this->dataPtr->iMax[_index] = _i;
+  this->dataPtr->UpdateLimits(_index);
+}
+
+//////////////////////////////////////////////////
+void PIDBank::SetIMin(const size_t _index, const double _i)
+{
+  this->dataPtr->iMin[_index] = _i;
+  this->dataPtr->UpdateLimits(_index);
+}
+
+//////////////////////////////////////////////////
+void PIDBank::SetCmdMax(const size_t _index, const double _c)
+{
+  this->dataPtr->cmdMax[_index] = _c;
+  this->dataPtr->UpdateLimits(_index);
+}
+
+//////////////////////////////////////////////////
+void PIDBank::SetCmdMin(const size_t _index, const double _c)
+{
+  this->dataPtr->cmdMin[_index] = _c;
+  this->dataPtr->UpdateLimits(_index);
+}
+
+//////////////////////////////////////////////////
+void PIDBank::Reset(const size_t _index)
+{
+  this->dataPtr->pErrLast[_index] = 0.0;
+  this->dataPtr->pErr[_index] = 0.0;
+  this->dataPtr->iErr[_index] = 0.0;
+  this->dataPtr->dErr[_index] = 0.0;
+  this->dataPtr->cmd[_index] = 0.0;
+}
+
+//////////////////////////////////////////////////
+void PIDBank::Reset()
+{
+  for (size_t i = 0; i < this->Size(); ++i)
+    this->Reset(i);
+}
+
+//////////////////////////////////////////////////
+double PIDBank::Cmd(const size_t _index) const
+{
+  return this->dataPtr->cmd[_index];
+}
+
+//////////////////////////////////////////////////
+void PIDBank::Errors(const size_t _index, double &_pe, double &_ie,
+    double &_de) const
+{
+  _pe = this->dataPtr->pErr[_index];
+  _ie = this->dataPtr->iErr[_index];
+  _de = this->dataPtr->dErr[_index];
+}
+
+//////////////////////////////////////////////////
+void PIDBank::Update(const double *_errors, const unsigned char *_active,
+    const double _dt, double *_cmds)
+{
+  const size_t count = this->Size();
+  if (_dt == 0.0)
+  {
+    std::fill(_cmds, _cmds + count, 0.0);
+    return;
+  }
+
+  PIDBankPrivate &data = *this->dataPtr;
+  UpdateControllers(count, _errors, _active, _dt, data.pGain.data(),
+      data.iGain.data(), data.dGain.data(), data.iMax.data(),
+      data.iMin.data(), data.iErrHigh.data(), data.iErrLow.data(),
+      data.cmdHigh.data(), data.cmdLow.data(), data.pErrLast.data(),
+      data.pErr.data(), data.iErr.data(), data.dErr.data(), data.cmd.data(),
+      _cmds);
+}
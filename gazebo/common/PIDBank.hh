@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_PIDBANK_HH_
+#define GAZEBO_COMMON_PIDBANK_HH_
+
+#include <cstddef>
+#include <memory>
+
+#include "gazebo/common/PID.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    // Forward declare private data class
+    class PIDBankPrivate;
+
+    /// \addtogroup gazebo_common
+    /// \{
+
+    /// \class PIDBank PIDBank.hh common/common.hh
+    /// \brief A set of PID controllers updated together, which behave like
+    /// common::PID.
+    ///
+    /// The gains and the errors of the controllers are stored in arrays,
+    /// one per quantity, so that Update runs one branch free loop over
+    /// all of them, which the compiler vectorizes. Unlike PID, integral
+    /// limits with iMin above iMax hold the integral term at iMax, and
+    /// a zero integral gain leaves the integral error unlimited.
+    class GZ_COMMON_VISIBLE PIDBank
+    {
+      /// \brief Constructor.
+      public: PIDBank();
+
+      /// \brief Destructor.
+      public: ~PIDBank();
+
+      /// \brief Get the number of controllers.
+      /// \return The number of controllers.
+      public: size_t Size() const;
+
+      /// \brief Add a controller.
+      /// \param[in] _pid Controller with the gains and limits to use. Its
+      /// errors aren't copied.
+      /// \return Index of the controller.
+      public: size_t Add(const PID &_pid);
+
+      /// \brief Remove a controller. The last controller takes its index.
+      /// \param[in] _index Index of the controller.
+      public: void Remove(const size_t _index);
+
+      /// \brief Set the gains and limits of a controller, and reset it.
+      /// \param[in] _index Index of the controller.
+      /// \param[in] _pid Controller with the gains and limits to use.
+      public: void Set(const size_t _index, const PID &_pid);
+
+      /// \brief Get a controller.
+      /// \param[in] _index Index of the controller.
+      /// \return A PID with the gains and limits of the controller.
+      public: PID Get(const size_t _index) const;
+
+      /// \brief Set the proportional gain of a controller.
+      /// \param[in] _index Index of the controller.
+      /// \param[in] _p Proportional gain.
+      public: void SetPGain(const size_t _index, const double _p);
+
+      /// \brief Set the integral gain of a controller.
+      /// \param[in] _index Index of the controller.
+      /// \param[in] _i Integral gain.
+      public: void SetIGain(const size_t _index, const double _i);
+
+      /// \brief Set the derivative gain of a controller.
+      /// \param[in] _index Index of the controller.
+      /// \param[in] _d Derivative gain.
+      public: void SetDGain(const size_t _index, const double _d);
+
+      /// \brief Set the integral upper limit of a controller.
+      /// \param[in] _index Index of the controller.
+      /// \param[in] _i Integral upper limit.
+      public: void SetIMax(const size_t _index, const double _i);
+
+      /// \brief Set the integral lower limit of a controller.
+      /// \param[in] _index Index of the controller.
+      /// \param[in] _i Integral lower limit.
+      public: void SetIMin(const size_t _index, const double _i);
+
+      /// \brief Set the command upper limit of a controller.
+      /// \param[in] _index Index of the controller.
+      /// \param[in] _c Command upper limit.
+      public: void SetCmdMax(const size_t _index, const double _c);
+
+      /// \brief Set the command lower limit of a controller.
+      /// \param[in] _index Index of the controller.
+      /// \param[in] _c Command lower limit.
+      public: void SetCmdMin(const size_t _index, const double _c);
+
+      /// \brief Reset the errors and the command of a controller.
+      /// \param[in] _index Index of the controller.
+      public: void Reset(const size_t _index);
+
+      /// \brief Reset the errors and the commands of all the controllers.
+      public: void Reset();
+
+      /// \brief Get the last command of a controller.
+      /// \param[in] _index Index of the controller.
+      /// \return The command.
+      public: double Cmd(const size_t _index) const;
+
+      /// \brief Get the errors of a controller.
+      /// \param[in] _index Index of the controller.
+      /// \param[out] _pe The proportional error.
+      /// \param[out] _ie The integral error.
+      /// \param[out] _de The derivative error.
+      public: void Errors(const size_t _index, double &_pe, double &_ie,
+                  double &_de) const;
+
+      /// \brief Update the controllers, as PID::Update does for each. The
+      /// arrays have Size() elements and don't overlap.
+      /// \param[in] _errors Error of each controller.
+      /// \param[in] _active 1 for the controllers to update, 0 for those
+      /// that keep their state and return a zero command.
+      /// \param[in] _dt Change in time since the last update, in seconds.
+      /// \param[out] _cmds Command of each controller.
+      public: void Update(const double *_errors,
+                  const unsigned char *_active, const double _dt,
+                  double *_cmds);
+
+      /// \brief Private data pointer.
+      private: std::unique_ptr<PIDBankPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "gazebo/common/PIDBank.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class PIDBankTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(PIDBankTest, MatchesPID)
+{
+  // Unclamped, clamped command, clamped integral, and unused gains
+  std::vector<common::PID> pids = {
+    common::PID(1, 0.1, 0.01, 1, -1, 1000, -1000),
+    common::PID(4, 1, 9, 0.5, -0.5, 2, -2),
+    common::PID(0.5, 10, 0, 0.2, -0.1),
+    common::PID()};
+
+  common::PIDBank bank;
+  for (const auto &pid : pids)
+    bank.Add(pid);
+  ASSERT_EQ(pids.size(), bank.Size());
+
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  std::vector<double> errors(pids.size());
+  std::vector<unsigned char> active(pids.size(), 1);
+  std::vector<double> cmds(pids.size());
+  for (unsigned int step = 0; step < 50; ++step)
+  {
+    for (size_t i = 0; i < errors.size(); ++i)
+      errors[i] = std::sin(step * 0.3 + i) * (i + 1);
+
+    // A non finite error and an inactive controller keep their state
+    if (step == 10)
+      errors[1] = nan;
+    active[2] = step % 7 != 3;
+
+    const double dt = 0.001 * (1 + step % 3);
+    bank.Update(errors.data(), active.data(), dt, cmds.data());
+
+    for (size_t i = 0; i < pids.size(); ++i)
+    {
+      double expected = 0;
+      if (active[i])
+        expected = pids[i].Update(errors[i], common::Time(dt));
+      EXPECT_DOUBLE_EQ(expected, cmds[i]) << "step " << step << " " << i;
+
+      double pe, ie, de, bpe, bie, bde;
+      pids[i].GetErrors(pe, ie, de);
+      bank.Errors(i, bpe, bie, bde);
+      if (!std::isnan(pe))
+      {
+        EXPECT_DOUBLE_EQ(pe, bpe);
+      }
+      EXPECT_DOUBLE_EQ(ie, bie);
+      EXPECT_DOUBLE_EQ(de, bde);
+      EXPECT_DOUBLE_EQ(pids[i].GetCmd(), bank.Cmd(i));
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+TEST_F(PIDBankTest, SetAndRemove)
+{
+  common::PIDBank bank;
+  EXPECT_EQ(0u, bank.Add(common::PID(1, 2, 3)));
+  EXPECT_EQ(1u, bank.Add(common::PID(4, 5, 6, 7, -7, 8, -8)));
+  EXPECT_EQ(2u, bank.Add(common::PID(9)));
+
+  bank.SetDGain(0, 0.5);
+  bank.SetCmdMax(0, 10);
+  bank.SetCmdMin(0, -10);
+  common::PID pid = bank.Get(0);
+  EXPECT_DOUBLE_EQ(1, pid.GetPGain());
+  EXPECT_DOUBLE_EQ(2, pid.GetIGain());
+  EXPECT_DOUBLE_EQ(0.5, pid.GetDGain());
+  EXPECT_DOUBLE_EQ(10, pid.GetCmdMax());
+  EXPECT_DOUBLE_EQ(-10, pid.GetCmdMin());
+
+  // Set resets the errors
+  const std::vector<double> errors = {1, 1, 1};
+  const std::vector<unsigned char> active = {1, 1, 1};
+  std::vector<double> cmds(3);
+  bank.Update(errors.data(), active.data(), 0.1, cmds.data());
+  EXPECT_DOUBLE_EQ(-9, bank.Cmd(2));
+  bank.Set(2, common::PID(3));
+  EXPECT_DOUBLE_EQ(0, bank.Cmd(2));
+
+  // The last controller takes the index of the removed one
+  bank.Remove(0);
+  ASSERT_EQ(2u, bank.Size());
+  EXPECT_DOUBLE_EQ(3, bank.Get(0).GetPGain());
+  EXPECT_DOUBLE_EQ(4, bank.Get(1).GetPGain());
+  EXPECT_DOUBLE_EQ(7, bank.Get(1).GetIMax());
+
+  bank.Reset();
+  double pe, ie, de;
+  bank.Errors(1, pe, ie, de);
+  EXPECT_DOUBLE_EQ(0, pe);
+  EXPECT_DOUBLE_EQ(0, ie);
+  EXPECT_DOUBLE_EQ(0, de);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -28,7 +28,10 @@
 #include <dlfcn.h>
 
 #include <list>
+#include <map>
+#include <mutex>
 #include <string>
+#include <utility>
 
 #include <sdf/sdf.hh>
 #include <boost/filesystem.hpp>
@@ -153,40 +156,63 @@ namespace gazebo
               }
 #endif  // ifdef __APPLE__
 
-              for (iter = pluginPaths.begin();
-                   iter!= pluginPaths.end(); ++iter)
-              {
-                fullname = (*iter)+std::string("/")+filename;
-                fullname = boost::filesystem::path(fullname)
-                    .make_preferred().string();
-                if (stat(fullname.c_str(), &st) == 0)
-                {
-                  found = true;
-                  break;
-                }
-              }
-
-              if (!found)
-                fullname = filename;
+              // Libraries are never closed, so each one is searched for,
+              // opened and resolved once and later plugins that use the same
+              // file reuse its handle
+              static std::mutex libraryMutex;
+              static std::map<std::string, std::pair<void *, void *>>
+                  libraries;
 
               fptr_union_t registerFunc;
-              std::string registerName = "RegisterPlugin";
-
-              void *dlHandle = dlopen(fullname.c_str(), RTLD_LAZY|RTLD_GLOBAL);
-              if (!dlHandle)
-              {
-                gzerr << "Failed to load plugin " << fullname << ": "
-                  << dlerror() << "\n";
-                return result;
-              }
-
-              registerFunc.ptr = dlsym(dlHandle, registerName.c_str());
-
-              if (!registerFunc.ptr)
+              void *dlHandle = nullptr;
               {
-                gzerr << "Failed to resolve " << registerName
-                      << ": " << dlerror();
-                return result;
+                std::lock_guard<std::mutex> lock(libraryMutex);
+                auto cached = libraries.find(filename);
+                if (cached != libraries.end())
+                {
+                  dlHandle = cached->second.first;
+                  registerFunc.ptr = cached->second.second;
+                }
+                else
+                {
+                  for (iter = pluginPaths.begin();
+                       iter!= pluginPaths.end(); ++iter)
+                  {
+                    fullname = (*iter)+std::string("/")+filename;
+                    fullname = boost::filesystem::path(fullname)
+                        .make_preferred().string();
+                    if (stat(fullname.c_str(), &st) == 0)
+                    {
+                      found = true;
+                      break;
+                    }
+                  }
+
+                  if (!found)
+                    fullname = filename;
+
+                  std::string registerName = "RegisterPlugin";
+
+                  dlHandle = dlopen(fullname.c_str(), RTLD_LAZY|RTLD_GLOBAL);
+                  if (!dlHandle)
+                  {
+                    gzerr << "Failed to load plugin " << fullname << ": "
+                      << dlerror() << "\n";
+                    return result;
+                  }
+
+                  registerFunc.ptr = dlsym(dlHandle, registerName.c_str());
+
+                  if (!registerFunc.ptr)
+                  {
+                    gzerr << "Failed to resolve " << registerName
+                          << ": " << dlerror();
+                    return result;
+                  }
+
+                  libraries[filename] =
+                      std::make_pair(dlHandle, registerFunc.ptr);
+                }
               }
 
               // Register the new controller.
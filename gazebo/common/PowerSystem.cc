@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+#include "gazebo/common/Battery.hh"
+#include "gazebo/common/BatteryPrivate.hh"
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/PowerSystem.hh"
+#include "gazebo/common/Time.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \brief Private data for PowerSystem.
+    class PowerSystemPrivate
+    {
+      /// \brief The batteries, Battery::dataPtr->systemIndex is their index
+      /// in all the arrays.
+      public: std::vector<Battery *> batteries;
+
+      /// \brief Non zero for the batteries with a linear model.
+      public: std::vector<char> linear;
+
+      /// \brief Linear model of each battery, unused when linear is zero.
+      public: std::vector<LinearBatteryModel> models;
+
+      /// \brief Time between two updates in seconds, 0 for every call.
+      public: double period = 0.0;
+
+      /// \brief Time elapsed since the last update in seconds.
+      public: double elapsed = 0.0;
+
+      /// \brief Protects the arrays.
+      public: mutable std::mutex mutex;
+    };
+  }
+}
+
+using namespace gazebo;
+using namespace common;
+
+/////////////////////////////////////////////////
+PowerSystem::PowerSystem()
+  : dataPtr(new PowerSystemPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+PowerSystem::~PowerSystem()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  for (auto battery : this->dataPtr->batteries)
+    battery->dataPtr->system = nullptr;
+}
+
+/////////////////////////////////////////////////
+void PowerSystem::Add(const BatteryPtr &_battery)
+{
+  if (!_battery)
+    return;
+
+  if (_battery->dataPtr->system)
+  {
+    if (_battery->dataPtr->system != this)
+    {
+      gzerr << "Battery[" << _battery->Name()
+            << "] already belongs to a power system\n";
+    }
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  _battery->dataPtr->system = this;
+  _battery->dataPtr->systemIndex = this->dataPtr->batteries.size();
+  this->dataPtr->batteries.push_back(_battery.get());
+  this->dataPtr->linear.push_back(0);
+  this->dataPtr->models.push_back(LinearBatteryModel());
+}
+
+/////////////////////////////////////////////////
+bool PowerSystem::Remove(const BatteryPtr &_battery)
+{
+  if (!_battery || _battery->dataPtr->system != this)
+    return false;
+
+  this->RemoveBattery(_battery.get());
+  return true;
+}
+
+/////////////////////////////////////////////////
+void PowerSystem::RemoveBattery(Battery *_battery)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  // Move the last battery to the free slot
+  size_t index = _battery->dataPtr->systemIndex;
+  size_t last = this->dataPtr->batteries.size() - 1;
+  if (index != last)
+  {
+    this->dataPtr->batteries[index] = this->dataPtr->batteries[last];
+    this->dataPtr->linear[index] = this->dataPtr->linear[last];
+    this->dataPtr->models[index] = this->dataPtr->models[last];
+    this->dataPtr->batteries[index]->dataPtr->systemIndex = index;
+  }
+  this->dataPtr->batteries.pop_back();
+  this->dataPtr->linear.pop_back();
+  this->dataPtr->models.pop_back();
+
+  _battery->dataPtr->system = nullptr;
+}
+
+/////////////////////////////////////////////////
+size_t PowerSystem::BatteryCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->batteries.size();
+}
+
+/////////////////////////////////////////////////
+bool PowerSystem::SetLinearModel(const BatteryPtr &_battery,
+    const LinearBatteryModel &_model)
+{
+  if (!_battery || _battery->dataPtr->system != this)
+  {
+    gzerr << "Battery isn't part of this power system\n";
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  size_t index = _battery->dataPtr->systemIndex;
+  this->dataPtr->linear[index] = 1;
+  this->dataPtr->models[index] = _model;
+
+  // The model replaces the update function
+  _battery->dataPtr->customUpdate = false;
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool PowerSystem::LinearModel(const BatteryPtr &_battery,
+    LinearBatteryModel &_model) const
+{
+  if (!_battery || _battery->dataPtr->system != this)
+    return false;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  size_t index = _battery->dataPtr->systemIndex;
+  if (!this->dataPtr->linear[index])
+    return false;
+
+  _model = this->dataPtr->models[index];
+  return true;
+}
+
+/////////////////////////////////////////////////
+void PowerSystem::SetUpdatePeriod(const double _period)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->period = std::max(0.0, _period);
+}
+
+/////////////////////////////////////////////////
+double PowerSystem::UpdatePeriod() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->period;
+}
+
+/////////////////////////////////////////////////
+void PowerSystem::Reset()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->elapsed = 0.0;
+}
+
+/////////////////////////////////////////////////
+void PowerSystem::Update(const double _dt)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  // The period is compared up to the rounding of the summed steps
+  this->dataPtr->elapsed += _dt;
+  if (this->dataPtr->elapsed < this->dataPtr->period * (1.0 - 1e-9) ||
+      this->dataPtr->elapsed <= 0.0)
+  {
+    return;
+  }
+
+  const double dt = this->dataPtr->elapsed;
+  this->dataPtr->elapsed = 0.0;
+
+  for (size_t i = 0; i < this->dataPtr->batteries.size(); ++i)
+  {
+    BatteryPrivate &battery = *this->dataPtr->batteries[i]->dataPtr;
+    if (battery.customUpdate)
+    {
+      this->dataPtr->batteries[i]->Update();
+      continue;
+    }
+
+    // Ideal batteries keep their voltage
+    if (!this->dataPtr->linear[i])
+      continue;
+
+    LinearBatteryModel &model = this->dataPtr->models[i];
+    double voltage = battery.realVoltage;
+    if (std::fabs(voltage) < 1e-3)
+    {
+      battery.realVoltage = 0.0;
+      continue;
+    }
+
+    double k = dt / model.tau;
+    model.iraw = battery.totalPowerLoad / voltage;
+    model.ismooth = model.ismooth + k * (model.iraw - model.ismooth);
+    model.q = model.q - GZ_SEC_TO_HOUR(dt * model.ismooth);
+
+    battery.realVoltage = std::max(0.0,
+        model.e0 + model.e1 * (1 - model.q / model.c) -
+        model.r * model.ismooth);
+  }
+}
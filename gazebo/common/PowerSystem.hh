@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_POWERSYSTEM_HH_
+#define GAZEBO_COMMON_POWERSYSTEM_HH_
+
+#include <memory>
+
+#include "gazebo/common/CommonTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    // Forward declare private data class
+    class PowerSystemPrivate;
+
+    /// \addtogroup gazebo_common
+    /// \{
+
+    /// \brief Parameters and state of a linear battery model, as read by
+    /// the LinearBatteryPlugin.
+    ///
+    /// The open circuit voltage is e0 + e1 * (1 - q / c), from which the
+    /// inner resistance times the smoothed current is subtracted.
+    class GZ_COMMON_VISIBLE LinearBatteryModel
+    {
+      /// \brief Open circuit voltage at full charge, minus e1.
+      public: double e0 = 0.0;
+
+      /// \brief Open circuit voltage lost at empty charge.
+      public: double e1 = 0.0;
+
+      /// \brief Battery capacity in Ah.
+      public: double c = 0.0;
+
+      /// \brief Battery inner resistance in Ohm.
+      public: double r = 0.0;
+
+      /// \brief Current low-pass filter characteristic time in seconds.
+      public: double tau = 0.0;
+
+      /// \brief Instantaneous battery charge in Ah.
+      public: double q = 0.0;
+
+      /// \brief Raw battery current in A.
+      public: double iraw = 0.0;
+
+      /// \brief Smoothed battery current in A.
+      public: double ismooth = 0.0;
+    };
+
+    /// \class PowerSystem PowerSystem.hh common/common.hh
+    /// \brief Updates the batteries of a world in one pass.
+    ///
+    /// Each battery added to the system keeps its API: its voltage and
+    /// power loads are read and set on the Battery as before. The system
+    /// holds the batteries, the sum of their power loads and the state of
+    /// their models in arrays, and updates all of them in a single loop,
+    /// at the rate set by SetUpdatePeriod. Batteries with a linear model
+    /// are updated in that loop, the ones with a custom update function
+    /// call it, and the ideal ones are skipped.
+    class GZ_COMMON_VISIBLE PowerSystem
+    {
+      /// \brief Constructor.
+      public: PowerSystem();
+
+      /// \brief Destructor. The batteries are detached.
+      public: ~PowerSystem();
+
+      /// \brief Add a battery, which is then updated by the system instead
+      /// of Battery::Update. A battery belongs to a single system, and is
+      /// removed when it is destroyed.
+      /// \param[in] _battery The battery.
+      public: void Add(const BatteryPtr &_battery);
+
+      /// \brief Remove a battery.
+      /// \param[in] _battery The battery.
+      /// \return False if the battery wasn't added to this system.
+      public: bool Remove(const BatteryPtr &_battery);
+
+      /// \brief Get the number of batteries.
+      /// \return The number of batteries added to the system.
+      public: size_t BatteryCount() const;
+
+      /// \brief Update the voltage of a battery with a linear model,
+      /// instead of its update function.
+      /// \param[in] _battery The battery, which must have been added.
+      /// \param[in] _model Parameters and initial state of the model.
+      /// \return False if the battery wasn't added to this system.
+      public: bool SetLinearModel(const BatteryPtr &_battery,
+                  const LinearBatteryModel &_model);
+
+      /// \brief Get the linear model of a battery.
+      /// \param[in] _battery The battery.
+      /// \param[out] _model Parameters and current state of the model.
+      /// \return False if the battery wasn't added to this system, or has
+      /// no linear model.
+      public: bool LinearModel(const BatteryPtr &_battery,
+                  LinearBatteryModel &_model) const;
+
+      /// \brief Set the time between two updates.
+      /// \param[in] _period Period in seconds, 0 to update at each call to
+      /// Update.
+      public: void SetUpdatePeriod(const double _period);
+
+      /// \brief Get the time between two updates.
+      /// \return Period in seconds, 0 when updated at each call to Update.
+      public: double UpdatePeriod() const;
+
+      /// \brief Advance the time, and update the batteries when the period
+      /// has elapsed since the last update.
+      /// \param[in] _dt Time elapsed since the last call, in seconds.
+      public: void Update(const double _dt);
+
+      /// \brief Forget the time elapsed since the last update.
+      public: void Reset();
+
+      /// \brief Remove a battery, called when it is destroyed.
+      /// \param[in] _battery The battery, which belongs to this system.
+      private: void RemoveBattery(Battery *_battery);
+
+      /// \brief The batteries remove themselves when destroyed.
+      private: friend class Battery;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<PowerSystemPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
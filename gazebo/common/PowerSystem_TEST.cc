@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "gazebo/common/Battery.hh"
+#include "gazebo/common/PowerSystem.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class PowerSystemTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief Load a battery with an initial voltage.
+/// \param[in] _voltage Initial voltage.
+/// \return The battery.
+common::BatteryPtr NewBattery(const double _voltage)
+{
+  std::ostringstream batteryStr;
+  batteryStr << "<sdf version ='" << SDF_VERSION << "'>"
+    << "<model name='model'>"
+    << "<link name ='link'>"
+    <<   "<battery name='battery'>"
+    <<     "<voltage>" << _voltage << "</voltage>"
+    <<   "</battery>"
+    << "</link>"
+    << "</model>"
+    << "</sdf>";
+
+  sdf::SDFPtr batterySDF(new sdf::SDF);
+  batterySDF->SetFromString(batteryStr.str());
+
+  common::BatteryPtr battery(new common::Battery());
+  battery->Load(batterySDF->Root()->GetElement("model")->GetElement(
+        "link")->GetElement("battery"));
+  battery->Init();
+  return battery;
+}
+
+/////////////////////////////////////////////////
+TEST_F(PowerSystemTest, AddRemove)
+{
+  common::PowerSystem system;
+  EXPECT_EQ(system.BatteryCount(), 0u);
+
+  common::BatteryPtr battery1 = NewBattery(12.0);
+  common::BatteryPtr battery2 = NewBattery(24.0);
+  system.Add(battery1);
+  system.Add(battery2);
+  system.Add(battery2);
+  EXPECT_EQ(system.BatteryCount(), 2u);
+
+  // A battery belongs to a single system
+  common::PowerSystem other;
+  other.Add(battery1);
+  EXPECT_EQ(other.BatteryCount(), 0u);
+  EXPECT_FALSE(other.Remove(battery1));
+
+  // The last battery takes the place of the removed one
+  common::LinearBatteryModel model;
+  model.q = 1.0;
+  EXPECT_TRUE(system.SetLinearModel(battery2, model));
+  EXPECT_TRUE(system.Remove(battery1));
+  EXPECT_FALSE(system.Remove(battery1));
+  EXPECT_EQ(system.BatteryCount(), 1u);
+  EXPECT_TRUE(system.LinearModel(battery2, model));
+  EXPECT_DOUBLE_EQ(model.q, 1.0);
+  EXPECT_FALSE(system.LinearModel(battery1, model));
+
+  // Destroyed batteries are removed
+  battery2.reset();
+  EXPECT_EQ(system.BatteryCount(), 0u);
+
+  // Batteries outlive their system
+  {
+    common::PowerSystem shortLived;
+    shortLived.Add(battery1);
+  }
+  other.Add(battery1);
+  EXPECT_EQ(other.BatteryCount(), 1u);
+}
+
+/////////////////////////////////////////////////
+TEST_F(PowerSystemTest, Update)
+{
+  common::PowerSystem system;
+
+  // Ideal battery
+  common::BatteryPtr ideal = NewBattery(12.0);
+  system.Add(ideal);
+
+  // Battery with an update function
+  int calls = 0;
+  common::BatteryPtr custom = NewBattery(12.0);
+  custom->SetUpdateFunc([&calls](const common::BatteryPtr &_battery)
+      {
+        ++calls;
+        return _battery->Voltage() - 0.1;
+      });
+  system.Add(custom);
+
+  // Linear battery
+  common::BatteryPtr linear = NewBattery(12.6);
+  uint32_t consumer = linear->AddConsumer();
+  EXPECT_TRUE(linear->SetPowerLoad(consumer, 6.0));
+  system.Add(linear);
+  common::LinearBatteryModel model;
+  model.e0 = 12.0;
+  model.e1 = 0.6;
+  model.c = 1.0;
+  model.r = 0.1;
+  model.tau = 1.0;
+  model.q = 1.0;
+  EXPECT_TRUE(system.SetLinearModel(linear, model));
+
+  const double dt = 0.01;
+  for (int i = 0; i < 10; ++i)
+    system.Update(dt);
+
+  EXPECT_DOUBLE_EQ(ideal->Voltage(), 12.0);
+  EXPECT_EQ(calls, 10);
+  EXPECT_NEAR(custom->Voltage(), 11.0, 1e-9);
+
+  // Same arithmetic as the linear battery plugin
+  double voltage = 12.6;
+  double ismooth = 0.0;
+  double q = 1.0;
+  for (int i = 0; i < 10; ++i)
+  {
+    double iraw = 6.0 / voltage;
+    ismooth += dt / model.tau * (iraw - ismooth);
+    q -= dt * ismooth / 3600.0;
+    voltage = model.e0 + model.e1 * (1 - q / model.c) - model.r * ismooth;
+  }
+  EXPECT_NEAR(linear->Voltage(), voltage, 1e-9);
+  EXPECT_TRUE(system.LinearModel(linear, model));
+  EXPECT_NEAR(model.ismooth, ismooth, 1e-9);
+  EXPECT_NEAR(model.q, q, 1e-12);
+
+  // An update function set afterwards replaces the model
+  linear->SetUpdateFunc([](const common::BatteryPtr &)
+      {
+        return 5.0;
+      });
+  system.Update(dt);
+  EXPECT_DOUBLE_EQ(linear->Voltage(), 5.0);
+}
+
+/////////////////////////////////////////////////
+TEST_F(PowerSystemTest, UpdatePeriod)
+{
+  common::PowerSystem system;
+  EXPECT_DOUBLE_EQ(system.UpdatePeriod(), 0.0);
+  system.SetUpdatePeriod(0.1);
+  EXPECT_DOUBLE_EQ(system.UpdatePeriod(), 0.1);
+
+  common::BatteryPtr battery = NewBattery(12.0);
+  int calls = 0;
+  battery->SetUpdateFunc([&calls](const common::BatteryPtr &_battery)
+      {
+        ++calls;
+        return _battery->Voltage();
+      });
+  system.Add(battery);
+
+  // Updated once every 10 steps of 0.01 s
+  for (int i = 0; i < 95; ++i)
+    system.Update(0.01);
+  EXPECT_EQ(calls, 9);
+
+  // Reset forgets the time since the last update
+  system.Reset();
+  for (int i = 0; i < 9; ++i)
+    system.Update(0.01);
+  EXPECT_EQ(calls, 9);
+  system.Update(0.011);
+  EXPECT_EQ(calls, 10);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
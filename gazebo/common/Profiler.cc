@@ -0,0 +1,298 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#include "gazebo/common/CommonIface.hh"
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Profiler.hh"
+
+using namespace gazebo;
+using namespace common;
+
+namespace
+{
+  /// \brief Number of events kept for each thread.
+  const uint64_t kEventsPerThread = 1 << 16;
+
+  /// \brief An event of a zone.
+  class ProfilerEvent
+  {
+    /// \brief Id of the zone.
+    public: uint32_t zone;
+
+    /// \brief Start, in nanoseconds.
+    public: int64_t start;
+
+    /// \brief End, in nanoseconds.
+    public: int64_t end;
+  };
+
+  /// \brief Ring buffer of the events of a thread. Only its thread writes
+  /// events, and the other threads read them.
+  class ProfilerRing
+  {
+    /// \brief Constructor.
+    /// \param[in] _thread Id of the thread in the trace.
+    public: explicit ProfilerRing(const uint32_t _thread)
+            : thread(_thread), events(kEventsPerThread)
+            {
+            }
+
+    /// \brief Id of the thread in the trace.
+    public: const uint32_t thread;
+
+    /// \brief The events, event i at index i % kEventsPerThread.
+    public: std::vector<ProfilerEvent> events;
+
+    /// \brief Number of events written since the thread started.
+    public: std::atomic<uint64_t> head{0};
+
+    /// \brief Number of events discarded by Profiler::Clear.
+    public: std::atomic<uint64_t> tail{0};
+  };
+
+  /// \brief The zones and the rings of all the threads.
+  class ProfilerRegistry
+  {
+    /// \brief Protects zones and rings.
+    public: std::mutex mutex;
+
+    /// \brief Names of the zones, by id.
+    public: std::vector<const char *> zones;
+
+    /// \brief Rings of the threads, which outlive their thread so that
+    /// its events can be written.
+    public: std::vector<std::shared_ptr<ProfilerRing>> rings;
+  };
+
+  /// \brief Get the registry, which zones of static objects may use
+  /// before main.
+  /// \return The registry.
+  ProfilerRegistry &Registry()
+  {
+    static ProfilerRegistry registry;
+    return registry;
+  }
+
+  /// \brief Get the ring of the calling thread, created on its first
+  /// event.
+  /// \return The ring.
+  ProfilerRing &ThreadRing()
+  {
+    thread_local std::shared_ptr<ProfilerRing> ring;
+    if (!ring)
+    {
+      ProfilerRegistry &registry = Registry();
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      ring = std::make_shared<ProfilerRing>(registry.rings.size());
+      registry.rings.push_back(ring);
+    }
+    return *ring;
+  }
+
+  /// \brief Copy the events of a ring which aren't cleared.
+  /// \param[in] _ring The ring.
+  /// \param[out] _events The events, oldest first.
+  void CopyEvents(const ProfilerRing &_ring,
+      std::vector<ProfilerEvent> &_events)
+  {
+    const uint64_t head = _ring.head.load(std::memory_order_acquire);
+    uint64_t first = _ring.tail.load(std::memory_order_relaxed);
+    if (head > kEventsPerThread)
+      first = std::max(first, head - kEventsPerThread);
+
+    _events.clear();
+    for (uint64_t i = first; i < head; ++i)
+      _events.push_back(_ring.events[i % kEventsPerThread]);
+
+    // Drop the events the thread overwrote while they were copied
+    const uint64_t newHead = _ring.head.load(std::memory_order_acquire);
+    if (newHead > kEventsPerThread && newHead - kEventsPerThread > first)
+    {
+      const uint64_t overwritten = std::min<uint64_t>(
+          newHead - kEventsPerThread - first, _events.size());
+      _events.erase(_events.begin(), _events.begin() + overwritten);
+    }
+  }
+
+  /// \brief Get the rings of all the threads.
+  /// \return The rings.
+  std::vector<std::shared_ptr<ProfilerRing>> Rings()
+  {
+    ProfilerRegistry &registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return registry.rings;
+  }
+
+  /// \brief Get whether GAZEBO_PROFILER enables the profiler.
+  /// \return True if it's enabled.
+  bool EnabledByEnv()
+  {
+    const char *env = common::getEnv("GAZEBO_PROFILER");
+    return env && std::string(env) == "1";
+  }
+}
+
+std::atomic<bool> Profiler::enabled(EnabledByEnv());
+
+//////////////////////////////////////////////////
+void Profiler::SetEnabled(const bool _enabled)
+{
+  enabled = _enabled;
+}
+
+//////////////////////////////////////////////////
+uint32_t Profiler::RegisterZone(const char *_name)
+{
+  ProfilerRegistry &registry = Registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.zones.push_back(_name);
+  return registry.zones.size() - 1;
+}
+
+//////////////////////////////////////////////////
+void Profiler::Record(const uint32_t _zone, const int64_t _start,
+    const int64_t _end)
+{
+  ProfilerRing &ring = ThreadRing();
+  const uint64_t head = ring.head.load(std::memory_order_relaxed);
+  ProfilerEvent &event = ring.events[head % kEventsPerThread];
+  event.zone = _zone;
+  event.start = _start;
+  event.end = _end;
+  ring.head.store(head + 1, std::memory_order_release);
+}
+
+//////////////////////////////////////////////////
+int64_t Profiler::Now()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//////////////////////////////////////////////////
+std::size_t Profiler::EventCount()
+{
+  std::size_t count = 0;
+  std::vector<ProfilerEvent> events;
+  for (const auto &ring : Rings())
+  {
+    CopyEvents(*ring, events);
+    count += events.size();
+  }
+  return count;
+}
+
+//////////////////////////////////////////////////
+std::map<std::string, double> Profiler::ZoneTotals()
+{
+  std::vector<const char *> zones;
+  {
+    ProfilerRegistry &registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    zones = registry.zones;
+  }
+
+  std::map<std::string, double> totals;
+  std::vector<ProfilerEvent> events;
+  for (const auto &ring : Rings())
+  {
+    CopyEvents(*ring, events);
+    for (const auto &event : events)
+      totals[zones[event.zone]] += (event.end - event.start) * 1e-9;
+  }
+  return totals;
+}
+
+//////////////////////////////////////////////////
+void Profiler::Clear()
+{
+  for (const auto &ring : Rings())
+    ring->tail = ring->head.load();
+}
+
+//////////////////////////////////////////////////
+std::string Profiler::ChromeTrace()
+{
+  const auto rings = Rings();
+  std::vector<const char *> zones;
+  {
+    ProfilerRegistry &registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    zones = registry.zones;
+  }
+
+  std::vector<std::vector<ProfilerEvent>> events(rings.size());
+  int64_t origin = std::numeric_limits<int64_t>::max();
+  for (std::size_t i = 0; i < rings.size(); ++i)
+  {
+    CopyEvents(*rings[i], events[i]);
+    for (const auto &event : events[i])
+      origin = std::min(origin, event.start);
+  }
+
+  // Complete events, with times in microseconds since the first event
+  std::ostringstream stream;
+  stream << std::fixed << std::setprecision(3);
+  stream << "{\"traceEvents\":[";
+  bool first = true;
+  for (std::size_t i = 0; i < rings.size(); ++i)
+  {
+    for (const auto &event : events[i])
+    {
+      if (!first)
+        stream << ",";
+      first = false;
+
+      stream << "\n{\"name\":\"";
+      for (const char *c = zones[event.zone]; *c; ++c)
+      {
+        if (*c == '"' || *c == '\\')
+          stream << '\\';
+        stream << *c;
+      }
+      stream << "\",\"cat\":\"gazebo\",\"ph\":\"X\""
+             << ",\"ts\":" << (event.start - origin) * 1e-3
+             << ",\"dur\":" << (event.end - event.start) * 1e-3
+             << ",\"pid\":0,\"tid\":" << rings[i]->thread << "}";
+    }
+  }
+  stream << "\n]}\n";
+  return stream.str();
+}
+
+//////////////////////////////////////////////////
+bool Profiler::WriteChromeTrace(const std::string &_filename)
+{
+  std::ofstream file(_filename);
+  if (!file.is_open())
+  {
+    gzerr << "Unable to open profiler trace file[" << _filename << "]\n";
+    return false;
+  }
+  file << ChromeTrace();
+  return file.good();
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_PROFILER_HH_
+#define GAZEBO_COMMON_PROFILER_HH_
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "gazebo/util/system.hh"
+
+/// \brief Concatenate two tokens, after expanding them.
+#define GZ_PROFILE_CONCAT_IMPL(_a, _b) _a##_b
+#define GZ_PROFILE_CONCAT(_a, _b) GZ_PROFILE_CONCAT_IMPL(_a, _b)
+
+/// \brief Profile the enclosing block as a zone named _name, which must be
+/// a string literal. The zone is registered the first time the block runs.
+/// When the profiler is disabled, the cost of the block is one load of a
+/// flag. Blocks nest, such as a GZ_PROFILE in World::Update around the
+/// ones in the physics engine.
+/// \param[in] _name Name of the zone.
+#define GZ_PROFILE(_name) \
+  static const gazebo::common::ProfilerZone \
+      GZ_PROFILE_CONCAT(gzProfilerZone, __LINE__)(_name); \
+  const gazebo::common::ProfilerScope \
+      GZ_PROFILE_CONCAT(gzProfilerScope, __LINE__)( \
+          GZ_PROFILE_CONCAT(gzProfilerZone, __LINE__))
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \addtogroup gazebo_common
+    /// \{
+
+    /// \class Profiler Profiler.hh common/common.hh
+    /// \brief A profiler for release builds, which records the times spent
+    /// in the zones marked with GZ_PROFILE.
+    ///
+    /// Each thread records its events in its own ring buffer, without
+    /// locking, and keeps the latest ones when the buffer is full. The
+    /// events can be written in the Chrome trace format, which
+    /// chrome://tracing and Perfetto open, and Tracy imports.
+    ///
+    /// \remarks Environment Variables:
+    /// GAZEBO_PROFILER: Set to 1 to enable the profiler at startup. It
+    /// can also be enabled at runtime with SetEnabled, or by publishing
+    /// "start" and "stop" on the ~/profiler topic of a world.
+    class GZ_COMMON_VISIBLE Profiler
+    {
+      /// \brief Get whether the profiler records events.
+      /// \return True if enabled.
+      public: static bool Enabled()
+              {
+                return enabled.load(std::memory_order_relaxed);
+              }
+
+      /// \brief Enable or disable the profiler. Events recorded while it
+      /// was enabled are kept.
+      /// \param[in] _enabled True to record events.
+      public: static void SetEnabled(const bool _enabled);
+
+      /// \brief Register a zone. Called by ProfilerZone.
+      /// \param[in] _name Name of the zone, which must outlive the
+      /// profiler, such as a string literal.
+      /// \return Id of the zone.
+      public: static uint32_t RegisterZone(const char *_name);
+
+      /// \brief Record an event of the calling thread.
+      /// \param[in] _zone Id of the zone.
+      /// \param[in] _start Start of the event, in nanoseconds.
+      /// \param[in] _end End of the event, in nanoseconds.
+      public: static void Record(const uint32_t _zone, const int64_t _start,
+                  const int64_t _end);
+
+      /// \brief Get the time of the profiler clock.
+      /// \return Nanoseconds since an arbitrary epoch.
+      public: static int64_t Now();
+
+      /// \brief Get the number of events held by the ring buffers of all
+      /// threads.
+      /// \return The number of events.
+      public: static std::size_t EventCount();
+
+      /// \brief Get the total time of the events of each zone held by the
+      /// ring buffers of all threads. Nested zones are counted in each
+      /// zone that contains them.
+      /// \return Seconds by zone name.
+      public: static std::map<std::string, double> ZoneTotals();
+
+      /// \brief Discard the recorded events.
+      public: static void Clear();
+
+      /// \brief Write the recorded events in the Chrome trace format.
+      /// \param[in] _filename File to write.
+      /// \return True on success.
+      public: static bool WriteChromeTrace(const std::string &_filename);
+
+      /// \brief Get the recorded events in the Chrome trace format.
+      /// \return JSON trace.
+      public: static std::string ChromeTrace();
+
+      /// \brief True if events are recorded.
+      private: static std::atomic<bool> enabled;
+    };
+
+    /// \class ProfilerZone Profiler.hh common/common.hh
+    /// \brief A registered profiler zone, which GZ_PROFILE declares as a
+    /// static variable.
+    class GZ_COMMON_VISIBLE ProfilerZone
+    {
+      /// \brief Constructor.
+      /// \param[in] _name Name of the zone, a string literal.
+      public: explicit ProfilerZone(const char *_name)
+              : id(Profiler::RegisterZone(_name))
+              {
+              }
+
+      /// \brief Id of the zone.
+      public: const uint32_t id;
+    };
+
+    /// \class ProfilerScope Profiler.hh common/common.hh
+    /// \brief Records an event of a zone from its construction to its
+    /// destruction, if the profiler is enabled at construction.
+    class GZ_COMMON_VISIBLE ProfilerScope
+    {
+      /// \brief Constructor.
+      /// \param[in] _zone The zone.
+      public: explicit ProfilerScope(const ProfilerZone &_zone)
+              : zone(_zone.id),
+                start(Profiler::Enabled() ? Profiler::Now() : -1)
+              {
+              }
+
+      /// \brief Destructor, which records the event.
+      public: ~ProfilerScope()
+              {
+                if (this->start >= 0)
+                  Profiler::Record(this->zone, this->start, Profiler::Now());
+              }
+
+      /// \brief Id of the zone.
+      private: const uint32_t zone;
+
+      /// \brief Start of the event, or -1 if it isn't recorded.
+      private: const int64_t start;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include "gazebo/common/CommonIface.hh"
+#include "gazebo/common/Profiler.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class ProfilerTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+void ProfiledInner()
+{
+  GZ_PROFILE("ProfilerTest::Inner");
+}
+
+/////////////////////////////////////////////////
+void ProfiledOuter()
+{
+  GZ_PROFILE("ProfilerTest::Outer");
+  ProfiledInner();
+  ProfiledInner();
+}
+
+/////////////////////////////////////////////////
+TEST_F(ProfilerTest, Disabled)
+{
+  common::Profiler::SetEnabled(false);
+  common::Profiler::Clear();
+
+  ProfiledOuter();
+  EXPECT_EQ(0u, common::Profiler::EventCount());
+}
+
+/////////////////////////////////////////////////
+TEST_F(ProfilerTest, Nested)
+{
+  common::Profiler::Clear();
+  common::Profiler::SetEnabled(true);
+  ProfiledOuter();
+  common::Profiler::SetEnabled(false);
+
+  // The inner zones end before the outer one, and are recorded first
+  EXPECT_EQ(3u, common::Profiler::EventCount());
+  const std::string trace = common::Profiler::ChromeTrace();
+  const std::size_t inner = trace.find("ProfilerTest::Inner");
+  const std::size_t outer = trace.find("ProfilerTest::Outer");
+  ASSERT_NE(std::string::npos, inner);
+  ASSERT_NE(std::string::npos, outer);
+  EXPECT_LT(inner, outer);
+  EXPECT_EQ(0u, trace.find("{\"traceEvents\":["));
+
+  // Totals by zone, the outer one containing the inner ones
+  const auto totals = common::Profiler::ZoneTotals();
+  ASSERT_EQ(1u, totals.count("ProfilerTest::Inner"));
+  ASSERT_EQ(1u, totals.count("ProfilerTest::Outer"));
+  EXPECT_GE(totals.at("ProfilerTest::Outer"),
+      totals.at("ProfilerTest::Inner"));
+
+  common::Profiler::Clear();
+  EXPECT_EQ(0u, common::Profiler::EventCount());
+  EXPECT_TRUE(common::Profiler::ZoneTotals().empty());
+}
+
+/////////////////////////////////////////////////
+TEST_F(ProfilerTest, Threads)
+{
+  common::Profiler::Clear();
+  common::Profiler::SetEnabled(true);
+
+  // Events of exited threads are kept
+  std::thread thread([]()
+      {
+        for (unsigned int i = 0; i < 10; ++i)
+          ProfiledInner();
+      });
+  ProfiledInner();
+  thread.join();
+  common::Profiler::SetEnabled(false);
+
+  EXPECT_EQ(11u, common::Profiler::EventCount());
+
+  // A full ring keeps the latest events
+  common::Profiler::Clear();
+  common::Profiler::SetEnabled(true);
+  for (unsigned int i = 0; i < 100000; ++i)
+    ProfiledInner();
+  common::Profiler::SetEnabled(false);
+  EXPECT_EQ(65536u, common::Profiler::EventCount());
+
+  // The trace can be written
+  const std::string filename = common::cwd() + "/profiler_trace.json";
+  EXPECT_TRUE(common::Profiler::WriteChromeTrace(filename));
+  std::remove(filename.c_str());
+  common::Profiler::Clear();
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifdef __linux__
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/RealTime.hh"
+
+using namespace gazebo;
+using namespace common;
+
+#ifdef __linux__
+namespace
+{
+  /// \brief Get the CPUs the process may run on.
+  /// \param[out] _set The CPUs.
+  void AllCpus(cpu_set_t &_set)
+  {
+    CPU_ZERO(&_set);
+    const long count = sysconf(_SC_NPROCESSORS_CONF);
+    for (long i = 0; i < count && i < CPU_SETSIZE; ++i)
+      CPU_SET(i, &_set);
+  }
+}
+#endif
+
+//////////////////////////////////////////////////
+bool RealTime::PinCurrentThread(const int _cpu, const int _priority)
+{
+#ifdef __linux__
+  if (_cpu < 0 || _cpu >= CPU_SETSIZE ||
+      _cpu >= sysconf(_SC_NPROCESSORS_CONF))
+  {
+    gzerr << "Invalid real time CPU[" << _cpu << "]\n";
+    return false;
+  }
+
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(_cpu, &set);
+  int result = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  if (result != 0)
+  {
+    gzerr << "Unable to pin thread to CPU[" << _cpu << "]: "
+          << strerror(result) << "\n";
+    return false;
+  }
+
+  if (_priority > 0)
+  {
+    sched_param param;
+    param.sched_priority = std::max(sched_get_priority_min(SCHED_FIFO),
+        std::min(_priority, sched_get_priority_max(SCHED_FIFO)));
+    result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (result == EPERM)
+    {
+      gzwarn << "Not allowed to use SCHED_FIFO, the real time thread keeps "
+             << "its scheduling policy. Grant CAP_SYS_NICE or an rtprio "
+             << "limit to use it.\n";
+    }
+    else if (result != 0)
+    {
+      gzwarn << "Unable to use SCHED_FIFO: " << strerror(result) << "\n";
+    }
+  }
+  return true;
+#else
+  gzwarn << "Real time thread placement is only supported on Linux\n";
+  return false;
+#endif
+}
+
+//////////////////////////////////////////////////
+void RealTime::UnpinCurrentThread()
+{
+#ifdef __linux__
+  sched_param param;
+  param.sched_priority = 0;
+  pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+
+  cpu_set_t set;
+  AllCpus(set);
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+//////////////////////////////////////////////////
+unsigned int RealTime::MoveOtherThreads(const int _cpu)
+{
+  unsigned int moved = 0;
+#ifdef __linux__
+  if (_cpu < 0 || _cpu >= CPU_SETSIZE)
+    return 0;
+
+  cpu_set_t others;
+  AllCpus(others);
+  CPU_CLR(_cpu, &others);
+  if (CPU_COUNT(&others) == 0)
+  {
+    gzwarn << "Only one CPU, other threads can't be moved off CPU["
+           << _cpu << "]\n";
+    return 0;
+  }
+
+  DIR *dir = opendir("/proc/self/task");
+  if (!dir)
+  {
+    gzwarn << "Unable to list the threads of the process\n";
+    return 0;
+  }
+
+  const pid_t self = static_cast<pid_t>(syscall(SYS_gettid));
+  while (dirent *entry = readdir(dir))
+  {
+    const pid_t tid = static_cast<pid_t>(std::atoi(entry->d_name));
+    if (tid <= 0 || tid == self)
+      continue;
+
+    // A thread pinned to the CPU alone was created by the real time
+    // thread, and may have inherited its policy too
+    cpu_set_t current;
+    const bool inherited =
+      sched_getaffinity(tid, sizeof(current), &current) == 0 &&
+      CPU_COUNT(&current) == 1 && CPU_ISSET(_cpu, &current);
+
+    if (sched_setaffinity(tid, sizeof(others), &others) != 0)
+      continue;
+    ++moved;
+
+    if (inherited && sched_getscheduler(tid) == SCHED_FIFO)
+    {
+      sched_param param;
+      param.sched_priority = 0;
+      sched_setscheduler(tid, SCHED_OTHER, &param);
+    }
+  }
+  closedir(dir);
+#else
+  (void)_cpu;
+#endif
+  return moved;
+}
+
+//////////////////////////////////////////////////
+int64_t RealTime::Now()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//////////////////////////////////////////////////
+void RealTime::WaitUntil(const int64_t _deadline, const int64_t _spin)
+{
+  const int64_t wake = _deadline - std::max<int64_t>(_spin, 0);
+  if (Now() < wake)
+  {
+#ifdef __linux__
+    // An absolute deadline doesn't drift when the sleep is interrupted
+    timespec ts;
+    ts.tv_sec = wake / 1000000000;
+    ts.tv_nsec = wake % 1000000000;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) ==
+        EINTR)
+    {
+    }
+#else
+    std::this_thread::sleep_until(std::chrono::steady_clock::time_point(
+          std::chrono::nanoseconds(wake)));
+#endif
+  }
+
+  while (Now() < _deadline)
+  {
+  }
+}
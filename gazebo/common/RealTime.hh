@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_REALTIME_HH_
+#define GAZEBO_COMMON_REALTIME_HH_
+
+#include <cstdint>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \addtogroup gazebo_common
+    /// \{
+
+    /// \class RealTime RealTime.hh common/common.hh
+    /// \brief Thread placement and deadline waits for threads which must
+    /// run at a fixed rate, such as the physics thread of a world in real
+    /// time mode.
+    ///
+    /// CPU affinity and SCHED_FIFO are only supported on Linux. Elsewhere,
+    /// the placement functions return false and the waits fall back to
+    /// the standard library.
+    class GZ_COMMON_VISIBLE RealTime
+    {
+      /// \brief Pin the calling thread to a CPU and, if _priority is
+      /// positive, run it with the SCHED_FIFO policy. Without the
+      /// privilege to change the policy, e.g. CAP_SYS_NICE or an rtprio
+      /// limit, the thread is pinned and keeps its policy.
+      /// \param[in] _cpu Index of the CPU.
+      /// \param[in] _priority SCHED_FIFO priority, clamped to the range of
+      /// the policy, or 0 to keep the policy.
+      /// \return True if the thread was pinned.
+      public: static bool PinCurrentThread(const int _cpu,
+                  const int _priority);
+
+      /// \brief Let the calling thread run on all CPUs with the default
+      /// policy, undoing PinCurrentThread.
+      public: static void UnpinCurrentThread();
+
+      /// \brief Keep the other threads of the process off a CPU. The
+      /// threads they create later inherit their affinity. Threads which
+      /// inherited the affinity and the SCHED_FIFO policy of a thread
+      /// pinned to the CPU get the default policy back.
+      /// \param[in] _cpu Index of the CPU.
+      /// \return Number of threads moved.
+      public: static unsigned int MoveOtherThreads(const int _cpu);
+
+      /// \brief Get the time of the monotonic clock, the clock of
+      /// std::chrono::steady_clock.
+      /// \return Nanoseconds since an arbitrary epoch.
+      public: static int64_t Now();
+
+      /// \brief Wait until a time of the monotonic clock. The thread
+      /// sleeps until _spin before the deadline, which absorbs the wake
+      /// up latency of the scheduler, then spins until the deadline.
+      /// \param[in] _deadline Deadline, in nanoseconds of Now().
+      /// \param[in] _spin Nanoseconds spent spinning before the deadline.
+      public: static void WaitUntil(const int64_t _deadline,
+                  const int64_t _spin);
+    };
+    /// \}
+  }
+}
+#endif
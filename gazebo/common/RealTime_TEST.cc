@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "gazebo/common/RealTime.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class RealTimeTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(RealTimeTest, WaitUntil)
+{
+  // Deadlines in the past return at once
+  int64_t start = common::RealTime::Now();
+  common::RealTime::WaitUntil(start - 1000000, 0);
+  EXPECT_LT(common::RealTime::Now() - start, 1000000);
+
+  // Never early, with or without spinning
+  for (const int64_t spin : {int64_t(0), int64_t(200000)})
+  {
+    start = common::RealTime::Now();
+    const int64_t deadline = start + 2000000;
+    common::RealTime::WaitUntil(deadline, spin);
+    const int64_t end = common::RealTime::Now();
+    EXPECT_GE(end, deadline);
+    EXPECT_LT(end - deadline, 100000000);
+  }
+}
+
+#ifdef __linux__
+/////////////////////////////////////////////////
+TEST_F(RealTimeTest, Placement)
+{
+  EXPECT_FALSE(common::RealTime::PinCurrentThread(-1, 0));
+
+  // Needs two of the CPUs the test may run on
+  cpu_set_t allowed;
+  ASSERT_EQ(0, sched_getaffinity(0, sizeof(allowed), &allowed));
+  if (CPU_COUNT(&allowed) < 2)
+    return;
+  int cpu = 0;
+  while (!CPU_ISSET(cpu, &allowed))
+    ++cpu;
+
+  std::atomic<bool> done(false);
+  std::thread other([&done]()
+      {
+        while (!done)
+          std::this_thread::yield();
+      });
+
+  std::thread pinned([&other, cpu]()
+      {
+        // Without privileges, SCHED_FIFO is refused and the thread is
+        // still pinned
+        ASSERT_TRUE(common::RealTime::PinCurrentThread(cpu, 10));
+        EXPECT_EQ(cpu, sched_getcpu());
+        EXPECT_GE(common::RealTime::MoveOtherThreads(cpu), 1u);
+
+        cpu_set_t set;
+        ASSERT_EQ(0, pthread_getaffinity_np(other.native_handle(),
+              sizeof(set), &set));
+        EXPECT_FALSE(CPU_ISSET(cpu, &set));
+
+        common::RealTime::UnpinCurrentThread();
+        ASSERT_EQ(0, pthread_getaffinity_np(pthread_self(), sizeof(set),
+              &set));
+        EXPECT_GT(CPU_COUNT(&set), 1);
+      });
+  pinned.join();
+
+  done = true;
+  other.join();
+
+  // The main thread was moved too
+  sched_setaffinity(0, sizeof(allowed), &allowed);
+}
+#endif
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
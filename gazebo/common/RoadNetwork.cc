@@ -0,0 +1,649 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <sstream>
+#include <tuple>
+#include <utility>
+
+#include <ignition/math/Helpers.hh>
+#include <ignition/math/Vector2.hh>
+
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/RoadNetwork.hh"
+
+using namespace gazebo;
+using namespace common;
+
+namespace
+{
+  /// \brief Default side of a tile, in meters.
+  const double kDefaultTileSize = 100.0;
+
+  /// \brief Distance under which points are the same, in meters.
+  const double kPointTolerance = 1e-3;
+
+  /// \brief Largest widening of a road in a sharp turn.
+  const double kMaxWidening = 4.0;
+
+  /// \brief Number of batch meshes created in the process, used to name
+  /// them uniquely.
+  std::atomic<uint64_t> meshCount(0);
+
+  /// \brief Triangles of a road or a junction in one batch.
+  class RoadPiece
+  {
+    /// \brief Compare the triangles of two pieces.
+    /// \param[in] _other The other piece.
+    /// \return True if the pieces are the same.
+    public: bool operator==(const RoadPiece &_other) const
+    {
+      return this->vertices == _other.vertices &&
+          this->texCoords == _other.texCoords &&
+          this->indices == _other.indices;
+    }
+
+    /// \brief Vertices.
+    public: std::vector<ignition::math::Vector3d> vertices;
+
+    /// \brief Texture coordinates of the vertices.
+    public: std::vector<ignition::math::Vector2d> texCoords;
+
+    /// \brief Triangle list of vertex indices.
+    public: std::vector<unsigned int> indices;
+  };
+
+  /// \brief Pieces of a road or junction by batch name.
+  typedef std::map<std::string, RoadPiece> RoadPieces;
+
+  /// \brief How a road ends, which depends on the other roads there.
+  class RoadEnd
+  {
+    /// \brief Tangent of the road at the end, along the points. Zero for
+    /// the direction of the end segment.
+    public: ignition::math::Vector3d tangent;
+
+    /// \brief Factor applied to the width at the end.
+    public: double widening = 1.0;
+
+    /// \brief Distance the end is moved along the end segment, to make room
+    /// for a junction.
+    public: double trim = 0.0;
+  };
+
+  /// \brief A road and its cached triangles.
+  class RoadData
+  {
+    /// \brief Points of the middle of the road, without repeated points.
+    public: std::vector<ignition::math::Vector3d> points;
+
+    /// \brief Width of the road.
+    public: double width = 0.0;
+
+    /// \brief Material of the road.
+    public: std::string material;
+
+    /// \brief Everything the triangles depend on, empty until they are
+    /// generated.
+    public: std::string signature;
+
+    /// \brief The triangles.
+    public: RoadPieces pieces;
+  };
+
+  /// \brief A road end, and whether it's the start of the road.
+  typedef std::pair<RoadData *, bool> EndRef;
+
+  /// \brief Point shared by road ends, quantized by kPointTolerance.
+  typedef std::tuple<int64_t, int64_t, int64_t> NodeKey;
+
+  /// \brief Get the node of a point.
+  /// \param[in] _point The point.
+  /// \return The key of the node.
+  NodeKey MakeNodeKey(const ignition::math::Vector3d &_point)
+  {
+    return NodeKey(std::llround(_point.X() / kPointTolerance),
+        std::llround(_point.Y() / kPointTolerance),
+        std::llround(_point.Z() / kPointTolerance));
+  }
+
+  /// \brief Get the name of a batch.
+  /// \param[in] _material Material of the batch.
+  /// \param[in] _point A point of the batch.
+  /// \param[in] _tileSize Side of a tile.
+  /// \return The batch name.
+  std::string BatchName(const std::string &_material,
+      const ignition::math::Vector3d &_point, const double _tileSize)
+  {
+    std::ostringstream stream;
+    stream << _material << "@"
+           << static_cast<int64_t>(std::floor(_point.X() / _tileSize)) << ","
+           << static_cast<int64_t>(std::floor(_point.Y() / _tileSize));
+    return stream.str();
+  }
+
+  /// \brief Get the direction of a road at one of its ends, away from the
+  /// end.
+  /// \param[in] _end The end.
+  /// \return Unit direction of the end segment.
+  ignition::math::Vector3d Inward(const EndRef &_end)
+  {
+    const std::vector<ignition::math::Vector3d> &points = _end.first->points;
+    if (_end.second)
+      return (points[1] - points[0]).Normalized();
+    return (points[points.size() - 2] - points.back()).Normalized();
+  }
+
+  /// \brief Get the length of the end segment of a road.
+  /// \param[in] _end The end.
+  /// \return The length.
+  double EndLength(const EndRef &_end)
+  {
+    const std::vector<ignition::math::Vector3d> &points = _end.first->points;
+    if (_end.second)
+      return points[0].Distance(points[1]);
+    return points.back().Distance(points[points.size() - 2]);
+  }
+
+  /// \brief Get the vertices on either side of a road point.
+  /// \param[in] _point The point.
+  /// \param[in] _tangent Unit tangent of the road at the point.
+  /// \param[in] _width Width of the road at the point.
+  /// \param[out] _left Vertex on the left of the tangent.
+  /// \param[out] _right Vertex on the right of the tangent.
+  void Sides(const ignition::math::Vector3d &_point,
+      const ignition::math::Vector3d &_tangent, const double _width,
+      ignition::math::Vector3d &_left, ignition::math::Vector3d &_right)
+  {
+    const double theta = atan2(_tangent.X(), -_tangent.Y());
+    const ignition::math::Vector3d offset(
+        cos(theta) * _width * 0.5, sin(theta) * _width * 0.5, 0);
+    _left = _point + offset;
+    _right = _point - offset;
+  }
+
+  /// \brief Get everything the triangles of a road depend on.
+  /// \param[in] _road The road.
+  /// \param[in] _start How the road starts.
+  /// \param[in] _end How the road ends.
+  /// \param[in] _tileSize Side of a tile.
+  /// \return The signature.
+  std::string Signature(const RoadData &_road, const RoadEnd &_start,
+      const RoadEnd &_end, const double _tileSize)
+  {
+    std::ostringstream stream;
+    stream << std::setprecision(17) << _road.material << "\n" << _road.width
+           << " " << _tileSize;
+    for (const RoadEnd *end : {&_start, &_end})
+      stream << " " << end->tangent << " " << end->widening << " " << end->trim;
+    for (const auto &point : _road.points)
+      stream << " " << point;
+    return stream.str();
+  }
+
+  /// \brief Generate the triangles of a road, a strip split by tile.
+  /// \param[in] _road The road.
+  /// \param[in] _start How the road starts.
+  /// \param[in] _end How the road ends.
+  /// \param[in] _tileSize Side of a tile.
+  /// \param[out] _pieces The triangles by batch.
+  void GenerateRoad(const RoadData &_road, const RoadEnd &_start,
+      const RoadEnd &_end, const double _tileSize, RoadPieces &_pieces)
+  {
+    _pieces.clear();
+    std::vector<ignition::math::Vector3d> points = _road.points;
+    const size_t count = points.size();
+    if (count < 2 || _road.width <= 0)
+      return;
+
+    points.front() += (points[1] - points[0]).Normalized() * _start.trim;
+    points.back() +=
+        (points[count - 2] - points[count - 1]).Normalized() * _end.trim;
+
+    std::vector<ignition::math::Vector3d> left(count), right(count);
+    std::vector<double> texCoords(count);
+
+    // The texture is square and repeated along the road
+    double length = 0.0;
+    for (size_t i = 0; i < count; ++i)
+    {
+      if (i > 0)
+        length += points[i].Distance(points[i - 1]);
+      texCoords[i] = length / _road.width;
+
+      ignition::math::Vector3d tangent;
+      double widening = 1.0;
+      if (i == 0)
+      {
+        tangent = _start.tangent;
+        widening = _start.widening;
+        if (tangent == ignition::math::Vector3d::Zero)
+          tangent = (points[1] - points[0]).Normalized();
+      }
+      else if (i == count - 1)
+      {
+        tangent = _end.tangent;
+        widening = _end.widening;
+        if (tangent == ignition::math::Vector3d::Zero)
+          tangent = (points[i] - points[i - 1]).Normalized();
+      }
+      else
+      {
+        // The road is widened in the turns, so that its sides stay parallel
+        const auto v1 = (points[i + 1] - points[i]).Normalized();
+        const auto v0 = (points[i] - points[i - 1]).Normalized();
+        const double dot = v0.Dot(-v1);
+        tangent = (v1 + v0).Normalized();
+        if (!ignition::math::equal(std::fabs(dot), 1.0))
+          widening = std::min(1.0 / sin(acos(dot) * 0.5), kMaxWidening);
+      }
+
+      Sides(points[i], tangent, _road.width * widening, left[i], right[i]);
+    }
+
+    // Each segment goes in the tile of its middle
+    for (size_t i = 0; i + 1 < count; ++i)
+    {
+      RoadPiece &piece = _pieces[BatchName(_road.material,
+          (points[i] + points[i + 1]) * 0.5, _tileSize)];
+      const unsigned int base = piece.vertices.size();
+      piece.vertices.insert(piece.vertices.end(),
+          {left[i], right[i], left[i + 1], right[i + 1]});
+      piece.texCoords.insert(piece.texCoords.end(),
+          {ignition::math::Vector2d(0, texCoords[i]),
+           ignition::math::Vector2d(1, texCoords[i]),
+           ignition::math::Vector2d(0, texCoords[i + 1]),
+           ignition::math::Vector2d(1, texCoords[i + 1])});
+      piece.indices.insert(piece.indices.end(),
+          {base, base + 1, base + 2, base + 2, base + 1, base + 3});
+    }
+  }
+
+  /// \brief Join two road ends at the same point along their bisector.
+  /// \param[in] _a First end.
+  /// \param[in] _b Second end.
+  /// \param[out] _endA How the first road ends.
+  /// \param[out] _endB How the second road ends.
+  void JoinEnds(const EndRef &_a, const EndRef &_b, RoadEnd &_endA,
+      RoadEnd &_endB)
+  {
+    const ignition::math::Vector3d inA = Inward(_a);
+    const ignition::math::Vector3d inB = Inward(_b);
+    const double dot = inA.Dot(inB);
+
+    // Roads that double back keep their square ends
+    if (dot > 1.0 - 1e-6)
+      return;
+
+    // Direction of travel from the second road into the first one
+    const ignition::math::Vector3d tangent = (inA - inB).Normalized();
+    double widening = 1.0;
+    if (!ignition::math::equal(std::fabs(dot), 1.0))
+      widening = std::min(1.0 / sin(acos(dot) * 0.5), kMaxWidening);
+
+    _endA.tangent = _a.second ? tangent : -tangent;
+    _endB.tangent = _b.second ? -tangent : tangent;
+    _endA.widening = _endB.widening = widening;
+  }
+
+  /// \brief Trim the ends of three or more roads at the same point, and
+  /// cover the junction with a polygon.
+  /// \param[in] _refs The road ends, the first road sets the material.
+  /// \param[in] _tileSize Side of a tile.
+  /// \param[out] _ends How each road ends.
+  /// \param[out] _pieces Triangles of the junction.
+  void Junction(const std::vector<EndRef> &_refs, const double _tileSize,
+      std::vector<RoadEnd *> &_ends, RoadPieces &_pieces)
+  {
+    double width = 0.0;
+    for (const auto &ref : _refs)
+      width = std::max(width, ref.first->width);
+    if (width <= 0)
+      return;
+
+    const ignition::math::Vector3d center = _refs[0].second ?
+        _refs[0].first->points.front() : _refs[0].first->points.back();
+
+    // The vertices of the trimmed ends, by angle around the junction
+    std::vector<std::pair<double, ignition::math::Vector3d>> sides;
+    for (size_t i = 0; i < _refs.size(); ++i)
+    {
+      _ends[i]->trim = std::min(0.5 * width, 0.5 * EndLength(_refs[i]));
+
+      const ignition::math::Vector3d inward = Inward(_refs[i]);
+      const ignition::math::Vector3d point = (_refs[i].second ?
+          _refs[i].first->points.front() : _refs[i].first->points.back()) +
+          inward * _ends[i]->trim;
+      ignition::math::Vector3d left, right;
+      Sides(point, _refs[i].second ? inward : -inward,
+          _refs[i].first->width, left, right);
+      for (const auto &side : {left, right})
+      {
+        sides.push_back(std::make_pair(
+            atan2(side.Y() - center.Y(), side.X() - center.X()), side));
+      }
+    }
+    std::sort(sides.begin(), sides.end(),
+        [](const std::pair<double, ignition::math::Vector3d> &_a,
+           const std::pair<double, ignition::math::Vector3d> &_b)
+        {
+          return _a.first < _b.first;
+        });
+
+    // Fan around the center, with the texture projected from above
+    RoadPiece &piece =
+        _pieces[BatchName(_refs[0].first->material, center, _tileSize)];
+    piece.vertices.push_back(center);
+    for (const auto &side : sides)
+      piece.vertices.push_back(side.second);
+    for (const auto &vertex : piece.vertices)
+    {
+      piece.texCoords.push_back(ignition::math::Vector2d(
+          (vertex.X() - center.X()) / width + 0.5,
+          (vertex.Y() - center.Y()) / width + 0.5));
+    }
+
+    const unsigned int count = sides.size();
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      const unsigned int next = (i + 1) % count;
+      const ignition::math::Vector3d a = sides[i].second - center;
+      const ignition::math::Vector3d b = sides[next].second - center;
+
+      // Skip the corners shared by two roads, and the gaps of half a turn
+      // or more, which a triangle can't fill
+      if (a.X() * b.Y() - a.Y() * b.X() <= kPointTolerance * kPointTolerance)
+        continue;
+      piece.indices.insert(piece.indices.end(), {0, i + 1, next + 1});
+    }
+  }
+
+  /// \brief Append triangles to a submesh.
+  /// \param[in] _piece The triangles.
+  /// \param[in,out] _subMesh The submesh.
+  void Append(const RoadPiece &_piece, SubMesh &_subMesh)
+  {
+    const unsigned int base = _subMesh.GetVertexCount();
+    for (size_t i = 0; i < _piece.vertices.size(); ++i)
+    {
+      _subMesh.AddVertex(_piece.vertices[i]);
+      _subMesh.AddNormal(ignition::math::Vector3d::UnitZ);
+      _subMesh.AddTexCoord(_piece.texCoords[i].X(), _piece.texCoords[i].Y());
+    }
+    for (const unsigned int index : _piece.indices)
+      _subMesh.AddIndex(base + index);
+  }
+}
+
+/// \brief Private data for the RoadNetwork class.
+class gazebo::common::RoadNetworkPrivate
+{
+  /// \brief Mark the batches of some pieces as changed.
+  /// \param[in] _pieces The pieces.
+  public: void Touch(const RoadPieces &_pieces)
+  {
+    for (const auto &piece : _pieces)
+      this->dirty.insert(piece.first);
+  }
+
+  /// \brief The roads by name.
+  public: std::map<std::string, RoadData> roads;
+
+  /// \brief Triangles of the junctions by node.
+  public: std::map<NodeKey, RoadPieces> junctions;
+
+  /// \brief Meshes of the batches that have triangles.
+  public: std::map<std::string, std::unique_ptr<Mesh>> meshes;
+
+  /// \brief Materials of the batches that have triangles.
+  public: std::map<std::string, std::string> materials;
+
+  /// \brief Batches known to change on the next update.
+  public: std::set<std::string> dirty;
+
+  /// \brief True if roads were set or removed since the last update.
+  public: bool changed = false;
+
+  /// \brief Side of a tile.
+  public: double tileSize = kDefaultTileSize;
+};
+
+//////////////////////////////////////////////////
+RoadNetwork::RoadNetwork()
+  : dataPtr(new RoadNetworkPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+RoadNetwork::~RoadNetwork()
+{
+}
+
+//////////////////////////////////////////////////
+bool RoadNetwork::SetRoad(const std::string &_name,
+    const std::vector<ignition::math::Vector3d> &_points,
+    const double _width, const std::string &_material)
+{
+  std::vector<ignition::math::Vector3d> points;
+  for (const auto &point : _points)
+  {
+    if (points.empty() || points.back().Distance(point) > kPointTolerance)
+      points.push_back(point);
+  }
+
+  auto iter = this->dataPtr->roads.find(_name);
+  if (iter != this->dataPtr->roads.end() &&
+      iter->second.points == points &&
+      ignition::math::equal(iter->second.width, _width) &&
+      iter->second.material == _material)
+  {
+    return false;
+  }
+
+  // The old triangles are replaced on the next update
+  RoadData &road = this->dataPtr->roads[_name];
+  road.points = points;
+  road.width = _width;
+  road.material = _material;
+  this->dataPtr->changed = true;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool RoadNetwork::RemoveRoad(const std::string &_name)
+{
+  auto iter = this->dataPtr->roads.find(_name);
+  if (iter == this->dataPtr->roads.end())
+    return false;
+
+  this->dataPtr->Touch(iter->second.pieces);
+  this->dataPtr->roads.erase(iter);
+  this->dataPtr->changed = true;
+  return true;
+}
+
+//////////////////////////////////////////////////
+size_t RoadNetwork::RoadCount() const
+{
+  return this->dataPtr->roads.size();
+}
+
+//////////////////////////////////////////////////
+void RoadNetwork::SetTileSize(const double _size)
+{
+  if (_size <= 0 || ignition::math::equal(_size, this->dataPtr->tileSize))
+    return;
+
+  this->dataPtr->tileSize = _size;
+  this->dataPtr->changed = true;
+}
+
+//////////////////////////////////////////////////
+double RoadNetwork::TileSize() const
+{
+  return this->dataPtr->tileSize;
+}
+
+//////////////////////////////////////////////////
+std::vector<std::string> RoadNetwork::Update()
+{
+  if (!this->dataPtr->changed)
+    return std::vector<std::string>();
+  this->dataPtr->changed = false;
+
+  // Find the road ends that meet, the roads are visited by name so that
+  // the first road at a junction doesn't depend on the order they were set
+  std::map<NodeKey, std::vector<EndRef>> nodes;
+  std::map<const RoadData *, std::pair<RoadEnd, RoadEnd>> ends;
+  for (auto &road : this->dataPtr->roads)
+  {
+    ends[&road.second];
+    if (road.second.points.size() < 2)
+      continue;
+    nodes[MakeNodeKey(road.second.points.front())].push_back(
+        EndRef(&road.second, true));
+    nodes[MakeNodeKey(road.second.points.back())].push_back(
+        EndRef(&road.second, false));
+  }
+
+  std::map<NodeKey, RoadPieces> junctions;
+  for (const auto &node : nodes)
+  {
+    const std::vector<EndRef> &refs = node.second;
+    std::vector<RoadEnd *> nodeEnds;
+    for (const auto &ref : refs)
+    {
+      auto &roadEnds = ends[ref.first];
+      nodeEnds.push_back(ref.second ? &roadEnds.first : &roadEnds.second);
+    }
+
+    if (refs.size() == 2)
+      JoinEnds(refs[0], refs[1], *nodeEnds[0], *nodeEnds[1]);
+    else if (refs.size() > 2)
+      Junction(refs, this->dataPtr->tileSize, nodeEnds, junctions[node.first]);
+  }
+
+  // Regenerate the roads whose ends or data changed
+  for (auto &entry : this->dataPtr->roads)
+  {
+    RoadData &road = entry.second;
+    const auto &roadEnds = ends[&road];
+    const std::string signature = Signature(road, roadEnds.first,
+        roadEnds.second, this->dataPtr->tileSize);
+    if (signature == road.signature)
+      continue;
+
+    this->dataPtr->Touch(road.pieces);
+    GenerateRoad(road, roadEnds.first, roadEnds.second,
+        this->dataPtr->tileSize, road.pieces);
+    this->dataPtr->Touch(road.pieces);
+    road.signature = signature;
+  }
+
+  // Compare the junctions
+  for (const auto &junction : this->dataPtr->junctions)
+  {
+    auto iter = junctions.find(junction.first);
+    if (iter == junctions.end() || !(iter->second == junction.second))
+      this->dataPtr->Touch(junction.second);
+  }
+  for (const auto &junction : junctions)
+  {
+    auto iter = this->dataPtr->junctions.find(junction.first);
+    if (iter == this->dataPtr->junctions.end() ||
+        !(iter->second == junction.second))
+    {
+      this->dataPtr->Touch(junction.second);
+    }
+  }
+  this->dataPtr->junctions.swap(junctions);
+
+  // Merge the pieces of the changed batches
+  std::map<std::string, SubMesh *> subMeshes;
+  auto append = [&](const RoadPieces &_pieces, const std::string &_material)
+  {
+    for (const auto &piece : _pieces)
+    {
+      if (this->dataPtr->dirty.count(piece.first) == 0)
+        continue;
+
+      SubMesh *&subMesh = subMeshes[piece.first];
+      if (!subMesh)
+      {
+        std::unique_ptr<Mesh> mesh(new Mesh());
+        mesh->SetName("__road_batch_" + std::to_string(++meshCount) + "__");
+        subMesh = new SubMesh();
+        subMesh->SetPrimitiveType(SubMesh::TRIANGLES);
+        mesh->AddSubMesh(subMesh);
+        this->dataPtr->meshes[piece.first] = std::move(mesh);
+        this->dataPtr->materials[piece.first] = _material;
+      }
+      Append(piece.second, *subMesh);
+    }
+  };
+
+  for (const auto &batch : this->dataPtr->dirty)
+  {
+    this->dataPtr->meshes.erase(batch);
+    this->dataPtr->materials.erase(batch);
+  }
+  for (const auto &road : this->dataPtr->roads)
+    append(road.second.pieces, road.second.material);
+  for (const auto &node : nodes)
+  {
+    auto iter = this->dataPtr->junctions.find(node.first);
+    if (iter != this->dataPtr->junctions.end())
+      append(iter->second, node.second[0].first->material);
+  }
+
+  std::vector<std::string> changed(this->dataPtr->dirty.begin(),
+      this->dataPtr->dirty.end());
+  this->dataPtr->dirty.clear();
+  return changed;
+}
+
+//////////////////////////////////////////////////
+std::vector<std::string> RoadNetwork::Batches() const
+{
+  std::vector<std::string> batches;
+  for (const auto &mesh : this->dataPtr->meshes)
+    batches.push_back(mesh.first);
+  return batches;
+}
+
+//////////////////////////////////////////////////
+const Mesh *RoadNetwork::BatchMesh(const std::string &_batch) const
+{
+  auto iter = this->dataPtr->meshes.find(_batch);
+  if (iter == this->dataPtr->meshes.end())
+    return nullptr;
+  return iter->second.get();
+}
+
+//////////////////////////////////////////////////
+std::string RoadNetwork::BatchMaterial(const std::string &_batch) const
+{
+  auto iter = this->dataPtr->materials.find(_batch);
+  if (iter == this->dataPtr->materials.end())
+    return std::string();
+  return iter->second;
+}
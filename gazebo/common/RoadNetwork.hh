@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_ROADNETWORK_HH_
+#define GAZEBO_COMMON_ROADNETWORK_HH_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    class Mesh;
+    class RoadNetworkPrivate;
+
+    /// \addtogroup gazebo_common Common
+    /// \{
+
+    /// \class RoadNetwork RoadNetwork.hh common/common.hh
+    /// \brief Triangle meshes of a set of roads, merged into one mesh per
+    /// material and square tile of the XY plane, so that a city renders
+    /// with a few large batches instead of one per road.
+    ///
+    /// Two road ends at the same point are joined along the bisector of the
+    /// roads, and the ends of three or more roads are trimmed and covered
+    /// by a junction polygon. The triangles of a road are cached until the
+    /// road or one of its neighbors changes, and only the batches they
+    /// belong to are regenerated.
+    class GZ_COMMON_VISIBLE RoadNetwork
+    {
+      /// \brief Constructor, the network is empty.
+      public: RoadNetwork();
+
+      /// \brief Destructor.
+      public: ~RoadNetwork();
+
+      /// \brief Add a road, or replace the road with the same name.
+      /// \param[in] _name Name of the road.
+      /// \param[in] _points Points of the middle of the road. Roads with
+      /// less than two points have no triangles.
+      /// \param[in] _width Width of the road.
+      /// \param[in] _material Name of the material of the road.
+      /// \return True if the road is new or differs from the road it
+      /// replaces.
+      public: bool SetRoad(const std::string &_name,
+                  const std::vector<ignition::math::Vector3d> &_points,
+                  const double _width, const std::string &_material);
+
+      /// \brief Remove a road.
+      /// \param[in] _name Name of the road.
+      /// \return False if there is no road with this name.
+      public: bool RemoveRoad(const std::string &_name);
+
+      /// \brief Get the number of roads.
+      /// \return Number of roads in the network.
+      public: size_t RoadCount() const;
+
+      /// \brief Set the size of the tiles the batches are split in.
+      /// \param[in] _size Side of a tile, in meters. Values that aren't
+      /// positive are ignored.
+      public: void SetTileSize(const double _size);
+
+      /// \brief Get the size of the tiles.
+      /// \return Side of a tile, in meters. The default is 100.
+      public: double TileSize() const;
+
+      /// \brief Regenerate the batches changed by the roads set or removed
+      /// since the last update.
+      /// \return Names of the regenerated batches, whose previous meshes are
+      /// deleted, including the batches that are now empty.
+      public: std::vector<std::string> Update();
+
+      /// \brief Get the names of the batches that have triangles.
+      /// \return The batch names.
+      public: std::vector<std::string> Batches() const;
+
+      /// \brief Get the mesh of a batch. Each regenerated mesh is named
+      /// uniquely in the process.
+      /// \param[in] _batch Name of the batch.
+      /// \return The mesh, which is valid until the next update, or null if
+      /// the batch has no triangles.
+      public: const Mesh *BatchMesh(const std::string &_batch) const;
+
+      /// \brief Get the material of a batch.
+      /// \param[in] _batch Name of the batch.
+      /// \return Name of the material, empty if the batch doesn't exist.
+      public: std::string BatchMaterial(const std::string &_batch) const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<RoadNetworkPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/RoadNetwork.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class RoadNetworkTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief Get the number of triangles of all the batches.
+/// \param[in] _network The road network.
+/// \return Number of triangles.
+unsigned int TriangleCount(const common::RoadNetwork &_network)
+{
+  unsigned int count = 0;
+  for (const auto &batch : _network.Batches())
+    count += _network.BatchMesh(batch)->GetIndexCount() / 3;
+  return count;
+}
+
+/////////////////////////////////////////////////
+TEST_F(RoadNetworkTest, Batches)
+{
+  common::RoadNetwork network;
+  EXPECT_DOUBLE_EQ(100.0, network.TileSize());
+  EXPECT_TRUE(network.Update().empty());
+  EXPECT_TRUE(network.Batches().empty());
+
+  // A road across two tiles
+  const std::vector<ignition::math::Vector3d> points = {
+      {10, 10, 0}, {60, 10, 0}, {110, 10, 0}, {160, 10, 0}};
+  EXPECT_TRUE(network.SetRoad("road_a", points, 4, "Gazebo/Road"));
+  EXPECT_FALSE(network.SetRoad("road_a", points, 4, "Gazebo/Road"));
+  EXPECT_EQ(1u, network.RoadCount());
+
+  auto changed = network.Update();
+  EXPECT_EQ(2u, changed.size());
+  ASSERT_EQ(2u, network.Batches().size());
+  EXPECT_EQ(3u * 2u, TriangleCount(network));
+  for (const auto &batch : network.Batches())
+  {
+    EXPECT_EQ("Gazebo/Road", network.BatchMaterial(batch));
+    const common::Mesh *mesh = network.BatchMesh(batch);
+    ASSERT_TRUE(mesh != nullptr);
+    EXPECT_EQ(common::SubMesh::TRIANGLES,
+        mesh->GetSubMesh(0)->GetPrimitiveType());
+
+    // The road is 4m wide, and faces up
+    EXPECT_DOUBLE_EQ(8.0, mesh->Min().Y());
+    EXPECT_DOUBLE_EQ(12.0, mesh->Max().Y());
+    EXPECT_EQ(ignition::math::Vector3d::UnitZ,
+        mesh->GetSubMesh(0)->Normal(0));
+  }
+
+  // Nothing to regenerate
+  EXPECT_TRUE(network.Update().empty());
+
+  // A road with another material in the same tiles adds batches, and
+  // leaves the others alone
+  const std::string first = network.BatchMesh(network.Batches()[0])->GetName();
+  EXPECT_TRUE(network.SetRoad("road_b",
+        {{10, 50, 0}, {60, 50, 0}}, 4, "Other"));
+  changed = network.Update();
+  ASSERT_EQ(1u, changed.size());
+  EXPECT_EQ("Other", network.BatchMaterial(changed[0]));
+  EXPECT_EQ(3u, network.Batches().size());
+  EXPECT_EQ(first, network.BatchMesh(network.Batches()[0])->GetName());
+
+  // Roads of the same material share the batches
+  EXPECT_TRUE(network.SetRoad("road_b",
+        {{10, 50, 0}, {60, 50, 0}}, 4, "Gazebo/Road"));
+  changed = network.Update();
+  EXPECT_EQ(2u, changed.size());
+  EXPECT_EQ(2u, network.Batches().size());
+  EXPECT_EQ(4u * 2u, TriangleCount(network));
+  EXPECT_NE(first, network.BatchMesh(network.Batches()[0])->GetName());
+
+  // Removed roads empty their batches
+  EXPECT_FALSE(network.RemoveRoad("road_c"));
+  EXPECT_TRUE(network.RemoveRoad("road_a"));
+  EXPECT_TRUE(network.RemoveRoad("road_b"));
+  changed = network.Update();
+  EXPECT_EQ(2u, changed.size());
+  EXPECT_TRUE(network.Batches().empty());
+  EXPECT_TRUE(network.BatchMesh(changed[0]) == nullptr);
+  EXPECT_TRUE(network.BatchMaterial(changed[0]).empty());
+
+  // Degenerate roads have no triangles
+  EXPECT_TRUE(network.SetRoad("point", {{1, 1, 0}, {1, 1, 0}}, 4, "m"));
+  EXPECT_TRUE(network.SetRoad("flat", {{1, 1, 0}, {5, 1, 0}}, 0, "m"));
+  EXPECT_TRUE(network.Update().empty());
+  EXPECT_TRUE(network.Batches().empty());
+}
+
+/////////////////////////////////////////////////
+TEST_F(RoadNetworkTest, Junctions)
+{
+  common::RoadNetwork network;
+  network.SetTileSize(1000);
+  EXPECT_DOUBLE_EQ(1000.0, network.TileSize());
+
+  // Two roads that meet at a right angle are joined along the bisector
+  network.SetRoad("a", {{0, 0, 0}, {10, 0, 0}}, 2, "m");
+  network.SetRoad("b", {{10, 0, 0}, {10, 10, 0}}, 2, "m");
+  network.Update();
+  ASSERT_EQ(1u, network.Batches().size());
+  const common::SubMesh *subMesh =
+      network.BatchMesh(network.Batches()[0])->GetSubMesh(0);
+  ASSERT_EQ(8u, subMesh->GetVertexCount());
+  EXPECT_EQ(4u, subMesh->GetIndexCount() / 3);
+
+  // The end of a shares its vertices with the start of b
+  EXPECT_EQ(subMesh->Vertex(2), subMesh->Vertex(4));
+  EXPECT_EQ(subMesh->Vertex(3), subMesh->Vertex(5));
+  EXPECT_EQ(ignition::math::Vector3d(9, 1, 0), subMesh->Vertex(2));
+  EXPECT_EQ(ignition::math::Vector3d(11, -1, 0), subMesh->Vertex(3));
+
+  // A third road at the same point makes a junction, which trims the
+  // roads by half the width and covers their ends
+  network.SetRoad("c", {{10, 0, 0}, {20, 0, 0}}, 2, "m");
+  network.Update();
+  ASSERT_EQ(1u, network.Batches().size());
+  const common::Mesh *mesh = network.BatchMesh(network.Batches()[0]);
+  subMesh = mesh->GetSubMesh(0);
+
+  // Three road quads, and the junction fan around its center with the six
+  // trimmed corners, which covers the square between the road ends
+  EXPECT_EQ(3u * 4u + 7u, subMesh->GetVertexCount());
+  EXPECT_EQ(3u * 2u + 4u, subMesh->GetIndexCount() / 3);
+  EXPECT_EQ(ignition::math::Vector3d(9, 1, 0), subMesh->Vertex(2));
+  EXPECT_EQ(ignition::math::Vector3d(9, -1, 0), subMesh->Vertex(3));
+
+  // All the triangles face up
+  for (unsigned int i = 0; i < subMesh->GetIndexCount(); i += 3)
+  {
+    const auto a = subMesh->Vertex(subMesh->GetIndex(i));
+    const auto b = subMesh->Vertex(subMesh->GetIndex(i + 1));
+    const auto c = subMesh->Vertex(subMesh->GetIndex(i + 2));
+    EXPECT_GT((b - a).Cross(c - a).Z(), 0.0);
+  }
+
+  // Removing the third road joins the first two again
+  network.RemoveRoad("c");
+  network.Update();
+  subMesh = network.BatchMesh(network.Batches()[0])->GetSubMesh(0);
+  EXPECT_EQ(8u, subMesh->GetVertexCount());
+  EXPECT_EQ(ignition::math::Vector3d(9, 1, 0), subMesh->Vertex(2));
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
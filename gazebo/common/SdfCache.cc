@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <atomic>
+#include <ctime>
+#include <limits>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/MemoryTracker.hh"
+#include "gazebo/common/SdfCache.hh"
+
+using namespace gazebo;
+using namespace common;
+
+namespace
+{
+  /// \brief Greatest number of cached strings. Strings are spawned by
+  /// scripts and tools which insert a few models many times.
+  const std::size_t kMaxCachedStrings = 64;
+
+  /// \brief A parsed file.
+  struct CachedFile
+  {
+    /// \brief Modification time of the file when it was parsed.
+    std::time_t modified = 0;
+
+    /// \brief Root element of the parsed file.
+    sdf::ElementPtr root;
+
+    /// \brief Size of the file.
+    uint64_t bytes = 0;
+  };
+
+  /// \brief The cache, shared by all the worlds of the process.
+  struct Cache
+  {
+    /// \brief Constructor, registers the evictor. The tracker is created
+    /// first, so it outlives the cache.
+    Cache()
+      : memory(MemoryTracker::Instance()->Counter("sdf"))
+    {
+      this->evictor = MemoryTracker::Instance()->AddEvictor("sdf",
+          [this](const uint64_t _bytes)
+          {
+            this->Evict(_bytes);
+          });
+    }
+
+    /// \brief Destructor.
+    ~Cache()
+    {
+      MemoryTracker::Instance()->RemoveEvictor(this->evictor);
+      this->Evict(std::numeric_limits<uint64_t>::max());
+    }
+
+    /// \brief Drop parsed SDF, the least recently read strings first,
+    /// then the files.
+    /// \param[in] _bytes Number of bytes to free.
+    void Evict(const uint64_t _bytes)
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      uint64_t freed = 0;
+      while (!this->stringOrder.empty() && freed < _bytes)
+      {
+        freed += this->stringOrder.back().size();
+        this->strings.erase(this->stringOrder.back());
+        this->stringOrder.pop_back();
+      }
+      while (!this->files.empty() && freed < _bytes)
+      {
+        freed += this->files.begin()->second.bytes;
+        this->files.erase(this->files.begin());
+      }
+      this->memory -= static_cast<int64_t>(freed);
+    }
+
+    /// \brief Text size of the cached files and strings, in the "sdf"
+    /// subsystem of the MemoryTracker.
+    std::atomic<int64_t> &memory;
+
+    /// \brief Id of the evictor.
+    int evictor = -1;
+
+    /// \brief Protects the members below.
+    std::mutex mutex;
+
+    /// \brief Parsed files by path.
+    std::map<std::string, CachedFile> files;
+
+    /// \brief Parsed strings by content, with their position in
+    /// stringOrder.
+    std::map<std::string, std::pair<sdf::ElementPtr,
+        std::list<std::string>::iterator>> strings;
+
+    /// \brief Cached strings, most recently read first.
+    std::list<std::string> stringOrder;
+  };
+
+  /// \brief Get the cache.
+  /// \return The cache.
+  Cache &cache()
+  {
+    static Cache instance;
+    return instance;
+  }
+
+  /// \brief Copy the parsed elements to an SDF.
+  /// \param[in] _root Root element of the parsed SDF.
+  /// \param[in] _sdf SDF to copy to.
+  void copyTo(const sdf::ElementPtr &_root, sdf::SDFPtr _sdf)
+  {
+    _sdf->Root(_root->Clone());
+  }
+}
+
+/////////////////////////////////////////////////
+bool SdfCache::ReadFile(const std::string &_filename, sdf::SDFPtr _sdf)
+{
+  boost::system::error_code ec;
+  const std::time_t modified =
+      boost::filesystem::last_write_time(_filename, ec);
+  if (ec)
+    return sdf::readFile(_filename, _sdf);
+
+  Cache &c = cache();
+  {
+    std::lock_guard<std::mutex> lock(c.mutex);
+    auto file = c.files.find(_filename);
+    if (file != c.files.end() && file->second.modified == modified)
+    {
+      copyTo(file->second.root, _sdf);
+      return true;
+    }
+  }
+
+  // Parse outside the lock, so that other files can be read meanwhile
+  sdf::SDFPtr parsed(new sdf::SDF);
+  if (!sdf::init(parsed) || !sdf::readFile(_filename, parsed))
+    return false;
+
+  const uintmax_t size = boost::filesystem::file_size(_filename, ec);
+  {
+    std::lock_guard<std::mutex> lock(c.mutex);
+    CachedFile &file = c.files[_filename];
+    c.memory -= static_cast<int64_t>(file.bytes);
+    file.modified = modified;
+    file.root = parsed->Root();
+    file.bytes = ec ? 0 : size;
+    c.memory += static_cast<int64_t>(file.bytes);
+  }
+  copyTo(parsed->Root(), _sdf);
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool SdfCache::ReadString(const std::string &_string, sdf::SDFPtr _sdf)
+{
+  Cache &c = cache();
+  {
+    std::lock_guard<std::mutex> lock(c.mutex);
+    auto str = c.strings.find(_string);
+    if (str != c.strings.end())
+    {
+      c.stringOrder.splice(c.stringOrder.begin(), c.stringOrder,
+          str->second.second);
+      copyTo(str->second.first, _sdf);
+      return true;
+    }
+  }
+
+  sdf::SDFPtr parsed(new sdf::SDF);
+  if (!sdf::init(parsed) || !sdf::readString(_string, parsed))
+    return false;
+
+  {
+    std::lock_guard<std::mutex> lock(c.mutex);
+    if (c.strings.find(_string) == c.strings.end())
+    {
+      c.stringOrder.push_front(_string);
+      c.strings[_string] =
+          std::make_pair(parsed->Root(), c.stringOrder.begin());
+      c.memory += _string.size();
+      if (c.stringOrder.size() > kMaxCachedStrings)
+      {
+        c.memory -= c.stringOrder.back().size();
+        c.strings.erase(c.stringOrder.back());
+        c.stringOrder.pop_back();
+      }
+    }
+  }
+  copyTo(parsed->Root(), _sdf);
+  return true;
+}
+
+/////////////////////////////////////////////////
+std::size_t SdfCache::Size()
+{
+  Cache &c = cache();
+  std::lock_guard<std::mutex> lock(c.mutex);
+  return c.files.size() + c.strings.size();
+}
+
+/////////////////////////////////////////////////
+void SdfCache::Clear()
+{
+  cache().Evict(std::numeric_limits<uint64_t>::max());
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_SDFCACHE_HH_
+#define GAZEBO_COMMON_SDFCACHE_HH_
+
+#include <cstddef>
+#include <string>
+#include <sdf/sdf.hh>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \addtogroup gazebo_common Common
+    /// \{
+
+    /// \class SdfCache SdfCache.hh common/common.hh
+    /// \brief Process-wide cache of parsed SDF, so that a model file
+    /// inserted many times, or a model string spawned many times, is
+    /// parsed and converted once.
+    ///
+    /// Files are keyed by path and modification time, so a changed file
+    /// is parsed again. The files included by a cached file aren't
+    /// checked. Strings are keyed by their content, and only the most
+    /// recently read ones are kept.
+    ///
+    /// Readers get a copy of the parsed elements, which they own and can
+    /// edit or move into another SDF without copying them again.
+    /// The cached SDF counts against the "sdf" budget of the
+    /// MemoryTracker by the size of its text, and is parsed again after
+    /// it's evicted.
+    class GZ_COMMON_VISIBLE SdfCache
+    {
+      /// \brief Read an SDF file, parsing it only if it isn't cached or
+      /// was modified since.
+      /// \param[in] _filename Path of the file.
+      /// \param[in] _sdf SDF which gets a copy of the parsed elements. It
+      /// must be initialized with sdf::init.
+      /// \return False if the file can't be read.
+      public: static bool ReadFile(const std::string &_filename,
+                  sdf::SDFPtr _sdf);
+
+      /// \brief Read an SDF string, parsing it only if it isn't cached.
+      /// \param[in] _string The SDF string.
+      /// \param[in] _sdf SDF which gets a copy of the parsed elements. It
+      /// must be initialized with sdf::init.
+      /// \return False if the string can't be read.
+      public: static bool ReadString(const std::string &_string,
+                  sdf::SDFPtr _sdf);
+
+      /// \brief Get the number of cached files and strings.
+      /// \return Number of cached files and strings.
+      public: static std::size_t Size();
+
+      /// \brief Remove the cached files and strings.
+      public: static void Clear();
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/MemoryTracker.hh"
+#include "gazebo/common/SdfCache.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class SdfCacheTest : public gazebo::testing::AutoLogFixture { };
+
+/// \brief Get an SDF string of a model.
+/// \param[in] _name Name of the model.
+/// \return The SDF string.
+static std::string modelString(const std::string &_name)
+{
+  return "<sdf version='1.6'><model name='" + _name + "'>"
+      "<link name='link'/></model></sdf>";
+}
+
+/// \brief Read an SDF file or string into a new SDF.
+/// \param[in] _file True to read a file, false to read a string.
+/// \param[in] _data The file name or the string.
+/// \return The model name, or an empty string if it can't be read.
+static std::string readModelName(const bool _file, const std::string &_data)
+{
+  sdf::SDFPtr sdf(new sdf::SDF);
+  sdf::init(sdf);
+  if (!(_file ? common::SdfCache::ReadFile(_data, sdf) :
+        common::SdfCache::ReadString(_data, sdf)))
+  {
+    return "";
+  }
+  return sdf->Root()->GetElement("model")->Get<std::string>("name");
+}
+
+/////////////////////////////////////////////////
+TEST_F(SdfCacheTest, ReadString)
+{
+  common::SdfCache::Clear();
+  EXPECT_EQ(0u, common::SdfCache::Size());
+
+  EXPECT_EQ("box", readModelName(false, modelString("box")));
+  EXPECT_EQ(1u, common::SdfCache::Size());
+
+  // A cached string is copied, so the copies can be edited
+  sdf::SDFPtr sdf(new sdf::SDF);
+  sdf::init(sdf);
+  ASSERT_TRUE(common::SdfCache::ReadString(modelString("box"), sdf));
+  EXPECT_EQ(1u, common::SdfCache::Size());
+  sdf->Root()->GetElement("model")->GetAttribute("name")->Set("edited");
+  EXPECT_EQ("box", readModelName(false, modelString("box")));
+
+  // Invalid strings aren't cached
+  EXPECT_EQ("", readModelName(false, "<sdf version='1.6'><model"));
+  EXPECT_EQ(1u, common::SdfCache::Size());
+
+  common::SdfCache::Clear();
+  EXPECT_EQ(0u, common::SdfCache::Size());
+}
+
+/////////////////////////////////////////////////
+TEST_F(SdfCacheTest, ReadFile)
+{
+  namespace fs = boost::filesystem;
+  const fs::path path = fs::temp_directory_path() /
+    fs::unique_path("gazebo-SdfCache-%%%%-%%%%.sdf");
+
+  common::SdfCache::Clear();
+  EXPECT_EQ("", readModelName(true, path.string()));
+  EXPECT_EQ(0u, common::SdfCache::Size());
+
+  {
+    std::ofstream file(path.string());
+    file << modelString("first");
+  }
+  EXPECT_EQ("first", readModelName(true, path.string()));
+  EXPECT_EQ(1u, common::SdfCache::Size());
+  EXPECT_EQ("first", readModelName(true, path.string()));
+  EXPECT_EQ(1u, common::SdfCache::Size());
+
+  // A modified file is parsed again
+  const std::time_t modified = fs::last_write_time(path);
+  {
+    std::ofstream file(path.string());
+    file << modelString("second");
+  }
+  fs::last_write_time(path, modified + 10);
+  EXPECT_EQ("second", readModelName(true, path.string()));
+  EXPECT_EQ(1u, common::SdfCache::Size());
+
+  fs::remove(path);
+  common::SdfCache::Clear();
+}
+
+/////////////////////////////////////////////////
+TEST_F(SdfCacheTest, Budget)
+{
+  common::MemoryTracker *tracker = common::MemoryTracker::Instance();
+  common::SdfCache::Clear();
+  EXPECT_EQ(0u, tracker->Bytes("sdf"));
+
+  const std::string first = modelString("first");
+  const std::string second = modelString("second");
+  EXPECT_EQ("first", readModelName(false, first));
+  EXPECT_EQ("second", readModelName(false, second));
+  EXPECT_EQ(first.size() + second.size(), tracker->Bytes("sdf"));
+
+  // Over budget, the least recently read string is dropped
+  EXPECT_EQ("first", readModelName(false, first));
+  tracker->SetBudget("sdf", first.size());
+  EXPECT_EQ(second.size(), tracker->Enforce());
+  EXPECT_EQ(1u, common::SdfCache::Size());
+  EXPECT_EQ(first.size(), tracker->Bytes("sdf"));
+  tracker->SetBudget("sdf", 0);
+
+  common::SdfCache::Clear();
+  EXPECT_EQ(0u, tracker->Bytes("sdf"));
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -240,6 +240,14 @@ bool SkeletonAnimation::HasNode(const std::string& _node) const
   return (this->animations.find(_node) != this->animations.end());
 }
 
+//////////////////////////////////////////////////
+const NodeAnimation *SkeletonAnimation::NodeAnimationByName(
+    const std::string &_node) const
+{
+  auto iter = this->animations.find(_node);
+  return iter != this->animations.end() ? iter->second : nullptr;
+}
+
 //////////////////////////////////////////////////
 void SkeletonAnimation::AddKeyFrame(const std::string& _node,
     const double _time, const ignition::math::Matrix4d &_mat)
@@ -150,6 +150,12 @@ namespace gazebo
       /// \return true if the node exits
       public: bool HasNode(const std::string &_node) const;
 
+      /// \brief Get the animation of a node.
+      /// \param[in] _node The name of the node.
+      /// \return The animation, or nullptr if the node doesn't exist.
+      public: const NodeAnimation *NodeAnimationByName(
+                  const std::string &_node) const;
+
       /// \brief Adds or replaces a named key frame at a specific time
       /// \param[in] _node the name of the new or existing node
       /// \param[in] _time the time
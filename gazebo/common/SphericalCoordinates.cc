@@ -14,7 +14,10 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <cmath>
 #include <string>
+#include <vector>
 #include <math.h>
 
 #include "gazebo/common/Console.hh"
@@ -203,6 +206,19 @@ ignition::math::Vector3d SphericalCoordinates::SphericalFromLocal(
   return result;
 }
 
+//////////////////////////////////////////////////
+void SphericalCoordinates::SphericalFromLocal(
+    const std::vector<ignition::math::Vector3d> &_xyz,
+    std::vector<ignition::math::Vector3d> &_result) const
+{
+  this->PositionTransform(_xyz, LOCAL, SPHERICAL, _result);
+  for (auto &result : _result)
+  {
+    result.X(IGN_RTOD(result.X()));
+    result.Y(IGN_RTOD(result.Y()));
+  }
+}
+
 //////////////////////////////////////////////////
 ignition::math::Vector3d SphericalCoordinates::LocalFromSpherical(
     const ignition::math::Vector3d &_xyz) const
@@ -246,6 +262,126 @@ double SphericalCoordinates::Distance(const ignition::math::Angle &_latA,
   return d;
 }
 
+//////////////////////////////////////////////////
+// Convert a SPHERICAL position (radians) to ECEF
+static ignition::math::Vector3d EcefFromSpherical(
+    const SphericalCoordinatesPrivate &_d, const ignition::math::Vector3d &_pos)
+{
+  // Cache trig results
+  double cosLat = cos(_pos.X());
+  double sinLat = sin(_pos.X());
+  double cosLon = cos(_pos.Y());
+  double sinLon = sin(_pos.Y());
+
+  // Radius of planet curvature (meters)
+  double curvature = 1.0 - _d.ellE * _d.ellE * sinLat * sinLat;
+  curvature = _d.ellA / sqrt(curvature);
+
+  return ignition::math::Vector3d(
+      (_pos.Z() + curvature) * cosLat * cosLon,
+      (_pos.Z() + curvature) * cosLat * sinLon,
+      ((_d.ellB * _d.ellB) / (_d.ellA * _d.ellA) * curvature + _pos.Z()) *
+      sinLat);
+}
+
+//////////////////////////////////////////////////
+// Convert an ECEF position to SPHERICAL (radians)
+static ignition::math::Vector3d SphericalFromEcef(
+    const SphericalCoordinatesPrivate &_d, const ignition::math::Vector3d &_pos)
+{
+  double p = sqrt(_pos.X() * _pos.X() + _pos.Y() * _pos.Y());
+  double theta = atan((_pos.Z() * _d.ellA) / (p * _d.ellB));
+  double sinTheta = sin(theta);
+  double cosTheta = cos(theta);
+
+  // Calculate latitude and longitude
+  double lat = atan(
+      (_pos.Z() + _d.ellP * _d.ellP * _d.ellB *
+       sinTheta * sinTheta * sinTheta) /
+      (p - _d.ellE * _d.ellE * _d.ellA * cosTheta * cosTheta * cosTheta));
+
+  double lon = atan2(_pos.Y(), _pos.X());
+
+  // Recalculate radius of planet curvature at the current latitude.
+  double sinLat = sin(lat);
+  double nCurvature = 1.0 - _d.ellE * _d.ellE * sinLat * sinLat;
+  nCurvature = _d.ellA / sqrt(nCurvature);
+
+  // Now calculate Z
+  return ignition::math::Vector3d(lat, lon, p / cos(lat) - nCurvature);
+}
+
+//////////////////////////////////////////////////
+// Convert a GLOBAL position close to the origin to SPHERICAL (radians),
+// on the tangent plane with the drop of the surface. Returns false if the
+// position is too far for the fast path.
+static bool FastSphericalFromGlobal(const SphericalCoordinatesPrivate &_d,
+    const ignition::math::Vector3d &_enu, ignition::math::Vector3d &_result)
+{
+  if (_enu.SquaredLength() >= _d.fastRadius * _d.fastRadius)
+    return false;
+
+  _result.Set(
+      _d.latitudeReference.Radian() + _enu.Y() * _d.fastLatScale,
+      _d.longitudeReference.Radian() + _enu.X() * _d.fastLonScale,
+      _d.elevationReference + _enu.Z() +
+      _enu.X() * _enu.X() * _d.fastEastDrop +
+      _enu.Y() * _enu.Y() * _d.fastNorthDrop);
+  return true;
+}
+
+//////////////////////////////////////////////////
+// Get the rotation and offset that move a Cartesian frame to ECEF.
+// Returns false if the frame is SPHERICAL or unknown.
+static bool EcefFromCartesian(const SphericalCoordinatesPrivate &_d,
+    const SphericalCoordinates::CoordinateType _type,
+    ignition::math::Matrix3d &_rot, ignition::math::Vector3d &_offset)
+{
+  switch (_type)
+  {
+    case SphericalCoordinates::LOCAL:
+      _rot = _d.rotLocalToECEF;
+      _offset = _d.origin;
+      return true;
+    case SphericalCoordinates::GLOBAL:
+      _rot = _d.rotGlobalToECEF;
+      _offset = _d.origin;
+      return true;
+    case SphericalCoordinates::ECEF:
+      _rot = ignition::math::Matrix3d::Identity;
+      _offset = ignition::math::Vector3d::Zero;
+      return true;
+    default:
+      return false;
+  }
+}
+
+//////////////////////////////////////////////////
+// Get the rotation and offset that move ECEF to a Cartesian frame.
+// Returns false if the frame is SPHERICAL or unknown.
+static bool CartesianFromEcef(const SphericalCoordinatesPrivate &_d,
+    const SphericalCoordinates::CoordinateType _type,
+    ignition::math::Matrix3d &_rot, ignition::math::Vector3d &_offset)
+{
+  switch (_type)
+  {
+    case SphericalCoordinates::LOCAL:
+      _rot = _d.rotECEFToLocal;
+      _offset = -(_rot * _d.origin);
+      return true;
+    case SphericalCoordinates::GLOBAL:
+      _rot = _d.rotECEFToGlobal;
+      _offset = -(_rot * _d.origin);
+      return true;
+    case SphericalCoordinates::ECEF:
+      _rot = ignition::math::Matrix3d::Identity;
+      _offset = ignition::math::Vector3d::Zero;
+      return true;
+    default:
+      return false;
+  }
+}
+
 //////////////////////////////////////////////////
 void SphericalCoordinates::UpdateTransformationMatrix()
 {
@@ -279,13 +415,126 @@ void SphericalCoordinates::UpdateTransformationMatrix()
   this->dataPtr->cosHea = cos(-this->dataPtr->headingOffset.Radian());
   this->dataPtr->sinHea = sin(-this->dataPtr->headingOffset.Radian());
 
+  // Combine the heading with the rotations, LOCAL positions are then
+  // converted with a single product.
+  double cosHea = this->dataPtr->cosHea;
+  double sinHea = this->dataPtr->sinHea;
+  this->dataPtr->rotLocalToGlobal = ignition::math::Matrix3d(
+                      -cosHea,  sinHea, 0,
+                      -sinHea, -cosHea, 0,
+                       0,       0,      1);
+  this->dataPtr->rotLocalToECEF =
+    this->dataPtr->rotGlobalToECEF * this->dataPtr->rotLocalToGlobal;
+  this->dataPtr->rotECEFToLocal = ignition::math::Matrix3d(
+                      cosHea, -sinHea, 0,
+                      sinHea,  cosHea, 0,
+                      0,       0,      1) * this->dataPtr->rotECEFToGlobal;
+
   // Cache the ECEF coordinate of the origin
   this->dataPtr->origin = ignition::math::Vector3d(
     this->dataPtr->latitudeReference.Radian(),
     this->dataPtr->longitudeReference.Radian(),
     this->dataPtr->elevationReference);
   this->dataPtr->origin =
-    this->PositionTransform(this->dataPtr->origin, SPHERICAL, ECEF);
+    EcefFromSpherical(*this->dataPtr, this->dataPtr->origin);
+
+  this->UpdateFastPath();
+}
+
+//////////////////////////////////////////////////
+void SphericalCoordinates::UpdateFastPath()
+{
+  this->dataPtr->fastRadius = 0.0;
+
+  // Near the poles the meridians converge too fast for the tangent plane
+  double cosLat = cos(this->dataPtr->latitudeReference.Radian());
+  if (this->dataPtr->fastTolerance <= 0.0 || std::abs(cosLat) < 1e-3)
+    return;
+
+  // Radii of curvature along the meridian and the prime vertical
+  double sinLat = sin(this->dataPtr->latitudeReference.Radian());
+  double e2 = this->dataPtr->ellE * this->dataPtr->ellE;
+  double w = sqrt(1.0 - e2 * sinLat * sinLat);
+  double primeRadius = this->dataPtr->ellA / w +
+    this->dataPtr->elevationReference;
+  double meridianRadius = this->dataPtr->ellA * (1.0 - e2) / (w * w * w) +
+    this->dataPtr->elevationReference;
+
+  this->dataPtr->fastLatScale = 1.0 / meridianRadius;
+  this->dataPtr->fastLonScale = 1.0 / (primeRadius * cosLat);
+  this->dataPtr->fastEastDrop = -0.5 / primeRadius;
+  this->dataPtr->fastNorthDrop = -0.5 / meridianRadius;
+
+  // Largest error in meters of the fast path on a sphere of the given
+  // radius around the origin, sampled around the horizon and above and
+  // below it.
+  auto error = [&](const double _radius)
+  {
+    double maxError = 0.0;
+    // Let the fast path accept the probes
+    this->dataPtr->fastRadius = 2.0 * _radius;
+    for (int i = 0; i < 8; ++i)
+    {
+      for (int j = -1; j <= 1; ++j)
+      {
+        double azimuth = i * IGN_PI / 4.0;
+        double elevation = j * IGN_PI / 4.0;
+        ignition::math::Vector3d enu(
+            _radius * cos(elevation) * cos(azimuth),
+            _radius * cos(elevation) * sin(azimuth),
+            _radius * sin(elevation));
+
+        ignition::math::Vector3d fast;
+        FastSphericalFromGlobal(*this->dataPtr, enu, fast);
+        ignition::math::Vector3d exact = SphericalFromEcef(*this->dataPtr,
+            this->dataPtr->origin + this->dataPtr->rotGlobalToECEF * enu);
+
+        ignition::math::Angle dLon(fast.Y() - exact.Y());
+        dLon.Normalize();
+        maxError = std::max(maxError, ignition::math::Vector3d(
+              (fast.X() - exact.X()) * meridianRadius,
+              dLon.Radian() * primeRadius * cosLat,
+              fast.Z() - exact.Z()).Length());
+      }
+    }
+    return maxError;
+  };
+
+  // The error grows with the square of the distance, shrink the estimate
+  // until the samples agree with it.
+  const double probe = 1000.0;
+  double radius = probe;
+  double probeError = error(probe);
+  if (probeError > 0.0)
+    radius = probe * sqrt(this->dataPtr->fastTolerance / probeError);
+  radius = std::min(radius, 1e5);
+  for (int i = 0; i < 20 && radius > 1e-3; ++i)
+  {
+    if (error(radius) <= this->dataPtr->fastTolerance)
+      break;
+    radius *= 0.8;
+  }
+
+  this->dataPtr->fastRadius = radius > 1e-3 ? radius : 0.0;
+}
+
+//////////////////////////////////////////////////
+void SphericalCoordinates::SetFastPathTolerance(const double _tolerance)
+{
+  this->dataPtr->fastTolerance = std::max(0.0, _tolerance);
+  this->UpdateFastPath();
+}
+
+//////////////////////////////////////////////////
+double SphericalCoordinates::FastPathTolerance() const
+{
+  return this->dataPtr->fastTolerance;
+}
+
+//////////////////////////////////////////////////
+double SphericalCoordinates::FastPathRadius() const
+{
+  return this->dataPtr->fastRadius;
 }
 
 /////////////////////////////////////////////////
@@ -295,45 +544,31 @@ ignition::math::Vector3d SphericalCoordinates::PositionTransform(
 {
   ignition::math::Vector3d tmp = _pos;
 
-  // Cache trig results
-  double cosLat = cos(_pos.X());
-  double sinLat = sin(_pos.X());
-  double cosLon = cos(_pos.Y());
-  double sinLon = sin(_pos.Y());
-
-  // Radius of planet curvature (meters)
-  double curvature = 1.0 -
-    this->dataPtr->ellE * this->dataPtr->ellE * sinLat * sinLat;
-  curvature = this->dataPtr->ellA / sqrt(curvature);
+  // Positions close to the origin skip ECEF
+  if (_out == SPHERICAL && this->dataPtr->fastRadius > 0.0 &&
+      (_in == LOCAL || _in == GLOBAL))
+  {
+    ignition::math::Vector3d enu = _in == LOCAL ?
+      this->dataPtr->rotLocalToGlobal * _pos : _pos;
+    if (FastSphericalFromGlobal(*this->dataPtr, enu, tmp))
+      return tmp;
+  }
 
   // Convert whatever arrives to a more flexible ECEF coordinate
   switch (_in)
   {
-    // East, North, Up (ENU), note no break at end of case
+    // East, North, Up (ENU) rotated by the heading
     case LOCAL:
-      {
-        tmp.X(-_pos.X() * this->dataPtr->cosHea + _pos.Y() *
-            this->dataPtr->sinHea);
-        tmp.Y(-_pos.X() * this->dataPtr->sinHea - _pos.Y() *
-            this->dataPtr->cosHea);
-      }
-      [[fallthrough]];
+      tmp = this->dataPtr->origin + this->dataPtr->rotLocalToECEF * _pos;
+      break;
 
     case GLOBAL:
-      {
-        tmp = this->dataPtr->origin + this->dataPtr->rotGlobalToECEF * tmp;
-        break;
-      }
+      tmp = this->dataPtr->origin + this->dataPtr->rotGlobalToECEF * _pos;
+      break;
 
     case SPHERICAL:
-      {
-        tmp.X((_pos.Z() + curvature) * cosLat * cosLon);
-        tmp.Y((_pos.Z() + curvature) * cosLat * sinLon);
-        tmp.Z(((this->dataPtr->ellB * this->dataPtr->ellB)/
-              (this->dataPtr->ellA * this->dataPtr->ellA) *
-              curvature + _pos.Z()) * sinLat);
-        break;
-      }
+      tmp = EcefFromSpherical(*this->dataPtr, _pos);
+      break;
 
     // Do nothing
     case ECEF:
@@ -346,34 +581,10 @@ ignition::math::Vector3d SphericalCoordinates::PositionTransform(
   // Convert ECEF to the requested output coordinate system
   switch (_out)
   {
+    // Convert from ECEF to SPHERICAL
     case SPHERICAL:
-      {
-        // Convert from ECEF to SPHERICAL
-        double p = sqrt(tmp.X() * tmp.X() + tmp.Y() * tmp.Y());
-        double theta = atan((tmp.Z() * this->dataPtr->ellA) /
-            (p * this->dataPtr->ellB));
-
-        // Calculate latitude and longitude
-        double lat = atan(
-            (tmp.Z() + std::pow(this->dataPtr->ellP, 2) * this->dataPtr->ellB *
-             std::pow(sin(theta), 3)) /
-            (p - std::pow(this->dataPtr->ellE, 2) *
-             this->dataPtr->ellA * std::pow(cos(theta), 3)));
-
-        double lon = atan2(tmp.Y(), tmp.X());
-
-        // Recalculate radius of planet curvature at the current latitude.
-        double nCurvature = 1.0 - std::pow(this->dataPtr->ellE, 2) *
-          std::pow(sin(lat), 2);
-        nCurvature = this->dataPtr->ellA / sqrt(nCurvature);
-
-        tmp.X(lat);
-        tmp.Y(lon);
-
-        // Now calculate Z
-        tmp.Z(p/cos(lat) - nCurvature);
-        break;
-      }
+      tmp = SphericalFromEcef(*this->dataPtr, tmp);
+      break;
 
     // Convert from ECEF TO GLOBAL
     case GLOBAL:
@@ -382,12 +593,7 @@ ignition::math::Vector3d SphericalCoordinates::PositionTransform(
 
     // Convert from ECEF TO LOCAL
     case LOCAL:
-      tmp = this->dataPtr->rotECEFToGlobal * (tmp - this->dataPtr->origin);
-
-      tmp = ignition::math::Vector3d(
-          tmp.X() * this->dataPtr->cosHea - tmp.Y() * this->dataPtr->sinHea,
-          tmp.X() * this->dataPtr->sinHea + tmp.Y() * this->dataPtr->cosHea,
-          tmp.Z());
+      tmp = this->dataPtr->rotECEFToLocal * (tmp - this->dataPtr->origin);
       break;
 
     // Return ECEF (do nothing)
@@ -402,6 +608,64 @@ ignition::math::Vector3d SphericalCoordinates::PositionTransform(
   return tmp;
 }
 
+/////////////////////////////////////////////////
+void SphericalCoordinates::PositionTransform(
+    const std::vector<ignition::math::Vector3d> &_pos,
+    const CoordinateType &_in, const CoordinateType &_out,
+    std::vector<ignition::math::Vector3d> &_result) const
+{
+  _result.resize(_pos.size());
+
+  ignition::math::Matrix3d inRot, outRot;
+  ignition::math::Vector3d inOffset, outOffset;
+  bool inCartesian = EcefFromCartesian(*this->dataPtr, _in, inRot, inOffset);
+  bool outCartesian =
+    CartesianFromEcef(*this->dataPtr, _out, outRot, outOffset);
+
+  if ((!inCartesian && _in != SPHERICAL) ||
+      (!outCartesian && _out != SPHERICAL))
+  {
+    gzerr << "Invalid coordinate types[" << _in << ", " << _out << "]\n";
+    _result = _pos;
+    return;
+  }
+
+  // Between Cartesian frames, a single rotation and offset
+  if (inCartesian && outCartesian)
+  {
+    ignition::math::Matrix3d rot = outRot * inRot;
+    ignition::math::Vector3d offset = outRot * inOffset + outOffset;
+    for (size_t i = 0; i < _pos.size(); ++i)
+      _result[i] = rot * _pos[i] + offset;
+    return;
+  }
+
+  if (inCartesian)
+  {
+    bool fast = this->dataPtr->fastRadius > 0.0 && _in != ECEF;
+    for (size_t i = 0; i < _pos.size(); ++i)
+    {
+      if (fast && FastSphericalFromGlobal(*this->dataPtr, _in == LOCAL ?
+            this->dataPtr->rotLocalToGlobal * _pos[i] : _pos[i], _result[i]))
+      {
+        continue;
+      }
+      _result[i] = SphericalFromEcef(*this->dataPtr, inRot * _pos[i] +
+          inOffset);
+    }
+    return;
+  }
+
+  for (size_t i = 0; i < _pos.size(); ++i)
+  {
+    _result[i] = EcefFromSpherical(*this->dataPtr, _pos[i]);
+    if (outCartesian)
+      _result[i] = outRot * _result[i] + outOffset;
+    else
+      _result[i] = SphericalFromEcef(*this->dataPtr, _result[i]);
+  }
+}
+
 //////////////////////////////////////////////////
 ignition::math::Vector3d SphericalCoordinates::VelocityTransform(
     const ignition::math::Vector3d &_vel,
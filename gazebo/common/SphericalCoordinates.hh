@@ -18,6 +18,7 @@
 #define _GAZEBO_SPHERICALCOORDINATES_HH_
 
 #include <string>
+#include <vector>
 
 #include <ignition/math/Angle.hh>
 #include <ignition/math/Vector3.hh>
@@ -93,6 +94,16 @@ namespace gazebo
       public: ignition::math::Vector3d SphericalFromLocal(
                   const ignition::math::Vector3d &_xyz) const;
 
+      /// \brief Convert Cartesian position vectors to geodetic coordinates.
+      /// Equivalent to calling SphericalFromLocal on each position, with
+      /// the conversion set up once for the whole batch.
+      /// \param[in] _xyz Cartesian position vectors in gazebo's world frame.
+      /// \param[out] _result Geodetic latitude (deg), longitude (deg) and
+      /// altitude above sea level (m) of each position.
+      public: void SphericalFromLocal(
+                  const std::vector<ignition::math::Vector3d> &_xyz,
+                  std::vector<ignition::math::Vector3d> &_result) const;
+
       /// \brief Convert a Cartesian velocity vector in the local gazebo frame
       ///        to a global Cartesian frame with components East, North, Up.
       /// \param[in] _xyz Cartesian vector in gazebo's world frame.
@@ -186,6 +197,37 @@ namespace gazebo
               PositionTransform(const ignition::math::Vector3d &_pos,
                   const CoordinateType &_in, const CoordinateType &_out) const;
 
+      /// \brief Convert between positions in SPHERICAL/ECEF/LOCAL/GLOBAL
+      /// frame. Equivalent to calling PositionTransform on each position;
+      /// the conversions between Cartesian frames are combined into a
+      /// single rotation and offset for the whole batch.
+      /// \param[in] _pos Position vectors in frame defined by parameter _in
+      /// \param[in] _in  CoordinateType for input
+      /// \param[in] _out CoordinateType for output
+      /// \param[out] _result Transformed coordinates using cached origin
+      public: void PositionTransform(
+                  const std::vector<ignition::math::Vector3d> &_pos,
+                  const CoordinateType &_in, const CoordinateType &_out,
+                  std::vector<ignition::math::Vector3d> &_result) const;
+
+      /// \brief Set the largest error allowed when converting LOCAL or
+      /// GLOBAL positions to SPHERICAL. Positions close enough to the
+      /// origin are then converted on the tangent plane, without going
+      /// through ECEF. The distance below which this is precise enough is
+      /// computed from the tolerance when the reference changes.
+      /// \param[in] _tolerance Error in meters, zero (the default) to
+      /// always use the exact conversion.
+      public: void SetFastPathTolerance(const double _tolerance);
+
+      /// \brief Get the largest error allowed on the fast path.
+      /// \return Error in meters, zero if the fast path is disabled.
+      public: double FastPathTolerance() const;
+
+      /// \brief Get the distance to the origin below which positions are
+      /// converted on the fast path.
+      /// \return Distance in meters, zero if the fast path is disabled.
+      public: double FastPathRadius() const;
+
       /// \brief Convert between velocity in SPHERICAL/ECEF/LOCAL/GLOBAL frame
       /// \param[in] _pos Velocity vector in frame defined by parameter _in
       /// \param[in] _in  CoordinateType for input
@@ -195,6 +237,10 @@ namespace gazebo
                   const ignition::math::Vector3d &_vel,
                   const CoordinateType &_in, const CoordinateType &_out) const;
 
+      /// \brief Compute the distance below which the fast path is precise
+      /// enough, from its tolerance and the reference location.
+      private: void UpdateFastPath();
+
       /// \internal
       /// \brief Pointer to the private data
       private: SphericalCoordinatesPrivate *dataPtr;
@@ -84,6 +84,35 @@ namespace gazebo
 
       /// \brief Cache sine head transform
       public: double sinHea;
+
+      /// \brief Rotation matrix that moves LOCAL to ECEF
+      public: ignition::math::Matrix3d rotLocalToECEF;
+
+      /// \brief Rotation matrix that moves ECEF to LOCAL
+      public: ignition::math::Matrix3d rotECEFToLocal;
+
+      /// \brief Rotation matrix that moves LOCAL to GLOBAL
+      public: ignition::math::Matrix3d rotLocalToGlobal;
+
+      /// \brief Largest error of the fast path in meters, zero to disable
+      /// it.
+      public: double fastTolerance = 0.0;
+
+      /// \brief Distance to the origin below which the fast path is used,
+      /// zero when it is disabled.
+      public: double fastRadius = 0.0;
+
+      /// \brief Radians of latitude per meter North, at the origin
+      public: double fastLatScale = 0.0;
+
+      /// \brief Radians of longitude per meter East, at the origin
+      public: double fastLonScale = 0.0;
+
+      /// \brief Drop of the surface per squared meter East, at the origin
+      public: double fastEastDrop = 0.0;
+
+      /// \brief Drop of the surface per squared meter North, at the origin
+      public: double fastNorthDrop = 0.0;
     };
     /// \}
   }
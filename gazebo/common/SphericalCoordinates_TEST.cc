@@ -17,6 +17,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/SphericalCoordinates.hh"
 #include "test/util.hh"
@@ -252,6 +254,78 @@ TEST_F(SphericalCoordinatesTest, CoordinateTransforms)
   }
 }
 
+//////////////////////////////////////////////////
+// Test batch conversions and the fast path
+TEST_F(SphericalCoordinatesTest, BatchTransforms)
+{
+  common::SphericalCoordinates sc(common::SphericalCoordinates::EARTH_WGS84,
+      ignition::math::Angle(IGN_DTOR(37.3877349)),
+      ignition::math::Angle(IGN_DTOR(-122.0651166)), 32.0,
+      ignition::math::Angle(0.5));
+
+  std::vector<ignition::math::Vector3d> xyz;
+  for (int i = -10; i <= 10; ++i)
+    xyz.push_back(ignition::math::Vector3d(150.0 * i, -90.0 * i, 7.0 * i));
+
+  // The batch gives the same result as the single conversions
+  EXPECT_DOUBLE_EQ(sc.FastPathTolerance(), 0.0);
+  EXPECT_DOUBLE_EQ(sc.FastPathRadius(), 0.0);
+  std::vector<ignition::math::Vector3d> sph;
+  sc.SphericalFromLocal(xyz, sph);
+  ASSERT_EQ(sph.size(), xyz.size());
+  std::vector<ignition::math::Vector3d> exact;
+  for (unsigned int i = 0; i < xyz.size(); ++i)
+  {
+    exact.push_back(sc.SphericalFromLocal(xyz[i]));
+    EXPECT_EQ(sph[i], exact[i]);
+  }
+
+  std::vector<ignition::math::Vector3d> ecef;
+  sc.PositionTransform(xyz, common::SphericalCoordinates::LOCAL,
+      common::SphericalCoordinates::ECEF, ecef);
+  std::vector<ignition::math::Vector3d> global;
+  sc.PositionTransform(ecef, common::SphericalCoordinates::ECEF,
+      common::SphericalCoordinates::GLOBAL, global);
+  ASSERT_EQ(global.size(), xyz.size());
+  for (unsigned int i = 0; i < xyz.size(); ++i)
+  {
+    EXPECT_EQ(global[i], sc.PositionTransform(xyz[i],
+          common::SphericalCoordinates::LOCAL,
+          common::SphericalCoordinates::GLOBAL));
+  }
+
+  // Within the fast path radius the error stays below the tolerance
+  sc.SetFastPathTolerance(0.01);
+  EXPECT_DOUBLE_EQ(sc.FastPathTolerance(), 0.01);
+  EXPECT_GT(sc.FastPathRadius(), 100.0);
+  EXPECT_LT(sc.FastPathRadius(), 1000.0);
+
+  sc.SphericalFromLocal(xyz, sph);
+  for (unsigned int i = 0; i < xyz.size(); ++i)
+  {
+    EXPECT_EQ(sph[i], sc.SphericalFromLocal(xyz[i]));
+    if (xyz[i].Length() >= sc.FastPathRadius())
+    {
+      EXPECT_EQ(sph[i], exact[i]);
+      continue;
+    }
+    // About 111 km per degree
+    EXPECT_NEAR(sph[i].X(), exact[i].X(), 0.01 / 1.1e5);
+    EXPECT_NEAR(sph[i].Y(), exact[i].Y(), 0.01 / 0.8e5);
+    EXPECT_NEAR(sph[i].Z(), exact[i].Z(), 0.01);
+  }
+
+  // The radius follows the reference
+  double radius = sc.FastPathRadius();
+  sc.SetLatitudeReference(ignition::math::Angle(IGN_DTOR(89.9999)));
+  EXPECT_DOUBLE_EQ(sc.FastPathRadius(), 0.0);
+  sc.SetLatitudeReference(ignition::math::Angle(IGN_DTOR(37.3877349)));
+  EXPECT_NEAR(sc.FastPathRadius(), radius, 1e-6);
+
+  sc.SetFastPathTolerance(0.0);
+  EXPECT_DOUBLE_EQ(sc.FastPathRadius(), 0.0);
+}
+
 //////////////////////////////////////////////////
 // Test distance
 TEST_F(SphericalCoordinatesTest, Distance)
@@ -416,9 +416,10 @@ std::string SystemPaths::FindFile(const std::string &_filename,
           iter != paths.end() && !found; ++iter)
       {
         path = boost::filesystem::path((*iter));
-        path = boost::filesystem::operator/(path, _filename);
-        if (boost::filesystem::exists(path))
+        if (this->MaybeInDirectory(path, _filename) &&
+            boost::filesystem::exists(path / _filename))
         {
+          path /= _filename;
           found = true;
           break;
         }
@@ -429,9 +430,10 @@ std::string SystemPaths::FindFile(const std::string &_filename,
         {
           path = boost::filesystem::path(*iter);
           path = boost::filesystem::operator/(path, *suffixIter);
-          path = boost::filesystem::operator/(path, _filename);
-          if (boost::filesystem::exists(path))
+          if (this->MaybeInDirectory(path, _filename) &&
+              boost::filesystem::exists(path / _filename))
           {
+            path /= _filename;
             found = true;
             break;
           }
@@ -464,6 +466,48 @@ std::string SystemPaths::FindFile(const std::string &_filename,
   return path.string();
 }
 
+/////////////////////////////////////////////////
+bool SystemPaths::MaybeInDirectory(const boost::filesystem::path &_dir,
+                                   const std::string &_filename)
+{
+#if defined(_WIN32) || defined(__APPLE__)
+  // Names on these filesystems usually compare case insensitively, which a
+  // listing can't answer
+  return true;
+#else
+  const boost::filesystem::path relative(_filename);
+  if (relative.empty())
+    return true;
+  const std::string first = relative.begin()->string();
+  if (first == "." || first == "..")
+    return true;
+
+  std::lock_guard<std::mutex> lock(this->dirListingsMutex);
+  auto listing = this->dirListings.find(_dir.string());
+  if (listing == this->dirListings.end())
+  {
+    listing = this->dirListings.emplace(_dir.string(),
+        std::set<std::string>()).first;
+
+    // A missing directory is cached as empty
+    boost::system::error_code ec;
+    for (boost::filesystem::directory_iterator it(_dir, ec), end;
+         !ec && it != end; it.increment(ec))
+    {
+      listing->second.insert(it->path().filename().string());
+    }
+  }
+  return listing->second.count(first) > 0;
+#endif
+}
+
+/////////////////////////////////////////////////
+void SystemPaths::ClearFindFileCache()
+{
+  std::lock_guard<std::mutex> lock(this->dirListingsMutex);
+  this->dirListings.clear();
+}
+
 /////////////////////////////////////////////////
 void SystemPaths::AddFindFileCallback(
     std::function<std::string (const std::string &)> _cb)
@@ -475,6 +519,7 @@ void SystemPaths::AddFindFileCallback(
 void SystemPaths::ClearGazeboPaths()
 {
   this->gazeboPaths.clear();
+  this->ClearFindFileCache();
 }
 
 /////////////////////////////////////////////////
@@ -30,6 +30,9 @@
 
 #include <boost/filesystem.hpp>
 #include <list>
+#include <map>
+#include <mutex>
+#include <set>
 #include <string>
 
 #include "gazebo/common/CommonTypes.hh"
@@ -126,6 +129,14 @@ namespace gazebo
       public: void AddFindFileCallback(
                   std::function<std::string (const std::string &)> _cb);
 
+      /// \brief Forget the directory listings FindFile keeps for the Gazebo
+      /// resource paths. FindFile lists each resource directory once and
+      /// skips candidates whose first path component isn't in the listing,
+      /// so call this after creating files directly under a resource path
+      /// that has already been searched. ClearGazeboPaths also clears the
+      /// cache.
+      public: void ClearFindFileCache();
+
       /// \brief Add colon delimited paths to Gazebo install
       /// \param[in] _path the directory to add
       public: void AddGazeboPaths(const std::string &_path);
@@ -175,6 +186,15 @@ namespace gazebo
       /// \brief re-read SystemPaths#ogrePaths from environment variable
       private: void UpdateOgrePaths();
 
+      /// \brief Check whether the first component of a relative path is
+      /// an entry of a directory, using a cached listing of the directory.
+      /// A true result still needs an existence check of the full path.
+      /// \param[in] _dir Directory to look in.
+      /// \param[in] _filename Relative path to look for.
+      /// \return False if _filename certainly doesn't exist under _dir.
+      private: bool MaybeInDirectory(const boost::filesystem::path &_dir,
+                                     const std::string &_filename);
+
       /// \brief adds a path to the list if not already present
       /// \param[in]_path the path
       /// \param[in]_list the list
@@ -219,6 +239,14 @@ namespace gazebo
 
       /// \brief Path to the instance temporary directory
       private: boost::filesystem::path tmpInstancePath;
+
+      /// \brief Entry names of each searched resource directory, keyed by
+      /// directory path.
+      private: std::map<std::string, std::set<std::string>> dirListings;
+
+      /// \brief Protects dirListings, since files are looked up from the
+      /// rendering, physics and transport threads.
+      private: std::mutex dirListingsMutex;
     };
     /// \}
   }
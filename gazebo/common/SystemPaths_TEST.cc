@@ -16,9 +16,12 @@
 */
 #include <gtest/gtest.h>
 
+#include <fstream>
 #include <string>
 #include <vector>
 
+#include <boost/filesystem.hpp>
+
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/SystemPaths.hh"
 #include "test/util.hh"
@@ -90,6 +93,35 @@ TEST_F(SystemPathsTest, FindFile)
   }
 }
 
+//////////////////////////////////////////////////
+TEST_F(SystemPathsTest, FindFileCache)
+{
+  auto sysPaths = common::SystemPaths::Instance();
+  const boost::filesystem::path dir =
+      boost::filesystem::path(sysPaths->DefaultTestPath()) / "find_cache";
+  boost::filesystem::remove_all(dir);
+  boost::filesystem::create_directories(dir / "sub");
+  std::ofstream((dir / "first.txt").string()) << "a";
+  sysPaths->AddGazeboPaths(dir.string());
+
+  EXPECT_EQ((dir / "first.txt").string(),
+      sysPaths->FindFile("first.txt", false));
+  EXPECT_EQ("", sysPaths->FindFile("missing.txt", false));
+
+  // Files below a listed entry are still found
+  std::ofstream((dir / "sub" / "nested.txt").string()) << "b";
+  EXPECT_EQ((dir / "sub" / "nested.txt").string(),
+      sysPaths->FindFile("sub/nested.txt", false));
+
+  // New top level entries show up once the cache is cleared
+  std::ofstream((dir / "second.txt").string()) << "c";
+  sysPaths->ClearFindFileCache();
+  EXPECT_EQ((dir / "second.txt").string(),
+      sysPaths->FindFile("second.txt", false));
+
+  boost::filesystem::remove_all(dir);
+}
+
 //////////////////////////////////////////////////
 TEST_F(SystemPathsTest, SystemPaths)
 {
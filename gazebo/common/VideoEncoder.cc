@@ -14,8 +14,13 @@
  * limitations under the License.
  *
 */
+#include <condition_variable>
+#include <deque>
 #include <mutex>
 #include <stdio.h>
+#include <thread>
+#include <utility>
+#include <vector>
 #include <gazebo/gazebo_config.h>
 
 #include <sys/types.h>
@@ -44,6 +49,12 @@ extern "C"
 #if defined(__linux__) && defined(HAVE_AVDEVICE)
 #include <libavdevice/avdevice.h>
 #endif
+
+// Hardware encoders need the hardware frame API of ffmpeg 4
+#if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(58, 18, 100)
+#define VIDEO_ENCODER_HW 1
+#include <libavutil/hwcontext.h>
+#endif
 }
 #endif
 
@@ -58,9 +69,87 @@ using namespace common;
 #define AV_ERROR_MAX_STRING_SIZE 64
 #endif
 
+namespace
+{
+/// \brief A frame waiting to be encoded.
+class VideoEncoderFrame
+{
+  /// \brief RGB pixels of the frame.
+  public: std::vector<unsigned char> data;
+
+  /// \brief Width of the frame.
+  public: unsigned int width = 0;
+
+  /// \brief Height of the frame.
+  public: unsigned int height = 0;
+};
+}
+
 // Private data class
 class gazebo::common::VideoEncoderPrivate
 {
+#ifdef HAVE_FFMPEG
+  /// \brief Encode a frame and write its packets, on the encode thread.
+  /// \param[in] _frame RGB pixels of the frame.
+  /// \param[in] _width Width of the frame.
+  /// \param[in] _height Height of the frame.
+  /// \return True on success.
+  public: bool Encode(const unsigned char *_frame, const unsigned int _width,
+              const unsigned int _height);
+
+  /// \brief Send a frame to the codec and write the packets it outputs.
+  /// \param[in] _frame The frame, or nullptr to flush the frames the codec
+  /// holds back, such as the ones before a B-frame.
+  /// \return True on success.
+  public: bool WriteFrame(AVFrame *_frame);
+
+  /// \brief Write a packet output by the codec to the video stream.
+  /// \param[in] _packet The packet, whose timestamps are rescaled.
+  /// \return True on success.
+  public: bool WritePacket(AVPacket *_packet);
+
+  /// \brief Encode queued frames until Stop is called.
+  public: void EncodeLoop();
+
+#ifdef VIDEO_ENCODER_HW
+  /// \brief Find the hardware encoder to use.
+  /// \param[in] _format Output format of the video.
+  /// \return The encoder, or nullptr if it isn't available.
+  public: AVCodec *FindHardwareEncoder(const AVOutputFormat *_format) const;
+
+  /// \brief Create the hardware frames of a VAAPI encoder.
+  /// \return False if there is no VAAPI device, in which case the
+  /// hardware encoder can't be opened.
+  public: bool CreateHardwareFrames();
+#endif
+#endif
+
+  /// \brief Frames waiting to be encoded, oldest first.
+  public: std::deque<VideoEncoderFrame> queue;
+
+  /// \brief Frames already encoded, whose buffers are reused.
+  public: std::vector<VideoEncoderFrame> pool;
+
+  /// \brief Protects queue, pool and stopEncoding.
+  public: std::mutex queueMutex;
+
+  /// \brief Notifies the encode thread of a frame, or of Stop.
+  public: std::condition_variable queueCondition;
+
+  /// \brief True when the encode thread should stop, once it has encoded
+  /// the queued frames.
+  public: bool stopEncoding = false;
+
+  /// \brief Thread which encodes and writes the frames.
+  public: std::thread encodeThread;
+
+  /// \brief Hardware encoder used by Start: "nvenc", "vaapi", or empty
+  /// for a software encoder.
+  public: std::string hardwareEncoder;
+
+  /// \brief True if the video is encoded by hardwareEncoder.
+  public: bool hardware = false;
+
   /// \brief Name of the file which stores the video while it is being
   ///        recorded.
   public: std::string filename;
@@ -87,6 +176,16 @@ class gazebo::common::VideoEncoderPrivate
 
   /// \brief Software scaling context
   public: SwsContext *swsCtx = nullptr;
+
+  /// \brief Pixel format of avOutFrame, which is the one of the codec
+  /// unless frames are uploaded to a hardware encoder.
+  public: AVPixelFormat swFormat = AV_PIX_FMT_YUV420P;
+
+  /// \brief Hardware device of a VAAPI encoder.
+  public: AVBufferRef *hwDeviceCtx = nullptr;
+
+  /// \brief Frame uploaded to a VAAPI encoder.
+  public: AVFrame *hwFrame = nullptr;
 #endif
 
   /// \brief True if the encoder is running
@@ -113,16 +212,297 @@ class gazebo::common::VideoEncoderPrivate
   /// \brief Number of frames in the video
   public: uint64_t frameCount = 0;
 
+  /// \brief Function that receives the encoded packets, if any.
+  public: std::function<void(const unsigned char *, const std::size_t,
+              const bool)> packetCallback;
+
   /// \brief Mutex for thread safety.
   public: std::mutex mutex;
 };
 
+/// \brief Greatest number of frames waiting to be encoded. Frames added
+/// while the encoder is that far behind are dropped.
+static const std::size_t kMaxQueuedFrames = 30;
+
+#ifdef HAVE_FFMPEG
+/////////////////////////////////////////////////
+void VideoEncoderPrivate::EncodeLoop()
+{
+  while (true)
+  {
+    VideoEncoderFrame frame;
+    {
+      std::unique_lock<std::mutex> lock(this->queueMutex);
+      this->queueCondition.wait(lock, [this]
+          {
+            return this->stopEncoding || !this->queue.empty();
+          });
+
+      // Stop once the queued frames are encoded
+      if (this->queue.empty())
+        return;
+
+      frame = std::move(this->queue.front());
+      this->queue.pop_front();
+    }
+
+    this->Encode(frame.data.data(), frame.width, frame.height);
+
+    std::lock_guard<std::mutex> lock(this->queueMutex);
+    this->pool.push_back(std::move(frame));
+  }
+}
+
+/////////////////////////////////////////////////
+bool VideoEncoderPrivate::Encode(const unsigned char *_frame,
+    const unsigned int _width, const unsigned int _height)
+{
+  // Cause the sws to be recreated on image resize
+  if (this->swsCtx && (this->inWidth != _width || this->inHeight != _height))
+  {
+    sws_freeContext(this->swsCtx);
+    this->swsCtx = nullptr;
+
+    if (this->avInFrame)
+#if LIBAVCODEC_VERSION_INT < AV_VERSION_INT(57, 24, 1)
+      av_free(this->avInFrame);
+#else
+      av_frame_free(&this->avInFrame);
+#endif
+    this->avInFrame = nullptr;
+  }
+
+  if (!this->swsCtx)
+  {
+    this->inWidth = _width;
+    this->inHeight = _height;
+
+    if (!this->avInFrame)
+    {
+#if LIBAVCODEC_VERSION_INT < AV_VERSION_INT(57, 24, 1)
+      this->avInFrame = new AVPicture;
+      avpicture_alloc(this->avInFrame, AV_PIX_FMT_RGB24, this->inWidth,
+          this->inHeight);
+#else
+      this->avInFrame = av_frame_alloc();
+
+      av_image_alloc(this->avInFrame->data, this->avInFrame->linesize,
+          this->inWidth, this->inHeight, AV_PIX_FMT_RGB24, 1);
+#endif
+    }
+
+    this->swsCtx = sws_getContext(
+        this->inWidth,
+        this->inHeight,
+        AV_PIX_FMT_RGB24,
+        this->codecCtx->width,
+        this->codecCtx->height,
+        this->swFormat,
+        SWS_BICUBIC, nullptr, nullptr, nullptr);
+
+    if (this->swsCtx == nullptr)
+    {
+      gzerr << "Error while calling sws_getContext\n";
+      return false;
+    }
+  }
+
+  // encode
+  memcpy(this->avInFrame->data[0], _frame,
+         this->inWidth * this->inHeight * 3);
+
+  sws_scale(this->swsCtx,
+      this->avInFrame->data,
+      this->avInFrame->linesize,
+      0, this->inHeight,
+      this->avOutFrame->data,
+      this->avOutFrame->linesize);
+
+  this->avOutFrame->pts = this->frameCount++;
+
+#ifdef VIDEO_ENCODER_HW
+  if (this->hwFrame)
+  {
+    if (av_hwframe_get_buffer(this->codecCtx->hw_frames_ctx, this->hwFrame,
+          0) < 0 ||
+        av_hwframe_transfer_data(this->hwFrame, this->avOutFrame, 0) < 0)
+    {
+      gzerr << "Could not upload a frame to the hardware video encoder\n";
+      av_frame_unref(this->hwFrame);
+      return false;
+    }
+    this->hwFrame->pts = this->avOutFrame->pts;
+
+    const bool result = this->WriteFrame(this->hwFrame);
+    av_frame_unref(this->hwFrame);
+    return result;
+  }
+#endif
+
+  return this->WriteFrame(this->avOutFrame);
+}
+
+/////////////////////////////////////////////////
+// This function supports ffmpeg2
+bool VideoEncoderPrivate::WriteFrame(AVFrame *_frame)
+{
+#if LIBAVCODEC_VERSION_INT < AV_VERSION_INT(57, 40, 101)
+  // A null frame outputs one delayed packet at a time
+  int gotOutput = 0;
+  do
+  {
+    AVPacket avPacket;
+    av_init_packet(&avPacket);
+    avPacket.data = nullptr;
+    avPacket.size = 0;
+
+    int ret = avcodec_encode_video2(this->codecCtx, &avPacket, _frame,
+        &gotOutput);
+    if (ret < 0)
+      return false;
+
+    bool written = gotOutput != 1 || this->WritePacket(&avPacket);
+    av_packet_unref(&avPacket);
+    if (!written)
+      return false;
+  } while (!_frame && gotOutput == 1);
+
+  return true;
+
+// #else for libavcodec version check
+#else
+  AVPacket *avPacket = av_packet_alloc();
+
+  // A null frame puts the codec in draining mode, where it outputs all
+  // the delayed packets
+  int ret = avcodec_send_frame(this->codecCtx, _frame);
+
+  // This loop will retrieve and write available packets
+  while (ret >= 0)
+  {
+    ret = avcodec_receive_packet(this->codecCtx, avPacket);
+    if (ret >= 0)
+    {
+      this->WritePacket(avPacket);
+      av_packet_unref(avPacket);
+    }
+  }
+
+  av_packet_free(&avPacket);
+  return ret == AVERROR(EAGAIN) || ret == AVERROR_EOF;
+#endif
+}
+
+/////////////////////////////////////////////////
+bool VideoEncoderPrivate::WritePacket(AVPacket *_packet)
+{
+  _packet->stream_index = this->videoStream->index;
+
+  // Scale timestamp appropriately.
+  if (_packet->pts != static_cast<int64_t>(AV_NOPTS_VALUE))
+  {
+    _packet->pts = av_rescale_q(_packet->pts, this->codecCtx->time_base,
+        this->videoStream->time_base);
+  }
+
+  if (_packet->dts != static_cast<int64_t>(AV_NOPTS_VALUE))
+  {
+    _packet->dts = av_rescale_q(_packet->dts, this->codecCtx->time_base,
+        this->videoStream->time_base);
+  }
+
+  // A streamed video isn't written
+  if (this->packetCallback)
+  {
+    this->packetCallback(_packet->data, _packet->size,
+        (_packet->flags & AV_PKT_FLAG_KEY) != 0);
+    return true;
+  }
+
+  // Write frame to disk
+  if (av_interleaved_write_frame(this->formatCtx, _packet) < 0)
+  {
+    gzerr << "Error writing frame" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+#ifdef VIDEO_ENCODER_HW
+/////////////////////////////////////////////////
+AVCodec *VideoEncoderPrivate::FindHardwareEncoder(
+    const AVOutputFormat *_format) const
+{
+  // The hardware encoders are H.264 ones
+  if (avformat_query_codec(_format, AV_CODEC_ID_H264,
+        FF_COMPLIANCE_NORMAL) != 1)
+  {
+    gzwarn << "Format[" << _format->name << "] can't hold H.264 video, "
+           << "using a software encoder.\n";
+    return nullptr;
+  }
+
+  const std::string name = "h264_" + this->hardwareEncoder;
+  AVCodec *encoder = avcodec_find_encoder_by_name(name.c_str());
+  if (!encoder)
+  {
+    gzwarn << "Hardware video encoder[" << name << "] not found, "
+           << "using a software encoder.\n";
+  }
+  return encoder;
+}
+
+/////////////////////////////////////////////////
+bool VideoEncoderPrivate::CreateHardwareFrames()
+{
+  if (av_hwdevice_ctx_create(&this->hwDeviceCtx, AV_HWDEVICE_TYPE_VAAPI,
+        nullptr, nullptr, 0) < 0)
+  {
+    return false;
+  }
+
+  AVBufferRef *framesRef = av_hwframe_ctx_alloc(this->hwDeviceCtx);
+  if (!framesRef)
+    return false;
+
+  // Frames are converted to NV12 in software, then uploaded
+  AVHWFramesContext *frames =
+      reinterpret_cast<AVHWFramesContext *>(framesRef->data);
+  frames->format = AV_PIX_FMT_VAAPI;
+  frames->sw_format = AV_PIX_FMT_NV12;
+  frames->width = this->codecCtx->width;
+  frames->height = this->codecCtx->height;
+  frames->initial_pool_size = 20;
+
+  if (av_hwframe_ctx_init(framesRef) < 0)
+  {
+    av_buffer_unref(&framesRef);
+    return false;
+  }
+
+  this->codecCtx->hw_frames_ctx = av_buffer_ref(framesRef);
+  av_buffer_unref(&framesRef);
+  if (!this->codecCtx->hw_frames_ctx)
+    return false;
+
+  this->codecCtx->pix_fmt = AV_PIX_FMT_VAAPI;
+  this->swFormat = AV_PIX_FMT_NV12;
+  this->hwFrame = av_frame_alloc();
+  return this->hwFrame != nullptr;
+}
+#endif
+#endif
+
 /////////////////////////////////////////////////
 VideoEncoder::VideoEncoder()
 : dataPtr(new VideoEncoderPrivate)
 {
   // Make sure libav is loaded.
   common::load();
+
+  const char *hardwareEnv = common::getEnv("GAZEBO_VIDEO_HW_ENCODER");
+  if (hardwareEnv)
+    this->SetHardwareEncoder(hardwareEnv);
 }
 
 /////////////////////////////////////////////////
@@ -143,6 +523,44 @@ unsigned int VideoEncoder::BitRate() const
   return this->dataPtr->bitRate;
 }
 
+/////////////////////////////////////////////////
+void VideoEncoder::SetHardwareEncoder(const std::string &_encoder)
+{
+  if (!_encoder.empty() && _encoder != "nvenc" && _encoder != "vaapi")
+  {
+    gzwarn << "Unknown hardware video encoder[" << _encoder
+           << "], using a software encoder.\n";
+    this->dataPtr->hardwareEncoder.clear();
+    return;
+  }
+  this->dataPtr->hardwareEncoder = _encoder;
+}
+
+/////////////////////////////////////////////////
+std::string VideoEncoder::HardwareEncoder() const
+{
+  return this->dataPtr->hardwareEncoder;
+}
+
+/////////////////////////////////////////////////
+bool VideoEncoder::IsHardwareEncoding() const
+{
+  return this->dataPtr->encoding && this->dataPtr->hardware;
+}
+
+/////////////////////////////////////////////////
+void VideoEncoder::SetPacketCallback(const std::function<void(
+    const unsigned char *, const std::size_t, const bool)> &_callback)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (this->dataPtr->encoding)
+  {
+    gzwarn << "The packet callback can't be set while encoding.\n";
+    return;
+  }
+  this->dataPtr->packetCallback = _callback;
+}
+
 /////////////////////////////////////////////////
 #ifdef HAVE_FFMPEG
 bool VideoEncoder::Start(const std::string &_format,
@@ -293,9 +711,22 @@ bool VideoEncoder::Start(const std::string &_format,
     return false;
   }
 
-  // find the video encoder
-  AVCodec *encoder = avcodec_find_encoder(
-      this->dataPtr->formatCtx->oformat->video_codec);
+  // find the video encoder, preferring the hardware one
+  AVCodec *encoder = nullptr;
+  this->dataPtr->hardware = false;
+#ifdef VIDEO_ENCODER_HW
+  if (!this->dataPtr->hardwareEncoder.empty())
+  {
+    encoder = this->dataPtr->FindHardwareEncoder(
+        this->dataPtr->formatCtx->oformat);
+    this->dataPtr->hardware = encoder != nullptr;
+  }
+#endif
+  if (!encoder)
+  {
+    encoder = avcodec_find_encoder(
+        this->dataPtr->formatCtx->oformat->video_codec);
+  }
   if (!encoder)
   {
     gzerr << "Codec for["
@@ -368,13 +799,17 @@ bool VideoEncoder::Start(const std::string &_format,
 
   // Emit one intra-frame every 10 frames
   this->dataPtr->codecCtx->gop_size = 10;
-  this->dataPtr->codecCtx->max_b_frames = 1;
+  // A B-frame holds back the frames before it, which a stream can't wait
+  // for
+  this->dataPtr->codecCtx->max_b_frames =
+      this->dataPtr->packetCallback ? 0 : 1;
   this->dataPtr->codecCtx->pix_fmt = AV_PIX_FMT_YUV420P;
   this->dataPtr->codecCtx->thread_count = 5;
+  this->dataPtr->swFormat = AV_PIX_FMT_YUV420P;
+
+  // Set the codec id, which is H.264 for a hardware encoder
+  this->dataPtr->codecCtx->codec_id = encoder->id;
 
-  // Set the codec id
-  this->dataPtr->codecCtx->codec_id =
-    this->dataPtr->formatCtx->oformat->video_codec;
 
   if (this->dataPtr->codecCtx->codec_id == AV_CODEC_ID_MPEG1VIDEO)
   {
@@ -384,21 +819,54 @@ bool VideoEncoder::Start(const std::string &_format,
     this->dataPtr->codecCtx->mb_decision = 2;
   }
 
-  if (this->dataPtr->codecCtx->codec_id == AV_CODEC_ID_H264)
+  // The presets are the ones of x264
+  if (this->dataPtr->codecCtx->codec_id == AV_CODEC_ID_H264 &&
+      !this->dataPtr->hardware)
   {
-    av_opt_set(this->dataPtr->codecCtx->priv_data, "preset", "slow", 0);
+    // A stream is encoded as fast as the frames arrive
+    const char *preset = this->dataPtr->packetCallback ? "veryfast" : "slow";
+    av_opt_set(this->dataPtr->codecCtx->priv_data, "preset", preset, 0);
+    if (this->dataPtr->packetCallback)
+    {
+      av_opt_set(this->dataPtr->codecCtx->priv_data, "tune", "zerolatency",
+          0);
+    }
 
 #if LIBAVCODEC_VERSION_INT < AV_VERSION_INT(57, 24, 1)
     av_opt_set(this->dataPtr->videoStream->codec->priv_data,
-        "preset", "slow", 0);
+        "preset", preset, 0);
 #else
-    av_opt_set(this->dataPtr->videoStream->priv_data, "preset", "slow", 0);
+    av_opt_set(this->dataPtr->videoStream->priv_data, "preset", preset, 0);
 #endif
   }
 
+  int ret = 0;
+#ifdef VIDEO_ENCODER_HW
+  // VAAPI encodes frames uploaded to the GPU
+  if (this->dataPtr->hardware && this->dataPtr->hardwareEncoder == "vaapi" &&
+      !this->dataPtr->CreateHardwareFrames())
+  {
+    ret = AVERROR(ENODEV);
+  }
+#endif
+
   // Open the video context
-  int ret = avcodec_open2(this->dataPtr->codecCtx, encoder, 0);
-  if (ret < 0)
+  if (ret >= 0)
+    ret = avcodec_open2(this->dataPtr->codecCtx, encoder, 0);
+  if (ret < 0 && this->dataPtr->hardware)
+  {
+    // The encoder exists, but there is no device for it
+    gzwarn << "Could not open hardware video encoder[" << encoder->name
+           << "], using a software encoder.\n";
+    const std::string hardwareEncoder = this->dataPtr->hardwareEncoder;
+    this->Reset();
+    this->dataPtr->hardwareEncoder.clear();
+    const bool result = this->Start(_format, _filename, _width, _height, _fps,
+        _bitRate);
+    this->dataPtr->hardwareEncoder = hardwareEncoder;
+    return result;
+  }
+  else if (ret < 0)
   {
     char errBuff[AV_ERROR_MAX_STRING_SIZE];
     av_strerror(ret, errBuff, AV_ERROR_MAX_STRING_SIZE);
@@ -422,7 +890,7 @@ bool VideoEncoder::Start(const std::string &_format,
     return false;
   }
 
-  this->dataPtr->avOutFrame->format = this->dataPtr->codecCtx->pix_fmt;
+  this->dataPtr->avOutFrame->format = this->dataPtr->swFormat;
   this->dataPtr->avOutFrame->width = this->dataPtr->codecCtx->width;
   this->dataPtr->avOutFrame->height = this->dataPtr->codecCtx->height;
 
@@ -432,7 +900,7 @@ bool VideoEncoder::Start(const std::string &_format,
                      this->dataPtr->avOutFrame->linesize,
                      this->dataPtr->codecCtx->width,
                      this->dataPtr->codecCtx->height,
-                     this->dataPtr->codecCtx->pix_fmt, 32) < 0)
+                     this->dataPtr->swFormat, 32) < 0)
   {
     gzerr << "Could not allocate raw picture buffer."
           << "Video encoding is not started\n";
@@ -466,7 +934,8 @@ bool VideoEncoder::Start(const std::string &_format,
     static_cast<int>(muxMaxDelay * AV_TIME_BASE);
 
   // Open the video stream
-  if (!(this->dataPtr->formatCtx->oformat->flags & AVFMT_NOFILE))
+  if (!(this->dataPtr->formatCtx->oformat->flags & AVFMT_NOFILE) &&
+      !this->dataPtr->packetCallback)
   {
     ret = avio_open(&this->dataPtr->formatCtx->pb,
         this->dataPtr->filename.c_str(), AVIO_FLAG_WRITE);
@@ -484,7 +953,8 @@ bool VideoEncoder::Start(const std::string &_format,
   }
 
   // Write the stream header, if any.
-  ret = avformat_write_header(this->dataPtr->formatCtx, nullptr);
+  if (!this->dataPtr->packetCallback)
+    ret = avformat_write_header(this->dataPtr->formatCtx, nullptr);
   if (ret < 0)
   {
     char errBuff[AV_ERROR_MAX_STRING_SIZE];
@@ -496,6 +966,10 @@ bool VideoEncoder::Start(const std::string &_format,
     return false;
   }
 
+  this->dataPtr->stopEncoding = false;
+  this->dataPtr->encodeThread = std::thread(&VideoEncoderPrivate::EncodeLoop,
+      this->dataPtr.get());
+
   this->dataPtr->encoding = true;
   return true;
 }
@@ -554,164 +1028,31 @@ bool VideoEncoder::AddFrame(const unsigned char *_frame,
 
   this->dataPtr->timePrev = _timestamp;
 
-  // Cause the sws to be recreated on image resize
-  if (this->dataPtr->swsCtx &&
-      (this->dataPtr->inWidth != _width || this->dataPtr->inHeight != _height))
+  // Reuse the buffer of an encoded frame, copying outside of the lock
+  VideoEncoderFrame frame;
   {
-    sws_freeContext(this->dataPtr->swsCtx);
-    this->dataPtr->swsCtx = nullptr;
-
-    if (this->dataPtr->avInFrame)
-#if LIBAVCODEC_VERSION_INT < AV_VERSION_INT(57, 24, 1)
-      av_free(this->dataPtr->avInFrame);
-#else
-      av_frame_free(&this->dataPtr->avInFrame);
-#endif
-    this->dataPtr->avInFrame = nullptr;
-  }
-
-  if (!this->dataPtr->swsCtx)
-  {
-    this->dataPtr->inWidth = _width;
-    this->dataPtr->inHeight = _height;
-
-    if (!this->dataPtr->avInFrame)
-    {
-#if LIBAVCODEC_VERSION_INT < AV_VERSION_INT(57, 24, 1)
-      this->dataPtr->avInFrame = new AVPicture;
-      avpicture_alloc(this->dataPtr->avInFrame,
-          AV_PIX_FMT_RGB24, this->dataPtr->inWidth,
-          this->dataPtr->inHeight);
-#else
-      this->dataPtr->avInFrame = av_frame_alloc();
-
-      av_image_alloc(this->dataPtr->avInFrame->data,
-          this->dataPtr->avInFrame->linesize,
-          this->dataPtr->inWidth, this->dataPtr->inHeight,
-          AV_PIX_FMT_RGB24, 1);
-#endif
-    }
-
-    this->dataPtr->swsCtx = sws_getContext(
-        this->dataPtr->inWidth,
-        this->dataPtr->inHeight,
-        AV_PIX_FMT_RGB24,
-        this->dataPtr->codecCtx->width,
-        this->dataPtr->codecCtx->height,
-        this->dataPtr->codecCtx->pix_fmt,
-        SWS_BICUBIC, nullptr, nullptr, nullptr);
-
-    if (this->dataPtr->swsCtx == nullptr)
-    {
-      gzerr << "Error while calling sws_getContext\n";
+    std::lock_guard<std::mutex> queueLock(this->dataPtr->queueMutex);
+    if (this->dataPtr->queue.size() >= kMaxQueuedFrames)
       return false;
-    }
-  }
-
-  // encode
-  memcpy(this->dataPtr->avInFrame->data[0], _frame,
-         this->dataPtr->inWidth * this->dataPtr->inHeight * 3);
-
-  sws_scale(this->dataPtr->swsCtx,
-      this->dataPtr->avInFrame->data,
-      this->dataPtr->avInFrame->linesize,
-      0, this->dataPtr->inHeight,
-      this->dataPtr->avOutFrame->data,
-      this->dataPtr->avOutFrame->linesize);
-
-  this->dataPtr->avOutFrame->pts = this->dataPtr->frameCount++;
-
-#if LIBAVCODEC_VERSION_INT < AV_VERSION_INT(57, 40, 101)
-  int gotOutput = 0;
-  AVPacket avPacket;
-  av_init_packet(&avPacket);
-  avPacket.data = nullptr;
-  avPacket.size = 0;
-
-  int ret = avcodec_encode_video2(this->dataPtr->codecCtx, &avPacket,
-      this->dataPtr->avOutFrame, &gotOutput);
-
-  if (ret >= 0 && gotOutput == 1)
-  {
-    avPacket.stream_index = this->dataPtr->videoStream->index;
-
-    // Scale timestamp appropriately.
-    if (avPacket.pts != static_cast<int64_t>(AV_NOPTS_VALUE))
+    if (!this->dataPtr->pool.empty())
     {
-      avPacket.pts = av_rescale_q(avPacket.pts,
-          this->dataPtr->codecCtx->time_base,
-          this->dataPtr->videoStream->time_base);
-    }
-
-    if (avPacket.dts != static_cast<int64_t>(AV_NOPTS_VALUE))
-    {
-      avPacket.dts = av_rescale_q(
-          avPacket.dts,
-          this->dataPtr->codecCtx->time_base,
-          this->dataPtr->videoStream->time_base);
-    }
-
-    // Write frame to disk
-    ret = av_interleaved_write_frame(this->dataPtr->formatCtx, &avPacket);
-
-    if (ret < 0)
-    {
-      gzerr << "Error writing frame" << std::endl;
-      return false;
+      frame = std::move(this->dataPtr->pool.back());
+      this->dataPtr->pool.pop_back();
     }
   }
 
-  av_packet_unref(&avPacket);
+  frame.data.assign(_frame, _frame + _width * _height * 3);
+  frame.width = _width;
+  frame.height = _height;
 
-// #else for libavcodec version check
-#else
-
-  AVPacket *avPacket = av_packet_alloc();
-  av_init_packet(avPacket);
-
-  avPacket->data = nullptr;
-  avPacket->size = 0;
-
-  int ret = avcodec_send_frame(this->dataPtr->codecCtx,
-                               this->dataPtr->avOutFrame);
-
-  // This loop will retrieve and write available packets
-  while (ret >= 0)
   {
-    ret = avcodec_receive_packet(this->dataPtr->codecCtx, avPacket);
-
-    // Potential performance improvement: Queue the packets and write in
-    // a separate thread.
-    if (ret >= 0)
-    {
-      avPacket->stream_index = this->dataPtr->videoStream->index;
-
-      // Scale timestamp appropriately.
-      if (avPacket->pts != static_cast<int64_t>(AV_NOPTS_VALUE))
-      {
-        avPacket->pts = av_rescale_q(avPacket->pts,
-            this->dataPtr->codecCtx->time_base,
-            this->dataPtr->videoStream->time_base);
-      }
-
-      if (avPacket->dts != static_cast<int64_t>(AV_NOPTS_VALUE))
-      {
-        avPacket->dts = av_rescale_q(
-            avPacket->dts,
-            this->dataPtr->codecCtx->time_base,
-            this->dataPtr->videoStream->time_base);
-      }
-
-      // Write frame to disk
-      if (av_interleaved_write_frame(this->dataPtr->formatCtx, avPacket) < 0)
-        gzerr << "Error writing frame" << std::endl;
-    }
+    std::lock_guard<std::mutex> queueLock(this->dataPtr->queueMutex);
+    this->dataPtr->queue.push_back(std::move(frame));
   }
-
-  av_packet_unref(avPacket);
-#endif
+  this->dataPtr->queueCondition.notify_one();
   return true;
 }
+
 // #else for HAVE_FFMPEG check
 #else
 bool VideoEncoder::AddFrame(const unsigned char */*_frame*/,
@@ -730,8 +1071,26 @@ bool VideoEncoder::AddFrame(const unsigned char */*_frame*/,
 bool VideoEncoder::Stop()
 {
 #ifdef HAVE_FFMPEG
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  // Let the encoder thread encode the queued frames
+  if (this->dataPtr->encodeThread.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> queueLock(this->dataPtr->queueMutex);
+      this->dataPtr->stopEncoding = true;
+    }
+    this->dataPtr->queueCondition.notify_all();
+    this->dataPtr->encodeThread.join();
+  }
+
   if (this->dataPtr->encoding && this->dataPtr->formatCtx)
-    av_write_trailer(this->dataPtr->formatCtx);
+  {
+    if (this->dataPtr->codecCtx)
+      this->dataPtr->WriteFrame(nullptr);
+    if (!this->dataPtr->packetCallback)
+      av_write_trailer(this->dataPtr->formatCtx);
+  }
 
 #if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(57, 24, 1)
   if (this->dataPtr->codecCtx)
@@ -755,6 +1114,16 @@ bool VideoEncoder::Stop()
 #endif
   this->dataPtr->avOutFrame = nullptr;
 
+#ifdef VIDEO_ENCODER_HW
+  if (this->dataPtr->hwFrame)
+    av_frame_free(&this->dataPtr->hwFrame);
+  this->dataPtr->hwFrame = nullptr;
+
+  if (this->dataPtr->hwDeviceCtx)
+    av_buffer_unref(&this->dataPtr->hwDeviceCtx);
+  this->dataPtr->hwDeviceCtx = nullptr;
+#endif
+
   if (this->dataPtr->swsCtx)
     sws_freeContext(this->dataPtr->swsCtx);
   this->dataPtr->swsCtx = nullptr;
@@ -18,6 +18,8 @@
 #define GAZEBO_COMMON_VIDEOENCODER_HH_
 
 #include <chrono>
+#include <cstddef>
+#include <functional>
 #include <string>
 #include <memory>
 #include <gazebo/util/system.hh>
@@ -43,6 +45,15 @@ namespace gazebo
     /// \class VideoEncoder VideoEncoder.hh common/common.hh
     /// \brief The VideoEncoder class supports encoding a series of images
     /// to a video format, and then writing the video to disk.
+    ///
+    /// Frames are copied into a queue by AddFrame, and encoded and written
+    /// by a thread of the encoder, so that the caller doesn't wait for
+    /// them. When the encoder falls behind by more than 30 frames, new
+    /// frames are dropped.
+    ///
+    /// \remarks Environment Variables:
+    /// GAZEBO_VIDEO_HW_ENCODER: Default hardware encoder, "nvenc" or
+    /// "vaapi". See SetHardwareEncoder.
     class GZ_COMMON_VISIBLE VideoEncoder
     {
       /// \brief Constructor
@@ -85,7 +96,8 @@ namespace gazebo
       /// \return True if Start has been called.
       public: bool IsEncoding() const;
 
-      /// \brief Add a single frame to be encoded
+      /// \brief Add a single frame to be encoded. The frame is copied, and
+      /// encoded later by the encoder thread.
       /// \param[in] _frame Image buffer to be encoded
       /// \param[in] _width Input frame width
       /// \param[in] _height Input frame height
@@ -99,7 +111,9 @@ namespace gazebo
       /// \param[in] _width Input frame width
       /// \param[in] _height Input frame height
       /// \param[in] _timestamp Timestamp of the image frame
-      /// \return True on success.
+      /// \return True on success, false if the frame is skipped to keep
+      /// the frame rate of the video, or dropped because the encoder is
+      /// behind.
       public: bool AddFrame(const unsigned char *_frame,
                   const unsigned int _width,
                   const unsigned int _height,
@@ -118,6 +132,39 @@ namespace gazebo
       /// \return Bit rate
       public: unsigned int BitRate() const;
 
+      /// \brief Set the hardware encoder used by the next Start, for the
+      /// formats which can hold H.264 video, such as "mp4". Start falls
+      /// back to a software encoder when the hardware one isn't available.
+      /// \param[in] _encoder "nvenc" for NVIDIA GPUs, "vaapi" for Intel and
+      /// AMD GPUs, or an empty string for a software encoder.
+      /// \sa IsHardwareEncoding
+      public: void SetHardwareEncoder(const std::string &_encoder);
+
+      /// \brief Get the hardware encoder used by Start.
+      /// \return "nvenc", "vaapi", or an empty string for a software
+      /// encoder.
+      public: std::string HardwareEncoder() const;
+
+      /// \brief Get whether the video is being encoded by the hardware
+      /// encoder.
+      /// \return True if encoding with the hardware encoder, false if not
+      /// encoding or encoding in software.
+      public: bool IsHardwareEncoding() const;
+
+      /// \brief Set a function that receives the encoded packets of the
+      /// video, on the encoder thread, to stream the video while it's
+      /// encoded. The "h264" format suits streaming, since its key frames
+      /// carry the headers needed to decode them. A video started while a
+      /// function is set isn't written to a file, and has no B-frames,
+      /// which would hold back the frames before them. This can't be called
+      /// while encoding.
+      /// \param[in] _callback Function called with the data and size of a
+      /// packet, and whether it holds a key frame. An empty function stops
+      /// the calls.
+      public: void SetPacketCallback(const std::function<void(
+                  const unsigned char *, const std::size_t, const bool)>
+                  &_callback);
+
       /// \brief Reset to default video properties and clean up allocated
       /// memory. This will also delete any temporary files.
       public: void Reset();
@@ -14,6 +14,13 @@
  *
 */
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
 
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/VideoEncoder.hh"
@@ -75,3 +82,105 @@ TEST_F(VideoEncoderTest, Exists)
   EXPECT_FALSE(common::exists(common::cwd() + "/TMP_RECORDING.mp4"));
 #endif
 }
+
+/////////////////////////////////////////////////
+TEST_F(VideoEncoderTest, EncodeFrames)
+{
+  VideoEncoder video;
+
+  // Unknown hardware encoders are ignored
+  video.SetHardwareEncoder("unknown");
+  EXPECT_TRUE(video.HardwareEncoder().empty());
+  video.SetHardwareEncoder("nvenc");
+  EXPECT_EQ("nvenc", video.HardwareEncoder());
+  video.SetHardwareEncoder("");
+
+#ifdef HAVE_FFMPEG
+  const unsigned int width = 64;
+  const unsigned int height = 48;
+  ASSERT_TRUE(video.Start("mp4", "", width, height, 25));
+  EXPECT_FALSE(video.IsHardwareEncoding());
+
+  // Frames are queued without waiting for the encoder. A frame sooner than
+  // the frame rate allows is skipped.
+  std::vector<unsigned char> frame(width * height * 3);
+  auto time = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < 20; ++i)
+  {
+    std::fill(frame.begin(), frame.end(), static_cast<unsigned char>(i * 10));
+    time += std::chrono::milliseconds(40);
+    EXPECT_TRUE(video.AddFrame(frame.data(), width, height, time));
+  }
+  EXPECT_FALSE(video.AddFrame(frame.data(), width, height,
+        time + std::chrono::milliseconds(1)));
+
+  // Saving encodes the queued frames and the delayed ones
+  const std::string filename = common::cwd() + "/encode_frames.mp4";
+  EXPECT_TRUE(video.SaveToFile(filename));
+  EXPECT_FALSE(video.IsEncoding());
+
+  std::ifstream file(filename, std::ios::binary | std::ios::ate);
+  EXPECT_TRUE(file.good());
+  EXPECT_GT(file.tellg(), 0);
+  file.close();
+  std::remove(filename.c_str());
+
+  // A hardware encoder falls back to software when it's not available
+  video.SetHardwareEncoder("vaapi");
+  EXPECT_TRUE(video.Start("mp4", "", width, height, 25));
+  EXPECT_TRUE(video.IsEncoding());
+  video.Reset();
+  EXPECT_FALSE(video.IsEncoding());
+#endif
+}
+
+/////////////////////////////////////////////////
+TEST_F(VideoEncoderTest, StreamPackets)
+{
+#ifdef HAVE_FFMPEG
+  std::mutex mutex;
+  std::size_t bytes = 0;
+  unsigned int packets = 0;
+  unsigned int keyFrames = 0;
+  bool firstKeyFrame = false;
+
+  VideoEncoder video;
+  video.SetPacketCallback([&](const unsigned char *_data,
+        const std::size_t _size, const bool _keyFrame)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        EXPECT_TRUE(_data != nullptr);
+        if (packets == 0)
+          firstKeyFrame = _keyFrame;
+        bytes += _size;
+        ++packets;
+        if (_keyFrame)
+          ++keyFrames;
+      });
+
+  const unsigned int width = 64;
+  const unsigned int height = 48;
+  ASSERT_TRUE(video.Start("h264", "", width, height, 25));
+
+  // The callback can't be changed while encoding
+  video.SetPacketCallback(nullptr);
+
+  std::vector<unsigned char> frame(width * height * 3);
+  auto time = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < 20; ++i)
+  {
+    std::fill(frame.begin(), frame.end(), static_cast<unsigned char>(i * 10));
+    time += std::chrono::milliseconds(40);
+    EXPECT_TRUE(video.AddFrame(frame.data(), width, height, time));
+  }
+  EXPECT_TRUE(video.Stop());
+
+  // Each frame is a packet, and the stream starts with a key frame
+  std::lock_guard<std::mutex> lock(mutex);
+  EXPECT_EQ(20u, packets);
+  EXPECT_GT(bytes, 0u);
+  EXPECT_TRUE(firstKeyFrame);
+  EXPECT_GE(keyFrames, 2u);
+  video.Reset();
+#endif
+}
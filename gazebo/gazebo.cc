@@ -14,6 +14,8 @@
  * limitations under the License.
  *
  */
+#include <cstdlib>
+#include <string>
 #include <vector>
 #include <boost/bind.hpp>
 #include <boost/thread/mutex.hpp>
@@ -66,9 +68,14 @@ bool gazebo::setupServer(int _argc, char **_argv)
 
   gazebo::transport::get_master_uri(host, port);
 
-  g_master = new gazebo::Master();
-  g_master->Init(port);
-  g_master->RunThread();
+  // The servers of a distributed world share the master of the first one
+  const char *external = getenv("GAZEBO_MASTER_EXTERNAL");
+  if (!external || std::string(external) == "0")
+  {
+    g_master = new gazebo::Master();
+    g_master->Init(port);
+    g_master->RunThread();
+  }
 
   if (!gazebo_shared::setup("server-", _argc, _argv, g_plugins))
   {
@@ -177,7 +184,9 @@ gazebo::physics::WorldPtr gazebo::loadWorld(const std::string &_worldFile)
   world = gazebo::physics::create_world();
   gazebo::physics::load_world(world, sdf->Root()->GetElement("world"));
 
-  gazebo::physics::init_world(world, rendering::update_scene_poses);
+  rendering::set_direct_scene_poses(true);
+  gazebo::physics::init_world(world, rendering::update_scene_poses,
+      rendering::has_scene);
 
   return world;
 }
@@ -72,6 +72,8 @@ void help()
   << "  -o [ --profile ] arg          Physics preset profile name from the "
   << "options in\n"
   << "                                the world file.\n"
+  << "  --copies arg (=1)             Number of independent copies of the "
+  << "world to load.\n"
   << "\n";
 }
 
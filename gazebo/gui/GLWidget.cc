@@ -14,6 +14,7 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
 #include <functional>
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
@@ -54,6 +55,10 @@ using namespace gui;
 extern bool g_fullscreen;
 extern ModelRightMenu *g_modelRightMenu;
 
+/// \brief Least time between two frames left to process events, in
+/// milliseconds.
+static const int kMinEventTime = 2;
+
 /////////////////////////////////////////////////
 GLWidget::GLWidget(QWidget *_parent)
   : QWidget(_parent),
@@ -64,7 +69,10 @@ GLWidget::GLWidget(QWidget *_parent)
   this->dataPtr->copyEntityName = "";
   this->dataPtr->modelEditorEnabled = false;
 
+  // The timer is started again after each frame, so that events are
+  // processed between frames that take longer than the period
   this->dataPtr->updateTimer = new QTimer(this);
+  this->dataPtr->updateTimer->setSingleShot(true);
   connect(this->dataPtr->updateTimer, SIGNAL(timeout()),
   this, SLOT(update()));
 
@@ -276,6 +284,8 @@ void GLWidget::moveEvent(QMoveEvent *_e)
 /////////////////////////////////////////////////
 void GLWidget::paintEvent(QPaintEvent *_e)
 {
+  common::Time start = common::Time::GetWallTime();
+
   rendering::UserCameraPtr cam = gui::get_active_camera();
   if (cam && cam->Initialized())
   {
@@ -291,6 +301,14 @@ void GLWidget::paintEvent(QPaintEvent *_e)
     event::Events::preRender();
   }
 
+  if (this->dataPtr->renderPeriod > 0)
+  {
+    int elapsed = static_cast<int>(
+        (common::Time::GetWallTime() - start).Double() * 1000.0);
+    this->dataPtr->updateTimer->start(
+        std::max(kMinEventTime, this->dataPtr->renderPeriod - elapsed));
+  }
+
   _e->accept();
 }
 
@@ -638,7 +656,7 @@ void GLWidget::wheelEvent(QWheelEvent *_event)
   // so limit wheel event to our update rate
   common::Time eventTime = common::Time::GetWallTime();
   double dt = (eventTime - this->dataPtr->lastWheelEventTime).Double();
-  if (dt < this->dataPtr->updateTimer->interval()*1e-3)
+  if (dt < this->dataPtr->renderPeriod*1e-3)
     return;
   this->dataPtr->lastWheelEventTime = eventTime;
 
@@ -901,13 +919,31 @@ void GLWidget::ViewScene(rendering::ScenePtr _scene)
 
   this->dataPtr->userCamera->SetInitialPose(mat.Pose());
 
+  // Level of detail bias of the user camera, separate from the sensors'
+  this->dataPtr->userCamera->SetLodBias(
+      gazebo::gui::getINIProperty<double>("rendering.lod_bias", 1.0));
+
   // client side heightmap configuration
   _scene->SetHeightmapLOD(gazebo::gui::getINIProperty<int>("heightmap.lod", 0));
 
+  // Load the meshes of inserted models without stalling the GUI
+  _scene->SetAsyncLoading(
+      gazebo::gui::getINIProperty<int>("rendering.async_loading", 0) != 0);
+
+  // Render the shadows of a still scene once
+  _scene->SetShadowCaching(
+      gazebo::gui::getINIProperty<int>("rendering.shadow_caching", 0) != 0);
+
+  // Lower the quality of the view to hold a frame rate, if set
+  double targetFps =
+      gazebo::gui::getINIProperty<double>("rendering.target_fps", 0.0);
+  if (targetFps > 0.0)
+    this->dataPtr->userCamera->SetTargetFrameTime(1.0 / targetFps);
+
   // Update at the camera's update rate
-  this->dataPtr->updateTimer->start(
-      static_cast<int>(
-        std::round(1000.0 / this->dataPtr->userCamera->RenderRate())));
+  this->dataPtr->renderPeriod = static_cast<int>(
+      std::round(1000.0 / this->dataPtr->userCamera->RenderRate()));
+  this->dataPtr->updateTimer->start(this->dataPtr->renderPeriod);
 }
 
 /////////////////////////////////////////////////
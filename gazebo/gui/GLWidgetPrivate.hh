@@ -115,6 +115,9 @@ namespace gazebo
       /// \brief Timer used to update the render window.
       public: QTimer *updateTimer = nullptr;
 
+      /// \brief Time between the starts of two frames, in milliseconds.
+      public: int renderPeriod = 0;
+
       /// \brief Time when the last wheel event was processed
       public: common::Time lastWheelEventTime;
     };
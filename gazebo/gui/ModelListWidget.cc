@@ -15,6 +15,7 @@
  *
  */
 #include <functional>
+#include <utility>
 
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/message.h>
@@ -87,6 +88,9 @@ ModelListWidget::ModelListWidget(QWidget *_parent)
   connect(this->dataPtr->modelTreeWidget, SIGNAL(itemClicked(QTreeWidgetItem *,
       int)),
           this, SLOT(OnModelSelection(QTreeWidgetItem *, int)));
+  connect(this->dataPtr->modelTreeWidget,
+      SIGNAL(itemExpanded(QTreeWidgetItem *)),
+      this, SLOT(OnItemExpanded(QTreeWidgetItem *)));
   connect(this->dataPtr->modelTreeWidget,
       SIGNAL(customContextMenuRequested(const QPoint &)),
       this, SLOT(OnCustomContextMenu(const QPoint &)));
@@ -184,6 +188,7 @@ void ModelListWidget::OnModelSelection(QTreeWidgetItem *_item, int /*_column*/)
   {
     std::string name = _item->data(0, Qt::UserRole).toString().toStdString();
     this->dataPtr->propTreeBrowser->clear();
+    this->PopulateModelItem(_item);
     if (name == "Scene")
     {
       this->dataPtr->requestMsg = msgs::CreateRequest("scene_info",
@@ -352,10 +357,22 @@ void ModelListWidget::Update()
 /////////////////////////////////////////////////
 void ModelListWidget::OnModelUpdate(const msgs::Model &_msg)
 {
-  std::lock_guard<std::mutex> lock(*this->dataPtr->receiveMutex);
+  // Only copy what the tree needs, on the receiving thread, so the Qt
+  // thread doesn't copy or hold the visuals and collisions of every model
   msgs::Model msg;
-  msg.CopyFrom(_msg);
-  this->dataPtr->modelMsgs.push_back(msg);
+  msg.set_name(_msg.name());
+  msg.set_id(_msg.id());
+  if (_msg.has_deleted())
+    msg.set_deleted(_msg.deleted());
+  for (int i = 0; i < _msg.link_size(); ++i)
+    msg.add_link()->set_name(_msg.link(i).name());
+  for (int i = 0; i < _msg.joint_size(); ++i)
+    msg.add_joint()->set_name(_msg.joint(i).name());
+  for (int i = 0; i < _msg.plugin_size(); ++i)
+    msg.add_plugin()->set_name(_msg.plugin(i).name());
+
+  std::lock_guard<std::mutex> lock(*this->dataPtr->receiveMutex);
+  this->dataPtr->modelMsgs.push_back(std::move(msg));
 }
 
 /////////////////////////////////////////////////
@@ -371,16 +388,21 @@ void ModelListWidget::OnLightUpdate(const msgs::Light &_msg)
 void ModelListWidget::ProcessModelMsgs()
 {
   std::lock_guard<std::mutex> lock(*this->dataPtr->receiveMutex);
-  QFont subheaderFont;
-  subheaderFont.setBold(true);
+  if (this->dataPtr->modelMsgs.empty())
+    return;
+
+  // New models are added in a single batch once all messages are processed
+  QList<QTreeWidgetItem *> newItems;
+  this->dataPtr->modelTreeWidget->setUpdatesEnabled(false);
 
   for (auto iter = this->dataPtr->modelMsgs.begin();
        iter != this->dataPtr->modelMsgs.end(); ++iter)
   {
     std::string name = (*iter).name();
 
-    QTreeWidgetItem *listItem = this->ListItem((*iter).name(),
-                                                  this->dataPtr->modelsItem);
+    auto itemIt = this->dataPtr->modelItems.find(name);
+    QTreeWidgetItem *listItem = itemIt != this->dataPtr->modelItems.end() ?
+        itemIt->second : nullptr;
 
     if (!listItem)
     {
@@ -388,100 +410,28 @@ void ModelListWidget::ProcessModelMsgs()
       {
         // Create an item for the model name
         QTreeWidgetItem *topItem = new QTreeWidgetItem(
-            this->dataPtr->modelsItem,
             QStringList(QString("%1").arg(QString::fromStdString(name))));
 
         topItem->setData(0, Qt::UserRole, QVariant((*iter).name().c_str()));
-        this->dataPtr->modelTreeWidget->addTopLevelItem(topItem);
-
-        if ((*iter).link_size() > 0)
-        {
-          // Create subheader for links
-          QTreeWidgetItem *linkHeaderItem = new QTreeWidgetItem(topItem,
-          QStringList(QString("%1").arg(QString::fromStdString("LINKS"))));
-          linkHeaderItem->setFont(0, subheaderFont);
-          linkHeaderItem->setFlags(Qt::NoItemFlags);
-          this->dataPtr->modelTreeWidget->addTopLevelItem(linkHeaderItem);
-        }
-
-        for (int i = 0; i < (*iter).link_size(); ++i)
-        {
-          std::string linkName = (*iter).link(i).name();
-          int index = linkName.rfind("::") + 2;
-          std::string linkNameShort = linkName.substr(index,
-                                                      linkName.size() - index);
-
-          QTreeWidgetItem *linkItem = new QTreeWidgetItem(topItem,
-              QStringList(QString("%1").arg(
-                  QString::fromStdString(linkNameShort))));
-
-          linkItem->setData(0, Qt::UserRole, QVariant(linkName.c_str()));
-          linkItem->setData(1, Qt::UserRole, QVariant((*iter).name().c_str()));
-          linkItem->setData(2, Qt::UserRole, QVariant((*iter).id()));
-          linkItem->setData(3, Qt::UserRole, QVariant("Link"));
-          this->dataPtr->modelTreeWidget->addTopLevelItem(linkItem);
-        }
-
-        if ((*iter).joint_size() > 0)
-        {
-          // Create subheader for joints
-          QTreeWidgetItem *jointHeaderItem = new QTreeWidgetItem(topItem,
-          QStringList(QString("%1").arg(QString::fromStdString("JOINTS"))));
-          jointHeaderItem->setFont(0, subheaderFont);
-          jointHeaderItem->setFlags(Qt::NoItemFlags);
-          this->dataPtr->modelTreeWidget->addTopLevelItem(jointHeaderItem);
-        }
-
-        for (int i = 0; i < (*iter).joint_size(); ++i)
-        {
-          std::string jointName = (*iter).joint(i).name();
-
-          int index = jointName.rfind("::") + 2;
-          std::string jointNameShort = jointName.substr(
-              index, jointName.size() - index);
-
-          QTreeWidgetItem *jointItem = new QTreeWidgetItem(topItem,
-              QStringList(QString("%1").arg(
-                  QString::fromStdString(jointNameShort))));
-
-          jointItem->setData(0, Qt::UserRole, QVariant(jointName.c_str()));
-          jointItem->setData(3, Qt::UserRole, QVariant("Joint"));
-          this->dataPtr->modelTreeWidget->addTopLevelItem(jointItem);
-        }
+        this->dataPtr->modelItems[name] = topItem;
+        newItems.append(topItem);
 
-        if ((*iter).plugin_size() > 0)
+        // Links, joints and plugins are only added once the model item is
+        // expanded or selected, keep their names until then
+        if ((*iter).link_size() > 0 || (*iter).joint_size() > 0 ||
+            (*iter).plugin_size() > 0)
         {
-          // Create subheader for plugins
-          QTreeWidgetItem *pluginHeaderItem = new QTreeWidgetItem(topItem,
-          QStringList(QString("%1").arg("PLUGINS")));
-          pluginHeaderItem->setFont(0, subheaderFont);
-          pluginHeaderItem->setFlags(Qt::NoItemFlags);
-          this->dataPtr->modelTreeWidget->addTopLevelItem(pluginHeaderItem);
-        }
-
-        for (int i = 0; i < (*iter).plugin_size(); ++i)
-        {
-          std::string pluginName = (*iter).plugin(i).name();
-
-          QTreeWidgetItem *pluginItem = new QTreeWidgetItem(topItem,
-              QStringList(QString("%1").arg(
-                  QString::fromStdString(pluginName))));
-
-          common::URI pluginUri;
-          pluginUri.SetScheme("data");
-
-          pluginUri.Path().PushBack("world");
-          pluginUri.Path().PushBack(gui::get_world());
-          pluginUri.Path().PushBack("model");
-          pluginUri.Path().PushBack((*iter).name());
-          pluginUri.Path().PushBack("plugin");
-          pluginUri.Path().PushBack(pluginName);
-
-          pluginItem->setData(0, Qt::UserRole,
-              QVariant(pluginUri.Str().c_str()));
-          pluginItem->setData(3, Qt::UserRole, QVariant("Plugin"));
-
-          this->dataPtr->modelTreeWidget->addTopLevelItem(pluginItem);
+          msgs::Model &children = this->dataPtr->modelChildren[name];
+          children.set_name(name);
+          children.set_id((*iter).id());
+          for (int i = 0; i < (*iter).link_size(); ++i)
+            children.add_link()->set_name((*iter).link(i).name());
+          for (int i = 0; i < (*iter).joint_size(); ++i)
+            children.add_joint()->set_name((*iter).joint(i).name());
+          for (int i = 0; i < (*iter).plugin_size(); ++i)
+            children.add_plugin()->set_name((*iter).plugin(i).name());
+
+          topItem->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
         }
       }
     }
@@ -489,8 +439,15 @@ void ModelListWidget::ProcessModelMsgs()
     {
       if ((*iter).has_deleted() && (*iter).deleted())
       {
-        int i = this->dataPtr->modelsItem->indexOfChild(listItem);
-        this->dataPtr->modelsItem->takeChild(i);
+        if (listItem->parent() == this->dataPtr->modelsItem)
+        {
+          int i = this->dataPtr->modelsItem->indexOfChild(listItem);
+          this->dataPtr->modelsItem->takeChild(i);
+        }
+        else if (!newItems.removeOne(listItem))
+          continue;
+        this->ForgetModelItem(listItem);
+        delete listItem;
       }
       else
       {
@@ -500,6 +457,147 @@ void ModelListWidget::ProcessModelMsgs()
     }
   }
   this->dataPtr->modelMsgs.clear();
+
+  this->dataPtr->modelsItem->addChildren(newItems);
+  this->dataPtr->modelTreeWidget->setUpdatesEnabled(true);
+}
+
+/////////////////////////////////////////////////
+void ModelListWidget::PopulateModelItem(QTreeWidgetItem *_item)
+{
+  if (!_item || _item->parent() != this->dataPtr->modelsItem)
+    return;
+
+  auto childrenIt = this->dataPtr->modelChildren.find(
+      _item->data(0, Qt::UserRole).toString().toStdString());
+  if (childrenIt == this->dataPtr->modelChildren.end())
+    return;
+
+  const msgs::Model &msg = childrenIt->second;
+
+  QFont subheaderFont;
+  subheaderFont.setBold(true);
+
+  QList<QTreeWidgetItem *> items;
+
+  if (msg.link_size() > 0)
+  {
+    // Create subheader for links
+    QTreeWidgetItem *linkHeaderItem = new QTreeWidgetItem(
+        QStringList(QString("%1").arg(QString::fromStdString("LINKS"))));
+    linkHeaderItem->setFont(0, subheaderFont);
+    linkHeaderItem->setFlags(Qt::NoItemFlags);
+    items.append(linkHeaderItem);
+  }
+
+  for (int i = 0; i < msg.link_size(); ++i)
+  {
+    std::string linkName = msg.link(i).name();
+    int index = linkName.rfind("::") + 2;
+    std::string linkNameShort = linkName.substr(index,
+                                                linkName.size() - index);
+
+    QTreeWidgetItem *linkItem = new QTreeWidgetItem(
+        QStringList(QString("%1").arg(
+            QString::fromStdString(linkNameShort))));
+
+    linkItem->setData(0, Qt::UserRole, QVariant(linkName.c_str()));
+    linkItem->setData(1, Qt::UserRole, QVariant(msg.name().c_str()));
+    linkItem->setData(2, Qt::UserRole, QVariant(msg.id()));
+    linkItem->setData(3, Qt::UserRole, QVariant("Link"));
+    this->dataPtr->modelItems[linkName] = linkItem;
+    items.append(linkItem);
+  }
+
+  if (msg.joint_size() > 0)
+  {
+    // Create subheader for joints
+    QTreeWidgetItem *jointHeaderItem = new QTreeWidgetItem(
+        QStringList(QString("%1").arg(QString::fromStdString("JOINTS"))));
+    jointHeaderItem->setFont(0, subheaderFont);
+    jointHeaderItem->setFlags(Qt::NoItemFlags);
+    items.append(jointHeaderItem);
+  }
+
+  for (int i = 0; i < msg.joint_size(); ++i)
+  {
+    std::string jointName = msg.joint(i).name();
+
+    int index = jointName.rfind("::") + 2;
+    std::string jointNameShort = jointName.substr(
+        index, jointName.size() - index);
+
+    QTreeWidgetItem *jointItem = new QTreeWidgetItem(
+        QStringList(QString("%1").arg(
+            QString::fromStdString(jointNameShort))));
+
+    jointItem->setData(0, Qt::UserRole, QVariant(jointName.c_str()));
+    jointItem->setData(3, Qt::UserRole, QVariant("Joint"));
+    this->dataPtr->modelItems[jointName] = jointItem;
+    items.append(jointItem);
+  }
+
+  if (msg.plugin_size() > 0)
+  {
+    // Create subheader for plugins
+    QTreeWidgetItem *pluginHeaderItem = new QTreeWidgetItem(
+        QStringList(QString("%1").arg("PLUGINS")));
+    pluginHeaderItem->setFont(0, subheaderFont);
+    pluginHeaderItem->setFlags(Qt::NoItemFlags);
+    items.append(pluginHeaderItem);
+  }
+
+  for (int i = 0; i < msg.plugin_size(); ++i)
+  {
+    std::string pluginName = msg.plugin(i).name();
+
+    QTreeWidgetItem *pluginItem = new QTreeWidgetItem(
+        QStringList(QString("%1").arg(
+            QString::fromStdString(pluginName))));
+
+    common::URI pluginUri;
+    pluginUri.SetScheme("data");
+
+    pluginUri.Path().PushBack("world");
+    pluginUri.Path().PushBack(gui::get_world());
+    pluginUri.Path().PushBack("model");
+    pluginUri.Path().PushBack(msg.name());
+    pluginUri.Path().PushBack("plugin");
+    pluginUri.Path().PushBack(pluginName);
+
+    pluginItem->setData(0, Qt::UserRole,
+        QVariant(pluginUri.Str().c_str()));
+    pluginItem->setData(3, Qt::UserRole, QVariant("Plugin"));
+    this->dataPtr->modelItems[pluginUri.Str()] = pluginItem;
+    items.append(pluginItem);
+  }
+
+  this->dataPtr->modelChildren.erase(childrenIt);
+
+  _item->addChildren(items);
+  _item->setChildIndicatorPolicy(
+      QTreeWidgetItem::DontShowIndicatorWhenChildless);
+}
+
+/////////////////////////////////////////////////
+void ModelListWidget::ForgetModelItem(QTreeWidgetItem *_item)
+{
+  const std::string name =
+      _item->data(0, Qt::UserRole).toString().toStdString();
+  this->dataPtr->modelItems.erase(name);
+  this->dataPtr->modelChildren.erase(name);
+
+  for (int i = 0; i < _item->childCount(); ++i)
+  {
+    this->dataPtr->modelItems.erase(
+        _item->child(i)->data(0, Qt::UserRole).toString().toStdString());
+  }
+}
+
+/////////////////////////////////////////////////
+void ModelListWidget::OnItemExpanded(QTreeWidgetItem *_item)
+{
+  this->PopulateModelItem(_item);
 }
 
 /////////////////////////////////////////////////
@@ -610,6 +708,10 @@ void ModelListWidget::RemoveEntity(const std::string &_name)
     QTreeWidgetItem *listItem = this->ListItem(_name, items[i]);
     if (listItem)
     {
+      if (i == 0)
+        this->ForgetModelItem(listItem);
+      else
+        this->dataPtr->lightItems.erase(_name);
       items[i]->takeChild(items[i]->indexOfChild(listItem));
       this->dataPtr->propTreeBrowser->clear();
       this->dataPtr->selectedEntityName.clear();
@@ -624,33 +726,28 @@ void ModelListWidget::RemoveEntity(const std::string &_name)
 QTreeWidgetItem *ModelListWidget::ListItem(const std::string &_name,
                                               QTreeWidgetItem *_parent)
 {
-  QTreeWidgetItem *listItem = nullptr;
+  auto &items = _parent == this->dataPtr->lightsItem ?
+      this->dataPtr->lightItems : this->dataPtr->modelItems;
 
-  // Find an existing element with the name from the message
-  for (int i = 0; i < _parent->childCount() && !listItem; ++i)
-  {
-    QTreeWidgetItem *item = _parent->child(i);
-    std::string listData = item->data(0, Qt::UserRole).toString().toStdString();
+  auto it = items.find(_name);
+  if (it != items.end())
+    return it->second;
 
-    if (listData == _name)
-    {
-      listItem = item;
-      break;
-    }
+  if (_parent != this->dataPtr->modelsItem)
+    return nullptr;
 
-    for (int j = 0; j < item->childCount(); j++)
-    {
-      QTreeWidgetItem *childItem = item->child(j);
-      listData = childItem->data(0, Qt::UserRole).toString().toStdString();
-      if (listData == _name)
-      {
-        listItem = childItem;
-        break;
-      }
-    }
+  // The name may belong to a child of a model which hasn't been populated
+  // yet, so populate the models it could be scoped in and look again
+  for (size_t pos = _name.find("::"); pos != std::string::npos;
+       pos = _name.find("::", pos + 2))
+  {
+    auto modelIt = items.find(_name.substr(0, pos));
+    if (modelIt != items.end())
+      this->PopulateModelItem(modelIt->second);
   }
 
-  return listItem;
+  it = items.find(_name);
+  return it != items.end() ? it->second : nullptr;
 }
 
 /////////////////////////////////////////////////
@@ -2896,6 +2993,9 @@ void ModelListWidget::InitTransport(const std::string &_name)
 void ModelListWidget::ResetTree()
 {
   this->dataPtr->modelTreeWidget->clear();
+  this->dataPtr->modelItems.clear();
+  this->dataPtr->lightItems.clear();
+  this->dataPtr->modelChildren.clear();
 
   // Create the top level of items in the tree widget
   {
@@ -3391,7 +3491,7 @@ void ModelListWidget::ProcessLightMsgs()
           QStringList(QString("%1").arg(QString::fromStdString(name))));
 
       item->setData(0, Qt::UserRole, QVariant((*iter).name().c_str()));
-      this->dataPtr->modelTreeWidget->addTopLevelItem(item);
+      this->dataPtr->lightItems[name] = item;
     }
     else
     {
@@ -49,6 +49,10 @@ namespace gazebo
       private slots: void OnPropertyChanged(QtProperty *_item);
       private slots: void OnCustomContextMenu(const QPoint &_pt);
       private slots: void OnCurrentPropertyChanged(QtBrowserItem *_item);
+
+      /// \brief Called when a tree item is expanded.
+      /// \param[in] _item The expanded item.
+      private slots: void OnItemExpanded(QTreeWidgetItem *_item);
       private: void OnSetSelectedEntity(const std::string &_name,
                                         const std::string &_mode);
       private: void OnResponse(ConstResponsePtr &_msg);
@@ -188,6 +192,15 @@ namespace gazebo
       private: void AddProperty(QtProperty *_item, QtProperty *_parent);
 
       private: void ProcessModelMsgs();
+
+      /// \brief Add the link, joint and plugin items of a model item if they
+      /// haven't been added yet.
+      /// \param[in] _item Model item.
+      private: void PopulateModelItem(QTreeWidgetItem *_item);
+
+      /// \brief Remove a model item and its children from the item maps.
+      /// \param[in] _item Model item.
+      private: void ForgetModelItem(QTreeWidgetItem *_item);
       private: void ProcessLightMsgs();
       private: void ProcessRemoveEntity();
 
@@ -19,6 +19,7 @@
 
 #include <string>
 #include <list>
+#include <map>
 #include <vector>
 #include <deque>
 #include <sdf/sdf.hh>
@@ -99,6 +100,16 @@ namespace gazebo
       typedef std::list<msgs::Light> LightMsgs_L;
       public: LightMsgs_L lightMsgs;
 
+      /// \brief Model, link, joint and plugin items by name.
+      public: std::map<std::string, QTreeWidgetItem *> modelItems;
+
+      /// \brief Light items by name.
+      public: std::map<std::string, QTreeWidgetItem *> lightItems;
+
+      /// \brief Names of the links, joints and plugins of the models whose
+      /// items haven't been populated yet, by model name.
+      public: std::map<std::string, msgs::Model> modelChildren;
+
       typedef std::list<std::string> RemoveEntity_L;
       public: RemoveEntity_L removeEntityList;
 
@@ -212,14 +212,10 @@ void TimePanel::TogglePause()
 /////////////////////////////////////////////////
 void TimePanel::OnStats(ConstWorldStatisticsPtr &_msg)
 {
+  // Only keep the latest statistics, the widgets are updated from the Qt
+  // thread at their own rate
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
-  if (_msg->has_paused())
-    this->SetPaused(_msg->paused());
-
-  if (!this->isVisible())
-    return;
-
   this->dataPtr->simTimes.push_back(msgs::Convert(_msg->sim_time()));
   if (this->dataPtr->simTimes.size() > 20)
     this->dataPtr->simTimes.pop_front();
@@ -228,14 +224,27 @@ void TimePanel::OnStats(ConstWorldStatisticsPtr &_msg)
   if (this->dataPtr->realTimes.size() > 20)
     this->dataPtr->realTimes.pop_front();
 
-  if (_msg->has_log_playback_stats() &&
+  this->dataPtr->statsMsg.CopyFrom(*_msg);
+  this->dataPtr->statsPending = true;
+}
+
+/////////////////////////////////////////////////
+void TimePanel::ApplyStats(const msgs::WorldStatistics &_msg)
+{
+  if (_msg.has_paused())
+    this->SetPaused(_msg.paused());
+
+  if (!this->isVisible())
+    return;
+
+  if (_msg.has_log_playback_stats() &&
       !this->dataPtr->logPlayWidget->isVisible())
   {
     this->SetTimeWidgetVisible(false);
     this->SetLogPlayWidgetVisible(true);
     gui::Events::windowMode("LogPlayback");
   }
-  else if (!_msg->has_log_playback_stats() &&
+  else if (!_msg.has_log_playback_stats() &&
       !this->dataPtr->timeWidget->isVisible())
   {
     this->SetTimeWidgetVisible(true);
@@ -247,40 +256,57 @@ void TimePanel::OnStats(ConstWorldStatisticsPtr &_msg)
   {
     // Set simulation time
     this->dataPtr->timeWidget->EmitSetSimTime(QString::fromStdString(
-        msgs::Convert(_msg->sim_time()).FormattedString()));
+        msgs::Convert(_msg.sim_time()).FormattedString()));
 
     // Set real time
     this->dataPtr->timeWidget->EmitSetRealTime(QString::fromStdString(
-        msgs::Convert(_msg->real_time()).FormattedString()));
+        msgs::Convert(_msg.real_time()).FormattedString()));
 
     // Set the iterations
     this->dataPtr->timeWidget->EmitSetIterations(QString::fromStdString(
-        boost::lexical_cast<std::string>(_msg->iterations())));
+        boost::lexical_cast<std::string>(_msg.iterations())));
   }
   else if (this->dataPtr->logPlayWidget->isVisible())
   {
     // Set current time
     this->dataPtr->logPlayWidget->EmitSetCurrentTime(
-        msgs::Convert(_msg->sim_time()));
+        msgs::Convert(_msg.sim_time()));
 
     // Set start time in text and in ms
     this->dataPtr->logPlayWidget->EmitSetStartTime(
-        msgs::Convert(_msg->log_playback_stats().start_time()));
+        msgs::Convert(_msg.log_playback_stats().start_time()));
 
     // Set end time in text and in ms
     this->dataPtr->logPlayWidget->EmitSetEndTime(
-        msgs::Convert(_msg->log_playback_stats().end_time()));
+        msgs::Convert(_msg.log_playback_stats().end_time()));
   }
 }
 
 /////////////////////////////////////////////////
 void TimePanel::Update()
 {
+  // Apply the latest statistics, if new ones arrived since the last update
+  {
+    msgs::WorldStatistics stats;
+    bool pending = false;
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+      pending = this->dataPtr->statsPending;
+      if (pending)
+      {
+        stats.Swap(&this->dataPtr->statsMsg);
+        this->dataPtr->statsPending = false;
+      }
+    }
+
+    if (pending)
+      this->ApplyStats(stats);
+  }
+
   if (!this->isVisible())
     return;
 
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
-
   // Avoid apparent race condition on start, seen on Windows.
   if (!this->dataPtr->simTimes.size() || !this->dataPtr->realTimes.size())
     return;
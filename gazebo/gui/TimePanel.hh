@@ -118,6 +118,10 @@ namespace gazebo
       /// \param[in] _msg World statistics message.
       private: void OnStats(ConstWorldStatisticsPtr &_msg);
 
+      /// \brief Update the widgets with world statistics.
+      /// \param[in] _msg World statistics message.
+      private: void ApplyStats(const msgs::WorldStatistics &_msg);
+
       /// \internal
       /// \brief Pointer to private data.
       private: TimePanelPrivate *dataPtr;
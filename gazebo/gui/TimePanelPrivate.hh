@@ -24,6 +24,7 @@
 #include "gazebo/common/CommonTypes.hh"
 #include "gazebo/common/Time.hh"
 #include "gazebo/gui/qt.h"
+#include "gazebo/msgs/msgs.hh"
 #include "gazebo/transport/TransportTypes.hh"
 
 namespace gazebo
@@ -43,6 +44,13 @@ namespace gazebo
       /// \brief List of real times used to compute averages.
       public: std::list<common::Time> realTimes;
 
+      /// \brief Latest statistics received, applied to the widgets by
+      /// TimePanel::Update.
+      public: msgs::WorldStatistics statsMsg;
+
+      /// \brief True if statsMsg was received after the last update.
+      public: bool statsPending = false;
+
       /// \brief Mutex to protect the member variables.
       public: std::mutex mutex;
 
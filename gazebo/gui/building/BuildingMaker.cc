@@ -14,7 +14,10 @@
  * limitations under the License.
  *
  */
+#include <map>
 #include <sstream>
+#include <string>
+#include <utility>
 #include <boost/filesystem.hpp>
 #include <ignition/math/Color.hh>
 
@@ -49,6 +52,25 @@
 using namespace gazebo;
 using namespace gui;
 
+namespace
+{
+  /// \brief Remove the cached links of the items which were removed.
+  /// \param[in] _items Items of the building.
+  /// \param[in] _cache Cached links.
+  void PruneLinkCache(
+      const std::map<std::string, BuildingModelManip *> &_items,
+      std::map<std::string, std::pair<std::string, sdf::ElementPtr>> &_cache)
+  {
+    for (auto it = _cache.begin(); it != _cache.end();)
+    {
+      if (_items.find(it->first) == _items.end())
+        it = _cache.erase(it);
+      else
+        ++it;
+    }
+  }
+}
+
 const double BuildingMaker::conversionScale = 0.01;
 
 /////////////////////////////////////////////////
@@ -623,6 +645,8 @@ void BuildingMaker::Reset()
   this->dataPtr->allItems.clear();
 
   this->dataPtr->attachmentMap.clear();
+  this->dataPtr->linkCache.clear();
+  this->dataPtr->csgLinkCache.clear();
 }
 
 /////////////////////////////////////////////////
@@ -701,6 +725,22 @@ void BuildingMaker::GenerateSDF()
     collisionNameStream.str("");
 
     std::string name = itemsIt.first;
+
+    // Reuse the link of an item which didn't change
+    const std::string signature = this->ItemSignature(name, modelOrigin);
+    auto &cached = this->dataPtr->linkCache[name];
+    if (cached.first == signature)
+    {
+      if (cached.second)
+      {
+        cached.second->SetParent(modelElem);
+        modelElem->InsertElement(cached.second);
+      }
+      continue;
+    }
+    cached.first = signature;
+    cached.second.reset();
+
     BuildingModelManip *buildingModelManip = itemsIt.second;
     rendering::VisualPtr visual = buildingModelManip->Visual();
     sdf::ElementPtr newLinkElem = templateLinkElem->Clone();
@@ -994,8 +1034,10 @@ void BuildingMaker::GenerateSDF()
       }
     }
     modelElem->InsertElement(newLinkElem);
+    cached.second = newLinkElem;
   }
   (modelElem->AddElement("static"))->Set("true");
+  PruneLinkCache(this->dataPtr->allItems, this->dataPtr->linkCache);
   // qDebug() << this->dataPtr->modelSDF->ToString().c_str();
 }
 
@@ -1039,6 +1081,26 @@ void BuildingMaker::GenerateSDFWithCSG()
 
     std::string name = itemsIt.first;
     BuildingModelManip *buildingModelManip = itemsIt.second;
+
+    // Reuse the link and boolean mesh of a wall which didn't change
+    const std::string signature = this->ItemSignature(name,
+        ignition::math::Pose3d::Zero);
+    auto &cached = this->dataPtr->csgLinkCache[name];
+    if (cached.first == signature && (!cached.second ||
+        name.find("Wall") == std::string::npos ||
+        common::MeshManager::Instance()->HasMesh(
+          buildingModelManip->Name() + "_Boolean")))
+    {
+      if (cached.second)
+      {
+        cached.second->SetParent(modelElem);
+        modelElem->InsertElement(cached.second);
+      }
+      continue;
+    }
+    cached.first = signature;
+    cached.second.reset();
+
     rendering::VisualPtr visual = buildingModelManip->Visual();
     sdf::ElementPtr newLinkElem = templateLinkElem->Clone();
     visualElem = newLinkElem->GetElement("visual");
@@ -1181,11 +1243,56 @@ void BuildingMaker::GenerateSDFWithCSG()
       }
     }
     modelElem->InsertElement(newLinkElem);
+    cached.second = newLinkElem;
   }
   (modelElem->AddElement("static"))->Set("true");
+  PruneLinkCache(this->dataPtr->allItems, this->dataPtr->csgLinkCache);
 #endif
 }
 
+/////////////////////////////////////////////////
+std::string BuildingMaker::ItemSignature(const std::string &_name,
+    const ignition::math::Pose3d &_origin)
+{
+  std::ostringstream signature;
+  signature << _name << ";" << this->dataPtr->folderName << ";" << _origin
+      << ";" << this->IsAttached(_name) << ";";
+
+  // Everything the link is generated from, for the item and the windows,
+  // doors and stairs attached to it
+  auto describe = [&signature](BuildingModelManip *_manip)
+  {
+    rendering::VisualPtr visual = _manip->Visual();
+    signature << _manip->Name() << ";" << visual->GetParent()->WorldPose()
+        << ";" << visual->WorldPose() << ";" << visual->Pose() << ";"
+        << visual->Scale() << ";" << _manip->Color() << ";"
+        << _manip->Texture() << ";" << _manip->Level() << ";";
+    for (unsigned int i = 0; i < visual->GetChildCount(); ++i)
+    {
+      rendering::VisualPtr child = visual->GetChild(i);
+      signature << child->WorldPose() << ";" << child->Scale() << ";";
+    }
+  };
+
+  BuildingModelManip *manip = this->ManipByName(_name);
+  if (!manip)
+    return signature.str();
+  describe(manip);
+
+  auto attached = this->dataPtr->attachmentMap.find(_name);
+  if (attached != this->dataPtr->attachmentMap.end())
+  {
+    for (auto const &child : attached->second)
+    {
+      signature << child << ";";
+      BuildingModelManip *childManip = this->ManipByName(child);
+      if (childManip)
+        describe(childManip);
+    }
+  }
+  return signature.str();
+}
+
 /////////////////////////////////////////////////
 void BuildingMaker::CreateTheEntity()
 {
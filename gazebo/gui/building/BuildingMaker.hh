@@ -211,6 +211,14 @@ namespace gazebo
       /// \brief Generate SDF with CSG support (to be supported).
       private: void GenerateSDFWithCSG();
 
+      /// \brief Get a signature of everything the link of an item is
+      /// generated from, including the items attached to it.
+      /// \param[in] _name Name of the item.
+      /// \param[in] _origin Origin of the model.
+      /// \return The signature, which changes when the item is edited.
+      private: std::string ItemSignature(const std::string &_name,
+          const ignition::math::Pose3d &_origin);
+
       /// \brief Get a template SDF string of a simple model.
       /// \return A string containing a simple model.
       private: std::string TemplateSDFString() const;
@@ -20,6 +20,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <sdf/sdf.hh>
@@ -130,6 +131,19 @@ namespace gazebo
 
       /// \brief Publisher for factory messages.
       public: transport::PublisherPtr makerPub;
+
+      /// \brief Link element generated for each item by GenerateSDF, with
+      /// the signature of the item it was generated from. An item whose
+      /// signature didn't change reuses its link, so that only the edited
+      /// walls and floors are subdivided again. The link is null for an
+      /// item which has none, such as an attached window.
+      public: std::map<std::string, std::pair<std::string, sdf::ElementPtr>>
+          linkCache;
+
+      /// \brief Same as linkCache, for GenerateSDFWithCSG, whose walls
+      /// reuse the boolean meshes in the mesh manager.
+      public: std::map<std::string, std::pair<std::string, sdf::ElementPtr>>
+          csgLinkCache;
     };
   }
 }
@@ -15,11 +15,15 @@
  *
 */
 
+#include <map>
+#include <string>
+
 #include "gazebo/gui/qt.h"
 #include "gazebo/gui/GuiIface.hh"
 #include "gazebo/gui/MainWindow.hh"
 #include "gazebo/gui/building/BuildingEditorEvents.hh"
 #include "gazebo/gui/building/BuildingMaker.hh"
+#include "gazebo/gui/building/BuildingModelManip.hh"
 #include "gazebo/gui/building/BuildingMaker_TEST.hh"
 
 #include "test_config.h"
@@ -137,5 +141,77 @@ void BuildingMaker_TEST::Layers()
   delete mainWindow;
 }
 
+/////////////////////////////////////////////////
+void BuildingMaker_TEST::RegenerateSDF()
+{
+  this->resMaxPercentChange = 5.0;
+  this->shareMaxPercentChange = 2.0;
+
+  // Load an empty world
+  this->Load("worlds/empty.world", false, false, false);
+
+  // Create the main window.
+  gazebo::gui::MainWindow *mainWindow = new gazebo::gui::MainWindow();
+  QVERIFY(mainWindow != NULL);
+  mainWindow->Load();
+  mainWindow->Init();
+  mainWindow->show();
+
+  this->ProcessEventsAndDraw(mainWindow);
+
+  auto buildingMaker = new gazebo::gui::BuildingMaker();
+  QVERIFY(buildingMaker != NULL);
+
+  auto wall0 = buildingMaker->AddWall(QVector3D(1, 1, 1),
+      QVector3D(0, 0, 0.5), 0);
+  auto wall1 = buildingMaker->AddWall(QVector3D(1, 1, 1),
+      QVector3D(0, 2, 0.5), 0);
+
+  // Get the ambient color of each link of the generated SDF
+  auto ambients = [&buildingMaker]()
+  {
+    std::map<std::string, ignition::math::Color> result;
+    sdf::SDF sdf;
+    sdf.SetFromString(buildingMaker->ModelSDF());
+    auto link = sdf.Root()->GetElement("model")->GetElement("link");
+    while (link)
+    {
+      result[link->Get<std::string>("name")] = link->GetElement("visual")->
+          GetElement("material")->GetElement("ambient")->
+          Get<ignition::math::Color>();
+      link = link->GetNextElement("link");
+    }
+    return result;
+  };
+
+  buildingMaker->GenerateSDF();
+  auto before = ambients();
+  QVERIFY(before.size() == 2u);
+
+  // Generating again without changes gives the same links
+  buildingMaker->GenerateSDF();
+  QVERIFY(ambients() == before);
+
+  // Only the edited wall changes
+  auto manip = buildingMaker->ManipByName(wall0);
+  QVERIFY(manip != NULL);
+  manip->SetColor(QColor(255, 0, 0));
+  buildingMaker->GenerateSDF();
+  auto after = ambients();
+  QVERIFY(after.size() == 2u);
+  QVERIFY(after[wall0] != before[wall0]);
+  QVERIFY(after[wall1] == before[wall1]);
+
+  // A removed wall is gone
+  buildingMaker->RemoveWall(wall1);
+  buildingMaker->GenerateSDF();
+  after = ambients();
+  QVERIFY(after.size() == 1u);
+  QVERIFY(after.find(wall0) != after.end());
+
+  delete buildingMaker;
+  delete mainWindow;
+}
+
 // Generate a main function for the test
 QTEST_MAIN(BuildingMaker_TEST)
@@ -33,6 +33,9 @@ class BuildingMaker_TEST : public QTestFixture
 
   /// \brief Test attaching and detaching manips.
   private slots: void Attach();
+
+  /// \brief Test regenerating the SDF after editing an item.
+  private slots: void RegenerateSDF();
 };
 
 #endif
@@ -14,7 +14,10 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
 #include <map>
+#include <mutex>
+#include <vector>
 #include <ignition/math/Color.hh>
 
 #include "gazebo/common/Assert.hh"
@@ -75,60 +78,126 @@ namespace gazebo
                 return this->d_boundingRect;
               }
 
-      /// \brief Add a point to the sample.
-      /// \param[in] _point Point to add.
-      public: inline void Add(const QPointF &_point)
+      /// \brief Replace the drawn samples.
+      /// \param[in] _samples Samples to draw.
+      public: void SetSamples(const QVector<QPointF> &_samples)
+              {
+                this->d_samples = _samples;
+                this->d_boundingRect = QRectF(0.0, 0.0, -1.0, -1.0);
+              }
+
+      /// \brief Clear the sample data.
+      public: void Clear()
+              {
+                this->d_samples.clear();
+                this->d_samples.squeeze();
+                this->d_boundingRect = QRectF(0.0, 0.0, -1.0, -1.0);
+              }
+    };
+
+    /// \brief Fixed capacity store of all the samples received by a curve.
+    /// The oldest samples are overwritten once it is full.
+    class SampleBuffer
+    {
+      /// \brief Constructor.
+      /// \param[in] _capacity Maximum number of samples kept.
+      public: explicit SampleBuffer(const size_t _capacity)
+              : samples(_capacity)
               {
-                this->d_samples += _point;
+              }
 
-                if (this->d_samples.size() > maxSampleSize)
+      /// \brief Add a sample, overwriting the oldest one when full.
+      /// \param[in] _point Sample to add.
+      public: void Add(const QPointF &_point)
+              {
+                if (this->total == 0u)
                 {
-                  // remove sample window
-                  // update bounding rect?
-                  this->d_samples.remove(0, windowSize);
+                  this->min = _point;
+                  this->max = _point;
                 }
-
-                if (this->d_samples.size() == 1)
+                else
                 {
-                  // init bounding rect
-                  this->d_boundingRect.setTopLeft(_point);
-                  this->d_boundingRect.setBottomRight(_point);
-                  return;
+                  this->min.setX(std::min(this->min.x(), _point.x()));
+                  this->min.setY(std::min(this->min.y(), _point.y()));
+                  this->max.setX(std::max(this->max.x(), _point.x()));
+                  this->max.setY(std::max(this->max.y(), _point.y()));
                 }
 
-                // expand bounding rect
-                if (_point.x() < this->d_boundingRect.left())
-                  this->d_boundingRect.setLeft(_point.x());
-                else if (_point.x() > this->d_boundingRect.right())
-                  this->d_boundingRect.setRight(_point.x());
-                if (_point.y() < this->d_boundingRect.top())
-                  this->d_boundingRect.setTop(_point.y());
-                else if (_point.y() > this->d_boundingRect.bottom())
-                  this->d_boundingRect.setBottom(_point.y());
+                this->samples[(this->start + this->count) %
+                    this->samples.size()] = _point;
+                if (this->count < this->samples.size())
+                  ++this->count;
+                else
+                  this->start = (this->start + 1) % this->samples.size();
+                ++this->total;
               }
 
-      /// \brief Clear the sample data.
+      /// \brief Remove all samples.
       public: void Clear()
               {
-                this->d_samples.clear();
-                this->d_samples.squeeze();
-                this->d_boundingRect = QRectF(0.0, 0.0, -1.0, -1.0);
+                this->start = 0u;
+                this->count = 0u;
+                this->total = 0u;
               }
 
-      /// \brief Get the sample data.
-      /// \return A vector of same points.
-      public: QVector<QPointF> Samples() const
+      /// \brief Get a sample, the oldest one is at index 0.
+      /// \param[in] _index Sample index, must be less than Size().
+      /// \return The sample.
+      public: const QPointF &At(const size_t _index) const
               {
-                return this->d_samples;
+                return this->samples[(this->start + _index) %
+                    this->samples.size()];
               }
 
-      /// \brief maxium sample size of this curve.
-      private: int maxSampleSize = 11000;
+      /// \brief Number of samples in the buffer.
+      /// \return Number of samples.
+      public: size_t Size() const
+              {
+                return this->count;
+              }
 
-      /// \brief Size of samples to remove when maxSampleSize is reached.
-      private: int windowSize = 1000;
-    };
+      /// \brief Index of the first sample with an x value not less than
+      /// the given one. Samples are expected to be in increasing x order.
+      /// \param[in] _x X value.
+      /// \return Sample index, Size() if there is none.
+      public: size_t LowerBound(const double _x) const
+              {
+                size_t first = 0u;
+                size_t len = this->count;
+                while (len > 0u)
+                {
+                  const size_t half = len / 2u;
+                  if (this->At(first + half).x() < _x)
+                  {
+                    first += half + 1u;
+                    len -= half + 1u;
+                  }
+                  else
+                    len = half;
+                }
+                return first;
+              }
+
+      /// \brief Min x and y values of the samples added since the last
+      /// clear.
+      public: QPointF min;
+
+      /// \brief Max x and y values of the samples added since the last
+      /// clear.
+      public: QPointF max;
 
+      /// \brief Number of samples added since the last clear.
+      public: uint64_t total = 0u;
+
+      /// \brief Ring storage.
+      private: std::vector<QPointF> samples;
+
+      /// \brief Index of the oldest sample.
+      private: size_t start = 0u;
+
+      /// \brief Number of samples stored.
+      private: size_t count = 0u;
+    };
 
     /// \internal
     /// \brief PlotCurve private data
@@ -149,9 +218,28 @@ namespace gazebo
       /// \brief Qwt Curve object.
       public: QwtPlotCurve *curve = nullptr;
 
-      /// \brief Curve data in the form of QwtArraySeriesData
+      /// \brief Curve data in the form of QwtArraySeriesData. Only holds the
+      /// decimated samples which are drawn.
       public: CurveData *curveData;
 
+      /// \brief All the received samples. 100 seconds of a 1 kHz signal.
+      public: SampleBuffer buffer{100000u};
+
+      /// \brief Mutex protecting the sample buffer. Samples are added from
+      /// transport threads and drawn from the Qt thread.
+      public: mutable std::mutex mutex;
+
+      /// \brief Number of samples added when the drawn samples were last
+      /// computed.
+      public: uint64_t drawnTotal = 0u;
+
+      /// \brief X range and column count the drawn samples were computed
+      /// for.
+      public: QRectF drawnRange;
+
+      /// \brief Column count the drawn samples were computed for.
+      public: unsigned int drawnColumns = 0u;
+
       /// \brief Global id incremented on every new curve
       public: static unsigned int globalCurveId;
 
@@ -256,7 +344,8 @@ void PlotCurve::AddPoint(const ignition::math::Vector2d &_pt)
     return;
 
   // Add a point
-  this->dataPtr->curveData->Add(QPointF(_pt.X(), _pt.Y()));
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->buffer.Add(QPointF(_pt.X(), _pt.Y()));
 }
 
 /////////////////////////////////////////////////
@@ -266,15 +355,95 @@ void PlotCurve::AddPoints(const std::vector<ignition::math::Vector2d> &_pts)
     return;
 
   // Add all the points
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
   for (const auto &pt : _pts)
   {
-    this->dataPtr->curveData->Add(QPointF(pt.X(), pt.Y()));
+    this->dataPtr->buffer.Add(QPointF(pt.X(), pt.Y()));
+  }
+}
+
+/////////////////////////////////////////////////
+void PlotCurve::Update(const double _minX, const double _maxX,
+    const unsigned int _columns)
+{
+  QVector<QPointF> drawn;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+    const QRectF range(QPointF(_minX, 0.0), QPointF(_maxX, 0.0));
+    if (this->dataPtr->drawnTotal == this->dataPtr->buffer.total &&
+        this->dataPtr->drawnRange == range &&
+        this->dataPtr->drawnColumns == _columns)
+    {
+      return;
+    }
+    this->dataPtr->drawnTotal = this->dataPtr->buffer.total;
+    this->dataPtr->drawnRange = range;
+    this->dataPtr->drawnColumns = _columns;
+
+    const SampleBuffer &buffer = this->dataPtr->buffer;
+
+    // Visible samples, plus one on each side so the line reaches the edges
+    size_t first = buffer.LowerBound(_minX);
+    size_t last = buffer.LowerBound(_maxX);
+    if (first > 0u)
+      --first;
+    if (last < buffer.Size())
+      ++last;
+
+    const size_t count = last - first;
+    const size_t columns = std::max(1u, _columns);
+    if (count <= 4u * columns || _maxX <= _minX)
+    {
+      drawn.reserve(static_cast<int>(count));
+      for (size_t i = first; i < last; ++i)
+        drawn.append(buffer.At(i));
+    }
+    else
+    {
+      // Keep the first, min, max and last samples of each pixel column,
+      // which draws the same as all the samples of the column
+      drawn.reserve(static_cast<int>(4u * columns + 2u));
+      const double width = (_maxX - _minX) / columns;
+      size_t i = first;
+      while (i < last)
+      {
+        const double columnEnd = _minX +
+            (std::floor((buffer.At(i).x() - _minX) / width) + 1.0) * width;
+
+        size_t minIdx = i;
+        size_t maxIdx = i;
+        size_t j = i + 1u;
+        for (; j < last && buffer.At(j).x() < columnEnd; ++j)
+        {
+          if (buffer.At(j).y() < buffer.At(minIdx).y())
+            minIdx = j;
+          if (buffer.At(j).y() > buffer.At(maxIdx).y())
+            maxIdx = j;
+        }
+
+        drawn.append(buffer.At(i));
+        if (std::min(minIdx, maxIdx) != i)
+          drawn.append(buffer.At(std::min(minIdx, maxIdx)));
+        if (minIdx != maxIdx && std::max(minIdx, maxIdx) != j - 1u)
+          drawn.append(buffer.At(std::max(minIdx, maxIdx)));
+        if (j - 1u != i)
+          drawn.append(buffer.At(j - 1u));
+
+        i = j;
+      }
+    }
   }
+
+  this->dataPtr->curveData->SetSamples(drawn);
 }
 
 /////////////////////////////////////////////////
 void PlotCurve::Clear()
 {
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->buffer.Clear();
+  this->dataPtr->drawnTotal = 0u;
   this->dataPtr->curveData->Clear();
 }
 
@@ -342,37 +511,54 @@ void PlotCurve::SetAge(const unsigned int _age)
 /////////////////////////////////////////////////
 unsigned int PlotCurve::Size() const
 {
-  return static_cast<unsigned int>(this->dataPtr->curveData->samples().size());
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return static_cast<unsigned int>(this->dataPtr->buffer.Size());
 }
 
 /////////////////////////////////////////////////
 ignition::math::Vector2d PlotCurve::Min()
 {
-  return ignition::math::Vector2d(this->dataPtr->curve->minXValue(),
-      this->dataPtr->curve->minYValue());
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  const QPointF &pt = this->dataPtr->buffer.min;
+  return ignition::math::Vector2d(pt.x(), pt.y());
 }
 
 /////////////////////////////////////////////////
 ignition::math::Vector2d PlotCurve::Max()
 {
-  return ignition::math::Vector2d(this->dataPtr->curve->maxXValue(),
-      this->dataPtr->curve->maxYValue());
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  const QPointF &pt = this->dataPtr->buffer.max;
+  return ignition::math::Vector2d(pt.x(), pt.y());
 }
 
 /////////////////////////////////////////////////
 ignition::math::Vector2d PlotCurve::Point(const unsigned int _index) const
 {
-  if (_index >= static_cast<unsigned int>(
-      this->dataPtr->curveData->samples().size()))
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (_index >= this->dataPtr->buffer.Size())
   {
     return ignition::math::Vector2d(ignition::math::NAN_D,
         ignition::math::NAN_D);
   }
 
-  const QPointF &pt = this->dataPtr->curveData->samples()[_index];
+  const QPointF &pt = this->dataPtr->buffer.At(_index);
   return ignition::math::Vector2d(pt.x(), pt.y());
 }
 
+/////////////////////////////////////////////////
+std::vector<ignition::math::Vector2d> PlotCurve::Points() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  std::vector<ignition::math::Vector2d> points;
+  points.reserve(this->dataPtr->buffer.Size());
+  for (size_t i = 0; i < this->dataPtr->buffer.Size(); ++i)
+  {
+    const QPointF &pt = this->dataPtr->buffer.At(i);
+    points.push_back(ignition::math::Vector2d(pt.x(), pt.y()));
+  }
+  return points;
+}
+
 /////////////////////////////////////////////////
 QwtPlotCurve *PlotCurve::Curve()
 {
@@ -55,6 +55,15 @@ namespace gazebo
       /// \param[in] _pts Points to add.
       public: void AddPoints(const std::vector<ignition::math::Vector2d> &_pt);
 
+      /// \brief Update the samples drawn by the curve. All the samples are
+      /// kept, but only the first, min, max and last samples of each pixel
+      /// column of the visible range are drawn.
+      /// \param[in] _minX Lower bound of the visible x range.
+      /// \param[in] _maxX Upper bound of the visible x range.
+      /// \param[in] _columns Number of pixel columns of the visible range.
+      public: void Update(const double _minX, const double _maxX,
+                          const unsigned int _columns);
+
       /// \brief Clear all data from the curve.
       public: void Clear();
 
@@ -15,6 +15,9 @@
  *
 */
 
+#include <vector>
+
+#include "gazebo/gui/plot/qwt_gazebo.h"
 #include "gazebo/gui/plot/PlottingTypes.hh"
 #include "gazebo/gui/plot/PlotCurve.hh"
 #include "gazebo/gui/plot/PlotCurve_TEST.hh"
@@ -133,5 +136,43 @@ void PlotCurve_TEST::AddPoint()
   delete plotCurve;
 }
 
+/////////////////////////////////////////////////
+void PlotCurve_TEST::Decimate()
+{
+  this->resMaxPercentChange = 5.0;
+  this->shareMaxPercentChange = 2.0;
+
+  this->Load("worlds/empty.world");
+
+  gazebo::gui::PlotCurve *plotCurve = new gazebo::gui::PlotCurve("curve01");
+  QVERIFY(plotCurve != nullptr);
+
+  // a 1 kHz signal over 200 seconds, the oldest samples are overwritten
+  std::vector<ignition::math::Vector2d> points;
+  for (unsigned int i = 0; i < 200000u; ++i)
+    points.push_back(ignition::math::Vector2d(i * 1e-3, (i % 2) ? 1 : -1));
+  plotCurve->AddPoints(points);
+  QVERIFY(plotCurve->Size() < points.size());
+  QCOMPARE(plotCurve->Point(plotCurve->Size() - 1), points.back());
+
+  // all the samples are visible in few columns
+  unsigned int columns = 100u;
+  plotCurve->Update(0, 200, columns);
+  QwtPlotCurve *curve = plotCurve->Curve();
+  QVERIFY(curve->dataSize() > 0u);
+  QVERIFY(curve->dataSize() <= 4u * columns + 2u);
+
+  // the extremes are kept
+  QCOMPARE(curve->minYValue(), -1.0);
+  QCOMPARE(curve->maxYValue(), 1.0);
+
+  // few samples are visible, they are all drawn
+  plotCurve->Update(199.9, 199.91, columns);
+  QVERIFY(curve->dataSize() >= 10u);
+  QVERIFY(curve->dataSize() <= 13u);
+
+  delete plotCurve;
+}
+
 // Generate a main function for the test
 QTEST_MAIN(PlotCurve_TEST)
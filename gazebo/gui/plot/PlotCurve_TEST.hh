@@ -32,5 +32,8 @@ class PlotCurve_TEST : public QTestFixture
 
   /// \brief Test adding points to the curve
   private slots: void AddPoint();
+
+  /// \brief Test that only the decimated visible samples are drawn
+  private slots: void Decimate();
 };
 #endif
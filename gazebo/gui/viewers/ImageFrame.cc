@@ -16,6 +16,7 @@
  */
 
 #include "gazebo/common/Image.hh"
+#include "gazebo/common/ImageConvert.hh"
 #include "gazebo/gui/viewers/ImageFramePrivate.hh"
 #include "gazebo/gui/viewers/ImageFrame.hh"
 
@@ -73,6 +74,7 @@ void ImageFrame::OnImage(const msgs::Image &_msg)
   switch (_msg.pixel_format())
   {
     case common::Image::PixelFormat::L_INT8:
+    case common::Image::PixelFormat::L_INT16:
     {
       qFormat = QImage::Format_Grayscale8;
       break;
@@ -80,7 +82,7 @@ void ImageFrame::OnImage(const msgs::Image &_msg)
     case common::Image::PixelFormat::R_FLOAT16:
     case common::Image::PixelFormat::R_FLOAT32:
     {
-      qFormat = QImage::Format_RGB888;
+      qFormat = QImage::Format_Grayscale8;
       isDepthImage = true;
       break;
     }
@@ -91,10 +93,17 @@ void ImageFrame::OnImage(const msgs::Image &_msg)
     }
   }
 
+  const bool isInt16Image =
+      _msg.pixel_format() == common::Image::PixelFormat::L_INT16 ||
+      _msg.pixel_format() == common::Image::PixelFormat::RGB_INT16;
+
+  // Converted images have another step than the one of the message, so
+  // their buffers are kept as long as the size and format don't change
   if (_msg.width() != static_cast<unsigned int>(this->dataPtr->image.width()) ||
       _msg.height() != static_cast<unsigned int>(this->dataPtr->image.height())
-      || qFormat != this->dataPtr->image.format() || _msg.step() !=
-      static_cast<unsigned int>(this->dataPtr->image.bytesPerLine()))
+      || qFormat != this->dataPtr->image.format() ||
+      (!isDepthImage && !isInt16Image && _msg.step() !=
+      static_cast<unsigned int>(this->dataPtr->image.bytesPerLine())))
   {
     this->dataPtr->image = QImage(_msg.width(), _msg.height(), qFormat);
     delete [] this->dataPtr->imageBuffer;
@@ -103,7 +112,7 @@ void ImageFrame::OnImage(const msgs::Image &_msg)
     this->dataPtr->depthBuffer = nullptr;
   }
 
-  // Convert the image data to RGB
+  // Convert the image data to 8 bit channels
   if (isDepthImage)
   {
     unsigned int depthSamples = _msg.width() * _msg.height();
@@ -115,31 +124,18 @@ void ImageFrame::OnImage(const msgs::Image &_msg)
       this->dataPtr->depthBuffer = new float[depthSamples];
     memcpy(this->dataPtr->depthBuffer, _msg.data().c_str(), depthBufferSize);
 
-    float maxDepth = 0;
-    for (unsigned int i = 0; i < _msg.height() * _msg.width(); ++i)
-    {
-      if (this->dataPtr->depthBuffer[i] > maxDepth &&
-          !std::isinf(this->dataPtr->depthBuffer[i]))
-      {
-        maxDepth = this->dataPtr->depthBuffer[i];
-      }
-    }
-    unsigned int idx = 0;
-    double factor = 255 / maxDepth;
+    // Near depths are brighter
+    const float maxDepth = common::ImageConvert::MaxDepth(
+        this->dataPtr->depthBuffer, depthSamples);
     for (unsigned int j = 0; j < _msg.height(); ++j)
     {
-      for (unsigned int i = 0; i < _msg.width(); ++i)
-      {
-        float d = this->dataPtr->depthBuffer[idx++];
-        d = 255 - (d * factor);
-        QRgb value = qRgb(d, d, d);
-        this->dataPtr->image.setPixel(i, j, value);
-      }
+      common::ImageConvert::DepthToL8(
+          this->dataPtr->depthBuffer + j * _msg.width(),
+          this->dataPtr->image.scanLine(j), _msg.width(), maxDepth, 0.0f);
     }
   }
-  // convert 16 bit camera images to rgb image format for display
-  else if (_msg.pixel_format() == common::Image::PixelFormat::L_INT16
-      || _msg.pixel_format() == common::Image::PixelFormat::RGB_INT16)
+  // convert 16 bit camera images to 8 bit for display
+  else if (isInt16Image)
   {
     uint16_t u;
     // cppchecker recommends using sizeof(varname)
@@ -151,27 +147,14 @@ void ImageFrame::OnImage(const msgs::Image &_msg)
       this->dataPtr->imageBuffer = new unsigned char[bufferSize];
     memcpy(this->dataPtr->imageBuffer, _msg.data().c_str(), bufferSize);
 
-    // factor to convert from 16bit to 8bit value
-    double factor = 255 / (std::pow(2, 16) - 1);
-    uint16_t *uint16Buffer = reinterpret_cast<uint16_t *>(
+    // L16 is shown as gray, RGB16 as RGB
+    const uint16_t *uint16Buffer = reinterpret_cast<const uint16_t *>(
         this->dataPtr->imageBuffer);
-    int rgb[3] = {0, 0, 0};
-    unsigned int width = _msg.width()*channels;
+    const unsigned int width = _msg.width() * channels;
     for (unsigned int j = 0; j < _msg.height(); ++j)
     {
-      for (unsigned int i = 0; i < width; i+=channels)
-      {
-        u = uint16Buffer[j*width + i] * factor;
-        // for L16 we set rgb to be the same value
-        rgb[0] = rgb[1] = rgb[2] = u;
-        // handle the case for rgb16
-        for (unsigned int k = 1; k < channels; ++k)
-        {
-          rgb[k] = uint16Buffer[j*width + i + k] * factor;
-        }
-        QRgb value = qRgb(rgb[0], rgb[1], rgb[2]);
-        this->dataPtr->image.setPixel(i/channels, j, value);
-      }
+      common::ImageConvert::Int16ToInt8(uint16Buffer + j * width,
+          this->dataPtr->image.scanLine(j), width);
     }
   }
   else
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "gazebo/msgs/ArenaMsg.hh"
+
+#ifdef GAZEBO_MSGS_ARENAS
+#include <memory>
+#include <vector>
+
+namespace
+{
+  /// \brief Size of the block of memory each thread keeps for its arena.
+  const std::size_t kArenaBlockSize = 64 * 1024;
+
+  /// \brief Arena of a thread.
+  struct ThreadArena
+  {
+    /// \brief Constructor, creates the arena on its first block.
+    ThreadArena()
+      : block(kArenaBlockSize)
+    {
+      google::protobuf::ArenaOptions options;
+      options.initial_block = this->block.data();
+      options.initial_block_size = this->block.size();
+      this->arena.reset(new google::protobuf::Arena(options));
+    }
+
+    /// \brief First block of the arena, kept when it's reset.
+    std::vector<char> block;
+
+    /// \brief The arena.
+    std::unique_ptr<google::protobuf::Arena> arena;
+
+    /// \brief Number of messages which use the arena.
+    unsigned int users = 0;
+  };
+
+  /// \brief Get the arena of the calling thread.
+  /// \return The arena.
+  ThreadArena &LocalArena()
+  {
+    static thread_local ThreadArena arena;
+    return arena;
+  }
+}
+
+namespace gazebo
+{
+  namespace msgs
+  {
+    //////////////////////////////////////////////////
+    google::protobuf::Arena *AcquireThreadArena()
+    {
+      ThreadArena &local = LocalArena();
+      ++local.users;
+      return local.arena.get();
+    }
+
+    //////////////////////////////////////////////////
+    void ReleaseThreadArena()
+    {
+      ThreadArena &local = LocalArena();
+      if (local.users > 0 && --local.users == 0)
+        local.arena->Reset();
+    }
+  }
+}
+#endif
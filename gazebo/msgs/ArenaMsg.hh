@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_MSGS_ARENAMSG_HH_
+#define GAZEBO_MSGS_ARENAMSG_HH_
+
+#include <google/protobuf/stubs/common.h>
+
+// Before 3.14, only the messages which set cc_enable_arenas can be
+// created on an arena.
+#if GOOGLE_PROTOBUF_VERSION >= 3014000
+#define GAZEBO_MSGS_ARENAS 1
+#include <google/protobuf/arena.h>
+#endif
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace msgs
+  {
+    /// \addtogroup gazebo_msgs Messages
+    /// \{
+
+#ifdef GAZEBO_MSGS_ARENAS
+    /// \brief Get the arena of the calling thread, and register a user.
+    /// \return The arena.
+    GAZEBO_VISIBLE
+    google::protobuf::Arena *AcquireThreadArena();
+
+    /// \brief Unregister a user of the arena of the calling thread. When
+    /// there are no users left, the messages created on it are destroyed,
+    /// and its first block of memory is kept for the next ones.
+    GAZEBO_VISIBLE
+    void ReleaseThreadArena();
+#endif
+
+    /// \class ArenaMsg ArenaMsg.hh msgs/msgs.hh
+    /// \brief A message created on the arena of the calling thread, for
+    /// the messages which are built and published in each step. Their
+    /// fields are allocated together, and freed at once when the last
+    /// ArenaMsg of the thread is destroyed, instead of one by one.
+    ///
+    /// The message must not be used after the ArenaMsg is destroyed, nor
+    /// from another thread. Publishing it is fine, since the publisher
+    /// copies it.
+    template<typename T>
+    class ArenaMsg
+    {
+      /// \brief Constructor, creates an empty message.
+      public: ArenaMsg()
+      {
+#ifdef GAZEBO_MSGS_ARENAS
+        this->msg =
+            google::protobuf::Arena::CreateMessage<T>(AcquireThreadArena());
+#else
+        this->msg = new T();
+#endif
+      }
+
+      /// \brief Destructor, releases the arena.
+      public: ~ArenaMsg()
+      {
+#ifdef GAZEBO_MSGS_ARENAS
+        ReleaseThreadArena();
+#else
+        delete this->msg;
+#endif
+      }
+
+      /// \brief Not copyable, the message belongs to the arena.
+      public: ArenaMsg(const ArenaMsg &) = delete;
+
+      /// \brief Not copyable, the message belongs to the arena.
+      public: ArenaMsg &operator=(const ArenaMsg &) = delete;
+
+      /// \brief Get the message.
+      /// \return The message.
+      public: T &operator*() const
+      {
+        return *this->msg;
+      }
+
+      /// \brief Access a member of the message.
+      /// \return Pointer to the message.
+      public: T *operator->() const
+      {
+        return this->msg;
+      }
+
+      /// \brief The message.
+      private: T *msg;
+    };
+    /// \}
+  }
+}
+#endif
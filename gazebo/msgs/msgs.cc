@@ -988,6 +988,12 @@ namespace gazebo
               geomElem->Get<unsigned int>("sampling"));
         }
 
+        if (geomElem->HasElement("gz:dem_level"))
+        {
+          result.mutable_heightmap()->set_dem_level(
+              geomElem->Get<unsigned int>("gz:dem_level"));
+        }
+
         sdf::ElementPtr textureElem = geomElem->GetElement("texture");
         while (textureElem)
         {
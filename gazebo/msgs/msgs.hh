@@ -32,6 +32,7 @@
 #include <ignition/msgs/color.pb.h>
 #include <ignition/msgs/material.pb.h>
 
+#include "gazebo/msgs/ArenaMsg.hh"
 #include "gazebo/msgs/MessageTypes.hh"
 
 #include "gazebo/common/SphericalCoordinates.hh"
@@ -3997,3 +3997,30 @@ TEST_F(MsgsTest, ConvertIgnMsgMaterial)
   EXPECT_DOUBLE_EQ(ignMsg.ambient().a(), ignMsg2.ambient().a());
   EXPECT_EQ(ignMsg.lighting(), ignMsg2.lighting());
 }
+
+/////////////////////////////////////////////////
+TEST_F(MsgsTest, ArenaMsg)
+{
+  for (int i = 0; i < 3; ++i)
+  {
+    msgs::ArenaMsg<msgs::Contacts> msg;
+    EXPECT_EQ(0, msg->contact_size());
+
+    msgs::Contact *contact = msg->add_contact();
+    contact->set_collision1("box::link::collision");
+    contact->set_collision2("ground::link::collision");
+    msgs::Set(contact->add_position(), ignition::math::Vector3d(i, 0, 0));
+    msgs::Set(msg->mutable_time(), common::Time(i, 0));
+
+    // Copies don't belong to the arena, so they outlive it
+    msgs::Contacts copy(*msg);
+    EXPECT_EQ(1, copy.contact_size());
+    EXPECT_DOUBLE_EQ(i, copy.contact(0).position(0).x());
+    EXPECT_EQ(i, copy.time().sec());
+
+#ifdef GAZEBO_MSGS_ARENAS
+    EXPECT_NE(nullptr, msg->GetArena());
+    EXPECT_EQ(nullptr, copy.GetArena());
+#endif
+  }
+}
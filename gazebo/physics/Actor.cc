@@ -19,6 +19,7 @@
 #include <algorithm>
 
 #include "gazebo/common/BVHLoader.hh"
+#include "gazebo/common/CompiledSkeletonAnimation.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/KeyFrame.hh"
 #include "gazebo/common/MeshManager.hh"
@@ -48,6 +49,60 @@ class gazebo::physics::ActorPrivate
   /// \brief Rotations to align BVH skeleton to DAE skin
   public: std::map<std::string, ignition::math::Matrix4d>
       rotationAligner;
+
+  /// \brief A skeleton animation compiled for the bones of the skin.
+  public: class BoneAnimation
+  {
+    /// \brief The animation it was compiled from.
+    public: const common::SkeletonAnimation *source = nullptr;
+
+    /// \brief Animation node of each bone, by handle, empty if the bone
+    /// isn't animated.
+    public: std::vector<std::string> nodes;
+
+    /// \brief The compiled animation, with a node per bone.
+    public: std::unique_ptr<common::CompiledSkeletonAnimation> animation;
+  };
+
+  /// \brief Get an animation compiled for the bones of the skin. It's
+  /// compiled on first use, and again if the animation of its type is
+  /// replaced.
+  /// \param[in] _type Animation type.
+  /// \param[in] _animation The animation of the type.
+  /// \param[in] _skelMap Animation node of each bone, by bone name.
+  /// \param[in] _skeleton Skeleton of the skin.
+  /// \return The compiled animation.
+  public: const BoneAnimation &Compiled(const std::string &_type,
+              const common::SkeletonAnimation *_animation,
+              const std::map<std::string, std::string> &_skelMap,
+              common::Skeleton *_skeleton)
+  {
+    BoneAnimation &compiled = this->boneAnimations[_type];
+    if (compiled.source == _animation && compiled.animation)
+      return compiled;
+
+    compiled.source = _animation;
+    compiled.nodes.assign(_skeleton->GetNumNodes(), std::string());
+    for (unsigned int i = 0; i < _skeleton->GetNumNodes(); ++i)
+    {
+      auto iter = _skelMap.find(_skeleton->GetNodeByHandle(i)->GetName());
+      if (iter != _skelMap.end() && _animation->HasNode(iter->second))
+        compiled.nodes[i] = iter->second;
+    }
+    compiled.animation.reset(new common::CompiledSkeletonAnimation(
+          *_animation, compiled.nodes));
+    return compiled;
+  }
+
+  /// \brief Compiled animations, indexed by animation type.
+  public: std::map<std::string, BoneAnimation> boneAnimations;
+
+  /// \brief Transform of each bone in the current frame, by handle.
+  /// Reused between frames.
+  public: std::vector<ignition::math::Matrix4d> frame;
+
+  /// \brief Link of each bone, by handle.
+  public: std::vector<gazebo::physics::LinkPtr> boneLinks;
 };
 
 using namespace gazebo;
@@ -770,35 +825,25 @@ void Actor::Update()
     return;
   }
 
-  auto skelMap = this->skelNodesMap[tinfo->type];
+  const ActorPrivate::BoneAnimation &compiled = this->dataPtr->Compiled(
+      tinfo->type, skelAnim, this->skelNodesMap[tinfo->type], this->skeleton);
+  const unsigned int rootHandle = this->skeleton->GetRootNode()->GetHandle();
 
-  std::map<std::string, ignition::math::Matrix4d> frame;
-  if (!this->customTrajectoryInfo)
-  {
-    if (this->interpolateX[tinfo->type] &&
-          this->trajectories.find(tinfo->id) != this->trajectories.end())
-    {
-      frame = skelAnim->PoseAtX(this->pathLength,
-                skelMap[this->skeleton->GetRootNode()->GetName()]);
-    }
-    else
-    {
-      frame = skelAnim->PoseAt(this->scriptTime);
-    }
-  }
-  else
+  double animTime = this->scriptTime;
+  if (!this->customTrajectoryInfo && this->interpolateX[tinfo->type] &&
+      this->trajectories.find(tinfo->id) != this->trajectories.end())
   {
-    frame = skelAnim->PoseAt(this->scriptTime);
+    animTime = compiled.animation->TimeAtX(this->pathLength, rootHandle);
   }
 
+  std::vector<ignition::math::Matrix4d> &frame = this->dataPtr->frame;
+  compiled.animation->PoseAt(animTime, frame);
+
   this->lastTraj = tinfo->id;
 
   ignition::math::Matrix4d rootTrans = ignition::math::Matrix4d::Identity;
-  auto iter = frame.find(skelMap[this->skeleton->GetRootNode()->GetName()]);
-  if (iter != frame.end())
-  {
-    rootTrans = frame[skelMap[this->skeleton->GetRootNode()->GetName()]];
-  }
+  if (compiled.animation->Animated(rootHandle))
+    rootTrans = frame[rootHandle];
 
   ignition::math::Vector3d rootPos = rootTrans.Translation();
   ignition::math::Quaterniond rootRot = rootTrans.Rotation();
@@ -839,14 +884,14 @@ void Actor::Update()
   // workaround for rotation bug
   rootM.SetTranslation(rootM.Translation() * this->skinScale);
 
-  frame[skelMap[this->skeleton->GetRootNode()->GetName()]] = rootM;
+  frame[rootHandle] = rootM;
 
-  this->SetPose(frame, skelMap, currentTime.Double());
+  this->SetPose(frame, compiled.nodes, currentTime.Double());
 }
 
 //////////////////////////////////////////////////
-void Actor::SetPose(std::map<std::string, ignition::math::Matrix4d> _frame,
-    std::map<std::string, std::string> _skelMap, const double _time)
+void Actor::SetPose(const std::vector<ignition::math::Matrix4d> &_frame,
+    const std::vector<std::string> &_nodes, const double _time)
 {
   msgs::PoseAnimation msg;
   msg.set_model_name(this->visualName);
@@ -861,20 +906,34 @@ void Actor::SetPose(std::map<std::string, ignition::math::Matrix4d> _frame,
     mainLinkPose.Rot() = this->worldPose.Rot();
   }
 
-  for (unsigned int i = 0; i < this->skeleton->GetNumNodes(); ++i)
+  // Look the links of the bones up once
+  const unsigned int nodeCount = this->skeleton->GetNumNodes();
+  std::vector<LinkPtr> &boneLinks = this->dataPtr->boneLinks;
+  if (boneLinks.size() != nodeCount)
+  {
+    boneLinks.resize(nodeCount);
+    for (unsigned int i = 0; i < nodeCount; ++i)
+    {
+      boneLinks[i] = this->GetChildLink(
+          this->skeleton->GetNodeByHandle(i)->GetName());
+    }
+  }
+
+  SkeletonNode *rootBone = this->skeleton->GetRootNode();
+  for (unsigned int i = 0; i < nodeCount; ++i)
   {
     SkeletonNode *bone = this->skeleton->GetNodeByHandle(i);
     SkeletonNode *parentBone = bone->GetParent();
     ignition::math::Matrix4d transform(ignition::math::Matrix4d::Identity);
 
-    if (_frame.find(_skelMap[bone->GetName()]) != _frame.end())
+    if (bone == rootBone || !_nodes[i].empty())
     {
       if (this->dataPtr->bvhFile)
       {
-        std::string tempStr(_skelMap[bone->GetName()]);
-        transform = _frame[tempStr];
+        const std::string &tempStr = _nodes[i];
+        transform = _frame[i];
 
-        if (bone->GetName() != this->skeleton->GetRootNode()->GetName())
+        if (bone != rootBone)
         {
           ignition::math::Vector3d bvhOffset = transform.Translation();
           ignition::math::Vector3d daeOffset = bone->Transform().Translation();
@@ -887,7 +946,7 @@ void Actor::SetPose(std::map<std::string, ignition::math::Matrix4d> _frame,
       }
       else
       {
-        transform = _frame[_skelMap[bone->GetName()]];
+        transform = _frame[i];
       }
     }
     else
@@ -895,7 +954,7 @@ void Actor::SetPose(std::map<std::string, ignition::math::Matrix4d> _frame,
       transform = bone->Transform();
     }
 
-    LinkPtr currentLink = this->GetChildLink(bone->GetName());
+    LinkPtr currentLink = boneLinks[i];
     ignition::math::Pose3d bonePose = transform.Pose();
     if (!bonePose.IsFinite())
     {
@@ -920,7 +979,7 @@ void Actor::SetPose(std::map<std::string, ignition::math::Matrix4d> _frame,
     {
       bone_pose->mutable_position()->CopyFrom(msgs::Convert(bonePose.Pos()));
       bone_pose->mutable_orientation()->CopyFrom(msgs::Convert(bonePose.Rot()));
-      LinkPtr parentLink = this->GetChildLink(parentBone->GetName());
+      LinkPtr parentLink = boneLinks[parentBone->GetHandle()];
       auto parentPose = parentLink->WorldPose();
       ignition::math::Matrix4d parentTrans(parentPose);
       transform = parentTrans * transform;
@@ -279,12 +279,14 @@ namespace gazebo
 
       /// \brief Set the actor's pose. This sets the pose for each bone in the
       /// skeleton and also the actor's pose in the world.
-      /// \param[in] _frame Each frame name and transform.
-      /// \param[in] _skelMap Map of bone relationships.
+      /// \param[in] _frame Transform of each bone, by handle.
+      /// \param[in] _nodes Animation node of each bone, by handle. It's
+      /// empty for the bones which aren't animated, and keep their skin
+      /// transform. The root bone is always animated.
       /// \param[in] _time Time over which to animate the set pose.
       private: void SetPose(
-                   std::map<std::string, ignition::math::Matrix4d> _frame,
-                   std::map<std::string, std::string> _skelMap,
+                   const std::vector<ignition::math::Matrix4d> &_frame,
+                   const std::vector<std::string> &_nodes,
                    const double _time);
 
       /// \brief Pointer to the actor's mesh.
@@ -14,6 +14,9 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <cmath>
+#include <mutex>
 #include <sdf/sdf.hh>
 
 #include "gazebo/physics/AdiabaticAtmosphere.hh"
@@ -35,6 +38,33 @@ namespace gazebo
       /// pressure and density of air.
       /// See https://en.wikipedia.org/wiki/Density_of_air#Altitude
       public: double adiabaticPower;
+
+      /// \brief Pressure and density at an altitude of the lookup table.
+      public: struct Sample
+      {
+        /// \brief Pressure in pascals.
+        double pressure;
+
+        /// \brief Density in kg/m^3.
+        double density;
+      };
+
+      /// \brief Samples of the lookup table, every tableResolution meters
+      /// from tableMin. Empty if there's no table.
+      public: std::vector<Sample> samples;
+
+      /// \brief Altitude of the first sample in meters.
+      public: double tableMin = 0.0;
+
+      /// \brief Altitude of the last sample in meters.
+      public: double tableMax = 0.0;
+
+      /// \brief Distance between two samples in meters.
+      public: double tableResolution = 0.0;
+
+      /// \brief Protects the samples, which are computed again when a
+      /// message changes the sea level values.
+      public: mutable std::mutex tableMutex;
     };
   }
 }
@@ -42,6 +72,37 @@ namespace gazebo
 using namespace gazebo;
 using namespace physics;
 
+/// \brief Largest number of samples in a lookup table.
+static const size_t kMaxLookupSamples = 1000000;
+
+/// \brief Interpolate the pressure and density in the lookup table. The
+/// table mutex must be locked.
+/// \param[in] _data Private data of the atmosphere.
+/// \param[in] _altitude Altitude above sea level in meters.
+/// \param[out] _pressure Pressure in pascals.
+/// \param[out] _density Density in kg/m^3.
+/// \return False if the table doesn't cover the altitude.
+static bool Interpolate(const AdiabaticAtmospherePrivate &_data,
+    const double _altitude, double &_pressure, double &_density)
+{
+  const auto &samples = _data.samples;
+  if (samples.size() < 2)
+    return false;
+
+  // Also false for NaN
+  const double t = (_altitude - _data.tableMin) / _data.tableResolution;
+  if (!(t >= 0.0 && t <= samples.size() - 1))
+    return false;
+
+  const size_t i = std::min(static_cast<size_t>(t), samples.size() - 2);
+  const double f = t - i;
+  _pressure = samples[i].pressure +
+      f * (samples[i + 1].pressure - samples[i].pressure);
+  _density = samples[i].density +
+      f * (samples[i + 1].density - samples[i].density);
+  return true;
+}
+
 GZ_REGISTER_ATMOSPHERE_MODEL("adiabatic", AdiabaticAtmosphere)
 
 //////////////////////////////////////////////////
@@ -61,6 +122,28 @@ void AdiabaticAtmosphere::Load(sdf::ElementPtr _sdf)
 {
   Atmosphere::Load(_sdf);
   this->ComputeAdiabaticPower();
+
+  sdf::ElementPtr sdf = this->SDF();
+  if (sdf->HasElement("gz:lookup_table"))
+  {
+    sdf::ElementPtr tableElem = sdf->GetElement("gz:lookup_table");
+    const double minAltitude = tableElem->HasElement("min_altitude") ?
+        tableElem->Get<double>("min_altitude") : 0.0;
+    const double maxAltitude = tableElem->HasElement("max_altitude") ?
+        tableElem->Get<double>("max_altitude") : 11000.0;
+    const double resolution = tableElem->HasElement("resolution") ?
+        tableElem->Get<double>("resolution") : 10.0;
+    if (!this->SetLookupTable(minAltitude, maxAltitude, resolution))
+    {
+      gzerr << "Invalid <gz:lookup_table> from [" << minAltitude << "] to ["
+            << maxAltitude << "] every [" << resolution << "] m, the "
+            << "atmosphere model is evaluated for every query" << std::endl;
+    }
+  }
+  else
+  {
+    this->ComputeLookupTable();
+  }
 }
 
 //////////////////////////////////////////////////
@@ -102,11 +185,26 @@ void AdiabaticAtmosphere::OnAtmosphereMsg(ConstAtmospherePtr &_msg)
   Atmosphere::OnAtmosphereMsg(_msg);
 }
 
+//////////////////////////////////////////////////
+void AdiabaticAtmosphere::SetTemperature(const double _t)
+{
+  Atmosphere::SetTemperature(_t);
+  this->ComputeLookupTable();
+}
+
+//////////////////////////////////////////////////
+void AdiabaticAtmosphere::SetPressure(const double _pressure)
+{
+  Atmosphere::SetPressure(_pressure);
+  this->ComputeLookupTable();
+}
+
 //////////////////////////////////////////////////
 void AdiabaticAtmosphere::SetTemperatureGradient(const double _gradient)
 {
   Atmosphere::SetTemperatureGradient(_gradient);
   this->ComputeAdiabaticPower();
+  this->ComputeLookupTable();
 }
 
 //////////////////////////////////////////////////
@@ -120,6 +218,13 @@ double AdiabaticAtmosphere::Temperature(const double _altitude) const
 //////////////////////////////////////////////////
 double AdiabaticAtmosphere::Pressure(const double _altitude) const
 {
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->tableMutex);
+    double pressure, density;
+    if (Interpolate(*this->dataPtr, _altitude, pressure, density))
+      return pressure;
+  }
+
   if (!ignition::math::equal(Atmosphere::Temperature(), 0.0, 1e-6))
   {
     // See https://en.wikipedia.org/wiki/Density_of_air#Altitude
@@ -138,6 +243,13 @@ double AdiabaticAtmosphere::Pressure(const double _altitude) const
 //////////////////////////////////////////////////
 double AdiabaticAtmosphere::MassDensity(const double _altitude) const
 {
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->tableMutex);
+    double pressure, density;
+    if (Interpolate(*this->dataPtr, _altitude, pressure, density))
+      return density;
+  }
+
   if (!ignition::math::equal(Atmosphere::Temperature(), 0.0, 1e-6))
   {
     // See https://en.wikipedia.org/wiki/Density_of_air#Altitude
@@ -162,3 +274,116 @@ void AdiabaticAtmosphere::ComputeAdiabaticPower()
       this->World().Gravity().Length() /
       (-Atmosphere::TemperatureGradient() * Atmosphere::IDEAL_GAS_CONSTANT_R);
 }
+
+//////////////////////////////////////////////////
+void AdiabaticAtmosphere::Properties(const std::vector<double> &_altitudes,
+    std::vector<double> &_temperatures, std::vector<double> &_pressures,
+    std::vector<double> &_densities) const
+{
+  _temperatures.resize(_altitudes.size());
+  _pressures.resize(_altitudes.size());
+  _densities.resize(_altitudes.size());
+
+  const double temperature = Atmosphere::Temperature();
+  const double gradient = Atmosphere::TemperatureGradient();
+  const bool valid = !ignition::math::equal(temperature, 0.0, 1e-6);
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->tableMutex);
+  for (size_t i = 0; i < _altitudes.size(); ++i)
+  {
+    _temperatures[i] = temperature + gradient * _altitudes[i];
+    if (Interpolate(*this->dataPtr, _altitudes[i], _pressures[i],
+          _densities[i]))
+    {
+      continue;
+    }
+
+    if (valid)
+    {
+      // The density ratio is the pressure ratio divided by the base, so
+      // a single pow is needed for both.
+      const double base = 1 + (gradient * _altitudes[i]) / temperature;
+      const double ratio = pow(base, this->dataPtr->adiabaticPower - 1);
+      _pressures[i] = Atmosphere::Pressure() * ratio * base;
+      _densities[i] = Atmosphere::MassDensity() * ratio;
+    }
+    else
+    {
+      _pressures[i] = 0;
+      _densities[i] = 0;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+bool AdiabaticAtmosphere::SetLookupTable(const double _minAltitude,
+    const double _maxAltitude, const double _resolution)
+{
+  if (!(_maxAltitude > _minAltitude) || !(_resolution > 0.0) ||
+      !std::isfinite(_minAltitude) || !std::isfinite(_maxAltitude) ||
+      (_maxAltitude - _minAltitude) / _resolution >= kMaxLookupSamples)
+  {
+    return false;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->tableMutex);
+    this->dataPtr->tableMin = _minAltitude;
+    this->dataPtr->tableMax = _maxAltitude;
+    this->dataPtr->tableResolution = _resolution;
+  }
+  this->ComputeLookupTable();
+  return true;
+}
+
+//////////////////////////////////////////////////
+void AdiabaticAtmosphere::ClearLookupTable()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->tableMutex);
+  this->dataPtr->samples.clear();
+  this->dataPtr->tableResolution = 0.0;
+}
+
+//////////////////////////////////////////////////
+bool AdiabaticAtmosphere::HasLookupTable() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->tableMutex);
+  return !this->dataPtr->samples.empty();
+}
+
+//////////////////////////////////////////////////
+void AdiabaticAtmosphere::ComputeLookupTable()
+{
+  double minAltitude, maxAltitude, resolution;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->tableMutex);
+    if (this->dataPtr->tableResolution <= 0.0)
+      return;
+    minAltitude = this->dataPtr->tableMin;
+    maxAltitude = this->dataPtr->tableMax;
+    resolution = this->dataPtr->tableResolution;
+
+    // The model is evaluated, not the previous table
+    this->dataPtr->samples.clear();
+  }
+
+  // The last sample is at or above the highest altitude
+  const size_t count = static_cast<size_t>(
+      std::ceil((maxAltitude - minAltitude) / resolution)) + 1;
+  std::vector<AdiabaticAtmospherePrivate::Sample> samples(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    const double altitude = minAltitude + i * resolution;
+    samples[i].pressure = this->Pressure(altitude);
+    samples[i].density = this->MassDensity(altitude);
+  }
+
+  // Unless the table was cleared or changed in the meantime
+  std::lock_guard<std::mutex> lock(this->dataPtr->tableMutex);
+  if (ignition::math::equal(this->dataPtr->tableResolution, resolution) &&
+      ignition::math::equal(this->dataPtr->tableMin, minAltitude) &&
+      ignition::math::equal(this->dataPtr->tableMax, maxAltitude))
+  {
+    this->dataPtr->samples.swap(samples);
+  }
+}
@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "gazebo/physics/Atmosphere.hh"
 
@@ -43,6 +44,16 @@ namespace gazebo
     /// constant gradients of gravity and temperature
     /// with respect to altitude.
     /// The troposphere model is recommended for altitudes below 11 km.
+    ///
+    /// The pressure and density can be tabulated over a range of
+    /// altitudes with the <gz:lookup_table> element of the atmosphere:
+    /// \verbatim
+    /// <gz:lookup_table>
+    ///   <min_altitude>0</min_altitude>
+    ///   <max_altitude>11000</max_altitude>
+    ///   <resolution>10</resolution>
+    /// </gz:lookup_table>
+    /// \endverbatim
     class GZ_PHYSICS_VISIBLE AdiabaticAtmosphere : public Atmosphere
     {
       /// \brief Constructor.
@@ -64,6 +75,12 @@ namespace gazebo
       // Documentation inherited
       protected: virtual void OnAtmosphereMsg(ConstAtmospherePtr &_msg);
 
+      // Documentation inherited
+      public: virtual void SetTemperature(const double _t);
+
+      // Documentation inherited
+      public: virtual void SetPressure(const double _pressure);
+
       // Documentation inherited
       public: virtual void SetTemperatureGradient(const double _gradient);
 
@@ -76,9 +93,38 @@ namespace gazebo
       // Documentation inherited
       public: double MassDensity(const double _altitude = 0.0) const;
 
+      // Documentation inherited
+      public: virtual void Properties(const std::vector<double> &_altitudes,
+                  std::vector<double> &_temperatures,
+                  std::vector<double> &_pressures,
+                  std::vector<double> &_densities) const;
+
+      /// \brief Sample the pressure and density at regular altitudes, so
+      /// that the queries in this range interpolate the samples instead
+      /// of evaluating the model. The samples are computed again when the
+      /// sea level values or the temperature gradient change.
+      /// \param[in] _minAltitude Lowest altitude of the table in meters.
+      /// \param[in] _maxAltitude Highest altitude of the table in meters.
+      /// \param[in] _resolution Distance between two samples in meters.
+      /// \return False if the range is empty, the resolution isn't
+      /// positive or the table would be too large, in which case the table
+      /// is left unchanged.
+      public: bool SetLookupTable(const double _minAltitude,
+                  const double _maxAltitude, const double _resolution);
+
+      /// \brief Evaluate the model for every query again.
+      public: void ClearLookupTable();
+
+      /// \brief Get whether the queries interpolate a lookup table.
+      /// \return True if a lookup table is set.
+      public: bool HasLookupTable() const;
+
       // \brief Compute the adiabatic power used internally.
       private: void ComputeAdiabaticPower();
 
+      /// \brief Sample the model again over the range of the lookup table.
+      private: void ComputeLookupTable();
+
       /// \internal
       /// \brief Private data pointer.
       protected: std::unique_ptr<AdiabaticAtmospherePrivate> dataPtr;
@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "gazebo/msgs/msgs.hh"
 
@@ -95,6 +96,20 @@ namespace gazebo
       /// \return Density in kg/m^3 at the specified altitude.
       public: virtual double MassDensity(const double _altitude = 0.0) const;
 
+      /// \brief Get the temperature, pressure and density at many
+      /// altitudes at once, e.g. at the links of a model.
+      /// \param[in] _altitudes Altitudes above sea level in meters.
+      /// \param[out] _temperatures Temperatures in kelvins, resized to the
+      /// number of altitudes.
+      /// \param[out] _pressures Pressures in pascals, resized to the
+      /// number of altitudes.
+      /// \param[out] _densities Densities in kg/m^3, resized to the number
+      /// of altitudes.
+      public: virtual void Properties(const std::vector<double> &_altitudes,
+                  std::vector<double> &_temperatures,
+                  std::vector<double> &_pressures,
+                  std::vector<double> &_densities) const;
+
       /// \brief Set the temperature gradient dT/dZ with respect to increasing
       /// altitude around sea level.
       /// \param[in] _gradient Value of the temperature gradient dT/dZ around
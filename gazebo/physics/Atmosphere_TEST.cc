@@ -15,6 +15,9 @@
  *
 */
 
+#include <vector>
+
+#include "gazebo/physics/AdiabaticAtmosphere.hh"
 #include "gazebo/test/ServerFixture.hh"
 #include "gazebo/msgs/msgs.hh"
 
@@ -35,6 +38,10 @@ class AtmosphereTest : public ServerFixture,
   /// \param[in] _atmosphere Name of the atmosphere model.
   public: void AtmosphereParamBool(const std::string &_atmosphere);
 
+  /// \brief Test the lookup table and the batched queries.
+  /// \param[in] _atmosphere Name of the atmosphere model.
+  public: void AtmosphereLookupTable(const std::string &_atmosphere);
+
   /// \brief Incoming atmosphere message.
   public: static msgs::Atmosphere atmospherePubMsg;
 
@@ -167,6 +174,82 @@ TEST_P(AtmosphereTest, AtmosphereParamBool)
   AtmosphereParamBool(this->GetParam());
 }
 
+/////////////////////////////////////////////////
+void AtmosphereTest::AtmosphereLookupTable(const std::string &_atmosphere)
+{
+  Load("worlds/empty.world", false);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  ASSERT_EQ(_atmosphere, "adiabatic");
+  physics::AdiabaticAtmosphere *atmosphere =
+      dynamic_cast<physics::AdiabaticAtmosphere *>(&world->Atmosphere());
+  ASSERT_TRUE(atmosphere != nullptr);
+
+  const std::vector<double> altitudes = {-200, 0, 1000, 2345.6, 10999, 15000};
+  std::vector<double> pressures, densities;
+  for (const double altitude : altitudes)
+  {
+    pressures.push_back(atmosphere->Pressure(altitude));
+    densities.push_back(atmosphere->MassDensity(altitude));
+  }
+
+  // Batched queries evaluate the same model
+  std::vector<double> temperatures, batchPressures, batchDensities;
+  atmosphere->Properties(altitudes, temperatures, batchPressures,
+      batchDensities);
+  ASSERT_EQ(temperatures.size(), altitudes.size());
+  ASSERT_EQ(batchPressures.size(), altitudes.size());
+  ASSERT_EQ(batchDensities.size(), altitudes.size());
+  for (size_t i = 0; i < altitudes.size(); ++i)
+  {
+    EXPECT_NEAR(temperatures[i], atmosphere->Temperature(altitudes[i]),
+        1e-9);
+    EXPECT_NEAR(batchPressures[i], pressures[i], 1e-6);
+    EXPECT_NEAR(batchDensities[i], densities[i], 1e-9);
+  }
+
+  // Invalid tables
+  EXPECT_FALSE(atmosphere->HasLookupTable());
+  EXPECT_FALSE(atmosphere->SetLookupTable(100, 0, 10));
+  EXPECT_FALSE(atmosphere->SetLookupTable(0, 100, 0));
+  EXPECT_FALSE(atmosphere->SetLookupTable(0, 1e9, 1e-3));
+  EXPECT_FALSE(atmosphere->HasLookupTable());
+
+  // Interpolated values are close to the model, and the altitudes
+  // outside of the table still evaluate it
+  ASSERT_TRUE(atmosphere->SetLookupTable(0, 11000, 10));
+  EXPECT_TRUE(atmosphere->HasLookupTable());
+  atmosphere->Properties(altitudes, temperatures, batchPressures,
+      batchDensities);
+  for (size_t i = 0; i < altitudes.size(); ++i)
+  {
+    EXPECT_NEAR(atmosphere->Pressure(altitudes[i]), pressures[i], 0.05);
+    EXPECT_NEAR(atmosphere->MassDensity(altitudes[i]), densities[i], 1e-6);
+    EXPECT_NEAR(batchPressures[i], pressures[i], 0.05);
+    EXPECT_NEAR(batchDensities[i], densities[i], 1e-6);
+  }
+  EXPECT_DOUBLE_EQ(atmosphere->Pressure(0), pressures[1]);
+  EXPECT_DOUBLE_EQ(atmosphere->Pressure(-200), pressures[0]);
+
+  // The table follows the sea level values
+  atmosphere->SetPressure(90000);
+  EXPECT_NEAR(atmosphere->Pressure(0), 90000, 1e-6);
+  EXPECT_NEAR(atmosphere->Pressure(1000),
+      pressures[2] * 90000 / 101325, 1e-2);
+
+  atmosphere->ClearLookupTable();
+  EXPECT_FALSE(atmosphere->HasLookupTable());
+  EXPECT_NEAR(atmosphere->Pressure(1000),
+      pressures[2] * 90000 / 101325, 1e-6);
+}
+
+/////////////////////////////////////////////////
+TEST_P(AtmosphereTest, AtmosphereLookupTable)
+{
+  AtmosphereLookupTable(this->GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(Atmospheres, AtmosphereTest,
                         ::testing::Values("adiabatic"),);  // NOLINT
 
@@ -73,6 +73,9 @@ void Base::Load(sdf::ElementPtr _sdf)
 
   this->ComputeScopedName();
 
+  if (this->world)
+    this->world->_AddToNameIndex(shared_from_this());
+
   this->RegisterIntrospectionItems();
 }
 
@@ -89,6 +92,9 @@ void Base::Fini()
 {
   this->UnregisterIntrospectionItems();
 
+  if (this->world)
+    this->world->_RemoveFromNameIndex(this);
+
   // Remove self as a child of the parent
   if (this->parent)
   {
@@ -137,6 +143,9 @@ void Base::SetName(const std::string &_name)
   this->sdf->GetAttribute("name")->Set(_name);
   this->name = _name;
   this->ComputeScopedName();
+
+  if (this->world)
+    this->world->_UpdateNameIndex(this);
 }
 
 //////////////////////////////////////////////////
@@ -14,12 +14,14 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
 #include <boost/algorithm/string.hpp>
 
 #include "gazebo/transport/Node.hh"
 #include "gazebo/transport/Publisher.hh"
 #include "gazebo/transport/TransportIface.hh"
 
+#include "gazebo/common/MemoryTracker.hh"
 #include "gazebo/common/Time.hh"
 
 #include "gazebo/physics/World.hh"
@@ -30,10 +32,14 @@
 using namespace gazebo;
 using namespace physics;
 
+/// \brief Number of contacts allocated together in one pool slab.
+static const unsigned int kContactSlabSize = 16;
+
 /////////////////////////////////////////////////
 ContactManager::ContactManager()
 {
   this->contactIndex = 0;
+  this->pendingCollisionNames = false;
   this->customMutex = new boost::recursive_mutex();
   this->neverDropContacts = false;
 }
@@ -62,6 +68,10 @@ ContactManager::~ContactManager()
     }
   }
   this->customContactPublishers.clear();
+  for (auto &callback : this->contactCallbacks)
+    delete callback.second;
+  this->contactCallbacks.clear();
+  this->collisionPublishers.clear();
   delete this->customMutex;
   this->customMutex = NULL;
 
@@ -99,90 +109,111 @@ bool ContactManager::SubscribersConnected(Collision *_collision1,
   if (this->contactPub->HasConnections()) return true;
 
   boost::recursive_mutex::scoped_lock lock(*this->customMutex);
+
+  if ((_collision1 && this->collisionPublishers.count(_collision1->GetId())) ||
+      (_collision2 && this->collisionPublishers.count(_collision2->GetId())))
+  {
+    return true;
+  }
+
+  if (!this->pendingCollisionNames)
+    return false;
+
+  // A model can simply be loaded later, so check the collisionNames as well.
   boost::unordered_map<std::string, ContactPublisher *>::const_iterator iter;
   for (iter = this->customContactPublishers.begin();
        iter != this->customContactPublishers.end(); ++iter)
   {
-    // A model can simply be loaded later, so check the collisionNames as well.
-    if (!iter->second->collisionNames.empty())
-    {
-      std::vector<std::string>::const_iterator it;
-      for (it = iter->second->collisionNames.begin();
-           it != iter->second->collisionNames.end(); ++it)
-      {
-        BasePtr b = this->world->BaseByName(*it);
-        if (b)
-        {
-          return true;
-        }
-        // We could do the same transformation which is done in
-        // GetCustomPublishers() here (insert collisions which now have been
-        // loaded), but this would remove the const qualifier of this function.
-        // It would however speed up repeated calls of this function without
-        // a call of NewContact() or GetCustomPublishers() in between.
-      }
-    }
-
-    // only reason _collision1 or _collision1 cannot be const parameters
-    // is that compiler can't find const pointers in unordered set
-    if (iter->second->collisions.find(_collision1) !=
-        iter->second->collisions.end() ||
-        iter->second->collisions.find(_collision2) !=
-        iter->second->collisions.end())
+    for (auto const &name : iter->second->collisionNames)
     {
-      return true;
+      if (this->world->BaseByName(name))
+        return true;
     }
   }
   return false;
 }
 
 /////////////////////////////////////////////////
-void ContactManager::GetCustomPublishers(Collision *_collision1,
-                     Collision *_collision2, const bool _getOnlyConnected,
-                     std::vector<ContactPublisher*> &_publishers)
+void ContactManager::ResolveCollisionNames()
 {
   boost::recursive_mutex::scoped_lock lock(*this->customMutex);
+  if (!this->pendingCollisionNames)
+    return;
+
+  bool resolved = false;
+  bool pending = false;
   boost::unordered_map<std::string, ContactPublisher *>::iterator iter;
   for (iter = this->customContactPublishers.begin();
        iter != this->customContactPublishers.end(); ++iter)
   {
-    // A model can simply be loaded later, so convert ones that are not yet
-    // found
-    if (!iter->second->collisionNames.empty())
+    std::vector<std::string>::iterator it;
+    for (it = iter->second->collisionNames.begin();
+        it != iter->second->collisionNames.end();)
     {
-      std::vector<std::string>::iterator it;
-      for (it = iter->second->collisionNames.begin();
-          it != iter->second->collisionNames.end();)
+      Collision *col = boost::dynamic_pointer_cast<Collision>(
+          this->world->BaseByName(*it)).get();
+      if (!col)
       {
-        Collision *col = boost::dynamic_pointer_cast<Collision>(
-            this->world->BaseByName(*it)).get();
-        if (!col)
-        {
-          ++it;
-          continue;
-        }
-        it = iter->second->collisionNames.erase(it);
-        iter->second->collisions.insert(col);
+        ++it;
+        continue;
       }
+      it = iter->second->collisionNames.erase(it);
+      if (iter->second->collisions.insert(col).second)
+        iter->second->collisionIds.push_back(col->GetId());
+      resolved = true;
     }
+    pending = pending || !iter->second->collisionNames.empty();
+  }
 
-    // only reason _collision1 or _collision1 cannot be const parameters
-    // is that compiler can't find const pointers in unordered set
-    if (iter->second->collisions.find(_collision1) !=
-        iter->second->collisions.end() ||
-        iter->second->collisions.find(_collision2) !=
-        iter->second->collisions.end())
-    {
-      GZ_ASSERT(iter->second->publisher != NULL,
-                "ContactPublisher must have a valid publisher");
-      if (!_getOnlyConnected || iter->second->publisher->HasConnections())
-      {
-        _publishers.push_back(iter->second);
-      }
-    }
+  this->pendingCollisionNames = pending;
+  if (resolved)
+    this->RebuildCollisionIndex();
+}
+
+/////////////////////////////////////////////////
+void ContactManager::RebuildCollisionIndex()
+{
+  this->collisionPublishers.clear();
+  this->pendingCollisionNames = false;
+
+  boost::unordered_map<std::string, ContactPublisher *>::iterator iter;
+  for (iter = this->customContactPublishers.begin();
+       iter != this->customContactPublishers.end(); ++iter)
+  {
+    GZ_ASSERT(iter->second->publisher != NULL,
+              "ContactPublisher must have a valid publisher");
+    for (auto const &id : iter->second->collisionIds)
+      this->collisionPublishers[id].push_back(iter->second);
+
+    this->pendingCollisionNames = this->pendingCollisionNames ||
+        !iter->second->collisionNames.empty();
+  }
+
+  for (auto const &callback : this->contactCallbacks)
+  {
+    for (auto const &id : callback.second->collisionIds)
+      this->collisionPublishers[id].push_back(callback.second);
   }
 }
 
+/////////////////////////////////////////////////
+Contact *ContactManager::AllocateContact()
+{
+  if (this->contactIndex >= this->contacts.size())
+  {
+    // Grow the pool by a whole slab so that steady state stepping never
+    // allocates; contacts are reused after every ResetCount().
+    this->contactSlabs.emplace_back(new Contact[kContactSlabSize]);
+    common::MemoryTracker::Instance()->Add("contacts",
+        kContactSlabSize * sizeof(Contact));
+    Contact *slab = this->contactSlabs.back().get();
+    for (unsigned int i = 0; i < kContactSlabSize; ++i)
+      this->contacts.push_back(slab + i);
+  }
+
+  return this->contacts[this->contactIndex++];
+}
+
 /////////////////////////////////////////////////
 Contact *ContactManager::NewContact(Collision *_collision1,
                                     Collision *_collision2,
@@ -198,30 +229,44 @@ Contact *ContactManager::NewContact(Collision *_collision1,
   // This is a signal to the Physics engine that it can skip the extra
   // processing necessary to get back contact information.
 
-  std::vector<ContactPublisher *> publishers;
-  bool getOnlyConnected = false;
-  // TODO check: getOnlyConnected set to false to keep same behaviour as before.
-  // But should we not only add publishers which are connected, as is done
-  // for this->contactPub->HasConnections() condition?
-  this->GetCustomPublishers(_collision1, _collision2,
-                            getOnlyConnected, publishers);
+  boost::recursive_mutex::scoped_lock lock(*this->customMutex);
+
+  const std::vector<ContactPublisher *> *publishers1 = nullptr;
+  const std::vector<ContactPublisher *> *publishers2 = nullptr;
+  if (!this->collisionPublishers.empty())
+  {
+    auto iter = this->collisionPublishers.find(_collision1->GetId());
+    if (iter != this->collisionPublishers.end())
+      publishers1 = &iter->second;
+
+    iter = this->collisionPublishers.find(_collision2->GetId());
+    if (iter != this->collisionPublishers.end())
+      publishers2 = &iter->second;
+  }
 
   if (this->NeverDropContacts() ||
       this->contactPub->HasConnections() ||
-      !publishers.empty())
+      publishers1 || publishers2)
   {
-    // Get or create a contact feedback object.
-    if (this->contactIndex < this->contacts.size())
-      result = this->contacts[this->contactIndex++];
-    else
+    result = this->AllocateContact();
+
+    if (publishers1)
     {
-      result = new Contact();
-      this->contacts.push_back(result);
-      this->contactIndex = this->contacts.size();
+      for (auto const &pub : *publishers1)
+        pub->contacts.push_back(result);
     }
-    for (unsigned int i = 0; i < publishers.size(); ++i)
+    if (publishers2)
     {
-      publishers[i]->contacts.push_back(result);
+      for (auto const &pub : *publishers2)
+      {
+        // Don't add the contact twice when a filter monitors both
+        // collisions.
+        if (!publishers1 || std::find(publishers1->begin(),
+              publishers1->end(), pub) == publishers1->end())
+        {
+          pub->contacts.push_back(result);
+        }
+      }
     }
   }
 
@@ -262,21 +307,27 @@ const std::vector<Contact*> &ContactManager::GetContacts() const
 void ContactManager::ResetCount()
 {
   this->contactIndex = 0;
+
+  // Collisions of filters may be loaded after the filter was created.
+  this->ResolveCollisionNames();
 }
 
 /////////////////////////////////////////////////
 void ContactManager::Clear()
 {
   // Delete all the contacts.
-  for (unsigned int i = 0; i < this->contacts.size(); ++i)
-    delete this->contacts[i];
-
+  common::MemoryTracker::Instance()->Add("contacts",
+      -static_cast<int64_t>(this->contactSlabs.size() * kContactSlabSize *
+      sizeof(Contact)));
   this->contacts.clear();
+  this->contactSlabs.clear();
 
   boost::unordered_map<std::string, ContactPublisher *>::iterator iter;
   for (iter = this->customContactPublishers.begin();
       iter != this->customContactPublishers.end(); ++iter)
     iter->second->contacts.clear();
+  for (auto &callback : this->contactCallbacks)
+    callback.second->contacts.clear();
 
   // Reset the contact count to zero.
   this->contactIndex = 0;
@@ -296,20 +347,21 @@ void ContactManager::PublishContacts()
   }
 
   // publish to default topic, ~/physics/contacts
-  if (!transport::getMinimalComms())
+  if (!transport::getMinimalComms() && this->contactPub->HasConnections())
   {
-    msgs::Contacts msg;
+    // Built every step, so its many small fields come from the arena
+    msgs::ArenaMsg<msgs::Contacts> msg;
     for (unsigned int i = 0; i < this->contactIndex; ++i)
     {
       if (this->contacts[i]->count == 0)
         continue;
 
-      msgs::Contact *contactMsg = msg.add_contact();
+      msgs::Contact *contactMsg = msg->add_contact();
       this->contacts[i]->FillMsg(*contactMsg);
     }
 
-    msgs::Set(msg.mutable_time(), this->world->SimTime());
-    this->contactPub->Publish(msg);
+    msgs::Set(msg->mutable_time(), this->world->SimTime());
+    this->contactPub->Publish(*msg);
   }
 
   // publish to other custom topics
@@ -319,18 +371,39 @@ void ContactManager::PublishContacts()
       iter != this->customContactPublishers.end(); ++iter)
   {
     ContactPublisher *contactPublisher = iter->second;
-    msgs::Contacts msg2;
-    for (unsigned int j = 0;
-        j < contactPublisher->contacts.size(); ++j)
+
+    // In-process consumers get the contacts directly.
+    if (contactPublisher->localCallback)
+      contactPublisher->localCallback(contactPublisher->contacts);
+
+    // Only build a message if someone listens on the topic.
+    if (contactPublisher->publisher->HasConnections())
     {
-      if (contactPublisher->contacts[j]->count == 0)
-        continue;
+      msgs::ArenaMsg<msgs::Contacts> msg2;
+      for (unsigned int j = 0;
+          j < contactPublisher->contacts.size(); ++j)
+      {
+        if (contactPublisher->contacts[j]->count == 0)
+          continue;
 
-      msgs::Contact *contactMsg = msg2.add_contact();
-      contactPublisher->contacts[j]->FillMsg(*contactMsg);
+        msgs::Contact *contactMsg = msg2->add_contact();
+        contactPublisher->contacts[j]->FillMsg(*contactMsg);
+      }
+      msgs::Set(msg2->mutable_time(), this->world->SimTime());
+      contactPublisher->publisher->Publish(*msg2);
     }
-    msgs::Set(msg2.mutable_time(), this->world->SimTime());
-    contactPublisher->publisher->Publish(msg2);
+    contactPublisher->contacts.clear();
+  }
+
+  // Direct callbacks only hear about steps with contacts, and the step
+  // their contacts end.
+  for (auto &callback : this->contactCallbacks)
+  {
+    ContactPublisher *contactPublisher = callback.second;
+    bool hasContacts = !contactPublisher->contacts.empty();
+    if (hasContacts || contactPublisher->hadContacts)
+      contactPublisher->localCallback(contactPublisher->contacts);
+    contactPublisher->hadContacts = hasContacts;
     contactPublisher->contacts.clear();
   }
 }
@@ -368,13 +441,14 @@ std::string ContactManager::CreateFilter(const std::string &_name,
   for (iter = _collisions.begin(); iter != _collisions.end(); ++iter)
   {
     Collision *col = iter->second.get();
-    if (col)
-      contactPublisher->collisions.insert(col);
+    if (col && contactPublisher->collisions.insert(col).second)
+      contactPublisher->collisionIds.push_back(col->GetId());
   }
 
   {
     boost::recursive_mutex::scoped_lock lock(*this->customMutex);
     this->customContactPublishers[name] = contactPublisher;
+    this->RebuildCollisionIndex();
   }
 
   return topic;
@@ -419,6 +493,8 @@ std::string ContactManager::CreateFilter(const std::string &_name,
 
     // Let it know about collisions not yet found.
     this->customContactPublishers[name]->collisionNames = collisionNames;
+    if (!collisionNames.empty())
+      this->pendingCollisionNames = true;
   }
 
   return topic;
@@ -439,10 +515,71 @@ void ContactManager::RemoveFilter(const std::string &_name)
     contactPublisher->contacts.clear();
     contactPublisher->collisionNames.clear();
     contactPublisher->collisions.clear();
+    contactPublisher->collisionIds.clear();
+    contactPublisher->localCallback = nullptr;
     contactPublisher->publisher->Fini();
     contactPublisher->publisher.reset();
     this->customContactPublishers.erase(iter);
+    this->RebuildCollisionIndex();
+  }
+}
+
+/////////////////////////////////////////////////
+unsigned int ContactManager::AddContactCallback(
+    const std::vector<CollisionPtr> &_collisions,
+    const std::function<void (const std::vector<Contact *> &)> &_callback)
+{
+  if (!_callback)
+  {
+    gzerr << "Unable to add an empty contact callback\n";
+    return 0;
   }
+
+  ContactPublisher *contactPublisher = new ContactPublisher;
+  contactPublisher->localCallback = _callback;
+  for (auto const &collision : _collisions)
+  {
+    if (collision &&
+        contactPublisher->collisions.insert(collision.get()).second)
+    {
+      contactPublisher->collisionIds.push_back(collision->GetId());
+    }
+  }
+
+  boost::recursive_mutex::scoped_lock lock(*this->customMutex);
+  unsigned int id = this->nextContactCallback++;
+  this->contactCallbacks[id] = contactPublisher;
+  this->RebuildCollisionIndex();
+  return id;
+}
+
+/////////////////////////////////////////////////
+void ContactManager::RemoveContactCallback(const unsigned int _id)
+{
+  boost::recursive_mutex::scoped_lock lock(*this->customMutex);
+  auto iter = this->contactCallbacks.find(_id);
+  if (iter == this->contactCallbacks.end())
+    return;
+
+  delete iter->second;
+  this->contactCallbacks.erase(iter);
+  this->RebuildCollisionIndex();
+}
+
+/////////////////////////////////////////////////
+bool ContactManager::SetFilterCallback(const std::string &_name,
+    const std::function<void (const std::vector<Contact *> &)> &_callback)
+{
+  std::string name = _name;
+  boost::replace_all(name, "::", "/");
+
+  boost::recursive_mutex::scoped_lock lock(*this->customMutex);
+  auto iter = this->customContactPublishers.find(name);
+  if (iter == this->customContactPublishers.end())
+    return false;
+
+  iter->second->localCallback = _callback;
+  return true;
 }
 
 /////////////////////////////////////////////////
@@ -20,7 +20,9 @@
 
 #include <vector>
 #include <string>
+#include <functional>
 #include <map>
+#include <memory>
 #include <ignition/transport/Node.hh>
 
 #include <boost/unordered/unordered_set.hpp>
@@ -48,6 +50,12 @@ namespace gazebo
       /// contacts.
       public: boost::unordered_set<Collision *> collisions;
 
+      /// \internal
+      /// \brief Ids of the collisions in the collisions set. Used to index
+      /// the publisher without dereferencing collisions that may have been
+      /// removed from the world.
+      public: std::vector<uint32_t> collisionIds;
+
       /// \internal
       /// \brief Names of collisions passed in by CreateFilter. Cleared
       /// once converted to pointers.
@@ -56,6 +64,17 @@ namespace gazebo
       /// \brief A list of contacts associated to the collisions.
       public: std::vector<Contact *> contacts;
 
+      /// \brief In-process callback that receives the raw contacts of
+      /// this filter, see ContactManager::SetFilterCallback.
+      public: std::function<void (const std::vector<Contact *> &)>
+              localCallback;
+
+      /// \internal
+      /// \brief True if the last contacts passed to localCallback were not
+      /// empty. Used by callbacks added with
+      /// ContactManager::AddContactCallback.
+      public: bool hadContacts = false;
+
       // Place ignition::transport objects at the end of this file to
       // guarantee they are destructed first.
 
@@ -195,6 +214,38 @@ namespace gazebo
       /// param[in] _name Filter name.
       public: void RemoveFilter(const std::string &_name);
 
+      /// \brief Set an in-process callback for a contacts filter. The
+      /// callback is called from PublishContacts() with the contacts of the
+      /// filter, avoiding the construction of a contacts message. The
+      /// contacts are only valid for the duration of the callback and may
+      /// contain contacts with a zero count. Messages are still published
+      /// to the filter topic when it has other subscribers.
+      /// \param[in] _name Filter name.
+      /// \param[in] _callback Callback function, or nullptr to remove the
+      /// current callback.
+      /// \return True if the filter exists.
+      public: bool SetFilterCallback(const std::string &_name,
+                  const std::function<void (const std::vector<Contact *> &)>
+                  &_callback);
+
+      /// \brief Call a function with the contacts of some collisions,
+      /// bypassing filter names and topics. The callback is called from
+      /// PublishContacts() right after the physics step, on the steps the
+      /// collisions have contacts and on the first step they have none.
+      /// The contacts are only valid for the duration of the callback and
+      /// may contain contacts with a zero count.
+      /// \param[in] _collisions Collisions to monitor.
+      /// \param[in] _callback Callback function.
+      /// \return Identifier of the callback, for RemoveContactCallback.
+      public: unsigned int AddContactCallback(
+                  const std::vector<CollisionPtr> &_collisions,
+                  const std::function<void (const std::vector<Contact *> &)>
+                  &_callback);
+
+      /// \brief Remove a callback added with AddContactCallback.
+      /// \param[in] _id Identifier returned by AddContactCallback.
+      public: void RemoveContactCallback(const unsigned int _id);
+
       /// \brief Get the number of filters in the contact manager.
       /// return Number of filters
       public: unsigned int GetFilterCount();
@@ -204,21 +255,41 @@ namespace gazebo
       /// return True if the filter exists.
       public: bool HasFilter(const std::string &_name);
 
-      /// \brief Helper function which gets the custom publishers which publish
-      ///   contacts of either \e _collision1 or \e _collision2.
-      /// \param[in] _collision1 the first collision object
-      /// \param[in] _collision2 the second collision object
-      /// \param[in] _getOnlyConnected return only publishers which currently
-      ///   have subscribers
-      /// \param[out] _publishers the resulting publishers.
-      private: void GetCustomPublishers(Collision *_collision1,
-                       Collision *_collision2, const bool _getOnlyConnected,
-                       std::vector<ContactPublisher*> &_publishers);
+      /// \brief Resolve collision names of filters that were not loaded
+      /// when the filter was created. This is done once per step from
+      /// ResetCount() rather than for every new contact.
+      private: void ResolveCollisionNames();
 
+      /// \brief Rebuild the map from collision id to the custom publishers
+      /// that monitor the collision. Must be called with customMutex held.
+      private: void RebuildCollisionIndex();
+
+      /// \brief Get the next free contact, growing the contact pool by a
+      /// slab when all pooled contacts are in use.
+      /// \return Pointer to a pooled contact.
+      private: Contact *AllocateContact();
+
+      /// \brief Pointers to all pooled contacts, in allocation order. The
+      /// contacts are owned by contactSlabs.
       private: std::vector<Contact*> contacts;
 
+      /// \brief Contiguous blocks of pooled contacts. Contacts are handed
+      /// out again after ResetCount() and only freed by Clear(). They
+      /// count against the "contacts" subsystem of the
+      /// common::MemoryTracker.
+      private: std::vector<std::unique_ptr<Contact[]>> contactSlabs;
+
       private: unsigned int contactIndex;
 
+      /// \brief Custom publishers indexed by the id of each collision they
+      /// monitor. Protected by customMutex.
+      private: boost::unordered_map<uint32_t,
+               std::vector<ContactPublisher *>> collisionPublishers;
+
+      /// \brief True if any custom publisher still has collision names
+      /// which could not be resolved. Protected by customMutex.
+      private: bool pendingCollisionNames;
+
       /// \brief Node for communication.
       private: transport::NodePtr node;
 
@@ -233,6 +304,15 @@ namespace gazebo
       private: boost::unordered_map<std::string, ContactPublisher *>
           customContactPublishers;
 
+      /// \brief Callbacks added with AddContactCallback, by identifier.
+      /// Their ContactPublisher has no publisher. Protected by
+      /// customMutex.
+      private: boost::unordered_map<unsigned int, ContactPublisher *>
+          contactCallbacks;
+
+      /// \brief Identifier of the next callback added.
+      private: unsigned int nextContactCallback = 1;
+
       /// \brief Mutex to protect the list of custom publishers.
       private: boost::recursive_mutex *customMutex;
 
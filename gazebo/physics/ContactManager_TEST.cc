@@ -194,6 +194,139 @@ TEST_F(ContactManagerTest, NeverDropContacts)
   }
 }
 
+/////////////////////////////////////////////////
+TEST_F(ContactManagerTest, FilterContactPool)
+{
+  Load("test/worlds/box.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+
+  physics::ContactManager *manager = physics->GetContactManager();
+  ASSERT_TRUE(manager != nullptr);
+
+  // A filter on a collision that doesn't exist yet keeps contacts dropped.
+  manager->CreateFilter("pending", "box2::link::collision");
+  world->Step(1);
+  EXPECT_EQ(manager->GetContactCount(), 0u);
+
+  // A filter on the box collision makes contacts available without
+  // subscribers.
+  manager->CreateFilter("box", "box::link::collision");
+  world->Step(1);
+  unsigned int numContacts = manager->GetContactCount();
+  ASSERT_GT(numContacts, 0u);
+
+  // Stepping again reuses the pooled contacts.
+  std::vector<physics::Contact *> contacts(manager->GetContacts().begin(),
+      manager->GetContacts().begin() + numContacts);
+  world->Step(1);
+  ASSERT_EQ(manager->GetContactCount(), numContacts);
+  for (unsigned int i = 0; i < numContacts; ++i)
+  {
+    EXPECT_EQ(manager->GetContact(i), contacts[i]);
+    EXPECT_TRUE(manager->GetContact(i)->collision1 != nullptr);
+    EXPECT_TRUE(manager->GetContact(i)->collision2 != nullptr);
+  }
+
+  // No contacts once the filter is removed.
+  manager->RemoveFilter("box");
+  world->Step(1);
+  EXPECT_EQ(manager->GetContactCount(), 0u);
+}
+
+/////////////////////////////////////////////////
+TEST_F(ContactManagerTest, FilterCallback)
+{
+  Load("test/worlds/box.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+
+  physics::ContactManager *manager = physics->GetContactManager();
+  ASSERT_TRUE(manager != nullptr);
+
+  unsigned int calls = 0;
+  int count = 0;
+  auto callback = [&](const std::vector<physics::Contact *> &_contacts)
+  {
+    ++calls;
+    for (auto const &contact : _contacts)
+      count += contact->count;
+  };
+
+  // Filter must exist
+  EXPECT_FALSE(manager->SetFilterCallback("box", callback));
+
+  manager->CreateFilter("box", "box::link::collision");
+  EXPECT_TRUE(manager->SetFilterCallback("box", callback));
+
+  world->Step(1);
+  EXPECT_EQ(calls, 1u);
+  EXPECT_GT(count, 0);
+
+  // Removing the callback stops the calls
+  EXPECT_TRUE(manager->SetFilterCallback("box", nullptr));
+  world->Step(1);
+  EXPECT_EQ(calls, 1u);
+}
+
+/////////////////////////////////////////////////
+TEST_F(ContactManagerTest, ContactCallback)
+{
+  Load("test/worlds/box.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+
+  physics::ContactManager *manager = physics->GetContactManager();
+  ASSERT_TRUE(manager != nullptr);
+
+  physics::ModelPtr model = world->ModelByName("box");
+  ASSERT_TRUE(model != nullptr);
+  physics::CollisionPtr collision =
+    model->GetLink("link")->GetCollision("collision");
+  ASSERT_TRUE(collision != nullptr);
+
+  unsigned int calls = 0;
+  int count = 0;
+  auto callback = [&](const std::vector<physics::Contact *> &_contacts)
+  {
+    ++calls;
+    for (auto const &contact : _contacts)
+    {
+      EXPECT_TRUE(contact->collision1 == collision.get() ||
+          contact->collision2 == collision.get());
+      count += contact->count;
+    }
+  };
+
+  unsigned int id = manager->AddContactCallback({collision}, callback);
+  EXPECT_NE(id, 0u);
+
+  // The box rests on the ground, no filter or topic is created
+  unsigned int filterCount = manager->GetFilterCount();
+  world->Step(1);
+  EXPECT_EQ(calls, 1u);
+  EXPECT_GT(count, 0);
+  EXPECT_EQ(manager->GetFilterCount(), filterCount);
+
+  // Removing the callback stops the calls
+  manager->RemoveContactCallback(id);
+  world->Step(1);
+  EXPECT_EQ(calls, 1u);
+}
+
+/////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
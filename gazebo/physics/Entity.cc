@@ -668,6 +668,15 @@ void Entity::UpdateAnimation(const common::UpdateInfo &_info)
   }
 }
 
+//////////////////////////////////////////////////
+void Entity::_SetWorldPoseFromPhysics(const ignition::math::Pose3d &_pose,
+    const bool _publish)
+{
+  (*this.*setWorldPoseFunc)(_pose, false, _publish);
+  if (_publish)
+    this->PublishPose();
+}
+
 //////////////////////////////////////////////////
 const ignition::math::Pose3d &Entity::DirtyPose() const
 {
@@ -227,6 +227,19 @@ namespace gazebo
       /// \return The dirty pose of the entity.
       public: const ignition::math::Pose3d &DirtyPose() const;
 
+      /// \internal
+      /// \brief Set the world pose of the entity after the physics engine
+      /// has moved it. Unlike SetWorldPose, this function does not lock
+      /// World::WorldPoseMutex or notify the physics engine. The caller
+      /// must hold World::WorldPoseMutex.
+      /// Only World should call this function.
+      /// \param[in] _pose New world pose.
+      /// \param[in] _publish True to publish the pose. Callers that update
+      /// entities in parallel pass false and publish the models afterwards.
+      public: void _SetWorldPoseFromPhysics(
+                  const ignition::math::Pose3d &_pose,
+                  const bool _publish = true);
+
       /// \brief This function is called when the entity's
       /// (or one of its parents) pose of the parent has changed.
       protected: virtual void OnPoseChange() = 0;
@@ -0,0 +1,410 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <utility>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Events.hh"
+#include "gazebo/physics/Collision.hh"
+#include "gazebo/physics/Contact.hh"
+#include "gazebo/physics/ContactManager.hh"
+#include "gazebo/physics/Joint.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/PhysicsEngine.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/physics/WorldSnapshot.hh"
+#include "gazebo/physics/Environment.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \brief A world stepped by an Environment.
+    class EnvironmentWorld
+    {
+      /// \brief The world.
+      public: WorldPtr world;
+
+      /// \brief The model in the world.
+      public: ModelPtr model;
+
+      /// \brief Joints of the model.
+      public: Joint_V joints;
+
+      /// \brief Links of the model.
+      public: Link_V links;
+
+      /// \brief Index of each link of the model.
+      public: std::unordered_map<const Link *, size_t> linkIndices;
+
+      /// \brief Contact flags of the links in the last step, written from
+      /// the update thread of the world.
+      public: std::vector<double> contacts;
+
+      /// \brief Identifier of the contact callback, 0 for none.
+      public: unsigned int contactCallback = 0;
+
+      /// \brief State of the world when it was loaded.
+      public: WorldSnapshot snapshot;
+    };
+
+    /// \brief Private data for Environment.
+    class EnvironmentPrivate
+    {
+      /// \brief Apply the actions of a world, at the start of its update.
+      /// \param[in] _info Update information, with the name of the world.
+      public: void OnWorldUpdateBegin(const common::UpdateInfo &_info);
+
+      /// \brief Write the observation of a world.
+      /// \param[in] _index Index of the world.
+      public: void Observe(const size_t _index);
+
+      /// \brief Write the observations of all the worlds.
+      public: void ObserveAll();
+
+      /// \brief Remove the contact callbacks from the worlds.
+      public: void RemoveContactCallbacks();
+
+      /// \brief The worlds.
+      public: std::vector<EnvironmentWorld> worlds;
+
+      /// \brief Index of each world, by name.
+      public: std::map<std::string, size_t> worldIndices;
+
+      /// \brief Number of joint axes of the model.
+      public: size_t dof = 0;
+
+      /// \brief Offset of each part in an observation.
+      public: size_t offsets[Environment::EXTRA + 1] = {0};
+
+      /// \brief Number of values in an observation.
+      public: size_t observationSize = 0;
+
+      /// \brief Functions writing the extra values, and their offsets.
+      public: std::vector<std::pair<size_t, Environment::ObservationFunc>>
+              extras;
+
+      /// \brief Observations of all the worlds.
+      public: std::vector<double> observations;
+
+      /// \brief Actions of all the worlds.
+      public: std::vector<double> actions;
+
+      /// \brief Connection to the world update begin event.
+      public: event::ConnectionPtr updateConnection;
+    };
+  }
+}
+
+//////////////////////////////////////////////////
+void EnvironmentPrivate::OnWorldUpdateBegin(const common::UpdateInfo &_info)
+{
+  auto iter = this->worldIndices.find(_info.worldName);
+  if (iter == this->worldIndices.end())
+    return;
+
+  EnvironmentWorld &env = this->worlds[iter->second];
+  std::fill(env.contacts.begin(), env.contacts.end(), 0.0);
+
+  const double *action = this->actions.data() + iter->second * this->dof;
+  for (const auto &joint : env.joints)
+  {
+    for (unsigned int axis = 0; axis < joint->DOF(); ++axis)
+      joint->SetForce(axis, *action++);
+  }
+}
+
+//////////////////////////////////////////////////
+void EnvironmentPrivate::Observe(const size_t _index)
+{
+  EnvironmentWorld &env = this->worlds[_index];
+  double *row = this->observations.data() + _index * this->observationSize;
+
+  double *positions = row + this->offsets[Environment::JOINT_POSITIONS];
+  double *velocities = row + this->offsets[Environment::JOINT_VELOCITIES];
+  for (const auto &joint : env.joints)
+  {
+    for (unsigned int axis = 0; axis < joint->DOF(); ++axis)
+    {
+      *positions++ = joint->Position(axis);
+      *velocities++ = joint->GetVelocity(axis);
+    }
+  }
+
+  double *poses = row + this->offsets[Environment::LINK_POSES];
+  double *twists = row + this->offsets[Environment::LINK_TWISTS];
+  for (const auto &link : env.links)
+  {
+    const ignition::math::Pose3d pose = link->WorldPose();
+    *poses++ = pose.Pos().X();
+    *poses++ = pose.Pos().Y();
+    *poses++ = pose.Pos().Z();
+    *poses++ = pose.Rot().W();
+    *poses++ = pose.Rot().X();
+    *poses++ = pose.Rot().Y();
+    *poses++ = pose.Rot().Z();
+
+    const ignition::math::Vector3d linear = link->WorldLinearVel();
+    const ignition::math::Vector3d angular = link->WorldAngularVel();
+    *twists++ = linear.X();
+    *twists++ = linear.Y();
+    *twists++ = linear.Z();
+    *twists++ = angular.X();
+    *twists++ = angular.Y();
+    *twists++ = angular.Z();
+  }
+
+  std::copy(env.contacts.begin(), env.contacts.end(),
+      row + this->offsets[Environment::CONTACTS]);
+
+  for (const auto &extra : this->extras)
+    extra.second(env.world, row + extra.first);
+}
+
+//////////////////////////////////////////////////
+void EnvironmentPrivate::ObserveAll()
+{
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, this->worlds.size(), 1),
+      [&](const tbb::blocked_range<size_t> &_r)
+      {
+        for (size_t i = _r.begin(); i != _r.end(); ++i)
+          this->Observe(i);
+      });
+}
+
+//////////////////////////////////////////////////
+void EnvironmentPrivate::RemoveContactCallbacks()
+{
+  for (auto &env : this->worlds)
+  {
+    if (env.contactCallback != 0 && env.world->Physics())
+    {
+      env.world->Physics()->GetContactManager()->RemoveContactCallback(
+          env.contactCallback);
+    }
+    env.contactCallback = 0;
+  }
+}
+
+//////////////////////////////////////////////////
+Environment::Environment()
+  : dataPtr(new EnvironmentPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+Environment::~Environment()
+{
+  this->dataPtr->updateConnection.reset();
+  this->dataPtr->RemoveContactCallbacks();
+}
+
+//////////////////////////////////////////////////
+bool Environment::Load(const std::vector<WorldPtr> &_worlds,
+    const std::string &_modelName)
+{
+  this->dataPtr->updateConnection.reset();
+  this->dataPtr->RemoveContactCallbacks();
+  this->dataPtr->worlds.clear();
+  this->dataPtr->worldIndices.clear();
+
+  std::vector<EnvironmentWorld> worlds(_worlds.size());
+  for (size_t i = 0; i < _worlds.size(); ++i)
+  {
+    EnvironmentWorld &env = worlds[i];
+    env.world = _worlds[i];
+    env.model = env.world ? env.world->ModelByName(_modelName) : nullptr;
+    if (!env.model)
+    {
+      gzerr << "Unable to find model[" << _modelName << "] in world["
+            << (env.world ? env.world->Name() : "") << "]\n";
+      return false;
+    }
+
+    env.joints = env.model->GetJoints();
+    env.links = env.model->GetLinks();
+    if (i > 0 && (env.model->JointDOFCount() != this->dataPtr->dof ||
+        env.links.size() != worlds[0].links.size()))
+    {
+      gzerr << "Model[" << _modelName << "] in world["
+            << env.world->Name() << "] doesn't have the joints and links "
+            << "of the model in world[" << worlds[0].world->Name() << "]\n";
+      return false;
+    }
+    this->dataPtr->dof = env.model->JointDOFCount();
+
+    for (size_t l = 0; l < env.links.size(); ++l)
+      env.linkIndices[env.links[l].get()] = l;
+    env.contacts.assign(env.links.size(), 0.0);
+  }
+
+  const size_t links = worlds.empty() ? 0 : worlds[0].links.size();
+  size_t *offsets = this->dataPtr->offsets;
+  offsets[JOINT_POSITIONS] = 0;
+  offsets[JOINT_VELOCITIES] = this->dataPtr->dof;
+  offsets[LINK_POSES] = 2 * this->dataPtr->dof;
+  offsets[LINK_TWISTS] = offsets[LINK_POSES] + 7 * links;
+  offsets[CONTACTS] = offsets[LINK_TWISTS] + 6 * links;
+  offsets[EXTRA] = offsets[CONTACTS] + links;
+  this->dataPtr->observationSize = offsets[EXTRA];
+  this->dataPtr->extras.clear();
+
+  this->dataPtr->worlds = std::move(worlds);
+  for (size_t i = 0; i < this->dataPtr->worlds.size(); ++i)
+  {
+    EnvironmentWorld &env = this->dataPtr->worlds[i];
+    this->dataPtr->worldIndices[env.world->Name()] = i;
+
+    env.world->SetPaused(true);
+    env.world->SaveSnapshot(env.snapshot);
+
+    // Flag the links of the model which have contacts
+    std::vector<CollisionPtr> collisions;
+    for (const auto &link : env.links)
+    {
+      for (const auto &collision : link->GetCollisions())
+        collisions.push_back(collision);
+    }
+    EnvironmentWorld *envPtr = &env;
+    env.contactCallback =
+      env.world->Physics()->GetContactManager()->AddContactCallback(
+        collisions, [envPtr](const std::vector<Contact *> &_contacts)
+        {
+          for (const auto *contact : _contacts)
+          {
+            if (contact->count <= 0)
+              continue;
+            for (const Collision *collision :
+                {contact->collision1, contact->collision2})
+            {
+              if (!collision)
+                continue;
+              auto iter = envPtr->linkIndices.find(
+                  collision->GetLink().get());
+              if (iter != envPtr->linkIndices.end())
+                envPtr->contacts[iter->second] = 1.0;
+            }
+          }
+        });
+  }
+
+  this->dataPtr->actions.assign(this->dataPtr->worlds.size() *
+      this->dataPtr->dof, 0.0);
+  this->dataPtr->observations.assign(this->dataPtr->worlds.size() *
+      this->dataPtr->observationSize, 0.0);
+
+  this->dataPtr->updateConnection = event::Events::ConnectWorldUpdateBegin(
+      std::bind(&EnvironmentPrivate::OnWorldUpdateBegin,
+        this->dataPtr.get(), std::placeholders::_1));
+
+  this->dataPtr->ObserveAll();
+  return true;
+}
+
+//////////////////////////////////////////////////
+size_t Environment::AddObservation(const size_t _size,
+    const ObservationFunc &_func)
+{
+  const size_t offset = this->dataPtr->observationSize;
+  this->dataPtr->observationSize += _size;
+  this->dataPtr->extras.push_back(std::make_pair(offset, _func));
+  this->dataPtr->observations.assign(this->dataPtr->worlds.size() *
+      this->dataPtr->observationSize, 0.0);
+  this->dataPtr->ObserveAll();
+  return offset;
+}
+
+//////////////////////////////////////////////////
+size_t Environment::WorldCount() const
+{
+  return this->dataPtr->worlds.size();
+}
+
+//////////////////////////////////////////////////
+size_t Environment::ObservationSize() const
+{
+  return this->dataPtr->observationSize;
+}
+
+//////////////////////////////////////////////////
+size_t Environment::Offset(const Field _field) const
+{
+  return this->dataPtr->offsets[_field];
+}
+
+//////////////////////////////////////////////////
+size_t Environment::ActionSize() const
+{
+  return this->dataPtr->dof;
+}
+
+//////////////////////////////////////////////////
+const double *Environment::Observations() const
+{
+  return this->dataPtr->observations.data();
+}
+
+//////////////////////////////////////////////////
+double *Environment::Actions()
+{
+  return this->dataPtr->actions.data();
+}
+
+//////////////////////////////////////////////////
+void Environment::Step(const unsigned int _steps)
+{
+  // World::Step blocks until the world thread has finished the steps, so
+  // use one task per world.
+  tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, this->dataPtr->worlds.size(), 1),
+      [&](const tbb::blocked_range<size_t> &_r)
+      {
+        for (size_t i = _r.begin(); i != _r.end(); ++i)
+        {
+          this->dataPtr->worlds[i].world->Step(_steps);
+          this->dataPtr->Observe(i);
+        }
+      });
+}
+
+//////////////////////////////////////////////////
+void Environment::Reset()
+{
+  std::fill(this->dataPtr->actions.begin(), this->dataPtr->actions.end(),
+      0.0);
+
+  tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, this->dataPtr->worlds.size(), 1),
+      [&](const tbb::blocked_range<size_t> &_r)
+      {
+        for (size_t i = _r.begin(); i != _r.end(); ++i)
+        {
+          EnvironmentWorld &env = this->dataPtr->worlds[i];
+          env.world->RestoreSnapshot(env.snapshot);
+          std::fill(env.contacts.begin(), env.contacts.end(), 0.0);
+          this->dataPtr->Observe(i);
+        }
+      });
+}
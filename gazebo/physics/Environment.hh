@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_ENVIRONMENT_HH_
+#define GAZEBO_PHYSICS_ENVIRONMENT_HH_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class
+    class EnvironmentPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class Environment Environment.hh physics/physics.hh
+    /// \brief In-process stepping of one model in several worlds, through
+    /// preallocated observation and action buffers, for learning loops
+    /// which would otherwise go through transport.
+    ///
+    /// Each world, e.g. a copy loaded with Server::LoadFileCopies, holds a
+    /// model with the same name. The worlds are stepped in lockstep, as
+    /// step_worlds does. At every physics step, the actions of a world are
+    /// applied as joint forces from its update thread. After the steps,
+    /// the observations of the worlds are written in place.
+    ///
+    /// The observation of a world is a row of ObservationSize() values:
+    /// joint positions and velocities, as Model::JointPositions orders
+    /// them, link poses as x y z qw qx qy qz, link twists as linear then
+    /// angular world velocities, one contact flag per link, 1 when the
+    /// link touched something in the last step, then the values of the
+    /// functions added with AddObservation, e.g. sensor data. The action of
+    /// a world is a row of ActionSize() joint forces. The rows of all the
+    /// worlds are contiguous.
+    class GZ_PHYSICS_VISIBLE Environment
+    {
+      /// \brief Parts of an observation.
+      public: enum Field
+              {
+                /// \brief Joint positions.
+                JOINT_POSITIONS,
+
+                /// \brief Joint velocities.
+                JOINT_VELOCITIES,
+
+                /// \brief Link world poses.
+                LINK_POSES,
+
+                /// \brief Link world velocities.
+                LINK_TWISTS,
+
+                /// \brief Link contact flags.
+                CONTACTS,
+
+                /// \brief Values of the functions added with AddObservation.
+                EXTRA
+              };
+
+      /// \brief Function writing a part of the observation of a world.
+      /// \param[in] _world The world, paused after its steps.
+      /// \param[out] _values Values to write, as many as the function was
+      /// added with.
+      public: using ObservationFunc =
+                  std::function<void (const WorldPtr &, double *)>;
+
+      /// \brief Constructor.
+      public: Environment();
+
+      /// \brief Destructor.
+      public: ~Environment();
+
+      /// \brief Set up the buffers for a model in several worlds, snapshot
+      /// the worlds for Reset, and fill the first observations. The worlds
+      /// must be running, and are paused.
+      /// \param[in] _worlds The worlds.
+      /// \param[in] _modelName Name of the model in each world.
+      /// \return False if a world has no such model, or its model doesn't
+      /// have the joints and links of the model in the first world.
+      public: bool Load(const std::vector<WorldPtr> &_worlds,
+                  const std::string &_modelName);
+
+      /// \brief Add values at the end of the observations, from a function
+      /// called for each world after its steps. This reallocates the
+      /// observations, and invalidates the pointers to them.
+      /// \param[in] _size Number of values.
+      /// \param[in] _func Function writing the values.
+      /// \return Offset of the values in an observation.
+      public: size_t AddObservation(const size_t _size,
+                  const ObservationFunc &_func);
+
+      /// \brief Get the number of worlds.
+      /// \return Number of worlds.
+      public: size_t WorldCount() const;
+
+      /// \brief Get the number of values in the observation of a world.
+      /// \return Number of values.
+      public: size_t ObservationSize() const;
+
+      /// \brief Get the offset of a part in the observation of a world.
+      /// \param[in] _field The part.
+      /// \return Offset of its first value.
+      public: size_t Offset(const Field _field) const;
+
+      /// \brief Get the number of values in the action of a world, the
+      /// number of joint axes of the model.
+      /// \return Number of values.
+      public: size_t ActionSize() const;
+
+      /// \brief Get the observations, WorldCount() rows of
+      /// ObservationSize() values, written by Load, Step and Reset.
+      /// \return Pointer to the first value.
+      public: const double *Observations() const;
+
+      /// \brief Get the actions, WorldCount() rows of ActionSize() joint
+      /// forces, applied at every step until they are changed.
+      /// \return Pointer to the first value.
+      public: double *Actions();
+
+      /// \brief Step all the worlds and write their observations.
+      /// \param[in] _steps Number of physics steps of each world.
+      public: void Step(const unsigned int _steps = 1);
+
+      /// \brief Restore the worlds as Load found them, zero the actions and
+      /// write the observations.
+      public: void Reset();
+
+      /// \brief Private data pointer.
+      private: std::unique_ptr<EnvironmentPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
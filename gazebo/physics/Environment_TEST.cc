@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "gazebo/physics/Environment.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+class EnvironmentTest : public ServerFixture
+{
+};
+
+/////////////////////////////////////////////////
+TEST_F(EnvironmentTest, StepAndReset)
+{
+  this->Load("worlds/simple_arm.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  physics::ModelPtr model = world->ModelByName("simple_arm");
+  ASSERT_TRUE(model != nullptr);
+
+  physics::Environment env;
+  EXPECT_FALSE(env.Load({world}, "no_such_model"));
+  ASSERT_TRUE(env.Load({world}, "simple_arm"));
+
+  const size_t dof = model->JointDOFCount();
+  const size_t links = model->GetLinks().size();
+  ASSERT_GT(dof, 0u);
+  EXPECT_EQ(1u, env.WorldCount());
+  EXPECT_EQ(dof, env.ActionSize());
+  EXPECT_EQ(2 * dof + 14 * links, env.ObservationSize());
+  EXPECT_EQ(dof, env.Offset(physics::Environment::JOINT_VELOCITIES));
+  EXPECT_EQ(2 * dof + 13 * links,
+      env.Offset(physics::Environment::CONTACTS));
+
+  // Extra values are appended after the contact flags
+  const size_t extra = env.AddObservation(1,
+      [](const physics::WorldPtr &_world, double *_values)
+      {
+        _values[0] = _world->SimTime().Double();
+      });
+  EXPECT_EQ(2 * dof + 14 * links, extra);
+  EXPECT_EQ(extra + 1, env.ObservationSize());
+
+  // The first observation matches the model
+  std::vector<double> positions;
+  model->JointPositions(positions);
+  for (size_t i = 0; i < dof; ++i)
+    EXPECT_DOUBLE_EQ(positions[i], env.Observations()[i]);
+  const double *poses = env.Observations() +
+    env.Offset(physics::Environment::LINK_POSES);
+  EXPECT_DOUBLE_EQ(model->GetLinks()[0]->WorldPose().Pos().Z(), poses[2]);
+  EXPECT_DOUBLE_EQ(0.0, env.Observations()[extra]);
+
+  // Actions are applied at every step
+  env.Actions()[0] = 10.0;
+  env.Step(100);
+  EXPECT_EQ(100u, world->Iterations());
+  EXPECT_NEAR(100 * world->Physics()->GetMaxStepSize(),
+      env.Observations()[extra], 1e-9);
+  model->JointPositions(positions);
+  for (size_t i = 0; i < dof; ++i)
+    EXPECT_DOUBLE_EQ(positions[i], env.Observations()[i]);
+  EXPECT_GT(env.Observations()[dof], 0.0);
+
+  const double *contacts = env.Observations() +
+    env.Offset(physics::Environment::CONTACTS);
+  for (size_t i = 0; i < links; ++i)
+    EXPECT_TRUE(contacts[i] == 0.0 || contacts[i] == 1.0);
+
+  // Reset goes back to the loaded state
+  env.Reset();
+  EXPECT_EQ(0u, world->Iterations());
+  EXPECT_DOUBLE_EQ(0.0, env.Actions()[0]);
+  EXPECT_DOUBLE_EQ(0.0, env.Observations()[extra]);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,791 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <ignition/math/Helpers.hh>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/physics/Inertial.hh"
+#include "gazebo/physics/Joint.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/physics/ForceField.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+namespace
+{
+  /// \brief Rotate a vector by a unit quaternion.
+  /// \param[in] _w Quaternion w.
+  /// \param[in] _x Quaternion x.
+  /// \param[in] _y Quaternion y.
+  /// \param[in] _z Quaternion z.
+  /// \param[in,out] _vx Vector x.
+  /// \param[in,out] _vy Vector y.
+  /// \param[in,out] _vz Vector z.
+  inline void Rotate(const double _w, const double _x, const double _y,
+      const double _z, double &_vx, double &_vy, double &_vz)
+  {
+    // v + 2w (q x v) + 2 q x (q x v)
+    const double tx = 2.0 * (_y * _vz - _z * _vy);
+    const double ty = 2.0 * (_z * _vx - _x * _vz);
+    const double tz = 2.0 * (_x * _vy - _y * _vx);
+    const double vx = _vx + _w * tx + (_y * tz - _z * ty);
+    const double vy = _vy + _w * ty + (_z * tx - _x * tz);
+    const double vz = _vz + _w * tz + (_x * ty - _y * tx);
+    _vx = vx;
+    _vy = vy;
+    _vz = vz;
+  }
+
+  /// \brief Replace a value which isn't finite by zero, as
+  /// ignition::math::Vector3::Correct does.
+  /// \param[in] _value Value.
+  /// \return The value, or 0.
+  inline double Finite(const double _value)
+  {
+    return std::isfinite(_value) ? _value : 0.0;
+  }
+
+  /// \brief Force and torque of the terms of one kind, about the center
+  /// of mass of their links in the world frame, one array per component.
+  class Wrenches
+  {
+    /// \brief Resize the arrays.
+    /// \param[in] _size Number of terms.
+    public: void Resize(const size_t _size)
+            {
+              for (auto *array : {&this->fx, &this->fy, &this->fz,
+                  &this->tx, &this->ty, &this->tz})
+              {
+                array->resize(_size);
+              }
+              this->active.resize(_size);
+            }
+
+    /// \brief Force x.
+    public: std::vector<double> fx;
+
+    /// \brief Force y.
+    public: std::vector<double> fy;
+
+    /// \brief Force z.
+    public: std::vector<double> fz;
+
+    /// \brief Torque x.
+    public: std::vector<double> tx;
+
+    /// \brief Torque y.
+    public: std::vector<double> ty;
+
+    /// \brief Torque z.
+    public: std::vector<double> tz;
+
+    /// \brief 1 for the terms which apply their wrench.
+    public: std::vector<unsigned char> active;
+  };
+}
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \brief Private data for ForceField.
+    class ForceFieldPrivate
+    {
+      /// \brief Constructor.
+      /// \param[in] _world World whose links are affected.
+      public: explicit ForceFieldPrivate(World &_world)
+              : world(_world)
+              {
+              }
+
+      /// \brief Find the links with wind enabled and index all the
+      /// affected links.
+      public: void Rebuild();
+
+      /// \brief Read the state of the affected links.
+      public: void Gather();
+
+      /// \brief Compute the wind drag.
+      public: void UpdateWind();
+
+      /// \brief Compute the buoyancy.
+      public: void UpdateBuoyancy();
+
+      /// \brief Compute the lift and drag.
+      public: void UpdateLiftDrag();
+
+      /// \brief Sum the wrenches of a kind of terms into their links.
+      /// \param[in] _wrenches Wrenches of the terms.
+      /// \param[in] _linkIndex Index of the link of each term.
+      public: void Accumulate(const Wrenches &_wrenches,
+                  const std::vector<size_t> &_linkIndex);
+
+      /// \brief Apply the sums of the wrenches to the links.
+      public: void Apply();
+
+      /// \brief World whose links are affected.
+      public: World &world;
+
+      /// \brief Scale of the wind drag, 0 when disabled.
+      public: double windDrag = 0.0;
+
+      /// \brief Entity generation of the world when the links with wind
+      /// enabled were found.
+      public: uint64_t windGeneration =
+              std::numeric_limits<uint64_t>::max();
+
+      /// \brief True when the affected links must be indexed again.
+      public: bool dirty = true;
+
+      /// \brief Next term identifier.
+      public: uint32_t nextId = 1;
+
+      /// \brief Kind and index of each term, by identifier. Kind 0 is
+      /// buoyancy, 1 is lift and drag.
+      public: std::map<uint32_t, std::pair<int, size_t>> terms;
+
+      /// \brief All the links of the models of the world, in order.
+      public: Link_V worldLinks;
+
+      /// \brief The affected links.
+      public: Link_V links;
+
+      /// \brief Index of each link of worldLinks in links.
+      public: std::vector<size_t> worldLinkIndex;
+
+      /// \name Link state, one value per affected link.
+      /// \{
+
+      /// \brief Position x.
+      public: std::vector<double> px;
+
+      /// \brief Position y.
+      public: std::vector<double> py;
+
+      /// \brief Position z.
+      public: std::vector<double> pz;
+
+      /// \brief Orientation w.
+      public: std::vector<double> qw;
+
+      /// \brief Orientation x.
+      public: std::vector<double> qx;
+
+      /// \brief Orientation y.
+      public: std::vector<double> qy;
+
+      /// \brief Orientation z.
+      public: std::vector<double> qz;
+
+      /// \brief Linear velocity x of the center of mass.
+      public: std::vector<double> vx;
+
+      /// \brief Linear velocity y of the center of mass.
+      public: std::vector<double> vy;
+
+      /// \brief Linear velocity z of the center of mass.
+      public: std::vector<double> vz;
+
+      /// \brief Angular velocity x.
+      public: std::vector<double> wx;
+
+      /// \brief Angular velocity y.
+      public: std::vector<double> wy;
+
+      /// \brief Angular velocity z.
+      public: std::vector<double> wz;
+
+      /// \brief Center of mass x, in the link frame.
+      public: std::vector<double> cx;
+
+      /// \brief Center of mass y, in the link frame.
+      public: std::vector<double> cy;
+
+      /// \brief Center of mass z, in the link frame.
+      public: std::vector<double> cz;
+
+      /// \brief Mass.
+      public: std::vector<double> mass;
+
+      /// \brief Sum of the forces and torques.
+      public: Wrenches sum;
+
+      /// \}
+
+      /// \brief Wind velocity of each link of worldLinks.
+      public: std::vector<double> windX;
+
+      /// \brief Wind velocity y.
+      public: std::vector<double> windY;
+
+      /// \brief Wind velocity z.
+      public: std::vector<double> windZ;
+
+      /// \brief Wind drag of each link of worldLinks.
+      public: Wrenches windWrenches;
+
+      /// \name Buoyancy terms.
+      /// \{
+
+      /// \brief Identifiers.
+      public: std::vector<uint32_t> buoyancyIds;
+
+      /// \brief Links.
+      public: Link_V buoyancyLinks;
+
+      /// \brief Index of the links in links.
+      public: std::vector<size_t> buoyancyLinkIndex;
+
+      /// \brief Volume times fluid density.
+      public: std::vector<double> displacedMass;
+
+      /// \brief Center of volume x, in the link frame.
+      public: std::vector<double> covX;
+
+      /// \brief Center of volume y, in the link frame.
+      public: std::vector<double> covY;
+
+      /// \brief Center of volume z, in the link frame.
+      public: std::vector<double> covZ;
+
+      /// \brief Wrenches.
+      public: Wrenches buoyancyWrenches;
+
+      /// \}
+
+      /// \name Lift and drag terms.
+      /// \{
+
+      /// \brief Identifiers.
+      public: std::vector<uint32_t> liftDragIds;
+
+      /// \brief Links.
+      public: Link_V liftDragLinks;
+
+      /// \brief Control joints, or null.
+      public: Joint_V liftDragJoints;
+
+      /// \brief Index of the links in links.
+      public: std::vector<size_t> liftDragLinkIndex;
+
+      /// \brief Parameters.
+      public: std::vector<LiftDragParams> liftDragParams;
+
+      /// \brief Position of each control joint, 0 without one.
+      public: std::vector<double> controlAngle;
+
+      /// \brief Wrenches.
+      public: Wrenches liftDragWrenches;
+
+      /// \}
+    };
+  }
+}
+
+//////////////////////////////////////////////////
+void ForceFieldPrivate::Rebuild()
+{
+  this->worldLinks.clear();
+  if (this->windDrag != 0.0)
+  {
+    for (const auto &model : this->world.Models())
+    {
+      for (const auto &link : model->GetLinks())
+        this->worldLinks.push_back(link);
+    }
+  }
+
+  this->links.clear();
+  std::unordered_map<const Link *, size_t> indices;
+  auto index = [&](const LinkPtr &_link)
+  {
+    auto iter = indices.emplace(_link.get(), this->links.size());
+    if (iter.second)
+      this->links.push_back(_link);
+    return iter.first->second;
+  };
+
+  this->worldLinkIndex.resize(this->worldLinks.size());
+  for (size_t i = 0; i < this->worldLinks.size(); ++i)
+    this->worldLinkIndex[i] = index(this->worldLinks[i]);
+  for (size_t i = 0; i < this->buoyancyLinks.size(); ++i)
+    this->buoyancyLinkIndex[i] = index(this->buoyancyLinks[i]);
+  for (size_t i = 0; i < this->liftDragLinks.size(); ++i)
+    this->liftDragLinkIndex[i] = index(this->liftDragLinks[i]);
+
+  const size_t count = this->links.size();
+  for (auto *array : {&this->px, &this->py, &this->pz, &this->qw,
+      &this->qx, &this->qy, &this->qz, &this->vx, &this->vy, &this->vz,
+      &this->wx, &this->wy, &this->wz, &this->cx, &this->cy, &this->cz,
+      &this->mass})
+  {
+    array->resize(count);
+  }
+  this->sum.Resize(count);
+
+  this->windX.resize(this->worldLinks.size());
+  this->windY.resize(this->worldLinks.size());
+  this->windZ.resize(this->worldLinks.size());
+  this->windWrenches.Resize(this->worldLinks.size());
+  this->buoyancyWrenches.Resize(this->buoyancyLinks.size());
+  this->controlAngle.resize(this->liftDragLinks.size());
+  this->liftDragWrenches.Resize(this->liftDragLinks.size());
+
+  this->dirty = false;
+}
+
+//////////////////////////////////////////////////
+void ForceFieldPrivate::Gather()
+{
+  for (size_t i = 0; i < this->links.size(); ++i)
+  {
+    const Link *link = this->links[i].get();
+    const ignition::math::Pose3d &pose = link->WorldPose();
+    this->px[i] = pose.Pos().X();
+    this->py[i] = pose.Pos().Y();
+    this->pz[i] = pose.Pos().Z();
+    this->qw[i] = pose.Rot().W();
+    this->qx[i] = pose.Rot().X();
+    this->qy[i] = pose.Rot().Y();
+    this->qz[i] = pose.Rot().Z();
+
+    const ignition::math::Vector3d vel = link->WorldCoGLinearVel();
+    this->vx[i] = vel.X();
+    this->vy[i] = vel.Y();
+    this->vz[i] = vel.Z();
+
+    const ignition::math::Vector3d angular = link->WorldAngularVel();
+    this->wx[i] = angular.X();
+    this->wy[i] = angular.Y();
+    this->wz[i] = angular.Z();
+
+    const InertialPtr inertial = link->GetInertial();
+    this->cx[i] = inertial->CoG().X();
+    this->cy[i] = inertial->CoG().Y();
+    this->cz[i] = inertial->CoG().Z();
+    this->mass[i] = inertial->Mass();
+  }
+
+  for (size_t i = 0; i < this->worldLinks.size(); ++i)
+  {
+    const Link *link = this->worldLinks[i].get();
+    this->windWrenches.active[i] = link->WindMode();
+    const ignition::math::Vector3d wind = link->WorldWindLinearVel();
+    this->windX[i] = wind.X();
+    this->windY[i] = wind.Y();
+    this->windZ[i] = wind.Z();
+  }
+
+  for (size_t i = 0; i < this->liftDragJoints.size(); ++i)
+  {
+    this->controlAngle[i] = this->liftDragJoints[i] ?
+      this->liftDragJoints[i]->Position(0) : 0.0;
+  }
+}
+
+//////////////////////////////////////////////////
+void ForceFieldPrivate::UpdateWind()
+{
+  Wrenches &out = this->windWrenches;
+  const double scale = this->windDrag;
+  for (size_t i = 0; i < this->worldLinks.size(); ++i)
+  {
+    const size_t l = this->worldLinkIndex[i];
+
+    // Velocity of the link origin, the velocity the drag opposes
+    double ox = -this->cx[l];
+    double oy = -this->cy[l];
+    double oz = -this->cz[l];
+    Rotate(this->qw[l], this->qx[l], this->qy[l], this->qz[l], ox, oy, oz);
+    const double velX = this->vx[l] + this->wy[l] * oz - this->wz[l] * oy;
+    const double velY = this->vy[l] + this->wz[l] * ox - this->wx[l] * oz;
+    const double velZ = this->vz[l] + this->wx[l] * oy - this->wy[l] * ox;
+
+    // Applied at the center of mass, so without torque
+    const double k = this->mass[l] * scale;
+    out.fx[i] = k * (this->windX[i] - velX);
+    out.fy[i] = k * (this->windY[i] - velY);
+    out.fz[i] = k * (this->windZ[i] - velZ);
+    out.tx[i] = 0.0;
+    out.ty[i] = 0.0;
+    out.tz[i] = 0.0;
+  }
+}
+
+//////////////////////////////////////////////////
+void ForceFieldPrivate::UpdateBuoyancy()
+{
+  // By Archimedes' principle, the buoyancy is the weight of the displaced
+  // fluid, opposed to gravity.
+  const ignition::math::Vector3d gravity = this->world.Gravity();
+  const double gx = gravity.X();
+  const double gy = gravity.Y();
+  const double gz = gravity.Z();
+
+  Wrenches &out = this->buoyancyWrenches;
+  for (size_t i = 0; i < this->buoyancyLinks.size(); ++i)
+  {
+    const size_t l = this->buoyancyLinkIndex[i];
+    const double fx = -this->displacedMass[i] * gx;
+    const double fy = -this->displacedMass[i] * gy;
+    const double fz = -this->displacedMass[i] * gz;
+
+    // Applied at the center of volume
+    double ax = this->covX[i] - this->cx[l];
+    double ay = this->covY[i] - this->cy[l];
+    double az = this->covZ[i] - this->cz[l];
+    Rotate(this->qw[l], this->qx[l], this->qy[l], this->qz[l], ax, ay, az);
+
+    out.fx[i] = fx;
+    out.fy[i] = fy;
+    out.fz[i] = fz;
+    out.tx[i] = ay * fz - az * fy;
+    out.ty[i] = az * fx - ax * fz;
+    out.tz[i] = ax * fy - ay * fx;
+    out.active[i] = 1;
+  }
+}
+
+//////////////////////////////////////////////////
+void ForceFieldPrivate::UpdateLiftDrag()
+{
+  using ignition::math::Vector3d;
+
+  Wrenches &out = this->liftDragWrenches;
+  for (size_t i = 0; i < this->liftDragLinks.size(); ++i)
+  {
+    const size_t l = this->liftDragLinkIndex[i];
+    const LiftDragParams &p = this->liftDragParams[i];
+    const double w = this->qw[l];
+    const double x = this->qx[l];
+    const double y = this->qy[l];
+    const double z = this->qz[l];
+
+    // Linear velocity at the center of pressure, in the world frame
+    double ax = p.cp.X() - this->cx[l];
+    double ay = p.cp.Y() - this->cy[l];
+    double az = p.cp.Z() - this->cz[l];
+    Rotate(w, x, y, z, ax, ay, az);
+    const Vector3d vel(
+        this->vx[l] + this->wy[l] * az - this->wz[l] * ay,
+        this->vy[l] + this->wz[l] * ax - this->wx[l] * az,
+        this->vz[l] + this->wx[l] * ay - this->wy[l] * ax);
+    const Vector3d velI = Vector3d(vel).Normalize();
+
+    // As in Link::AddForceAtRelativePosition, the force is applied at cp
+    // relative to the center of gravity
+    ax = p.cp.X();
+    ay = p.cp.Y();
+    az = p.cp.Z();
+    Rotate(w, x, y, z, ax, ay, az);
+
+    // Too slow for aerodynamic forces
+    out.active[i] = vel.Length() > 0.01;
+
+    // Forward and upward directions in the world frame
+    double fwdX = p.forward.X();
+    double fwdY = p.forward.Y();
+    double fwdZ = p.forward.Z();
+    Rotate(w, x, y, z, fwdX, fwdY, fwdZ);
+    const Vector3d forwardI(fwdX, fwdY, fwdZ);
+
+    Vector3d upwardI;
+    if (p.radialSymmetry)
+    {
+      // The component of the inflow perpendicular to the forward direction
+      upwardI = forwardI.Cross(forwardI.Cross(velI)).Normalize();
+    }
+    else
+    {
+      double upX = p.upward.X();
+      double upY = p.upward.Y();
+      double upZ = p.upward.Z();
+      Rotate(w, x, y, z, upX, upY, upZ);
+      upwardI.Set(upX, upY, upZ);
+    }
+
+    // Normal to the lift-drag plane
+    const Vector3d spanwiseI = forwardI.Cross(upwardI).Normalize();
+
+    // Sweep, the angle between the inflow and the lift-drag plane, within
+    // +/-90 degrees since it comes from asin
+    const double sinSweepAngle =
+      ignition::math::clamp(spanwiseI.Dot(velI), -1.0, 1.0);
+    const double cosSweepAngle = 1.0 - sinSweepAngle * sinSweepAngle;
+
+    // Velocity without its spanwise component
+    const Vector3d velInLDPlane = vel - vel.Dot(spanwiseI) * velI;
+    const Vector3d dragDirection = (-velInLDPlane).Normalize();
+    const Vector3d liftI = spanwiseI.Cross(velInLDPlane).Normalize();
+
+    // Angle of attack, positive when the lift points forward, normalized
+    // to within +/-90 degrees
+    const double cosAlpha =
+      ignition::math::clamp(liftI.Dot(upwardI), -1.0, 1.0);
+    double alpha = liftI.Dot(forwardI) >= 0.0 ?
+      p.alpha0 + std::acos(cosAlpha) : p.alpha0 - std::acos(cosAlpha);
+    if (std::fabs(alpha) > 0.5 * M_PI)
+      alpha -= M_PI * std::nearbyint(alpha / M_PI);
+
+    // Dynamic pressure
+    const double speedInLDPlane = velInLDPlane.Length();
+    const double q = 0.5 * p.rho * speedInLDPlane * speedInLDPlane;
+
+    // Lift coefficient, after stall and sweep, and with the control joint
+    double cl;
+    if (alpha > p.alphaStall)
+    {
+      cl = std::max(0.0, (p.cla * p.alphaStall +
+            p.claStall * (alpha - p.alphaStall)) * cosSweepAngle);
+    }
+    else if (alpha < -p.alphaStall)
+    {
+      cl = std::min(0.0, (-p.cla * p.alphaStall +
+            p.claStall * (alpha + p.alphaStall)) * cosSweepAngle);
+    }
+    else
+      cl = p.cla * alpha * cosSweepAngle;
+    cl += p.controlJointRadToCL * this->controlAngle[i];
+
+    // Drag coefficient, always positive
+    double cd;
+    if (alpha > p.alphaStall)
+    {
+      cd = (p.cda * p.alphaStall +
+          p.cdaStall * (alpha - p.alphaStall)) * cosSweepAngle;
+    }
+    else if (alpha < -p.alphaStall)
+    {
+      cd = (-p.cda * p.alphaStall +
+          p.cdaStall * (alpha + p.alphaStall)) * cosSweepAngle;
+    }
+    else
+      cd = p.cda * alpha * cosSweepAngle;
+    cd = std::fabs(cd);
+
+    // The pitching moment isn't applied, it needs testing
+    const Vector3d force =
+      cl * q * p.area * liftI + cd * q * p.area * dragDirection;
+
+    // Applied at cp from the center of gravity
+    out.fx[i] = Finite(force.X());
+    out.fy[i] = Finite(force.Y());
+    out.fz[i] = Finite(force.Z());
+    out.tx[i] = ay * out.fz[i] - az * out.fy[i];
+    out.ty[i] = az * out.fx[i] - ax * out.fz[i];
+    out.tz[i] = ax * out.fy[i] - ay * out.fx[i];
+  }
+}
+
+//////////////////////////////////////////////////
+void ForceFieldPrivate::Accumulate(const Wrenches &_wrenches,
+    const std::vector<size_t> &_linkIndex)
+{
+  for (size_t i = 0; i < _linkIndex.size(); ++i)
+  {
+    if (!_wrenches.active[i])
+      continue;
+
+    const size_t l = _linkIndex[i];
+    this->sum.fx[l] += _wrenches.fx[i];
+    this->sum.fy[l] += _wrenches.fy[i];
+    this->sum.fz[l] += _wrenches.fz[i];
+    this->sum.tx[l] += _wrenches.tx[i];
+    this->sum.ty[l] += _wrenches.ty[i];
+    this->sum.tz[l] += _wrenches.tz[i];
+    this->sum.active[l] = 1;
+  }
+}
+
+//////////////////////////////////////////////////
+void ForceFieldPrivate::Apply()
+{
+  for (size_t l = 0; l < this->links.size(); ++l)
+  {
+    if (!this->sum.active[l])
+      continue;
+
+    this->links[l]->AddForce(ignition::math::Vector3d(
+          this->sum.fx[l], this->sum.fy[l], this->sum.fz[l]));
+    this->links[l]->AddTorque(ignition::math::Vector3d(
+          this->sum.tx[l], this->sum.ty[l], this->sum.tz[l]));
+  }
+}
+
+//////////////////////////////////////////////////
+ForceField::ForceField(World &_world)
+  : dataPtr(new ForceFieldPrivate(_world))
+{
+}
+
+//////////////////////////////////////////////////
+ForceField::~ForceField()
+{
+}
+
+//////////////////////////////////////////////////
+void ForceField::SetWindDrag(const double _scale)
+{
+  if ((this->dataPtr->windDrag != 0.0) != (_scale != 0.0))
+    this->dataPtr->dirty = true;
+  this->dataPtr->windDrag = _scale;
+}
+
+//////////////////////////////////////////////////
+double ForceField::WindDrag() const
+{
+  return this->dataPtr->windDrag;
+}
+
+//////////////////////////////////////////////////
+uint32_t ForceField::AddBuoyancy(const LinkPtr &_link, const double _volume,
+    const ignition::math::Vector3d &_cov, const double _fluidDensity)
+{
+  if (!_link)
+  {
+    gzerr << "Unable to add buoyancy without a link\n";
+    return 0;
+  }
+
+  const uint32_t id = this->dataPtr->nextId++;
+  this->dataPtr->terms[id] =
+    std::make_pair(0, this->dataPtr->buoyancyIds.size());
+  this->dataPtr->buoyancyIds.push_back(id);
+  this->dataPtr->buoyancyLinks.push_back(_link);
+  this->dataPtr->buoyancyLinkIndex.push_back(0);
+  this->dataPtr->displacedMass.push_back(_volume * _fluidDensity);
+  this->dataPtr->covX.push_back(_cov.X());
+  this->dataPtr->covY.push_back(_cov.Y());
+  this->dataPtr->covZ.push_back(_cov.Z());
+  this->dataPtr->dirty = true;
+  return id;
+}
+
+//////////////////////////////////////////////////
+uint32_t ForceField::AddLiftDrag(const LinkPtr &_link,
+    const LiftDragParams &_params, const JointPtr &_controlJoint)
+{
+  if (!_link)
+  {
+    gzerr << "Unable to add lift and drag without a link\n";
+    return 0;
+  }
+
+  const uint32_t id = this->dataPtr->nextId++;
+  this->dataPtr->terms[id] =
+    std::make_pair(1, this->dataPtr->liftDragIds.size());
+  this->dataPtr->liftDragIds.push_back(id);
+  this->dataPtr->liftDragLinks.push_back(_link);
+  this->dataPtr->liftDragJoints.push_back(_controlJoint);
+  this->dataPtr->liftDragLinkIndex.push_back(0);
+  this->dataPtr->liftDragParams.push_back(_params);
+  this->dataPtr->dirty = true;
+  return id;
+}
+
+//////////////////////////////////////////////////
+void ForceField::Remove(const uint32_t _id)
+{
+  auto iter = this->dataPtr->terms.find(_id);
+  if (iter == this->dataPtr->terms.end())
+    return;
+
+  const int kind = iter->second.first;
+  const size_t index = iter->second.second;
+  this->dataPtr->terms.erase(iter);
+
+  // The last term of the kind takes the index of the removed one
+  auto remove = [index](auto &_array)
+  {
+    _array[index] = _array.back();
+    _array.pop_back();
+  };
+
+  std::vector<uint32_t> &ids = kind == 0 ?
+    this->dataPtr->buoyancyIds : this->dataPtr->liftDragIds;
+  remove(ids);
+  if (kind == 0)
+  {
+    remove(this->dataPtr->buoyancyLinks);
+    remove(this->dataPtr->buoyancyLinkIndex);
+    remove(this->dataPtr->displacedMass);
+    remove(this->dataPtr->covX);
+    remove(this->dataPtr->covY);
+    remove(this->dataPtr->covZ);
+  }
+  else
+  {
+    remove(this->dataPtr->liftDragLinks);
+    remove(this->dataPtr->liftDragJoints);
+    remove(this->dataPtr->liftDragLinkIndex);
+    remove(this->dataPtr->liftDragParams);
+  }
+
+  if (index < ids.size())
+    this->dataPtr->terms[ids[index]].second = index;
+  this->dataPtr->dirty = true;
+}
+
+//////////////////////////////////////////////////
+size_t ForceField::TermCount() const
+{
+  return this->dataPtr->terms.size();
+}
+
+//////////////////////////////////////////////////
+void ForceField::Update(const uint64_t _entityGeneration)
+{
+  const bool wind = this->dataPtr->windDrag != 0.0;
+  if (!wind && this->dataPtr->terms.empty())
+    return;
+
+  if (wind && _entityGeneration != this->dataPtr->windGeneration)
+  {
+    this->dataPtr->windGeneration = _entityGeneration;
+    this->dataPtr->dirty = true;
+  }
+  if (this->dataPtr->dirty)
+    this->dataPtr->Rebuild();
+
+  this->dataPtr->Gather();
+  this->dataPtr->UpdateWind();
+  this->dataPtr->UpdateBuoyancy();
+  this->dataPtr->UpdateLiftDrag();
+
+  Wrenches &sum = this->dataPtr->sum;
+  for (auto *array : {&sum.fx, &sum.fy, &sum.fz, &sum.tx, &sum.ty, &sum.tz})
+    std::fill(array->begin(), array->end(), 0.0);
+  std::fill(sum.active.begin(), sum.active.end(), 0);
+
+  this->dataPtr->Accumulate(this->dataPtr->windWrenches,
+      this->dataPtr->worldLinkIndex);
+  this->dataPtr->Accumulate(this->dataPtr->buoyancyWrenches,
+      this->dataPtr->buoyancyLinkIndex);
+  this->dataPtr->Accumulate(this->dataPtr->liftDragWrenches,
+      this->dataPtr->liftDragLinkIndex);
+  this->dataPtr->Apply();
+}
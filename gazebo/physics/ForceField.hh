@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_FORCEFIELD_HH_
+#define GAZEBO_PHYSICS_FORCEFIELD_HH_
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class
+    class ForceFieldPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \brief Parameters of a lift and drag surface, as read by the
+    /// LiftDragPlugin.
+    class GZ_PHYSICS_VISIBLE LiftDragParams
+    {
+      /// \brief Lift coefficient slope.
+      public: double cla = 1.0;
+
+      /// \brief Drag coefficient slope.
+      public: double cda = 0.01;
+
+      /// \brief Moment coefficient slope.
+      public: double cma = 0.01;
+
+      /// \brief Angle of attack at stall.
+      public: double alphaStall = 0.5 * M_PI;
+
+      /// \brief Lift coefficient slope after stall.
+      public: double claStall = 0.0;
+
+      /// \brief Drag coefficient slope after stall.
+      public: double cdaStall = 1.0;
+
+      /// \brief Moment coefficient slope after stall.
+      public: double cmaStall = 0.0;
+
+      /// \brief Fluid density.
+      public: double rho = 1.2041;
+
+      /// \brief True to derive the upward direction from the inflow.
+      public: bool radialSymmetry = false;
+
+      /// \brief Surface area.
+      public: double area = 1.0;
+
+      /// \brief Angle of attack at zero lift.
+      public: double alpha0 = 0.0;
+
+      /// \brief Center of pressure, in the link frame. As in the
+      /// LiftDragPlugin, the force is applied at cp relative to the center
+      /// of gravity, see Link::AddForceAtRelativePosition.
+      public: ignition::math::Vector3d cp;
+
+      /// \brief Forward direction, in the link frame.
+      public: ignition::math::Vector3d forward =
+              ignition::math::Vector3d::UnitX;
+
+      /// \brief Upward direction, in the link frame.
+      public: ignition::math::Vector3d upward =
+              ignition::math::Vector3d::UnitZ;
+
+      /// \brief Change of the lift coefficient per radian of the control
+      /// joint.
+      public: double controlJointRadToCL = 4.0;
+    };
+
+    /// \class ForceField ForceField.hh physics/physics.hh
+    /// \brief Forces of the surrounding fluids, computed for all the links
+    /// of a world at once.
+    ///
+    /// Plugins add terms: wind drag on every link with wind enabled,
+    /// buoyancy, and lift and drag of surfaces. At each update, which the
+    /// world runs right after the world update begin event, the state of
+    /// the affected links is gathered into arrays, one per quantity, each
+    /// kind of term is evaluated in one loop over these arrays, and the
+    /// sum of the forces and torques of each link is applied with a single
+    /// Link::AddForce and Link::AddTorque.
+    class GZ_PHYSICS_VISIBLE ForceField
+    {
+      /// \brief Constructor.
+      /// \param[in] _world World whose links are affected.
+      public: explicit ForceField(World &_world);
+
+      /// \brief Destructor.
+      public: ~ForceField();
+
+      /// \brief Set the wind drag of the links with wind enabled, which is
+      /// the mass of a link times _scale times the difference between the
+      /// wind velocity and the velocity of the link.
+      /// \param[in] _scale Scale of the drag, or 0 to disable it.
+      public: void SetWindDrag(const double _scale);
+
+      /// \brief Get the wind drag scale.
+      /// \return The scale, 0 when disabled.
+      public: double WindDrag() const;
+
+      /// \brief Add the buoyancy of a link immersed in a fluid.
+      /// \param[in] _link The link.
+      /// \param[in] _volume Volume of the link.
+      /// \param[in] _cov Center of volume, in the link frame.
+      /// \param[in] _fluidDensity Density of the fluid.
+      /// \return Identifier of the term, for Remove.
+      public: uint32_t AddBuoyancy(const LinkPtr &_link,
+                  const double _volume,
+                  const ignition::math::Vector3d &_cov,
+                  const double _fluidDensity);
+
+      /// \brief Add the lift and drag of a surface.
+      /// \param[in] _link Link of the surface.
+      /// \param[in] _params Parameters of the surface.
+      /// \param[in] _controlJoint Joint whose position changes the lift
+      /// coefficient, or null.
+      /// \return Identifier of the term, for Remove.
+      public: uint32_t AddLiftDrag(const LinkPtr &_link,
+                  const LiftDragParams &_params,
+                  const JointPtr &_controlJoint = JointPtr());
+
+      /// \brief Remove a term.
+      /// \param[in] _id Identifier returned by AddBuoyancy or AddLiftDrag.
+      public: void Remove(const uint32_t _id);
+
+      /// \brief Get the number of buoyancy and lift and drag terms.
+      /// \return Number of terms.
+      public: size_t TermCount() const;
+
+      /// \brief Compute and apply the forces.
+      /// \param[in] _entityGeneration Counter of the insertions and
+      /// removals of entities in the world, which tells when to look for
+      /// the links with wind enabled again.
+      public: void Update(const uint64_t _entityGeneration);
+
+      /// \brief Private data pointer.
+      private: std::unique_ptr<ForceFieldPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
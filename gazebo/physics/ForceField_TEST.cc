@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "gazebo/physics/ForceField.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+class ForceFieldTest : public ServerFixture
+{
+};
+
+/////////////////////////////////////////////////
+TEST_F(ForceFieldTest, Buoyancy)
+{
+  this->Load("worlds/empty.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 5), ignition::math::Vector3d::Zero);
+  physics::ModelPtr model = world->ModelByName("box");
+  ASSERT_TRUE(model != nullptr);
+  physics::LinkPtr link = model->GetLink();
+  ASSERT_TRUE(link != nullptr);
+
+  physics::ForceField &field = world->ForceField();
+  EXPECT_EQ(0u, field.TermCount());
+  EXPECT_EQ(0u, field.AddBuoyancy(nullptr, 1.0,
+        ignition::math::Vector3d::Zero, 1.0));
+
+  // Terms can be removed in any order
+  const double mass = link->GetInertial()->Mass();
+  const uint32_t first = field.AddBuoyancy(link, 0.5,
+      ignition::math::Vector3d::Zero, mass);
+  const uint32_t second = field.AddBuoyancy(link, 0.5,
+      ignition::math::Vector3d::Zero, mass);
+  const uint32_t third = field.AddLiftDrag(link, physics::LiftDragParams());
+  EXPECT_NE(0u, first);
+  EXPECT_NE(first, second);
+  EXPECT_EQ(3u, field.TermCount());
+  field.Remove(third);
+  field.Remove(third);
+  EXPECT_EQ(2u, field.TermCount());
+
+  // The buoyancy of the two halves of the volume cancels gravity
+  world->Step(100);
+  EXPECT_NEAR(5.0, link->WorldPose().Pos().Z(), 1e-6);
+  EXPECT_NEAR(0.0, link->WorldLinearVel().Z(), 1e-6);
+
+  // Half the buoyancy halves the fall
+  field.Remove(first);
+  EXPECT_EQ(1u, field.TermCount());
+  world->Step(100);
+  const double t = 100 * world->Physics()->GetMaxStepSize();
+  EXPECT_NEAR(0.5 * world->Gravity().Z() * t,
+      link->WorldLinearVel().Z(), 1e-3);
+
+  field.Remove(second);
+  EXPECT_EQ(0u, field.TermCount());
+}
+
+/////////////////////////////////////////////////
+TEST_F(ForceFieldTest, WindDrag)
+{
+  this->Load("worlds/empty.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 5), ignition::math::Vector3d::Zero);
+  physics::ModelPtr model = world->ModelByName("box");
+  ASSERT_TRUE(model != nullptr);
+  physics::LinkPtr link = model->GetLink();
+  ASSERT_TRUE(link != nullptr);
+  link->SetGravityMode(false);
+  link->SetWindMode(true);
+  world->Wind().SetLinearVel(ignition::math::Vector3d(1, 0, 0));
+
+  physics::ForceField &field = world->ForceField();
+  EXPECT_DOUBLE_EQ(0.0, field.WindDrag());
+  world->Step(10);
+  EXPECT_NEAR(0.0, link->WorldLinearVel().X(), 1e-9);
+
+  // The link is dragged towards the wind velocity
+  field.SetWindDrag(1.0);
+  EXPECT_DOUBLE_EQ(1.0, field.WindDrag());
+  world->Step(1000);
+  EXPECT_GT(link->WorldLinearVel().X(), 0.5);
+  EXPECT_LT(link->WorldLinearVel().X(), 1.0);
+  field.SetWindDrag(0.0);
+}
+
+/////////////////////////////////////////////////
+TEST_F(ForceFieldTest, LiftDragCenterOfGravity)
+{
+  this->Load("worlds/empty.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  SpawnBox("surface", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 5), ignition::math::Vector3d::Zero);
+  SpawnBox("reference", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 5, 5), ignition::math::Vector3d::Zero);
+
+  // Both links have their center of gravity away from their origin
+  std::vector<physics::LinkPtr> links;
+  for (auto const &name : {"surface", "reference"})
+  {
+    physics::ModelPtr model = world->ModelByName(name);
+    ASSERT_TRUE(model != nullptr);
+    physics::LinkPtr link = model->GetLink();
+    ASSERT_TRUE(link != nullptr);
+    link->SetGravityMode(false);
+    link->GetInertial()->SetCoG(0.2, 0, 0);
+    link->UpdateMass();
+    link->SetLinearVel(ignition::math::Vector3d(10, 0, 0));
+    links.push_back(link);
+  }
+
+  physics::LiftDragParams params;
+  params.alpha0 = 0.2;
+  params.cp.Set(0, 1, 0);
+  const uint32_t id = world->ForceField().AddLiftDrag(links[0], params);
+
+  world->Step(1);
+  const ignition::math::Vector3d angularVel = links[0]->WorldAngularVel();
+  world->ForceField().Remove(id);
+
+  // The force the field applied, applied the way the LiftDragPlugin did
+  const double dt = world->Physics()->GetMaxStepSize();
+  const ignition::math::Vector3d force = links[0]->GetInertial()->Mass() *
+      (links[0]->WorldCoGLinearVel() - ignition::math::Vector3d(10, 0, 0)) /
+      dt;
+  EXPECT_GT(force.Length(), 0.0);
+  links[1]->AddForceAtRelativePosition(force, params.cp);
+  world->Step(1);
+
+  EXPECT_GT(angularVel.Length(), 0.0);
+  EXPECT_NEAR(angularVel.X(), links[1]->WorldAngularVel().X(), 1e-6);
+  EXPECT_NEAR(angularVel.Y(), links[1]->WorldAngularVel().Y(), 1e-6);
+  EXPECT_NEAR(angularVel.Z(), links[1]->WorldAngularVel().Z(), 1e-6);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
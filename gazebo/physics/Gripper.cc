@@ -22,13 +22,8 @@
 #include <ignition/math/Helpers.hh>
 #include <ignition/math/Pose3.hh>
 
-#include "gazebo/msgs/msgs.hh"
-
 #include "gazebo/common/Events.hh"
 
-#include "gazebo/transport/Node.hh"
-#include "gazebo/transport/Subscriber.hh"
-
 #include "gazebo/physics/ContactManager.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/Joint.hh"
@@ -46,11 +41,14 @@ using namespace physics;
 /// \brief Private data class for Gripper
 class gazebo::physics::GripperPrivate
 {
-  /// \brief Callback used when the gripper contacts an object.
-  /// \param[in] _msg Message that contains contact information.
-  public: void OnContacts(ConstContactsPtr &_msg);
-
-  /// \brief Update the gripper.
+  /// \brief Callback used when the contacts of the gripper change. It is
+  /// called on the steps the gripper has contacts, and the first step it
+  /// has none.
+  /// \param[in] _contacts Contacts of the gripper collisions.
+  public: void OnContacts(const std::vector<Contact *> &_contacts);
+
+  /// \brief Update the gripper. Connected to the world update only while
+  /// the gripper touches or holds something.
   public: void OnUpdate();
 
   /// \brief Attach an object to the gripper.
@@ -80,12 +78,20 @@ class gazebo::physics::GripperPrivate
   /// \brief The collisions for the links in the gripper.
   public: std::map<std::string, physics::CollisionPtr> collisions;
 
-  /// \brief The current contacts.
-  public: std::vector<msgs::Contact> contacts;
+  /// \brief Number of contacts between moving collisions since the last
+  /// update.
+  public: unsigned int contactCount = 0;
+
+  /// \brief Number of contacts with each collision outside the gripper
+  /// since the last update, by scoped name.
+  public: std::map<std::string, int> objectContacts;
 
-  /// \brief Mutex used to protect reading/writing the contact message.
+  /// \brief Mutex used to protect reading/writing the contacts.
   public: std::mutex mutexContacts;
 
+  /// \brief Identifier of the contact callback, 0 if there is none.
+  public: unsigned int contactCallback = 0;
+
   /// \brief True if the gripper has an object.
   public: bool attached;
 
@@ -124,12 +130,6 @@ class gazebo::physics::GripperPrivate
 
   /// \brief Name of the gripper.
   public: std::string name;
-
-  /// \brief Node for communication.
-  public: transport::NodePtr node;
-
-  /// \brief Subscription to contact messages from the physics engine.
-  public: transport::SubscriberPtr contactSub;
 };
 
 /////////////////////////////////////////////////
@@ -145,18 +145,17 @@ Gripper::Gripper(ModelPtr _model) : dataPtr(new GripperPrivate)
   this->dataPtr->attached = false;
 
   this->dataPtr->updateRate = common::Time(0, common::Time::SecToNano(0.75));
-
-  this->dataPtr->node = transport::NodePtr(new transport::Node());
 }
 
 /////////////////////////////////////////////////
 Gripper::~Gripper()
 {
-  if (this->dataPtr->world && this->dataPtr->world->Running())
+  if (this->dataPtr->contactCallback && this->dataPtr->world &&
+      this->dataPtr->world->Physics())
   {
     physics::ContactManager *mgr =
         this->dataPtr->world->Physics()->GetContactManager();
-    mgr->RemoveFilter(this->Name());
+    mgr->RemoveContactCallback(this->dataPtr->contactCallback);
   }
 
   this->dataPtr->model.reset();
@@ -167,8 +166,6 @@ Gripper::~Gripper()
 /////////////////////////////////////////////////
 void Gripper::Load(sdf::ElementPtr _sdf)
 {
-  this->dataPtr->node->Init(this->dataPtr->world->Name());
-
   this->dataPtr->name = _sdf->Get<std::string>("name");
   this->dataPtr->fixedJoint =
       this->dataPtr->world->Physics()->CreateJoint("fixed",
@@ -212,22 +209,20 @@ void Gripper::Load(sdf::ElementPtr _sdf)
     gripperLinkElem = gripperLinkElem->GetNextElement("gripper_link");
   }
 
-  if (!this->dataPtr->collisions.empty())
+  // The contact manager calls the gripper directly when its collisions
+  // touch something, the gripper is idle otherwise
+  if (!this->dataPtr->collisions.empty() && !this->dataPtr->contactCallback)
   {
-    // request the contact manager to publish messages to a custom topic for
-    // this sensor
+    std::vector<physics::CollisionPtr> collisions;
+    for (auto const &collision : this->dataPtr->collisions)
+      collisions.push_back(collision.second);
+
     physics::ContactManager *mgr =
         this->dataPtr->world->Physics()->GetContactManager();
-    std::string topic = mgr->CreateFilter(this->Name(),
-        this->dataPtr->collisions);
-    if (!this->dataPtr->contactSub)
-    {
-      this->dataPtr->contactSub = this->dataPtr->node->Subscribe(topic,
-          &GripperPrivate::OnContacts, this->dataPtr.get());
-    }
+    this->dataPtr->contactCallback = mgr->AddContactCallback(collisions,
+        std::bind(&GripperPrivate::OnContacts, this->dataPtr.get(),
+          std::placeholders::_1));
   }
-  this->dataPtr->connections.push_back(event::Events::ConnectWorldUpdateEnd(
-          std::bind(&GripperPrivate::OnUpdate, this->dataPtr.get())));
 }
 
 /////////////////////////////////////////////////
@@ -260,7 +255,7 @@ void GripperPrivate::OnUpdate()
   }
 
   // @todo: should package the decision into a function
-  if (this->contacts.size() >= this->minContactCount)
+  if (this->contactCount >= this->minContactCount)
   {
     this->posCount++;
     this->zeroCount = 0;
@@ -282,7 +277,12 @@ void GripperPrivate::OnUpdate()
 
   {
     std::lock_guard<std::mutex> lock(this->mutexContacts);
-    this->contacts.clear();
+    this->contactCount = 0;
+    this->objectContacts.clear();
+
+    // Nothing left to decide until the next contact
+    if (!this->attached && this->posCount == 0)
+      this->connections.clear();
   }
 
   this->prevUpdateTime = common::Time::GetWallTime();
@@ -301,28 +301,14 @@ void GripperPrivate::HandleAttach()
   std::map<std::string, int> contactCounts;
   std::map<std::string, int>::iterator iter;
 
-  // This function is only called from the OnUpdate function so
-  // the call to contacts.clear() is not going to happen in
-  // parallel with the reads in the following code, no mutex
-  // needed.
-  for (unsigned int i = 0; i < this->contacts.size(); ++i)
+  // This function is only called from the OnUpdate function, which
+  // clears the contacts after it, and the contacts are added by the
+  // physics step of the same thread, no mutex needed.
+  contactCounts = this->objectContacts;
+  for (auto const &count : contactCounts)
   {
-    std::string name1 = this->contacts[i].collision1();
-    std::string name2 = this->contacts[i].collision2();
-
-    if (this->collisions.find(name1) == this->collisions.end())
-    {
-      cc[name1] = boost::dynamic_pointer_cast<Collision>(
-          this->world->EntityByName(name1));
-      contactCounts[name1] += 1;
-    }
-
-    if (this->collisions.find(name2) == this->collisions.end())
-    {
-      cc[name2] = boost::dynamic_pointer_cast<Collision>(
-          this->world->EntityByName(name2));
-      contactCounts[name2] += 1;
-    }
+    cc[count.first] = boost::dynamic_pointer_cast<Collision>(
+        this->world->EntityByName(count.first));
   }
 
   iter = contactCounts.begin();
@@ -371,21 +357,37 @@ void GripperPrivate::HandleDetach()
 }
 
 /////////////////////////////////////////////////
-void GripperPrivate::OnContacts(ConstContactsPtr &_msg)
+void GripperPrivate::OnContacts(const std::vector<Contact *> &_contacts)
 {
-  for (int i = 0; i < _msg->contact_size(); ++i)
-  {
-    CollisionPtr collision1 = boost::dynamic_pointer_cast<Collision>(
-        this->world->EntityByName(_msg->contact(i).collision1()));
-    CollisionPtr collision2 = boost::dynamic_pointer_cast<Collision>(
-        this->world->EntityByName(_msg->contact(i).collision2()));
+  std::lock_guard<std::mutex> lock(this->mutexContacts);
 
-    if ((collision1 && !collision1->IsStatic()) &&
-        (collision2 && !collision2->IsStatic()))
+  bool touching = false;
+  for (auto const &contact : _contacts)
+  {
+    if (contact->count == 0 ||
+        !contact->collision1 || contact->collision1->IsStatic() ||
+        !contact->collision2 || contact->collision2->IsStatic())
     {
-      std::lock_guard<std::mutex> lock(this->mutexContacts);
-      this->contacts.push_back(_msg->contact(i));
+      continue;
     }
+
+    touching = true;
+    ++this->contactCount;
+
+    std::string name1 = contact->collision1->GetScopedName();
+    if (this->collisions.find(name1) == this->collisions.end())
+      this->objectContacts[name1] += 1;
+
+    std::string name2 = contact->collision2->GetScopedName();
+    if (this->collisions.find(name2) == this->collisions.end())
+      this->objectContacts[name2] += 1;
+  }
+
+  // Evaluate the grasp while the gripper touches something
+  if (touching && this->connections.empty())
+  {
+    this->connections.push_back(event::Events::ConnectWorldUpdateEnd(
+          std::bind(&GripperPrivate::OnUpdate, this)));
   }
 }
 
@@ -16,7 +16,13 @@
 */
 #include <algorithm>
 #include <cmath>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <set>
+#include <sstream>
 #include <string>
+#include <boost/filesystem.hpp>
 #include <ignition/math/Helpers.hh>
 #include <gazebo/gazebo_config.h>
 
@@ -24,14 +30,43 @@
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Image.hh"
 #include "gazebo/common/CommonIface.hh"
+#include "gazebo/common/Events.hh"
 #include "gazebo/common/SphericalCoordinates.hh"
+#include "gazebo/common/SystemPaths.hh"
+#include "gazebo/physics/Collision.hh"
 #include "gazebo/physics/HeightmapShape.hh"
+#include "gazebo/physics/Model.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/transport/transport.hh"
 
 using namespace gazebo;
 using namespace physics;
 
+/// \brief Period of the tile updates, in simulation seconds.
+static const double kTileUpdatePeriod = 0.1;
+
+//////////////////////////////////////////////////
+/// \brief Use a cached lookup table as the heights of a shape.
+/// \param[in] _cached The cached table.
+/// \param[out] _heights The heights of the shape.
+static void ShareHeights(
+    const std::shared_ptr<const std::vector<float>> &_cached,
+    std::shared_ptr<const std::vector<float>> &_heights)
+{
+  _heights = _cached;
+}
+
+//////////////////////////////////////////////////
+/// \brief Copy a cached lookup table as the double heights of a shape.
+/// \param[in] _cached The cached table.
+/// \param[out] _heights The heights of the shape.
+static void ShareHeights(
+    const std::shared_ptr<const std::vector<float>> &_cached,
+    std::shared_ptr<const std::vector<double>> &_heights)
+{
+  _heights = std::make_shared<const std::vector<double>>(
+      _cached->begin(), _cached->end());
+}
 
 //////////////////////////////////////////////////
 HeightmapShape::HeightmapShape(CollisionPtr _parent)
@@ -48,6 +83,7 @@ HeightmapShape::HeightmapShape(CollisionPtr _parent)
 //////////////////////////////////////////////////
 HeightmapShape::~HeightmapShape()
 {
+  this->updateConnection.reset();
   this->requestSub.reset();
   this->responsePub.reset();
   if (this->node)
@@ -93,6 +129,10 @@ int HeightmapShape::LoadTerrainFile(const std::string &_filename)
   auto demData = dynamic_cast<common::Dem *>(this->heightmapData);
   if (demData)
   {
+    // Only the selected level is read from the DEM cache
+    if (this->sdf->HasElement("gz:dem_level"))
+      demData->SetLevel(this->sdf->Get<unsigned int>("gz:dem_level"));
+
     this->dem = *demData;
     if (this->sdf->HasElement("size"))
     {
@@ -151,15 +191,15 @@ void HeightmapShape::Load(sdf::ElementPtr _sdf)
 {
   Base::Load(_sdf);
 
-  std::string filename = common::find_file(this->sdf->Get<std::string>("uri"));
-  if (filename.empty())
+  this->filename = common::find_file(this->sdf->Get<std::string>("uri"));
+  if (this->filename.empty())
   {
     gzerr << "Unable to find heightmap[" +
              this->sdf->Get<std::string>("uri") + "]\n";
     return;
   }
 
-  if (this->LoadTerrainFile(filename) != 0)
+  if (this->LoadTerrainFile(this->filename) != 0)
   {
     gzerr << "Heightmap data size must be square, with a size of 2^n+1\n";
     return;
@@ -181,6 +221,24 @@ void HeightmapShape::Load(sdf::ElementPtr _sdf)
     }
   }
 
+  this->tileSize = 0;
+  if (this->sdf->HasElement("gz:tile_size"))
+  {
+    unsigned int s = this->sdf->Get<unsigned int>("gz:tile_size");
+    if (s < 2u || s & (s - 1u))
+    {
+      gzerr << "Heightmap tile size must be a power of 2. "
+            << "The heights will not be tiled." << std::endl;
+    }
+    else
+    {
+      this->tileSize = s;
+    }
+  }
+
+  if (this->sdf->HasElement("gz:tile_radius"))
+    this->tileRadius = this->sdf->Get<unsigned int>("gz:tile_radius");
+
   // Check if the geometry of the terrain data matches Ogre constrains
   if (this->heightmapData->GetWidth() != this->heightmapData->GetHeight() ||
       !ignition::math::isPowerOfTwo(this->heightmapData->GetWidth() - 1))
@@ -245,8 +303,156 @@ void HeightmapShape::Init()
   else
     this->scale.Z() = fabs(terrainSize.Z()) / heightmapSizeZ;
 
-  // Construct the heightmap lookup table
-  this->FillHeightfield(this->heights);
+  // Map the tiles, or construct the heightmap lookup table
+  if (this->tileSize > 0 && this->InitTiles())
+  {
+    this->updateConnection = event::Events::ConnectWorldUpdateBegin(
+        std::bind(&HeightmapShape::UpdateTiles, this, std::placeholders::_1));
+  }
+  else if (!this->heights)
+  {
+    // A rendering heightmap of the same terrain in this process uses the
+    // same table.
+    unsigned int level = 0;
+    if (this->sdf->HasElement("gz:dem_level"))
+      level = this->sdf->Get<unsigned int>("gz:dem_level");
+    ShareHeights(common::HeightmapCache::Heights(this->filename, level,
+          *this->heightmapData, this->subSampling, this->vertSize,
+          terrainSize, this->scale, this->flipY), this->heights);
+  }
+}
+
+//////////////////////////////////////////////////
+bool HeightmapShape::InitTiles()
+{
+  // The tile file is named after everything the heights depend on, so a
+  // changed terrain or heightmap element creates a new file.
+  std::ostringstream key;
+  key << std::setprecision(17) << this->filename;
+  try
+  {
+    key << " " << boost::filesystem::last_write_time(this->filename);
+  }
+  catch(const boost::filesystem::filesystem_error &_e)
+  {
+    gzwarn << "Unable to get the modification time of heightmap ["
+           << this->filename << "]: " << _e.what() << std::endl;
+  }
+  key << " " << this->Size() << " " << this->scale << " " << this->subSampling
+      << " " << this->flipY << " " << this->vertSize << " " << this->tileSize;
+
+  boost::filesystem::path dir =
+      boost::filesystem::path(common::SystemPaths::Instance()->GetLogPath()) /
+      "paging" / "heightmaps";
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(dir, ec);
+  if (ec)
+  {
+    gzerr << "Unable to create the heightmap tile directory ["
+          << dir.string() << "]: " << ec.message() << std::endl;
+    return false;
+  }
+
+  std::string tileFilename =
+      (dir / (common::get_sha1<std::string>(key.str()) + ".tiles")).string();
+
+  // Reuse the tiles of a previous run
+  if (this->tiles.Open(tileFilename, this->vertSize, this->tileSize))
+    return true;
+
+  std::vector<float> dense;
+  this->FillHeightfield(dense);
+  if (HeightmapTiles::Write(tileFilename, dense, this->vertSize,
+        this->tileSize) &&
+      this->tiles.Open(tileFilename, this->vertSize, this->tileSize))
+  {
+    return true;
+  }
+
+  gzwarn << "Unable to tile heightmap [" << this->filename
+         << "], the heights will be kept in memory." << std::endl;
+  this->heights = std::make_shared<const std::vector<HeightType>>(
+      dense.begin(), dense.end());
+  return false;
+}
+
+//////////////////////////////////////////////////
+void HeightmapShape::UpdateTiles(const common::UpdateInfo &_info)
+{
+  const double simTime = _info.simTime.Double();
+  if (simTime >= this->tileUpdateTime &&
+      simTime < this->tileUpdateTime + kTileUpdatePeriod)
+  {
+    return;
+  }
+  this->tileUpdateTime = simTime;
+
+  const ignition::math::Pose3d pose = this->collisionParent->WorldPose();
+  const ignition::math::Vector3d size = this->Size();
+  const double last = this->vertSize - 1.0;
+  const int tileCount = static_cast<int>(this->tiles.TileCount());
+  const int radius = static_cast<int>(this->tileRadius);
+
+  std::set<unsigned int> active;
+  for (auto const &model : this->world->Models())
+  {
+    if (model->IsStatic())
+      continue;
+
+    ignition::math::AxisAlignedBox box = model->BoundingBox();
+    if (!std::isfinite(box.Min().X()) || !std::isfinite(box.Max().X()))
+      continue;
+
+    // Vertex range of the model, from the corners of its box in the
+    // heightmap frame.
+    double minCol = std::numeric_limits<double>::max();
+    double maxCol = -std::numeric_limits<double>::max();
+    double minRow = minCol;
+    double maxRow = maxCol;
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+      ignition::math::Vector3d corner(
+          (i & 1u) ? box.Max().X() : box.Min().X(),
+          (i & 2u) ? box.Max().Y() : box.Min().Y(), box.Min().Z());
+      ignition::math::Vector3d local = pose.Rot().RotateVectorReverse(
+          corner - pose.Pos());
+
+      double col = (local.X() / size.X() + 0.5) * last;
+      double row = (local.Y() / size.Y() + 0.5) * last;
+      if (!this->flipY)
+        row = last - row;
+
+      minCol = std::min(minCol, col);
+      maxCol = std::max(maxCol, col);
+      minRow = std::min(minRow, row);
+      maxRow = std::max(maxRow, row);
+    }
+
+    int tx0 = static_cast<int>(std::floor(minCol / this->tileSize)) - radius;
+    int tx1 = static_cast<int>(std::floor(maxCol / this->tileSize)) + radius;
+    int ty0 = static_cast<int>(std::floor(minRow / this->tileSize)) - radius;
+    int ty1 = static_cast<int>(std::floor(maxRow / this->tileSize)) + radius;
+    if (tx1 < 0 || ty1 < 0 || tx0 >= tileCount || ty0 >= tileCount)
+      continue;
+
+    tx0 = std::max(tx0, 0);
+    ty0 = std::max(ty0, 0);
+    tx1 = std::min(tx1, tileCount - 1);
+    ty1 = std::min(ty1, tileCount - 1);
+    for (int ty = ty0; ty <= ty1; ++ty)
+    {
+      for (int tx = tx0; tx <= tx1; ++tx)
+        active.insert(static_cast<unsigned int>(ty * tileCount + tx));
+    }
+  }
+
+  this->tiles.SetActiveTiles(active);
+}
+
+//////////////////////////////////////////////////
+bool HeightmapShape::Tiled() const
+{
+  return this->tiles.IsOpen();
 }
 
 //////////////////////////////////////////////////
@@ -298,8 +504,8 @@ void HeightmapShape::FillHeights(msgs::Geometry &_msg) const
   {
     for (unsigned int x = 0; x < this->vertSize; ++x)
     {
-      int index = (this->vertSize - y - 1) * this->vertSize + x;
-      _msg.mutable_heightmap()->add_heights(this->heights[index]);
+      _msg.mutable_heightmap()->add_heights(
+          this->GetHeight(x, this->vertSize - y - 1));
     }
   }
 }
@@ -319,21 +525,33 @@ ignition::math::Vector2i HeightmapShape::VertexCount() const
 /////////////////////////////////////////////////
 HeightmapShape::HeightType HeightmapShape::GetHeight(int _x, int _y) const
 {
+  if (this->tiles.IsOpen())
+    return this->tiles.Height(_x, _y);
+
   int index =  _y * this->vertSize + _x;
-  if (_x < 0 || _y < 0 || index >= static_cast<int>(this->heights.size()))
+  if (!this->heights || _x < 0 || _y < 0 ||
+      index >= static_cast<int>(this->heights->size()))
+  {
     return 0.0;
+  }
 
-  return this->heights[index];
+  return (*this->heights)[index];
 }
 
 /////////////////////////////////////////////////
 HeightmapShape::HeightType HeightmapShape::GetMaxHeight() const
 {
+  if (this->tiles.IsOpen())
+    return this->tiles.MaxHeight();
+
   HeightType max = -std::numeric_limits<HeightType>::max();
-  for (unsigned int i = 0; i < this->heights.size(); ++i)
+  if (!this->heights)
+    return max;
+
+  for (const HeightType height : *this->heights)
   {
-    if (this->heights[i] > max)
-      max = this->heights[i];
+    if (height > max)
+      max = height;
   }
 
   return max;
@@ -342,11 +560,17 @@ HeightmapShape::HeightType HeightmapShape::GetMaxHeight() const
 /////////////////////////////////////////////////
 HeightmapShape::HeightType HeightmapShape::GetMinHeight() const
 {
+  if (this->tiles.IsOpen())
+    return this->tiles.MinHeight();
+
   HeightType min = std::numeric_limits<HeightType>::max();
-  for (unsigned int i = 0; i < this->heights.size(); ++i)
+  if (!this->heights)
+    return min;
+
+  for (const HeightType height : *this->heights)
   {
-    if (this->heights[i] < min)
-      min = this->heights[i];
+    if (height < min)
+      min = height;
   }
 
   return min;
@@ -17,6 +17,7 @@
 #ifndef GAZEBO_PHYSICS_HEIGHTMAPSHAPE_HH_
 #define GAZEBO_PHYSICS_HEIGHTMAPSHAPE_HH_
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <ignition/transport/Node.hh>
@@ -26,7 +27,9 @@
 #include "gazebo/common/ImageHeightmap.hh"
 #include "gazebo/common/HeightmapData.hh"
 #include "gazebo/common/Dem.hh"
+#include "gazebo/common/UpdateInfo.hh"
 #include "gazebo/transport/TransportTypes.hh"
+#include "gazebo/physics/HeightmapTiles.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/physics/Shape.hh"
 #include "gazebo/util/system.hh"
@@ -42,6 +45,16 @@ namespace gazebo
     /// \brief HeightmapShape collision shape builds a heightmap from
     /// an image.  The supplied image must be square with
     /// N*N+1 pixels per side, where N is an integer.
+    ///
+    /// Large terrains can be split in tiles with the <gz:tile_size> element
+    /// of the <heightmap>, the number of vertices along each side of a tile.
+    /// The heights are then stored in a memory-mapped file in the paging
+    /// directory of the log path, and only the tiles within
+    /// <gz:tile_radius> tiles (default 1) of the non-static models are kept
+    /// in memory.
+    ///
+    /// DEM terrains can be loaded at a lower resolution with the
+    /// <gz:dem_level> element, see common::Dem::SetLevel.
     class GZ_PHYSICS_VISIBLE HeightmapShape : public Shape
     {
       /// \brief height field type, float or double
@@ -114,6 +127,11 @@ namespace gazebo
       /// \return The minimum height.
       public: HeightType GetMinHeight() const;
 
+      /// \brief Get whether the heights are stored in tiles.
+      /// \return True if <gz:tile_size> is set and the tiles are mapped.
+      /// \sa GetHeight
+      public: bool Tiled() const;
+
       /// \brief Get the amount of subsampling.
       /// \return Amount of subsampling.
       public: int GetSubSampling() const;
@@ -131,6 +149,16 @@ namespace gazebo
       /// \return 0 when the operation succeeds to load a file or -1 when fails.
       private: int LoadTerrainFile(const std::string &_filename);
 
+      /// \brief Load the heights in tiles, from the paging directory if
+      /// they were saved by a previous run.
+      /// \return True if the tiles are mapped.
+      private: bool InitTiles();
+
+      /// \brief Activate the tiles near the non-static models, and release
+      /// the others. Called on world update.
+      /// \param[in] _info World update information.
+      private: void UpdateTiles(const common::UpdateInfo &_info);
+
       /// \brief Handle request messages.
       /// \param[in] _msg The request message.
       private: void OnRequest(ConstRequestPtr &_msg);
@@ -143,8 +171,13 @@ namespace gazebo
       /// \brief Version of FillHeightfield() for double vectors.
       public: void FillHeightfield(std::vector<double>& heights);
 
-      /// \brief Lookup table of heights.
-      protected: std::vector<HeightType> heights;
+      /// \brief Lookup table of heights, shared through
+      /// common::HeightmapCache with the other heightmaps of the terrain.
+      /// Null if the heights are tiled.
+      protected: std::shared_ptr<const std::vector<HeightType>> heights;
+
+      /// \brief Heights stored in tiles, used if <gz:tile_size> is set.
+      protected: HeightmapTiles tiles;
 
       /// \brief Image used to generate the heights.
       protected: common::ImageHeightmap img;
@@ -176,6 +209,23 @@ namespace gazebo
       /// \brief Terrain size
       private: ignition::math::Vector3d heightmapSize;
 
+      /// \brief Number of vertices along each side of a tile, 0 to store
+      /// the heights in one array.
+      private: unsigned int tileSize = 0;
+
+      /// \brief Number of tiles kept around each model.
+      private: unsigned int tileRadius = 1;
+
+      /// \brief Simulation time of the last tile update, in seconds.
+      private: double tileUpdateTime = -1.0;
+
+      /// \brief Connection to the world update event, used to update the
+      /// active tiles.
+      private: event::ConnectionPtr updateConnection;
+
+      /// \brief Full path of the file the heights were loaded from.
+      private: std::string filename;
+
       #ifdef HAVE_GDAL
       /// \brief DEM used to generate the heights.
       private: common::Dem dem;
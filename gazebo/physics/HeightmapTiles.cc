@@ -0,0 +1,462 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <mutex>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/MemoryTracker.hh"
+#include "gazebo/physics/HeightmapTiles.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+namespace
+{
+  /// \brief Identifies a tile file.
+  const char kMagic[4] = {'G', 'Z', 'H', 'T'};
+
+  /// \brief Version of the tile file layout.
+  const uint32_t kVersion = 1;
+
+  /// \brief Offset of the first tile. The header is padded so the tiles
+  /// start on a page boundary.
+  const size_t kDataOffset = 4096;
+
+  /// \brief Header at the start of a tile file.
+  struct TileFileHeader
+  {
+    char magic[4];
+    uint32_t version;
+    uint32_t vertSize;
+    uint32_t tileSize;
+    float minHeight;
+    float maxHeight;
+  };
+}
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief Private data for the HeightmapTiles class
+    class HeightmapTilesPrivate
+    {
+      /// \brief Advise the kernel about the pages of a tile.
+      /// \param[in] _tile Index of the tile.
+      /// \param[in] _load True to read the tile ahead, false to release it.
+      public: void Advise(unsigned int _tile, bool _load) const
+      {
+#ifndef _WIN32
+        static const size_t pageSize =
+            static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+        size_t start = kDataOffset + _tile * this->tileBytes;
+        size_t end = start + this->tileBytes;
+
+        // Read ahead every page touching the tile, but only release the
+        // pages that belong to it alone.
+        if (_load)
+        {
+          start = start / pageSize * pageSize;
+          end = std::min((end + pageSize - 1) / pageSize * pageSize,
+              this->mapSize);
+        }
+        else
+        {
+          start = (start + pageSize - 1) / pageSize * pageSize;
+          end = end / pageSize * pageSize;
+        }
+
+        if (end <= start)
+          return;
+
+        madvise(static_cast<char *>(this->map) + start, end - start,
+            _load ? MADV_WILLNEED : MADV_DONTNEED);
+#else
+        (void)_tile;
+        (void)_load;
+#endif
+      }
+
+      /// \brief Release the pages of the tiles that were read ahead.
+      /// \param[in] _bytes Number of bytes to release.
+      public: void Evict(const uint64_t _bytes)
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        uint64_t freed = 0;
+        while (!this->resident.empty() && freed < _bytes)
+        {
+          this->Advise(*this->resident.begin(), false);
+          this->resident.erase(this->resident.begin());
+          freed += this->tileBytes;
+        }
+        *this->memory -= static_cast<int64_t>(freed);
+      }
+
+      /// \brief Start of the mapped file.
+      public: void *map = nullptr;
+
+      /// \brief Size of the mapped file in bytes.
+      public: size_t mapSize = 0;
+
+      /// \brief First tile in the mapped file.
+      public: const float *tiles = nullptr;
+
+      /// \brief Number of vertices along each side of the field.
+      public: unsigned int vertSize = 0;
+
+      /// \brief Number of vertices along each side of a tile.
+      public: unsigned int tileSize = 0;
+
+      /// \brief Number of tiles along each side of the field.
+      public: unsigned int tileCount = 0;
+
+      /// \brief Size of a tile in bytes.
+      public: size_t tileBytes = 0;
+
+      /// \brief Minimum height of the field.
+      public: float minHeight = 0;
+
+      /// \brief Maximum height of the field.
+      public: float maxHeight = 0;
+
+      /// \brief Tiles in use.
+      public: std::set<unsigned int> activeTiles;
+
+      /// \brief Active tiles that were read ahead and not evicted since.
+      public: std::set<unsigned int> resident;
+
+      /// \brief Protects activeTiles and resident, which the evictor
+      /// changes.
+      public: std::mutex mutex;
+
+      /// \brief Bytes of the resident tiles, in the "heightmaps" subsystem
+      /// of the MemoryTracker.
+      public: std::atomic<int64_t> *memory =
+          &common::MemoryTracker::Instance()->Counter("heightmaps");
+
+      /// \brief Id of the evictor of the tiles, -1 while closed.
+      public: int evictor = -1;
+    };
+  }
+}
+
+//////////////////////////////////////////////////
+HeightmapTiles::HeightmapTiles()
+  : dataPtr(new HeightmapTilesPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+HeightmapTiles::~HeightmapTiles()
+{
+  this->Close();
+}
+
+//////////////////////////////////////////////////
+bool HeightmapTiles::Write(const std::string &_filename,
+    const std::vector<float> &_heights, unsigned int _vertSize,
+    unsigned int _tileSize)
+{
+  if (_tileSize == 0 || _heights.size() <
+      static_cast<size_t>(_vertSize) * _vertSize)
+  {
+    gzerr << "Invalid height field for heightmap tiles" << std::endl;
+    return false;
+  }
+
+  std::ofstream out(_filename, std::ios::binary | std::ios::trunc);
+  if (!out)
+  {
+    gzerr << "Unable to write heightmap tiles [" << _filename << "]\n";
+    return false;
+  }
+
+  TileFileHeader header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.vertSize = _vertSize;
+  header.tileSize = _tileSize;
+  header.minHeight = std::numeric_limits<float>::max();
+  header.maxHeight = -std::numeric_limits<float>::max();
+  for (size_t i = 0; i < static_cast<size_t>(_vertSize) * _vertSize; ++i)
+  {
+    header.minHeight = std::min(header.minHeight, _heights[i]);
+    header.maxHeight = std::max(header.maxHeight, _heights[i]);
+  }
+
+  std::vector<char> padding(kDataOffset, 0);
+  std::memcpy(padding.data(), &header, sizeof(header));
+  out.write(padding.data(), padding.size());
+
+  // Store each tile contiguously, so a tile is a range of pages. Tiles on
+  // the far edges are padded with zeros.
+  unsigned int tileCount = (_vertSize + _tileSize - 1) / _tileSize;
+  std::vector<float> tile(static_cast<size_t>(_tileSize) * _tileSize);
+  for (unsigned int ty = 0; ty < tileCount; ++ty)
+  {
+    for (unsigned int tx = 0; tx < tileCount; ++tx)
+    {
+      std::fill(tile.begin(), tile.end(), 0.0f);
+      for (unsigned int y = 0; y < _tileSize; ++y)
+      {
+        unsigned int row = ty * _tileSize + y;
+        if (row >= _vertSize)
+          break;
+
+        unsigned int col = tx * _tileSize;
+        unsigned int count = std::min(_tileSize, _vertSize - col);
+        std::copy_n(_heights.begin() + static_cast<size_t>(row) * _vertSize +
+            col, count, tile.begin() + static_cast<size_t>(y) * _tileSize);
+      }
+      out.write(reinterpret_cast<const char *>(tile.data()),
+          tile.size() * sizeof(float));
+    }
+  }
+
+  if (!out)
+  {
+    gzerr << "Unable to write heightmap tiles [" << _filename << "]\n";
+    return false;
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool HeightmapTiles::Open(const std::string &_filename,
+    unsigned int _vertSize, unsigned int _tileSize)
+{
+  this->Close();
+
+#ifndef _WIN32
+  int fd = open(_filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(kDataOffset))
+  {
+    close(fd);
+    return false;
+  }
+
+  TileFileHeader header;
+  if (pread(fd, &header, sizeof(header), 0) !=
+      static_cast<ssize_t>(sizeof(header)) ||
+      std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      header.version != kVersion || header.vertSize != _vertSize ||
+      header.tileSize != _tileSize || _tileSize == 0)
+  {
+    close(fd);
+    return false;
+  }
+
+  unsigned int tileCount = (_vertSize + _tileSize - 1) / _tileSize;
+  size_t tileBytes = static_cast<size_t>(_tileSize) * _tileSize *
+      sizeof(float);
+  size_t mapSize = kDataOffset +
+      static_cast<size_t>(tileCount) * tileCount * tileBytes;
+  if (static_cast<size_t>(st.st_size) < mapSize)
+  {
+    close(fd);
+    return false;
+  }
+
+  void *map = mmap(nullptr, mapSize, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+  {
+    gzerr << "Unable to map heightmap tiles [" << _filename << "]\n";
+    return false;
+  }
+
+  this->dataPtr->map = map;
+  this->dataPtr->mapSize = mapSize;
+  this->dataPtr->tiles = reinterpret_cast<const float *>(
+      static_cast<const char *>(map) + kDataOffset);
+  this->dataPtr->vertSize = _vertSize;
+  this->dataPtr->tileSize = _tileSize;
+  this->dataPtr->tileCount = tileCount;
+  this->dataPtr->tileBytes = tileBytes;
+  this->dataPtr->minHeight = header.minHeight;
+  this->dataPtr->maxHeight = header.maxHeight;
+
+  // Pages are read on demand, don't read the whole file ahead
+  madvise(map, mapSize, MADV_RANDOM);
+
+  HeightmapTilesPrivate *data = this->dataPtr.get();
+  this->dataPtr->evictor = common::MemoryTracker::Instance()->AddEvictor(
+      "heightmaps", [data](const uint64_t _bytes)
+      {
+        data->Evict(_bytes);
+      });
+
+  return true;
+#else
+  gzwarn << "Heightmap tiles are not supported on this platform\n";
+  return false;
+#endif
+}
+
+//////////////////////////////////////////////////
+void HeightmapTiles::Close()
+{
+  // Unregistered before locking, since the tracker holds its own lock
+  // while the evictor waits for this one
+  if (this->dataPtr->evictor >= 0)
+  {
+    common::MemoryTracker::Instance()->RemoveEvictor(this->dataPtr->evictor);
+    this->dataPtr->evictor = -1;
+  }
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  *this->dataPtr->memory -= static_cast<int64_t>(
+      this->dataPtr->resident.size() * this->dataPtr->tileBytes);
+  this->dataPtr->resident.clear();
+
+#ifndef _WIN32
+  if (this->dataPtr->map)
+    munmap(this->dataPtr->map, this->dataPtr->mapSize);
+#endif
+
+  this->dataPtr->map = nullptr;
+  this->dataPtr->mapSize = 0;
+  this->dataPtr->tiles = nullptr;
+  this->dataPtr->vertSize = 0;
+  this->dataPtr->tileCount = 0;
+  this->dataPtr->activeTiles.clear();
+}
+
+//////////////////////////////////////////////////
+bool HeightmapTiles::IsOpen() const
+{
+  return this->dataPtr->tiles != nullptr;
+}
+
+//////////////////////////////////////////////////
+float HeightmapTiles::Height(int _x, int _y) const
+{
+  const int vertSize = static_cast<int>(this->dataPtr->vertSize);
+  if (_x < 0 || _y < 0 || _x >= vertSize || _y >= vertSize)
+    return 0.0f;
+
+  const unsigned int tileSize = this->dataPtr->tileSize;
+  const unsigned int x = static_cast<unsigned int>(_x);
+  const unsigned int y = static_cast<unsigned int>(_y);
+  const size_t tile = this->TileIndex(x, y);
+
+  return this->dataPtr->tiles[tile * tileSize * tileSize +
+      (y % tileSize) * tileSize + (x % tileSize)];
+}
+
+//////////////////////////////////////////////////
+float HeightmapTiles::MinHeight() const
+{
+  return this->dataPtr->minHeight;
+}
+
+//////////////////////////////////////////////////
+float HeightmapTiles::MaxHeight() const
+{
+  return this->dataPtr->maxHeight;
+}
+
+//////////////////////////////////////////////////
+unsigned int HeightmapTiles::VertSize() const
+{
+  return this->dataPtr->vertSize;
+}
+
+//////////////////////////////////////////////////
+unsigned int HeightmapTiles::TileSize() const
+{
+  return this->dataPtr->tileSize;
+}
+
+//////////////////////////////////////////////////
+unsigned int HeightmapTiles::TileCount() const
+{
+  return this->dataPtr->tileCount;
+}
+
+//////////////////////////////////////////////////
+unsigned int HeightmapTiles::TileIndex(unsigned int _x, unsigned int _y) const
+{
+  return (_y / this->dataPtr->tileSize) * this->dataPtr->tileCount +
+      _x / this->dataPtr->tileSize;
+}
+
+//////////////////////////////////////////////////
+void HeightmapTiles::SetActiveTiles(const std::set<unsigned int> &_tiles)
+{
+  if (!this->IsOpen())
+    return;
+
+  const unsigned int total = this->dataPtr->tileCount *
+      this->dataPtr->tileCount;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  int64_t bytes = 0;
+  for (auto const tile : this->dataPtr->activeTiles)
+  {
+    if (_tiles.find(tile) == _tiles.end())
+    {
+      this->dataPtr->Advise(tile, false);
+      if (this->dataPtr->resident.erase(tile) > 0)
+        bytes -= static_cast<int64_t>(this->dataPtr->tileBytes);
+    }
+  }
+
+  std::set<unsigned int> active;
+  for (auto const tile : _tiles)
+  {
+    if (tile >= total)
+      continue;
+
+    if (this->dataPtr->activeTiles.find(tile) ==
+        this->dataPtr->activeTiles.end())
+    {
+      this->dataPtr->Advise(tile, true);
+      this->dataPtr->resident.insert(tile);
+      bytes += static_cast<int64_t>(this->dataPtr->tileBytes);
+    }
+    active.insert(tile);
+  }
+
+  this->dataPtr->activeTiles = active;
+  *this->dataPtr->memory += bytes;
+}
+
+//////////////////////////////////////////////////
+const std::set<unsigned int> &HeightmapTiles::ActiveTiles() const
+{
+  return this->dataPtr->activeTiles;
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_HEIGHTMAPTILES_HH_
+#define GAZEBO_PHYSICS_HEIGHTMAPTILES_HH_
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class HeightmapTilesPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class HeightmapTiles HeightmapTiles.hh physics/physics.hh
+    /// \brief Height field stored in square tiles in a memory-mapped file.
+    /// Only the tiles that are read, or activated with SetActiveTiles, are
+    /// kept in memory. Tiles that are deactivated are released to the
+    /// operating system, and read again from the file when needed. The
+    /// tiles read ahead count against the "heightmaps" budget of the
+    /// common::MemoryTracker, over which they are released too.
+    class GZ_PHYSICS_VISIBLE HeightmapTiles
+    {
+      /// \brief Constructor.
+      public: HeightmapTiles();
+
+      /// \brief Destructor, unmaps the file.
+      public: virtual ~HeightmapTiles();
+
+      /// \brief Write a height field to a tile file.
+      /// \param[in] _filename Path of the file to write.
+      /// \param[in] _heights Heights of the field, row by row.
+      /// \param[in] _vertSize Number of vertices along each side.
+      /// \param[in] _tileSize Number of vertices along each side of a tile.
+      /// \return True if the file was written.
+      public: static bool Write(const std::string &_filename,
+                  const std::vector<float> &_heights, unsigned int _vertSize,
+                  unsigned int _tileSize);
+
+      /// \brief Map a tile file.
+      /// \param[in] _filename Path of the file written by Write.
+      /// \param[in] _vertSize Expected number of vertices along each side.
+      /// \param[in] _tileSize Expected number of vertices along each side of
+      /// a tile.
+      /// \return False if the file can't be mapped or does not match the
+      /// expected sizes.
+      public: bool Open(const std::string &_filename, unsigned int _vertSize,
+                  unsigned int _tileSize);
+
+      /// \brief Unmap the file.
+      public: void Close();
+
+      /// \brief Get whether a file is mapped.
+      /// \return True if Open succeeded.
+      public: bool IsOpen() const;
+
+      /// \brief Get a height.
+      /// \param[in] _x Column of the vertex.
+      /// \param[in] _y Row of the vertex.
+      /// \return The height, or 0 if the vertex is outside the field.
+      public: float Height(int _x, int _y) const;
+
+      /// \brief Get the minimum height of the field.
+      /// \return The minimum height.
+      public: float MinHeight() const;
+
+      /// \brief Get the maximum height of the field.
+      /// \return The maximum height.
+      public: float MaxHeight() const;
+
+      /// \brief Get the number of vertices along each side of the field.
+      /// \return Number of vertices.
+      public: unsigned int VertSize() const;
+
+      /// \brief Get the number of vertices along each side of a tile.
+      /// \return Number of vertices.
+      public: unsigned int TileSize() const;
+
+      /// \brief Get the number of tiles along each side of the field.
+      /// \return Number of tiles.
+      public: unsigned int TileCount() const;
+
+      /// \brief Get the index of the tile holding a vertex.
+      /// \param[in] _x Column of the vertex.
+      /// \param[in] _y Row of the vertex.
+      /// \return Index of the tile, row by row.
+      public: unsigned int TileIndex(unsigned int _x, unsigned int _y) const;
+
+      /// \brief Set the tiles that are in use. Tiles that were not active
+      /// are read ahead, and tiles that are no longer active are released.
+      /// \param[in] _tiles Indices of the active tiles.
+      public: void SetActiveTiles(const std::set<unsigned int> &_tiles);
+
+      /// \brief Get the tiles that are in use.
+      /// \return Indices of the active tiles.
+      public: const std::set<unsigned int> &ActiveTiles() const;
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<HeightmapTilesPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <set>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/MemoryTracker.hh"
+#include "gazebo/physics/HeightmapTiles.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class HeightmapTilesTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(HeightmapTilesTest, WriteOpen)
+{
+  boost::filesystem::path path =
+    boost::filesystem::temp_directory_path() / "gazebo";
+  boost::filesystem::create_directories(path);
+  path /= "heightmap_tiles_test.tiles";
+
+  // 65 vertices per side do not fill the 16x16 tiles on the far edges
+  const unsigned int vertSize = 65;
+  const unsigned int tileSize = 16;
+  std::vector<float> heights(vertSize * vertSize);
+  for (unsigned int i = 0; i < heights.size(); ++i)
+    heights[i] = static_cast<float>(i % 97) - 10.0f;
+
+  EXPECT_FALSE(physics::HeightmapTiles::Write(path.string(), heights,
+        vertSize, 0));
+  EXPECT_TRUE(physics::HeightmapTiles::Write(path.string(), heights,
+        vertSize, tileSize));
+
+  physics::HeightmapTiles tiles;
+  EXPECT_FALSE(tiles.IsOpen());
+
+  // Sizes must match the file
+  EXPECT_FALSE(tiles.Open(path.string(), vertSize + 1, tileSize));
+  EXPECT_FALSE(tiles.Open(path.string(), vertSize, tileSize * 2));
+  EXPECT_FALSE(tiles.IsOpen());
+
+  ASSERT_TRUE(tiles.Open(path.string(), vertSize, tileSize));
+  EXPECT_TRUE(tiles.IsOpen());
+  EXPECT_EQ(tiles.VertSize(), vertSize);
+  EXPECT_EQ(tiles.TileSize(), tileSize);
+  EXPECT_EQ(tiles.TileCount(), 5u);
+  EXPECT_FLOAT_EQ(tiles.MinHeight(), -10.0f);
+  EXPECT_FLOAT_EQ(tiles.MaxHeight(), 86.0f);
+
+  for (unsigned int y = 0; y < vertSize; ++y)
+  {
+    for (unsigned int x = 0; x < vertSize; ++x)
+      EXPECT_FLOAT_EQ(tiles.Height(x, y), heights[y * vertSize + x]);
+  }
+
+  // Outside the field
+  EXPECT_FLOAT_EQ(tiles.Height(-1, 0), 0.0f);
+  EXPECT_FLOAT_EQ(tiles.Height(0, vertSize), 0.0f);
+
+  EXPECT_EQ(tiles.TileIndex(0, 0), 0u);
+  EXPECT_EQ(tiles.TileIndex(16, 0), 1u);
+  EXPECT_EQ(tiles.TileIndex(64, 64), 24u);
+
+  // Tiles outside the field are ignored
+  tiles.SetActiveTiles({0u, 6u, 25u});
+  EXPECT_EQ(tiles.ActiveTiles(), std::set<unsigned int>({0u, 6u}));
+
+  // Released tiles are read again from the file
+  tiles.SetActiveTiles({24u});
+  EXPECT_EQ(tiles.ActiveTiles(), std::set<unsigned int>({24u}));
+  EXPECT_FLOAT_EQ(tiles.Height(0, 0), heights[0]);
+  EXPECT_FLOAT_EQ(tiles.Height(20, 20), heights[20 * vertSize + 20]);
+
+  tiles.Close();
+  EXPECT_FALSE(tiles.IsOpen());
+  EXPECT_TRUE(tiles.ActiveTiles().empty());
+
+  boost::filesystem::remove(path);
+}
+
+/////////////////////////////////////////////////
+TEST_F(HeightmapTilesTest, Budget)
+{
+  boost::filesystem::path path =
+    boost::filesystem::temp_directory_path() / "gazebo";
+  boost::filesystem::create_directories(path);
+  path /= "heightmap_tiles_budget_test.tiles";
+
+  const unsigned int vertSize = 64;
+  const unsigned int tileSize = 32;
+  const uint64_t tileBytes = tileSize * tileSize * sizeof(float);
+  std::vector<float> heights(vertSize * vertSize, 1.0f);
+  ASSERT_TRUE(physics::HeightmapTiles::Write(path.string(), heights,
+        vertSize, tileSize));
+
+  common::MemoryTracker *tracker = common::MemoryTracker::Instance();
+  const uint64_t before = tracker->Bytes("heightmaps");
+
+  physics::HeightmapTiles tiles;
+  ASSERT_TRUE(tiles.Open(path.string(), vertSize, tileSize));
+
+  // The tiles read ahead are counted
+  tiles.SetActiveTiles({0u, 1u, 2u});
+  EXPECT_EQ(tracker->Bytes("heightmaps"), before + 3 * tileBytes);
+  tiles.SetActiveTiles({1u, 2u, 3u});
+  EXPECT_EQ(tracker->Bytes("heightmaps"), before + 3 * tileBytes);
+
+  // Over budget, tiles are released but stay active and readable
+  tracker->SetBudget("heightmaps", before + tileBytes);
+  EXPECT_EQ(tracker->Enforce(), 2 * tileBytes);
+  EXPECT_EQ(tracker->Bytes("heightmaps"), before + tileBytes);
+  EXPECT_EQ(tiles.ActiveTiles().size(), 3u);
+  EXPECT_FLOAT_EQ(tiles.Height(40, 40), 1.0f);
+  tracker->SetBudget("heightmaps", 0);
+
+  tiles.SetActiveTiles({3u});
+  EXPECT_EQ(tracker->Bytes("heightmaps"), before + tileBytes);
+
+  tiles.Close();
+  EXPECT_EQ(tracker->Bytes("heightmaps"), before);
+
+  boost::filesystem::remove(path);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -15,6 +15,8 @@
  *
 */
 
+#include <mutex>
+
 #include "gazebo/transport/TransportIface.hh"
 #include "gazebo/transport/Publisher.hh"
 
@@ -1178,7 +1180,54 @@ void Joint::SetUpperLimit(const unsigned int _index, const double _limit)
 //////////////////////////////////////////////////
 void Joint::SetProvideFeedback(bool _enable)
 {
-  this->provideFeedback = _enable;
+  this->feedbackEnabled = _enable;
+  this->provideFeedback = _enable || this->feedbackUsers > 0;
+}
+
+//////////////////////////////////////////////////
+void Joint::AddFeedbackUser()
+{
+  // The sensors add users from their own thread
+  std::unique_lock<boost::recursive_mutex> lock;
+  if (this->GetWorld() && this->GetWorld()->Physics())
+  {
+    lock = std::unique_lock<boost::recursive_mutex>(
+        *this->GetWorld()->Physics()->GetPhysicsUpdateMutex());
+  }
+
+  ++this->feedbackUsers;
+
+  // Let the physics engine enable its feedback
+  if (!this->provideFeedback)
+    this->SetProvideFeedback(this->feedbackEnabled);
+}
+
+//////////////////////////////////////////////////
+void Joint::RemoveFeedbackUser()
+{
+  std::unique_lock<boost::recursive_mutex> lock;
+  if (this->GetWorld() && this->GetWorld()->Physics())
+  {
+    lock = std::unique_lock<boost::recursive_mutex>(
+        *this->GetWorld()->Physics()->GetPhysicsUpdateMutex());
+  }
+
+  if (this->feedbackUsers == 0)
+  {
+    gzerr << "Joint[" << this->GetName() << "] has no feedback user\n";
+    return;
+  }
+
+  --this->feedbackUsers;
+
+  if (this->feedbackUsers == 0 && !this->feedbackEnabled)
+    this->SetProvideFeedback(false);
+}
+
+//////////////////////////////////////////////////
+bool Joint::ProvideFeedback() const
+{
+  return this->provideFeedback;
 }
 
 //////////////////////////////////////////////////
@@ -314,7 +314,8 @@ namespace gazebo
       ///
       ///   Note that for ODE you must set
       ///     <provide_feedback>true<provide_feedback>
-      ///   in the joint sdf to use this.
+      ///   in the joint sdf, or register with AddFeedbackUser, to use
+      ///   this.
       ///
       /// \param[in] _index Not used right now
       /// \return The force and torque at the joint, see above for details
@@ -500,10 +501,27 @@ namespace gazebo
       public: virtual void SetUpperLimit(const unsigned int _index,
                                          const double _limit);
 
-      /// \brief Set whether the joint should generate feedback.
+      /// \brief Set whether the joint should generate feedback, as
+      /// <provide_feedback> does. The joint also generates feedback while
+      /// it has feedback users.
       /// \param[in] _enable True to enable joint feedback.
+      /// \sa AddFeedbackUser
       public: virtual void SetProvideFeedback(bool _enable);
 
+      /// \brief Register a user of the force and torque of the joint, such
+      /// as a force torque sensor. The physics engine generates feedback
+      /// while the joint has users, so every call should be matched by a
+      /// call to RemoveFeedbackUser.
+      public: void AddFeedbackUser();
+
+      /// \brief Unregister a user added with AddFeedbackUser.
+      public: void RemoveFeedbackUser();
+
+      /// \brief Get whether the physics engine generates feedback for the
+      /// joint, either because of <provide_feedback> or of a user.
+      /// \return True if GetForceTorque is available.
+      public: bool ProvideFeedback() const;
+
       /// \brief Cache Joint Force Torque Values if necessary for physics engine
       public: virtual void CacheForceTorque();
 
@@ -709,6 +727,12 @@ namespace gazebo
       /// \brief Provide Feedback data for contact forces
       protected: bool provideFeedback;
 
+      /// \brief Whether feedback was enabled by SetProvideFeedback.
+      private: bool feedbackEnabled = false;
+
+      /// \brief Number of feedback users.
+      private: unsigned int feedbackUsers = 0;
+
       /// \brief Names of all the sensors attached to the link.
       private: std::vector<std::string> sensors;
 
@@ -15,6 +15,8 @@
  *
 */
 
+#include <algorithm>
+#include <cmath>
 #include <boost/algorithm/string.hpp>
 
 #include "gazebo/transport/Node.hh"
@@ -57,6 +59,13 @@ JointController::JointController(ModelPtr _model)
   {
     gzerr << "Error advertising service [" << service << "]\n";
   }
+
+  topic = "/" + modelName + "/joint_targets";
+  if (!this->dataPtr->node.Subscribe(topic,
+      &JointController::OnJointTargets, this))
+  {
+    gzerr << "Error subscribing to topic [" << topic << "]\n";
+  }
 }
 
 /////////////////////////////////////////////////
@@ -69,45 +78,89 @@ JointController::~JointController()
 /////////////////////////////////////////////////
 void JointController::AddJoint(JointPtr _joint)
 {
-  this->dataPtr->joints[_joint->GetScopedName()] = _joint;
-  this->dataPtr->posPids[_joint->GetScopedName()].Init(
-      1, 0.1, 0.01, 1, -1, 1000, -1000);
-  this->dataPtr->velPids[_joint->GetScopedName()].Init(
-      1, 0.1, 0.01, 1, -1, 1000, -1000);
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
+
+  const common::PID pid(1, 0.1, 0.01, 1, -1, 1000, -1000);
+  auto iter = this->dataPtr->indices.find(_joint->GetScopedName());
+  if (iter != this->dataPtr->indices.end())
+  {
+    // Adding a joint again replaces it and resets its controllers
+    this->dataPtr->joints[iter->second] = _joint;
+    this->dataPtr->posPids.Set(iter->second, pid);
+    this->dataPtr->velPids.Set(iter->second, pid);
+    return;
+  }
+
+  this->dataPtr->indices[_joint->GetScopedName()] =
+    this->dataPtr->joints.size();
+  this->dataPtr->joints.push_back(_joint);
+  this->dataPtr->posPids.Add(pid);
+  this->dataPtr->velPids.Add(pid);
+  this->dataPtr->forces.push_back(0.0);
+  this->dataPtr->hasForce.push_back(0);
+  this->dataPtr->positions.push_back(0.0);
+  this->dataPtr->hasPosition.push_back(0);
+  this->dataPtr->velocities.push_back(0.0);
+  this->dataPtr->hasVelocity.push_back(0);
+  this->dataPtr->errors.push_back(0.0);
+  this->dataPtr->cmds.push_back(0.0);
 }
 
 /////////////////////////////////////////////////
 void JointController::RemoveJoint(Joint *_joint)
 {
-  if (_joint)
+  if (!_joint)
+    return;
+
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
+
+  auto iter = this->dataPtr->indices.find(_joint->GetScopedName());
+  if (iter == this->dataPtr->indices.end())
+    return;
+
+  // The last joint takes the index of the removed one, as in the banks
+  const size_t index = iter->second;
+  this->dataPtr->indices.erase(iter);
+  this->dataPtr->posPids.Remove(index);
+  this->dataPtr->velPids.Remove(index);
+
+  auto remove = [index](auto &_array)
+  {
+    _array[index] = _array.back();
+    _array.pop_back();
+  };
+  remove(this->dataPtr->joints);
+  remove(this->dataPtr->forces);
+  remove(this->dataPtr->hasForce);
+  remove(this->dataPtr->positions);
+  remove(this->dataPtr->hasPosition);
+  remove(this->dataPtr->velocities);
+  remove(this->dataPtr->hasVelocity);
+  remove(this->dataPtr->errors);
+  remove(this->dataPtr->cmds);
+
+  if (index < this->dataPtr->joints.size())
   {
-    this->dataPtr->joints.erase(_joint->GetScopedName());
-    this->dataPtr->posPids.erase(_joint->GetScopedName());
-    this->dataPtr->velPids.erase(_joint->GetScopedName());
+    this->dataPtr->indices[
+      this->dataPtr->joints[index]->GetScopedName()] = index;
   }
 }
 
 /////////////////////////////////////////////////
 void JointController::Reset()
 {
-  // Reset setpoints and feed-forward.
-  this->dataPtr->positions.clear();
-  this->dataPtr->velocities.clear();
-  this->dataPtr->forces.clear();
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
 
-  std::map<std::string, common::PID>::iterator iter;
-
-  for (iter = this->dataPtr->posPids.begin();
-    iter != this->dataPtr->posPids.end(); ++iter)
-  {
-    iter->second.Reset();
-  }
-
-  for (iter = this->dataPtr->velPids.begin();
-    iter != this->dataPtr->velPids.end(); ++iter)
-  {
-    iter->second.Reset();
-  }
+  // Reset setpoints and feed-forward.
+  std::fill(this->dataPtr->hasForce.begin(),
+      this->dataPtr->hasForce.end(), 0);
+  std::fill(this->dataPtr->hasPosition.begin(),
+      this->dataPtr->hasPosition.end(), 0);
+  std::fill(this->dataPtr->hasVelocity.begin(),
+      this->dataPtr->hasVelocity.end(), 0);
+
+  this->dataPtr->posPids.Reset();
+  this->dataPtr->velPids.Reset();
 }
 
 /////////////////////////////////////////////////
@@ -123,265 +176,261 @@ void JointController::Update()
   // TODO: fix this when World::ResetTime is improved
   if (stepTime > 0)
   {
-    if (!this->dataPtr->forces.empty())
+    std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
+
+    const size_t count = this->dataPtr->joints.size();
+    const double dt = stepTime.Double();
+    double *errors = this->dataPtr->errors.data();
+    double *cmds = this->dataPtr->cmds.data();
+
+    for (size_t i = 0; i < count; ++i)
     {
-      std::map<std::string, double>::iterator iter;
-      for (iter = this->dataPtr->forces.begin();
-          iter != this->dataPtr->forces.end(); ++iter)
-      {
-        this->dataPtr->joints[iter->first]->SetForce(0, iter->second);
-      }
+      if (this->dataPtr->hasForce[i])
+        this->dataPtr->joints[i]->SetForce(0, this->dataPtr->forces[i]);
     }
 
-    if (!this->dataPtr->positions.empty())
+    // Gather the errors of all the joints, update their controllers in
+    // one pass, then apply the commands
+    for (size_t i = 0; i < count; ++i)
     {
-      std::map<std::string, double>::iterator iter;
-
-      for (iter = this->dataPtr->positions.begin();
-           iter != this->dataPtr->positions.end(); ++iter)
-      {
-        double cmd = this->dataPtr->posPids[iter->first].Update(
-            this->dataPtr->joints[iter->first]->Position(0) -
-            iter->second, stepTime);
-        this->dataPtr->joints[iter->first]->SetForce(0, cmd);
-      }
+      errors[i] = this->dataPtr->hasPosition[i] ?
+        this->dataPtr->joints[i]->Position(0) -
+        this->dataPtr->positions[i] : 0.0;
     }
-
-    if (!this->dataPtr->velocities.empty())
+    this->dataPtr->posPids.Update(errors,
+        this->dataPtr->hasPosition.data(), dt, cmds);
+    for (size_t i = 0; i < count; ++i)
     {
-      std::map<std::string, double>::iterator iter;
-
-      for (iter = this->dataPtr->velocities.begin();
-           iter != this->dataPtr->velocities.end(); ++iter)
-      {
-        double cmd = this->dataPtr->velPids[iter->first].Update(
-            this->dataPtr->joints[iter->first]->GetVelocity(0) - iter->second,
-            stepTime);
-        this->dataPtr->joints[iter->first]->SetForce(0, cmd);
-      }
+      if (this->dataPtr->hasPosition[i])
+        this->dataPtr->joints[i]->SetForce(0, cmds[i]);
     }
-  }
 
-  /* enable below if we want to set position kinematically
-  if (this->dataPtr->positions.size() > 0)
-  {
-    std::map<std::string, JointPtr>::iterator iter;
-    for (iter = this->dataPtr->joints.begin();
-         iter != this->dataPtr->joints.end(); ++iter)
+    for (size_t i = 0; i < count; ++i)
+    {
+      errors[i] = this->dataPtr->hasVelocity[i] ?
+        this->dataPtr->joints[i]->GetVelocity(0) -
+        this->dataPtr->velocities[i] : 0.0;
+    }
+    this->dataPtr->velPids.Update(errors,
+        this->dataPtr->hasVelocity.data(), dt, cmds);
+    for (size_t i = 0; i < count; ++i)
     {
-      if (this->dataPtr->positions.find(iter->first) ==
-          this->dataPtr->positions.end())
-      {
-        this->dataPtr->positions[iter->first] =
-          iter->second->Position(0);
-      }
+      if (this->dataPtr->hasVelocity[i])
+        this->dataPtr->joints[i]->SetForce(0, cmds[i]);
     }
-    this->SetJointPositions(this->dataPtr->positions);
-    this->dataPtr->positions.clear();
   }
-  */
 }
 
 /////////////////////////////////////////////////
 bool JointController::OnJointCmdReq(const ignition::msgs::StringMsg &_req,
     ignition::msgs::JointCmd &_rep)
 {
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
+
   const std::string &jointName = _req.data();
   _rep.set_name(jointName);
 
-  if (this->dataPtr->forces.find(jointName) !=
-      this->dataPtr->forces.end())
+  auto iter = this->dataPtr->indices.find(jointName);
+  if (iter == this->dataPtr->indices.end())
+    return true;
+  const size_t index = iter->second;
+
+  if (this->dataPtr->hasForce[index])
   {
-    _rep.mutable_force_optional()->set_data(this->dataPtr->forces[jointName]);
+    _rep.mutable_force_optional()->set_data(this->dataPtr->forces[index]);
   }
 
-  if (this->dataPtr->positions.find(jointName) !=
-      this->dataPtr->positions.end())
+  if (this->dataPtr->hasPosition[index])
   {
     _rep.mutable_position()->mutable_target_optional()->set_data(
-        this->dataPtr->positions[jointName]);
+        this->dataPtr->positions[index]);
   }
 
-  if (this->dataPtr->velocities.find(jointName) !=
-      this->dataPtr->velocities.end())
+  if (this->dataPtr->hasVelocity[index])
   {
     _rep.mutable_velocity()->mutable_target_optional()->set_data(
-        this->dataPtr->velocities[jointName]);
+        this->dataPtr->velocities[index]);
   }
 
-  if (this->dataPtr->posPids.find(jointName) !=
-      this->dataPtr->posPids.end())
+  const common::PID posPid = this->dataPtr->posPids.Get(index);
+  _rep.mutable_position()->mutable_p_gain_optional()->set_data(
+      posPid.GetPGain());
+  _rep.mutable_position()->mutable_d_gain_optional()->set_data(
+      posPid.GetDGain());
+  _rep.mutable_position()->mutable_i_gain_optional()->set_data(
+      posPid.GetIGain());
+
+  const common::PID velPid = this->dataPtr->velPids.Get(index);
+  _rep.mutable_velocity()->mutable_p_gain_optional()->set_data(
+      velPid.GetPGain());
+  _rep.mutable_velocity()->mutable_d_gain_optional()->set_data(
+      velPid.GetDGain());
+  _rep.mutable_velocity()->mutable_i_gain_optional()->set_data(
+      velPid.GetIGain());
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+void JointController::OnJointCommand(const ignition::msgs::JointCmd &_msg)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
+
+  auto iter = this->dataPtr->indices.find(_msg.name());
+  if (iter == this->dataPtr->indices.end())
   {
-    _rep.mutable_position()->mutable_p_gain_optional()->set_data(
-        this->dataPtr->posPids[jointName].GetPGain());
-    _rep.mutable_position()->mutable_d_gain_optional()->set_data(
-        this->dataPtr->posPids[jointName].GetDGain());
-    _rep.mutable_position()->mutable_i_gain_optional()->set_data(
-        this->dataPtr->posPids[jointName].GetIGain());
+    gzerr << "Unable to find joint[" << _msg.name() << "]\n";
+    return;
   }
+  const size_t index = iter->second;
 
-  if (this->dataPtr->velPids.find(jointName) !=
-      this->dataPtr->velPids.end())
+  if (_msg.reset())
   {
-    _rep.mutable_velocity()->mutable_p_gain_optional()->set_data(
-        this->dataPtr->velPids[jointName].GetPGain());
-    _rep.mutable_velocity()->mutable_d_gain_optional()->set_data(
-        this->dataPtr->velPids[jointName].GetDGain());
-    _rep.mutable_velocity()->mutable_i_gain_optional()->set_data(
-        this->dataPtr->velPids[jointName].GetIGain());
+    this->dataPtr->hasForce[index] = 0;
+    this->dataPtr->hasPosition[index] = 0;
+    this->dataPtr->hasVelocity[index] = 0;
   }
 
-  return true;
+  if (_msg.has_force_optional())
+  {
+    this->dataPtr->forces[index] = _msg.force_optional().data();
+    this->dataPtr->hasForce[index] = 1;
+  }
+
+  if (_msg.has_position())
+  {
+    const ignition::msgs::PID &pid = _msg.position();
+    common::PIDBank &bank = this->dataPtr->posPids;
+
+    if (pid.has_target_optional())
+    {
+      this->dataPtr->positions[index] = pid.target_optional().data();
+      this->dataPtr->hasPosition[index] = 1;
+
+      // Commanding a joint wakes the model up.
+      if (this->dataPtr->model)
+        this->dataPtr->model->Wake();
+    }
+    if (pid.has_p_gain_optional())
+      bank.SetPGain(index, pid.p_gain_optional().data());
+    if (pid.has_i_gain_optional())
+      bank.SetIGain(index, pid.i_gain_optional().data());
+    if (pid.has_d_gain_optional())
+      bank.SetDGain(index, pid.d_gain_optional().data());
+    if (pid.has_i_max_optional())
+      bank.SetIMax(index, pid.i_max_optional().data());
+    if (pid.has_i_min_optional())
+      bank.SetIMin(index, pid.i_min_optional().data());
+    if (pid.has_limit_optional())
+    {
+      bank.SetCmdMax(index, pid.limit_optional().data());
+      bank.SetCmdMin(index, -pid.limit_optional().data());
+    }
+  }
+
+  if (_msg.has_velocity())
+  {
+    const ignition::msgs::PID &pid = _msg.velocity();
+    common::PIDBank &bank = this->dataPtr->velPids;
+
+    if (pid.has_target_optional())
+    {
+      this->dataPtr->velocities[index] = pid.target_optional().data();
+      this->dataPtr->hasVelocity[index] = 1;
+
+      // Commanding a joint wakes the model up.
+      if (this->dataPtr->model)
+        this->dataPtr->model->Wake();
+    }
+    if (pid.has_p_gain_optional())
+      bank.SetPGain(index, pid.p_gain_optional().data());
+    if (pid.has_i_gain_optional())
+      bank.SetIGain(index, pid.i_gain_optional().data());
+    if (pid.has_d_gain_optional())
+      bank.SetDGain(index, pid.d_gain_optional().data());
+    if (pid.has_i_max_optional())
+      bank.SetIMax(index, pid.i_max_optional().data());
+    if (pid.has_i_min_optional())
+      bank.SetIMin(index, pid.i_min_optional().data());
+    if (pid.has_limit_optional())
+    {
+      bank.SetCmdMax(index, pid.limit_optional().data());
+      bank.SetCmdMin(index, -pid.limit_optional().data());
+    }
+  }
 }
 
 /////////////////////////////////////////////////
-void JointController::OnJointCommand(const ignition::msgs::JointCmd &_msg)
+void JointController::OnJointTargets(const msgs::JointTargets &_msg)
+{
+  this->SetTargets(_msg);
+}
+
+/////////////////////////////////////////////////
+unsigned int JointController::SetTargets(const msgs::JointTargets &_msg)
 {
-  std::map<std::string, JointPtr>::iterator iter;
-  iter = this->dataPtr->joints.find(_msg.name());
-  if (iter != this->dataPtr->joints.end())
+  const int count = _msg.name_size();
+  if ((_msg.position_size() != 0 && _msg.position_size() != count) ||
+      (_msg.velocity_size() != 0 && _msg.velocity_size() != count) ||
+      (_msg.force_size() != 0 && _msg.force_size() != count))
   {
-    if (_msg.reset())
-    {
-      if (this->dataPtr->forces.find(_msg.name()) !=
-          this->dataPtr->forces.end())
-      {
-        this->dataPtr->forces.erase(this->dataPtr->forces.find(_msg.name()));
-      }
-
-      if (this->dataPtr->positions.find(_msg.name()) !=
-          this->dataPtr->positions.end())
-      {
-        this->dataPtr->positions.erase(
-            this->dataPtr->positions.find(_msg.name()));
-      }
-
-      if (this->dataPtr->velocities.find(_msg.name()) !=
-          this->dataPtr->velocities.end())
-      {
-        this->dataPtr->velocities.erase(
-            this->dataPtr->velocities.find(_msg.name()));
-      }
-    }
+    gzerr << "Joint targets need one value per joint name, or none\n";
+    return 0;
+  }
 
-    if (_msg.has_force_optional())
-      this->dataPtr->forces[_msg.name()] = _msg.force_optional().data();
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
 
-    if (_msg.has_position())
+  unsigned int commanded = 0;
+  for (int i = 0; i < count; ++i)
+  {
+    auto iter = this->dataPtr->indices.find(_msg.name(i));
+    if (iter == this->dataPtr->indices.end())
     {
-      if (_msg.position().has_target_optional())
-      {
-        if (!this->SetPositionTarget(_msg.name(),
-            _msg.position().target_optional().data()))
-        {
-          gzerr << "Unable to set position target for joint["
-            << _msg.name() << "]. Joint is not found.\n";
-        }
-      }
-
-      if (_msg.position().has_p_gain_optional())
-      {
-        this->dataPtr->posPids[_msg.name()].SetPGain(
-            _msg.position().p_gain_optional().data());
-      }
-
-      if (_msg.position().has_i_gain_optional())
-      {
-        this->dataPtr->posPids[_msg.name()].SetIGain(
-            _msg.position().i_gain_optional().data());
-      }
-
-      if (_msg.position().has_d_gain_optional())
-      {
-        this->dataPtr->posPids[_msg.name()].SetDGain(
-            _msg.position().d_gain_optional().data());
-      }
-
-      if (_msg.position().has_i_max_optional())
-      {
-        this->dataPtr->posPids[_msg.name()].SetIMax(
-            _msg.position().i_max_optional().data());
-      }
-
-      if (_msg.position().has_i_min_optional())
-      {
-        this->dataPtr->posPids[_msg.name()].SetIMin(
-            _msg.position().i_min_optional().data());
-      }
-
-      if (_msg.position().has_limit_optional())
-      {
-        this->dataPtr->posPids[_msg.name()].SetCmdMax(
-            _msg.position().limit_optional().data());
-        this->dataPtr->posPids[_msg.name()].SetCmdMin(
-            -_msg.position().limit_optional().data());
-      }
+      gzerr << "Unable to find joint[" << _msg.name(i) << "]\n";
+      continue;
     }
+    const size_t index = iter->second;
 
-    if (_msg.has_velocity())
+    // NaN leaves the target unchanged
+    if (_msg.position_size() != 0 && !std::isnan(_msg.position(i)))
     {
-      if (_msg.velocity().has_target_optional())
-      {
-        if (!this->SetVelocityTarget(_msg.name(),
-            _msg.velocity().target_optional().data()))
-        {
-          gzerr << "Unable to set velocity target for joint["
-            << _msg.name() << "]. Joint is not found.\n";
-        }
-      }
-
-      if (_msg.velocity().has_p_gain_optional())
-      {
-        this->dataPtr->velPids[_msg.name()].SetPGain(
-            _msg.velocity().p_gain_optional().data());
-      }
-
-      if (_msg.velocity().has_i_gain_optional())
-      {
-        this->dataPtr->velPids[_msg.name()].SetIGain(
-            _msg.velocity().i_gain_optional().data());
-      }
-
-      if (_msg.velocity().has_d_gain_optional())
-      {
-        this->dataPtr->velPids[_msg.name()].SetDGain(
-            _msg.velocity().d_gain_optional().data());
-      }
-
-      if (_msg.velocity().has_i_max_optional())
-      {
-        this->dataPtr->velPids[_msg.name()].SetIMax(
-            _msg.velocity().i_max_optional().data());
-      }
-
-      if (_msg.velocity().has_i_min_optional())
-      {
-        this->dataPtr->velPids[_msg.name()].SetIMin(
-            _msg.velocity().i_min_optional().data());
-      }
-
-      if (_msg.velocity().has_limit_optional())
-      {
-        this->dataPtr->velPids[_msg.name()].SetCmdMax(
-            _msg.velocity().limit_optional().data());
-        this->dataPtr->velPids[_msg.name()].SetCmdMin(
-            -_msg.velocity().limit_optional().data());
-      }
+      this->dataPtr->positions[index] = _msg.position(i);
+      this->dataPtr->hasPosition[index] = 1;
     }
+    if (_msg.velocity_size() != 0 && !std::isnan(_msg.velocity(i)))
+    {
+      this->dataPtr->velocities[index] = _msg.velocity(i);
+      this->dataPtr->hasVelocity[index] = 1;
+    }
+    if (_msg.force_size() != 0 && !std::isnan(_msg.force(i)))
+    {
+      this->dataPtr->forces[index] = _msg.force(i);
+      this->dataPtr->hasForce[index] = 1;
+    }
+    ++commanded;
   }
-  else
-    gzerr << "Unable to find joint[" << _msg.name() << "]\n";
+
+  // Commanding a joint wakes the model up.
+  if (commanded > 0 && this->dataPtr->model)
+    this->dataPtr->model->Wake();
+
+  return commanded;
 }
 
 //////////////////////////////////////////////////
 void JointController::SetJointPosition(const std::string & _name,
                                        double _position, int _index)
 {
-  std::map<std::string, JointPtr>::iterator jiter =
-    this->dataPtr->joints.find(_name);
+  JointPtr joint;
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
+    auto iter = this->dataPtr->indices.find(_name);
+    if (iter != this->dataPtr->indices.end())
+      joint = this->dataPtr->joints[iter->second];
+  }
 
-  if (jiter != this->dataPtr->joints.end())
-    this->SetJointPosition(jiter->second, _position, _index);
+  if (joint)
+    this->SetJointPosition(joint, _position, _index);
   else
     gzwarn << "SetJointPosition [" << _name << "] not found\n";
 }
@@ -392,24 +441,23 @@ void JointController::SetJointPositions(
 {
   // go through all joints in this model and update each one
   //   for each joint update, recursively update all children
-  std::map<std::string, JointPtr>::iterator iter;
   std::map<std::string, double>::const_iterator jiter;
 
-  for (iter = this->dataPtr->joints.begin();
-      iter != this->dataPtr->joints.end(); ++iter)
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
+  for (const auto &joint : this->dataPtr->joints)
   {
     // First try name without scope, i.e. joint_name
-    jiter = _jointPositions.find(iter->second->GetName());
+    jiter = _jointPositions.find(joint->GetName());
 
     if (jiter == _jointPositions.end())
     {
       // Second try name with scope, i.e. model_name::joint_name
-      jiter = _jointPositions.find(iter->second->GetScopedName());
+      jiter = _jointPositions.find(joint->GetScopedName());
       if (jiter == _jointPositions.end())
         continue;
     }
 
-    this->SetJointPosition(iter->second, jiter->second);
+    this->SetJointPosition(joint, jiter->second);
   }
 }
 
@@ -429,48 +477,87 @@ common::Time JointController::GetLastUpdateTime() const
 /////////////////////////////////////////////////
 std::map<std::string, JointPtr> JointController::GetJoints() const
 {
-  return this->dataPtr->joints;
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
+
+  std::map<std::string, JointPtr> result;
+  for (const auto &iter : this->dataPtr->indices)
+    result[iter.first] = this->dataPtr->joints[iter.second];
+  return result;
 }
 
 /////////////////////////////////////////////////
 std::map<std::string, common::PID> JointController::GetPositionPIDs() const
 {
-  return this->dataPtr->posPids;
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
+
+  std::map<std::string, common::PID> result;
+  for (const auto &iter : this->dataPtr->indices)
+    result[iter.first] = this->dataPtr->posPids.Get(iter.second);
+  return result;
 }
 
 /////////////////////////////////////////////////
 std::map<std::string, common::PID> JointController::GetVelocityPIDs() const
 {
-  return this->dataPtr->velPids;
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
+
+  std::map<std::string, common::PID> result;
+  for (const auto &iter : this->dataPtr->indices)
+    result[iter.first] = this->dataPtr->velPids.Get(iter.second);
+  return result;
 }
 
 /////////////////////////////////////////////////
 std::map<std::string, double> JointController::GetForces() const
 {
-  return this->dataPtr->forces;
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
+
+  std::map<std::string, double> result;
+  for (const auto &iter : this->dataPtr->indices)
+  {
+    if (this->dataPtr->hasForce[iter.second])
+      result[iter.first] = this->dataPtr->forces[iter.second];
+  }
+  return result;
 }
 
 /////////////////////////////////////////////////
 std::map<std::string, double> JointController::GetPositions() const
 {
-  return this->dataPtr->positions;
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
+
+  std::map<std::string, double> result;
+  for (const auto &iter : this->dataPtr->indices)
+  {
+    if (this->dataPtr->hasPosition[iter.second])
+      result[iter.first] = this->dataPtr->positions[iter.second];
+  }
+  return result;
 }
 
 /////////////////////////////////////////////////
 std::map<std::string, double> JointController::GetVelocities() const
 {
-  return this->dataPtr->velocities;
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
+
+  std::map<std::string, double> result;
+  for (const auto &iter : this->dataPtr->indices)
+  {
+    if (this->dataPtr->hasVelocity[iter.second])
+      result[iter.first] = this->dataPtr->velocities[iter.second];
+  }
+  return result;
 }
 
 //////////////////////////////////////////////////
 void JointController::SetPositionPID(const std::string &_jointName,
                                      const common::PID &_pid)
 {
-  std::map<std::string, JointPtr>::iterator iter;
-  iter = this->dataPtr->joints.find(_jointName);
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
 
-  if (iter != this->dataPtr->joints.end())
-    this->dataPtr->posPids[_jointName] = _pid;
+  auto iter = this->dataPtr->indices.find(_jointName);
+  if (iter != this->dataPtr->indices.end())
+    this->dataPtr->posPids.Set(iter->second, _pid);
   else
     gzerr << "Unable to find joint with name[" << _jointName << "]\n";
 }
@@ -479,27 +566,31 @@ void JointController::SetPositionPID(const std::string &_jointName,
 bool JointController::SetPositionTarget(const std::string &_jointName,
     const double _target)
 {
-  bool result = false;
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
 
-  if (this->dataPtr->posPids.find(_jointName) !=
-      this->dataPtr->posPids.end())
-  {
-    this->dataPtr->positions[_jointName] = _target;
-    result = true;
-  }
+  auto iter = this->dataPtr->indices.find(_jointName);
+  if (iter == this->dataPtr->indices.end())
+    return false;
 
-  return result;
+  this->dataPtr->positions[iter->second] = _target;
+  this->dataPtr->hasPosition[iter->second] = 1;
+
+  // Commanding a joint wakes the model up.
+  if (this->dataPtr->model)
+    this->dataPtr->model->Wake();
+
+  return true;
 }
 
 //////////////////////////////////////////////////
 void JointController::SetVelocityPID(const std::string &_jointName,
                                      const common::PID &_pid)
 {
-  std::map<std::string, JointPtr>::iterator iter;
-  iter = this->dataPtr->joints.find(_jointName);
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
 
-  if (iter != this->dataPtr->joints.end())
-    this->dataPtr->velPids[_jointName] = _pid;
+  auto iter = this->dataPtr->indices.find(_jointName);
+  if (iter != this->dataPtr->indices.end())
+    this->dataPtr->velPids.Set(iter->second, _pid);
   else
     gzerr << "Unable to find joint with name[" << _jointName << "]\n";
 }
@@ -508,30 +599,38 @@ void JointController::SetVelocityPID(const std::string &_jointName,
 bool JointController::SetVelocityTarget(const std::string &_jointName,
     const double _target)
 {
-  bool result = false;
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
 
-  if (this->dataPtr->velPids.find(_jointName) !=
-      this->dataPtr->velPids.end())
-  {
-    this->dataPtr->velocities[_jointName] = _target;
-    result = true;
-  }
+  auto iter = this->dataPtr->indices.find(_jointName);
+  if (iter == this->dataPtr->indices.end())
+    return false;
 
-  return result;
+  this->dataPtr->velocities[iter->second] = _target;
+  this->dataPtr->hasVelocity[iter->second] = 1;
+
+  // Commanding a joint wakes the model up.
+  if (this->dataPtr->model)
+    this->dataPtr->model->Wake();
+
+  return true;
 }
 
 /////////////////////////////////////////////////
 bool JointController::SetForce(const std::string &_jointName,
     const double _force)
 {
-  bool result = false;
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
 
-  if (this->dataPtr->joints.find(_jointName) !=
-      this->dataPtr->joints.end())
-  {
-    this->dataPtr->forces[_jointName] = _force;
-    result = true;
-  }
+  auto iter = this->dataPtr->indices.find(_jointName);
+  if (iter == this->dataPtr->indices.end())
+    return false;
 
-  return result;
+  this->dataPtr->forces[iter->second] = _force;
+  this->dataPtr->hasForce[iter->second] = 1;
+
+  // Commanding a joint wakes the model up.
+  if (this->dataPtr->model)
+    this->dataPtr->model->Wake();
+
+  return true;
 }
@@ -141,6 +141,14 @@ namespace gazebo
       /// set by the user of the JointController.
       public: std::map<std::string, double> GetVelocities() const;
 
+      /// \brief Set the targets of several joints at once, as received on
+      /// the /<model>/joint_targets topic. The message has one position,
+      /// velocity and force per joint name, or none of a kind, and a NaN
+      /// value leaves the target of its joint unchanged.
+      /// \param[in] _msg Targets of the joints, by scoped name.
+      /// \return Number of joints found and commanded.
+      public: unsigned int SetTargets(const msgs::JointTargets &_msg);
+
       /// \brief Callback for service to request the current control parameters.
       /// \param[in] _req The service request. The service expects a joint
       /// name.
@@ -155,6 +163,10 @@ namespace gazebo
       /// \param[in] _msg The received message.
       private: void OnJointCommand(const ignition::msgs::JointCmd &_msg);
 
+      /// \brief Callback when a joint targets message is received.
+      /// \param[in] _msg The received message.
+      private: void OnJointTargets(const msgs::JointTargets &_msg);
+
       /// \brief Set the positions of a Joint by name
       ///        The position is specified in native units, which means,
       ///        if you are using metric system, it's meters for SliderJoint
@@ -17,12 +17,14 @@
 #ifndef _GAZEBO_JOINTCONTROLLER_PRIVATE_HH_
 #define _GAZEBO_JOINTCONTROLLER_PRIVATE_HH_
 
-#include <string>
 #include <map>
+#include <mutex>
+#include <string>
+#include <vector>
 #include <ignition/transport.hh>
 
 #include "gazebo/transport/TransportTypes.hh"
-#include "gazebo/common/PID.hh"
+#include "gazebo/common/PIDBank.hh"
 #include "gazebo/common/Time.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 
@@ -30,6 +32,9 @@ namespace gazebo
 {
   namespace physics
   {
+    /// \brief Private data of JointController. The state of the joints is
+    /// stored in arrays indexed like joints, resolved from the joint names
+    /// once, so that each update runs over the arrays.
     class JointControllerPrivate
     {
       /// \brief Model to control.
@@ -38,23 +43,46 @@ namespace gazebo
       /// \brief List of links that have been updated.
       public: Link_V updatedLinks;
 
-      /// \brief Map of joint names to the joint pointer.
-      public: std::map<std::string, JointPtr> joints;
+      /// \brief The joints, by index.
+      public: std::vector<JointPtr> joints;
+
+      /// \brief Index of each joint, by scoped name.
+      public: std::map<std::string, size_t> indices;
 
-      /// \brief Position PID controllers.
-      public: std::map<std::string, common::PID> posPids;
+      /// \brief Position PID controllers, by joint index.
+      public: common::PIDBank posPids;
 
-      /// \brief Velocity PID controllers.
-      public: std::map<std::string, common::PID> velPids;
+      /// \brief Velocity PID controllers, by joint index.
+      public: common::PIDBank velPids;
 
       /// \brief Forces applied to joints.
-      public: std::map<std::string, double> forces;
+      public: std::vector<double> forces;
+
+      /// \brief 1 for the joints with a force.
+      public: std::vector<unsigned char> hasForce;
+
+      /// \brief Joint position targets.
+      public: std::vector<double> positions;
+
+      /// \brief 1 for the joints with a position target.
+      public: std::vector<unsigned char> hasPosition;
+
+      /// \brief Joint velocity targets.
+      public: std::vector<double> velocities;
+
+      /// \brief 1 for the joints with a velocity target.
+      public: std::vector<unsigned char> hasVelocity;
+
+      /// \brief Errors given to the PID controllers, kept between updates
+      /// to avoid allocations.
+      public: std::vector<double> errors;
 
-      /// \brief Joint positions.
-      public: std::map<std::string, double> positions;
+      /// \brief Commands of the PID controllers.
+      public: std::vector<double> cmds;
 
-      /// \brief Joint velocities.
-      public: std::map<std::string, double> velocities;
+      /// \brief Protects the joints and their state, which commands
+      /// received by transport change while the world updates.
+      public: std::recursive_mutex mutex;
 
       /// \brief Node for communication.
       /// \deprecated See JointControllerPrivate::node.
@@ -16,6 +16,7 @@
 */
 
 #include <gtest/gtest.h>
+#include <limits>
 #include <ignition/math/Pose3.hh>
 #include <ignition/math/Vector3.hh>
 #include <ignition/transport.hh>
@@ -280,6 +281,63 @@ TEST_F(JointControllerTest, SetJointPositions)
   EXPECT_NO_THROW(jointController->SetJointPositions(positions));
 }
 
+/////////////////////////////////////////////////
+TEST_F(JointControllerTest, SetTargets)
+{
+  physics::ModelPtr model(new physics::Model(physics::BasePtr()));
+  physics::JointControllerPtr jointController(
+      new physics::JointController(model));
+
+  physics::JointPtr joint1(new FakeJoint(model));
+  joint1->SetName("joint1");
+  physics::JointPtr joint2(new FakeJoint(model));
+  joint2->SetName("joint2");
+  physics::JointPtr joint3(new FakeJoint(model));
+  joint3->SetName("joint3");
+  jointController->AddJoint(joint1);
+  jointController->AddJoint(joint2);
+  jointController->AddJoint(joint3);
+
+  // NaN leaves a target unset, unknown joints are skipped
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  msgs::JointTargets msg;
+  msg.add_name(joint1->GetScopedName());
+  msg.add_name("my_bad_name");
+  msg.add_name(joint3->GetScopedName());
+  msg.add_position(1.5);
+  msg.add_position(2.0);
+  msg.add_position(nan);
+  msg.add_force(nan);
+  msg.add_force(3.0);
+  msg.add_force(-4.0);
+  EXPECT_EQ(2u, jointController->SetTargets(msg));
+
+  std::map<std::string, double> positions = jointController->GetPositions();
+  EXPECT_EQ(1u, positions.size());
+  EXPECT_DOUBLE_EQ(1.5, positions[joint1->GetScopedName()]);
+  EXPECT_TRUE(jointController->GetVelocities().empty());
+  std::map<std::string, double> forces = jointController->GetForces();
+  EXPECT_EQ(1u, forces.size());
+  EXPECT_DOUBLE_EQ(-4.0, forces[joint3->GetScopedName()]);
+
+  // Arrays which don't match the names are refused
+  msg.add_velocity(1.0);
+  EXPECT_EQ(0u, jointController->SetTargets(msg));
+  EXPECT_TRUE(jointController->GetVelocities().empty());
+
+  // Removing a joint keeps the targets of the others
+  jointController->RemoveJoint(joint1.get());
+  EXPECT_TRUE(jointController->GetPositions().empty());
+  forces = jointController->GetForces();
+  EXPECT_EQ(1u, forces.size());
+  EXPECT_DOUBLE_EQ(-4.0, forces[joint3->GetScopedName()]);
+  EXPECT_EQ(2u, jointController->GetPositionPIDs().size());
+  EXPECT_TRUE(jointController->SetPositionTarget(
+        joint2->GetScopedName(), 0.5));
+  EXPECT_DOUBLE_EQ(0.5, jointController->GetPositions()[
+      joint2->GetScopedName()]);
+}
+
 /////////////////////////////////////////////////
 TEST_F(JointControllerTest, JointCmd)
 {
@@ -214,3 +214,20 @@ void JointState::FillSDF(sdf::ElementPtr _sdf)
     elem->Set((*iter));
   }
 }
+
+/////////////////////////////////////////////////
+void JointState::FillMsg(msgs::JointState &_msg) const
+{
+  _msg.set_name(this->name);
+
+  for (const auto &position : this->positions)
+    _msg.add_position(position);
+}
+
+/////////////////////////////////////////////////
+void JointState::Load(const msgs::JointState &_msg)
+{
+  this->name = _msg.name();
+
+  this->positions.assign(_msg.position().begin(), _msg.position().end());
+}
@@ -21,6 +21,7 @@
 #include <string>
 #include <ignition/math/Angle.hh>
 
+#include "gazebo/msgs/msgs.hh"
 #include "gazebo/physics/State.hh"
 #include "gazebo/util/system.hh"
 
@@ -98,6 +99,14 @@ namespace gazebo
       /// \return True if the values in the state are zero.
       public: bool IsZero() const;
 
+      /// \brief Populate a state message with data from the object.
+      /// \param[out] _msg Message to populate.
+      public: void FillMsg(msgs::JointState &_msg) const;
+
+      /// \brief Load state from a message.
+      /// \param[in] _msg Message to load the state from.
+      public: void Load(const msgs::JointState &_msg);
+
       /// \brief Populate a state SDF element with data from the object.
       /// \param[out] _sdf SDF element to populate.
       public: void FillSDF(sdf::ElementPtr _sdf);
@@ -117,3 +117,23 @@ void LightState::FillSDF(sdf::ElementPtr _sdf)
   _sdf->GetElement("pose")->Set(this->pose);
 }
 
+/////////////////////////////////////////////////
+void LightState::FillMsg(msgs::LightState &_msg) const
+{
+  _msg.set_name(this->name);
+
+  if (this->pose != ignition::math::Pose3d::Zero)
+    msgs::Set(_msg.mutable_pose(), this->pose);
+}
+
+/////////////////////////////////////////////////
+void LightState::Load(const msgs::LightState &_msg)
+{
+  this->name = _msg.name();
+
+  if (_msg.has_pose())
+    this->pose = msgs::ConvertIgn(_msg.pose());
+  else
+    this->pose.Set(0, 0, 0, 0, 0, 0);
+}
+
@@ -21,6 +21,7 @@
 #include <iomanip>
 #include <ignition/math/Pose3.hh>
 
+#include "gazebo/msgs/msgs.hh"
 #include "gazebo/physics/State.hh"
 
 namespace gazebo
@@ -82,6 +83,15 @@ namespace gazebo
       /// \return True if the values in the state are zero.
       public: bool IsZero() const;
 
+      /// \brief Populate a state message with data from the object.
+      /// A zero pose is left unset.
+      /// \param[out] _msg Message to populate.
+      public: void FillMsg(msgs::LightState &_msg) const;
+
+      /// \brief Load state from a message.
+      /// \param[in] _msg Message to load the state from.
+      public: void Load(const msgs::LightState &_msg);
+
       /// \brief Populate a state SDF element with data from the object.
       /// \param[out] _sdf SDF element to populate.
       public: void FillSDF(sdf::ElementPtr _sdf);
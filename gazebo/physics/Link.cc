@@ -30,6 +30,7 @@
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Battery.hh"
+#include "gazebo/common/PowerSystem.hh"
 #include "gazebo/common/SdfFrameSemantics.hh"
 
 #include "gazebo/physics/PhysicsIface.hh"
@@ -103,6 +104,55 @@ class gazebo::physics::LinkPrivate
   /// \brief All the attached batteries.
   public: std::vector<common::BatteryPtr> batteries;
 
+  /// \brief True if the link is swept for continuous collision detection.
+  public: bool continuousCollision = false;
+
+  /// \brief Drop the cached world quantities if they were computed at
+  /// another pose or during another physics update, so that they are
+  /// computed again. cacheMutex must be locked.
+  /// \param[in] _pose Current world pose of the link.
+  /// \param[in] _update Current World::PhysicsUpdateCount.
+  public: void RefreshCache(const ignition::math::Pose3d &_pose,
+              const uint64_t _update)
+  {
+    if (this->cacheUpdate != _update || this->cachePose != _pose)
+    {
+      this->cacheUpdate = _update;
+      this->cachePose = _pose;
+      this->cogPoseCached = false;
+      this->inertialPoseCached = false;
+      this->inertiaMatrixCached = false;
+    }
+  }
+
+  /// \brief World pose the cached quantities were computed at.
+  public: ignition::math::Pose3d cachePose;
+
+  /// \brief Physics update the cached quantities were computed during.
+  public: uint64_t cacheUpdate = 0;
+
+  /// \brief True if cogPose is up to date.
+  public: bool cogPoseCached = false;
+
+  /// \brief True if inertialPose is up to date.
+  public: bool inertialPoseCached = false;
+
+  /// \brief True if inertiaMatrix is up to date.
+  public: bool inertiaMatrixCached = false;
+
+  /// \brief Cached result of Link::WorldCoGPose.
+  public: ignition::math::Pose3d cogPose;
+
+  /// \brief Cached result of Link::WorldInertialPose.
+  public: ignition::math::Pose3d inertialPose;
+
+  /// \brief Cached result of Link::WorldInertiaMatrix.
+  public: ignition::math::Matrix3d inertiaMatrix;
+
+  /// \brief Mutex to protect the cached world quantities, which sensors
+  /// read from their own threads.
+  public: std::mutex cacheMutex;
+
 #ifdef HAVE_OPENAL
       /// \brief All the audio sources
       public: std::vector<util::OpenALSourcePtr> audioSources;
@@ -295,6 +345,13 @@ void Link::Load(sdf::ElementPtr _sdf)
   this->sdf->GetElement("enable_wind")->GetValue()->SetUpdateFunc(
       std::bind(&Link::WindMode, this));
 
+  // Fast links can be swept between steps, see SetContinuousCollision.
+  if (this->sdf->HasElement("gz:continuous_collision"))
+  {
+    this->SetContinuousCollision(
+        this->sdf->Get<bool>("gz:continuous_collision"));
+  }
+
   this->connections.push_back(event::Events::ConnectWorldUpdateBegin(
       std::bind(
       static_cast<void(Link::*)(const common::UpdateInfo &)>(&Link::Update),
@@ -351,6 +408,8 @@ void Link::Fini()
   this->dataPtr->childJoints.clear();
   this->dataPtr->collisions.clear();
   this->inertial.reset();
+  for (auto &battery : this->dataPtr->batteries)
+    this->world->PowerSystem().Remove(battery);
   this->dataPtr->batteries.clear();
 
   // Remove all the sensors attached to the link
@@ -624,12 +683,6 @@ void Link::Update(const common::UpdateInfo & /*_info*/)
       this->ProcessWrenchMsg(it);
     }
   }
-
-  // Update the batteries.
-  for (auto &battery : this->dataPtr->batteries)
-  {
-    battery->Update();
-  }
 }
 
 //////////////////////////////////////////////////
@@ -741,9 +794,17 @@ CollisionPtr Link::GetCollision(unsigned int _index) const
 //////////////////////////////////////////////////
 ignition::math::Pose3d Link::WorldCoGPose() const
 {
-  ignition::math::Pose3d pose = this->WorldPose();
-  pose.Pos() += pose.Rot().RotateVector(this->inertial->CoG());
-  return pose;
+  std::lock_guard<std::mutex> lock(this->dataPtr->cacheMutex);
+  this->dataPtr->RefreshCache(this->WorldPose(), this->world ?
+      this->world->PhysicsUpdateCount() : 0);
+  if (!this->dataPtr->cogPoseCached)
+  {
+    ignition::math::Pose3d pose = this->WorldPose();
+    pose.Pos() += pose.Rot().RotateVector(this->inertial->CoG());
+    this->dataPtr->cogPose = pose;
+    this->dataPtr->cogPoseCached = true;
+  }
+  return this->dataPtr->cogPose;
 }
 
 //////////////////////////////////////////////////
@@ -876,6 +937,25 @@ bool Link::WindMode() const
   return this->sdf->Get<bool>("enable_wind");
 }
 
+//////////////////////////////////////////////////
+void Link::SetContinuousCollision(const bool _enable)
+{
+  if (this->IsStatic() || !this->world || !this->world->Physics())
+    return;
+
+  if (this->world->Physics()->SetLinkContinuousCollision(
+        boost::static_pointer_cast<Link>(shared_from_this()), _enable))
+  {
+    this->dataPtr->continuousCollision = _enable;
+  }
+}
+
+//////////////////////////////////////////////////
+bool Link::ContinuousCollision() const
+{
+  return this->dataPtr->continuousCollision;
+}
+
 //////////////////////////////////////////////////
 bool Link::SetSelected(bool _s)
 {
@@ -896,23 +976,48 @@ void Link::SetInertial(const InertialPtr &/*_inertial*/)
 //////////////////////////////////////////////////
 ignition::math::Pose3d Link::WorldInertialPose() const
 {
-  ignition::math::Pose3d inertialPose;
-  if (this->inertial)
-    inertialPose = this->inertial->Pose();
-  return inertialPose + this->WorldPose();
+  std::lock_guard<std::mutex> lock(this->dataPtr->cacheMutex);
+  this->dataPtr->RefreshCache(this->WorldPose(), this->world ?
+      this->world->PhysicsUpdateCount() : 0);
+  if (!this->dataPtr->inertialPoseCached)
+  {
+    ignition::math::Pose3d inertialPose;
+    if (this->inertial)
+      inertialPose = this->inertial->Pose();
+    this->dataPtr->inertialPose = inertialPose + this->WorldPose();
+    this->dataPtr->inertialPoseCached = true;
+  }
+  return this->dataPtr->inertialPose;
 }
 
 //////////////////////////////////////////////////
 ignition::math::Matrix3d Link::WorldInertiaMatrix() const
 {
-  ignition::math::Matrix3d moi;
-  if (this->inertial)
+  std::lock_guard<std::mutex> lock(this->dataPtr->cacheMutex);
+  this->dataPtr->RefreshCache(this->WorldPose(), this->world ?
+      this->world->PhysicsUpdateCount() : 0);
+  if (!this->dataPtr->inertiaMatrixCached)
   {
-    ignition::math::Vector3d pos = this->inertial->Pose().Pos();
-    ignition::math::Quaterniond rot = this->WorldPose().Rot().Inverse();
-    moi = this->inertial->MOI(ignition::math::Pose3d(pos, rot));
+    ignition::math::Matrix3d moi;
+    if (this->inertial)
+    {
+      ignition::math::Vector3d pos = this->inertial->Pose().Pos();
+      ignition::math::Quaterniond rot = this->WorldPose().Rot().Inverse();
+      moi = this->inertial->MOI(ignition::math::Pose3d(pos, rot));
+    }
+    this->dataPtr->inertiaMatrix = moi;
+    this->dataPtr->inertiaMatrixCached = true;
   }
-  return moi;
+  return this->dataPtr->inertiaMatrix;
+}
+
+//////////////////////////////////////////////////
+void Link::ResetWorldCache()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->cacheMutex);
+  this->dataPtr->cogPoseCached = false;
+  this->dataPtr->inertialPoseCached = false;
+  this->dataPtr->inertiaMatrixCached = false;
 }
 
 //////////////////////////////////////////////////
@@ -1084,6 +1189,7 @@ void Link::ProcessMsg(const msgs::Link &_msg)
   if (_msg.has_inertial())
   {
     this->inertial->ProcessMsg(_msg.inertial());
+    this->ResetWorldCache();
     this->SetEnabled(true);
     // Only update the Center of Mass if object is dynamic
     if (!this->GetKinematic())
@@ -1833,6 +1939,9 @@ void Link::LoadBattery(sdf::ElementPtr _sdf)
   common::BatteryPtr battery(new common::Battery());
   battery->Load(_sdf);
   this->dataPtr->batteries.push_back(battery);
+
+  // The world updates all the batteries at once
+  this->world->PowerSystem().Add(battery);
 }
 
 /////////////////////////////////////////////////
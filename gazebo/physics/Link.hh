@@ -117,6 +117,18 @@ namespace gazebo
       /// \return True if wind is enabled.
       public: virtual bool WindMode() const;
 
+      /// \brief Sweep the link between steps so that it doesn't tunnel
+      /// through thin collisions when it moves further than its own size in
+      /// one step. Only supported by physics engines that implement
+      /// PhysicsEngine::SetLinkContinuousCollision.
+      /// \param[in] _enable True to enable continuous collision detection.
+      public: void SetContinuousCollision(const bool _enable);
+
+      /// \brief Get whether continuous collision detection is enabled.
+      /// \return True if the link is swept between steps.
+      /// \sa SetContinuousCollision
+      public: bool ContinuousCollision() const;
+
       /// \brief Set whether this body will collide with others in the
       /// model.
       /// \sa GetSelfCollide
@@ -332,6 +344,13 @@ namespace gazebo
       /// of zeros if link has no inertia.
       public: ignition::math::Matrix3d WorldInertiaMatrix() const;
 
+      /// \brief Drop the cached values of WorldCoGPose, WorldInertialPose
+      /// and WorldInertiaMatrix. They are computed once per pose and
+      /// physics update, and UpdateMass drops them, so this only needs to be
+      /// called after changing the inertial returned by GetInertial without
+      /// calling UpdateMass.
+      public: void ResetWorldCache();
+
       /// \cond
       /// This is an internal function
       /// \brief Get a collision by id.
@@ -320,6 +320,51 @@ void LinkState::FillSDF(sdf::ElementPtr _sdf)
   // }
 }
 
+/////////////////////////////////////////////////
+void LinkState::FillMsg(msgs::LinkState &_msg) const
+{
+  _msg.set_name(this->name);
+
+  if (this->pose != ignition::math::Pose3d::Zero)
+    msgs::Set(_msg.mutable_pose(), this->pose);
+
+  if (this->RecordVelocity())
+  {
+    if (this->velocity != ignition::math::Pose3d::Zero)
+      msgs::Set(_msg.mutable_velocity(), this->velocity);
+    if (this->acceleration != ignition::math::Pose3d::Zero)
+      msgs::Set(_msg.mutable_acceleration(), this->acceleration);
+    if (this->wrench != ignition::math::Pose3d::Zero)
+      msgs::Set(_msg.mutable_wrench(), this->wrench);
+  }
+}
+
+/////////////////////////////////////////////////
+void LinkState::Load(const msgs::LinkState &_msg)
+{
+  this->name = _msg.name();
+
+  if (_msg.has_pose())
+    this->pose = msgs::ConvertIgn(_msg.pose());
+  else
+    this->pose.Set(0, 0, 0, 0, 0, 0);
+
+  if (_msg.has_velocity())
+    this->velocity = msgs::ConvertIgn(_msg.velocity());
+  else
+    this->velocity.Set(0, 0, 0, 0, 0, 0);
+
+  if (_msg.has_acceleration())
+    this->acceleration = msgs::ConvertIgn(_msg.acceleration());
+  else
+    this->acceleration.Set(0, 0, 0, 0, 0, 0);
+
+  if (_msg.has_wrench())
+    this->wrench = msgs::ConvertIgn(_msg.wrench());
+  else
+    this->wrench.Set(0, 0, 0, 0, 0, 0);
+}
+
 /////////////////////////////////////////////////
 void LinkState::SetWallTime(const common::Time &_time)
 {
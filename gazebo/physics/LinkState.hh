@@ -25,6 +25,7 @@
 #include <ignition/math/Pose3.hh>
 #include <sdf/sdf.hh>
 
+#include "gazebo/msgs/msgs.hh"
 #include "gazebo/physics/State.hh"
 #include "gazebo/physics/CollisionState.hh"
 #include "gazebo/util/system.hh"
@@ -142,6 +143,16 @@ namespace gazebo
       /// \return True if the values in the state are zero.
       public: bool IsZero() const;
 
+      /// \brief Populate a state message with data from the object.
+      /// A zero pose is left unset. Velocity, acceleration and wrench are
+      /// only filled when velocities are recorded, see SetRecordVelocity.
+      /// \param[out] _msg Message to populate.
+      public: void FillMsg(msgs::LinkState &_msg) const;
+
+      /// \brief Load state from a message.
+      /// \param[in] _msg Message to load the state from.
+      public: void Load(const msgs::LinkState &_msg);
+
       /// \brief Populate a state SDF element with data from the object.
       /// \param[out] _sdf SDF element to populate.
       public: void FillSDF(sdf::ElementPtr _sdf);
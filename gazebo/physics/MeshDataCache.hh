@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_MESHDATACACHE_HH_
+#define GAZEBO_PHYSICS_MESHDATACACHE_HH_
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class MeshDataCache MeshDataCache.hh physics/physics.hh
+    /// \brief Cache of the collision data a physics engine builds from a
+    /// mesh, such as its triangle buffers and bounding volume hierarchy.
+    /// Mesh shapes with the same key, see MeshShape::CollisionMeshKey,
+    /// share one instance of the data, which is deleted with the last
+    /// shape that uses it.
+    /// \tparam T Type of the engine collision data.
+    template<typename T>
+    class MeshDataCache
+    {
+      /// \brief Get the data of a key, creating it if no shape uses it.
+      /// \param[in] _key Key of the mesh data.
+      /// \param[in] _create Function creating the data, called if the key
+      /// is not in the cache.
+      /// \return The shared data, or nullptr if _create returned nullptr.
+      public: std::shared_ptr<T> Get(const std::string &_key,
+                  const std::function<std::shared_ptr<T>()> &_create)
+              {
+                std::lock_guard<std::mutex> lock(this->mutex);
+
+                auto iter = this->entries.find(_key);
+                if (iter != this->entries.end())
+                {
+                  std::shared_ptr<T> data = iter->second.lock();
+                  if (data)
+                    return data;
+                }
+
+                std::shared_ptr<T> data = _create();
+                if (!data)
+                  return data;
+
+                // Drop the entries no shape uses anymore
+                for (auto it = this->entries.begin();
+                     it != this->entries.end();)
+                {
+                  if (it->second.expired())
+                    it = this->entries.erase(it);
+                  else
+                    ++it;
+                }
+
+                this->entries[_key] = data;
+                return data;
+              }
+
+      /// \brief Get the number of keys whose data is still in use.
+      /// \return Number of cached keys.
+      public: size_t Size() const
+              {
+                std::lock_guard<std::mutex> lock(this->mutex);
+
+                size_t count = 0;
+                for (auto const &entry : this->entries)
+                {
+                  if (!entry.second.expired())
+                    ++count;
+                }
+                return count;
+              }
+
+      /// \brief Cached data by key.
+      private: std::map<std::string, std::weak_ptr<T>> entries;
+
+      /// \brief Protects the entries, shapes can be created from several
+      /// threads.
+      private: mutable std::mutex mutex;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <memory>
+
+#include "gazebo/physics/MeshDataCache.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class MeshDataCacheTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(MeshDataCacheTest, Share)
+{
+  physics::MeshDataCache<int> cache;
+
+  int created = 0;
+  auto create = [&created]()
+  {
+    return std::make_shared<int>(++created);
+  };
+
+  // Same key, one instance
+  std::shared_ptr<int> a = cache.Get("box.dae|1 1 1", create);
+  std::shared_ptr<int> b = cache.Get("box.dae|1 1 1", create);
+  ASSERT_TRUE(a != nullptr);
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(1, created);
+  EXPECT_EQ(1u, cache.Size());
+
+  // Another scale is another key
+  std::shared_ptr<int> c = cache.Get("box.dae|2 2 2", create);
+  EXPECT_NE(a, c);
+  EXPECT_EQ(2, created);
+  EXPECT_EQ(2u, cache.Size());
+
+  // The data is released with the last user, and created again afterwards
+  a.reset();
+  EXPECT_EQ(2u, cache.Size());
+  b.reset();
+  EXPECT_EQ(1u, cache.Size());
+
+  std::shared_ptr<int> d = cache.Get("box.dae|1 1 1", create);
+  EXPECT_EQ(3, created);
+  EXPECT_EQ(3, *d);
+
+  // Nothing is cached if the data can't be created
+  std::shared_ptr<int> e = cache.Get("missing.dae|1 1 1",
+      []() { return std::shared_ptr<int>(); });
+  EXPECT_TRUE(e == nullptr);
+  EXPECT_EQ(2u, cache.Size());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
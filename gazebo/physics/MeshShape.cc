@@ -14,6 +14,8 @@
  * limitations under the License.
  *
 */
+#include <sstream>
+
 #include <boost/thread/recursive_mutex.hpp>
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Console.hh"
@@ -114,6 +116,29 @@ std::string MeshShape::GetMeshURI() const
   return this->sdf->Get<std::string>("uri");
 }
 
+//////////////////////////////////////////////////
+std::string MeshShape::CollisionMeshKey() const
+{
+  if (!this->mesh)
+    return std::string();
+
+  std::ostringstream key;
+  key.precision(17);
+  key << this->mesh->GetName();
+
+  if (this->submesh)
+  {
+    sdf::ElementPtr submeshElem = this->sdf->GetElement("submesh");
+    key << "|" << submeshElem->Get<std::string>("name")
+        << "|" << submeshElem->Get<bool>("center");
+  }
+
+  auto scale = this->sdf->Get<ignition::math::Vector3d>("scale");
+  key << "|" << scale.X() << " " << scale.Y() << " " << scale.Z();
+
+  return key.str();
+}
+
 //////////////////////////////////////////////////
 void MeshShape::SetMesh(const std::string &_uri,
     const std::string &_submesh, bool _center)
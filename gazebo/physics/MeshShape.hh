@@ -56,6 +56,12 @@ namespace gazebo
       /// \return The URI of the mesh data.
       public: std::string GetMeshURI() const;
 
+      /// \brief Get the key of the collision data of this shape in a
+      /// MeshDataCache. Shapes with the same mesh, submesh and scale have
+      /// the same key, and can share the data of the physics engine.
+      /// \return The key, or an empty string if the mesh is not loaded.
+      public: std::string CollisionMeshKey() const;
+
       /// \brief Set the mesh uri and submesh name.
       /// \param[in] _uri Filename of the mesh file to load from.
       /// \param[in] _submesh Name of the submesh to use within the mesh
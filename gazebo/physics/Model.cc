@@ -55,6 +55,22 @@
 using namespace gazebo;
 using namespace physics;
 
+namespace
+{
+  /// \brief Lock the physics engine of a world, if there is one, for the
+  /// batched state accessors of Model.
+  /// \param[in] _world World of the model.
+  /// \return The lock, which doesn't own a mutex without a physics engine.
+  boost::unique_lock<boost::recursive_mutex> PhysicsLock(
+      const WorldPtr &_world)
+  {
+    if (!_world || !_world->Physics())
+      return boost::unique_lock<boost::recursive_mutex>();
+    return boost::unique_lock<boost::recursive_mutex>(
+        *_world->Physics()->GetPhysicsUpdateMutex());
+  }
+}
+
 //////////////////////////////////////////////////
 Model::Model(BasePtr _parent)
   : Entity(_parent)
@@ -319,12 +335,17 @@ void Model::Init()
   {
     (*iter)->Init();
   }
+
+  // Background models can be stepped at a coarser rate, see
+  // SetStepMultiple.
+  if (this->sdf->HasElement("gz:step_multiple"))
+    this->SetStepMultiple(this->sdf->Get<unsigned int>("gz:step_multiple"));
 }
 
 //////////////////////////////////////////////////
 void Model::Update()
 {
-  if (this->IsStatic())
+  if (this->IsStatic() || this->sleeping)
     return;
 
   boost::recursive_mutex::scoped_lock lock(this->updateMutex);
@@ -338,21 +359,17 @@ void Model::Update()
 
   if (!this->jointAnimations.empty())
   {
-    common::NumericKeyFrame kf(0);
     std::map<std::string, double> jointPositions;
     std::map<std::string, common::NumericAnimationPtr>::iterator iter;
     iter = this->jointAnimations.begin();
     while (iter != this->jointAnimations.end())
     {
-      iter->second->GetInterpolatedKeyFrame(kf);
-
       iter->second->AddTime(
           (this->world->SimTime() - this->prevAnimationTime).Double());
 
       if (iter->second->GetTime() < iter->second->GetLength())
       {
-        iter->second->GetInterpolatedKeyFrame(kf);
-        jointPositions[iter->first] = kf.GetValue();
+        jointPositions[iter->first] = iter->second->InterpolatedValue();
         ++iter;
       }
       else
@@ -380,6 +397,7 @@ void Model::Update()
 void Model::SetJointPosition(
   const std::string &_jointName, double _position, int _index)
 {
+  this->Wake();
   if (this->jointController)
     this->jointController->SetJointPosition(_jointName, _position, _index);
 }
@@ -388,10 +406,200 @@ void Model::SetJointPosition(
 void Model::SetJointPositions(
     const std::map<std::string, double> &_jointPositions)
 {
+  this->Wake();
   if (this->jointController)
     this->jointController->SetJointPositions(_jointPositions);
 }
 
+//////////////////////////////////////////////////
+unsigned int Model::JointDOFCount() const
+{
+  unsigned int count = 0;
+  for (const auto &joint : this->joints)
+    count += joint->DOF();
+  return count;
+}
+
+//////////////////////////////////////////////////
+void Model::JointPositions(std::vector<double> &_positions) const
+{
+  auto lock = PhysicsLock(this->world);
+
+  _positions.resize(this->JointDOFCount());
+  size_t i = 0;
+  for (const auto &joint : this->joints)
+  {
+    for (unsigned int axis = 0; axis < joint->DOF(); ++axis)
+      _positions[i++] = joint->Position(axis);
+  }
+}
+
+//////////////////////////////////////////////////
+void Model::JointVelocities(std::vector<double> &_velocities) const
+{
+  auto lock = PhysicsLock(this->world);
+
+  _velocities.resize(this->JointDOFCount());
+  size_t i = 0;
+  for (const auto &joint : this->joints)
+  {
+    for (unsigned int axis = 0; axis < joint->DOF(); ++axis)
+      _velocities[i++] = joint->GetVelocity(axis);
+  }
+}
+
+//////////////////////////////////////////////////
+void Model::JointForces(std::vector<double> &_forces) const
+{
+  auto lock = PhysicsLock(this->world);
+
+  _forces.resize(this->JointDOFCount());
+  size_t i = 0;
+  for (const auto &joint : this->joints)
+  {
+    for (unsigned int axis = 0; axis < joint->DOF(); ++axis)
+      _forces[i++] = joint->GetForce(axis);
+  }
+}
+
+//////////////////////////////////////////////////
+bool Model::SetJointPositions(const std::vector<double> &_positions)
+{
+  if (_positions.size() != this->JointDOFCount())
+  {
+    gzerr << "Model[" << this->GetScopedName() << "] has "
+          << this->JointDOFCount() << " joint axes, not "
+          << _positions.size() << "\n";
+    return false;
+  }
+
+  auto lock = PhysicsLock(this->world);
+
+  size_t i = 0;
+  for (const auto &joint : this->joints)
+  {
+    for (unsigned int axis = 0; axis < joint->DOF(); ++axis)
+      joint->SetPosition(axis, _positions[i++]);
+  }
+  this->Wake();
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Model::SetJointVelocities(const std::vector<double> &_velocities)
+{
+  if (_velocities.size() != this->JointDOFCount())
+  {
+    gzerr << "Model[" << this->GetScopedName() << "] has "
+          << this->JointDOFCount() << " joint axes, not "
+          << _velocities.size() << "\n";
+    return false;
+  }
+
+  auto lock = PhysicsLock(this->world);
+
+  size_t i = 0;
+  for (const auto &joint : this->joints)
+  {
+    for (unsigned int axis = 0; axis < joint->DOF(); ++axis)
+      joint->SetVelocity(axis, _velocities[i++]);
+  }
+  this->Wake();
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Model::SetJointForces(const std::vector<double> &_forces)
+{
+  if (_forces.size() != this->JointDOFCount())
+  {
+    gzerr << "Model[" << this->GetScopedName() << "] has "
+          << this->JointDOFCount() << " joint axes, not "
+          << _forces.size() << "\n";
+    return false;
+  }
+
+  auto lock = PhysicsLock(this->world);
+
+  size_t i = 0;
+  for (const auto &joint : this->joints)
+  {
+    for (unsigned int axis = 0; axis < joint->DOF(); ++axis)
+      joint->SetForce(axis, _forces[i++]);
+  }
+  this->Wake();
+  return true;
+}
+
+//////////////////////////////////////////////////
+void Model::LinkWorldPoses(std::vector<ignition::math::Pose3d> &_poses) const
+{
+  auto lock = PhysicsLock(this->world);
+
+  _poses.resize(this->links.size());
+  for (size_t i = 0; i < this->links.size(); ++i)
+    _poses[i] = this->links[i]->WorldPose();
+}
+
+//////////////////////////////////////////////////
+void Model::LinkWorldTwists(std::vector<ignition::math::Vector3d> &_linear,
+    std::vector<ignition::math::Vector3d> &_angular) const
+{
+  auto lock = PhysicsLock(this->world);
+
+  _linear.resize(this->links.size());
+  _angular.resize(this->links.size());
+  for (size_t i = 0; i < this->links.size(); ++i)
+  {
+    _linear[i] = this->links[i]->WorldLinearVel();
+    _angular[i] = this->links[i]->WorldAngularVel();
+  }
+}
+
+//////////////////////////////////////////////////
+bool Model::SetLinkWorldPoses(
+    const std::vector<ignition::math::Pose3d> &_poses)
+{
+  if (_poses.size() != this->links.size())
+  {
+    gzerr << "Model[" << this->GetScopedName() << "] has "
+          << this->links.size() << " links, not " << _poses.size() << "\n";
+    return false;
+  }
+
+  auto lock = PhysicsLock(this->world);
+
+  for (size_t i = 0; i < this->links.size(); ++i)
+    this->links[i]->SetWorldPose(_poses[i]);
+  this->Wake();
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Model::SetLinkWorldTwists(
+    const std::vector<ignition::math::Vector3d> &_linear,
+    const std::vector<ignition::math::Vector3d> &_angular)
+{
+  if (_linear.size() != this->links.size() ||
+      _angular.size() != this->links.size())
+  {
+    gzerr << "Model[" << this->GetScopedName() << "] has "
+          << this->links.size() << " links, not " << _linear.size()
+          << " linear and " << _angular.size() << " angular velocities\n";
+    return false;
+  }
+
+  auto lock = PhysicsLock(this->world);
+
+  for (size_t i = 0; i < this->links.size(); ++i)
+  {
+    this->links[i]->SetLinearVel(_linear[i]);
+    this->links[i]->SetAngularVel(_angular[i]);
+  }
+  this->Wake();
+  return true;
+}
+
 //////////////////////////////////////////////////
 void Model::RemoveChild(EntityPtr _child)
 {
@@ -670,6 +878,7 @@ const sdf::ElementPtr Model::UnscaledSDF()
 //////////////////////////////////////////////////
 void Model::Reset()
 {
+  this->Wake();
   Entity::Reset();
 
   this->ResetPhysicsStates();
@@ -707,6 +916,7 @@ void Model::ResetPhysicsStates()
 //////////////////////////////////////////////////
 void Model::SetLinearVel(const ignition::math::Vector3d &_vel)
 {
+  this->Wake();
   for (Link_V::iterator iter = this->links.begin();
        iter != this->links.end(); ++iter)
   {
@@ -721,6 +931,7 @@ void Model::SetLinearVel(const ignition::math::Vector3d &_vel)
 //////////////////////////////////////////////////
 void Model::SetAngularVel(const ignition::math::Vector3d &_vel)
 {
+  this->Wake();
   for (Link_V::iterator iter = this->links.begin();
        iter != this->links.end(); ++iter)
   {
@@ -1103,6 +1314,9 @@ void Model::LoadPlugin(sdf::ElementPtr _sdf)
 
     ModelPtr myself = boost::static_pointer_cast<Model>(shared_from_this());
 
+    // Account the callbacks the plugin connects to it
+    event::ConnectionOwner owner(this->GetScopedName() + "::" + pluginName);
+
     try
     {
       plugin->Load(myself, _sdf);
@@ -1315,6 +1529,8 @@ void Model::DetachStaticModel(const std::string &_modelName)
 //////////////////////////////////////////////////
 void Model::OnPoseChange()
 {
+  this->Wake();
+
   ignition::math::Pose3d p;
   for (unsigned int i = 0; i < this->attachedModels.size(); i++)
   {
@@ -1454,6 +1670,149 @@ bool Model::GetAutoDisable() const
   return this->sdf->Get<bool>("allow_auto_disable");
 }
 
+/////////////////////////////////////////////////
+void Model::SetStepMultiple(const unsigned int _multiple)
+{
+  if (_multiple == 0)
+  {
+    gzerr << "Step multiple of model [" << this->GetScopedName()
+          << "] must be at least 1\n";
+    return;
+  }
+
+  if (this->IsStatic() || !this->world || !this->world->Physics())
+    return;
+
+  if (this->world->Physics()->SetModelStepMultiple(
+        boost::static_pointer_cast<Model>(shared_from_this()), _multiple))
+  {
+    this->stepMultiple = _multiple;
+  }
+}
+
+/////////////////////////////////////////////////
+unsigned int Model::StepMultiple() const
+{
+  return this->stepMultiple;
+}
+
+/////////////////////////////////////////////////
+bool Model::Sleeping() const
+{
+  return this->sleeping;
+}
+
+/////////////////////////////////////////////////
+void Model::Sleep()
+{
+  if (this->sleeping || this->IsStatic())
+    return;
+
+  this->SetEnabledRecursive(false);
+  this->nativeSleep = !this->AnyLinkEnabled();
+  this->sleeping = true;
+}
+
+/////////////////////////////////////////////////
+void Model::Wake()
+{
+  this->idleTime = 0.0;
+  if (!this->sleeping)
+    return;
+
+  this->sleeping = false;
+  this->SetEnabledRecursive(true);
+}
+
+/////////////////////////////////////////////////
+void Model::UpdateSleep(const double _dt, const double _sleepTime,
+    const double _linearThreshold, const double _angularThreshold)
+{
+  if (this->IsStatic())
+    return;
+
+  if (this->sleeping)
+  {
+    // Engines that disable links wake them on contact with awake bodies,
+    // otherwise wake up when the model starts moving.
+    if (this->nativeSleep ? this->AnyLinkEnabled() :
+        !this->Idle(_linearThreshold, _angularThreshold))
+    {
+      this->Wake();
+    }
+    return;
+  }
+
+  if (!this->Idle(_linearThreshold, _angularThreshold))
+  {
+    this->idleTime = 0.0;
+    return;
+  }
+
+  this->idleTime += _dt;
+  if (this->idleTime >= _sleepTime && this->GetAutoDisable())
+    this->Sleep();
+}
+
+/////////////////////////////////////////////////
+bool Model::Idle(const double _linearThreshold,
+    const double _angularThreshold) const
+{
+  for (auto const &link : this->links)
+  {
+    if (link->WorldLinearVel().Length() > _linearThreshold ||
+        link->WorldAngularVel().Length() > _angularThreshold)
+    {
+      return false;
+    }
+  }
+
+  for (auto const &model : this->models)
+  {
+    if (!model->Idle(_linearThreshold, _angularThreshold))
+      return false;
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool Model::AnyLinkEnabled() const
+{
+  for (auto const &link : this->links)
+  {
+    if (link->GetEnabled())
+      return true;
+  }
+
+  for (auto const &model : this->models)
+  {
+    if (model->AnyLinkEnabled())
+      return true;
+  }
+
+  return false;
+}
+
+/////////////////////////////////////////////////
+void Model::SetEnabledRecursive(const bool _enabled)
+{
+  // Zero the velocities before disabling, setting them enables links in
+  // some engines.
+  if (!_enabled)
+  {
+    for (auto const &link : this->links)
+    {
+      link->SetLinearVel(ignition::math::Vector3d::Zero);
+      link->SetAngularVel(ignition::math::Vector3d::Zero);
+    }
+  }
+
+  this->SetEnabled(_enabled);
+  for (auto const &model : this->models)
+    model->SetEnabledRecursive(_enabled);
+}
+
 /////////////////////////////////////////////////
 void Model::SetSelfCollide(bool _self_collide)
 {
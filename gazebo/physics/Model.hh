@@ -262,6 +262,79 @@ namespace gazebo
       public: void SetJointPositions(
                   const std::map<std::string, double> &_jointPositions);
 
+      /// \brief Get the number of degrees of freedom of all the joints,
+      /// the size of the joint state arrays.
+      /// \return Sum of Joint::DOF over GetJoints().
+      public: unsigned int JointDOFCount() const;
+
+      /// \brief Get the positions of all the joints at once, with the
+      /// physics engine locked once. The array holds each axis of each
+      /// joint, in the order of GetJoints().
+      /// \param[out] _positions Joint positions, resized to JointDOFCount.
+      public: void JointPositions(std::vector<double> &_positions) const;
+
+      /// \brief Get the velocities of all the joints at once.
+      /// \sa JointPositions
+      /// \param[out] _velocities Joint velocities, resized to
+      /// JointDOFCount.
+      public: void JointVelocities(std::vector<double> &_velocities) const;
+
+      /// \brief Get the forces applied to all the joints at once.
+      /// \sa JointPositions
+      /// \param[out] _forces Joint forces, resized to JointDOFCount.
+      public: void JointForces(std::vector<double> &_forces) const;
+
+      /// \brief Set the positions of all the joints at once, as
+      /// Joint::SetPosition does for each axis.
+      /// \sa JointPositions
+      /// \param[in] _positions JointDOFCount joint positions.
+      /// \return False if the array doesn't have JointDOFCount values.
+      public: bool SetJointPositions(const std::vector<double> &_positions);
+
+      /// \brief Set the velocities of all the joints at once.
+      /// \sa JointPositions
+      /// \param[in] _velocities JointDOFCount joint velocities.
+      /// \return False if the array doesn't have JointDOFCount values.
+      public: bool SetJointVelocities(const std::vector<double> &_velocities);
+
+      /// \brief Apply forces to all the joints at once, as Joint::SetForce
+      /// does for each axis.
+      /// \sa JointPositions
+      /// \param[in] _forces JointDOFCount joint forces.
+      /// \return False if the array doesn't have JointDOFCount values.
+      public: bool SetJointForces(const std::vector<double> &_forces);
+
+      /// \brief Get the world poses of all the links at once, in the order
+      /// of GetLinks().
+      /// \param[out] _poses Link poses, resized to the number of links.
+      public: void LinkWorldPoses(
+                  std::vector<ignition::math::Pose3d> &_poses) const;
+
+      /// \brief Get the world velocities of the origins of all the links
+      /// at once, in the order of GetLinks().
+      /// \param[out] _linear Linear velocities, resized to the number of
+      /// links.
+      /// \param[out] _angular Angular velocities, resized to the number of
+      /// links.
+      public: void LinkWorldTwists(
+                  std::vector<ignition::math::Vector3d> &_linear,
+                  std::vector<ignition::math::Vector3d> &_angular) const;
+
+      /// \brief Set the world poses of all the links at once.
+      /// \param[in] _poses One pose per link, in the order of GetLinks().
+      /// \return False if the array doesn't have one pose per link.
+      public: bool SetLinkWorldPoses(
+                  const std::vector<ignition::math::Pose3d> &_poses);
+
+      /// \brief Set the world velocities of all the links at once.
+      /// \param[in] _linear One linear velocity per link, in the order of
+      /// GetLinks().
+      /// \param[in] _angular One angular velocity per link.
+      /// \return False if the arrays don't have one value per link.
+      public: bool SetLinkWorldTwists(
+                  const std::vector<ignition::math::Vector3d> &_linear,
+                  const std::vector<ignition::math::Vector3d> &_angular);
+
       /// \brief Joint Animation.
       /// \param[in] _anim Map of joint names to their position animation.
       /// \param[in] _onComplete Callback function for when the animation
@@ -344,6 +417,51 @@ namespace gazebo
       /// \return True if auto disable is allowed for this model.
       public: bool GetAutoDisable() const;
 
+      /// \brief Step the model at a multiple of the world step size. The
+      /// model is integrated once every _multiple world steps, with a
+      /// step size of _multiple times the world step size. While it
+      /// touches or is jointed to a model stepped at a finer rate, it is
+      /// stepped together with that model at the finer rate. Models that
+      /// touch each other should use the same multiple. Only supported by
+      /// physics engines that implement
+      /// PhysicsEngine::SetModelStepMultiple.
+      /// \param[in] _multiple Step multiple, 1 steps at the world rate.
+      public: void SetStepMultiple(const unsigned int _multiple);
+
+      /// \brief Get the step multiple of the model.
+      /// \return Step multiple, 1 when the model steps at the world rate.
+      /// \sa SetStepMultiple
+      public: unsigned int StepMultiple() const;
+
+      /// \brief Check if the model is sleeping. A sleeping model is
+      /// disabled in the physics engine and skipped by Model::Update.
+      /// \return True if the model is sleeping.
+      /// \sa World::SetSleepTime
+      public: bool Sleeping() const;
+
+      /// \brief Put the model to sleep. All links of the model and its
+      /// nested models are disabled and their velocities are zeroed.
+      /// Static models never sleep.
+      public: void Sleep();
+
+      /// \brief Wake up the model if it is sleeping. Models are woken when
+      /// they are commanded, e.g. through SetWorldPose, SetLinearVel or a
+      /// joint controller target, and when the physics engine enables one
+      /// of their links, e.g. on contact with an awake model.
+      public: void Wake();
+
+      /// \brief Update the sleep state of the model, called by the world
+      /// after each physics step when sleeping is enabled. The model goes
+      /// to sleep after its links have been slower than the thresholds for
+      /// _sleepTime seconds, unless <allow_auto_disable> is false.
+      /// \param[in] _dt Duration of the physics step.
+      /// \param[in] _sleepTime Time the model must be idle to sleep.
+      /// \param[in] _linearThreshold Linear velocity threshold.
+      /// \param[in] _angularThreshold Angular velocity threshold.
+      public: void UpdateSleep(const double _dt, const double _sleepTime,
+                  const double _linearThreshold,
+                  const double _angularThreshold);
+
       /// \brief Load all plugins
       ///
       /// Load all plugins specified in the SDF for the model.
@@ -506,6 +624,24 @@ namespace gazebo
       /// \param[in] _name Name of the link to remove.
       private: void RemoveLink(const std::string &_name);
 
+      /// \brief Check if all links of the model and its nested models are
+      /// slower than the thresholds.
+      /// \param[in] _linearThreshold Linear velocity threshold.
+      /// \param[in] _angularThreshold Angular velocity threshold.
+      /// \return True if the model is idle.
+      private: bool Idle(const double _linearThreshold,
+                   const double _angularThreshold) const;
+
+      /// \brief Check if the physics engine enabled any link of the model
+      /// or its nested models.
+      /// \return True if any link is enabled.
+      private: bool AnyLinkEnabled() const;
+
+      /// \brief Enable or disable the links of the model and its nested
+      /// models.
+      /// \param[in] _enabled True to enable the links.
+      private: void SetEnabledRecursive(const bool _enabled);
+
       /// \brief Publish the scale.
       private: virtual void PublishScale();
 
@@ -559,6 +695,19 @@ namespace gazebo
 
       /// \brief SDF Model DOM object
       private: const sdf::Model *modelSDFDom = nullptr;
+
+      /// \brief True if the model is sleeping.
+      private: bool sleeping = false;
+
+      /// \brief True if the physics engine disables links of a sleeping
+      /// model. Otherwise sleeping models are woken by velocity.
+      private: bool nativeSleep = false;
+
+      /// \brief Time the model has been idle.
+      private: double idleTime = 0.0;
+
+      /// \brief Step multiple of the model.
+      private: unsigned int stepMultiple = 1;
     };
     /// \}
   }
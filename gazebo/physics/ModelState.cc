@@ -120,21 +120,39 @@ void ModelState::Load(const ModelPtr _model, const common::Time &_realTime,
   this->pose = _model->WorldPose();
   this->scale = _model->Scale();
 
-  // Load all the links
-  this->linkStates.clear();
-  const Link_V links = _model->GetLinks();
-  for (Link_V::const_iterator iter = links.begin(); iter != links.end(); ++iter)
+  // Load all the links. The states of the last load are updated in place,
+  // and only rebuilt when some link went away.
+  const Link_V &links = _model->GetLinks();
+  for (auto const &link : links)
   {
-    this->linkStates[(*iter)->GetName()].Load(*iter, _realTime, _simTime,
+    this->linkStates[link->GetName()].Load(link, _realTime, _simTime,
         _iterations);
   }
+  if (this->linkStates.size() != links.size())
+  {
+    this->linkStates.clear();
+    for (auto const &link : links)
+    {
+      this->linkStates[link->GetName()].Load(link, _realTime, _simTime,
+          _iterations);
+    }
+  }
 
   // Load all the models
-  this->modelStates.clear();
-  for (const auto &m : _model->NestedModels())
+  const Model_V &models = _model->NestedModels();
+  for (const auto &m : models)
   {
     this->modelStates[m->GetName()].Load(m, _realTime, _simTime, _iterations);
   }
+  if (this->modelStates.size() != models.size())
+  {
+    this->modelStates.clear();
+    for (const auto &m : models)
+    {
+      this->modelStates[m->GetName()].Load(m, _realTime, _simTime,
+          _iterations);
+    }
+  }
 
   // Copy all the joints
   /*const Joint_V joints = _model->GetJoints();
@@ -405,23 +423,10 @@ ModelState &ModelState::operator=(const ModelState &_state)
   this->pose = _state.pose;
   this->scale = _state.scale;
 
-  // Clear the link, joint, and model states.
-  this->linkStates.clear();
+  // Copy the link and model states, reusing the nodes of the maps.
   this->jointStates.clear();
-  this->modelStates.clear();
-
-  // Copy the link states.
-  for (LinkState_M::const_iterator iter =
-       _state.linkStates.begin(); iter != _state.linkStates.end(); ++iter)
-  {
-    this->linkStates.insert(std::make_pair(iter->first, iter->second));
-  }
-
-  // Copy the model states.
-  for (const auto &ms : _state.modelStates)
-  {
-    this->modelStates.insert(std::make_pair(ms.first, ms.second));
-  }
+  this->linkStates = _state.linkStates;
+  this->modelStates = _state.modelStates;
 
   // Copy the joint states.
   // for (JointState_M::const_iterator iter =
@@ -449,10 +454,10 @@ ModelState ModelState::operator-(const ModelState &_state) const
   {
     try
     {
-      if (_state.HasLinkState(iter->second.GetName()))
+      auto other = _state.linkStates.find(iter->first);
+      if (other != _state.linkStates.end())
       {
-        LinkState state = iter->second - _state.GetLinkState(
-            iter->second.GetName());
+        LinkState state = iter->second - other->second;
         if (!state.IsZero())
           result.linkStates.insert(std::make_pair(state.GetName(), state));
       }
@@ -469,10 +474,10 @@ ModelState ModelState::operator-(const ModelState &_state) const
   {
     try
     {
-      if (_state.HasNestedModelState(ms.second.GetName()))
+      auto other = _state.modelStates.find(ms.first);
+      if (other != _state.modelStates.end())
       {
-        ModelState state = ms.second - _state.NestedModelState(
-            ms.second.GetName());
+        ModelState state = ms.second - other->second;
         if (!state.IsZero())
           result.modelStates.insert(std::make_pair(state.GetName(), state));
       }
@@ -610,6 +615,69 @@ void ModelState::FillSDF(sdf::ElementPtr _sdf)
   }
 }
 
+/////////////////////////////////////////////////
+void ModelState::FillMsg(msgs::ModelState &_msg) const
+{
+  _msg.set_name(this->name);
+
+  if (this->pose != ignition::math::Pose3d::Zero)
+    msgs::Set(_msg.mutable_pose(), this->pose);
+
+  if (this->scale != ignition::math::Vector3d::One)
+    msgs::Set(_msg.mutable_scale(), this->scale);
+
+  for (const auto &ls : this->linkStates)
+    ls.second.FillMsg(*_msg.add_link());
+
+  for (const auto &js : this->jointStates)
+    js.second.FillMsg(*_msg.add_joint());
+
+  for (const auto &ms : this->modelStates)
+    ms.second.FillMsg(*_msg.add_model());
+}
+
+/////////////////////////////////////////////////
+void ModelState::Load(const msgs::ModelState &_msg)
+{
+  this->name = _msg.name();
+
+  if (_msg.has_pose())
+    this->pose = msgs::ConvertIgn(_msg.pose());
+  else
+    this->pose.Set(0, 0, 0, 0, 0, 0);
+
+  if (_msg.has_scale())
+    this->scale = msgs::ConvertIgn(_msg.scale());
+  else
+    this->scale.Set(1, 1, 1);
+
+  this->linkStates.clear();
+  for (int i = 0; i < _msg.link_size(); ++i)
+  {
+    LinkState linkState;
+    linkState.Load(_msg.link(i));
+    this->linkStates.insert(std::make_pair(linkState.GetName(), linkState));
+  }
+
+  this->jointStates.clear();
+  for (int i = 0; i < _msg.joint_size(); ++i)
+  {
+    JointState jointState;
+    jointState.Load(_msg.joint(i));
+    this->jointStates.insert(std::make_pair(jointState.GetName(),
+          jointState));
+  }
+
+  this->modelStates.clear();
+  for (int i = 0; i < _msg.model_size(); ++i)
+  {
+    ModelState modelState;
+    modelState.Load(_msg.model(i));
+    this->modelStates.insert(std::make_pair(modelState.GetName(),
+          modelState));
+  }
+}
+
 /////////////////////////////////////////////////
 void ModelState::SetWallTime(const common::Time &_time)
 {
@@ -25,6 +25,7 @@
 #include <ignition/math/Pose3.hh>
 #include <ignition/math/Vector3.hh>
 
+#include "gazebo/msgs/msgs.hh"
 #include "gazebo/physics/State.hh"
 #include "gazebo/physics/LinkState.hh"
 #include "gazebo/physics/JointState.hh"
@@ -199,6 +200,15 @@ namespace gazebo
       /// \return A map of model names to model states.
       public: const ModelState_M &NestedModelStates() const;
 
+      /// \brief Populate a state message with data from the object.
+      /// A zero pose and a unit scale are left unset.
+      /// \param[out] _msg Message to populate.
+      public: void FillMsg(msgs::ModelState &_msg) const;
+
+      /// \brief Load state from a message.
+      /// \param[in] _msg Message to load the state from.
+      public: void Load(const msgs::ModelState &_msg);
+
       /// \brief Populate a state SDF element with data from the object.
       /// \param[out] _sdf SDF element to populate.
       public: void FillSDF(sdf::ElementPtr _sdf);
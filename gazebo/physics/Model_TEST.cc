@@ -242,6 +242,58 @@ TEST_F(ModelTest, BoundingBox)
       model->BoundingBox());
 }
 
+//////////////////////////////////////////////////
+TEST_F(ModelTest, BatchedState)
+{
+  this->Load("worlds/simple_arm.world", true);
+
+  auto world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  auto model = world->ModelByName("simple_arm");
+  ASSERT_TRUE(model != nullptr);
+  ASSERT_FALSE(model->GetJoints().empty());
+
+  // Joint arrays hold each axis of each joint, in order
+  unsigned int dof = 0;
+  for (const auto &joint : model->GetJoints())
+    dof += joint->DOF();
+  EXPECT_EQ(dof, model->JointDOFCount());
+
+  std::vector<double> positions(dof);
+  for (unsigned int i = 0; i < dof; ++i)
+    positions[i] = 0.1 * (i + 1);
+  EXPECT_TRUE(model->SetJointPositions(positions));
+  EXPECT_FALSE(model->SetJointPositions(std::vector<double>(dof + 1)));
+
+  std::vector<double> read;
+  model->JointPositions(read);
+  ASSERT_EQ(dof, read.size());
+  for (unsigned int i = 0; i < dof; ++i)
+    EXPECT_NEAR(positions[i], read[i], 1e-6);
+
+  model->JointVelocities(read);
+  EXPECT_EQ(dof, read.size());
+  EXPECT_FALSE(model->SetJointForces(std::vector<double>()));
+  EXPECT_TRUE(model->SetJointForces(std::vector<double>(dof, 0.0)));
+
+  // Link arrays follow GetLinks
+  const auto &links = model->GetLinks();
+  std::vector<ignition::math::Pose3d> poses;
+  model->LinkWorldPoses(poses);
+  ASSERT_EQ(links.size(), poses.size());
+  for (size_t i = 0; i < links.size(); ++i)
+    EXPECT_EQ(links[i]->WorldPose(), poses[i]);
+
+  std::vector<ignition::math::Vector3d> linear, angular;
+  model->LinkWorldTwists(linear, angular);
+  EXPECT_EQ(links.size(), linear.size());
+  EXPECT_EQ(links.size(), angular.size());
+  EXPECT_FALSE(model->SetLinkWorldTwists(linear, {}));
+  EXPECT_TRUE(model->SetLinkWorldTwists(linear, angular));
+  EXPECT_TRUE(model->SetLinkWorldPoses(poses));
+}
+
 //////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -14,6 +14,10 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <string>
+#include <vector>
+
 #include "gazebo/common/Exception.hh"
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/physics/MultiRayShape.hh"
@@ -189,6 +193,73 @@ void MultiRayShape::Update()
   this->newLaserScans();
 }
 
+//////////////////////////////////////////////////
+void MultiRayShape::UpdateColumns(const unsigned int _first,
+    const unsigned int _count)
+{
+  const unsigned int columns = std::max(this->GetSampleCount(), 1);
+  const unsigned int last = std::min(_first + _count, columns);
+  if (_first >= last)
+    return;
+
+  double fullRange = this->GetMaxRange() - this->GetMinRange();
+
+  // Rays are stored row by row, one row per vertical sample
+  const unsigned int rows = this->rays.size() / columns;
+  this->columnRays.clear();
+  for (unsigned int row = 0; row < rows; ++row)
+  {
+    for (unsigned int i = row * columns + _first; i < row * columns + last;
+         ++i)
+    {
+      this->rays[i]->SetLength(fullRange);
+      this->rays[i]->SetRetro(0.0);
+      this->rays[i]->Update();
+      this->columnRays.push_back(i);
+    }
+  }
+
+  this->UpdateRaySubset(this->columnRays);
+
+  if (last == columns)
+    this->newLaserScans();
+}
+
+//////////////////////////////////////////////////
+void MultiRayShape::UpdateRaySubset(const std::vector<unsigned int> &_rays)
+{
+  std::vector<char> cast(this->rays.size(), 0);
+  for (auto const i : _rays)
+  {
+    if (i < cast.size())
+      cast[i] = 1;
+  }
+
+  // Keep the readings of the rays that are not cast
+  std::vector<double> lengths(this->rays.size());
+  std::vector<double> retros(this->rays.size());
+  std::vector<std::string> names(this->rays.size());
+  for (unsigned int i = 0; i < this->rays.size(); ++i)
+  {
+    if (cast[i])
+      continue;
+    lengths[i] = this->rays[i]->GetLength();
+    retros[i] = this->rays[i]->GetRetro();
+    names[i] = this->rays[i]->CollisionName();
+  }
+
+  this->UpdateRays();
+
+  for (unsigned int i = 0; i < this->rays.size(); ++i)
+  {
+    if (cast[i])
+      continue;
+    this->rays[i]->SetLength(lengths[i]);
+    this->rays[i]->SetRetro(retros[i]);
+    this->rays[i]->SetCollisionName(names[i]);
+  }
+}
+
 //////////////////////////////////////////////////
 bool MultiRayShape::SetRay(const unsigned int _rayIndex,
     const ignition::math::Vector3d &_start,
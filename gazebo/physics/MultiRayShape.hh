@@ -127,6 +127,15 @@ namespace gazebo
       /// \brief Update the ray collisions.
       public: void Update();
 
+      /// \brief Update the collisions of the rays of some horizontal
+      /// samples only, every vertical sample included. The other rays keep
+      /// their readings. The new laser scans event is signaled when the
+      /// columns end at the last horizontal sample.
+      /// \param[in] _first Index of the first horizontal sample.
+      /// \param[in] _count Number of horizontal samples.
+      public: void UpdateColumns(const unsigned int _first,
+                  const unsigned int _count);
+
       /// \TODO This function is not implemented.
       /// \brief Fill a message with this shape's values.
       /// \param[out] _msg Message that contains the shape's values.
@@ -153,6 +162,14 @@ namespace gazebo
       /// \sa explicit MultiRayShape(PhysicsEnginePtr _physicsEngine)
       public: virtual void UpdateRays() = 0;
 
+      /// \brief Method for updating some of the rays. The default
+      /// implementation updates every ray with UpdateRays and restores the
+      /// readings of the other rays, engines override it to only cast the
+      /// given rays.
+      /// \param[in] _rays Indices of the rays to update.
+      public: virtual void UpdateRaySubset(
+                  const std::vector<unsigned int> &_rays);
+
       /// \brief Add a ray to the collision.
       /// \param[in] _start Start of the ray.
       /// \param[in] _end End of the ray.
@@ -203,6 +220,10 @@ namespace gazebo
       /// \brief New laser scans event.
       protected: event::EventT<void()> newLaserScans;
 
+      /// \brief Indices of the rays updated by UpdateColumns, reused
+      /// across calls.
+      private: std::vector<unsigned int> columnRays;
+
       /// \brief Min range of a ray
       private: double minRange = 0;
 
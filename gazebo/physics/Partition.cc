@@ -0,0 +1,754 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/physics/Partition.hh"
+#include "gazebo/transport/Node.hh"
+#include "gazebo/transport/Publisher.hh"
+#include "gazebo/transport/Subscriber.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+namespace
+{
+  /// \brief Time between two checks of the peers while waiting for them,
+  /// after which the last state of the region is sent again.
+  const std::chrono::milliseconds kWaitPeriod(100);
+
+  /// \brief Time after which a warning names the peers waited for.
+  const std::chrono::seconds kWarnPeriod(5);
+
+  /// \brief Remove the plugins and sensors of a model and of its nested
+  /// models, so that its ghost doesn't act on the world.
+  /// \param[in] _model The model element.
+  void StripGhost(const sdf::ElementPtr &_model)
+  {
+    while (_model->HasElement("plugin"))
+      _model->RemoveChild(_model->GetElement("plugin"));
+
+    sdf::ElementPtr link = _model->HasElement("link") ?
+        _model->GetElement("link") : sdf::ElementPtr();
+    for (; link; link = link->GetNextElement("link"))
+    {
+      while (link->HasElement("sensor"))
+        link->RemoveChild(link->GetElement("sensor"));
+    }
+
+    sdf::ElementPtr nested = _model->HasElement("model") ?
+        _model->GetElement("model") : sdf::ElementPtr();
+    for (; nested; nested = nested->GetNextElement("model"))
+      StripGhost(nested);
+  }
+
+  /// \brief Wrap the SDF of a model into an SDF document, at the current
+  /// pose of the model.
+  /// \param[in] _model The model.
+  /// \return The document.
+  std::string ModelDocument(const ModelPtr &_model)
+  {
+    sdf::ElementPtr elem = _model->GetSDF()->Clone();
+    elem->GetElement("pose")->Set(_model->WorldPose());
+    return std::string("<sdf version='") + SDF_VERSION + "'>" +
+        elem->ToString("") + "</sdf>";
+  }
+}
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \brief Last state received from a peer.
+    class PartitionPeer
+    {
+      /// \brief True once a message has been received.
+      public: bool known = false;
+
+      /// \brief Iterations simulated by the peer.
+      public: uint64_t iterations = 0;
+
+      /// \brief Box owned by the peer.
+      public: ignition::math::AxisAlignedBox box;
+
+      /// \brief Ghosts of the last message, by name.
+      public: std::map<std::string, msgs::Partition::Model> ghosts;
+
+      /// \brief SDF of the ghosts of the peer, kept while they are sent
+      /// since it is only sent until the region acknowledges it.
+      public: std::map<std::string, std::string> ghostSdf;
+
+      /// \brief Models handed over to the region in the last message,
+      /// acknowledged so that the peer stops sending them.
+      public: std::set<std::string> migrated;
+
+      /// \brief Models of the region the peer acknowledged receiving.
+      public: std::set<std::string> acknowledged;
+
+      /// \brief Ghosts of the region whose SDF the peer acknowledged.
+      public: std::set<std::string> mirrored;
+    };
+
+    /// \brief A model handed over by a peer.
+    class PartitionMigration
+    {
+      /// \brief The model, as sent by the peer.
+      public: msgs::Partition::Model model;
+
+      /// \brief True once the model has been inserted.
+      public: bool inserted = false;
+    };
+
+    /// \internal
+    /// \brief Private data for the Partition class.
+    class PartitionPrivate
+    {
+      /// \brief Constructor.
+      /// \param[in] _world World simulating the region.
+      public: explicit PartitionPrivate(World &_world)
+              : world(_world)
+              {
+              }
+
+      /// \brief Receive the state of a region.
+      /// \param[in] _msg The state.
+      public: void OnPartition(ConstPartitionPtr &_msg);
+
+      /// \brief Wait until every peer has simulated an iteration.
+      /// \param[in] _iterations The iteration.
+      public: void WaitForPeers(const uint64_t _iterations);
+
+      /// \brief Insert the models handed over by the peers, once their
+      /// ghosts are gone.
+      public: void ApplyMigrations();
+
+      /// \brief Insert, move and remove the ghosts of the models of the
+      /// peers.
+      public: void ApplyGhosts();
+
+      /// \brief Insert the ghost of a model of a peer.
+      /// \param[in] _ghost The model.
+      /// \param[in] _sdf SDF document of the model.
+      public: void InsertGhost(const msgs::Partition::Model &_ghost,
+                  const std::string &_sdf);
+
+      /// \brief The world.
+      public: World &world;
+
+      /// \brief Name of the region.
+      public: std::string region;
+
+      /// \brief Box owned by the region.
+      public: ignition::math::AxisAlignedBox box;
+
+      /// \brief Names of the peers.
+      public: std::vector<std::string> peers;
+
+      /// \brief Distance to the boundary under which the models of the
+      /// region are mirrored by the peers.
+      public: double ghostMargin = 1.0;
+
+      /// \brief Node of the exchanges with the peers.
+      public: transport::NodePtr node;
+
+      /// \brief Publisher of the state of the region.
+      public: transport::PublisherPtr pub;
+
+      /// \brief Subscriber to the states of the regions.
+      public: transport::SubscriberPtr sub;
+
+      /// \brief Protects the members below, up to the world thread ones.
+      public: mutable std::mutex mutex;
+
+      /// \brief Notified when a peer state is received.
+      public: std::condition_variable condition;
+
+      /// \brief State of the peers, by name.
+      public: std::map<std::string, PartitionPeer> peerStates;
+
+      /// \brief True when the ghosts of a peer changed since they were
+      /// last applied.
+      public: bool ghostsChanged = false;
+
+      /// \brief Models handed over by the peers, not inserted yet.
+      public: std::vector<msgs::Partition::Model> incoming;
+
+      /// \brief Names of the ghosts inserted in the world.
+      public: std::set<std::string> ghostNames;
+
+      /// \brief True when Fini has been called.
+      public: bool stop = false;
+
+      /// \brief True once the models owned by the peers have been
+      /// removed. Only used by the world thread, as the members below.
+      public: bool started = false;
+
+      /// \brief Models handed over by the peers, being inserted.
+      public: std::vector<PartitionMigration> migrations;
+
+      /// \brief Models handed over to the peers, as sent, by name. They
+      /// are kept as kinematic ghosts until their target acknowledges
+      /// them.
+      public: std::map<std::string, msgs::Partition::Model> handovers;
+
+      /// \brief Last state published, sent again while waiting for the
+      /// peers so that they learn about the region.
+      public: msgs::Partition lastMsg;
+    };
+  }
+}
+
+/////////////////////////////////////////////////
+Partition::Partition(World &_world)
+  : dataPtr(new PartitionPrivate(_world))
+{
+}
+
+/////////////////////////////////////////////////
+Partition::~Partition()
+{
+  this->Fini();
+}
+
+/////////////////////////////////////////////////
+bool Partition::Load(const sdf::ElementPtr &_sdf)
+{
+  if (!_sdf->HasElement("region"))
+  {
+    gzerr << "<gz:partition> has no <region>, the world isn't "
+          << "partitioned.\n";
+    return false;
+  }
+  this->dataPtr->region = _sdf->Get<std::string>("region");
+
+  const ignition::math::Vector3d min = _sdf->HasElement("min") ?
+      _sdf->Get<ignition::math::Vector3d>("min") :
+      ignition::math::Vector3d::Zero;
+  const ignition::math::Vector3d max = _sdf->HasElement("max") ?
+      _sdf->Get<ignition::math::Vector3d>("max") :
+      ignition::math::Vector3d::Zero;
+  if (!(min.X() < max.X() && min.Y() < max.Y() && min.Z() < max.Z()))
+  {
+    gzerr << "Region[" << this->dataPtr->region << "] needs a <min> "
+          << "smaller than its <max>, the world isn't partitioned.\n";
+    return false;
+  }
+  this->dataPtr->box = ignition::math::AxisAlignedBox(min, max);
+
+  if (_sdf->HasElement("ghost_margin"))
+  {
+    this->dataPtr->ghostMargin =
+        std::max(0.0, _sdf->Get<double>("ghost_margin"));
+  }
+
+  sdf::ElementPtr peerElem = _sdf->HasElement("peer") ?
+      _sdf->GetElement("peer") : sdf::ElementPtr();
+  for (; peerElem; peerElem = peerElem->GetNextElement("peer"))
+  {
+    const std::string peer = peerElem->Get<std::string>();
+    if (peer.empty() || peer == this->dataPtr->region)
+      continue;
+    this->dataPtr->peers.push_back(peer);
+    this->dataPtr->peerStates[peer];
+  }
+
+  this->dataPtr->lastMsg.set_region(this->dataPtr->region);
+  this->dataPtr->lastMsg.set_iterations(0);
+  msgs::Set(this->dataPtr->lastMsg.mutable_min(), min);
+  msgs::Set(this->dataPtr->lastMsg.mutable_max(), max);
+
+  this->dataPtr->node = transport::NodePtr(new transport::Node());
+  this->dataPtr->node->Init(this->dataPtr->world.Name());
+  // Migrations are lost if the queue overflows, so it is long
+  this->dataPtr->pub = this->dataPtr->node->Advertise<msgs::Partition>(
+      "~/partition", 1000);
+  this->dataPtr->sub = this->dataPtr->node->Subscribe("~/partition",
+      &PartitionPrivate::OnPartition, this->dataPtr.get());
+
+  gzmsg << "World[" << this->dataPtr->world.Name() << "] simulates region["
+        << this->dataPtr->region << "] " << min << " to " << max << " with "
+        << this->dataPtr->peers.size() << " peers.\n";
+  return true;
+}
+
+/////////////////////////////////////////////////
+std::string Partition::Region() const
+{
+  return this->dataPtr->region;
+}
+
+/////////////////////////////////////////////////
+ignition::math::AxisAlignedBox Partition::Box() const
+{
+  return this->dataPtr->box;
+}
+
+/////////////////////////////////////////////////
+std::vector<std::string> Partition::Peers() const
+{
+  return this->dataPtr->peers;
+}
+
+/////////////////////////////////////////////////
+bool Partition::IsGhost(const std::string &_name) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->ghostNames.count(_name) > 0;
+}
+
+/////////////////////////////////////////////////
+size_t Partition::GhostCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->ghostNames.size();
+}
+
+/////////////////////////////////////////////////
+void PartitionPrivate::OnPartition(ConstPartitionPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  auto iter = this->peerStates.find(_msg->region());
+  if (iter == this->peerStates.end())
+    return;
+
+  PartitionPeer &peer = iter->second;
+  peer.known = true;
+  peer.iterations = std::max(peer.iterations,
+      static_cast<uint64_t>(_msg->iterations()));
+  peer.box = ignition::math::AxisAlignedBox(msgs::ConvertIgn(_msg->min()),
+      msgs::ConvertIgn(_msg->max()));
+
+  // The SDF of the ghosts no longer sent is dropped, so that the peer
+  // sends it again if they come back
+  std::map<std::string, std::string> ghostSdf;
+  peer.ghosts.clear();
+  for (auto const &ghost : _msg->ghost())
+  {
+    auto doc = peer.ghostSdf.find(ghost.name());
+    if (ghost.has_sdf())
+      ghostSdf[ghost.name()] = ghost.sdf();
+    else if (doc != peer.ghostSdf.end())
+      ghostSdf[ghost.name()].swap(doc->second);
+    peer.ghosts[ghost.name()] = ghost;
+  }
+  peer.ghostSdf.swap(ghostSdf);
+  this->ghostsChanged = true;
+
+  // Migrations are sent until acknowledged, only the first one is kept
+  std::set<std::string> migrated;
+  for (auto const &model : _msg->migrate())
+  {
+    if (model.target() != this->region || !model.has_sdf())
+      continue;
+    migrated.insert(model.name());
+    if (!peer.migrated.count(model.name()))
+      this->incoming.push_back(model);
+  }
+  peer.migrated.swap(migrated);
+
+  peer.acknowledged.clear();
+  peer.acknowledged.insert(_msg->migrated().begin(), _msg->migrated().end());
+  peer.mirrored.clear();
+  peer.mirrored.insert(_msg->mirrored().begin(), _msg->mirrored().end());
+
+  this->condition.notify_all();
+}
+
+/////////////////////////////////////////////////
+void PartitionPrivate::WaitForPeers(const uint64_t _iterations)
+{
+  auto waitStart = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (!this->stop && this->world.Running())
+  {
+    std::string missing;
+    for (auto const &peer : this->peerStates)
+    {
+      if (!peer.second.known || peer.second.iterations < _iterations)
+        missing += " " + peer.first;
+    }
+    if (missing.empty())
+      return;
+
+    if (this->condition.wait_for(lock, kWaitPeriod) ==
+        std::cv_status::timeout)
+    {
+      // The peers started after the last message never received it
+      transport::PublisherPtr publisher = this->pub;
+      lock.unlock();
+      if (publisher)
+        publisher->Publish(this->lastMsg);
+      lock.lock();
+
+      if (std::chrono::steady_clock::now() - waitStart > kWarnPeriod)
+      {
+        gzwarn << "Region[" << this->region << "] waiting for iteration["
+               << _iterations << "] of peers[" << missing.substr(1)
+               << "]\n";
+        waitStart = std::chrono::steady_clock::now();
+      }
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+void PartitionPrivate::ApplyMigrations()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (auto &model : this->incoming)
+    {
+      PartitionMigration migration;
+      migration.model.Swap(&model);
+      this->migrations.push_back(migration);
+    }
+    this->incoming.clear();
+  }
+
+  for (auto iter = this->migrations.begin();
+       iter != this->migrations.end();)
+  {
+    const msgs::Partition::Model &model = iter->model;
+
+    // The ghost of the model makes way for it, once it is loaded
+    bool ghost;
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      ghost = this->ghostNames.count(model.name()) > 0;
+    }
+    ModelPtr existing = this->world.ModelByName(model.name());
+    if (ghost)
+    {
+      if (!existing)
+      {
+        ++iter;
+        continue;
+      }
+      this->world.RemoveModel(model.name());
+      existing.reset();
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->ghostNames.erase(model.name());
+    }
+
+    if (!iter->inserted)
+    {
+      if (existing)
+      {
+        gzerr << "Region[" << this->region << "] already has a model["
+              << model.name() << "], dropping the one migrating from "
+              << "another region.\n";
+        iter = this->migrations.erase(iter);
+        continue;
+      }
+      this->world.InsertModelString(model.sdf());
+      iter->inserted = true;
+      ++iter;
+      continue;
+    }
+
+    // The velocities are set once the model is loaded
+    if (!existing)
+    {
+      ++iter;
+      continue;
+    }
+    existing->SetWorldPose(msgs::ConvertIgn(model.pose()));
+    if (model.has_linear_velocity())
+      existing->SetLinearVel(msgs::ConvertIgn(model.linear_velocity()));
+    if (model.has_angular_velocity())
+      existing->SetAngularVel(msgs::ConvertIgn(model.angular_velocity()));
+    iter = this->migrations.erase(iter);
+  }
+}
+
+/////////////////////////////////////////////////
+void PartitionPrivate::InsertGhost(const msgs::Partition::Model &_ghost,
+    const std::string &_sdf)
+{
+  sdf::SDFPtr document(new sdf::SDF());
+  sdf::init(document);
+  if (!sdf::readString(_sdf, document) ||
+      !document->Root()->HasElement("model"))
+  {
+    gzerr << "Unable to read the SDF of ghost[" << _ghost.name() << "]\n";
+    return;
+  }
+
+  sdf::ElementPtr modelElem = document->Root()->GetElement("model");
+  modelElem->GetElement("static")->Set(true);
+  modelElem->GetElement("pose")->Set(msgs::ConvertIgn(_ghost.pose()));
+  StripGhost(modelElem);
+
+  this->world.InsertModelSDF(*document);
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->ghostNames.insert(_ghost.name());
+}
+
+/////////////////////////////////////////////////
+void PartitionPrivate::ApplyGhosts()
+{
+  // Ghosts of the peers near the region, with the SDF of the new ones
+  std::map<std::string, msgs::Partition::Model> wanted;
+  std::map<std::string, std::string> sdfs;
+  std::set<std::string> current;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (!this->ghostsChanged)
+      return;
+    this->ghostsChanged = false;
+
+    const ignition::math::Vector3d margin(this->ghostMargin,
+        this->ghostMargin, this->ghostMargin);
+    const ignition::math::AxisAlignedBox near(this->box.Min() - margin,
+        this->box.Max() + margin);
+    for (auto const &peer : this->peerStates)
+    {
+      for (auto const &ghost : peer.second.ghosts)
+      {
+        if (!near.Contains(msgs::ConvertIgn(ghost.second.pose().position())))
+          continue;
+        wanted[ghost.first] = ghost.second;
+        if (!this->ghostNames.count(ghost.first))
+        {
+          auto doc = peer.second.ghostSdf.find(ghost.first);
+          if (doc != peer.second.ghostSdf.end())
+            sdfs[ghost.first] = doc->second;
+        }
+      }
+    }
+    current = this->ghostNames;
+  }
+
+  // Models being handed over aren't mirrored
+  for (auto const &migration : this->migrations)
+    wanted.erase(migration.model.name());
+
+  for (auto const &name : current)
+  {
+    if (wanted.count(name))
+      continue;
+    if (this->world.ModelByName(name))
+    {
+      this->world.RemoveModel(name);
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->ghostNames.erase(name);
+    }
+  }
+
+  for (auto const &ghost : wanted)
+  {
+    if (current.count(ghost.first))
+    {
+      // Ghosts still in the factory queue are moved once loaded
+      ModelPtr model = this->world.ModelByName(ghost.first);
+      if (model)
+        model->SetWorldPose(msgs::ConvertIgn(ghost.second.pose()));
+      continue;
+    }
+
+    auto doc = sdfs.find(ghost.first);
+    if (doc == sdfs.end() || this->world.ModelByName(ghost.first))
+      continue;
+    this->InsertGhost(ghost.second, doc->second);
+  }
+}
+
+/////////////////////////////////////////////////
+void Partition::UpdateBegin()
+{
+  // The models owned by the peers were loaded from the world file too
+  if (!this->dataPtr->started)
+  {
+    this->dataPtr->started = true;
+    for (auto const &model : this->dataPtr->world.Models())
+    {
+      if (!model->IsStatic() &&
+          !this->dataPtr->box.Contains(model->WorldPose().Pos()))
+      {
+        this->dataPtr->world.RemoveModel(model->GetName());
+      }
+    }
+  }
+
+  // The world counts the iteration being simulated
+  const uint64_t iterations = this->dataPtr->world.Iterations();
+  if (iterations > 0)
+    this->dataPtr->WaitForPeers(iterations - 1);
+
+  this->dataPtr->ApplyMigrations();
+  this->dataPtr->ApplyGhosts();
+}
+
+/////////////////////////////////////////////////
+void Partition::UpdateEnd()
+{
+  msgs::Partition &msg = this->dataPtr->lastMsg;
+  msg.set_iterations(this->dataPtr->world.Iterations());
+  msg.clear_ghost();
+  msg.clear_migrate();
+  msg.clear_migrated();
+  msg.clear_mirrored();
+
+  std::map<std::string, ignition::math::AxisAlignedBox> peerBoxes;
+  std::map<std::string, std::set<std::string>> acknowledged;
+  std::set<std::string> ghostNames;
+  transport::PublisherPtr publisher;
+  // Models handed over to the region, and ghosts whose SDF it has
+  std::set<std::string> received;
+  std::set<std::string> sdfs;
+  // Ghosts of the region whose SDF every peer has
+  std::set<std::string> everywhere;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    if (this->dataPtr->stop)
+      return;
+    publisher = this->dataPtr->pub;
+    bool first = true;
+    for (auto const &peer : this->dataPtr->peerStates)
+    {
+      received.insert(peer.second.migrated.begin(),
+          peer.second.migrated.end());
+      for (auto const &doc : peer.second.ghostSdf)
+        sdfs.insert(doc.first);
+      if (!peer.second.known)
+        continue;
+
+      peerBoxes[peer.first] = peer.second.box;
+      acknowledged[peer.first] = peer.second.acknowledged;
+      if (first)
+        everywhere = peer.second.mirrored;
+      for (auto iter = everywhere.begin(); iter != everywhere.end();)
+      {
+        if (peer.second.mirrored.count(*iter))
+          ++iter;
+        else
+          iter = everywhere.erase(iter);
+      }
+      first = false;
+    }
+    ghostNames = this->dataPtr->ghostNames;
+  }
+
+  for (auto const &name : received)
+    msg.add_migrated(name);
+  for (auto const &name : sdfs)
+    msg.add_mirrored(name);
+
+  // Handed over models are removed once their target has them
+  for (auto iter = this->dataPtr->handovers.begin();
+       iter != this->dataPtr->handovers.end();)
+  {
+    auto acks = acknowledged.find(iter->second.target());
+    if (acks != acknowledged.end() && acks->second.count(iter->first))
+    {
+      if (this->dataPtr->world.ModelByName(iter->first))
+        this->dataPtr->world.RemoveModel(iter->first);
+      iter = this->dataPtr->handovers.erase(iter);
+      continue;
+    }
+    *msg.add_migrate() = iter->second;
+    ++iter;
+  }
+
+  const ignition::math::Vector3d margin(this->dataPtr->ghostMargin,
+      this->dataPtr->ghostMargin, this->dataPtr->ghostMargin);
+  const ignition::math::AxisAlignedBox inner(
+      this->dataPtr->box.Min() + margin, this->dataPtr->box.Max() - margin);
+
+  for (auto const &model : this->dataPtr->world.Models())
+  {
+    if (model->IsStatic() || ghostNames.count(model->GetName()) ||
+        this->dataPtr->handovers.count(model->GetName()))
+    {
+      continue;
+    }
+
+    const ignition::math::Pose3d pose = model->WorldPose();
+    if (this->dataPtr->box.Contains(pose.Pos()))
+    {
+      if (this->dataPtr->peers.empty() || inner.Contains(pose.Pos()))
+        continue;
+
+      msgs::Partition::Model *ghost = msg.add_ghost();
+      ghost->set_name(model->GetName());
+      msgs::Set(ghost->mutable_pose(), pose);
+      if (!everywhere.count(model->GetName()))
+        ghost->set_sdf(ModelDocument(model));
+      continue;
+    }
+
+    // Models outside every region stay where they are
+    std::string target;
+    for (auto const &peer : peerBoxes)
+    {
+      if (peer.second.Contains(pose.Pos()))
+      {
+        target = peer.first;
+        break;
+      }
+    }
+    if (target.empty())
+      continue;
+
+    msgs::Partition::Model *migrate = msg.add_migrate();
+    migrate->set_name(model->GetName());
+    migrate->set_target(target);
+    msgs::Set(migrate->mutable_pose(), pose);
+    migrate->set_sdf(ModelDocument(model));
+    msgs::Set(migrate->mutable_linear_velocity(), model->WorldLinearVel());
+    msgs::Set(migrate->mutable_angular_velocity(), model->WorldAngularVel());
+    this->dataPtr->handovers[model->GetName()] = *migrate;
+
+    // The model stays in place, pushing but not pushed, until removed
+    for (auto const &link : model->GetLinks())
+      link->SetKinematic(true);
+    model->SetLinearVel(ignition::math::Vector3d::Zero);
+    model->SetAngularVel(ignition::math::Vector3d::Zero);
+  }
+
+  publisher->Publish(msg);
+}
+
+/////////////////////////////////////////////////
+void Partition::Fini()
+{
+  // The world thread may still hold the publisher
+  transport::PublisherPtr publisher;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stop = true;
+    publisher.swap(this->dataPtr->pub);
+    this->dataPtr->condition.notify_all();
+  }
+
+  publisher.reset();
+  this->dataPtr->sub.reset();
+  if (this->dataPtr->node)
+    this->dataPtr->node->Fini();
+  this->dataPtr->node.reset();
+}
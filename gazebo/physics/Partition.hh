@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_PARTITION_HH_
+#define GAZEBO_PHYSICS_PARTITION_HH_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/math/AxisAlignedBox.hh>
+#include <sdf/sdf.hh>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class
+    class PartitionPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class Partition Partition.hh physics/physics.hh
+    /// \brief Region of a world simulated by one of several servers.
+    ///
+    /// Each server loads the same world file, with a <gz:partition>
+    /// element naming its region, the box it owns and the other regions:
+    ///
+    /// \code
+    /// <gz:partition>
+    ///   <region>east</region>
+    ///   <min>0 -500 -100</min>
+    ///   <max>500 500 100</max>
+    ///   <peer>west</peer>
+    ///   <ghost_margin>2</ghost_margin>
+    /// </gz:partition>
+    /// \endcode
+    ///
+    /// The servers share one master, started by the first server; the
+    /// others are run with GAZEBO_MASTER_EXTERNAL=1. Since the worlds have
+    /// the same name, clients receive the poses of all the regions on the
+    /// usual topics.
+    ///
+    /// A region owns the models which aren't static and whose origin is
+    /// in its box. The others are removed when the world starts. Before
+    /// each iteration, the world waits until every peer has simulated the
+    /// previous one, so that the regions run in lockstep. After each
+    /// iteration, the region publishes on ~/partition:
+    /// - its owned models within the ghost margin of its boundary, which
+    /// the other regions mirror as static models without plugins or
+    /// sensors. They collide with the models of the other regions but
+    /// aren't pushed by them.
+    /// - its models whose origin moved into the box of a peer. Their SDF
+    /// and velocities are handed to the peer, which inserts them. The
+    /// region keeps them as kinematic ghosts, and sends them again, until
+    /// the peer acknowledges them. Joint positions aren't transferred.
+    ///
+    /// The SDF of a ghost is also sent again until every peer acknowledges
+    /// it, so that a lost message doesn't lose a model or a ghost.
+    class GZ_PHYSICS_VISIBLE Partition
+    {
+      /// \brief Constructor.
+      /// \param[in] _world World simulating the region.
+      public: explicit Partition(World &_world);
+
+      /// \brief Destructor.
+      public: ~Partition();
+
+      /// \brief Load the region and start exchanging with the peers.
+      /// \param[in] _sdf The <gz:partition> element.
+      /// \return False if the region has no name or an empty box.
+      public: bool Load(const sdf::ElementPtr &_sdf);
+
+      /// \brief Get the name of the region.
+      /// \return The name.
+      public: std::string Region() const;
+
+      /// \brief Get the box owned by the region.
+      /// \return The box, in the world frame.
+      public: ignition::math::AxisAlignedBox Box() const;
+
+      /// \brief Get the names of the other regions.
+      /// \return The peers, as listed in the SDF.
+      public: std::vector<std::string> Peers() const;
+
+      /// \brief Get whether a model is a ghost of a model of a peer.
+      /// \param[in] _name Name of the model.
+      /// \return True for a ghost.
+      public: bool IsGhost(const std::string &_name) const;
+
+      /// \brief Get the number of ghosts in the world.
+      /// \return Number of ghosts.
+      public: size_t GhostCount() const;
+
+      /// \brief Wait for the peers to finish the previous iteration, then
+      /// apply their ghosts and migrations. Called by the world before
+      /// each update.
+      public: void UpdateBegin();
+
+      /// \brief Publish the ghosts and migrations of the region. Called by
+      /// the world after each update.
+      public: void UpdateEnd();
+
+      /// \brief Stop exchanging with the peers, and wake the waiting
+      /// world.
+      public: void Fini();
+
+      /// \brief Private data pointer.
+      private: std::unique_ptr<PartitionPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gazebo/physics/Partition.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+class PartitionTest : public ServerFixture
+{
+  /// \brief Store the states published by the region of the world.
+  /// \param[in] _msg A state.
+  public: void OnPartition(ConstPartitionPtr &_msg)
+          {
+            if (_msg->region() != "east")
+              return;
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->last = *_msg;
+            for (auto const &model : _msg->migrate())
+              this->migrated.push_back(model.name());
+          }
+
+  /// \brief Publish the state of the other region, then run an
+  /// iteration.
+  /// \param[in] _world The world.
+  public: void Step(const physics::WorldPtr &_world)
+          {
+            this->west.set_iterations(_world->Iterations());
+            this->pub->Publish(this->west);
+            _world->Step(1);
+            common::Time::MSleep(10);
+
+            // SDF and migrations are sent until the region has them
+            std::lock_guard<std::mutex> lock(this->mutex);
+            const std::set<std::string> mirrored(
+                this->last.mirrored().begin(), this->last.mirrored().end());
+            for (auto &ghost : *this->west.mutable_ghost())
+            {
+              if (mirrored.count(ghost.name()))
+                ghost.clear_sdf();
+            }
+            const std::set<std::string> migrated(
+                this->last.migrated().begin(), this->last.migrated().end());
+            auto migrate = this->west.mutable_migrate();
+            for (int i = migrate->size() - 1; i >= 0; --i)
+            {
+              if (migrated.count(migrate->Get(i).name()))
+                migrate->DeleteSubrange(i, 1);
+            }
+          }
+
+  /// \brief State of the simulated other region.
+  public: msgs::Partition west;
+
+  /// \brief Publisher of the other region.
+  public: transport::PublisherPtr pub;
+
+  /// \brief Protects the members below.
+  public: std::mutex mutex;
+
+  /// \brief Last state of the region of the world.
+  public: msgs::Partition last;
+
+  /// \brief Models which migrated out of the region.
+  public: std::vector<std::string> migrated;
+};
+
+/////////////////////////////////////////////////
+std::string BoxDocument(const std::string &_name,
+    const ignition::math::Vector3d &_pos)
+{
+  std::ostringstream sdf;
+  sdf << "<sdf version='" << SDF_VERSION << "'>"
+      << "<model name='" << _name << "'>"
+      << "<pose>" << _pos << " 0 0 0</pose>"
+      << "<link name='link'><collision name='collision'><geometry>"
+      << "<box><size>1 1 1</size></box></geometry></collision></link>"
+      << "</model></sdf>";
+  return sdf.str();
+}
+
+/////////////////////////////////////////////////
+TEST_F(PartitionTest, Exchange)
+{
+  this->Load("test/worlds/partition.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::Partition *partition = world->Partition();
+  ASSERT_TRUE(partition != nullptr);
+  EXPECT_EQ("east", partition->Region());
+  ASSERT_EQ(1u, partition->Peers().size());
+  EXPECT_EQ("west", partition->Peers()[0]);
+  EXPECT_EQ(ignition::math::Vector3d(50, 50, 50), partition->Box().Max());
+
+  transport::SubscriberPtr sub = this->node->Subscribe("~/partition",
+      &PartitionTest::OnPartition, this);
+  this->pub = this->node->Advertise<msgs::Partition>("~/partition");
+  this->pub->WaitForConnection();
+
+  this->west.set_region("west");
+  msgs::Set(this->west.mutable_min(), ignition::math::Vector3d(-50, -50, -50));
+  msgs::Set(this->west.mutable_max(), ignition::math::Vector3d(0, 50, 50));
+  msgs::Partition::Model *remote = this->west.add_ghost();
+  remote->set_name("remote");
+  msgs::Set(remote->mutable_pose(),
+      ignition::math::Pose3d(-1, 0, 0.5, 0, 0, 0));
+  remote->set_sdf(BoxDocument("remote", ignition::math::Vector3d(-1, 0, 0.5)));
+
+  // The models of the other region are removed from the world file
+  this->Step(world);
+  EXPECT_EQ(1u, world->Iterations());
+  EXPECT_TRUE(world->ModelByName("outside") == nullptr);
+  EXPECT_TRUE(world->ModelByName("inside") != nullptr);
+  EXPECT_TRUE(world->ModelByName("edge") != nullptr);
+
+  // The ghost of the other region is static
+  for (int i = 0; i < 100 && !world->ModelByName("remote"); ++i)
+    this->Step(world);
+  physics::ModelPtr ghost = world->ModelByName("remote");
+  ASSERT_TRUE(ghost != nullptr);
+  EXPECT_TRUE(ghost->IsStatic());
+  EXPECT_TRUE(partition->IsGhost("remote"));
+  EXPECT_FALSE(partition->IsGhost("inside"));
+  EXPECT_EQ(1u, partition->GhostCount());
+
+  // and follows the other region
+  msgs::Set(this->west.mutable_ghost(0)->mutable_pose(),
+      ignition::math::Pose3d(-1, 1, 0.5, 0, 0, 0));
+  this->Step(world);
+  EXPECT_NEAR(1.0, ghost->WorldPose().Pos().Y(), 1e-6);
+
+  // Only the models near the boundary are mirrored by the other region
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    ASSERT_EQ(1, this->last.ghost_size());
+    EXPECT_EQ("edge", this->last.ghost(0).name());
+    EXPECT_EQ("east", this->last.region());
+    ASSERT_EQ(1, this->last.mirrored_size());
+    EXPECT_EQ("remote", this->last.mirrored(0));
+
+    // with its SDF, until the other region has it
+    EXPECT_TRUE(this->last.ghost(0).has_sdf());
+    this->west.add_mirrored("edge");
+  }
+  this->Step(world);
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    ASSERT_EQ(1, this->last.ghost_size());
+    EXPECT_FALSE(this->last.ghost(0).has_sdf());
+  }
+
+  // The region waits for the other one
+  const uint32_t iterations = world->Iterations();
+  std::atomic<bool> done(false);
+  std::thread stepper([&world, &done]()
+      {
+        world->Step(1);
+        done = true;
+      });
+  common::Time::MSleep(300);
+  EXPECT_FALSE(done);
+  EXPECT_EQ(iterations, world->Iterations());
+  this->west.set_iterations(iterations);
+  this->pub->Publish(this->west);
+  stepper.join();
+  EXPECT_EQ(iterations + 1u, world->Iterations());
+
+  // A model handed over by the other region keeps its velocity
+  msgs::Partition::Model *arrival = this->west.add_migrate();
+  arrival->set_name("arrival");
+  arrival->set_target("east");
+  msgs::Set(arrival->mutable_pose(),
+      ignition::math::Pose3d(20, 0, 5, 0, 0, 0));
+  arrival->set_sdf(BoxDocument("arrival", ignition::math::Vector3d(20, 0, 5)));
+  msgs::Set(arrival->mutable_linear_velocity(),
+      ignition::math::Vector3d(1, 0, 0));
+  for (int i = 0; i < 100 && (!world->ModelByName("arrival") ||
+        world->ModelByName("arrival")->WorldLinearVel().X() < 0.5); ++i)
+  {
+    this->Step(world);
+  }
+  physics::ModelPtr model = world->ModelByName("arrival");
+  ASSERT_TRUE(model != nullptr);
+  EXPECT_FALSE(model->IsStatic());
+  EXPECT_FALSE(partition->IsGhost("arrival"));
+  EXPECT_NEAR(1.0, model->WorldLinearVel().X(), 1e-3);
+
+  // A ghost no longer sent is removed
+  this->west.clear_ghost();
+  for (int i = 0; i < 100 && world->ModelByName("remote"); ++i)
+    this->Step(world);
+  EXPECT_TRUE(world->ModelByName("remote") == nullptr);
+  EXPECT_EQ(0u, partition->GhostCount());
+
+  // A model entering the other region is handed over, and kept until the
+  // other region acknowledges it
+  physics::ModelPtr leaving = world->ModelByName("inside");
+  ASSERT_TRUE(leaving != nullptr);
+  leaving->SetWorldPose(ignition::math::Pose3d(-10, 0, 0.5, 0, 0, 0));
+  for (int i = 0; i < 100; ++i)
+  {
+    this->Step(world);
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->migrated.size() >= 2u)
+      break;
+  }
+  EXPECT_EQ(leaving, world->ModelByName("inside"));
+  EXPECT_TRUE(leaving->GetLink("link")->GetKinematic());
+  EXPECT_FALSE(partition->IsGhost("inside"));
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    ASSERT_GE(this->migrated.size(), 2u);
+    for (auto const &name : this->migrated)
+      EXPECT_EQ("inside", name);
+  }
+  leaving.reset();
+
+  this->west.add_migrated("inside");
+  for (int i = 0; i < 100 && world->ModelByName("inside"); ++i)
+    this->Step(world);
+  EXPECT_TRUE(world->ModelByName("inside") == nullptr);
+  std::lock_guard<std::mutex> lock(this->mutex);
+  EXPECT_EQ(0, this->last.migrate_size());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -15,6 +15,8 @@
  *
 */
 
+#include <cstring>
+#include <functional>
 #include <boost/lexical_cast.hpp>
 
 #include <sdf/sdf.hh>
@@ -243,6 +245,12 @@ bool PhysicsEngine::SetParam(const std::string &_key,
       this->world->SetMagneticField(
           any_cast<ignition::math::Vector3d>(copy));
     }
+    else if (_key == "parallel_model_update")
+      this->world->SetParallelModelUpdate(any_cast<bool>(_value));
+    else if (_key == "step_batch_size")
+      this->world->SetStepBatchSize(any_cast<unsigned int>(_value));
+    else if (_key == "sleep_time")
+      this->world->SetSleepTime(any_cast<double>(_value));
     else
     {
       gzwarn << "SetParam failed for [" << _key << "] in physics engine "
@@ -295,6 +303,12 @@ bool PhysicsEngine::GetParam(const std::string &_key,
     _value = this->world->Gravity();
   else if (_key == "magnetic_field")
     _value = this->world->MagneticField();
+  else if (_key == "parallel_model_update")
+    _value = this->world->ParallelModelUpdate();
+  else if (_key == "step_batch_size")
+    _value = this->world->StepBatchSize();
+  else if (_key == "sleep_time")
+    _value = this->world->SleepTime();
   else
   {
     gzwarn << "GetParam failed for [" << _key << "] in physics engine "
@@ -305,12 +319,133 @@ bool PhysicsEngine::GetParam(const std::string &_key,
   return true;
 }
 
+//////////////////////////////////////////////////
+bool PhysicsEngine::SetModelStepMultiple(ModelPtr _model,
+    const unsigned int _multiple)
+{
+  if (_multiple == 1)
+    return true;
+
+  gzwarn << "Physics engine [" << this->GetType() << "] doesn't support "
+         << "step multiples, model [" << (_model ? _model->GetScopedName() : "")
+         << "] is stepped at the world rate\n";
+  return false;
+}
+
+//////////////////////////////////////////////////
+bool PhysicsEngine::SetLinkContinuousCollision(LinkPtr _link,
+    const bool _enable)
+{
+  if (!_enable)
+    return true;
+
+  gzwarn << "Physics engine [" << this->GetType() << "] doesn't support "
+         << "continuous collision detection, link ["
+         << (_link ? _link->GetScopedName() : "")
+         << "] is collided at the end of each step\n";
+  return false;
+}
+
 //////////////////////////////////////////////////
 ContactManager *PhysicsEngine::GetContactManager() const
 {
   return this->contactManager;
 }
 
+//////////////////////////////////////////////////
+void PhysicsEngine::SnapshotEntities(Link_V &_links, Joint_V &_joints) const
+{
+  _links.clear();
+  _joints.clear();
+
+  std::function<void(const ModelPtr &)> addModel =
+      [&](const ModelPtr &_model)
+      {
+        auto const &links = _model->GetLinks();
+        _links.insert(_links.end(), links.begin(), links.end());
+        auto const &joints = _model->GetJoints();
+        _joints.insert(_joints.end(), joints.begin(), joints.end());
+
+        for (auto const &nested : _model->NestedModels())
+          addModel(nested);
+      };
+
+  for (auto const &model : this->world->Models())
+    addModel(model);
+}
+
+//////////////////////////////////////////////////
+void PhysicsEngine::SaveSnapshot(std::string &_data) const
+{
+  Link_V links;
+  Joint_V joints;
+  this->SnapshotEntities(links, joints);
+
+  // Layout: link count, then pose (7), linear velocity (3) and angular
+  // velocity (3) of every link.
+  const uint64_t linkCount = links.size();
+  _data.resize(sizeof(linkCount) + linkCount * 13 * sizeof(double));
+  std::memcpy(&_data[0], &linkCount, sizeof(linkCount));
+
+  double *values = reinterpret_cast<double *>(&_data[sizeof(linkCount)]);
+  for (auto const &link : links)
+  {
+    auto pose = link->WorldPose();
+    auto linearVel = link->WorldLinearVel();
+    auto angularVel = link->WorldAngularVel();
+
+    *values++ = pose.Pos().X();
+    *values++ = pose.Pos().Y();
+    *values++ = pose.Pos().Z();
+    *values++ = pose.Rot().W();
+    *values++ = pose.Rot().X();
+    *values++ = pose.Rot().Y();
+    *values++ = pose.Rot().Z();
+    *values++ = linearVel.X();
+    *values++ = linearVel.Y();
+    *values++ = linearVel.Z();
+    *values++ = angularVel.X();
+    *values++ = angularVel.Y();
+    *values++ = angularVel.Z();
+  }
+}
+
+//////////////////////////////////////////////////
+bool PhysicsEngine::RestoreSnapshot(const std::string &_data)
+{
+  Link_V links;
+  Joint_V joints;
+  this->SnapshotEntities(links, joints);
+
+  uint64_t linkCount = 0;
+  if (_data.size() >= sizeof(linkCount))
+    std::memcpy(&linkCount, _data.data(), sizeof(linkCount));
+
+  if (linkCount != links.size() ||
+      _data.size() != sizeof(linkCount) + linkCount * 13 * sizeof(double))
+  {
+    gzerr << "Snapshot doesn't match the links of world["
+          << this->world->Name() << "]\n";
+    return false;
+  }
+
+  const double *values =
+      reinterpret_cast<const double *>(&_data[sizeof(linkCount)]);
+  for (auto const &link : links)
+  {
+    ignition::math::Pose3d pose(values[0], values[1], values[2],
+        values[3], values[4], values[5], values[6]);
+    link->SetWorldPose(pose);
+    link->SetLinearVel(
+        ignition::math::Vector3d(values[7], values[8], values[9]));
+    link->SetAngularVel(
+        ignition::math::Vector3d(values[10], values[11], values[12]));
+    values += 13;
+  }
+
+  return true;
+}
+
 //////////////////////////////////////////////////
 sdf::ElementPtr PhysicsEngine::GetSDF() const
 {
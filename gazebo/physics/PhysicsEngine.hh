@@ -215,6 +215,20 @@ namespace gazebo
       ///          (defined but not used in ode).
       ///       -# "max_step_size" (double) - maximum physics step size when
       ///          physics update step must return.
+      ///       -# "parallel_model_update" (bool) - update models that are
+      ///          not connected through joints in parallel.
+      ///       -# "step_batch_size" (unsigned int) - maximum number of
+      ///          steps run back to back when the update rate is unlimited.
+      ///       -# "sleep_time" (double) - time a model must be idle before
+      ///          it is put to sleep, 0 to disable.
+      ///       -# "collision_threads" (int) - number of threads of the
+      ///          collision narrowphase, 0 to disable. (ODE)
+      ///       -# "pair_cache" (bool) - keep broadphase pairs from one
+      ///          step to the next and skip pairs of sleeping or static
+      ///          geometry. (ODE)
+      ///       -# "thread_count" (int) - number of threads of the
+      ///          collision dispatcher and constraint solver pool, 0 to
+      ///          step sequentially. (Bullet)
       ///
       /// \param[in] _value The value to set to
       /// \return true if SetParam is successful, false if operation fails.
@@ -238,6 +252,42 @@ namespace gazebo
       /// \brief Debug print out of the physic engine state.
       public: virtual void DebugPrint() const = 0;
 
+      /// \brief Save the dynamic state of all links and joints of the
+      /// world into a binary buffer. The default implementation only saves
+      /// the pose and velocity of each link. Engines override it to save
+      /// their complete internal state.
+      /// \param[out] _data Buffer that receives the state. Its memory is
+      /// reused if it is large enough.
+      /// \sa World::SaveSnapshot
+      public: virtual void SaveSnapshot(std::string &_data) const;
+
+      /// \brief Restore a state saved by SaveSnapshot. The world must have
+      /// the same links and joints as when the state was saved.
+      /// \param[in] _data Buffer filled by SaveSnapshot.
+      /// \return True on success.
+      /// \sa World::RestoreSnapshot
+      public: virtual bool RestoreSnapshot(const std::string &_data);
+
+      /// \brief Step a model at a multiple of the world step size.
+      /// Engines that don't support multi-rate stepping print a warning
+      /// and step every model at the world rate.
+      /// \param[in] _model Model to step.
+      /// \param[in] _multiple Step multiple, 1 steps at the world rate.
+      /// \return True if the engine steps the model at the multiple.
+      /// \sa Model::SetStepMultiple
+      public: virtual bool SetModelStepMultiple(ModelPtr _model,
+                  const unsigned int _multiple);
+
+      /// \brief Sweep a link between steps for continuous collision
+      /// detection. Engines that don't support it print a warning and
+      /// collide the link at the end of each step only.
+      /// \param[in] _link Link to sweep.
+      /// \param[in] _enable True to enable continuous collision detection.
+      /// \return True if the engine sweeps the link as requested.
+      /// \sa Link::SetContinuousCollision
+      public: virtual bool SetLinkContinuousCollision(LinkPtr _link,
+                  const bool _enable);
+
       /// \brief Get a pointer to the world.
       /// \return Pointer to the world.
       public: WorldPtr World() const;
@@ -280,6 +330,12 @@ namespace gazebo
         }
       }
 
+      /// \brief Get all the links and joints of the world, including the
+      /// ones of nested models, in a stable order suitable for snapshots.
+      /// \param[out] _links All the links.
+      /// \param[out] _joints All the joints.
+      protected: void SnapshotEntities(Link_V &_links, Joint_V &_joints) const;
+
       /// \brief virtual callback for gztopic "~/request".
       /// \param[in] _msg Request message.
       protected: virtual void OnRequest(ConstRequestPtr &_msg);
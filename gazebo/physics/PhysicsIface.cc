@@ -15,6 +15,8 @@
  *
 */
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 #include <boost/thread/mutex.hpp>
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
@@ -111,9 +113,15 @@ void physics::init_worlds()
 
 /////////////////////////////////////////////////
 void physics::init_worlds(UpdateScenePosesFunc _func)
+{
+  init_worlds(_func, nullptr);
+}
+
+/////////////////////////////////////////////////
+void physics::init_worlds(UpdateScenePosesFunc _func, HasSceneFunc _hasScene)
 {
   for (auto &world : g_worlds)
-    world->Init(_func);
+    world->Init(_func, _hasScene);
 }
 
 /////////////////////////////////////////////////
@@ -137,6 +145,32 @@ void physics::stop_worlds()
     world->Stop();
 }
 
+/////////////////////////////////////////////////
+void physics::step_worlds(const unsigned int _steps)
+{
+  // World::Step blocks until the world thread has finished the steps, so
+  // use one task per world.
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, g_worlds.size(), 1),
+      [&](const tbb::blocked_range<size_t> &_r)
+      {
+        for (size_t i = _r.begin(); i != _r.end(); ++i)
+          g_worlds[i]->Step(_steps);
+      });
+}
+
+/////////////////////////////////////////////////
+std::vector<physics::WorldState> physics::get_world_states()
+{
+  std::vector<WorldState> states(g_worlds.size());
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, g_worlds.size(), 1),
+      [&](const tbb::blocked_range<size_t> &_r)
+      {
+        for (size_t i = _r.begin(); i != _r.end(); ++i)
+          states[i].Load(g_worlds[i]);
+      });
+  return states;
+}
+
 /////////////////////////////////////////////////
 void physics::load_world(WorldPtr _world, sdf::ElementPtr _sdf)
 {
@@ -152,7 +186,14 @@ void physics::init_world(WorldPtr _world)
 /////////////////////////////////////////////////
 void physics::init_world(WorldPtr _world, UpdateScenePosesFunc _func)
 {
-  _world->Init(_func);
+  init_world(_world, _func, nullptr);
+}
+
+/////////////////////////////////////////////////
+void physics::init_world(WorldPtr _world, UpdateScenePosesFunc _func,
+    HasSceneFunc _hasScene)
+{
+  _world->Init(_func, _hasScene);
 }
 
 /////////////////////////////////////////////////
@@ -18,9 +18,11 @@
 #define _PHYSICSIFACE_HH_
 
 #include <string>
+#include <vector>
 #include <sdf/sdf.hh>
 
 #include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/physics/WorldState.hh"
 #include "gazebo/util/system.hh"
 
 namespace gazebo
@@ -79,6 +81,15 @@ namespace gazebo
     GZ_PHYSICS_VISIBLE
     void init_world(WorldPtr _world, UpdateScenePosesFunc _func);
 
+    /// \brief Init world given a pointer to it.
+    /// \param[in] _world World to initialize.
+    /// \param[in] _func function to be called when Poses are available.
+    /// \param[in] _hasScene function telling whether the scene of the world
+    /// exists.
+    GZ_PHYSICS_VISIBLE
+    void init_world(WorldPtr _world, UpdateScenePosesFunc _func,
+        HasSceneFunc _hasScene);
+
     /// \brief Run world by calling World::Run() given a pointer to it.
     /// \param[in] _world World to run.
     /// \param[in] _iterations Number of iterations for each world to take.
@@ -114,6 +125,14 @@ namespace gazebo
     GZ_PHYSICS_VISIBLE
     void init_worlds(UpdateScenePosesFunc _func);
 
+    /// \brief initialize multiple worlds stored in static variable
+    /// gazebo::g_worlds
+    /// \param[in] _func function to be called when Poses are available.
+    /// \param[in] _hasScene function telling whether the scene of a world
+    /// exists.
+    GZ_PHYSICS_VISIBLE
+    void init_worlds(UpdateScenePosesFunc _func, HasSceneFunc _hasScene);
+
     /// \brief Run multiple worlds stored in static variable
     /// gazebo::g_worlds
     /// \param[in] _iterations Number of iterations for each world to take.
@@ -126,6 +145,20 @@ namespace gazebo
     GZ_PHYSICS_VISIBLE
     void stop_worlds();
 
+    /// \brief Step all worlds in lockstep. The worlds are stepped
+    /// concurrently on a thread pool, and the call blocks until every
+    /// world has taken _steps steps. Worlds that are not paused are
+    /// paused first.
+    /// \param[in] _steps Number of steps each world takes.
+    GZ_PHYSICS_VISIBLE
+    void step_worlds(const unsigned int _steps = 1);
+
+    /// \brief Get the current state of all worlds, in the order in which
+    /// the worlds were created.
+    /// \return One state per world.
+    GZ_PHYSICS_VISIBLE
+    std::vector<WorldState> get_world_states();
+
     /// \brief pause multiple worlds stored in static variable
     /// gazebo::g_worlds
     /// \param[in] _pause True to pause, False to unpause.
@@ -52,6 +52,8 @@ namespace gazebo
     class UserCmdManager;
     class PhysicsEngine;
     class Wind;
+    class ForceField;
+    class Partition;
     class Atmosphere;
     class Mass;
     class Road;
@@ -251,6 +253,12 @@ namespace gazebo
     using UpdateScenePosesFunc =
         std::function<void(const std::string &, const msgs::PosesStamped &)>;
 
+    /// \brief Function signature for API that tells whether a scene exists
+    /// to receive the poses of UpdateScenePosesFunc.
+    /// \param[in] String name of the scene.
+    /// \return True if the scene exists.
+    using HasSceneFunc = std::function<bool(const std::string &)>;
+
     #ifndef GZ_COLLIDE_BITS
 
     /// \def GZ_ALL_COLLIDE
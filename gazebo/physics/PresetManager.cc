@@ -15,6 +15,11 @@
  *
 */
 
+#include <any>
+#include <atomic>
+#include <string>
+#include <typeinfo>
+
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Assert.hh"
 #include "gazebo/physics/PresetManagerPrivate.hh"
@@ -37,11 +42,71 @@ template<typename T> bool CastAnyValue(const boost::any &_value, T &_return)
   return true;
 }
 
+namespace
+{
+  /// \brief Get a new revision of preset parameters.
+  /// \return Revision, never returned before.
+  uint64_t NextRevision()
+  {
+    static std::atomic<uint64_t> revision(0);
+    return ++revision;
+  }
+
+  /// \brief Get the type of a parameter value.
+  /// \param[in] _value Value, which may hold a std::any from SDF.
+  /// \return Type of the value.
+  const std::type_info &ParamType(const boost::any &_value)
+  {
+    if (_value.type() == typeid(std::any))
+      return boost::any_cast<const std::any &>(_value).type();
+    return _value.type();
+  }
+
+  /// \brief Compare parameter values of a type.
+  /// \param[in] _a First value.
+  /// \param[in] _b Second value.
+  /// \return True if the values are equal.
+  template<typename T> bool EqualParams(const boost::any &_a,
+      const boost::any &_b)
+  {
+    return PhysicsEngine::any_cast<T>(_a) == PhysicsEngine::any_cast<T>(_b);
+  }
+
+  /// \brief Check whether parameter values are of the same type and equal.
+  /// \param[in] _a First value.
+  /// \param[in] _b Second value.
+  /// \return True if the values are equal, false if they differ or are of
+  /// a type which can't be compared.
+  bool SameParam(const boost::any &_a, const boost::any &_b)
+  {
+    const std::type_info &type = ParamType(_a);
+    if (type != ParamType(_b))
+      return false;
+
+    if (type == typeid(double))
+      return EqualParams<double>(_a, _b);
+    if (type == typeid(float))
+      return EqualParams<float>(_a, _b);
+    if (type == typeid(int))
+      return EqualParams<int>(_a, _b);
+    if (type == typeid(unsigned int))
+      return EqualParams<unsigned int>(_a, _b);
+    if (type == typeid(bool))
+      return EqualParams<bool>(_a, _b);
+    if (type == typeid(std::string))
+      return EqualParams<std::string>(_a, _b);
+    if (type == typeid(ignition::math::Vector3d))
+      return EqualParams<ignition::math::Vector3d>(_a, _b);
+    return false;
+  }
+}
+
 //////////////////////////////////////////////////
 Preset::Preset()
     : dataPtr(new PresetPrivate)
 {
   GZ_ASSERT(this->dataPtr != NULL, "Data ptr NULL for Preset!");
+  this->dataPtr->revision = NextRevision();
 }
 
 //////////////////////////////////////////////////
@@ -49,6 +114,7 @@ Preset::Preset(const std::string &_name)
     : dataPtr(new PresetPrivate(_name))
 {
   GZ_ASSERT(this->dataPtr != NULL, "Data ptr NULL for Preset!");
+  this->dataPtr->revision = NextRevision();
 }
 
 //////////////////////////////////////////////////
@@ -89,6 +155,53 @@ bool Preset::SetAllPhysicsParameters(PhysicsEnginePtr _physicsEngine) const
   return result;
 }
 
+//////////////////////////////////////////////////
+bool Preset::SetChangedPhysicsParameters(const Preset &_active,
+    PhysicsEnginePtr _physicsEngine) const
+{
+  if (!_physicsEngine)
+  {
+    gzwarn << "Physics engine for PresetManager is NULL. PresetManager will "
+           << "have no effect on simulation!" << std::endl;
+    return false;
+  }
+
+  PresetPrivate::Transition &transition =
+    this->dataPtr->transitions[_active.Name()];
+  if (transition.revision != this->dataPtr->revision ||
+      transition.fromRevision != _active.dataPtr->revision)
+  {
+    transition.revision = this->dataPtr->revision;
+    transition.fromRevision = _active.dataPtr->revision;
+    transition.params.clear();
+    for (auto const &param : this->dataPtr->parameterMap)
+    {
+      // disable params we know can't be set
+      if (param.first == "type")
+        continue;
+
+      auto active = _active.dataPtr->parameterMap.find(param.first);
+      if (active == _active.dataPtr->parameterMap.end() ||
+          !SameParam(param.second, active->second))
+      {
+        transition.params.push_back(param);
+      }
+    }
+  }
+
+  bool result = true;
+  for (auto const &param : transition.params)
+  {
+    if (!_physicsEngine->SetParam(param.first, param.second))
+    {
+      gzwarn << "Couldn't set parameter [" << param.first
+        << "] in physics engine" << std::endl;
+      result = false;
+    }
+  }
+  return result;
+}
+
 //////////////////////////////////////////////////
 bool Preset::SetAllParamsFromSDF(const sdf::ElementPtr _elem)
 {
@@ -164,9 +277,14 @@ bool Preset::SetParam(const std::string &_key, const boost::any &_value)
   bool result = true;
 
   if (_key.empty())
+  {
     result = false;
+  }
   else
+  {
     this->dataPtr->parameterMap[_key] = _value;
+    this->dataPtr->revision = NextRevision();
+  }
 
   return result;
 }
@@ -274,12 +392,26 @@ bool PresetManager::CurrentProfile(const std::string &_name)
     if (_name == this->CurrentProfile())
       return true;
 
+    const std::string previous = this->CurrentProfile();
     this->dataPtr->currentPreset = _name;
 
-    // For now, ignore the return value of this function, since not all
+    // Apply all the parameters between two physics updates. When switching
+    // profiles, only the parameters which differ are set.
+    // For now, ignore the return value of these functions, since not all
     // parameters are supported
-    this->CurrentPreset()->SetAllPhysicsParameters(
-        this->dataPtr->physicsEngine);
+    boost::recursive_mutex::scoped_lock physicsLock(
+        *this->dataPtr->physicsEngine->GetPhysicsUpdateMutex());
+    if (previous.empty() || !this->HasProfile(previous))
+    {
+      this->CurrentPreset()->SetAllPhysicsParameters(
+          this->dataPtr->physicsEngine);
+    }
+    else
+    {
+      this->CurrentPreset()->SetChangedPhysicsParameters(
+          this->dataPtr->presetProfiles[previous],
+          this->dataPtr->physicsEngine);
+    }
   }
 
   return true;
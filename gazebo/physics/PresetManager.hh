@@ -75,6 +75,17 @@ namespace gazebo
       public: bool SetAllPhysicsParameters(PhysicsEnginePtr _physicsEngine)
           const;
 
+      /// \brief Set the parameters of this preset which differ from another
+      /// preset in the physics engine, when switching from that preset. The
+      /// parameters to set are found once, and again only after either
+      /// preset changes.
+      /// \param[in] _active The preset active in the physics engine.
+      /// \param[in] _physicsEngine The physics engine in which to affect the
+      /// change.
+      /// \return True if setting the parameters was successful.
+      public: bool SetChangedPhysicsParameters(const Preset &_active,
+          PhysicsEnginePtr _physicsEngine) const;
+
       /// \brief Set all parameters of this preset based on the key/value pairs
       /// in the given SDF element.
       /// \param[in] _elem The physics SDF element from which to read values.
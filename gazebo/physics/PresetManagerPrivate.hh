@@ -17,9 +17,12 @@
 #ifndef _GAZEBO_PHYSICS_PRESETMANAGER_PRIVATE_HH_
 #define _GAZEBO_PHYSICS_PRESETMANAGER_PRIVATE_HH_
 
+#include <cstdint>
 #include <map>
 #include <string>
 #include <mutex>
+#include <utility>
+#include <vector>
 #include "gazebo/physics/PhysicsEngine.hh"
 
 namespace gazebo
@@ -45,6 +48,26 @@ namespace gazebo
 
       /// \brief SDF for the physics element represented by this object
       public: sdf::ElementPtr elementSDF;
+
+      /// \brief Revision of parameterMap, unique across all the presets.
+      public: uint64_t revision = 0;
+
+      /// \brief The parameters of a preset which differ from another one.
+      public: class Transition
+      {
+        /// \brief Revision of this preset when the parameters were found.
+        public: uint64_t revision = 0;
+
+        /// \brief Revision of the other preset.
+        public: uint64_t fromRevision = 0;
+
+        /// \brief Keys and values of the parameters to set.
+        public: std::vector<std::pair<std::string, boost::any>> params;
+      };
+
+      /// \brief Transitions from other presets, by their names. See
+      /// Preset::SetChangedPhysicsParameters.
+      public: std::map<std::string, Transition> transitions;
     };
 
     class Preset;
@@ -115,6 +115,47 @@ TEST_F(PresetManagerTest, GetSetProfileParam)
       value2));
 }
 
+/////////////////////////////////////////////////
+TEST_F(PresetManagerTest, SwitchProfile)
+{
+  Load("test/worlds/presets.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  physics::PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+  if (physics->GetType() != "ode")
+    return;
+  physics::PresetManagerPtr presetManager = world->PresetMgr();
+
+  // Two profiles which only differ by their step size
+  EXPECT_TRUE(presetManager->CreateProfile("fast"));
+  EXPECT_TRUE(presetManager->CreateProfile("accurate"));
+  EXPECT_TRUE(presetManager->SetProfileParam("fast", "max_step_size",
+        0.01));
+  EXPECT_TRUE(presetManager->SetProfileParam("accurate", "max_step_size",
+        0.001));
+  EXPECT_TRUE(presetManager->CurrentProfile("fast"));
+  EXPECT_DOUBLE_EQ(0.01, physics->GetMaxStepSize());
+
+  // Parameters which don't differ aren't written again
+  const int iters = boost::any_cast<int>(physics->GetParam("iters"));
+  EXPECT_TRUE(physics->SetParam("iters", iters + 1));
+  for (int i = 0; i < 2; ++i)
+  {
+    EXPECT_TRUE(presetManager->CurrentProfile("accurate"));
+    EXPECT_DOUBLE_EQ(0.001, physics->GetMaxStepSize());
+    EXPECT_TRUE(presetManager->CurrentProfile("fast"));
+    EXPECT_DOUBLE_EQ(0.01, physics->GetMaxStepSize());
+  }
+  EXPECT_EQ(iters + 1, boost::any_cast<int>(physics->GetParam("iters")));
+
+  // Changing a profile changes the parameters to write
+  EXPECT_TRUE(presetManager->SetProfileParam("accurate", "iters",
+        iters + 2));
+  EXPECT_TRUE(presetManager->CurrentProfile("accurate"));
+  EXPECT_EQ(iters + 2, boost::any_cast<int>(physics->GetParam("iters")));
+}
+
 /////////////////////////////////////////////////
 TEST_F(PresetManagerTest, CreateRemoveProfile)
 {
@@ -161,6 +161,10 @@ namespace gazebo
       /// \brief Name of the object this ray collided with
       private: std::string collisionName;
 
+      /// \brief MultiRayShape restores the collision names of the rays it
+      /// doesn't cast in MultiRayShape::UpdateRaySubset
+      protected: friend class MultiRayShape;
+
       /// \brief ODEMultiRayShape needs to call SetCollisionName when it is
       /// updated
       protected: friend class ODEMultiRayShape;
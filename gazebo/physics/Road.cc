@@ -99,6 +99,7 @@ void Road::Init()
       }
     }
   }
+  this->points.clear();
   sdf::ElementPtr pointElem = this->sdf->GetElement("point");
   while (pointElem)
   {
@@ -107,6 +108,7 @@ void Road::Init()
 
     msgs::Vector3d *ptMsg = msg.add_point();
     msgs::Set(ptMsg, point);
+    this->points.push_back(point);
   }
 
   this->roadPub->Publish(msg);
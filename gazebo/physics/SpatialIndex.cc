@@ -0,0 +1,345 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+
+#include <ignition/math/Helpers.hh>
+
+#include "gazebo/physics/SpatialIndex.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+namespace
+{
+  /// \brief Boxes spanning more cells are not stored in the cells.
+  const double kMaxCellsPerBox = 64;
+
+  /// \brief Cell coordinates are clamped to +/- this value, so they fit in
+  /// 21 bits.
+  const int64_t kMaxCellCoord = (1 << 20) - 1;
+
+  /// \brief Range of cells overlapped by a box.
+  struct CellRange
+  {
+    int64_t min[3];
+    int64_t max[3];
+
+    /// \brief Number of cells in the range, as a double so it can't
+    /// overflow.
+    double Count() const
+    {
+      return static_cast<double>(this->max[0] - this->min[0] + 1) *
+             static_cast<double>(this->max[1] - this->min[1] + 1) *
+             static_cast<double>(this->max[2] - this->min[2] + 1);
+    }
+
+    bool operator==(const CellRange &_r) const
+    {
+      return std::equal(this->min, this->min + 3, _r.min) &&
+             std::equal(this->max, this->max + 3, _r.max);
+    }
+  };
+
+  /// \brief Get whether a box has finite bounds.
+  bool IsBounded(const ignition::math::AxisAlignedBox &_box)
+  {
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      if (!std::isfinite(_box.Min()[i]) || !std::isfinite(_box.Max()[i]))
+        return false;
+    }
+    return true;
+  }
+
+  /// \brief Get whether two boxes overlap or touch.
+  bool Overlap(const ignition::math::AxisAlignedBox &_a,
+      const ignition::math::AxisAlignedBox &_b)
+  {
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      if (_a.Min()[i] > _b.Max()[i] || _b.Min()[i] > _a.Max()[i])
+        return false;
+    }
+    return true;
+  }
+
+  /// \brief Get the key of a cell.
+  uint64_t CellKey(const int64_t _x, const int64_t _y, const int64_t _z)
+  {
+    const uint64_t mask = (1 << 21) - 1;
+    return ((static_cast<uint64_t>(_x) & mask) << 42) |
+           ((static_cast<uint64_t>(_y) & mask) << 21) |
+           (static_cast<uint64_t>(_z) & mask);
+  }
+}
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief Private data for the SpatialIndex class
+    class SpatialIndexPrivate
+    {
+      /// \brief A box in the index.
+      public: struct Entry
+      {
+        /// \brief The box.
+        ignition::math::AxisAlignedBox box;
+
+        /// \brief Cells the box is stored in.
+        CellRange cells;
+
+        /// \brief True if the box is in the large list rather than cells.
+        bool large;
+      };
+
+      /// \brief Get the range of cells overlapped by a box.
+      /// \param[in] _box A bounded box.
+      /// \return The range.
+      public: CellRange Cells(const ignition::math::AxisAlignedBox &_box) const
+      {
+        CellRange range;
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+          range.min[i] = static_cast<int64_t>(ignition::math::clamp(
+              std::floor(_box.Min()[i] / this->cellSize),
+              static_cast<double>(-kMaxCellCoord),
+              static_cast<double>(kMaxCellCoord)));
+          range.max[i] = static_cast<int64_t>(ignition::math::clamp(
+              std::floor(_box.Max()[i] / this->cellSize),
+              static_cast<double>(-kMaxCellCoord),
+              static_cast<double>(kMaxCellCoord)));
+          range.max[i] = std::max(range.min[i], range.max[i]);
+        }
+        return range;
+      }
+
+      /// \brief Add or remove a box from the cells of a range.
+      /// \param[in] _id Identifier of the box.
+      /// \param[in] _range The cells.
+      /// \param[in] _add True to add, false to remove.
+      public: void Store(const unsigned int _id, const CellRange &_range,
+                  const bool _add)
+      {
+        for (int64_t x = _range.min[0]; x <= _range.max[0]; ++x)
+        {
+          for (int64_t y = _range.min[1]; y <= _range.max[1]; ++y)
+          {
+            for (int64_t z = _range.min[2]; z <= _range.max[2]; ++z)
+            {
+              uint64_t key = CellKey(x, y, z);
+              if (_add)
+              {
+                this->cells[key].push_back(_id);
+                continue;
+              }
+
+              auto iter = this->cells.find(key);
+              if (iter == this->cells.end())
+                continue;
+
+              auto &ids = iter->second;
+              ids.erase(std::remove(ids.begin(), ids.end(), _id), ids.end());
+              if (ids.empty())
+                this->cells.erase(iter);
+            }
+          }
+        }
+      }
+
+      /// \brief Size of the cells.
+      public: double cellSize;
+
+      /// \brief Boxes by identifier.
+      public: std::unordered_map<unsigned int, Entry> entries;
+
+      /// \brief Identifiers of the boxes in each cell.
+      public: std::unordered_map<uint64_t, std::vector<unsigned int>> cells;
+
+      /// \brief Identifiers of the boxes not stored in cells.
+      public: std::vector<unsigned int> large;
+    };
+  }
+}
+
+//////////////////////////////////////////////////
+SpatialIndex::SpatialIndex(const double _cellSize)
+  : dataPtr(new SpatialIndexPrivate)
+{
+  this->dataPtr->cellSize = _cellSize > 0 ? _cellSize : 4.0;
+}
+
+//////////////////////////////////////////////////
+SpatialIndex::~SpatialIndex()
+{
+}
+
+//////////////////////////////////////////////////
+double SpatialIndex::CellSize() const
+{
+  return this->dataPtr->cellSize;
+}
+
+//////////////////////////////////////////////////
+void SpatialIndex::Set(const unsigned int _id,
+    const ignition::math::AxisAlignedBox &_box)
+{
+  SpatialIndexPrivate::Entry entry;
+  entry.box = _box;
+  entry.large = !IsBounded(_box);
+  if (!entry.large)
+  {
+    entry.cells = this->dataPtr->Cells(_box);
+    entry.large = entry.cells.Count() > kMaxCellsPerBox;
+  }
+
+  auto iter = this->dataPtr->entries.find(_id);
+  if (iter != this->dataPtr->entries.end())
+  {
+    SpatialIndexPrivate::Entry &old = iter->second;
+
+    // Only touch the cells if the box moved to other cells
+    if (old.large == entry.large && (entry.large || old.cells == entry.cells))
+    {
+      old.box = _box;
+      return;
+    }
+    this->Remove(_id);
+  }
+
+  if (entry.large)
+    this->dataPtr->large.push_back(_id);
+  else
+    this->dataPtr->Store(_id, entry.cells, true);
+
+  this->dataPtr->entries[_id] = entry;
+}
+
+//////////////////////////////////////////////////
+void SpatialIndex::Remove(const unsigned int _id)
+{
+  auto iter = this->dataPtr->entries.find(_id);
+  if (iter == this->dataPtr->entries.end())
+    return;
+
+  if (iter->second.large)
+  {
+    auto &large = this->dataPtr->large;
+    large.erase(std::remove(large.begin(), large.end(), _id), large.end());
+  }
+  else
+  {
+    this->dataPtr->Store(_id, iter->second.cells, false);
+  }
+
+  this->dataPtr->entries.erase(iter);
+}
+
+//////////////////////////////////////////////////
+void SpatialIndex::Clear()
+{
+  this->dataPtr->entries.clear();
+  this->dataPtr->cells.clear();
+  this->dataPtr->large.clear();
+}
+
+//////////////////////////////////////////////////
+bool SpatialIndex::Has(const unsigned int _id) const
+{
+  return this->dataPtr->entries.find(_id) != this->dataPtr->entries.end();
+}
+
+//////////////////////////////////////////////////
+unsigned int SpatialIndex::Count() const
+{
+  return this->dataPtr->entries.size();
+}
+
+//////////////////////////////////////////////////
+std::vector<unsigned int> SpatialIndex::Ids() const
+{
+  std::vector<unsigned int> ids;
+  ids.reserve(this->dataPtr->entries.size());
+  for (auto const &entry : this->dataPtr->entries)
+    ids.push_back(entry.first);
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+//////////////////////////////////////////////////
+std::vector<unsigned int> SpatialIndex::Query(
+    const ignition::math::AxisAlignedBox &_box) const
+{
+  std::vector<unsigned int> result;
+
+  auto test = [&](const unsigned int _id)
+  {
+    auto iter = this->dataPtr->entries.find(_id);
+    if (iter != this->dataPtr->entries.end() &&
+        Overlap(iter->second.box, _box))
+    {
+      result.push_back(_id);
+    }
+  };
+
+  // Regions covering more cells than there are boxes test every box
+  CellRange range = CellRange();
+  bool scanAll = !IsBounded(_box);
+  if (!scanAll)
+  {
+    range = this->dataPtr->Cells(_box);
+    scanAll = range.Count() >
+        static_cast<double>(this->dataPtr->entries.size());
+  }
+
+  if (scanAll)
+  {
+    for (auto const &entry : this->dataPtr->entries)
+      test(entry.first);
+  }
+  else
+  {
+    for (auto const id : this->dataPtr->large)
+      test(id);
+
+    for (int64_t x = range.min[0]; x <= range.max[0]; ++x)
+    {
+      for (int64_t y = range.min[1]; y <= range.max[1]; ++y)
+      {
+        for (int64_t z = range.min[2]; z <= range.max[2]; ++z)
+        {
+          auto iter = this->dataPtr->cells.find(CellKey(x, y, z));
+          if (iter == this->dataPtr->cells.end())
+            continue;
+
+          for (auto const id : iter->second)
+            test(id);
+        }
+      }
+    }
+  }
+
+  // Boxes spanning several cells are found once per cell
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+  return result;
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_SPATIALINDEX_HH_
+#define GAZEBO_PHYSICS_SPATIALINDEX_HH_
+
+#include <memory>
+#include <vector>
+
+#include <ignition/math/AxisAlignedBox.hh>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class SpatialIndexPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class SpatialIndex SpatialIndex.hh physics/physics.hh
+    /// \brief Uniform grid of axis aligned boxes, to find the boxes that
+    /// overlap a region without testing all of them.
+    /// Each box is stored in the cells it overlaps. Moving a box only
+    /// touches the cells it enters and leaves. Boxes that span too many
+    /// cells, or are unbounded, are kept in a separate list that is tested
+    /// by every query.
+    /// This class is not thread safe.
+    class GZ_PHYSICS_VISIBLE SpatialIndex
+    {
+      /// \brief Constructor.
+      /// \param[in] _cellSize Size of the cells along each axis, in meters.
+      public: explicit SpatialIndex(const double _cellSize = 4.0);
+
+      /// \brief Destructor.
+      public: virtual ~SpatialIndex();
+
+      /// \brief Get the size of the cells.
+      /// \return Size of the cells along each axis, in meters.
+      public: double CellSize() const;
+
+      /// \brief Add a box, or move it if it is in the index.
+      /// \param[in] _id Identifier of the box.
+      /// \param[in] _box The box.
+      public: void Set(const unsigned int _id,
+                  const ignition::math::AxisAlignedBox &_box);
+
+      /// \brief Remove a box.
+      /// \param[in] _id Identifier of the box.
+      public: void Remove(const unsigned int _id);
+
+      /// \brief Remove all boxes.
+      public: void Clear();
+
+      /// \brief Get whether a box is in the index.
+      /// \param[in] _id Identifier of the box.
+      /// \return True if the box was added and not removed.
+      public: bool Has(const unsigned int _id) const;
+
+      /// \brief Get the number of boxes.
+      /// \return Number of boxes.
+      public: unsigned int Count() const;
+
+      /// \brief Get the identifiers of all boxes.
+      /// \return Identifiers in increasing order.
+      public: std::vector<unsigned int> Ids() const;
+
+      /// \brief Get the boxes overlapping a region. Boxes touching it are
+      /// included.
+      /// \param[in] _box The region.
+      /// \return Identifiers of the boxes, in increasing order.
+      public: std::vector<unsigned int> Query(
+                  const ignition::math::AxisAlignedBox &_box) const;
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<SpatialIndexPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <vector>
+#include <ignition/math/Helpers.hh>
+
+#include "gazebo/physics/SpatialIndex.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class SpatialIndexTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+ignition::math::AxisAlignedBox Box(const double _x, const double _y,
+    const double _z, const double _size = 1.0)
+{
+  return ignition::math::AxisAlignedBox(
+      ignition::math::Vector3d(_x, _y, _z),
+      ignition::math::Vector3d(_x + _size, _y + _size, _z + _size));
+}
+
+/////////////////////////////////////////////////
+TEST_F(SpatialIndexTest, SetQuery)
+{
+  physics::SpatialIndex index(2.0);
+  EXPECT_DOUBLE_EQ(index.CellSize(), 2.0);
+  EXPECT_EQ(index.Count(), 0u);
+  EXPECT_TRUE(index.Query(Box(0, 0, 0)).empty());
+
+  index.Set(3, Box(0, 0, 0));
+  index.Set(1, Box(10, 0, 0));
+  index.Set(2, Box(-10, -10, -10));
+  EXPECT_EQ(index.Count(), 3u);
+  EXPECT_TRUE(index.Has(1));
+  EXPECT_FALSE(index.Has(4));
+  EXPECT_EQ(index.Ids(), std::vector<unsigned int>({1, 2, 3}));
+
+  EXPECT_EQ(index.Query(Box(0.5, 0.5, 0.5)),
+      std::vector<unsigned int>({3}));
+
+  // Touching boxes are included
+  EXPECT_EQ(index.Query(Box(1, 1, 1)), std::vector<unsigned int>({3}));
+
+  // A box in the same cell that does not overlap
+  EXPECT_TRUE(index.Query(Box(1.5, 1.5, 1.5, 0.2)).empty());
+
+  // A region spanning several boxes
+  EXPECT_EQ(index.Query(Box(-10, -10, -10, 20.5)),
+      std::vector<unsigned int>({1, 2, 3}));
+
+  // A region much larger than the boxes
+  EXPECT_EQ(index.Query(Box(-1000, -1000, -1000, 2000)),
+      std::vector<unsigned int>({1, 2, 3}));
+}
+
+/////////////////////////////////////////////////
+TEST_F(SpatialIndexTest, MoveRemove)
+{
+  physics::SpatialIndex index(2.0);
+  index.Set(1, Box(0, 0, 0));
+  index.Set(2, Box(10, 0, 0));
+
+  // Move within the same cells
+  index.Set(1, Box(0.5, 0, 0));
+  EXPECT_EQ(index.Query(Box(1.2, 0, 0, 0.2)),
+      std::vector<unsigned int>({1}));
+  EXPECT_EQ(index.Count(), 2u);
+
+  // Move to other cells
+  index.Set(1, Box(20, 20, 20));
+  EXPECT_TRUE(index.Query(Box(0, 0, 0)).empty());
+  EXPECT_EQ(index.Query(Box(20.5, 20.5, 20.5)),
+      std::vector<unsigned int>({1}));
+  EXPECT_EQ(index.Count(), 2u);
+
+  index.Remove(1);
+  EXPECT_FALSE(index.Has(1));
+  EXPECT_TRUE(index.Query(Box(20.5, 20.5, 20.5)).empty());
+  EXPECT_EQ(index.Count(), 1u);
+
+  // Removing an unknown box does nothing
+  index.Remove(7);
+  EXPECT_EQ(index.Count(), 1u);
+
+  index.Clear();
+  EXPECT_EQ(index.Count(), 0u);
+  EXPECT_TRUE(index.Query(Box(10, 0, 0)).empty());
+}
+
+/////////////////////////////////////////////////
+TEST_F(SpatialIndexTest, Large)
+{
+  physics::SpatialIndex index(1.0);
+
+  // Spans more cells than are stored per box
+  index.Set(1, Box(-50, -50, -1, 100));
+  index.Set(2, Box(5, 5, 5));
+
+  EXPECT_EQ(index.Query(Box(5.2, 5.2, 5.2, 0.1)),
+      std::vector<unsigned int>({1, 2}));
+  EXPECT_EQ(index.Query(Box(-40, -40, 0, 0.1)),
+      std::vector<unsigned int>({1}));
+  EXPECT_TRUE(index.Query(Box(200, 0, 0)).empty());
+
+  // Shrinks back into the cells
+  index.Set(1, Box(-40, -40, 0));
+  EXPECT_EQ(index.Query(Box(5.2, 5.2, 5.2, 0.1)),
+      std::vector<unsigned int>({2}));
+  EXPECT_EQ(index.Query(Box(-40, -40, 0, 0.1)),
+      std::vector<unsigned int>({1}));
+
+  // Unbounded boxes and regions
+  const double inf = ignition::math::INF_D;
+  index.Set(3, ignition::math::AxisAlignedBox(
+      ignition::math::Vector3d(-inf, -inf, -inf),
+      ignition::math::Vector3d(inf, inf, 0)));
+  EXPECT_EQ(index.Query(Box(5.2, 5.2, -5.2, 0.1)),
+      std::vector<unsigned int>({3}));
+  EXPECT_EQ(index.Query(ignition::math::AxisAlignedBox(
+      ignition::math::Vector3d(-inf, -inf, -inf),
+      ignition::math::Vector3d(inf, inf, inf))),
+      std::vector<unsigned int>({1, 2, 3}));
+
+  index.Remove(3);
+  EXPECT_TRUE(index.Query(Box(5.2, 5.2, -5.2, 0.1)).empty());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
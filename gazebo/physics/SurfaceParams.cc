@@ -15,6 +15,9 @@
  *
 */
 
+#include <cmath>
+#include <limits>
+
 #include <ignition/math/Helpers.hh>
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Console.hh"
@@ -30,6 +33,11 @@ FrictionPyramid::FrictionPyramid()
   , usePatchRadius(1)
   , poissonsRatio(0.3)
   , elasticModulus(0)
+  , trackVelocity(0)
+  , trackTurnCenter(ignition::math::Vector3d(
+        std::numeric_limits<double>::infinity(),
+        std::numeric_limits<double>::infinity(),
+        std::numeric_limits<double>::infinity()))
 {
   this->mu[0] = 1.0;
   this->mu[1] = 1.0;
@@ -159,6 +167,83 @@ void FrictionPyramid::SetElasticModulus(const double _modulus)
   }
 }
 
+//////////////////////////////////////////////////
+ignition::math::Vector3d FrictionPyramid::TrackAxis() const
+{
+  return this->trackAxis;
+}
+
+//////////////////////////////////////////////////
+void FrictionPyramid::SetTrackAxis(const ignition::math::Vector3d &_axis)
+{
+  this->trackAxis = _axis;
+  if (this->trackAxis != ignition::math::Vector3d::Zero)
+    this->trackAxis.Normalize();
+}
+
+//////////////////////////////////////////////////
+double FrictionPyramid::TrackVelocity() const
+{
+  return this->trackVelocity;
+}
+
+//////////////////////////////////////////////////
+void FrictionPyramid::SetTrackVelocity(const double _velocity)
+{
+  this->trackVelocity = _velocity;
+}
+
+//////////////////////////////////////////////////
+ignition::math::Vector3d FrictionPyramid::TrackTurnCenter() const
+{
+  return this->trackTurnCenter;
+}
+
+//////////////////////////////////////////////////
+void FrictionPyramid::SetTrackTurnCenter(
+    const ignition::math::Vector3d &_center)
+{
+  this->trackTurnCenter = _center;
+}
+
+//////////////////////////////////////////////////
+bool FrictionPyramid::TrackContact(const ignition::math::Pose3d &_pose,
+    const ignition::math::Vector3d &_position,
+    const ignition::math::Vector3d &_normal,
+    ignition::math::Vector3d &_direction, double &_velocity) const
+{
+  if (this->trackAxis == ignition::math::Vector3d::Zero)
+    return false;
+
+  // The normal points into the track
+  ignition::math::Vector3d normal = _normal;
+  if (normal.Dot(_pose.Pos() - _position) < 0)
+    normal = -normal;
+
+  // Direction in which the belt moves at the contact
+  ignition::math::Vector3d belt =
+    normal.Cross(_pose.Rot().RotateVector(this->trackAxis));
+  if (belt.SquaredLength() < 1e-12)
+    return false;
+  belt.Normalize();
+
+  _direction = belt;
+  if (std::isfinite(this->trackTurnCenter.X()) &&
+      std::isfinite(this->trackTurnCenter.Y()) &&
+      std::isfinite(this->trackTurnCenter.Z()))
+  {
+    // Tangent to the circle around the center of the turn. Its sign
+    // doesn't matter, since the velocity follows it.
+    const ignition::math::Vector3d tangent =
+      normal.Cross(_position - this->trackTurnCenter);
+    if (tangent.SquaredLength() > 1e-12)
+      _direction = ignition::math::Vector3d(tangent).Normalize();
+  }
+
+  _velocity = this->trackVelocity * belt.Dot(_direction);
+  return true;
+}
+
 //////////////////////////////////////////////////
 double FrictionPyramid::Mu(const unsigned int _index) const
 {
@@ -216,6 +301,23 @@ void SurfaceParams::Load(sdf::ElementPtr _sdf)
           contactElem->Get<unsigned int>("collide_bitmask");
       }
     }
+
+    // Tracks, driven by the physics engine
+    FrictionPyramidPtr friction = this->FrictionPyramid();
+    if (friction && _sdf->HasElement("friction"))
+    {
+      sdf::ElementPtr frictionElem = _sdf->GetElement("friction");
+      if (frictionElem->HasElement("gz:track_axis"))
+      {
+        friction->SetTrackAxis(frictionElem->Get<ignition::math::Vector3d>(
+              "gz:track_axis"));
+      }
+      if (frictionElem->HasElement("gz:track_velocity"))
+      {
+        friction->SetTrackVelocity(
+            frictionElem->Get<double>("gz:track_velocity"));
+      }
+    }
   }
 }
 
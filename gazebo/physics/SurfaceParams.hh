@@ -18,6 +18,7 @@
 #define GAZEBO_PHYSICS_SURFACEPARAMS_HH_
 
 #include <sdf/sdf.hh>
+#include <ignition/math/Pose3.hh>
 #include <ignition/math/Vector3.hh>
 
 #include "gazebo/msgs/msgs.hh"
@@ -105,6 +106,56 @@ namespace gazebo
       /// \param[in] _modulus elastic modulus to set to
       public: void SetElasticModulus(const double _modulus);
 
+      /// \brief Get the axis around which the belt of a track turns.
+      /// \return Axis in the collision frame, zero when the surface isn't a
+      /// track.
+      public: ignition::math::Vector3d TrackAxis() const;
+
+      /// \brief Make the surface a track, whose belt turns around an axis.
+      /// At contacts, the physics engine drives the surface along the belt,
+      /// the cross product of the normal pointing into the collision and
+      /// the axis, without plugins processing the contacts.
+      /// \param[in] _axis Axis in the collision frame, or zero to disable.
+      public: void SetTrackAxis(const ignition::math::Vector3d &_axis);
+
+      /// \brief Get the velocity of the belt of a track.
+      /// \return Velocity relative to the link, in m/s.
+      public: double TrackVelocity() const;
+
+      /// \brief Set the velocity of the belt of a track.
+      /// \param[in] _velocity Velocity relative to the link, in m/s, along
+      /// the belt direction at the contacts.
+      public: void SetTrackVelocity(const double _velocity);
+
+      /// \brief Get the center of the turn of a tracked vehicle.
+      /// \return Center in the world frame, not finite when driving
+      /// straight.
+      public: ignition::math::Vector3d TrackTurnCenter() const;
+
+      /// \brief Set the center of the turn of a tracked vehicle. The primary
+      /// friction direction of the contacts of a track is then tangent to the
+      /// circle around the center, instead of along the belt.
+      /// \param[in] _center Center in the world frame, or a vector which
+      /// isn't finite when driving straight.
+      public: void SetTrackTurnCenter(const ignition::math::Vector3d &_center);
+
+      /// \brief Get the primary friction direction and the surface velocity
+      /// along it at a contact of a track.
+      /// \param[in] _pose World pose of the collision.
+      /// \param[in] _position Position of the contact, in the world frame.
+      /// \param[in] _normal Normal of the contact, in the world frame, in
+      /// either direction.
+      /// \param[out] _direction Unit primary friction direction.
+      /// \param[out] _velocity Velocity of the surface along _direction,
+      /// relative to the link.
+      /// \return False if the surface isn't a track, or the contact is on
+      /// the side of the belt.
+      public: bool TrackContact(const ignition::math::Pose3d &_pose,
+                  const ignition::math::Vector3d &_position,
+                  const ignition::math::Vector3d &_normal,
+                  ignition::math::Vector3d &_direction,
+                  double &_velocity) const;
+
       /// \brief Vector for specifying the primary friction direction,
       /// relative to the parent collision frame. The component of this
       /// vector that is orthogonal to the surface normal will be set
@@ -158,6 +209,15 @@ namespace gazebo
 
       /// \brief Elastic modulus.
       private: double elasticModulus;
+
+      /// \brief Axis of the belt of a track, in the collision frame.
+      private: ignition::math::Vector3d trackAxis;
+
+      /// \brief Velocity of the belt of a track.
+      private: double trackVelocity;
+
+      /// \brief Center of the turn of a tracked vehicle, in the world frame.
+      private: ignition::math::Vector3d trackTurnCenter;
     };
 
     /// \class SurfaceParams SurfaceParams.hh physics/physics.hh
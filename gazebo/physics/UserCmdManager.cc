@@ -16,9 +16,15 @@
  */
 #include <boost/algorithm/string.hpp>
 #include <boost/range/adaptor/reversed.hpp>
+#include <string>
+#include <vector>
 
 #include "gazebo/transport/transport.hh"
 
+#include "gazebo/physics/Light.hh"
+#include "gazebo/physics/LightState.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/ModelState.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/WorldState.hh"
 
@@ -29,28 +35,136 @@ using namespace gazebo;
 using namespace physics;
 
 
+namespace
+{
+  /// \brief Record the state of the given entities, or of the whole world
+  /// if there are none, as a serialized msgs::WorldState.
+  /// \param[in] _world Pointer to the world.
+  /// \param[in] _entities Names of the models and lights to record.
+  /// \return Serialized state.
+  std::string RecordState(const WorldPtr &_world,
+      const std::vector<std::string> &_entities)
+  {
+    msgs::WorldState msg;
+    if (_entities.empty())
+    {
+      WorldState(_world).FillMsg(msg);
+    }
+    else
+    {
+      const common::Time realTime = _world->RealTime();
+      const common::Time simTime = _world->SimTime();
+      const uint64_t iterations = _world->Iterations();
+
+      msg.set_name(_world->Name());
+      msgs::Set(msg.mutable_sim_time(), simTime);
+      msgs::Set(msg.mutable_real_time(), realTime);
+      msg.set_iterations(iterations);
+
+      for (auto const &name : _entities)
+      {
+        if (ModelPtr model = _world->ModelByName(name))
+        {
+          ModelState(model, realTime, simTime, iterations).FillMsg(
+              *msg.add_model());
+        }
+        else if (LightPtr light = _world->LightByName(name))
+        {
+          LightState(light, realTime, simTime, iterations).FillMsg(
+              *msg.add_light());
+        }
+      }
+    }
+
+    std::string data;
+    msg.SerializeToString(&data);
+    return data;
+  }
+
+  /// \brief Restore a state recorded with RecordState.
+  /// \param[in] _world Pointer to the world.
+  /// \param[in] _entities Names of the entities the state was recorded for.
+  /// \param[in] _data Serialized state.
+  void RestoreState(const WorldPtr &_world,
+      const std::vector<std::string> &_entities, const std::string &_data)
+  {
+    msgs::WorldState msg;
+    if (!msg.ParseFromString(_data))
+    {
+      gzerr << "Unable to parse recorded user command state" << std::endl;
+      return;
+    }
+
+    if (_entities.empty())
+    {
+      WorldState state;
+      state.Load(msg);
+
+      // Reset physics states for the whole world
+      _world->ResetPhysicsStates();
+      _world->SetState(state);
+      return;
+    }
+
+    // Only the touched entities are restored, the rest of the world and the
+    // simulation time are left as they are
+    for (int i = 0; i < msg.model_size(); ++i)
+    {
+      ModelPtr model = _world->ModelByName(msg.model(i).name());
+      if (!model)
+        continue;
+
+      ModelState state;
+      state.Load(msg.model(i));
+      model->ResetPhysicsStates();
+      model->SetState(state);
+    }
+
+    for (int i = 0; i < msg.light_size(); ++i)
+    {
+      LightPtr light = _world->LightByName(msg.light(i).name());
+      if (!light)
+        continue;
+
+      LightState state;
+      state.Load(msg.light(i));
+      light->SetState(state);
+    }
+  }
+}
+
 /////////////////////////////////////////////////
 UserCmd::UserCmd(const unsigned int _id,
                  physics::WorldPtr _world,
                  const std::string &_description,
                  const msgs::UserCmd::Type &_type)
+  : UserCmd(_id, _world, _description, _type, {})
+{
+}
+
+/////////////////////////////////////////////////
+UserCmd::UserCmd(const unsigned int _id,
+                 physics::WorldPtr _world,
+                 const std::string &_description,
+                 const msgs::UserCmd::Type &_type,
+                 const std::vector<std::string> &_entities)
   : dataPtr(new UserCmdPrivate())
 {
   this->dataPtr->id = _id;
   this->dataPtr->world = _world;
   this->dataPtr->description = _description;
   this->dataPtr->type = _type;
+  this->dataPtr->entities = _entities;
 
-  // Record current world state
-  this->dataPtr->startState = WorldState(this->dataPtr->world);
+  // Record current state
+  this->dataPtr->startState = RecordState(this->dataPtr->world,
+      this->dataPtr->entities);
 }
 
 /////////////////////////////////////////////////
 UserCmd::~UserCmd()
 {
   this->dataPtr->world.reset();
-  this->dataPtr->startState.SetWorld(WorldPtr());
-  this->dataPtr->endState.SetWorld(WorldPtr());
 
   delete this->dataPtr;
   this->dataPtr = NULL;
@@ -60,23 +174,20 @@ UserCmd::~UserCmd()
 void UserCmd::Undo()
 {
   // Record / override the state for redo
-  this->dataPtr->endState = WorldState(this->dataPtr->world);
-
-  // Reset physics states for the whole world
-  this->dataPtr->world->ResetPhysicsStates();
+  this->dataPtr->endState = RecordState(this->dataPtr->world,
+      this->dataPtr->entities);
 
   // Set state to the moment the command was executed
-  this->dataPtr->world->SetState(this->dataPtr->startState);
+  RestoreState(this->dataPtr->world, this->dataPtr->entities,
+      this->dataPtr->startState);
 }
 
 /////////////////////////////////////////////////
 void UserCmd::Redo()
 {
-  // Reset physics states for the whole world
-  this->dataPtr->world->ResetPhysicsStates();
-
   // Set state to the moment undo was triggered
-  this->dataPtr->world->SetState(this->dataPtr->endState);
+  RestoreState(this->dataPtr->world, this->dataPtr->entities,
+      this->dataPtr->endState);
 }
 
 /////////////////////////////////////////////////
@@ -97,6 +208,12 @@ msgs::UserCmd::Type UserCmd::Type() const
   return this->dataPtr->type;
 }
 
+/////////////////////////////////////////////////
+size_t UserCmd::StateSize() const
+{
+  return this->dataPtr->startState.size() + this->dataPtr->endState.size();
+}
+
 /////////////////////////////////////////////////
 UserCmdManager::UserCmdManager(const WorldPtr _world)
   : dataPtr(new UserCmdManagerPrivate())
@@ -160,9 +277,21 @@ void UserCmdManager::OnUserCmdMsg(ConstUserCmdPtr &_msg)
   // Generate unique id
   unsigned int id = this->dataPtr->idCounter++;
 
+  // Moving and scaling only touch the entities in the message, so only their
+  // state needs to be recorded
+  std::vector<std::string> entities;
+  if (_msg->type() == msgs::UserCmd::MOVING ||
+      _msg->type() == msgs::UserCmd::SCALING)
+  {
+    for (int i = 0; i < _msg->model_size(); ++i)
+      entities.push_back(_msg->model(i).name());
+    for (int i = 0; i < _msg->light_size(); ++i)
+      entities.push_back(_msg->light(i).name());
+  }
+
   // Create command
   UserCmdPtr cmd(new UserCmd(id, this->dataPtr->world, _msg->description(),
-      _msg->type()));
+      _msg->type(), entities));
 
   // Forward message after we've saved the current state
   switch (_msg->type())
@@ -226,6 +355,8 @@ void UserCmdManager::OnUserCmdMsg(ConstUserCmdPtr &_msg)
   // Clear redo list
   this->dataPtr->redoCmds.clear();
 
+  this->TrimHistory();
+
   // Publish stats
   this->PublishCurrentStats();
 }
@@ -328,9 +459,54 @@ void UserCmdManager::OnUndoRedoMsg(ConstUndoRedoPtr &_msg)
     }
   }
 
+  // Undo records a new state for redo
+  this->TrimHistory();
+
   this->PublishCurrentStats();
 }
 
+/////////////////////////////////////////////////
+void UserCmdManager::SetMaxHistorySize(const size_t _bytes)
+{
+  this->dataPtr->maxHistorySize = _bytes;
+  this->TrimHistory();
+}
+
+/////////////////////////////////////////////////
+size_t UserCmdManager::MaxHistorySize() const
+{
+  return this->dataPtr->maxHistorySize;
+}
+
+/////////////////////////////////////////////////
+void UserCmdManager::TrimHistory()
+{
+  size_t size = 0;
+  for (auto const &cmd : this->dataPtr->undoCmds)
+    size += cmd->StateSize();
+  for (auto const &cmd : this->dataPtr->redoCmds)
+    size += cmd->StateSize();
+
+  // Drop the oldest undo commands first, then the furthest redo commands
+  auto undoEnd = this->dataPtr->undoCmds.begin();
+  while (size > this->dataPtr->maxHistorySize &&
+      undoEnd != this->dataPtr->undoCmds.end())
+  {
+    size -= (*undoEnd)->StateSize();
+    ++undoEnd;
+  }
+  this->dataPtr->undoCmds.erase(this->dataPtr->undoCmds.begin(), undoEnd);
+
+  auto redoEnd = this->dataPtr->redoCmds.begin();
+  while (size > this->dataPtr->maxHistorySize &&
+      redoEnd != this->dataPtr->redoCmds.end())
+  {
+    size -= (*redoEnd)->StateSize();
+    ++redoEnd;
+  }
+  this->dataPtr->redoCmds.erase(this->dataPtr->redoCmds.begin(), redoEnd);
+}
+
 /////////////////////////////////////////////////
 void UserCmdManager::PublishCurrentStats()
 {
@@ -18,6 +18,7 @@
 #define GAZEBO_PHYSICS_USERCMDMANAGER_HH_
 
 #include <string>
+#include <vector>
 
 #include "gazebo/transport/TransportTypes.hh"
 
@@ -45,6 +46,21 @@ namespace gazebo
                       const std::string &_description,
                       const msgs::UserCmd::Type &_type);
 
+      /// \brief Constructor for a command which only touches some entities.
+      /// Only the state of those entities is recorded and restored.
+      /// \param[in] _id Unique ID for this command
+      /// \param[in] _world Pointer to the world
+      /// \param[in] _description Description for the command, such as
+      /// "Rotate box", "Delete sphere", etc.
+      /// \param[in] _type Type of command, such as MOVING, DELETING, etc.
+      /// \param[in] _entities Names of the models and lights the command
+      /// touches. If empty, the whole world state is recorded.
+      public: UserCmd(const unsigned int _id,
+                      physics::WorldPtr _world,
+                      const std::string &_description,
+                      const msgs::UserCmd::Type &_type,
+                      const std::vector<std::string> &_entities);
+
       /// \brief Destructor
       public: virtual ~UserCmd();
 
@@ -66,6 +82,10 @@ namespace gazebo
       /// \return Command type
       public: msgs::UserCmd::Type Type() const;
 
+      /// \brief Return the number of bytes used by the recorded states.
+      /// \return Size of the recorded states in bytes
+      public: size_t StateSize() const;
+
       /// \internal
       /// \brief Pointer to private data.
       protected: UserCmdPrivate *dataPtr;
@@ -83,6 +103,16 @@ namespace gazebo
       /// \brief Destructor.
       public: virtual ~UserCmdManager();
 
+      /// \brief Set the maximum number of bytes of recorded states kept for
+      /// undo and redo. The oldest commands are dropped beyond it.
+      /// \param[in] _bytes Maximum history size in bytes.
+      public: void SetMaxHistorySize(const size_t _bytes);
+
+      /// \brief Get the maximum number of bytes of recorded states kept for
+      /// undo and redo.
+      /// \return Maximum history size in bytes.
+      public: size_t MaxHistorySize() const;
+
       /// \brief Callback when a UserCmd message is received, notifying that
       /// a new command has been executed by a user.
       /// \param[in] _msg Incoming message
@@ -96,6 +126,10 @@ namespace gazebo
       /// \brief Publish a message about current user command statistics.
       private: void PublishCurrentStats();
 
+      /// \brief Drop the oldest commands until the recorded states fit in
+      /// the maximum history size.
+      private: void TrimHistory();
+
       /// \internal
       /// \brief Pointer to private data.
       private: UserCmdManagerPrivate *dataPtr;
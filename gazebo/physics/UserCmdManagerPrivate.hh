@@ -29,8 +29,6 @@ namespace gazebo
 {
   namespace physics
   {
-    class WorldState;
-
     /// \internal
     /// \brief Private data for the UserCmdManager class
     class UserCmdPrivate
@@ -38,12 +36,17 @@ namespace gazebo
       /// \brief Pointer to the world.
       public: WorldPtr world;
 
-      /// \brief Whole world state the moment the user command was executed.
-      public: WorldState startState;
+      /// \brief Names of the models and lights the command touched. Empty
+      /// if the command affects the whole world.
+      public: std::vector<std::string> entities;
+
+      /// \brief Serialized msgs::WorldState of the touched entities the
+      /// moment the user command was executed.
+      public: std::string startState;
 
-      /// \brief Whole world state for the most recent time the user has
-      /// triggered undo for this command.
-      public: WorldState endState;
+      /// \brief Serialized msgs::WorldState of the touched entities for the
+      /// most recent time the user has triggered undo for this command.
+      public: std::string endState;
 
       /// \brief Unique ID identifying this command in the server.
       public: unsigned int id;
@@ -93,6 +96,10 @@ namespace gazebo
 
       /// \brief List of commands which can be redone.
       public: std::vector<UserCmdPtr> redoCmds;
+
+      /// \brief Maximum number of bytes of recorded states kept in the undo
+      /// and redo lists, the oldest commands are dropped beyond it.
+      public: size_t maxHistorySize = 64u * 1024u * 1024u;
     };
   }
 }
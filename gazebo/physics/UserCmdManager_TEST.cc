@@ -61,6 +61,56 @@ TEST_F(UserCmdManagerTest, CreateCmd)
   manager = NULL;
 }
 
+/////////////////////////////////////////////////
+TEST_F(UserCmdManagerTest, EntityState)
+{
+  Load("worlds/shapes.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  physics::ModelPtr box = world->ModelByName("box");
+  physics::ModelPtr sphere = world->ModelByName("sphere");
+  ASSERT_TRUE(box != NULL);
+  ASSERT_TRUE(sphere != NULL);
+  const ignition::math::Pose3d boxPose = box->WorldPose();
+  const ignition::math::Pose3d spherePose = sphere->WorldPose();
+
+  // A command touching a single model records less than the whole world
+  physics::UserCmd worldCmd(0, world, "World", msgs::UserCmd::WORLD_CONTROL);
+  physics::UserCmd cmd(1, world, "Move box", msgs::UserCmd::MOVING, {"box"});
+  EXPECT_GT(cmd.StateSize(), 0u);
+  EXPECT_LT(cmd.StateSize(), worldCmd.StateSize());
+
+  // Only the touched model is restored on undo
+  const ignition::math::Pose3d moved(1, 2, 3, 0, 0, 0);
+  box->SetWorldPose(moved);
+  sphere->SetWorldPose(moved);
+  cmd.Undo();
+  EXPECT_EQ(boxPose, box->WorldPose());
+  EXPECT_EQ(moved, sphere->WorldPose());
+
+  cmd.Redo();
+  EXPECT_EQ(moved, box->WorldPose());
+
+  sphere->SetWorldPose(spherePose);
+}
+
+/////////////////////////////////////////////////
+TEST_F(UserCmdManagerTest, MaxHistorySize)
+{
+  Load("test/worlds/empty_test.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  physics::UserCmdManager manager(world);
+  EXPECT_GT(manager.MaxHistorySize(), 0u);
+
+  manager.SetMaxHistorySize(1024u);
+  EXPECT_EQ(1024u, manager.MaxHistorySize());
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
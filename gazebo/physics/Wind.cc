@@ -15,7 +15,10 @@
  *
 */
 
+#include <algorithm>
+#include <cmath>
 #include <functional>
+#include <mutex>
 #include <boost/lexical_cast.hpp>
 #include <sdf/sdf.hh>
 
@@ -57,6 +60,26 @@ namespace gazebo
       public: std::function< ignition::math::Vector3d (
                   const Wind *, const Entity *)> linearVelFunc;
 
+      /// \brief Position of the first node of the velocity grid.
+      public: ignition::math::Vector3d gridMin;
+
+      /// \brief Distance between two nodes along each axis.
+      public: ignition::math::Vector3d gridCell;
+
+      /// \brief Number of nodes along each axis.
+      public: ignition::math::Vector3i gridSize;
+
+      /// \brief Velocities of the nodes for each frame of the grid. Empty
+      /// if there's no grid.
+      public: std::vector<std::vector<ignition::math::Vector3d>> gridFrames;
+
+      /// \brief Sim time between two frames of the grid.
+      public: double gridPeriod = 0.0;
+
+      /// \brief Protects the grid, which is usually set by a plugin while
+      /// the links query it.
+      public: mutable std::mutex gridMutex;
+
       // Transport is declared last.
       /// \brief Node for communication.
       public: transport::NodePtr node;
@@ -76,6 +99,104 @@ namespace gazebo
 using namespace gazebo;
 using namespace physics;
 
+/// \brief Select the two frames of the grid around a time. The grid mutex
+/// must be locked.
+/// \param[in] _data Private data of the wind.
+/// \param[in] _time Sim time in seconds.
+/// \param[out] _first Index of the frame before the time.
+/// \param[out] _second Index of the frame after the time.
+/// \param[out] _weight Weight of the second frame.
+static void SelectFrames(const WindPrivate &_data, const double _time,
+    size_t &_first, size_t &_second, double &_weight)
+{
+  const size_t count = _data.gridFrames.size();
+  if (count < 2)
+  {
+    _first = _second = 0;
+    _weight = 0.0;
+    return;
+  }
+
+  double t = std::fmod(_time / _data.gridPeriod, static_cast<double>(count));
+  if (t < 0.0)
+    t += count;
+  _first = std::min(static_cast<size_t>(t), count - 1);
+  _second = (_first + 1) % count;
+  _weight = t - _first;
+}
+
+/// \brief Interpolate a frame of the grid trilinearly. The grid mutex must
+/// be locked.
+/// \param[in] _data Private data of the wind.
+/// \param[in] _frame Velocities of the nodes.
+/// \param[in] _pos Position in world frame.
+/// \return The velocity at the position.
+static ignition::math::Vector3d SampleFrame(const WindPrivate &_data,
+    const std::vector<ignition::math::Vector3d> &_frame,
+    const ignition::math::Vector3d &_pos)
+{
+  int index[3];
+  double weight[3];
+  for (int a = 0; a < 3; ++a)
+  {
+    const int n = _data.gridSize[a];
+    if (n < 2)
+    {
+      index[a] = 0;
+      weight[a] = 0.0;
+      continue;
+    }
+
+    // Positions outside of the grid are clamped to it
+    const double t = ignition::math::clamp(
+        (_pos[a] - _data.gridMin[a]) / _data.gridCell[a], 0.0, n - 1.0);
+    index[a] = std::min(static_cast<int>(t), n - 2);
+    weight[a] = t - index[a];
+  }
+
+  ignition::math::Vector3d vel;
+  for (int corner = 0; corner < 8; ++corner)
+  {
+    double w = 1.0;
+    int node[3];
+    for (int a = 0; a < 3; ++a)
+    {
+      const bool upper = corner & (1 << a);
+      w *= upper ? weight[a] : 1.0 - weight[a];
+      node[a] = index[a] + (upper ? 1 : 0);
+    }
+
+    if (w > 0.0)
+    {
+      vel += w * _frame[node[0] + _data.gridSize.X() *
+          (node[1] + _data.gridSize.Y() * node[2])];
+    }
+  }
+  return vel;
+}
+
+/// \brief Interpolate the grid in space and time. The grid mutex must be
+/// locked.
+/// \param[in] _data Private data of the wind.
+/// \param[in] _pos Position in world frame.
+/// \param[in] _first Index of the frame before the time.
+/// \param[in] _second Index of the frame after the time.
+/// \param[in] _weight Weight of the second frame.
+/// \return The velocity at the position.
+static ignition::math::Vector3d SampleGrid(const WindPrivate &_data,
+    const ignition::math::Vector3d &_pos, const size_t _first,
+    const size_t _second, const double _weight)
+{
+  ignition::math::Vector3d vel = SampleFrame(_data,
+      _data.gridFrames[_first], _pos);
+  if (_weight > 0.0)
+  {
+    vel += _weight * (SampleFrame(_data, _data.gridFrames[_second], _pos) -
+        vel);
+  }
+  return vel;
+}
+
 //////////////////////////////////////////////////
 Wind::Wind(World &_world, sdf::ElementPtr _sdf)
   : dataPtr(new WindPrivate(_world))
@@ -117,9 +238,57 @@ ignition::math::Vector3d Wind::LinearVelDefault(
 //////////////////////////////////////////////////
 ignition::math::Vector3d Wind::WorldLinearVel(const Entity *_entity) const
 {
+  if (_entity)
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->gridMutex);
+    if (!this->dataPtr->gridFrames.empty())
+    {
+      size_t first, second;
+      double weight;
+      SelectFrames(*this->dataPtr, this->dataPtr->world.SimTime().Double(),
+          first, second, weight);
+      return SampleGrid(*this->dataPtr, _entity->WorldPose().Pos(),
+          first, second, weight);
+    }
+  }
+
   return this->dataPtr->linearVelFunc(this, _entity);
 }
 
+//////////////////////////////////////////////////
+void Wind::WorldLinearVel(const std::vector<const Entity *> &_entities,
+    std::vector<ignition::math::Vector3d> &_vels) const
+{
+  _vels.resize(_entities.size());
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->gridMutex);
+    if (!this->dataPtr->gridFrames.empty())
+    {
+      size_t first, second;
+      double weight;
+      SelectFrames(*this->dataPtr, this->dataPtr->world.SimTime().Double(),
+          first, second, weight);
+      for (size_t i = 0; i < _entities.size(); ++i)
+      {
+        if (_entities[i])
+        {
+          _vels[i] = SampleGrid(*this->dataPtr,
+              _entities[i]->WorldPose().Pos(), first, second, weight);
+        }
+        else
+        {
+          _vels[i] = this->dataPtr->linearVelFunc(this, _entities[i]);
+        }
+      }
+      return;
+    }
+  }
+
+  for (size_t i = 0; i < _entities.size(); ++i)
+    _vels[i] = this->dataPtr->linearVelFunc(this, _entities[i]);
+}
+
 //////////////////////////////////////////////////
 ignition::math::Vector3d Wind::RelativeLinearVel(const Entity *_entity) const
 {
@@ -240,3 +409,57 @@ void Wind::SetLinearVelFunc(std::function< ignition::math::Vector3d (
 {
   this->dataPtr->linearVelFunc = _linearVelFunc;
 }
+
+/////////////////////////////////////////////////
+bool Wind::SetLinearVelGrid(const ignition::math::AxisAlignedBox &_box,
+    const ignition::math::Vector3i &_size,
+    const std::vector<std::vector<ignition::math::Vector3d>> &_frames,
+    const double _period)
+{
+  if (_frames.empty() || (_frames.size() > 1 && !(_period > 0.0)))
+    return false;
+
+  ignition::math::Vector3d cell;
+  for (int a = 0; a < 3; ++a)
+  {
+    if (_size[a] < 1)
+      return false;
+
+    // The box needs a length along the axes with several nodes
+    if (_size[a] > 1)
+    {
+      if (!(_box.Max()[a] > _box.Min()[a]))
+        return false;
+      cell[a] = (_box.Max()[a] - _box.Min()[a]) / (_size[a] - 1);
+    }
+  }
+
+  const size_t nodes = static_cast<size_t>(_size.X()) * _size.Y() * _size.Z();
+  for (const auto &frame : _frames)
+  {
+    if (frame.size() != nodes)
+      return false;
+  }
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->gridMutex);
+  this->dataPtr->gridMin = _box.Min();
+  this->dataPtr->gridCell = cell;
+  this->dataPtr->gridSize = _size;
+  this->dataPtr->gridFrames = _frames;
+  this->dataPtr->gridPeriod = _period;
+  return true;
+}
+
+/////////////////////////////////////////////////
+void Wind::ClearLinearVelGrid()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->gridMutex);
+  this->dataPtr->gridFrames.clear();
+}
+
+/////////////////////////////////////////////////
+bool Wind::HasLinearVelGrid() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->gridMutex);
+  return !this->dataPtr->gridFrames.empty();
+}
@@ -20,7 +20,10 @@
 #include <string>
 #include <functional>
 #include <memory>
+#include <vector>
 #include <boost/any.hpp>
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Vector3.hh>
 
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
@@ -91,6 +94,17 @@ namespace gazebo
       public: ignition::math::Vector3d WorldLinearVel(const Entity *_entity)
           const;
 
+      /// \brief Get the wind velocity at the location of many entities at
+      /// once, e.g. the links of a model, in the world coordinate frame.
+      /// The frames of the velocity grid are selected once for all of
+      /// them.
+      /// \param[in] _entities Entities at which locations the wind is
+      /// applied.
+      /// \param[out] _vels Linear velocities of the wind, resized to the
+      /// number of entities.
+      public: void WorldLinearVel(const std::vector<const Entity *> &_entities,
+                  std::vector<ignition::math::Vector3d> &_vels) const;
+
       /// \brief Get the wind velocity at an entity location.
       /// \param[in] _entity Entity at which location the wind is applied.
       /// \return Linear velocity of the wind.
@@ -114,6 +128,33 @@ namespace gazebo
       public: void SetLinearVelFunc(std::function< ignition::math::Vector3d (
           const Wind *_wind, const Entity *_entity) > _linearVelFunc);
 
+      /// \brief Sample the wind velocity from a grid of velocities
+      /// instead of calling the velocity function. The velocities are
+      /// interpolated trilinearly between the nodes of the grid, and
+      /// linearly in time between its frames, which loop. Outside of the
+      /// grid, the velocity is the one of the closest point of the grid.
+      /// \param[in] _box Box covered by the grid, whose corners are nodes.
+      /// \param[in] _size Number of nodes along each axis, at least 1.
+      /// \param[in] _frames Velocities of the nodes in world frame, x
+      /// first then y then z, for each frame.
+      /// \param[in] _period Sim time between two frames in seconds,
+      /// ignored if there's a single frame.
+      /// \return False if a frame doesn't have a velocity per node, or the
+      /// period isn't positive with several frames, in which case the
+      /// grid is left unchanged.
+      public: bool SetLinearVelGrid(const ignition::math::AxisAlignedBox &_box,
+                  const ignition::math::Vector3i &_size,
+                  const std::vector<std::vector<ignition::math::Vector3d>>
+                  &_frames, const double _period = 0.0);
+
+      /// \brief Call the velocity function again instead of sampling the
+      /// grid.
+      public: void ClearLinearVelGrid();
+
+      /// \brief Get whether the wind velocity is sampled from a grid.
+      /// \return True if a grid is set.
+      public: bool HasLinearVelGrid() const;
+
       /// \brief Get the global wind velocity, ignoring the entity.
       /// \param[in] _wind Reference to the wind.
       /// \param[in] _entity Pointer to an entity at which location the wind
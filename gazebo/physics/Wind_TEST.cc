@@ -15,6 +15,7 @@
  *
 */
 #include <memory>
+#include <vector>
 
 #include "gazebo/test/ServerFixture.hh"
 #include "gazebo/msgs/msgs.hh"
@@ -44,6 +45,9 @@ class WindTest : public ServerFixture
   /// \brief Test setting up function to compute the wind.
   public: void WindSetLinearVelFunc();
 
+  /// \brief Test sampling the wind from a grid of velocities.
+  public: void WindLinearVelGrid();
+
   /// \brief Incoming wind message.
   public: static msgs::Wind windPubMsg;
 
@@ -221,6 +225,93 @@ TEST_F(WindTest, WindSetLinearVelFunc)
   WindSetLinearVelFunc();
 }
 
+/////////////////////////////////////////////////
+void WindTest::WindLinearVelGrid()
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  this->SpawnBox("box_0", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(1, 0, 0.5), ignition::math::Vector3d::Zero,
+      true);
+  this->SpawnBox("box_1", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(8, 0, 0.5), ignition::math::Vector3d::Zero,
+      true);
+  physics::ModelPtr box0 = world->ModelByName("box_0");
+  physics::ModelPtr box1 = world->ModelByName("box_1");
+  ASSERT_TRUE(box0 != NULL);
+  ASSERT_TRUE(box1 != NULL);
+
+  physics::Wind &wind = world->Wind();
+  EXPECT_FALSE(wind.HasLinearVelGrid());
+
+  // The velocity of each node is its position in the first frame, and
+  // twice its position in the second one.
+  const ignition::math::AxisAlignedBox box(
+      ignition::math::Vector3d(0, 0, 0), ignition::math::Vector3d(4, 0, 2));
+  const ignition::math::Vector3i size(3, 1, 3);
+  std::vector<std::vector<ignition::math::Vector3d>> frames(2);
+  for (int z = 0; z < size.Z(); ++z)
+  {
+    for (int x = 0; x < size.X(); ++x)
+    {
+      frames[0].push_back(ignition::math::Vector3d(2 * x, 0, z));
+      frames[1].push_back(2.0 * frames[0].back());
+    }
+  }
+
+  // Invalid grids
+  EXPECT_FALSE(wind.SetLinearVelGrid(box, size, {}));
+  EXPECT_FALSE(wind.SetLinearVelGrid(box, size, frames));
+  EXPECT_FALSE(wind.SetLinearVelGrid(box, ignition::math::Vector3i(3, 2, 3),
+      frames, 1.0));
+  EXPECT_FALSE(wind.SetLinearVelGrid(box, ignition::math::Vector3i(3, 0, 3),
+      frames, 1.0));
+  EXPECT_FALSE(wind.HasLinearVelGrid());
+
+  ASSERT_TRUE(wind.SetLinearVelGrid(box, size, frames, 1.0));
+  EXPECT_TRUE(wind.HasLinearVelGrid());
+
+  // Interpolated inside of the grid, clamped outside
+  EXPECT_EQ(wind.WorldLinearVel(box0.get()),
+      ignition::math::Vector3d(1, 0, 0.5));
+  EXPECT_EQ(wind.WorldLinearVel(box1.get()),
+      ignition::math::Vector3d(4, 0, 0.5));
+
+  // Batched queries
+  std::vector<ignition::math::Vector3d> vels;
+  wind.WorldLinearVel({box0.get(), box1.get()}, vels);
+  ASSERT_EQ(vels.size(), 2u);
+  EXPECT_EQ(vels[0], wind.WorldLinearVel(box0.get()));
+  EXPECT_EQ(vels[1], wind.WorldLinearVel(box1.get()));
+
+  // Interpolated between the frames
+  world->Step(500);
+  const double weight = world->SimTime().Double();
+  EXPECT_GT(weight, 0.0);
+  EXPECT_LT(weight, 1.0);
+  wind.WorldLinearVel({box0.get(), box1.get()}, vels);
+  ASSERT_EQ(vels.size(), 2u);
+  EXPECT_EQ(vels[0], (1 + weight) * ignition::math::Vector3d(1, 0, 0.5));
+  EXPECT_EQ(vels[1], (1 + weight) * ignition::math::Vector3d(4, 0, 0.5));
+
+  // Back to the velocity function
+  wind.SetLinearVel(ignition::math::Vector3d(0, 1, 0));
+  wind.ClearLinearVelGrid();
+  EXPECT_FALSE(wind.HasLinearVelGrid());
+  EXPECT_EQ(wind.WorldLinearVel(box1.get()), wind.LinearVel());
+  wind.WorldLinearVel({box0.get(), box1.get()}, vels);
+  ASSERT_EQ(vels.size(), 2u);
+  EXPECT_EQ(vels[0], wind.LinearVel());
+}
+
+/////////////////////////////////////////////////
+TEST_F(WindTest, WindLinearVelGrid)
+{
+  WindLinearVelGrid();
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
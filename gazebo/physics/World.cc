@@ -22,10 +22,17 @@
 
 #include <sdf/sdf.hh>
 
+#include <algorithm>
+#include <chrono>
 #include <deque>
 #include <list>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <set>
+#include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <boost/algorithm/string/predicate.hpp>
@@ -43,15 +50,22 @@
 #include "gazebo/transport/TransportIface.hh"
 #include "gazebo/transport/Publisher.hh"
 #include "gazebo/transport/Subscriber.hh"
+#include "gazebo/transport/TopicManager.hh"
 
 #include "gazebo/util/LogPlay.hh"
 
+#include "gazebo/common/Base64.hh"
 #include "gazebo/common/ModelDatabase.hh"
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Events.hh"
 #include "gazebo/common/Exception.hh"
+#include "gazebo/common/MemoryTracker.hh"
+#include "gazebo/common/MeshManager.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Plugin.hh"
+#include "gazebo/common/Profiler.hh"
+#include "gazebo/common/RealTime.hh"
+#include "gazebo/common/SdfCache.hh"
 #include "gazebo/common/Time.hh"
 #include "gazebo/common/URI.hh"
 
@@ -76,6 +90,8 @@
 #include "gazebo/physics/Light.hh"
 #include "gazebo/physics/Actor.hh"
 #include "gazebo/physics/Wind.hh"
+#include "gazebo/physics/ForceField.hh"
+#include "gazebo/physics/Partition.hh"
 #include "gazebo/physics/WorldPrivate.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/common/SphericalCoordinates.hh"
@@ -91,20 +107,299 @@ using namespace physics;
 /// This will be replaced with a class member variable in Gazebo 3.0
 bool g_clearModels;
 
+/// \brief Minimum number of dirty poses needed to update them in parallel.
+static const size_t kMinParallelDirtyPoses = 256;
+
+/// \brief Number of world states that can be waiting for the log worker
+/// thread before new log snapshots are dropped.
+static const size_t kLogStatePoolSize = 64;
+
+/// \brief Nanoseconds the physics thread spins before the deadline of a
+/// step in real time mode, which covers the usual wake up latency.
+static const int64_t kRealTimeSpin = 50000;
+
+/// \brief Period at which the caches over their memory budget are
+/// trimmed.
+static const std::chrono::milliseconds kMemoryEnforcePeriod(200);
+
+/// \brief Element that holds a Base64 encoded msgs::WorldState inside a
+/// log frame.
+static const std::string kBinaryStateStart = "<binary_state>";
+static const std::string kBinaryStateEnd = "</binary_state>";
+
+/// \brief Element that holds the SDF of the models and lights of a log
+/// keyframe, after its world state.
+static const std::string kKeyframeStart = "<keyframe>";
+static const std::string kKeyframeEnd = "</keyframe>";
+
+//////////////////////////////////////////////////
+/// \brief Write a world state to a log stream as one <sdf> frame.
+/// \param[in] _state World state to write.
+/// \param[in] _keyframe SDF of the models and lights if the state is a
+/// keyframe, empty otherwise.
+/// \param[in] _binary True to write the state as a binary message.
+/// \param[out] _stream Log stream.
+static void WriteLogState(const WorldState &_state,
+    const std::string &_keyframe, const bool _binary,
+    std::ostringstream &_stream)
+{
+  _stream << "<sdf version='" << SDF_VERSION << "'>";
+  if (_binary)
+  {
+    msgs::ArenaMsg<msgs::WorldState> msg;
+    _state.FillMsg(*msg);
+
+    std::string data;
+    msg->SerializeToString(&data);
+
+    // The iterations are kept in plain text so that LogPlay can find the
+    // first iteration of the log.
+    std::string encoded;
+    Base64Encode(data.c_str(), data.size(), encoded);
+    _stream << "<iterations>" << _state.GetIterations() << "</iterations>";
+
+    // So are markers of insertions and deletions, which LogPlay looks for
+    // when rebuilding the world from a keyframe.
+    if (!_state.Insertions().empty())
+      _stream << "<insertions></insertions>";
+    if (!_state.Deletions().empty())
+      _stream << "<deletions></deletions>";
+
+    _stream << kBinaryStateStart << encoded << kBinaryStateEnd;
+  }
+  else
+  {
+    _stream << _state;
+  }
+
+  if (!_keyframe.empty())
+    _stream << kKeyframeStart << _keyframe << kKeyframeEnd;
+  _stream << "</sdf>";
+}
+
+//////////////////////////////////////////////////
+/// \brief Load a world state from a log frame.
+/// \param[in] _data The <sdf> frame.
+/// \param[in] _stateSDF Element used to parse SDF frames.
+/// \param[out] _state The world state.
+/// \return True if the frame was parsed.
+static bool LoadLogState(const std::string &_data,
+    const sdf::ElementPtr &_stateSDF, WorldState &_state)
+{
+  auto binaryStart = _data.find(kBinaryStateStart);
+  auto binaryEnd = _data.find(kBinaryStateEnd);
+  if (binaryStart != std::string::npos &&
+      binaryEnd != std::string::npos)
+  {
+    binaryStart += kBinaryStateStart.size();
+    msgs::ArenaMsg<msgs::WorldState> msg;
+    if (!msg->ParseFromString(Base64Decode(
+          _data.substr(binaryStart, binaryEnd - binaryStart))))
+    {
+      gzerr << "Unable to parse binary world state from log\n";
+      return false;
+    }
+    _state.Load(*msg);
+    return true;
+  }
+
+  // The keyframe isn't part of the state's SDF
+  _stateSDF->Clear();
+  auto keyframeStart = _data.find(kKeyframeStart);
+  auto keyframeEnd = _data.find(kKeyframeEnd);
+  if (keyframeStart != std::string::npos &&
+      keyframeEnd != std::string::npos)
+  {
+    std::string data = _data;
+    data.erase(keyframeStart,
+        keyframeEnd + kKeyframeEnd.size() - keyframeStart);
+    sdf::readString(data, _stateSDF);
+  }
+  else
+  {
+    sdf::readString(_data, _stateSDF);
+  }
+
+  _state.Load(_stateSDF);
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the simulation time of a log frame, without loading its
+/// state.
+/// \param[in] _data The <sdf> frame.
+/// \param[out] _time Simulation time of the frame.
+/// \return True if the frame has a simulation time.
+static bool LogFrameTime(const std::string &_data, common::Time &_time)
+{
+  auto binaryStart = _data.find(kBinaryStateStart);
+  auto binaryEnd = _data.find(kBinaryStateEnd);
+  if (binaryStart != std::string::npos &&
+      binaryEnd != std::string::npos)
+  {
+    binaryStart += kBinaryStateStart.size();
+    msgs::ArenaMsg<msgs::WorldState> msg;
+    if (!msg->ParseFromString(Base64Decode(
+          _data.substr(binaryStart, binaryEnd - binaryStart))) ||
+        !msg->has_sim_time())
+    {
+      return false;
+    }
+    _time = msgs::Convert(msg->sim_time());
+    return true;
+  }
+
+  const std::string kStartTime = "<sim_time>";
+  auto start = _data.find(kStartTime);
+  if (start == std::string::npos)
+    return false;
+
+  std::istringstream stream(_data.substr(start + kStartTime.size(), 64));
+  return static_cast<bool>(stream >> _time);
+}
+
+//////////////////////////////////////////////////
+/// \brief Read the models and lights of a world's SDF.
+/// \param[in] _sdfString An <sdf> element with a <world>.
+/// \param[in,out] _entities SDF of the models and lights, by name.
+static void ReadLogEntities(const std::string &_sdfString,
+    std::map<std::string, std::string> &_entities)
+{
+  sdf::SDFPtr sdf(new sdf::SDF);
+  sdf::init(sdf);
+  if (!sdf::readString(_sdfString, sdf) || !sdf->Root()->HasElement("world"))
+  {
+    gzerr << "Unable to read models and lights from log\n";
+    return;
+  }
+
+  auto world = sdf->Root()->GetElement("world");
+  for (auto elem = world->GetFirstElement(); elem;
+       elem = elem->GetNextElement())
+  {
+    if (elem->GetName() == "model" || elem->GetName() == "light")
+      _entities[elem->Get<std::string>("name")] = elem->ToString("");
+  }
+}
+
+/// \brief TBB functor that updates groups of models. Each group is updated
+/// sequentially, in world order, while separate groups may run concurrently.
 class ModelUpdate_TBB
 {
-  public: explicit ModelUpdate_TBB(Model_V *_models) : models(_models) {}
+  public: explicit ModelUpdate_TBB(std::vector<Model_V> *_groups)
+          : groups(_groups) {}
   public: void operator() (const tbb::blocked_range<size_t> &_r) const
   {
     for (size_t i = _r.begin(); i != _r.end(); i++)
     {
-      (*models)[i]->Update();
+      for (auto &model : (*groups)[i])
+        model->Update();
     }
   }
 
-  private: Model_V *models;
+  private: std::vector<Model_V> *groups;
 };
 
+//////////////////////////////////////////////////
+/// \brief Collect the URIs of the meshes of an SDF element and of its
+/// descendants.
+/// \param[in] _elem The SDF element.
+/// \param[out] _uris The mesh URIs.
+static void MeshUris(sdf::ElementPtr _elem, std::vector<std::string> &_uris)
+{
+  if (_elem->GetName() == "mesh" && _elem->HasElement("uri"))
+  {
+    const std::string uri = _elem->Get<std::string>("uri");
+    if (!uri.empty() && uri != "__default__")
+      _uris.push_back(uri);
+    return;
+  }
+
+  for (sdf::ElementPtr child = _elem->GetFirstElement(); child;
+       child = child->GetNextElement())
+  {
+    MeshUris(child, _uris);
+  }
+}
+
+/// \brief Record the duration of a startup phase that began at
+/// _data.startupMark, and start the next phase from now.
+/// \param[in,out] _data World data holding the startup timings.
+/// \param[in] _phase Name of the phase that just completed.
+static void EndStartupPhase(WorldPrivate &_data, const std::string &_phase)
+{
+  const auto now = std::chrono::steady_clock::now();
+  std::lock_guard<std::mutex> lock(_data.startupMutex);
+  _data.startupTimes.emplace_back(_phase,
+      std::chrono::duration<double>(now - _data.startupMark).count());
+  _data.startupMark = now;
+}
+
+/// \brief Apply a model state to the entities resolved for it, resolving
+/// the links and nested models the state names which aren't resolved. The
+/// physics engine must be locked.
+/// \param[in,out] _target Entities of the state.
+/// \param[in] _model The model of _target.
+/// \param[in] _state The model state.
+static void ApplyModelState(StateTarget &_target, const ModelPtr &_model,
+    const ModelState &_state)
+{
+  // The model keeps its links alive
+  std::vector<std::pair<Link *, const LinkState *>> links;
+  links.reserve(_state.GetLinkStates().size());
+  for (auto const &linkState : _state.GetLinkStates())
+  {
+    auto &target = _target.links[linkState.first];
+    LinkPtr link = target.lock();
+    if (!link)
+    {
+      link = _model->GetLink(linkState.first);
+      target = link;
+    }
+
+    if (link)
+      links.emplace_back(link.get(), &linkState.second);
+    else
+      gzerr << "Unable to find link[" << linkState.first << "]\n";
+  }
+
+  // When the states set the poses of all the links, moving the model only
+  // moves the entities, and the engine gets each link pose once. The
+  // canonical link notifies the model.
+  std::vector<Link *> distinct;
+  distinct.reserve(links.size());
+  for (auto const &link : links)
+    distinct.push_back(link.first);
+  std::sort(distinct.begin(), distinct.end());
+  const bool allLinks = !distinct.empty() && _model->NestedModels().empty() &&
+      static_cast<size_t>(std::unique(distinct.begin(), distinct.end()) -
+      distinct.begin()) == _model->GetLinks().size();
+
+  _model->SetWorldPose(_state.Pose(), !allLinks);
+  _model->SetScale(_state.Scale(), true);
+
+  for (auto const &link : links)
+    link.first->SetState(*link.second);
+
+  for (auto const &nestedState : _state.NestedModelStates())
+  {
+    auto &nested = _target.nested[nestedState.first];
+    if (!nested)
+      nested.reset(new StateTarget);
+    ModelPtr nestedModel = nested->model.lock();
+    if (!nestedModel)
+    {
+      nestedModel = _model->NestedModel(nestedState.first);
+      nested->model = nestedModel;
+    }
+
+    if (nestedModel)
+      ApplyModelState(*nested, nestedModel, nestedState.second);
+    else
+      gzerr << "Unable to find model[" << nestedState.first << "]\n";
+  }
+}
+
 //////////////////////////////////////////////////
 World::World(const std::string &_name)
   : dataPtr(new WorldPrivate)
@@ -144,8 +439,21 @@ World::World(const std::string &_name)
   this->dataPtr->enablePhysicsEngine = true;
   this->dataPtr->enableWind = true;
   this->dataPtr->enableAtmosphere = true;
-
-  this->dataPtr->sleepOffset = common::Time(0);
+  this->dataPtr->parallelModelUpdate = false;
+  this->dataPtr->stepBatchSize = 1;
+  this->dataPtr->realTimeCpu = -1;
+  this->dataPtr->realTimePriority = 0;
+  this->dataPtr->realTimeDeadline = 0;
+  this->dataPtr->sleepTime = 0;
+  this->dataPtr->sleepLinearThreshold = 0.01;
+  this->dataPtr->sleepAngularThreshold = 0.01;
+  this->dataPtr->modelUpdateGroupsDirty = true;
+  this->dataPtr->dirtyPoseCount = 0;
+  this->dataPtr->logDroppedStates = 0;
+  this->dataPtr->entityGeneration = 0;
+  this->dataPtr->logEntityGeneration = 0;
+
+  this->dataPtr->sleepOffset = common::NanoTime();
 
   this->dataPtr->prevStatTime = common::Time::GetWallTime();
   this->dataPtr->prevProcessMsgsTime = common::Time::GetWallTime();
@@ -173,6 +481,12 @@ World::~World()
 //////////////////////////////////////////////////
 void World::Load(sdf::ElementPtr _sdf)
 {
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->startupMutex);
+    this->dataPtr->startupTimes.clear();
+    this->dataPtr->startupMark = std::chrono::steady_clock::now();
+  }
+
   this->dataPtr->loaded = false;
   this->dataPtr->sdf = _sdf;
 
@@ -251,13 +565,43 @@ void World::Load(sdf::ElementPtr _sdf)
   this->dataPtr->modelSub = this->dataPtr->node->Subscribe<msgs::Model>(
       "~/model/modify", &World::OnModelMsg, this);
 
+  this->dataPtr->poseInterestSub = this->dataPtr->node->Subscribe(
+      "~/pose/interest", &World::OnPoseInterestMsg, this);
+
   this->dataPtr->responsePub = this->dataPtr->node->Advertise<msgs::Response>(
       "~/response");
   this->dataPtr->statPub =
     this->dataPtr->node->Advertise<msgs::WorldStatistics>(
         "~/world_stats", 100, 5);
+  this->dataPtr->transportStatsPub =
+    this->dataPtr->node->Advertise<msgs::TransportStats>(
+        "~/transport/stats", 10, 1);
   this->dataPtr->modelPub = this->dataPtr->node->Advertise<msgs::Model>(
       "~/model/info");
+
+  // Checkpoints are only written when <gz:checkpoint> sets a period
+  if (this->dataPtr->sdf->HasElement("gz:checkpoint"))
+  {
+    sdf::ElementPtr checkpointElem =
+        this->dataPtr->sdf->GetElement("gz:checkpoint");
+    this->SetCheckpointPeriod(checkpointElem->HasElement("period") ?
+        checkpointElem->Get<double>("period") : 0.0,
+        checkpointElem->HasElement("path") ?
+        checkpointElem->Get<std::string>("path") :
+        this->Name() + ".checkpoint");
+  }
+
+  // Only a region of the world is simulated when it is distributed over
+  // several servers. See Partition.
+  if (this->dataPtr->sdf->HasElement("gz:partition"))
+  {
+    this->dataPtr->partition.reset(new physics::Partition(*this));
+    if (!this->dataPtr->partition->Load(
+          this->dataPtr->sdf->GetElement("gz:partition")))
+    {
+      this->dataPtr->partition.reset();
+    }
+  }
   this->dataPtr->lightPub = this->dataPtr->node->Advertise<msgs::Light>(
       "~/light/modify");
   this->dataPtr->lightFactoryPub = this->dataPtr->node->Advertise<msgs::Light>(
@@ -295,6 +639,19 @@ void World::Load(sdf::ElementPtr _sdf)
 
   this->dataPtr->wind->Load(windElem);
 
+  if (!this->dataPtr->forceField)
+    this->dataPtr->forceField.reset(new physics::ForceField(*this));
+
+  // This should come before loading of entities, whose links add their
+  // batteries
+  if (!this->dataPtr->powerSystem)
+    this->dataPtr->powerSystem.reset(new common::PowerSystem());
+  if (this->dataPtr->sdf->HasElement("gz:battery_update_rate"))
+  {
+    double rate = this->dataPtr->sdf->Get<double>("gz:battery_update_rate");
+    this->dataPtr->powerSystem->SetUpdatePeriod(rate > 0 ? 1.0 / rate : 0.0);
+  }
+
   // This should come after loading physics engine
   sdf::ElementPtr atmosphereElem = this->dataPtr->sdf->GetElement("atmosphere");
 
@@ -334,6 +691,13 @@ void World::Load(sdf::ElementPtr _sdf)
   // information. The joints must be created last, otherwise they get
   // initialized improperly.
   {
+    // Load all the meshes in parallel first, instead of one by one as
+    // the shapes and visuals get loaded
+    std::vector<std::string> meshUris;
+    MeshUris(this->dataPtr->sdf, meshUris);
+    if (!meshUris.empty())
+      common::MeshManager::Instance()->Prefetch(meshUris);
+
     // Create all the entities
     this->LoadEntities(this->dataPtr->sdf, this->dataPtr->rootElement);
 
@@ -341,13 +705,53 @@ void World::Load(sdf::ElementPtr _sdf)
       this->ModelByIndex(i)->LoadJoints();
   }
 
-  // TODO: Performance test to see if TBB model updating is necessary
-  // Choose threaded or unthreaded model updating depending on the number of
-  // models in the scene
-  // if (this->ModelCount() < 20)
+  // Models are updated sequentially in world order by default. Parallel
+  // updates of independent models can be requested through the
+  // <gz:parallel_model_update> element or the "parallel_model_update"
+  // physics parameter.
   this->dataPtr->modelUpdateFunc = &World::ModelUpdateSingleLoop;
-  // else
-  // this->dataPtr->modelUpdateFunc = &World::ModelUpdateTBB;
+  if (physicsElem->HasElement("gz:parallel_model_update"))
+  {
+    this->SetParallelModelUpdate(
+        physicsElem->Get<bool>("gz:parallel_model_update"));
+  }
+
+  // Steps are run one at a time by default. See SetStepBatchSize.
+  if (physicsElem->HasElement("gz:step_batch_size"))
+  {
+    this->SetStepBatchSize(
+        physicsElem->Get<unsigned int>("gz:step_batch_size"));
+  }
+
+  // The physics thread is paced with sleeps by default, real time mode
+  // is enabled by <gz:real_time_cpu>. See SetRealTimeMode.
+  if (physicsElem->HasElement("gz:real_time_cpu"))
+  {
+    const int cpu = physicsElem->Get<int>("gz:real_time_cpu");
+    if (physicsElem->HasElement("gz:real_time_priority"))
+    {
+      this->SetRealTimeMode(cpu,
+          physicsElem->Get<int>("gz:real_time_priority"));
+    }
+    else
+      this->SetRealTimeMode(cpu);
+  }
+
+  // Idle models are only put to sleep when <gz:sleep_time> is set. See
+  // SetSleepTime and SetSleepThresholds.
+  if (physicsElem->HasElement("gz:sleep_linear_velocity") ||
+      physicsElem->HasElement("gz:sleep_angular_velocity"))
+  {
+    double linear = this->dataPtr->sleepLinearThreshold;
+    double angular = this->dataPtr->sleepAngularThreshold;
+    if (physicsElem->HasElement("gz:sleep_linear_velocity"))
+      linear = physicsElem->Get<double>("gz:sleep_linear_velocity");
+    if (physicsElem->HasElement("gz:sleep_angular_velocity"))
+      angular = physicsElem->Get<double>("gz:sleep_angular_velocity");
+    this->SetSleepThresholds(linear, angular);
+  }
+  if (physicsElem->HasElement("gz:sleep_time"))
+    this->SetSleepTime(physicsElem->Get<double>("gz:sleep_time"));
 
   event::Events::worldCreated(this->Name());
 
@@ -363,6 +767,8 @@ void World::Load(sdf::ElementPtr _sdf)
   this->RegisterIntrospectionItems();
 
   this->dataPtr->loaded = true;
+
+  EndStartupPhase(*this->dataPtr, "load");
 }
 
 //////////////////////////////////////////////////
@@ -404,6 +810,12 @@ void World::Init()
 
 //////////////////////////////////////////////////
 void World::Init(UpdateScenePosesFunc _func)
+{
+  this->Init(_func, nullptr);
+}
+
+//////////////////////////////////////////////////
+void World::Init(UpdateScenePosesFunc _func, HasSceneFunc _hasScene)
 {
   if (nullptr == this->dataPtr->rootElement)
   {
@@ -433,7 +845,6 @@ void World::Init(UpdateScenePosesFunc _func)
   this->dataPtr->updateInfo.worldName = this->Name();
 
   this->dataPtr->iterations = 0;
-  this->dataPtr->logPrevIteration = 0;
 
   util::DiagnosticManager::Instance()->Init(this->Name());
 
@@ -467,9 +878,14 @@ void World::Init(UpdateScenePosesFunc _func)
   }
 
   this->dataPtr->updateScenePoses = _func;
+  this->dataPtr->hasScene = _hasScene;
 
   this->dataPtr->initialized = true;
 
+  // The "init" phase starts where "load" ended, so it includes the time
+  // spent between the two calls
+  EndStartupPhase(*this->dataPtr, "init");
+
   // Mark the world initialization
   gzlog << "Init world[" << this->Name() << "]" << std::endl;
 }
@@ -517,6 +933,10 @@ void World::Stop()
     delete this->dataPtr->thread;
     this->dataPtr->thread = nullptr;
   }
+  this->dataPtr->partition.reset();
+
+  if (this->dataPtr->checkpointThread.joinable())
+    this->dataPtr->checkpointThread.join();
 
   event::Events::stop();
 }
@@ -532,16 +952,43 @@ void World::RunLoop()
   if (this->IsPaused())
     this->dataPtr->pauseStartTime = this->dataPtr->startTime;
 
-  this->dataPtr->prevStepWallTime = common::Time::GetWallTime();
+  this->dataPtr->prevStepWallTime =
+    common::NanoTime(common::Time::GetWallTime());
 
   // Get the first state
   this->dataPtr->prevStates[0] = WorldState(shared_from_this());
   this->dataPtr->prevStates[1] = WorldState(shared_from_this());
   this->dataPtr->stateToggle = 0;
 
+  // Preallocate the states handed to the log worker thread.
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->logMutex);
+    this->dataPtr->logStatePool.resize(kLogStatePoolSize);
+    this->dataPtr->logStateKeyframes.resize(kLogStatePoolSize);
+    this->dataPtr->logFreeStates.clear();
+    for (size_t i = 0; i < this->dataPtr->logStatePool.size(); ++i)
+      this->dataPtr->logFreeStates.push_back(i);
+    this->dataPtr->logReadyStates.clear();
+  }
+  this->dataPtr->prevUnfilteredState.Load(shared_from_this());
+  this->dataPtr->logEntityGeneration = this->dataPtr->entityGeneration;
+
   this->dataPtr->logThread =
     new std::thread(std::bind(&World::LogWorker, this));
 
+  // In real time mode, the physics thread has its CPU to itself. The
+  // log worker is started first, so that it doesn't inherit the CPU.
+  const int realTimeCpu = this->dataPtr->realTimeCpu;
+  bool pinned = false;
+  if (realTimeCpu >= 0)
+  {
+    pinned = common::RealTime::PinCurrentThread(realTimeCpu,
+        this->dataPtr->realTimePriority);
+    if (pinned)
+      common::RealTime::MoveOtherThreads(realTimeCpu);
+  }
+  this->dataPtr->realTimeDeadline = 0;
+
   if (!util::LogPlay::Instance()->IsOpen())
   {
     for (this->dataPtr->iterations = 0; !this->dataPtr->stop &&
@@ -564,6 +1011,10 @@ void World::RunLoop()
 
   this->dataPtr->stop = true;
 
+  // RunBlocking runs the loop in the thread of the caller
+  if (pinned)
+    common::RealTime::UnpinCurrentThread();
+
   if (this->dataPtr->logThread)
   {
     this->dataPtr->logCondition.notify_all();
@@ -589,7 +1040,31 @@ void World::LogStep()
         this->dataPtr->stepInc = 1;
 
       std::string data;
-      if (!util::LogPlay::Instance()->Step(this->dataPtr->stepInc, data))
+      bool stepped =
+        util::LogPlay::Instance()->Step(this->dataPtr->stepInc, data);
+
+      // While playing, skip the states within the play period of the last
+      // one played. Those that insert or delete entities are played, and
+      // so is the last state of the log.
+      const double playPeriod = util::LogPlay::Instance()->PlayPeriod();
+      if (stepped && playPeriod > 0 && !this->IsPaused() &&
+          !this->dataPtr->logPlayRebuild &&
+          this->dataPtr->logLastStatePlayedSimTime != common::Time(0))
+      {
+        const common::Time nextPlayTime =
+          this->dataPtr->logLastStatePlayedSimTime + common::Time(playPeriod);
+        common::Time frameTime;
+        std::string next;
+        while (data.find("<insertions>") == std::string::npos &&
+               data.find("<deletions>") == std::string::npos &&
+               LogFrameTime(data, frameTime) && frameTime < nextPlayTime &&
+               util::LogPlay::Instance()->Step(next))
+        {
+          data.swap(next);
+        }
+      }
+
+      if (!stepped)
       {
         // There are no more chunks, time to exit.
         this->SetPaused(true);
@@ -599,10 +1074,15 @@ void World::LogStep()
       {
         this->dataPtr->stepInc = 1;
 
-        this->dataPtr->logPlayStateSDF->Clear();
-        sdf::readString(data, this->dataPtr->logPlayStateSDF);
+        LoadLogState(data, this->dataPtr->logPlayStateSDF,
+            this->dataPtr->logPlayState);
 
-        this->dataPtr->logPlayState.Load(this->dataPtr->logPlayStateSDF);
+        // The frames skipped by a seek may have inserted or deleted models
+        if (this->dataPtr->logPlayRebuild)
+        {
+          this->dataPtr->logPlayRebuild = false;
+          this->RebuildFromKeyframe(this->dataPtr->logPlayState.GetSimTime());
+        }
 
         // If it's the first step, we're going back in time or
         // rt factor is close to zero, don't sleep.
@@ -663,9 +1143,17 @@ bool World::SensorsInitialized() const
   return this->dataPtr->sensorsInitialized;
 }
 
+//////////////////////////////////////////////////
+std::vector<std::pair<std::string, double>> World::StartupTimes() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->startupMutex);
+  return this->dataPtr->startupTimes;
+}
+
 //////////////////////////////////////////////////
 void World::Step()
 {
+  GZ_PROFILE("World::Step");
   DIAG_TIMER_START("World::Step");
 
   /// need this because ODE does not call dxReallocateWorldProcessContext()
@@ -674,8 +1162,27 @@ void World::Step()
   /// one iteration of the physics engine. Do not remove this.
   if (!this->dataPtr->pluginsLoaded && this->SensorsInitialized())
   {
+    EndStartupPhase(*this->dataPtr, "sensors");
     this->LoadPlugins();
     this->dataPtr->pluginsLoaded = true;
+    EndStartupPhase(*this->dataPtr, "plugins");
+
+    std::ostringstream timings;
+    for (const auto &phase : this->StartupTimes())
+      timings << " " << phase.first << "[" << phase.second << "s]";
+    gzmsg << "World[" << this->Name() << "] startup:" << timings.str()
+          << std::endl;
+
+    // Move the threads the plugins created off the real time CPU
+    if (this->dataPtr->realTimeCpu >= 0)
+      common::RealTime::MoveOtherThreads(this->dataPtr->realTimeCpu);
+
+    // A checkpoint is restored once the plugins registered their data
+    if (this->dataPtr->resumeCheckpoint)
+    {
+      this->ResumeCheckpoint(*this->dataPtr->resumeCheckpoint);
+      this->dataPtr->resumeCheckpoint.reset();
+    }
   }
 
   DIAG_TIMER_LAP("World::Step", "loadPlugins");
@@ -686,51 +1193,101 @@ void World::Step()
   DIAG_TIMER_LAP("World::Step", "publishWorldStats");
 
   double updatePeriod = this->dataPtr->physicsEngine->GetUpdatePeriod();
-  // sleep here to get the correct update rate
-  common::Time tmpTime = common::Time::GetWallTime();
-  common::Time sleepTime = this->dataPtr->prevStepWallTime +
-    common::Time(updatePeriod) - tmpTime - this->dataPtr->sleepOffset;
-
-  common::Time actualSleep;
-  if (sleepTime > 0)
+  bool due = true;
+  if (this->dataPtr->realTimeCpu >= 0)
   {
-    common::Time::Sleep(sleepTime);
-    actualSleep = common::Time::GetWallTime() - tmpTime;
+    this->WaitForStepDeadline(updatePeriod);
   }
   else
-    sleepTime = 0;
+  {
+    // sleep here to get the correct update rate
+    const common::NanoTime period = common::NanoTime::FromSeconds(updatePeriod);
+    const common::NanoTime tmpTime(common::Time::GetWallTime());
+    common::NanoTime sleepTime = this->dataPtr->prevStepWallTime +
+      period - tmpTime - this->dataPtr->sleepOffset;
+
+    common::NanoTime actualSleep;
+    if (sleepTime > common::NanoTime())
+    {
+      common::Time::Sleep(sleepTime.ToTime());
+      actualSleep = common::NanoTime(common::Time::GetWallTime()) - tmpTime;
+    }
+    else
+      sleepTime = common::NanoTime();
+
+    // exponentially avg out
+    this->dataPtr->sleepOffset = (actualSleep - sleepTime) * 0.01 +
+                        this->dataPtr->sleepOffset * 0.99;
 
-  // exponentially avg out
-  this->dataPtr->sleepOffset = (actualSleep - sleepTime) * 0.01 +
-                      this->dataPtr->sleepOffset * 0.99;
+    DIAG_TIMER_LAP("World::Step", "sleepOffset");
 
-  DIAG_TIMER_LAP("World::Step", "sleepOffset");
+    // throttling update rate, with sleepOffset as tolerance
+    // the tolerance is needed as the sleep time is not exact
+    due = common::NanoTime(common::Time::GetWallTime()) -
+        this->dataPtr->prevStepWallTime + this->dataPtr->sleepOffset >= period;
+  }
 
-  // throttling update rate, with sleepOffset as tolerance
-  // the tolerance is needed as the sleep time is not exact
-  if (common::Time::GetWallTime() - this->dataPtr->prevStepWallTime +
-      this->dataPtr->sleepOffset >= common::Time(updatePeriod))
+  if (due)
   {
     std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
 
     DIAG_TIMER_LAP("World::Step", "worldUpdateMutex");
 
-    this->dataPtr->prevStepWallTime = common::Time::GetWallTime();
+    this->dataPtr->prevStepWallTime =
+      common::NanoTime(common::Time::GetWallTime());
 
     double stepTime = this->dataPtr->physicsEngine->GetMaxStepSize();
 
     if (!this->IsPaused() || this->dataPtr->stepInc > 0
         || this->dataPtr->needsReset)
     {
-      // query timestep to allow dynamic time step size updates
-      this->dataPtr->simTime += stepTime;
-      this->dataPtr->iterations++;
-      this->Update();
+      // Steps can only be batched if they don't have to be throttled.
+      unsigned int batchSize = 1;
+      if (updatePeriod <= 0)
+        batchSize = this->dataPtr->stepBatchSize;
+
+      for (unsigned int i = 0; i < batchSize; ++i)
+      {
+        bool reset = this->dataPtr->needsReset;
+
+        // query timestep to allow dynamic time step size updates
+        if (i > 0)
+          stepTime = this->dataPtr->physicsEngine->GetMaxStepSize();
+        this->dataPtr->simTime += stepTime;
+        this->dataPtr->iterations++;
+
+        const auto updateStart = std::chrono::steady_clock::now();
+        this->Update();
+        const uint64_t updateTime =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now() - updateStart).count();
+        this->dataPtr->stepTimes.Record(updateTime);
+        if (updatePeriod > 0 && updateTime > updatePeriod * 1e9)
+          ++this->dataPtr->overrunSteps;
+
+        if (this->IsPaused() && this->dataPtr->stepInc > 0)
+          this->dataPtr->stepInc--;
+
+        // Stop the batch whenever something outside of the update loop
+        // has to happen.
+        if (reset || this->dataPtr->stop || this->StepBarrierReached() ||
+            (this->IsPaused() && this->dataPtr->stepInc <= 0) ||
+            (this->dataPtr->stopIterations &&
+             this->dataPtr->iterations >= this->dataPtr->stopIterations))
+        {
+          break;
+        }
+      }
 
       DIAG_TIMER_LAP("World::Step", "update");
 
-      if (this->IsPaused() && this->dataPtr->stepInc > 0)
-        this->dataPtr->stepInc--;
+      if (this->dataPtr->checkpointPeriod > 0 &&
+          this->dataPtr->simTime >= this->dataPtr->nextCheckpointTime)
+      {
+        this->SaveCheckpoint(this->dataPtr->checkpointPath);
+        this->dataPtr->nextCheckpointTime = this->dataPtr->simTime +
+            this->dataPtr->checkpointPeriod;
+      }
     }
     else
     {
@@ -779,6 +1336,7 @@ void World::Step(const unsigned int _steps)
 //////////////////////////////////////////////////
 void World::Update()
 {
+  GZ_PROFILE("World::Update");
   DIAG_TIMER_START("World::Update");
 
   if (this->dataPtr->needsReset)
@@ -794,37 +1352,47 @@ void World::Update()
   }
   DIAG_TIMER_LAP("World::Update", "needsReset");
 
+  // Wait for the other regions, and mirror their models
+  if (this->dataPtr->partition)
+  {
+    this->dataPtr->partition->UpdateBegin();
+    DIAG_TIMER_LAP("World::Update", "Partition::UpdateBegin");
+  }
+
   this->dataPtr->updateInfo.simTime = this->SimTime();
   this->dataPtr->updateInfo.realTime = this->RealTime();
   event::Events::worldUpdateBegin(this->dataPtr->updateInfo);
 
   DIAG_TIMER_LAP("World::Update", "Events::worldUpdateBegin");
 
+  // Forces of the surrounding fluids, after the plugins changed the state
+  this->dataPtr->forceField->Update(this->dataPtr->entityGeneration);
+
+  DIAG_TIMER_LAP("World::Update", "ForceField::Update");
+
+  // Batteries, after the plugins changed their power loads
+  this->dataPtr->powerSystem->Update(
+      this->dataPtr->physicsEngine->GetMaxStepSize());
+
+  DIAG_TIMER_LAP("World::Update", "PowerSystem::Update");
+
   // Update all the models
   (*this.*dataPtr->modelUpdateFunc)();
 
   DIAG_TIMER_LAP("World::Update", "Model::Update");
 
+#ifdef HAVE_OPENAL
+  // Sends the poses the links set to OpenAL, at the audio update rate
+  util::OpenAL::Instance()->Update();
+
+  DIAG_TIMER_LAP("World::Update", "OpenAL::Update");
+#endif
+
   // This must be called before PhysicsEngine::UpdatePhysics for ODE.
   this->dataPtr->physicsEngine->UpdateCollision();
 
   DIAG_TIMER_LAP("World::Update", "PhysicsEngine::UpdateCollision");
 
-  // Wait for logging to finish, if it's running.
-  if (util::LogRecord::Instance()->Running())
-  {
-    std::unique_lock<std::mutex> lock(this->dataPtr->logMutex);
-
-    // It's possible the logWorker thread never processed the previous
-    // state. This checks to make sure that we don't continute until the log
-    // worker catchs up.
-    if (this->dataPtr->iterations - this->dataPtr->logPrevIteration > 1)
-    {
-      this->dataPtr->logCondition.notify_one();
-      this->dataPtr->logContinueCondition.wait(lock);
-    }
-  }
-
   // Give clients a possibility to react to collisions before the physics
   // gets updated.
   this->dataPtr->updateInfo.realTime = this->RealTime();
@@ -843,32 +1411,34 @@ void World::Update()
     // do this after physics update as
     //   ode --> MoveCallback sets the dirtyPoses
     //           and we need to propagate it into Entity::worldPose
-    {
-      // block any other pose updates (e.g. Joint::SetPosition)
-      boost::recursive_mutex::scoped_lock plock(
-          *this->Physics()->GetPhysicsUpdateMutex());
+    this->FlushDirtyPoses();
+    this->dataPtr->physicsUpdates++;
 
-      for (auto &dirtyEntity : this->dataPtr->dirtyPoses)
-      {
-        dirtyEntity->SetWorldPose(dirtyEntity->DirtyPose(), false);
-      }
+    DIAG_TIMER_LAP("World::Update", "SetWorldPose(dirtyPoses)");
 
-      this->dataPtr->dirtyPoses.clear();
+    if (this->dataPtr->sleepTime > 0)
+    {
+      this->UpdateSleep();
+      DIAG_TIMER_LAP("World::Update", "UpdateSleep");
     }
-
-    DIAG_TIMER_LAP("World::Update", "SetWorldPose(dirtyPoses)");
   }
 
   // Only update state information if logging data.
   if (util::LogRecord::Instance()->Running())
-    this->dataPtr->logCondition.notify_one();
-  DIAG_TIMER_LAP("World::Update", "LogRecordNotify");
+    this->CaptureLogState();
+  DIAG_TIMER_LAP("World::Update", "CaptureLogState");
 
   // Output the contact information
   this->dataPtr->physicsEngine->GetContactManager()->PublishContacts();
 
   DIAG_TIMER_LAP("World::Update", "ContactManager::PublishContacts");
 
+  if (this->dataPtr->partition)
+  {
+    this->dataPtr->partition->UpdateEnd();
+    DIAG_TIMER_LAP("World::Update", "Partition::UpdateEnd");
+  }
+
   event::Events::worldUpdateEnd();
 
   gazebo::util::IntrospectionManager::Instance()->Update();
@@ -882,6 +1452,10 @@ void World::Fini()
   this->dataPtr->stop = true;
   this->dataPtr->enablePhysicsEngine = false;
 
+  // Wake the world thread if it waits for the other regions
+  if (this->dataPtr->partition)
+    this->dataPtr->partition->Fini();
+
 #ifdef HAVE_OPENAL
   util::OpenAL::Instance()->Fini();
 #endif
@@ -898,9 +1472,11 @@ void World::Fini()
 
     this->dataPtr->poseLocalPub.reset();
     this->dataPtr->posePub.reset();
+    this->dataPtr->poseInterests.clear();
     this->dataPtr->guiPub.reset();
     this->dataPtr->responsePub.reset();
     this->dataPtr->statPub.reset();
+    this->dataPtr->transportStatsPub.reset();
     this->dataPtr->modelPub.reset();
     this->dataPtr->lightPub.reset();
     this->dataPtr->lightFactoryPub.reset();
@@ -914,6 +1490,7 @@ void World::Fini()
     this->dataPtr->lightFactorySub.reset();
     this->dataPtr->lightModifySub.reset();
     this->dataPtr->modelSub.reset();
+    this->dataPtr->poseInterestSub.reset();
 
     if (this->dataPtr->node)
       this->dataPtr->node->Fini();
@@ -930,6 +1507,8 @@ void World::Fini()
   this->dataPtr->publishModelPoses.clear();
   this->dataPtr->publishModelScales.clear();
   this->dataPtr->publishLightPoses.clear();
+  this->dataPtr->pendingModelPoses.clear();
+  this->dataPtr->pendingLightPoses.clear();
 
   // Clean entities
   for (auto &model : this->dataPtr->models)
@@ -938,6 +1517,7 @@ void World::Fini()
       model->Fini();
   }
   this->dataPtr->models.clear();
+  this->dataPtr->modelUpdateGroups.clear();
 
   for (auto &road : this->dataPtr->roads)
   {
@@ -958,12 +1538,25 @@ void World::Fini()
     this->dataPtr->rootElement->Fini();
     this->dataPtr->rootElement.reset();
   }
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->nameIndexMutex);
+    this->dataPtr->nameIndex.clear();
+    this->dataPtr->nameIndexEntries.clear();
+  }
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->stateTargetsMutex);
+    this->dataPtr->stateTargets.clear();
+    this->dataPtr->stateLights.clear();
+  }
   this->dataPtr->prevStates[0].SetWorld(WorldPtr());
   this->dataPtr->prevStates[1].SetWorld(WorldPtr());
   this->dataPtr->prevUnfilteredState.SetWorld(WorldPtr());
   this->dataPtr->logPlayState.SetWorld(WorldPtr());
   this->dataPtr->states[0].clear();
   this->dataPtr->states[1].clear();
+  this->dataPtr->keyframes[0].clear();
+  this->dataPtr->keyframes[1].clear();
 
   this->dataPtr->presetManager.reset();
   this->dataPtr->userCmdManager.reset();
@@ -1010,6 +1603,8 @@ void World::ClearModels()
     this->RemoveModel(this->dataPtr->models[0]);
   }
   this->dataPtr->models.clear();
+  this->dataPtr->modelUpdateGroups.clear();
+  this->dataPtr->modelUpdateGroupsDirty = true;
 
   for (auto &road : this->dataPtr->roads)
   {
@@ -1039,6 +1634,24 @@ Wind &World::Wind() const
   return *this->dataPtr->wind;
 }
 
+//////////////////////////////////////////////////
+ForceField &World::ForceField() const
+{
+  return *this->dataPtr->forceField;
+}
+
+//////////////////////////////////////////////////
+common::PowerSystem &World::PowerSystem() const
+{
+  return *this->dataPtr->powerSystem;
+}
+
+//////////////////////////////////////////////////
+physics::Partition *World::Partition() const
+{
+  return this->dataPtr->partition.get();
+}
+
 //////////////////////////////////////////////////
 Atmosphere &World::Atmosphere() const
 {
@@ -1092,10 +1705,34 @@ void World::SetMagneticField(const ignition::math::Vector3d &_mag)
 //////////////////////////////////////////////////
 BasePtr World::BaseByName(const std::string &_name) const
 {
-  if (this->dataPtr->rootElement)
-    return this->dataPtr->rootElement->GetByName(_name);
-  else
+  if (!this->dataPtr->rootElement)
     return BasePtr();
+
+  if (this->dataPtr->rootElement->GetScopedName() == _name ||
+      this->dataPtr->rootElement->GetName() == _name)
+  {
+    return this->dataPtr->rootElement;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->nameIndexMutex);
+
+    auto iter = this->dataPtr->nameIndex.find(_name);
+    if (iter == this->dataPtr->nameIndex.end())
+      return BasePtr();
+
+    if (iter->second.size() == 1u)
+    {
+      auto entry = this->dataPtr->nameIndexEntries.find(iter->second[0]);
+      if (entry != this->dataPtr->nameIndexEntries.end())
+        return entry->second.base.lock();
+      return BasePtr();
+    }
+  }
+
+  // Several entities match the name, search the tree so that the first
+  // match in depth first order is returned.
+  return this->dataPtr->rootElement->GetByName(_name);
 }
 
 /////////////////////////////////////////////////
@@ -1153,9 +1790,15 @@ ModelPtr World::LoadModel(sdf::ElementPtr _sdf , BasePtr _parent)
 
     msgs::Model msg;
     model->FillMsg(msg);
-    this->dataPtr->modelPub->Publish(msg);
-
-    this->EnableAllModels();
+    if (this->dataPtr->deferModelMsgs)
+    {
+      this->dataPtr->deferredModelMsgs.push_back(msg);
+    }
+    else
+    {
+      this->dataPtr->modelPub->Publish(msg);
+      this->EnableAllModels();
+    }
   }
   else
   {
@@ -1164,6 +1807,8 @@ ModelPtr World::LoadModel(sdf::ElementPtr _sdf , BasePtr _parent)
 
   this->PublishModelPose(model);
   this->dataPtr->models.push_back(model);
+  this->dataPtr->modelUpdateGroupsDirty = true;
+  this->dataPtr->entityGeneration++;
   return model;
 }
 
@@ -1189,6 +1834,7 @@ LightPtr World::LoadLight(const sdf::ElementPtr &_sdf, const BasePtr &_parent)
   light->SetWorld(shared_from_this());
   light->Load(_sdf);
   this->dataPtr->lights.push_back(light);
+  this->dataPtr->entityGeneration++;
 
   // msg should contain scoped name (consistent with other entities)
   msg->set_name(light->GetScopedName());
@@ -1219,6 +1865,8 @@ ActorPtr World::LoadActor(sdf::ElementPtr _sdf , BasePtr _parent)
   this->EnableAllModels();
   this->PublishModelPose(actor);
   this->dataPtr->models.push_back(actor);
+  this->dataPtr->modelUpdateGroupsDirty = true;
+  this->dataPtr->entityGeneration++;
 
   return actor;
 }
@@ -1329,6 +1977,8 @@ void World::ResetTime()
   this->dataPtr->startTime = common::Time::GetWallTime();
   this->dataPtr->realTimeOffset = common::Time(0);
   this->dataPtr->iterations = 0;
+  this->dataPtr->stepTimes.Reset();
+  this->dataPtr->overrunSteps = 0;
 
   if (this->IsPaused())
     this->dataPtr->pauseStartTime = this->dataPtr->startTime;
@@ -1358,11 +2008,13 @@ void World::Reset()
 
     this->ResetTime();
     this->ResetEntities(Base::BASE);
+    this->dataPtr->powerSystem->Reset();
     for (auto &plugin : this->dataPtr->plugins)
     {
       plugin->Reset();
     }
     this->dataPtr->physicsEngine->Reset();
+    this->dataPtr->physicsUpdates++;
 
     // Signal a reset has occurred
     event::Events::worldReset();
@@ -1429,6 +2081,24 @@ common::Time World::RealTime() const
     return this->dataPtr->logRealTime;
 }
 
+//////////////////////////////////////////////////
+const common::LatencyHistogram &World::StepTimes() const
+{
+  return this->dataPtr->stepTimes;
+}
+
+//////////////////////////////////////////////////
+uint64_t World::OverrunStepCount() const
+{
+  return this->dataPtr->overrunSteps;
+}
+
+//////////////////////////////////////////////////
+uint64_t World::PhysicsUpdateCount() const
+{
+  return this->dataPtr->physicsUpdates;
+}
+
 //////////////////////////////////////////////////
 bool World::IsPaused() const
 {
@@ -1544,12 +2214,16 @@ void World::ProcessPlaybackControlMsgs()
       common::Time targetSimTime = msgs::Convert(msg.seek());
       util::LogPlay::Instance()->Seek(targetSimTime);
       this->dataPtr->stepInc = 1;
+      this->dataPtr->logPlayRebuild =
+          util::LogPlay::Instance()->KeyframePeriod() > 0;
     }
 
     if (msg.has_rewind() && msg.rewind())
     {
       util::LogPlay::Instance()->Rewind();
       this->dataPtr->stepInc = 1;
+      this->dataPtr->logPlayRebuild =
+          util::LogPlay::Instance()->KeyframePeriod() > 0;
       if (!util::LogPlay::Instance()->HasIterations())
         this->dataPtr->iterations = 0;
     }
@@ -1566,6 +2240,9 @@ void World::ProcessPlaybackControlMsgs()
     {
       this->dataPtr->logPlayRealTimeFactor = msg.rt_factor();
     }
+
+    if (msg.has_play_period())
+      util::LogPlay::Instance()->SetPlayPeriod(msg.play_period());
   }
 
   this->dataPtr->playbackControlMsgs.clear();
@@ -1632,23 +2309,592 @@ void World::BuildSceneMsg(msgs::Scene &_scene, BasePtr _entity)
 
 
 //////////////////////////////////////////////////
-// void World::ModelUpdateTBB()
-// {
-//   tbb::parallel_for (tbb::blocked_range<size_t>(0,
-//   this->dataPtr->models.size(), 10),
-//       ModelUpdate_TBB(&this->dataPtr->models));
-// }
-
-//////////////////////////////////////////////////
-void World::ModelUpdateSingleLoop()
+void World::ModelUpdateTBB()
 {
-  // Update all the models
-  for (unsigned int i = 0; i < this->dataPtr->rootElement->GetChildCount(); ++i)
-    this->dataPtr->rootElement->GetChild(i)->Update();
-}
+  if (this->dataPtr->modelUpdateGroupsDirty)
+    this->UpdateModelUpdateGroups();
 
+  // There is nothing to gain from spawning tasks for a single group.
+  if (this->dataPtr->modelUpdateGroups.size() < 2)
+  {
+    this->ModelUpdateSingleLoop();
+    return;
+  }
 
-//////////////////////////////////////////////////
+  tbb::parallel_for(tbb::blocked_range<size_t>(0,
+      this->dataPtr->modelUpdateGroups.size(), 1),
+      ModelUpdate_TBB(&this->dataPtr->modelUpdateGroups));
+
+  // Update the remaining children of the root element, such as lights.
+  for (unsigned int i = 0; i < this->dataPtr->rootElement->GetChildCount(); ++i)
+  {
+    BasePtr child = this->dataPtr->rootElement->GetChild(i);
+    if (!child->HasType(Base::MODEL))
+      child->Update();
+  }
+}
+
+//////////////////////////////////////////////////
+void World::UpdateModelUpdateGroups()
+{
+  this->dataPtr->modelUpdateGroups.clear();
+  this->dataPtr->modelUpdateGroupsDirty = false;
+
+  const Model_V &models = this->dataPtr->models;
+
+  std::map<const Model *, size_t> modelIndex;
+  for (size_t i = 0; i < models.size(); ++i)
+    modelIndex[models[i].get()] = i;
+
+  // Union-find over the top level models. Two models end up in the same
+  // group when a joint, possibly in a nested model, connects their links.
+  std::vector<size_t> groupRoot(models.size());
+  for (size_t i = 0; i < groupRoot.size(); ++i)
+    groupRoot[i] = i;
+
+  auto findRoot = [&groupRoot](size_t _i)
+  {
+    while (groupRoot[_i] != _i)
+    {
+      groupRoot[_i] = groupRoot[groupRoot[_i]];
+      _i = groupRoot[_i];
+    }
+    return _i;
+  };
+
+  for (size_t i = 0; i < models.size(); ++i)
+  {
+    std::list<ModelPtr> modelList;
+    modelList.push_back(models[i]);
+    while (!modelList.empty())
+    {
+      ModelPtr m = modelList.front();
+      modelList.pop_front();
+
+      for (auto const &joint : m->GetJoints())
+      {
+        for (auto const &link : {joint->GetParent(), joint->GetChild()})
+        {
+          if (!link)
+            continue;
+
+          auto iter = modelIndex.find(link->GetParentModel().get());
+          if (iter != modelIndex.end())
+            groupRoot[findRoot(iter->second)] = findRoot(i);
+        }
+      }
+
+      for (auto const &n : m->NestedModels())
+        modelList.push_back(n);
+    }
+  }
+
+  // Build the groups, keeping world order both across and within groups.
+  std::map<size_t, size_t> groupIndex;
+  for (size_t i = 0; i < models.size(); ++i)
+  {
+    size_t root = findRoot(i);
+    auto iter = groupIndex.find(root);
+    if (iter == groupIndex.end())
+    {
+      iter = groupIndex.insert(
+          std::make_pair(root, this->dataPtr->modelUpdateGroups.size())).first;
+      this->dataPtr->modelUpdateGroups.push_back(Model_V());
+    }
+    this->dataPtr->modelUpdateGroups[iter->second].push_back(models[i]);
+  }
+}
+
+//////////////////////////////////////////////////
+void World::FlushDirtyPoses()
+{
+  // block any other pose updates (e.g. Joint::SetPosition)
+  boost::recursive_mutex::scoped_lock plock(
+      *this->Physics()->GetPhysicsUpdateMutex());
+
+  auto &dirtyPoses = this->dataPtr->dirtyPoses;
+  size_t count = std::min(this->dataPtr->dirtyPoseCount.load(),
+      dirtyPoses.size());
+
+  // Append the entities that didn't fit. This also grows the buffer so the
+  // next iteration is unlikely to overflow.
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->dirtyPosesOverflowMutex);
+    if (!this->dataPtr->dirtyPosesOverflow.empty())
+    {
+      dirtyPoses.resize(count);
+      dirtyPoses.insert(dirtyPoses.end(),
+          this->dataPtr->dirtyPosesOverflow.begin(),
+          this->dataPtr->dirtyPosesOverflow.end());
+      this->dataPtr->dirtyPosesOverflow.clear();
+      count = dirtyPoses.size();
+    }
+  }
+
+  if (count == 0)
+    return;
+
+  // Snapshot the poses computed by the physics engine.
+  auto &poses = this->dataPtr->dirtyPoseBuffer;
+  poses.resize(count);
+  for (size_t i = 0; i < count; ++i)
+    poses[i] = dirtyPoses[i]->DirtyPose();
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->setWorldPoseMutex);
+
+    if (count < kMinParallelDirtyPoses)
+    {
+      for (size_t i = 0; i < count; ++i)
+        dirtyPoses[i]->_SetWorldPoseFromPhysics(poses[i]);
+    }
+    else
+    {
+      // Setting the pose of a canonical link also sets the pose of its
+      // parent models, so entities are grouped by top level model. Each
+      // group is updated in order, and groups are updated in parallel.
+      auto &order = this->dataPtr->dirtyPoseOrder;
+      order.resize(count);
+      for (size_t i = 0; i < count; ++i)
+        order[i] = std::make_pair(dirtyPoses[i]->GetParentModel().get(), i);
+
+      std::stable_sort(order.begin(), order.end(),
+          [](const std::pair<const Model *, size_t> &_a,
+             const std::pair<const Model *, size_t> &_b)
+          {
+            return _a.first < _b.first;
+          });
+
+      auto &groups = this->dataPtr->dirtyPoseGroups;
+      groups.clear();
+      for (size_t i = 0; i < count; ++i)
+      {
+        if (i == 0 || order[i].first != order[i-1].first)
+          groups.push_back(i);
+      }
+      groups.push_back(count);
+
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, groups.size() - 1),
+          [&](const tbb::blocked_range<size_t> &_r)
+          {
+            for (size_t g = _r.begin(); g != _r.end(); ++g)
+            {
+              for (size_t i = groups[g]; i < groups[g+1]; ++i)
+              {
+                size_t index = order[i].second;
+                dirtyPoses[index]->_SetWorldPoseFromPhysics(poses[index],
+                    false);
+              }
+            }
+          });
+
+      // Publishing is serialized on the receive mutex, so each moved model
+      // is published once after the parallel update.
+      for (size_t g = 0; g + 1 < groups.size(); ++g)
+      {
+        this->PublishModelPose(
+            dirtyPoses[order[groups[g]].second]->GetParentModel());
+      }
+    }
+  }
+
+  this->dataPtr->dirtyPoseCount = 0;
+}
+
+//////////////////////////////////////////////////
+void World::SetParallelModelUpdate(const bool _enable)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+  this->dataPtr->parallelModelUpdate = _enable;
+  if (_enable)
+    this->dataPtr->modelUpdateFunc = &World::ModelUpdateTBB;
+  else
+    this->dataPtr->modelUpdateFunc = &World::ModelUpdateSingleLoop;
+}
+
+//////////////////////////////////////////////////
+bool World::ParallelModelUpdate() const
+{
+  return this->dataPtr->parallelModelUpdate;
+}
+
+//////////////////////////////////////////////////
+unsigned int World::StepBatchSize() const
+{
+  return this->dataPtr->stepBatchSize;
+}
+
+//////////////////////////////////////////////////
+int World::RealTimeCpu() const
+{
+  return this->dataPtr->realTimeCpu;
+}
+
+//////////////////////////////////////////////////
+int World::RealTimePriority() const
+{
+  return this->dataPtr->realTimePriority;
+}
+
+//////////////////////////////////////////////////
+void World::SetRealTimeMode(const int _cpu, const int _priority)
+{
+  if (_priority < 0)
+  {
+    gzerr << "Real time priority must be positive, or 0 to keep the "
+          << "scheduling policy\n";
+    return;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+  this->dataPtr->realTimeCpu = _cpu < 0 ? -1 : _cpu;
+  this->dataPtr->realTimePriority = _priority;
+  this->dataPtr->realTimeDeadline = 0;
+}
+
+//////////////////////////////////////////////////
+void World::WaitForStepDeadline(const double _updatePeriod)
+{
+  if (_updatePeriod <= 0)
+  {
+    this->dataPtr->realTimeDeadline = 0;
+    return;
+  }
+
+  // Each deadline is one period after the previous one, so the rate
+  // doesn't drift with the time of the steps. When the next deadline has
+  // already passed, e.g. after an overrun, a new schedule starts instead
+  // of a burst of late steps.
+  const int64_t period = static_cast<int64_t>(_updatePeriod * 1e9);
+  const int64_t now = common::RealTime::Now();
+  int64_t &deadline = this->dataPtr->realTimeDeadline;
+  if (deadline == 0 || now - deadline > period)
+  {
+    deadline = now;
+    return;
+  }
+
+  deadline += period;
+  common::RealTime::WaitUntil(deadline, kRealTimeSpin);
+}
+
+//////////////////////////////////////////////////
+void World::SetStepBatchSize(const unsigned int _size)
+{
+  if (_size == 0)
+  {
+    gzerr << "Step batch size must be at least 1\n";
+    return;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+  this->dataPtr->stepBatchSize = _size;
+}
+
+//////////////////////////////////////////////////
+double World::SleepTime() const
+{
+  return this->dataPtr->sleepTime;
+}
+
+//////////////////////////////////////////////////
+void World::SetSleepTime(const double _time)
+{
+  if (_time < 0)
+  {
+    gzerr << "Sleep time must not be negative\n";
+    return;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+  this->dataPtr->sleepTime = _time;
+
+  // Disabling sleep wakes all models up.
+  if (ignition::math::equal(_time, 0.0))
+  {
+    for (auto &model : this->dataPtr->models)
+      model->Wake();
+  }
+}
+
+//////////////////////////////////////////////////
+void World::SetSleepThresholds(const double _linear, const double _angular)
+{
+  if (_linear < 0 || _angular < 0)
+  {
+    gzerr << "Sleep velocity thresholds must not be negative\n";
+    return;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+  this->dataPtr->sleepLinearThreshold = _linear;
+  this->dataPtr->sleepAngularThreshold = _angular;
+}
+
+//////////////////////////////////////////////////
+double World::SleepLinearThreshold() const
+{
+  return this->dataPtr->sleepLinearThreshold;
+}
+
+//////////////////////////////////////////////////
+double World::SleepAngularThreshold() const
+{
+  return this->dataPtr->sleepAngularThreshold;
+}
+
+//////////////////////////////////////////////////
+void World::UpdateSleep()
+{
+  const double dt = this->dataPtr->physicsEngine->GetMaxStepSize();
+  for (auto &model : this->dataPtr->models)
+  {
+    model->UpdateSleep(dt, this->dataPtr->sleepTime,
+        this->dataPtr->sleepLinearThreshold,
+        this->dataPtr->sleepAngularThreshold);
+  }
+}
+
+//////////////////////////////////////////////////
+void World::AddStepBarrier(const common::Time &_simTime,
+    const std::function<void()> &_callback)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->stepBarriersMutex);
+  this->dataPtr->stepBarriers.emplace(_simTime, _callback);
+}
+
+//////////////////////////////////////////////////
+void World::SaveSnapshot(WorldSnapshot &_snapshot)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+
+  _snapshot.worldName = this->Name();
+  _snapshot.simTime = this->dataPtr->simTime;
+  _snapshot.iterations = this->dataPtr->iterations;
+  _snapshot.entityGeneration = this->dataPtr->entityGeneration;
+
+  {
+    boost::recursive_mutex::scoped_lock plock(
+        *this->dataPtr->physicsEngine->GetPhysicsUpdateMutex());
+    this->dataPtr->physicsEngine->SaveSnapshot(_snapshot.physicsData);
+  }
+
+  std::lock_guard<std::mutex> cbLock(this->dataPtr->snapshotCallbacksMutex);
+  _snapshot.pluginData.clear();
+  for (auto const &callbacks : this->dataPtr->snapshotCallbacks)
+    _snapshot.pluginData[callbacks.first] = callbacks.second.first();
+}
+
+//////////////////////////////////////////////////
+bool World::RestoreSnapshot(const WorldSnapshot &_snapshot)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+
+  if (_snapshot.worldName != this->Name())
+  {
+    gzerr << "Snapshot of world[" << _snapshot.worldName
+          << "] can't be restored in world[" << this->Name() << "]\n";
+    return false;
+  }
+
+  if (_snapshot.entityGeneration != this->dataPtr->entityGeneration)
+  {
+    gzerr << "Models were inserted or removed since the snapshot was saved, "
+          << "it can't be restored\n";
+    return false;
+  }
+
+  {
+    boost::recursive_mutex::scoped_lock plock(
+        *this->dataPtr->physicsEngine->GetPhysicsUpdateMutex());
+    if (!this->dataPtr->physicsEngine->RestoreSnapshot(_snapshot.physicsData))
+      return false;
+  }
+
+  // Models start awake from the restored state.
+  for (auto &model : this->dataPtr->models)
+    model->Wake();
+
+  // Propagate the restored link poses to the entities.
+  this->FlushDirtyPoses();
+
+  // Contacts of the previous step are no longer valid.
+  this->dataPtr->physicsEngine->GetContactManager()->Clear();
+
+  this->dataPtr->simTime = _snapshot.simTime;
+  this->dataPtr->iterations = _snapshot.iterations;
+
+  // Sensors reset their last update time when time jumps.
+  event::Events::timeReset();
+
+  std::lock_guard<std::mutex> cbLock(this->dataPtr->snapshotCallbacksMutex);
+  for (auto const &data : _snapshot.pluginData)
+  {
+    auto iter = this->dataPtr->snapshotCallbacks.find(data.first);
+    if (iter == this->dataPtr->snapshotCallbacks.end())
+    {
+      gzwarn << "No snapshot callbacks registered for [" << data.first
+             << "], its data is ignored\n";
+      continue;
+    }
+    iter->second.second(data.second);
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+void World::AddSnapshotCallbacks(const std::string &_name,
+    std::function<std::string()> _save,
+    std::function<void(const std::string &)> _restore)
+{
+  if (!_save || !_restore)
+  {
+    gzerr << "Invalid snapshot callbacks for [" << _name << "]\n";
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->snapshotCallbacksMutex);
+  this->dataPtr->snapshotCallbacks[_name] = std::make_pair(_save, _restore);
+}
+
+//////////////////////////////////////////////////
+void World::RemoveSnapshotCallbacks(const std::string &_name)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->snapshotCallbacksMutex);
+  this->dataPtr->snapshotCallbacks.erase(_name);
+}
+
+//////////////////////////////////////////////////
+bool World::SaveCheckpoint(const std::string &_filename)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+
+  if (this->dataPtr->checkpointWriting)
+  {
+    gzwarn << "The previous checkpoint is still being written, skipping "
+           << "the checkpoint at sim time[" << this->dataPtr->simTime
+           << "]\n";
+    return false;
+  }
+
+  auto checkpoint = std::make_shared<WorldCheckpoint>();
+  this->SaveSnapshot(checkpoint->snapshot);
+
+  // The populations were expanded into models when the world was loaded
+  sdf::ElementPtr worldSdf = this->SDF()->Clone();
+  while (worldSdf->HasElement("population"))
+    worldSdf->RemoveChild(worldSdf->GetElement("population"));
+  checkpoint->sdf = "<?xml version ='1.0'?>\n";
+  checkpoint->sdf += "<sdf version='" + std::string(SDF_VERSION) + "'>\n";
+  checkpoint->sdf += worldSdf->ToString("");
+  checkpoint->sdf += "</sdf>\n";
+
+  if (this->dataPtr->checkpointThread.joinable())
+    this->dataPtr->checkpointThread.join();
+  this->dataPtr->checkpointWriting = true;
+  this->dataPtr->checkpointThread = std::thread([this, checkpoint, _filename]()
+      {
+        this->dataPtr->checkpointWritten = checkpoint->Write(_filename);
+        this->dataPtr->checkpointWriting = false;
+      });
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool World::WaitForCheckpoint()
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+  if (this->dataPtr->checkpointThread.joinable())
+    this->dataPtr->checkpointThread.join();
+  return this->dataPtr->checkpointWritten;
+}
+
+//////////////////////////////////////////////////
+void World::SetCheckpointPeriod(const double _period,
+    const std::string &_filename)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+  this->dataPtr->checkpointPeriod = std::max(0.0, _period);
+  this->dataPtr->checkpointPath = _filename;
+  this->dataPtr->nextCheckpointTime = this->dataPtr->simTime +
+      this->dataPtr->checkpointPeriod;
+}
+
+//////////////////////////////////////////////////
+double World::CheckpointPeriod() const
+{
+  return this->dataPtr->checkpointPeriod;
+}
+
+//////////////////////////////////////////////////
+bool World::ResumeCheckpoint(const WorldCheckpoint &_checkpoint)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+
+  if (_checkpoint.snapshot.worldName != this->Name())
+  {
+    gzerr << "Checkpoint of world[" << _checkpoint.snapshot.worldName
+          << "] can't be resumed in world[" << this->Name() << "]\n";
+    return false;
+  }
+
+  if (!this->dataPtr->pluginsLoaded)
+  {
+    if (this->dataPtr->resumeCheckpoint.get() != &_checkpoint)
+      this->dataPtr->resumeCheckpoint.reset(new WorldCheckpoint(_checkpoint));
+    return true;
+  }
+
+  // The entities of the world were loaded from the SDF of the checkpoint,
+  // so the generation counters don't compare.
+  WorldSnapshot snapshot = _checkpoint.snapshot;
+  snapshot.entityGeneration = this->dataPtr->entityGeneration;
+  if (!this->RestoreSnapshot(snapshot))
+    return false;
+
+  this->dataPtr->nextCheckpointTime = this->dataPtr->simTime +
+      this->dataPtr->checkpointPeriod;
+  gzmsg << "World[" << this->Name() << "] resumed at sim time["
+        << this->dataPtr->simTime << "]\n";
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool World::StepBarrierReached()
+{
+  std::vector<std::function<void()>> callbacks;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->stepBarriersMutex);
+    auto &barriers = this->dataPtr->stepBarriers;
+    auto end = barriers.upper_bound(this->dataPtr->simTime);
+    if (end == barriers.begin())
+      return false;
+
+    for (auto iter = barriers.begin(); iter != end; ++iter)
+    {
+      if (iter->second)
+        callbacks.push_back(iter->second);
+    }
+    barriers.erase(barriers.begin(), end);
+  }
+
+  // Callbacks may add barriers
+  for (auto const &callback : callbacks)
+    callback();
+  return true;
+}
+
+//////////////////////////////////////////////////
+void World::ModelUpdateSingleLoop()
+{
+  // Update all the models
+  for (unsigned int i = 0; i < this->dataPtr->rootElement->GetChildCount(); ++i)
+    this->dataPtr->rootElement->GetChild(i)->Update();
+}
+
+
+//////////////////////////////////////////////////
 void World::LoadPlugins()
 {
   // Load the plugins
@@ -1691,6 +2937,9 @@ void World::LoadPlugin(const std::string &_filename,
             << "Plugin filename[" << _filename << "] name[" << _name << "]\n";
       return;
     }
+
+    // Account the callbacks the plugin connects to it
+    event::ConnectionOwner owner(_name);
     plugin->Load(shared_from_this(), _sdf);
     this->dataPtr->plugins.push_back(plugin);
 
@@ -1778,8 +3027,7 @@ void World::ProcessRequestMsgs()
     }
     else if (requestMsg.request() == "entity_info")
     {
-      BasePtr entity(
-        this->dataPtr->rootElement->GetByName(requestMsg.data()));
+      BasePtr entity(this->BaseByName(requestMsg.data()));
       if (entity)
       {
         if (entity->HasType(Base::MODEL))
@@ -2054,8 +3302,9 @@ void World::ProcessFactoryMsgs()
 
     if (factoryMsg.has_sdf() && !factoryMsg.sdf().empty())
     {
-      // SDF Parsing happens here
-      if (!sdf::readString(factoryMsg.sdf(), this->dataPtr->factorySDF))
+      // SDF Parsing happens here, once per string
+      if (!common::SdfCache::ReadString(factoryMsg.sdf(),
+            this->dataPtr->factorySDF))
       {
         gzerr << "Unable to read sdf string[" << factoryMsg.sdf() << "]\n";
         continue;
@@ -2079,7 +3328,8 @@ void World::ProcessFactoryMsgs()
             factoryMsg.sdf_filename());
       }
 
-      if (!sdf::readFile(filename, this->dataPtr->factorySDF))
+      // A model file inserted many times is parsed once
+      if (!common::SdfCache::ReadFile(filename, this->dataPtr->factorySDF))
       {
         gzerr << "Unable to read sdf file.\n";
         continue;
@@ -2113,8 +3363,7 @@ void World::ProcessFactoryMsgs()
 
     if (factoryMsg.has_edit_name())
     {
-      BasePtr base(
-        this->dataPtr->rootElement->GetByName(factoryMsg.edit_name()));
+      BasePtr base(this->BaseByName(factoryMsg.edit_name()));
       if (base)
       {
         sdf::ElementPtr elem;
@@ -2132,7 +3381,9 @@ void World::ProcessFactoryMsgs()
       bool isModel = false;
       bool isLight = false;
 
-      sdf::ElementPtr elem = this->dataPtr->factorySDF->Root()->Clone();
+      // factorySDF owns its elements, a copy made by SdfCache or of the
+      // cloned model, so the entity is moved out of it without a copy
+      sdf::ElementPtr elem = this->dataPtr->factorySDF->Root();
 
       if (!elem)
       {
@@ -2166,6 +3417,50 @@ void World::ProcessFactoryMsgs()
         continue;
       }
 
+      // Copies of a model share the parsed SDF
+      if (isModel && factoryMsg.instances_size() > 0)
+      {
+        // Names of the copies, which aren't models yet
+        std::set<std::string> names;
+        const auto modelName = elem->Get<std::string>("name");
+        int next = 0;
+        for (auto const &instance : factoryMsg.instances())
+        {
+          std::string entityName = instance.name();
+          if (entityName.empty())
+          {
+            do
+            {
+              entityName = modelName + "_" + std::to_string(next++);
+            }
+            while (names.count(entityName) || this->ModelByName(entityName));
+          }
+          else if (names.count(entityName) || this->ModelByName(entityName))
+          {
+            gzwarn << "A model named [" << entityName << "] already exists. "
+                   << "Model won't be inserted." << std::endl;
+            continue;
+          }
+          names.insert(entityName);
+
+          sdf::ElementPtr instanceElem = elem->Clone();
+          instanceElem->GetAttribute("name")->Set(entityName);
+
+          if (instance.has_pose())
+          {
+            instanceElem->GetElement("pose")->Set(
+                msgs::ConvertIgn(instance.pose()));
+          }
+
+          instanceElem->SetParent(this->dataPtr->sdf);
+          instanceElem->GetParent()->InsertElement(instanceElem);
+          modelsToLoad.push_back(instanceElem);
+        }
+        continue;
+      }
+
+      // Detached, so that clearing factorySDF doesn't clear the entity
+      elem->GetParent()->RemoveChild(elem);
       elem->SetParent(this->dataPtr->sdf);
       elem->GetParent()->InsertElement(elem);
       if (factoryMsg.has_pose())
@@ -2214,7 +3509,8 @@ void World::ProcessFactoryMsgs()
     }
   }
 
-  // Load models
+  // Load models, and then tell the clients about all of them
+  this->dataPtr->deferModelMsgs = true;
   for (auto const &elem : modelsToLoad)
   {
     try
@@ -2233,6 +3529,15 @@ void World::ProcessFactoryMsgs()
       gzerr << "Loading model from factory message failed\n";
     }
   }
+  this->dataPtr->deferModelMsgs = false;
+
+  if (!this->dataPtr->deferredModelMsgs.empty())
+  {
+    for (auto const &msg : this->dataPtr->deferredModelMsgs)
+      this->dataPtr->modelPub->Publish(msg);
+    this->dataPtr->deferredModelMsgs.clear();
+    this->EnableAllModels();
+  }
 
   // Load lights
   for (auto const &elem : lightsToLoad)
@@ -2263,6 +3568,82 @@ ModelPtr World::ModelBelowPoint(const ignition::math::Vector3d &_pt) const
   return model;
 }
 
+//////////////////////////////////////////////////
+Model_V World::ModelsInBox(const ignition::math::AxisAlignedBox &_box) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->modelIndexMutex);
+
+  // Refresh the boxes once per iteration, and whenever models are inserted
+  // or removed
+  if (!this->dataPtr->modelIndexValid ||
+      this->dataPtr->modelIndexIterations != this->dataPtr->iterations ||
+      this->dataPtr->modelIndexGeneration != this->dataPtr->entityGeneration)
+  {
+    this->dataPtr->modelIndexValid = true;
+    this->dataPtr->modelIndexIterations = this->dataPtr->iterations;
+    this->dataPtr->modelIndexGeneration = this->dataPtr->entityGeneration;
+
+    auto &entries = this->dataPtr->modelIndexEntries;
+    std::set<unsigned int> seen;
+
+    std::list<ModelPtr> modelList(this->dataPtr->models.begin(),
+        this->dataPtr->models.end());
+    while (!modelList.empty())
+    {
+      ModelPtr model = modelList.front();
+      modelList.pop_front();
+      if (!model)
+        continue;
+
+      for (auto const &nested : model->NestedModels())
+        modelList.push_back(nested);
+
+      const unsigned int id = model->GetId();
+      seen.insert(id);
+
+      // Static models only move when their pose is set
+      const ignition::math::Pose3d pose = model->WorldPose();
+      auto iter = entries.find(id);
+      if (iter != entries.end() && model->IsStatic() &&
+          iter->second.second == pose)
+      {
+        continue;
+      }
+
+      ignition::math::AxisAlignedBox box = model->BoundingBox();
+      box += ignition::math::AxisAlignedBox(pose.Pos(), pose.Pos());
+      this->dataPtr->modelIndex.Set(id, box);
+      entries[id] = std::make_pair(boost::weak_ptr<Model>(model), pose);
+    }
+
+    for (auto iter = entries.begin(); iter != entries.end();)
+    {
+      if (seen.find(iter->first) == seen.end())
+      {
+        this->dataPtr->modelIndex.Remove(iter->first);
+        iter = entries.erase(iter);
+      }
+      else
+      {
+        ++iter;
+      }
+    }
+  }
+
+  Model_V result;
+  for (auto const id : this->dataPtr->modelIndex.Query(_box))
+  {
+    auto iter = this->dataPtr->modelIndexEntries.find(id);
+    if (iter == this->dataPtr->modelIndexEntries.end())
+      continue;
+
+    ModelPtr model = iter->second.first.lock();
+    if (model)
+      result.push_back(model);
+  }
+  return result;
+}
+
 //////////////////////////////////////////////////
 EntityPtr World::EntityBelowPoint(const ignition::math::Vector3d &_pt) const
 {
@@ -2286,128 +3667,253 @@ void World::SetState(const WorldState &_state)
   this->dataPtr->logRealTime = _state.GetRealTime();
   this->dataPtr->iterations = _state.GetIterations();
 
-  // Insertions (adapted from ProcessFactoryMsgs)
-  auto insertions = _state.Insertions();
-  for (auto const &insertion : insertions)
-  {
-    this->dataPtr->factorySDF->Clear();
+  // Insertions
+  for (auto const &insertion : _state.Insertions())
+    this->InsertEntity(insertion);
 
-    std::stringstream sdfStr;
-    sdfStr << "<sdf version='" << SDF_VERSION << "'>"
-           << insertion
-           << "</sdf>";
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->stateTargetsMutex);
 
-    // SDF Parsing happens here
-    if (!sdf::readString(sdfStr.str(), this->dataPtr->factorySDF))
+    // The entities are resolved again once models or lights are inserted
+    // or removed
+    if (this->dataPtr->stateTargetsGeneration !=
+        this->dataPtr->entityGeneration)
     {
-      gzerr << "Unable to read sdf string[" << insertion << "]" << std::endl;
-      continue;
+      this->dataPtr->stateTargets.clear();
+      this->dataPtr->stateLights.clear();
+      this->dataPtr->stateTargetsGeneration = this->dataPtr->entityGeneration;
     }
 
-    // Get entity being inserted
-    bool isModel = false;
-    bool isLight = false;
-
-    auto elem = this->dataPtr->factorySDF->Root()->Clone();
-
-    if (!elem)
+    // Names are resolved before locking the physics engine, since the
+    // model and light lookups lock the lists of entities.
+    struct ModelTarget
     {
-      gzerr << "Invalid SDF:" << std::endl;
-      this->dataPtr->factorySDF->Root()->PrintValues("");
-      continue;
-    }
-
-    if (elem->HasElement("world"))
-      elem = elem->GetElement("world");
-
-    if (elem->HasElement("model"))
+      StateTarget *target;
+      ModelPtr model;
+      const ModelState *state;
+    };
+    std::vector<ModelTarget> models;
+    models.reserve(_state.GetModelStates().size());
+    for (auto const &modelState : _state.GetModelStates())
     {
-      elem = elem->GetElement("model");
-      isModel = true;
+      const std::string &name = modelState.second.GetName();
+      StateTarget &target = this->dataPtr->stateTargets[name];
+      ModelPtr model = target.model.lock();
+      if (!model)
+      {
+        model = this->ModelByName(name);
+        target.model = model;
+      }
+
+      if (model)
+        models.push_back({&target, model, &modelState.second});
+      else
+        gzerr << "Unable to find model[" << name << "]\n";
     }
-    else if (elem->HasElement("light"))
+
+    std::vector<std::pair<LightPtr, const LightState *>> lights;
+    lights.reserve(_state.LightStates().size());
+    for (auto const &lightState : _state.LightStates())
     {
-      elem = elem->GetElement("light");
-      isLight = true;
+      const std::string &name = lightState.second.GetName();
+      auto &target = this->dataPtr->stateLights[name];
+      LightPtr light = target.lock();
+      if (!light)
+      {
+        light = this->LightByName(name);
+        target = light;
+      }
+
+      if (light)
+        lights.emplace_back(light, &lightState.second);
+      else
+        gzerr << "Unable to find light[" << name << "]" << std::endl;
     }
-    else
+
+    // All the states are applied in a single lock of the physics engine
+    boost::unique_lock<boost::recursive_mutex> plock;
+    if (this->dataPtr->physicsEngine)
     {
-      gzerr << "Unable to find a model or light in:" << std::endl;
-      this->dataPtr->factorySDF->Root()->PrintValues("");
-      continue;
+      plock = boost::unique_lock<boost::recursive_mutex>(
+          *this->dataPtr->physicsEngine->GetPhysicsUpdateMutex());
     }
 
-    elem->SetParent(this->dataPtr->sdf);
-    elem->GetParent()->InsertElement(elem);
+    // Model updates
+    for (auto const &model : models)
+      ApplyModelState(*model.target, model.model, *model.state);
+
+    // Light updates
+    for (auto const &light : lights)
+      light.first->SetState(*light.second);
+  }
+
+  // Deletions
+  auto deletions = _state.Deletions();
+  for (auto const &deletion : deletions)
+  {
+    // This works for models and lights
+    this->RemoveModel(deletion);
+  }
+}
+
+//////////////////////////////////////////////////
+void World::InsertEntity(const std::string &_insertion)
+{
+  // Adapted from ProcessFactoryMsgs
+  this->dataPtr->factorySDF->Clear();
+
+  std::stringstream sdfStr;
+  sdfStr << "<sdf version='" << SDF_VERSION << "'>"
+         << _insertion
+         << "</sdf>";
+
+  // SDF Parsing happens here
+  if (!common::SdfCache::ReadString(sdfStr.str(), this->dataPtr->factorySDF))
+  {
+    gzerr << "Unable to read sdf string[" << _insertion << "]" << std::endl;
+    return;
+  }
+
+  // Get entity being inserted
+  bool isModel = false;
+  bool isLight = false;
 
-    if (isModel)
+  auto elem = this->dataPtr->factorySDF->Root()->Clone();
+
+  if (!elem)
+  {
+    gzerr << "Invalid SDF:" << std::endl;
+    this->dataPtr->factorySDF->Root()->PrintValues("");
+    return;
+  }
+
+  if (elem->HasElement("world"))
+    elem = elem->GetElement("world");
+
+  if (elem->HasElement("model"))
+  {
+    elem = elem->GetElement("model");
+    isModel = true;
+  }
+  else if (elem->HasElement("light"))
+  {
+    elem = elem->GetElement("light");
+    isLight = true;
+  }
+  else
+  {
+    gzerr << "Unable to find a model or light in:" << std::endl;
+    this->dataPtr->factorySDF->Root()->PrintValues("");
+    return;
+  }
+
+  elem->SetParent(this->dataPtr->sdf);
+  elem->GetParent()->InsertElement(elem);
+
+  if (isModel)
+  {
+    try
     {
-      try
-      {
-        std::lock_guard<std::mutex> lock(this->dataPtr->factoryDeleteMutex);
+      std::lock_guard<std::mutex> lock(this->dataPtr->factoryDeleteMutex);
 
-        ModelPtr model = this->LoadModel(elem, this->dataPtr->rootElement);
-        if (model != nullptr)
-        {
-          model->Init();
-          if (!util::LogPlay::Instance()->IsOpen())
-            model->LoadPlugins();
-        }
-      }
-      catch(...)
+      ModelPtr model = this->LoadModel(elem, this->dataPtr->rootElement);
+      if (model != nullptr)
       {
-        gzerr << "Loading model from world state insertion failed" <<
-            std::endl;
+        model->Init();
+        if (!util::LogPlay::Instance()->IsOpen())
+          model->LoadPlugins();
       }
     }
-    else if (isLight)
+    catch(...)
     {
-      try
-      {
-        std::lock_guard<std::mutex> lock(this->dataPtr->factoryDeleteMutex);
+      gzerr << "Loading model from world state insertion failed" <<
+          std::endl;
+    }
+  }
+  else if (isLight)
+  {
+    try
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->factoryDeleteMutex);
 
-        LightPtr light = this->LoadLight(elem, this->dataPtr->rootElement);
-        light->Init();
-      }
-      catch(...)
-      {
-        gzerr << "Loading light from world state insertion failed." <<
-            std::endl;
-      }
+      LightPtr light = this->LoadLight(elem, this->dataPtr->rootElement);
+      light->Init();
+    }
+    catch(...)
+    {
+      gzerr << "Loading light from world state insertion failed." <<
+          std::endl;
     }
   }
+}
 
-  // Model updates
-  const ModelState_M modelStates = _state.GetModelStates();
-  for (auto const &modelState : modelStates)
+//////////////////////////////////////////////////
+void World::RebuildFromKeyframe(const common::Time &_time)
+{
+  std::vector<std::string> frames;
+  if (!util::LogPlay::Instance()->Keyframe(_time, frames))
   {
-    ModelPtr model = this->ModelByName(modelState.second.GetName());
-    if (model)
-      model->SetState(modelState.second);
-    else
-      gzerr << "Unable to find model[" << modelState.second.GetName() << "]\n";
+    gzwarn << "Unable to find a log keyframe before time[" << _time
+           << "], models and lights may be out of date\n";
+    return;
   }
 
-  // Light updates
-  const LightState_M lightStates = _state.LightStates();
-  for (auto const &lightState : lightStates)
+  // SDF of the models and lights at the time, starting with the keyframe's
+  std::map<std::string, std::string> entities;
+  const std::string &keyframe = frames.front();
+  auto keyframeStart = keyframe.find(kKeyframeStart);
+  auto keyframeEnd = keyframe.find(kKeyframeEnd);
+  if (keyframeStart != std::string::npos &&
+      keyframeEnd != std::string::npos)
   {
-    LightPtr light = this->LightByName(lightState.second.GetName());
-    if (light)
-      light->SetState(lightState.second);
-    else
+    keyframeStart += kKeyframeStart.size();
+    ReadLogEntities("<sdf version='" + std::string(SDF_VERSION) + "'>"
+        "<world name='keyframe'>" +
+        keyframe.substr(keyframeStart, keyframeEnd - keyframeStart) +
+        "</world></sdf>", entities);
+  }
+  else
+  {
+    // The first frame of the log, with the world's SDF
+    ReadLogEntities(keyframe, entities);
+  }
+
+  // Then the insertions and deletions after it
+  sdf::ElementPtr stateSDF(new sdf::Element);
+  sdf::initFile("state.sdf", stateSDF);
+  WorldState state;
+  for (size_t i = 1; i < frames.size(); ++i)
+  {
+    if (!LoadLogState(frames[i], stateSDF, state))
+      continue;
+
+    for (auto const &insertion : state.Insertions())
     {
-      gzerr << "Unable to find light[" << lightState.second.GetName() << "]"
-            << std::endl;
+      ReadLogEntities("<sdf version='" + std::string(SDF_VERSION) + "'>"
+          "<world name='keyframe'>" + insertion + "</world></sdf>", entities);
     }
+    for (auto const &deletion : state.Deletions())
+      entities.erase(deletion);
   }
 
-  // Deletions
-  auto deletions = _state.Deletions();
-  for (auto const &deletion : deletions)
+  std::vector<std::string> removed;
+  for (auto const &model : this->dataPtr->models)
   {
-    // This works for models and lights
-    this->RemoveModel(deletion);
+    if (entities.find(model->GetName()) == entities.end())
+      removed.push_back(model->GetName());
+  }
+  for (auto const &light : this->dataPtr->lights)
+  {
+    if (entities.find(light->GetName()) == entities.end())
+      removed.push_back(light->GetName());
+  }
+  for (auto const &name : removed)
+    this->RemoveModel(name);
+
+  for (auto const &entity : entities)
+  {
+    if (!this->ModelByName(entity.first) && !this->LightByName(entity.first))
+      this->InsertEntity(entity.second);
   }
 }
 
@@ -2438,6 +3944,23 @@ void World::InsertModelString(const std::string &_sdfString)
   this->dataPtr->factoryMsgs.push_back(msg);
 }
 
+//////////////////////////////////////////////////
+void World::InsertModelsString(const std::string &_sdfString,
+    const std::vector<std::pair<std::string, ignition::math::Pose3d>>
+    &_instances)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
+  msgs::Factory msg;
+  msg.set_sdf(_sdfString);
+  for (auto const &instance : _instances)
+  {
+    auto instanceMsg = msg.add_instances();
+    instanceMsg->set_name(instance.first);
+    msgs::Set(instanceMsg->mutable_pose(), instance.second);
+  }
+  this->dataPtr->factoryMsgs.push_back(msg);
+}
+
 //////////////////////////////////////////////////
 std::string World::StripWorldName(const std::string &_name) const
 {
@@ -2453,6 +3976,7 @@ void World::EnableAllModels()
   for (auto &model : this->dataPtr->models)
   {
     model->SetEnabled(true);
+    model->Wake();
   }
 }
 
@@ -2579,6 +4103,8 @@ void World::LogModelResources()
 bool World::OnLog(std::ostringstream &_stream)
 {
   int bufferIndex = this->dataPtr->currentStateBuffer;
+  bool binary = util::LogRecord::Instance()->BinaryStates();
+
   // Save the entire state when its the first call to OnLog.
   if (util::LogRecord::Instance()->FirstUpdate())
   {
@@ -2595,14 +4121,13 @@ bool World::OnLog(std::ostringstream &_stream)
       std::lock_guard<std::mutex> lock(this->dataPtr->logBufferMutex);
       this->dataPtr->currentStateBuffer ^= 1;
     }
-    for (auto const &worldState : this->dataPtr->states[bufferIndex])
-    {
-      _stream << "<sdf version='" << SDF_VERSION << "'>"
-              << worldState
-              << "</sdf>";
-    }
+    auto const &states = this->dataPtr->states[bufferIndex];
+    auto const &keyframes = this->dataPtr->keyframes[bufferIndex];
+    for (size_t i = 0; i < states.size(); ++i)
+      WriteLogState(states[i], keyframes[i], binary, _stream);
 
     this->dataPtr->states[bufferIndex].clear();
+    this->dataPtr->keyframes[bufferIndex].clear();
   }
 
   // Logging has stopped. Wait for log worker to finish. Output last bit
@@ -2612,27 +4137,20 @@ bool World::OnLog(std::ostringstream &_stream)
     std::lock_guard<std::mutex> lock(this->dataPtr->logBufferMutex);
 
     // Output any data that may have been pushed onto the queue
-    for (size_t i = 0;
-        i < this->dataPtr->states[this->dataPtr->currentStateBuffer^1].size();
-        ++i)
+    for (auto const buffer : {this->dataPtr->currentStateBuffer ^ 1,
+                              this->dataPtr->currentStateBuffer})
     {
-      _stream << "<sdf version='" << SDF_VERSION << "'>"
-        << this->dataPtr->states[this->dataPtr->currentStateBuffer^1][i]
-        << "</sdf>";
-    }
-
-    for (size_t i = 0;
-        i < this->dataPtr->states[this->dataPtr->currentStateBuffer].size();
-        ++i)
-    {
-      _stream << "<sdf version='" << SDF_VERSION << "'>"
-        << this->dataPtr->states[this->dataPtr->currentStateBuffer][i]
-        << "</sdf>";
+      auto const &states = this->dataPtr->states[buffer];
+      auto const &keyframes = this->dataPtr->keyframes[buffer];
+      for (size_t i = 0; i < states.size(); ++i)
+        WriteLogState(states[i], keyframes[i], binary, _stream);
     }
 
     // Clear everything.
     this->dataPtr->states[0].clear();
     this->dataPtr->states[1].clear();
+    this->dataPtr->keyframes[0].clear();
+    this->dataPtr->keyframes[1].clear();
     this->dataPtr->stateToggle = 0;
     this->dataPtr->prevStates[0] = WorldState();
     this->dataPtr->prevStates[1] = WorldState();
@@ -2643,90 +4161,133 @@ bool World::OnLog(std::ostringstream &_stream)
   return true;
 }
 
+//////////////////////////////////////////////////
+/// \brief Fill a poses message with the relative poses of models, their
+/// links and nested models, and lights. The message is cleared first,
+/// which keeps its pose entries allocated for reuse.
+/// \param[in] _time Time stamp of the message.
+/// \param[in] _models Models to add.
+/// \param[in] _lights Lights to add.
+/// \param[out] _msg Message to fill.
+static void FillPosesMsg(const common::Time &_time,
+    const std::set<ModelPtr> &_models, const std::set<LightPtr> &_lights,
+    msgs::PosesStamped &_msg)
+{
+  _msg.Clear();
+  msgs::Set(_msg.mutable_time(), _time);
+
+  std::function<void(const ModelPtr &)> addModel = [&](const ModelPtr &_model)
+  {
+    // Publish the model's relative pose
+    msgs::Pose *poseMsg = _msg.add_pose();
+    poseMsg->set_name(_model->GetScopedName());
+    poseMsg->set_id(_model->GetId());
+    msgs::Set(poseMsg, _model->RelativePose());
+
+    // Publish each of the model's child links relative poses
+    for (auto const &link : _model->GetLinks())
+    {
+      poseMsg = _msg.add_pose();
+      poseMsg->set_name(link->GetScopedName());
+      poseMsg->set_id(link->GetId());
+      msgs::Set(poseMsg, link->RelativePose());
+    }
+
+    for (auto const &nested : _model->NestedModels())
+      addModel(nested);
+  };
+
+  for (auto const &model : _models)
+    addModel(model);
+
+  for (auto const &light : _lights)
+  {
+    // Publish the light's pose
+    msgs::Pose *poseMsg = _msg.add_pose();
+    poseMsg->set_name(light->GetScopedName());
+    poseMsg->set_id(light->GetId());
+    msgs::Set(poseMsg, light->RelativePose());
+  }
+}
+
 //////////////////////////////////////////////////
 void World::ProcessMessages()
 {
   {
     std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
 
-    if ((this->dataPtr->posePub && this->dataPtr->posePub->HasConnections()) ||
-      // When ready to use the direct API for updating scene poses from server,
-      // uncomment the following line:
-      // this->dataPtr->updateScenePoses ||
-        (this->dataPtr->poseLocalPub &&
-         this->dataPtr->poseLocalPub->HasConnections()))
-    {
-      msgs::PosesStamped msg;
+    bool localConnected = this->dataPtr->poseLocalPub &&
+        this->dataPtr->poseLocalPub->HasConnections();
+    bool remoteConnected = this->dataPtr->posePub &&
+        this->dataPtr->posePub->HasConnections();
 
-      // Time stamp this PosesStamped message
-      msgs::Set(msg.mutable_time(), this->SimTime());
+    // A server without rendering has no scene to update
+    const bool sceneConnected = this->dataPtr->updateScenePoses &&
+        (!this->dataPtr->hasScene || this->dataPtr->hasScene(this->Name()));
 
-      if (!this->dataPtr->publishModelPoses.empty() ||
-          !this->dataPtr->publishLightPoses.empty())
+    if (localConnected || sceneConnected)
+    {
+      // rendering::Scene depends on this timestamp, which is used by
+      // rendering sensors to time stamp their data, so the message is
+      // sent even if nothing moved.
+      FillPosesMsg(this->SimTime(), this->dataPtr->publishModelPoses,
+          this->dataPtr->publishLightPoses, this->dataPtr->localPosesMsg);
+
+      // Scenes in this process read the poses directly
+      if (sceneConnected)
       {
-        for (auto const &model : this->dataPtr->publishModelPoses)
-        {
-          std::list<ModelPtr> modelList;
-          modelList.push_back(model);
-          while (!modelList.empty())
-          {
-            ModelPtr m = modelList.front();
-            modelList.pop_front();
-            msgs::Pose *poseMsg = msg.add_pose();
-
-            // Publish the model's relative pose
-            poseMsg->set_name(m->GetScopedName());
-            poseMsg->set_id(m->GetId());
-            msgs::Set(poseMsg, m->RelativePose());
+        this->dataPtr->updateScenePoses(this->Name(),
+            this->dataPtr->localPosesMsg);
+      }
 
-            // Publish each of the model's child links relative poses
-            Link_V links = m->GetLinks();
-            for (auto const &link : links)
-            {
-              poseMsg = msg.add_pose();
-              poseMsg->set_name(link->GetScopedName());
-              poseMsg->set_id(link->GetId());
-              msgs::Set(poseMsg, link->RelativePose());
-            }
+      if (localConnected)
+        this->dataPtr->poseLocalPub->Publish(this->dataPtr->localPosesMsg);
+    }
 
-            // add all nested models to the queue
-            Model_V models = m->NestedModels();
-            for (auto const &n : models)
-              modelList.push_back(n);
-          }
+    if (remoteConnected)
+    {
+      this->dataPtr->pendingModelPoses.insert(
+          this->dataPtr->publishModelPoses.begin(),
+          this->dataPtr->publishModelPoses.end());
+      this->dataPtr->pendingLightPoses.insert(
+          this->dataPtr->publishLightPoses.begin(),
+          this->dataPtr->publishLightPoses.end());
+
+      // Only serialize when the message will actually go out, the pending
+      // sets keep the poses that changed in the meantime.
+      if ((!this->dataPtr->pendingModelPoses.empty() ||
+           !this->dataPtr->pendingLightPoses.empty()) &&
+          this->dataPtr->posePub->ReadyToPublish())
+      {
+        // The pending sets contain the current ones, if they have the same
+        // size the local message already has the right content.
+        if ((localConnected || sceneConnected) &&
+            this->dataPtr->pendingModelPoses.size() ==
+            this->dataPtr->publishModelPoses.size() &&
+            this->dataPtr->pendingLightPoses.size() ==
+            this->dataPtr->publishLightPoses.size())
+        {
+          this->dataPtr->posePub->Publish(this->dataPtr->localPosesMsg);
         }
-
-        for (auto const &light : this->dataPtr->publishLightPoses)
+        else
         {
-          msgs::Pose *poseMsg = msg.add_pose();
-
-          // Publish the light's pose
-          poseMsg->set_name(light->GetScopedName());
-          poseMsg->set_id(light->GetId());
-          msgs::Set(poseMsg, light->RelativePose());
+          FillPosesMsg(this->SimTime(), this->dataPtr->pendingModelPoses,
+              this->dataPtr->pendingLightPoses, this->dataPtr->posesMsg);
+          this->dataPtr->posePub->Publish(this->dataPtr->posesMsg);
         }
 
-        if (this->dataPtr->posePub && this->dataPtr->posePub->HasConnections())
-          this->dataPtr->posePub->Publish(msg);
-      }
-
-      if (this->dataPtr->poseLocalPub &&
-          this->dataPtr->poseLocalPub->HasConnections())
-      {
-        // rendering::Scene depends on this timestamp, which is used by
-        // rendering sensors to time stamp their data
-        this->dataPtr->poseLocalPub->Publish(msg);
+        this->dataPtr->pendingModelPoses.clear();
+        this->dataPtr->pendingLightPoses.clear();
       }
-
-      // When ready to use the direct API for updating scene poses from server,
-      // uncomment the following lines:
-      // // Execute callback to export Pose msg
-      // if (this->dataPtr->updateScenePoses)
-      // {
-      //   this->dataPtr->updateScenePoses(this->Name(), msg);
-      // }
+    }
+    else
+    {
+      this->dataPtr->pendingModelPoses.clear();
+      this->dataPtr->pendingLightPoses.clear();
     }
 
+    this->PublishPoseInterests();
+
     this->dataPtr->publishModelPoses.clear();
     this->dataPtr->publishLightPoses.clear();
   }
@@ -2840,8 +4401,55 @@ void World::PublishWorldStats()
         logStats);
   }
 
+  // The caches over their budget are trimmed a few times per second
+  common::MemoryTracker *tracker = common::MemoryTracker::Instance();
+  const auto now = std::chrono::steady_clock::now();
+  if (now - this->dataPtr->memoryEnforceTime > kMemoryEnforcePeriod)
+  {
+    tracker->Enforce();
+    this->dataPtr->memoryEnforceTime = now;
+  }
+
   if (this->dataPtr->statPub && this->dataPtr->statPub->HasConnections())
+  {
+    // The usage is only gathered for the messages that aren't throttled
+    if (this->dataPtr->statPub->ReadyToPublish())
+    {
+      for (auto const &usage : tracker->Usage())
+      {
+        msgs::WorldStatistics::Memory *memory =
+            this->dataPtr->worldStatsMsg.add_memory();
+        memory->set_subsystem(usage.first);
+        memory->set_bytes(usage.second);
+        const uint64_t budget = tracker->Budget(usage.first);
+        if (budget > 0)
+          memory->set_budget(budget);
+      }
+    }
+
+    // The percentiles are only read when someone listens
+    const common::LatencyHistogram &stepTimes = this->dataPtr->stepTimes;
+    if (stepTimes.Count() > 0)
+    {
+      auto &msg = this->dataPtr->worldStatsMsg;
+      msg.set_step_time_p50(stepTimes.Percentile(50) * 1e-9);
+      msg.set_step_time_p99(stepTimes.Percentile(99) * 1e-9);
+      msg.set_step_time_p999(stepTimes.Percentile(99.9) * 1e-9);
+      msg.set_step_time_max(stepTimes.Max() * 1e-9);
+      msg.set_overrun_steps(this->dataPtr->overrunSteps);
+    }
     this->dataPtr->statPub->Publish(this->dataPtr->worldStatsMsg);
+  }
+
+  // The transport counters are only gathered when someone listens
+  if (this->dataPtr->transportStatsPub &&
+      this->dataPtr->transportStatsPub->HasConnections() &&
+      this->dataPtr->transportStatsPub->ReadyToPublish())
+  {
+    msgs::TransportStats transportStats;
+    transport::TopicManager::Instance()->FillStatistics(transportStats);
+    this->dataPtr->transportStatsPub->Publish(transportStats);
+  }
   this->dataPtr->prevStatTime = common::Time::GetWallTime();
 }
 
@@ -2854,6 +4462,10 @@ bool World::IsLoaded() const
 //////////////////////////////////////////////////
 void World::PublishModelPose(physics::ModelPtr _model)
 {
+  // Sleeping models don't move.
+  if (_model->Sleeping())
+    return;
+
   std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
 
   // Only add if the model name is not in the list
@@ -2879,73 +4491,170 @@ void World::PublishLightPose(const physics::LightPtr _light)
 }
 
 //////////////////////////////////////////////////
-void World::LogWorker()
+void World::CaptureLogState()
 {
-  std::unique_lock<std::mutex> lock(this->dataPtr->logMutex);
-
   WorldPtr self = shared_from_this();
-  this->dataPtr->logPrevIteration = this->dataPtr->iterations;
-
-  GZ_ASSERT(self, "Self pointer to World is invalid");
 
-  // Init the prevUnfilteredState
-  this->dataPtr->prevUnfilteredState.Load(self);
-
-  while (!this->dataPtr->stop)
+  // Find out about insertions and deletions. These are rare, so the
+  // unfiltered world state is only loaded when models or lights have been
+  // inserted or removed.
+  uint64_t generation = this->dataPtr->entityGeneration;
+  if (generation != this->dataPtr->logEntityGeneration)
   {
-    // get unfiltered world state
     WorldState unfilteredState;
     {
       std::lock_guard<std::mutex> dLock(this->dataPtr->entityDeleteMutex);
       unfilteredState.Load(self);
     }
 
-    // compute world state diff and find out about insertions and deletions
-    std::vector<std::string> insertions;
-    std::vector<std::string> deletions;
-    bool insertDelete = false;
+    WorldState unfilteredDiffState = unfilteredState -
+        this->dataPtr->prevUnfilteredState;
+    if (!unfilteredDiffState.IsZero())
+    {
+      auto const &insertions = unfilteredDiffState.Insertions();
+      auto const &deletions = unfilteredDiffState.Deletions();
+      this->dataPtr->logPendingInsertions.insert(
+          this->dataPtr->logPendingInsertions.end(),
+          insertions.begin(), insertions.end());
+      this->dataPtr->logPendingDeletions.insert(
+          this->dataPtr->logPendingDeletions.end(),
+          deletions.begin(), deletions.end());
+    }
+
+    this->dataPtr->prevUnfilteredState = unfilteredState;
+    this->dataPtr->logEntityGeneration = generation;
+  }
+
+  bool insertDelete = !this->dataPtr->logPendingInsertions.empty() ||
+      !this->dataPtr->logPendingDeletions.empty();
+
+  // Throttle state capture based on log recording frequency.
+  auto simTime = this->SimTime();
+  if ((simTime - this->dataPtr->logLastStateTime <
+      util::LogRecord::Instance()->EffectivePeriod()) && !insertDelete)
+  {
+    return;
+  }
+
+  // Get a free state. Don't wait for the log worker, unless the log
+  // buffer blocks when full, drop the snapshot instead. Pending insertions
+  // and deletions are kept for the next one.
+  size_t index;
+  {
+    std::unique_lock<std::mutex> lock(this->dataPtr->logMutex);
+    util::LogRecord *recorder = util::LogRecord::Instance();
+    while (this->dataPtr->logFreeStates.empty() && !this->dataPtr->stop &&
+        recorder->Running() && recorder->BufferLimit() > 0 &&
+        recorder->BufferPolicy() == util::LogBufferPolicy::BLOCK)
+    {
+      this->dataPtr->logFreeCondition.wait_for(lock,
+          std::chrono::milliseconds(100));
+    }
 
+    if (this->dataPtr->logFreeStates.empty())
     {
-      WorldState unfilteredDiffState = unfilteredState -
-          this->dataPtr->prevUnfilteredState;
-      if (!unfilteredDiffState.IsZero())
+      if (this->dataPtr->logDroppedStates++ == 0)
       {
-        insertions = unfilteredDiffState.Insertions();
-        deletions = unfilteredDiffState.Deletions();
-        insertDelete = !insertions.empty() || !deletions.empty();
+        gzwarn << "Log worker thread can't keep up, dropping world states. "
+               << "See World::DroppedLogStates." << std::endl;
       }
+      return;
     }
-    this->dataPtr->prevUnfilteredState = unfilteredState;
+    index = this->dataPtr->logFreeStates.back();
+    this->dataPtr->logFreeStates.pop_back();
+  }
+
+  WorldState &state = this->dataPtr->logStatePool[index];
+  {
+    std::lock_guard<std::mutex> dLock(this->dataPtr->entityDeleteMutex);
+    state.LoadWithFilter(self, util::LogRecord::Instance()->Filter());
+  }
 
-    // Throttle state capture based on log recording frequency.
-    auto simTime = this->SimTime();
-    if ((simTime - this->dataPtr->logLastStateTime >=
-        util::LogRecord::Instance()->Period()) || insertDelete)
+  // A keyframe also holds the SDF of every model and light, so that
+  // playback doesn't need the insertions and deletions before it.
+  std::string &keyframe = this->dataPtr->logStateKeyframes[index];
+  keyframe.clear();
+  const double keyframePeriod = util::LogRecord::Instance()->KeyframePeriod();
+  if (keyframePeriod > 0 &&
+      (simTime - this->dataPtr->logLastKeyframeTime >= keyframePeriod ||
+       simTime < this->dataPtr->logLastKeyframeTime))
+  {
+    std::ostringstream stream;
     {
-      int currState = (this->dataPtr->stateToggle + 1) % 2;
+      std::lock_guard<std::mutex> dLock(this->dataPtr->entityDeleteMutex);
+      for (auto const &model : this->dataPtr->models)
+        stream << model->UnscaledSDF()->ToString("");
+      for (auto const &light : this->dataPtr->lights)
+        stream << light->GetSDF()->ToString("");
+    }
+    keyframe = stream.str();
+    this->dataPtr->logLastKeyframeTime = simTime;
+  }
+  state.SetInsertions(this->dataPtr->logPendingInsertions);
+  state.SetDeletions(this->dataPtr->logPendingDeletions);
+  this->dataPtr->logPendingInsertions.clear();
+  this->dataPtr->logPendingDeletions.clear();
+
+  this->dataPtr->logLastStateTime = simTime;
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->logMutex);
+    this->dataPtr->logReadyStates.push_back(index);
+  }
+  this->dataPtr->logCondition.notify_one();
+}
+
+//////////////////////////////////////////////////
+void World::LogWorker()
+{
+  std::unique_lock<std::mutex> lock(this->dataPtr->logMutex);
+
+  while (true)
+  {
+    // Wait until there is work to be done.
+    this->dataPtr->logCondition.wait(lock, [this]
+        {
+          return this->dataPtr->stop ||
+              !this->dataPtr->logReadyStates.empty();
+        });
+
+    while (!this->dataPtr->logReadyStates.empty())
+    {
+      size_t index = this->dataPtr->logReadyStates.front();
+      this->dataPtr->logReadyStates.pop_front();
+      lock.unlock();
+
+      const WorldState &state = this->dataPtr->logStatePool[index];
+      const std::string &keyframe = this->dataPtr->logStateKeyframes[index];
+      bool insertDelete = !state.Insertions().empty() ||
+          !state.Deletions().empty();
 
-      std::string filterStr = util::LogRecord::Instance()->Filter();
       // compute diff for filtered states
-      {
-        std::lock_guard<std::mutex> dLock(this->dataPtr->entityDeleteMutex);
-        this->dataPtr->prevStates[currState].LoadWithFilter(self, filterStr);
-      }
+      int currState = (this->dataPtr->stateToggle + 1) % 2;
+      this->dataPtr->prevStates[currState] = state;
       WorldState diffState = this->dataPtr->prevStates[currState] -
           this->dataPtr->prevStates[this->dataPtr->stateToggle];
-      this->dataPtr->logPrevIteration = this->dataPtr->iterations;
 
-      if (!diffState.IsZero() || insertDelete)
+      if (!diffState.IsZero() || insertDelete || !keyframe.empty())
       {
+        // A full log buffer holds back the state, and through the free
+        // states the simulation, if the buffer blocks
+        const common::Time wait(0, 100000000);
+        while (!this->dataPtr->stop &&
+            !util::LogRecord::Instance()->WaitForRoom(wait))
+        {
+        }
+
         this->dataPtr->stateToggle = currState;
         {
           // Store the entire current state (instead of the diffState). A slow
           // moving link may never be captured if only diff state is recorded.
           std::lock_guard<std::mutex> bLock(this->dataPtr->logBufferMutex);
 
-          this->dataPtr->prevStates[currState].SetInsertions(insertions);
-          this->dataPtr->prevStates[currState].SetDeletions(deletions);
           this->dataPtr->states[this->dataPtr->currentStateBuffer].push_back(
               this->dataPtr->prevStates[currState]);
+          this->dataPtr->keyframes[this->dataPtr->currentStateBuffer]
+              .push_back(keyframe);
 
           // Tell the logger to update, once the number of states exceeds 1000
           if (this->dataPtr->states[this->dataPtr->currentStateBuffer].size() >
@@ -2956,17 +4665,20 @@ void World::LogWorker()
         }
       }
 
-      this->dataPtr->logLastStateTime = simTime;
+      lock.lock();
+      this->dataPtr->logFreeStates.push_back(index);
+      this->dataPtr->logFreeCondition.notify_all();
     }
 
-    this->dataPtr->logContinueCondition.notify_all();
-
-    // Wait until there is work to be done.
-    this->dataPtr->logCondition.wait(lock);
+    if (this->dataPtr->stop)
+      break;
   }
+}
 
-  // Make sure nothing is blocked by this thread.
-  this->dataPtr->logContinueCondition.notify_all();
+//////////////////////////////////////////////////
+uint64_t World::DroppedLogStates() const
+{
+  return this->dataPtr->logDroppedStates;
 }
 
 /////////////////////////////////////////////////
@@ -2985,17 +4697,23 @@ void World::RemoveModel(const std::string &_name)
 
   // Remove all the dirty poses from the delete entity.
   {
-    for (auto entity = this->dataPtr->dirtyPoses.begin();
-             entity != this->dataPtr->dirtyPoses.end(); ++entity)
+    auto isRemoved = [&_name](const Entity *_entity)
     {
-      if ((*entity)->GetName() == _name ||
-         ((*entity)->GetParent() && (*entity)->GetParent()->GetName() == _name))
-      {
-        this->dataPtr->dirtyPoses.erase(entity++);
-      }
-      else
-        ++entity;
-    }
+      return _entity->GetName() == _name ||
+          (_entity->GetParent() && _entity->GetParent()->GetName() == _name);
+    };
+
+    auto &dirtyPoses = this->dataPtr->dirtyPoses;
+    size_t count = std::min(this->dataPtr->dirtyPoseCount.load(),
+        dirtyPoses.size());
+    auto end = std::remove_if(dirtyPoses.begin(), dirtyPoses.begin() + count,
+        isRemoved);
+    this->dataPtr->dirtyPoseCount = end - dirtyPoses.begin();
+
+    std::lock_guard<std::mutex> lock(this->dataPtr->dirtyPosesOverflowMutex);
+    auto &overflow = this->dataPtr->dirtyPosesOverflow;
+    overflow.erase(std::remove_if(overflow.begin(), overflow.end(),
+        isRemoved), overflow.end());
   }
 
   // Remove from SDF
@@ -3034,6 +4752,8 @@ void World::RemoveModel(const std::string &_name)
       {
         this->dataPtr->models.erase(model);
         this->dataPtr->rootElement->RemoveChild(_name);
+        this->dataPtr->modelUpdateGroupsDirty = true;
+        this->dataPtr->entityGeneration++;
         break;
       }
     }
@@ -3055,6 +4775,7 @@ void World::RemoveModel(const std::string &_name)
           (*light)->GetParent()->RemoveChild(*light);
         }
         this->dataPtr->lights.erase(light);
+        this->dataPtr->entityGeneration++;
         break;
       }
     }
@@ -3072,31 +4793,152 @@ void World::RemoveModel(const std::string &_name)
     }
   }
 
-  // Cleanup the publishModelPoses list.
+  // Cleanup the publishModelPoses and pendingModelPoses lists.
   {
     std::lock_guard<std::recursive_mutex> lock2(this->dataPtr->receiveMutex);
-    for (auto model = this->dataPtr->publishModelPoses.begin();
-             model != this->dataPtr->publishModelPoses.end(); ++model)
+    std::vector<std::set<ModelPtr> *> modelSets =
+        {&this->dataPtr->publishModelPoses,
+         &this->dataPtr->pendingModelPoses};
+    for (auto &interest : this->dataPtr->poseInterests)
+      modelSets.push_back(&interest.second.pendingModels);
+
+    for (auto *models : modelSets)
     {
-      if ((*model)->GetName() == _name || (*model)->GetScopedName() == _name)
+      for (auto model = models->begin(); model != models->end(); ++model)
       {
-        this->dataPtr->publishModelPoses.erase(model);
-        break;
+        if ((*model)->GetName() == _name || (*model)->GetScopedName() == _name)
+        {
+          models->erase(model);
+          break;
+        }
       }
     }
   }
 
-  // Cleanup the publishLightPoses list.
+  // Cleanup the publishLightPoses and pendingLightPoses lists.
   {
     std::lock_guard<std::recursive_mutex> lock2(this->dataPtr->receiveMutex);
-    for (auto light : this->dataPtr->publishLightPoses)
+    std::vector<std::set<LightPtr> *> lightSets =
+        {&this->dataPtr->publishLightPoses,
+         &this->dataPtr->pendingLightPoses};
+    for (auto &interest : this->dataPtr->poseInterests)
+      lightSets.push_back(&interest.second.pendingLights);
+
+    for (auto *lights : lightSets)
     {
-      if (light->GetName() == _name || light->GetScopedName() == _name)
+      for (auto light = lights->begin(); light != lights->end(); ++light)
       {
-        this->dataPtr->publishLightPoses.erase(light);
-        break;
+        if ((*light)->GetName() == _name || (*light)->GetScopedName() == _name)
+        {
+          lights->erase(light);
+          break;
+        }
+      }
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+void World::OnPoseInterestMsg(ConstPoseInterestPtr &_msg)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
+
+  if (!_msg->has_min() || !_msg->has_max())
+  {
+    this->dataPtr->poseInterests.erase(_msg->topic());
+    return;
+  }
+
+  PoseInterest &interest = this->dataPtr->poseInterests[_msg->topic()];
+  if (!interest.pub)
+  {
+    // Same rate cap as ~/pose/info
+    interest.pub = this->dataPtr->node->Advertise<msgs::PosesStamped>(
+        _msg->topic(), 10, 60);
+
+    // Start with every pose, so the client doesn't wait for things to move
+    interest.sendAll = true;
+  }
+  interest.box = ignition::math::AxisAlignedBox(
+      msgs::ConvertIgn(_msg->min()), msgs::ConvertIgn(_msg->max()));
+  interest.farPeriod = _msg->far_period();
+}
+
+//////////////////////////////////////////////////
+void World::PublishPoseInterests()
+{
+  for (auto &iter : this->dataPtr->poseInterests)
+  {
+    PoseInterest &interest = iter.second;
+    if (!interest.pub->HasConnections())
+    {
+      interest.pendingModels.clear();
+      interest.pendingLights.clear();
+      continue;
+    }
+
+    if (interest.sendAll)
+    {
+      interest.pendingModels.insert(this->dataPtr->models.begin(),
+          this->dataPtr->models.end());
+      interest.pendingLights.insert(this->dataPtr->lights.begin(),
+          this->dataPtr->lights.end());
+      interest.sendAll = false;
+    }
+
+    interest.pendingModels.insert(this->dataPtr->publishModelPoses.begin(),
+        this->dataPtr->publishModelPoses.end());
+    interest.pendingLights.insert(this->dataPtr->publishLightPoses.begin(),
+        this->dataPtr->publishLightPoses.end());
+
+    if ((interest.pendingModels.empty() && interest.pendingLights.empty()) ||
+        !interest.pub->ReadyToPublish())
+    {
+      continue;
+    }
+
+    ++interest.count;
+    const bool far = interest.farPeriod > 0 &&
+        interest.count % interest.farPeriod == 0;
+
+    // The poses outside the region stay pending until the next far message
+    std::set<ModelPtr> models;
+    std::set<LightPtr> lights;
+    if (far)
+    {
+      models.swap(interest.pendingModels);
+      lights.swap(interest.pendingLights);
+    }
+    else
+    {
+      for (auto const &model : this->ModelsInBox(interest.box))
+      {
+        auto it = interest.pendingModels.find(model);
+        if (it != interest.pendingModels.end())
+        {
+          models.insert(model);
+          interest.pendingModels.erase(it);
+        }
+      }
+
+      for (auto it = interest.pendingLights.begin();
+           it != interest.pendingLights.end();)
+      {
+        if (interest.box.Contains((*it)->WorldPose().Pos()))
+        {
+          lights.insert(*it);
+          it = interest.pendingLights.erase(it);
+        }
+        else
+          ++it;
       }
     }
+
+    if (models.empty() && lights.empty())
+      continue;
+
+    FillPosesMsg(this->SimTime(), models, lights, interest.msg);
+    interest.pub->Publish(interest.msg);
   }
 }
 
@@ -3179,7 +5021,81 @@ void World::SetAtmosphereEnabled(const bool _enable)
 void World::_AddDirty(Entity *_entity)
 {
   GZ_ASSERT(_entity != nullptr, "_entity is nullptr");
-  this->dataPtr->dirtyPoses.push_back(_entity);
+
+  // This may be called from several physics engine threads. Claim a slot
+  // without locking, and only lock if the buffer is full.
+  size_t index = this->dataPtr->dirtyPoseCount.fetch_add(1,
+      std::memory_order_relaxed);
+  if (index < this->dataPtr->dirtyPoses.size())
+  {
+    this->dataPtr->dirtyPoses[index] = _entity;
+  }
+  else
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->dirtyPosesOverflowMutex);
+    this->dataPtr->dirtyPosesOverflow.push_back(_entity);
+  }
+}
+
+/////////////////////////////////////////////////
+void World::_AddToNameIndex(const BasePtr &_base)
+{
+  GZ_ASSERT(_base != nullptr, "_base is nullptr");
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->nameIndexMutex);
+
+  auto &entry = this->dataPtr->nameIndexEntries[_base.get()];
+  if (!entry.base.expired())
+    return;
+
+  entry.name = _base->GetName();
+  entry.scopedName = _base->GetScopedName();
+  entry.base = _base;
+
+  this->dataPtr->nameIndex[entry.name].push_back(_base.get());
+  if (entry.scopedName != entry.name)
+    this->dataPtr->nameIndex[entry.scopedName].push_back(_base.get());
+}
+
+/////////////////////////////////////////////////
+void World::_UpdateNameIndex(const Base *_base)
+{
+  BasePtr base;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->nameIndexMutex);
+    auto iter = this->dataPtr->nameIndexEntries.find(_base);
+    if (iter == this->dataPtr->nameIndexEntries.end())
+      return;
+    base = iter->second.base.lock();
+  }
+
+  this->_RemoveFromNameIndex(_base);
+  if (base)
+    this->_AddToNameIndex(base);
+}
+
+/////////////////////////////////////////////////
+void World::_RemoveFromNameIndex(const Base *_base)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->nameIndexMutex);
+
+  auto iter = this->dataPtr->nameIndexEntries.find(_base);
+  if (iter == this->dataPtr->nameIndexEntries.end())
+    return;
+
+  for (auto const &name : {iter->second.name, iter->second.scopedName})
+  {
+    auto nameIter = this->dataPtr->nameIndex.find(name);
+    if (nameIter == this->dataPtr->nameIndex.end())
+      continue;
+
+    auto &bases = nameIter->second;
+    bases.erase(std::remove(bases.begin(), bases.end(), _base), bases.end());
+    if (bases.empty())
+      this->dataPtr->nameIndex.erase(nameIter);
+  }
+
+  this->dataPtr->nameIndexEntries.erase(iter);
 }
 
 /////////////////////////////////////////////////
@@ -3206,6 +5122,15 @@ void World::RegisterIntrospectionItems()
   // Add here all the items that might be introspected.
   gazebo::util::IntrospectionManager::Instance()->Register<common::Time>(
       timeURI.Str(), std::bind(&World::SimTime, this));
+
+  common::URI droppedLogStatesURI(uri);
+  droppedLogStatesURI.Query().Insert("p", "log/dropped_states");
+  this->dataPtr->introspectionItems.push_back(droppedLogStatesURI);
+  gazebo::util::IntrospectionManager::Instance()->Register<int>(
+      droppedLogStatesURI.Str(), [this]()
+      {
+        return static_cast<int>(this->DroppedLogStates());
+      });
 }
 
 /////////////////////////////////////////////////
@@ -21,11 +21,15 @@
 #include <list>
 #include <set>
 #include <deque>
+#include <functional>
 #include <string>
 #include <memory>
+#include <utility>
 
 #include <boost/enable_shared_from_this.hpp>
 
+#include <ignition/math/AxisAlignedBox.hh>
+
 #include <sdf/sdf.hh>
 
 #include "gazebo/transport/TransportTypes.hh"
@@ -39,6 +43,7 @@
 
 #include "gazebo/physics/Base.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/physics/WorldSnapshot.hh"
 #include "gazebo/physics/WorldState.hh"
 #include "gazebo/physics/Wind.hh"
 #include "gazebo/util/system.hh"
@@ -110,6 +115,13 @@ namespace gazebo
       /// \param[in] _func function to be called when Poses are available.
       public: void Init(UpdateScenePosesFunc _func);
 
+      /// \brief Initialize the world.
+      /// This is called after Load.
+      /// \param[in] _func function to be called when Poses are available.
+      /// \param[in] _hasScene function telling whether the scene of the
+      /// world exists. The poses are only prepared for _func while it does.
+      public: void Init(UpdateScenePosesFunc _func, HasSceneFunc _hasScene);
+
       /// \brief Run the world in a thread.
       /// Run the update loop.
       /// \param[in] _iterations Run for this many iterations, then stop.
@@ -155,6 +167,22 @@ namespace gazebo
       /// \return Reference to the wind.
       public: physics::Wind &Wind() const;
 
+      /// \brief Get a reference to the forces of the surrounding fluids,
+      /// to which the wind, buoyancy and lift drag plugins add terms.
+      /// \return Reference to the force field.
+      public: physics::ForceField &ForceField() const;
+
+      /// \brief Get the power system that updates the batteries of the
+      /// links. The <gz:battery_update_rate> element of the world, in Hz,
+      /// sets its rate; by default it updates at every step.
+      /// \return Reference to the power system.
+      public: common::PowerSystem &PowerSystem() const;
+
+      /// \brief Get the region simulated by this server, when the world
+      /// is distributed over several with a <gz:partition> element.
+      /// \return The region, or null if the world isn't distributed.
+      public: physics::Partition *Partition() const;
+
       /// \brief Return the spherical coordinates converter.
       /// \return Pointer to the spherical coordinates converter.
       public: common::SphericalCoordinatesPtr SphericalCoords() const;
@@ -239,6 +267,25 @@ namespace gazebo
       /// \return The real time.
       public: common::Time RealTime() const;
 
+      /// \brief Get the histogram of the wall time of the steps, which
+      /// covers the steps since the world started or was reset. Its
+      /// percentiles can be read from any thread.
+      /// \return The histogram, of update durations in nanoseconds.
+      public: const common::LatencyHistogram &StepTimes() const;
+
+      /// \brief Get the number of steps which took longer than the update
+      /// period of real_time_update_rate, since the world started or was
+      /// reset. Steps aren't counted when the update rate is unlimited.
+      /// \return The number of overrun steps.
+      public: uint64_t OverrunStepCount() const;
+
+      /// \brief Get the number of physics updates since the world was
+      /// loaded. It is incremented once the poses computed by a step have
+      /// been applied, and when the world is reset, so that values derived
+      /// from the state of the entities can be kept for the rest of a step.
+      /// \return The number of physics updates.
+      public: uint64_t PhysicsUpdateCount() const;
+
       /// \brief Returns the state of the simulation true if paused.
       /// \return True if paused.
       public: bool IsPaused() const;
@@ -285,6 +332,16 @@ namespace gazebo
       public: ModelPtr ModelBelowPoint(
                   const ignition::math::Vector3d &_pt) const;
 
+      /// \brief Get the models whose bounding box overlaps a box, nested
+      /// models included. A model's box is its bounding box grown to hold
+      /// its origin. The candidates come from a spatial index refreshed at
+      /// most once per iteration, so callers testing many regions per
+      /// update do not each walk every model.
+      /// \param[in] _box The box, in the world frame.
+      /// \return The models, ordered by id.
+      public: Model_V ModelsInBox(
+                  const ignition::math::AxisAlignedBox &_box) const;
+
       /// \brief Get the nearest entity below a point.
       /// Projects a Ray down (-Z axis) starting at the given point. The
       /// first entity hit by the Ray is returned.
@@ -312,6 +369,17 @@ namespace gazebo
       /// \param[in] _sdf A reference to an SDF object.
       public: void InsertModelSDF(const sdf::SDF &_sdf);
 
+      /// \brief Insert many copies of a model from an SDF string.
+      /// The SDF is parsed once, and the copies are loaded together in the
+      /// next world update.
+      /// \param[in] _sdfString A string containing valid SDF markup of a
+      /// model.
+      /// \param[in] _instances Name and pose of each copy. Copies with an
+      /// empty name get a unique name made from the name of the model.
+      public: void InsertModelsString(const std::string &_sdfString,
+                  const std::vector<std::pair<std::string,
+                  ignition::math::Pose3d>> &_instances);
+
       /// \brief Return a version of the name with "<world_name>::" removed
       /// \param[in] _name Usually the name of an entity.
       /// \return The stripped world name.
@@ -355,6 +423,172 @@ namespace gazebo
       /// \param[in] _enable True to enable the physics engine.
       public: void SetPhysicsEnabled(const bool _enable);
 
+      /// \brief Check if independent models are updated in parallel.
+      /// \return True if parallel model update is enabled.
+      public: bool ParallelModelUpdate() const;
+
+      /// \brief Enable/disable parallel model update during World::Update.
+      /// When enabled, models that are not connected through joints are
+      /// updated concurrently on a task pool. When disabled, all models are
+      /// updated sequentially in world order, which is the default.
+      /// \param[in] _enable True to enable parallel model update.
+      public: void SetParallelModelUpdate(const bool _enable);
+
+      /// \brief Get the maximum number of physics steps run back to back.
+      /// \return Step batch size, 1 when batching is disabled.
+      /// \sa SetStepBatchSize
+      public: unsigned int StepBatchSize() const;
+
+      /// \brief Set the maximum number of physics steps run back to back.
+      /// When the real time update rate is unlimited, the world runs up to
+      /// _size steps in a row without publishing statistics or processing
+      /// messages in between. World update events still fire at every
+      /// step with the correct sim time. A batch stops early when a step
+      /// barrier is reached, when the world is paused or stopped, and
+      /// after a reset.
+      /// \param[in] _size Step batch size, 1 disables batching.
+      /// \sa AddStepBarrier
+      public: void SetStepBatchSize(const unsigned int _size);
+
+      /// \brief Get the CPU the physics thread is pinned to in real time
+      /// mode.
+      /// \return Index of the CPU, or -1 when real time mode is disabled.
+      /// \sa SetRealTimeMode
+      public: int RealTimeCpu() const;
+
+      /// \brief Get the SCHED_FIFO priority of the physics thread in real
+      /// time mode.
+      /// \return The priority, 0 when the thread keeps its policy.
+      /// \sa SetRealTimeMode
+      public: int RealTimePriority() const;
+
+      /// \brief Enable or disable real time mode, for hardware in the loop
+      /// simulation. In real time mode, the physics thread is pinned to a
+      /// CPU and runs with the SCHED_FIFO policy, where allowed, and the
+      /// other threads of the process are moved off the CPU. Steps are
+      /// paced to the real time update rate with absolute deadlines, the
+      /// thread sleeping until shortly before each deadline and spinning
+      /// until it. Placement takes effect the next time the world runs,
+      /// and is only supported on Linux. It is also enabled by the
+      /// <gz:real_time_cpu> and <gz:real_time_priority> physics elements.
+      /// \param[in] _cpu Index of the CPU, or -1 to disable real time
+      /// mode.
+      /// \param[in] _priority SCHED_FIFO priority, or 0 to keep the
+      /// scheduling policy.
+      /// \sa common::RealTime
+      public: void SetRealTimeMode(const int _cpu,
+                  const int _priority = 80);
+
+      /// \brief Get the time a model must be idle before it is put to
+      /// sleep.
+      /// \return Sleep time in seconds, zero when sleeping is disabled.
+      /// \sa SetSleepTime
+      public: double SleepTime() const;
+
+      /// \brief Set the time a model must be idle before it is put to
+      /// sleep. A model is idle while the linear and angular velocities of
+      /// all its links are below the sleep thresholds. Sleeping models are
+      /// disabled in the physics engine, skipped by Model::Update and don't
+      /// publish poses. They are woken on command or when the physics
+      /// engine wakes one of their links, e.g. on contact. Models with
+      /// <allow_auto_disable> set to false never sleep. Sleeping is
+      /// disabled by default.
+      /// \param[in] _time Sleep time in seconds, zero disables sleeping
+      /// and wakes all models.
+      /// \sa Model::Sleep, Model::Wake
+      public: void SetSleepTime(const double _time);
+
+      /// \brief Set the velocities below which a model is idle.
+      /// \param[in] _linear Linear velocity threshold in m/s.
+      /// \param[in] _angular Angular velocity threshold in rad/s.
+      /// \sa SetSleepTime
+      public: void SetSleepThresholds(const double _linear,
+                  const double _angular);
+
+      /// \brief Get the linear velocity below which a model is idle.
+      /// \return Linear velocity threshold in m/s.
+      public: double SleepLinearThreshold() const;
+
+      /// \brief Get the angular velocity below which a model is idle.
+      /// \return Angular velocity threshold in rad/s.
+      public: double SleepAngularThreshold() const;
+
+      /// \brief Make the current batch of steps stop at the step that
+      /// reaches the given sim time, so that message processing happens
+      /// at that time. Used by the SensorManager for sensor updates, and
+      /// by plugins that need to react at a specific time.
+      /// \param[in] _simTime Sim time of the barrier.
+      /// \param[in] _callback Function called by the world thread when the
+      /// batch stops at the barrier, before messages are processed.
+      public: void AddStepBarrier(const common::Time &_simTime,
+                  const std::function<void()> &_callback = nullptr);
+
+      /// \brief Save the complete dynamic state of the world to memory.
+      /// Unlike WorldState, a snapshot includes the internal state of the
+      /// physics engine and the data of registered plugins, so that
+      /// RestoreSnapshot continues the simulation exactly as it would have
+      /// continued from this point. Snapshots are meant to be restored
+      /// many times, e.g. to reset episodes without reloading the world.
+      /// \param[out] _snapshot Snapshot to fill. Its buffers are reused.
+      /// \sa AddSnapshotCallbacks
+      public: void SaveSnapshot(WorldSnapshot &_snapshot);
+
+      /// \brief Restore a snapshot saved by SaveSnapshot. Fails if models
+      /// were inserted or removed since the snapshot was saved.
+      /// \param[in] _snapshot Snapshot to restore.
+      /// \return True if the snapshot was restored.
+      public: bool RestoreSnapshot(const WorldSnapshot &_snapshot);
+
+      /// \brief Register functions that save and restore the state of a
+      /// plugin in world snapshots.
+      /// \param[in] _name Unique name of the data, usually the plugin name.
+      /// Registering the same name again replaces the callbacks.
+      /// \param[in] _save Function that returns the state of the plugin.
+      /// \param[in] _restore Function that restores the state returned by
+      /// _save.
+      public: void AddSnapshotCallbacks(const std::string &_name,
+                  std::function<std::string()> _save,
+                  std::function<void(const std::string &)> _restore);
+
+      /// \brief Unregister snapshot callbacks added with
+      /// AddSnapshotCallbacks.
+      /// \param[in] _name Name given to AddSnapshotCallbacks.
+      public: void RemoveSnapshotCallbacks(const std::string &_name);
+
+      /// \brief Write a checkpoint of the world to disk, from which a new
+      /// server resumes the simulation with `gzserver --resume`. The state
+      /// is captured right away, and written by a thread of its own. The
+      /// checkpoint is skipped if the previous one is still being written.
+      /// \param[in] _filename Path of the file.
+      /// \return False if the previous checkpoint is still being written.
+      /// \sa WaitForCheckpoint
+      public: bool SaveCheckpoint(const std::string &_filename);
+
+      /// \brief Wait until the last checkpoint is written.
+      /// \return False if it couldn't be written.
+      public: bool WaitForCheckpoint();
+
+      /// \brief Write checkpoints periodically, as the <gz:checkpoint>
+      /// element of the world does.
+      /// \param[in] _period Sim time between two checkpoints, 0 to
+      /// disable them.
+      /// \param[in] _filename Path of the file, overwritten by each
+      /// checkpoint.
+      public: void SetCheckpointPeriod(const double _period,
+                  const std::string &_filename);
+
+      /// \brief Get the sim time between two periodic checkpoints.
+      /// \return The period, 0 if disabled.
+      public: double CheckpointPeriod() const;
+
+      /// \brief Continue the simulation from a checkpoint of a world
+      /// loaded from the SDF of the checkpoint. The snapshot is restored
+      /// once the world plugins are loaded, so that their data is restored
+      /// too.
+      /// \param[in] _checkpoint The checkpoint.
+      /// \return False if the checkpoint is of another world.
+      public: bool ResumeCheckpoint(const WorldCheckpoint &_checkpoint);
+
       /// \brief check if wind is enabled/disabled.
       /// \param True if the wind is enabled.
       public: bool WindEnabled() const;
@@ -404,6 +638,12 @@ namespace gazebo
       /// \return Number of iterations that simulation has taken.
       public: uint32_t Iterations() const;
 
+      /// \brief Get the number of world states that were not logged
+      /// because the log worker thread could not keep up with the
+      /// simulation. World::Update never waits for the log worker.
+      /// \return Number of dropped log states.
+      public: uint64_t DroppedLogStates() const;
+
       /// \brief Get the current scene in message form.
       /// \return The scene state as a protobuf message.
       public: msgs::Scene SceneMsg() const;
@@ -438,6 +678,25 @@ namespace gazebo
       /// \param[in] _entity Entity that has moved.
       public: void _AddDirty(Entity *_entity);
 
+      /// \internal
+      /// \brief Add an entity to the index used by the name lookups, such
+      /// as BaseByName. This is called by Base::Load.
+      /// \param[in] _base Entity to add.
+      public: void _AddToNameIndex(const BasePtr &_base);
+
+      /// \internal
+      /// \brief Update the name index after an entity has been renamed.
+      /// Entities that are not in the index are ignored. This is called by
+      /// Base::SetName.
+      /// \param[in] _base Entity that has been renamed.
+      public: void _UpdateNameIndex(const Base *_base);
+
+      /// \internal
+      /// \brief Remove an entity from the name index. This is called by
+      /// Base::Fini.
+      /// \param[in] _base Entity to remove.
+      public: void _RemoveFromNameIndex(const Base *_base);
+
       /// \brief Get whether sensors have been initialized.
       /// \return True if sensors have been initialized.
       public: bool SensorsInitialized() const;
@@ -448,6 +707,12 @@ namespace gazebo
       /// \param[in] _init True if sensors have been initialized.
       public: void _SetSensorsInitialized(const bool _init);
 
+      /// \brief Get the wall clock duration of each startup phase that has
+      /// completed so far: "load", "init", "sensors" and "plugins".
+      /// \return Phase names paired with their duration in seconds, in the
+      /// order the phases completed.
+      public: std::vector<std::pair<std::string, double>> StartupTimes() const;
+
       /// \brief Return the URI of the world.
       /// \return URI of this world.
       public: common::URI URI() const;
@@ -513,6 +778,16 @@ namespace gazebo
       /// \brief Step the world once by reading from a log file.
       private: void LogStep();
 
+      /// \brief Insert the models and lights, and remove the ones that
+      /// shouldn't be there, to match the world of the log file just before
+      /// a time. Uses the closest keyframe and the log states after it.
+      /// \param[in] _time Simulation time.
+      private: void RebuildFromKeyframe(const common::Time &_time);
+
+      /// \brief Insert a model or light from its SDF.
+      /// \param[in] _insertion The SDF of the model or light.
+      private: void InsertEntity(const std::string &_insertion);
+
       /// \brief Update the world.
       private: void Update();
 
@@ -556,6 +831,24 @@ namespace gazebo
       /// \brief TBB version of model updating.
       private: void ModelUpdateTBB();
 
+      /// \brief Rebuild the groups of models used by ModelUpdateTBB.
+      private: void UpdateModelUpdateGroups();
+
+      /// \brief Update the sleep state of all models.
+      /// \sa SetSleepTime
+      private: void UpdateSleep();
+
+      /// \brief Wait for the deadline of the next step in real time mode.
+      /// \param[in] _updatePeriod Update period in seconds, 0 when the
+      /// rate is unlimited.
+      /// \sa SetRealTimeMode
+      private: void WaitForStepDeadline(const double _updatePeriod);
+
+      /// \brief Propagate the poses set by the physics engine, see
+      /// _AddDirty, to the entities. Large batches are split by model and
+      /// updated in parallel.
+      private: void FlushDirtyPoses();
+
       /// \brief Single loop version of model updating.
       private: void ModelUpdateSingleLoop();
 
@@ -609,6 +902,16 @@ namespace gazebo
       /// \brief Publish the world stats message.
       private: void PublishWorldStats();
 
+      /// \brief Snapshot the world state and hand it to the log worker
+      /// thread. Called from Update while logging, never blocks on the
+      /// log worker.
+      private: void CaptureLogState();
+
+      /// \brief Check whether the current sim time has reached a step
+      /// barrier, and remove the barriers that were reached.
+      /// \return True if a barrier was reached.
+      private: bool StepBarrierReached();
+
       /// \brief Thread function for logging state data.
       private: void LogWorker();
 
@@ -628,6 +931,16 @@ namespace gazebo
       /// \param[in] _msg Pointer to the light message.
       private: void OnLightModifyMsg(ConstLightPtr &_msg);
 
+      /// \brief Publish the poses that changed in each region registered on
+      /// ~/pose/interest. Called by ProcessMessages with receiveMutex
+      /// locked.
+      private: void PublishPoseInterests();
+
+      /// \brief Callback when a message is received in the ~/pose/interest
+      /// topic.
+      /// \param[in] _msg Pointer to the pose interest message.
+      private: void OnPoseInterestMsg(ConstPoseInterestPtr &_msg);
+
       /// \brief Callback for "<this_name>/physics/info/plugin" service.
       /// Get information about plugins in this world or one of its
       /// children, according to the given _pluginUri. Some _pluginUri examples:
@@ -650,12 +963,6 @@ namespace gazebo
       /// \internal
       /// \brief Private data pointer.
       private: std::unique_ptr<WorldPrivate> dataPtr;
-
-      /// Friend DARTLink so that it has access to dataPtr->dirtyPoses
-      private: friend class DARTLink;
-
-      /// Friend SimbodyPhysics so that it has access to dataPtr->dirtyPoses
-      private: friend class SimbodyPhysics;
     };
     /// \}
   }
@@ -18,20 +18,30 @@
 #define GAZEBO_PHYSICS_WORLDPRIVATE_HH_
 
 #include <atomic>
+#include <chrono>
 #include <deque>
+#include <functional>
+#include <map>
 #include <vector>
 #include <list>
 #include <memory>
 #include <set>
 #include <sdf/sdf.hh>
 #include <string>
+#include <unordered_map>
 #include <mutex>
 #include <thread>
+#include <utility>
 #include <condition_variable>
 
+#include <boost/weak_ptr.hpp>
+#include <ignition/math/AxisAlignedBox.hh>
 #include <ignition/transport.hh>
 
 #include "gazebo/common/Event.hh"
+#include "gazebo/common/LatencyHistogram.hh"
+#include "gazebo/common/NanoTime.hh"
+#include "gazebo/common/PowerSystem.hh"
 #include "gazebo/common/Time.hh"
 #include "gazebo/common/URI.hh"
 
@@ -40,17 +50,81 @@
 #include "gazebo/transport/TransportTypes.hh"
 
 #include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/physics/SpatialIndex.hh"
 #include "gazebo/physics/WorldState.hh"
 
 namespace gazebo
 {
   namespace physics
   {
+    /// \internal
+    /// \brief Region of interest registered on ~/pose/interest, and the
+    /// state of the poses published for it.
+    class PoseInterest
+    {
+      /// \brief Publisher of the poses in the region.
+      public: transport::PublisherPtr pub;
+
+      /// \brief The region, in the world frame.
+      public: ignition::math::AxisAlignedBox box;
+
+      /// \brief Poses outside the region are sent every farPeriod messages,
+      /// never if 0.
+      public: unsigned int farPeriod = 0;
+
+      /// \brief Number of messages published.
+      public: uint64_t count = 0;
+
+      /// \brief True to send the poses of all the models and lights, once
+      /// the next message can go out.
+      public: bool sendAll = false;
+
+      /// \brief Models that moved since their pose was last sent.
+      public: std::set<ModelPtr> pendingModels;
+
+      /// \brief Lights that moved since their pose was last sent.
+      public: std::set<LightPtr> pendingLights;
+
+      /// \brief Message reused for pub.
+      public: msgs::PosesStamped msg;
+    };
+
+    /// \brief An entity stored in the World name index.
+    class NameIndexEntry
+    {
+      /// \brief Leaf name of the entity when it was indexed.
+      public: std::string name;
+
+      /// \brief Scoped name of the entity when it was indexed.
+      public: std::string scopedName;
+
+      /// \brief Weak pointer to the entity.
+      public: boost::weak_ptr<Base> base;
+    };
+
+    /// \brief Entities resolved for a model state by World::SetState, so
+    /// that the names in the states are only looked up once. The entities
+    /// aren't kept alive, an expired pointer is resolved again.
+    class StateTarget
+    {
+      /// \brief The model, expired if there's none with the name of the
+      /// state.
+      public: boost::weak_ptr<Model> model;
+
+      /// \brief Links of the model by name of their state, expired if the
+      /// model has no such link.
+      public: std::unordered_map<std::string, boost::weak_ptr<Link>> links;
+
+      /// \brief Nested models by name of their state.
+      public: std::unordered_map<std::string, std::unique_ptr<StateTarget>>
+              nested;
+    };
+
     /// \brief Private data class for World.
     class WorldPrivate
     {
       /// \brief For keeping track of time step throttling.
-      public: common::Time prevStepWallTime;
+      public: common::NanoTime prevStepWallTime;
 
       /// \brief Pointer the physics engine.
       public: PhysicsEnginePtr physicsEngine;
@@ -58,6 +132,19 @@ namespace gazebo
       /// \brief Unique pointer the wind. The world owns this pointer.
       public: std::unique_ptr<Wind> wind;
 
+      /// \brief Forces of the surrounding fluids. Unlike the wind, it is
+      /// kept until the world is destroyed, since plugins remove their
+      /// terms when they are destroyed.
+      public: std::unique_ptr<ForceField> forceField;
+
+      /// \brief Batteries of the links, updated in one pass. Kept until
+      /// the world is destroyed, like the force field.
+      public: std::unique_ptr<common::PowerSystem> powerSystem;
+
+      /// \brief Region simulated by this server, when the world is
+      /// distributed over several. Null otherwise.
+      public: std::unique_ptr<Partition> partition;
+
       /// \brief Unique pointer the atmosphere model.
       /// The world owns this pointer.
       public: std::unique_ptr<Atmosphere> atmosphere;
@@ -101,6 +188,10 @@ namespace gazebo
       /// \brief Publisher for world statistics messages.
       public: transport::PublisherPtr statPub;
 
+      /// \brief Publisher of the transport counters of the process, once
+      /// per second while someone listens.
+      public: transport::PublisherPtr transportStatsPub;
+
       /// \brief Publisher for request response messages.
       public: transport::PublisherPtr responsePub;
 
@@ -122,6 +213,12 @@ namespace gazebo
       /// \brief Publisher for local pose messages.
       public: transport::PublisherPtr poseLocalPub;
 
+      /// \brief Regions of interest by topic. Protected by receiveMutex.
+      public: std::map<std::string, PoseInterest> poseInterests;
+
+      /// \brief Subscriber to pose interest messages.
+      public: transport::SubscriberPtr poseInterestSub;
+
       /// \brief Subscriber to world control messages.
       public: transport::SubscriberPtr controlSub;
 
@@ -158,9 +255,76 @@ namespace gazebo
       /// \brief Function pointer to the model update function.
       public: void (World::*modelUpdateFunc)();
 
+      /// \brief True if independent models are updated in parallel.
+      public: bool parallelModelUpdate;
+
+      /// \brief Maximum number of steps World::Step runs back to back,
+      /// without processing messages, when the update rate is unlimited.
+      public: unsigned int stepBatchSize;
+
+      /// \brief Time a model must be idle before it is put to sleep,
+      /// zero when sleeping is disabled.
+      public: double sleepTime;
+
+      /// \brief Linear velocity below which a model is idle.
+      public: double sleepLinearThreshold;
+
+      /// \brief Angular velocity below which a model is idle.
+      public: double sleepAngularThreshold;
+
+      /// \brief Sim times at which a batch of steps must stop, with the
+      /// functions to call when it does.
+      public: std::multimap<common::Time, std::function<void()>>
+              stepBarriers;
+
+      /// \brief Mutex to protect stepBarriers.
+      public: std::mutex stepBarriersMutex;
+
+      /// \brief Save and restore functions of plugin data in snapshots,
+      /// indexed by name.
+      public: std::map<std::string, std::pair<std::function<std::string()>,
+              std::function<void(const std::string &)>>> snapshotCallbacks;
+
+      /// \brief Mutex to protect snapshotCallbacks.
+      public: std::mutex snapshotCallbacksMutex;
+
+      /// \brief Thread writing the last checkpoint to disk.
+      public: std::thread checkpointThread;
+
+      /// \brief True while checkpointThread writes.
+      public: std::atomic<bool> checkpointWriting{false};
+
+      /// \brief False if the last checkpoint couldn't be written.
+      public: std::atomic<bool> checkpointWritten{true};
+
+      /// \brief Sim time between two periodic checkpoints, 0 if disabled.
+      public: double checkpointPeriod = 0;
+
+      /// \brief Path of the periodic checkpoints.
+      public: std::string checkpointPath;
+
+      /// \brief Sim time of the next periodic checkpoint.
+      public: common::Time nextCheckpointTime;
+
+      /// \brief Checkpoint restored once the world plugins are loaded.
+      public: std::unique_ptr<WorldCheckpoint> resumeCheckpoint;
+
+      /// \brief Groups of models used by the parallel model update. Models
+      /// connected through joints share a group and are updated
+      /// sequentially, while separate groups are updated concurrently.
+      public: std::vector<Model_V> modelUpdateGroups;
+
+      /// \brief True if modelUpdateGroups must be rebuilt before the next
+      /// parallel model update.
+      public: bool modelUpdateGroupsDirty;
+
       /// \brief Last time a world statistics message was sent.
       public: common::Time prevStatTime;
 
+      /// \brief Last time the caches over their memory budget were
+      /// trimmed.
+      public: std::chrono::steady_clock::time_point memoryEnforceTime;
+
       /// \brief Time at which pause started.
       public: common::Time pauseStartTime;
 
@@ -208,6 +372,14 @@ namespace gazebo
       /// \brief Model message buffer.
       public: std::list<msgs::Model> modelMsgs;
 
+      /// \brief True while loading the models of factory messages, which
+      /// defers their model messages to deferredModelMsgs.
+      public: bool deferModelMsgs = false;
+
+      /// \brief Messages of the models loaded from factory messages, sent
+      /// once all of them are loaded.
+      public: std::vector<msgs::Model> deferredModelMsgs;
+
       /// \brief Light factory message buffer.
       public: std::list<msgs::Light> lightFactoryMsgs;
 
@@ -250,8 +422,40 @@ namespace gazebo
       /// \brief True if the plugins have been loaded.
       public: bool pluginsLoaded;
 
+      /// \brief Wall clock duration in seconds of each startup phase, in
+      /// the order the phases completed.
+      public: std::vector<std::pair<std::string, double>> startupTimes;
+
+      /// \brief Protects startupTimes, which is read from other threads.
+      public: mutable std::mutex startupMutex;
+
+      /// \brief Wall clock time at which the current startup phase began.
+      public: std::chrono::steady_clock::time_point startupMark;
+
       /// \brief sleep timing error offset due to clock wake up latency
-      public: common::Time sleepOffset;
+      public: common::NanoTime sleepOffset;
+
+      /// \brief Wall time of the updates of the steps.
+      public: common::LatencyHistogram stepTimes;
+
+      /// \brief Number of steps longer than the update period.
+      public: std::atomic<uint64_t> overrunSteps{0};
+
+      /// \brief Number of physics updates, see World::PhysicsUpdateCount.
+      public: std::atomic<uint64_t> physicsUpdates{0};
+
+      /// \brief CPU the physics thread is pinned to in real time mode, or
+      /// -1 when real time mode is disabled.
+      public: int realTimeCpu;
+
+      /// \brief SCHED_FIFO priority of the physics thread in real time
+      /// mode, 0 to keep its policy.
+      public: int realTimePriority;
+
+      /// \brief Deadline of the next step in real time mode, in
+      /// nanoseconds of common::RealTime::Now(), or 0 to start a new
+      /// schedule.
+      public: int64_t realTimeDeadline;
 
       /// \brief Last time incoming messages were processed.
       public: common::Time prevProcessMsgsTime;
@@ -262,6 +466,10 @@ namespace gazebo
       /// \brief Alternating buffer of states.
       public: std::deque<WorldState> states[2];
 
+      /// \brief Keyframe of each state in states, empty if the state isn't
+      /// a keyframe.
+      public: std::deque<std::string> keyframes[2];
+
       /// \brief Keep track of current state buffer being updated
       public: int currentStateBuffer;
 
@@ -294,6 +502,23 @@ namespace gazebo
       /// \brief The list of lights that need to publish their pose.
       public: std::set<LightPtr> publishLightPoses;
 
+      /// \brief Models that moved since the last message that went out on
+      /// the rate limited posePub. Accumulated from publishModelPoses
+      /// while posePub is throttled, so that no pose change is lost.
+      public: std::set<ModelPtr> pendingModelPoses;
+
+      /// \brief Lights that moved since the last message that went out on
+      /// posePub.
+      public: std::set<LightPtr> pendingLightPoses;
+
+      /// \brief Message reused for poseLocalPub. Clearing a message keeps
+      /// its pose entries allocated, so filling it again every step
+      /// doesn't allocate.
+      public: msgs::PosesStamped localPosesMsg;
+
+      /// \brief Message reused for posePub.
+      public: msgs::PosesStamped posesMsg;
+
       /// \brief Info passed through the WorldUpdateBegin event.
       public: common::UpdateInfo updateInfo;
 
@@ -306,17 +531,89 @@ namespace gazebo
       /// \brief Condition used for log worker.
       public: std::condition_variable logCondition;
 
-      /// \brief Condition used to guarantee the log worker thread doesn't
-      /// skip an interation.
-      public: std::condition_variable logContinueCondition;
+      /// \brief Notified when the log worker frees a state of
+      /// logStatePool.
+      public: std::condition_variable logFreeCondition;
+
+      /// \brief Preallocated world states used to hand log snapshots from
+      /// the update thread to the log worker thread.
+      public: std::vector<WorldState> logStatePool;
+
+      /// \brief SDF of the models and lights of each logStatePool state
+      /// that is a keyframe, empty otherwise.
+      public: std::vector<std::string> logStateKeyframes;
+
+      /// \brief Indices of the logStatePool states that are free. Protected
+      /// by logMutex.
+      public: std::vector<size_t> logFreeStates;
+
+      /// \brief Indices of the logStatePool states waiting for the log
+      /// worker thread, in capture order. Protected by logMutex.
+      public: std::deque<size_t> logReadyStates;
+
+      /// \brief Number of log snapshots dropped because the log worker
+      /// thread fell behind.
+      public: std::atomic<uint64_t> logDroppedStates;
+
+      /// \brief Incremented every time a model or light is inserted or
+      /// removed.
+      public: std::atomic<uint64_t> entityGeneration;
+
+      /// \brief Boxes of the models, nested ones included, by model id.
+      /// Used by World::ModelsInBox. Protected by modelIndexMutex.
+      public: SpatialIndex modelIndex;
 
-      /// \brief Last iteration recorded by the log worker thread.
-      public: uint64_t logPrevIteration;
+      /// \brief Models in modelIndex by id, with the pose their box was
+      /// computed at. Protected by modelIndexMutex.
+      public: std::unordered_map<unsigned int,
+              std::pair<boost::weak_ptr<Model>, ignition::math::Pose3d>>
+              modelIndexEntries;
+
+      /// \brief Iteration modelIndex was last refreshed at.
+      public: uint64_t modelIndexIterations = 0;
+
+      /// \brief Value of entityGeneration when modelIndex was last
+      /// refreshed.
+      public: uint64_t modelIndexGeneration = 0;
+
+      /// \brief True once modelIndex has been filled.
+      public: bool modelIndexValid = false;
+
+      /// \brief Mutex to protect modelIndex and modelIndexEntries.
+      public: std::mutex modelIndexMutex;
+
+      /// \brief Entities of the model states given to SetState, by name of
+      /// the state. Protected by stateTargetsMutex.
+      public: std::unordered_map<std::string, StateTarget> stateTargets;
+
+      /// \brief Lights of the light states given to SetState, by name of
+      /// the state, expired when unresolved. Protected by
+      /// stateTargetsMutex.
+      public: std::unordered_map<std::string, boost::weak_ptr<Light>>
+              stateLights;
+
+      /// \brief Value of entityGeneration when stateTargets and stateLights
+      /// were last cleared.
+      public: uint64_t stateTargetsGeneration = 0;
+
+      /// \brief Mutex to protect stateTargets and stateLights.
+      public: std::mutex stateTargetsMutex;
+
+      /// \brief Value of entityGeneration when the insertions and deletions
+      /// were last computed for logging.
+      public: uint64_t logEntityGeneration;
+
+      /// \brief Insertions not yet handed to the log worker thread.
+      public: std::vector<std::string> logPendingInsertions;
+
+      /// \brief Deletions not yet handed to the log worker thread.
+      public: std::vector<std::string> logPendingDeletions;
 
       /// \brief Real time value set from a log file.
       public: common::Time logRealTime;
 
-      /// \brief Mutex to protect the log worker thread.
+      /// \brief Mutex to protect the log worker thread and the log state
+      /// queues.
       public: std::mutex logMutex;
 
       /// \brief Mutex to protect the log state buffers
@@ -334,14 +631,51 @@ namespace gazebo
       /// \brief A cached list of lights.
       public: Light_V lights;
 
+      /// \brief Entities indexed by both their scoped and leaf names. The
+      /// entities sharing a name are kept in insertion order.
+      public: std::unordered_map<std::string, std::vector<const Base *>>
+              nameIndex;
+
+      /// \brief The names each indexed entity is stored under.
+      public: std::unordered_map<const Base *, NameIndexEntry>
+              nameIndexEntries;
+
+      /// \brief Mutex to protect nameIndex and nameIndexEntries.
+      public: std::mutex nameIndexMutex;
+
       /// \brief This mutex is used to by the ::RemoveModel and
       /// ::ProcessFactoryMsgs functions.
       public: std::mutex factoryDeleteMutex;
 
       /// \brief when physics engine makes an update and changes a link pose,
-      /// this flag is set to trigger Entity::SetWorldPose on the
-      /// physics::Link in World::Update.
-      public: std::list<Entity*> dirtyPoses;
+      /// the link is added to this buffer to trigger Entity::SetWorldPose on
+      /// the physics::Link in World::Update. Only the first dirtyPoseCount
+      /// slots are valid. The buffer is preallocated so that physics engine
+      /// threads can add entities without locking.
+      public: std::vector<Entity *> dirtyPoses;
+
+      /// \brief Number of slots of dirtyPoses claimed since the last flush.
+      /// This may be larger than the size of dirtyPoses, in which case the
+      /// remaining entities are in dirtyPosesOverflow.
+      public: std::atomic<size_t> dirtyPoseCount;
+
+      /// \brief Dirty entities that did not fit in dirtyPoses. The
+      /// dirtyPoses buffer grows to fit them during the next flush.
+      public: std::vector<Entity *> dirtyPosesOverflow;
+
+      /// \brief Mutex to protect dirtyPosesOverflow.
+      public: std::mutex dirtyPosesOverflowMutex;
+
+      /// \brief Contiguous copy of the poses of the dirty entities, filled
+      /// when the dirty poses are flushed.
+      public: std::vector<ignition::math::Pose3d> dirtyPoseBuffer;
+
+      /// \brief Indices into dirtyPoses sorted by top level model, used to
+      /// update the dirty poses of different models in parallel.
+      public: std::vector<std::pair<const Model *, size_t>> dirtyPoseOrder;
+
+      /// \brief Start of each model's range in dirtyPoseOrder.
+      public: std::vector<size_t> dirtyPoseGroups;
 
       /// \brief Class to manage preset simulation parameter profiles.
       public: PresetManagerPtr presetManager;
@@ -356,6 +690,13 @@ namespace gazebo
       /// \brief Simulation time of the last log state captured.
       public: gazebo::common::Time logLastStateTime;
 
+      /// \brief Simulation time of the last log keyframe captured.
+      public: gazebo::common::Time logLastKeyframeTime;
+
+      /// \brief True to rebuild the models and lights from a keyframe
+      /// before playing the next log state, after a seek.
+      public: bool logPlayRebuild = false;
+
       /// \brief Simulation time of the last log state played.
       public: gazebo::common::Time logLastStatePlayedSimTime;
 
@@ -380,6 +721,10 @@ namespace gazebo
       /// \brief Callback function intended to call the scene with updated Poses
       public: UpdateScenePosesFunc updateScenePoses;
 
+      /// \brief Tells whether the scene updated by updateScenePoses exists,
+      /// always true when null.
+      public: HasSceneFunc hasScene;
+
       /// \brief SDF World DOM object
       public: std::unique_ptr<sdf::World> worldSDFDom;
     };
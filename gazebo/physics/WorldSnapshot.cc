@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <utility>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/physics/WorldSnapshot.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+namespace
+{
+  /// \brief First bytes of a checkpoint file.
+  const char kCheckpointMagic[8] = {'G', 'Z', 'C', 'K', 'P', 'T', '0', '1'};
+
+  /// \brief Write an integer in native byte order.
+  /// \param[in] _out Stream.
+  /// \param[in] _value Integer.
+  template<typename T>
+  void WriteValue(std::ostream &_out, const T _value)
+  {
+    _out.write(reinterpret_cast<const char *>(&_value), sizeof(_value));
+  }
+
+  /// \brief Write a string preceded by its size.
+  /// \param[in] _out Stream.
+  /// \param[in] _value String.
+  void WriteString(std::ostream &_out, const std::string &_value)
+  {
+    WriteValue<uint64_t>(_out, _value.size());
+    _out.write(_value.data(), _value.size());
+  }
+
+  /// \brief Read an integer written by WriteValue.
+  /// \param[in] _in Stream.
+  /// \param[out] _value Integer.
+  /// \return False at the end of the stream.
+  template<typename T>
+  bool ReadValue(std::istream &_in, T &_value)
+  {
+    return static_cast<bool>(
+        _in.read(reinterpret_cast<char *>(&_value), sizeof(_value)));
+  }
+
+  /// \brief Read a string written by WriteString.
+  /// \param[in] _in Stream.
+  /// \param[in] _remaining Bytes left in the stream, which bound the size.
+  /// \param[out] _value String.
+  /// \return False at the end of the stream or for an invalid size.
+  bool ReadString(std::istream &_in, const uint64_t _remaining,
+      std::string &_value)
+  {
+    uint64_t size = 0;
+    if (!ReadValue(_in, size) || size > _remaining)
+      return false;
+    _value.resize(size);
+    return size == 0 || _in.read(&_value[0], size);
+  }
+}
+
+/////////////////////////////////////////////////
+bool WorldCheckpoint::Write(const std::string &_filename) const
+{
+  const std::string tmpFilename = _filename + ".tmp";
+  {
+    std::ofstream out(tmpFilename, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+      gzerr << "Unable to open checkpoint file[" << tmpFilename << "]\n";
+      return false;
+    }
+
+    out.write(kCheckpointMagic, sizeof(kCheckpointMagic));
+    WriteString(out, this->snapshot.worldName);
+    WriteValue<int32_t>(out, this->snapshot.simTime.sec);
+    WriteValue<int32_t>(out, this->snapshot.simTime.nsec);
+    WriteValue<uint64_t>(out, this->snapshot.iterations);
+    WriteString(out, this->sdf);
+    WriteString(out, this->snapshot.physicsData);
+    WriteValue<uint64_t>(out, this->snapshot.pluginData.size());
+    for (auto const &data : this->snapshot.pluginData)
+    {
+      WriteString(out, data.first);
+      WriteString(out, data.second);
+    }
+
+    out.flush();
+    if (!out)
+    {
+      gzerr << "Unable to write checkpoint file[" << tmpFilename << "]\n";
+      return false;
+    }
+  }
+
+  if (std::rename(tmpFilename.c_str(), _filename.c_str()) != 0)
+  {
+    gzerr << "Unable to rename checkpoint file[" << tmpFilename << "] to ["
+          << _filename << "]\n";
+    std::remove(tmpFilename.c_str());
+    return false;
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool WorldCheckpoint::Read(const std::string &_filename)
+{
+  std::ifstream in(_filename, std::ios::binary | std::ios::ate);
+  if (!in)
+  {
+    gzerr << "Unable to open checkpoint file[" << _filename << "]\n";
+    return false;
+  }
+  const uint64_t fileSize = in.tellg();
+  in.seekg(0);
+
+  char magic[sizeof(kCheckpointMagic)];
+  if (!in.read(magic, sizeof(magic)) ||
+      !std::equal(magic, magic + sizeof(magic), kCheckpointMagic))
+  {
+    gzerr << "File[" << _filename << "] isn't a checkpoint\n";
+    return false;
+  }
+
+  WorldCheckpoint checkpoint;
+  int32_t sec = 0;
+  int32_t nsec = 0;
+  uint64_t pluginCount = 0;
+  bool valid = ReadString(in, fileSize, checkpoint.snapshot.worldName) &&
+      ReadValue(in, sec) && ReadValue(in, nsec) &&
+      ReadValue(in, checkpoint.snapshot.iterations) &&
+      ReadString(in, fileSize, checkpoint.sdf) &&
+      ReadString(in, fileSize, checkpoint.snapshot.physicsData) &&
+      ReadValue(in, pluginCount) && pluginCount <= fileSize;
+  for (uint64_t i = 0; valid && i < pluginCount; ++i)
+  {
+    std::string name;
+    std::string data;
+    valid = ReadString(in, fileSize, name) &&
+        ReadString(in, fileSize, data);
+    checkpoint.snapshot.pluginData[name].swap(data);
+  }
+  if (!valid)
+  {
+    gzerr << "Checkpoint file[" << _filename << "] is truncated\n";
+    return false;
+  }
+
+  checkpoint.snapshot.simTime.Set(sec, nsec);
+  *this = std::move(checkpoint);
+  return true;
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_WORLDSNAPSHOT_HH_
+#define GAZEBO_PHYSICS_WORLDSNAPSHOT_HH_
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class WorldSnapshot WorldSnapshot.hh physics/physics.hh
+    /// \brief In-memory copy of the complete simulation state of a world.
+    ///
+    /// A snapshot is taken with World::SaveSnapshot and restored with
+    /// World::RestoreSnapshot. Unlike WorldState, it holds the physics
+    /// engine data needed to continue the simulation exactly where it was
+    /// saved, and it is only valid for the world it was taken from, as
+    /// long as no models or lights are inserted or removed.
+    class GZ_PHYSICS_VISIBLE WorldSnapshot
+    {
+      /// \brief Name of the world the snapshot was taken from.
+      public: std::string worldName;
+
+      /// \brief Simulation time.
+      public: common::Time simTime;
+
+      /// \brief Simulation iterations.
+      public: uint64_t iterations = 0;
+
+      /// \brief Used to detect entities inserted or removed after the
+      /// snapshot was taken.
+      public: uint64_t entityGeneration = 0;
+
+      /// \brief Physics engine specific data.
+      /// \sa PhysicsEngine::SaveSnapshot
+      public: std::string physicsData;
+
+      /// \brief Data saved by the callbacks registered with
+      /// World::AddSnapshotCallbacks, indexed by callback name.
+      public: std::map<std::string, std::string> pluginData;
+    };
+
+    /// \class WorldCheckpoint WorldSnapshot.hh physics/physics.hh
+    /// \brief Snapshot of a world together with its SDF, written to disk
+    /// so that a new server can resume the simulation.
+    ///
+    /// Checkpoints are written by World::SaveCheckpoint, and periodically
+    /// when the world has a <gz:checkpoint> element. `gzserver --resume`
+    /// loads the SDF of a checkpoint and hands it to
+    /// World::ResumeCheckpoint.
+    class GZ_PHYSICS_VISIBLE WorldCheckpoint
+    {
+      /// \brief Write the checkpoint to a file. The data is written to a
+      /// temporary file first, which is renamed, so that an interrupted
+      /// write leaves the previous checkpoint intact.
+      /// \param[in] _filename Path of the file.
+      /// \return False if the file can't be written.
+      public: bool Write(const std::string &_filename) const;
+
+      /// \brief Read a checkpoint written by Write.
+      /// \param[in] _filename Path of the file.
+      /// \return False if the file doesn't exist or isn't a checkpoint,
+      /// in which case the checkpoint is left unchanged.
+      public: bool Read(const std::string &_filename);
+
+      /// \brief SDF document of the world, with the models inserted since
+      /// it was loaded and their state at the time of the checkpoint.
+      public: std::string sdf;
+
+      /// \brief Dynamic state of the world.
+      public: WorldSnapshot snapshot;
+    };
+    /// \}
+  }
+}
+#endif
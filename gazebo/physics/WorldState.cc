@@ -17,6 +17,13 @@
 /* Desc: A world state
  * Author: Nate Koenig
  */
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <set>
+#include <utility>
+#include <vector>
+
 #include <boost/algorithm/string.hpp>
 
 #include "gazebo/common/Console.hh"
@@ -112,41 +119,57 @@ void WorldState::Load(const WorldPtr _world)
   }
   std::list<std::string>::iterator partIter = parts.begin();
 
-  // Add a state for all the models that match the filter
+  // The first element in the filter must be a model name or a star.
+  bool filterModels = false;
+  boost::regex regex;
+  if (partIter != parts.end() && !parts.empty() &&
+      !(*partIter).empty() && (*partIter) != "*")
+  {
+    std::string regexStr = *partIter;
+    boost::replace_all(regexStr, "*", ".*");
+    regex.assign(regexStr);
+    filterModels = true;
+  }
+
+  // Find the states of the models that match the filter, and then load
+  // them in parallel, since each only reads its model.
   Model_V models = _world->Models();
-  for (Model_V::const_iterator iter = models.begin();
-       iter != models.end(); ++iter)
+  std::vector<std::pair<const ModelPtr *, ModelState *>> loads;
+  loads.reserve(models.size());
+  for (auto const &model : models)
   {
-    bool add = true;
+    if (!filterModels || boost::regex_match(model->GetName(), regex))
+      loads.emplace_back(&model, &this->modelStates[model->GetName()]);
+  }
 
-    // The first element in the filter must be a model name or a star.
-    if (partIter != parts.end() && !parts.empty() &&
-        !(*partIter).empty() && (*partIter) != "*")
-    {
-      std::string regexStr = *partIter;
-      boost::replace_all(regexStr, "*", ".*");
-      boost::regex regex(regexStr);
-      add = boost::regex_match((*iter)->GetName(), regex);
-    }
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, loads.size(), 16),
+      [&](const tbb::blocked_range<size_t> &_r)
+      {
+        for (size_t i = _r.begin(); i != _r.end(); ++i)
+        {
+          loads[i].second->Load(*loads[i].first, this->realTime,
+              this->simTime, this->iterations);
+        }
+      });
+
+  // Remove the states of models that no longer exist, or don't match the
+  // filter anymore.
+  if (this->modelStates.size() != loads.size())
+  {
+    std::set<const ModelState *> loaded;
+    for (auto const &load : loads)
+      loaded.insert(load.second);
 
-    if (add)
+    for (ModelState_M::iterator iter = this->modelStates.begin();
+         iter != this->modelStates.end();)
     {
-      this->modelStates[(*iter)->GetName()].Load(*iter, this->realTime,
-          this->simTime, this->iterations);
+      if (loaded.count(&iter->second) == 0)
+        this->modelStates.erase(iter++);
+      else
+        ++iter;
     }
   }
 
-  // Remove models that no longer exist. We determine this by check the time
-  // stamp on each model.
-  for (ModelState_M::iterator iter = this->modelStates.begin();
-       iter != this->modelStates.end();)
-  {
-    if (iter->second.GetRealTime() != this->realTime)
-      this->modelStates.erase(iter++);
-    else
-      ++iter;
-  }
-
   // Add states for all the lights
   this->lightStates.clear();
   Light_V lights = _world->Lights();
@@ -438,35 +461,13 @@ WorldState &WorldState::operator=(const WorldState &_state)
 {
   State::operator=(_state);
 
-  // Clear the states
-  this->modelStates.clear();
-  this->lightStates.clear();
-
-  this->insertions.clear();
-  this->deletions.clear();
-
-  // Copy the model states.
-  for (ModelState_M::const_iterator iter =
-       _state.modelStates.begin(); iter != _state.modelStates.end(); ++iter)
-  {
-    this->modelStates.insert(std::make_pair(iter->first,
-          ModelState(iter->second)));
-  }
-
-  // Copy the light states.
-  for (const auto &light : _state.lightStates)
-  {
-    this->lightStates.insert(std::make_pair(light.first,
-          LightState(light.second)));
-  }
-
-  // Copy the insertions
-  std::copy(_state.insertions.begin(),
-            _state.insertions.end(), this->insertions.begin());
+  // Copy the states. Assigning the maps reuses their nodes, which matters
+  // for the log worker copying a state every period.
+  this->modelStates = _state.modelStates;
+  this->lightStates = _state.lightStates;
 
-  // Copy the deletions
-  std::copy(_state.deletions.begin(),
-            _state.deletions.end(), this->deletions.begin());
+  this->insertions = _state.insertions;
+  this->deletions = _state.deletions;
 
   return *this;
 }
@@ -486,10 +487,10 @@ WorldState WorldState::operator-(const WorldState &_state) const
   for (ModelState_M::const_iterator iter =
        _state.modelStates.begin(); iter != _state.modelStates.end(); ++iter)
   {
-    if (this->HasModelState(iter->second.GetName()))
+    auto current = this->modelStates.find(iter->first);
+    if (current != this->modelStates.end())
     {
-      ModelState state = this->GetModelState(iter->second.GetName()) -
-        iter->second;
+      ModelState state = current->second - iter->second;
 
       if (!state.IsZero())
       {
@@ -505,10 +506,10 @@ WorldState WorldState::operator-(const WorldState &_state) const
   // Subtract the light states.
   for (const auto &light : _state.lightStates)
   {
-    if (this->HasLightState(light.second.GetName()))
+    auto current = this->lightStates.find(light.first);
+    if (current != this->lightStates.end())
     {
-      LightState state = this->GetLightState(light.second.GetName()) -
-          light.second;
+      LightState state = current->second - light.second;
 
       if (!state.IsZero())
       {
@@ -603,6 +604,75 @@ void WorldState::FillSDF(sdf::ElementPtr _sdf)
   }
 }
 
+/////////////////////////////////////////////////
+void WorldState::FillMsg(msgs::WorldState &_msg) const
+{
+  _msg.set_name(this->name);
+  msgs::Set(_msg.mutable_sim_time(), this->simTime);
+  msgs::Set(_msg.mutable_real_time(), this->realTime);
+  msgs::Set(_msg.mutable_wall_time(), this->wallTime);
+  _msg.set_iterations(this->iterations);
+
+  for (const auto &insertion : this->insertions)
+    _msg.add_insertions(insertion);
+
+  for (const auto &deletion : this->deletions)
+    _msg.add_deletions(deletion);
+
+  for (const auto &model : this->modelStates)
+    model.second.FillMsg(*_msg.add_model());
+
+  for (const auto &light : this->lightStates)
+    light.second.FillMsg(*_msg.add_light());
+}
+
+/////////////////////////////////////////////////
+void WorldState::Load(const msgs::WorldState &_msg)
+{
+  // Copy the name and time information
+  this->name = _msg.name();
+  this->simTime = _msg.has_sim_time() ?
+      msgs::Convert(_msg.sim_time()) : common::Time::Zero;
+  this->realTime = _msg.has_real_time() ?
+      msgs::Convert(_msg.real_time()) : common::Time::Zero;
+  this->wallTime = _msg.has_wall_time() ?
+      msgs::Convert(_msg.wall_time()) : common::Time::Zero;
+  this->iterations = _msg.iterations();
+
+  // Add the model states
+  this->modelStates.clear();
+  for (int i = 0; i < _msg.model_size(); ++i)
+  {
+    ModelState modelState;
+    modelState.Load(_msg.model(i));
+    modelState.SetSimTime(this->simTime);
+    modelState.SetWallTime(this->wallTime);
+    modelState.SetRealTime(this->realTime);
+    modelState.SetIterations(this->iterations);
+    this->modelStates.insert(std::make_pair(modelState.GetName(),
+          modelState));
+  }
+
+  // Add the light states
+  this->lightStates.clear();
+  for (int i = 0; i < _msg.light_size(); ++i)
+  {
+    LightState lightState;
+    lightState.Load(_msg.light(i));
+    lightState.SetSimTime(this->simTime);
+    lightState.SetWallTime(this->wallTime);
+    lightState.SetRealTime(this->realTime);
+    lightState.SetIterations(this->iterations);
+    this->lightStates.insert(std::make_pair(lightState.GetName(),
+          lightState));
+  }
+
+  // Add insertions and deletions
+  this->insertions.assign(_msg.insertions().begin(),
+      _msg.insertions().end());
+  this->deletions.assign(_msg.deletions().begin(), _msg.deletions().end());
+}
+
 /////////////////////////////////////////////////
 void WorldState::SetWallTime(const common::Time &_time)
 {
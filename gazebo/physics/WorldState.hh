@@ -26,6 +26,7 @@
 
 #include <sdf/sdf.hh>
 
+#include "gazebo/msgs/msgs.hh"
 #include "gazebo/physics/State.hh"
 #include "gazebo/physics/ModelState.hh"
 #include "gazebo/physics/LightState.hh"
@@ -167,6 +168,16 @@ namespace gazebo
       /// \return True if the values in the state are zero.
       public: bool IsZero() const;
 
+      /// \brief Populate a state message with data from the object.
+      /// When this state is the difference between two states the message
+      /// only holds the models and lights that changed.
+      /// \param[out] _msg Message to populate.
+      public: void FillMsg(msgs::WorldState &_msg) const;
+
+      /// \brief Load state from a message.
+      /// \param[in] _msg Message to load the state from.
+      public: void Load(const msgs::WorldState &_msg);
+
       /// \brief Populate a state SDF element with data from the object.
       /// \param[out] _sdf SDF element to populate.
       public: void FillSDF(sdf::ElementPtr _sdf);
@@ -141,6 +141,63 @@ TEST_F(WorldStateTest, FillSDF)
       "sun");
 }
 
+//////////////////////////////////////////////////
+TEST_F(WorldStateTest, FillMsg)
+{
+  // Load a world
+  this->Load("worlds/shapes.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::ModelPtr box = world->ModelByName("box");
+  ASSERT_TRUE(box != nullptr);
+
+  physics::WorldState worldState(world);
+  worldState.SetIterations(42);
+
+  // Round trip through a message
+  msgs::WorldState msg;
+  worldState.FillMsg(msg);
+  EXPECT_EQ(msg.name(), "default");
+  EXPECT_EQ(msg.iterations(), 42u);
+  EXPECT_EQ(static_cast<unsigned int>(msg.model_size()),
+      worldState.GetModelStateCount());
+
+  std::string data;
+  ASSERT_TRUE(msg.SerializeToString(&data));
+  msgs::WorldState parsedMsg;
+  ASSERT_TRUE(parsedMsg.ParseFromString(data));
+
+  physics::WorldState loadedState;
+  loadedState.Load(parsedMsg);
+  EXPECT_EQ(loadedState.GetName(), "default");
+  EXPECT_EQ(loadedState.GetIterations(), 42u);
+  EXPECT_EQ(loadedState.GetSimTime(), worldState.GetSimTime());
+  EXPECT_EQ(loadedState.GetModelStateCount(),
+      worldState.GetModelStateCount());
+  EXPECT_EQ(loadedState.LightStateCount(), worldState.LightStateCount());
+  EXPECT_EQ(loadedState.GetModelState("box").Pose(), box->WorldPose());
+  EXPECT_EQ(loadedState.GetModelState("box").GetLinkStateCount(),
+      worldState.GetModelState("box").GetLinkStateCount());
+
+  // Move the box and encode only the difference
+  box->SetWorldPose(ignition::math::Pose3d(1, 2, 3, 0, 0, 0.5));
+  physics::WorldState movedState(world);
+  physics::WorldState diffState = movedState - worldState;
+
+  msgs::WorldState diffMsg;
+  diffState.FillMsg(diffMsg);
+  EXPECT_EQ(diffMsg.model_size(), 1);
+  EXPECT_EQ(diffMsg.model(0).name(), "box");
+  EXPECT_LT(diffMsg.ByteSize(), msg.ByteSize());
+
+  physics::WorldState loadedDiff;
+  loadedDiff.Load(diffMsg);
+  physics::WorldState appliedState = worldState + loadedDiff;
+  EXPECT_EQ(appliedState.GetModelState("box").Pose(),
+      ignition::math::Pose3d(1, 2, 3, 0, 0, 0.5));
+}
+
 //////////////////////////////////////////////////
 TEST_F(WorldStateTest, OperatorsNoInsertionsDeletions)
 {
@@ -333,6 +390,45 @@ TEST_F(WorldStateTest, InsertionOfMeshModel)
   EXPECT_TRUE(inserted.find("<scale>0.5 0.6 0.7</scale>") != std::string::npos);
 }
 
+//////////////////////////////////////////////////
+TEST_F(WorldStateTest, AssignAndReload)
+{
+  this->Load("worlds/shapes.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::WorldState state(world);
+  state.SetInsertions({"<model name='inserted'/>"});
+  state.SetDeletions({"deleted"});
+
+  // Assignment copies the insertions and deletions with the states
+  physics::WorldState copy;
+  copy = state;
+  ASSERT_EQ(1u, copy.Insertions().size());
+  EXPECT_EQ("<model name='inserted'/>", copy.Insertions()[0]);
+  ASSERT_EQ(1u, copy.Deletions().size());
+  EXPECT_EQ("deleted", copy.Deletions()[0]);
+  EXPECT_EQ(state.GetModelStateCount(), copy.GetModelStateCount());
+
+  // Reloading a state updates its models in place
+  physics::ModelPtr box = world->ModelByName("box");
+  ASSERT_TRUE(box != nullptr);
+  box->SetWorldPose(ignition::math::Pose3d(1, 2, 3, 0, 0, 0));
+  copy.Load(world);
+  EXPECT_EQ(world->ModelCount(), copy.GetModelStateCount());
+  EXPECT_EQ(ignition::math::Pose3d(1, 2, 3, 0, 0, 0),
+      copy.GetModelState("box").Pose());
+  EXPECT_EQ(box->GetLinks().size(),
+      copy.GetModelState("box").GetLinkStateCount());
+  EXPECT_TRUE(copy.Insertions().empty());
+
+  // Removed models are dropped from the state
+  world->RemoveModel("box");
+  copy.Load(world);
+  EXPECT_FALSE(copy.HasModelState("box"));
+  EXPECT_EQ(world->ModelCount(), copy.GetModelStateCount());
+}
+
 //////////////////////////////////////////////////
 TEST_F(WorldStateTest, Times)
 {
@@ -15,8 +15,15 @@
  *
 */
 
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <boost/filesystem.hpp>
+
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/physics/World.hh"
+#include "gazebo/util/LogRecord.hh"
 #include "gazebo/test/ServerFixture.hh"
 #include "test/util.hh"
 
@@ -217,6 +224,442 @@ TEST_F(WorldTest, Stop)
 }
 
 //////////////////////////////////////////////////
+TEST_F(WorldTest, NameIndex)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  // World name returns the root element
+  auto root = world->BaseByName("default");
+  ASSERT_NE(nullptr, root);
+  EXPECT_EQ(nullptr, root->GetParent());
+
+  // Scoped and leaf names
+  auto box = world->ModelByName("box");
+  ASSERT_NE(nullptr, box);
+  EXPECT_EQ(box, world->EntityByName("box"));
+  auto link = world->EntityByName("box::link");
+  ASSERT_NE(nullptr, link);
+  EXPECT_EQ(box, link->GetParentModel());
+  EXPECT_EQ(nullptr, world->EntityByName("box::fake_link"));
+
+  // Ambiguous leaf names return the first match in the entity tree
+  auto groundPlane = world->ModelByName("ground_plane");
+  ASSERT_NE(nullptr, groundPlane);
+  EXPECT_EQ(groundPlane->GetLink("link"), world->EntityByName("link"));
+
+  // Rename
+  box->SetName("renamed_box");
+  EXPECT_EQ(nullptr, world->ModelByName("box"));
+  EXPECT_EQ(box, world->ModelByName("renamed_box"));
+  box->SetName("box");
+  EXPECT_EQ(box, world->ModelByName("box"));
+
+  // Removal
+  world->RemoveModel("sphere");
+  EXPECT_EQ(nullptr, world->ModelByName("sphere"));
+  EXPECT_EQ(nullptr, world->EntityByName("sphere::link"));
+  EXPECT_NE(nullptr, world->ModelByName("cylinder"));
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldTest, ParallelModelUpdate)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  // Sequential update is the default
+  EXPECT_FALSE(world->ParallelModelUpdate());
+  boost::any value;
+  EXPECT_TRUE(world->Physics()->GetParam("parallel_model_update", value));
+  EXPECT_FALSE(boost::any_cast<bool>(value));
+
+  world->Step(10);
+  auto simTime = world->SimTime();
+
+  // Enable through the physics parameter
+  EXPECT_TRUE(world->Physics()->SetParam("parallel_model_update", true));
+  EXPECT_TRUE(world->ParallelModelUpdate());
+
+  world->Step(100);
+  EXPECT_GT(world->SimTime(), simTime);
+  EXPECT_EQ(world->ModelCount(), 4u);
+
+  // Disable through the world API
+  world->SetParallelModelUpdate(false);
+  EXPECT_FALSE(world->ParallelModelUpdate());
+  EXPECT_TRUE(world->Physics()->GetParam("parallel_model_update", value));
+  EXPECT_FALSE(boost::any_cast<bool>(value));
+  world->Step(10);
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldTest, StepBatchSize)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  EXPECT_EQ(1u, world->StepBatchSize());
+
+  // Zero is not a valid batch size
+  world->SetStepBatchSize(0);
+  EXPECT_EQ(1u, world->StepBatchSize());
+
+  boost::any value;
+  EXPECT_TRUE(world->Physics()->SetParam("step_batch_size", 10u));
+  EXPECT_EQ(10u, world->StepBatchSize());
+  EXPECT_TRUE(world->Physics()->GetParam("step_batch_size", value));
+  EXPECT_EQ(10u, boost::any_cast<unsigned int>(value));
+
+  // Batches are limited by the requested number of steps
+  world->Physics()->SetRealTimeUpdateRate(0);
+  auto iterations = world->Iterations();
+  world->Step(25);
+  EXPECT_EQ(iterations + 25u, world->Iterations());
+
+  // A barrier ends a batch without skipping steps, at the third one
+  const common::Time barrier = world->SimTime() +
+      common::Time(2.5 * world->Physics()->GetMaxStepSize());
+  int barrierCount = 0;
+  common::Time barrierTime;
+  uint32_t barrierIterations = 0;
+  world->AddStepBarrier(barrier,
+      [&]()
+      {
+        ++barrierCount;
+        barrierTime = world->SimTime();
+        barrierIterations = world->Iterations();
+      });
+  world->Step(25);
+  EXPECT_EQ(iterations + 50u, world->Iterations());
+
+  // The batch ended at the step reaching the barrier
+  EXPECT_EQ(1, barrierCount);
+  EXPECT_EQ(iterations + 28u, barrierIterations);
+  EXPECT_GE(barrierTime, barrier);
+  EXPECT_LT(barrierTime - barrier,
+      common::Time(world->Physics()->GetMaxStepSize()));
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldTest, Snapshot)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  auto box = world->ModelByName("box");
+  ASSERT_NE(nullptr, box);
+  box->SetWorldPose(ignition::math::Pose3d(0, 0, 2, 0, 0, 0));
+
+  std::string pluginData = "initial";
+  world->AddSnapshotCallbacks("test",
+      [&pluginData]() {return pluginData;},
+      [&pluginData](const std::string &_data) {pluginData = _data;});
+
+  physics::WorldSnapshot snapshot;
+  world->SaveSnapshot(snapshot);
+  EXPECT_EQ("default", snapshot.worldName);
+  EXPECT_EQ(world->SimTime(), snapshot.simTime);
+  EXPECT_EQ(world->Iterations(), snapshot.iterations);
+  EXPECT_EQ(1u, snapshot.pluginData.count("test"));
+  auto pose = box->WorldPose();
+
+  // Let the box fall
+  pluginData = "changed";
+  world->Step(300);
+  EXPECT_GT(pose.Pos().Z() - box->WorldPose().Pos().Z(), 0.5);
+
+  // Restoring several times gives the same result every time
+  for (int i = 0; i < 2; ++i)
+  {
+    EXPECT_TRUE(world->RestoreSnapshot(snapshot));
+    EXPECT_EQ(snapshot.simTime, world->SimTime());
+    EXPECT_EQ(snapshot.iterations, world->Iterations());
+    EXPECT_EQ(pose, box->WorldPose());
+    EXPECT_EQ(ignition::math::Vector3d::Zero, box->WorldLinearVel());
+    EXPECT_EQ("initial", pluginData);
+    world->Step(10);
+  }
+
+  // A snapshot can't be restored after a model is removed
+  world->RemoveModel("sphere");
+  EXPECT_FALSE(world->RestoreSnapshot(snapshot));
+
+  world->RemoveSnapshotCallbacks("test");
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldTest, Checkpoint)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  auto box = world->ModelByName("box");
+  ASSERT_NE(nullptr, box);
+  box->SetWorldPose(ignition::math::Pose3d(0, 0, 2, 0, 0, 0));
+
+  std::string pluginData = "initial";
+  world->AddSnapshotCallbacks("test",
+      [&pluginData]() {return pluginData;},
+      [&pluginData](const std::string &_data) {pluginData = _data;});
+
+  namespace fs = boost::filesystem;
+  const std::string filename = (fs::temp_directory_path() /
+      fs::unique_path("gazebo-checkpoint-%%%%-%%%%")).string();
+
+  world->Step(50);
+  const uint32_t iterations = world->Iterations();
+  EXPECT_TRUE(world->SaveCheckpoint(filename));
+  EXPECT_TRUE(world->WaitForCheckpoint());
+  EXPECT_FALSE(fs::exists(filename + ".tmp"));
+
+  // Reference of the next iteration
+  world->Step(1);
+  auto pose = box->WorldPose();
+  pluginData = "changed";
+  world->Step(100);
+  EXPECT_NE(pose, box->WorldPose());
+
+  physics::WorldCheckpoint checkpoint;
+  ASSERT_TRUE(checkpoint.Read(filename));
+  EXPECT_EQ("default", checkpoint.snapshot.worldName);
+  EXPECT_EQ(iterations, checkpoint.snapshot.iterations);
+  EXPECT_EQ("initial", checkpoint.snapshot.pluginData["test"]);
+  EXPECT_NE(std::string::npos, checkpoint.sdf.find("<model name='box'>"));
+
+  // The world continues from the checkpoint
+  EXPECT_TRUE(world->ResumeCheckpoint(checkpoint));
+  world->Step(1);
+  EXPECT_EQ(iterations + 1, world->Iterations());
+  EXPECT_EQ("initial", pluginData);
+  EXPECT_EQ(pose, box->WorldPose());
+
+  // Checkpoints of other worlds and other files are refused
+  physics::WorldCheckpoint other = checkpoint;
+  other.snapshot.worldName = "other";
+  EXPECT_FALSE(world->ResumeCheckpoint(other));
+  EXPECT_FALSE(other.Read(filename + ".missing"));
+  {
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    out << "GZCKPT01 truncated";
+  }
+  EXPECT_FALSE(other.Read(filename));
+  EXPECT_EQ("other", other.snapshot.worldName);
+
+  // Periodic checkpoints overwrite the file
+  world->SetCheckpointPeriod(0.01, filename);
+  EXPECT_DOUBLE_EQ(0.01, world->CheckpointPeriod());
+  world->Step(25);
+  EXPECT_TRUE(world->WaitForCheckpoint());
+  ASSERT_TRUE(checkpoint.Read(filename));
+  EXPECT_GT(checkpoint.snapshot.iterations, iterations + 1u);
+
+  world->SetCheckpointPeriod(0, filename);
+  world->RemoveSnapshotCallbacks("test");
+  fs::remove(filename);
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldTest, Sleep)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  EXPECT_DOUBLE_EQ(0.0, world->SleepTime());
+  world->SetSleepTime(-1.0);
+  EXPECT_DOUBLE_EQ(0.0, world->SleepTime());
+
+  world->SetSleepThresholds(0.05, 0.05);
+  EXPECT_DOUBLE_EQ(0.05, world->SleepLinearThreshold());
+  EXPECT_DOUBLE_EQ(0.05, world->SleepAngularThreshold());
+
+  boost::any value;
+  EXPECT_TRUE(world->Physics()->SetParam("sleep_time", 0.2));
+  EXPECT_DOUBLE_EQ(0.2, world->SleepTime());
+  EXPECT_TRUE(world->Physics()->GetParam("sleep_time", value));
+  EXPECT_DOUBLE_EQ(0.2, boost::any_cast<double>(value));
+
+  auto box = world->ModelByName("box");
+  ASSERT_NE(nullptr, box);
+
+  // The box rests on the ground and falls asleep
+  world->Step(1000);
+  EXPECT_TRUE(box->Sleeping());
+  auto pose = box->WorldPose();
+  world->Step(100);
+  EXPECT_EQ(pose, box->WorldPose());
+
+  // A command wakes it up
+  box->SetLinearVel(ignition::math::Vector3d(1, 0, 0));
+  EXPECT_FALSE(box->Sleeping());
+  world->Step(10);
+  EXPECT_GT(box->WorldPose().Pos().X(), pose.Pos().X());
+
+  // Disabling sleep wakes every model
+  world->Step(1000);
+  EXPECT_TRUE(box->Sleeping());
+  world->SetSleepTime(0.0);
+  EXPECT_FALSE(box->Sleeping());
+}
+
+std::mutex g_interestMutex;
+std::set<std::string> g_interestNames;
+
+//////////////////////////////////////////////////
+void OnInterestPoses(ConstPosesStampedPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(g_interestMutex);
+  for (int i = 0; i < _msg->pose_size(); ++i)
+    g_interestNames.insert(_msg->pose(i).name());
+}
+
+//////////////////////////////////////////////////
+/// \brief Only the poses inside a registered region are published on its
+/// topic.
+TEST_F(WorldTest, PoseInterest)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  auto sub = this->node->Subscribe("~/pose/interest_test",
+      &OnInterestPoses);
+
+  // A region around the box only
+  auto pub = this->node->Advertise<msgs::PoseInterest>("~/pose/interest");
+  pub->WaitForConnection();
+  msgs::PoseInterest msg;
+  msg.set_topic("~/pose/interest_test");
+  msgs::Set(msg.mutable_min(), ignition::math::Vector3d(-0.6, -0.6, 0));
+  msgs::Set(msg.mutable_max(), ignition::math::Vector3d(0.6, 0.6, 1.2));
+  pub->Publish(msg);
+
+  for (int i = 0; i < 50; ++i)
+  {
+    world->Step(10);
+    common::Time::MSleep(20);
+    std::lock_guard<std::mutex> lock(g_interestMutex);
+    if (g_interestNames.count("box"))
+      break;
+  }
+
+  std::lock_guard<std::mutex> lock(g_interestMutex);
+  EXPECT_EQ(1u, g_interestNames.count("box"));
+  EXPECT_EQ(0u, g_interestNames.count("sphere"));
+  EXPECT_EQ(0u, g_interestNames.count("cylinder"));
+}
+
+std::mutex g_poseInfoMutex;
+std::set<std::string> g_poseInfoNames;
+
+//////////////////////////////////////////////////
+void OnPoseInfo(ConstPosesStampedPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(g_poseInfoMutex);
+  for (int i = 0; i < _msg->pose_size(); ++i)
+    g_poseInfoNames.insert(_msg->pose(i).name());
+}
+
+//////////////////////////////////////////////////
+/// \brief Models moved by the physics engine are published on
+/// ~/pose/info.
+TEST_F(WorldTest, PublishPhysicsPoses)
+{
+  this->Load("worlds/empty.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  SpawnBox("falling_box", ignition::math::Vector3d(1, 1, 1),
+      ignition::math::Vector3d(0, 0, 5), ignition::math::Vector3d::Zero);
+  auto box = world->ModelByName("falling_box");
+  ASSERT_NE(nullptr, box);
+
+  auto sub = this->node->Subscribe("~/pose/info", &OnPoseInfo);
+
+  // Only poses published after the box started falling count
+  world->Step(1);
+  common::Time::MSleep(100);
+  {
+    std::lock_guard<std::mutex> lock(g_poseInfoMutex);
+    g_poseInfoNames.clear();
+  }
+
+  auto pose = box->WorldPose();
+  for (int i = 0; i < 50; ++i)
+  {
+    world->Step(10);
+    common::Time::MSleep(20);
+    std::lock_guard<std::mutex> lock(g_poseInfoMutex);
+    if (g_poseInfoNames.count("falling_box"))
+      break;
+  }
+  EXPECT_LT(box->WorldPose().Pos().Z(), pose.Pos().Z());
+
+  std::lock_guard<std::mutex> lock(g_poseInfoMutex);
+  EXPECT_EQ(1u, g_poseInfoNames.count("falling_box"));
+}
+
+//////////////////////////////////////////////////
+/// \brief Stepping the world while logging must not wait for the log
+/// worker thread.
+TEST_F(WorldTest, LogCapture)
+{
+  util::LogRecord *recorder = util::LogRecord::Instance();
+  ASSERT_NE(nullptr, recorder);
+  recorder->Init("test");
+
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+  EXPECT_EQ(0u, world->DroppedLogStates());
+
+  EXPECT_TRUE(recorder->Start("zlib"));
+  EXPECT_TRUE(recorder->Running());
+
+  auto iterations = world->Iterations();
+  world->Step(500);
+  EXPECT_EQ(iterations + 500u, world->Iterations());
+
+  // Inserting a model while recording is picked up by the next snapshot
+  SpawnBox("log_box", ignition::math::Vector3d(1, 1, 1),
+      ignition::math::Vector3d(0, 0, 2), ignition::math::Vector3d::Zero);
+  world->Step(100);
+  EXPECT_NE(nullptr, world->ModelByName("log_box"));
+
+  recorder->Stop();
+  EXPECT_FALSE(recorder->Running());
+}
+
+/////////////////////////////////////////////////
+TEST_F(WorldTest, StartupTimes)
+{
+  this->Load("worlds/empty.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  // Plugins load on the first step once sensors are initialized
+  world->Step(1);
+  auto times = world->StartupTimes();
+  ASSERT_EQ(4u, times.size());
+  EXPECT_EQ("load", times[0].first);
+  EXPECT_EQ("init", times[1].first);
+  EXPECT_EQ("sensors", times[2].first);
+  EXPECT_EQ("plugins", times[3].first);
+  for (const auto &phase : times)
+    EXPECT_GE(phase.second, 0.0);
+
+  // Later steps don't add phases
+  world->Step(10);
+  EXPECT_EQ(4u, world->StartupTimes().size());
+}
+
+/////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -28,6 +28,36 @@
 using namespace gazebo;
 using namespace physics;
 
+namespace
+{
+  /// \brief Bullet height field reading the heights of a tiled heightmap,
+  /// instead of an array holding all of them.
+  class TiledHeightfieldTerrainShape : public btHeightfieldTerrainShape
+  {
+    /// \brief Constructor.
+    /// \param[in] _shape Heightmap holding the tiles.
+    /// \param[in] _minHeight Minimum height.
+    /// \param[in] _maxHeight Maximum height.
+    public: TiledHeightfieldTerrainShape(const HeightmapShape *_shape,
+                btScalar _minHeight, btScalar _maxHeight)
+            : btHeightfieldTerrainShape(_shape->VertexCount().X(),
+                _shape->VertexCount().Y(), nullptr, 1, _minHeight,
+                _maxHeight, 2, PHY_FLOAT, false),
+              shape(_shape)
+            {
+            }
+
+    // Documentation inherited
+    protected: virtual btScalar getRawHeightFieldValue(int _x, int _y) const
+               {
+                 return this->shape->GetHeight(_x, _y);
+               }
+
+    /// \brief Heightmap holding the tiles.
+    private: const HeightmapShape *shape;
+  };
+}
+
 //////////////////////////////////////////////////
 BulletHeightmapShape::BulletHeightmapShape(CollisionPtr _parent)
     : HeightmapShape(_parent)
@@ -53,16 +83,24 @@ void BulletHeightmapShape::Init()
   int upIndex = 2;
   btVector3 localScaling(this->scale.X(), this->scale.Y(), 1.0);
 
-  this->heightFieldShape  = new btHeightfieldTerrainShape(
-      this->vertSize,     // # of heights along width
-      this->vertSize,     // # of height along height
-      &this->heights[0],  // The heights
-      1,                  // Height scaling
-      minHeight,          // Min height
-      maxHeight,          // Max height
-      upIndex,            // Up axis
-      PHY_FLOAT,
-      false);             // Flip quad edges
+  if (this->Tiled())
+  {
+    this->heightFieldShape = new TiledHeightfieldTerrainShape(
+        this, minHeight, maxHeight);
+  }
+  else
+  {
+    this->heightFieldShape  = new btHeightfieldTerrainShape(
+        this->vertSize,     // # of heights along width
+        this->vertSize,     // # of height along height
+        this->heights->data(),  // The heights
+        1,                  // Height scaling
+        minHeight,          // Min height
+        maxHeight,          // Max height
+        upIndex,            // Up axis
+        PHY_FLOAT,
+        false);             // Flip quad edges
+  }
 
   this->heightFieldShape->setLocalScaling(localScaling);
 
@@ -164,9 +164,7 @@ void BulletLink::Init()
   this->rigidLink->setFriction(0.5*(hackMu1 + hackMu2));  // Hack
 
   // Setup motion clamping to prevent objects from moving too fast.
-  // this->rigidLink->setCcdMotionThreshold(1);
-  // auto size = this->BoundingBox().Size();
-  // this->rigidLink->setCcdSweptSphereRadius(size.GetMax()*0.8);
+  this->UpdateContinuousCollision(this->ContinuousCollision());
 
   if (this->inertial->Mass() <= 0.0)
     this->rigidLink->setCollisionFlags(btCollisionObject::CF_KINEMATIC_OBJECT);
@@ -208,6 +206,32 @@ void BulletLink::Init()
   this->SetAngularDamping(this->GetAngularDamping());
 }
 
+//////////////////////////////////////////////////
+void BulletLink::UpdateContinuousCollision(const bool _enable)
+{
+  if (!this->rigidLink || !this->compoundShape)
+    return;
+
+  if (!_enable)
+  {
+    this->rigidLink->setCcdMotionThreshold(0);
+    this->rigidLink->setCcdSweptSphereRadius(0);
+    return;
+  }
+
+  // The swept sphere fits in the bounding box of the collisions, and is
+  // only swept when the link moves further than its radius in one step.
+  btVector3 min, max;
+  this->compoundShape->getAabb(btTransform::getIdentity(), min, max);
+  const btVector3 size = max - min;
+  const btScalar radius = 0.5 * size[size.minAxis()];
+  if (radius <= 0)
+    return;
+
+  this->rigidLink->setCcdMotionThreshold(radius);
+  this->rigidLink->setCcdSweptSphereRadius(radius);
+}
+
 //////////////////////////////////////////////////
 void BulletLink::Fini()
 {
@@ -234,6 +258,8 @@ void BulletLink::Fini()
 /////////////////////////////////////////////////////////////////////
 void BulletLink::UpdateMass()
 {
+  this->ResetWorldCache();
+
   if (this->rigidLink && this->inertial)
   {
     if (this->inertial->ProductsOfInertia() != ignition::math::Vector3d::Zero)
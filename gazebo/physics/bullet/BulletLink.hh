@@ -109,6 +109,12 @@ namespace gazebo
       /// \brief Remove and re-add this rigid body from the world.
       public: void RemoveAndAddBody() const;
 
+      /// \internal
+      /// \brief Set up bullet's swept sphere on the rigid body, called
+      /// on init and by BulletPhysics::SetLinkContinuousCollision.
+      /// \param[in] _enable True to enable continuous collision detection.
+      public: void UpdateContinuousCollision(const bool _enable);
+
       /// \internal
       /// \brief Clear bullet collision cache needed when the body is resized.
       public: void ClearCollisionCache();
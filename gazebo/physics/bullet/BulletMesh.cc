@@ -15,8 +15,12 @@
  *
 */
 
+#include <functional>
+
 #include "gazebo/common/Mesh.hh"
 
+#include "gazebo/physics/MeshDataCache.hh"
+
 #include "gazebo/physics/bullet/BulletTypes.hh"
 #include "gazebo/physics/bullet/BulletCollision.hh"
 #include "gazebo/physics/bullet/BulletPhysics.hh"
@@ -25,6 +29,9 @@
 using namespace gazebo;
 using namespace physics;
 
+/// \brief Triangle data shared by the bullet meshes with the same key.
+static MeshDataCache<btTriangleMesh> triangleMeshCache;
+
 //////////////////////////////////////////////////
 BulletMesh::BulletMesh()
 {
@@ -38,80 +45,94 @@ BulletMesh::~BulletMesh()
 //////////////////////////////////////////////////
 void BulletMesh::Init(const common::SubMesh *_subMesh,
                       BulletCollisionPtr _collision,
-                      const ignition::math::Vector3d &_scale)
+                      const ignition::math::Vector3d &_scale,
+                      const std::string &_key)
 {
-  float *vertices = nullptr;
-  int *indices = nullptr;
+  std::function<std::shared_ptr<btTriangleMesh>()> create = [&]()
+  {
+    float *vertices = nullptr;
+    int *indices = nullptr;
 
-  unsigned int numVertices = _subMesh->GetVertexCount();
-  unsigned int numIndices = _subMesh->GetIndexCount();
+    // Get all the vertex and index data
+    _subMesh->FillArrays(&vertices, &indices);
 
-  // Get all the vertex and index data
-  _subMesh->FillArrays(&vertices, &indices);
+    auto triMesh = CreateTriangleMesh(vertices, indices,
+        _subMesh->GetVertexCount(), _subMesh->GetIndexCount(), _scale);
 
-  this->CreateMesh(vertices, indices, numVertices,
-                   numIndices, _collision, _scale);
+    delete [] vertices;
+    delete [] indices;
+    return triMesh;
+  };
 
-  delete [] vertices;
-  delete [] indices;
+  this->CreateMesh(
+      _key.empty() ? create() : triangleMeshCache.Get(_key, create),
+      _collision);
 }
 
 //////////////////////////////////////////////////
 void BulletMesh::Init(const common::Mesh *_mesh,
                       BulletCollisionPtr _collision,
-                      const ignition::math::Vector3d &_scale)
+                      const ignition::math::Vector3d &_scale,
+                      const std::string &_key)
 {
-  float *vertices = nullptr;
-  int *indices = nullptr;
+  std::function<std::shared_ptr<btTriangleMesh>()> create = [&]()
+  {
+    float *vertices = nullptr;
+    int *indices = nullptr;
 
-  unsigned int numVertices = _mesh->GetVertexCount();
-  unsigned int numIndices = _mesh->GetIndexCount();
+    // Get all the vertex and index data
+    _mesh->FillArrays(&vertices, &indices);
 
-  // Get all the vertex and index data
-  _mesh->FillArrays(&vertices, &indices);
+    auto triMesh = CreateTriangleMesh(vertices, indices,
+        _mesh->GetVertexCount(), _mesh->GetIndexCount(), _scale);
 
-  this->CreateMesh(vertices, indices, numVertices,
-                   numIndices, _collision, _scale);
+    delete [] vertices;
+    delete [] indices;
+    return triMesh;
+  };
 
-  delete [] vertices;
-  delete [] indices;
+  this->CreateMesh(
+      _key.empty() ? create() : triangleMeshCache.Get(_key, create),
+      _collision);
 }
 
 /////////////////////////////////////////////////
-void BulletMesh::CreateMesh(float *_vertices, int *_indices,
-    unsigned int _numVertices, unsigned int _numIndices,
-    BulletCollisionPtr _collision, const ignition::math::Vector3d &_scale)
+std::shared_ptr<btTriangleMesh> BulletMesh::CreateTriangleMesh(
+    const float *_vertices, const int *_indices, unsigned int _numVertices,
+    unsigned int _numIndices, const ignition::math::Vector3d &_scale)
 {
-  btTriangleMesh *mTriMesh = new btTriangleMesh();
+  auto mTriMesh = std::make_shared<btTriangleMesh>();
 
   // Scale the vertex data
+  std::vector<btVector3> vertices(_numVertices);
   for (unsigned int j = 0;  j < _numVertices; ++j)
   {
-    _vertices[j*3+0] = _vertices[j*3+0] * _scale.X();
-    _vertices[j*3+1] = _vertices[j*3+1] * _scale.Y();
-    _vertices[j*3+2] = _vertices[j*3+2] * _scale.Z();
+    vertices[j] = btVector3(_vertices[j*3+0] * _scale.X(),
+                            _vertices[j*3+1] * _scale.Y(),
+                            _vertices[j*3+2] * _scale.Z());
   }
 
   // Create the Bullet trimesh
   for (unsigned int j = 0; j < _numIndices; j += 3)
   {
-    btVector3 bv0(_vertices[_indices[j]*3+0],
-                  _vertices[_indices[j]*3+1],
-                  _vertices[_indices[j]*3+2]);
-
-    btVector3 bv1(_vertices[_indices[j+1]*3+0],
-                  _vertices[_indices[j+1]*3+1],
-                  _vertices[_indices[j+1]*3+2]);
+    mTriMesh->addTriangle(vertices[_indices[j]],
+                          vertices[_indices[j+1]],
+                          vertices[_indices[j+2]]);
+  }
 
-    btVector3 bv2(_vertices[_indices[j+2]*3+0],
-                  _vertices[_indices[j+2]*3+1],
-                  _vertices[_indices[j+2]*3+2]);
+  return mTriMesh;
+}
 
-    mTriMesh->addTriangle(bv0, bv1, bv2);
-  }
+/////////////////////////////////////////////////
+void BulletMesh::CreateMesh(std::shared_ptr<btTriangleMesh> _triMesh,
+    BulletCollisionPtr _collision)
+{
+  this->triangleMeshes.push_back(_triMesh);
 
+  // The bounding volume tree of the shape is built per collision, GImpact
+  // shapes update it while colliding.
   btGImpactMeshShape *gimpactMeshShape =
-    new btGImpactMeshShape(mTriMesh);
+    new btGImpactMeshShape(_triMesh.get());
   gimpactMeshShape->updateBound();
 
   _collision->SetCollisionShape(gimpactMeshShape);
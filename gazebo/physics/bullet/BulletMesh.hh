@@ -18,11 +18,17 @@
 #ifndef GAZEBO_PHYSICS_BULLET_BULLETMESH_HH_
 #define GAZEBO_PHYSICS_BULLET_BULLETMESH_HH_
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include <ignition/math/Vector3.hh>
 
 #include "gazebo/physics/bullet/BulletTypes.hh"
 #include "gazebo/util/system.hh"
 
+class btTriangleMesh;
+
 namespace gazebo
 {
   namespace physics
@@ -44,29 +50,48 @@ namespace gazebo
       /// \param[in] _subMesh Pointer to the submesh.
       /// \param[in] _collision Pointer to the collision object.
       /// \param[in] _scale Scaling factor.
+      /// \param[in] _key Key of the triangle data, see
+      /// MeshShape::CollisionMeshKey. Meshes with the same key share their
+      /// triangle data. Empty to not share it.
       public: void Init(const common::SubMesh *_subMesh,
                       BulletCollisionPtr _collision,
-                      const ignition::math::Vector3d &_scale);
+                      const ignition::math::Vector3d &_scale,
+                      const std::string &_key = "");
 
       /// \brief Create a mesh collision shape using a mesh.
       /// \param[in] _mesh Pointer to the mesh.
       /// \param[in] _collision Pointer to the collision object.
       /// \param[in] _scale Scaling factor.
+      /// \param[in] _key Key of the triangle data, see
+      /// MeshShape::CollisionMeshKey. Meshes with the same key share their
+      /// triangle data. Empty to not share it.
       public: void Init(const common::Mesh *_mesh,
                       BulletCollisionPtr _collision,
-                      const ignition::math::Vector3d &_scale);
+                      const ignition::math::Vector3d &_scale,
+                      const std::string &_key = "");
 
-      /// \brief Helper function to create the collision shape.
+      /// \brief Helper function to create the triangle data.
       /// \param[in] _vertices Array of vertices.
       /// \param[in] _indices Array of indices.
       /// \param[in] _numVertices Number of vertices.
       /// \param[in] _numIndices Number of indices.
-      /// \param[in] _collision Pointer to the collision object.
       /// \param[in] _scale Scaling factor.
-      private: void CreateMesh(float *_vertices, int *_indices,
+      /// \return The triangle data.
+      private: static std::shared_ptr<btTriangleMesh> CreateTriangleMesh(
+                   const float *_vertices, const int *_indices,
                    unsigned int _numVertices, unsigned int _numIndices,
-                   BulletCollisionPtr _collision,
                    const ignition::math::Vector3d &_scale);
+
+      /// \brief Helper function to create the collision shape.
+      /// \param[in] _triMesh The triangle data, possibly shared with other
+      /// meshes.
+      /// \param[in] _collision Pointer to the collision object.
+      private: void CreateMesh(std::shared_ptr<btTriangleMesh> _triMesh,
+                   BulletCollisionPtr _collision);
+
+      /// \brief Triangle data of the collision shapes created by this mesh,
+      /// which keep pointers to it.
+      private: std::vector<std::shared_ptr<btTriangleMesh>> triangleMeshes;
     };
     /// \}
   }
@@ -63,11 +63,13 @@ void BulletMeshShape::Init()
   if (this->submesh)
   {
     this->bulletMesh->Init(this->submesh, bParent,
-        this->sdf->Get<ignition::math::Vector3d>("scale"));
+        this->sdf->Get<ignition::math::Vector3d>("scale"),
+        this->CollisionMeshKey());
   }
   else
   {
     this->bulletMesh->Init(this->mesh, bParent,
-        this->sdf->Get<ignition::math::Vector3d>("scale"));
+        this->sdf->Get<ignition::math::Vector3d>("scale"),
+        this->CollisionMeshKey());
   }
 }
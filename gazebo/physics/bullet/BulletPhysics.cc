@@ -57,6 +57,7 @@
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
+#include "gazebo/common/Profiler.hh"
 
 #include "gazebo/physics/bullet/BulletPhysics.hh"
 #include "gazebo/physics/bullet/BulletSurfaceParams.hh"
@@ -257,6 +258,38 @@ bool ContactProcessed(btManifoldPoint &/*_cp*/, void * /*_body0*/,
   return true;
 }
 
+#ifdef LIBBULLET_VERSION_GE_288
+//////////////////////////////////////////////////
+// Installs a bullet task scheduler with _threads worker threads. The
+// scheduler is global to bullet, TBB and OpenMP are preferred over
+// bullet's own thread pool. Returns false if bullet was built without
+// BT_THREADSAFE, in which case none of them is available.
+bool SetTaskSchedulerThreads(const int _threads)
+{
+  static btITaskScheduler *defaultScheduler = nullptr;
+
+  btITaskScheduler *scheduler = btGetTaskScheduler();
+  if (scheduler == nullptr || scheduler == btGetSequentialTaskScheduler())
+  {
+    scheduler = btGetTBBTaskScheduler();
+    if (!scheduler)
+      scheduler = btGetOpenMPTaskScheduler();
+    if (!scheduler)
+    {
+      if (!defaultScheduler)
+        defaultScheduler = btCreateDefaultTaskScheduler();
+      scheduler = defaultScheduler;
+    }
+    if (!scheduler)
+      return false;
+    btSetTaskScheduler(scheduler);
+  }
+
+  scheduler->setNumThreads(std::min(_threads, scheduler->getMaxNumThreads()));
+  return true;
+}
+#endif
+
 //////////////////////////////////////////////////
 BulletPhysics::BulletPhysics(WorldPtr _world)
     : PhysicsEngine(_world)
@@ -266,9 +299,6 @@ BulletPhysics::BulletPhysics(WorldPtr _world)
   // Default setup for memory and collisions
   this->collisionConfig = new btDefaultCollisionConfiguration();
 
-  // Default collision dispatcher, a multi-threaded dispatcher may be available
-  this->dispatcher = new btCollisionDispatcher(this->collisionConfig);
-
   // Broadphase collision detection uses axis-aligned bounding boxes (AABB)
   // to detect pairs of objects that may be in contact.
   // The narrow-phase collision detection evaluates each pair generated by the
@@ -281,15 +311,7 @@ BulletPhysics::BulletPhysics(WorldPtr _world)
   // Here we are using btDbvtBroadphase.
   this->broadPhase = new btDbvtBroadphase();
 
-  // Create btSequentialImpulseConstraintSolver, the default constraint solver.
-  // Note that a multi-threaded solver may be available.
-  this->solver = new btSequentialImpulseConstraintSolver;
-
-  // Create a btDiscreteDynamicsWorld, which is used for discrete rigid bodies.
-  // An alternative is btSoftRigidDynamicsWorld, which handles both soft and
-  // rigid bodies.
-  this->dynamicsWorld = new btDiscreteDynamicsWorld(this->dispatcher,
-      this->broadPhase, this->solver, this->collisionConfig);
+  this->CreateDynamicsWorld();
 
   btOverlapFilterCallback *filterCallback = new CollisionFilter();
   btOverlappingPairCache* pairCache = this->dynamicsWorld->getPairCache();
@@ -301,14 +323,88 @@ BulletPhysics::BulletPhysics(WorldPtr _world)
   gContactAddedCallback = ContactCallback;
   gContactProcessedCallback = ContactProcessed;
 
-  this->dynamicsWorld->setInternalTickCallback(
-      InternalTickCallback, static_cast<void *>(this));
-
   // Set random seed for physics engine based on gazebo's random seed.
   // Note: this was moved from physics::PhysicsEngine constructor.
   this->SetSeed(ignition::math::Rand::Seed());
+}
+
+//////////////////////////////////////////////////
+void BulletPhysics::CreateDynamicsWorld()
+{
+  // Carry the solver settings over when the world is replaced
+  const bool replace = this->dynamicsWorld != nullptr;
+  btContactSolverInfo info;
+  btVector3 gravity(0, 0, 0);
+  if (replace)
+  {
+    btDiscreteDynamicsWorld *oldWorld = this->dynamicsWorld;
+    info = oldWorld->getSolverInfo();
+    gravity = oldWorld->getGravity();
+  }
+  this->DestroyDynamicsWorld();
+
+#ifdef LIBBULLET_VERSION_GE_288
+  if (this->threadCount > 0)
+  {
+    // The multithreaded dispatcher runs the narrowphase of the overlapping
+    // pairs in parallel, and the world solves islands in parallel with one
+    // solver of the pool per thread.
+    this->dispatcher = new btCollisionDispatcherMt(this->collisionConfig);
+    this->solverMt = new btSequentialImpulseConstraintSolverMt;
+    btConstraintSolverPoolMt *solverPool =
+        new btConstraintSolverPoolMt(this->threadCount);
+    this->solver = solverPool;
+    this->dynamicsWorld = new btDiscreteDynamicsWorldMt(this->dispatcher,
+        this->broadPhase, solverPool, this->solverMt, this->collisionConfig);
+  }
+  else
+#endif
+  {
+    // Default collision dispatcher
+    this->dispatcher = new btCollisionDispatcher(this->collisionConfig);
+
+    // Create btSequentialImpulseConstraintSolver, the default constraint
+    // solver.
+    this->solver = new btSequentialImpulseConstraintSolver;
+
+    // Create a btDiscreteDynamicsWorld, which is used for discrete rigid
+    // bodies. An alternative is btSoftRigidDynamicsWorld, which handles both
+    // soft and rigid bodies.
+    this->dynamicsWorld = new btDiscreteDynamicsWorld(this->dispatcher,
+        this->broadPhase, this->solver, this->collisionConfig);
+  }
+
+  if (replace)
+  {
+    this->dynamicsWorld->getSolverInfo() = info;
+    this->dynamicsWorld->setGravity(gravity);
+  }
+
+  this->dynamicsWorld->setInternalTickCallback(
+      InternalTickCallback, static_cast<void *>(this));
+
+  btGImpactCollisionAlgorithm::registerAlgorithm(this->dispatcher);
+}
+
+//////////////////////////////////////////////////
+void BulletPhysics::DestroyDynamicsWorld()
+{
+  // Delete in reverse-order of creation
+  if (this->dynamicsWorld)
+    delete this->dynamicsWorld;
+  this->dynamicsWorld = nullptr;
+
+  if (this->solverMt)
+    delete this->solverMt;
+  this->solverMt = nullptr;
+
+  if (this->solver)
+    delete this->solver;
+  this->solver = nullptr;
 
-  btGImpactCollisionAlgorithm::registerAlgorithm(dispatcher);
+  if (this->dispatcher)
+    delete this->dispatcher;
+  this->dispatcher = nullptr;
 }
 
 //////////////////////////////////////////////////
@@ -324,6 +420,12 @@ void BulletPhysics::Load(sdf::ElementPtr _sdf)
 
   sdf::ElementPtr bulletElem = this->sdf->GetElement("bullet");
 
+  // Bullet steps on the physics thread unless <gz:thread_count> is set.
+  // This replaces the dynamics world, so it is done before the world is
+  // configured below.
+  if (bulletElem->HasElement("gz:thread_count"))
+    this->SetThreadCount(bulletElem->Get<int>("gz:thread_count"));
+
   auto g = this->world->Gravity();
   // ODEPhysics checks this, so we will too.
   if (g == ignition::math::Vector3d::Zero)
@@ -415,6 +517,7 @@ void BulletPhysics::OnRequest(ConstRequestPtr &_msg)
 
     physicsMsg.set_contact_surface_layer(
       boost::any_cast<double>(this->GetParam("contact_surface_layer")));
+    physicsMsg.set_thread_count(this->threadCount);
 
     physicsMsg.mutable_gravity()->CopyFrom(
       msgs::Convert(this->world->Gravity()));
@@ -462,6 +565,9 @@ void BulletPhysics::OnPhysicsMsg(ConstPhysicsPtr &_msg)
   if (_msg->has_contact_surface_layer())
     this->SetParam("contact_surface_layer", _msg->contact_surface_layer());
 
+  if (_msg->has_thread_count())
+    this->SetParam("thread_count", _msg->thread_count());
+
   if (_msg->has_gravity())
     this->SetGravity(msgs::ConvertIgn(_msg->gravity()));
 
@@ -485,6 +591,7 @@ void BulletPhysics::OnPhysicsMsg(ConstPhysicsPtr &_msg)
 //////////////////////////////////////////////////
 void BulletPhysics::UpdateCollision()
 {
+  GZ_PROFILE("BulletPhysics::UpdateCollision");
   this->contactManager->ResetCount();
 
   if (!this->world->PhysicsEnabled())
@@ -509,6 +616,7 @@ void BulletPhysics::UpdateCollision()
 //////////////////////////////////////////////////
 void BulletPhysics::UpdatePhysics()
 {
+  GZ_PROFILE("BulletPhysics::UpdatePhysics");
   // need to lock, otherwise might conflict with world resetting
   boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
 
@@ -520,22 +628,12 @@ void BulletPhysics::UpdatePhysics()
 void BulletPhysics::Fini()
 {
   // Delete in reverse-order of creation
-  if (this->dynamicsWorld)
-    delete this->dynamicsWorld;
-  this->dynamicsWorld = nullptr;
-
-  if (this->solver)
-    delete this->solver;
-  this->solver = nullptr;
+  this->DestroyDynamicsWorld();
 
   if (this->broadPhase)
     delete this->broadPhase;
   this->broadPhase = nullptr;
 
-  if (this->dispatcher)
-    delete this->dispatcher;
-  this->dispatcher = nullptr;
-
   if (this->collisionConfig)
     delete this->collisionConfig;
   this->collisionConfig = nullptr;
@@ -566,6 +664,64 @@ void BulletPhysics::SetSORPGSIters(unsigned int _iters)
       "solver")->GetElement("iters")->Set(_iters);
 }
 
+//////////////////////////////////////////////////
+bool BulletPhysics::SetLinkContinuousCollision(LinkPtr _link,
+    const bool _enable)
+{
+  BulletLinkPtr link = boost::dynamic_pointer_cast<BulletLink>(_link);
+  if (!link)
+    return false;
+
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+
+  // Links that are not initialized yet set up CCD in BulletLink::Init
+  link->UpdateContinuousCollision(_enable);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool BulletPhysics::SetThreadCount(const int _threads)
+{
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+
+  const int threads = std::max(0, _threads);
+  if (threads == this->threadCount)
+    return true;
+
+#ifdef LIBBULLET_VERSION_GE_288
+  if (threads > 0 && !SetTaskSchedulerThreads(threads))
+  {
+    gzwarn << "Bullet was built without BT_THREADSAFE, "
+           << "thread_count is ignored" << std::endl;
+    return false;
+  }
+
+  // Only a resize of the thread pool once the world is multithreaded
+  if (threads > 0 && this->threadCount > 0)
+  {
+    this->threadCount = threads;
+    return true;
+  }
+
+  // Changing between the sequential and the multithreaded world replaces
+  // the dispatcher and the solver, which bodies and constraints refer to.
+  if (this->dynamicsWorld->getNumCollisionObjects() > 0 ||
+      this->dynamicsWorld->getNumConstraints() > 0)
+  {
+    gzwarn << "thread_count can only be enabled or disabled before models "
+           << "are loaded" << std::endl;
+    return false;
+  }
+
+  this->threadCount = threads;
+  this->CreateDynamicsWorld();
+  return true;
+#else
+  gzwarn << "thread_count requires bullet 2.88 or later" << std::endl;
+  return false;
+#endif
+}
+
 //////////////////////////////////////////////////
 bool BulletPhysics::SetParam(const std::string &_key, const boost::any &_value)
 {
@@ -645,6 +801,10 @@ bool BulletPhysics::SetParam(const std::string &_key, const boost::any &_value)
       double value = any_cast<double>(_value);
       bulletElem->GetElement("solver")->GetElement("min_step_size")->Set(value);
     }
+    else if (_key == "thread_count")
+    {
+      return this->SetThreadCount(any_cast<int>(_value));
+    }
     else
     {
       return PhysicsEngine::SetParam(_key, _value);
@@ -707,6 +867,8 @@ bool BulletPhysics::GetParam(const std::string &_key, boost::any &_value) const
     _value = this->sdf->GetElement("max_contacts")->Get<int>();
   else if (_key == "min_step_size")
     _value = bulletElem->GetElement("solver")->Get<double>("min_step_size");
+  else if (_key == "thread_count")
+    _value = this->threadCount;
   else
   {
     return PhysicsEngine::GetParam(_key, _value);
@@ -172,11 +172,48 @@ namespace gazebo
       // Documentation inherited
       public: virtual void SetSORPGSIters(unsigned int iters);
 
+      // Documentation inherited
+      public: virtual bool SetLinkContinuousCollision(LinkPtr _link,
+                  const bool _enable) override;
+
+      /// \brief Set the number of threads used by the collision dispatcher
+      /// and the constraint solver pool. Switching between sequential and
+      /// multithreaded stepping replaces the dispatcher and the solver, so
+      /// it is only possible before models are loaded. Requires bullet 2.88
+      /// or later, built with BT_THREADSAFE. Same as the "thread_count"
+      /// parameter.
+      /// \param[in] _threads Number of threads, 0 to step on the physics
+      /// thread.
+      /// \return True if the thread count was applied.
+      public: bool SetThreadCount(const int _threads);
+
+      /// \brief Create the collision dispatcher, the constraint solver and
+      /// the dynamics world, sequential or multithreaded depending on the
+      /// thread count. The solver info and gravity of an existing world
+      /// are carried over.
+      private: void CreateDynamicsWorld();
+
+      /// \brief Delete the dynamics world, the constraint solver and the
+      /// collision dispatcher.
+      private: void DestroyDynamicsWorld();
+
       private: btBroadphaseInterface *broadPhase;
       private: btDefaultCollisionConfiguration *collisionConfig;
-      private: btCollisionDispatcher *dispatcher;
-      private: btSequentialImpulseConstraintSolver *solver;
-      private: btDiscreteDynamicsWorld *dynamicsWorld;
+      private: btCollisionDispatcher *dispatcher = nullptr;
+
+      /// \brief Constraint solver of the world. A btConstraintSolverPoolMt
+      /// when the thread count is greater than 0.
+      private: btConstraintSolver *solver = nullptr;
+
+      /// \brief Solver used by the multithreaded world for islands that
+      /// are too large for a single solver of the pool.
+      private: btConstraintSolver *solverMt = nullptr;
+
+      private: btDiscreteDynamicsWorld *dynamicsWorld = nullptr;
+
+      /// \brief Number of threads used to step the world, 0 for
+      /// sequential stepping.
+      private: int threadCount = 0;
 
       private: common::Time lastUpdateTime;
 
@@ -17,6 +17,7 @@
 
 #include <gtest/gtest.h>
 #include <string>
+#include <vector>
 
 #include "gazebo/physics/physics.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
@@ -267,6 +268,81 @@ TEST_F(BulletPhysics_TEST, PhysicsMsgParam)
   PhysicsMsgParam();
 }
 
+/////////////////////////////////////////////////
+/// Test the thread_count parameter
+TEST_F(BulletPhysics_TEST, ThreadCount)
+{
+  Load("worlds/blank.world", true, "bullet");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+
+  // Sequential stepping by default
+  EXPECT_EQ(0, boost::any_cast<int>(physics->GetParam("thread_count")));
+
+  // The world is empty, so it can be made multithreaded if bullet supports
+  // it. Otherwise the thread count stays 0.
+  const bool threaded = physics->SetParam("thread_count", 2);
+  const int threads = threaded ? 2 : 0;
+  EXPECT_EQ(threads, boost::any_cast<int>(physics->GetParam("thread_count")));
+
+  // Drop a box onto a static one and check it comes to rest on it
+  SpawnBox("ground", ignition::math::Vector3d(10, 10, 1),
+      ignition::math::Vector3d(0, 0, -0.5), ignition::math::Vector3d::Zero,
+      true);
+  SpawnBox("box", ignition::math::Vector3d(1, 1, 1),
+      ignition::math::Vector3d(0, 0, 1), ignition::math::Vector3d::Zero);
+  ModelPtr box = world->ModelByName("box");
+  ASSERT_TRUE(box != nullptr);
+
+  // The world is no longer empty, so it stays as it is
+  EXPECT_FALSE(physics->SetParam("thread_count", threaded ? 0 : 2));
+  EXPECT_EQ(threads, boost::any_cast<int>(physics->GetParam("thread_count")));
+
+  world->Step(1000);
+  EXPECT_NEAR(box->WorldPose().Pos().Z(), 0.5, 0.01);
+}
+
+/////////////////////////////////////////////////
+/// A small fast sphere tunnels through a thin wall, unless continuous
+/// collision detection is enabled on its link.
+TEST_F(BulletPhysics_TEST, ContinuousCollision)
+{
+  Load("worlds/blank.world", true, "bullet");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  SpawnBox("wall", ignition::math::Vector3d(0.02, 4, 4),
+      ignition::math::Vector3d(2, 0, 0), ignition::math::Vector3d::Zero,
+      true);
+
+  std::vector<LinkPtr> links;
+  for (const std::string name : {"discrete", "continuous"})
+  {
+    SpawnSphere(name, ignition::math::Vector3d(0, links.empty() ? -1 : 1, 0),
+        ignition::math::Vector3d::Zero, ignition::math::Vector3d::Zero, 0.05);
+    ModelPtr model = world->ModelByName(name);
+    ASSERT_TRUE(model != nullptr);
+    LinkPtr link = model->GetLink();
+    ASSERT_TRUE(link != nullptr);
+    EXPECT_FALSE(link->ContinuousCollision());
+    link->SetGravityMode(false);
+    links.push_back(link);
+  }
+  links[1]->SetContinuousCollision(true);
+  EXPECT_TRUE(links[1]->ContinuousCollision());
+
+  // 0.3m per step jumps over the wall and the sphere
+  for (auto const &link : links)
+    link->SetLinearVel(ignition::math::Vector3d(300, 0, 0));
+
+  world->Step(20);
+  EXPECT_GT(links[0]->WorldPose().Pos().X(), 2.0);
+  EXPECT_LT(links[1]->WorldPose().Pos().X(), 2.0);
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int argc, char **argv)
@@ -62,8 +62,27 @@ void DARTHeightmapShape::Init()
   HeightmapShape::Init();
 
   GZ_ASSERT(this->dataPtr->Shape(), "Shape is NULL");
-  this->dataPtr->Shape()->setHeightField(this->vertSize, this->vertSize,
-                                         this->heights);
+  if (this->Tiled())
+  {
+    // DART keeps its own copy of the heights, so tiling saves no memory.
+    gzwarn << "DART does not support tiled heightmaps, all the heights of ["
+           << this->GetURI() << "] will be kept in memory." << std::endl;
+
+    std::vector<HeightmapShape::HeightType> dense(
+        static_cast<size_t>(this->vertSize) * this->vertSize);
+    for (unsigned int y = 0; y < this->vertSize; ++y)
+    {
+      for (unsigned int x = 0; x < this->vertSize; ++x)
+        dense[y * this->vertSize + x] = this->GetHeight(x, y);
+    }
+    this->dataPtr->Shape()->setHeightField(this->vertSize, this->vertSize,
+                                           dense);
+  }
+  else
+  {
+    this->dataPtr->Shape()->setHeightField(this->vertSize, this->vertSize,
+                                           *this->heights);
+  }
   this->dataPtr->Shape()->setScale(Vector3(this->scale.X(),
                                            this->scale.Y(), 1));
 }
@@ -256,12 +256,21 @@ void DARTLink::Init()
 //////////////////////////////////////////////////
 void DARTLink::Fini()
 {
+  if (this->dataPtr->dartPhysics)
+  {
+    for (auto slaveNode : this->dataPtr->dtSlaveNodes)
+      this->dataPtr->dartPhysics->RemoveBodyNode(slaveNode.first);
+    this->dataPtr->dartPhysics->RemoveBodyNode(this->dataPtr->dtBodyNode);
+  }
+
   Link::Fini();
 }
 
 /////////////////////////////////////////////////////////////////////
 void DARTLink::UpdateMass()
 {
+  this->ResetWorldCache();
+
   if (this->dataPtr->dtBodyNode && this->inertial)
   {
     double nFragments = 1.0 + this->dataPtr->dtSlaveNodes.size();
@@ -965,7 +974,7 @@ void DARTLink::updateDirtyPoseFromDARTTransformation()
 
   // Set the new pose to the world
   // (Below method can be changed in gazebo code)
-  this->world->dataPtr->dirtyPoses.push_back(this);
+  this->world->_AddDirty(this);
 }
 
 //////////////////////////////////////////////////
@@ -996,6 +1005,13 @@ DARTBodyNodePropPtr DARTLink::DARTProperties() const
 //////////////////////////////////////////////////
 void DARTLink::SetDARTBodyNode(dart::dynamics::BodyNode *_dtBodyNode)
 {
+  if (this->dataPtr->dartPhysics)
+  {
+    this->dataPtr->dartPhysics->RemoveBodyNode(this->dataPtr->dtBodyNode);
+    this->dataPtr->dartPhysics->AddBodyNode(_dtBodyNode,
+        boost::static_pointer_cast<DARTLink>(shared_from_this()));
+  }
+
   this->dataPtr->dtBodyNode = _dtBodyNode;
 }
 
@@ -1008,6 +1024,11 @@ void DARTLink::AddSlaveBodyNode(dart::dynamics::BodyNode *_dtBodyNode)
   this->DARTWorld()->getConstraintSolver()->addConstraint(dtWeldJointConst);
   this->dataPtr->dtSlaveNodes.push_back(std::pair<dart::dynamics::BodyNode *,
       dart::constraint::WeldJointConstraintPtr>(_dtBodyNode, dtWeldJointConst));
+  if (this->dataPtr->dartPhysics)
+  {
+    this->dataPtr->dartPhysics->AddBodyNode(_dtBodyNode,
+        boost::static_pointer_cast<DARTLink>(shared_from_this()), true);
+  }
   this->UpdateMass();
 }
 
@@ -1021,6 +1042,8 @@ bool DARTLink::RemoveSlaveBodyNode(dart::dynamics::BodyNode *_dtBodyNode)
     {
       // Remove the weld constraint between the slave and master body nodes
       this->DARTWorld()->getConstraintSolver()->removeConstraint(iter->second);
+      if (this->dataPtr->dartPhysics)
+        this->dataPtr->dartPhysics->RemoveBodyNode(iter->first);
       // Remove the slave body node from the skeleton
       iter->first->remove();
       // Redestribute the link's mass between the remaining body nodes
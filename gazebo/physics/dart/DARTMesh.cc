@@ -15,9 +15,13 @@
  *
 */
 
+#include <functional>
+
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Mesh.hh"
 
+#include "gazebo/physics/MeshDataCache.hh"
+
 #include "gazebo/physics/dart/DARTCollision.hh"
 #include "gazebo/physics/dart/DARTPhysics.hh"
 #include "gazebo/physics/dart/DARTMesh.hh"
@@ -27,6 +31,10 @@
 using namespace gazebo;
 using namespace physics;
 
+/// \brief Mesh shapes shared by the DART meshes with the same key. DART
+/// collision detectors create one collision geometry per shape.
+static MeshDataCache<dart::dynamics::MeshShape> meshShapeCache;
+
 //////////////////////////////////////////////////
 DARTMesh::DARTMesh() : dataPtr(new DARTMeshPrivate())
 {
@@ -42,51 +50,60 @@ DARTMesh::~DARTMesh()
 //////////////////////////////////////////////////
 void DARTMesh::Init(const common::SubMesh *_subMesh,
                     DARTCollisionPtr _collision,
-                    const ignition::math::Vector3d &_scale)
+                    const ignition::math::Vector3d &_scale,
+                    const std::string &_key)
 {
-  float *vertices = nullptr;
-  int *indices = nullptr;
+  std::function<std::shared_ptr<dart::dynamics::MeshShape>()> create = [&]()
+  {
+    float *vertices = nullptr;
+    int *indices = nullptr;
 
-  unsigned int numVertices = _subMesh->GetVertexCount();
-  unsigned int numIndices = _subMesh->GetIndexCount();
+    // Get all the vertex and index data
+    _subMesh->FillArrays(&vertices, &indices);
 
-  // Get all the vertex and index data
-  _subMesh->FillArrays(&vertices, &indices);
+    auto shape = CreateMeshShape(vertices, indices,
+        _subMesh->GetVertexCount(), _subMesh->GetIndexCount(), _scale);
 
-  this->CreateMesh(vertices, indices, numVertices, numIndices,
-                   _collision, _scale);
+    delete [] vertices;
+    delete [] indices;
+    return shape;
+  };
 
-  delete [] vertices;
-  delete [] indices;
+  this->CreateShapeNode(
+      _key.empty() ? create() : meshShapeCache.Get(_key, create), _collision);
 }
 
 //////////////////////////////////////////////////
 void DARTMesh::Init(const common::Mesh *_mesh,
                     DARTCollisionPtr _collision,
-                    const ignition::math::Vector3d &_scale)
+                    const ignition::math::Vector3d &_scale,
+                    const std::string &_key)
 {
-  float *vertices = nullptr;
-  int *indices = nullptr;
+  std::function<std::shared_ptr<dart::dynamics::MeshShape>()> create = [&]()
+  {
+    float *vertices = nullptr;
+    int *indices = nullptr;
+
+    // Get all the vertex and index data
+    _mesh->FillArrays(&vertices, &indices);
 
-  unsigned int numVertices = _mesh->GetVertexCount();
-  unsigned int numIndices = _mesh->GetIndexCount();
+    auto shape = CreateMeshShape(vertices, indices,
+        _mesh->GetVertexCount(), _mesh->GetIndexCount(), _scale);
 
-  // Get all the vertex and index data
-  _mesh->FillArrays(&vertices, &indices);
+    delete [] vertices;
+    delete [] indices;
+    return shape;
+  };
 
-  this->CreateMesh(vertices, indices, numVertices, numIndices,
-                   _collision, _scale);
-  delete [] vertices;
-  delete [] indices;
+  this->CreateShapeNode(
+      _key.empty() ? create() : meshShapeCache.Get(_key, create), _collision);
 }
 
 /////////////////////////////////////////////////
-void DARTMesh::CreateMesh(float *_vertices, int *_indices,
-    unsigned int _numVertices, unsigned int _numIndices,
-    DARTCollisionPtr _collision, const ignition::math::Vector3d &_scale)
+std::shared_ptr<dart::dynamics::MeshShape> DARTMesh::CreateMeshShape(
+    const float *_vertices, const int *_indices, unsigned int _numVertices,
+    unsigned int _numIndices, const ignition::math::Vector3d &_scale)
 {
-  GZ_ASSERT(_collision, "DART collision is null");
-
   // Create new aiScene (aiMesh)
   aiScene *assimpScene = new aiScene;
   aiMesh *assimpMesh = new aiMesh;
@@ -122,8 +139,15 @@ void DARTMesh::CreateMesh(float *_vertices, int *_indices,
     itAIFace->mIndices[2] = _indices[i*3 + 2];
   }
 
-  dart::dynamics::ShapePtr dtMeshShape(new dart::dynamics::MeshShape(
-      DARTTypes::ConvVec3(_scale), assimpScene));
+  return std::make_shared<dart::dynamics::MeshShape>(
+      DARTTypes::ConvVec3(_scale), assimpScene);
+}
+
+/////////////////////////////////////////////////
+void DARTMesh::CreateShapeNode(dart::dynamics::ShapePtr _shape,
+    DARTCollisionPtr _collision)
+{
+  GZ_ASSERT(_collision, "DART collision is null");
   GZ_ASSERT(_collision->DARTBodyNode(),
             "DART _collision->DARTBodyNode() is null");
 
@@ -131,7 +155,7 @@ void DARTMesh::CreateMesh(float *_vertices, int *_indices,
     _collision->DARTBodyNode()->createShapeNodeWith<
       dart::dynamics::VisualAspect,
       dart::dynamics::CollisionAspect,
-      dart::dynamics::DynamicsAspect>(dtMeshShape);
+      dart::dynamics::DynamicsAspect>(_shape);
 
   this->dataPtr->dtMeshShape.set(node);
 }
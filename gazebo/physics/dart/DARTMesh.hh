@@ -18,6 +18,9 @@
 #ifndef GAZEBO_PHYSICS_DART_DARTMESH_HH_
 #define GAZEBO_PHYSICS_DART_DARTMESH_HH_
 
+#include <memory>
+#include <string>
+
 #include <ignition/math/Vector3.hh>
 
 #include "gazebo/physics/dart/DARTTypes.hh"
@@ -47,32 +50,49 @@ namespace gazebo
       /// \param[in] _subMesh Pointer to the submesh.
       /// \param[in] _collision Pointer to the collision object.
       /// \param[in] _scale Scaling factor.
+      /// \param[in] _key Key of the mesh shape, see
+      /// MeshShape::CollisionMeshKey. Meshes with the same key share their
+      /// DART mesh shape, and its collision geometry. Empty to not share it.
       public: void Init(const common::SubMesh *_subMesh,
                       DARTCollisionPtr _collision,
-                      const ignition::math::Vector3d &_scale);
+                      const ignition::math::Vector3d &_scale,
+                      const std::string &_key = "");
 
       /// \brief Create a mesh collision shape using a mesh.
       /// \param[in] _mesh Pointer to the mesh.
       /// \param[in] _collision Pointer to the collision object.
       /// \param[in] _scale Scaling factor.
+      /// \param[in] _key Key of the mesh shape, see
+      /// MeshShape::CollisionMeshKey. Meshes with the same key share their
+      /// DART mesh shape, and its collision geometry. Empty to not share it.
       public: void Init(const common::Mesh *_mesh,
                       DARTCollisionPtr _collision,
-                      const ignition::math::Vector3d &_scale);
+                      const ignition::math::Vector3d &_scale,
+                      const std::string &_key = "");
 
       /// \brief Returns the DART mesh shape node
       public: dart::dynamics::ShapeNodePtr ShapeNode() const;
 
-      /// \brief Helper function to create the collision shape.
+      /// \brief Helper function to create the DART mesh shape.
       /// \param[in] _vertices Array of vertices.
       /// \param[in] _indices Array of indices.
       /// \param[in] _numVertices Number of vertices.
       /// \param[in] _numIndices Number of indices.
-      /// \param[in] _collision Pointer to the collision object.
-      private: void CreateMesh(float *_vertices, int *_indices,
-                   unsigned int _numVertices, unsigned int _numIndices,
-                   DARTCollisionPtr _collision,
+      /// \param[in] _scale Scaling factor.
+      /// \return The mesh shape.
+      private: static std::shared_ptr<dart::dynamics::MeshShape>
+                   CreateMeshShape(const float *_vertices,
+                   const int *_indices, unsigned int _numVertices,
+                   unsigned int _numIndices,
                    const ignition::math::Vector3d &_scale);
 
+      /// \brief Helper function to create the collision shape node.
+      /// \param[in] _shape The DART mesh shape, possibly shared with other
+      /// meshes.
+      /// \param[in] _collision Pointer to the collision object.
+      private: void CreateShapeNode(dart::dynamics::ShapePtr _shape,
+                   DARTCollisionPtr _collision);
+
       /// \internal
       /// \brief Pointer to private data
       private: DARTMeshPrivate *dataPtr;
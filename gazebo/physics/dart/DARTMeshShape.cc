@@ -66,7 +66,8 @@ void DARTMeshShape::Init()
   {
     this->dataPtr->dartMesh->Init(this->submesh,
         boost::dynamic_pointer_cast<DARTCollision>(this->collisionParent),
-        this->sdf->Get<ignition::math::Vector3d>("scale"));
+        this->sdf->Get<ignition::math::Vector3d>("scale"),
+        this->CollisionMeshKey());
   }
   else
   {
@@ -77,7 +78,8 @@ void DARTMeshShape::Init()
     }
     this->dataPtr->dartMesh->Init(this->mesh,
         boost::dynamic_pointer_cast<DARTCollision>(this->collisionParent),
-        this->sdf->Get<ignition::math::Vector3d>("scale"));
+        this->sdf->Get<ignition::math::Vector3d>("scale"),
+        this->CollisionMeshKey());
   }
 
   BasePtr _parent = GetParent();
@@ -15,6 +15,8 @@
  *
 */
 
+#include <algorithm>
+
 // required for HAVE_DART_BULLET define
 #include <gazebo/gazebo_config.h>
 
@@ -28,6 +30,7 @@
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
+#include "gazebo/common/Profiler.hh"
 
 #include "gazebo/transport/Publisher.hh"
 
@@ -59,6 +62,7 @@
 #include "gazebo/physics/dart/DARTMultiRayShape.hh"
 #include "gazebo/physics/dart/DARTHeightmapShape.hh"
 
+#include "gazebo/physics/dart/DARTCollision.hh"
 #include "gazebo/physics/dart/DARTModel.hh"
 #include "gazebo/physics/dart/DARTLink.hh"
 
@@ -71,6 +75,98 @@ using namespace physics;
 
 GZ_REGISTER_PHYSICS_ENGINE("dart", DARTPhysics)
 
+// Contact surface handlers were added in DART 6.10
+#if DART_MAJOR_MINOR_VERSION_AT_LEAST(6, 10)
+namespace
+{
+  /// \brief Drives the surface of the contacts of tracks along their belt,
+  /// see FrictionPyramid::SetTrackAxis.
+  class TrackContactSurfaceHandler
+    : public dart::constraint::ContactSurfaceHandler
+  {
+    /// \brief Constructor.
+    /// \param[in] _physics Physics engine, to find the links of contacts.
+    public: explicit TrackContactSurfaceHandler(DARTPhysics *_physics)
+            : physics(_physics)
+            {
+            }
+
+    // Documentation inherited
+    public: dart::constraint::ContactSurfaceParams createParams(
+                const dart::collision::Contact &_contact,
+                const size_t _numContactsOnCollisionObject) const override
+            {
+              dart::constraint::ContactSurfaceParams params =
+                ContactSurfaceHandler::createParams(_contact,
+                    _numContactsOnCollisionObject);
+
+              // The velocity is the one of the first body relative to the
+              // second one
+              int sign = -1;
+              for (auto object : {_contact.collisionObject1,
+                  _contact.collisionObject2})
+              {
+                const DARTCollision *collision = this->Find(object);
+                if (collision)
+                {
+                  ignition::math::Vector3d direction;
+                  double velocity;
+                  if (collision->GetSurface()->FrictionPyramid()->
+                      TrackContact(collision->WorldPose(),
+                        ignition::math::Vector3d(_contact.point.x(),
+                          _contact.point.y(), _contact.point.z()),
+                        ignition::math::Vector3d(_contact.normal.x(),
+                          _contact.normal.y(), _contact.normal.z()),
+                        direction, velocity))
+                  {
+                    params.mFirstFrictionalDirection = Eigen::Vector3d(
+                        direction.X(), direction.Y(), direction.Z());
+                    params.mContactSurfaceMotionVelocity =
+                      Eigen::Vector3d(sign * velocity, 0, 0);
+                    break;
+                  }
+                }
+                sign = -sign;
+              }
+              return params;
+            }
+
+    /// \brief Find the collision of a DART collision object.
+    /// \param[in] _object The collision object.
+    /// \return The collision, or null.
+    private: const DARTCollision *Find(
+                 const dart::collision::CollisionObject *_object) const
+             {
+               const dart::dynamics::ShapeNode *shapeNode =
+                 _object->getShapeFrame()->asShapeNode();
+               if (!shapeNode)
+                 return nullptr;
+
+               DARTLinkPtr link =
+                 this->physics->FindDARTLink(shapeNode->getBodyNodePtr());
+               if (!link)
+                 return nullptr;
+
+               for (auto const &collision : link->GetCollisions())
+               {
+                 const DARTCollision *dartCollision =
+                   dynamic_cast<const DARTCollision *>(collision.get());
+                 if (dartCollision &&
+                     dartCollision->DARTCollisionShapeNode().get() ==
+                     shapeNode)
+                 {
+                   return dartCollision;
+                 }
+               }
+               return nullptr;
+             }
+
+    /// \brief Physics engine.
+    private: DARTPhysics *physics;
+  };
+}
+#endif
+
 //////////////////////////////////////////////////
 DARTPhysics::DARTPhysics(WorldPtr _world)
     : PhysicsEngine(_world), dataPtr(new DARTPhysicsPrivate())
@@ -109,11 +205,18 @@ std::string DARTPhysics::CollisionDetectorInUse() const
 //////////////////////////////////////////////////
 void DARTPhysics::Init()
 {
+#if DART_MAJOR_MINOR_VERSION_AT_LEAST(6, 10)
+  this->dataPtr->dtWorld->getConstraintSolver()->addContactSurfaceHandler(
+      std::make_shared<TrackContactSurfaceHandler>(this));
+#endif
 }
 
 //////////////////////////////////////////////////
 void DARTPhysics::Fini()
 {
+  this->dataPtr->linksByBodyNode.clear();
+  this->dataPtr->links.clear();
+
   PhysicsEngine::Fini();
 }
 
@@ -305,8 +408,8 @@ static void RetrieveDARTCollisions(
     GZ_ASSERT(dtBodyNode1, "body node 1 is null!");
     GZ_ASSERT(dtBodyNode2, "body node 2 is null!");
 
-    DARTLinkPtr dartLink1 = StaticFindDARTLink(_dtPhysics, dtBodyNode1);
-    DARTLinkPtr dartLink2 = StaticFindDARTLink(_dtPhysics, dtBodyNode2);
+    DARTLinkPtr dartLink1 = _dtPhysics->FindDARTLink(dtBodyNode1.get());
+    DARTLinkPtr dartLink2 = _dtPhysics->FindDARTLink(dtBodyNode2.get());
 
     GZ_ASSERT(dartLink1, "dartLink1 in collision pair is null");
     GZ_ASSERT(dartLink2, "dartLink2 in collision pair is null");
@@ -411,6 +514,7 @@ static void RetrieveDARTCollisions(
 //////////////////////////////////////////////////
 void DARTPhysics::UpdateCollision()
 {
+  GZ_PROFILE("DARTPhysics::UpdateCollision");
   if (!this->world->PhysicsEnabled())
   {
     dart::collision::CollisionResult localResult;
@@ -432,6 +536,7 @@ void DARTPhysics::UpdateCollision()
 //////////////////////////////////////////////////
 void DARTPhysics::UpdatePhysics()
 {
+  GZ_PROFILE("DARTPhysics::UpdatePhysics");
   // need to lock, otherwise might conflict with world resetting
   boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
 
@@ -442,25 +547,8 @@ void DARTPhysics::UpdatePhysics()
         this->dataPtr->resetAllForcesAfterSimulationStep);
 
   // Update all the transformation of DART's links to gazebo's links
-  // TODO: How to visit all the links in the world?
-  unsigned int modelCount = this->world->ModelCount();
-  ModelPtr modelItr;
-
-  for (unsigned int i = 0; i < modelCount; ++i)
-  {
-    modelItr = this->world->ModelByIndex(i);
-    // TODO: need to improve speed
-    Link_V links = modelItr->GetLinks();
-    unsigned int linkCount = links.size();
-    DARTLinkPtr dartLinkItr;
-
-    for (unsigned int j = 0; j < linkCount; ++j)
-    {
-      dartLinkItr
-          = boost::dynamic_pointer_cast<DARTLink>(links.at(j));
-      dartLinkItr->updateDirtyPoseFromDARTTransformation();
-    }
-  }
+  for (const auto &dartLink : this->dataPtr->links)
+    dartLink->updateDirtyPoseFromDARTTransformation();
 
   RetrieveDARTCollisions(
         this,
@@ -878,6 +966,49 @@ void DARTPhysics::OnPhysicsMsg(ConstPhysicsPtr& _msg)
 DARTLinkPtr DARTPhysics::FindDARTLink(
     const dart::dynamics::BodyNode *_dtBodyNode)
 {
-  return StaticFindDARTLink(this, _dtBodyNode);
+  auto iter = this->dataPtr->linksByBodyNode.find(_dtBodyNode);
+  if (iter != this->dataPtr->linksByBodyNode.end())
+    return iter->second;
+
+  // BodyNodes are normally added by their links, search the models
+  // otherwise and remember the result.
+  DARTLinkPtr res = StaticFindDARTLink(this, _dtBodyNode);
+  if (res)
+    this->dataPtr->linksByBodyNode[_dtBodyNode] = res;
+  return res;
+}
+
+//////////////////////////////////////////////////
+void DARTPhysics::AddBodyNode(const dart::dynamics::BodyNode *_dtBodyNode,
+    DARTLinkPtr _dartLink, const bool _slave)
+{
+  if (!_dtBodyNode || !_dartLink)
+    return;
+
+  this->dataPtr->linksByBodyNode[_dtBodyNode] = _dartLink;
+
+  if (!_slave && std::find(this->dataPtr->links.begin(),
+        this->dataPtr->links.end(), _dartLink) == this->dataPtr->links.end())
+  {
+    this->dataPtr->links.push_back(_dartLink);
+  }
+}
+
+//////////////////////////////////////////////////
+void DARTPhysics::RemoveBodyNode(const dart::dynamics::BodyNode *_dtBodyNode)
+{
+  auto iter = this->dataPtr->linksByBodyNode.find(_dtBodyNode);
+  if (iter == this->dataPtr->linksByBodyNode.end())
+    return;
+
+  DARTLinkPtr dartLink = iter->second;
+  this->dataPtr->linksByBodyNode.erase(iter);
+
+  // Only the master BodyNode of a link is in the list of links
+  if (dartLink->DARTBodyNode() == _dtBodyNode)
+  {
+    this->dataPtr->links.erase(std::remove(this->dataPtr->links.begin(),
+          this->dataPtr->links.end(), dartLink), this->dataPtr->links.end());
+  }
 }
 
@@ -159,18 +159,32 @@ namespace gazebo
       /// detector has been loaded yet, the empty string is returned.
       public: std::string CollisionDetectorInUse() const;
 
+      /// \brief Find DART Link corresponding to DART BodyNode.
+      /// \param[in] _dtBodyNode The DART BodyNode.
+      /// \return Pointer to the DART Link.
+      public: DARTLinkPtr FindDARTLink(
+          const dart::dynamics::BodyNode *_dtBodyNode);
+
+      /// \brief Associate a DART BodyNode with the link that owns it. Called
+      /// by DARTLink when its BodyNodes are created, so that contacts and
+      /// pose updates don't have to search all models every step.
+      /// \param[in] _dtBodyNode The DART BodyNode.
+      /// \param[in] _dartLink The link owning the BodyNode.
+      /// \param[in] _slave True if the BodyNode is a slave of _dartLink,
+      /// which closes a kinematic loop.
+      public: void AddBodyNode(const dart::dynamics::BodyNode *_dtBodyNode,
+          DARTLinkPtr _dartLink, const bool _slave = false);
+
+      /// \brief Remove a DART BodyNode added with AddBodyNode.
+      /// \param[in] _dtBodyNode The DART BodyNode.
+      public: void RemoveBodyNode(const dart::dynamics::BodyNode *_dtBodyNode);
+
       // Documentation inherited
       protected: virtual void OnRequest(ConstRequestPtr &_msg);
 
       // Documentation inherited
       protected: virtual void OnPhysicsMsg(ConstPhysicsPtr &_msg);
 
-      /// \brief Find DART Link corresponding to DART BodyNode.
-      /// \param[in] _dtBodyNode The DART BodyNode.
-      /// \return Pointer to the DART Link.
-      private: DARTLinkPtr FindDARTLink(
-          const dart::dynamics::BodyNode *_dtBodyNode);
-
       /// \internal
       /// \brief Pointer to private data.
       private: DARTPhysicsPrivate *dataPtr = nullptr;
@@ -18,7 +18,11 @@
 #ifndef _GAZEBO_DARTPHYSICS_PRIVATE_HH_
 #define _GAZEBO_DARTPHYSICS_PRIVATE_HH_
 
+#include <unordered_map>
+#include <vector>
+
 #include "gazebo/physics/dart/dart_inc.h"
+#include "gazebo/physics/dart/DARTTypes.hh"
 
 namespace gazebo
 {
@@ -50,6 +54,15 @@ namespace gazebo
       /// and torques (both internal and external) after completing a simulation
       /// step. Default value is true.
       public: bool resetAllForcesAfterSimulationStep;
+
+      /// \brief Links by the DART BodyNodes they own, including the slave
+      /// BodyNodes of kinematic loops. Used to find the links of contacts.
+      public: std::unordered_map<const dart::dynamics::BodyNode *,
+              DARTLinkPtr> linksByBodyNode;
+
+      /// \brief Links whose pose is updated after each step, in the order
+      /// their BodyNodes were added.
+      public: std::vector<DARTLinkPtr> links;
     };
   }
 }
@@ -49,6 +49,10 @@ ODECollision::ODECollision(LinkPtr _link)
 //////////////////////////////////////////////////
 ODECollision::~ODECollision()
 {
+  for (auto geomId : this->subCollisionIds)
+    dGeomDestroy(geomId);
+  this->subCollisionIds.clear();
+
   if (this->collisionId)
     dGeomDestroy(this->collisionId);
   this->collisionId = nullptr;
@@ -138,6 +142,27 @@ dGeomID ODECollision::GetCollisionId() const
   return this->collisionId;
 }
 
+//////////////////////////////////////////////////
+void ODECollision::AddSubCollision(dGeomID _geomId)
+{
+  if (!_geomId)
+    return;
+
+  this->subCollisionIds.push_back(_geomId);
+  if (this->collisionId)
+  {
+    dGeomSetCategoryBits(_geomId, dGeomGetCategoryBits(this->collisionId));
+    dGeomSetCollideBits(_geomId, dGeomGetCollideBits(this->collisionId));
+  }
+  dGeomSetData(_geomId, this);
+}
+
+//////////////////////////////////////////////////
+const std::vector<dGeomID> &ODECollision::SubCollisionIds() const
+{
+  return this->subCollisionIds;
+}
+
 //////////////////////////////////////////////////
 int ODECollision::GetCollisionClass() const
 {
@@ -156,6 +181,8 @@ void ODECollision::SetCategoryBits(unsigned int _bits)
 {
   if (this->collisionId)
     dGeomSetCategoryBits(this->collisionId, _bits);
+  for (auto geomId : this->subCollisionIds)
+    dGeomSetCategoryBits(geomId, _bits);
   if (this->spaceId)
     dGeomSetCategoryBits((dGeomID)this->spaceId, _bits);
 }
@@ -165,6 +192,8 @@ void ODECollision::SetCollideBits(unsigned int _bits)
 {
   if (this->collisionId)
     dGeomSetCollideBits(this->collisionId, _bits);
+  for (auto geomId : this->subCollisionIds)
+    dGeomSetCollideBits(geomId, _bits);
   if (this->spaceId)
     dGeomSetCollideBits((dGeomID)this->spaceId, _bits);
 }
@@ -182,6 +211,14 @@ ignition::math::AxisAlignedBox ODECollision::BoundingBox() const
       ignition::math::Vector3d(aabb[0], aabb[2], aabb[4]),
       ignition::math::Vector3d(aabb[1], aabb[3], aabb[5]));
 
+  for (auto geomId : this->subCollisionIds)
+  {
+    dGeomGetAABB(geomId, aabb);
+    box.Merge(ignition::math::AxisAlignedBox(
+        ignition::math::Vector3d(aabb[0], aabb[2], aabb[4]),
+        ignition::math::Vector3d(aabb[1], aabb[3], aabb[5])));
+  }
+
   return box;
 }
 
@@ -227,6 +264,12 @@ void ODECollision::OnPoseChangeGlobal()
   dGeomSetPosition(this->collisionId, localPose.Pos().X(),
       localPose.Pos().Y(), localPose.Pos().Z());
   dGeomSetQuaternion(this->collisionId, q);
+  for (auto geomId : this->subCollisionIds)
+  {
+    dGeomSetPosition(geomId, localPose.Pos().X(),
+        localPose.Pos().Y(), localPose.Pos().Z());
+    dGeomSetQuaternion(geomId, q);
+  }
 }
 
 /////////////////////////////////////////////////
@@ -254,6 +297,12 @@ void ODECollision::OnPoseChangeRelative()
   dGeomSetOffsetPosition(this->collisionId,
       localPose.Pos().X(), localPose.Pos().Y(), localPose.Pos().Z());
   dGeomSetOffsetQuaternion(this->collisionId, q);
+  for (auto geomId : this->subCollisionIds)
+  {
+    dGeomSetOffsetPosition(geomId,
+        localPose.Pos().X(), localPose.Pos().Y(), localPose.Pos().Z());
+    dGeomSetOffsetQuaternion(geomId, q);
+  }
 }
 
 /////////////////////////////////////////////////
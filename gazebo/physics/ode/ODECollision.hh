@@ -22,6 +22,8 @@
 #ifndef _ODECOLLISION_HH_
 #define _ODECOLLISION_HH_
 
+#include <vector>
+
 #include "gazebo/physics/ode/ode_inc.h"
 
 #include "gazebo/physics/PhysicsTypes.hh"
@@ -61,6 +63,16 @@ namespace gazebo
       /// \return The collision id.
       public: dGeomID GetCollisionId() const;
 
+      /// \brief Add a geom which moves and collides as part of this
+      /// collision, for shapes made of several ODE geoms. The geom must be
+      /// in the collision's space, and it is destroyed with the collision.
+      /// \param[in] _geomId ODE id of the geom.
+      public: void AddSubCollision(dGeomID _geomId);
+
+      /// \brief Get the geoms added with AddSubCollision.
+      /// \return The ODE ids of the geoms.
+      public: const std::vector<dGeomID> &SubCollisionIds() const;
+
       /// \brief Get the ODE collision class.
       /// \return The ODE collision class.
       public: int GetCollisionClass() const;
@@ -105,6 +117,10 @@ namespace gazebo
       /// \brief ID for the collision.
       protected: dGeomID collisionId;
 
+      /// \brief Geoms which are part of this collision, in addition to
+      /// collisionId.
+      private: std::vector<dGeomID> subCollisionIds;
+
       /// \brief Function used to set the pose of the ODE object.
       private: void (ODECollision::*onPoseChangeFunc)();
     };
@@ -138,6 +138,12 @@ void ODEJoint::Load(sdf::ElementPtr _sdf)
   }
 }
 
+//////////////////////////////////////////////////
+dJointID ODEJoint::GetODEId() const
+{
+  return this->jointId;
+}
+
 //////////////////////////////////////////////////
 LinkPtr ODEJoint::GetJointLink(unsigned int _index) const
 {
@@ -632,6 +638,7 @@ void ODEJoint::Reset()
     gzerr << "ODE Joint ID is invalid\n";
 
   this->forceAppliedTime = common::Time::Zero;
+  this->wrenchValid = false;
 
   Joint::Reset();
 }
@@ -645,6 +652,11 @@ void ODEJoint::CacheForceTorque()
 //////////////////////////////////////////////////
 JointWrench ODEJoint::GetForceTorque(unsigned int /*_index*/)
 {
+  // The feedback only changes when the world steps
+  uint32_t iteration = this->GetWorld()->Iterations();
+  if (this->wrenchValid && this->wrenchIteration == iteration)
+    return this->wrench;
+
   // Note that:
   // f2, t2 are the force torque measured on parent body's cg
   // f1, t1 are the force torque measured on child body's cg
@@ -833,6 +845,8 @@ JointWrench ODEJoint::GetForceTorque(unsigned int /*_index*/)
       }
     }
     this->wrench = this->wrench - wrenchAppliedWorld;
+    this->wrenchValid = true;
+    this->wrenchIteration = iteration;
   }
   else
   {
@@ -1111,6 +1125,13 @@ void ODEJoint::SetProvideFeedback(bool _enable)
     else
       gzerr << "ODE Joint ID is invalid\n";
   }
+  else if (this->jointId)
+  {
+    // ODE skips the feedback of the joint once no one needs it
+    dJointSetFeedback(this->jointId, nullptr);
+  }
+
+  this->wrenchValid = false;
 }
 
 //////////////////////////////////////////////////
@@ -1142,6 +1163,9 @@ void ODEJoint::SaveForce(unsigned int _index, double _force)
     }
 
     this->forceApplied[_index] += _force;
+
+    // The applied forces are part of the wrench
+    this->wrenchValid = false;
   }
   else
     gzerr << "Something's wrong, joint [" << this->GetScopedName()
@@ -64,6 +64,10 @@ namespace gazebo
       // Documentation inherited.
       public: virtual LinkPtr GetJointLink(unsigned int _index) const override;
 
+      /// \brief Get the ODE joint id.
+      /// \return The ODE joint id, or nullptr if the joint wasn't created.
+      public: dJointID GetODEId() const;
+
       // Documentation inherited.
       public: virtual bool AreConnected(LinkPtr _one, LinkPtr _two) const
             override;
@@ -241,7 +245,11 @@ namespace gazebo
       // Documentation inherited.
       public: virtual void SetProvideFeedback(bool _enable) override;
 
-      // Documentation inherited.
+      /// \brief Get the force and torque of the joint. They are computed
+      /// from the ODE feedback on the first call of each iteration, the
+      /// following calls return the same wrench.
+      /// \param[in] _index Not used.
+      /// \return The wrench, zero if the joint provides no feedback.
       public: virtual JointWrench GetForceTorque(unsigned int _index) override;
 
       // Documentation inherited.
@@ -296,6 +304,13 @@ namespace gazebo
       /// \brief Save time at which force is applied by user
       /// This will let us know if it's time to clean up forceApplied.
       private: common::Time forceAppliedTime;
+
+      /// \brief True if wrench holds the force and torque of
+      /// wrenchIteration.
+      private: bool wrenchValid = false;
+
+      /// \brief World iteration at which wrench was computed.
+      private: uint32_t wrenchIteration = 0;
     };
     /// \}
   }
@@ -101,6 +101,8 @@ void ODELink::Init()
         if (g->IsPlaceable() && g->GetCollisionId())
         {
           dGeomSetBody(g->GetCollisionId(), this->linkId);
+          for (auto geomId : g->SubCollisionIds())
+            dGeomSetBody(geomId, this->linkId);
         }
       }
     }
@@ -140,28 +142,8 @@ void ODELink::DisabledCallback(dBodyID /*_id*/)
 //////////////////////////////////////////////////
 void ODELink::MoveCallback(dBodyID _id)
 {
-  const dReal *p;
-  const dReal *r;
   ODELink *self = static_cast<ODELink*>(dBodyGetData(_id));
-  // self->poseMutex->lock();
-
-  p = dBodyGetPosition(_id);
-  r = dBodyGetQuaternion(_id);
-
-  self->dirtyPose.Pos().Set(p[0], p[1], p[2]);
-  self->dirtyPose.Rot().Set(r[0], r[1], r[2], r[3]);
-
-  // subtracting cog location from ode pose
-  GZ_ASSERT(self->inertial != nullptr, "Inertial pointer is null");
-  ignition::math::Vector3d cog = self->dirtyPose.Rot().RotateVector(
-      self->inertial->CoG());
-
-  self->dirtyPose.Pos() -= cog;
-
-  // Tell the world that our pose has changed.
-  self->world->_AddDirty(self);
-
-  // self->poseMutex->unlock();
+  self->SyncBodyPose();
 
   // get force and applied to this body
   if (_id)
@@ -174,6 +156,29 @@ void ODELink::MoveCallback(dBodyID _id)
   }
 }
 
+//////////////////////////////////////////////////
+void ODELink::SyncBodyPose()
+{
+  if (!this->linkId)
+    return;
+
+  const dReal *p = dBodyGetPosition(this->linkId);
+  const dReal *r = dBodyGetQuaternion(this->linkId);
+
+  this->dirtyPose.Pos().Set(p[0], p[1], p[2]);
+  this->dirtyPose.Rot().Set(r[0], r[1], r[2], r[3]);
+
+  // subtracting cog location from ode pose
+  GZ_ASSERT(this->inertial != nullptr, "Inertial pointer is null");
+  ignition::math::Vector3d cog = this->dirtyPose.Rot().RotateVector(
+      this->inertial->CoG());
+
+  this->dirtyPose.Pos() -= cog;
+
+  // Tell the world that our pose has changed.
+  this->world->_AddDirty(this);
+}
+
 //////////////////////////////////////////////////
 void ODELink::Fini()
 {
@@ -336,6 +341,12 @@ void ODELink::UpdateCollisionOffsets()
           dGeomSetOffsetPosition(g->GetCollisionId(),
               localPose.Pos().X(), localPose.Pos().Y(), localPose.Pos().Z());
           dGeomSetOffsetQuaternion(g->GetCollisionId(), q);
+          for (auto geomId : g->SubCollisionIds())
+          {
+            dGeomSetOffsetPosition(geomId, localPose.Pos().X(),
+                localPose.Pos().Y(), localPose.Pos().Z());
+            dGeomSetOffsetQuaternion(geomId, q);
+          }
         }
       }
     }
@@ -382,6 +393,8 @@ void ODELink::UpdateSurface()
 /////////////////////////////////////////////////////////////////////
 void ODELink::UpdateMass()
 {
+  this->ResetWorldCache();
+
   if (!this->linkId)
   {
     if (!this->IsStatic() && this->initialized)
@@ -179,6 +179,10 @@ namespace gazebo
       /// \param[in] _id Id of the body.
       public: static void MoveCallback(dBodyID _id);
 
+      /// \brief Update the link pose from its body, after the body was
+      /// moved outside of a world step.
+      public: void SyncBodyPose();
+
       // Documentation inherited
       public: virtual void SetLinkStatic(bool _static);
 
@@ -14,10 +14,26 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "gazebo/gazebo_config.h"
+
+#ifdef HAVE_FCL
+#include <fcl/BVH_model.h>
+#include <fcl/collision.h>
+#endif
+
 #include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshDistanceField.hh"
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Console.hh"
 
+#include "gazebo/physics/MeshDataCache.hh"
 #include "gazebo/physics/ode/ODECollision.hh"
 #include "gazebo/physics/ode/ODEPhysics.hh"
 #include "gazebo/physics/ode/ODEMesh.hh"
@@ -25,25 +41,509 @@
 using namespace gazebo;
 using namespace physics;
 
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief Scaled vertices, indices and ODE trimesh data of a mesh.
+    /// ODE allows several trimesh geoms to use the same data, which
+    /// includes the OPCODE bounding volume tree.
+    class ODEMeshData
+    {
+      /// \brief Destructor.
+      public: ~ODEMeshData()
+      {
+        if (this->odeData)
+          dGeomTriMeshDataDestroy(this->odeData);
+        delete [] this->vertices;
+        delete [] this->indices;
+      }
+
+      /// \brief Scale the vertices and build the ODE trimesh data.
+      /// \param[in] _numVertices Number of vertices.
+      /// \param[in] _numIndices Number of indices.
+      /// \param[in] _scale Scaling factor.
+      public: void Build(unsigned int _numVertices, unsigned int _numIndices,
+                  const ignition::math::Vector3d &_scale)
+      {
+        // Scale the vertex data
+        for (unsigned int j = 0;  j < _numVertices; j++)
+        {
+          this->vertices[j*3+0] = this->vertices[j*3+0] * _scale.X();
+          this->vertices[j*3+1] = this->vertices[j*3+1] * _scale.Y();
+          this->vertices[j*3+2] = this->vertices[j*3+2] * _scale.Z();
+        }
+
+        this->vertexCount = _numVertices;
+        this->indexCount = _numIndices;
+
+        // Build the ODE triangle mesh
+        this->odeData = dGeomTriMeshDataCreate();
+        dGeomTriMeshDataBuildSingle(this->odeData,
+            this->vertices, 3*sizeof(this->vertices[0]), _numVertices,
+            this->indices, _numIndices, 3*sizeof(this->indices[0]));
+      }
+
+      /// \brief Array of vertex values.
+      public: float *vertices = nullptr;
+
+      /// \brief Array of index values.
+      public: int *indices = nullptr;
+
+      /// \brief Number of vertices.
+      public: unsigned int vertexCount = 0;
+
+      /// \brief Number of indices.
+      public: unsigned int indexCount = 0;
+
+      /// \brief ODE trimesh data.
+      public: dTriMeshDataID odeData = nullptr;
+    };
+
+    /// \internal
+    /// \brief Scaled convex hulls in the layout of ODE convex geoms, which
+    /// keep pointers to the arrays.
+    class ODEConvexData
+    {
+      /// \brief Convex hull of an ODE convex geom.
+      public: struct Hull
+      {
+        /// \brief Normal and distance to the origin of each face.
+        std::vector<dReal> planes;
+
+        /// \brief Coordinates of the points.
+        std::vector<dReal> points;
+
+        /// \brief Number of points of each face followed by their
+        /// indices, counter-clockwise seen from outside.
+        std::vector<unsigned int> polygons;
+      };
+
+      /// \brief Scale the hulls and convert them.
+      /// \param[in] _hulls Mesh with one hull per submesh.
+      /// \param[in] _scale Scaling factor.
+      public: void Build(const common::Mesh &_hulls,
+                  const ignition::math::Vector3d &_scale)
+      {
+        // A mirroring scale turns the faces inside out
+        const bool flip = _scale.X() * _scale.Y() * _scale.Z() < 0;
+
+        for (unsigned int i = 0; i < _hulls.GetSubMeshCount(); ++i)
+        {
+          const common::SubMesh *subMesh = _hulls.GetSubMesh(i);
+          std::vector<ignition::math::Vector3d> vertices;
+          Hull hull;
+          for (unsigned int j = 0; j < subMesh->GetVertexCount(); ++j)
+          {
+            vertices.push_back(subMesh->Vertex(j) * _scale);
+            hull.points.insert(hull.points.end(), {vertices.back().X(),
+                vertices.back().Y(), vertices.back().Z()});
+          }
+
+          for (unsigned int j = 0; j + 2 < subMesh->GetIndexCount(); j += 3)
+          {
+            unsigned int a = subMesh->GetIndex(j);
+            unsigned int b = subMesh->GetIndex(j + (flip ? 2 : 1));
+            unsigned int c = subMesh->GetIndex(j + (flip ? 1 : 2));
+            if (a >= vertices.size() || b >= vertices.size() ||
+                c >= vertices.size())
+            {
+              continue;
+            }
+
+            ignition::math::Vector3d normal =
+                (vertices[b] - vertices[a]).Cross(vertices[c] - vertices[a]);
+            if (normal.Length() <= 0.0)
+              continue;
+            normal.Normalize();
+            hull.planes.insert(hull.planes.end(), {normal.X(), normal.Y(),
+                normal.Z(), normal.Dot(vertices[a])});
+            hull.polygons.insert(hull.polygons.end(), {3u, a, b, c});
+          }
+
+          // A hull needs at least a tetrahedron
+          if (hull.planes.size() >= 16u)
+            this->hulls.push_back(hull);
+        }
+      }
+
+      /// \brief The hulls.
+      public: std::vector<Hull> hulls;
+    };
+
+    /// \internal
+    /// \brief FCL mesh of the triangles of a geom, which has the pose of
+    /// the geom, so it isn't shared.
+    class ODEMeshFCL
+    {
+#ifdef HAVE_FCL
+      /// \brief Guards the pose of the model, set for each collision.
+      public: std::mutex mutex;
+
+      /// \brief Bounding volume hierarchy of the triangles, nullptr until
+      /// the first collision.
+      public: std::unique_ptr<fcl::BVHModel<fcl::OBB>> model;
+#endif
+    };
+  }
+}
+
+/// \brief Trimesh data shared by the ODE meshes with the same key.
+static MeshDataCache<ODEMeshData> meshDataCache;
+
+/// \brief Convex hulls shared by the ODE meshes with the same key.
+static MeshDataCache<ODEConvexData> convexDataCache;
+
+/// \brief Guards trimeshes.
+static std::mutex trimeshesMutex;
+
+/// \brief ODE meshes by the id of their triangle mesh geom.
+static std::unordered_map<dGeomID, ODEMesh *> trimeshes;
+
+//////////////////////////////////////////////////
+/// \brief Transform a point from the frame of a geom to the world.
+/// \param[in] _geom The geom.
+/// \param[in] _point The point in the frame of the geom.
+/// \return The point in the world.
+static ignition::math::Vector3d GeomToWorld(dGeomID _geom,
+    const ignition::math::Vector3d &_point)
+{
+  const dReal *p = dGeomGetPosition(_geom);
+  const dReal *r = dGeomGetRotation(_geom);
+  return ignition::math::Vector3d(
+      p[0] + r[0] * _point.X() + r[1] * _point.Y() + r[2] * _point.Z(),
+      p[1] + r[4] * _point.X() + r[5] * _point.Y() + r[6] * _point.Z(),
+      p[2] + r[8] * _point.X() + r[9] * _point.Y() + r[10] * _point.Z());
+}
+
+//////////////////////////////////////////////////
+/// \brief Sample a geom by spheres, for its queries against a distance
+/// field.
+/// \param[in] _geom The geom, triangle meshes are sampled by
+/// ODEMesh::CollideDistanceField.
+/// \param[out] _samples Centers in the world and radii of the spheres,
+/// zero for points.
+/// \return False if the geom can't be sampled.
+static bool SampleGeom(dGeomID _geom,
+    std::vector<std::pair<ignition::math::Vector3d, double>> &_samples)
+{
+  switch (dGeomGetClass(_geom))
+  {
+    case dSphereClass:
+    {
+      _samples.push_back(std::make_pair(GeomToWorld(_geom,
+          ignition::math::Vector3d::Zero), dGeomSphereGetRadius(_geom)));
+      return true;
+    }
+    case dBoxClass:
+    {
+      // Corners, middles of the edges and centers of the faces
+      dVector3 lengths;
+      dGeomBoxGetLengths(_geom, lengths);
+      for (int i = -1; i <= 1; ++i)
+      {
+        for (int j = -1; j <= 1; ++j)
+        {
+          for (int k = -1; k <= 1; ++k)
+          {
+            if (i == 0 && j == 0 && k == 0)
+              continue;
+            _samples.push_back(std::make_pair(GeomToWorld(_geom,
+                ignition::math::Vector3d(0.5 * i * lengths[0],
+                  0.5 * j * lengths[1], 0.5 * k * lengths[2])), 0.0));
+          }
+        }
+      }
+      return true;
+    }
+    case dCapsuleClass:
+    {
+      // Overlapping spheres along the axis
+      dReal radius, length;
+      dGeomCapsuleGetParams(_geom, &radius, &length);
+      const int count = 2 + static_cast<int>(
+          radius > 0 ? std::ceil(length / radius) : 0);
+      for (int i = 0; i < count; ++i)
+      {
+        const double z = length * (static_cast<double>(i) / (count - 1) - 0.5);
+        _samples.push_back(std::make_pair(GeomToWorld(_geom,
+            ignition::math::Vector3d(0, 0, z)), radius));
+      }
+      return true;
+    }
+    case dCylinderClass:
+    {
+      // Rims and centers of the caps
+      dReal radius, length;
+      dGeomCylinderGetParams(_geom, &radius, &length);
+      for (double z : {-0.5 * length, 0.5 * length})
+      {
+        _samples.push_back(std::make_pair(GeomToWorld(_geom,
+            ignition::math::Vector3d(0, 0, z)), 0.0));
+        for (int i = 0; i < 8; ++i)
+        {
+          const double a = i * M_PI / 4;
+          _samples.push_back(std::make_pair(GeomToWorld(_geom,
+              ignition::math::Vector3d(radius * std::cos(a),
+                radius * std::sin(a), z)), 0.0));
+        }
+      }
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
 //////////////////////////////////////////////////
 ODEMesh::ODEMesh()
+  : fclData(new ODEMeshFCL())
 {
-  this->odeData = nullptr;
-  this->vertices = nullptr;
-  this->indices = nullptr;
 }
 
 //////////////////////////////////////////////////
 ODEMesh::~ODEMesh()
 {
-  delete [] this->vertices;
-  delete [] this->indices;
-  dGeomTriMeshDataDestroy(this->odeData);
+  std::lock_guard<std::mutex> lock(trimeshesMutex);
+  auto iter = trimeshes.find(this->collisionId);
+  if (iter != trimeshes.end() && iter->second == this)
+    trimeshes.erase(iter);
+}
+
+//////////////////////////////////////////////////
+int ODEMesh::CollideFCL(dGeomID _geom1, dGeomID _geom2,
+    const int _maxContacts, dContactGeom *_contacts)
+{
+#ifdef HAVE_FCL
+  ODEMesh *meshes[2] = {nullptr, nullptr};
+  {
+    std::lock_guard<std::mutex> lock(trimeshesMutex);
+    auto iter1 = trimeshes.find(_geom1);
+    auto iter2 = trimeshes.find(_geom2);
+    if (iter1 == trimeshes.end() || iter2 == trimeshes.end())
+      return -1;
+    meshes[0] = iter1->second;
+    meshes[1] = iter2->second;
+  }
+  if (meshes[0] == meshes[1] || _maxContacts <= 0)
+    return 0;
+
+  // The pose of a model is set for each pair, so several pairs with the
+  // same mesh can't collide at once
+  std::unique_lock<std::mutex> lock1(meshes[0]->fclData->mutex,
+      std::defer_lock);
+  std::unique_lock<std::mutex> lock2(meshes[1]->fclData->mutex,
+      std::defer_lock);
+  std::lock(lock1, lock2);
+
+  const dGeomID geoms[2] = {_geom1, _geom2};
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    ODEMesh *mesh = meshes[i];
+    auto &model = mesh->fclData->model;
+    if (!model)
+    {
+      const ODEMeshData &data = *mesh->meshData;
+      std::vector<fcl::Vec3f> points;
+      points.reserve(data.vertexCount);
+      for (unsigned int j = 0; j < data.vertexCount; ++j)
+      {
+        points.push_back(fcl::Vec3f(data.vertices[j*3+0],
+            data.vertices[j*3+1], data.vertices[j*3+2]));
+      }
+
+      std::vector<fcl::Triangle> triangles;
+      triangles.reserve(data.indexCount / 3);
+      for (unsigned int j = 0; j + 2 < data.indexCount; j += 3)
+      {
+        triangles.push_back(fcl::Triangle(data.indices[j],
+            data.indices[j+1], data.indices[j+2]));
+      }
+
+      model.reset(new fcl::BVHModel<fcl::OBB>());
+      model->beginModel(triangles.size(), points.size());
+      model->addSubModel(points, triangles);
+      model->endModel();
+    }
+
+    const dReal *pos = dGeomGetPosition(geoms[i]);
+    const dReal *rot = dGeomGetRotation(geoms[i]);
+    const fcl::Vec3f rows[3] = {
+      fcl::Vec3f(rot[0], rot[1], rot[2]),
+      fcl::Vec3f(rot[4], rot[5], rot[6]),
+      fcl::Vec3f(rot[8], rot[9], rot[10])};
+    model->setTransform(rows, fcl::Vec3f(pos[0], pos[1], pos[2]));
+  }
+
+  std::vector<fcl::Contact> contacts;
+  fcl::collide(meshes[0]->fclData->model.get(),
+      meshes[1]->fclData->model.get(), _maxContacts, false, true, contacts);
+
+  // ODE normals push the first geom out of the second
+  dReal aabb1[6];
+  dReal aabb2[6];
+  dGeomGetAABB(_geom1, aabb1);
+  dGeomGetAABB(_geom2, aabb2);
+  dReal separation[3];
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    separation[i] = (aabb1[2*i] + aabb1[2*i+1]) -
+        (aabb2[2*i] + aabb2[2*i+1]);
+  }
+
+  int count = 0;
+  for (auto const &contact : contacts)
+  {
+    if (count >= _maxContacts)
+      break;
+
+    dContactGeom &c = _contacts[count++];
+    dReal sign = 1;
+    if (contact.normal[0] * separation[0] + contact.normal[1] * separation[1]
+        + contact.normal[2] * separation[2] < 0)
+    {
+      sign = -1;
+    }
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      c.pos[i] = contact.pos[i];
+      c.normal[i] = sign * contact.normal[i];
+    }
+    c.depth = std::abs(contact.penetration_depth);
+    c.g1 = _geom1;
+    c.g2 = _geom2;
+    c.side1 = contact.b1;
+    c.side2 = contact.b2;
+  }
+  return count;
+#else
+  (void)_geom1;
+  (void)_geom2;
+  (void)_maxContacts;
+  (void)_contacts;
+  return -1;
+#endif
+}
+
+//////////////////////////////////////////////////
+void ODEMesh::SetDistanceField(const common::MeshDistanceField *_field)
+{
+  this->distanceField = _field;
+}
+
+//////////////////////////////////////////////////
+int ODEMesh::CollideDistanceField(dGeomID _geom1, dGeomID _geom2,
+    const int _maxContacts, dContactGeom *_contacts)
+{
+  const ODEMesh *fieldMesh = nullptr;
+  const ODEMesh *otherMesh = nullptr;
+  bool reverse = false;
+  {
+    std::lock_guard<std::mutex> lock(trimeshesMutex);
+    auto iter1 = trimeshes.find(_geom1);
+    auto iter2 = trimeshes.find(_geom2);
+    if (iter1 != trimeshes.end() && iter1->second->distanceField)
+    {
+      fieldMesh = iter1->second;
+      if (iter2 != trimeshes.end())
+        otherMesh = iter2->second;
+    }
+    else if (iter2 != trimeshes.end() && iter2->second->distanceField)
+    {
+      fieldMesh = iter2->second;
+      if (iter1 != trimeshes.end())
+        otherMesh = iter1->second;
+      reverse = true;
+    }
+  }
+  if (!fieldMesh)
+    return -1;
+
+  const dGeomID fieldGeom = reverse ? _geom2 : _geom1;
+  const dGeomID otherGeom = reverse ? _geom1 : _geom2;
+
+  std::vector<std::pair<ignition::math::Vector3d, double>> samples;
+  if (otherMesh && otherMesh->meshData)
+  {
+    // The vertices of a triangle mesh
+    const ODEMeshData &data = *otherMesh->meshData;
+    samples.reserve(data.vertexCount);
+    for (unsigned int i = 0; i < data.vertexCount; ++i)
+    {
+      samples.push_back(std::make_pair(GeomToWorld(otherGeom,
+          ignition::math::Vector3d(data.vertices[i*3+0],
+            data.vertices[i*3+1], data.vertices[i*3+2])), 0.0));
+    }
+  }
+  else if (!SampleGeom(otherGeom, samples))
+  {
+    return -1;
+  }
+
+  const dReal *pos = dGeomGetPosition(fieldGeom);
+  const dReal *rot = dGeomGetRotation(fieldGeom);
+  std::vector<dContactGeom> contacts;
+  for (auto const &sample : samples)
+  {
+    // The sample in the frame of the mesh
+    const ignition::math::Vector3d d(sample.first.X() - pos[0],
+        sample.first.Y() - pos[1], sample.first.Z() - pos[2]);
+    const ignition::math::Vector3d local(
+        rot[0] * d.X() + rot[4] * d.Y() + rot[8] * d.Z(),
+        rot[1] * d.X() + rot[5] * d.Y() + rot[9] * d.Z(),
+        rot[2] * d.X() + rot[6] * d.Y() + rot[10] * d.Z());
+
+    const double distance =
+        fieldMesh->distanceField->Distance(local) - sample.second;
+    if (distance >= 0)
+      continue;
+
+    const ignition::math::Vector3d g =
+        fieldMesh->distanceField->Gradient(local);
+    const ignition::math::Vector3d normal(
+        rot[0] * g.X() + rot[1] * g.Y() + rot[2] * g.Z(),
+        rot[4] * g.X() + rot[5] * g.Y() + rot[6] * g.Z(),
+        rot[8] * g.X() + rot[9] * g.Y() + rot[10] * g.Z());
+
+    // Halfway between the deepest point of the sample and the surface,
+    // the normal pushes the mesh out of the other geom.
+    const ignition::math::Vector3d point =
+        sample.first - normal * (sample.second + 0.5 * distance);
+    dContactGeom c;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      c.pos[i] = point[i];
+      c.normal[i] = reverse ? normal[i] : -normal[i];
+    }
+    c.depth = -distance;
+    c.g1 = _geom1;
+    c.g2 = _geom2;
+    c.side1 = -1;
+    c.side2 = -1;
+    contacts.push_back(c);
+  }
+
+  // Keep the deepest contacts
+  const int count = std::min(_maxContacts, static_cast<int>(contacts.size()));
+  if (count <= 0)
+    return 0;
+  std::partial_sort(contacts.begin(), contacts.begin() + count,
+      contacts.end(), [](const dContactGeom &_a, const dContactGeom &_b)
+      {
+        return _a.depth > _b.depth;
+      });
+  std::copy(contacts.begin(), contacts.begin() + count, _contacts);
+  return count;
 }
 
 //////////////////////////////////////////////////
 void ODEMesh::Update()
 {
+  // Only triangle meshes use the previous transform
+  if (!this->meshData)
+    return;
+
   /// FIXME: use below to update trimesh geometry for collision without
   // using above Ogre codes
   // tell the tri-tri collider the current transform of the trimesh --
@@ -81,75 +581,112 @@ void ODEMesh::Update()
 
 //////////////////////////////////////////////////
 void ODEMesh::Init(const common::SubMesh *_subMesh, ODECollisionPtr _collision,
-    const ignition::math::Vector3d &_scale)
+    const ignition::math::Vector3d &_scale, const std::string &_key)
 {
   if (!_subMesh)
     return;
 
-  unsigned int numVertices = _subMesh->GetVertexCount();
-  unsigned int numIndices = _subMesh->GetIndexCount();
+  std::function<std::shared_ptr<ODEMeshData>()> create = [&]()
+  {
+    auto data = std::make_shared<ODEMeshData>();
 
-  this->vertices = nullptr;
-  this->indices = nullptr;
+    // Get all the vertex and index data
+    _subMesh->FillArrays(&data->vertices, &data->indices);
+    data->Build(_subMesh->GetVertexCount(), _subMesh->GetIndexCount(),
+        _scale);
+    return data;
+  };
 
-  // Get all the vertex and index data
-  _subMesh->FillArrays(&this->vertices, &this->indices);
+  this->meshData = _key.empty() ? create() : meshDataCache.Get(_key, create);
 
   this->collisionId = _collision->GetCollisionId();
 
-  this->CreateMesh(numVertices, numIndices, _collision, _scale);
+  this->CreateMesh(_collision);
 }
 
 //////////////////////////////////////////////////
 void ODEMesh::Init(const common::Mesh *_mesh, ODECollisionPtr _collision,
-    const ignition::math::Vector3d &_scale)
+    const ignition::math::Vector3d &_scale, const std::string &_key)
 {
   if (!_mesh)
     return;
 
-  unsigned int numVertices = _mesh->GetVertexCount();
-  unsigned int numIndices = _mesh->GetIndexCount();
+  std::function<std::shared_ptr<ODEMeshData>()> create = [&]()
+  {
+    auto data = std::make_shared<ODEMeshData>();
 
-  this->vertices = nullptr;
-  this->indices = nullptr;
+    // Get all the vertex and index data
+    _mesh->FillArrays(&data->vertices, &data->indices);
+    data->Build(_mesh->GetVertexCount(), _mesh->GetIndexCount(), _scale);
+    return data;
+  };
 
-  // Get all the vertex and index data
-  _mesh->FillArrays(&this->vertices, &this->indices);
+  this->meshData = _key.empty() ? create() : meshDataCache.Get(_key, create);
 
   this->collisionId = _collision->GetCollisionId();
-  this->CreateMesh(numVertices, numIndices, _collision, _scale);
+  this->CreateMesh(_collision);
 }
 
 //////////////////////////////////////////////////
-void ODEMesh::CreateMesh(unsigned int _numVertices, unsigned int _numIndices,
-    ODECollisionPtr _collision, const ignition::math::Vector3d &_scale)
+bool ODEMesh::InitConvex(const common::Mesh *_hulls,
+    ODECollisionPtr _collision, const ignition::math::Vector3d &_scale,
+    const std::string &_key)
 {
-  /// This will hold the vertex data of the triangle mesh
-  if (this->odeData == nullptr)
-    this->odeData = dGeomTriMeshDataCreate();
+  if (!_hulls || _collision->GetCollisionId() != nullptr)
+    return false;
+
+  std::function<std::shared_ptr<ODEConvexData>()> create = [&]()
+  {
+    auto data = std::make_shared<ODEConvexData>();
+    data->Build(*_hulls, _scale);
+    if (data->hulls.empty())
+      data.reset();
+    return data;
+  };
+
+  this->convexData = _key.empty() ? create() :
+      convexDataCache.Get(_key, create);
+  if (!this->convexData)
+    return false;
 
-  // Scale the vertex data
-  for (unsigned int j = 0;  j < _numVertices; j++)
+  // The hulls share the pose of the collision, in a space of their own
+  _collision->SetSpaceId(dSimpleSpaceCreate(_collision->GetSpaceId()));
+  for (unsigned int i = 0; i < this->convexData->hulls.size(); ++i)
   {
-    this->vertices[j*3+0] = this->vertices[j*3+0] * _scale.X();
-    this->vertices[j*3+1] = this->vertices[j*3+1] * _scale.Y();
-    this->vertices[j*3+2] = this->vertices[j*3+2] * _scale.Z();
+    ODEConvexData::Hull &hull = this->convexData->hulls[i];
+    dGeomID geomId = dCreateConvex(i == 0 ? 0 : _collision->GetSpaceId(),
+        hull.planes.data(), hull.planes.size() / 4, hull.points.data(),
+        hull.points.size() / 3, hull.polygons.data());
+    if (i == 0)
+      _collision->SetCollision(geomId, true);
+    else
+      _collision->AddSubCollision(geomId);
   }
 
-  // Build the ODE triangle mesh
-  dGeomTriMeshDataBuildSingle(this->odeData,
-      this->vertices, 3*sizeof(this->vertices[0]), _numVertices,
-      this->indices, _numIndices, 3*sizeof(this->indices[0]));
+  this->collisionId = _collision->GetCollisionId();
+  return true;
+}
 
+//////////////////////////////////////////////////
+void ODEMesh::CreateMesh(ODECollisionPtr _collision)
+{
   if (_collision->GetCollisionId() == nullptr)
   {
     _collision->SetSpaceId(dSimpleSpaceCreate(_collision->GetSpaceId()));
     _collision->SetCollision(dCreateTriMesh(_collision->GetSpaceId(),
-          this->odeData, 0, 0, 0), true);
+          this->meshData->odeData, 0, 0, 0), true);
+
+    std::lock_guard<std::mutex> lock(trimeshesMutex);
+    trimeshes[_collision->GetCollisionId()] = this;
   }
   else
   {
-    dGeomTriMeshSetData(_collision->GetCollisionId(), this->odeData);
+    dGeomTriMeshSetData(_collision->GetCollisionId(), this->meshData->odeData);
+
+#ifdef HAVE_FCL
+    std::lock_guard<std::mutex> lock(this->fclData->mutex);
+    this->fclData->model.reset();
+#endif
   }
 
   memset(this->transform, 0, 32*sizeof(dReal));
@@ -18,6 +18,9 @@
 #ifndef GAZEBO_PHYSICS_ODE_ODEMESH_HH_
 #define GAZEBO_PHYSICS_ODE_ODEMESH_HH_
 
+#include <memory>
+#include <string>
+
 #include <ignition/math/Vector3.hh>
 
 #include "gazebo/physics/ode/ODETypes.hh"
@@ -32,6 +35,10 @@ namespace gazebo
     /// \addtogroup gazebo_physics_ode
     /// \{
 
+    class ODEConvexData;
+    class ODEMeshFCL;
+    class ODEMeshData;
+
     /// \brief Triangle mesh helper class.
     class GZ_PHYSICS_VISIBLE ODEMesh
     {
@@ -45,28 +52,85 @@ namespace gazebo
       /// \param[in] _subMesh Pointer to the submesh.
       /// \param[in] _collision Pointer to the collision object.
       /// \param[in] _scale Scaling factor.
+      /// \param[in] _key Key of the triangle data, see
+      /// MeshShape::CollisionMeshKey. Meshes with the same key share their
+      /// triangle data. Empty to not share it.
       public: void Init(const common::SubMesh *_subMesh,
                       ODECollisionPtr _collision,
-                      const ignition::math::Vector3d &_scale);
+                      const ignition::math::Vector3d &_scale,
+                      const std::string &_key = "");
 
       /// \brief Create a mesh collision shape using a mesh.
       /// \param[in] _mesh Pointer to the mesh.
       /// \param[in] _collision Pointer to the collision object.
       /// \param[in] _scale Scaling factor.
+      /// \param[in] _key Key of the triangle data, see
+      /// MeshShape::CollisionMeshKey. Meshes with the same key share their
+      /// triangle data. Empty to not share it.
       public: void Init(const common::Mesh *_mesh,
                       ODECollisionPtr _collision,
-                      const ignition::math::Vector3d &_scale);
+                      const ignition::math::Vector3d &_scale,
+                      const std::string &_key = "");
+
+      /// \brief Create a collision shape made of convex hulls, which
+      /// collides faster and more smoothly than triangles. ODE doesn't
+      /// collide convex hulls with triangle meshes.
+      /// \param[in] _hulls Mesh with one convex hull per submesh, see
+      /// common::MeshManager::ConvexDecomposition.
+      /// \param[in] _collision Pointer to the collision object, which must
+      /// not have an ODE geom yet.
+      /// \param[in] _scale Scaling factor.
+      /// \param[in] _key Key of the hulls, meshes with the same key share
+      /// their data. Empty to not share it.
+      /// \return False if the collision can't be made of the hulls.
+      public: bool InitConvex(const common::Mesh *_hulls,
+                  ODECollisionPtr _collision,
+                  const ignition::math::Vector3d &_scale,
+                  const std::string &_key = "");
+
+      /// \brief Collide two triangle mesh geoms with the bounding volume
+      /// hierarchies of FCL, which copes better than ODE's trimesh
+      /// collider with large meshes in contact. The hierarchies are built
+      /// on first use.
+      /// \param[in] _geom1 First geom.
+      /// \param[in] _geom2 Second geom.
+      /// \param[in] _maxContacts Size of _contacts.
+      /// \param[out] _contacts Contacts, in the convention of dCollide.
+      /// \return Number of contacts, or -1 if gazebo is built without FCL
+      /// or a geom isn't the triangle mesh of an ODEMesh.
+      public: static int CollideFCL(dGeomID _geom1, dGeomID _geom2,
+                  const int _maxContacts, dContactGeom *_contacts);
+
+      /// \brief Answer the contact queries of other geoms against this
+      /// mesh from a signed distance field, in constant time per query
+      /// instead of testing triangles. Spheres, capsules, boxes, cylinders
+      /// and triangle meshes are sampled by points and spheres, the other
+      /// geoms keep colliding with the triangles, as do rays.
+      /// \param[in] _field Distance field of the scaled mesh, which must
+      /// outlive this mesh, nullptr to collide with the triangles.
+      /// \sa common::MeshManager::DistanceField
+      public: void SetDistanceField(
+                  const common::MeshDistanceField *_field);
+
+      /// \brief Collide a geom with the triangle mesh of an ODEMesh that
+      /// has a distance field.
+      /// \param[in] _geom1 First geom.
+      /// \param[in] _geom2 Second geom.
+      /// \param[in] _maxContacts Size of _contacts.
+      /// \param[out] _contacts Contacts, in the convention of dCollide.
+      /// \return Number of contacts, or -1 if neither geom is a mesh with a
+      /// distance field, or the other geom can't be sampled.
+      /// \sa SetDistanceField
+      public: static int CollideDistanceField(dGeomID _geom1, dGeomID _geom2,
+                  const int _maxContacts, dContactGeom *_contacts);
 
       /// \brief Update the collision mesh.
       public: virtual void Update();
 
-      /// \brief Helper function to create the collision shape.
-      /// \param[in] _numVertices Number of vertices.
-      /// \param[in] _numIndices Number of indices.
+      /// \brief Helper function to create the collision shape from the
+      /// triangle data.
       /// \param[in] _collision Pointer to the collision object.
-      private: void CreateMesh(unsigned int _numVertices,
-                   unsigned int _numIndices, ODECollisionPtr _collision,
-                   const ignition::math::Vector3d &_scale);
+      private: void CreateMesh(ODECollisionPtr _collision);
 
       /// \brief Transform matrix.
       private: dReal transform[16*2];
@@ -74,17 +138,23 @@ namespace gazebo
       /// \brief Transform matrix index.
       private: int transformIndex;
 
-      /// \brief Array of vertex values.
-      private: float *vertices;
+      /// \brief Vertices, indices and ODE trimesh data, possibly shared
+      /// with other meshes.
+      private: std::shared_ptr<ODEMeshData> meshData;
+
+      /// \brief Points, planes and polygons of the convex hulls, possibly
+      /// shared with other meshes.
+      private: std::shared_ptr<ODEConvexData> convexData;
 
-      /// \brief Array of index values.
-      private: int *indices;
+      /// \brief FCL hierarchy of the triangles, built by CollideFCL.
+      private: std::unique_ptr<ODEMeshFCL> fclData;
 
-      /// \brief ODE trimesh data.
-      private: dTriMeshDataID odeData;
+      /// \brief Distance field answering the contact queries, owned by
+      /// the mesh manager.
+      private: const common::MeshDistanceField *distanceField = nullptr;
 
       /// \brief The collision id that this mesh is attached to.
-      private: dGeomID collisionId;
+      private: dGeomID collisionId = nullptr;
     };
     /// \}
   }
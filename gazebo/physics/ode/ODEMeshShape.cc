@@ -14,7 +14,10 @@
  * limitations under the License.
  *
 */
+#include <string>
+
 #include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshManager.hh"
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Console.hh"
 
@@ -57,16 +60,99 @@ void ODEMeshShape::Init()
   if (!this->mesh)
     return;
 
+  // Optionally collide with convex hulls approximating the mesh
+  if (this->sdf->HasElement("gz:convex_decomposition") &&
+      this->sdf->Get<bool>("gz:convex_decomposition"))
+  {
+    unsigned int maxHulls = 16u;
+    if (this->sdf->HasElement("gz:max_convex_hulls"))
+      maxHulls = this->sdf->Get<unsigned int>("gz:max_convex_hulls");
+
+    const common::Mesh *hulls = nullptr;
+    if (this->submesh)
+    {
+      common::Mesh part;
+      part.AddSubMesh(new common::SubMesh(this->submesh));
+      hulls = common::MeshManager::Instance()->ConvexDecomposition(
+          &part, maxHulls);
+    }
+    else
+    {
+      hulls = common::MeshManager::Instance()->ConvexDecomposition(
+          this->mesh, maxHulls);
+    }
+
+    std::string key = this->CollisionMeshKey();
+    if (!key.empty())
+      key += "|convex " + std::to_string(maxHulls);
+    if (this->odeMesh->InitConvex(hulls,
+          boost::static_pointer_cast<ODECollision>(this->collisionParent),
+          this->sdf->Get<ignition::math::Vector3d>("scale"), key))
+    {
+      return;
+    }
+
+    gzwarn << "Unable to decompose mesh [" << this->GetMeshURI()
+           << "] into convex hulls, colliding with its triangles instead"
+           << std::endl;
+  }
+
   if (this->submesh)
   {
     this->odeMesh->Init(this->submesh,
         boost::static_pointer_cast<ODECollision>(this->collisionParent),
-        this->sdf->Get<ignition::math::Vector3d>("scale"));
+        this->sdf->Get<ignition::math::Vector3d>("scale"),
+        this->CollisionMeshKey());
   }
   else
   {
     this->odeMesh->Init(this->mesh,
         boost::static_pointer_cast<ODECollision>(this->collisionParent),
-        this->sdf->Get<ignition::math::Vector3d>("scale"));
+        this->sdf->Get<ignition::math::Vector3d>("scale"),
+        this->CollisionMeshKey());
+  }
+
+  // Optionally answer the contact queries against static meshes from a
+  // signed distance field
+  if (this->sdf->HasElement("gz:distance_field") &&
+      this->sdf->Get<bool>("gz:distance_field"))
+  {
+    if (!this->collisionParent->IsStatic())
+    {
+      gzwarn << "Distance field of mesh [" << this->GetMeshURI()
+             << "] ignored, only static meshes use one" << std::endl;
+      return;
+    }
+
+    double cellSize = 0.0;
+    if (this->sdf->HasElement("gz:distance_cell_size"))
+      cellSize = this->sdf->Get<double>("gz:distance_cell_size");
+
+    const ignition::math::Vector3d scale =
+        this->sdf->Get<ignition::math::Vector3d>("scale");
+    const common::MeshDistanceField *field = nullptr;
+    if (this->submesh)
+    {
+      common::Mesh part;
+      part.AddSubMesh(new common::SubMesh(this->submesh));
+      field = common::MeshManager::Instance()->DistanceField(
+          &part, scale, cellSize);
+    }
+    else
+    {
+      field = common::MeshManager::Instance()->DistanceField(
+          this->mesh, scale, cellSize);
+    }
+
+    if (field)
+    {
+      this->odeMesh->SetDistanceField(field);
+    }
+    else
+    {
+      gzwarn << "Unable to compute the distance field of mesh ["
+             << this->GetMeshURI() << "], colliding with its triangles "
+             << "instead" << std::endl;
+    }
   }
 }
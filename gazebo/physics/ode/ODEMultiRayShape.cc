@@ -14,6 +14,15 @@
  * limitations under the License.
  *
  */
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Exception.hh"
 
@@ -28,6 +37,176 @@
 using namespace gazebo;
 using namespace physics;
 
+/// \brief Number of rays from which UpdateRaysBatched is used.
+static const unsigned int kMinBatchRays = 32;
+
+/// \brief Number of rays processed together by one task.
+static const unsigned int kRayGrainSize = 16;
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief Buffers for ODEMultiRayShape::UpdateRaysBatched. The world
+    /// geoms are stored as arrays of bounding box coordinates so the
+    /// ray-box tests run over contiguous memory.
+    class ODERayBatch
+    {
+      /// \brief Candidate world geoms.
+      public: std::vector<dGeomID> geoms;
+
+      /// \brief Collisions of the candidate geoms.
+      public: std::vector<ODECollision *> collisions;
+
+      /// \brief True if the geom must be tested from a single thread.
+      public: std::vector<char> serial;
+
+      /// \brief Bounding box minimum and maximum of each candidate geom.
+      public: std::vector<double> minX, minY, minZ, maxX, maxY, maxZ;
+
+      /// \brief Closest hit distance of each ray.
+      public: std::vector<double> depth;
+
+      /// \brief Collision hit by each ray, null if none.
+      public: std::vector<ODECollision *> hit;
+
+      /// \brief Candidates of each ray that must be tested serially, as
+      /// pairs of entry distance and candidate index.
+      public: std::vector<std::vector<std::pair<double, unsigned int>>>
+              serialHits;
+    };
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the collision of a world geom.
+/// \param[in] _geom Geom id.
+/// \return The collision, null if the geom has no collision.
+static ODECollision *GeomCollision(dGeomID _geom)
+{
+  if (dGeomGetClass(_geom) == dGeomTransformClass)
+    return static_cast<ODECollision*>(dGeomGetData(
+          dGeomTransformGetGeom(_geom)));
+  return static_cast<ODECollision*>(dGeomGetData(_geom));
+}
+
+//////////////////////////////////////////////////
+/// \brief Collect the enabled leaf geoms of a space whose bounding boxes
+/// overlap a bounding box.
+/// \param[in] _space Space to collect from.
+/// \param[in] _aabb Bounding box to overlap, as returned by dGeomGetAABB.
+/// \param[in] _raySpace Space of the rays, used to check collide bits.
+/// \param[out] _batch Batch receiving the geoms.
+static void CollectRayCandidates(dSpaceID _space, const dReal *_aabb,
+    dGeomID _raySpace, ODERayBatch &_batch)
+{
+  int count = dSpaceGetNumGeoms(_space);
+  for (int i = 0; i < count; ++i)
+  {
+    dGeomID geom = dSpaceGetGeom(_space, i);
+    if (!dGeomIsEnabled(geom))
+      continue;
+
+    dReal aabb[6];
+    dGeomGetAABB(geom, aabb);
+    if (aabb[0] > _aabb[1] || aabb[1] < _aabb[0] ||
+        aabb[2] > _aabb[3] || aabb[3] < _aabb[2] ||
+        aabb[4] > _aabb[5] || aabb[5] < _aabb[4])
+    {
+      continue;
+    }
+
+    if (!(dGeomGetCategoryBits(geom) & dGeomGetCollideBits(_raySpace)) &&
+        !(dGeomGetCategoryBits(_raySpace) & dGeomGetCollideBits(geom)))
+    {
+      continue;
+    }
+
+    if (dGeomIsSpace(geom))
+    {
+      CollectRayCandidates(reinterpret_cast<dSpaceID>(geom), _aabb,
+          _raySpace, _batch);
+      continue;
+    }
+
+    ODECollision *collision = GeomCollision(geom);
+    if (!collision)
+      continue;
+
+    // Mesh, heightmap and polyline colliders keep shared state, and
+    // transforms update their cached pose while colliding.
+    bool serial = dGeomGetClass(geom) == dGeomTransformClass ||
+        collision->HasType(Base::HEIGHTMAP_SHAPE) ||
+        collision->HasType(Base::POLYLINE_SHAPE) ||
+        collision->HasType(Base::MESH_SHAPE);
+
+    _batch.geoms.push_back(geom);
+    _batch.collisions.push_back(collision);
+    _batch.serial.push_back(serial);
+    _batch.minX.push_back(aabb[0]);
+    _batch.maxX.push_back(aabb[1]);
+    _batch.minY.push_back(aabb[2]);
+    _batch.maxY.push_back(aabb[3]);
+    _batch.minZ.push_back(aabb[4]);
+    _batch.maxZ.push_back(aabb[5]);
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Compute the distance at which a ray enters a bounding box.
+/// \param[in] _start Ray start.
+/// \param[in] _invDir Inverse of the ray direction.
+/// \param[in] _min Box minimum.
+/// \param[in] _max Box maximum.
+/// \param[in] _length Ray length.
+/// \param[out] _entry Entry distance, zero if the ray starts inside.
+/// \return True if the ray hits the box within its length.
+static inline bool RayBoxEntry(const dReal *_start, const double *_invDir,
+    const double *_min, const double *_max, double _length, double &_entry)
+{
+  double tmin = 0.0;
+  double tmax = _length;
+  for (int k = 0; k < 3; ++k)
+  {
+    // Unbounded boxes, e.g. planes, are always hit.
+    if (std::isinf(_min[k]) || std::isinf(_max[k]))
+      continue;
+
+    double t1 = (_min[k] - _start[k]) * _invDir[k];
+    double t2 = (_max[k] - _start[k]) * _invDir[k];
+    if (std::isnan(t1) || std::isnan(t2))
+      continue;
+    tmin = std::max(tmin, std::min(t1, t2));
+    tmax = std::min(tmax, std::max(t1, t2));
+  }
+  _entry = tmin;
+  return tmin <= tmax;
+}
+
+//////////////////////////////////////////////////
+/// \brief Test a ray exactly against a geom.
+/// \param[in] _ray Ray geom.
+/// \param[in] _geom Geom to test.
+/// \param[out] _depth Hit distance.
+/// \return True if the ray hits the geom.
+static inline bool RayGeomHit(dGeomID _ray, dGeomID _geom, double &_depth)
+{
+  if (!(dGeomGetCategoryBits(_ray) & dGeomGetCollideBits(_geom)) &&
+      !(dGeomGetCategoryBits(_geom) & dGeomGetCollideBits(_ray)))
+  {
+    return false;
+  }
+
+  dContactGeom contact;
+  if (dCollide(_ray, _geom, 1, &contact, sizeof(contact)) > 0)
+  {
+    _depth = contact.depth;
+    return true;
+  }
+  return false;
+}
+
 
 //////////////////////////////////////////////////
 ODEMultiRayShape::ODEMultiRayShape(CollisionPtr _parent)
@@ -93,6 +272,13 @@ void ODEMultiRayShape::UpdateRays()
   {
     boost::recursive_mutex::scoped_lock lock(*ode->GetPhysicsUpdateMutex());
 
+    // Sensors with many rays cast them in one batch.
+    if (this->defaultUpdate && this->rays.size() >= kMinBatchRays)
+    {
+      this->UpdateRaysBatched(ode->GetSpaceId());
+      return;
+    }
+
     // Do collision detection
     dSpaceCollide2((dGeomID) (this->superSpaceId),
         (dGeomID) (ode->GetSpaceId()),
@@ -100,6 +286,186 @@ void ODEMultiRayShape::UpdateRays()
   }
 }
 
+//////////////////////////////////////////////////
+void ODEMultiRayShape::UpdateRaySubset(const std::vector<unsigned int> &_rays)
+{
+  ODEPhysicsPtr ode = boost::dynamic_pointer_cast<ODEPhysics>(
+      this->GetWorld()->Physics());
+
+  if (ode == nullptr)
+    gzthrow("Invalid physics engine. Must use ODE.");
+
+  boost::recursive_mutex::scoped_lock lock(*ode->GetPhysicsUpdateMutex());
+
+  if (this->defaultUpdate && _rays.size() >= kMinBatchRays)
+  {
+    this->UpdateRaysBatched(ode->GetSpaceId(), &_rays);
+    return;
+  }
+
+  // Collisions of disabled geoms are skipped, disable the rays not cast
+  std::vector<char> cast(this->rays.size(), 0);
+  for (auto const i : _rays)
+  {
+    if (i < cast.size())
+      cast[i] = 1;
+  }
+
+  std::vector<dGeomID> disabled;
+  for (unsigned int i = 0; i < this->rays.size(); ++i)
+  {
+    dGeomID id = boost::static_pointer_cast<ODERayShape>(
+        this->rays[i])->ODEGeomId();
+    if (!cast[i] && dGeomIsEnabled(id))
+    {
+      dGeomDisable(id);
+      disabled.push_back(id);
+    }
+  }
+
+  dSpaceCollide2((dGeomID) (this->superSpaceId),
+      (dGeomID) (ode->GetSpaceId()),
+      this, &UpdateCallback);
+
+  for (auto const id : disabled)
+    dGeomEnable(id);
+}
+
+//////////////////////////////////////////////////
+void ODEMultiRayShape::UpdateRaysBatched(dSpaceID _worldSpace,
+    const std::vector<unsigned int> *_rays)
+{
+  if (!this->rayBatch)
+    this->rayBatch.reset(new ODERayBatch);
+  ODERayBatch &batch = *this->rayBatch;
+
+  const unsigned int rayCount = _rays ? _rays->size() : this->rays.size();
+  std::vector<RayShape *> shapes(rayCount);
+  std::vector<dGeomID> rayIds(rayCount);
+  for (unsigned int i = 0; i < rayCount; ++i)
+  {
+    shapes[i] = this->rays[_rays ? (*_rays)[i] : i].get();
+    rayIds[i] = static_cast<ODERayShape *>(shapes[i])->ODEGeomId();
+    dGeomRaySetParams(rayIds[i], 0, 0);
+    dGeomRaySetClosestHit(rayIds[i], 1);
+  }
+
+  // The bounding box of the ray space covers all rays. Getting it also
+  // updates the cached poses of the rays before the parallel section.
+  dReal aabb[6];
+  dGeomGetAABB(reinterpret_cast<dGeomID>(this->raySpaceId), aabb);
+
+  // Only the rays cast need to be covered
+  if (_rays)
+  {
+    for (unsigned int i = 0; i < rayCount; ++i)
+    {
+      dReal rayAabb[6];
+      dGeomGetAABB(rayIds[i], rayAabb);
+      for (unsigned int k = 0; k < 6; k += 2)
+      {
+        if (i == 0 || rayAabb[k] < aabb[k])
+          aabb[k] = rayAabb[k];
+        if (i == 0 || rayAabb[k + 1] > aabb[k + 1])
+          aabb[k + 1] = rayAabb[k + 1];
+      }
+    }
+  }
+
+  batch.geoms.clear();
+  batch.collisions.clear();
+  batch.serial.clear();
+  batch.minX.clear();
+  batch.minY.clear();
+  batch.minZ.clear();
+  batch.maxX.clear();
+  batch.maxY.clear();
+  batch.maxZ.clear();
+  CollectRayCandidates(_worldSpace, aabb,
+      reinterpret_cast<dGeomID>(this->raySpaceId), batch);
+
+  const double inf = std::numeric_limits<double>::infinity();
+  batch.depth.assign(rayCount, inf);
+  batch.hit.assign(rayCount, nullptr);
+  batch.serialHits.resize(rayCount);
+
+  if (batch.geoms.empty())
+    return;
+
+  tbb::parallel_for(tbb::blocked_range<unsigned int>(0, rayCount,
+        kRayGrainSize), [&](const tbb::blocked_range<unsigned int> &_range)
+  {
+    std::vector<std::pair<double, unsigned int>> hits;
+    for (unsigned int r = _range.begin(); r != _range.end(); ++r)
+    {
+      dGeomID ray = rayIds[r];
+      dVector3 start, dir;
+      dGeomRayGet(ray, start, dir);
+      double length = dGeomRayGetLength(ray);
+      double invDir[3] = {1.0 / dir[0], 1.0 / dir[1], 1.0 / dir[2]};
+
+      hits.clear();
+      batch.serialHits[r].clear();
+      for (unsigned int g = 0; g < batch.geoms.size(); ++g)
+      {
+        double boxMin[3] = {batch.minX[g], batch.minY[g], batch.minZ[g]};
+        double boxMax[3] = {batch.maxX[g], batch.maxY[g], batch.maxZ[g]};
+        double entry;
+        if (!RayBoxEntry(start, invDir, boxMin, boxMax, length, entry))
+          continue;
+
+        if (batch.serial[g])
+          batch.serialHits[r].push_back(std::make_pair(entry, g));
+        else
+          hits.push_back(std::make_pair(entry, g));
+      }
+
+      // Test the closest boxes first and stop once a box starts beyond
+      // the closest hit.
+      std::sort(hits.begin(), hits.end());
+      for (auto const &h : hits)
+      {
+        if (h.first >= batch.depth[r])
+          break;
+
+        double depth;
+        if (RayGeomHit(ray, batch.geoms[h.second], depth) &&
+            depth < batch.depth[r])
+        {
+          batch.depth[r] = depth;
+          batch.hit[r] = batch.collisions[h.second];
+        }
+      }
+    }
+  });
+
+  for (unsigned int r = 0; r < rayCount; ++r)
+  {
+    std::sort(batch.serialHits[r].begin(), batch.serialHits[r].end());
+    for (auto const &h : batch.serialHits[r])
+    {
+      if (h.first >= batch.depth[r])
+        break;
+
+      double depth;
+      if (RayGeomHit(rayIds[r], batch.geoms[h.second], depth) &&
+          depth < batch.depth[r])
+      {
+        batch.depth[r] = depth;
+        batch.hit[r] = batch.collisions[h.second];
+      }
+    }
+
+    RayShape *shape = shapes[r];
+    if (batch.hit[r] && batch.depth[r] < shape->GetLength())
+    {
+      shape->SetLength(batch.depth[r]);
+      shape->SetRetro(batch.hit[r]->GetLaserRetro());
+      shape->SetCollisionName(batch.hit[r]->GetScopedName());
+    }
+  }
+}
+
 //////////////////////////////////////////////////
 void ODEMultiRayShape::UpdateCallback(void *_data, dGeomID _o1, dGeomID _o2)
 {
@@ -17,6 +17,10 @@
 #ifndef GAZEBO_PHYSICS_ODE_ODEMULTIRAYSHAPE_HH_
 #define GAZEBO_PHYSICS_ODE_ODEMULTIRAYSHAPE_HH_
 
+#include <memory>
+#include <vector>
+
+#include "gazebo/physics/ode/ode_inc.h"
 #include "gazebo/physics/MultiRayShape.hh"
 #include "gazebo/util/system.hh"
 
@@ -24,6 +28,9 @@ namespace gazebo
 {
   namespace physics
   {
+    // Forward declare private data.
+    class ODERayBatch;
+
     /// \addtogroup gazebo_physics_ode
     /// \{
 
@@ -51,6 +58,18 @@ namespace gazebo
       private: static void UpdateCallback(void *_data, dGeomID _o1,
                                           dGeomID _o2);
 
+      // Documentation inherited.
+      public: virtual void UpdateRaySubset(
+                  const std::vector<unsigned int> &_rays);
+
+      /// \brief Cast rays in one pass against a flat list of the
+      /// world's geoms. Candidate geoms are selected with ray-box tests and
+      /// tested exactly in order of distance, on multiple threads.
+      /// \param[in] _worldSpace Space containing the world's geoms.
+      /// \param[in] _rays Indices of the rays to cast, null for all rays.
+      private: void UpdateRaysBatched(dSpaceID _worldSpace,
+                   const std::vector<unsigned int> *_rays = nullptr);
+
       /// \brief Add a ray to the collision.
       /// \param[in] _start Start of a ray.
       /// \param[in] _end End of a ray.
@@ -66,6 +85,9 @@ namespace gazebo
       /// \brief Helper to get the correct ray shape in the UpdateCallback
       /// function.
       private: bool defaultUpdate = true;
+
+      /// \brief Buffers reused by UpdateRaysBatched.
+      private: std::unique_ptr<ODERayBatch> rayBatch;
     };
     /// \}
   }
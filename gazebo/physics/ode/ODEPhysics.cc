@@ -17,15 +17,23 @@
 
 #include <tbb/parallel_for.h>
 #include <tbb/blocked_range.h>
+#include <tbb/task_arena.h>
 
 #include <sdf/sdf.hh>
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <limits>
 #include <map>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include <ignition/math/Helpers.hh>
 #include <ignition/math/Rand.hh>
 #include <ignition/math/Vector3.hh>
 
@@ -33,6 +41,7 @@
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
+#include "gazebo/common/Profiler.hh"
 #include "gazebo/common/Time.hh"
 #include "gazebo/common/Timer.hh"
 
@@ -49,6 +58,7 @@
 #include "gazebo/physics/ContactManager.hh"
 
 #include "gazebo/physics/ode/ODECollision.hh"
+#include "gazebo/physics/ode/ODEJoint.hh"
 #include "gazebo/physics/ode/ODELink.hh"
 #include "gazebo/physics/ode/ODEScrewJoint.hh"
 #include "gazebo/physics/ode/ODEHingeJoint.hh"
@@ -65,6 +75,7 @@
 #include "gazebo/physics/ode/ODECylinderShape.hh"
 #include "gazebo/physics/ode/ODEPlaneShape.hh"
 #include "gazebo/physics/ode/ODEMeshShape.hh"
+#include "gazebo/physics/ode/ODEMesh.hh"
 #include "gazebo/physics/ode/ODEMultiRayShape.hh"
 #include "gazebo/physics/ode/ODEHeightmapShape.hh"
 #include "gazebo/physics/ode/ODEPolylineShape.hh"
@@ -79,6 +90,542 @@ using namespace physics;
 
 GZ_REGISTER_PHYSICS_ENGINE("ode", ODEPhysics)
 
+#ifdef HAVE_PARALLEL_QUICKSTEP
+// Entry point of deps/parallel_quickstep, see parallel_quickstep.h
+extern "C" int dWorldParallelQuickStep(dWorldID _world, dReal _stepSize);
+#endif
+
+// Below this number of colliders the collision narrowphase stays on the
+// physics thread, even if collision threads are enabled.
+static const unsigned int kMinParallelColliders = 64;
+
+// Number of colliders handled by a parallel narrowphase task.
+static const unsigned int kParallelCollidersGrain = 16;
+
+// Size of the cells that identify contact positions across steps, in
+// meters.
+static const double kContactCellSize = 0.01;
+
+// Depth of the quadtree space, which allocates 4^depth blocks up front.
+static const int kQuadTreeDepth = 6;
+
+// Bisections of the path of a continuous collision link that hits a geom.
+static const int kSweepIterations = 10;
+
+// Range of the automatically tuned hash levels, 1mm to 1km cells.
+static const int kMinHashLevel = -10;
+static const int kMaxHashLevel = 10;
+
+//////////////////////////////////////////////////
+/// \brief Find the bodies and sensor geoms of a top level geom,
+/// recursing into spaces.
+/// \param[in] _geom Geom to scan.
+/// \param[in,out] _bodies Bodies found, each once.
+/// \param[in,out] _sensor Set to true if a geom is a sensor.
+static void ScanBroadphaseGeom(dGeomID _geom, std::vector<dBodyID> &_bodies,
+    bool &_sensor)
+{
+  if (dGeomIsSpace(_geom))
+  {
+    dSpaceID space = reinterpret_cast<dSpaceID>(_geom);
+    int count = dSpaceGetNumGeoms(space);
+    for (int i = 0; i < count; ++i)
+      ScanBroadphaseGeom(dSpaceGetGeom(space, i), _bodies, _sensor);
+    return;
+  }
+
+  dBodyID body = dGeomGetBody(_geom);
+  if (body && std::find(_bodies.begin(), _bodies.end(), body) ==
+      _bodies.end())
+  {
+    _bodies.push_back(body);
+  }
+
+  if (dGeomGetCategoryBits(_geom) == GZ_SENSOR_COLLIDE)
+    _sensor = true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Identify a contact across steps by its geoms, its features, and
+/// its position in the frame of the first placeable geom.
+/// \param[in] _geom1 First geom of the contact pair.
+/// \param[in] _geom2 Second geom of the contact pair.
+/// \param[in] _contact The contact.
+/// \return Id of the contact.
+static uint64_t ContactId(dGeomID _geom1, dGeomID _geom2,
+    const dContactGeom &_contact)
+{
+  // Position of the contact in the geom frame, p_local = R^T (p - o).
+  // Planes aren't placeable, so contacts with them use the other geom.
+  static const dReal kZero[3] = {0, 0, 0};
+  static const dMatrix3 kIdentity = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0};
+  dGeomID frame = dGeomGetClass(_geom1) != dPlaneClass ? _geom1 :
+      (dGeomGetClass(_geom2) != dPlaneClass ? _geom2 : nullptr);
+  const dReal *origin = frame ? dGeomGetPosition(frame) : kZero;
+  const dReal *rot = frame ? dGeomGetRotation(frame) : kIdentity;
+  dReal offset[3];
+  for (int i = 0; i < 3; ++i)
+    offset[i] = _contact.pos[i] - origin[i];
+
+  uint64_t id = std::hash<const void *>()(_geom1);
+  auto combine = [&id](const uint64_t _value)
+  {
+    id ^= _value + 0x9e3779b97f4a7c15ull + (id << 6) + (id >> 2);
+  };
+  combine(std::hash<const void *>()(_geom2));
+  combine(static_cast<uint32_t>(_contact.side1));
+  combine(static_cast<uint32_t>(_contact.side2));
+  for (int i = 0; i < 3; ++i)
+  {
+    const dReal local = rot[i] * offset[0] + rot[4 + i] * offset[1] +
+        rot[8 + i] * offset[2];
+    combine(static_cast<uint64_t>(static_cast<int64_t>(
+        std::floor(local / kContactCellSize))));
+  }
+  return id;
+}
+
+//////////////////////////////////////////////////
+/// \brief Find whether the bounding boxes of two geoms overlap.
+/// \param[in] _geom1 First geom.
+/// \param[in] _geom2 Second geom.
+/// \return True if they overlap.
+static bool AabbsOverlap(dGeomID _geom1, dGeomID _geom2)
+{
+  dReal aabb1[6];
+  dReal aabb2[6];
+  dGeomGetAABB(_geom1, aabb1);
+  dGeomGetAABB(_geom2, aabb2);
+  for (int i = 0; i < 6; i += 2)
+  {
+    if (aabb1[i] > aabb2[i + 1] || aabb2[i] > aabb1[i + 1])
+      return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the geoms of a collision.
+/// \param[in] _collision The collision.
+/// \return Its collision id followed by its sub collisions.
+static std::vector<dGeomID> CollisionGeoms(const ODECollision *_collision)
+{
+  std::vector<dGeomID> geoms(1, _collision->GetCollisionId());
+  geoms.insert(geoms.end(), _collision->SubCollisionIds().begin(),
+      _collision->SubCollisionIds().end());
+  return geoms;
+}
+
+//////////////////////////////////////////////////
+/// \brief Find whether a pair of geoms reported by the broadphase is the
+/// first overlapping pair of geoms of their collisions, so that
+/// collisions made of several geoms are only added once.
+/// \param[in] _collision1 Collision of the first geom.
+/// \param[in] _geom1 First geom.
+/// \param[in] _collision2 Collision of the second geom.
+/// \param[in] _geom2 Second geom.
+/// \return True if the collisions should be added for this pair.
+static bool FirstGeomPair(const ODECollision *_collision1, dGeomID _geom1,
+    const ODECollision *_collision2, dGeomID _geom2)
+{
+  if (_collision1->SubCollisionIds().empty() &&
+      _collision2->SubCollisionIds().empty())
+  {
+    return true;
+  }
+
+  for (auto geom1 : CollisionGeoms(_collision1))
+  {
+    for (auto geom2 : CollisionGeoms(_collision2))
+    {
+      if (AabbsOverlap(geom1, geom2))
+        return geom1 == _geom1 && geom2 == _geom2;
+    }
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Generate the contacts of two collisions, colliding each pair
+/// of their geoms whose bounding boxes overlap.
+/// \param[in] _collision1 First collision.
+/// \param[in] _collision2 Second collision.
+/// \param[in] _fcl True to collide pairs of triangle meshes with FCL.
+/// \param[out] _contacts Buffer of MAX_COLLIDE_RETURNS contacts.
+/// \return Number of contacts.
+static unsigned int CollideGeoms(const ODECollision *_collision1,
+    const ODECollision *_collision2, const bool _fcl,
+    dContactGeom *_contacts)
+{
+  // Static meshes with a distance field answer the queries of the
+  // geoms they can sample
+  if (_collision1->GetCollisionClass() == dTriMeshClass ||
+      _collision2->GetCollisionClass() == dTriMeshClass)
+  {
+    int numc = ODEMesh::CollideDistanceField(_collision1->GetCollisionId(),
+        _collision2->GetCollisionId(), MAX_COLLIDE_RETURNS, _contacts);
+    if (numc >= 0)
+      return numc;
+  }
+
+  if (_fcl && _collision1->GetCollisionClass() == dTriMeshClass &&
+      _collision2->GetCollisionClass() == dTriMeshClass)
+  {
+    int numc = ODEMesh::CollideFCL(_collision1->GetCollisionId(),
+        _collision2->GetCollisionId(), MAX_COLLIDE_RETURNS, _contacts);
+    if (numc >= 0)
+      return numc;
+  }
+
+  if (_collision1->SubCollisionIds().empty() &&
+      _collision2->SubCollisionIds().empty())
+  {
+    return dCollide(_collision1->GetCollisionId(),
+        _collision2->GetCollisionId(), MAX_COLLIDE_RETURNS, _contacts,
+        sizeof(_contacts[0]));
+  }
+
+  unsigned int numc = 0;
+  for (auto geom1 : CollisionGeoms(_collision1))
+  {
+    for (auto geom2 : CollisionGeoms(_collision2))
+    {
+      if (numc >= MAX_COLLIDE_RETURNS)
+        return numc;
+      if (AabbsOverlap(geom1, geom2))
+      {
+        numc += dCollide(geom1, geom2, MAX_COLLIDE_RETURNS - numc,
+            _contacts + numc, sizeof(_contacts[0]));
+      }
+    }
+  }
+  return numc;
+}
+
+//////////////////////////////////////////////////
+/// \brief Same test as ODE spaces do on the geoms of overlapping bounding
+/// boxes, before calling the near callback.
+/// \param[in] _e1 First geom.
+/// \param[in] _e2 Second geom.
+/// \return True if the geoms may collide.
+static bool BroadphaseFilter(const ODEBroadphaseEntry &_e1,
+    const ODEBroadphaseEntry &_e2)
+{
+  if (!_e1.enabled || !_e2.enabled)
+    return false;
+
+  if (_e1.body && _e1.body == _e2.body)
+    return false;
+
+  return (_e1.category & _e2.collide) != 0 ||
+         (_e2.category & _e1.collide) != 0;
+}
+
+//////////////////////////////////////////////////
+/// \brief Check whether the bounding boxes of two geoms overlap.
+/// \param[in] _e1 First geom.
+/// \param[in] _e2 Second geom.
+/// \return True if they overlap or touch.
+static bool BroadphaseBoxesOverlap(const ODEBroadphaseEntry &_e1,
+    const ODEBroadphaseEntry &_e2)
+{
+  return !(_e1.aabb[0] > _e2.aabb[1] || _e1.aabb[1] < _e2.aabb[0] ||
+           _e1.aabb[2] > _e2.aabb[3] || _e1.aabb[3] < _e2.aabb[2] ||
+           _e1.aabb[4] > _e2.aabb[5] || _e1.aabb[5] < _e2.aabb[4]);
+}
+
+//////////////////////////////////////////////////
+/// \brief Order of the endpoints along an axis. Lower bounds go first on
+/// ties, so that touching boxes overlap.
+/// \param[in] _a First endpoint.
+/// \param[in] _b Second endpoint.
+/// \return True if _a goes before _b.
+static bool BroadphaseEndpointLess(const ODEBroadphaseEndpoint &_a,
+    const ODEBroadphaseEndpoint &_b)
+{
+  return _a.value < _b.value ||
+      (_a.value == _b.value && !_a.max && _b.max);
+}
+
+//////////////////////////////////////////////////
+/// \brief Add a pair of overlapping geoms, if it isn't there already.
+/// \param[in,out] _data Broadphase data.
+/// \param[in] _e1 First geom.
+/// \param[in] _e2 Second geom.
+static void AddBroadphasePair(ODEPhysicsPrivate &_data,
+    ODEBroadphaseEntry *_e1, ODEBroadphaseEntry *_e2)
+{
+  const ODEBroadphasePair pair = _e1->id < _e2->id ?
+      std::make_pair(_e1, _e2) : std::make_pair(_e2, _e1);
+  if (_data.broadphasePairIndex.emplace(pair,
+        _data.broadphasePairs.size()).second)
+  {
+    _data.broadphasePairs.push_back(pair);
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Remove a pair of geoms, if it's there.
+/// \param[in,out] _data Broadphase data.
+/// \param[in] _e1 First geom.
+/// \param[in] _e2 Second geom.
+static void RemoveBroadphasePair(ODEPhysicsPrivate &_data,
+    ODEBroadphaseEntry *_e1, ODEBroadphaseEntry *_e2)
+{
+  const ODEBroadphasePair pair = _e1->id < _e2->id ?
+      std::make_pair(_e1, _e2) : std::make_pair(_e2, _e1);
+  auto iter = _data.broadphasePairIndex.find(pair);
+  if (iter == _data.broadphasePairIndex.end())
+    return;
+
+  // Move the last pair in its place
+  auto &pairs = _data.broadphasePairs;
+  const size_t index = iter->second;
+  _data.broadphasePairIndex.erase(iter);
+  if (index + 1 != pairs.size())
+  {
+    pairs[index] = pairs.back();
+    _data.broadphasePairIndex[pairs[index]] = index;
+  }
+  pairs.pop_back();
+}
+
+//////////////////////////////////////////////////
+/// \brief Move an endpoint to its place along its axis, after the bounding
+/// box of its geom changed. Passing an endpoint of another geom is the only
+/// way the two boxes can start or stop overlapping, so a pair is added or
+/// removed then.
+/// \param[in,out] _data Broadphase data.
+/// \param[in] _axis Axis of the endpoint.
+/// \param[in] _index Index of the endpoint.
+static void MoveBroadphaseEndpoint(ODEPhysicsPrivate &_data, const int _axis,
+    size_t _index)
+{
+  auto &list = _data.broadphaseEndpoints[_axis];
+  const ODEBroadphaseEndpoint moving = list[_index];
+
+  // Insertion sort passes to the left, then to the right
+  while (_index > 0 && BroadphaseEndpointLess(moving, list[_index-1]))
+  {
+    const ODEBroadphaseEndpoint &other = list[_index-1];
+    if (other.entry != moving.entry)
+    {
+      if (!moving.max && other.max)
+      {
+        if (BroadphaseBoxesOverlap(*moving.entry, *other.entry))
+          AddBroadphasePair(_data, moving.entry, other.entry);
+      }
+      else if (moving.max && !other.max)
+        RemoveBroadphasePair(_data, moving.entry, other.entry);
+    }
+    list[_index] = other;
+    other.entry->endpoints[2 * _axis + other.max] = _index;
+    --_index;
+  }
+
+  while (_index + 1 < list.size() &&
+      BroadphaseEndpointLess(list[_index+1], moving))
+  {
+    const ODEBroadphaseEndpoint &other = list[_index+1];
+    if (other.entry != moving.entry)
+    {
+      if (moving.max && !other.max)
+      {
+        if (BroadphaseBoxesOverlap(*moving.entry, *other.entry))
+          AddBroadphasePair(_data, moving.entry, other.entry);
+      }
+      else if (!moving.max && other.max)
+        RemoveBroadphasePair(_data, moving.entry, other.entry);
+    }
+    list[_index] = other;
+    other.entry->endpoints[2 * _axis + other.max] = _index;
+    ++_index;
+  }
+
+  list[_index] = moving;
+  moving.entry->endpoints[2 * _axis + moving.max] = _index;
+}
+
+//////////////////////////////////////////////////
+/// \brief Set the bounding box of a geom and move its endpoints.
+/// \param[in,out] _data Broadphase data.
+/// \param[in,out] _entry The geom.
+/// \param[in] _aabb New bounding box.
+static void MoveBroadphaseEntry(ODEPhysicsPrivate &_data,
+    ODEBroadphaseEntry &_entry, const dReal _aabb[6])
+{
+  // A box moving up an axis moves its upper bound first, so that its lower
+  // bound doesn't stop at it
+  bool up[3];
+  for (int axis = 0; axis < 3; ++axis)
+    up[axis] = _aabb[2 * axis] > _entry.aabb[2 * axis];
+
+  // The whole box is updated first, so that the overlap tests see it
+  std::memcpy(_entry.aabb, _aabb, sizeof(_entry.aabb));
+  for (int i = 0; i < 6; ++i)
+    _data.broadphaseEndpoints[i / 2][_entry.endpoints[i]].value = _aabb[i];
+
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    const int first = up[axis] ? 1 : 0;
+    MoveBroadphaseEndpoint(_data, axis, _entry.endpoints[2 * axis + first]);
+    MoveBroadphaseEndpoint(_data, axis,
+        _entry.endpoints[2 * axis + 1 - first]);
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Add a geom to the endpoints. It starts past the end of every
+/// axis, where it overlaps nothing, and is moved to its bounding box.
+/// \param[in,out] _data Broadphase data.
+/// \param[in,out] _entry The geom.
+/// \param[in] _aabb Bounding box of the geom.
+static void InsertBroadphaseEntry(ODEPhysicsPrivate &_data,
+    ODEBroadphaseEntry &_entry, const dReal _aabb[6])
+{
+  for (int i = 0; i < 6; ++i)
+  {
+    auto &list = _data.broadphaseEndpoints[i / 2];
+    ODEBroadphaseEndpoint endpoint;
+    endpoint.value = std::numeric_limits<dReal>::max();
+    endpoint.entry = &_entry;
+    endpoint.max = i % 2 == 1;
+    _entry.aabb[i] = endpoint.value;
+    _entry.endpoints[i] = list.size();
+    list.push_back(endpoint);
+  }
+  MoveBroadphaseEntry(_data, _entry, _aabb);
+}
+
+//////////////////////////////////////////////////
+/// \brief Sort all the endpoints and find all the overlapping pairs.
+/// \param[in,out] _data Broadphase data.
+/// \param[in] _entries All the geoms, in the order of the space.
+static void RebuildBroadphase(ODEPhysicsPrivate &_data,
+    const std::vector<ODEBroadphaseEntry *> &_entries)
+{
+  _data.broadphasePairs.clear();
+  _data.broadphasePairIndex.clear();
+
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    auto &list = _data.broadphaseEndpoints[axis];
+    list.clear();
+    for (auto entry : _entries)
+    {
+      for (int max = 0; max < 2; ++max)
+      {
+        ODEBroadphaseEndpoint endpoint;
+        endpoint.value = entry->aabb[2 * axis + max];
+        endpoint.entry = entry;
+        endpoint.max = max == 1;
+        list.push_back(endpoint);
+      }
+    }
+    std::stable_sort(list.begin(), list.end(), BroadphaseEndpointLess);
+    for (size_t i = 0; i < list.size(); ++i)
+      list[i].entry->endpoints[2 * axis + list[i].max] = i;
+  }
+
+  // Sweep along x
+  const auto &list = _data.broadphaseEndpoints[0];
+  for (size_t i = 0; i < list.size(); ++i)
+  {
+    if (list[i].max)
+      continue;
+
+    ODEBroadphaseEntry *entry1 = list[i].entry;
+    for (size_t j = i + 1; list[j].entry != entry1; ++j)
+    {
+      if (!list[j].max &&
+          BroadphaseBoxesOverlap(*entry1, *list[j].entry))
+      {
+        AddBroadphasePair(_data, entry1, list[j].entry);
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Remove the geoms which left the space.
+/// \param[in,out] _data Broadphase data.
+/// \param[in] _step Current broadphase step.
+static void RemoveStaleBroadphaseEntries(ODEPhysicsPrivate &_data,
+    const uint64_t _step)
+{
+  auto stale = [_step](const ODEBroadphaseEntry *_entry)
+  {
+    return _entry->step != _step;
+  };
+
+  auto &pairs = _data.broadphasePairs;
+  pairs.erase(std::remove_if(pairs.begin(), pairs.end(),
+      [&stale](const ODEBroadphasePair &_pair)
+      {
+        return stale(_pair.first) || stale(_pair.second);
+      }), pairs.end());
+  _data.broadphasePairIndex.clear();
+  for (size_t i = 0; i < pairs.size(); ++i)
+    _data.broadphasePairIndex[pairs[i]] = i;
+
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    auto &list = _data.broadphaseEndpoints[axis];
+    list.erase(std::remove_if(list.begin(), list.end(),
+        [&stale](const ODEBroadphaseEndpoint &_endpoint)
+        {
+          return stale(_endpoint.entry);
+        }), list.end());
+    for (size_t i = 0; i < list.size(); ++i)
+      list[i].entry->endpoints[2 * axis + list[i].max] = i;
+  }
+
+  for (auto iter = _data.broadphaseEntries.begin();
+       iter != _data.broadphaseEntries.end();)
+  {
+    if (stale(&iter->second))
+      iter = _data.broadphaseEntries.erase(iter);
+    else
+      ++iter;
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Check whether a geom contains an enabled body, once per step.
+/// \param[in,out] _entry The geom.
+/// \param[in] _step Current broadphase step.
+/// \return True if a body of the geom is enabled.
+static bool BroadphaseEntryActive(ODEBroadphaseEntry &_entry,
+    const uint64_t _step)
+{
+  if (_entry.activeStep != _step)
+  {
+    _entry.activeStep = _step;
+    _entry.active = false;
+    for (auto const &body : _entry.bodies)
+    {
+      if (dBodyIsEnabled(body))
+      {
+        _entry.active = true;
+        break;
+      }
+    }
+  }
+  return _entry.active;
+}
+
+//////////////////////////////////////////////////
+/// \brief Check whether a collision can be collided from any thread.
+/// ODE heightfields and trimeshes keep temporary buffers in the geom.
+/// \param[in] _collision Collision to check.
+/// \return True if the collision can be collided in parallel.
+static bool ParallelCollideSafe(const ODECollision *_collision)
+{
+  return !_collision->HasType(Base::HEIGHTMAP_SHAPE) &&
+         !_collision->HasType(Base::POLYLINE_SHAPE) &&
+         !_collision->HasType(Base::MESH_SHAPE);
+}
+
 /*
 class ContactUpdate_TBB
 {
@@ -229,6 +776,42 @@ void ODEPhysics::Load(sdf::ElementPtr _sdf)
     this->GetSORPGSIters());
   dWorldSetQuickStepW(this->dataPtr->worldId, this->GetSORPGSW());
 
+  // The collision narrowphase runs on the physics thread unless
+  // <gz:collision_threads> is set. See SetCollisionThreads.
+  if (odeElem->HasElement("gz:collision_threads"))
+    this->SetCollisionThreads(odeElem->Get<int>("gz:collision_threads"));
+
+  // ODE's hash space finds the colliding pairs from scratch every step,
+  // unless <gz:pair_cache> is set. See SetPairCache.
+  if (odeElem->HasElement("gz:pair_cache"))
+    this->SetPairCache(odeElem->Get<bool>("gz:pair_cache"));
+
+  // Contacts start their solve from zero forces unless
+  // <gz:contact_warm_start> is set. See SetContactWarmStart.
+  if (odeElem->HasElement("gz:contact_warm_start"))
+    this->SetContactWarmStart(odeElem->Get<bool>("gz:contact_warm_start"));
+
+  // The world space is a hash space with levels -2 to 8 unless
+  // <gz:space_type> or the hash parameters are set. See SetSpaceType.
+  if (odeElem->HasElement("gz:hash_min_level") ||
+      odeElem->HasElement("gz:hash_max_level"))
+  {
+    this->SetHashLevels(
+        odeElem->Get<int>("gz:hash_min_level", this->dataPtr->hashMinLevel)
+        .first,
+        odeElem->Get<int>("gz:hash_max_level", this->dataPtr->hashMaxLevel)
+        .first);
+  }
+  if (odeElem->HasElement("gz:hash_auto_levels"))
+    this->SetHashAutoLevels(odeElem->Get<bool>("gz:hash_auto_levels"));
+  if (odeElem->HasElement("gz:space_type"))
+    this->SetSpaceType(odeElem->Get<std::string>("gz:space_type"));
+
+  // Triangle meshes collide with ODE's trimesh collider unless
+  // <gz:mesh_collider> is set. See SetMeshCollider.
+  if (odeElem->HasElement("gz:mesh_collider"))
+    this->SetMeshCollider(odeElem->Get<std::string>("gz:mesh_collider"));
+
   // Set the physics update function
   this->SetStepType(this->dataPtr->stepType);
   if (this->dataPtr->physicsStepFunc == nullptr)
@@ -277,6 +860,17 @@ void ODEPhysics::OnRequest(ConstRequestPtr &_msg)
     physicsMsg.set_real_time_update_rate(this->realTimeUpdateRate);
     physicsMsg.set_real_time_factor(this->targetRealTimeFactor);
     physicsMsg.set_max_step_size(this->maxStepSize);
+    physicsMsg.set_solver_time(this->dataPtr->solverTime);
+    if (this->dataPtr->solverSteps > 0)
+    {
+      physicsMsg.set_solver_time_mean(this->dataPtr->solverTimeTotal /
+          this->dataPtr->solverSteps);
+    }
+    physicsMsg.set_space_type(this->dataPtr->spaceType);
+    physicsMsg.set_hash_min_level(this->dataPtr->hashMinLevel);
+    physicsMsg.set_hash_max_level(this->dataPtr->hashMaxLevel);
+    physicsMsg.set_hash_auto_levels(this->dataPtr->hashAutoLevels);
+    physicsMsg.set_mesh_collider(this->dataPtr->meshCollider);
 
     response.set_type(physicsMsg.GetTypeName());
     physicsMsg.SerializeToString(serializedData);
@@ -304,110 +898,992 @@ void ODEPhysics::OnPhysicsMsg(ConstPhysicsPtr &_msg)
   if (_msg->has_iters())
     this->SetSORPGSIters(_msg->iters());
 
-  if (_msg->has_sor())
-    this->SetSORPGSW(_msg->sor());
+  if (_msg->has_sor())
+    this->SetSORPGSW(_msg->sor());
+
+  if (_msg->has_cfm())
+    this->SetWorldCFM(_msg->cfm());
+
+  if (_msg->has_erp())
+    this->SetWorldERP(_msg->erp());
+
+  if (_msg->has_enable_physics())
+    this->world->SetPhysicsEnabled(_msg->enable_physics());
+
+  if (_msg->has_contact_max_correcting_vel())
+    this->SetContactMaxCorrectingVel(_msg->contact_max_correcting_vel());
+
+  if (_msg->has_contact_surface_layer())
+    this->SetContactSurfaceLayer(_msg->contact_surface_layer());
+
+  if (_msg->has_gravity())
+    this->SetGravity(msgs::ConvertIgn(_msg->gravity()));
+
+  if (_msg->has_real_time_factor())
+    this->SetTargetRealTimeFactor(_msg->real_time_factor());
+
+  if (_msg->has_real_time_update_rate())
+  {
+    this->SetRealTimeUpdateRate(_msg->real_time_update_rate());
+  }
+
+  if (_msg->has_max_step_size())
+  {
+    this->SetMaxStepSize(_msg->max_step_size());
+  }
+
+  if (_msg->has_space_type())
+    this->SetSpaceType(_msg->space_type());
+
+  if (_msg->has_mesh_collider())
+    this->SetMeshCollider(_msg->mesh_collider());
+
+  if (_msg->has_hash_min_level() || _msg->has_hash_max_level())
+  {
+    this->SetHashLevels(
+        _msg->has_hash_min_level() ? _msg->hash_min_level() :
+        this->dataPtr->hashMinLevel,
+        _msg->has_hash_max_level() ? _msg->hash_max_level() :
+        this->dataPtr->hashMaxLevel);
+  }
+
+  if (_msg->has_hash_auto_levels())
+    this->SetHashAutoLevels(_msg->hash_auto_levels());
+
+  /// Make sure all models get at least on update cycle.
+  this->world->EnableAllModels();
+}
+
+
+
+//////////////////////////////////////////////////
+void ODEPhysics::Init()
+{
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::InitForThread()
+{
+  dAllocateODEDataForThread(dAllocateMaskAll);
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::UpdateCollision()
+{
+  GZ_PROFILE("ODEPhysics::UpdateCollision");
+  DIAG_TIMER_START("ODEPhysics::UpdateCollision");
+
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+  dJointGroupEmpty(this->dataPtr->contactGroup);
+  this->dataPtr->stepContacts.clear();
+  this->dataPtr->warmStartedContacts = 0;
+
+  if (!this->dataPtr->multiRateModels.empty())
+    this->ParkMultiRateModels();
+
+  unsigned int i = 0;
+  this->dataPtr->collidersCount = 0;
+  this->dataPtr->trimeshCollidersCount = 0;
+  this->dataPtr->jointFeedbackIndex = 0;
+
+  // Reset the contact count
+  this->contactManager->ResetCount();
+
+  if (this->dataPtr->spaceRebuild)
+    this->RebuildSpace();
+
+  if (this->dataPtr->hashAutoLevels && this->dataPtr->spaceType == "hash")
+  {
+    const int count = dSpaceGetNumGeoms(this->dataPtr->spaceId);
+    const int tuned = this->dataPtr->hashTunedCount;
+    if (count > 0 && std::abs(count - tuned) * 4 > tuned)
+      this->TuneHashLevels();
+  }
+
+  // Do collision detection; this will add contacts to the contact group
+  if (this->dataPtr->pairCache)
+    this->UpdateBroadphase();
+  else
+    dSpaceCollide(this->dataPtr->spaceId, this, CollisionCallback);
+  DIAG_TIMER_LAP("ODEPhysics::UpdateCollision", "dSpaceCollide");
+
+  // Generate non-trimesh collisions.
+  if (this->dataPtr->collisionArena &&
+      this->dataPtr->collidersCount >= kMinParallelColliders)
+  {
+    this->CollideParallel();
+  }
+  else
+  {
+    for (i = 0; i < this->dataPtr->collidersCount; ++i)
+    {
+      this->Collide(this->dataPtr->colliders[i].first,
+          this->dataPtr->colliders[i].second,
+          this->dataPtr->contactCollisions);
+    }
+  }
+  DIAG_TIMER_LAP("ODEPhysics::UpdateCollision", "collideShapes");
+
+  // Generate trimesh collision.
+  // This must happen in this thread sequentially
+  for (i = 0; i < this->dataPtr->trimeshCollidersCount; ++i)
+  {
+    ODECollision *collision1 = this->dataPtr->trimeshColliders[i].first;
+    ODECollision *collision2 = this->dataPtr->trimeshColliders[i].second;
+    this->Collide(collision1, collision2, this->dataPtr->contactCollisions);
+  }
+  DIAG_TIMER_LAP("ODEPhysics::UpdateCollision", "collideTrimeshes");
+
+  DIAG_TIMER_STOP("ODEPhysics::UpdateCollision");
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::UpdateBroadphase()
+{
+  auto &entries = this->dataPtr->broadphaseEntries;
+  const uint64_t step = ++this->dataPtr->broadphaseStep;
+  const bool rebuild = !this->dataPtr->broadphasePairsValid;
+
+  // Recompute the bounding boxes of the geoms that moved
+  dSpaceClean(this->dataPtr->spaceId);
+
+  std::vector<ODEBroadphaseEntry *> rebuildEntries;
+  const int count = dSpaceGetNumGeoms(this->dataPtr->spaceId);
+  for (int i = 0; i < count; ++i)
+  {
+    dGeomID geom = dSpaceGetGeom(this->dataPtr->spaceId, i);
+    auto inserted = entries.emplace(geom, ODEBroadphaseEntry());
+    ODEBroadphaseEntry &entry = inserted.first->second;
+    if (inserted.second)
+    {
+      entry.geom = geom;
+      entry.id = ++this->dataPtr->broadphaseEntryCount;
+    }
+    entry.step = step;
+    entry.body = dGeomGetBody(geom);
+    entry.enabled = dGeomIsEnabled(geom) != 0;
+    entry.category = dGeomGetCategoryBits(geom);
+    entry.collide = dGeomGetCollideBits(geom);
+
+    // The bodies are only collected again when the geoms of a model space
+    // are added or removed
+    const int geomCount = dGeomIsSpace(geom) ?
+        dSpaceGetNumGeoms(reinterpret_cast<dSpaceID>(geom)) : 0;
+    if (inserted.second || geomCount != entry.geomCount)
+    {
+      entry.geomCount = geomCount;
+      entry.bodies.clear();
+      entry.sensor = false;
+      entry.activeStep = 0;
+      ScanBroadphaseGeom(geom, entry.bodies, entry.sensor);
+    }
+
+    dReal aabb[6];
+    dGeomGetAABB(geom, aabb);
+    if (rebuild)
+    {
+      std::memcpy(entry.aabb, aabb, sizeof(entry.aabb));
+      rebuildEntries.push_back(&entry);
+    }
+    else if (inserted.second)
+      InsertBroadphaseEntry(*this->dataPtr, entry, aabb);
+    else if (std::memcmp(aabb, entry.aabb, sizeof(entry.aabb)) != 0)
+      MoveBroadphaseEntry(*this->dataPtr, entry, aabb);
+  }
+
+  // Forget the geoms that were removed from the space
+  if (entries.size() != static_cast<size_t>(count))
+    RemoveStaleBroadphaseEntries(*this->dataPtr, step);
+
+  if (rebuild)
+  {
+    RebuildBroadphase(*this->dataPtr, rebuildEntries);
+    this->dataPtr->broadphasePairsValid = true;
+  }
+
+  // Pairs without any enabled body don't generate contacts, see
+  // CollisionCallback, unless contacts are needed by subscribers or sensors.
+  const bool skipInactive = !this->contactManager->NeverDropContacts() &&
+      this->contactManager->GetFilterCount() == 0 &&
+      !this->contactManager->SubscribersConnected(nullptr, nullptr);
+
+  for (auto const &pair : this->dataPtr->broadphasePairs)
+  {
+    if (!BroadphaseFilter(*pair.first, *pair.second))
+      continue;
+
+    if (skipInactive && !pair.first->sensor && !pair.second->sensor &&
+        !BroadphaseEntryActive(*pair.first, step) &&
+        !BroadphaseEntryActive(*pair.second, step))
+    {
+      continue;
+    }
+    CollisionCallback(this, pair.first->geom, pair.second->geom);
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Collect the ODE bodies of a model and its nested models.
+/// \param[in] _model The model.
+/// \param[out] _bodies Vector receiving the bodies.
+static void CollectModelBodies(const ModelPtr &_model,
+    std::vector<dBodyID> &_bodies)
+{
+  for (auto const &link : _model->GetLinks())
+  {
+    ODELinkPtr odeLink = boost::dynamic_pointer_cast<ODELink>(link);
+    if (odeLink && odeLink->GetODEId())
+      _bodies.push_back(odeLink->GetODEId());
+  }
+
+  for (auto const &model : _model->NestedModels())
+    CollectModelBodies(model, _bodies);
+}
+
+//////////////////////////////////////////////////
+bool ODEPhysics::SetModelStepMultiple(ModelPtr _model,
+    const unsigned int _multiple)
+{
+  if (!_model || _multiple == 0)
+    return false;
+
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+
+  auto &models = this->dataPtr->multiRateModels;
+  auto iter = std::find_if(models.begin(), models.end(),
+      [&_model](const ODEMultiRateModel &_entry)
+      {
+        return _entry.model.lock() == _model;
+      });
+
+  if (_multiple == 1)
+  {
+    if (iter != models.end())
+      models.erase(iter);
+    return true;
+  }
+
+  if (iter == models.end())
+  {
+    models.push_back(ODEMultiRateModel());
+    iter = models.end() - 1;
+    iter->model = _model;
+  }
+  iter->multiple = _multiple;
+  iter->pending = 0;
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::ParkMultiRateModels()
+{
+  // Bodies left disabled by an update without a physics step.
+  this->UnparkMultiRateModels();
+
+  auto &models = this->dataPtr->multiRateModels;
+  for (size_t i = 0; i < models.size();)
+  {
+    ModelPtr model = models[i].model.lock();
+    if (!model)
+    {
+      models.erase(models.begin() + i);
+      continue;
+    }
+
+    ODEMultiRateModel &entry = models[i];
+    entry.bodies.clear();
+    CollectModelBodies(model, entry.bodies);
+
+    entry.pending += this->maxStepSize;
+    entry.due = entry.pending >= (entry.multiple - 0.5) * this->maxStepSize;
+    if (!entry.due)
+      this->ParkMultiRateBodies(i);
+    ++i;
+  }
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::ParkMultiRateBodies(const size_t _index)
+{
+  for (auto const &body : this->dataPtr->multiRateModels[_index].bodies)
+  {
+    if (!dBodyIsEnabled(body))
+      continue;
+
+    dBodyDisable(body);
+    ODEParkedBody parked;
+    parked.body = body;
+    parked.model = _index;
+    this->dataPtr->parkedBodies.push_back(parked);
+  }
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::StepMultiRateModels()
+{
+  auto &models = this->dataPtr->multiRateModels;
+  auto &parked = this->dataPtr->parkedBodies;
+
+  // ODE enables disabled bodies that are connected to enabled ones through
+  // contacts or joints. These were stepped at the world rate.
+  for (auto &p : parked)
+  {
+    if (dBodyIsEnabled(p.body))
+    {
+      p.stepped = true;
+      models[p.model].pending = 0;
+      models[p.model].due = false;
+    }
+  }
+
+  // Models that are due together with the same step size share a step.
+  std::vector<size_t> due;
+  for (size_t i = 0; i < models.size(); ++i)
+  {
+    if (models[i].due)
+      due.push_back(i);
+  }
+  std::sort(due.begin(), due.end(), [&models](size_t _a, size_t _b)
+      {
+        return models[_a].pending < models[_b].pending;
+      });
+
+  const double tol = 1e-3 * this->maxStepSize;
+  for (size_t k = 0; k < due.size(); ++k)
+  {
+    if (!models[due[k]].due)
+      continue;
+
+    // Mark the group with a negative pending time.
+    const double stepSize = models[due[k]].pending;
+    for (size_t i = k; i < due.size(); ++i)
+    {
+      ODEMultiRateModel &entry = models[due[i]];
+      if (entry.due && entry.pending - stepSize < tol)
+      {
+        entry.due = false;
+        entry.pending = -1;
+      }
+    }
+
+    // Hold the bodies that already took the world step.
+    this->dataPtr->heldBodies.clear();
+    for (dBodyID body = dWorldGetFirstBody(this->dataPtr->worldId); body;
+         body = dBodyGetNextBody(body))
+    {
+      if (dBodyIsEnabled(body))
+      {
+        dBodyDisable(body);
+        this->dataPtr->heldBodies.push_back(body);
+      }
+    }
+
+    bool enabled = false;
+    for (auto &p : parked)
+    {
+      if (!p.stepped && models[p.model].pending < 0)
+      {
+        p.stepped = true;
+        dBodyResume(p.body);
+        enabled = true;
+      }
+    }
+
+    if (enabled)
+    {
+      this->StepWorld(stepSize);
+
+      // Bodies of other multi-rate models pulled in through contacts were
+      // stepped as well.
+      for (auto &p : parked)
+      {
+        if (!p.stepped && dBodyIsEnabled(p.body))
+        {
+          p.stepped = true;
+          models[p.model].pending = 0;
+          models[p.model].due = false;
+        }
+      }
+    }
+
+    for (auto &entry : models)
+    {
+      if (entry.pending < 0)
+        entry.pending = 0;
+    }
+
+    // dBodyEnable would restart the auto-disable countdown of every body
+    // in the world each time a multi-rate model is stepped.
+    for (auto const &body : this->dataPtr->heldBodies)
+      dBodyResume(body);
+    this->dataPtr->heldBodies.clear();
+  }
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::UnparkMultiRateModels()
+{
+  for (auto const &p : this->dataPtr->parkedBodies)
+  {
+    // Stepped bodies keep the state ODE left them in, e.g. auto disabled.
+    if (!p.stepped)
+      dBodyResume(p.body);
+  }
+  this->dataPtr->parkedBodies.clear();
+}
+
+//////////////////////////////////////////////////
+bool ODEPhysics::SetLinkContinuousCollision(LinkPtr _link,
+    const bool _enable)
+{
+  if (!_link)
+    return false;
+
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+
+  auto &links = this->dataPtr->continuousLinks;
+  auto iter = std::find_if(links.begin(), links.end(),
+      [&_link](const ODEContinuousLink &_entry)
+      {
+        return _entry.link.lock() == _link;
+      });
+
+  if (!_enable)
+  {
+    if (iter != links.end())
+      links.erase(iter);
+  }
+  else if (iter == links.end())
+  {
+    links.push_back(ODEContinuousLink());
+    links.back().link = _link;
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Geoms hit by a swept geom.
+class ODESweep
+{
+  /// \brief The swept geom.
+  public: dGeomID geom = nullptr;
+
+  /// \brief Radius of the swept sphere.
+  public: double radius = 0;
+
+  /// \brief Body of the swept link, its geoms are not hit.
+  public: dBodyID body = nullptr;
+
+  /// \brief Category bits of the swept link.
+  public: unsigned int category = 0;
+
+  /// \brief Collide bits of the swept link.
+  public: unsigned int collide = 0;
+
+  /// \brief Geoms that are not hit, e.g. because they already touch the
+  /// link at the start of the sweep.
+  public: std::vector<dGeomID> ignored;
+
+  /// \brief Geoms hit by the swept geom.
+  public: std::vector<dGeomID> hits;
+};
+
+//////////////////////////////////////////////////
+/// \brief dSpaceCollide2 callback of a swept geom, collecting the geoms it
+/// intersects, recursing into spaces.
+/// \param[in] _data The ODESweep.
+/// \param[in] _o1 First geom.
+/// \param[in] _o2 Second geom.
+static void SweepCallback(void *_data, dGeomID _o1, dGeomID _o2)
+{
+  ODESweep *sweep = static_cast<ODESweep *>(_data);
+  dGeomID other = _o1 == sweep->geom ? _o2 : _o1;
+
+  if (dGeomIsSpace(other))
+  {
+    dSpaceCollide2(sweep->geom, other, _data, &SweepCallback);
+    return;
+  }
+
+  if (dGeomGetBody(other) == sweep->body ||
+      dGeomGetCategoryBits(other) == GZ_SENSOR_COLLIDE)
+  {
+    return;
+  }
+
+  // Same filter as the ODE spaces
+  if (!(dGeomGetCategoryBits(other) & sweep->collide) &&
+      !(dGeomGetCollideBits(other) & sweep->category))
+  {
+    return;
+  }
+
+  ODECollision *collision = static_cast<ODECollision *>(dGeomGetData(other));
+  if (collision && collision->GetSurface()->collideWithoutContact)
+    return;
+
+  if (std::find(sweep->ignored.begin(), sweep->ignored.end(), other) !=
+      sweep->ignored.end())
+  {
+    return;
+  }
+
+  dContactGeom contact;
+  if (dCollide(sweep->geom, other, 1, &contact, sizeof(contact)) > 0)
+    sweep->hits.push_back(other);
+}
+
+//////////////////////////////////////////////////
+/// \brief Place a capsule between two points and collect the geoms of a
+/// space it hits.
+/// \param[in] _start Center of the first cap.
+/// \param[in] _end Center of the second cap.
+/// \param[in] _space Space to collide with.
+/// \param[in,out] _sweep Sweep whose geom is the capsule, hits are
+/// replaced.
+/// \return True if the capsule hits a geom.
+static bool SweepCapsule(const ignition::math::Vector3d &_start,
+    const ignition::math::Vector3d &_end, dSpaceID _space, ODESweep &_sweep)
+{
+  ignition::math::Vector3d axis = _end - _start;
+  const double length = axis.Length();
+  axis = length > 0 ? axis / length : ignition::math::Vector3d::UnitZ;
+
+  dMatrix3 rot;
+  dRFromZAxis(rot, axis.X(), axis.Y(), axis.Z());
+  const ignition::math::Vector3d center = 0.5 * (_start + _end);
+  dGeomSetPosition(_sweep.geom, center.X(), center.Y(), center.Z());
+  dGeomSetRotation(_sweep.geom, rot);
+  dGeomCapsuleSetParams(_sweep.geom, _sweep.radius, length);
+
+  _sweep.hits.clear();
+  dSpaceCollide2(_sweep.geom, reinterpret_cast<dGeomID>(_space), &_sweep,
+      &SweepCallback);
+  return !_sweep.hits.empty();
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::StartContinuousLinks()
+{
+  auto &links = this->dataPtr->continuousLinks;
+  for (size_t i = 0; i < links.size();)
+  {
+    LinkPtr link = links[i].link.lock();
+    if (!link)
+    {
+      links.erase(links.begin() + i);
+      continue;
+    }
+
+    ODEContinuousLink &entry = links[i++];
+    dBodyID body = boost::static_pointer_cast<ODELink>(link)->GetODEId();
+    entry.started = body && dBodyIsEnabled(body);
+    if (entry.started)
+    {
+      const dReal *p = dBodyGetPosition(body);
+      entry.start.Set(p[0], p[1], p[2]);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::SweepContinuousLinks()
+{
+  GZ_PROFILE("ODEPhysics::SweepContinuousLinks");
+
+  if (!this->dataPtr->sweepGeom)
+    this->dataPtr->sweepGeom = dCreateCapsule(nullptr, 1, 1);
+
+  for (auto &entry : this->dataPtr->continuousLinks)
+  {
+    LinkPtr link = entry.link.lock();
+    if (!entry.started || !link)
+      continue;
+
+    // The swept sphere fits in the bounding box of the link's collisions,
+    // a negative radius marks links without collisions.
+    if (ignition::math::equal(entry.radius, 0.0))
+    {
+      ignition::math::Vector3d size = link->BoundingBox().Size();
+      entry.radius = 0.5 * std::min(size.X(), std::min(size.Y(), size.Z()));
+      if (!std::isfinite(entry.radius) || entry.radius <= 0)
+        entry.radius = -1;
+    }
+    if (entry.radius < 0)
+      continue;
+
+    ODELinkPtr odeLink = boost::static_pointer_cast<ODELink>(link);
+    dBodyID body = odeLink->GetODEId();
+    const dReal *p = dBodyGetPosition(body);
+    const ignition::math::Vector3d end(p[0], p[1], p[2]);
+    const ignition::math::Vector3d motion = end - entry.start;
+
+    // Slower links collide at the end of the step before they can tunnel
+    if (motion.Length() <= entry.radius)
+      continue;
+
+    ODESweep sweep;
+    sweep.geom = this->dataPtr->sweepGeom;
+    sweep.radius = entry.radius;
+    sweep.body = body;
+    for (auto const &collision : link->GetCollisions())
+    {
+      dGeomID id = boost::static_pointer_cast<ODECollision>(
+          collision)->GetCollisionId();
+      if (id)
+      {
+        sweep.category |= dGeomGetCategoryBits(id);
+        sweep.collide |= dGeomGetCollideBits(id);
+      }
+    }
+
+    // Geoms the link touches before the step are handled by its contacts
+    SweepCapsule(entry.start, entry.start, this->dataPtr->spaceId, sweep);
+    sweep.ignored.swap(sweep.hits);
 
-  if (_msg->has_cfm())
-    this->SetWorldCFM(_msg->cfm());
+    if (!SweepCapsule(entry.start, end, this->dataPtr->spaceId, sweep))
+      continue;
 
-  if (_msg->has_erp())
-    this->SetWorldERP(_msg->erp());
+    // Conservative advancement to the first hit along the path, where the
+    // link overlaps the geom it tunneled through and gets contacts in the
+    // next step.
+    double safe = 0;
+    double hit = 1;
+    for (int i = 0; i < kSweepIterations; ++i)
+    {
+      const double mid = 0.5 * (safe + hit);
+      if (SweepCapsule(entry.start, entry.start + mid * motion,
+            this->dataPtr->spaceId, sweep))
+      {
+        hit = mid;
+      }
+      else
+      {
+        safe = mid;
+      }
+    }
 
-  if (_msg->has_enable_physics())
-    this->world->SetPhysicsEnabled(_msg->enable_physics());
+    const ignition::math::Vector3d pos = entry.start + hit * motion;
+    dBodySetPosition(body, pos.X(), pos.Y(), pos.Z());
+    odeLink->SyncBodyPose();
+  }
+}
 
-  if (_msg->has_contact_max_correcting_vel())
-    this->SetContactMaxCorrectingVel(_msg->contact_max_correcting_vel());
+//////////////////////////////////////////////////
+void ODEPhysics::SetPairCache(const bool _enable)
+{
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
 
-  if (_msg->has_contact_surface_layer())
-    this->SetContactSurfaceLayer(_msg->contact_surface_layer());
+  this->dataPtr->pairCache = _enable;
+  this->dataPtr->broadphasePairs.clear();
+  this->dataPtr->broadphasePairIndex.clear();
+  for (auto &list : this->dataPtr->broadphaseEndpoints)
+    list.clear();
+  this->dataPtr->broadphaseEntries.clear();
+  this->dataPtr->broadphasePairsValid = false;
+}
 
-  if (_msg->has_gravity())
-    this->SetGravity(msgs::ConvertIgn(_msg->gravity()));
+//////////////////////////////////////////////////
+void ODEPhysics::SetContactWarmStart(const bool _enable)
+{
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
 
-  if (_msg->has_real_time_factor())
-    this->SetTargetRealTimeFactor(_msg->real_time_factor());
+  this->dataPtr->contactWarmStart = _enable;
+  this->dataPtr->contactImpulses.clear();
+  this->dataPtr->stepContacts.clear();
+}
 
-  if (_msg->has_real_time_update_rate())
+//////////////////////////////////////////////////
+bool ODEPhysics::SetSpaceType(const std::string &_type)
+{
+  if (_type != "hash" && _type != "sap" && _type != "quadtree")
   {
-    this->SetRealTimeUpdateRate(_msg->real_time_update_rate());
+    gzerr << "Unknown ODE space type[" << _type
+          << "], expected hash, sap or quadtree" << std::endl;
+    return false;
   }
 
-  if (_msg->has_max_step_size())
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+  if (_type != this->dataPtr->spaceType)
   {
-    this->SetMaxStepSize(_msg->max_step_size());
+    this->dataPtr->spaceType = _type;
+    this->dataPtr->spaceRebuild = true;
   }
-
-  /// Make sure all models get at least on update cycle.
-  this->world->EnableAllModels();
+  return true;
 }
 
+//////////////////////////////////////////////////
+bool ODEPhysics::SetMeshCollider(const std::string &_collider)
+{
+  if (_collider != "ode" && _collider != "fcl")
+  {
+    gzerr << "Unknown ODE mesh collider[" << _collider
+          << "], expected ode or fcl" << std::endl;
+    return false;
+  }
+
+#ifndef HAVE_FCL
+  if (_collider == "fcl")
+  {
+    gzwarn << "Gazebo was built without the FCL mesh collider, "
+           << "set ENABLE_FCL to build it. Using the ode collider."
+           << std::endl;
+    return false;
+  }
+#endif
 
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+  this->dataPtr->meshCollider = _collider;
+  return true;
+}
 
 //////////////////////////////////////////////////
-void ODEPhysics::Init()
+void ODEPhysics::SetHashLevels(const int _min, const int _max)
 {
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+
+  this->dataPtr->hashMinLevel = std::min(_min, _max);
+  this->dataPtr->hashMaxLevel = std::max(_min, _max);
+  if (dSpaceGetClass(this->dataPtr->spaceId) == dHashSpaceClass)
+  {
+    dHashSpaceSetLevels(this->dataPtr->spaceId,
+        this->dataPtr->hashMinLevel, this->dataPtr->hashMaxLevel);
+  }
 }
 
 //////////////////////////////////////////////////
-void ODEPhysics::InitForThread()
+void ODEPhysics::SetHashAutoLevels(const bool _enable)
 {
-  dAllocateODEDataForThread(dAllocateMaskAll);
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+
+  this->dataPtr->hashAutoLevels = _enable;
+  this->dataPtr->hashTunedCount = 0;
 }
 
 //////////////////////////////////////////////////
-void ODEPhysics::UpdateCollision()
+void ODEPhysics::RebuildSpace()
 {
-  DIAG_TIMER_START("ODEPhysics::UpdateCollision");
+  this->dataPtr->spaceRebuild = false;
 
-  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
-  dJointGroupEmpty(this->dataPtr->contactGroup);
+  dSpaceID oldSpace = this->dataPtr->spaceId;
+  std::vector<dGeomID> geoms(dSpaceGetNumGeoms(oldSpace));
+  for (size_t i = 0; i < geoms.size(); ++i)
+    geoms[i] = dSpaceGetGeom(oldSpace, static_cast<int>(i));
 
-  unsigned int i = 0;
-  this->dataPtr->collidersCount = 0;
-  this->dataPtr->trimeshCollidersCount = 0;
-  this->dataPtr->jointFeedbackIndex = 0;
+  dSpaceID newSpace = nullptr;
+  if (this->dataPtr->spaceType == "sap")
+  {
+    newSpace = dSweepAndPruneSpaceCreate(0, dSAP_AXES_XYZ);
+  }
+  else if (this->dataPtr->spaceType == "quadtree")
+  {
+    // Cover the x-y bounds of the finite geoms, with some room to move.
+    // Geoms outside of the tree are still tested, against all the others.
+    ignition::math::Vector3d min(-50, -50, 0), max(50, 50, 0);
+    bool first = true;
+    for (auto geom : geoms)
+    {
+      dReal aabb[6];
+      dGeomGetAABB(geom, aabb);
+      if (aabb[0] <= -dInfinity || aabb[1] >= dInfinity ||
+          aabb[2] <= -dInfinity || aabb[3] >= dInfinity)
+      {
+        continue;
+      }
+      if (first)
+      {
+        min.Set(aabb[0], aabb[2], 0);
+        max.Set(aabb[1], aabb[3], 0);
+        first = false;
+      }
+      min.Min(ignition::math::Vector3d(aabb[0], aabb[2], 0));
+      max.Max(ignition::math::Vector3d(aabb[1], aabb[3], 0));
+    }
+    const ignition::math::Vector3d center = (min + max) * 0.5;
+    const ignition::math::Vector3d half = (max - min) * 0.75 +
+        ignition::math::Vector3d(1, 1, 0);
+    dVector3 odeCenter = {static_cast<dReal>(center.X()),
+        static_cast<dReal>(center.Y()), 0, 0};
+    dVector3 odeExtents = {static_cast<dReal>(half.X()),
+        static_cast<dReal>(half.Y()), 1, 0};
+    newSpace = dQuadTreeSpaceCreate(0, odeCenter, odeExtents,
+        kQuadTreeDepth);
+  }
+  else
+  {
+    newSpace = dHashSpaceCreate(0);
+    dHashSpaceSetLevels(newSpace, this->dataPtr->hashMinLevel,
+        this->dataPtr->hashMaxLevel);
+    this->dataPtr->hashTunedCount = 0;
+  }
 
-  // Reset the contact count
-  this->contactManager->ResetCount();
+  // The geoms keep their bodies, categories and sub-spaces
+  dSpaceSetCleanup(oldSpace, 0);
+  for (auto geom : geoms)
+  {
+    dSpaceRemove(oldSpace, geom);
+    dSpaceAdd(newSpace, geom);
+  }
+  dSpaceDestroy(oldSpace);
+  this->dataPtr->spaceId = newSpace;
+  this->dataPtr->broadphasePairsValid = false;
+}
 
-  // Do collision detection; this will add contacts to the contact group
-  dSpaceCollide(this->dataPtr->spaceId, this, CollisionCallback);
-  DIAG_TIMER_LAP("ODEPhysics::UpdateCollision", "dSpaceCollide");
+//////////////////////////////////////////////////
+void ODEPhysics::TuneHashLevels()
+{
+  const int count = dSpaceGetNumGeoms(this->dataPtr->spaceId);
+  this->dataPtr->hashTunedCount = count;
 
-  // Generate non-trimesh collisions.
-  for (i = 0; i < this->dataPtr->collidersCount; ++i)
+  std::vector<dReal> sizes;
+  sizes.reserve(count);
+  for (int i = 0; i < count; ++i)
   {
-    this->Collide(this->dataPtr->colliders[i].first,
-        this->dataPtr->colliders[i].second, this->dataPtr->contactCollisions);
+    dReal aabb[6];
+    dGeomGetAABB(dSpaceGetGeom(this->dataPtr->spaceId, i), aabb);
+    const dReal size = std::max({aabb[1] - aabb[0], aabb[3] - aabb[2],
+        aabb[5] - aabb[4]});
+    // Infinite geoms such as planes always go in the large geom list
+    if (size > 0 && size < dInfinity)
+      sizes.push_back(size);
   }
-  DIAG_TIMER_LAP("ODEPhysics::UpdateCollision", "collideShapes");
+  if (sizes.empty())
+    return;
 
-  // Generate trimesh collision.
-  // This must happen in this thread sequentially
-  for (i = 0; i < this->dataPtr->trimeshCollidersCount; ++i)
+  // The smallest cells fit all but the smallest tenth of the geoms, and
+  // the largest cells fit all of them
+  std::sort(sizes.begin(), sizes.end());
+  const dReal small = sizes[sizes.size() / 10];
+  const int minLevel = ignition::math::clamp(
+      static_cast<int>(std::floor(std::log2(small))),
+      kMinHashLevel, kMaxHashLevel);
+  const int maxLevel = ignition::math::clamp(
+      static_cast<int>(std::ceil(std::log2(sizes.back()))),
+      minLevel, kMaxHashLevel);
+
+  if (minLevel != this->dataPtr->hashMinLevel ||
+      maxLevel != this->dataPtr->hashMaxLevel)
   {
-    ODECollision *collision1 = this->dataPtr->trimeshColliders[i].first;
-    ODECollision *collision2 = this->dataPtr->trimeshColliders[i].second;
-    this->Collide(collision1, collision2, this->dataPtr->contactCollisions);
+    gzlog << "ODE hash space levels [" << minLevel << ", " << maxLevel
+          << "] for " << count << " geoms" << std::endl;
+    this->SetHashLevels(minLevel, maxLevel);
   }
-  DIAG_TIMER_LAP("ODEPhysics::UpdateCollision", "collideTrimeshes");
+}
 
-  DIAG_TIMER_STOP("ODEPhysics::UpdateCollision");
+//////////////////////////////////////////////////
+void ODEPhysics::CollideParallel()
+{
+  auto &results = this->dataPtr->collideResults;
+  if (results.size() < this->dataPtr->collidersCount)
+    results.resize(this->dataPtr->collidersCount);
+
+  // The narrowphase rotates the friction directions by the world poses of
+  // the collisions, which are computed lazily on first use. A collision is
+  // in several colliders, so they are computed here, before the threads
+  // read them.
+  for (unsigned int i = 0; i < this->dataPtr->collidersCount; ++i)
+  {
+    this->dataPtr->colliders[i].first->WorldPose();
+    this->dataPtr->colliders[i].second->WorldPose();
+  }
+
+  // Narrowphase of the colliders in parallel. Each thread writes its
+  // contacts to its own buffer, and only reads the collisions, whose world
+  // poses are up to date.
+  this->dataPtr->collisionArena->execute([&]()
+  {
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0,
+        this->dataPtr->collidersCount, kParallelCollidersGrain),
+        [&](const tbb::blocked_range<unsigned int> &_range)
+    {
+      ODEContactBuffer &buffer = this->dataPtr->contactBuffers.local();
+      for (unsigned int i = _range.begin(); i != _range.end(); ++i)
+      {
+        ODECollision *collision1 = this->dataPtr->colliders[i].first;
+        ODECollision *collision2 = this->dataPtr->colliders[i].second;
+        ODECollideResult &result = results[i];
+
+        // Heightfields and polylines use buffers stored in the ODE geom,
+        // they are collided afterwards on this thread.
+        result.deferred = !ParallelCollideSafe(collision1) ||
+            !ParallelCollideSafe(collision2);
+        result.count = 0;
+        if (result.deferred)
+          continue;
+
+        result.count = this->CollideNarrowphase(collision1, collision2,
+            buffer.scratch, result.contact);
+        result.buffer = &buffer;
+        result.offset = buffer.contacts.size();
+        buffer.contacts.insert(buffer.contacts.end(), buffer.scratch,
+            buffer.scratch + result.count);
+      }
+    });
+  });
+
+  // Create the contact joints in collider order, so that the result is the
+  // same as with sequential collision detection.
+  for (unsigned int i = 0; i < this->dataPtr->collidersCount; ++i)
+  {
+    ODECollision *collision1 = this->dataPtr->colliders[i].first;
+    ODECollision *collision2 = this->dataPtr->colliders[i].second;
+    ODECollideResult &result = results[i];
+
+    if (result.deferred)
+    {
+      this->Collide(collision1, collision2, this->dataPtr->contactCollisions);
+    }
+    else if (result.count > 0)
+    {
+      this->AddContactJoints(collision1, collision2,
+          &result.buffer->contacts[result.offset], result.count,
+          result.contact);
+    }
+  }
+
+  for (auto &buffer : this->dataPtr->contactBuffers)
+    buffer.contacts.clear();
 }
 
 //////////////////////////////////////////////////
 void ODEPhysics::UpdatePhysics()
 {
+  GZ_PROFILE("ODEPhysics::UpdatePhysics");
   DIAG_TIMER_START("ODEPhysics::UpdatePhysics");
 
   // need to lock, otherwise might conflict with world resetting
   {
     boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
 
+    // Multi-rate models that are due this update are stepped after the
+    // world step, unless contacts or joints couple them to it.
+    const bool multiRate = !this->dataPtr->multiRateModels.empty();
+    if (multiRate)
+    {
+      for (size_t i = 0; i < this->dataPtr->multiRateModels.size(); ++i)
+      {
+        if (this->dataPtr->multiRateModels[i].due)
+          this->ParkMultiRateBodies(i);
+      }
+    }
+
+    const bool continuous = !this->dataPtr->continuousLinks.empty();
+    if (continuous)
+      this->StartContinuousLinks();
+
     // Update the dynamical model
-    (*(this->dataPtr->physicsStepFunc))
-      (this->dataPtr->worldId, this->maxStepSize);
+    this->StepWorld(this->maxStepSize);
+
+    if (multiRate)
+    {
+      this->StepMultiRateModels();
+      this->UnparkMultiRateModels();
+    }
+
+    if (continuous)
+      this->SweepContinuousLinks();
 
     ignition::math::Vector3d f1, f2, t1, t2;
 
@@ -448,6 +1924,11 @@ void ODEPhysics::UpdatePhysics()
 //////////////////////////////////////////////////
 void ODEPhysics::Fini()
 {
+  if (this->dataPtr->sweepGeom)
+    dGeomDestroy(this->dataPtr->sweepGeom);
+  this->dataPtr->sweepGeom = nullptr;
+  this->dataPtr->continuousLinks.clear();
+
   dCloseODE();
 
   if (this->dataPtr->contactGroup)
@@ -483,6 +1964,8 @@ void ODEPhysics::Reset()
   boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
   // Very important to clear out the contact group
   dJointGroupEmpty(this->dataPtr->contactGroup);
+  this->dataPtr->stepContacts.clear();
+  this->dataPtr->contactImpulses.clear();
 }
 
 //////////////////////////////////////////////////
@@ -920,9 +2403,47 @@ void ODEPhysics::SetStepType(const std::string &_type)
     this->dataPtr->physicsStepFunc = &dWorldQuickStep;
   else if (this->dataPtr->stepType == "world")
     this->dataPtr->physicsStepFunc = &dWorldStep;
+  else if (this->dataPtr->stepType == "parallel_quick")
+  {
+#ifdef HAVE_PARALLEL_QUICKSTEP
+    this->dataPtr->physicsStepFunc = &dWorldParallelQuickStep;
+#else
+    gzwarn << "Gazebo was built without the parallel quickstep solver, "
+           << "using the quick step type instead" << std::endl;
+    this->dataPtr->physicsStepFunc = &dWorldQuickStep;
+#endif
+  }
   else
     gzerr << "Invalid step type[" << this->dataPtr->stepType
           << "]" << std::endl;
+
+  this->dataPtr->solverTime = 0;
+  this->dataPtr->solverTimeTotal = 0;
+  this->dataPtr->solverSteps = 0;
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::StepWorld(const double _stepSize)
+{
+  const auto start = std::chrono::steady_clock::now();
+  (*(this->dataPtr->physicsStepFunc))(this->dataPtr->worldId, _stepSize);
+  this->dataPtr->solverTime = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+  this->dataPtr->solverTimeTotal += this->dataPtr->solverTime;
+  ++this->dataPtr->solverSteps;
+
+  // Keep the contact forces for the contacts of the next step
+  if (this->dataPtr->contactWarmStart)
+  {
+    auto &impulses = this->dataPtr->contactImpulses;
+    impulses.clear();
+    for (const auto &contact : this->dataPtr->stepContacts)
+    {
+      ODEContactImpulse &impulse = impulses[contact.first];
+      dJointGetLambda(contact.second, impulse.lambda, impulse.lambdaErp);
+    }
+    this->dataPtr->stepContacts.clear();
+  }
 }
 
 //////////////////////////////////////////////////
@@ -982,7 +2503,8 @@ void ODEPhysics::CollisionCallback(void *_data, dGeomID _o1, dGeomID _o2)
     }
 
     // Make sure both collision pointers are valid.
-    if (collision1 && collision2)
+    if (collision1 && collision2 &&
+        FirstGeomPair(collision1, _o1, collision2, _o2))
     {
       // Add either a tri-mesh collider or a regular collider.
       if (collision1->HasType(Base::MESH_SHAPE) ||
@@ -1000,11 +2522,26 @@ void ODEPhysics::CollisionCallback(void *_data, dGeomID _o1, dGeomID _o2)
 //////////////////////////////////////////////////
 void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
                          dContactGeom *_contactCollisions)
+{
+  dContact contact;
+  unsigned int numc = this->CollideNarrowphase(_collision1, _collision2,
+      _contactCollisions, contact);
+  if (numc > 0)
+  {
+    this->AddContactJoints(_collision1, _collision2, _contactCollisions,
+        numc, contact);
+  }
+}
+
+//////////////////////////////////////////////////
+unsigned int ODEPhysics::CollideNarrowphase(ODECollision *_collision1,
+    ODECollision *_collision2, dContactGeom *_contactCollisions,
+    dContact &_contact)
 {
   // Filter collisions based on collide bitmask.
   if ((_collision1->GetSurface()->collideBitmask &
         _collision2->GetSurface()->collideBitmask) == 0)
-    return;
+    return 0;
 
   // Filter collisions based on contact bitmask if collide_without_contact is
   // on.The bitmask is set mainly for speed improvements otherwise a collision
@@ -1016,7 +2553,7 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
     if ((_collision1->GetSurface()->collideWithoutContactBitmask &
          _collision2->GetSurface()->collideWithoutContactBitmask) == 0)
     {
-      return;
+      return 0;
     }
   }
 
@@ -1033,10 +2570,9 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
   }*/
 
   unsigned int numc = 0;
-  dContact contact;
 
-  // maxCollide must less than the size of this->dataPtr->indices
-  // Check the header
+  // maxCollide must not be greater than MAX_CONTACT_JOINTS, the size of
+  // the feedback arrays. Check the header
   unsigned int maxCollide = MAX_CONTACT_JOINTS;
 
   // max_contacts specified globally
@@ -1051,36 +2587,36 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
     maxCollide = _collision2->GetMaxContacts();
 
   // Generate the contacts
-  numc = dCollide(_collision1->GetCollisionId(), _collision2->GetCollisionId(),
-      MAX_COLLIDE_RETURNS, _contactCollisions, sizeof(_contactCollisions[0]));
+  numc = CollideGeoms(_collision1, _collision2,
+      this->dataPtr->meshCollider == "fcl", _contactCollisions);
 
   // Return if no contacts.
   if (numc == 0)
-    return;
-
-  // Store the indices of the contacts.
-  for (int i = 0; i < MAX_CONTACT_JOINTS; i++)
-    this->dataPtr->indices[i] = i;
+    return 0;
 
-  // Choose only the best contacts if too many were generated.
+  // Choose only the best contacts if too many were generated. The first
+  // maxCollide-1 contacts are kept, and the last kept slot receives the
+  // deepest of the remaining contacts.
   if (maxCollide > 0 && numc > maxCollide)
   {
-    double max = _contactCollisions[maxCollide-1].depth;
+    unsigned int deepest = maxCollide-1;
+    double max = _contactCollisions[deepest].depth;
     for (unsigned int i = maxCollide; i < numc; ++i)
     {
       if (_contactCollisions[i].depth > max)
       {
         max = _contactCollisions[i].depth;
-        this->dataPtr->indices[maxCollide-1] = i;
+        deepest = i;
       }
     }
+    _contactCollisions[maxCollide-1] = _contactCollisions[deepest];
 
     // Make sure numc has the valid number of contacts.
     numc = maxCollide;
   }
 
   // Set the contact surface parameter flags.
-  contact.surface.mode = dContactBounce |
+  _contact.surface.mode = dContactBounce |
                          dContactMu2 |
                          dContactSoftERP |
                          dContactSoftCFM |
@@ -1097,14 +2633,14 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
   double kp = 1.0 / (1.0 / surf1->kp + 1.0 / surf2->kp);
   double kd = surf1->kd + surf2->kd;
 
-  contact.surface.soft_erp = (this->maxStepSize * kp) /
+  _contact.surface.soft_erp = (this->maxStepSize * kp) /
                              (this->maxStepSize * kp + kd);
 
-  contact.surface.soft_cfm = 1.0 / (this->maxStepSize * kp + kd);
+  _contact.surface.soft_cfm = 1.0 / (this->maxStepSize * kp + kd);
 
-  // contact.surface.soft_erp = 0.5*(_collision1->surface->softERP +
+  // _contact.surface.soft_erp = 0.5*(_collision1->surface->softERP +
   //                                _collision2->surface->softERP);
-  // contact.surface.soft_cfm = 0.5*(_collision1->surface->softCFM +
+  // _contact.surface.soft_cfm = 0.5*(_collision1->surface->softCFM +
   //                                _collision2->surface->softCFM);
 
   // assign fdir1 if not set as 0
@@ -1143,38 +2679,38 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
 
   if (fd != ignition::math::Vector3d::Zero)
   {
-    contact.surface.mode |= dContactFDir1;
-    contact.fdir1[0] = fd.X();
-    contact.fdir1[1] = fd.Y();
-    contact.fdir1[2] = fd.Z();
+    _contact.surface.mode |= dContactFDir1;
+    _contact.fdir1[0] = fd.X();
+    _contact.fdir1[1] = fd.Y();
+    _contact.fdir1[2] = fd.Z();
   }
 
   // Set the friction coefficients.
-  contact.surface.mu = std::min(surf1->FrictionPyramid()->MuPrimary(),
+  _contact.surface.mu = std::min(surf1->FrictionPyramid()->MuPrimary(),
                                 surf2->FrictionPyramid()->MuPrimary());
-  contact.surface.mu2 = std::min(surf1->FrictionPyramid()->MuSecondary(),
+  _contact.surface.mu2 = std::min(surf1->FrictionPyramid()->MuSecondary(),
                                  surf2->FrictionPyramid()->MuSecondary());
-  contact.surface.mu3 = std::min(surf1->FrictionPyramid()->MuTorsion(),
+  _contact.surface.mu3 = std::min(surf1->FrictionPyramid()->MuTorsion(),
                                  surf2->FrictionPyramid()->MuTorsion());
 
   // Combine the slip values
   // The slip is equivalent to the inverse of a viscous damping term
   // To combine dampers in series, the inverse of damping is summed
   // So the sum of slip parameters is used to combine them
-  contact.surface.slip1 = surf1->slip1 + surf2->slip1;
-  contact.surface.slip2 = surf1->slip2 + surf2->slip2;
-  contact.surface.slip3 = surf1->slipTorsion + surf2->slipTorsion;
+  _contact.surface.slip1 = surf1->slip1 + surf2->slip1;
+  _contact.surface.slip2 = surf1->slip2 + surf2->slip2;
+  _contact.surface.slip3 = surf1->slipTorsion + surf2->slipTorsion;
   // The slip parameter acts like a damper at each contact point
   // so the total damping for each collision is multiplied by the
   // number of contact points (numc).
   // To eliminate this dependence on numc, the inverse damping
   // is multipled by numc.
-  contact.surface.slip1 *= numc;
-  contact.surface.slip2 *= numc;
-  contact.surface.slip3 *= numc;
+  _contact.surface.slip1 *= numc;
+  _contact.surface.slip2 *= numc;
+  _contact.surface.slip3 *= numc;
 
   // Combine torsional friction patch radius values
-  contact.surface.patch_radius =
+  _contact.surface.patch_radius =
       std::max(surf1->FrictionPyramid()->PatchRadius(),
                surf2->FrictionPyramid()->PatchRadius());
 
@@ -1190,32 +2726,32 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
     curv2 = 1 / surf2->FrictionPyramid()->SurfaceRadius();
 
   double curvSum = curv1 + curv2;
-  contact.surface.surface_radius = 0;
+  _contact.surface.surface_radius = 0;
   if (curvSum > 0)
-    contact.surface.surface_radius = 1 / curvSum;
+    _contact.surface.surface_radius = 1 / curvSum;
 
   /// \todo Not sure how to combine these logic flags
   /// If user wanted to use patch radius, but got settings
   /// overwritten by the logic combination, how do we make sure the
   /// the surface radius is specified or makes sense?
-  contact.surface.use_patch_radius =
+  _contact.surface.use_patch_radius =
       surf1->FrictionPyramid()->UsePatchRadius() &&
       surf2->FrictionPyramid()->UsePatchRadius();
 
-  if (contact.surface.mu3 > 0)
+  if (_contact.surface.mu3 > 0)
   {
     // Patch radius
-    if ((contact.surface.use_patch_radius &&
-        contact.surface.patch_radius > 0) ||
+    if ((_contact.surface.use_patch_radius &&
+        _contact.surface.patch_radius > 0) ||
     // Surface radius
-        (!contact.surface.use_patch_radius &&
-        contact.surface.surface_radius > 0))
+        (!_contact.surface.use_patch_radius &&
+        _contact.surface.surface_radius > 0))
     {
-      contact.surface.mode |= dContactMu3;
+      _contact.surface.mode |= dContactMu3;
 
-      if (contact.surface.slip3 > 0)
+      if (_contact.surface.slip3 > 0)
       {
-        contact.surface.mode |= dContactSlip3;
+        _contact.surface.mode |= dContactSlip3;
       }
     }
   }
@@ -1229,23 +2765,31 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
   double e2 = surf2->FrictionPyramid()->ElasticModulus();
   if (e1 > 0 && e2 > 0)
   {
-    contact.surface.elastic_modulus = 1.0 /
+    _contact.surface.elastic_modulus = 1.0 /
       ((1.0 - nu1*nu1)/e1 + (1.0 - nu2*nu2)/e2);
 
     // Turn on Contact Elastic Modulus model if elastic modulus > 0
-    if (contact.surface.elastic_modulus > 0.0)
+    if (_contact.surface.elastic_modulus > 0.0)
     {
-      contact.surface.mode |= dContactEM;
+      _contact.surface.mode |= dContactEM;
     }
   }
 
   // Set the bounce values
-  contact.surface.bounce = std::min(surf1->bounce,
+  _contact.surface.bounce = std::min(surf1->bounce,
                                     surf2->bounce);
-  contact.surface.bounce_vel =
+  _contact.surface.bounce_vel =
     std::min(surf1->bounceThreshold,
              surf2->bounceThreshold);
 
+  return numc;
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::AddContactJoints(ODECollision *_collision1,
+    ODECollision *_collision2, const dContactGeom *_contacts,
+    const unsigned int _count, dContact &_contact)
+{
   // Get the ODE body IDs
   dBodyID b1 = dGeomGetBody(_collision1->GetCollisionId());
   dBodyID b2 = dGeomGetBody(_collision2->GetCollisionId());
@@ -1275,34 +2819,84 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
     jointFeedback->contact = contactFeedback;
   }
 
+  // A track drives the surface of each contact along its belt. ODE
+  // constrains the velocity of the first body that isn't null relative to
+  // the other one.
+  ODECollision *track = nullptr;
+  FrictionPyramidPtr trackFriction;
+  for (auto collision : {_collision1, _collision2})
+  {
+    FrictionPyramidPtr friction = collision->GetODESurface()->FrictionPyramid();
+    if (friction->TrackAxis() != ignition::math::Vector3d::Zero)
+    {
+      track = collision;
+      trackFriction = friction;
+      break;
+    }
+  }
+  const bool trackFirst = (track == _collision1) == (b1 != nullptr);
+  const ignition::math::Pose3d trackPose =
+    track ? track->WorldPose() : ignition::math::Pose3d::Zero;
+
   // Create a joint for each contact
-  for (unsigned int j = 0; j < numc; ++j)
+  for (unsigned int j = 0; j < _count; ++j)
   {
-    contact.geom = _contactCollisions[this->dataPtr->indices[j]];
+    _contact.geom = _contacts[j];
+
+    dContact *contact = &_contact;
+    dContact trackContact;
+    ignition::math::Vector3d direction;
+    double velocity;
+    if (track && trackFriction->TrackContact(trackPose,
+          ignition::math::Vector3d(_contacts[j].pos[0], _contacts[j].pos[1],
+            _contacts[j].pos[2]),
+          ignition::math::Vector3d(_contacts[j].normal[0],
+            _contacts[j].normal[1], _contacts[j].normal[2]),
+          direction, velocity))
+    {
+      trackContact = _contact;
+      trackContact.surface.mode |= dContactFDir1 | dContactMotion1;
+      trackContact.fdir1[0] = direction.X();
+      trackContact.fdir1[1] = direction.Y();
+      trackContact.fdir1[2] = direction.Z();
+
+      // The ground moves backwards relative to the track
+      trackContact.surface.motion1 = trackFirst ? -velocity : velocity;
+      contact = &trackContact;
+    }
 
     // Create the contact joint. This introduces the contact constraint to
     // ODE
     dJointID contactJoint = dJointCreateContact(this->dataPtr->worldId,
-      this->dataPtr->contactGroup, &contact);
+      this->dataPtr->contactGroup, contact);
+
+    if (this->dataPtr->contactWarmStart)
+    {
+      const uint64_t id = ContactId(_collision1->GetCollisionId(),
+          _collision2->GetCollisionId(), _contacts[j]);
+      auto previous = this->dataPtr->contactImpulses.find(id);
+      if (previous != this->dataPtr->contactImpulses.end())
+      {
+        dJointSetLambda(contactJoint, previous->second.lambda,
+            previous->second.lambdaErp);
+        ++this->dataPtr->warmStartedContacts;
+      }
+      this->dataPtr->stepContacts.emplace_back(id, contactJoint);
+    }
 
     // Store contact information.
     if (contactFeedback && jointFeedback)
     {
       // Store the contact depth
-      contactFeedback->depths[j] =
-        _contactCollisions[this->dataPtr->indices[j]].depth;
+      contactFeedback->depths[j] = _contacts[j].depth;
 
       // Store the contact position
-      contactFeedback->positions[j].Set(
-          _contactCollisions[this->dataPtr->indices[j]].pos[0],
-          _contactCollisions[this->dataPtr->indices[j]].pos[1],
-          _contactCollisions[this->dataPtr->indices[j]].pos[2]);
+      contactFeedback->positions[j].Set(_contacts[j].pos[0],
+          _contacts[j].pos[1], _contacts[j].pos[2]);
 
       // Store the contact normal
-      contactFeedback->normals[j].Set(
-          _contactCollisions[this->dataPtr->indices[j]].normal[0],
-          _contactCollisions[this->dataPtr->indices[j]].normal[1],
-          _contactCollisions[this->dataPtr->indices[j]].normal[2]);
+      contactFeedback->normals[j].Set(_contacts[j].normal[0],
+          _contacts[j].normal[1], _contacts[j].normal[2]);
 
       // Set the joint feedback.
       dJointSetFeedback(contactJoint, &(jointFeedback->feedbacks[j]));
@@ -1319,6 +2913,20 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
   }
 }
 
+//////////////////////////////////////////////////
+void ODEPhysics::SetCollisionThreads(const int _threads)
+{
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+
+  this->dataPtr->collisionThreads = std::max(0, _threads);
+  this->dataPtr->collisionArena.reset();
+  if (this->dataPtr->collisionThreads > 0)
+  {
+    this->dataPtr->collisionArena.reset(
+        new tbb::task_arena(this->dataPtr->collisionThreads));
+  }
+}
+
 /////////////////////////////////////////////////
 void ODEPhysics::AddTrimeshCollider(ODECollision *_collision1,
                                     ODECollision *_collision2)
@@ -1347,6 +2955,109 @@ void ODEPhysics::AddCollider(ODECollision *_collision1,
   this->dataPtr->collidersCount++;
 }
 
+// Number of values saved per body and per joint in a snapshot.
+static const size_t kSnapshotBodyValues = 20;
+static const size_t kSnapshotJointValues = 12;
+
+//////////////////////////////////////////////////
+void ODEPhysics::SaveSnapshot(std::string &_data) const
+{
+  Link_V links;
+  Joint_V joints;
+  this->SnapshotEntities(links, joints);
+
+  // Layout: link count, joint count, then per body position (3),
+  // quaternion (4), linear velocity (3), angular velocity (3), force (3),
+  // torque (3) and enabled flag, and per joint lambda (6) and lambda_erp (6).
+  const uint64_t counts[2] = {links.size(), joints.size()};
+  _data.assign(sizeof(counts) + (links.size() * kSnapshotBodyValues +
+      joints.size() * kSnapshotJointValues) * sizeof(dReal), '\0');
+  std::memcpy(&_data[0], counts, sizeof(counts));
+
+  dReal *values = reinterpret_cast<dReal *>(&_data[sizeof(counts)]);
+  for (auto const &link : links)
+  {
+    auto odeLink = boost::static_pointer_cast<ODELink>(link);
+    dBodyID body = odeLink->GetODEId();
+    // Static links don't have a body, their values are left at zero.
+    if (body)
+    {
+      std::memcpy(values, dBodyGetPosition(body), 3 * sizeof(dReal));
+      std::memcpy(values + 3, dBodyGetQuaternion(body), 4 * sizeof(dReal));
+      std::memcpy(values + 7, dBodyGetLinearVel(body), 3 * sizeof(dReal));
+      std::memcpy(values + 10, dBodyGetAngularVel(body), 3 * sizeof(dReal));
+      std::memcpy(values + 13, dBodyGetForce(body), 3 * sizeof(dReal));
+      std::memcpy(values + 16, dBodyGetTorque(body), 3 * sizeof(dReal));
+      values[19] = dBodyIsEnabled(body) ? 1 : 0;
+    }
+    values += kSnapshotBodyValues;
+  }
+
+  for (auto const &joint : joints)
+  {
+    auto odeJoint = boost::static_pointer_cast<ODEJoint>(joint);
+    if (odeJoint->GetODEId())
+      dJointGetLambda(odeJoint->GetODEId(), values, values + 6);
+    values += kSnapshotJointValues;
+  }
+}
+
+//////////////////////////////////////////////////
+bool ODEPhysics::RestoreSnapshot(const std::string &_data)
+{
+  Link_V links;
+  Joint_V joints;
+  this->SnapshotEntities(links, joints);
+
+  uint64_t counts[2] = {0, 0};
+  if (_data.size() >= sizeof(counts))
+    std::memcpy(counts, _data.data(), sizeof(counts));
+
+  if (counts[0] != links.size() || counts[1] != joints.size() ||
+      _data.size() != sizeof(counts) + (counts[0] * kSnapshotBodyValues +
+        counts[1] * kSnapshotJointValues) * sizeof(dReal))
+  {
+    gzerr << "Snapshot doesn't match the links and joints of world["
+          << this->world->Name() << "]\n";
+    return false;
+  }
+
+  const dReal *values =
+      reinterpret_cast<const dReal *>(&_data[sizeof(counts)]);
+  for (auto const &link : links)
+  {
+    auto odeLink = boost::static_pointer_cast<ODELink>(link);
+    dBodyID body = odeLink->GetODEId();
+    if (body)
+    {
+      dBodySetPosition(body, values[0], values[1], values[2]);
+      dBodySetQuaternion(body, values + 3);
+      dBodySetLinearVel(body, values[7], values[8], values[9]);
+      dBodySetAngularVel(body, values[10], values[11], values[12]);
+      dBodySetForce(body, values[13], values[14], values[15]);
+      dBodySetTorque(body, values[16], values[17], values[18]);
+      if (values[19] > 0)
+        dBodyEnable(body);
+      else
+        dBodyDisable(body);
+
+      // Update the cached pose of the link and mark it dirty.
+      ODELink::MoveCallback(body);
+    }
+    values += kSnapshotBodyValues;
+  }
+
+  for (auto const &joint : joints)
+  {
+    auto odeJoint = boost::static_pointer_cast<ODEJoint>(joint);
+    if (odeJoint->GetODEId())
+      dJointSetLambda(odeJoint->GetODEId(), values, values + 6);
+    values += kSnapshotJointValues;
+  }
+
+  return true;
+}
+
 /////////////////////////////////////////////////
 void ODEPhysics::DebugPrint() const
 {
@@ -1543,6 +3254,58 @@ bool ODEPhysics::SetParam(const std::string &_key, const boost::any &_value)
       }
       dWorldSetIslandThreads(this->dataPtr->worldId, value);
     }
+    else if (_key == "contact_warm_start")
+    {
+      this->SetContactWarmStart(any_cast<bool>(_value));
+    }
+    else if (_key == "space_type")
+    {
+      return this->SetSpaceType(any_cast<std::string>(_value));
+    }
+    else if (_key == "mesh_collider")
+    {
+      return this->SetMeshCollider(any_cast<std::string>(_value));
+    }
+    else if (_key == "hash_min_level")
+    {
+      this->SetHashLevels(any_cast<int>(_value), this->dataPtr->hashMaxLevel);
+    }
+    else if (_key == "hash_max_level")
+    {
+      this->SetHashLevels(this->dataPtr->hashMinLevel, any_cast<int>(_value));
+    }
+    else if (_key == "hash_auto_levels")
+    {
+      this->SetHashAutoLevels(any_cast<bool>(_value));
+    }
+    else if (_key == "pair_cache")
+    {
+      bool value;
+      try
+      {
+        value = any_cast<bool>(_value);
+      }
+      catch(const boost::bad_any_cast &e)
+      {
+        gzerr << "boost any_cast error:" << e.what() << "\n";
+        return false;
+      }
+      this->SetPairCache(value);
+    }
+    else if (_key == "collision_threads")
+    {
+      int value;
+      try
+      {
+        value = any_cast<int>(_value);
+      }
+      catch(const boost::bad_any_cast &e)
+      {
+        gzerr << "boost any_cast error:" << e.what() << "\n";
+        return false;
+      }
+      this->SetCollisionThreads(value);
+    }
     else if (_key == "ode_quiet")
     {
       bool odeQuiet = any_cast<bool>(_value);
@@ -1650,6 +3413,31 @@ bool ODEPhysics::GetParam(const std::string &_key, boost::any &_value) const
     _value = this->GetFrictionModel();
   else if (_key == "island_threads")
     _value = dWorldGetIslandThreads(this->dataPtr->worldId);
+  else if (_key == "collision_threads")
+    _value = this->dataPtr->collisionThreads;
+  else if (_key == "pair_cache")
+    _value = this->dataPtr->pairCache;
+  else if (_key == "contact_warm_start")
+    _value = this->dataPtr->contactWarmStart;
+  else if (_key == "warm_started_contacts")
+    _value = this->dataPtr->warmStartedContacts;
+  else if (_key == "solver_time")
+    _value = this->dataPtr->solverTime;
+  else if (_key == "solver_time_mean")
+  {
+    _value = this->dataPtr->solverSteps == 0 ? 0.0 :
+        this->dataPtr->solverTimeTotal / this->dataPtr->solverSteps;
+  }
+  else if (_key == "space_type")
+    _value = this->dataPtr->spaceType;
+  else if (_key == "mesh_collider")
+    _value = this->dataPtr->meshCollider;
+  else if (_key == "hash_min_level")
+    _value = this->dataPtr->hashMinLevel;
+  else if (_key == "hash_max_level")
+    _value = this->dataPtr->hashMaxLevel;
+  else if (_key == "hash_auto_levels")
+    _value = this->dataPtr->hashAutoLevels;
   else if (_key == "ode_quiet")
     _value = dGetMessageHandler() != 0;
   else if (_key == "world_step_solver")
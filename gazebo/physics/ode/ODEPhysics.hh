@@ -210,6 +210,24 @@ namespace gazebo
       // Documentation inherited
       public: virtual void DebugPrint() const;
 
+      /// \brief Save the state of every ODE body, including accumulated
+      /// forces, and the constraint impulses of every joint used to warm
+      /// start the quick step solver.
+      /// \param[out] _data Buffer that receives the state.
+      public: virtual void SaveSnapshot(std::string &_data) const override;
+
+      // Documentation inherited
+      public: virtual bool RestoreSnapshot(const std::string &_data)
+              override;
+
+      // Documentation inherited
+      public: virtual bool SetModelStepMultiple(ModelPtr _model,
+                  const unsigned int _multiple) override;
+
+      // Documentation inherited
+      public: virtual bool SetLinkContinuousCollision(LinkPtr _link,
+                  const bool _enable) override;
+
       // Documentation inherited
       public: virtual void SetSeed(uint32_t _seed);
 
@@ -271,12 +289,16 @@ namespace gazebo
       public: static World_Solver_Type
               ConvertWorldStepSolverType(const std::string &_solverType);
 
-      /// \brief Get the step type (quick, world).
+      /// \brief Get the step type (quick, world, parallel_quick).
       /// \return The step type.
       public: virtual std::string GetStepType() const;
 
-      /// \brief Set the step type (quick, world).
-      /// \param[in] _type The step type (quick or world).
+      /// \brief Set the step type (quick, world, parallel_quick). The
+      /// parallel_quick solver needs Gazebo built with
+      /// ENABLE_PARALLEL_QUICKSTEP, and falls back to quick otherwise. The
+      /// "solver_time" and "solver_time_mean" parameters report how long
+      /// the steps take.
+      /// \param[in] _type The step type (quick, world or parallel_quick).
       public: virtual void SetStepType(const std::string &_type);
 
 
@@ -287,6 +309,67 @@ namespace gazebo
       public: void Collide(ODECollision *_collision1, ODECollision *_collision2,
                            dContactGeom *_contactCollisions);
 
+      /// \brief Set the number of threads used for the narrowphase of
+      /// collision detection. The contacts are identical to the ones of
+      /// sequential collision detection. Same as the "collision_threads"
+      /// parameter.
+      /// \param[in] _threads Number of threads, 0 to collide on the
+      /// physics thread.
+      public: void SetCollisionThreads(const int _threads);
+
+      /// \brief Enable the broadphase pair cache. Instead of asking ODE's
+      /// hash space for all the overlapping geoms every step, the bounds of
+      /// the top level geoms are kept sorted along each axis from one step
+      /// to the next. Only the bounds of the geoms that moved are moved,
+      /// adding and removing the pairs they start or stop overlapping.
+      /// Pairs without any enabled body, e.g. static geometry and sleeping
+      /// models, are skipped. Same as the "pair_cache" parameter.
+      /// \param[in] _enable True to enable the cache.
+      public: void SetPairCache(const bool _enable);
+
+      /// \brief Warm start the contacts from the previous step. Each contact
+      /// gets an id from its pair of geoms, the features ODE reports and its
+      /// position in the frame of the first geom, and starts its solve from
+      /// the forces of the contact with the same id in the previous step.
+      /// Stacks then need fewer solver iterations to settle. This needs a
+      /// nonzero "warm_start_factor", which scales the forces. Same as the
+      /// "contact_warm_start" parameter.
+      /// \param[in] _enable True to warm start the contacts.
+      public: void SetContactWarmStart(const bool _enable);
+
+      /// \brief Set the broadphase space of the world. "hash" is ODE's
+      /// multi-resolution hash space, "sap" a sweep and prune space, which
+      /// suits many geoms of similar size, and "quadtree" a quadtree over
+      /// the x-y bounds of the geoms, which suits large flat worlds. The
+      /// geoms are moved to the new space before the next collision
+      /// detection. Same as the "space_type" parameter.
+      /// \param[in] _type Type of the space.
+      /// \return False if the type is unknown.
+      public: bool SetSpaceType(const std::string &_type);
+
+      /// \brief Set the cell levels of the hash space. Geoms are put in
+      /// cells of size 2^level between the two levels, and geoms larger
+      /// than the largest cells are tested against all the others. Same as
+      /// the "hash_min_level" and "hash_max_level" parameters.
+      /// \param[in] _min Smallest level.
+      /// \param[in] _max Largest level.
+      public: void SetHashLevels(const int _min, const int _max);
+
+      /// \brief Pick the hash levels from the sizes of the top level geoms,
+      /// when the first geoms are added and again whenever their number
+      /// changes by a quarter. Same as the "hash_auto_levels" parameter.
+      /// \param[in] _enable True to tune the levels automatically.
+      public: void SetHashAutoLevels(const bool _enable);
+
+      /// \brief Set the collider of pairs of triangle meshes. "ode" is
+      /// ODE's trimesh collider, and "fcl" collides the bounding volume
+      /// hierarchies of the bundled FCL, which is faster on large meshes.
+      /// FCL is only available when gazebo is built with ENABLE_FCL. Same
+      /// as the "mesh_collider" parameter.
+      /// \param[in] _collider Name of the collider.
+      /// \return False if the collider is unknown or unavailable.
+      public: bool SetMeshCollider(const std::string &_collider);
+
       /// \brief process joint feedbacks.
       /// \param[in] _feedback ODE Joint Contact feedback information.
       public: void ProcessJointFeedback(ODEJointFeedback *_feedback);
@@ -303,6 +386,80 @@ namespace gazebo
                                              dGeomID _o2);
 
 
+      /// \brief Generate the contacts between two collision objects,
+      /// without modifying the ODE world or the contact manager. Safe to
+      /// call from several threads, unless one of the collisions is a
+      /// heightmap or polyline.
+      /// \param[in] _collision1 First collision object.
+      /// \param[in] _collision2 Second collision object.
+      /// \param[out] _contactCollisions Buffer of MAX_COLLIDE_RETURNS
+      /// contacts. The kept contacts are moved to the front.
+      /// \param[out] _contact Surface parameters of the contacts.
+      /// \return Number of kept contacts.
+      private: unsigned int CollideNarrowphase(ODECollision *_collision1,
+                   ODECollision *_collision2, dContactGeom *_contactCollisions,
+                   dContact &_contact);
+
+      /// \brief Create the contact joints and contact feedback for contacts
+      /// generated by CollideNarrowphase.
+      /// \param[in] _collision1 First collision object.
+      /// \param[in] _collision2 Second collision object.
+      /// \param[in] _contacts Contacts to add.
+      /// \param[in] _count Number of contacts.
+      /// \param[in,out] _contact Surface parameters of the contacts.
+      private: void AddContactJoints(ODECollision *_collision1,
+                   ODECollision *_collision2, const dContactGeom *_contacts,
+                   const unsigned int _count, dContact &_contact);
+
+      /// \brief Create the world space with the requested type, and move
+      /// the top level geoms to it.
+      /// \sa SetSpaceType
+      private: void RebuildSpace();
+
+      /// \brief Set the hash levels from the sizes of the top level geoms.
+      /// \sa SetHashAutoLevels
+      private: void TuneHashLevels();
+
+      /// \brief Step the dynamics of the world with the solver of the step
+      /// type, and time the step.
+      /// \param[in] _stepSize Step size in seconds.
+      private: void StepWorld(const double _stepSize);
+
+      /// \brief Collide the normal colliders using the collision threads.
+      private: void CollideParallel();
+
+      /// \brief Find the colliding top level geoms with the pair cache, and
+      /// call CollisionCallback for each of them.
+      /// \sa SetPairCache
+      private: void UpdateBroadphase();
+
+      /// \brief Disable the bodies of multi-rate models that are not
+      /// stepped in this update, so that their collisions are skipped.
+      /// \sa SetModelStepMultiple
+      private: void ParkMultiRateModels();
+
+      /// \brief Disable the enabled bodies of a multi-rate model.
+      /// \param[in] _index Index of the model.
+      private: void ParkMultiRateBodies(const size_t _index);
+
+      /// \brief Step the multi-rate models that are due after the world
+      /// step, grouped by their step size.
+      private: void StepMultiRateModels();
+
+      /// \brief Enable the bodies disabled by ParkMultiRateModels that
+      /// were not stepped.
+      private: void UnparkMultiRateModels();
+
+      /// \brief Record the positions of the continuous collision links
+      /// before the world step.
+      /// \sa SetLinkContinuousCollision
+      private: void StartContinuousLinks();
+
+      /// \brief Sweep a sphere along the step motion of the continuous
+      /// collision links, and move the links that tunneled back to the
+      /// first collision along their path.
+      private: void SweepContinuousLinks();
+
       /// \brief Create a triangle mesh object collider.
       /// \param[in] _collision1 The first collision object.
       /// \param[in] _collision2 The second collision object.
@@ -18,12 +18,20 @@
 #ifndef _ODEPHYSICS_PRIVATE_HH_
 #define _ODEPHYSICS_PRIVATE_HH_
 
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/task_arena.h>
+
 #include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <utility>
 
+#include <ignition/math/Vector3.hh>
+
 #include "gazebo/physics/Contact.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/physics/ode/ODETypes.hh"
 
 namespace gazebo
@@ -45,6 +53,179 @@ namespace gazebo
       public: dJointFeedback feedbacks[MAX_CONTACT_JOINTS];
     };
 
+    /// \brief Contacts generated by one thread during parallel collision
+    /// detection.
+    class ODEContactBuffer
+    {
+      /// \brief Buffer given to dCollide.
+      public: dContactGeom scratch[MAX_COLLIDE_RETURNS];
+
+      /// \brief Kept contacts of all the colliders handled by the thread.
+      public: std::vector<dContactGeom> contacts;
+    };
+
+    /// \brief Narrowphase result of one collider during parallel collision
+    /// detection.
+    class ODECollideResult
+    {
+      /// \brief Buffer that holds the contacts.
+      public: ODEContactBuffer *buffer = nullptr;
+
+      /// \brief Index of the first contact in the buffer.
+      public: size_t offset = 0;
+
+      /// \brief Number of contacts.
+      public: unsigned int count = 0;
+
+      /// \brief True if the collider has to be collided sequentially.
+      public: bool deferred = false;
+
+      /// \brief Surface parameters of the contacts.
+      public: dContact contact;
+    };
+
+    /// \brief Cached broadphase data of a geom of the top level space.
+    class ODEBroadphaseEntry
+    {
+      /// \brief The geom.
+      public: dGeomID geom = nullptr;
+
+      /// \brief Rank of the geom in the order the geoms were added, which
+      /// orders the two geoms of a pair.
+      public: uint64_t id = 0;
+
+      /// \brief Bounding box of the geom, as returned by dGeomGetAABB,
+      /// when its endpoints were last sorted.
+      public: dReal aabb[6] = {0, 0, 0, 0, 0, 0};
+
+      /// \brief Index of each bound of aabb in the endpoints of its axis.
+      public: size_t endpoints[6] = {0, 0, 0, 0, 0, 0};
+
+      /// \brief Body of the geom, null for spaces.
+      public: dBodyID body = nullptr;
+
+      /// \brief Bodies of the geom and of the geoms of its space.
+      public: std::vector<dBodyID> bodies;
+
+      /// \brief Number of geoms in the space of the geom when bodies was
+      /// collected, 0 if the geom isn't a space.
+      public: int geomCount = 0;
+
+      /// \brief True if the geom contains an enabled body, as of
+      /// activeStep.
+      public: bool active = false;
+
+      /// \brief Broadphase step active was computed for.
+      public: uint64_t activeStep = 0;
+
+      /// \brief True if the geom contains a sensor geom.
+      public: bool sensor = false;
+
+      /// \brief True if the geom is enabled.
+      public: bool enabled = false;
+
+      /// \brief Category bits of the geom.
+      public: unsigned long category = 0;
+
+      /// \brief Collide bits of the geom.
+      public: unsigned long collide = 0;
+
+      /// \brief Last broadphase step the geom was in the space.
+      public: uint64_t step = 0;
+    };
+
+    /// \brief A bound of the bounding box of a broadphase entry, along
+    /// one axis.
+    class ODEBroadphaseEndpoint
+    {
+      /// \brief Value of the bound.
+      public: dReal value = 0;
+
+      /// \brief Entry of the bounding box.
+      public: ODEBroadphaseEntry *entry = nullptr;
+
+      /// \brief True for the upper bound, false for the lower bound.
+      public: bool max = false;
+    };
+
+    /// \brief Two broadphase entries whose bounding boxes overlap.
+    typedef std::pair<ODEBroadphaseEntry *, ODEBroadphaseEntry *>
+        ODEBroadphasePair;
+
+    /// \brief Hash of a broadphase pair.
+    class ODEBroadphasePairHash
+    {
+      /// \brief Hash a pair.
+      /// \param[in] _pair The pair.
+      /// \return The hash.
+      public: size_t operator()(const ODEBroadphasePair &_pair) const
+      {
+        const std::hash<const void *> hash;
+        return hash(_pair.first) * 31 + hash(_pair.second);
+      }
+    };
+
+    /// \brief A model stepped at a multiple of the world step size.
+    class ODEMultiRateModel
+    {
+      /// \brief The model.
+      public: boost::weak_ptr<Model> model;
+
+      /// \brief Step multiple of the model.
+      public: unsigned int multiple = 1;
+
+      /// \brief Time since the model was last stepped.
+      public: double pending = 0;
+
+      /// \brief True if the model is stepped in the current update.
+      public: bool due = false;
+
+      /// \brief Bodies of the model's links, collected every update.
+      public: std::vector<dBodyID> bodies;
+    };
+
+    /// \brief A link swept between steps for continuous collision
+    /// detection.
+    class ODEContinuousLink
+    {
+      /// \brief The link.
+      public: boost::weak_ptr<Link> link;
+
+      /// \brief Radius of the swept sphere, computed on the first sweep.
+      public: double radius = 0;
+
+      /// \brief Position of the body before the step.
+      public: ignition::math::Vector3d start;
+
+      /// \brief True if start was recorded for the current step.
+      public: bool started = false;
+    };
+
+    /// \brief A body disabled during an update because its model isn't
+    /// stepped at the world rate.
+    class ODEParkedBody
+    {
+      /// \brief The body.
+      public: dBodyID body = nullptr;
+
+      /// \brief Index of the body's model in multiRateModels.
+      public: size_t model = 0;
+
+      /// \brief True if the body was stepped in the current update.
+      public: bool stepped = false;
+    };
+
+    /// \brief Constraint forces of a contact at the end of a step, used to
+    /// warm start the matching contact of the next step.
+    class ODEContactImpulse
+    {
+      /// \brief Normal and friction forces, see dJointGetLambda.
+      public: dReal lambda[6];
+
+      /// \brief Forces of the erp correction, see dJointGetLambda.
+      public: dReal lambdaErp[6];
+    };
+
     class ODEPhysicsPrivate
     {
       /// \brief Top-level world for all bodies
@@ -65,6 +246,16 @@ namespace gazebo
       /// \brief Physics step function.
       public: int (*physicsStepFunc)(dxWorld*, dReal);
 
+      /// \brief Wall clock time of the last world step, in seconds.
+      public: double solverTime = 0;
+
+      /// \brief Sum of the wall clock times of the world steps since the
+      /// step type was set, in seconds.
+      public: double solverTimeTotal = 0;
+
+      /// \brief Number of world steps since the step type was set.
+      public: uint64_t solverSteps = 0;
+
       /// \brief All the collsiion spaces.
       public: std::map<std::string, dSpaceID> spaces;
 
@@ -78,8 +269,6 @@ namespace gazebo
       /// \brief Array of contact collisions.
       public: dContactGeom contactCollisions[MAX_COLLIDE_RETURNS];
 
-      /// \brief Indices used during creation of contact joints.
-      public: int indices[MAX_CONTACT_JOINTS];
 
       /// \brief Current index into the contactFeedbacks buffer
       public: unsigned int jointFeedbackIndex;
@@ -92,6 +281,102 @@ namespace gazebo
 
       /// \brief Maximum number of contact points per collision pair.
       public: unsigned int maxContacts;
+
+      /// \brief Number of threads of the collision narrowphase.
+      public: int collisionThreads = 0;
+
+      /// \brief Arena that limits the concurrency of the collision
+      /// narrowphase. Null when collision detection is sequential.
+      public: std::unique_ptr<tbb::task_arena> collisionArena;
+
+      /// \brief Contact buffer of each collision thread.
+      public: tbb::enumerable_thread_specific<ODEContactBuffer>
+              contactBuffers;
+
+      /// \brief Narrowphase result of each normal collider.
+      public: std::vector<ODECollideResult> collideResults;
+
+      /// \brief True if contacts are warm started from the matching
+      /// contacts of the previous step.
+      public: bool contactWarmStart = false;
+
+      /// \brief Forces of the contacts of the last step, by contact id.
+      public: std::unordered_map<uint64_t, ODEContactImpulse> contactImpulses;
+
+      /// \brief Contact joints created for the next step, with their ids.
+      public: std::vector<std::pair<uint64_t, dJointID>> stepContacts;
+
+      /// \brief Number of contacts of the next step that matched a contact
+      /// of the previous one.
+      public: unsigned int warmStartedContacts = 0;
+
+      /// \brief Type of the world space: "hash", "sap" or "quadtree".
+      public: std::string spaceType = "hash";
+
+      /// \brief True if the world space must be created again with
+      /// spaceType before the next collision detection.
+      public: bool spaceRebuild = false;
+
+      /// \brief Smallest cell level of the hash space, cells are 2^level.
+      public: int hashMinLevel = -2;
+
+      /// \brief Largest cell level of the hash space.
+      public: int hashMaxLevel = 8;
+
+      /// \brief True if the hash levels are picked from the sizes of the
+      /// top level geoms.
+      public: bool hashAutoLevels = false;
+
+      /// \brief Number of top level geoms when the hash levels were last
+      /// tuned.
+      public: int hashTunedCount = 0;
+
+      /// \brief Collider of pairs of triangle meshes: "ode" or "fcl".
+      public: std::string meshCollider = "ode";
+
+      /// \brief True if the broadphase pair cache is used.
+      public: bool pairCache = false;
+
+      /// \brief Broadphase data of the top level geoms.
+      public: std::unordered_map<dGeomID, ODEBroadphaseEntry>
+              broadphaseEntries;
+
+      /// \brief Bounds of the top level geoms along x, y and z, each
+      /// sorted by value with lower bounds first on ties.
+      public: std::vector<ODEBroadphaseEndpoint> broadphaseEndpoints[3];
+
+      /// \brief Top level geoms whose bounding boxes overlap. Kept up to
+      /// date as the endpoints are sorted.
+      public: std::vector<ODEBroadphasePair> broadphasePairs;
+
+      /// \brief Index of each pair in broadphasePairs.
+      public: std::unordered_map<ODEBroadphasePair, size_t,
+              ODEBroadphasePairHash> broadphasePairIndex;
+
+      /// \brief False if the endpoints and pairs must be computed again.
+      public: bool broadphasePairsValid = false;
+
+      /// \brief Counter of broadphase updates.
+      public: uint64_t broadphaseStep = 0;
+
+      /// \brief Counter of the geoms added to the broadphase.
+      public: uint64_t broadphaseEntryCount = 0;
+
+      /// \brief Models stepped at a multiple of the world step size.
+      public: std::vector<ODEMultiRateModel> multiRateModels;
+
+      /// \brief Bodies of multi-rate models disabled in this update.
+      public: std::vector<ODEParkedBody> parkedBodies;
+
+      /// \brief Bodies disabled while multi-rate models are stepped.
+      public: std::vector<dBodyID> heldBodies;
+
+      /// \brief Links swept for continuous collision detection.
+      public: std::vector<ODEContinuousLink> continuousLinks;
+
+      /// \brief Capsule geom used to sweep the continuous links, created
+      /// on the first sweep.
+      public: dGeomID sweepGeom = nullptr;
     };
   }
 }
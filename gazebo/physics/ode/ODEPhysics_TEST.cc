@@ -17,8 +17,16 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gazebo/gazebo_config.h"
+#include "gazebo/common/MeshManager.hh"
 #include "gazebo/physics/physics.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
+#include "gazebo/physics/ode/ODECollision.hh"
 #include "gazebo/physics/ode/ODEPhysics.hh"
 #include "gazebo/physics/ode/ODETypes.hh"
 #include "gazebo/test/ServerFixture.hh"
@@ -320,6 +328,40 @@ TEST_F(ODEPhysics_TEST, PhysicsParam)
     }
   }
 
+  // Test collision_threads
+  {
+    // collision_threads should be 0 by default
+    int collisionThreads = 1;
+    EXPECT_NO_THROW(collisionThreads =
+      boost::any_cast<int>(odePhysics->GetParam("collision_threads")));
+    EXPECT_FALSE(collisionThreads);
+
+    std::vector<int> threads = {1, 4, 0};
+    for (auto const collisionThreadsSet : threads)
+    {
+      odePhysics->SetParam("collision_threads", collisionThreadsSet);
+      EXPECT_NO_THROW(collisionThreads =
+        boost::any_cast<int>(odePhysics->GetParam("collision_threads")));
+      EXPECT_EQ(collisionThreads, collisionThreadsSet);
+    }
+  }
+
+  // Test pair_cache
+  {
+    bool pairCache = true;
+    EXPECT_NO_THROW(pairCache =
+      boost::any_cast<bool>(odePhysics->GetParam("pair_cache")));
+    EXPECT_FALSE(pairCache);
+
+    for (const bool pairCacheSet : {true, false})
+    {
+      EXPECT_TRUE(odePhysics->SetParam("pair_cache", pairCacheSet));
+      EXPECT_NO_THROW(pairCache =
+        boost::any_cast<bool>(odePhysics->GetParam("pair_cache")));
+      EXPECT_EQ(pairCache, pairCacheSet);
+    }
+  }
+
   // Test ode_quiet
   // convenient for disabling LCP internal error messages from world solver
   {
@@ -490,6 +532,605 @@ TEST_F(ODEPhysics_TEST, PhysicsMsgParam)
   PhysicsMsgParam();
 }
 
+/////////////////////////////////////////////////
+/// Parallel collision detection must give the same contacts as sequential
+/// collision detection.
+TEST_F(ODEPhysics_TEST, CollisionThreads)
+{
+  Load("worlds/empty.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  // A grid of boxes touching the ground and their neighbors, enough to use
+  // the parallel narrowphase
+  for (int i = 0; i < 8; ++i)
+  {
+    for (int j = 0; j < 10; ++j)
+    {
+      SpawnBox("box_" + std::to_string(i) + "_" + std::to_string(j),
+          ignition::math::Vector3d(1, 1, 1),
+          ignition::math::Vector3d(i * 0.999, j * 0.999, 0.499));
+    }
+  }
+
+  WorldSnapshot snapshot;
+  world->SaveSnapshot(snapshot);
+
+  world->Step(200);
+  std::vector<ignition::math::Pose3d> sequentialPoses;
+  for (auto const &model : world->Models())
+    sequentialPoses.push_back(model->WorldPose());
+
+  EXPECT_TRUE(world->RestoreSnapshot(snapshot));
+  world->Physics()->SetParam("collision_threads", 4);
+  world->Step(200);
+  auto models = world->Models();
+  ASSERT_EQ(sequentialPoses.size(), models.size());
+  for (size_t i = 0; i < models.size(); ++i)
+    EXPECT_EQ(sequentialPoses[i], models[i]->WorldPose());
+}
+
+/////////////////////////////////////////////////
+/// Parallel collision detection must give the same contacts as sequential
+/// collision detection when a collision with a friction direction touches
+/// many bodies.
+TEST_F(ODEPhysics_TEST, CollisionThreadsFrictionDirection)
+{
+  Load("worlds/empty.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  // A turned plate with anisotropic friction, pushed around by the boxes
+  // sliding on it
+  std::ostringstream plateSdf;
+  plateSdf << "<sdf version='" << SDF_VERSION << "'>"
+      << "<model name='plate'>"
+      << "<pose>0 0 0.1 0 0 0.3</pose>"
+      << "<link name='link'>"
+      << "<inertial><mass>100</mass></inertial>"
+      << "<collision name='collision'>"
+      << "<geometry><box><size>12 12 0.2</size></box></geometry>"
+      << "<surface><friction><ode>"
+      << "<mu>1</mu><mu2>0.1</mu2><fdir1>1 0 0</fdir1>"
+      << "</ode></friction></surface>"
+      << "</collision>"
+      << "<visual name='visual'>"
+      << "<geometry><box><size>12 12 0.2</size></box></geometry>"
+      << "</visual>"
+      << "</link>"
+      << "</model>"
+      << "</sdf>";
+  SpawnSDF(plateSdf.str());
+  for (int i = 0; i < 100 && !world->ModelByName("plate"); ++i)
+    common::Time::MSleep(10);
+  ASSERT_TRUE(world->ModelByName("plate") != nullptr);
+
+  // Enough boxes on the plate to use the parallel narrowphase
+  for (int i = 0; i < 8; ++i)
+  {
+    for (int j = 0; j < 10; ++j)
+    {
+      const std::string name =
+          "box_" + std::to_string(i) + "_" + std::to_string(j);
+      SpawnBox(name, ignition::math::Vector3d(0.5, 0.5, 0.5),
+          ignition::math::Vector3d(i - 3.5, j - 4.5, 0.449));
+      auto box = world->ModelByName(name);
+      ASSERT_TRUE(box != nullptr);
+      box->SetLinearVel(ignition::math::Vector3d(1, 1, 0));
+    }
+  }
+
+  WorldSnapshot snapshot;
+  world->SaveSnapshot(snapshot);
+
+  world->Step(200);
+  std::vector<ignition::math::Pose3d> sequentialPoses;
+  for (auto const &model : world->Models())
+    sequentialPoses.push_back(model->WorldPose());
+
+  EXPECT_TRUE(world->RestoreSnapshot(snapshot));
+  world->Physics()->SetParam("collision_threads", 4);
+  world->Step(200);
+  auto models = world->Models();
+  ASSERT_EQ(sequentialPoses.size(), models.size());
+  for (size_t i = 0; i < models.size(); ++i)
+    EXPECT_EQ(sequentialPoses[i], models[i]->WorldPose());
+}
+
+/////////////////////////////////////////////////
+/// The broadphase pair cache must find the same collisions as ODE's space.
+TEST_F(ODEPhysics_TEST, PairCache)
+{
+  Load("worlds/empty.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  world->Physics()->SetParam("pair_cache", true);
+
+  // A static platform, a box that falls on it and a box resting on the
+  // ground plane
+  SpawnBox("platform", ignition::math::Vector3d(2, 2, 1),
+      ignition::math::Vector3d(0, 0, 0.5), ignition::math::Vector3d::Zero,
+      true);
+  SpawnBox("falling_box", ignition::math::Vector3d(1, 1, 1),
+      ignition::math::Vector3d(0, 0, 3));
+  SpawnBox("resting_box", ignition::math::Vector3d(1, 1, 1),
+      ignition::math::Vector3d(5, 0, 0.5));
+
+  auto fallingBox = world->ModelByName("falling_box");
+  auto restingBox = world->ModelByName("resting_box");
+  ASSERT_TRUE(fallingBox != nullptr);
+  ASSERT_TRUE(restingBox != nullptr);
+
+  // Give the resting box time to go to sleep while the other one falls
+  world->Step(3000);
+  EXPECT_NEAR(1.5, fallingBox->WorldPose().Pos().Z(), 0.01);
+  EXPECT_NEAR(0.5, restingBox->WorldPose().Pos().Z(), 0.01);
+
+  // Moving a sleeping box wakes it up and its new pairs are found
+  restingBox->SetWorldPose(ignition::math::Pose3d(0, 0, 4, 0, 0, 0));
+  world->Step(2000);
+  EXPECT_NEAR(2.5, restingBox->WorldPose().Pos().Z(), 0.01);
+  EXPECT_NEAR(1.5, fallingBox->WorldPose().Pos().Z(), 0.01);
+
+  // Removing a model from the space updates the cache
+  world->RemoveModel("falling_box");
+  world->Step(2000);
+  EXPECT_NEAR(1.5, restingBox->WorldPose().Pos().Z(), 0.01);
+}
+
+/////////////////////////////////////////////////
+/// Every broadphase space must find the same resting contacts.
+TEST_F(ODEPhysics_TEST, SpaceType)
+{
+  Load("worlds/empty.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+
+  EXPECT_EQ("hash", boost::any_cast<std::string>(
+        physics->GetParam("space_type")));
+  EXPECT_FALSE(physics->SetParam("space_type", std::string("octree")));
+
+  SpawnBox("box", ignition::math::Vector3d(1, 1, 1),
+      ignition::math::Vector3d(0, 0, 2));
+  SpawnBox("far_box", ignition::math::Vector3d(0.1, 0.1, 0.1),
+      ignition::math::Vector3d(100, 0, 1));
+  auto box = world->ModelByName("box");
+  auto farBox = world->ModelByName("far_box");
+  ASSERT_TRUE(box != nullptr);
+  ASSERT_TRUE(farBox != nullptr);
+
+  for (const std::string type : {"sap", "quadtree", "hash"})
+  {
+    EXPECT_TRUE(physics->SetParam("space_type", type));
+    EXPECT_EQ(type, boost::any_cast<std::string>(
+          physics->GetParam("space_type")));
+    box->SetWorldPose(ignition::math::Pose3d(0, 0, 2, 0, 0, 0));
+    farBox->SetWorldPose(ignition::math::Pose3d(100, 0, 1, 0, 0, 0));
+    world->Step(2000);
+    EXPECT_NEAR(0.5, box->WorldPose().Pos().Z(), 0.01) << type;
+    EXPECT_NEAR(0.05, farBox->WorldPose().Pos().Z(), 0.01) << type;
+  }
+
+  // Tuned levels fit the sizes of the boxes and stay in range
+  EXPECT_TRUE(physics->SetParam("hash_auto_levels", true));
+  world->Step(1);
+  const int minLevel = boost::any_cast<int>(
+      physics->GetParam("hash_min_level"));
+  const int maxLevel = boost::any_cast<int>(
+      physics->GetParam("hash_max_level"));
+  EXPECT_LE(minLevel, maxLevel);
+  EXPECT_GE(minLevel, -10);
+  EXPECT_LE(maxLevel, 10);
+  EXPECT_LE(std::pow(2.0, minLevel), 1.0);
+  EXPECT_GE(std::pow(2.0, maxLevel), 1.0);
+  EXPECT_NEAR(0.5, box->WorldPose().Pos().Z(), 0.01);
+}
+
+/////////////////////////////////////////////////
+/// The parallel quickstep solver falls back to quickstep when it isn't
+/// built, and both report their timings.
+TEST_F(ODEPhysics_TEST, ParallelQuickStep)
+{
+  Load("worlds/empty.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+
+  SpawnBox("box", ignition::math::Vector3d(1, 1, 1),
+      ignition::math::Vector3d(0, 0, 2));
+  auto box = world->ModelByName("box");
+  ASSERT_TRUE(box != nullptr);
+
+  for (const std::string type : {"quick", "parallel_quick"})
+  {
+    EXPECT_TRUE(physics->SetParam("solver_type", type));
+    EXPECT_EQ(type, boost::any_cast<std::string>(
+          physics->GetParam("solver_type")));
+    EXPECT_DOUBLE_EQ(0.0, boost::any_cast<double>(
+          physics->GetParam("solver_time_mean")));
+
+    box->SetWorldPose(ignition::math::Pose3d(0, 0, 2, 0, 0, 0));
+    world->Step(2000);
+    EXPECT_NEAR(0.5, box->WorldPose().Pos().Z(), 0.01) << type;
+    EXPECT_GE(boost::any_cast<double>(physics->GetParam("solver_time")), 0.0);
+    EXPECT_GT(boost::any_cast<double>(
+          physics->GetParam("solver_time_mean")), 0.0);
+  }
+}
+
+/////////////////////////////////////////////////
+/// Warm started contacts keep a stack standing with few iterations.
+TEST_F(ODEPhysics_TEST, ContactWarmStart)
+{
+  Load("worlds/empty.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+
+  EXPECT_FALSE(boost::any_cast<bool>(
+        physics->GetParam("contact_warm_start")));
+  EXPECT_TRUE(physics->SetParam("contact_warm_start", true));
+  EXPECT_TRUE(physics->SetParam("iters", 10));
+
+  std::vector<ModelPtr> boxes;
+  for (int i = 0; i < 5; ++i)
+  {
+    const std::string name = "box_" + std::to_string(i);
+    SpawnBox(name, ignition::math::Vector3d(0.5, 0.5, 0.5),
+        ignition::math::Vector3d(0, 0, 0.25 + 0.5 * i));
+    boxes.push_back(world->ModelByName(name));
+    ASSERT_TRUE(boxes.back() != nullptr);
+  }
+
+  world->Step(2000);
+
+  // The resting contacts match the ones of the step before
+  EXPECT_GT(boost::any_cast<unsigned int>(
+        physics->GetParam("warm_started_contacts")), 0u);
+  for (size_t i = 0; i < boxes.size(); ++i)
+  {
+    EXPECT_NEAR(0.25 + 0.5 * i, boxes[i]->WorldPose().Pos().Z(), 0.02)
+      << i;
+    EXPECT_NEAR(0.0, boxes[i]->WorldPose().Pos().X(), 0.01) << i;
+  }
+
+  // Turning it off forgets the contact forces
+  EXPECT_TRUE(physics->SetParam("contact_warm_start", false));
+  world->Step(1);
+  EXPECT_EQ(0u, boost::any_cast<unsigned int>(
+        physics->GetParam("warm_started_contacts")));
+}
+
+/////////////////////////////////////////////////
+/// Islands stepped in batches on the island threads move the same way as
+/// islands stepped one by one.
+TEST_F(ODEPhysics_TEST, IslandBatches)
+{
+  Load("worlds/empty.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+
+  // Many more islands than threads, with a few larger stacks
+  std::vector<ModelPtr> boxes;
+  for (int i = 0; i < 40; ++i)
+  {
+    const int height = (i % 8 == 0) ? 3 : 1;
+    for (int j = 0; j < height; ++j)
+    {
+      const std::string name = "box_" + std::to_string(i) + "_" +
+          std::to_string(j);
+      SpawnBox(name, ignition::math::Vector3d(0.5, 0.5, 0.5),
+          ignition::math::Vector3d(2.0 * i, 0, 0.3 + 0.55 * j));
+      boxes.push_back(world->ModelByName(name));
+      ASSERT_TRUE(boxes.back() != nullptr);
+    }
+  }
+
+  std::vector<ignition::math::Pose3d> initialPoses;
+  for (auto box : boxes)
+    initialPoses.push_back(box->WorldPose());
+
+  std::vector<ignition::math::Pose3d> sequentialPoses;
+  for (const int threads : {0, 4})
+  {
+    EXPECT_TRUE(physics->SetParam("island_threads", threads));
+    for (size_t i = 0; i < boxes.size(); ++i)
+    {
+      boxes[i]->SetWorldPose(initialPoses[i]);
+      boxes[i]->ResetPhysicsStates();
+    }
+    world->Step(500);
+
+    if (threads == 0)
+    {
+      for (auto box : boxes)
+        sequentialPoses.push_back(box->WorldPose());
+      continue;
+    }
+
+    for (size_t i = 0; i < boxes.size(); ++i)
+    {
+      EXPECT_NEAR(sequentialPoses[i].Pos().Z(),
+          boxes[i]->WorldPose().Pos().Z(), 1e-6) << i;
+    }
+  }
+  physics->SetParam("island_threads", 0);
+}
+
+/////////////////////////////////////////////////
+/// Mesh collisions can be made of convex hulls.
+TEST_F(ODEPhysics_TEST, ConvexDecomposition)
+{
+  Load("worlds/empty.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  // Two boxes apart in one mesh
+  common::MeshManager *manager = common::MeshManager::Instance();
+  const common::Mesh *box = manager->GetMesh("unit_box");
+  ASSERT_TRUE(box != nullptr);
+  common::Mesh *twoBoxes = new common::Mesh();
+  twoBoxes->SetName("convex_two_boxes");
+  for (double x : {-2.0, 2.0})
+  {
+    common::SubMesh *subMesh = new common::SubMesh(box->GetSubMesh(0));
+    subMesh->Translate(ignition::math::Vector3d(x, 0, 0));
+    twoBoxes->AddSubMesh(subMesh);
+  }
+  manager->AddMesh(twoBoxes);
+
+  std::ostringstream sdfStream;
+  sdfStream << "<sdf version='" << SDF_VERSION << "'>"
+    << "<model name='hulls'>"
+    << "<pose>0 0 2 0 0 0</pose>"
+    << "<link name='link'>"
+    << "  <collision name='collision'>"
+    << "    <geometry>"
+    << "      <mesh>"
+    << "        <uri>convex_two_boxes</uri>"
+    << "        <gz:convex_decomposition>true</gz:convex_decomposition>"
+    << "      </mesh>"
+    << "    </geometry>"
+    << "  </collision>"
+    << "</link>"
+    << "</model>"
+    << "</sdf>";
+  SpawnSDF(sdfStream.str());
+
+  ModelPtr model = world->ModelByName("hulls");
+  ASSERT_TRUE(model != nullptr);
+  ODECollisionPtr collision = boost::dynamic_pointer_cast<ODECollision>(
+      model->GetLink("link")->GetCollision("collision"));
+  ASSERT_TRUE(collision != nullptr);
+  EXPECT_EQ(dConvexClass, collision->GetCollisionClass());
+  EXPECT_EQ(1u, collision->SubCollisionIds().size());
+
+  // Both hulls rest on the ground
+  world->Step(2000);
+  ignition::math::Pose3d pose = model->WorldPose();
+  EXPECT_NEAR(0.5, pose.Pos().Z(), 0.02);
+  EXPECT_NEAR(0.0, pose.Rot().Euler().Y(), 0.01);
+  ignition::math::AxisAlignedBox bounds = collision->BoundingBox();
+  EXPECT_NEAR(-2.5, bounds.Min().X(), 0.02);
+  EXPECT_NEAR(2.5, bounds.Max().X(), 0.02);
+}
+
+/////////////////////////////////////////////////
+/// Mesh pairs collide with ODE's trimesh collider, or with FCL when it is
+/// built.
+TEST_F(ODEPhysics_TEST, MeshCollider)
+{
+  Load("worlds/empty.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+
+  EXPECT_EQ("ode", boost::any_cast<std::string>(
+        physics->GetParam("mesh_collider")));
+  EXPECT_FALSE(physics->SetParam("mesh_collider", std::string("gjk")));
+#ifdef HAVE_FCL
+  EXPECT_TRUE(physics->SetParam("mesh_collider", std::string("fcl")));
+#else
+  EXPECT_FALSE(physics->SetParam("mesh_collider", std::string("fcl")));
+#endif
+  const std::string collider = boost::any_cast<std::string>(
+      physics->GetParam("mesh_collider"));
+
+  // A mesh box falling on a static mesh slab
+  for (const std::string name : {"slab", "box"})
+  {
+    const bool slab = name == "slab";
+    std::ostringstream sdfStream;
+    sdfStream << "<sdf version='" << SDF_VERSION << "'>"
+      << "<model name='" << name << "'>"
+      << "<static>" << slab << "</static>"
+      << "<pose>0 0 " << (slab ? 0.5 : 3.0) << " 0 0 0</pose>"
+      << "<link name='link'>"
+      << "  <collision name='collision'>"
+      << "    <geometry>"
+      << "      <mesh>"
+      << "        <uri>unit_box</uri>"
+      << "        <scale>" << (slab ? "4 4 1" : "1 1 1") << "</scale>"
+      << "      </mesh>"
+      << "    </geometry>"
+      << "  </collision>"
+      << "</link>"
+      << "</model>"
+      << "</sdf>";
+    SpawnSDF(sdfStream.str());
+  }
+  ModelPtr box = world->ModelByName("box");
+  ASSERT_TRUE(box != nullptr);
+
+  world->Step(3000);
+  EXPECT_NEAR(1.5, box->WorldPose().Pos().Z(), 0.05) << collider;
+  EXPECT_NEAR(0.0, box->WorldPose().Pos().X(), 0.05) << collider;
+}
+
+/////////////////////////////////////////////////
+/// Shapes rest on a static mesh whose contacts come from a distance field.
+TEST_F(ODEPhysics_TEST, DistanceField)
+{
+  Load("worlds/blank.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  std::ostringstream sdfStream;
+  sdfStream << "<sdf version='" << SDF_VERSION << "'>"
+    << "<model name='floor'>"
+    << "<static>true</static>"
+    << "<pose>0 0 0.5 0 0 0</pose>"
+    << "<link name='link'>"
+    << "  <collision name='collision'>"
+    << "    <geometry>"
+    << "      <mesh>"
+    << "        <uri>unit_box</uri>"
+    << "        <scale>8 8 1</scale>"
+    << "        <gz:distance_field>true</gz:distance_field>"
+    << "        <gz:distance_cell_size>0.05</gz:distance_cell_size>"
+    << "      </mesh>"
+    << "    </geometry>"
+    << "  </collision>"
+    << "</link>"
+    << "</model>"
+    << "</sdf>";
+  SpawnSDF(sdfStream.str());
+
+  SpawnSphere("sphere", ignition::math::Vector3d(-2, 0, 3),
+      ignition::math::Vector3d::Zero, ignition::math::Vector3d::Zero, 0.5);
+  SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(2, 0, 3), ignition::math::Vector3d::Zero);
+  SpawnCylinder("cylinder", ignition::math::Vector3d(0, 2, 3),
+      ignition::math::Vector3d::Zero);
+
+  world->Step(3000);
+  for (const std::string name : {"sphere", "box", "cylinder"})
+  {
+    ModelPtr model = world->ModelByName(name);
+    ASSERT_TRUE(model != nullptr);
+    EXPECT_NEAR(1.5, model->WorldPose().Pos().Z(), 0.02) << name;
+    EXPECT_NEAR(0.0, model->WorldLinearVel().Length(), 0.01) << name;
+  }
+}
+
+/////////////////////////////////////////////////
+/// A small fast sphere tunnels through a thin wall, unless continuous
+/// collision detection is enabled on its link.
+TEST_F(ODEPhysics_TEST, ContinuousCollision)
+{
+  Load("worlds/blank.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  SpawnBox("wall", ignition::math::Vector3d(0.02, 4, 4),
+      ignition::math::Vector3d(2, 0, 0), ignition::math::Vector3d::Zero,
+      true);
+
+  std::vector<LinkPtr> links;
+  for (const std::string name : {"discrete", "continuous"})
+  {
+    SpawnSphere(name, ignition::math::Vector3d(0, links.empty() ? -1 : 1, 0),
+        ignition::math::Vector3d::Zero, ignition::math::Vector3d::Zero, 0.05);
+    ModelPtr model = world->ModelByName(name);
+    ASSERT_TRUE(model != nullptr);
+    LinkPtr link = model->GetLink();
+    ASSERT_TRUE(link != nullptr);
+    EXPECT_FALSE(link->ContinuousCollision());
+    link->SetGravityMode(false);
+    links.push_back(link);
+  }
+  links[1]->SetContinuousCollision(true);
+  EXPECT_TRUE(links[1]->ContinuousCollision());
+
+  // 0.3m per step jumps over the wall and the sphere
+  for (auto const &link : links)
+    link->SetLinearVel(ignition::math::Vector3d(300, 0, 0));
+
+  world->Step(20);
+  EXPECT_GT(links[0]->WorldPose().Pos().X(), 2.0);
+  EXPECT_LT(links[1]->WorldPose().Pos().X(), 2.0);
+}
+
+/////////////////////////////////////////////////
+TEST_F(ODEPhysics_TEST, StepMultiple)
+{
+  Load("worlds/empty.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  // Two boxes falling from the same height
+  SpawnBox("fine_box", ignition::math::Vector3d(1, 1, 1),
+      ignition::math::Vector3d(0, 0, 10));
+  SpawnBox("coarse_box", ignition::math::Vector3d(1, 1, 1),
+      ignition::math::Vector3d(5, 0, 10));
+
+  auto fineBox = world->ModelByName("fine_box");
+  auto coarseBox = world->ModelByName("coarse_box");
+  ASSERT_TRUE(fineBox != nullptr);
+  ASSERT_TRUE(coarseBox != nullptr);
+
+  EXPECT_EQ(1u, coarseBox->StepMultiple());
+  coarseBox->SetStepMultiple(0);
+  EXPECT_EQ(1u, coarseBox->StepMultiple());
+  coarseBox->SetStepMultiple(10);
+  EXPECT_EQ(10u, coarseBox->StepMultiple());
+
+  // The coarse box only moves every 10 steps
+  world->Step(5);
+  EXPECT_LT(fineBox->WorldPose().Pos().Z(), 10.0);
+  EXPECT_DOUBLE_EQ(10.0, coarseBox->WorldPose().Pos().Z());
+  world->Step(5);
+  EXPECT_LT(coarseBox->WorldPose().Pos().Z(), 10.0);
+
+  // Both boxes fall at the same speed
+  world->Step(490);
+  EXPECT_NEAR(fineBox->WorldPose().Pos().Z(),
+      coarseBox->WorldPose().Pos().Z(), 0.05);
+  EXPECT_NEAR(fineBox->WorldLinearVel().Z(),
+      coarseBox->WorldLinearVel().Z(), 0.05);
+
+  // Back to the world rate
+  coarseBox->SetStepMultiple(1);
+  EXPECT_EQ(1u, coarseBox->StepMultiple());
+  auto z = coarseBox->WorldPose().Pos().Z();
+  world->Step(1);
+  EXPECT_LT(coarseBox->WorldPose().Pos().Z(), z);
+}
+
+/////////////////////////////////////////////////
+TEST_F(ODEPhysics_TEST, StepMultipleAutoDisable)
+{
+  Load("worlds/empty.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  SpawnBox("resting_box", ignition::math::Vector3d(1, 1, 1),
+      ignition::math::Vector3d(0, 0, 0.5));
+  SpawnBox("coarse_box", ignition::math::Vector3d(1, 1, 1),
+      ignition::math::Vector3d(5, 0, 1000));
+
+  auto restingBox = world->ModelByName("resting_box");
+  auto coarseBox = world->ModelByName("coarse_box");
+  ASSERT_TRUE(restingBox != nullptr);
+  ASSERT_TRUE(coarseBox != nullptr);
+  auto link = restingBox->GetLink();
+  ASSERT_TRUE(link != nullptr);
+  link->SetAutoDisable(true);
+  coarseBox->SetStepMultiple(10);
+
+  // Stepping the falling coarse box doesn't keep the resting box awake
+  world->Step(3000);
+  EXPECT_FALSE(link->GetEnabled());
+  EXPECT_TRUE(coarseBox->GetLink()->GetEnabled());
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int argc, char **argv)
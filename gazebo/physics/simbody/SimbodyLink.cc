@@ -115,6 +115,7 @@ void SimbodyLink::Fini()
 /////////////////////////////////////////////////////////////////////
 void SimbodyLink::UpdateMass()
 {
+  this->ResetWorldCache();
 }
 
 //////////////////////////////////////////////////
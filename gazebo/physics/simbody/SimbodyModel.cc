@@ -84,12 +84,19 @@ void SimbodyModel::Init()
   physics::SimbodyPhysicsPtr simbodyPhysics =
     boost::dynamic_pointer_cast<physics::SimbodyPhysics>(
         this->GetWorld()->Physics());
-  if (simbodyPhysics)
+  if (simbodyPhysics && !simbodyPhysics->InitModel(
+        boost::static_pointer_cast<Model>(shared_from_this())))
   {
-    simbodyPhysics->InitModel(
-        boost::static_pointer_cast<Model>(shared_from_this()));
+    // The joints are initialized once the system is realized
+    return;
   }
 
+  this->InitJoints();
+}
+
+//////////////////////////////////////////////////
+void SimbodyModel::InitJoints()
+{
   // Initialize the joints last.
   Joint_V myJoints = this->GetJoints();
   for (Joint_V::iterator iter = myJoints.begin();
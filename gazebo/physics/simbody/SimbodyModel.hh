@@ -44,6 +44,11 @@ namespace gazebo
 
       // Documentation inherited
       public: virtual void Init();
+
+      /// \brief Initialize the joints. Done by Init, or by
+      /// SimbodyPhysics::Init for models loaded with the world, once the
+      /// Simbody system has been realized.
+      public: void InitJoints();
     };
     /// \}
   }
@@ -16,6 +16,7 @@
 */
 
 #include <string>
+#include <vector>
 
 #include "gazebo/physics/simbody/SimbodyTypes.hh"
 #include "gazebo/physics/simbody/SimbodyModel.hh"
@@ -54,6 +55,7 @@
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
+#include "gazebo/common/Profiler.hh"
 
 #include "gazebo/transport/Publisher.hh"
 
@@ -258,49 +260,38 @@ void SimbodyPhysics::Reset()
 //////////////////////////////////////////////////
 void SimbodyPhysics::Init()
 {
-  this->simbodyPhysicsInitialized = true;
-}
+  this->engineInitialized = true;
 
-//////////////////////////////////////////////////
-void SimbodyPhysics::InitModel(const physics::ModelPtr _model)
-{
-  // Before building a new system, transfer all joints in existing
-  // models, save Simbody joint states in Gazebo Model.
-  const SimTK::State& currentState = this->integ->getState();
-  double stateTime = 0;
-  bool simbodyStateSaved = false;
-
-  if (currentState.getSystemStage() != SimTK::Stage::Empty)
+  // The models loaded with the world were added to the system without
+  // realizing it, realize it once for all of them.
+  if (!this->pendingModels.empty())
   {
-    stateTime = currentState.getTime();
-    physics::Model_V models = this->world->Models();
-    for (physics::Model_V::iterator mi = models.begin();
-         mi != models.end(); ++mi)
-    {
-      if ((*mi) != _model)
-      {
-        physics::Joint_V joints = (*mi)->GetJoints();
-        for (physics::Joint_V::iterator jx = joints.begin();
-             jx != joints.end(); ++jx)
-        {
-          SimbodyJointPtr simbodyJoint =
-            boost::dynamic_pointer_cast<physics::SimbodyJoint>(*jx);
-          simbodyJoint->SaveSimbodyState(currentState);
-        }
+    std::vector<physics::ModelPtr> models;
+    models.swap(this->pendingModels);
 
-        physics::Link_V links = (*mi)->GetLinks();
-        for (physics::Link_V::iterator lx = links.begin();
-             lx != links.end(); ++lx)
-        {
-          SimbodyLinkPtr simbodyLink =
-            boost::dynamic_pointer_cast<physics::SimbodyLink>(*lx);
-          simbodyLink->SaveSimbodyState(currentState);
-        }
-      }
+    this->RealizeSystem();
+    this->simbodyPhysicsInitialized = true;
+    for (auto const &model : models)
+    {
+      this->MarkModelInitialized(model);
+      SimbodyModelPtr simbodyModel =
+          boost::dynamic_pointer_cast<SimbodyModel>(model);
+      if (simbodyModel)
+        simbodyModel->InitJoints();
     }
-    simbodyStateSaved = true;
   }
 
+  this->simbodyPhysicsInitialized = true;
+}
+
+//////////////////////////////////////////////////
+bool SimbodyPhysics::InitModel(const physics::ModelPtr _model)
+{
+  // Before building a new system, save the coordinates and speeds of the
+  // existing mobilized bodies. Bodies are only ever appended to the matter
+  // subsystem, so their indices are still valid in the new system.
+  this->SaveMobilizerStates();
+
   try
   {
     //------------------------ CREATE SIMBODY SYSTEM ---------------------------
@@ -325,6 +316,47 @@ void SimbodyPhysics::InitModel(const physics::ModelPtr _model)
     gzthrow(std::string("Simbody build EXCEPTION: ") + e.what());
   }
 
+  // Realizing the topology costs as much as the whole system, so while the
+  // world is loading it is done once in Init for all models.
+  if (!this->engineInitialized)
+  {
+    this->pendingModels.push_back(_model);
+    return false;
+  }
+
+  this->RealizeSystem();
+  this->MarkModelInitialized(_model);
+  this->simbodyPhysicsInitialized = true;
+  return true;
+}
+
+//////////////////////////////////////////////////
+void SimbodyPhysics::SaveMobilizerStates()
+{
+  this->savedQ.clear();
+  this->savedU.clear();
+
+  const SimTK::State &currentState = this->integ->getState();
+  if (currentState.getSystemStage() < SimTK::Stage::Model)
+    return;
+
+  this->savedTime = currentState.getTime();
+
+  // Body 0 is Ground, which has no mobilizer
+  const int numBodies = this->matter.getNumBodies();
+  this->savedQ.resize(numBodies);
+  this->savedU.resize(numBodies);
+  for (SimTK::MobilizedBodyIndex i(1); i < numBodies; ++i)
+  {
+    const SimTK::MobilizedBody &mobod = this->matter.getMobilizedBody(i);
+    this->savedQ[i] = mobod.getQAsVector(currentState);
+    this->savedU[i] = mobod.getUAsVector(currentState);
+  }
+}
+
+//////////////////////////////////////////////////
+void SimbodyPhysics::RealizeSystem()
+{
   try
   {
     //------------------------ CREATE SIMBODY SYSTEM ---------------------------
@@ -338,39 +370,31 @@ void SimbodyPhysics::InitModel(const physics::ModelPtr _model)
 
   SimTK::State state = this->system.realizeTopology();
 
-  // Restore Gazebo saved Joint states
-  // back into Simbody state.
-  if (simbodyStateSaved)
+  // Restore the saved mobilizer states into the new state
+  if (!this->savedQ.empty())
   {
     // set/retsore state time.
-    state.setTime(stateTime);
+    state.setTime(this->savedTime);
 
-    physics::Model_V models = this->world->Models();
-    for (physics::Model_V::iterator mi = models.begin();
-         mi != models.end(); ++mi)
+    this->system.realizeModel(state);
+    for (SimTK::MobilizedBodyIndex i(1);
+         i < static_cast<int>(this->savedQ.size()); ++i)
     {
-      physics::Joint_V joints = (*mi)->GetJoints();
-      for (physics::Joint_V::iterator jx = joints.begin();
-           jx != joints.end(); ++jx)
-      {
-        SimbodyJointPtr simbodyJoint =
-          boost::dynamic_pointer_cast<physics::SimbodyJoint>(*jx);
-        simbodyJoint->RestoreSimbodyState(state);
-      }
-      physics::Link_V links = (*mi)->GetLinks();
-      for (physics::Link_V::iterator lx = links.begin();
-           lx != links.end(); ++lx)
-      {
-        SimbodyLinkPtr simbodyLink =
-          boost::dynamic_pointer_cast<physics::SimbodyLink>(*lx);
-        simbodyLink->RestoreSimbodyState(state);
-      }
+      const SimTK::MobilizedBody &mobod = this->matter.getMobilizedBody(i);
+      mobod.setQFromVector(state, this->savedQ[i]);
+      mobod.setUFromVector(state, this->savedU[i]);
     }
+    this->savedQ.clear();
+    this->savedU.clear();
   }
 
   // initialize integrator from state
   this->integ->initialize(state);
+}
 
+//////////////////////////////////////////////////
+void SimbodyPhysics::MarkModelInitialized(const physics::ModelPtr _model)
+{
   // mark links as initialized
   Link_V links = _model->GetLinks();
   for (Link_V::iterator li = links.begin(); li != links.end(); ++li)
@@ -397,8 +421,6 @@ void SimbodyPhysics::InitModel(const physics::ModelPtr _model)
       gzerr << "simbodyJoint [" << (*ji)->GetName()
             << "]is not a SimbodyJointPtr\n";
   }
-
-  this->simbodyPhysicsInitialized = true;
 }
 
 //////////////////////////////////////////////////
@@ -409,6 +431,7 @@ void SimbodyPhysics::InitForThread()
 //////////////////////////////////////////////////
 void SimbodyPhysics::UpdateCollision()
 {
+  GZ_PROFILE("SimbodyPhysics::UpdateCollision");
   boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
 
   this->contactManager->ResetCount();
@@ -637,6 +660,7 @@ void SimbodyPhysics::UpdateCollision()
 //////////////////////////////////////////////////
 void SimbodyPhysics::UpdatePhysics()
 {
+  GZ_PROFILE("SimbodyPhysics::UpdatePhysics");
   // need to lock, otherwise might conflict with world resetting
   boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
 
@@ -688,8 +712,7 @@ void SimbodyPhysics::UpdatePhysics()
       auto pose = SimbodyPhysics::Transform2PoseIgn(
         simbodyLink->masterMobod.getBodyTransform(s));
       simbodyLink->SetDirtyPose(pose);
-      this->world->dataPtr->dirtyPoses.push_back(
-        boost::static_pointer_cast<Entity>(*lx).get());
+      this->world->_AddDirty(boost::static_pointer_cast<Entity>(*lx).get());
     }
 
     physics::Joint_V joints = (*mi)->GetJoints();
@@ -710,6 +733,8 @@ void SimbodyPhysics::UpdatePhysics()
 //////////////////////////////////////////////////
 void SimbodyPhysics::Fini()
 {
+  this->pendingModels.clear();
+
   PhysicsEngine::Fini();
 }
 
@@ -18,6 +18,7 @@
 #ifndef GAZEBO_PHYSICS_SIMBODY_SIMBODYPHYSICS_HH
 #define GAZEBO_PHYSICS_SIMBODY_SIMBODYPHYSICS_HH
 #include <string>
+#include <vector>
 
 #include <boost/thread/thread.hpp>
 #include <boost/thread/mutex.hpp>
@@ -56,9 +57,14 @@ namespace gazebo
       // Documentation inherited
       public: virtual void Reset();
 
-      /// \brief Add a Model to the Simbody system.
+      /// \brief Add a Model to the Simbody system. The system is realized
+      /// again right away, except while the world is loading: models added
+      /// before Init are realized together in Init, which then initializes
+      /// their joints with SimbodyModel::InitJoints.
       /// \param[in] _model Pointer to the model to add into Simbody.
-      public: void InitModel(const physics::ModelPtr _model);
+      /// \return True if the model is part of the realized system, false if
+      /// its realization was deferred to Init.
+      public: bool InitModel(const physics::ModelPtr _model);
 
       // Documentation inherited
       public: virtual void InitForThread();
@@ -203,6 +209,19 @@ namespace gazebo
         const SimTK::MultibodyGraphMaker &_mbgraph,
         const physics::ModelPtr _model);
 
+      /// \brief Save the coordinates and speeds of all mobilized bodies of
+      /// the current state, before the system topology changes.
+      private: void SaveMobilizerStates();
+
+      /// \brief Realize the system topology, restore the states saved by
+      /// SaveMobilizerStates and initialize the integrator.
+      private: void RealizeSystem();
+
+      /// \brief Mark the links and joints of a model as initialized, once
+      /// the model is part of the realized system.
+      /// \param[in] _model The model.
+      private: void MarkModelInitialized(const physics::ModelPtr _model);
+
       /// \brief helper function for building SimbodySystem
       private: void AddCollisionsToLink(const physics::SimbodyLink *_link,
         SimTK::MobilizedBody &_mobod, SimTK::ContactCliqueId _modelClique);
@@ -268,6 +287,24 @@ namespace gazebo
 
       private: SimTK::MultibodySystem *dynamicsWorld;
 
+      /// \brief True once Init was called.
+      private: bool engineInitialized = false;
+
+      /// \brief Models added while the world is loading, which wait for
+      /// Init to realize the system.
+      private: std::vector<physics::ModelPtr> pendingModels;
+
+      /// \brief Coordinates of the mobilized bodies, by MobilizedBodyIndex,
+      /// saved while the system is rebuilt.
+      private: std::vector<SimTK::Vector> savedQ;
+
+      /// \brief Speeds of the mobilized bodies, by MobilizedBodyIndex, saved
+      /// while the system is rebuilt.
+      private: std::vector<SimTK::Vector> savedU;
+
+      /// \brief Time of the state saved while the system is rebuilt.
+      private: double savedTime = 0;
+
       private: common::Time lastUpdateTime;
 
       private: double stepTimeDouble;
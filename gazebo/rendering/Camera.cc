@@ -15,7 +15,10 @@
  *
 */
 
+#include <algorithm>
+#include <cmath>
 #include <sstream>
+#include <string>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
@@ -36,6 +39,7 @@
 #include "gazebo/common/Events.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
+#include "gazebo/common/Profiler.hh"
 #include "gazebo/common/VideoEncoder.hh"
 
 #include "gazebo/rendering/ogre_gazebo.h"
@@ -45,6 +49,7 @@
 #include "gazebo/rendering/Conversions.hh"
 #include "gazebo/rendering/Scene.hh"
 #include "gazebo/rendering/Distortion.hh"
+#include "gazebo/rendering/OcclusionCuller.hh"
 #include "gazebo/rendering/CameraPrivate.hh"
 #include "gazebo/rendering/Camera.hh"
 #include "gazebo/rendering/RenderEvents.hh"
@@ -146,6 +151,27 @@ void Camera::Load()
   else
     gzthrow("Camera has no <image> tag.");
 
+  if (this->sdf->HasElement("gz:async_readback"))
+    this->SetAsyncReadback(this->sdf->Get<bool>("gz:async_readback"));
+
+  if (this->sdf->HasElement("gz:lod_bias"))
+    this->SetLodBias(this->sdf->Get<double>("gz:lod_bias"));
+
+  if (this->sdf->HasElement("gz:occlusion_culling"))
+  {
+    this->SetOcclusionCulling(
+        this->sdf->Get<bool>("gz:occlusion_culling"));
+  }
+
+  if (this->sdf->HasElement("gz:visibility_mask"))
+  {
+    this->SetVisibilityMask(
+        this->sdf->Get<unsigned int>("gz:visibility_mask"));
+  }
+
+  if (this->sdf->HasElement("gz:deferred_shading"))
+    this->SetDeferredShading(this->sdf->Get<bool>("gz:deferred_shading"));
+
   // Create the directory to store frames
   if (this->sdf->HasElement("save") &&
       this->sdf->GetElement("save")->Get<bool>("enabled"))
@@ -353,6 +379,10 @@ void Camera::Fini()
 {
   this->dataPtr->videoEncoder.Reset();
 
+  // Write the queued frames
+  this->dataPtr->frameWriter.reset();
+  this->dataPtr->saveOptionsLoaded = false;
+
   if (this->saveFrameBuffer)
     delete [] this->saveFrameBuffer;
   this->saveFrameBuffer = NULL;
@@ -378,12 +408,21 @@ void Camera::Fini()
     this->renderTarget->removeAllViewports();
   this->renderTarget = NULL;
 
+  for (auto &output : this->dataPtr->imageOutputs)
+  {
+    if (output.texture)
+      Ogre::TextureManager::getSingleton().remove(output.texture->getName());
+  }
+  this->dataPtr->imageOutputs.clear();
+
   if (this->renderTexture)
     Ogre::TextureManager::getSingleton().remove(this->renderTexture->getName());
   this->renderTexture = NULL;
 
   if (this->camera)
   {
+    if (this->scene->Occlusion())
+      this->scene->Occlusion()->RemoveCamera(this->camera);
     this->scene->OgreSceneManager()->destroyCamera(this->scopedUniqueName);
     this->camera = NULL;
   }
@@ -391,6 +430,10 @@ void Camera::Fini()
   this->sceneNode = NULL;
   this->cameraNode = nullptr;
   this->viewport = NULL;
+  this->dataPtr->dsGBufferInstance = nullptr;
+  this->dataPtr->dsMergeInstance = nullptr;
+  this->dataPtr->dlGBufferInstance = nullptr;
+  this->dataPtr->dlMergeInstance = nullptr;
 
   this->scene.reset();
   this->connections.clear();
@@ -556,6 +599,8 @@ void Camera::Render(const bool _force)
        common::Time::GetWallTime() - this->lastRenderWallTime >=
         this->dataPtr->renderPeriod))
   {
+    this->dataPtr->prevRenderSimTime = this->dataPtr->renderSimTime;
+    this->dataPtr->renderSimTime = this->scene->SimTime();
     this->newData = true;
     this->RenderImpl();
   }
@@ -564,10 +609,17 @@ void Camera::Render(const bool _force)
 //////////////////////////////////////////////////
 void Camera::RenderImpl()
 {
+  GZ_PROFILE("Camera::RenderImpl");
   if (this->renderTarget)
   {
     Events::cameraPreRender(this->Name());
-    this->renderTarget->update();
+
+    // The buffers are swapped in PostRender, like the depth and laser
+    // targets. All the cameras rendered in a frame are submitted back to
+    // back, before the first one is resolved and read back.
+    this->renderTarget->update(false);
+    this->dataPtr->swapPending = true;
+
     Events::cameraPostRender(this->Name());
   }
 }
@@ -587,8 +639,37 @@ void Camera::ReadPixelBuffer()
         static_cast<Ogre::PixelFormat>(this->imageFormat));
 
     // Allocate buffer
+    bool allocated = false;
     if (!this->saveFrameBuffer)
+    {
       this->saveFrameBuffer = new unsigned char[size];
+      allocated = true;
+    }
+
+    // Read the frame started by the previous call, and start this one
+    if (this->ReadbackLatency() > 0 && this->renderTexture &&
+        this->renderTexture->getBuffer()->getRenderTarget() ==
+        this->renderTarget)
+    {
+      if (this->dataPtr->readback.Read(this->renderTexture,
+            this->imageFormat, width, height, this->saveFrameBuffer))
+      {
+        this->MarkImageDelivered(true);
+      }
+      else
+      {
+        // There's no frame to deliver yet
+        if (allocated)
+        {
+          delete [] this->saveFrameBuffer;
+          this->saveFrameBuffer = nullptr;
+        }
+        this->newData = false;
+      }
+      return;
+    }
+    this->dataPtr->readback.Reset();
+    this->MarkImageDelivered(false);
 
     memset(this->saveFrameBuffer, 128, size);
 
@@ -642,6 +723,324 @@ void Camera::ReadPixelBuffer()
   }
 }
 
+//////////////////////////////////////////////////
+void Camera::SetAsyncReadback(const bool _enable)
+{
+  if (this->dataPtr->asyncReadback != _enable)
+    this->dataPtr->readback.Reset();
+  this->dataPtr->asyncReadback = _enable;
+}
+
+//////////////////////////////////////////////////
+bool Camera::AsyncReadback() const
+{
+  return this->dataPtr->asyncReadback;
+}
+
+//////////////////////////////////////////////////
+void Camera::SetLodBias(const double _bias)
+{
+  if (_bias <= 0.0 || !std::isfinite(_bias))
+  {
+    gzerr << "Camera[" << this->Name() << "] LOD bias must be greater than "
+          << "zero, got[" << _bias << "]" << std::endl;
+    return;
+  }
+
+  this->dataPtr->lodBias = _bias;
+  if (this->camera)
+    this->camera->setLodBias(_bias);
+}
+
+//////////////////////////////////////////////////
+double Camera::LodBias() const
+{
+  return this->dataPtr->lodBias;
+}
+
+//////////////////////////////////////////////////
+void Camera::SetOcclusionCulling(const bool _enable)
+{
+  this->dataPtr->occlusionCulling = _enable;
+  if (!this->camera || !this->scene || !this->scene->Occlusion())
+    return;
+
+  if (!_enable)
+    this->scene->Occlusion()->RemoveCamera(this->camera);
+  else if (!this->scene->Occlusion()->AddCamera(this->camera))
+  {
+    gzwarn << "Occlusion queries are not supported, camera["
+           << this->Name() << "] will not cull occluded objects" << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+bool Camera::OcclusionCulling() const
+{
+  return this->dataPtr->occlusionCulling;
+}
+
+//////////////////////////////////////////////////
+void Camera::SetVisibilityMask(const uint32_t _mask)
+{
+  this->dataPtr->visibilityMask = _mask;
+  if (this->viewport)
+    this->viewport->setVisibilityMask(_mask);
+}
+
+//////////////////////////////////////////////////
+uint32_t Camera::VisibilityMask() const
+{
+  if (this->viewport)
+    return this->viewport->getVisibilityMask();
+  return this->dataPtr->visibilityMask;
+}
+
+//////////////////////////////////////////////////
+bool Camera::SetDeferredShading(const bool _enable)
+{
+  if (_enable && !RenderEngine::Instance()->InitDeferredShading())
+  {
+    gzwarn << "Deferred shading isn't supported by the render system, "
+           << "camera[" << this->Name() << "] keeps forward shading"
+           << std::endl;
+    this->dataPtr->deferredShading = false;
+    this->UpdateDeferredShading();
+    return false;
+  }
+
+  this->dataPtr->deferredShading = _enable;
+  this->UpdateDeferredShading();
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Camera::DeferredShading() const
+{
+  return this->dataPtr->deferredShading;
+}
+
+//////////////////////////////////////////////////
+void Camera::UpdateDeferredShading()
+{
+  if (!this->viewport)
+    return;
+
+  Ogre::CompositorManager &compMgr = Ogre::CompositorManager::getSingleton();
+  if (this->dataPtr->deferredShading && !this->dataPtr->dsGBufferInstance)
+  {
+    // The geometry buffer and the lighting come before the other
+    // compositors, such as noise and distortion, which filter the lit image
+    this->dataPtr->dsGBufferInstance =
+      compMgr.addCompositor(this->viewport, "DeferredShading/GBuffer", 0);
+    this->dataPtr->dsMergeInstance =
+      compMgr.addCompositor(this->viewport, "DeferredShading/ShowLit", 1);
+    if (!this->dataPtr->dsGBufferInstance || !this->dataPtr->dsMergeInstance)
+    {
+      gzerr << "Unable to add the deferred shading compositors to camera["
+            << this->Name() << "]" << std::endl;
+      if (this->dataPtr->dsGBufferInstance)
+      {
+        compMgr.removeCompositor(this->viewport, "DeferredShading/GBuffer");
+        this->dataPtr->dsGBufferInstance = nullptr;
+      }
+      this->dataPtr->dsMergeInstance = nullptr;
+      this->dataPtr->deferredShading = false;
+    }
+    else
+    {
+      // The lit image is cleared by the compositor instead of the viewport
+      Ogre::CompositionTargetPass *output =
+        this->dataPtr->dsMergeInstance->getTechnique()->getOutputTargetPass();
+      for (unsigned int i = 0; i < output->getNumPasses(); ++i)
+      {
+        Ogre::CompositionPass *pass = output->getPass(i);
+        if (pass->getType() == Ogre::CompositionPass::PT_CLEAR)
+          pass->setClearColour(this->viewport->getBackgroundColour());
+      }
+    }
+  }
+
+  if (this->dataPtr->dsGBufferInstance)
+  {
+    this->dataPtr->dsGBufferInstance->setEnabled(
+        this->dataPtr->deferredShading);
+    this->dataPtr->dsMergeInstance->setEnabled(
+        this->dataPtr->deferredShading);
+  }
+
+  // The deferred lighting of the deferred render path is replaced
+  if (this->dataPtr->dlGBufferInstance)
+  {
+    this->dataPtr->dlGBufferInstance->setEnabled(
+        !this->dataPtr->deferredShading);
+    this->dataPtr->dlMergeInstance->setEnabled(
+        !this->dataPtr->deferredShading);
+  }
+}
+
+//////////////////////////////////////////////////
+unsigned int Camera::ReadbackLatency() const
+{
+  return (this->dataPtr->asyncReadback &&
+      TextureReadback::Supported(this->imageFormat)) ? 1u : 0u;
+}
+
+//////////////////////////////////////////////////
+int Camera::AddImageOutput(const unsigned int _x, const unsigned int _y,
+    const unsigned int _width, const unsigned int _height, const double _scale)
+{
+  if (!this->renderTexture)
+  {
+    gzerr << "Camera[" << this->Name() << "] has no render texture to add "
+          << "an image output to" << std::endl;
+    return -1;
+  }
+
+  CameraImageOutput output;
+  output.left = _x;
+  output.top = _y;
+  output.right = _width > 0 ? _x + _width : this->ImageWidth();
+  output.bottom = _height > 0 ? _y + _height : this->ImageHeight();
+  if (output.left >= output.right || output.top >= output.bottom ||
+      output.right > this->ImageWidth() || output.bottom > this->ImageHeight())
+  {
+    gzerr << "Camera[" << this->Name() << "] image output region is not "
+          << "within the " << this->ImageWidth() << "x" << this->ImageHeight()
+          << " image" << std::endl;
+    return -1;
+  }
+
+  if (!(_scale > 0.0 && _scale <= 1.0))
+  {
+    gzerr << "Camera[" << this->Name() << "] image output scale must be in "
+          << "(0, 1], got[" << _scale << "]" << std::endl;
+    return -1;
+  }
+
+  output.width = std::max(1u, static_cast<unsigned int>(
+        std::round((output.right - output.left) * _scale)));
+  output.height = std::max(1u, static_cast<unsigned int>(
+        std::round((output.bottom - output.top) * _scale)));
+
+  // A scaled region is blitted into a texture of the output size, which
+  // the render system filters on the GPU.
+  const int index = static_cast<int>(this->dataPtr->imageOutputs.size());
+  if (output.width != output.right - output.left ||
+      output.height != output.bottom - output.top)
+  {
+    output.texture = Ogre::TextureManager::getSingleton().createManual(
+        this->renderTexture->getName() + "_output" + std::to_string(index),
+        "General",
+        Ogre::TEX_TYPE_2D,
+        output.width,
+        output.height,
+        0,
+        static_cast<Ogre::PixelFormat>(this->imageFormat),
+        Ogre::TU_RENDERTARGET).getPointer();
+  }
+
+  this->dataPtr->imageOutputs.push_back(std::move(output));
+  return index;
+}
+
+//////////////////////////////////////////////////
+void Camera::SetImageOutputEnabled(const unsigned int _index,
+    const bool _enabled)
+{
+  if (_index < this->dataPtr->imageOutputs.size())
+    this->dataPtr->imageOutputs[_index].enabled = _enabled;
+}
+
+//////////////////////////////////////////////////
+unsigned int Camera::ImageOutputCount() const
+{
+  return this->dataPtr->imageOutputs.size();
+}
+
+//////////////////////////////////////////////////
+unsigned int Camera::ImageOutputWidth(const unsigned int _index) const
+{
+  if (_index >= this->dataPtr->imageOutputs.size())
+    return 0;
+  return this->dataPtr->imageOutputs[_index].width;
+}
+
+//////////////////////////////////////////////////
+unsigned int Camera::ImageOutputHeight(const unsigned int _index) const
+{
+  if (_index >= this->dataPtr->imageOutputs.size())
+    return 0;
+  return this->dataPtr->imageOutputs[_index].height;
+}
+
+//////////////////////////////////////////////////
+const unsigned char *Camera::ImageOutputData(const unsigned int _index) const
+{
+  if (_index >= this->dataPtr->imageOutputs.size() ||
+      this->dataPtr->imageOutputs[_index].data.empty())
+  {
+    return nullptr;
+  }
+  return this->dataPtr->imageOutputs[_index].data.data();
+}
+
+//////////////////////////////////////////////////
+void Camera::ReadImageOutputs()
+{
+  if (!this->newData || !this->renderTexture)
+    return;
+
+  Ogre::HardwarePixelBufferSharedPtr source = this->renderTexture->getBuffer();
+  const Ogre::PixelFormat format =
+      static_cast<Ogre::PixelFormat>(this->imageFormat);
+  for (auto &output : this->dataPtr->imageOutputs)
+  {
+    if (!output.enabled)
+      continue;
+
+    output.data.resize(Ogre::PixelUtil::getMemorySize(
+          output.width, output.height, 1, format));
+    Ogre::PixelBox box(output.width, output.height, 1, format,
+        output.data.data());
+    const Ogre::Box region(output.left, output.top, output.right,
+        output.bottom);
+
+    // Only the region, or its scaled copy, is read back
+    if (output.texture)
+    {
+      Ogre::HardwarePixelBufferSharedPtr scaled = output.texture->getBuffer();
+      scaled->blit(source, region,
+          Ogre::Box(0, 0, output.width, output.height));
+      scaled->blitToMemory(box);
+    }
+    else
+    {
+      source->blitToMemory(region, box);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+common::Time Camera::ImageSimTime() const
+{
+  return this->dataPtr->imageSimTime;
+}
+
+//////////////////////////////////////////////////
+uint64_t Camera::ImageCount() const
+{
+  return this->dataPtr->imageCount;
+}
+
+//////////////////////////////////////////////////
+void Camera::MarkImageDelivered(const bool _previous)
+{
+  this->dataPtr->imageSimTime = _previous ?
+      this->dataPtr->prevRenderSimTime : this->dataPtr->renderSimTime;
+  ++this->dataPtr->imageCount;
+}
+
 //////////////////////////////////////////////////
 common::Time Camera::LastRenderWallTime() const
 {
@@ -651,6 +1050,14 @@ common::Time Camera::LastRenderWallTime() const
 //////////////////////////////////////////////////
 void Camera::PostRender()
 {
+  if (this->dataPtr->swapPending)
+  {
+    if (this->renderTarget)
+      this->renderTarget->swapBuffers();
+    this->dataPtr->swapPending = false;
+  }
+
+  this->ReadImageOutputs();
   this->ReadPixelBuffer();
 
   // Only record last render time if data was actually generated
@@ -678,7 +1085,23 @@ void Camera::PostRender()
     if (this->sdf->HasElement("save") &&
         this->sdf->GetElement("save")->Get<bool>("enabled"))
     {
-      this->SaveFrame(this->FrameFilename());
+      if (!this->dataPtr->saveOptionsLoaded)
+        this->LoadSaveOptions();
+
+      const std::string filename = this->FrameFilename();
+      if (!this->dataPtr->frameWriter)
+      {
+        this->SaveFrame(filename);
+      }
+      else if (!this->dataPtr->frameWriter->Write(this->saveFrameBuffer,
+            width, height, this->ImageDepth(), this->ImageFormat(), filename) &&
+          !this->dataPtr->saveDropWarned)
+      {
+        gzwarn << "Camera[" << this->ScopedName() << "] drops the frames it "
+               << "can't write fast enough, starting with [" << filename
+               << "]\n";
+        this->dataPtr->saveDropWarned = true;
+      }
     }
 
     // do last minute conversion if Bayer pattern is requested, go from R8G8B8
@@ -1194,8 +1617,9 @@ std::string Camera::FrameFilename()
   else
   {
     pathToFile = (path.empty()) ? "." : path;
-    pathToFile /= str(boost::format("%s-%04d.jpg")
-        % friendlyName.c_str() % this->saveCount);
+    pathToFile /= str(boost::format("%s-%04d.%s")
+        % friendlyName.c_str() % this->saveCount
+        % this->dataPtr->saveExtension);
     this->saveCount++;
   }
 
@@ -1206,6 +1630,47 @@ std::string Camera::FrameFilename()
   return pathToFile.string();
 }
 
+//////////////////////////////////////////////////
+void Camera::LoadSaveOptions()
+{
+  this->dataPtr->saveOptionsLoaded = true;
+  this->dataPtr->frameWriter.reset();
+
+  sdf::ElementPtr saveElem = this->sdf->GetElement("save");
+
+  this->dataPtr->saveExtension = "jpg";
+  if (saveElem->HasElement("gz:format"))
+  {
+    const std::string format = saveElem->Get<std::string>("gz:format");
+    if (format == "jpg" || format == "png" || format == "raw")
+      this->dataPtr->saveExtension = format;
+    else
+      gzerr << "Unknown <gz:format> [" << format << "], saving jpg files\n";
+  }
+
+  // Frames are encoded in the rendering thread without writer threads
+  const unsigned int threads = saveElem->HasElement("gz:writer_threads") ?
+      saveElem->Get<unsigned int>("gz:writer_threads") : 2u;
+  if (threads == 0)
+    return;
+
+  const unsigned int queueSize = saveElem->HasElement("gz:queue_size") ?
+      saveElem->Get<unsigned int>("gz:queue_size") : 8u;
+
+  FrameWriter::FullPolicy policy = FrameWriter::BLOCK;
+  if (saveElem->HasElement("gz:when_full"))
+  {
+    const std::string whenFull = saveElem->Get<std::string>("gz:when_full");
+    if (whenFull == "drop")
+      policy = FrameWriter::DROP;
+    else if (whenFull != "block")
+      gzerr << "Unknown <gz:when_full> [" << whenFull << "], blocking\n";
+  }
+
+  this->dataPtr->frameWriter.reset(
+      new FrameWriter(threads, queueSize, policy));
+}
+
 /////////////////////////////////////////////////
 std::string Camera::ScreenshotPath() const
 {
@@ -1506,6 +1971,9 @@ void Camera::CreateCamera()
   this->cameraNode = this->sceneNode->createChildSceneNode(
       this->scopedUniqueName + "_cameraNode");
   this->cameraNode->attachObject(this->camera);
+  this->camera->setLodBias(this->dataPtr->lodBias);
+  if (this->dataPtr->occlusionCulling)
+    this->SetOcclusionCulling(true);
 
   if (this->sdf->HasElement("projection_type"))
     this->SetProjectionType(this->sdf->Get<std::string>("projection_type"));
@@ -1552,11 +2020,17 @@ double Camera::LimitFOV(const double _fov)
 void Camera::SetRenderTarget(Ogre::RenderTarget *_target)
 {
   this->renderTarget = _target;
+  this->dataPtr->swapPending = false;
 
   if (this->renderTarget)
   {
-    // Setup the viewport to use the texture
+    // Setup the viewport to use the texture. Compositors of a previous
+    // viewport went with it.
     this->viewport = this->renderTarget->addViewport(this->camera);
+    this->dataPtr->dsGBufferInstance = nullptr;
+    this->dataPtr->dsMergeInstance = nullptr;
+    this->dataPtr->dlGBufferInstance = nullptr;
+    this->dataPtr->dlMergeInstance = nullptr;
     this->viewport->setClearEveryFrame(true);
     this->viewport->setShadowsEnabled(true);
     this->viewport->setOverlaysEnabled(false);
@@ -1568,8 +2042,7 @@ void Camera::SetRenderTarget(Ogre::RenderTarget *_target)
 
     auto const &ignBG = this->scene->BackgroundColor();
     this->viewport->setBackgroundColour(Conversions::Convert(ignBG));
-    this->viewport->setVisibilityMask(GZ_VISIBILITY_ALL &
-        ~(GZ_VISIBILITY_GUI | GZ_VISIBILITY_SELECTABLE));
+    this->viewport->setVisibilityMask(this->dataPtr->visibilityMask);
 
     this->UpdateFOV();
 
@@ -1610,6 +2083,9 @@ void Camera::SetRenderTarget(Ogre::RenderTarget *_target)
       // this->dataPtr->this->ssaoInstance->setEnabled(false);
     }
 
+    if (this->dataPtr->deferredShading)
+      this->UpdateDeferredShading();
+
     if (this->dataPtr->distortion)
       this->dataPtr->distortion->SetCamera(shared_from_this());
 
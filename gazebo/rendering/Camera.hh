@@ -393,7 +393,12 @@ namespace gazebo
       /// \return Far clip distance
       public: double FarClip() const;
 
-      /// \brief Enable or disable saving
+      /// \brief Enable or disable saving. The frames are written by
+      /// background threads, set by elements of <save>: <gz:format> is
+      /// jpg (default), png or raw, <gz:writer_threads> is the number of
+      /// threads (2 by default, 0 to write in the rendering thread),
+      /// <gz:queue_size> is the number of frames waiting for them (8 by
+      /// default), and <gz:when_full> is "block" (default) or "drop".
       /// \param[in] _enable Set to True to enable saving of frames
       public: void EnableSaveFrame(const bool _enable);
 
@@ -492,6 +497,147 @@ namespace gazebo
       /// \brief Capture data once and save to disk
       public: void SetCaptureDataOnce();
 
+      /// \brief Set whether captured data is read back asynchronously. The
+      /// copy of a frame to memory is started in PostRender and delivered
+      /// by the next PostRender, so it overlaps with the next render. The
+      /// image data is then one frame behind, see ReadbackLatency and
+      /// ImageSimTime, and the first frame after enabling delivers no data.
+      /// The default can be set with the <gz:async_readback> element of the
+      /// camera.
+      /// \param[in] _enable True to read back asynchronously.
+      public: void SetAsyncReadback(const bool _enable);
+
+      /// \brief Get whether asynchronous readback was requested.
+      /// \return True if requested with SetAsyncReadback.
+      public: bool AsyncReadback() const;
+
+      /// \brief Set the level of detail bias of the camera. Meshes switch
+      /// to their simplified levels when they cover fewer pixels than the
+      /// threshold of the level, scaled by the inverse of the bias, so a
+      /// higher bias keeps the full resolution meshes further away. The
+      /// default is 1, and can be set with the <gz:lod_bias> element of the
+      /// camera.
+      /// \param[in] _bias The bias, greater than zero.
+      public: void SetLodBias(const double _bias);
+
+      /// \brief Get the level of detail bias of the camera.
+      /// \return The bias.
+      /// \sa SetLodBias
+      public: double LodBias() const;
+
+      /// \brief Set whether the camera skips the entities hidden behind
+      /// other objects. Each entity in the view is tested with a hardware
+      /// occlusion query of its bounding box, and skipped while the last
+      /// query saw none of it. Results arrive a frame or two late, so an
+      /// entity coming out from behind an occluder can be missing from the
+      /// first frames in which it should be seen. Off by default, and can
+      /// be set with the <gz:occlusion_culling> element of the camera.
+      /// \param[in] _enable True to cull occluded entities.
+      public: void SetOcclusionCulling(const bool _enable);
+
+      /// \brief Get whether occlusion culling was requested.
+      /// \return True if requested with SetOcclusionCulling.
+      public: bool OcclusionCulling() const;
+
+      /// \brief Set the visibility mask of the camera. Objects are only
+      /// rendered if their visibility flags share a bit with the mask. GUI
+      /// visuals, such as markers, COM, joint and collision visuals, have
+      /// the GZ_VISIBILITY_GUI flag, which the default mask of non user
+      /// cameras leaves out, along with GZ_VISIBILITY_SELECTABLE. Can be
+      /// set with the <gz:visibility_mask> element of the camera.
+      /// \param[in] _mask The mask.
+      public: void SetVisibilityMask(const uint32_t _mask);
+
+      /// \brief Get the visibility mask of the camera.
+      /// \return The mask.
+      /// \sa SetVisibilityMask
+      public: uint32_t VisibilityMask() const;
+
+      /// \brief Set whether the camera uses deferred shading. The scene is
+      /// first rendered unlit into a geometry buffer, then each light
+      /// shades the pixels covered by its volume, so that the cost grows
+      /// with the lit pixels instead of the lights times the objects.
+      /// Scenes with many point and spot lights render faster, shadows of
+      /// those lights are only drawn on the deferred render path, and
+      /// transparent materials are drawn after the lighting, unlit. Off by
+      /// default, and can be set with the <gz:deferred_shading> element of
+      /// the camera.
+      /// \param[in] _enable True to use deferred shading.
+      /// \return False if _enable is true and the render system doesn't
+      /// support deferred shading, in which case the camera keeps forward
+      /// shading.
+      public: bool SetDeferredShading(const bool _enable);
+
+      /// \brief Get whether the camera uses deferred shading.
+      /// \return True if deferred shading is enabled.
+      /// \sa SetDeferredShading
+      public: bool DeferredShading() const;
+
+      /// \brief Get the number of frames the image data lags behind the
+      /// last render.
+      /// \return 1 if data is read back asynchronously, 0 otherwise, also
+      /// when asynchronous readback was requested but isn't supported by
+      /// the render system.
+      public: unsigned int ReadbackLatency() const;
+
+      /// \brief Add an output of a region of the image, scaled down on the
+      /// GPU, so that consumers of a crop or a thumbnail only read back the
+      /// pixels they need. The region is copied out of the render texture
+      /// in PostRender while the output is enabled, independently of
+      /// SetCaptureData, and always synchronously. Call it once the render
+      /// texture has been created.
+      /// \param[in] _x Left column of the region.
+      /// \param[in] _y Top row of the region.
+      /// \param[in] _width Width of the region, zero for the rest of the
+      /// row.
+      /// \param[in] _height Height of the region, zero for the rest of the
+      /// image.
+      /// \param[in] _scale Scale of the output, in (0, 1].
+      /// \return Index of the output, or -1 if the region isn't within the
+      /// image or the camera has no render texture.
+      public: int AddImageOutput(const unsigned int _x, const unsigned int _y,
+                  const unsigned int _width, const unsigned int _height,
+                  const double _scale = 1.0);
+
+      /// \brief Set whether an image output is read back.
+      /// \param[in] _index Index returned by AddImageOutput.
+      /// \param[in] _enabled True to read it back after each render.
+      public: void SetImageOutputEnabled(const unsigned int _index,
+                  const bool _enabled);
+
+      /// \brief Get the number of image outputs.
+      /// \return Number of outputs added with AddImageOutput.
+      public: unsigned int ImageOutputCount() const;
+
+      /// \brief Get the width of an image output.
+      /// \param[in] _index Index returned by AddImageOutput.
+      /// \return Width in pixels, zero for an invalid index.
+      public: unsigned int ImageOutputWidth(const unsigned int _index) const;
+
+      /// \brief Get the height of an image output.
+      /// \param[in] _index Index returned by AddImageOutput.
+      /// \return Height in pixels, zero for an invalid index.
+      public: unsigned int ImageOutputHeight(const unsigned int _index) const;
+
+      /// \brief Get the pixels of an image output, row by row in the
+      /// format of the render texture.
+      /// \param[in] _index Index returned by AddImageOutput.
+      /// \return The pixels of the last render, or nullptr if the output
+      /// hasn't been read back yet or the index is invalid.
+      public: const unsigned char *ImageOutputData(
+                  const unsigned int _index) const;
+
+      /// \brief Get the sim time at which the image data was rendered.
+      /// \return Scene sim time of the render the data comes from.
+      /// \sa ReadbackLatency
+      public: common::Time ImageSimTime() const;
+
+      /// \brief Get the number of frames read back so far. Sensors can
+      /// compare it between updates to skip a frame that wasn't delivered,
+      /// which happens once after asynchronous readback is enabled.
+      /// \return Number of frames delivered to the image data.
+      public: uint64_t ImageCount() const;
+
       /// \brief Turn on video recording.
       /// \param[in] _format String that represents the video type.
       /// Supported types include: "avi", "ogv", mp4", "v4l2". If using
@@ -774,6 +920,22 @@ namespace gazebo
       /// \brief Read image data from pixel buffer
       protected: void ReadPixelBuffer();
 
+      /// \brief Read the enabled image outputs from the render texture.
+      private: void ReadImageOutputs();
+
+      /// \brief Add the deferred shading compositors to the viewport if
+      /// needed, and enable them if deferred shading is on.
+      private: void UpdateDeferredShading();
+
+      /// \brief Read the file format and the frame writer options of the
+      /// <save> element.
+      private: void LoadSaveOptions();
+
+      /// \brief Record that a frame was read back.
+      /// \param[in] _previous True if the frame is the one rendered before
+      /// the last render, see ReadbackLatency.
+      protected: void MarkImageDelivered(const bool _previous);
+
       /// \brief Implementation of the Camera::TrackVisual call
       /// \param[in] _visualName Name of the visual to track
       /// \return True if able to track the visual
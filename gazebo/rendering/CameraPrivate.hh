@@ -18,25 +18,67 @@
 #define GAZEBO_RENDERING_CAMERAPRIVATE_HH_
 
 #include <deque>
+#include <memory>
 #include <mutex>
 #include <utility>
 #include <list>
+#include <string>
+#include <vector>
 #include <ignition/math/Pose3.hh>
 
 #include "gazebo/common/PID.hh"
+#include "gazebo/common/Time.hh"
 #include "gazebo/common/VideoEncoder.hh"
 #include "gazebo/msgs/msgs.hh"
+#include "gazebo/rendering/FrameWriter.hh"
+#include "gazebo/rendering/RenderTypes.hh"
+#include "gazebo/rendering/TextureReadback.hh"
 #include "gazebo/util/system.hh"
 
 namespace Ogre
 {
   class CompositorInstance;
+  class Texture;
 }
 
 namespace gazebo
 {
   namespace rendering
   {
+    /// \internal
+    /// \brief A region of the camera image, scaled down and read back on
+    /// its own.
+    class CameraImageOutput
+    {
+      /// \brief Left column of the region.
+      public: unsigned int left = 0;
+
+      /// \brief Top row of the region.
+      public: unsigned int top = 0;
+
+      /// \brief Column after the right of the region.
+      public: unsigned int right = 0;
+
+      /// \brief Row after the bottom of the region.
+      public: unsigned int bottom = 0;
+
+      /// \brief Width of the output.
+      public: unsigned int width = 0;
+
+      /// \brief Height of the output.
+      public: unsigned int height = 0;
+
+      /// \brief Texture the region is scaled into, null if it isn't
+      /// scaled.
+      public: Ogre::Texture *texture = nullptr;
+
+      /// \brief Pixels of the last readback.
+      public: std::vector<unsigned char> data;
+
+      /// \brief True if the output is read back.
+      public: bool enabled = false;
+    };
+
     /// \brief Private data for the Camera class
     class GZ_RENDERING_VISIBLE CameraPrivate
     {
@@ -47,16 +89,16 @@ namespace gazebo
       public: static unsigned int cameraCounter;
 
       /// \brief Deferred shading geometry buffer.
-      public: Ogre::CompositorInstance *dsGBufferInstance;
+      public: Ogre::CompositorInstance *dsGBufferInstance = nullptr;
 
       /// \brief Deferred shading merge compositor.
-      public: Ogre::CompositorInstance *dsMergeInstance;
+      public: Ogre::CompositorInstance *dsMergeInstance = nullptr;
 
       /// \brief Deferred lighting geometry buffer.
-      public: Ogre::CompositorInstance *dlGBufferInstance;
+      public: Ogre::CompositorInstance *dlGBufferInstance = nullptr;
 
       /// \brief Deferred lighting merge compositor.
-      public: Ogre::CompositorInstance *dlMergeInstance;
+      public: Ogre::CompositorInstance *dlMergeInstance = nullptr;
 
       /// \brief Screen space ambient occlusion compositor.
       public: Ogre::CompositorInstance *ssaoInstance;
@@ -117,6 +159,57 @@ namespace gazebo
 
       /// \brief Fixed axis to yaw around.
       public: ignition::math::Vector3d yawFixedAxis;
+
+      /// \brief True if the render target was updated and its buffers
+      /// still need to be swapped in PostRender.
+      public: bool swapPending = false;
+
+      /// \brief True if asynchronous readback was requested.
+      public: bool asyncReadback = false;
+
+      /// \brief Level of detail bias.
+      public: double lodBias = 1.0;
+
+      /// \brief True if occlusion culling was requested.
+      public: bool occlusionCulling = false;
+
+      /// \brief True if deferred shading is enabled.
+      public: bool deferredShading = false;
+
+      /// \brief Visibility mask of the viewport.
+      public: uint32_t visibilityMask =
+          GZ_VISIBILITY_ALL & ~(GZ_VISIBILITY_GUI | GZ_VISIBILITY_SELECTABLE);
+
+      /// \brief Asynchronous readback of the render texture.
+      public: TextureReadback readback;
+
+      /// \brief Scene sim time of the last render.
+      public: common::Time renderSimTime;
+
+      /// \brief Scene sim time of the render before the last one.
+      public: common::Time prevRenderSimTime;
+
+      /// \brief Scene sim time of the frame in the image data.
+      public: common::Time imageSimTime;
+
+      /// \brief Number of frames read back.
+      public: uint64_t imageCount = 0;
+
+      /// \brief Outputs of regions of the image.
+      public: std::vector<CameraImageOutput> imageOutputs;
+
+      /// \brief Writes the frames saved by the <save> element in
+      /// background threads, null to write them in the rendering thread.
+      public: std::unique_ptr<FrameWriter> frameWriter;
+
+      /// \brief Extension of the files written for the <save> element.
+      public: std::string saveExtension = "jpg";
+
+      /// \brief True once the options of the <save> element were read.
+      public: bool saveOptionsLoaded = false;
+
+      /// \brief True once a warning was printed for a dropped frame.
+      public: bool saveDropWarned = false;
     };
   }
 }
@@ -16,7 +16,9 @@
 */
 
 #include <gtest/gtest.h>
+#include "gazebo/rendering/ogre_gazebo.h"
 #include "gazebo/rendering/Camera.hh"
+#include "gazebo/rendering/RenderEngine.hh"
 #include "gazebo/rendering/RenderingIface.hh"
 #include "gazebo/rendering/RenderTypes.hh"
 #include "gazebo/rendering/Scene.hh"
@@ -184,6 +186,270 @@ TEST_F(Camera_TEST, Create)
   }
 }
 
+/////////////////////////////////////////////////
+TEST_F(Camera_TEST, AsyncReadback)
+{
+  Load("worlds/empty.world");
+
+  gazebo::rendering::ScenePtr scene = gazebo::rendering::get_scene("default");
+
+  if (!scene)
+    scene = gazebo::rendering::create_scene("default", false);
+  ASSERT_TRUE(scene != nullptr);
+
+  rendering::CameraPtr camera =
+      scene->CreateCamera("test_camera_async", false);
+  ASSERT_TRUE(camera != nullptr);
+
+  std::stringstream ss;
+  ss << "<sdf version='" << SDF_VERSION << "'>"
+     << "  <camera>"
+     << "    <horizontal_fov>0.78</horizontal_fov>"
+     << "    <image>"
+     << "      <width>160</width>"
+     << "      <height>120</height>"
+     << "      <format>R8G8B8</format>"
+     << "    </image>"
+     << "    <clip>"
+     << "      <near>0.1</near><far>100</far>"
+     << "    </clip>"
+     << "  </camera>"
+     << "</sdf>";
+  sdf::ElementPtr cameraSDF(new sdf::Element);
+  sdf::initFile("camera.sdf", cameraSDF);
+  sdf::readString(ss.str(), cameraSDF);
+  camera->Load(cameraSDF);
+  camera->Init();
+  camera->CreateRenderTexture("test_camera_async_RttTex");
+  camera->SetCaptureData(true);
+
+  EXPECT_FALSE(camera->AsyncReadback());
+  EXPECT_EQ(0u, camera->ReadbackLatency());
+
+  camera->Render(true);
+  camera->PostRender();
+  EXPECT_EQ(1u, camera->ImageCount());
+  EXPECT_TRUE(camera->ImageData() != nullptr);
+
+  camera->SetAsyncReadback(true);
+  EXPECT_TRUE(camera->AsyncReadback());
+  const unsigned int latency = camera->ReadbackLatency();
+  EXPECT_LE(latency, 1u);
+
+  // The first frame after enabling is not delivered
+  camera->Render(true);
+  camera->PostRender();
+  EXPECT_EQ(latency > 0 ? 1u : 2u, camera->ImageCount());
+
+  camera->Render(true);
+  camera->PostRender();
+  EXPECT_EQ(latency > 0 ? 2u : 3u, camera->ImageCount());
+  EXPECT_TRUE(camera->ImageData() != nullptr);
+
+  camera->SetAsyncReadback(false);
+  EXPECT_EQ(0u, camera->ReadbackLatency());
+
+  scene->RemoveCamera(camera->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_F(Camera_TEST, VisibilityMask)
+{
+  Load("worlds/empty.world");
+
+  gazebo::rendering::ScenePtr scene = gazebo::rendering::get_scene("default");
+
+  if (!scene)
+    scene = gazebo::rendering::create_scene("default", false);
+  ASSERT_TRUE(scene != nullptr);
+
+  rendering::CameraPtr camera =
+      scene->CreateCamera("test_camera_mask", false);
+  ASSERT_TRUE(camera != nullptr);
+
+  std::stringstream ss;
+  ss << "<sdf version='" << SDF_VERSION << "'>"
+     << "  <camera>"
+     << "    <horizontal_fov>0.78</horizontal_fov>"
+     << "    <image>"
+     << "      <width>160</width>"
+     << "      <height>120</height>"
+     << "      <format>R8G8B8</format>"
+     << "    </image>"
+     << "    <clip>"
+     << "      <near>0.1</near><far>100</far>"
+     << "    </clip>"
+     << "    <gz:occlusion_culling>true</gz:occlusion_culling>"
+     << "  </camera>"
+     << "</sdf>";
+  sdf::ElementPtr cameraSDF(new sdf::Element);
+  sdf::initFile("camera.sdf", cameraSDF);
+  sdf::readString(ss.str(), cameraSDF);
+
+  // GUI visuals are left out by default
+  const uint32_t defaultMask =
+      GZ_VISIBILITY_ALL & ~(GZ_VISIBILITY_GUI | GZ_VISIBILITY_SELECTABLE);
+  EXPECT_EQ(defaultMask, camera->VisibilityMask());
+  EXPECT_FALSE(camera->OcclusionCulling());
+
+  camera->Load(cameraSDF);
+  camera->Init();
+  camera->CreateRenderTexture("test_camera_mask_RttTex");
+  EXPECT_EQ(defaultMask, camera->VisibilityMask());
+  EXPECT_TRUE(camera->OcclusionCulling());
+
+  // The mask is applied to the viewport
+  camera->SetVisibilityMask(GZ_VISIBILITY_GUI);
+  EXPECT_EQ(static_cast<uint32_t>(GZ_VISIBILITY_GUI),
+      camera->VisibilityMask());
+  EXPECT_EQ(static_cast<uint32_t>(GZ_VISIBILITY_GUI),
+      camera->OgreViewport()->getVisibilityMask());
+
+  // Rendering with occlusion culling, then without
+  camera->Render(true);
+  camera->PostRender();
+  camera->SetOcclusionCulling(false);
+  EXPECT_FALSE(camera->OcclusionCulling());
+  camera->Render(true);
+  camera->PostRender();
+
+  scene->RemoveCamera(camera->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_F(Camera_TEST, ImageOutputs)
+{
+  Load("worlds/empty.world");
+
+  gazebo::rendering::ScenePtr scene = gazebo::rendering::get_scene("default");
+
+  if (!scene)
+    scene = gazebo::rendering::create_scene("default", false);
+  ASSERT_TRUE(scene != nullptr);
+
+  rendering::CameraPtr camera =
+      scene->CreateCamera("test_camera_outputs", false);
+  ASSERT_TRUE(camera != nullptr);
+
+  std::stringstream ss;
+  ss << "<sdf version='" << SDF_VERSION << "'>"
+     << "  <camera>"
+     << "    <horizontal_fov>0.78</horizontal_fov>"
+     << "    <image>"
+     << "      <width>160</width>"
+     << "      <height>120</height>"
+     << "      <format>R8G8B8</format>"
+     << "    </image>"
+     << "    <clip>"
+     << "      <near>0.1</near><far>100</far>"
+     << "    </clip>"
+     << "  </camera>"
+     << "</sdf>";
+  sdf::ElementPtr cameraSDF(new sdf::Element);
+  sdf::initFile("camera.sdf", cameraSDF);
+  sdf::readString(ss.str(), cameraSDF);
+  camera->Load(cameraSDF);
+  camera->Init();
+
+  // Outputs need the render texture
+  EXPECT_EQ(-1, camera->AddImageOutput(0, 0, 0, 0));
+  camera->CreateRenderTexture("test_camera_outputs_RttTex");
+
+  // Regions outside the image and bad scales are refused
+  EXPECT_EQ(-1, camera->AddImageOutput(150, 0, 20, 10));
+  EXPECT_EQ(-1, camera->AddImageOutput(0, 120, 0, 0));
+  EXPECT_EQ(-1, camera->AddImageOutput(0, 0, 0, 0, 0.0));
+  EXPECT_EQ(-1, camera->AddImageOutput(0, 0, 0, 0, 2.0));
+  EXPECT_EQ(0u, camera->ImageOutputCount());
+
+  // A crop and a thumbnail
+  EXPECT_EQ(0, camera->AddImageOutput(40, 30, 64, 48));
+  EXPECT_EQ(1, camera->AddImageOutput(0, 0, 0, 0, 0.25));
+  EXPECT_EQ(2u, camera->ImageOutputCount());
+  EXPECT_EQ(64u, camera->ImageOutputWidth(0));
+  EXPECT_EQ(48u, camera->ImageOutputHeight(0));
+  EXPECT_EQ(40u, camera->ImageOutputWidth(1));
+  EXPECT_EQ(30u, camera->ImageOutputHeight(1));
+  EXPECT_EQ(0u, camera->ImageOutputWidth(2));
+
+  // Only enabled outputs are read back, without the full image
+  camera->SetImageOutputEnabled(1, true);
+  camera->SetCaptureData(false);
+  camera->Render(true);
+  camera->PostRender();
+  EXPECT_TRUE(camera->ImageOutputData(0) == nullptr);
+  EXPECT_TRUE(camera->ImageOutputData(1) != nullptr);
+  EXPECT_TRUE(camera->ImageOutputData(2) == nullptr);
+  EXPECT_TRUE(camera->ImageData() == nullptr);
+
+  camera->SetImageOutputEnabled(0, true);
+  camera->Render(true);
+  camera->PostRender();
+  EXPECT_TRUE(camera->ImageOutputData(0) != nullptr);
+
+  scene->RemoveCamera(camera->Name());
+}
+
+/////////////////////////////////////////////////
+TEST_F(Camera_TEST, DeferredShading)
+{
+  Load("worlds/empty.world");
+
+  gazebo::rendering::ScenePtr scene = gazebo::rendering::get_scene("default");
+
+  if (!scene)
+    scene = gazebo::rendering::create_scene("default", false);
+  ASSERT_TRUE(scene != nullptr);
+
+  rendering::CameraPtr camera =
+      scene->CreateCamera("test_camera_deferred", false);
+  ASSERT_TRUE(camera != nullptr);
+
+  std::stringstream ss;
+  ss << "<sdf version='" << SDF_VERSION << "'>"
+     << "  <camera>"
+     << "    <horizontal_fov>0.78</horizontal_fov>"
+     << "    <image>"
+     << "      <width>160</width>"
+     << "      <height>120</height>"
+     << "      <format>R8G8B8</format>"
+     << "    </image>"
+     << "    <clip>"
+     << "      <near>0.1</near><far>100</far>"
+     << "    </clip>"
+     << "    <gz:deferred_shading>true</gz:deferred_shading>"
+     << "  </camera>"
+     << "</sdf>";
+  sdf::ElementPtr cameraSDF(new sdf::Element);
+  sdf::initFile("camera.sdf", cameraSDF);
+  sdf::readString(ss.str(), cameraSDF);
+  camera->Load(cameraSDF);
+  camera->Init();
+  camera->CreateRenderTexture("test_camera_deferred_RttTex");
+
+  if (!rendering::RenderEngine::Instance()->InitDeferredShading())
+  {
+    EXPECT_FALSE(camera->DeferredShading());
+    EXPECT_FALSE(camera->SetDeferredShading(true));
+    scene->RemoveCamera(camera->Name());
+    return;
+  }
+
+  // The element enabled it, and the lit image is rendered
+  EXPECT_TRUE(camera->DeferredShading());
+  camera->Render(true);
+  camera->PostRender();
+  EXPECT_TRUE(camera->ImageData() != nullptr);
+
+  EXPECT_TRUE(camera->SetDeferredShading(false));
+  EXPECT_FALSE(camera->DeferredShading());
+  camera->Render(true);
+  camera->PostRender();
+  EXPECT_TRUE(camera->ImageData() != nullptr);
+
+  scene->RemoveCamera(camera->Name());
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -68,6 +68,13 @@ void DepthCamera::Load(sdf::ElementPtr _sdf)
   this->dataPtr->outputPoints =  found != std::string::npos;
   found = outputs.find("normals");
   this->dataPtr->outputNormals =  found != std::string::npos;
+
+  sdf::ElementPtr depthElem = _sdf->GetElement("depth_camera");
+  if (depthElem->HasElement("gz:points_from_depth"))
+  {
+    this->dataPtr->pointsFromDepth =
+        depthElem->Get<bool>("gz:points_from_depth");
+  }
 }
 
 //////////////////////////////////////////////////
@@ -154,13 +161,31 @@ void DepthCamera::CreateDepthTexture(const std::string &_textureName)
     this->dataPtr->pcdViewport->setVisibilityMask(
         GZ_VISIBILITY_ALL & ~(GZ_VISIBILITY_GUI | GZ_VISIBILITY_SELECTABLE));
 
-    this->dataPtr->pcdMaterial = (Ogre::Material*)(
-    Ogre::MaterialManager::getSingleton().getByName("Gazebo/XYZPoints").get());
+    if (this->dataPtr->pointsFromDepth)
+    {
+      // The compositor only draws a full screen quad, the scene is not
+      // rendered in this viewport.
+      this->dataPtr->pcdMaterial = (Ogre::Material*)(
+          Ogre::MaterialManager::getSingleton().getByName(
+          "Gazebo/XYZPointsFromDepth").get());
+      this->dataPtr->pcdMaterial->load();
+
+      Ogre::CompositorManager::getSingleton().addCompositor(
+          this->dataPtr->pcdViewport, "Gazebo/XYZPointsFromDepth");
+      Ogre::CompositorManager::getSingleton().setCompositorEnabled(
+          this->dataPtr->pcdViewport, "Gazebo/XYZPointsFromDepth", true);
+    }
+    else
+    {
+      this->dataPtr->pcdMaterial = (Ogre::Material*)(
+      Ogre::MaterialManager::getSingleton().getByName(
+          "Gazebo/XYZPoints").get());
 
-    this->dataPtr->pcdMaterial->getTechnique(0)->getPass(0)->
-        createTextureUnitState(this->renderTexture->getName());
+      this->dataPtr->pcdMaterial->getTechnique(0)->getPass(0)->
+          createTextureUnitState(this->renderTexture->getName());
 
-    this->dataPtr->pcdMaterial->load();
+      this->dataPtr->pcdMaterial->load();
+    }
   }
 
 /*
@@ -182,6 +207,25 @@ void DepthCamera::CreateDepthTexture(const std::string &_textureName)
 */
 }
 
+//////////////////////////////////////////////////
+void DepthCamera::SetPointsFromDepth(const bool _value)
+{
+  if (this->dataPtr->pcdTexture)
+  {
+    gzwarn << "The point cloud output of [" << this->Name()
+           << "] is already created" << std::endl;
+    return;
+  }
+
+  this->dataPtr->pointsFromDepth = _value;
+}
+
+//////////////////////////////////////////////////
+bool DepthCamera::PointsFromDepth() const
+{
+  return this->dataPtr->pointsFromDepth;
+}
+
 //////////////////////////////////////////////////
 void DepthCamera::CreateNormalsTexture(const std::string &_textureName)
 {
@@ -246,18 +290,43 @@ void DepthCamera::PostRender()
           Ogre::PF_FLOAT32_R);
 
       // Blit the depth buffer if needed
+      bool allocated = false;
       if (!this->dataPtr->depthBuffer)
+      {
         this->dataPtr->depthBuffer = new float[size];
-
-      Ogre::PixelBox dstBox(width, height,
-          1, Ogre::PF_FLOAT32_R, this->dataPtr->depthBuffer);
-
-      pixelBuffer->lock(Ogre::HardwarePixelBuffer::HBL_NORMAL);
-      pixelBuffer->blitToMemory(dstBox);
-      pixelBuffer->unlock();  // FIXME: do we need to lock/unlock still?
-
-      this->dataPtr->newDepthFrame(
-          this->dataPtr->depthBuffer, width, height, 1, "FLOAT32");
+        allocated = true;
+      }
+
+      bool ready = true;
+      if (this->ReadbackLatency() > 0)
+      {
+        // Read the frame started by the previous call, and start this one
+        ready = this->dataPtr->depthReadback.Read(this->depthTexture,
+            Ogre::PF_FLOAT32_R, width, height, this->dataPtr->depthBuffer);
+        if (!ready && allocated)
+        {
+          delete [] this->dataPtr->depthBuffer;
+          this->dataPtr->depthBuffer = nullptr;
+        }
+      }
+      else
+      {
+        this->dataPtr->depthReadback.Reset();
+
+        Ogre::PixelBox dstBox(width, height,
+            1, Ogre::PF_FLOAT32_R, this->dataPtr->depthBuffer);
+
+        pixelBuffer->lock(Ogre::HardwarePixelBuffer::HBL_NORMAL);
+        pixelBuffer->blitToMemory(dstBox);
+        pixelBuffer->unlock();  // FIXME: do we need to lock/unlock still?
+      }
+
+      if (ready)
+      {
+        this->MarkImageDelivered(this->ReadbackLatency() > 0);
+        this->dataPtr->newDepthFrame(
+            this->dataPtr->depthBuffer, width, height, 1, "FLOAT32");
+      }
     }
     else
     {
@@ -411,6 +480,10 @@ void DepthCamera::RenderImpl()
   sceneMgr->setShadowTechnique(Ogre::SHADOWTYPE_NONE);
   sceneMgr->_suppressRenderStateChanges(true);
 
+  // The material is shared by all depth cameras
+  this->dataPtr->depthNoise.Apply(
+      this->dataPtr->depthMaterial->getBestTechnique()->getPass(0),
+      this->FarClip());
   this->UpdateRenderTarget(this->depthTarget,
                   this->dataPtr->depthMaterial, "Gazebo/DepthMap");
 
@@ -423,7 +496,24 @@ void DepthCamera::RenderImpl()
   // for camera image
   Camera::RenderImpl();
 
-  if (this->dataPtr->outputPoints)
+  if (this->dataPtr->outputPoints && this->dataPtr->pointsFromDepth)
+  {
+    // The material is shared by all depth cameras, which render one after
+    // the other, so point it to this camera's textures before the update.
+    Ogre::Pass *pass =
+        this->dataPtr->pcdMaterial->getTechnique(0)->getPass(0);
+    pass->getTextureUnitState(0)->setTextureName(
+        this->depthTexture->getName());
+    pass->getTextureUnitState(1)->setTextureName(
+        this->renderTexture->getName());
+
+    const Ogre::Matrix4 &proj = this->OgreCamera()->getProjectionMatrix();
+    pass->getFragmentProgramParameters()->setNamedConstant("projParams",
+        Ogre::Vector4(proj[0][0], proj[1][1], proj[0][2], proj[1][2]));
+
+    this->dataPtr->pcdTarget->update(false);
+  }
+  else if (this->dataPtr->outputPoints)
   {
     sceneMgr->setShadowTechnique(Ogre::SHADOWTYPE_NONE);
     sceneMgr->_suppressRenderStateChanges(true);
@@ -506,3 +596,15 @@ event::ConnectionPtr DepthCamera::ConnectNewNormalsPointCloud(
 {
   return this->dataPtr->newNormalsPointCloud.Connect(_subscriber);
 }
+
+//////////////////////////////////////////////////
+void DepthCamera::SetDepthNoise(const DepthNoise &_noise)
+{
+  this->dataPtr->depthNoise = _noise;
+}
+
+//////////////////////////////////////////////////
+const DepthNoise &DepthCamera::DepthNoiseModel() const
+{
+  return this->dataPtr->depthNoise;
+}
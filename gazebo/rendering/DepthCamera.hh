@@ -26,6 +26,7 @@
 #include "gazebo/common/CommonTypes.hh"
 
 #include "gazebo/rendering/Camera.hh"
+#include "gazebo/rendering/DepthNoise.hh"
 #include "gazebo/util/system.hh"
 
 namespace Ogre
@@ -77,6 +78,22 @@ namespace gazebo
       /// \param[in] _textureName Name of the texture to create
       public: void CreateDepthTexture(const std::string &_textureName);
 
+      /// \brief Set whether the point cloud is reprojected from the depth
+      /// texture by a single full screen pass, instead of rendering the
+      /// scene a second time. The points then hold the color of the camera
+      /// image, packed as r * 65536 + g * 256 + b in their 4th channel.
+      /// Only used when the "points" output is enabled, and must be called
+      /// before CreateDepthTexture. It can also be set with the
+      /// <gz:points_from_depth> element of <depth_camera>.
+      /// \param[in] _value True to reproject the depth texture.
+      public: void SetPointsFromDepth(const bool _value);
+
+      /// \brief Get whether the point cloud is reprojected from the depth
+      /// texture.
+      /// \return True if the point cloud is reprojected.
+      /// \sa SetPointsFromDepth
+      public: bool PointsFromDepth() const;
+
       /// \brief Create a texture which will hold the normal data
       /// \param[in] _textureName Name of the texture to create
       public: void CreateNormalsTexture(const std::string &_textureName);
@@ -92,6 +109,14 @@ namespace gazebo
       /// \param[in] _target Pointer to the render target
       public: virtual void SetDepthTarget(Ogre::RenderTarget *_target);
 
+      /// \brief Set the noise the depth shader adds to the depth data.
+      /// \param[in] _noise The noise, disabled by default.
+      public: void SetDepthNoise(const DepthNoise &_noise);
+
+      /// \brief Get the noise added to the depth data.
+      /// \return The noise set with SetDepthNoise.
+      public: const DepthNoise &DepthNoiseModel() const;
+
       /// \brief Connect a to the new depth image signal
       /// \param[in] _subscriber Subscriber callback function
       /// \return Pointer to the new Connection. This must be kept in scope
@@ -23,6 +23,8 @@
 #include "gazebo/common/Event.hh"
 
 #include "gazebo/rendering/Camera.hh"
+#include "gazebo/rendering/DepthNoise.hh"
+#include "gazebo/rendering/TextureReadback.hh"
 
 namespace Ogre
 {
@@ -43,9 +45,15 @@ namespace gazebo
       /// \brief The depth buffer
       public: float *depthBuffer = nullptr;
 
+      /// \brief Asynchronous readback of the depth texture.
+      public: TextureReadback depthReadback;
+
       /// \brief The depth material
       public: Ogre::Material *depthMaterial = nullptr;
 
+      /// \brief Noise added to the depth data by the depth shader.
+      public: DepthNoise depthNoise;
+
       /// \brief True to generate point clouds
       public: bool outputPoints;
 
@@ -70,6 +78,9 @@ namespace gazebo
       /// \brief Point cloud material
       public: Ogre::Material *normalsMaterial = nullptr;
 
+      /// \brief True to reproject the point cloud from the depth texture
+      public: bool pointsFromDepth = false;
+
       /// \brief Point cloud texture
       public: Ogre::Texture *pcdTexture = nullptr;
 
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <string>
+
+#include <ignition/math/Helpers.hh>
+#include <ignition/math/Rand.hh>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/rendering/ogre_gazebo.h"
+#include "gazebo/rendering/DepthNoise.hh"
+
+namespace gazebo
+{
+  namespace rendering
+  {
+    /// \internal
+    /// \brief Private data for the DepthNoise class
+    class DepthNoisePrivate
+    {
+      /// \brief Mean of the Gaussian noise.
+      public: double mean = 0.0;
+
+      /// \brief Standard deviation of the Gaussian noise.
+      public: double stdDev = 0.0;
+
+      /// \brief Quantization step, zero to disable.
+      public: double precision = 0.0;
+
+      /// \brief Probability of dropping a sample.
+      public: double dropout = 0.0;
+    };
+  }
+}
+
+using namespace gazebo;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+DepthNoise::DepthNoise()
+  : dataPtr(new DepthNoisePrivate)
+{
+}
+
+//////////////////////////////////////////////////
+DepthNoise::DepthNoise(const DepthNoise &_noise)
+  : dataPtr(new DepthNoisePrivate(*_noise.dataPtr))
+{
+}
+
+//////////////////////////////////////////////////
+DepthNoise::~DepthNoise()
+{
+}
+
+//////////////////////////////////////////////////
+DepthNoise &DepthNoise::operator=(const DepthNoise &_noise)
+{
+  *this->dataPtr = *_noise.dataPtr;
+  return *this;
+}
+
+//////////////////////////////////////////////////
+void DepthNoise::Load(sdf::ElementPtr _sdf)
+{
+  *this->dataPtr = DepthNoisePrivate();
+  if (!_sdf)
+    return;
+
+  const std::string type = _sdf->HasElement("type") ?
+      _sdf->Get<std::string>("type") : "gaussian";
+  if (type != "gaussian" && type != "gaussian_quantized" && type != "none")
+  {
+    gzerr << "Unsupported depth noise type [" << type << "], only gaussian "
+      << "and gaussian_quantized noises are added by the shaders.\n";
+  }
+  else if (type != "none")
+  {
+    this->SetGaussian(
+        _sdf->HasElement("mean") ? _sdf->Get<double>("mean") : 0.0,
+        _sdf->HasElement("stddev") ? _sdf->Get<double>("stddev") : 0.0);
+    if (type == "gaussian_quantized" && _sdf->HasElement("precision"))
+      this->SetPrecision(_sdf->Get<double>("precision"));
+  }
+
+  if (_sdf->HasElement("gz:dropout"))
+    this->SetDropout(_sdf->Get<double>("gz:dropout"));
+}
+
+//////////////////////////////////////////////////
+void DepthNoise::SetGaussian(const double _mean, const double _stdDev)
+{
+  this->dataPtr->mean = _mean;
+  this->dataPtr->stdDev = std::max(_stdDev, 0.0);
+}
+
+//////////////////////////////////////////////////
+void DepthNoise::SetPrecision(const double _precision)
+{
+  this->dataPtr->precision = std::max(_precision, 0.0);
+}
+
+//////////////////////////////////////////////////
+void DepthNoise::SetDropout(const double _dropout)
+{
+  this->dataPtr->dropout = ignition::math::clamp(_dropout, 0.0, 1.0);
+}
+
+//////////////////////////////////////////////////
+double DepthNoise::Mean() const
+{
+  return this->dataPtr->mean;
+}
+
+//////////////////////////////////////////////////
+double DepthNoise::StdDev() const
+{
+  return this->dataPtr->stdDev;
+}
+
+//////////////////////////////////////////////////
+double DepthNoise::Precision() const
+{
+  return this->dataPtr->precision;
+}
+
+//////////////////////////////////////////////////
+double DepthNoise::Dropout() const
+{
+  return this->dataPtr->dropout;
+}
+
+//////////////////////////////////////////////////
+bool DepthNoise::Enabled() const
+{
+  return !ignition::math::equal(this->dataPtr->mean, 0.0) ||
+      this->dataPtr->stdDev > 0.0 || this->dataPtr->precision > 0.0 ||
+      this->dataPtr->dropout > 0.0;
+}
+
+//////////////////////////////////////////////////
+void DepthNoise::Apply(Ogre::Pass *_pass, const double _farClip) const
+{
+  if (!_pass || !_pass->hasFragmentProgram())
+    return;
+
+  Ogre::GpuProgramParametersSharedPtr params =
+      _pass->getFragmentProgramParameters();
+  if (params.isNull() || !params->_findNamedConstantDefinition("noiseMean"))
+    return;
+
+  // These parameters are declared in media/materials/scripts/gazebo.material
+  // and used by the depth_noise function of the depth shaders.
+  params->setNamedConstant("noiseOffsets", Ogre::Vector3(
+        ignition::math::Rand::DblUniform(0.0, 1.0),
+        ignition::math::Rand::DblUniform(0.0, 1.0),
+        ignition::math::Rand::DblUniform(0.0, 1.0)));
+  params->setNamedConstant("noiseMean",
+      static_cast<Ogre::Real>(this->dataPtr->mean));
+  params->setNamedConstant("noiseStdDev",
+      static_cast<Ogre::Real>(this->dataPtr->stdDev));
+  params->setNamedConstant("noisePrecision",
+      static_cast<Ogre::Real>(this->dataPtr->precision));
+  params->setNamedConstant("noiseDropout",
+      static_cast<Ogre::Real>(this->dataPtr->dropout));
+  params->setNamedConstant("noiseFar", static_cast<Ogre::Real>(_farClip));
+}
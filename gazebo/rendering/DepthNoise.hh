@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_RENDERING_DEPTHNOISE_HH_
+#define GAZEBO_RENDERING_DEPTHNOISE_HH_
+
+#include <memory>
+#include <sdf/Element.hh>
+
+#include "gazebo/util/system.hh"
+
+namespace Ogre
+{
+  class Pass;
+}
+
+namespace gazebo
+{
+  namespace rendering
+  {
+    class DepthNoisePrivate;
+
+    /// \addtogroup gazebo_rendering Rendering
+    /// \{
+
+    /// \class DepthNoise DepthNoise.hh rendering/rendering.hh
+    /// \brief Noise added by the shaders of the depth camera and the GPU
+    /// laser to the distances they render, so that it costs nothing on the
+    /// CPU and is already in the data that is read back. Each sample is
+    /// dropped with some probability, otherwise it gets Gaussian noise and
+    /// is then quantized. Dropped samples read as the far clip distance,
+    /// like the samples that hit nothing, which keep their value.
+    class GZ_RENDERING_VISIBLE DepthNoise
+    {
+      /// \brief Constructor, the noise is disabled.
+      public: DepthNoise();
+
+      /// \brief Copy constructor.
+      /// \param[in] _noise Noise to copy.
+      public: DepthNoise(const DepthNoise &_noise);
+
+      /// \brief Destructor.
+      public: ~DepthNoise();
+
+      /// \brief Assignment operator.
+      /// \param[in] _noise Noise to copy.
+      /// \return Reference to this noise.
+      public: DepthNoise &operator=(const DepthNoise &_noise);
+
+      /// \brief Load the noise from a <noise> element. The mean and stddev
+      /// of Gaussian noise are read, the precision of gaussian_quantized
+      /// noise, and the probability of dropping a sample from <gz:dropout>.
+      /// \param[in] _sdf The noise element.
+      public: void Load(sdf::ElementPtr _sdf);
+
+      /// \brief Set the Gaussian noise.
+      /// \param[in] _mean Mean of the noise.
+      /// \param[in] _stdDev Standard deviation of the noise.
+      public: void SetGaussian(const double _mean, const double _stdDev);
+
+      /// \brief Set the quantization.
+      /// \param[in] _precision Step the distances are rounded to, zero to
+      /// leave them unquantized.
+      public: void SetPrecision(const double _precision);
+
+      /// \brief Set the probability of dropping a sample.
+      /// \param[in] _dropout Probability, in [0, 1].
+      public: void SetDropout(const double _dropout);
+
+      /// \brief Get the mean of the Gaussian noise.
+      /// \return The mean.
+      public: double Mean() const;
+
+      /// \brief Get the standard deviation of the Gaussian noise.
+      /// \return The standard deviation.
+      public: double StdDev() const;
+
+      /// \brief Get the quantization step.
+      /// \return The precision, zero if the distances aren't quantized.
+      public: double Precision() const;
+
+      /// \brief Get the probability of dropping a sample.
+      /// \return The dropout probability.
+      public: double Dropout() const;
+
+      /// \brief Get whether the noise changes the distances.
+      /// \return True if any of the noises is set.
+      public: bool Enabled() const;
+
+      /// \brief Set the noise parameters of a shader pass, with new random
+      /// offsets. The materials are shared, so this is called before each
+      /// render, and a disabled noise clears the parameters.
+      /// \param[in] _pass Pass whose fragment program adds the noise.
+      /// \param[in] _farClip Value of the samples that hit nothing, which
+      /// the dropped samples get.
+      public: void Apply(Ogre::Pass *_pass, const double _farClip) const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<DepthNoisePrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
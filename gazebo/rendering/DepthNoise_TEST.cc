@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <sdf/sdf.hh>
+
+#include "gazebo/rendering/DepthNoise.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class DepthNoiseTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief Build a <noise> element with the given children.
+sdf::ElementPtr NoiseSdf(const std::string &_children)
+{
+  std::ostringstream stream;
+  stream << "<sdf version='" << SDF_VERSION << "'>"
+    << "<model name='m'><link name='l'><sensor name='s' type='gpu_ray'>"
+    << "<ray><scan><horizontal><samples>1</samples></horizontal></scan>"
+    << "<range><min>0.1</min><max>10</max></range>"
+    << "<noise>" << _children << "</noise>"
+    << "</ray></sensor></link></model></sdf>";
+
+  sdf::ElementPtr sdf(new sdf::Element);
+  sdf::initFile("root.sdf", sdf);
+  if (!sdf::readString(stream.str(), sdf))
+    return sdf::ElementPtr();
+
+  return sdf->GetElement("model")->GetElement("link")->GetElement("sensor")
+    ->GetElement("ray")->GetElement("noise");
+}
+
+/////////////////////////////////////////////////
+TEST_F(DepthNoiseTest, Defaults)
+{
+  rendering::DepthNoise noise;
+  EXPECT_FALSE(noise.Enabled());
+  EXPECT_DOUBLE_EQ(noise.Mean(), 0.0);
+  EXPECT_DOUBLE_EQ(noise.StdDev(), 0.0);
+  EXPECT_DOUBLE_EQ(noise.Precision(), 0.0);
+  EXPECT_DOUBLE_EQ(noise.Dropout(), 0.0);
+
+  // Out of range values are clamped
+  noise.SetGaussian(0.0, -1.0);
+  noise.SetPrecision(-0.1);
+  noise.SetDropout(2.0);
+  EXPECT_DOUBLE_EQ(noise.StdDev(), 0.0);
+  EXPECT_DOUBLE_EQ(noise.Precision(), 0.0);
+  EXPECT_DOUBLE_EQ(noise.Dropout(), 1.0);
+  EXPECT_TRUE(noise.Enabled());
+  noise.SetDropout(-1.0);
+  EXPECT_DOUBLE_EQ(noise.Dropout(), 0.0);
+  EXPECT_FALSE(noise.Enabled());
+
+  noise.SetGaussian(0.1, 0.0);
+  EXPECT_TRUE(noise.Enabled());
+
+  // Apply ignores passes without the noise parameters
+  noise.Apply(nullptr, 10.0);
+}
+
+/////////////////////////////////////////////////
+TEST_F(DepthNoiseTest, Load)
+{
+  sdf::ElementPtr noiseSdf = NoiseSdf(
+      "<type>gaussian_quantized</type><mean>0.01</mean>"
+      "<stddev>0.02</stddev><precision>0.05</precision>"
+      "<gz:dropout>0.1</gz:dropout>");
+  ASSERT_TRUE(noiseSdf != nullptr);
+
+  rendering::DepthNoise noise;
+  noise.Load(noiseSdf);
+  EXPECT_TRUE(noise.Enabled());
+  EXPECT_DOUBLE_EQ(noise.Mean(), 0.01);
+  EXPECT_DOUBLE_EQ(noise.StdDev(), 0.02);
+  EXPECT_DOUBLE_EQ(noise.Precision(), 0.05);
+  EXPECT_DOUBLE_EQ(noise.Dropout(), 0.1);
+
+  // Copies don't share their parameters
+  rendering::DepthNoise copy(noise);
+  noise.SetDropout(0.0);
+  EXPECT_DOUBLE_EQ(copy.Dropout(), 0.1);
+  copy = noise;
+  EXPECT_DOUBLE_EQ(copy.Dropout(), 0.0);
+
+  // The precision of plain Gaussian noise is ignored
+  noiseSdf = NoiseSdf("<type>gaussian</type><mean>0</mean>"
+      "<stddev>0.02</stddev><precision>0.05</precision>");
+  ASSERT_TRUE(noiseSdf != nullptr);
+  noise.Load(noiseSdf);
+  EXPECT_DOUBLE_EQ(noise.StdDev(), 0.02);
+  EXPECT_DOUBLE_EQ(noise.Precision(), 0.0);
+
+  // Loading resets the previous noise
+  noiseSdf = NoiseSdf("<type>none</type>");
+  ASSERT_TRUE(noiseSdf != nullptr);
+  noise.Load(noiseSdf);
+  EXPECT_FALSE(noise.Enabled());
+  noise.Load(sdf::ElementPtr());
+  EXPECT_FALSE(noise.Enabled());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
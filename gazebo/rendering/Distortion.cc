@@ -14,10 +14,21 @@
  * limitations under the License.
  *
 */
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
 #include <sdf/sdf.hh>
 
 #include <ignition/math/Helpers.hh>
 
+#include "gazebo/common/CommonIface.hh"
+#include "gazebo/common/SystemPaths.hh"
 #include "gazebo/rendering/ogre_gazebo.h"
 #include "gazebo/rendering/Camera.hh"
 #include "gazebo/rendering/Distortion.hh"
@@ -66,8 +77,9 @@ namespace gazebo
       /// \brief Connection for the pre render event.
       public: event::ConnectionPtr preRenderConnection;
 
-      /// \brief Mapping of distorted to undistorted normalized pixels
-      public: std::vector<ignition::math::Vector2d> distortionMap;
+      /// \brief Mapping of distorted to undistorted normalized pixels, two
+      /// values per texel. It's shared with the cameras with the same lens.
+      public: std::shared_ptr<const std::vector<float>> distortionMap;
 
       /// \brief Width of distortion texture map
       public: unsigned int distortionTexWidth;
@@ -91,6 +103,148 @@ namespace gazebo
     };
   }
 }
+
+/// \brief Magic bytes at the start of a distortion map cache file.
+static const char kDistortionCacheMagic[4] = {'G', 'Z', 'D', 'M'};
+
+/// \brief Version of the distortion map cache files. Bump it when the
+/// computation of the maps changes.
+static const uint32_t kDistortionCacheVersion = 1;
+
+/// \brief Maps in use in this process, by key.
+static std::map<std::string, std::weak_ptr<const std::vector<float>>>
+    gDistortionMaps;
+
+/// \brief Mutex protecting gDistortionMaps.
+static std::mutex gDistortionMapsMutex;
+
+//////////////////////////////////////////////////
+/// \brief Append a value to the inputs of a distortion map.
+/// \param[in,out] _key The inputs.
+/// \param[in] _value Value to append.
+template<typename T>
+static void PutKey(std::string &_key, const T &_value)
+{
+  _key.append(reinterpret_cast<const char *>(&_value), sizeof(_value));
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the key of a distortion map, a hash of its inputs.
+/// \param[in] _side Width and height of the map.
+/// \param[in] _center Normalized distortion center.
+/// \param[in] _k1 Radial distortion coefficient k1.
+/// \param[in] _k2 Radial distortion coefficient k2.
+/// \param[in] _k3 Radial distortion coefficient k3.
+/// \param[in] _p1 Tangential distortion coefficient p1.
+/// \param[in] _p2 Tangential distortion coefficient p2.
+/// \return The key.
+static std::string MapKey(const unsigned int _side,
+    const ignition::math::Vector2d &_center, const double _k1,
+    const double _k2, const double _k3, const double _p1, const double _p2)
+{
+  std::string key = "distortion_map\n";
+  PutKey(key, kDistortionCacheVersion);
+  PutKey(key, _side);
+  PutKey(key, _center.X());
+  PutKey(key, _center.Y());
+  PutKey(key, _k1);
+  PutKey(key, _k2);
+  PutKey(key, _k3);
+  PutKey(key, _p1);
+  PutKey(key, _p2);
+  return common::get_sha1<std::string>(key);
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the cache file of a distortion map.
+/// \param[in] _key Key of the map.
+/// \return Path of the file, which may not exist. Empty if the cache is
+/// disabled with GAZEBO_DISTORTION_CACHE=0, or its directory can't be
+/// created.
+static std::string MapFilename(const std::string &_key)
+{
+  const char *cacheEnv = common::getEnv("GAZEBO_DISTORTION_CACHE");
+  if (cacheEnv && std::string(cacheEnv) == "0")
+    return "";
+
+  const boost::filesystem::path dir = boost::filesystem::path(
+      common::SystemPaths::Instance()->GetLogPath()) / "distortion_cache";
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(dir, ec);
+  if (ec)
+  {
+    gzwarn << "Unable to create the distortion cache directory ["
+           << dir.string() << "]: " << ec.message() << std::endl;
+    return "";
+  }
+  return (dir / (_key + ".distortion")).string();
+}
+
+//////////////////////////////////////////////////
+/// \brief Read a distortion map from a cache file.
+/// \param[in] _filename Path of the file.
+/// \param[in] _side Expected width and height of the map.
+/// \param[out] _map The map, two values per texel.
+/// \return False if the file doesn't exist or doesn't hold a map of this
+/// size.
+static bool LoadMap(const std::string &_filename, const unsigned int _side,
+    std::vector<float> &_map)
+{
+  std::ifstream file(_filename, std::ios::binary);
+  if (!file)
+    return false;
+
+  char magic[sizeof(kDistortionCacheMagic)];
+  uint32_t version = 0;
+  uint32_t side = 0;
+  file.read(magic, sizeof(magic));
+  file.read(reinterpret_cast<char *>(&version), sizeof(version));
+  file.read(reinterpret_cast<char *>(&side), sizeof(side));
+  if (!file || std::memcmp(magic, kDistortionCacheMagic, sizeof(magic)) != 0 ||
+      version != kDistortionCacheVersion || side != _side)
+  {
+    return false;
+  }
+
+  _map.resize(2 * static_cast<std::size_t>(_side) * _side);
+  file.read(reinterpret_cast<char *>(_map.data()),
+      _map.size() * sizeof(float));
+  return static_cast<bool>(file);
+}
+
+//////////////////////////////////////////////////
+/// \brief Write a distortion map to a cache file. It's written to a
+/// temporary file first, so other processes never read a partial map.
+/// \param[in] _filename Path of the file.
+/// \param[in] _side Width and height of the map.
+/// \param[in] _map The map.
+static void SaveMap(const std::string &_filename, const unsigned int _side,
+    const std::vector<float> &_map)
+{
+  const std::string tmpFilename = _filename + "." +
+      boost::filesystem::unique_path().string();
+  {
+    std::ofstream file(tmpFilename, std::ios::binary);
+    const uint32_t side = _side;
+    file.write(kDistortionCacheMagic, sizeof(kDistortionCacheMagic));
+    file.write(reinterpret_cast<const char *>(&kDistortionCacheVersion),
+        sizeof(kDistortionCacheVersion));
+    file.write(reinterpret_cast<const char *>(&side), sizeof(side));
+    file.write(reinterpret_cast<const char *>(_map.data()),
+        _map.size() * sizeof(float));
+    if (!file)
+    {
+      gzwarn << "Unable to write the distortion cache file [" << tmpFilename
+             << "]" << std::endl;
+    }
+  }
+
+  boost::system::error_code ec;
+  boost::filesystem::rename(tmpFilename, _filename, ec);
+  if (ec)
+    boost::filesystem::remove(tmpFilename, ec);
+}
+
 //////////////////////////////////////////////////
 Distortion::Distortion()
   : dataPtr(new DistortionPrivate)
@@ -119,14 +273,146 @@ void Distortion::Load(sdf::ElementPtr _sdf)
 ignition::math::Vector2d
     Distortion::DistortionMapValueClamped(const int x, const int y) const
 {
-  if (x < 0 || x >= static_cast<int>(this->dataPtr->distortionTexWidth) ||
+  if (!this->dataPtr->distortionMap ||
+      x < 0 || x >= static_cast<int>(this->dataPtr->distortionTexWidth) ||
       y < 0 || y >= static_cast<int>(this->dataPtr->distortionTexHeight))
   {
     return ignition::math::Vector2d(-1, -1);
   }
-  ignition::math::Vector2d res =
-      this->dataPtr->distortionMap[y*this->dataPtr->distortionTexWidth+x];
-  return res;
+  const std::size_t idx = 2 * (y * this->dataPtr->distortionTexWidth + x);
+  return ignition::math::Vector2d((*this->dataPtr->distortionMap)[idx],
+      (*this->dataPtr->distortionMap)[idx + 1]);
+}
+
+//////////////////////////////////////////////////
+ignition::math::Vector2d Distortion::Undistort(
+    const ignition::math::Vector2d &_uv) const
+{
+  if (!this->dataPtr->distortionMap)
+    return _uv;
+
+  // Same lookup as camera_distortion_map_fs.glsl
+  const ignition::math::Vector2d center(0.5, 0.5);
+  const ignition::math::Vector2d inputUV =
+      (_uv - center) / this->dataPtr->distortionScale + center;
+  return this->DistortionMapValueClamped(
+      static_cast<int>(std::floor(
+          inputUV.X() * this->dataPtr->distortionTexWidth)),
+      static_cast<int>(std::floor(
+          inputUV.Y() * this->dataPtr->distortionTexHeight)));
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<const std::vector<float>> Distortion::Map(
+    const unsigned int _side, const ignition::math::Vector2d &_center,
+    const double _k1, const double _k2, const double _k3,
+    const double _p1, const double _p2)
+{
+  const std::string key = MapKey(_side, _center, _k1, _k2, _k3, _p1, _p2);
+
+  std::lock_guard<std::mutex> lock(gDistortionMapsMutex);
+  auto iter = gDistortionMaps.find(key);
+  if (iter != gDistortionMaps.end())
+  {
+    std::shared_ptr<const std::vector<float>> map = iter->second.lock();
+    if (map)
+      return map;
+  }
+
+  std::shared_ptr<std::vector<float>> map(new std::vector<float>);
+  const std::string filename = MapFilename(key);
+  if (filename.empty() || !LoadMap(filename, _side, *map))
+  {
+    // Mapping of distorted to undistorted normalized pixels, (-1, -1) for
+    // the distorted pixels that no pixel maps to.
+    std::vector<ignition::math::Vector2d> distortionMap(
+        static_cast<std::size_t>(_side) * _side,
+        ignition::math::Vector2d(-1, -1));
+    auto valueClamped = [&](const int _x, const int _y)
+    {
+      if (_x < 0 || _x >= static_cast<int>(_side) ||
+          _y < 0 || _y >= static_cast<int>(_side))
+      {
+        return ignition::math::Vector2d(-1, -1);
+      }
+      return distortionMap[_y * _side + _x];
+    };
+
+    // fill the distortion map
+    const double incr = 1.0 / _side;
+    for (unsigned int i = 0; i < _side; ++i)
+    {
+      double v = i*incr;
+      for (unsigned int j = 0; j < _side; ++j)
+      {
+        double u = j*incr;
+        ignition::math::Vector2d uv(u, v);
+        ignition::math::Vector2d out =
+            Distort(uv, _center, _k1, _k2, _k3, _p1, _p2);
+
+        // compute the index in the distortion map
+        if (out.X() >= 0 && out.Y() >= 0)
+        {
+          unsigned int idxU = out.X() * _side;
+          unsigned int idxV = out.Y() * _side;
+          if (idxU < _side && idxV < _side)
+            distortionMap[idxV * _side + idxU] = uv;
+        }
+        // else: pixel maps outside the image bounds.
+        // This is expected and normal to ensure
+        // no black borders; carry on
+      }
+    }
+
+    // interpolate to fill dead pixels
+    map->reserve(2 * distortionMap.size());
+    for (unsigned int i = 0; i < _side; ++i)
+    {
+      for (unsigned int j = 0; j < _side; ++j)
+      {
+        ignition::math::Vector2d vec = distortionMap[i * _side + j];
+
+        // check for empty mapping within the region and correct it by
+        // interpolating the eight neighboring distortion map values.
+        if (vec.X() < -0.5 && vec.Y() < -0.5)
+        {
+          const ignition::math::Vector2d neighbors[] = {
+              valueClamped(j+1, i), valueClamped(j-1, i),
+              valueClamped(j, i-1), valueClamped(j, i+1),
+              valueClamped(j+1, i+1), valueClamped(j-1, i+1),
+              valueClamped(j+1, i-1), valueClamped(j-1, i-1)};
+
+          ignition::math::Vector2d interpolated;
+          double divisor = 0;
+          for (int k = 0; k < 8; ++k)
+          {
+            if (neighbors[k].X() > -0.5)
+            {
+              // the diagonal neighbors weigh less
+              const double weight = k < 4 ? 1.0 : 0.707;
+              divisor += weight;
+              interpolated += neighbors[k] * weight;
+            }
+          }
+
+          if (divisor > 0.5)
+          {
+            interpolated /= divisor;
+          }
+          vec.Set(ignition::math::clamp(interpolated.X(), 0.0, 1.0),
+              ignition::math::clamp(interpolated.Y(), 0.0, 1.0));
+        }
+        map->push_back(static_cast<float>(vec.X()));
+        map->push_back(static_cast<float>(vec.Y()));
+      }
+    }
+
+    if (!filename.empty())
+      SaveMap(filename, _side, *map);
+  }
+
+  gDistortionMaps[key] = map;
+  return map;
 }
 
 //////////////////////////////////////////////////
@@ -153,46 +439,12 @@ void Distortion::SetCamera(CameraPtr _camera)
       _camera->ImageHeight() : _camera->ImageWidth();
   this->dataPtr->distortionTexWidth = texSide - 1;
   this->dataPtr->distortionTexHeight = texSide - 1;
-  unsigned int imageSize =
-      this->dataPtr->distortionTexWidth * this->dataPtr->distortionTexHeight;
-  double incrU = 1.0 / this->dataPtr->distortionTexWidth;
-  double incrV = 1.0 / this->dataPtr->distortionTexHeight;
-
-  // initialize distortion map
-  this->dataPtr->distortionMap.resize(imageSize);
-  for (unsigned int i = 0; i < this->dataPtr->distortionMap.size(); ++i)
-  {
-    this->dataPtr->distortionMap[i] = -1;
-  }
 
-  // fill the distortion map
-  for (unsigned int i = 0; i < this->dataPtr->distortionTexHeight; ++i)
-  {
-    double v = i*incrV;
-    for (unsigned int j = 0; j < this->dataPtr->distortionTexWidth; ++j)
-    {
-      double u = j*incrU;
-      ignition::math::Vector2d uv(u, v);
-      ignition::math::Vector2d out =
-        this->Distort(uv, this->dataPtr->lensCenter,
-            this->dataPtr->k1, this->dataPtr->k2, this->dataPtr->k3,
-            this->dataPtr->p1, this->dataPtr->p2);
-
-      // compute the index in the distortion map
-      unsigned int idxU = out.X() * this->dataPtr->distortionTexWidth;
-      unsigned int idxV = out.Y() * this->dataPtr->distortionTexHeight;
-
-      if (idxU < this->dataPtr->distortionTexWidth &&
-          idxV < this->dataPtr->distortionTexHeight)
-      {
-        unsigned int mapIdx = idxV * this->dataPtr->distortionTexWidth + idxU;
-        this->dataPtr->distortionMap[mapIdx] = uv;
-      }
-      // else: pixel maps outside the image bounds.
-      // This is expected and normal to ensure
-      // no black borders; carry on
-    }
-  }
+  // The map only depends on its size and the coefficients, so cameras
+  // with the same lens share it and its texture.
+  this->dataPtr->distortionMap = this->Map(texSide - 1,
+      this->dataPtr->lensCenter, this->dataPtr->k1, this->dataPtr->k2,
+      this->dataPtr->k3, this->dataPtr->p1, this->dataPtr->p2);
 
   // set up the distortion instance
   this->dataPtr->distortionMaterial =
@@ -203,126 +455,47 @@ void Distortion::SetCamera(CameraPtr _camera)
           "Gazebo/" + _camera->Name() + "_CameraDistortionMap");
 
   // create the distortion map texture for the distortion instance
-  std::string texName = _camera->Name() + "_distortionTex";
-  Ogre::TexturePtr renderTexture =
-      Ogre::TextureManager::getSingleton().createManual(
-          texName,
-          "General",
-          Ogre::TEX_TYPE_2D,
-          this->dataPtr->distortionTexWidth,
-          this->dataPtr->distortionTexHeight,
-          0,
-          Ogre::PF_FLOAT32_RGB);
-  Ogre::HardwarePixelBufferSharedPtr pixelBuffer = renderTexture->getBuffer();
-
-  // fill the distortion map, while interpolating to fill dead pixels
-  pixelBuffer->lock(Ogre::HardwareBuffer::HBL_NORMAL);
-  const Ogre::PixelBox &pixelBox = pixelBuffer->getCurrentLock();
+  std::string texName = "Gazebo/DistortionMap_" + MapKey(texSide - 1,
+      this->dataPtr->lensCenter, this->dataPtr->k1, this->dataPtr->k2,
+      this->dataPtr->k3, this->dataPtr->p1, this->dataPtr->p2);
+  if (!Ogre::TextureManager::getSingleton().resourceExists(texName))
+  {
+    Ogre::TexturePtr renderTexture =
+        Ogre::TextureManager::getSingleton().createManual(
+            texName,
+            "General",
+            Ogre::TEX_TYPE_2D,
+            this->dataPtr->distortionTexWidth,
+            this->dataPtr->distortionTexHeight,
+            0,
+            Ogre::PF_FLOAT32_RGB);
+    Ogre::HardwarePixelBufferSharedPtr pixelBuffer =
+        renderTexture->getBuffer();
+
+    pixelBuffer->lock(Ogre::HardwareBuffer::HBL_NORMAL);
+    const Ogre::PixelBox &pixelBox = pixelBuffer->getCurrentLock();
 
 #if OGRE_VERSION_MAJOR > 1 || OGRE_VERSION_MINOR >= 11
-  // Ogre 1.11 changed Ogre::PixelBox::data from void* to uchar*, hence
-  // reinterpret_cast is required here. static_cast is not allowed between
-  // pointers of unrelated types (see, for instance, Standard § 3.9.1
-  // Fundamental types)
-  float *pDest = reinterpret_cast<float *>(pixelBox.data);
+    // Ogre 1.11 changed Ogre::PixelBox::data from void* to uchar*, hence
+    // reinterpret_cast is required here. static_cast is not allowed between
+    // pointers of unrelated types (see, for instance, Standard § 3.9.1
+    // Fundamental types)
+    float *pDest = reinterpret_cast<float *>(pixelBox.data);
 #else
-  float *pDest = static_cast<float *>(pixelBox.data);
+    float *pDest = static_cast<float *>(pixelBox.data);
 #endif
 
-  for (unsigned int i = 0; i < this->dataPtr->distortionTexHeight; ++i)
-  {
-    for (unsigned int j = 0; j < this->dataPtr->distortionTexWidth; ++j)
+    const std::vector<float> &map = *this->dataPtr->distortionMap;
+    for (std::size_t i = 0; i < map.size(); i += 2)
     {
-      ignition::math::Vector2d vec =
-          this->dataPtr->distortionMap[i*this->dataPtr->distortionTexWidth+j];
-
-      // perform interpolation on-the-fly:
-      // check for empty mapping within the region and correct it by
-      // interpolating the eight neighboring distortion map values.
-
-      if (vec.X() < -0.5 && vec.Y() < -0.5)
-      {
-        ignition::math::Vector2d left =
-            this->DistortionMapValueClamped(j-1, i);
-        ignition::math::Vector2d right =
-            this->DistortionMapValueClamped(j+1, i);
-        ignition::math::Vector2d bottom =
-            this->DistortionMapValueClamped(j, i+1);
-        ignition::math::Vector2d top =
-            this->DistortionMapValueClamped(j, i-1);
-
-        ignition::math::Vector2d topLeft =
-            this->DistortionMapValueClamped(j-1, i-1);
-        ignition::math::Vector2d topRight =
-            this->DistortionMapValueClamped(j+1, i-1);
-        ignition::math::Vector2d bottomLeft =
-            this->DistortionMapValueClamped(j-1, i+1);
-        ignition::math::Vector2d bottomRight =
-            this->DistortionMapValueClamped(j+1, i+1);
-
-
-        ignition::math::Vector2d interpolated;
-        double divisor = 0;
-        if (right.X() > -0.5)
-        {
-          divisor++;
-          interpolated += right;
-        }
-        if (left.X() > -0.5)
-        {
-          divisor++;
-          interpolated += left;
-        }
-        if (top.X() > -0.5)
-        {
-          divisor++;
-          interpolated += top;
-        }
-        if (bottom.X() > -0.5)
-        {
-          divisor++;
-          interpolated += bottom;
-        }
-
-        if (bottomRight.X() > -0.5)
-        {
-          divisor += 0.707;
-          interpolated += bottomRight * 0.707;
-        }
-        if (bottomLeft.X() > -0.5)
-        {
-          divisor += 0.707;
-          interpolated += bottomLeft * 0.707;
-        }
-        if (topRight.X() > -0.5)
-        {
-          divisor += 0.707;
-          interpolated += topRight * 0.707;
-        }
-        if (topLeft.X() > -0.5)
-        {
-          divisor += 0.707;
-          interpolated += topLeft * 0.707;
-        }
-
-        if (divisor > 0.5)
-        {
-          interpolated /= divisor;
-        }
-        *pDest++ = ignition::math::clamp(interpolated.X(), 0.0, 1.0);
-        *pDest++ = ignition::math::clamp(interpolated.Y(), 0.0, 1.0);
-      }
-      else
-      {
-        *pDest++ = vec.X();
-        *pDest++ = vec.Y();
-      }
+      *pDest++ = map[i];
+      *pDest++ = map[i + 1];
 
       // Z coordinate
       *pDest++ = 0;
     }
+    pixelBuffer->unlock();
   }
-  pixelBuffer->unlock();
 
   // set up the distortion map texture to be used in the pixel shader.
   this->dataPtr->distortionMaterial->getTechnique(0)->getPass(0)->
@@ -18,6 +18,7 @@
 #define GAZEBO_RENDERING_DISTORTION_HH_
 
 #include <memory>
+#include <vector>
 #include <ignition/math/Vector2.hh>
 #include <sdf/Element.hh>
 
@@ -104,6 +105,34 @@ namespace gazebo
                   double _k1, double _k2, double _k3,
                   double _p1, double _p2);
 
+      /// \brief Get the point of the undistorted image that a point of
+      /// the distorted image shows, using the distortion map like the
+      /// distortion shader.
+      /// \param[in] _uv Normalized point of the distorted image.
+      /// \return Normalized point of the undistorted image, or (-1, -1) if
+      /// the point is in the black border. The point is returned unchanged
+      /// until SetCamera has built the map, or without distortion.
+      public: ignition::math::Vector2d Undistort(
+                  const ignition::math::Vector2d &_uv) const;
+
+      /// \brief Get the mapping of distorted to undistorted normalized
+      /// pixels of a lens. Maps are shared by the cameras with the same
+      /// size and coefficients, and cached on disk in the distortion_cache
+      /// directory of the log path, unless GAZEBO_DISTORTION_CACHE is 0.
+      /// \param[in] _side Width and height of the map, in texels.
+      /// \param[in] _center Normalized distortion center.
+      /// \param[in] _k1 Radial distortion coefficient k1.
+      /// \param[in] _k2 Radial distortion coefficient k2.
+      /// \param[in] _k3 Radial distortion coefficient k3.
+      /// \param[in] _p1 Tangential distortion coefficient p1.
+      /// \param[in] _p2 Tangential distortion coefficient p2.
+      /// \return The map, row by row, two values (u, v) per texel.
+      public: static std::shared_ptr<const std::vector<float>> Map(
+                  const unsigned int _side,
+                  const ignition::math::Vector2d &_center,
+                  const double _k1, const double _k2, const double _k3,
+                  const double _p1, const double _p2);
+
       /// \brief get the distortion map value.
       /// \return the distortion map value at the specified index,
       /// or (-1, -1) if the index
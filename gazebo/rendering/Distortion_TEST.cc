@@ -16,7 +16,9 @@
 */
 
 #include <gtest/gtest.h>
+#include <memory>
 #include <string>
+#include <vector>
 #include <stdlib.h>
 
 #include "gazebo/rendering/RenderingIface.hh"
@@ -116,6 +118,44 @@ TEST_F(Distortion_TEST, DistortionModelBasics)
   EXPECT_DOUBLE_EQ(distortion.Center().Y(), 0.5);
 }
 
+/////////////////////////////////////////////////
+TEST_F(Distortion_TEST, Map)
+{
+  const ignition::math::Vector2d center(0.5, 0.5);
+  std::shared_ptr<const std::vector<float>> map =
+      rendering::Distortion::Map(64, center, -0.1, -0.05, -0.01, 0, 0);
+  ASSERT_TRUE(map != nullptr);
+  ASSERT_EQ(map->size(), 2u * 64u * 64u);
+
+  // Lenses with the same size and coefficients share the map
+  EXPECT_EQ(map,
+      rendering::Distortion::Map(64, center, -0.1, -0.05, -0.01, 0, 0));
+  EXPECT_NE(map,
+      rendering::Distortion::Map(64, center, 0.1, 0.05, 0.01, 0, 0));
+  EXPECT_NE(map,
+      rendering::Distortion::Map(32, center, -0.1, -0.05, -0.01, 0, 0));
+
+  // The center doesn't move
+  const std::size_t idx = 2 * (32 * 64 + 32);
+  EXPECT_NEAR((*map)[idx], 0.5, 2.0 / 64);
+  EXPECT_NEAR((*map)[idx + 1], 0.5, 2.0 / 64);
+
+  // A map that is no longer used is read back from the disk cache
+  const std::vector<float> values = *map;
+  map.reset();
+  map = rendering::Distortion::Map(64, center, -0.1, -0.05, -0.01, 0, 0);
+  ASSERT_TRUE(map != nullptr);
+  EXPECT_EQ(*map, values);
+
+  // Without a camera, points are left undistorted
+  rendering::Distortion distortion;
+  distortion.Load(
+      CreateDistortionSDFElement(-0.1, -0.05, -0.01, 0, 0, 0.5, 0.5));
+  EXPECT_EQ(distortion.Undistort(ignition::math::Vector2d(0.2, 0.3)),
+      ignition::math::Vector2d(0.2, 0.3));
+}
+
+/////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
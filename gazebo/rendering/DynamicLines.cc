@@ -132,13 +132,15 @@ unsigned int DynamicLines::GetPointCount() const
 void DynamicLines::Clear()
 {
   this->points.clear();
+  this->dataPtr->colors.clear();
   this->dirty = true;
 }
 
 /////////////////////////////////////////////////
 void DynamicLines::Update()
 {
-  if (this->dirty && this->points.size() > 1)
+  // Cleared lines are filled too, so that the old points aren't drawn
+  if (this->dirty)
     this->FillHardwareBuffers();
 }
 
@@ -155,50 +157,58 @@ void DynamicLines::CreateVertexDeclaration()
 /////////////////////////////////////////////////
 void DynamicLines::FillHardwareBuffers()
 {
-  int size = this->points.size();
+  const size_t size = this->points.size();
   this->PrepareHardwareBuffers(size, 0);
 
-  if (!size)
+  if (size == 0)
   {
     this->mBox.setExtents(Ogre::Vector3::ZERO, Ogre::Vector3::ZERO);
-    this->dirty = false;
   }
-
-  Ogre::HardwareVertexBufferSharedPtr vbuf =
-    this->mRenderOp.vertexData->vertexBufferBinding->getBuffer(0);
-
-  Ogre::Real *prPos =
-    static_cast<Ogre::Real*>(vbuf->lock(Ogre::HardwareBuffer::HBL_NORMAL));
+  else
   {
-    for (int i = 0; i < size; i++)
+    // The buffers are rewritten whole, so they are locked with discard and
+    // the driver can hand out new storage instead of waiting for frames
+    // which still draw the old points
+    Ogre::HardwareVertexBufferSharedPtr vbuf =
+      this->mRenderOp.vertexData->vertexBufferBinding->getBuffer(0);
+    float *prPos = static_cast<float *>(vbuf->lock(0,
+        size * vbuf->getVertexSize(), Ogre::HardwareBuffer::HBL_DISCARD));
+
+    ignition::math::Vector3d min = this->points[0];
+    ignition::math::Vector3d max = this->points[0];
+    for (auto const &pt : this->points)
     {
-      *prPos++ = this->points[i].X();
-      *prPos++ = this->points[i].Y();
-      *prPos++ = this->points[i].Z();
-
-      this->mBox.merge(Conversions::Convert(this->points[i]));
+      *prPos++ = pt.X();
+      *prPos++ = pt.Y();
+      *prPos++ = pt.Z();
+      min.Min(pt);
+      max.Max(pt);
     }
+    vbuf->unlock();
+    this->mBox.setExtents(Conversions::Convert(min),
+        Conversions::Convert(max));
+
+    // Update the colors
+    Ogre::HardwareVertexBufferSharedPtr cbuf =
+      this->mRenderOp.vertexData->vertexBufferBinding->getBuffer(1);
+    Ogre::RGBA *colorArrayBuffer = static_cast<Ogre::RGBA *>(cbuf->lock(0,
+        size * cbuf->getVertexSize(), Ogre::HardwareBuffer::HBL_DISCARD));
+    Ogre::RenderSystem *renderSystemForVertex =
+          Ogre::Root::getSingleton().getRenderSystem();
+    for (size_t i = 0; i < size; ++i)
+    {
+      Ogre::ColourValue color = i < this->dataPtr->colors.size() ?
+          Conversions::Convert(this->dataPtr->colors[i]) :
+          Ogre::ColourValue::White;
+      renderSystemForVertex->convertColourValue(color, &colorArrayBuffer[i]);
+    }
+    cbuf->unlock();
   }
-  vbuf->unlock();
-
-  // Update the colors
-  Ogre::HardwareVertexBufferSharedPtr cbuf =
-    this->mRenderOp.vertexData->vertexBufferBinding->getBuffer(1);
-
-  Ogre::RGBA *colorArrayBuffer =
-        static_cast<Ogre::RGBA*>(cbuf->lock(Ogre::HardwareBuffer::HBL_DISCARD));
-  Ogre::RenderSystem *renderSystemForVertex =
-        Ogre::Root::getSingleton().getRenderSystem();
-  for (int i = 0; i < size; ++i)
-  {
-    Ogre::ColourValue color = Conversions::Convert(this->dataPtr->colors[i]);
-    renderSystemForVertex->convertColourValue(color, &colorArrayBuffer[i]);
-  }
-  cbuf->unlock();
 
   // need to update after mBox change, otherwise the lines goes in and out
   // of scope based on old mBox
-  this->getParentSceneNode()->needUpdate();
+  if (this->getParentSceneNode())
+    this->getParentSceneNode()->needUpdate();
 
   this->dirty = false;
 }
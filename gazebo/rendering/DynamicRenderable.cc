@@ -147,10 +147,11 @@ void DynamicRenderable::PrepareHardwareBuffers(size_t vertexCount,
     while (newVertCapacity < vertexCount)
       newVertCapacity <<= 1;
   }
-  else if (vertexCount < this->vertexBufferCapacity>>1)
+  else if (vertexCount < this->vertexBufferCapacity>>2)
   {
-    // Make capacity the previous power of two
-    while (vertexCount < newVertCapacity>>1)
+    // Only shrink when a quarter of the buffer is used, so that counts
+    // which go up and down don't reallocate the buffer every update
+    while (vertexCount < newVertCapacity>>2)
       newVertCapacity >>= 1;
   }
 
@@ -203,10 +204,10 @@ void DynamicRenderable::PrepareHardwareBuffers(size_t vertexCount,
       while (newIndexCapacity < indexCount)
         newIndexCapacity <<= 1;
     }
-    else if (indexCount < newIndexCapacity>>1)
+    else if (indexCount < newIndexCapacity>>2)
     {
-      // Make capacity the previous power of two
-      while (indexCount < newIndexCapacity>>1)
+      // Only shrink when a quarter of the buffer is used
+      while (indexCount < newIndexCapacity>>2)
         newIndexCapacity >>= 1;
     }
 
@@ -0,0 +1,302 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/rendering/ogre_gazebo.h"
+#include "gazebo/rendering/Camera.hh"
+#include "gazebo/rendering/FrameWriter.hh"
+
+using namespace gazebo;
+using namespace rendering;
+
+namespace gazebo
+{
+  namespace rendering
+  {
+    /// \internal
+    /// \brief A frame waiting for a writer thread.
+    class QueuedFrame
+    {
+      /// \brief Copy of the pixels.
+      public: std::vector<unsigned char> data;
+
+      /// \brief Width of the image.
+      public: unsigned int width = 0;
+
+      /// \brief Height of the image.
+      public: unsigned int height = 0;
+
+      /// \brief Depth of the image data.
+      public: int depth = 0;
+
+      /// \brief Format the image data is in.
+      public: std::string format;
+
+      /// \brief Name of the file in which to write the frame.
+      public: std::string filename;
+    };
+
+    /// \internal
+    /// \brief Private data for the FrameWriter class
+    class FrameWriterPrivate
+    {
+      /// \brief Encode the queued frames until stopped.
+      public: void Run();
+
+      /// \brief Write a frame to its file.
+      /// \param[in] _frame The frame.
+      /// \return True if the frame was written.
+      public: static bool Encode(const QueuedFrame &_frame);
+
+      /// \brief Frames waiting for a writer thread, oldest first.
+      public: std::deque<QueuedFrame> queue;
+
+      /// \brief Pixel buffers of the frames written, reused by the next
+      /// frames.
+      public: std::vector<std::vector<unsigned char>> pool;
+
+      /// \brief Maximum number of frames in the queue.
+      public: size_t queueSize = 1;
+
+      /// \brief What to do with a frame when the queue is full.
+      public: FrameWriter::FullPolicy policy = FrameWriter::BLOCK;
+
+      /// \brief Number of frames being copied by Write, which have a place
+      /// in the queue.
+      public: size_t reserved = 0;
+
+      /// \brief Number of frames taken by a writer thread and not written
+      /// yet.
+      public: size_t busy = 0;
+
+      /// \brief Number of frames written.
+      public: uint64_t written = 0;
+
+      /// \brief Number of frames dropped or that failed to be written.
+      public: uint64_t dropped = 0;
+
+      /// \brief True to stop the writer threads once the queue is empty.
+      public: bool stop = false;
+
+      /// \brief Protects all the members.
+      public: mutable std::mutex mutex;
+
+      /// \brief Notified when a frame is queued or the threads must stop.
+      public: std::condition_variable queuedCond;
+
+      /// \brief Notified when a frame is taken from the queue or written.
+      public: std::condition_variable takenCond;
+
+      /// \brief The writer threads.
+      public: std::vector<std::thread> threads;
+    };
+  }
+}
+
+//////////////////////////////////////////////////
+FrameWriter::FrameWriter(const unsigned int _threads,
+    const unsigned int _queueSize, const FullPolicy _policy)
+  : dataPtr(new FrameWriterPrivate)
+{
+  this->dataPtr->queueSize = std::max(1u, _queueSize);
+  this->dataPtr->policy = _policy;
+
+  for (unsigned int i = 0; i < std::max(1u, _threads); ++i)
+  {
+    this->dataPtr->threads.emplace_back(&FrameWriterPrivate::Run,
+        this->dataPtr.get());
+  }
+}
+
+//////////////////////////////////////////////////
+FrameWriter::~FrameWriter()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stop = true;
+  }
+  this->dataPtr->queuedCond.notify_all();
+
+  for (auto &thread : this->dataPtr->threads)
+    thread.join();
+}
+
+//////////////////////////////////////////////////
+bool FrameWriter::Write(const unsigned char *_image,
+    const unsigned int _width, const unsigned int _height, const int _depth,
+    const std::string &_format, const std::string &_filename)
+{
+  if (!_image)
+  {
+    gzerr << "Can't save an empty image\n";
+    return false;
+  }
+
+  const size_t size = Camera::ImageByteSize(_width, _height, _format);
+
+  std::vector<unsigned char> data;
+  {
+    std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+    auto full = [this]
+    {
+      return this->dataPtr->queue.size() + this->dataPtr->reserved >=
+          this->dataPtr->queueSize;
+    };
+
+    if (full())
+    {
+      if (this->dataPtr->policy == DROP)
+      {
+        ++this->dataPtr->dropped;
+        return false;
+      }
+
+      this->dataPtr->takenCond.wait(lock, [&full] { return !full(); });
+    }
+
+    ++this->dataPtr->reserved;
+    if (!this->dataPtr->pool.empty())
+    {
+      data.swap(this->dataPtr->pool.back());
+      this->dataPtr->pool.pop_back();
+    }
+  }
+
+  // The copy is made without the lock, the writer threads keep going
+  data.resize(size);
+  std::memcpy(data.data(), _image, size);
+
+  QueuedFrame frame;
+  frame.data.swap(data);
+  frame.width = _width;
+  frame.height = _height;
+  frame.depth = _depth;
+  frame.format = _format;
+  frame.filename = _filename;
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    --this->dataPtr->reserved;
+    this->dataPtr->queue.push_back(std::move(frame));
+  }
+  this->dataPtr->queuedCond.notify_one();
+  return true;
+}
+
+//////////////////////////////////////////////////
+void FrameWriter::Flush()
+{
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->takenCond.wait(lock, [this]
+      {
+        return this->dataPtr->queue.empty() &&
+            this->dataPtr->reserved == 0 && this->dataPtr->busy == 0;
+      });
+}
+
+//////////////////////////////////////////////////
+uint64_t FrameWriter::WrittenCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->written;
+}
+
+//////////////////////////////////////////////////
+uint64_t FrameWriter::DroppedCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->dropped;
+}
+
+//////////////////////////////////////////////////
+void FrameWriterPrivate::Run()
+{
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (true)
+  {
+    this->queuedCond.wait(lock, [this]
+        {
+          return this->stop || !this->queue.empty();
+        });
+
+    // The queued frames are still written when stopping
+    if (this->queue.empty())
+      return;
+
+    QueuedFrame frame = std::move(this->queue.front());
+    this->queue.pop_front();
+    ++this->busy;
+    this->takenCond.notify_all();
+
+    lock.unlock();
+    const bool result = Encode(frame);
+    lock.lock();
+
+    --this->busy;
+    if (result)
+      ++this->written;
+    else
+      ++this->dropped;
+
+    // Keep as many buffers as frames can be in flight
+    if (this->pool.size() < this->queueSize + this->threads.size())
+      this->pool.push_back(std::move(frame.data));
+    this->takenCond.notify_all();
+  }
+}
+
+//////////////////////////////////////////////////
+bool FrameWriterPrivate::Encode(const QueuedFrame &_frame)
+{
+  const size_t pos = _frame.filename.find_last_of('.');
+  if (pos != std::string::npos && _frame.filename.substr(pos + 1) == "raw")
+  {
+    std::ofstream file(_frame.filename, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(_frame.data.data()),
+        _frame.data.size());
+    if (!file)
+    {
+      gzerr << "Unable to write frame [" << _frame.filename << "]\n";
+      return false;
+    }
+    return true;
+  }
+
+  // The Ogre codecs encode separate images in parallel, their registry
+  // is only read.
+  try
+  {
+    return Camera::SaveFrame(_frame.data.data(), _frame.width,
+        _frame.height, _frame.depth, _frame.format, _frame.filename);
+  }
+  catch(Ogre::Exception &_e)
+  {
+    gzerr << "Unable to write frame [" << _frame.filename << "]: "
+          << _e.what() << std::endl;
+    return false;
+  }
+}
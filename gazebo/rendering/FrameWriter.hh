@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_RENDERING_FRAMEWRITER_HH_
+#define GAZEBO_RENDERING_FRAMEWRITER_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace gazebo
+{
+  namespace rendering
+  {
+    // Forward declare private data class.
+    class FrameWriterPrivate;
+
+    /// \internal
+    /// \brief Writes camera frames to files in background threads, so that
+    /// encoding them doesn't stall the rendering thread. Each frame is
+    /// copied into a pooled buffer and queued, then encoded by one of the
+    /// writer threads according to the extension of its file: "raw" files
+    /// hold the pixels as is, and the other extensions are encoded by the
+    /// Ogre image codecs, as Camera::SaveFrame does.
+    class FrameWriter
+    {
+      /// \enum FullPolicy
+      /// \brief What Write does when the queue is full.
+      public: enum FullPolicy
+      {
+        /// \brief Drop the frame.
+        DROP,
+
+        /// \brief Wait until a writer thread takes a frame.
+        BLOCK
+      };
+
+      /// \brief Constructor, starts the writer threads.
+      /// \param[in] _threads Number of writer threads, at least 1.
+      /// \param[in] _queueSize Number of frames that can wait for a writer
+      /// thread, at least 1.
+      /// \param[in] _policy What to do with a frame when the queue is full.
+      public: FrameWriter(const unsigned int _threads = 2,
+                  const unsigned int _queueSize = 8,
+                  const FullPolicy _policy = BLOCK);
+
+      /// \brief Destructor, writes the queued frames and stops the threads.
+      public: ~FrameWriter();
+
+      /// \brief Queue a frame.
+      /// \param[in] _image The pixels, copied before returning.
+      /// \param[in] _width Width of the image.
+      /// \param[in] _height Height of the image.
+      /// \param[in] _depth Depth of the image data.
+      /// \param[in] _format Format the image data is in.
+      /// \param[in] _filename Name of the file in which to write the frame.
+      /// \return False if the image is empty, or the queue is full with the
+      /// DROP policy.
+      public: bool Write(const unsigned char *_image,
+                  const unsigned int _width, const unsigned int _height,
+                  const int _depth, const std::string &_format,
+                  const std::string &_filename);
+
+      /// \brief Wait until all the queued frames are written.
+      public: void Flush();
+
+      /// \brief Get the number of frames written to files.
+      /// \return Number of frames written.
+      public: uint64_t WrittenCount() const;
+
+      /// \brief Get the number of frames dropped because the queue was
+      /// full, or failed to be written.
+      /// \return Number of frames lost.
+      public: uint64_t DroppedCount() const;
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<FrameWriterPrivate> dataPtr;
+    };
+  }
+}
+#endif
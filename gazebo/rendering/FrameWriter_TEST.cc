@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+#include "gazebo/rendering/FrameWriter.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class FrameWriterTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(FrameWriterTest, Raw)
+{
+  namespace fs = boost::filesystem;
+  const fs::path dir = fs::temp_directory_path() /
+      fs::unique_path("gazebo-FrameWriter-%%%%-%%%%");
+  ASSERT_TRUE(fs::create_directories(dir));
+
+  const unsigned int width = 4;
+  const unsigned int height = 2;
+  const unsigned int count = 20;
+  std::vector<unsigned char> image(width * height * 3);
+
+  {
+    rendering::FrameWriter writer(3, 2);
+    EXPECT_FALSE(writer.Write(nullptr, width, height, 1, "R8G8B8",
+          (dir / "null.raw").string()));
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      // The image is copied, changing it doesn't change the queued frames
+      for (unsigned int j = 0; j < image.size(); ++j)
+        image[j] = static_cast<unsigned char>(i + j);
+      EXPECT_TRUE(writer.Write(image.data(), width, height, 1, "R8G8B8",
+            (dir / ("frame" + std::to_string(i) + ".raw")).string()));
+    }
+
+    // A missing directory fails
+    EXPECT_TRUE(writer.Write(image.data(), width, height, 1, "R8G8B8",
+          (dir / "missing" / "frame.raw").string()));
+
+    writer.Flush();
+    EXPECT_EQ(writer.WrittenCount(), count);
+    EXPECT_EQ(writer.DroppedCount(), 1u);
+  }
+
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    std::ifstream file((dir / ("frame" + std::to_string(i) + ".raw")).string(),
+        std::ios::binary);
+    std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)),
+        std::istreambuf_iterator<char>());
+    ASSERT_EQ(data.size(), image.size());
+    for (unsigned int j = 0; j < data.size(); ++j)
+      EXPECT_EQ(data[j], static_cast<unsigned char>(i + j));
+  }
+
+  // Frames are dropped instead of waiting for the writer thread
+  {
+    rendering::FrameWriter writer(1, 1, rendering::FrameWriter::DROP);
+    unsigned int queued = 0;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      if (writer.Write(image.data(), width, height, 1, "R8G8B8",
+            (dir / ("drop" + std::to_string(i) + ".raw")).string()))
+      {
+        ++queued;
+      }
+    }
+    writer.Flush();
+    EXPECT_GE(queued, 1u);
+    EXPECT_EQ(writer.WrittenCount(), queued);
+    EXPECT_EQ(writer.WrittenCount() + writer.DroppedCount(), count);
+  }
+
+  fs::remove_all(dir);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -15,6 +15,7 @@
  *
 */
 
+#include <cmath>
 #include <sstream>
 
 #include <ignition/math/Color.hh>
@@ -42,6 +43,7 @@
 #include "gazebo/rendering/Conversions.hh"
 #include "gazebo/rendering/Scene.hh"
 #include "gazebo/rendering/GpuLaser.hh"
+#include "gazebo/rendering/GpuLaserDepthFaces.hh"
 #include "gazebo/rendering/GpuLaserPrivate.hh"
 
 using namespace gazebo;
@@ -60,7 +62,10 @@ GpuLaser::GpuLaser(const std::string &_namePrefix, ScenePtr _scene,
   this->dataPtr->matFirstPass = NULL;
   this->dataPtr->matSecondPass = NULL;
   for (int i = 0; i < 3; ++i)
+  {
     this->dataPtr->firstPassTextures[i] = NULL;
+    this->dataPtr->firstPassTargets[i] = NULL;
+  }
   this->dataPtr->secondPassTexture = NULL;
   this->dataPtr->orthoCam = NULL;
   this->dataPtr->w2nd = 0;
@@ -121,6 +126,9 @@ void GpuLaser::Fini()
     this->dataPtr->orthoCam = nullptr;
   }
 
+  this->dataPtr->depthFaces.reset();
+  this->dataPtr->neededFaces.clear();
+
   this->dataPtr->visual.reset();
   this->dataPtr->texIdx.clear();
   this->dataPtr->texCount = 0;
@@ -157,7 +165,9 @@ void GpuLaser::CreateLaserTexture(const std::string &_textureName)
     this->dataPtr->cameraYaws[3] = -this->hfov;
   }
 
-  for (unsigned int i = 0; i < this->dataPtr->textureCount; ++i)
+  // The first pass is rendered to the shared depth images instead
+  for (unsigned int i = 0; !this->dataPtr->sharedDepth &&
+      i < this->dataPtr->textureCount; ++i)
   {
     std::stringstream texName;
     texName << _textureName << "first_pass_" << i;
@@ -193,6 +203,11 @@ void GpuLaser::CreateLaserTexture(const std::string &_textureName)
 
   this->dataPtr->secondPassTarget->setAutoUpdated(false);
 
+  // The canvas is created once the laser is attached to its visual, see
+  // CreateSharedDepth
+  if (this->dataPtr->sharedDepth)
+    return;
+
   this->dataPtr->matSecondPass = (Ogre::Material*)(
   Ogre::MaterialManager::getSingleton().getByName("Gazebo/LaserScan2nd").get());
 
@@ -229,7 +244,8 @@ void GpuLaser::PostRender()
 {
   for (unsigned int i = 0; i < this->dataPtr->textureCount; ++i)
   {
-    this->dataPtr->firstPassTargets[i]->swapBuffers();
+    if (this->dataPtr->firstPassTargets[i])
+      this->dataPtr->firstPassTargets[i]->swapBuffers();
   }
   this->dataPtr->secondPassTarget->swapBuffers();
 
@@ -255,20 +271,37 @@ void GpuLaser::PostRender()
     Ogre::PixelBox dstBox(width, height,
         1, Ogre::PF_FLOAT32_RGB, this->dataPtr->laserBuffer);
 
-    pixelBuffer->blitToMemory(dstBox);
-
-    if (!this->dataPtr->laserScan)
+    bool ready = true;
+    if (this->ReadbackLatency() > 0)
+    {
+      // Read the frame started by the previous call, and start this one
+      ready = this->dataPtr->laserReadback.Read(
+          this->dataPtr->secondPassTexture, Ogre::PF_FLOAT32_RGB, width,
+          height, this->dataPtr->laserBuffer);
+    }
+    else
     {
-      int len = this->dataPtr->w2nd * this->dataPtr->h2nd * 3;
-      this->dataPtr->laserScan = new float[len];
+      this->dataPtr->laserReadback.Reset();
+      pixelBuffer->blitToMemory(dstBox);
     }
 
-    memcpy(this->dataPtr->laserScan, this->dataPtr->laserBuffer,
-           this->dataPtr->w2nd * this->dataPtr->h2nd * 3 *
-           sizeof(this->dataPtr->laserScan[0]));
+    if (ready)
+    {
+      this->MarkImageDelivered(this->ReadbackLatency() > 0);
 
-    this->dataPtr->newLaserFrame(this->dataPtr->laserScan, this->dataPtr->w2nd,
-        this->dataPtr->h2nd, 3, "BLABLA");
+      if (!this->dataPtr->laserScan)
+      {
+        int len = this->dataPtr->w2nd * this->dataPtr->h2nd * 3;
+        this->dataPtr->laserScan = new float[len];
+      }
+
+      memcpy(this->dataPtr->laserScan, this->dataPtr->laserBuffer,
+             this->dataPtr->w2nd * this->dataPtr->h2nd * 3 *
+             sizeof(this->dataPtr->laserScan[0]));
+
+      this->dataPtr->newLaserFrame(this->dataPtr->laserScan,
+          this->dataPtr->w2nd, this->dataPtr->h2nd, 3, "BLABLA");
+    }
   }
 
   this->newData = false;
@@ -292,7 +325,7 @@ void GpuLaser::UpdateRenderTarget(Ogre::RenderTarget *_target,
   // OgreSceneManager::_render function automatically sets farClip to 0.
   // Which normally equates to infinite distance. We don't want this. So
   // we have to set the distance every time.
-  _cam->setFarClipDistance(this->FarClip());
+  _cam->setFarClipDistance(this->dataPtr->currentFarClip);
 
   Ogre::AutoParamDataSource autoParamDataSource;
 
@@ -389,7 +422,7 @@ void GpuLaser::notifyRenderSingleObject(Ogre::Renderable *_rend,
   autoParamDataSource.setCurrentViewport(vp);
   autoParamDataSource.setCurrentRenderTarget(this->dataPtr->currentTarget);
   autoParamDataSource.setCurrentSceneManager(this->scene->OgreSceneManager());
-  autoParamDataSource.setCurrentCamera(this->camera, true);
+  autoParamDataSource.setCurrentCamera(this->dataPtr->currentCam, true);
 
   pass->_updateAutoParams(&autoParamDataSource,
       Ogre::GPV_GLOBAL | Ogre::GPV_PER_OBJECT);
@@ -418,10 +451,24 @@ void GpuLaser::RenderImpl()
 
   Ogre::SceneManager *sceneMgr = this->scene->OgreSceneManager();
 
+  // Wait to be attached to the visual before joining the shared depth
+  if (this->dataPtr->sharedDepth && !this->dataPtr->depthFaces &&
+      !this->CreateSharedDepth())
+  {
+    this->newData = false;
+    return;
+  }
+
+  this->dataPtr->currentFarClip = this->FarClip();
+
   sceneMgr->_suppressRenderStateChanges(true);
   sceneMgr->addRenderObjectListener(this);
 
-  for (unsigned int i = 0; i < this->dataPtr->textureCount; ++i)
+  if (this->dataPtr->depthFaces)
+    this->RenderSharedDepth();
+
+  for (unsigned int i = 0; !this->dataPtr->depthFaces &&
+      i < this->dataPtr->textureCount; ++i)
   {
     if (this->dataPtr->textureCount > 1)
     {
@@ -432,13 +479,14 @@ void GpuLaser::RenderImpl()
 
     this->dataPtr->currentMat = this->dataPtr->matFirstPass;
     this->dataPtr->currentTarget = this->dataPtr->firstPassTargets[i];
+    this->dataPtr->currentCam = this->camera;
 
     this->UpdateRenderTarget(this->dataPtr->firstPassTargets[i],
                   this->dataPtr->matFirstPass, this->camera);
     this->dataPtr->firstPassTargets[i]->update(false);
   }
 
-  if (this->dataPtr->textureCount > 1)
+  if (!this->dataPtr->depthFaces && this->dataPtr->textureCount > 1)
       this->sceneNode->roll(Ogre::Radian(this->dataPtr->cameraYaws[3]));
 
   sceneMgr->removeRenderObjectListener(this);
@@ -448,8 +496,24 @@ void GpuLaser::RenderImpl()
 
   this->dataPtr->visual->SetVisible(true);
 
-  this->UpdateRenderTarget(this->dataPtr->secondPassTarget,
-                this->dataPtr->matSecondPass, this->dataPtr->orthoCam, true);
+  // The second pass materials are shared by the lasers
+  if (this->dataPtr->depthFaces)
+  {
+    // The faces are bound to the samplers of the shared material
+    this->dataPtr->rangeNoise.Apply(
+        this->dataPtr->depthFaces->Material()->getBestTechnique()->getPass(0),
+        this->FarClip());
+    this->UpdateRenderTarget(this->dataPtr->secondPassTarget,
+        this->dataPtr->depthFaces->Material(), this->dataPtr->orthoCam);
+  }
+  else
+  {
+    this->dataPtr->rangeNoise.Apply(
+        this->dataPtr->matSecondPass->getBestTechnique()->getPass(0),
+        this->FarClip());
+    this->UpdateRenderTarget(this->dataPtr->secondPassTarget,
+        this->dataPtr->matSecondPass, this->dataPtr->orthoCam, true);
+  }
   this->dataPtr->secondPassTarget->update(false);
 
   this->dataPtr->visual->SetVisible(false);
@@ -460,6 +524,70 @@ void GpuLaser::RenderImpl()
   this->dataPtr->lastRenderDuration = firstPassDur + secondPassDur;
 }
 
+//////////////////////////////////////////////////
+bool GpuLaser::CreateSharedDepth()
+{
+  for (auto const &request : this->requests)
+  {
+    if (request.request() == "attach_visual")
+      return false;
+  }
+
+  Ogre::SceneNode *parent =
+      dynamic_cast<Ogre::SceneNode *>(this->sceneNode->getParent());
+  if (!parent)
+    return false;
+
+  this->dataPtr->depthFaces = GpuLaserDepthFaces::Acquire(this->scene, parent,
+      Conversions::ConvertIgn(this->sceneNode->getPosition()));
+
+  // Look the rays up in the faces, and keep the canvas out of them
+  this->CreateCanvas();
+  this->dataPtr->visual->SetVisible(false);
+
+  // Keep the texel density of the images the laser would render on its
+  // own, within the memory budget of six faces
+  double tanHalfFov = std::tan(this->CosHorzFOV() / 2.0);
+  unsigned int size = 1024;
+  if (tanHalfFov > 0)
+  {
+    size = static_cast<unsigned int>(ignition::math::clamp(
+        std::round(this->ImageWidth() / tanHalfFov), 256.0, 1024.0));
+  }
+
+  this->dataPtr->depthFaces->AddLaser(this->NearClip(), this->FarClip(), size,
+      this->dataPtr->neededFaces);
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+void GpuLaser::RenderSharedDepth()
+{
+  if (!this->dataPtr->depthFaces->NeedsRender(this->scene->SimTime()))
+    return;
+
+  this->dataPtr->depthFaces->Update();
+  this->dataPtr->currentFarClip = this->dataPtr->depthFaces->FarClip();
+
+  for (unsigned int i = 0; i < GpuLaserDepthFaces::FaceCount; ++i)
+  {
+    Ogre::RenderTarget *target = this->dataPtr->depthFaces->Target(i);
+    if (!target)
+      continue;
+
+    this->dataPtr->currentMat = this->dataPtr->matFirstPass;
+    this->dataPtr->currentTarget = target;
+    this->dataPtr->currentCam = this->dataPtr->depthFaces->FaceCamera(i);
+
+    this->UpdateRenderTarget(target, this->dataPtr->matFirstPass,
+        this->dataPtr->currentCam);
+    target->update(false);
+  }
+
+  this->dataPtr->currentFarClip = this->FarClip();
+}
+
 //////////////////////////////////////////////////
 GpuLaser::DataIter GpuLaser::LaserDataBegin() const
 {
@@ -655,6 +783,14 @@ void GpuLaser::CreateMesh()
     vstep = 0;
   }
 
+  // Orientation of the laser in the frame of the shared depth images
+  ignition::math::Quaterniond rot;
+  if (this->dataPtr->depthFaces)
+  {
+    rot = Conversions::ConvertIgn(this->sceneNode->getOrientation());
+    this->dataPtr->neededFaces.assign(GpuLaserDepthFaces::FaceCount, false);
+  }
+
   for (unsigned int j = 0; j < this->dataPtr->h2nd; ++j)
   {
     double gamma = 0;
@@ -688,6 +824,27 @@ void GpuLaser::CreateMesh()
       }
       ptsOnLine++;
 
+      if (this->dataPtr->depthFaces)
+      {
+        // Direction of the ray, from the minimum horizontal angle
+        double alpha = this->horzHalfAngle - thfov / 2.0 + hstep * i;
+        ignition::math::Vector3d dir = rot.RotateVector(
+            ignition::math::Vector3d(cos(gamma) * cos(alpha),
+            cos(gamma) * sin(alpha), sin(gamma)));
+
+        unsigned int face;
+        double u, v;
+        GpuLaserDepthFaces::Lookup(dir, face, u, v);
+        this->dataPtr->neededFaces[face] = true;
+
+        // face/1000.0 selects the face in the laser_2nd_pass_faces.frag
+        // shader
+        submesh->AddVertex(face/1000.0, startX, startY);
+        submesh->AddTexCoord(u, v);
+        submesh->AddIndex(this->dataPtr->w2nd * j + i);
+        continue;
+      }
+
       // the texture/1000.0 value is used in the laser_2nd_pass.frag shader
       // as a trick to determine which camera texture to use when stitching
       // together the final depth image.
@@ -894,3 +1051,27 @@ event::ConnectionPtr GpuLaser::ConnectNewLaserFrame(
 {
   return this->dataPtr->newLaserFrame.Connect(_subscriber);
 }
+
+//////////////////////////////////////////////////
+void GpuLaser::SetSharedDepth(const bool _enable)
+{
+  this->dataPtr->sharedDepth = _enable;
+}
+
+//////////////////////////////////////////////////
+bool GpuLaser::SharedDepth() const
+{
+  return this->dataPtr->sharedDepth;
+}
+
+//////////////////////////////////////////////////
+void GpuLaser::SetRangeNoise(const DepthNoise &_noise)
+{
+  this->dataPtr->rangeNoise = _noise;
+}
+
+//////////////////////////////////////////////////
+const DepthNoise &GpuLaser::RangeNoise() const
+{
+  return this->dataPtr->rangeNoise;
+}
@@ -24,6 +24,7 @@
 
 #include "gazebo/rendering/ogre_gazebo.h"
 #include "gazebo/rendering/Camera.hh"
+#include "gazebo/rendering/DepthNoise.hh"
 #include "gazebo/rendering/GpuLaserDataIterator.hh"
 #include "gazebo/rendering/RenderTypes.hh"
 #include "gazebo/util/system.hh"
@@ -207,6 +208,30 @@ namespace gazebo
       /// \param[in] _rayCountRatio ray count ratio (equivalent to aspect ratio)
       public: void SetRayCountRatio(const double _rayCountRatio);
 
+      /// \brief Share the depth images with the other lasers mounted at the
+      /// same point of the same visual. The six axis aligned faces around
+      /// that point are rendered once per scene time, and each laser looks
+      /// its rays up in them, instead of rendering its own CameraCount()
+      /// images. Must be set before CreateLaserTexture. The lasers must be
+      /// rigidly mounted, their pose relative to the visual is read when
+      /// they first render.
+      /// \param[in] _enable True to share the depth images.
+      public: void SetSharedDepth(const bool _enable);
+
+      /// \brief Get whether the depth images are shared with the lasers
+      /// mounted at the same point.
+      /// \return True if enabled with SetSharedDepth.
+      public: bool SharedDepth() const;
+
+      /// \brief Set the noise the shader of the second pass adds to the
+      /// ranges, before they are read back.
+      /// \param[in] _noise The noise, disabled by default.
+      public: void SetRangeNoise(const DepthNoise &_noise);
+
+      /// \brief Get the noise added to the ranges.
+      /// \return The noise set with SetRangeNoise.
+      public: const DepthNoise &RangeNoise() const;
+
       // Documentation inherited.
       private: virtual void RenderImpl();
 
@@ -220,6 +245,15 @@ namespace gazebo
                                        Ogre::Camera *_cam,
                                        const bool _updateTex = false);
 
+      /// \brief Join the lasers sharing the depth images, once the laser is
+      /// attached to its visual.
+      /// \return True if the laser has joined.
+      private: bool CreateSharedDepth();
+
+      /// \brief Render the shared depth images, if no other laser did at the
+      /// current scene time.
+      private: void RenderSharedDepth();
+
       /// \brief Create an ortho camera.
       private: void CreateOrthoCam();
 
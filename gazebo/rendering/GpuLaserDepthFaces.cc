@@ -0,0 +1,392 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include "gazebo/rendering/ogre_gazebo.h"
+
+#include "gazebo/common/Assert.hh"
+#include "gazebo/rendering/Conversions.hh"
+#include "gazebo/rendering/Scene.hh"
+#include "gazebo/rendering/GpuLaserDepthFaces.hh"
+
+using namespace gazebo;
+using namespace rendering;
+
+namespace
+{
+  /// \brief Viewing direction of each face.
+  const ignition::math::Vector3d kFaceForward[GpuLaserDepthFaces::FaceCount] =
+  {
+    { 1,  0,  0}, {-1,  0,  0},
+    { 0,  1,  0}, { 0, -1,  0},
+    { 0,  0,  1}, { 0,  0, -1}
+  };
+
+  /// \brief Up direction of each face.
+  const ignition::math::Vector3d kFaceUp[GpuLaserDepthFaces::FaceCount] =
+  {
+    { 0,  0,  1}, { 0,  0,  1},
+    { 0,  0,  1}, { 0,  0,  1},
+    {-1,  0,  0}, { 1,  0,  0}
+  };
+
+  /// \brief Faces shared by the lasers at a point, by scene, scene node and
+  /// position.
+  std::map<std::string, std::weak_ptr<GpuLaserDepthFaces>> gFaces;
+
+  /// \brief Number of faces created, used to name their resources.
+  unsigned int gFacesCount = 0;
+}
+
+namespace gazebo
+{
+  namespace rendering
+  {
+    /// \internal
+    /// \brief Private data for the GpuLaserDepthFaces class
+    class GpuLaserDepthFacesPrivate
+    {
+      /// \brief Scene of the lasers.
+      public: ScenePtr scene;
+
+      /// \brief Prefix of the resource names.
+      public: std::string name;
+
+      /// \brief Scene node at the position of the lasers, aligned with the
+      /// parent visual.
+      public: Ogre::SceneNode *node = nullptr;
+
+      /// \brief Camera of each face.
+      public: Ogre::Camera *cameras[GpuLaserDepthFaces::FaceCount];
+
+      /// \brief Texture of each face, null until a laser needs it.
+      public: Ogre::Texture *textures[GpuLaserDepthFaces::FaceCount];
+
+      /// \brief Render target of each face.
+      public: Ogre::RenderTarget *targets[GpuLaserDepthFaces::FaceCount];
+
+      /// \brief True for the faces some laser samples.
+      public: std::vector<bool> needed =
+          std::vector<bool>(GpuLaserDepthFaces::FaceCount, false);
+
+      /// \brief Second pass material sampling the faces.
+      public: Ogre::MaterialPtr material;
+
+      /// \brief Size of the faces in pixels.
+      public: unsigned int size = 0;
+
+      /// \brief Near clip distance.
+      public: double nearClip = 0;
+
+      /// \brief Far clip distance.
+      public: double farClip = 0;
+
+      /// \brief Number of textures created, used to name them.
+      public: unsigned int generation = 0;
+
+      /// \brief Scene time of the last render.
+      public: common::Time renderTime;
+
+      /// \brief True once the faces were rendered.
+      public: bool rendered = false;
+    };
+  }
+}
+
+//////////////////////////////////////////////////
+GpuLaserDepthFaces::GpuLaserDepthFaces(ScenePtr _scene,
+    Ogre::SceneNode *_parent, const ignition::math::Vector3d &_pos)
+  : dataPtr(new GpuLaserDepthFacesPrivate)
+{
+  this->dataPtr->scene = _scene;
+
+  std::ostringstream name;
+  name << "GpuLaserDepthFaces_" << gFacesCount++;
+  this->dataPtr->name = name.str();
+
+  this->dataPtr->node = _parent->createChildSceneNode(
+      this->dataPtr->name + "_node", Conversions::Convert(_pos));
+
+  for (unsigned int i = 0; i < FaceCount; ++i)
+  {
+    std::ostringstream camName;
+    camName << this->dataPtr->name << "_camera_" << i;
+    Ogre::Camera *camera =
+        _scene->OgreSceneManager()->createCamera(camName.str());
+
+    // Ogre cameras look down -Z, with +Y up
+    const ignition::math::Vector3d &forward = kFaceForward[i];
+    const ignition::math::Vector3d &up = kFaceUp[i];
+    ignition::math::Vector3d right = forward.Cross(up);
+    camera->setOrientation(Ogre::Quaternion(Conversions::Convert(right),
+        Conversions::Convert(up), Conversions::Convert(-forward)));
+    camera->setFOVy(Ogre::Degree(90));
+    camera->setAspectRatio(1.0);
+    this->dataPtr->node->attachObject(camera);
+
+    this->dataPtr->cameras[i] = camera;
+    this->dataPtr->textures[i] = nullptr;
+    this->dataPtr->targets[i] = nullptr;
+  }
+
+  Ogre::MaterialPtr material = Ogre::MaterialManager::getSingleton().getByName(
+      "Gazebo/LaserScan2ndFaces");
+  GZ_ASSERT(!material.isNull(),
+      "GpuLaser material script error: Gazebo/LaserScan2ndFaces not found");
+  material->load();
+  this->dataPtr->material =
+      material->clone(this->dataPtr->name + "_LaserScan2ndFaces");
+}
+
+//////////////////////////////////////////////////
+GpuLaserDepthFaces::~GpuLaserDepthFaces()
+{
+  for (unsigned int i = 0; i < FaceCount; ++i)
+  {
+    if (this->dataPtr->textures[i])
+    {
+      Ogre::TextureManager::getSingleton().remove(
+          this->dataPtr->textures[i]->getName());
+    }
+    this->dataPtr->scene->OgreSceneManager()->destroyCamera(
+        this->dataPtr->cameras[i]);
+  }
+
+  if (!this->dataPtr->material.isNull())
+  {
+    Ogre::MaterialManager::getSingleton().remove(
+        this->dataPtr->material->getName());
+  }
+
+  this->dataPtr->scene->OgreSceneManager()->destroySceneNode(
+      this->dataPtr->node);
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<GpuLaserDepthFaces> GpuLaserDepthFaces::Acquire(
+    ScenePtr _scene, Ogre::SceneNode *_parent,
+    const ignition::math::Vector3d &_pos)
+{
+  // Lasers within a millimeter of each other share the faces
+  std::ostringstream key;
+  key << _scene->Name() << "/" << _parent->getName() << "/"
+      << std::lround(_pos.X() * 1000) << "/"
+      << std::lround(_pos.Y() * 1000) << "/"
+      << std::lround(_pos.Z() * 1000);
+
+  std::shared_ptr<GpuLaserDepthFaces> faces = gFaces[key.str()].lock();
+  if (!faces)
+  {
+    faces.reset(new GpuLaserDepthFaces(_scene, _parent, _pos));
+    gFaces[key.str()] = faces;
+  }
+
+  // Drop the faces no laser uses anymore
+  for (auto iter = gFaces.begin(); iter != gFaces.end();)
+  {
+    if (iter->second.expired())
+      iter = gFaces.erase(iter);
+    else
+      ++iter;
+  }
+
+  return faces;
+}
+
+//////////////////////////////////////////////////
+void GpuLaserDepthFaces::Lookup(const ignition::math::Vector3d &_dir,
+    unsigned int &_face, double &_u, double &_v)
+{
+  const ignition::math::Vector3d abs = _dir.Abs();
+  if (abs.X() >= abs.Y() && abs.X() >= abs.Z())
+    _face = _dir.X() >= 0 ? 0 : 1;
+  else if (abs.Y() >= abs.Z())
+    _face = _dir.Y() >= 0 ? 2 : 3;
+  else
+    _face = _dir.Z() >= 0 ? 4 : 5;
+
+  const ignition::math::Vector3d &forward = kFaceForward[_face];
+  const ignition::math::Vector3d &up = kFaceUp[_face];
+  const ignition::math::Vector3d right = forward.Cross(up);
+
+  // Project on the image plane, at distance 1 with a 90 degree fov
+  double depth = _dir.Dot(forward);
+  _u = 0.5 + 0.5 * _dir.Dot(right) / depth;
+  _v = 0.5 - 0.5 * _dir.Dot(up) / depth;
+}
+
+//////////////////////////////////////////////////
+void GpuLaserDepthFaces::AddLaser(const double _near, const double _far,
+    const unsigned int _size, const std::vector<bool> &_faces)
+{
+  if (this->dataPtr->size == 0)
+  {
+    this->dataPtr->nearClip = _near;
+    this->dataPtr->farClip = _far;
+  }
+  else
+  {
+    this->dataPtr->nearClip = std::min(this->dataPtr->nearClip, _near);
+    this->dataPtr->farClip = std::max(this->dataPtr->farClip, _far);
+  }
+  this->dataPtr->size = std::max(this->dataPtr->size, _size);
+
+  for (unsigned int i = 0; i < FaceCount && i < _faces.size(); ++i)
+    this->dataPtr->needed[i] = this->dataPtr->needed[i] || _faces[i];
+
+  for (unsigned int i = 0; i < FaceCount; ++i)
+  {
+    this->dataPtr->cameras[i]->setNearClipDistance(this->dataPtr->nearClip);
+    this->dataPtr->cameras[i]->setFarClipDistance(this->dataPtr->farClip);
+    if (this->dataPtr->targets[i])
+    {
+      this->dataPtr->targets[i]->getViewport(0)->setBackgroundColour(
+          Ogre::ColourValue(this->dataPtr->farClip, 0.0, 1.0));
+    }
+  }
+
+  // Render with the new requirements
+  this->dataPtr->rendered = false;
+}
+
+//////////////////////////////////////////////////
+bool GpuLaserDepthFaces::NeedsRender(const common::Time &_time)
+{
+  if (this->dataPtr->rendered && this->dataPtr->renderTime == _time)
+    return false;
+
+  this->dataPtr->rendered = true;
+  this->dataPtr->renderTime = _time;
+  return true;
+}
+
+//////////////////////////////////////////////////
+void GpuLaserDepthFaces::Update()
+{
+  bool changed = false;
+  for (unsigned int i = 0; i < FaceCount; ++i)
+  {
+    if (!this->dataPtr->needed[i])
+      continue;
+
+    Ogre::Texture *texture = this->dataPtr->textures[i];
+    if (texture && texture->getWidth() == this->dataPtr->size)
+      continue;
+
+    // A laser asked for larger faces, or a new face
+    if (texture)
+      Ogre::TextureManager::getSingleton().remove(texture->getName());
+
+    std::ostringstream texName;
+    texName << this->dataPtr->name << "_face_" << i << "_"
+        << this->dataPtr->generation++;
+    texture = Ogre::TextureManager::getSingleton().createManual(
+        texName.str(), "General", Ogre::TEX_TYPE_2D,
+        this->dataPtr->size, this->dataPtr->size, 0,
+        Ogre::PF_FLOAT32_RGB, Ogre::TU_RENDERTARGET).getPointer();
+
+    Ogre::RenderTarget *target = texture->getBuffer()->getRenderTarget();
+    target->setAutoUpdated(false);
+
+    Ogre::Viewport *viewport = target->addViewport(this->dataPtr->cameras[i]);
+    viewport->setClearEveryFrame(true);
+    viewport->setOverlaysEnabled(false);
+    viewport->setShadowsEnabled(false);
+    viewport->setSkiesEnabled(false);
+    viewport->setBackgroundColour(
+        Ogre::ColourValue(this->dataPtr->farClip, 0.0, 1.0));
+    viewport->setVisibilityMask(
+        GZ_VISIBILITY_ALL & ~(GZ_VISIBILITY_GUI | GZ_VISIBILITY_SELECTABLE));
+
+    this->dataPtr->textures[i] = texture;
+    this->dataPtr->targets[i] = target;
+    changed = true;
+  }
+
+  if (!changed)
+    return;
+
+  // Bind the faces to the samplers of the second pass
+  Ogre::Technique *technique = this->dataPtr->material->getTechnique(0);
+  GZ_ASSERT(technique, "GpuLaser material script error: technique not found");
+
+  Ogre::Pass *pass = technique->getPass(0);
+  GZ_ASSERT(pass, "GpuLaser material script error: pass not found");
+
+  pass->removeAllTextureUnitStates();
+
+  int unit = 0;
+  for (unsigned int i = 0; i < FaceCount; ++i)
+  {
+    std::ostringstream sampler;
+    sampler << "tex" << i + 1;
+
+    if (!this->dataPtr->textures[i])
+    {
+      pass->getFragmentProgramParameters()->setNamedConstant(
+          sampler.str(), 0);
+      continue;
+    }
+
+    Ogre::TextureUnitState *texUnit = pass->createTextureUnitState(
+        this->dataPtr->textures[i]->getName());
+    texUnit->setTextureFiltering(Ogre::TFO_NONE);
+    texUnit->setTextureAddressingMode(Ogre::TextureUnitState::TAM_CLAMP);
+
+    pass->getFragmentProgramParameters()->setNamedConstant(
+        sampler.str(), unit++);
+  }
+}
+
+//////////////////////////////////////////////////
+Ogre::RenderTarget *GpuLaserDepthFaces::Target(const unsigned int _face) const
+{
+  if (_face >= FaceCount)
+    return nullptr;
+  return this->dataPtr->targets[_face];
+}
+
+//////////////////////////////////////////////////
+Ogre::Camera *GpuLaserDepthFaces::FaceCamera(const unsigned int _face) const
+{
+  if (_face >= FaceCount)
+    return nullptr;
+  return this->dataPtr->cameras[_face];
+}
+
+//////////////////////////////////////////////////
+Ogre::Material *GpuLaserDepthFaces::Material() const
+{
+  return this->dataPtr->material.get();
+}
+
+//////////////////////////////////////////////////
+double GpuLaserDepthFaces::FarClip() const
+{
+  return this->dataPtr->farClip;
+}
+
+//////////////////////////////////////////////////
+unsigned int GpuLaserDepthFaces::Size() const
+{
+  return this->dataPtr->size;
+}
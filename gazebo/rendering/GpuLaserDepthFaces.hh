@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_RENDERING_GPULASERDEPTHFACES_HH_
+#define GAZEBO_RENDERING_GPULASERDEPTHFACES_HH_
+
+#include <memory>
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/rendering/RenderTypes.hh"
+
+namespace Ogre
+{
+  class Camera;
+  class Material;
+  class RenderTarget;
+  class SceneNode;
+}
+
+namespace gazebo
+{
+  namespace rendering
+  {
+    // Forward declare private data class.
+    class GpuLaserDepthFacesPrivate;
+
+    /// \internal
+    /// \brief Range images of the six axis aligned faces of a cube,
+    /// shared by the GPU lasers mounted at the same point of a visual.
+    /// The faces are rendered once per scene time, by the first laser that
+    /// renders, and each laser looks its rays up in them in its second
+    /// pass. Only the faces that some laser needs are rendered.
+    /// Faces are ordered +X, -X, +Y, -Y, +Z, -Z, in the frame of the
+    /// visual.
+    class GpuLaserDepthFaces
+    {
+      /// \brief Number of faces.
+      public: static const unsigned int FaceCount = 6;
+
+      /// \brief Constructor.
+      /// \param[in] _scene Scene of the lasers.
+      /// \param[in] _parent Scene node the lasers are attached to.
+      /// \param[in] _pos Position of the lasers relative to _parent.
+      public: GpuLaserDepthFaces(ScenePtr _scene, Ogre::SceneNode *_parent,
+                  const ignition::math::Vector3d &_pos);
+
+      /// \brief Destructor, destroys the cameras and textures.
+      public: ~GpuLaserDepthFaces();
+
+      /// \brief Get the faces shared by the lasers mounted at a point,
+      /// creating them if there are none.
+      /// \param[in] _scene Scene of the lasers.
+      /// \param[in] _parent Scene node the lasers are attached to.
+      /// \param[in] _pos Position of the lasers relative to _parent.
+      /// \return The shared faces.
+      public: static std::shared_ptr<GpuLaserDepthFaces> Acquire(
+                  ScenePtr _scene, Ogre::SceneNode *_parent,
+                  const ignition::math::Vector3d &_pos);
+
+      /// \brief Get the face and texture coordinates a direction is
+      /// rendered to.
+      /// \param[in] _dir Direction in the frame of the parent visual.
+      /// \param[out] _face Index of the face.
+      /// \param[out] _u Horizontal texture coordinate, 0 on the left.
+      /// \param[out] _v Vertical texture coordinate, 0 on the top.
+      public: static void Lookup(const ignition::math::Vector3d &_dir,
+                  unsigned int &_face, double &_u, double &_v);
+
+      /// \brief Add the requirements of a laser. The clip distances cover
+      /// every laser, and the faces have the largest size requested.
+      /// \param[in] _near Near clip distance of the laser.
+      /// \param[in] _far Far clip distance of the laser.
+      /// \param[in] _size Size of the faces in pixels.
+      /// \param[in] _faces Faces the laser samples, FaceCount entries.
+      public: void AddLaser(const double _near, const double _far,
+                  const unsigned int _size, const std::vector<bool> &_faces);
+
+      /// \brief Get whether the faces must be rendered for a scene time,
+      /// and mark them rendered for that time.
+      /// \param[in] _time Scene time of the render.
+      /// \return False if the faces were already rendered at _time.
+      public: bool NeedsRender(const common::Time &_time);
+
+      /// \brief Create or resize the textures of the needed faces.
+      public: void Update();
+
+      /// \brief Get the render target of a face.
+      /// \param[in] _face Index of the face.
+      /// \return The render target, null if no laser needs the face.
+      public: Ogre::RenderTarget *Target(const unsigned int _face) const;
+
+      /// \brief Get the camera of a face.
+      /// \param[in] _face Index of the face.
+      /// \return The camera.
+      public: Ogre::Camera *FaceCamera(const unsigned int _face) const;
+
+      /// \brief Get the second pass material sampling the faces.
+      /// \return The material.
+      public: Ogre::Material *Material() const;
+
+      /// \brief Get the far clip distance of the faces.
+      /// \return The largest far clip distance of the lasers.
+      public: double FarClip() const;
+
+      /// \brief Get the size of the faces.
+      /// \return Size in pixels.
+      public: unsigned int Size() const;
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<GpuLaserDepthFacesPrivate> dataPtr;
+    };
+  }
+}
+#endif
@@ -18,10 +18,13 @@
 #ifndef _GAZEBO_RENDERING_GPULASER_PRIVATE_HH_
 #define _GAZEBO_RENDERING_GPULASER_PRIVATE_HH_
 
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "gazebo/rendering/DepthNoise.hh"
 #include "gazebo/rendering/RenderTypes.hh"
+#include "gazebo/rendering/TextureReadback.hh"
 
 #include "gazebo/common/Event.hh"
 
@@ -45,6 +48,8 @@ namespace gazebo
 
   namespace rendering
   {
+    class GpuLaserDepthFaces;
+
     /// \internal
     /// \brief Private data for the GpuLaser class
     class GpuLaserPrivate
@@ -62,6 +67,9 @@ namespace gazebo
       /// \brief Raw buffer of laser data.
       public: float *laserBuffer;
 
+      /// \brief Asynchronous readback of the second pass texture.
+      public: TextureReadback laserReadback;
+
       /// \brief Outgoing laser data, used by newLaserFrame event.
       public: float *laserScan;
 
@@ -101,6 +109,26 @@ namespace gazebo
       /// \brief Temporary pointer to the current material.
       public: Ogre::Material *currentMat;
 
+      /// \brief Temporary pointer to the camera rendering the current target.
+      public: Ogre::Camera *currentCam = nullptr;
+
+      /// \brief Far clip distance of the current render.
+      public: double currentFarClip = 0;
+
+      /// \brief True to share the depth images with the lasers mounted at
+      /// the same point.
+      public: bool sharedDepth = false;
+
+      /// \brief Depth images shared with the lasers mounted at the same
+      /// point, null until the laser is attached to its visual.
+      public: std::shared_ptr<GpuLaserDepthFaces> depthFaces;
+
+      /// \brief Noise added to the ranges by the second pass.
+      public: DepthNoise rangeNoise;
+
+      /// \brief Faces of depthFaces sampled by this laser.
+      public: std::vector<bool> neededFaces;
+
       /// \brief Ogre orthorgraphic camera used in the second pass for
       /// undistortion.
       public: Ogre::Camera *orthoCam;
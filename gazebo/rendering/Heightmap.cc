@@ -40,6 +40,7 @@
 #include "gazebo/rendering/Conversions.hh"
 #include "gazebo/rendering/UserCamera.hh"
 #include "gazebo/rendering/RenderEngine.hh"
+#include "gazebo/rendering/ShadowCache.hh"
 
 #include "gazebo/rendering/Heightmap.hh"
 #include "gazebo/rendering/HeightmapPrivate.hh"
@@ -54,8 +55,8 @@ using Ogre::RENDER_COMPOSITE_MAP;
 using Ogre::LOW_LOD;
 #endif
 
-const double HeightmapPrivate::loadRadiusFactor = 1.0;
-const double HeightmapPrivate::holdRadiusFactor = 1.15;
+const double HeightmapPrivate::loadRadiusFactor = 2.0;
+const double HeightmapPrivate::holdRadiusFactor = 2.3;
 const boost::filesystem::path HeightmapPrivate::pagingDirname = "paging";
 const boost::filesystem::path HeightmapPrivate::hashFilename = "gzterrain.SHA1";
 
@@ -85,6 +86,7 @@ Heightmap::Heightmap(ScenePtr _scene)
 //////////////////////////////////////////////////
 Heightmap::~Heightmap()
 {
+  this->dataPtr->pagingConnection.reset();
   this->dataPtr->scene.reset();
 
   if (this->dataPtr->terrainPaging)
@@ -174,6 +176,9 @@ void Heightmap::LoadFromMsg(ConstVisualPtr &_msg)
     }
   }
 
+  if (_msg->geometry().heightmap().has_dem_level())
+    this->dataPtr->demLevel = _msg->geometry().heightmap().dem_level();
+
   this->SetCastShadows(_msg->cast_shadows());
 
   this->Load();
@@ -408,6 +413,10 @@ void Heightmap::Load()
           dynamic_cast<common::Dem *>(this->dataPtr->heightmapData);
       if (demData)
       {
+        // Only the selected level is read from the DEM cache
+        if (this->dataPtr->demLevel > 0)
+          demData->SetLevel(this->dataPtr->demLevel);
+
         heightmapSizeZ = heightmapSizeZ - demData->GetMinElevation();
         if (this->dataPtr->terrainSize == ignition::math::Vector3d::Zero)
         {
@@ -434,17 +443,24 @@ void Heightmap::Load()
       else
         scale.Z(fabs(this->dataPtr->terrainSize.Z()) / heightmapSizeZ);
 
-      // Construct the heightmap lookup table
-      std::vector<float> lookup;
-      this->dataPtr->heightmapData->FillHeightMap(this->dataPtr->sampling,
-          vertSize, this->dataPtr->terrainSize, scale, flipY, lookup);
-
+      // Get the heightmap lookup table, which is shared with the physics
+      // heightmap of the terrain in this process. Ogre copies the heights,
+      // so their own order and offset are kept only until the terrains are
+      // loaded.
+      std::shared_ptr<const std::vector<float>> lookup =
+          common::HeightmapCache::Heights(this->dataPtr->filename,
+          this->dataPtr->demLevel, *this->dataPtr->heightmapData,
+          this->dataPtr->sampling, vertSize, this->dataPtr->terrainSize,
+          scale, flipY);
+
+      this->dataPtr->heights.reserve(
+          static_cast<size_t>(vertSize) * vertSize);
       for (unsigned int y = 0; y < vertSize; ++y)
       {
         for (unsigned int x = 0; x < vertSize; ++x)
         {
           int index = (vertSize - y - 1) * vertSize + x;
-          this->dataPtr->heights.push_back(lookup[index] - minElevation);
+          this->dataPtr->heights.push_back((*lookup)[index] - minElevation);
         }
       }
 
@@ -607,41 +623,55 @@ void Heightmap::Load()
     this->dataPtr->pageManager->setPageProvider(
         &this->dataPtr->dummyPageProvider);
 
-    // Add cameras
-    for (unsigned int i = 0; i < this->dataPtr->scene->CameraCount(); ++i)
-    {
-      this->dataPtr->pageManager->addCamera(
-          this->dataPtr->scene->GetCamera(i)->OgreCamera());
-    }
-    for (unsigned int i = 0; i < this->dataPtr->scene->UserCameraCount();
-        ++i)
-    {
-      this->dataPtr->pageManager->addCamera(
-          this->dataPtr->scene->GetUserCamera(i)->OgreCamera());
-    }
+    // Add cameras, and the ones created after the heightmap
+    this->AddPagingCameras();
+    this->dataPtr->pagingConnection = event::Events::ConnectPreRender(
+        std::bind(&Heightmap::AddPagingCameras, this));
 
+    // The radii are relative to the size of a page, so that only the pages
+    // around the cameras are loaded
+    double pageSize = this->dataPtr->terrainSize.X() / sqrtN;
     this->dataPtr->terrainPaging =
         OGRE_NEW Ogre::TerrainPaging(this->dataPtr->pageManager);
     this->dataPtr->world = this->dataPtr->pageManager->createWorld();
     this->dataPtr->terrainPaging->createWorldSection(
         this->dataPtr->world, this->dataPtr->terrainGroup,
-        this->dataPtr->loadRadiusFactor * this->dataPtr->terrainSize.X(),
-        this->dataPtr->holdRadiusFactor * this->dataPtr->terrainSize.X(),
+        this->dataPtr->loadRadiusFactor * pageSize,
+        this->dataPtr->holdRadiusFactor * pageSize,
         0, 0, sqrtN - 1, sqrtN - 1);
   }
 
   gzmsg << "Loading heightmap: " << terrainName.string() << std::endl;
   common::Time time = common::Time::GetWallTime();
 
-  for (int y = 0; y <= sqrtN - 1; ++y)
-    for (int x = 0; x <= sqrtN - 1; ++x)
-      this->DefineTerrain(x, y);
-
   // use gazebo shaders
   this->CreateMaterial();
 
-  // Sync load since we want everything in place when we start
-  this->dataPtr->terrainGroup->loadAllTerrains(true);
+  if (this->dataPtr->useTerrainPaging && this->PagesCached(sqrtN))
+  {
+    // The pager loads the cached pages around the cameras in the
+    // background, and unloads the ones out of the hold radius.
+    gzmsg << "Streaming heightmap cache data from "
+          << terrainDirPath.string() << std::endl;
+    this->dataPtr->terrainsImported = false;
+  }
+  else
+  {
+    for (int y = 0; y <= sqrtN - 1; ++y)
+      for (int x = 0; x <= sqrtN - 1; ++x)
+        this->DefineTerrain(x, y);
+
+    // Sync load since we want everything in place when we start
+    this->dataPtr->terrainGroup->loadAllTerrains(true);
+  }
+
+  // The terrains keep a copy of their heights, and paged terrains are
+  // reloaded from the cache.
+  if (this->dataPtr->useTerrainPaging)
+  {
+    std::vector<float>().swap(this->dataPtr->heights);
+    std::vector<std::vector<float> >().swap(this->dataPtr->subTerrains);
+  }
 
   gzmsg << "Heightmap loaded. Process took: "
         <<  (common::Time::GetWallTime() - time).Double()
@@ -869,6 +899,48 @@ void Heightmap::DefineTerrain(const int _x, const int _y)
   }
 }
 
+//////////////////////////////////////////////////
+bool Heightmap::PagesCached(const int _sqrtN) const
+{
+  if (this->dataPtr->terrainHashChanged)
+    return false;
+
+  for (int y = 0; y < _sqrtN; ++y)
+  {
+    for (int x = 0; x < _sqrtN; ++x)
+    {
+      if (!Ogre::ResourceGroupManager::getSingleton().resourceExists(
+          this->dataPtr->terrainGroup->getResourceGroup(),
+          this->dataPtr->terrainGroup->generateFilename(x, y)))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+void Heightmap::AddPagingCameras()
+{
+  if (!this->dataPtr->pageManager || !this->dataPtr->scene)
+    return;
+
+  for (unsigned int i = 0; i < this->dataPtr->scene->CameraCount(); ++i)
+  {
+    Ogre::Camera *camera = this->dataPtr->scene->GetCamera(i)->OgreCamera();
+    if (camera && !this->dataPtr->pageManager->hasCamera(camera))
+      this->dataPtr->pageManager->addCamera(camera);
+  }
+  for (unsigned int i = 0; i < this->dataPtr->scene->UserCameraCount(); ++i)
+  {
+    Ogre::Camera *camera =
+        this->dataPtr->scene->GetUserCamera(i)->OgreCamera();
+    if (camera && !this->dataPtr->pageManager->hasCamera(camera))
+      this->dataPtr->pageManager->addCamera(camera);
+  }
+}
+
 /////////////////////////////////////////////////
 bool Heightmap::InitBlendMaps(Ogre::Terrain *_terrain)
 {
@@ -1153,6 +1225,10 @@ void Heightmap::ModifyTerrain(Ogre::Vector3 _pos, const double _outsideRadius,
   }
   terrain->dirty();
   terrain->update();
+
+  // The terrain is not seen by the shadow cache
+  if (this->dataPtr->scene && this->dataPtr->scene->Shadows())
+    this->dataPtr->scene->Shadows()->Invalidate();
 }
 
 /////////////////////////////////////////////////
@@ -273,6 +273,16 @@ namespace gazebo
       /// \brief Save the heightmap tiles to disk
       private: void SaveHeightmap();
 
+      /// \brief Check if every page of the terrain can be loaded from the
+      /// cache, so that the pages can be streamed instead of defined upfront.
+      /// \param[in] _sqrtN Number of pages along each side of the terrain.
+      /// \return True if the hash matches and all the page files exist.
+      private: bool PagesCached(const int _sqrtN) const;
+
+      /// \brief Add the cameras of the scene that are not paging the
+      /// terrain yet to the page manager.
+      private: void AddPagingCameras();
+
       /// \internal
       /// \brief Pointer to private data.
       private: std::unique_ptr<HeightmapPrivate> dataPtr;
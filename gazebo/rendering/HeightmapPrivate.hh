@@ -360,15 +360,15 @@ namespace gazebo
     {
       /// \brief The terrain pages are loaded if the distance from the camera is
       /// within the loadRadius. See Ogre::TerrainPaging::createWorldSection().
-      /// LoadRadiusFactor is a multiplier applied to the terrain size to create
-      /// a load radius that depends on the terrain size.
+      /// LoadRadiusFactor is a multiplier applied to the size of a page to
+      /// create a load radius that depends on the page size.
       public: static const double loadRadiusFactor;
 
       /// \brief The terrain pages are held in memory but not loaded if they
       /// are not ready when the camera is within holdRadius distance. See
       /// Ogre::TerrainPaging::createWorldSection(). HoldRadiusFactor is a
-      /// multiplier applied to the terrain size to create a hold radius that
-      /// depends on the terrain size.
+      /// multiplier applied to the size of a page to create a hold radius
+      /// that depends on the page size.
       public: static const double holdRadiusFactor;
 
       /// \brief Hash file name that should be present for every terrain file
@@ -466,6 +466,9 @@ namespace gazebo
       /// \brief Number of samples per heightmap datum
       public: unsigned int sampling = 2u;
 
+      /// \brief Resolution level of a DEM, 0 is the full resolution.
+      public: unsigned int demLevel = 0u;
+
       /// \brief Max pixel error allowed for rendering the heightmap. This
       /// affects the transitions between LOD levels.
       public: double maxPixelError = 0.0;
@@ -485,6 +488,10 @@ namespace gazebo
 
       /// \brief Event connections
       public: std::vector<event::ConnectionPtr> connections;
+
+      /// \brief Connection that adds new cameras to the page manager. Kept
+      /// apart from connections, which is cleared once the cache is saved.
+      public: event::ConnectionPtr pagingConnection;
     };
   }
 }
@@ -0,0 +1,293 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "gazebo/rendering/ogre_gazebo.h"
+#include <OGRE/OgreInstanceManager.h>
+#include <OGRE/OgreInstancedEntity.h>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/rendering/InstancedVisuals.hh"
+
+using namespace gazebo;
+using namespace rendering;
+
+namespace
+{
+  /// \brief Number of instances per batch.
+  const size_t kInstancesPerBatch = 256;
+
+  /// \brief Number of lights the instancing programs handle.
+  const unsigned short kMaxLights = 4;
+
+  /// \brief Number of instancing managers and materials created, used to
+  /// name them.
+  unsigned int gInstancedCount = 0;
+
+  /// \brief Get whether vertices have one set of texture coordinates and
+  /// normals, so that the instance data follows the texture coordinates
+  /// the programs read.
+  /// \param[in] _data The vertices.
+  /// \return True if the vertices can be instanced.
+  bool InstanceableVertices(const Ogre::VertexData *_data)
+  {
+    if (!_data)
+      return false;
+
+    unsigned int texCoords = 0;
+    bool normals = false;
+    const Ogre::VertexDeclaration::VertexElementList &elements =
+        _data->vertexDeclaration->getElements();
+    for (auto const &element : elements)
+    {
+      if (element.getSemantic() == Ogre::VES_TEXTURE_COORDINATES)
+        ++texCoords;
+      else if (element.getSemantic() == Ogre::VES_NORMAL)
+        normals = true;
+    }
+    return texCoords == 1 && normals;
+  }
+}
+
+namespace gazebo
+{
+  namespace rendering
+  {
+    /// \internal
+    /// \brief Private data for the InstancedVisuals class
+    class InstancedVisualsPrivate
+    {
+      /// \brief Get the instancing material for the appearance of a
+      /// material, creating it if needed.
+      /// \param[in] _material The material of a sub entity.
+      /// \return Name of the instancing material, empty if the material
+      /// can't be instanced.
+      public: std::string Material(const Ogre::MaterialPtr &_material)
+      {
+        if (_material.isNull() || _material->getNumTechniques() == 0)
+          return std::string();
+
+        // Techniques generated for other schemes are dropped, the
+        // instancing programs replace them
+        Ogre::Technique *technique = _material->getTechnique(0);
+        if (technique->getSchemeName() !=
+            Ogre::MaterialManager::DEFAULT_SCHEME_NAME ||
+            technique->getNumPasses() != 1)
+        {
+          return std::string();
+        }
+
+        Ogre::Pass *pass = technique->getPass(0);
+        if (pass->hasVertexProgram() || pass->hasFragmentProgram() ||
+            pass->isTransparent() || !pass->getLightingEnabled() ||
+            pass->getPolygonMode() != Ogre::PM_SOLID ||
+            pass->getNumTextureUnitStates() > 1)
+        {
+          return std::string();
+        }
+
+        std::string texture;
+        if (pass->getNumTextureUnitStates() == 1)
+        {
+          texture = pass->getTextureUnitState(0)->getTextureName();
+          if (texture.empty())
+            return std::string();
+        }
+
+        // Materials are cloned per visual, so they are grouped by
+        // appearance rather than by name
+        std::ostringstream key;
+        key << pass->getAmbient() << " " << pass->getDiffuse() << " "
+            << pass->getSpecular() << " " << pass->getSelfIllumination()
+            << " " << pass->getShininess() << " "
+            << pass->getCullingMode() << " " << texture;
+
+        auto iter = this->materials.find(key.str());
+        if (iter != this->materials.end())
+          return iter->second;
+
+        std::string name = "__GZ_INSTANCED_MATERIAL_" +
+            std::to_string(gInstancedCount++);
+        Ogre::MaterialPtr instanced = _material->clone(name);
+        while (instanced->getNumTechniques() > 1)
+          instanced->removeTechnique(1);
+
+        Ogre::Pass *instancedPass = instanced->getTechnique(0)->getPass(0);
+        instancedPass->setMaxSimultaneousLights(kMaxLights);
+        instancedPass->setVertexProgram("Gazebo/InstancedVP");
+        instancedPass->setFragmentProgram(texture.empty() ?
+            "Gazebo/InstancedFP" : "Gazebo/InstancedTexturedFP");
+        instanced->load();
+
+        this->materials[key.str()] = name;
+        return name;
+      }
+
+      /// \brief Get the instance manager of a sub mesh, creating it if
+      /// needed.
+      /// \param[in] _mesh The mesh.
+      /// \param[in] _subMesh Index of the sub mesh.
+      /// \return The manager.
+      public: Ogre::InstanceManager *Manager(const Ogre::MeshPtr &_mesh,
+                  const unsigned short _subMesh)
+      {
+        auto key = std::make_pair(_mesh->getName(), _subMesh);
+        auto iter = this->managers.find(key);
+        if (iter != this->managers.end())
+          return iter->second;
+
+        Ogre::InstanceManager *instanceManager =
+            this->manager->createInstanceManager(
+            "__GZ_INSTANCE_MANAGER_" + std::to_string(gInstancedCount++),
+            _mesh->getName(), _mesh->getGroup(),
+            Ogre::InstanceManager::HWInstancingBasic, kInstancesPerBatch,
+            Ogre::IM_USEALL, _subMesh);
+        this->managers[key] = instanceManager;
+        return instanceManager;
+      }
+
+      /// \brief Scene manager of the scene.
+      public: Ogre::SceneManager *manager = nullptr;
+
+      /// \brief True if instancing is supported.
+      public: bool supported = false;
+
+      /// \brief Instance managers, by mesh name and sub mesh index.
+      public: std::map<std::pair<std::string, unsigned short>,
+              Ogre::InstanceManager *> managers;
+
+      /// \brief Instancing material names, by appearance.
+      public: std::map<std::string, std::string> materials;
+
+      /// \brief Number of instanced entities.
+      public: unsigned int instanceCount = 0;
+    };
+  }
+}
+
+//////////////////////////////////////////////////
+InstancedVisuals::InstancedVisuals(Ogre::SceneManager *_manager)
+  : dataPtr(new InstancedVisualsPrivate)
+{
+  this->dataPtr->manager = _manager;
+
+  Ogre::RenderSystem *renderSys = Ogre::Root::getSingleton().getRenderSystem();
+  this->dataPtr->supported = _manager && renderSys &&
+      renderSys->getCapabilities()->hasCapability(
+      Ogre::RSC_VERTEX_BUFFER_INSTANCE_DATA) &&
+      Ogre::HighLevelGpuProgramManager::getSingleton().resourceExists(
+      "Gazebo/InstancedVP");
+}
+
+//////////////////////////////////////////////////
+InstancedVisuals::~InstancedVisuals()
+{
+  for (auto &manager : this->dataPtr->managers)
+    this->dataPtr->manager->destroyInstanceManager(manager.second);
+  this->dataPtr->managers.clear();
+
+  for (auto &material : this->dataPtr->materials)
+    Ogre::MaterialManager::getSingleton().remove(material.second);
+  this->dataPtr->materials.clear();
+}
+
+//////////////////////////////////////////////////
+bool InstancedVisuals::Supported() const
+{
+  return this->dataPtr->supported;
+}
+
+//////////////////////////////////////////////////
+std::vector<Ogre::InstancedEntity *> InstancedVisuals::Create(
+    Ogre::Entity *_entity)
+{
+  std::vector<Ogre::InstancedEntity *> instances;
+
+  if (!this->dataPtr->supported || !_entity || _entity->hasSkeleton() ||
+      _entity->hasVertexAnimation())
+  {
+    return instances;
+  }
+
+  // Check every sub entity before creating any instance
+  Ogre::MeshPtr mesh = _entity->getMesh();
+  std::vector<std::string> materials;
+  for (unsigned int i = 0; i < _entity->getNumSubEntities(); ++i)
+  {
+    Ogre::SubMesh *subMesh = mesh->getSubMesh(i);
+    if (subMesh->useSharedVertices ||
+        !InstanceableVertices(subMesh->vertexData))
+    {
+      return instances;
+    }
+
+    std::string material = this->dataPtr->Material(
+        _entity->getSubEntity(i)->getMaterial());
+    if (material.empty())
+      return instances;
+    materials.push_back(material);
+  }
+
+  try
+  {
+    for (unsigned int i = 0; i < materials.size(); ++i)
+    {
+      Ogre::InstancedEntity *instance = this->dataPtr->Manager(mesh,
+          static_cast<unsigned short>(i))->createInstancedEntity(
+          materials[i]);
+      instance->setCastShadows(false);
+      instances.push_back(instance);
+    }
+  }
+  catch(Ogre::Exception &e)
+  {
+    gzwarn << "Unable to instance mesh[" << mesh->getName() << "]: "
+           << e.getDescription() << std::endl;
+    this->Destroy(instances);
+    return instances;
+  }
+
+  this->dataPtr->instanceCount += instances.size();
+  return instances;
+}
+
+//////////////////////////////////////////////////
+void InstancedVisuals::Destroy(
+    std::vector<Ogre::InstancedEntity *> &_instances)
+{
+  for (auto instance : _instances)
+  {
+    if (instance->isAttached())
+      instance->detachFromParent();
+    this->dataPtr->manager->destroyInstancedEntity(instance);
+  }
+
+  this->dataPtr->instanceCount -= std::min(this->dataPtr->instanceCount,
+      static_cast<unsigned int>(_instances.size()));
+  _instances.clear();
+}
+
+//////////////////////////////////////////////////
+unsigned int InstancedVisuals::InstanceCount() const
+{
+  return this->dataPtr->instanceCount;
+}
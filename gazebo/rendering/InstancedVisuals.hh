@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_RENDERING_INSTANCEDVISUALS_HH_
+#define GAZEBO_RENDERING_INSTANCEDVISUALS_HH_
+
+#include <memory>
+#include <vector>
+
+namespace Ogre
+{
+  class Entity;
+  class InstancedEntity;
+  class SceneManager;
+}
+
+namespace gazebo
+{
+  namespace rendering
+  {
+    // Forward declare private data class.
+    class InstancedVisualsPrivate;
+
+    /// \internal
+    /// \brief Hardware instanced batches of the visuals of a scene.
+    /// Visuals drawing the same mesh with the same appearance share
+    /// instance batches, so they are drawn with one call per batch instead
+    /// of one per visual. An instanced entity takes the place of each sub
+    /// entity of the visual, in the visual's scene node, so the visual moves
+    /// as before.
+    /// The instancing material of an appearance is a copy of the visual's
+    /// material, drawn by the Gazebo/Instanced programs, with per pixel
+    /// lighting from up to four lights. Only single pass, opaque, lit
+    /// materials without programs of their own and with at most one
+    /// texture can be instanced, on meshes with exactly one set of texture
+    /// coordinates. Instanced visuals don't cast or receive shadows.
+    class InstancedVisuals
+    {
+      /// \brief Constructor.
+      /// \param[in] _manager Scene manager of the scene.
+      public: explicit InstancedVisuals(Ogre::SceneManager *_manager);
+
+      /// \brief Destructor, destroys the batches and materials.
+      public: ~InstancedVisuals();
+
+      /// \brief Get whether the render system and media support
+      /// instancing.
+      /// \return True if instanced entities can be created.
+      public: bool Supported() const;
+
+      /// \brief Create the instanced entities drawing an entity.
+      /// \param[in] _entity The entity. It is not modified.
+      /// \return One instanced entity per sub entity, not attached, or an
+      /// empty vector if the entity can't be instanced.
+      public: std::vector<Ogre::InstancedEntity *> Create(
+                  Ogre::Entity *_entity);
+
+      /// \brief Destroy instanced entities returned by Create.
+      /// \param[in,out] _instances The entities, cleared on return.
+      public: void Destroy(std::vector<Ogre::InstancedEntity *> &_instances);
+
+      /// \brief Get the number of instanced entities.
+      /// \return Number of entities created and not destroyed.
+      public: unsigned int InstanceCount() const;
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<InstancedVisualsPrivate> dataPtr;
+    };
+  }
+}
+#endif
@@ -64,6 +64,14 @@ class gazebo::rendering::MarkerManagerPrivate
   /// \param[in] _req The marker message.
   public: void OnMarkerMsg(const ignition::msgs::Marker &_req);
 
+  /// \brief Callback that receives several marker messages at once, so
+  /// that large sets of markers don't need one request each.
+  /// \param[in] _req The marker messages.
+  /// \param[out] _res True, the markers are processed on PreRender.
+  /// \return True on success.
+  public: bool OnMarkerArray(const ignition::msgs::Marker_V &_req,
+              ignition::msgs::Boolean &_res);
+
   /// \brief Service callback that returns a list of markers.
   /// \param[out] _rep Service reply
   /// \return True on success.
@@ -142,6 +150,13 @@ bool MarkerManager::Init(Scene *_scene)
     gzerr << "Unable to advertise to the /marker service.\n";
   }
 
+  // Advertise to the marker array service
+  if (!this->dataPtr->node.Advertise("/marker_array",
+        &MarkerManagerPrivate::OnMarkerArray, this->dataPtr.get()))
+  {
+    gzerr << "Unable to advertise to the /marker_array service.\n";
+  }
+
   this->dataPtr->gznode = transport::NodePtr(new transport::Node());
   this->dataPtr->gznode->Init();
 
@@ -333,6 +348,17 @@ void MarkerManagerPrivate::OnMarkerMsg(const ignition::msgs::Marker &_req)
   this->markerMsgs.push_back(_req);
 }
 
+/////////////////////////////////////////////////
+bool MarkerManagerPrivate::OnMarkerArray(
+    const ignition::msgs::Marker_V &_req, ignition::msgs::Boolean &_res)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->markerMsgs.insert(this->markerMsgs.end(), _req.marker().begin(),
+      _req.marker().end());
+  _res.set_data(true);
+  return true;
+}
+
 /////////////////////////////////////////////////
 bool MarkerManagerPrivate::OnList(ignition::msgs::Marker_V &_rep)
 {
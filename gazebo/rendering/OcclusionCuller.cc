@@ -0,0 +1,496 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "gazebo/rendering/ogre_gazebo.h"
+#include <OGRE/OgreHardwareOcclusionQuery.h>
+
+#include "gazebo/rendering/OcclusionCuller.hh"
+
+using namespace gazebo;
+using namespace rendering;
+
+namespace
+{
+  /// \brief Number of occlusion query materials created, used to name
+  /// them.
+  unsigned int gOcclusionCount = 0;
+
+  /// \brief Margin added around the bounding boxes, relative to their
+  /// largest dimension, so that flat and thin boxes still cover pixels.
+  const Ogre::Real kBoxMargin = 0.01;
+
+  /// \brief Smallest margin added around the bounding boxes.
+  const Ogre::Real kMinBoxMargin = 0.001;
+
+  /// \brief A box, drawn to test the visibility of a bounding box.
+  class OcclusionBox : public Ogre::Renderable
+  {
+    /// \brief Constructor, creates a unit cube.
+    /// \param[in] _material Material of the box.
+    public: explicit OcclusionBox(const Ogre::MaterialPtr &_material)
+            : material(_material)
+    {
+      const float vertices[] = {
+          -0.5f, -0.5f, -0.5f,  0.5f, -0.5f, -0.5f,
+           0.5f,  0.5f, -0.5f, -0.5f,  0.5f, -0.5f,
+          -0.5f, -0.5f,  0.5f,  0.5f, -0.5f,  0.5f,
+           0.5f,  0.5f,  0.5f, -0.5f,  0.5f,  0.5f};
+      const uint16_t indices[] = {
+          0, 2, 1, 0, 3, 2,  4, 5, 6, 4, 6, 7,
+          0, 1, 5, 0, 5, 4,  2, 3, 7, 2, 7, 6,
+          1, 2, 6, 1, 6, 5,  0, 4, 7, 0, 7, 3};
+
+      this->op.operationType = Ogre::RenderOperation::OT_TRIANGLE_LIST;
+      this->op.useIndexes = true;
+
+      this->op.vertexData = OGRE_NEW Ogre::VertexData();
+      this->op.vertexData->vertexCount = 8;
+      this->op.vertexData->vertexDeclaration->addElement(0, 0,
+          Ogre::VET_FLOAT3, Ogre::VES_POSITION);
+      Ogre::HardwareVertexBufferSharedPtr vertexBuffer =
+          Ogre::HardwareBufferManager::getSingleton().createVertexBuffer(
+          3 * sizeof(float), 8, Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+      vertexBuffer->writeData(0, vertexBuffer->getSizeInBytes(), vertices,
+          true);
+      this->op.vertexData->vertexBufferBinding->setBinding(0, vertexBuffer);
+
+      this->op.indexData = OGRE_NEW Ogre::IndexData();
+      this->op.indexData->indexCount = 36;
+      this->op.indexData->indexBuffer =
+          Ogre::HardwareBufferManager::getSingleton().createIndexBuffer(
+          Ogre::HardwareIndexBuffer::IT_16BIT, 36,
+          Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+      this->op.indexData->indexBuffer->writeData(0,
+          this->op.indexData->indexBuffer->getSizeInBytes(), indices, true);
+    }
+
+    /// \brief Destructor.
+    public: virtual ~OcclusionBox()
+    {
+      OGRE_DELETE this->op.vertexData;
+      OGRE_DELETE this->op.indexData;
+    }
+
+    /// \brief Place the box.
+    /// \param[in] _box Bounding box to cover, in world coordinates.
+    public: void SetBox(const Ogre::AxisAlignedBox &_box)
+    {
+      Ogre::Vector3 size = _box.getSize();
+      Ogre::Real margin = std::max(kMinBoxMargin,
+          kBoxMargin * std::max(size.x, std::max(size.y, size.z)));
+      this->transform.makeTransform(_box.getCenter(),
+          size + Ogre::Vector3(2 * margin), Ogre::Quaternion::IDENTITY);
+    }
+
+    // Documentation inherited
+    public: virtual const Ogre::MaterialPtr &getMaterial() const
+    {
+      return this->material;
+    }
+
+    // Documentation inherited
+    public: virtual void getRenderOperation(Ogre::RenderOperation &_op)
+    {
+      _op = this->op;
+    }
+
+    // Documentation inherited
+    public: virtual void getWorldTransforms(Ogre::Matrix4 *_xform) const
+    {
+      *_xform = this->transform;
+    }
+
+    // Documentation inherited
+    public: virtual Ogre::Real getSquaredViewDepth(
+                const Ogre::Camera * /*_cam*/) const
+    {
+      return 0;
+    }
+
+    // Documentation inherited
+    public: virtual const Ogre::LightList &getLights() const
+    {
+      return this->lights;
+    }
+
+    /// \brief Material of the box.
+    private: Ogre::MaterialPtr material;
+
+    /// \brief Geometry of the box.
+    private: Ogre::RenderOperation op;
+
+    /// \brief Transform of the unit cube to the tested box.
+    private: Ogre::Matrix4 transform = Ogre::Matrix4::IDENTITY;
+
+    /// \brief No lights, the box is not lit.
+    private: Ogre::LightList lights;
+  };
+
+  /// \brief Occlusion state of an entity, for one camera.
+  struct OcclusionState
+  {
+    /// \brief Query of the entity's box, nullptr if none is issued.
+    Ogre::HardwareOcclusionQuery *query = nullptr;
+
+    /// \brief True if the last query saw no pixel of the box.
+    bool occluded = false;
+
+    /// \brief Frame in which the entity was last tested.
+    unsigned int frame = 0;
+  };
+
+  /// \brief Occlusion states of the entities of a camera.
+  struct CameraOcclusion
+  {
+    /// \brief States by entity.
+    std::unordered_map<const Ogre::MovableObject *, OcclusionState>
+        objects;
+
+    /// \brief Number of frames tested.
+    unsigned int frame = 0;
+  };
+}
+
+namespace gazebo
+{
+  namespace rendering
+  {
+    /// \internal
+    /// \brief Private data for the OcclusionCuller class
+    class OcclusionCullerPrivate
+      : public Ogre::RenderQueueListener,
+        public Ogre::MovableObject::Listener
+    {
+      /// \brief Skip the occluded entities of the cameras.
+      /// \param[in] _object The entity.
+      /// \param[in] _camera Camera rendering the scene.
+      /// \return False if the entity is occluded from _camera.
+      public: virtual bool objectRendering(const Ogre::MovableObject *_object,
+                  const Ogre::Camera *_camera)
+      {
+        auto camera = this->cameras.find(_camera);
+        if (camera == this->cameras.end())
+          return true;
+
+        auto object = camera->second.objects.find(_object);
+        return object == camera->second.objects.end() ||
+            !object->second.occluded;
+      }
+
+      /// \brief Forget a destroyed entity.
+      /// \param[in] _object The entity.
+      public: virtual void objectDestroyed(Ogre::MovableObject *_object)
+      {
+        for (auto &camera : this->cameras)
+        {
+          auto object = camera.second.objects.find(_object);
+          if (object != camera.second.objects.end())
+          {
+            this->Release(object->second);
+            camera.second.objects.erase(object);
+          }
+        }
+        this->listened.erase(_object);
+      }
+
+      /// \brief Test the entities once the opaque objects of a camera
+      /// are rendered.
+      /// \param[in] _queueGroupId Render queue group that was rendered.
+      /// \param[in] _invocation Name of the invocation.
+      /// \param[out] _repeat Not used.
+      public: virtual void renderQueueEnded(Ogre::uint8 _queueGroupId,
+                  const Ogre::String &_invocation, bool &/*_repeat*/)
+      {
+        if (_queueGroupId != Ogre::RENDER_QUEUE_MAIN ||
+            !_invocation.empty() || this->cameras.empty())
+        {
+          return;
+        }
+
+        Ogre::Viewport *viewport = this->manager->getCurrentViewport();
+        if (!viewport || !viewport->getCamera())
+          return;
+
+        auto iter = this->cameras.find(viewport->getCamera());
+        if (iter != this->cameras.end())
+          this->Test(iter->first, viewport, iter->second);
+      }
+
+      /// \brief Read the finished queries of a camera and issue new ones.
+      /// \param[in] _camera The camera being rendered.
+      /// \param[in] _viewport Viewport of the camera.
+      /// \param[in,out] _state Occlusion state of the camera.
+      public: void Test(const Ogre::Camera *_camera,
+                  const Ogre::Viewport *_viewport, CameraOcclusion &_state)
+      {
+        ++_state.frame;
+
+        // Boxes the near plane cuts into can be hidden by the clipping,
+        // so they are not tested
+        Ogre::Vector3 eye = _camera->getDerivedPosition();
+        const Ogre::Vector3 *corners = _camera->getWorldSpaceCorners();
+        Ogre::Real nearMargin = 0;
+        for (unsigned int i = 0; i < 4; ++i)
+          nearMargin = std::max(nearMargin, eye.distance(corners[i]));
+        Ogre::Vector3 margin(2 * nearMargin + kMinBoxMargin);
+
+        uint32_t mask = _viewport->getVisibilityMask() &
+            this->manager->getVisibilityMask();
+
+        Ogre::SceneManager::MovableObjectIterator objects =
+            this->manager->getMovableObjectIterator(
+            Ogre::EntityFactory::FACTORY_TYPE_NAME);
+        while (objects.hasMoreElements())
+        {
+          Ogre::MovableObject *object = objects.getNext();
+          if (!object->isAttached() || !object->getVisible() ||
+              !(object->getVisibilityFlags() & mask))
+          {
+            continue;
+          }
+
+          if (object->getListener() != this)
+          {
+            // Entities with a listener of their own are always drawn
+            if (object->getListener())
+              continue;
+            object->setListener(this);
+            this->listened.insert(object);
+          }
+
+          const Ogre::AxisAlignedBox &box = object->getWorldBoundingBox(true);
+          if (!box.isFinite())
+            continue;
+
+          OcclusionState &state = _state.objects[object];
+          state.frame = _state.frame;
+
+          if (state.query)
+          {
+            // Keep the last result until the query is done
+            if (state.query->isStillOutstanding())
+              continue;
+
+            unsigned int pixels = 0;
+            state.query->pullOcclusionQuery(&pixels);
+            state.occluded = pixels == 0;
+          }
+
+          Ogre::AxisAlignedBox nearBox(box.getMinimum() - margin,
+              box.getMaximum() + margin);
+          if (!_camera->isVisible(box) || nearBox.contains(eye))
+          {
+            // Entities outside the frustum are culled anyway
+            state.occluded = false;
+            this->Release(state);
+            continue;
+          }
+
+          if (!state.query)
+            state.query = this->Acquire();
+          this->box->SetBox(box);
+          state.query->beginOcclusionQuery();
+          this->manager->_injectRenderWithPass(this->pass, this->box.get(),
+              false);
+          state.query->endOcclusionQuery();
+        }
+
+        // Entities which are hidden or were detached are drawn as usual
+        for (auto object = _state.objects.begin();
+            object != _state.objects.end();)
+        {
+          if (object->second.frame != _state.frame)
+          {
+            this->Release(object->second);
+            object = _state.objects.erase(object);
+          }
+          else
+            ++object;
+        }
+      }
+
+      /// \brief Get an unused query.
+      /// \return The query.
+      public: Ogre::HardwareOcclusionQuery *Acquire()
+      {
+        if (!this->freeQueries.empty())
+        {
+          Ogre::HardwareOcclusionQuery *query = this->freeQueries.back();
+          this->freeQueries.pop_back();
+          return query;
+        }
+
+        Ogre::HardwareOcclusionQuery *query =
+            this->renderSystem->createHardwareOcclusionQuery();
+        this->queries.push_back(query);
+        return query;
+      }
+
+      /// \brief Release the query of an entity.
+      /// \param[in,out] _state State of the entity.
+      public: void Release(OcclusionState &_state)
+      {
+        if (!_state.query)
+          return;
+
+        // Read the result, so that the query can be issued again
+        if (_state.query->isStillOutstanding())
+        {
+          unsigned int pixels = 0;
+          _state.query->pullOcclusionQuery(&pixels);
+        }
+        this->freeQueries.push_back(_state.query);
+        _state.query = nullptr;
+      }
+
+      /// \brief Scene manager of the scene.
+      public: Ogre::SceneManager *manager = nullptr;
+
+      /// \brief Render system creating the queries.
+      public: Ogre::RenderSystem *renderSystem = nullptr;
+
+      /// \brief Material drawing the boxes without writing color or
+      /// depth.
+      public: Ogre::MaterialPtr material;
+
+      /// \brief Pass of the material.
+      public: Ogre::Pass *pass = nullptr;
+
+      /// \brief Box drawn in the queries.
+      public: std::unique_ptr<OcclusionBox> box;
+
+      /// \brief Occlusion state of the cameras.
+      public: std::map<const Ogre::Camera *, CameraOcclusion> cameras;
+
+      /// \brief Entities whose listener was set.
+      public: std::unordered_set<Ogre::MovableObject *> listened;
+
+      /// \brief All the queries created.
+      public: std::vector<Ogre::HardwareOcclusionQuery *> queries;
+
+      /// \brief Queries which are not issued.
+      public: std::vector<Ogre::HardwareOcclusionQuery *> freeQueries;
+    };
+  }
+}
+
+//////////////////////////////////////////////////
+OcclusionCuller::OcclusionCuller(Ogre::SceneManager *_manager)
+  : dataPtr(new OcclusionCullerPrivate)
+{
+  this->dataPtr->manager = _manager;
+
+  Ogre::RenderSystem *renderSys = Ogre::Root::getSingleton().getRenderSystem();
+  if (!_manager || !renderSys ||
+      !renderSys->getCapabilities()->hasCapability(Ogre::RSC_HWOCCLUSION))
+  {
+    return;
+  }
+  this->dataPtr->renderSystem = renderSys;
+
+  this->dataPtr->material = Ogre::MaterialManager::getSingleton().create(
+      "__GZ_OCCLUSION_QUERY_MATERIAL_" + std::to_string(gOcclusionCount++),
+      Ogre::ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+  this->dataPtr->pass = this->dataPtr->material->getTechnique(0)->getPass(0);
+  this->dataPtr->pass->setColourWriteEnabled(false);
+  this->dataPtr->pass->setDepthWriteEnabled(false);
+  this->dataPtr->pass->setDepthCheckEnabled(true);
+  this->dataPtr->pass->setCullingMode(Ogre::CULL_NONE);
+  this->dataPtr->pass->setLightingEnabled(false);
+  this->dataPtr->material->load();
+
+  this->dataPtr->box.reset(new OcclusionBox(this->dataPtr->material));
+  _manager->addRenderQueueListener(this->dataPtr.get());
+}
+
+//////////////////////////////////////////////////
+OcclusionCuller::~OcclusionCuller()
+{
+  if (!this->dataPtr->renderSystem)
+    return;
+
+  this->dataPtr->manager->removeRenderQueueListener(this->dataPtr.get());
+
+  for (auto object : this->dataPtr->listened)
+  {
+    if (object->getListener() == this->dataPtr.get())
+      object->setListener(nullptr);
+  }
+  this->dataPtr->listened.clear();
+  this->dataPtr->cameras.clear();
+
+  for (auto query : this->dataPtr->queries)
+    this->dataPtr->renderSystem->destroyHardwareOcclusionQuery(query);
+  this->dataPtr->queries.clear();
+  this->dataPtr->freeQueries.clear();
+
+  this->dataPtr->box.reset();
+  Ogre::MaterialManager::getSingleton().remove(
+      this->dataPtr->material->getName());
+  this->dataPtr->material.setNull();
+}
+
+//////////////////////////////////////////////////
+bool OcclusionCuller::Supported() const
+{
+  return this->dataPtr->renderSystem != nullptr;
+}
+
+//////////////////////////////////////////////////
+bool OcclusionCuller::AddCamera(const Ogre::Camera *_camera)
+{
+  if (!this->Supported() || !_camera)
+    return false;
+
+  this->dataPtr->cameras[_camera];
+  return true;
+}
+
+//////////////////////////////////////////////////
+void OcclusionCuller::RemoveCamera(const Ogre::Camera *_camera)
+{
+  auto iter = this->dataPtr->cameras.find(_camera);
+  if (iter == this->dataPtr->cameras.end())
+    return;
+
+  for (auto &object : iter->second.objects)
+    this->dataPtr->Release(object.second);
+  this->dataPtr->cameras.erase(iter);
+}
+
+//////////////////////////////////////////////////
+unsigned int OcclusionCuller::OccludedCount(
+    const Ogre::Camera *_camera) const
+{
+  auto iter = this->dataPtr->cameras.find(_camera);
+  if (iter == this->dataPtr->cameras.end())
+    return 0;
+
+  return std::count_if(iter->second.objects.begin(),
+      iter->second.objects.end(),
+      [](const auto &_object)
+      {
+        return _object.second.occluded;
+      });
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_RENDERING_OCCLUSIONCULLER_HH_
+#define GAZEBO_RENDERING_OCCLUSIONCULLER_HH_
+
+#include <memory>
+
+namespace Ogre
+{
+  class Camera;
+  class SceneManager;
+}
+
+namespace gazebo
+{
+  namespace rendering
+  {
+    // Forward declare private data class.
+    class OcclusionCullerPrivate;
+
+    /// \internal
+    /// \brief Hardware occlusion culling of the entities of a scene, for
+    /// the cameras added to it.
+    /// After the opaque objects of a camera are rendered, the bounding box
+    /// of each entity in the camera's frustum is drawn inside an occlusion
+    /// query, without writing color or depth. Entities whose box had no
+    /// visible pixels are skipped by the camera once the query result is
+    /// available, usually one or two frames later, until a query sees
+    /// their box again. An entity which comes out from behind an occluder
+    /// can therefore be missing from the first frames in which it should
+    /// be visible.
+    class OcclusionCuller
+    {
+      /// \brief Constructor.
+      /// \param[in] _manager Scene manager of the scene.
+      public: explicit OcclusionCuller(Ogre::SceneManager *_manager);
+
+      /// \brief Destructor, destroys the queries.
+      public: ~OcclusionCuller();
+
+      /// \brief Get whether the render system supports occlusion queries.
+      /// \return True if cameras can be added.
+      public: bool Supported() const;
+
+      /// \brief Cull the occluded entities of a camera.
+      /// \param[in] _camera The camera.
+      /// \return False if occlusion queries are not supported.
+      public: bool AddCamera(const Ogre::Camera *_camera);
+
+      /// \brief Stop culling the occluded entities of a camera. This must
+      /// be called before the camera is destroyed.
+      /// \param[in] _camera The camera.
+      public: void RemoveCamera(const Ogre::Camera *_camera);
+
+      /// \brief Get the number of entities a camera currently skips.
+      /// \param[in] _camera The camera.
+      /// \return Number of occluded entities.
+      public: unsigned int OccludedCount(const Ogre::Camera *_camera) const;
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<OcclusionCullerPrivate> dataPtr;
+    };
+  }
+}
+#endif
@@ -16,6 +16,9 @@
 */
 
 #include <sys/stat.h>
+#include <fstream>
+#include <functional>
+#include <sstream>
 #include <boost/filesystem.hpp>
 
 #if defined(HAVE_OPENGL)
@@ -34,6 +37,7 @@
 #endif /* HAVE_OPENGL */
 
 
+#include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/SystemPaths.hh"
@@ -97,6 +101,10 @@ void RTShaderSystem::Init()
     // Set shader cache path.
     this->dataPtr->shaderGenerator->setShaderCachePath(cachePath);
 
+    // The generated sources are reused from the cache path, the compiled
+    // programs only if enabled.
+    this->LoadProgramCache(cachePath);
+
 #if OGRE_VERSION_MAJOR >= 1 && OGRE_VERSION_MINOR <= 8
     this->dataPtr->programWriterFactory =
         OGRE_NEW CustomGLSLProgramWriterFactory();
@@ -138,6 +146,8 @@ void RTShaderSystem::Fini()
   Ogre::MaterialManager::getSingleton().setActiveScheme(
       Ogre::MaterialManager::DEFAULT_SCHEME_NAME);
 
+  this->SaveProgramCache();
+
   // Finalize RTShader system.
   if (this->dataPtr->shaderGenerator != NULL)
   {
@@ -155,6 +165,7 @@ void RTShaderSystem::Fini()
 
   this->dataPtr->pssmSetup.setNull();
   this->dataPtr->scenes.clear();
+  this->dataPtr->dirtyVisuals.clear();
   this->dataPtr->shadowsApplied = false;
   this->dataPtr->initialized = false;
 }
@@ -243,6 +254,18 @@ void RTShaderSystem::UpdateShaders()
   this->dataPtr->updateShaders = true;
 }
 
+//////////////////////////////////////////////////
+void RTShaderSystem::InvalidateShaders(const Visual &_vis)
+{
+  if (!_vis.GetScene())
+  {
+    this->dataPtr->updateShaders = true;
+    return;
+  }
+
+  this->dataPtr->dirtyVisuals[_vis.GetScene()->Name()].insert(_vis.GetId());
+}
+
 //////////////////////////////////////////////////
 void RTShaderSystem::UpdateShaders(VisualPtr _vis)
 {
@@ -646,7 +669,49 @@ Ogre::PSSMShadowCameraSetup *RTShaderSystem::GetPSSMShadowCameraSetup() const
 /////////////////////////////////////////////////
 void RTShaderSystem::Update()
 {
-  if (!this->dataPtr->initialized || !this->dataPtr->updateShaders)
+  if (!this->dataPtr->initialized)
+    return;
+
+  if (!this->dataPtr->updateShaders && !this->dataPtr->dirtyVisuals.empty())
+  {
+    // Visuals that are not in the scene fall back to updating everything
+    std::vector<VisualPtr> visuals;
+    for (const auto &scene : this->dataPtr->scenes)
+    {
+      auto dirty = this->dataPtr->dirtyVisuals.find(scene->Name());
+      if (dirty == this->dataPtr->dirtyVisuals.end())
+        continue;
+
+      for (auto id : dirty->second)
+      {
+        VisualPtr vis = scene->GetVisual(id);
+        if (!vis)
+        {
+          this->dataPtr->updateShaders = true;
+          break;
+        }
+
+        // Children are updated with their parent
+        bool queuedParent = false;
+        for (VisualPtr parent = vis->GetParent(); parent && !queuedParent;
+            parent = parent->GetParent())
+        {
+          queuedParent = dirty->second.count(parent->GetId()) > 0;
+        }
+        if (!queuedParent)
+          visuals.push_back(vis);
+      }
+    }
+
+    if (!this->dataPtr->updateShaders)
+    {
+      for (auto &vis : visuals)
+        this->UpdateShaders(vis);
+    }
+    this->dataPtr->dirtyVisuals.clear();
+  }
+
+  if (!this->dataPtr->updateShaders)
     return;
 
   for (const auto &scene : this->dataPtr->scenes)
@@ -658,6 +723,88 @@ void RTShaderSystem::Update()
     }
   }
   this->dataPtr->updateShaders = false;
+  this->dataPtr->dirtyVisuals.clear();
+}
+
+/////////////////////////////////////////////////
+void RTShaderSystem::LoadProgramCache(const std::string &_cachePath)
+{
+  const char *env = common::getEnv("GAZEBO_SHADER_BINARY_CACHE");
+  if (!env || std::string(env) == "" || std::string(env) == "0")
+    return;
+
+  Ogre::GpuProgramManager &manager = Ogre::GpuProgramManager::getSingleton();
+  if (!manager.canGetCompiledShaderBuffer())
+  {
+    gzwarn << "The render system can't return compiled shaders, they will "
+           << "not be cached" << std::endl;
+    return;
+  }
+
+  // The binaries are only valid for the driver that compiled them
+  const Ogre::RenderSystemCapabilities *capabilities =
+      Ogre::Root::getSingleton().getRenderSystem()->getCapabilities();
+  std::string driver = capabilities->getRenderSystemName() + "_" +
+      capabilities->getDeviceName() + "_" +
+      capabilities->getDriverVersion().toString();
+  std::ostringstream filename;
+  filename << "programs_" << std::hex << std::hash<std::string>()(driver)
+           << ".cache";
+  this->dataPtr->programCacheFile =
+      (boost::filesystem::path(_cachePath) / filename.str()).string();
+
+  manager.setSaveMicrocodesToCache(true);
+
+  if (!boost::filesystem::exists(this->dataPtr->programCacheFile))
+    return;
+
+  std::ifstream *file = OGRE_NEW_T(std::ifstream, Ogre::MEMCATEGORY_GENERAL)(
+      this->dataPtr->programCacheFile.c_str(),
+      std::ios::in | std::ios::binary);
+  Ogre::DataStreamPtr stream(OGRE_NEW Ogre::FileStreamDataStream(
+      this->dataPtr->programCacheFile, file));
+  try
+  {
+    manager.loadMicrocodeCache(stream);
+    gzmsg << "Loaded compiled shaders from ["
+          << this->dataPtr->programCacheFile << "]" << std::endl;
+  }
+  catch(Ogre::Exception &e)
+  {
+    gzwarn << "Unable to load compiled shaders from ["
+           << this->dataPtr->programCacheFile << "]: "
+           << e.getDescription() << std::endl;
+  }
+}
+
+/////////////////////////////////////////////////
+void RTShaderSystem::SaveProgramCache()
+{
+  if (this->dataPtr->programCacheFile.empty() ||
+      !Ogre::GpuProgramManager::getSingletonPtr())
+  {
+    return;
+  }
+
+  Ogre::GpuProgramManager &manager = Ogre::GpuProgramManager::getSingleton();
+  if (!manager.isCacheDirty())
+    return;
+
+  std::fstream *file = OGRE_NEW_T(std::fstream, Ogre::MEMCATEGORY_GENERAL)();
+  file->open(this->dataPtr->programCacheFile.c_str(),
+      std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file->is_open())
+  {
+    gzwarn << "Unable to save compiled shaders to ["
+           << this->dataPtr->programCacheFile << "]" << std::endl;
+    OGRE_DELETE_T(file, basic_fstream, Ogre::MEMCATEGORY_GENERAL);
+    return;
+  }
+
+  Ogre::DataStreamPtr stream(OGRE_NEW Ogre::FileStreamDataStream(
+      this->dataPtr->programCacheFile, file));
+  manager.saveMicrocodeCache(stream);
+  stream->close();
 }
 
 /////////////////////////////////////////////////
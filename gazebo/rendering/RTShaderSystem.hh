@@ -91,6 +91,12 @@ namespace gazebo
       /// \brief Queue a call to update the shaders.
       public: void UpdateShaders();
 
+      /// \brief Queue a call to update the shaders of a visual and its
+      /// children only, for changes that don't affect other visuals, such
+      /// as a new material.
+      /// \param[in] _vis The visual.
+      public: void InvalidateShaders(const Visual &_vis);
+
       /// \brief Set a viewport to use shaders.
       /// \param[in] _viewport The viewport to add.
       /// \param[in] _scene The scene that the viewport uses.
@@ -180,6 +186,17 @@ namespace gazebo
       /// \brief Re-apply shadows. Call this if a shadow paramenter is changed.
       private: void ReapplyShadows();
 
+      /// \brief Load the compiled programs of a previous run, when
+      /// GAZEBO_SHADER_BINARY_CACHE is set and the render system can
+      /// return compiled programs. The programs compiled from now on are
+      /// kept to be saved by SaveProgramCache.
+      /// \param[in] _cachePath Directory of the cache.
+      private: void LoadProgramCache(const std::string &_cachePath);
+
+      /// \brief Save the compiled programs, if any was added since the
+      /// cache was loaded.
+      private: void SaveProgramCache();
+
       /// \brief Make the RTShader system a singleton.
       private: friend class SingletonT<RTShaderSystem>;
 
@@ -18,6 +18,8 @@
 #ifndef _GAZEBO_RTSHADERSYSTEM_PRIVATE_HH_
 #define _GAZEBO_RTSHADERSYSTEM_PRIVATE_HH_
 
+#include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -79,6 +81,14 @@ namespace gazebo
 
       /// \brief Flag to indicate if normal map should be enabled
       public: bool enableNormalMap = true;
+
+      /// \brief Ids of the visuals whose shaders need to be updated, by
+      /// scene name.
+      public: std::map<std::string, std::set<uint32_t>> dirtyVisuals;
+
+      /// \brief File of the compiled programs, empty if they are not
+      /// cached.
+      public: std::string programCacheFile;
     };
   }
 }
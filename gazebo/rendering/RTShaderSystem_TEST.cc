@@ -18,6 +18,7 @@
 #include <gtest/gtest.h>
 #include "gazebo/rendering/Scene.hh"
 #include "gazebo/rendering/RTShaderSystem.hh"
+#include "gazebo/rendering/Visual.hh"
 #include "gazebo/test/ServerFixture.hh"
 
 
@@ -55,6 +56,50 @@ TEST_F(RTShaderSystem_TEST, Shadows)
   EXPECT_DOUBLE_EQ(4.8, shaderSys->ShadowSplitPadding());
 }
 
+/////////////////////////////////////////////////
+TEST_F(RTShaderSystem_TEST, InvalidateShaders)
+{
+  Load("worlds/shapes.world");
+
+  gazebo::rendering::ScenePtr scene = gazebo::rendering::get_scene();
+  ASSERT_TRUE(scene != nullptr);
+
+  // Wait until the box is inserted
+  int sleep = 0;
+  int maxSleep = 10;
+  rendering::VisualPtr vis;
+  while (!vis && sleep < maxSleep)
+  {
+    event::Events::preRender();
+    event::Events::render();
+    event::Events::postRender();
+
+    vis = scene->GetVisual("box::link::visual");
+    common::Time::MSleep(1000);
+    sleep++;
+  }
+  ASSERT_TRUE(vis != nullptr);
+
+  // Only the visual with the new material gets a shader technique
+  vis->SetMaterial("Gazebo/Green");
+  rendering::RTShaderSystem::Instance()->Update();
+
+  Ogre::MaterialPtr material =
+      Ogre::MaterialManager::getSingleton().getByName(vis->GetMaterialName());
+  ASSERT_FALSE(material.isNull());
+  std::string scheme = scene->Name() +
+      Ogre::RTShader::ShaderGenerator::DEFAULT_SCHEME_NAME;
+  bool found = false;
+  for (unsigned int i = 0; i < material->getNumTechniques() && !found; ++i)
+    found = material->getTechnique(i)->getSchemeName() == scheme;
+  EXPECT_TRUE(found);
+
+  // Queued visuals that were removed fall back to updating all visuals
+  rendering::RTShaderSystem::Instance()->InvalidateShaders(*vis);
+  scene->RemoveVisual(vis);
+  rendering::RTShaderSystem::Instance()->Update();
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
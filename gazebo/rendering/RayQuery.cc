@@ -14,11 +14,14 @@
  * limitations under the License.
  *
 */
+#include <limits>
+#include <vector>
 
 #include <ignition/math/Triangle.hh>
 #include <ignition/math/Vector3.hh>
 
 #include "gazebo/common/MeshManager.hh"
+#include "gazebo/common/MeshRayTree.hh"
 
 #include "gazebo/rendering/Camera.hh"
 #include "gazebo/rendering/UserCamera.hh"
@@ -65,79 +68,53 @@ bool RayQuery::SelectMeshTriangle(const int _x, const int _y,
   std::vector<rendering::VisualPtr> visuals;
   this->MeshVisuals(_visual, visuals);
 
-  Ogre::Real closestDistance = -1.0f;
-  Ogre::Vector3 closestResult;
-  bool newClosestFound = false;
-  std::vector<Ogre::Vector3> vertices;
+  double closestDistance = -1.0;
+  ignition::math::Triangle3d closestTriangle;
 
   for (unsigned int i = 0; i < visuals.size(); ++i)
   {
-    const common::Mesh *mesh =
-        common::MeshManager::Instance()->GetMesh(visuals[i]->GetMeshName());
-
-    if (!mesh)
+    const common::MeshRayTree *tree = common::MeshManager::Instance()->RayTree(
+        common::MeshManager::Instance()->GetMesh(visuals[i]->GetMeshName()));
+    if (!tree)
       continue;
 
-    Ogre::Matrix4 transform = visuals[i]->GetSceneNode()->_getFullTransform();
-    // test for hitting individual triangles on the mesh
-    for (unsigned int j = 0; j < mesh->GetSubMeshCount(); ++j)
+    // Cast the ray in the frame of the mesh, which keeps the distances of
+    // the world frame since the direction is transformed too.
+    const Ogre::Matrix4 transform =
+        visuals[i]->GetSceneNode()->_getFullTransform();
+    const Ogre::Real det = transform.determinant();
+    if (det == 0.0)
+      continue;
+    const Ogre::Matrix4 inverse = transform.inverseAffine();
+    const Ogre::Vector3 origin = inverse * ray.getOrigin();
+    const Ogre::Vector3 dir = inverse * (ray.getOrigin() + ray.getDirection())
+        - origin;
+
+    double distance;
+    ignition::math::Triangle3d triangle;
+    if (tree->Intersect(Conversions::ConvertIgn(origin),
+          Conversions::ConvertIgn(dir), distance, triangle,
+          closestDistance < 0.0 ? std::numeric_limits<double>::max() :
+          closestDistance, det < 0.0))
     {
-      const common::SubMesh *submesh = mesh->GetSubMesh(j);
-      if (submesh->GetVertexCount() < 3u)
-        continue;
-      unsigned int indexCount = submesh->GetIndexCount();
-      for (unsigned int k = 0; k < indexCount; k += 3)
-      {
-        if (indexCount <= k+2)
-          continue;
-
-        ignition::math::Vector3d vertexA =
-          submesh->Vertex(submesh->GetIndex(k));
-        ignition::math::Vector3d vertexB =
-          submesh->Vertex(submesh->GetIndex(k+1));
-        ignition::math::Vector3d vertexC =
-          submesh->Vertex(submesh->GetIndex(k+2));
-
-        Ogre::Vector3 worldVertexA = transform * Conversions::Convert(vertexA);
-        Ogre::Vector3 worldVertexB = transform * Conversions::Convert(vertexB);
-        Ogre::Vector3 worldVertexC = transform * Conversions::Convert(vertexC);
-
-        // check for a hit against this triangle
-        std::pair<bool, Ogre::Real> hit = Ogre::Math::intersects(ray,
-            worldVertexA, worldVertexB, worldVertexC,
-           (worldVertexB - worldVertexA).crossProduct(
-           worldVertexC - worldVertexA));
-
-        // if it was a hit check if its the closest
-        if (hit.first &&
-            (closestDistance < 0.0f || hit.second < closestDistance))
-        {
-          // this is the closest so far, save it off
-          closestDistance = hit.second;
-          vertices.clear();
-          vertices.push_back(worldVertexA);
-          vertices.push_back(worldVertexB);
-          vertices.push_back(worldVertexC);
-          newClosestFound = true;
-        }
-      }
+      // this is the closest so far, save it off
+      closestDistance = distance;
+      closestTriangle.Set(
+          Conversions::ConvertIgn(transform *
+            Conversions::Convert(triangle[0])),
+          Conversions::ConvertIgn(transform *
+            Conversions::Convert(triangle[1])),
+          Conversions::ConvertIgn(transform *
+            Conversions::Convert(triangle[2])));
     }
   }
 
-  // if we found a new closest raycast for this object, update the
-  // closestResult before moving on to the next object.
-  if (newClosestFound)
-    closestResult = ray.getPoint(closestDistance);
-
   // return the result
-  if (closestDistance >= 0.0f && vertices.size() == 3u)
+  if (closestDistance >= 0.0)
   {
     // raycast success
-    _intersect = Conversions::ConvertIgn(closestResult);
-    _triangle.Set(
-        Conversions::ConvertIgn(vertices[0]),
-        Conversions::ConvertIgn(vertices[1]),
-        Conversions::ConvertIgn(vertices[2]));
+    _intersect = Conversions::ConvertIgn(ray.getPoint(closestDistance));
+    _triangle = closestTriangle;
     return true;
   }
   // raycast failed
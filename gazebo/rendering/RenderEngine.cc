@@ -14,9 +14,15 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
 #include <string>
 #include <iostream>
 #include <functional>
+#include <vector>
+#include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
 #include <sys/types.h>
 
@@ -29,6 +35,10 @@
 
 #ifndef _WIN32
   #include <dirent.h>
+  #include <fcntl.h>
+  #include <signal.h>
+  #include <sys/file.h>
+  #include <unistd.h>
 #else
   #include "gazebo/common/win_dirent.h"
 #endif
@@ -39,6 +49,7 @@
 #include "gazebo/common/Events.hh"
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Console.hh"
+#include "gazebo/common/MemoryTracker.hh"
 #include "gazebo/common/SystemPaths.hh"
 
 #include "gazebo/rendering/ogre_gazebo.h"
@@ -50,6 +61,11 @@
 #include "gazebo/rendering/RenderTypes.hh"
 #include "gazebo/rendering/RenderEngine.hh"
 #include "gazebo/rendering/RenderEnginePrivate.hh"
+#include "gazebo/rendering/deferred_shading/DeferredLightCP.hh"
+#include "gazebo/rendering/deferred_shading/GBufferSchemeHandler.hh"
+#include "gazebo/rendering/deferred_shading/MergeSchemeHandler.hh"
+#include "gazebo/rendering/deferred_shading/NullSchemeHandler.hh"
+#include "gazebo/rendering/deferred_shading/SSAOLogic.hh"
 
 using namespace gazebo;
 using namespace rendering;
@@ -277,6 +293,13 @@ void RenderEngine::PostRender()
   // a regression.
   this->dataPtr->root->_fireFrameRenderingQueued();
   this->dataPtr->root->_fireFrameEnded();
+
+  if (this->dataPtr->memory)
+  {
+    *this->dataPtr->memory = static_cast<int64_t>(
+        Ogre::TextureManager::getSingleton().getMemoryUsage() +
+        Ogre::MeshManager::getSingleton().getMemoryUsage());
+  }
 }
 
 //////////////////////////////////////////////////
@@ -301,6 +324,17 @@ void RenderEngine::Init()
   // Set default mipmap level (NB some APIs ignore this)
   Ogre::TextureManager::getSingleton().setDefaultNumMipmaps(5);
 
+  // Over their budget, the resource managers unload the resources that
+  // aren't referenced
+  common::MemoryTracker *tracker = common::MemoryTracker::Instance();
+  const uint64_t budget = tracker->Budget("ogre");
+  if (budget > 0)
+  {
+    Ogre::TextureManager::getSingleton().setMemoryBudget(budget);
+    Ogre::MeshManager::getSingleton().setMemoryBudget(budget);
+  }
+  this->dataPtr->memory = &tracker->Counter("ogre");
+
   // init the resources
   Ogre::ResourceGroupManager::getSingleton().initialiseAllResourceGroups();
 
@@ -324,6 +358,20 @@ void RenderEngine::Fini()
   // if render engine is not initialized
   this->dataPtr->windowManager->Fini();
 
+  if (this->dataPtr->memory)
+  {
+    *this->dataPtr->memory = 0;
+    this->dataPtr->memory = nullptr;
+  }
+
+  // Let the next servers of the node take the display
+  if (!this->dataPtr->displayClaimFile.empty())
+  {
+    boost::system::error_code ec;
+    boost::filesystem::remove(this->dataPtr->displayClaimFile, ec);
+    this->dataPtr->displayClaimFile.clear();
+  }
+
   if (!this->dataPtr->initialized)
     return;
 
@@ -728,6 +776,86 @@ void RenderEngine::SetupRenderSystem()
   this->dataPtr->root->setRenderSystem(renderSys);
 }
 
+/////////////////////////////////////////////////
+std::string RenderEngine::RenderDisplay() const
+{
+  return this->dataPtr->renderDisplay;
+}
+
+/////////////////////////////////////////////////
+std::string RenderEngine::ClaimDisplay(
+    const std::vector<std::string> &_displays, const std::string &_claimDir)
+{
+  if (_displays.empty())
+    return "";
+
+#if defined __APPLE__ || _WIN32
+  return _displays.front();
+#else
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(_claimDir, ec);
+  if (ec)
+  {
+    gzwarn << "Unable to create the display claim directory[" << _claimDir
+           << "]: " << ec.message() << std::endl;
+    return _displays.front();
+  }
+
+  // Servers starting together take turns
+  const std::string lockFilename = (boost::filesystem::path(_claimDir) /
+      "lock").string();
+  const int lockFd = open(lockFilename.c_str(), O_RDWR | O_CREAT, 0666);
+  if (lockFd < 0 || flock(lockFd, LOCK_EX) != 0)
+  {
+    gzwarn << "Unable to lock the display claims in[" << _claimDir << "]"
+           << std::endl;
+    if (lockFd >= 0)
+      close(lockFd);
+    return _displays.front();
+  }
+
+  // Count the claims of the running processes
+  std::vector<unsigned int> counts(_displays.size(), 0);
+  const std::string self = std::to_string(getpid());
+  for (boost::filesystem::directory_iterator iter(_claimDir, ec), end;
+       !ec && iter != end; iter.increment(ec))
+  {
+    const std::string name = iter->path().filename().string();
+    if (name == "lock" || name == self)
+      continue;
+
+    const int pid = std::atoi(name.c_str());
+    if (pid <= 0 || (kill(pid, 0) != 0 && errno == ESRCH))
+    {
+      boost::system::error_code removeEc;
+      boost::filesystem::remove(iter->path(), removeEc);
+      continue;
+    }
+
+    std::ifstream claim(iter->path().string());
+    std::string claimed;
+    std::getline(claim, claimed);
+    auto found = std::find(_displays.begin(), _displays.end(), claimed);
+    if (found != _displays.end())
+      ++counts[found - _displays.begin()];
+  }
+
+  const size_t index =
+      std::min_element(counts.begin(), counts.end()) - counts.begin();
+  std::ofstream claim((boost::filesystem::path(_claimDir) / self).string());
+  claim << _displays[index] << std::endl;
+  if (!claim)
+  {
+    gzwarn << "Unable to write the display claim in[" << _claimDir << "]"
+           << std::endl;
+  }
+
+  flock(lockFd, LOCK_UN);
+  close(lockFd);
+  return _displays[index];
+#endif
+}
+
 /////////////////////////////////////////////////
 bool RenderEngine::CreateContext()
 {
@@ -738,6 +866,37 @@ bool RenderEngine::CreateContext()
 #else
   try
   {
+    // GAZEBO_RENDER_DISPLAY selects the X screen, and so the GPU, used for
+    // rendering, e.g. ":0.1" for the second GPU of a node with one screen
+    // per GPU. DISPLAY is overridden so that Ogre, which opens its own
+    // connection, uses the same screen.
+    const char *renderDisplay = common::getEnv("GAZEBO_RENDER_DISPLAY");
+    std::string display = renderDisplay ? renderDisplay : "";
+
+    // A comma separated list spreads the servers of the node across the
+    // screens, each one taking the least used screen when it starts.
+    if (display.find(',') != std::string::npos)
+    {
+      std::vector<std::string> displays;
+      boost::split(displays, display, boost::is_any_of(","));
+      displays.erase(std::remove(displays.begin(), displays.end(), ""),
+          displays.end());
+
+      const boost::filesystem::path claimDir = boost::filesystem::path(
+          common::SystemPaths::Instance()->TmpPath()) /
+          "gazebo_render_displays";
+      display = ClaimDisplay(displays, claimDir.string());
+      this->dataPtr->displayClaimFile =
+          (claimDir / std::to_string(getpid())).string();
+    }
+
+    if (!display.empty())
+    {
+      this->dataPtr->renderDisplay = display;
+      setenv("DISPLAY", display.c_str(), 1);
+      gzmsg << "Rendering on display[" << display << "]\n";
+    }
+
     this->dummyDisplay = XOpenDisplay(0);
     if (!this->dummyDisplay)
     {
@@ -815,7 +974,8 @@ void RenderEngine::CheckSystemCapabilities()
   // bool hasRenderToVertexBuffer =
   //  capabilities->hasCapability(Ogre::RSC_HWRENDER_TO_VERTEX_BUFFER);
 
-  // int multiRenderTargetCount = capabilities->getNumMultiRenderTargets();
+  this->dataPtr->multiRenderTargetCount =
+    capabilities->getNumMultiRenderTargets();
 
   bool hasFBO =
 #if OGRE_VERSION_MAJOR == 1 && OGRE_VERSION_MINOR >= 11
@@ -849,7 +1009,8 @@ void RenderEngine::CheckSystemCapabilities()
     this->dataPtr->renderPathType = RenderEngine::VERTEX;
 
   // Disable deferred rendering for now. Needs more work.
-  // if (hasRenderToVertexBuffer && multiRenderTargetCount >= 8)
+  // if (hasRenderToVertexBuffer &&
+  //     this->dataPtr->multiRenderTargetCount >= 8)
   //  this->dataPtr->renderPathType = RenderEngine::DEFERRED;
 }
 
@@ -859,6 +1020,52 @@ WindowManagerPtr RenderEngine::GetWindowManager() const
   return this->dataPtr->windowManager;
 }
 
+/////////////////////////////////////////////////
+bool RenderEngine::InitDeferredShading()
+{
+  if (this->dataPtr->deferredShadingInit)
+    return true;
+
+#if OGRE_VERSION_MAJOR > 1 || OGRE_VERSION_MINOR >= 8
+  // The deferred shading geometry buffer is two half float targets
+  if (this->dataPtr->renderPathType < FORWARD ||
+      this->dataPtr->multiRenderTargetCount < 2 ||
+      !Ogre::TextureManager::getSingleton().isFormatSupported(
+        Ogre::TEX_TYPE_2D, Ogre::PF_FLOAT16_RGBA, Ogre::TU_RENDERTARGET))
+  {
+    return false;
+  }
+
+  Ogre::MaterialManager &matMgr = Ogre::MaterialManager::getSingleton();
+  Ogre::CompositorManager &compMgr = Ogre::CompositorManager::getSingleton();
+
+  // Deferred Shading scheme handler
+  matMgr.addListener(
+      new GBufferSchemeHandler(GBufferMaterialGenerator::GBT_FAT),
+      "DSGBuffer");
+
+  // Deferred Lighting scheme handlers
+  matMgr.addListener(
+      new GBufferSchemeHandler(GBufferMaterialGenerator::GBT_NORMAL_AND_DEPTH),
+      "DLGBuffer");
+  matMgr.addListener(new MergeSchemeHandler(false), "DLMerge");
+
+  matMgr.addListener(new NullSchemeHandler, "NoGBuffer");
+
+  compMgr.registerCustomCompositionPass("DeferredShadingLight",
+      new DeferredLightCompositionPass<DeferredShading>);
+  compMgr.registerCustomCompositionPass("DeferredLightingLight",
+      new DeferredLightCompositionPass<DeferredLighting>);
+
+  compMgr.registerCompositorLogic("SSAOLogic", new SSAOLogic);
+
+  this->dataPtr->deferredShadingInit = true;
+  return true;
+#else
+  return false;
+#endif
+}
+
 /////////////////////////////////////////////////
 Ogre::Root *RenderEngine::Root() const
 {
@@ -52,6 +52,9 @@ namespace gazebo
     /// \brief Adaptor to Ogre3d
     ///
     /// Provides the interface to load, initialize the rendering engine.
+    /// The Ogre meshes and textures count against the "ogre" budget of
+    /// the common::MemoryTracker, which is passed to the Ogre resource
+    /// managers.
     class GZ_RENDERING_VISIBLE RenderEngine : public SingletonT<RenderEngine>
     {
       /// \enum RenderPathType
@@ -128,6 +131,15 @@ namespace gazebo
       /// \return Pointer to the window manager.
       public: WindowManagerPtr GetWindowManager() const;
 
+      /// \brief Prepare the deferred shading that cameras opt in to with
+      /// Camera::SetDeferredShading, whatever the render path. The
+      /// material schemes and compositor passes it needs are registered
+      /// on the first call.
+      /// \return False if the system can't render the geometry buffer,
+      /// which needs shaders and two floating point render targets
+      /// written at once.
+      public: bool InitDeferredShading();
+
       /// \brief Get a pointer to the Ogre root object.
       /// \return Pointer to the Ogre root object.
       public: Ogre::Root *Root() const;
@@ -136,6 +148,26 @@ namespace gazebo
       /// \return a list of FSAA levels
       public: std::vector<unsigned int> FSAALevels() const;
 
+      /// \brief Get the X display the render engine renders on, set with
+      /// GAZEBO_RENDER_DISPLAY.
+      /// \return The display, empty if it wasn't set.
+      public: std::string RenderDisplay() const;
+
+      /// \brief Claim one of several displays to render on, for the
+      /// servers of a node with several GPUs. The claim goes to the display
+      /// the fewest running processes claim, ties going to the first of
+      /// them. Claims are files named after the process ids in a
+      /// directory, whose content is the display. The claims of processes
+      /// that no longer run are removed, and a previous claim of this
+      /// process is replaced.
+      /// \param[in] _displays Candidate displays, e.g. one X screen per GPU.
+      /// \param[in] _claimDir Directory of the claims, created if needed.
+      /// \return The claimed display, or the first candidate if the claim
+      /// can't be written. Empty if there are no candidates.
+      public: static std::string ClaimDisplay(
+                  const std::vector<std::string> &_displays,
+                  const std::string &_claimDir);
+
 #if OGRE_VERSION_MAJOR > 1 || OGRE_VERSION_MINOR >= 9
       /// \internal
       /// \brief Get a pointer to the Ogre overlay system.
@@ -18,6 +18,8 @@
 #ifndef _GAZEBO_RENDERING_RENDERENGINE_PRIVATE_HH_
 #define _GAZEBO_RENDERING_RENDERENGINE_PRIVATE_HH_
 
+#include <atomic>
+#include <string>
 #include <vector>
 #include "gazebo/common/CommonTypes.hh"
 #include "gazebo/transport/TransportTypes.hh"
@@ -67,10 +69,28 @@ namespace gazebo
       /// \brief A list of supported fsaa levels
       public: std::vector<unsigned int> fsaaLevels;
 
+      /// \brief Number of render targets a pass can write at once.
+      public: int multiRenderTargetCount = 0;
+
+      /// \brief True once the deferred shading schemes are registered.
+      public: bool deferredShadingInit = false;
+
+      /// \brief Display rendered on, empty if GAZEBO_RENDER_DISPLAY isn't
+      /// set.
+      public: std::string renderDisplay;
+
+      /// \brief File of the display claim of this process, empty if it
+      /// didn't claim a display.
+      public: std::string displayClaimFile;
+
 #if OGRE_VERSION_MAJOR > 1 || OGRE_VERSION_MINOR >= 9
       /// \brief Ogre overlay system needed for initialization of Ogre
       public: Ogre::OverlaySystem *overlaySystem;
 #endif
+
+      /// \brief Bytes of the Ogre meshes and textures, in the "ogre"
+      /// subsystem of the common::MemoryTracker.
+      public: std::atomic<int64_t> *memory = nullptr;
     };
   }
 }
@@ -16,6 +16,14 @@
 */
 
 #include <gtest/gtest.h>
+
+#ifndef _WIN32
+  #include <unistd.h>
+#endif
+
+#include <fstream>
+#include <boost/filesystem.hpp>
+
 #include "gazebo/test/ServerFixture.hh"
 #include "gazebo/rendering/RenderEngine.hh"
 
@@ -50,6 +58,39 @@ TEST_F(RenderEngine_TEST, FSAATest)
   }
 }
 
+#ifndef _WIN32
+/////////////////////////////////////////////////
+TEST_F(RenderEngine_TEST, ClaimDisplay)
+{
+  namespace fs = boost::filesystem;
+  const fs::path dir = fs::temp_directory_path() /
+      fs::unique_path("gazebo-ClaimDisplay-%%%%-%%%%");
+  ASSERT_TRUE(fs::create_directories(dir));
+
+  std::vector<std::string> displays = {":0.0", ":0.1"};
+  EXPECT_EQ(rendering::RenderEngine::ClaimDisplay({}, dir.string()), "");
+
+  // The parent process holds the first display, the claim of a process
+  // that is gone is removed.
+  {
+    std::ofstream live((dir / std::to_string(getppid())).string());
+    live << ":0.0" << std::endl;
+    std::ofstream dead((dir / "999999999").string());
+    dead << ":0.1" << std::endl;
+  }
+  EXPECT_EQ(rendering::RenderEngine::ClaimDisplay(displays, dir.string()),
+      ":0.1");
+  EXPECT_FALSE(fs::exists(dir / "999999999"));
+  EXPECT_TRUE(fs::exists(dir / std::to_string(getpid())));
+
+  // Claiming again replaces the claim of this process
+  EXPECT_EQ(rendering::RenderEngine::ClaimDisplay(displays, dir.string()),
+      ":0.1");
+
+  fs::remove_all(dir);
+}
+#endif
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
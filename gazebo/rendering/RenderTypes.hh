@@ -69,6 +69,7 @@ namespace gazebo
     class WindowManager;
     class SelectionObj;
     class RayQuery;
+    class DepthNoise;
     class Distortion;
     class LensFlare;
     class Road2d;
@@ -14,6 +14,10 @@
  * limitations under the License.
  *
 */
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <string>
 #include <boost/thread.hpp>
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Console.hh"
@@ -24,6 +28,15 @@
 
 using namespace gazebo;
 
+/// \brief True when physics updates scene poses with update_scene_poses.
+static std::atomic<bool> g_directScenePoses(false);
+
+/// \brief Names of the scenes created with create_scene.
+static std::set<std::string> g_sceneNames;
+
+/// \brief Protects g_sceneNames.
+static std::mutex g_sceneNamesMutex;
+
 //////////////////////////////////////////////////
 bool rendering::load()
 {
@@ -64,6 +77,10 @@ bool rendering::init()
 //////////////////////////////////////////////////
 bool rendering::fini()
 {
+  {
+    std::lock_guard<std::mutex> lock(g_sceneNamesMutex);
+    g_sceneNames.clear();
+  }
   rendering::RenderEngine::Instance()->Fini();
   return true;
 }
@@ -100,22 +117,51 @@ rendering::ScenePtr rendering::create_scene(const std::string &_name,
     }
   }
 
+  if (scene)
+  {
+    std::lock_guard<std::mutex> lock(g_sceneNamesMutex);
+    g_sceneNames.insert(_name);
+  }
+
   return scene;
 }
 
 //////////////////////////////////////////////////
 void rendering::remove_scene(const std::string &_name)
 {
+  {
+    std::lock_guard<std::mutex> lock(g_sceneNamesMutex);
+    g_sceneNames.erase(_name);
+  }
   rendering::RenderEngine::Instance()->RemoveScene(_name);
 }
 
+//////////////////////////////////////////////////
+bool rendering::has_scene(const std::string &_name)
+{
+  std::lock_guard<std::mutex> lock(g_sceneNamesMutex);
+  return g_sceneNames.count(_name) > 0;
+}
+
 //////////////////////////////////////////////////
 void rendering::update_scene_poses(const std::string &_name,
                                    const msgs::PosesStamped &_msg)
 {
+  // Poses received before the scene is initialized are applied once it is,
+  // since only the poses that changed are sent
   ScenePtr scene = get_scene(_name);
-  if (scene && scene->Initialized())
-  {
+  if (scene)
     scene->UpdatePoses(_msg);
-  }
+}
+
+//////////////////////////////////////////////////
+void rendering::set_direct_scene_poses(const bool _enable)
+{
+  g_directScenePoses = _enable;
+}
+
+//////////////////////////////////////////////////
+bool rendering::direct_scene_poses()
+{
+  return g_directScenePoses;
 }
@@ -55,6 +55,27 @@ namespace gazebo
     void update_scene_poses(const std::string &_name,
                             const msgs::PosesStamped &_msg);
 
+    /// \brief Tell scenes that physics runs in this process and updates
+    /// their poses with update_scene_poses. Scenes loaded afterwards don't
+    /// subscribe to pose topics, which avoids serializing poses to
+    /// protobuf and back.
+    /// \param[in] _enable True to use the direct API.
+    GZ_RENDERING_VISIBLE
+    void set_direct_scene_poses(const bool _enable);
+
+    /// \brief Get whether scene poses are updated with the direct API.
+    /// \return True if set_direct_scene_poses(true) was called.
+    /// \sa set_direct_scene_poses
+    GZ_RENDERING_VISIBLE
+    bool direct_scene_poses();
+
+    /// \brief Get whether a scene was created with create_scene and not
+    /// removed. Unlike get_scene, it can be called from any thread.
+    /// \param[in] _name Name of the scene.
+    /// \return True if the scene exists.
+    GZ_RENDERING_VISIBLE
+    bool has_scene(const std::string &_name);
+
     /// \brief create rendering::Scene by name.
     /// \param[in] _name Name of the scene to create.
     /// \param[in] _enableVisualizations True enables visualization
@@ -15,10 +15,13 @@
  *
 */
 
+#include <map>
+#include <string>
 #include <vector>
 
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/RoadNetwork.hh"
 #include "gazebo/rendering/ogre_gazebo.h"
-#include "gazebo/rendering/Conversions.hh"
 #include "gazebo/rendering/RenderingIface.hh"
 #include "gazebo/rendering/Road2d.hh"
 #include "gazebo/rendering/RenderEngine.hh"
@@ -28,31 +31,14 @@ namespace gazebo
 {
   namespace rendering
   {
-    /// \brief A road segment
-    class RoadSegment
-    {
-      /// \brief Load the road segment from message data.
-      /// \param[in] _msg The robot data.
-      public: void Load(msgs::Road _msg);
-
-      /// \brief Name of the road segment.
-      public: std::string name;
-
-      /// \brief Points that make up the middle of the road.
-      public: std::vector<ignition::math::Vector3d> points;
-
-      /// \brief Width of the road.
-      public: double width;
-
-      /// \brief Texture of the road
-      public: std::string texture;
-    };
-
     /// \brief Private data for the Road2d class.
     class Road2dPrivate : public VisualPrivate
     {
-      /// \brief All the road segments.
-      public: std::vector<RoadSegment> segments;
+      /// \brief Meshes of the roads.
+      public: common::RoadNetwork network;
+
+      /// \brief Entities of the batches, by batch name.
+      public: std::map<std::string, Ogre::Entity *> entities;
     };
   }
 }
@@ -79,234 +65,107 @@ Road2d::Road2d(const std::string &_name, VisualPtr _parent)
 /////////////////////////////////////////////////
 Road2d::~Road2d()
 {
-  Road2dPrivate *dPtr =
-      reinterpret_cast<Road2dPrivate *>(this->dataPtr);
+  this->DestroyBatches();
+}
 
-  dPtr->segments.clear();
+/////////////////////////////////////////////////
+void Road2d::Fini()
+{
+  this->DestroyBatches();
+  Visual::Fini();
 }
 
 //////////////////////////////////////////////////
 void Road2d::Load(msgs::Road _msg)
 {
   this->Load();
-
-  Road2dPrivate *dPtr =
-      reinterpret_cast<Road2dPrivate *>(this->dataPtr);
-
-  RoadSegment segment;
-  segment.Load(_msg);
-
-  Ogre::MovableObject *obj = dynamic_cast<Ogre::MovableObject *>
-      (this->GetSceneNode()->getCreator()->createEntity(
-      segment.name, segment.name));
-  obj->setRenderQueueGroup(obj->getRenderQueueGroup()+1);
-  this->AttachObject(obj);
-  dPtr->segments.push_back(segment);
-
-  // make the road visual not selectable
-  this->SetVisibilityFlags(GZ_VISIBILITY_ALL & (~GZ_VISIBILITY_SELECTABLE));
+  this->AddRoad(_msg);
+  this->UpdateBatches();
 }
 
-/////////////////////////////////////////////////
-void RoadSegment::Load(msgs::Road _msg)
+//////////////////////////////////////////////////
+void Road2d::AddRoad(const msgs::Road &_msg)
 {
-  this->width = _msg.width();
+  Road2dPrivate *dPtr =
+      reinterpret_cast<Road2dPrivate *>(this->dataPtr);
 
+  std::vector<ignition::math::Vector3d> points;
   for (int i = 0; i < _msg.point_size(); ++i)
-  {
-    this->points.push_back(msgs::ConvertIgn(_msg.point(i)));
-  }
-
-  this->name = _msg.name();
-
-  /// Create the mesh
-  Ogre::MeshPtr mesh =
-      Ogre::MeshManager::getSingleton().createManual(this->name,
-      Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
-
-
-  Ogre::SubMesh *subMesh = mesh->createSubMesh();
-  subMesh->useSharedVertices = false;
-  subMesh->operationType = Ogre::RenderOperation::OT_TRIANGLE_STRIP;
-  subMesh->vertexData = new Ogre::VertexData();
-  Ogre::VertexData *vertexData = subMesh->vertexData;
-  Ogre::VertexDeclaration *vertexDecl = vertexData->vertexDeclaration;
-
-  size_t currOffset = 0;
-
-  // Positions
-  vertexDecl->addElement(0, currOffset, Ogre::VET_FLOAT3, Ogre::VES_POSITION);
-  currOffset += Ogre::VertexElement::getTypeSize(Ogre::VET_FLOAT3);
-
-  // Normals
-  vertexDecl->addElement(0, currOffset, Ogre::VET_FLOAT3, Ogre::VES_NORMAL);
-  currOffset += Ogre::VertexElement::getTypeSize(Ogre::VET_FLOAT3);
-
-  // two dimensional ->roadObjtexture coordinates
-  vertexDecl->addElement(0, currOffset, Ogre::VET_FLOAT2,
-                         Ogre::VES_TEXTURE_COORDINATES, 0);
-
-  // allocate the vertex buffer
-  vertexData->vertexCount = this->points.size() * 2;
-  Ogre::HardwareVertexBufferSharedPtr vBuf =
-    Ogre::HardwareBufferManager::getSingleton().createVertexBuffer(
-        vertexDecl->getVertexSize(0), vertexData->vertexCount,
-        Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY, false);
-
-  Ogre::VertexBufferBinding *binding = vertexData->vertexBufferBinding;
-  binding->setBinding(0, vBuf);
-  float *vertices = static_cast<float*>(
-      vBuf->lock(Ogre::HardwareBuffer::HBL_DISCARD));
-
-  // index buffer
-  subMesh->indexData->indexCount = vertexData->vertexCount;
-  subMesh->indexData->indexBuffer =
-      Ogre::HardwareBufferManager::getSingleton().createIndexBuffer(
-      Ogre::HardwareIndexBuffer::IT_32BIT,
-      subMesh->indexData->indexCount,
-      Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY,
-      false);
-  Ogre::HardwareIndexBufferSharedPtr iBuf = subMesh->indexData->indexBuffer;
-  uint32_t *indices = static_cast<uint32_t *>(
-      iBuf->lock(Ogre::HardwareBuffer::HBL_DISCARD));
-
-  ignition::math::Vector3d pA, pB, tangent;
-
-  ignition::math::AxisAlignedBox bounds;
-  bounds.Min().Set(ignition::math::MAX_D, ignition::math::MAX_D,
-                   ignition::math::MAX_D);
-  bounds.Max().Set(ignition::math::MIN_D, ignition::math::MIN_D,
-                   ignition::math::MIN_D);
+    points.push_back(msgs::ConvertIgn(_msg.point(i)));
 
-  // length for each texture tile, same as road width as texture is square
-  // (if texture size should change or made custom in a future version
-  // there needs to be code to handle this)
-  double texMaxLen = this->width;
-
-  // current road length
-  double curLen = 0.0;
-
-  // Generate the triangles for the road
-  for (unsigned int i = 0; i < this->points.size(); ++i)
+  std::string material = "Gazebo/Road";
+  if (_msg.has_material() && _msg.material().has_script())
   {
-    double factor = 1.0;
-
-    // update current road length
-    if (i > 0)
-    {
-      curLen += this->points[i].Distance(this->points[i-1]);
-    }
-
-    // assign texture coordinate as percentage of texture tile size
-    // and let ogre/opengl handle the texture wrapping
-    float texCoord = curLen/texMaxLen;
-
-    // Start point is a special case
-    if (i == 0)
-    {
-      tangent = (this->points[i+1] - this->points[i]).Normalize();
-    }
-    // End point is a special case
-    else if (i == this->points.size() - 1)
-    {
-      tangent = (this->points[i] - this->points[i-1]).Normalize();
-    }
-    // Every other point in the road
-    else
+    for (int i = 0; i < _msg.material().script().uri_size(); ++i)
     {
-      auto v1 = (this->points[i+1] - this->points[i]).Normalize();
-      auto v0 = (this->points[i] - this->points[i-1]).Normalize();
-      double dot = v0.Dot(v1 * -1);
-      tangent = (v1+v0).Normalize();
-
-      // Check to see if the points are not colinear
-      // If not colinear, then the road needs to be widended for the turns
-      if (!ignition::math::equal(fabs(dot), 1.0))
-      {
-        factor = 1.0 / sin(acos(dot) * 0.5);
-      }
+      std::string matUri = _msg.material().script().uri(i);
+      if (!matUri.empty())
+        RenderEngine::Instance()->AddResourcePath(matUri);
     }
 
-    // The tangent is used to calculate the two verteces to either side of
-    // the point. The vertices define the triangle mesh of the road
-    double theta = atan2(tangent.X(), -tangent.Y());
-
-    pA = pB = this->points[i];
-    double w = (this->width * factor) * 0.5;
-
-    pA.X() += cos(theta) * w;
-    pA.Y() += sin(theta) * w;
-
-    pB.X() -= cos(theta) * w;
-    pB.Y() -= sin(theta) * w;
-
-    bounds.Min().Min(pA);
-    bounds.Min().Min(pB);
-
-    bounds.Max().Max(pA);
-    bounds.Max().Max(pB);
-
-    // Position
-    *vertices++ = pA.X();
-    *vertices++ = pA.Y();
-    *vertices++ = pA.Z();
+    if (!_msg.material().script().name().empty())
+      material = _msg.material().script().name();
+  }
 
-    // Normal
-    *vertices++ = 0;
-    *vertices++ = 0;
-    *vertices++ = 1;
+  dPtr->network.SetRoad(_msg.name(), points, _msg.width(), material);
+}
 
-    // UV Coord
-    *vertices++ = 0;
-    *vertices++ = texCoord;
+//////////////////////////////////////////////////
+void Road2d::UpdateBatches()
+{
+  Road2dPrivate *dPtr =
+      reinterpret_cast<Road2dPrivate *>(this->dataPtr);
 
-    // Position
-    *vertices++ = pB.X();
-    *vertices++ = pB.Y();
-    *vertices++ = pB.Z();
+  if (!dPtr->sceneNode)
+    return;
 
-    // Normal
-    *vertices++ = 0;
-    *vertices++ = 0;
-    *vertices++ = 1;
+  Ogre::SceneManager *sceneManager = dPtr->sceneNode->getCreator();
+  for (const auto &batch : dPtr->network.Update())
+  {
+    // The entity of the previous mesh of the batch
+    auto iter = dPtr->entities.find(batch);
+    if (iter != dPtr->entities.end())
+    {
+      const std::string meshName = iter->second->getMesh()->getName();
+      dPtr->sceneNode->detachObject(iter->second);
+      sceneManager->destroyEntity(iter->second);
+      Ogre::MeshManager::getSingleton().remove(meshName);
+      dPtr->entities.erase(iter);
+    }
 
-    // UV Coord
-    *vertices++ = 1;
-    *vertices++ = texCoord;
+    const common::Mesh *mesh = dPtr->network.BatchMesh(batch);
+    if (!mesh)
+      continue;
+
+    Visual::InsertMesh(mesh);
+    Ogre::Entity *entity =
+        sceneManager->createEntity(mesh->GetName(), mesh->GetName());
+    entity->setMaterialName(dPtr->network.BatchMaterial(batch));
+    entity->setRenderQueueGroup(entity->getRenderQueueGroup()+1);
+    this->AttachObject(entity);
+    dPtr->entities[batch] = entity;
   }
 
-  // Add all the indices
-  for (unsigned int i = 0; i < subMesh->indexData->indexCount; ++i)
-    *indices++ = i;
-
-  // unlock
-  vBuf->unlock();
-  iBuf->unlock();
-
-  mesh->_setBounds(Ogre::AxisAlignedBox(Conversions::Convert(bounds.Min()),
-                   Conversions::Convert(bounds.Max())));
+  // make the road visual not selectable
+  this->SetVisibilityFlags(GZ_VISIBILITY_ALL & (~GZ_VISIBILITY_SELECTABLE));
+}
 
-  if (_msg.has_material())
-  {
-    if (_msg.material().has_script())
-    {
-      for (int i = 0; i < _msg.material().script().uri_size(); ++i)
-      {
-        std::string matUri = _msg.material().script().uri(i);
-        if (!matUri.empty())
-          RenderEngine::Instance()->AddResourcePath(matUri);
-      }
+//////////////////////////////////////////////////
+void Road2d::DestroyBatches()
+{
+  Road2dPrivate *dPtr =
+      reinterpret_cast<Road2dPrivate *>(this->dataPtr);
 
-      std::string matName = _msg.material().script().name();
+  if (!dPtr || dPtr->entities.empty())
+    return;
 
-      if (!matName.empty())
-        subMesh->setMaterialName(matName);
-     }
-  }
-  else
+  for (const auto &batch : dPtr->entities)
   {
-    subMesh->setMaterialName("Gazebo/Road");
+    const std::string meshName = batch.second->getMesh()->getName();
+    if (dPtr->sceneNode)
+      dPtr->sceneNode->detachObject(batch.second);
+    batch.second->_getManager()->destroyEntity(batch.second);
+    Ogre::MeshManager::getSingleton().remove(meshName);
   }
-
-  mesh->load();
+  dPtr->entities.clear();
 }
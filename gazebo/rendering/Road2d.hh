@@ -31,7 +31,8 @@ namespace gazebo
     /// \{
 
     /// \class Road Road.hh rendering/rendering.hh
-    /// \brief Used to render a strip of road.
+    /// \brief Used to render roads. The roads added to a visual are merged
+    /// into one mesh per material and tile, see common::RoadNetwork.
     class GZ_RENDERING_VISIBLE Road2d : public Visual
     {
       /// \brief Constructor
@@ -45,10 +46,25 @@ namespace gazebo
       /// \brief Destructor
       public: virtual ~Road2d();
 
-      /// \brief Load the visual using a road msg.
+      /// \brief Load the visual, add a road and update the meshes.
       /// \param[in] _msg Message containing road data.
       public: void Load(msgs::Road _msg);
       using Visual::Load;
+
+      // Documentation inherited.
+      public: virtual void Fini();
+
+      /// \brief Add a road, or replace the road with the same name. The
+      /// meshes are regenerated by the next call to UpdateBatches.
+      /// \param[in] _msg Message containing road data.
+      public: void AddRoad(const msgs::Road &_msg);
+
+      /// \brief Regenerate the meshes of the roads added since the last
+      /// update.
+      public: void UpdateBatches();
+
+      /// \brief Destroy the entities and meshes of all the batches.
+      private: void DestroyBatches();
     };
     /// \}
   }
@@ -15,7 +15,14 @@
  *
 */
 
+#include <chrono>
 #include <functional>
+#include <future>
+#include <limits>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <boost/lexical_cast.hpp>
 #include <boost/make_shared.hpp>
@@ -27,9 +34,13 @@
 
 #include "gazebo/msgs/msgs.hh"
 
+#include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Console.hh"
+#include "gazebo/common/MeshManager.hh"
+#include "gazebo/common/MeshRayTree.hh"
+#include "gazebo/common/Profiler.hh"
 #include "gazebo/rendering/Road2d.hh"
 #include "gazebo/rendering/Projector.hh"
 #include "gazebo/rendering/Heightmap.hh"
@@ -49,6 +60,7 @@
 #include "gazebo/rendering/Light.hh"
 #include "gazebo/rendering/Visual.hh"
 #include "gazebo/rendering/RenderEngine.hh"
+#include "gazebo/rendering/RenderingIface.hh"
 #include "gazebo/rendering/UserCamera.hh"
 #include "gazebo/rendering/Camera.hh"
 #include "gazebo/rendering/WideAngleCamera.hh"
@@ -95,6 +107,11 @@ struct VisualMessageLess {
     }
 } VisualMessageLessOp;
 
+/// \brief Time a single PreRender may spend creating visuals. The visuals
+/// which don't fit are created on the following frames, so loading a large
+/// scene doesn't stall rendering.
+static const std::chrono::milliseconds visualFrameBudget(20);
+
 //////////////////////////////////////////////////
 Scene::Scene()
   : dataPtr(new ScenePrivate)
@@ -157,18 +174,21 @@ Scene::Scene(const std::string &_name, const bool _enableVisualizations,
       &Scene::OnLightModifyMsg, this);
 
   this->dataPtr->isServer = _isServer;
-  if (_isServer)
-  {
-    this->dataPtr->poseSub = this->dataPtr->node->Subscribe("~/pose/local/info",
-        &Scene::OnPoseMsg, this);
-  }
-  else
-  // When ready to use the direct API for updating scene poses from server,
-  // uncomment the following line and delete the if and else directly above
-  // if (!_isServer)
+
+  // When physics runs in this process it calls UpdatePoses directly, for
+  // sensor scenes as well as for a GUI scene.
+  if (!direct_scene_poses())
   {
-    this->dataPtr->poseSub = this->dataPtr->node->Subscribe("~/pose/info",
-        &Scene::OnPoseMsg, this);
+    if (_isServer)
+    {
+      this->dataPtr->poseSub = this->dataPtr->node->Subscribe(
+          "~/pose/local/info", &Scene::OnPoseMsg, this);
+    }
+    else
+    {
+      this->dataPtr->poseSub = this->dataPtr->node->Subscribe("~/pose/info",
+          &Scene::OnPoseMsg, this);
+    }
   }
 
   this->dataPtr->jointSub =
@@ -248,6 +268,14 @@ void Scene::Clear()
   {
     std::lock_guard<std::recursive_mutex> lock(this->dataPtr->poseMsgMutex);
     this->dataPtr->poseMsgs.clear();
+    this->dataPtr->scenePosesIncoming.clear();
+    this->dataPtr->scenePosesFront.clear();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->scenePosesMutex);
+    this->dataPtr->scenePosesBack.clear();
+    this->dataPtr->scenePosesUpdated = false;
   }
 
   this->dataPtr->joints.clear();
@@ -259,6 +287,13 @@ void Scene::Clear()
     this->RemoveVisual(this->dataPtr->visuals.begin()->first);
 
   this->dataPtr->visuals.clear();
+  this->dataPtr->visualIds.clear();
+  this->dataPtr->meshRayTrees.clear();
+  this->dataPtr->roads.reset();
+
+  // Wait for the meshes being loaded
+  this->dataPtr->meshLoads.clear();
+  this->dataPtr->loadingVisuals.clear();
 
   if (this->dataPtr->originVisual)
   {
@@ -300,6 +335,11 @@ void Scene::Clear()
   this->dataPtr->skyx = nullptr;
   this->dataPtr->skyxController = nullptr;
 
+  // Instanced entities were destroyed with the visuals
+  this->dataPtr->instances.reset();
+  this->dataPtr->occlusion.reset();
+  this->dataPtr->shadowCache.reset();
+
   RTShaderSystem::Instance()->RemoveScene(this->Name());
 }
 
@@ -399,9 +439,18 @@ void Scene::Init()
   this->dataPtr->raySceneQuery->setQueryMask(
       Ogre::SceneManager::ENTITY_TYPE_MASK);
 
+  this->dataPtr->shadowCache.reset(
+      new ShadowCache(this->dataPtr->manager));
+  this->dataPtr->shadowCache->SetEnabled(this->dataPtr->shadowCaching);
+
   // Force shadows on.
   this->SetShadowsEnabled(true);
 
+  this->dataPtr->instances.reset(
+      new InstancedVisuals(this->dataPtr->manager));
+  this->dataPtr->occlusion.reset(
+      new OcclusionCuller(this->dataPtr->manager));
+
   // Create origin visual
   this->dataPtr->originVisual.reset(new OriginVisual("__WORLD_ORIGIN__",
       this->dataPtr->worldVisual));
@@ -432,29 +481,11 @@ bool Scene::Initialized() const
 void Scene::InitDeferredShading()
 {
 #if OGRE_VERSION_MAJOR > 1 || OGRE_VERSION_MINOR >= 8
-  Ogre::CompositorManager &compMgr = Ogre::CompositorManager::getSingleton();
-
-  // Deferred Shading scheme handler
-  Ogre::MaterialManager::getSingleton().addListener(
-      new GBufferSchemeHandler(GBufferMaterialGenerator::GBT_FAT),
-      "DSGBuffer");
-
-  // Deferred Lighting scheme handlers
-  Ogre::MaterialManager::getSingleton().addListener(
-      new GBufferSchemeHandler(GBufferMaterialGenerator::GBT_NORMAL_AND_DEPTH),
-      "DLGBuffer");
-  Ogre::MaterialManager::getSingleton().addListener(
-      new MergeSchemeHandler(false), "DLMerge");
-
-  Ogre::MaterialManager::getSingleton().addListener(
-      new NullSchemeHandler, "NoGBuffer");
-
-  compMgr.registerCustomCompositionPass("DeferredShadingLight",
-      new DeferredLightCompositionPass<DeferredShading>);
-  compMgr.registerCustomCompositionPass("DeferredLightingLight",
-      new DeferredLightCompositionPass<DeferredLighting>);
-
-  compMgr.registerCompositorLogic("SSAOLogic", new SSAOLogic);
+  if (!RenderEngine::Instance()->InitDeferredShading())
+  {
+    gzerr << "Deferred shading isn't supported by the render system\n";
+    return;
+  }
 
   // Create and instance geometry for VPL
   Ogre::MeshPtr VPLMesh =
@@ -787,10 +818,30 @@ VisualPtr Scene::GetVisual(const uint32_t _id) const
   return VisualPtr();
 }
 
+//////////////////////////////////////////////////
+VisualPtr Scene::VisualByIndexedName(const std::string &_name) const
+{
+  auto nameIter = this->dataPtr->visualIds.find(_name);
+  if (nameIter == this->dataPtr->visualIds.end())
+    return VisualPtr();
+
+  auto iter = this->dataPtr->visuals.find(nameIter->second);
+  if (iter == this->dataPtr->visuals.end() || !iter->second ||
+      iter->second->Name() != _name)
+  {
+    return VisualPtr();
+  }
+  return iter->second;
+}
+
 //////////////////////////////////////////////////
 VisualPtr Scene::GetVisual(const std::string &_name) const
 {
-  VisualPtr result;
+  VisualPtr result = this->VisualByIndexedName(_name);
+  if (result)
+    return result;
+
+  // Visuals which weren't added with AddVisual, or were renamed
 
   Visual_M::const_iterator iter;
   for (iter = this->dataPtr->visuals.begin();
@@ -1091,55 +1142,35 @@ Ogre::Entity *Scene::OgreEntityAt(CameraPtr _camera,
 
       Ogre::Entity *ogreEntity = static_cast<Ogre::Entity*>(iter->movable);
 
-      // mesh data to retrieve
-      size_t vertex_count;
-      size_t index_count;
-      Ogre::Vector3 *vertices;
-      uint64_t *indices;
-
-      // Get the mesh information
-      this->MeshInformation(ogreEntity->getMesh().get(), vertex_count,
-          vertices, index_count, indices,
-          Conversions::ConvertIgn(
-            ogreEntity->getParentNode()->_getDerivedPosition()),
-          Conversions::ConvertIgn(
-          ogreEntity->getParentNode()->_getDerivedOrientation()),
-          Conversions::ConvertIgn(
-          ogreEntity->getParentNode()->_getDerivedScale()));
-
-      bool new_closest_found = false;
-      for (int i = 0; i < static_cast<int>(index_count); i += 3)
-      {
-        // when indices size is not divisible by 3
-        if (i+2 >= static_cast<int>(index_count))
-          break;
-
-        // check for a hit against this triangle
-        std::pair<bool, Ogre::Real> hit = Ogre::Math::intersects(mouseRay,
-            vertices[indices[i]],
-            vertices[indices[i+1]],
-            vertices[indices[i+2]],
-            true, false);
-
-        // if it was a hit check if its the closest
-        if (hit.first)
-        {
-          if ((closest_distance < 0.0f) || (hit.second < closest_distance))
-          {
-            // this is the closest so far, save it off
-            closest_distance = hit.second;
-            new_closest_found = true;
-          }
-        }
-      }
-
-      delete [] vertices;
-      delete [] indices;
+      const common::MeshRayTree *tree =
+          this->OgreMeshRayTree(ogreEntity->getMesh().get());
+      if (!tree)
+        continue;
 
-      if (new_closest_found)
+      // Cast the ray in the frame of the mesh, so that moving the entity
+      // doesn't need its vertices again.
+      const Ogre::Node *node = ogreEntity->getParentNode();
+      const Ogre::Vector3 scale = node->_getDerivedScale();
+      if (scale.x == 0 || scale.y == 0 || scale.z == 0)
+        continue;
+      const Ogre::Quaternion invOrient =
+          node->_getDerivedOrientation().Inverse();
+      const Ogre::Vector3 origin = (invOrient *
+          (mouseRay.getOrigin() - node->_getDerivedPosition())) / scale;
+      const Ogre::Vector3 dir =
+          (invOrient * mouseRay.getDirection()) / scale;
+
+      double distance;
+      ignition::math::Triangle3d triangle;
+      if (tree->Intersect(
+          Conversions::ConvertIgn(origin), Conversions::ConvertIgn(dir),
+          distance, triangle, closest_distance < 0.0f ?
+          std::numeric_limits<double>::max() : closest_distance,
+          scale.x * scale.y * scale.z < 0))
       {
+        // this is the closest so far, save it off
+        closest_distance = distance;
         closestEntity = ogreEntity;
-        // break;
       }
     }
   }
@@ -1404,6 +1435,35 @@ std::string Scene::IdString() const
   return this->dataPtr->idString;
 }
 
+//////////////////////////////////////////////////
+const common::MeshRayTree *Scene::OgreMeshRayTree(const Ogre::Mesh *_mesh)
+{
+  auto iter = this->dataPtr->meshRayTrees.find(_mesh->getHandle());
+  if (iter != this->dataPtr->meshRayTrees.end())
+    return iter->second.get();
+
+  size_t vertexCount;
+  size_t indexCount;
+  Ogre::Vector3 *vertices;
+  uint64_t *indices;
+  this->MeshInformation(_mesh, vertexCount, vertices, indexCount, indices,
+      ignition::math::Vector3d::Zero, ignition::math::Quaterniond::Identity,
+      ignition::math::Vector3d::One);
+
+  std::vector<ignition::math::Vector3d> treeVertices(vertexCount);
+  for (size_t i = 0; i < vertexCount; ++i)
+    treeVertices[i] = Conversions::ConvertIgn(vertices[i]);
+  std::vector<unsigned int> treeIndices(indices, indices + indexCount);
+  delete [] vertices;
+  delete [] indices;
+
+  std::unique_ptr<common::MeshRayTree> tree(new common::MeshRayTree());
+  if (!tree->Build(treeVertices, treeIndices))
+    tree.reset();
+  return this->dataPtr->meshRayTrees.insert(std::make_pair(
+        _mesh->getHandle(), std::move(tree))).first->second.get();
+}
+
 //////////////////////////////////////////////////
 void Scene::MeshInformation(const Ogre::Mesh *_mesh,
                             size_t &_vertex_count,
@@ -1533,17 +1593,8 @@ bool Scene::ProcessSceneMsg(ConstScenePtr &_msg)
     std::lock_guard<std::recursive_mutex> lock(this->dataPtr->poseMsgMutex);
     for (int i = 0; i < _msg->model_size(); ++i)
     {
-      PoseMsgs_M::iterator iter =
-          this->dataPtr->poseMsgs.find(_msg->model(i).id());
-      if (iter != this->dataPtr->poseMsgs.end())
-        iter->second.CopyFrom(_msg->model(i).pose());
-      else
-        this->dataPtr->poseMsgs.insert(
-            std::make_pair(_msg->model(i).id(), _msg->model(i).pose()));
-
-      this->dataPtr->poseMsgs[_msg->model(i).id()].set_name(
-          _msg->model(i).name());
-      this->dataPtr->poseMsgs[_msg->model(i).id()].set_id(_msg->model(i).id());
+      this->dataPtr->poseMsgs[_msg->model(i).id()] =
+          msgs::ConvertIgn(_msg->model(i).pose());
 
       this->ProcessModelMsg(_msg->model(i));
     }
@@ -1627,9 +1678,6 @@ bool Scene::ProcessSceneMsg(ConstScenePtr &_msg)
 //////////////////////////////////////////////////
 bool Scene::ProcessModelMsg(const msgs::Model &_msg)
 {
-  std::string modelName, linkName;
-
-  modelName = _msg.name() + "::";
   for (int j = 0; j < _msg.visual_size(); ++j)
   {
     boost::shared_ptr<msgs::Visual> vm(new msgs::Visual(
@@ -1668,22 +1716,12 @@ bool Scene::ProcessModelMsg(const msgs::Model &_msg)
 
   for (int j = 0; j < _msg.link_size(); ++j)
   {
-    linkName = modelName + _msg.link(j).name();
-
     {
       std::lock_guard<std::recursive_mutex> lock(this->dataPtr->poseMsgMutex);
       if (_msg.link(j).has_pose())
       {
-        PoseMsgs_M::iterator iter =
-            this->dataPtr->poseMsgs.find(_msg.link(j).id());
-        if (iter != this->dataPtr->poseMsgs.end())
-          iter->second.CopyFrom(_msg.link(j).pose());
-        else
-          this->dataPtr->poseMsgs.insert(
-              std::make_pair(_msg.link(j).id(), _msg.link(j).pose()));
-
-        this->dataPtr->poseMsgs[_msg.link(j).id()].set_name(linkName);
-        this->dataPtr->poseMsgs[_msg.link(j).id()].set_id(_msg.link(j).id());
+        this->dataPtr->poseMsgs[_msg.link(j).id()] =
+            msgs::ConvertIgn(_msg.link(j).pose());
       }
     }
 
@@ -1759,6 +1797,7 @@ void Scene::OnVisualMsg(ConstVisualPtr &_msg)
 //////////////////////////////////////////////////
 void Scene::PreRender()
 {
+  GZ_PROFILE("Scene::PreRender");
   /* Deferred shading debug code. Delete me soon (July 17, 2012)
   static bool first = true;
 
@@ -1828,65 +1867,24 @@ void Scene::PreRender()
   LinkMsgs_L linkMsgsCopy;
   RoadMsgs_L roadMsgsCopy;
 
+  // Take the queued messages. Swapping the lists doesn't copy them, so the
+  // receive threads are only held off for a moment.
   {
     std::lock_guard<std::mutex> lock(*this->dataPtr->receiveMutex);
-
-    std::copy(this->dataPtr->sceneMsgs.begin(), this->dataPtr->sceneMsgs.end(),
-              std::back_inserter(sceneMsgsCopy));
-    this->dataPtr->sceneMsgs.clear();
-
-    std::copy(this->dataPtr->modelMsgs.begin(), this->dataPtr->modelMsgs.end(),
-              std::back_inserter(modelMsgsCopy));
-    this->dataPtr->modelMsgs.clear();
-
-    std::copy(this->dataPtr->sensorMsgs.begin(),
-              this->dataPtr->sensorMsgs.end(),
-              std::back_inserter(sensorMsgsCopy));
-    this->dataPtr->sensorMsgs.clear();
-
-    std::copy(this->dataPtr->lightFactoryMsgs.begin(),
-              this->dataPtr->lightFactoryMsgs.end(),
-              std::back_inserter(lightFactoryMsgsCopy));
-    this->dataPtr->lightFactoryMsgs.clear();
-
-    std::copy(this->dataPtr->lightModifyMsgs.begin(),
-              this->dataPtr->lightModifyMsgs.end(),
-              std::back_inserter(lightModifyMsgsCopy));
-    this->dataPtr->lightModifyMsgs.clear();
-
-    std::copy(this->dataPtr->modelVisualMsgs.begin(),
-              this->dataPtr->modelVisualMsgs.end(),
-              std::back_inserter(modelVisualMsgsCopy));
-    this->dataPtr->modelVisualMsgs.clear();
-
-    std::copy(this->dataPtr->linkVisualMsgs.begin(),
-              this->dataPtr->linkVisualMsgs.end(),
-              std::back_inserter(linkVisualMsgsCopy));
-    this->dataPtr->linkVisualMsgs.clear();
-
-    this->dataPtr->visualMsgs.sort(VisualMessageLessOp);
-    std::copy(this->dataPtr->visualMsgs.begin(),
-              this->dataPtr->visualMsgs.end(),
-              std::back_inserter(visualMsgsCopy));
-    this->dataPtr->visualMsgs.clear();
-
-    std::copy(this->dataPtr->collisionVisualMsgs.begin(),
-              this->dataPtr->collisionVisualMsgs.end(),
-              std::back_inserter(collisionVisualMsgsCopy));
-    this->dataPtr->collisionVisualMsgs.clear();
-
-    std::copy(this->dataPtr->jointMsgs.begin(), this->dataPtr->jointMsgs.end(),
-              std::back_inserter(jointMsgsCopy));
-    this->dataPtr->jointMsgs.clear();
-
-    std::copy(this->dataPtr->linkMsgs.begin(), this->dataPtr->linkMsgs.end(),
-              std::back_inserter(linkMsgsCopy));
-    this->dataPtr->linkMsgs.clear();
-
-    std::copy(this->dataPtr->roadMsgs.begin(), this->dataPtr->roadMsgs.end(),
-              std::back_inserter(roadMsgsCopy));
-    this->dataPtr->roadMsgs.clear();
-  }
+    sceneMsgsCopy.swap(this->dataPtr->sceneMsgs);
+    modelMsgsCopy.swap(this->dataPtr->modelMsgs);
+    sensorMsgsCopy.swap(this->dataPtr->sensorMsgs);
+    lightFactoryMsgsCopy.swap(this->dataPtr->lightFactoryMsgs);
+    lightModifyMsgsCopy.swap(this->dataPtr->lightModifyMsgs);
+    modelVisualMsgsCopy.swap(this->dataPtr->modelVisualMsgs);
+    linkVisualMsgsCopy.swap(this->dataPtr->linkVisualMsgs);
+    visualMsgsCopy.swap(this->dataPtr->visualMsgs);
+    collisionVisualMsgsCopy.swap(this->dataPtr->collisionVisualMsgs);
+    jointMsgsCopy.swap(this->dataPtr->jointMsgs);
+    linkMsgsCopy.swap(this->dataPtr->linkMsgs);
+    roadMsgsCopy.swap(this->dataPtr->roadMsgs);
+  }
+  visualMsgsCopy.sort(VisualMessageLessOp);
 
   // Process the scene messages. DO THIS FIRST
   for (sIter = sceneMsgsCopy.begin(); sIter != sceneMsgsCopy.end();)
@@ -1920,9 +1918,18 @@ void Scene::PreRender()
       ++sensorIter;
   }
 
+  // Visuals are created in parent to child order until the frame budget is
+  // spent, the rest are put back in the queues for the next frame
+  const auto visualDeadline =
+      std::chrono::steady_clock::now() + visualFrameBudget;
+  auto inVisualBudget = [&visualDeadline]()
+  {
+    return std::chrono::steady_clock::now() < visualDeadline;
+  };
+
   // Process the model visual messages.
   for (visualIter = modelVisualMsgsCopy.begin();
-      visualIter != modelVisualMsgsCopy.end();)
+      visualIter != modelVisualMsgsCopy.end() && inVisualBudget();)
   {
     if (this->ProcessVisualMsg(*visualIter, Visual::VT_MODEL))
       modelVisualMsgsCopy.erase(visualIter++);
@@ -1932,7 +1939,7 @@ void Scene::PreRender()
 
   // Process the link visual messages.
   for (visualIter = linkVisualMsgsCopy.begin();
-      visualIter != linkVisualMsgsCopy.end();)
+      visualIter != linkVisualMsgsCopy.end() && inVisualBudget();)
   {
     if (this->ProcessVisualMsg(*visualIter, Visual::VT_LINK))
       linkVisualMsgsCopy.erase(visualIter++);
@@ -1941,7 +1948,8 @@ void Scene::PreRender()
   }
 
   // Process the visual messages.
-  for (visualIter = visualMsgsCopy.begin(); visualIter != visualMsgsCopy.end();)
+  for (visualIter = visualMsgsCopy.begin();
+      visualIter != visualMsgsCopy.end() && inVisualBudget();)
   {
     Visual::VisualType visualType = Visual::VT_VISUAL;
     if ((*visualIter)->has_type())
@@ -1955,7 +1963,7 @@ void Scene::PreRender()
 
   // Process the collision visual messages.
   for (visualIter = collisionVisualMsgsCopy.begin();
-      visualIter != collisionVisualMsgsCopy.end();)
+      visualIter != collisionVisualMsgsCopy.end() && inVisualBudget();)
   {
     if (this->ProcessVisualMsg(*visualIter, Visual::VT_COLLISION))
       collisionVisualMsgsCopy.erase(visualIter++);
@@ -2003,48 +2011,64 @@ void Scene::PreRender()
   }
 
   // Process the request messages
+  std::set<std::string> deletedEntities;
   for (rIter =  this->dataPtr->requestMsgs.begin();
       rIter != this->dataPtr->requestMsgs.end(); ++rIter)
   {
+    if ((*rIter)->request() == "entity_delete")
+      deletedEntities.insert((*rIter)->data());
     this->ProcessRequestMsg(*rIter);
   }
   this->dataPtr->requestMsgs.clear();
 
+  // Drop the visuals of deleted entities which haven't been created yet
+  if (!deletedEntities.empty())
   {
-    std::lock_guard<std::mutex> lock(*this->dataPtr->receiveMutex);
-
-    std::copy(sceneMsgsCopy.begin(), sceneMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->sceneMsgs));
-
-    std::copy(modelMsgsCopy.begin(), modelMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->modelMsgs));
-
-    std::copy(sensorMsgsCopy.begin(), sensorMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->sensorMsgs));
-
-    std::copy(lightFactoryMsgsCopy.begin(), lightFactoryMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->lightFactoryMsgs));
-
-    std::copy(lightModifyMsgsCopy.begin(), lightModifyMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->lightModifyMsgs));
-
-    std::copy(modelVisualMsgsCopy.begin(), modelVisualMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->modelVisualMsgs));
-
-    std::copy(linkVisualMsgsCopy.begin(), linkVisualMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->linkVisualMsgs));
-
-    std::copy(visualMsgsCopy.begin(), visualMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->visualMsgs));
-
-    std::copy(collisionVisualMsgsCopy.begin(), collisionVisualMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->collisionVisualMsgs));
-
-    std::copy(jointMsgsCopy.begin(), jointMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->jointMsgs));
+    auto deleted = [&deletedEntities](
+        const boost::shared_ptr<msgs::Visual const> &_msg)
+    {
+      for (auto const &name : deletedEntities)
+      {
+        if (_msg->name() == name ||
+            _msg->name().compare(0, name.size() + 2, name + "::") == 0)
+        {
+          return true;
+        }
+      }
+      return false;
+    };
+    modelVisualMsgsCopy.remove_if(deleted);
+    linkVisualMsgsCopy.remove_if(deleted);
+    visualMsgsCopy.remove_if(deleted);
+    collisionVisualMsgsCopy.remove_if(deleted);
+  }
 
-    std::copy(linkMsgsCopy.begin(), linkMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->linkMsgs));
+  // Put back the messages which couldn't be processed yet, ahead of the
+  // ones received meanwhile
+  {
+    std::lock_guard<std::mutex> lock(*this->dataPtr->receiveMutex);
+    this->dataPtr->sceneMsgs.splice(
+        this->dataPtr->sceneMsgs.begin(), sceneMsgsCopy);
+    this->dataPtr->modelMsgs.splice(
+        this->dataPtr->modelMsgs.begin(), modelMsgsCopy);
+    this->dataPtr->sensorMsgs.splice(
+        this->dataPtr->sensorMsgs.begin(), sensorMsgsCopy);
+    this->dataPtr->lightFactoryMsgs.splice(
+        this->dataPtr->lightFactoryMsgs.begin(), lightFactoryMsgsCopy);
+    this->dataPtr->lightModifyMsgs.splice(
+        this->dataPtr->lightModifyMsgs.begin(), lightModifyMsgsCopy);
+    this->dataPtr->modelVisualMsgs.splice(
+        this->dataPtr->modelVisualMsgs.begin(), modelVisualMsgsCopy);
+    this->dataPtr->linkVisualMsgs.splice(
+        this->dataPtr->linkVisualMsgs.begin(), linkVisualMsgsCopy);
+    this->dataPtr->visualMsgs.splice(
+        this->dataPtr->visualMsgs.begin(), visualMsgsCopy);
+    this->dataPtr->collisionVisualMsgs.splice(
+        this->dataPtr->collisionVisualMsgs.begin(), collisionVisualMsgsCopy);
+    this->dataPtr->jointMsgs.splice(
+        this->dataPtr->jointMsgs.begin(), jointMsgsCopy);
+    this->dataPtr->linkMsgs.splice(
+        this->dataPtr->linkMsgs.begin(), linkMsgsCopy);
   }
 
   // update the rt shader
@@ -2059,41 +2083,39 @@ void Scene::PreRender()
     pIter = this->dataPtr->poseMsgs.begin();
     while (pIter != this->dataPtr->poseMsgs.end())
     {
-      Visual_M::iterator iter = this->dataPtr->visuals.find(pIter->first);
-      if (iter != this->dataPtr->visuals.end() && iter->second)
-      {
-        // If an object is selected, don't let the physics engine move it.
-        if (!this->dataPtr->selectedVis
-            || this->dataPtr->selectionMode != "move" ||
-            (iter->first != this->dataPtr->selectedVis->GetId() &&
-            !this->dataPtr->selectedVis->IsAncestorOf(iter->second)))
-        {
-          ignition::math::Pose3d pose = msgs::ConvertIgn(pIter->second);
-          GZ_ASSERT(iter->second, "Visual pointer is NULL");
-          iter->second->SetPose(pose);
-          PoseMsgs_M::iterator prev = pIter++;
-          this->dataPtr->poseMsgs.erase(prev);
-        }
-        else
-          ++pIter;
-      }
+      if (this->ApplyPose(pIter->first, pIter->second))
+        pIter = this->dataPtr->poseMsgs.erase(pIter);
       else
+        ++pIter;
+    }
+
+    // Process the poses received with the direct API. Swapping the buffers
+    // lets physics write the next poses while these are applied.
+    {
+      std::lock_guard<std::mutex> posesLock(this->dataPtr->scenePosesMutex);
+      std::swap(this->dataPtr->scenePosesBack,
+          this->dataPtr->scenePosesIncoming);
+      if (this->dataPtr->scenePosesUpdated)
       {
-        // process light pose messages
-        auto lIter = this->dataPtr->lights.find(pIter->first);
-        if (lIter != this->dataPtr->lights.end())
-        {
-          ignition::math::Pose3d pose = msgs::ConvertIgn(pIter->second);
-          lIter->second->SetPosition(pose.Pos());
-          lIter->second->SetRotation(pose.Rot());
-          auto prev = pIter++;
-          this->dataPtr->poseMsgs.erase(prev);
-        }
-        else
-          ++pIter;
+        this->dataPtr->sceneSimTimePosesReceived =
+            this->dataPtr->scenePosesTime;
+        this->dataPtr->scenePosesUpdated = false;
       }
     }
 
+    for (auto const &pose : this->dataPtr->scenePosesIncoming)
+      this->dataPtr->scenePosesFront[pose.first] = pose.second;
+    this->dataPtr->scenePosesIncoming.clear();
+
+    for (auto poseIter = this->dataPtr->scenePosesFront.begin();
+         poseIter != this->dataPtr->scenePosesFront.end();)
+    {
+      if (this->ApplyPose(poseIter->first, poseIter->second))
+        poseIter = this->dataPtr->scenePosesFront.erase(poseIter);
+      else
+        ++poseIter;
+    }
+
     // process skeleton pose msgs
     spIter = this->dataPtr->skeletonPoseMsgs.begin();
     while (spIter != this->dataPtr->skeletonPoseMsgs.end())
@@ -2131,26 +2153,22 @@ void Scene::PreRender()
         ++spIter;
     }
 
-    // Process the road messages.
-    for (const auto &msg : roadMsgsCopy)
+    // Process the road messages. All the roads are merged in one visual,
+    // whose meshes are regenerated once for all the messages.
+    if (!roadMsgsCopy.empty())
     {
-      // do not add road if it already exists
-      bool addRoad = true;
-      for (const auto &it : this->dataPtr->visuals)
-      {
-        Road2dPtr road = std::dynamic_pointer_cast<Road2d>(it.second);
-        if (road && road->Name() == msg->name())
-        {
-          addRoad = false;
-          break;
-        }
-      }
-      if (addRoad)
+      if (!this->dataPtr->roads)
       {
-        Road2dPtr road(new Road2d(msg->name(), this->dataPtr->worldVisual));
-        road->Load(*msg);
-        this->dataPtr->visuals[road->GetId()] = road;
+        this->dataPtr->roads.reset(
+            new Road2d("__roads__", this->dataPtr->worldVisual));
+        this->dataPtr->roads->Load();
+        this->dataPtr->visuals[this->dataPtr->roads->GetId()] =
+            this->dataPtr->roads;
       }
+
+      for (const auto &msg : roadMsgsCopy)
+        this->dataPtr->roads->AddRoad(*msg);
+      this->dataPtr->roads->UpdateBatches();
     }
 
     // official time stamp of approval
@@ -2809,6 +2827,32 @@ bool Scene::ProcessVisualMsg(ConstVisualPtr &_msg, Visual::VisualType _type)
     return true;
   }
 
+  // Visuals whose mesh is loading are created once it's loaded, and their
+  // updates wait for them
+  if (this->dataPtr->asyncLoading)
+  {
+    std::string uri;
+    if (_msg->has_geometry() &&
+        _msg->geometry().type() == msgs::Geometry::MESH &&
+        _msg->geometry().has_mesh())
+    {
+      uri = _msg->geometry().mesh().filename();
+    }
+
+    auto loading = this->dataPtr->loadingVisuals.find(_msg->name());
+    if (uri.empty() && loading != this->dataPtr->loadingVisuals.end())
+      uri = loading->second;
+
+    if (!uri.empty() && !this->MeshLoaded(uri))
+    {
+      this->dataPtr->loadingVisuals[_msg->name()] = uri;
+      return false;
+    }
+
+    if (loading != this->dataPtr->loadingVisuals.end())
+      this->dataPtr->loadingVisuals.erase(loading);
+  }
+
   // All other visuals
   VisualPtr visual;
 
@@ -2867,23 +2911,58 @@ void Scene::OnPoseMsg(ConstPosesStampedPtr &_msg)
   this->dataPtr->sceneSimTimePosesReceived =
     common::Time(_msg->time().sec(), _msg->time().nsec());
 
+  // Convert here, on the transport thread, so that PreRender only applies
+  // the poses
   for (int i = 0; i < _msg->pose_size(); ++i)
   {
-    auto p = _msg->pose(i);
-    PoseMsgs_M::iterator iter =
-        this->dataPtr->poseMsgs.find(p.id());
-    if (iter != this->dataPtr->poseMsgs.end())
-      iter->second.CopyFrom(p);
-    else
-      this->dataPtr->poseMsgs.insert(std::make_pair(p.id(), p));
+    auto const &p = _msg->pose(i);
+    this->dataPtr->poseMsgs[p.id()] = msgs::ConvertIgn(p);
+  }
+}
+
+/////////////////////////////////////////////////
+bool Scene::ApplyPose(const uint32_t _id, const ignition::math::Pose3d &_pose)
+{
+  Visual_M::iterator iter = this->dataPtr->visuals.find(_id);
+  if (iter != this->dataPtr->visuals.end() && iter->second)
+  {
+    // If an object is selected, don't let the physics engine move it.
+    if (!this->dataPtr->selectedVis
+        || this->dataPtr->selectionMode != "move" ||
+        (iter->first != this->dataPtr->selectedVis->GetId() &&
+        !this->dataPtr->selectedVis->IsAncestorOf(iter->second)))
+    {
+      iter->second->SetPose(_pose);
+      return true;
+    }
+    return false;
   }
+
+  // process light poses
+  auto lIter = this->dataPtr->lights.find(_id);
+  if (lIter != this->dataPtr->lights.end())
+  {
+    lIter->second->SetPosition(_pose.Pos());
+    lIter->second->SetRotation(_pose.Rot());
+    return true;
+  }
+
+  return false;
 }
 
 /////////////////////////////////////////////////
 void Scene::UpdatePoses(const msgs::PosesStamped &_msg)
 {
-  auto msgptr = boost::make_shared<const msgs::PosesStamped>(_msg);
-  this->OnPoseMsg(msgptr);
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->scenePosesMutex);
+    this->dataPtr->scenePosesTime = msgs::Convert(_msg.time());
+    this->dataPtr->scenePosesUpdated = true;
+    for (int i = 0; i < _msg.pose_size(); ++i)
+    {
+      auto const &pose = _msg.pose(i);
+      this->dataPtr->scenePosesBack[pose.id()] = msgs::ConvertIgn(pose);
+    }
+  }
 
   std::unique_lock<std::mutex> lck(this->dataPtr->newPoseMutex);
   this->dataPtr->newPoseAvailable = true;
@@ -3161,6 +3240,9 @@ void Scene::SetShadowsEnabled(bool _value)
 
   this->dataPtr->sdf->GetElement("shadows")->Set(_value);
 
+  if (this->dataPtr->shadowCache)
+    this->dataPtr->shadowCache->Invalidate();
+
   if (RenderEngine::Instance()->GetRenderPathType() == RenderEngine::DEFERRED)
   {
 #if OGRE_VERSION_MAJOR >= 1 && OGRE_VERSION_MINOR >= 8
@@ -3220,6 +3302,120 @@ bool Scene::ShadowsEnabled() const
   return this->dataPtr->sdf->Get<bool>("shadows");
 }
 
+/////////////////////////////////////////////////
+void Scene::SetInstancing(const bool _enable)
+{
+  if (_enable == this->dataPtr->instancing)
+    return;
+
+  if (_enable && (!this->dataPtr->instances ||
+      !this->dataPtr->instances->Supported()))
+  {
+    gzwarn << "Hardware instancing is not supported, visuals of scene["
+           << this->Name() << "] will not be instanced" << std::endl;
+  }
+
+  this->dataPtr->instancing = _enable;
+
+  for (auto &vis : this->dataPtr->visuals)
+  {
+    if (vis.second)
+      vis.second->UpdateInstancing();
+  }
+}
+
+/////////////////////////////////////////////////
+bool Scene::Instancing() const
+{
+  return this->dataPtr->instancing;
+}
+
+/////////////////////////////////////////////////
+void Scene::SetAsyncLoading(const bool _enable)
+{
+  this->dataPtr->asyncLoading = _enable;
+}
+
+/////////////////////////////////////////////////
+bool Scene::AsyncLoading() const
+{
+  return this->dataPtr->asyncLoading;
+}
+
+/////////////////////////////////////////////////
+bool Scene::MeshLoaded(const std::string &_uri)
+{
+  if (this->dataPtr->loadedMeshes.count(_uri))
+    return true;
+
+  auto iter = this->dataPtr->meshLoads.find(_uri);
+  if (iter == this->dataPtr->meshLoads.end())
+  {
+    // Level of detail generation is the slowest part of large meshes, so
+    // it's done on the worker too
+    this->dataPtr->meshLoads[_uri] = std::async(std::launch::async,
+        [_uri]()
+        {
+          std::string filename = common::find_file(_uri);
+          common::MeshManager *manager = common::MeshManager::Instance();
+          if (filename.empty() || !manager->IsValidFilename(filename))
+            return;
+
+          try
+          {
+            manager->MeshLods(manager->Load(filename));
+          }
+          catch(common::Exception &)
+          {
+            // Reported again when the visual loads the mesh
+          }
+        });
+    return false;
+  }
+
+  if (iter->second.wait_for(std::chrono::seconds(0)) !=
+      std::future_status::ready)
+  {
+    return false;
+  }
+
+  this->dataPtr->meshLoads.erase(iter);
+  this->dataPtr->loadedMeshes.insert(_uri);
+  return true;
+}
+
+/////////////////////////////////////////////////
+InstancedVisuals *Scene::Instances() const
+{
+  return this->dataPtr->instances.get();
+}
+
+/////////////////////////////////////////////////
+OcclusionCuller *Scene::Occlusion() const
+{
+  return this->dataPtr->occlusion.get();
+}
+
+/////////////////////////////////////////////////
+ShadowCache *Scene::Shadows() const
+{
+  return this->dataPtr->shadowCache.get();
+}
+
+/////////////////////////////////////////////////
+void Scene::SetShadowCaching(const bool _enable)
+{
+  this->dataPtr->shadowCaching = _enable;
+  if (this->dataPtr->shadowCache)
+    this->dataPtr->shadowCache->SetEnabled(_enable);
+}
+
+/////////////////////////////////////////////////
+bool Scene::ShadowCaching() const
+{
+  return this->dataPtr->shadowCaching;
+}
+
 /////////////////////////////////////////////////
 bool Scene::SetShadowTextureSize(const unsigned int _size)
 {
@@ -3273,6 +3469,14 @@ void Scene::AddVisual(VisualPtr _vis)
   }
 
   this->dataPtr->visuals[_vis->GetId()] = _vis;
+
+  // Keep the first visual of a name, unless it was renamed or removed
+  auto nameIter = this->dataPtr->visualIds.find(_vis->Name());
+  if (nameIter == this->dataPtr->visualIds.end() ||
+      this->VisualByIndexedName(_vis->Name()) == nullptr)
+  {
+    this->dataPtr->visualIds[_vis->Name()] = _vis->GetId();
+  }
 }
 
 /////////////////////////////////////////////////
@@ -3300,6 +3504,13 @@ void Scene::RemoveVisual(uint32_t _id)
     }
     this->dataPtr->visuals.erase(iter);
 
+    auto nameIter = this->dataPtr->visualIds.find(vis->Name());
+    if (nameIter != this->dataPtr->visualIds.end() &&
+        nameIter->second == _id)
+    {
+      this->dataPtr->visualIds.erase(nameIter);
+    }
+
     this->RemoveVisualizations(vis);
     vis->Fini();
 
@@ -3324,6 +3535,13 @@ void Scene::SetVisualId(VisualPtr _vis, uint32_t _id)
   auto iter = this->dataPtr->visuals.find(_vis->GetId());
   if (iter != this->dataPtr->visuals.end())
   {
+    auto nameIter = this->dataPtr->visualIds.find(_vis->Name());
+    if (nameIter != this->dataPtr->visualIds.end() &&
+        nameIter->second == _vis->GetId())
+    {
+      nameIter->second = _id;
+    }
+
     this->dataPtr->visuals.erase(_vis->GetId());
     this->dataPtr->visuals[_id] = _vis;
     _vis->SetId(_id);
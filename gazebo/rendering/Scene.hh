@@ -48,12 +48,20 @@ namespace SkyX
 
 namespace gazebo
 {
+  namespace common
+  {
+    class MeshRayTree;
+  }
+
   namespace rendering
   {
     class Visual;
     class Grid;
     class Heightmap;
+    class InstancedVisuals;
+    class OcclusionCuller;
     class ScenePrivate;
+    class ShadowCache;
 
     /// \addtogroup gazebo_rendering
     /// \{
@@ -413,6 +421,64 @@ namespace gazebo
       /// \return Size of the shadow texture. The default size is 1024.
       public: unsigned int ShadowTextureSize() const;
 
+      /// \brief Set whether shadow textures are reused across renders.
+      /// A shadow texture is rendered again only if its shadow camera
+      /// changed or a shadow caster moved since it was last rendered, so
+      /// static cameras, and cameras sharing a pose, render the shadows of
+      /// a static scene once. Off by default, which renders the shadows
+      /// for every camera update.
+      /// \param[in] _enable True to reuse shadow textures.
+      public: void SetShadowCaching(const bool _enable);
+
+      /// \brief Get whether shadow textures are reused across renders.
+      /// \return True if shadow textures are reused.
+      /// \sa SetShadowCaching
+      public: bool ShadowCaching() const;
+
+      /// \brief Set whether visuals drawing the same mesh with the same
+      /// appearance are drawn with hardware instancing, one draw call per
+      /// batch of visuals. Off by default. Visuals whose material can't be
+      /// instanced, and visuals whose appearance is changed after they
+      /// are loaded, are drawn as before. Instanced visuals don't cast
+      /// shadows, and are not drawn correctly by GPU lasers and depth
+      /// cameras, which replace the programs of the objects they render.
+      /// \param[in] _enable True to instance visuals.
+      public: void SetInstancing(const bool _enable);
+
+      /// \brief Get whether visuals are instanced.
+      /// \return True if instancing is enabled.
+      /// \sa SetInstancing
+      public: bool Instancing() const;
+
+      /// \brief Set whether the meshes of new visuals are loaded on worker
+      /// threads. A visual whose mesh isn't loaded yet is created in the
+      /// first PreRender after its mesh is ready, and its updates wait for
+      /// it, so inserting a large model doesn't stall rendering. Off by
+      /// default, which creates visuals in the PreRender that receives
+      /// them. Textures are still loaded when the visual is created.
+      /// \param[in] _enable True to load meshes on worker threads.
+      public: void SetAsyncLoading(const bool _enable);
+
+      /// \brief Get whether meshes are loaded on worker threads.
+      /// \return True if meshes are loaded on worker threads.
+      /// \sa SetAsyncLoading
+      public: bool AsyncLoading() const;
+
+      /// \internal
+      /// \brief Get the instance batches of the scene.
+      /// \return The batches, or nullptr if the scene is not initialized.
+      public: InstancedVisuals *Instances() const;
+
+      /// \internal
+      /// \brief Get the occlusion culling of the cameras of the scene.
+      /// \return The culling, or nullptr if the scene is not initialized.
+      public: OcclusionCuller *Occlusion() const;
+
+      /// \internal
+      /// \brief Get the cache of the shadow textures of the scene.
+      /// \return The cache, or nullptr if the scene is not initialized.
+      public: ShadowCache *Shadows() const;
+
       /// \brief Add a visual to the scene
       /// \param[in] _vis Visual to add.
       public: void AddVisual(VisualPtr _vis);
@@ -559,8 +625,11 @@ namespace gazebo
       public: common::Time SimTime() const;
 
       /// \brief Update Poses of objects in the scene via direct API call
-      /// instead of transport.
+      /// instead of transport. The poses are written to a buffer that is
+      /// swapped with the one read by PreRender, so this only blocks for
+      /// the time it takes to copy the poses.
       /// \param[in] _msg The message data.
+      /// \sa rendering::set_direct_scene_poses
       public: void UpdatePoses(const msgs::PosesStamped& _msg);
 
       /// \brief Get the number of visuals.
@@ -616,6 +685,14 @@ namespace gazebo
           const ignition::math::Vector2i &_mousePos,
           const bool _ignoreSelectionObj);
 
+      /// \brief Get the ray tree of an Ogre mesh, built from its vertex
+      /// buffers on first use and kept until the scene is cleared.
+      /// \param[in] _mesh The mesh.
+      /// \return The tree, in the frame of the mesh, or nullptr if the
+      /// mesh has no triangles.
+      private: const common::MeshRayTree *OgreMeshRayTree(
+                   const Ogre::Mesh *_mesh);
+
       /// \brief Get the mesh information for the given mesh.
       /// \param[in] _mesh Mesh to get info about.
       /// \param[out] _vertexCount Number of vertices in the mesh.
@@ -670,6 +747,18 @@ namespace gazebo
       /// \param[in] _msg The message data.
       private: bool ProcessLinkMsg(ConstLinkPtr &_msg);
 
+      /// \brief Get whether a mesh is loaded, and start loading it on a
+      /// worker thread if it isn't.
+      /// \param[in] _uri URI of the mesh.
+      /// \return True if the mesh was loaded.
+      private: bool MeshLoaded(const std::string &_uri);
+
+      /// \brief Get a visual added with AddVisual by name, through the
+      /// name index.
+      /// \param[in] _name Name of the visual.
+      /// \return The visual, or nullptr if it isn't indexed under _name.
+      private: VisualPtr VisualByIndexedName(const std::string &_name) const;
+
       /// \brief Proces a scene message.
       /// \param[in] _msg The message data.
       private: bool ProcessSceneMsg(ConstScenePtr &_msg);
@@ -725,6 +814,14 @@ namespace gazebo
       /// \param[in] _msg The message data.
       private: void OnPoseMsg(ConstPosesStampedPtr &_msg);
 
+      /// \brief Set the pose of a visual or light received from physics.
+      /// \param[in] _id Id of the visual or light.
+      /// \param[in] _pose New pose.
+      /// \return False if the pose has to be applied again later, because
+      /// the visual doesn't exist yet or is being moved by the user.
+      private: bool ApplyPose(const uint32_t _id,
+                   const ignition::math::Pose3d &_pose);
+
       /// \brief Skeleton animation callback.
       /// \param[in] _msg The message data.
       private: void OnSkeletonPoseMsg(ConstPoseAnimationPtr &_msg);
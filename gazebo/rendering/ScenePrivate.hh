@@ -19,20 +19,28 @@
 
 #include <list>
 #include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <mutex>
 #include <condition_variable>
+#include <future>
+#include <unordered_set>
 
 #include <boost/unordered/unordered_map.hpp>
 
 #include <sdf/sdf.hh>
 
 #include "gazebo/common/Events.hh"
+#include "gazebo/common/MeshRayTree.hh"
 #include "gazebo/gazebo_config.h"
 #include "gazebo/msgs/msgs.hh"
+#include "gazebo/rendering/InstancedVisuals.hh"
 #include "gazebo/rendering/MarkerManager.hh"
+#include "gazebo/rendering/OcclusionCuller.hh"
 #include "gazebo/rendering/RenderTypes.hh"
+#include "gazebo/rendering/ShadowCache.hh"
 #include "gazebo/transport/TransportTypes.hh"
 
 namespace SkyX
@@ -57,8 +65,8 @@ namespace gazebo
     class Heightmap;
 
     /// \def Visual_M
-    /// \brief Map of visuals and their names.
-    typedef std::map<uint32_t, VisualPtr> Visual_M;
+    /// \brief Map of visuals and their ids.
+    typedef std::unordered_map<uint32_t, VisualPtr> Visual_M;
 
     /// \def VisualMsgs_L
     /// \brief List of visual messages.
@@ -69,8 +77,14 @@ namespace gazebo
     typedef std::list<boost::shared_ptr<msgs::Light const> > LightMsgs_L;
 
     /// \typedef PoseMsgs_M.
-    /// \brief List of messages.
-    typedef std::map<uint32_t, msgs::Pose> PoseMsgs_M;
+    /// \brief Poses received in messages, converted when they are
+    /// received, indexed by id.
+    typedef std::unordered_map<uint32_t, ignition::math::Pose3d> PoseMsgs_M;
+
+    /// \typedef ScenePoses_M.
+    /// \brief Poses received with the direct API, indexed by id.
+    typedef std::unordered_map<uint32_t, ignition::math::Pose3d>
+        ScenePoses_M;
 
     /// \typedef LightPoseMsgs_M.
     /// \brief List of messages.
@@ -151,6 +165,12 @@ namespace gazebo
       /// \brief A ray query used to locate distances to visuals.
       public: Ogre::RaySceneQuery *raySceneQuery = nullptr;
 
+      /// \brief Ray trees of the Ogre meshes picked by OgreEntityAt,
+      /// indexed by resource handle, which a reloaded mesh doesn't reuse.
+      /// A null tree marks a mesh without triangles.
+      public: std::map<uint64_t, std::unique_ptr<common::MeshRayTree>>
+              meshRayTrees;
+
       /// \brief All the grids in the scene.
       public: std::vector<Grid *> grids;
 
@@ -208,6 +228,10 @@ namespace gazebo
       /// \brief Map of all the visuals in this scene.
       public: Visual_M visuals;
 
+      /// \brief Ids of the visuals added with AddVisual, by name. Visuals
+      /// can be renamed, so entries are checked against the visual.
+      public: std::unordered_map<std::string, uint32_t> visualIds;
+
       /// \brief Map of all the lights in this scene.
       public: Light_M lights;
 
@@ -217,6 +241,9 @@ namespace gazebo
       /// \brief List of road messages to process.
       public: RoadMsgs_L roadMsgs;
 
+      /// \brief Visual of all the roads, created by the first road message.
+      public: Road2dPtr roads;
+
       /// \brief used to wake up upon new Pose available
       public: std::condition_variable newPoseCondition;
 
@@ -232,6 +259,28 @@ namespace gazebo
       /// \brief Mutex to lock the pose message buffers.
       public: std::recursive_mutex poseMsgMutex;
 
+      /// \brief Poses written by UpdatePoses, protected by
+      /// scenePosesMutex.
+      public: ScenePoses_M scenePosesBack;
+
+      /// \brief Buffer swapped with scenePosesBack by PreRender. Only used
+      /// by the rendering thread.
+      public: ScenePoses_M scenePosesIncoming;
+
+      /// \brief Poses waiting to be applied, e.g. because their visual
+      /// doesn't exist yet. Only used by the rendering thread.
+      public: ScenePoses_M scenePosesFront;
+
+      /// \brief Sim time of the poses in scenePosesBack.
+      public: common::Time scenePosesTime;
+
+      /// \brief True if UpdatePoses was called since the last swap.
+      public: bool scenePosesUpdated = false;
+
+      /// \brief Mutex to protect scenePosesBack, scenePosesTime and
+      /// scenePosesUpdated.
+      public: std::mutex scenePosesMutex;
+
       /// \brief Communication Node
       public: transport::NodePtr node;
 
@@ -376,6 +425,34 @@ namespace gazebo
       /// \brief State of each layer where key is the layer id, and value is
       /// the layer's visibility.
       public: std::map<int32_t, bool> layerState;
+
+      /// \brief Instance batches of the visuals.
+      public: std::unique_ptr<InstancedVisuals> instances;
+
+      /// \brief True when visuals should be instanced.
+      public: bool instancing = false;
+
+      /// \brief Occlusion culling of the cameras.
+      public: std::unique_ptr<OcclusionCuller> occlusion;
+
+      /// \brief Reuse of the shadow textures.
+      public: std::unique_ptr<ShadowCache> shadowCache;
+
+      /// \brief True when shadow textures should be reused.
+      public: bool shadowCaching = false;
+
+      /// \brief True to load the meshes of new visuals on worker threads.
+      public: bool asyncLoading = false;
+
+      /// \brief Meshes being loaded on worker threads, by URI.
+      public: std::unordered_map<std::string, std::future<void>> meshLoads;
+
+      /// \brief URIs of the meshes loaded on worker threads.
+      public: std::unordered_set<std::string> loadedMeshes;
+
+      /// \brief Mesh URI of the visuals waiting for their mesh, by visual
+      /// name.
+      public: std::unordered_map<std::string, std::string> loadingVisuals;
     };
   }
 }
@@ -16,7 +16,11 @@
 */
 
 #include <gtest/gtest.h>
+#include "gazebo/common/CommonIface.hh"
+#include "gazebo/common/MeshManager.hh"
+#include "gazebo/rendering/Camera.hh"
 #include "gazebo/rendering/Scene.hh"
+#include "gazebo/rendering/ShadowCache.hh"
 #include "gazebo/test/ServerFixture.hh"
 
 
@@ -402,6 +406,224 @@ TEST_F(Scene_TEST, AddRemoveLights)
   EXPECT_FALSE(scene->LightByName("light1"));
 }
 
+/////////////////////////////////////////////////
+TEST_F(Scene_TEST, DirectPoses)
+{
+  // The server in this process updates the scene without transport
+  EXPECT_TRUE(rendering::direct_scene_poses());
+
+  Load("worlds/shapes.world", true);
+
+  gazebo::rendering::ScenePtr scene = gazebo::rendering::get_scene();
+  ASSERT_TRUE(scene != nullptr);
+
+  // Wait until the box is inserted
+  int sleep = 0;
+  int maxSleep = 10;
+  rendering::VisualPtr box;
+  while (!box && sleep < maxSleep)
+  {
+    event::Events::preRender();
+    event::Events::render();
+    event::Events::postRender();
+
+    box = scene->GetVisual("box");
+    common::Time::MSleep(1000);
+    sleep++;
+  }
+  ASSERT_TRUE(box != nullptr);
+
+  ignition::math::Pose3d pose(1, 2, 3, 0, 0, 0.5);
+  msgs::PosesStamped msg;
+  msgs::Set(msg.mutable_time(), common::Time(12, 0));
+  msgs::Pose *poseMsg = msg.add_pose();
+  poseMsg->set_name("box");
+  poseMsg->set_id(box->GetId());
+  msgs::Set(poseMsg, pose);
+
+  // Poses of visuals that don't exist yet are kept until they do
+  poseMsg = msg.add_pose();
+  poseMsg->set_name("not_yet_created");
+  poseMsg->set_id(box->GetId() + 10000);
+  msgs::Set(poseMsg, pose);
+
+  scene->UpdatePoses(msg);
+  scene->PreRender();
+  EXPECT_EQ(pose, box->WorldPose());
+  EXPECT_EQ(common::Time(12, 0), scene->SimTime());
+
+  // A later pose replaces the one that wasn't applied yet
+  ignition::math::Pose3d pose2(4, 5, 6, 0, 0, 0);
+  msgs::Set(msg.mutable_time(), common::Time(13, 0));
+  msgs::Set(msg.mutable_pose(0), pose2);
+  scene->UpdatePoses(msg);
+  scene->PreRender();
+  EXPECT_EQ(pose2, box->WorldPose());
+  EXPECT_EQ(common::Time(13, 0), scene->SimTime());
+}
+
+/////////////////////////////////////////////////
+TEST_F(Scene_TEST, DirectPosesBeforeInit)
+{
+  Load("worlds/shapes.world", true);
+
+  gazebo::rendering::ScenePtr scene = gazebo::rendering::get_scene();
+  ASSERT_TRUE(scene != nullptr);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  physics::ModelPtr model = world->ModelByName("box");
+  ASSERT_TRUE(model != nullptr);
+
+  // The scene is initialized by its first render
+  EXPECT_FALSE(scene->Initialized());
+
+  ignition::math::Pose3d pose(1, 2, 3, 0, 0, 0.5);
+  msgs::PosesStamped msg;
+  msgs::Set(msg.mutable_time(), common::Time(12, 0));
+  msgs::Pose *poseMsg = msg.add_pose();
+  poseMsg->set_name("box");
+  poseMsg->set_id(model->GetId());
+  msgs::Set(poseMsg, pose);
+  rendering::update_scene_poses(scene->Name(), msg);
+
+  // The pose is applied once the scene and the box exist
+  int sleep = 0;
+  int maxSleep = 10;
+  rendering::VisualPtr box;
+  while ((!box || box->WorldPose() != pose) && sleep < maxSleep)
+  {
+    event::Events::preRender();
+    event::Events::render();
+    event::Events::postRender();
+
+    box = scene->GetVisual("box");
+    common::Time::MSleep(1000);
+    sleep++;
+  }
+  EXPECT_TRUE(scene->Initialized());
+  ASSERT_TRUE(box != nullptr);
+  EXPECT_EQ(pose, box->WorldPose());
+}
+
+
+/////////////////////////////////////////////////
+TEST_F(Scene_TEST, AsyncLoading)
+{
+  Load("worlds/empty.world");
+
+  gazebo::rendering::ScenePtr scene = gazebo::rendering::get_scene();
+  ASSERT_TRUE(scene != nullptr);
+
+  EXPECT_FALSE(scene->AsyncLoading());
+  scene->SetAsyncLoading(true);
+  EXPECT_TRUE(scene->AsyncLoading());
+
+  const std::string uri = "file://media/models/chair3/models/chair.stl";
+  const std::string filename = common::find_file(uri);
+  ASSERT_FALSE(filename.empty());
+  EXPECT_FALSE(common::MeshManager::Instance()->HasMesh(filename));
+
+  transport::NodePtr node = transport::NodePtr(new transport::Node());
+  node->Init();
+  transport::PublisherPtr visPub = node->Advertise<msgs::Visual>("~/visual");
+  visPub->WaitForConnection();
+
+  msgs::Visual msg;
+  msg.set_name("async_chair");
+  msg.set_parent_name(scene->Name());
+  msg.mutable_geometry()->set_type(msgs::Geometry::MESH);
+  msg.mutable_geometry()->mutable_mesh()->set_filename(uri);
+  visPub->Publish(msg);
+
+  // The visual is created once its mesh is loaded
+  int sleep = 0;
+  int maxSleep = 50;
+  rendering::VisualPtr vis;
+  while (!vis && sleep < maxSleep)
+  {
+    event::Events::preRender();
+    event::Events::render();
+    event::Events::postRender();
+
+    vis = scene->GetVisual("async_chair");
+    common::Time::MSleep(100);
+    sleep++;
+  }
+  ASSERT_TRUE(vis != nullptr);
+  EXPECT_TRUE(common::MeshManager::Instance()->HasMesh(filename));
+  EXPECT_EQ(filename, vis->GetMeshName());
+
+  scene->SetAsyncLoading(false);
+}
+
+/////////////////////////////////////////////////
+TEST_F(Scene_TEST, ShadowCaching)
+{
+  Load("worlds/shapes.world");
+
+  gazebo::rendering::ScenePtr scene = gazebo::rendering::get_scene();
+  ASSERT_TRUE(scene != nullptr);
+
+  // Wait until the box is inserted
+  int sleep = 0;
+  int maxSleep = 10;
+  rendering::VisualPtr box;
+  while (!box && sleep < maxSleep)
+  {
+    event::Events::preRender();
+    event::Events::render();
+    event::Events::postRender();
+
+    box = scene->GetVisual("box");
+    common::Time::MSleep(1000);
+    sleep++;
+  }
+  ASSERT_TRUE(box != nullptr);
+
+  rendering::ShadowCache *cache = scene->Shadows();
+  ASSERT_TRUE(cache != nullptr);
+  EXPECT_FALSE(scene->ShadowCaching());
+  EXPECT_FALSE(cache->Enabled());
+
+  scene->SetShadowCaching(true);
+  EXPECT_TRUE(scene->ShadowCaching());
+  EXPECT_TRUE(cache->Enabled());
+
+  rendering::CameraPtr camera =
+      scene->CreateCamera("test_camera_shadows", false);
+  ASSERT_TRUE(camera != nullptr);
+  camera->Load();
+  camera->Init();
+  camera->SetImageWidth(160);
+  camera->SetImageHeight(120);
+  camera->CreateRenderTexture("test_camera_shadows_RttTex");
+  camera->SetWorldPose(ignition::math::Pose3d(-5, 0, 2, 0, 0.3, 0));
+
+  camera->Render(true);
+  camera->PostRender();
+  unsigned int reused = cache->ReusedCount();
+
+  // Nothing moved, the shadows of the camera are reused
+  camera->Render(true);
+  camera->PostRender();
+  if (scene->ShadowsEnabled())
+    EXPECT_GT(cache->ReusedCount(), reused);
+
+  // A moved caster renders the shadows again
+  reused = cache->ReusedCount();
+  box->SetWorldPose(ignition::math::Pose3d(0, 3, 0.5, 0, 0, 0));
+  camera->Render(true);
+  camera->PostRender();
+  EXPECT_EQ(reused, cache->ReusedCount());
+
+  scene->SetShadowCaching(false);
+  EXPECT_FALSE(cache->Enabled());
+  camera->Render(true);
+  camera->PostRender();
+  EXPECT_EQ(reused, cache->ReusedCount());
+
+  scene->RemoveCamera(camera->Name());
+}
 
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
@@ -0,0 +1,289 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <cmath>
+#include <functional>
+#include <unordered_map>
+
+#include "gazebo/rendering/ogre_gazebo.h"
+
+#include "gazebo/rendering/ShadowCache.hh"
+
+using namespace gazebo;
+using namespace rendering;
+
+namespace
+{
+  /// \brief Largest difference between the elements of two matrices
+  /// that are considered equal.
+  const Ogre::Real kMatrixTolerance = 1e-5;
+
+  /// \brief Combine a value with a hash.
+  /// \param[in,out] _seed The hash.
+  /// \param[in] _value The value.
+  template<typename T>
+  void HashCombine(std::size_t &_seed, const T &_value)
+  {
+    _seed ^= std::hash<T>()(_value) + 0x9e3779b9 + (_seed << 6) +
+        (_seed >> 2);
+  }
+
+  /// \brief Combine a matrix with a hash.
+  /// \param[in,out] _seed The hash.
+  /// \param[in] _matrix The matrix.
+  void HashCombine(std::size_t &_seed, const Ogre::Matrix4 &_matrix)
+  {
+    for (unsigned int r = 0; r < 4; ++r)
+      for (unsigned int c = 0; c < 4; ++c)
+        HashCombine(_seed, static_cast<float>(_matrix[r][c]));
+  }
+
+  /// \brief Compare two matrices.
+  /// \param[in] _a First matrix.
+  /// \param[in] _b Second matrix.
+  /// \return True if their elements differ by less than kMatrixTolerance.
+  bool MatrixEqual(const Ogre::Matrix4 &_a, const Ogre::Matrix4 &_b)
+  {
+    for (unsigned int r = 0; r < 4; ++r)
+    {
+      for (unsigned int c = 0; c < 4; ++c)
+      {
+        if (std::abs(_a[r][c] - _b[r][c]) > kMatrixTolerance)
+          return false;
+      }
+    }
+    return true;
+  }
+
+  /// \brief Content of a shadow texture.
+  struct ShadowState
+  {
+    /// \brief View matrix of the shadow camera.
+    Ogre::Matrix4 view;
+
+    /// \brief Projection matrix of the shadow camera.
+    Ogre::Matrix4 projection;
+
+    /// \brief Visibility mask of the shadow viewport.
+    uint32_t mask = 0;
+
+    /// \brief Hash of the shadow casters.
+    std::size_t casters = 0;
+  };
+}
+
+namespace gazebo
+{
+  namespace rendering
+  {
+    /// \internal
+    /// \brief Private data for the ShadowCache class
+    class ShadowCachePrivate : public Ogre::SceneManager::Listener
+    {
+      /// \brief Skip the update of a shadow texture whose content would
+      /// not change.
+      /// \param[in] _light Light casting the shadows.
+      /// \param[in] _camera Shadow camera, set up for the update.
+      /// \param[in] _iteration Index of the texture for the light.
+      public: virtual void shadowTextureCasterPreViewProj(
+                  Ogre::Light * /*_light*/, Ogre::Camera *_camera,
+                  size_t _iteration)
+      {
+        Ogre::Viewport *viewport = nullptr;
+        Ogre::ResourceHandle handle = 0;
+        for (size_t i = 0; i < this->manager->getShadowTextureCount() &&
+            !viewport; ++i)
+        {
+          const Ogre::TexturePtr &texture = this->manager->getShadowTexture(i);
+          if (!texture.get())
+            continue;
+
+          Ogre::RenderTarget *target =
+              texture->getBuffer()->getRenderTarget();
+          if (target->getNumViewports() > 0 &&
+              target->getViewport(0)->getCamera() == _camera)
+          {
+            viewport = target->getViewport(0);
+            handle = texture->getHandle();
+          }
+        }
+
+        if (!viewport)
+          return;
+
+        if (!this->enabled)
+        {
+          viewport->setAutoUpdated(true);
+          return;
+        }
+
+        // The casters are checked once for the textures of a light
+        if (_iteration == 0)
+          this->casters = this->CasterHash();
+
+        // Texture handles are not reused, so recreated textures are
+        // always rendered
+        auto iter = this->states.find(handle);
+        bool reuse = iter != this->states.end() &&
+            iter->second.casters == this->casters &&
+            iter->second.mask == viewport->getVisibilityMask() &&
+            MatrixEqual(iter->second.view, _camera->getViewMatrix()) &&
+            MatrixEqual(iter->second.projection,
+            _camera->getProjectionMatrix());
+
+        viewport->setAutoUpdated(!reuse);
+        if (reuse)
+        {
+          ++this->reused;
+          return;
+        }
+
+        ShadowState &state = this->states[handle];
+        state.view = _camera->getViewMatrix();
+        state.projection = _camera->getProjectionMatrix();
+        state.mask = viewport->getVisibilityMask();
+        state.casters = this->casters;
+      }
+
+      /// \brief Hash the poses of the shadow casters.
+      /// \return Hash of the shadow casters.
+      public: std::size_t CasterHash() const
+      {
+        std::size_t seed = 0;
+        for (auto const &type : {Ogre::EntityFactory::FACTORY_TYPE_NAME,
+            Ogre::ManualObjectFactory::FACTORY_TYPE_NAME})
+        {
+          Ogre::SceneManager::MovableObjectIterator objects =
+              this->manager->getMovableObjectIterator(type);
+          while (objects.hasMoreElements())
+          {
+            Ogre::MovableObject *object = objects.getNext();
+            if (!object->isAttached() || !object->getVisible() ||
+                !object->getCastShadows())
+            {
+              continue;
+            }
+
+            HashCombine(seed, object);
+            HashCombine(seed, object->getVisibilityFlags());
+            HashCombine(seed, object->_getParentNodeFullTransform());
+
+            // Animated meshes cast the shadows of their bones
+            Ogre::Entity *entity = dynamic_cast<Ogre::Entity *>(object);
+            if (entity && entity->hasSkeleton())
+            {
+              Ogre::SkeletonInstance *skeleton = entity->getSkeleton();
+              for (unsigned int i = 0; i < skeleton->getNumBones(); ++i)
+              {
+                Ogre::Bone *bone = skeleton->getBone(i);
+                Ogre::Matrix4 xform;
+                xform.makeTransform(bone->_getDerivedPosition(),
+                    bone->_getDerivedScale(), bone->_getDerivedOrientation());
+                HashCombine(seed, xform);
+              }
+            }
+          }
+        }
+        return seed;
+      }
+
+      /// \brief Render the shadow textures as usual.
+      public: void Restore()
+      {
+        this->states.clear();
+        if (!this->manager->isShadowTechniqueTextureBased())
+          return;
+
+        for (size_t i = 0; i < this->manager->getShadowTextureCount(); ++i)
+        {
+          const Ogre::TexturePtr &texture = this->manager->getShadowTexture(i);
+          if (!texture.get())
+            continue;
+
+          Ogre::RenderTarget *target =
+              texture->getBuffer()->getRenderTarget();
+          for (unsigned int j = 0; j < target->getNumViewports(); ++j)
+            target->getViewport(j)->setAutoUpdated(true);
+        }
+      }
+
+      /// \brief Scene manager of the scene.
+      public: Ogre::SceneManager *manager = nullptr;
+
+      /// \brief True to reuse the shadow textures.
+      public: bool enabled = false;
+
+      /// \brief Hash of the shadow casters of the current update.
+      public: std::size_t casters = 0;
+
+      /// \brief Content of the shadow textures, by texture handle.
+      public: std::unordered_map<Ogre::ResourceHandle, ShadowState> states;
+
+      /// \brief Number of skipped updates.
+      public: unsigned int reused = 0;
+    };
+  }
+}
+
+//////////////////////////////////////////////////
+ShadowCache::ShadowCache(Ogre::SceneManager *_manager)
+  : dataPtr(new ShadowCachePrivate)
+{
+  this->dataPtr->manager = _manager;
+  if (_manager)
+    _manager->addListener(this->dataPtr.get());
+}
+
+//////////////////////////////////////////////////
+ShadowCache::~ShadowCache()
+{
+  if (!this->dataPtr->manager)
+    return;
+
+  this->dataPtr->manager->removeListener(this->dataPtr.get());
+  if (this->dataPtr->enabled)
+    this->dataPtr->Restore();
+}
+
+//////////////////////////////////////////////////
+void ShadowCache::SetEnabled(const bool _enable)
+{
+  if (_enable == this->dataPtr->enabled)
+    return;
+
+  this->dataPtr->enabled = _enable;
+  if (!_enable && this->dataPtr->manager)
+    this->dataPtr->Restore();
+}
+
+//////////////////////////////////////////////////
+bool ShadowCache::Enabled() const
+{
+  return this->dataPtr->enabled;
+}
+
+//////////////////////////////////////////////////
+void ShadowCache::Invalidate()
+{
+  this->dataPtr->states.clear();
+}
+
+//////////////////////////////////////////////////
+unsigned int ShadowCache::ReusedCount() const
+{
+  return this->dataPtr->reused;
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_RENDERING_SHADOWCACHE_HH_
+#define GAZEBO_RENDERING_SHADOWCACHE_HH_
+
+#include <memory>
+
+namespace Ogre
+{
+  class SceneManager;
+}
+
+namespace gazebo
+{
+  namespace rendering
+  {
+    // Forward declare private data class.
+    class ShadowCachePrivate;
+
+    /// \internal
+    /// \brief Reuse of the shadow textures of a scene across renders.
+    /// The scene manager renders every shadow texture again each time a
+    /// camera is rendered. When enabled, a shadow texture is not rendered
+    /// if its shadow camera has the same view and projection as when the
+    /// texture was last rendered, and no shadow caster moved, appeared,
+    /// or disappeared meanwhile. Static cameras, and cameras sharing a
+    /// pose, therefore render their shadows once, until something moves.
+    /// Changes the cache can't see, such as a modified terrain, require a
+    /// call to Invalidate.
+    class ShadowCache
+    {
+      /// \brief Constructor.
+      /// \param[in] _manager Scene manager of the scene.
+      public: explicit ShadowCache(Ogre::SceneManager *_manager);
+
+      /// \brief Destructor, renders the shadow textures as usual again.
+      public: ~ShadowCache();
+
+      /// \brief Set whether the shadow textures are reused.
+      /// \param[in] _enable True to reuse the shadow textures.
+      public: void SetEnabled(const bool _enable);
+
+      /// \brief Get whether the shadow textures are reused.
+      /// \return True if the shadow textures are reused.
+      public: bool Enabled() const;
+
+      /// \brief Render all the shadow textures in their next update.
+      public: void Invalidate();
+
+      /// \brief Get the number of shadow texture updates that were
+      /// skipped.
+      /// \return Number of reused shadow textures.
+      public: unsigned int ReusedCount() const;
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<ShadowCachePrivate> dataPtr;
+    };
+  }
+}
+#endif
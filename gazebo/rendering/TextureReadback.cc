@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// Pixel buffer objects are only declared by glext.h with prototypes, and
+// only exported by the Linux OpenGL libraries.
+#if defined(HAVE_OPENGL) && defined(__linux__)
+#define GZ_TEXTURE_READBACK_PBO
+#define GL_GLEXT_PROTOTYPES
+#include <GL/gl.h>
+#include <GL/glext.h>
+#endif
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "gazebo/rendering/ogre_gazebo.h"
+#include "gazebo/rendering/TextureReadback.hh"
+
+using namespace gazebo;
+using namespace rendering;
+
+namespace gazebo
+{
+  namespace rendering
+  {
+    /// \internal
+    /// \brief Private data for the TextureReadback class
+    class TextureReadbackPrivate
+    {
+#ifdef GZ_TEXTURE_READBACK_PBO
+      /// \brief The two pixel buffer objects.
+      public: GLuint buffers[2] = {0, 0};
+#endif
+
+      /// \brief Allocated size of each pixel buffer object, in bytes.
+      public: size_t bufferSizes[2] = {0, 0};
+
+      /// \brief Index of the buffer the next copy is queued to.
+      public: unsigned int current = 0;
+
+      /// \brief True if a copy is queued in the other buffer.
+      public: bool pending = false;
+
+      /// \brief Size in bytes of the queued copy.
+      public: size_t pendingSize = 0;
+
+      /// \brief Pixel format of the queued copy.
+      public: int pendingFormat = 0;
+    };
+  }
+}
+
+#ifdef GZ_TEXTURE_READBACK_PBO
+namespace
+{
+  /// \brief Get the OpenGL format and type matching an Ogre pixel format,
+  /// as laid out in memory.
+  /// \param[in] _format Ogre pixel format.
+  /// \param[out] _glFormat OpenGL pixel format.
+  /// \param[out] _glType OpenGL pixel type.
+  /// \return False if the format is not supported.
+  bool GLPixelFormat(const int _format, GLenum &_glFormat, GLenum &_glType)
+  {
+    switch (static_cast<Ogre::PixelFormat>(_format))
+    {
+      case Ogre::PF_L8:
+        _glFormat = GL_LUMINANCE;
+        _glType = GL_UNSIGNED_BYTE;
+        return true;
+      case Ogre::PF_L16:
+        _glFormat = GL_LUMINANCE;
+        _glType = GL_UNSIGNED_SHORT;
+        return true;
+      case Ogre::PF_BYTE_RGB:
+        _glFormat = GL_RGB;
+        _glType = GL_UNSIGNED_BYTE;
+        return true;
+      case Ogre::PF_BYTE_BGR:
+        _glFormat = GL_BGR;
+        _glType = GL_UNSIGNED_BYTE;
+        return true;
+      case Ogre::PF_SHORT_RGB:
+        _glFormat = GL_RGB;
+        _glType = GL_UNSIGNED_SHORT;
+        return true;
+      case Ogre::PF_FLOAT32_R:
+        _glFormat = GL_RED;
+        _glType = GL_FLOAT;
+        return true;
+      case Ogre::PF_FLOAT32_RGB:
+        _glFormat = GL_RGB;
+        _glType = GL_FLOAT;
+        return true;
+      case Ogre::PF_FLOAT32_RGBA:
+        _glFormat = GL_RGBA;
+        _glType = GL_FLOAT;
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  /// \brief Get whether the OpenGL context has pixel buffer objects.
+  /// \return True for OpenGL 2.1 and later.
+  bool HasPixelBufferObjects()
+  {
+    // Checked once there is a context
+    static int supported = -1;
+    if (supported >= 0)
+      return supported > 0;
+
+    Ogre::RenderSystem *renderSys = Ogre::Root::getSingletonPtr() ?
+        Ogre::Root::getSingleton().getRenderSystem() : nullptr;
+    if (!renderSys)
+      return false;
+
+    if (renderSys->getName().find("OpenGL") == std::string::npos)
+    {
+      supported = 0;
+      return false;
+    }
+
+    const char *version =
+        reinterpret_cast<const char *>(glGetString(GL_VERSION));
+    if (!version)
+      return false;
+
+    char *end = nullptr;
+    int major = static_cast<int>(std::strtol(version, &end, 10));
+    int minor = (end && *end == '.') ?
+        static_cast<int>(std::strtol(end + 1, nullptr, 10)) : 0;
+    supported = (major > 2 || (major == 2 && minor >= 1)) ? 1 : 0;
+    return supported > 0;
+  }
+}
+#endif
+
+//////////////////////////////////////////////////
+TextureReadback::TextureReadback()
+  : dataPtr(new TextureReadbackPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+TextureReadback::~TextureReadback()
+{
+#ifdef GZ_TEXTURE_READBACK_PBO
+  if (this->dataPtr->buffers[0])
+    glDeleteBuffers(2, this->dataPtr->buffers);
+#endif
+}
+
+//////////////////////////////////////////////////
+bool TextureReadback::Supported(const int _format)
+{
+#ifdef GZ_TEXTURE_READBACK_PBO
+  GLenum glFormat, glType;
+  return GLPixelFormat(_format, glFormat, glType) && HasPixelBufferObjects();
+#else
+  (void)_format;
+  return false;
+#endif
+}
+
+//////////////////////////////////////////////////
+bool TextureReadback::Read(Ogre::Texture *_texture, const int _format,
+    const unsigned int _width, const unsigned int _height, void *_dst)
+{
+#ifdef GZ_TEXTURE_READBACK_PBO
+  GLenum glFormat, glType;
+  if (!_texture || !_dst || !GLPixelFormat(_format, glFormat, glType))
+    return false;
+
+  const size_t size = Ogre::PixelUtil::getMemorySize(_width, _height, 1,
+      static_cast<Ogre::PixelFormat>(_format));
+
+  if (!this->dataPtr->buffers[0])
+    glGenBuffers(2, this->dataPtr->buffers);
+
+  const unsigned int current = this->dataPtr->current;
+  const unsigned int previous = 1 - current;
+
+  // Queue the copy of this frame first, so the GPU isn't idle while the
+  // previous copy is mapped.
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, this->dataPtr->buffers[current]);
+  if (this->dataPtr->bufferSizes[current] != size)
+  {
+    glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+    this->dataPtr->bufferSizes[current] = size;
+  }
+
+  // Restore the state Ogre caches
+  GLint prevTexture = 0;
+  GLint prevAlignment = 4;
+  glGetIntegerv(GL_TEXTURE_BINDING_2D, &prevTexture);
+  glGetIntegerv(GL_PACK_ALIGNMENT, &prevAlignment);
+
+  GLuint texId = 0;
+  _texture->getCustomAttribute("GLID", &texId);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glBindTexture(GL_TEXTURE_2D, texId);
+  glGetTexImage(GL_TEXTURE_2D, 0, glFormat, glType, nullptr);
+  glBindTexture(GL_TEXTURE_2D, prevTexture);
+  glPixelStorei(GL_PACK_ALIGNMENT, prevAlignment);
+
+  // Deliver the copy queued by the previous call
+  bool result = false;
+  if (this->dataPtr->pending && this->dataPtr->pendingSize == size &&
+      this->dataPtr->pendingFormat == _format)
+  {
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, this->dataPtr->buffers[previous]);
+    const void *data = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+    if (data)
+    {
+      std::memcpy(_dst, data, size);
+      result = true;
+    }
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  this->dataPtr->pending = true;
+  this->dataPtr->pendingSize = size;
+  this->dataPtr->pendingFormat = _format;
+  this->dataPtr->current = previous;
+
+  return result;
+#else
+  (void)_texture;
+  (void)_format;
+  (void)_width;
+  (void)_height;
+  (void)_dst;
+  return false;
+#endif
+}
+
+//////////////////////////////////////////////////
+void TextureReadback::Reset()
+{
+  this->dataPtr->pending = false;
+}
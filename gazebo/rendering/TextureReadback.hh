@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_RENDERING_TEXTUREREADBACK_HH_
+#define GAZEBO_RENDERING_TEXTUREREADBACK_HH_
+
+#include <memory>
+
+namespace Ogre
+{
+  class Texture;
+}
+
+namespace gazebo
+{
+  namespace rendering
+  {
+    // Forward declare private data class.
+    class TextureReadbackPrivate;
+
+    /// \internal
+    /// \brief Asynchronous copy of a render texture to CPU memory.
+    /// Each call to Read queues the copy of the texture to one of two
+    /// pixel buffer objects, and delivers the copy queued by the previous
+    /// call, so a frame is read back while the next one renders. The data
+    /// delivered by Read is one frame behind the texture.
+    /// Must be used in the thread owning the OpenGL context.
+    class TextureReadback
+    {
+      /// \brief Constructor.
+      public: TextureReadback();
+
+      /// \brief Destructor, deletes the pixel buffer objects.
+      public: ~TextureReadback();
+
+      /// \brief Get whether a pixel format can be read asynchronously with
+      /// the current render system.
+      /// \param[in] _format Ogre pixel format of the destination.
+      /// \return False if the render system is not OpenGL, or doesn't
+      /// support pixel buffer objects, or the format is not supported.
+      public: static bool Supported(const int _format);
+
+      /// \brief Queue the copy of a texture and deliver the previous one.
+      /// \param[in] _texture Texture to read.
+      /// \param[in] _format Ogre pixel format of the destination.
+      /// \param[in] _width Width of the texture.
+      /// \param[in] _height Height of the texture.
+      /// \param[out] _dst Destination of the previous copy, which must
+      /// hold the memory size of _width x _height pixels of _format.
+      /// \return True if _dst holds the copy queued by the previous call,
+      /// false if there was none, or it had a different size or format.
+      public: bool Read(Ogre::Texture *_texture, const int _format,
+                  const unsigned int _width, const unsigned int _height,
+                  void *_dst);
+
+      /// \brief Drop the queued copy, the next Read doesn't deliver any
+      /// data.
+      public: void Reset();
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<TextureReadbackPrivate> dataPtr;
+    };
+  }
+}
+#endif
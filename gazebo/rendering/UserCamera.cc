@@ -14,6 +14,8 @@
  * limitations under the License.
  *
 */
+#include <cmath>
+
 #include <boost/bind.hpp>
 #include <ignition/math/Color.hh>
 #include <ignition/math/Vector2.hh>
@@ -39,6 +41,21 @@
 using namespace gazebo;
 using namespace rendering;
 
+/// \brief Highest quality level, lowest quality.
+static const unsigned int kMaxQualityLevel = 3u;
+
+/// \brief Quality level from which the shadows are turned off.
+static const unsigned int kNoShadowsLevel = 2u;
+
+/// \brief Weight of the last frame in the average frame time.
+static const double kFrameTimeWeight = 0.1;
+
+/// \brief Frames to render at a level before lowering the quality again.
+static const unsigned int kLowerFrames = 30u;
+
+/// \brief Frames to render at a level before raising the quality again.
+static const unsigned int kRaiseFrames = 120u;
+
 //////////////////////////////////////////////////
 UserCamera::UserCamera(const std::string &_name, ScenePtr _scene,
     bool _stereoEnabled)
@@ -250,6 +267,7 @@ void UserCamera::Render(const bool /*_force*/)
 {
   if (this->initialized)
   {
+    this->dataPtr->renderStart = common::Time::GetWallTime();
     this->newData = true;
     this->RenderImpl();
   }
@@ -259,6 +277,107 @@ void UserCamera::Render(const bool /*_force*/)
 void UserCamera::PostRender()
 {
   Camera::PostRender();
+
+  // The swap waits for the GPU, so it's part of the frame time
+  if (this->dataPtr->targetFrameTime > 0 &&
+      this->dataPtr->renderStart != common::Time::Zero)
+  {
+    this->AdaptQuality(
+        (common::Time::GetWallTime() - this->dataPtr->renderStart).Double());
+    this->dataPtr->renderStart = common::Time::Zero;
+  }
+}
+
+//////////////////////////////////////////////////
+void UserCamera::SetTargetFrameTime(const double _seconds)
+{
+  if (_seconds < 0.0 || !std::isfinite(_seconds))
+  {
+    gzerr << "Target frame time must be positive, got[" << _seconds << "]"
+          << std::endl;
+    return;
+  }
+
+  this->dataPtr->targetFrameTime = _seconds;
+  this->dataPtr->frameTimeAvg = 0.0;
+  this->dataPtr->framesAtLevel = 0u;
+  if (_seconds <= 0.0)
+    this->SetQualityLevel(0u);
+}
+
+//////////////////////////////////////////////////
+double UserCamera::TargetFrameTime() const
+{
+  return this->dataPtr->targetFrameTime;
+}
+
+//////////////////////////////////////////////////
+unsigned int UserCamera::QualityLevel() const
+{
+  return this->dataPtr->qualityLevel;
+}
+
+//////////////////////////////////////////////////
+void UserCamera::AdaptQuality(const double _frameTime)
+{
+  if (this->dataPtr->frameTimeAvg <= 0.0)
+    this->dataPtr->frameTimeAvg = _frameTime;
+  else
+  {
+    this->dataPtr->frameTimeAvg += kFrameTimeWeight *
+        (_frameTime - this->dataPtr->frameTimeAvg);
+  }
+  ++this->dataPtr->framesAtLevel;
+
+  // Raising the quality needs a wide margin, or the camera would switch
+  // back and forth between two levels
+  double target = this->dataPtr->targetFrameTime;
+  unsigned int level = this->dataPtr->qualityLevel;
+  if (this->dataPtr->frameTimeAvg > 1.2 * target && level < kMaxQualityLevel &&
+      this->dataPtr->framesAtLevel >= kLowerFrames)
+  {
+    this->SetQualityLevel(level + 1);
+  }
+  else if (this->dataPtr->frameTimeAvg < 0.6 * target && level > 0u &&
+      this->dataPtr->framesAtLevel >= kRaiseFrames)
+  {
+    this->SetQualityLevel(level - 1);
+  }
+}
+
+//////////////////////////////////////////////////
+void UserCamera::SetQualityLevel(const unsigned int _level)
+{
+  if (_level == this->dataPtr->qualityLevel)
+    return;
+
+  this->dataPtr->qualityLevel = _level;
+  this->dataPtr->framesAtLevel = 0u;
+
+  // The bias set by the user is kept, and scaled down on the Ogre camera
+  double lodScale = 1.0;
+  if (_level >= kMaxQualityLevel)
+    lodScale = 0.25;
+  else if (_level >= 1u)
+    lodScale = 0.5;
+  if (this->camera)
+    this->camera->setLodBias(this->LodBias() * lodScale);
+
+  if (this->scene)
+  {
+    if (_level >= kNoShadowsLevel && this->scene->ShadowsEnabled())
+    {
+      this->scene->SetShadowsEnabled(false);
+      this->dataPtr->shadowsLowered = true;
+    }
+    else if (_level < kNoShadowsLevel && this->dataPtr->shadowsLowered)
+    {
+      // Shadows turned back on by the user are left alone
+      if (!this->scene->ShadowsEnabled())
+        this->scene->SetShadowsEnabled(true);
+      this->dataPtr->shadowsLowered = false;
+    }
+  }
 }
 
 //////////////////////////////////////////////////
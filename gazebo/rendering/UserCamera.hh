@@ -234,6 +234,27 @@ namespace gazebo
       /// \param[in] _enable True to turn on stereo, false to turn off.
       public: void EnableStereo(bool _enable);
 
+      /// \brief Set the frame time the camera tries to hold. When the
+      /// average time to render and swap a frame is over the target, the
+      /// camera lowers its quality one level at a time: first the level of
+      /// detail of the meshes, then the shadows of the scene, then the level
+      /// of detail again. The quality is raised back once frames are well
+      /// under the target. Zero, the default, turns this off and restores
+      /// the full quality.
+      /// \param[in] _seconds Target frame time in seconds.
+      public: void SetTargetFrameTime(const double _seconds);
+
+      /// \brief Get the frame time the camera tries to hold.
+      /// \return Target frame time in seconds, zero if the quality is fixed.
+      /// \sa SetTargetFrameTime
+      public: double TargetFrameTime() const;
+
+      /// \brief Get how far the quality is lowered to hold the target frame
+      /// time.
+      /// \return Zero for full quality, up to 3.
+      /// \sa SetTargetFrameTime
+      public: unsigned int QualityLevel() const;
+
       // Documentation inherited.
       public: virtual bool SetProjectionType(const std::string &_type);
 
@@ -273,6 +294,14 @@ namespace gazebo
       /// \brief Toggle whether to show the visual.
       private: void ToggleShowVisual();
 
+      /// \brief Change the quality level from the average frame time.
+      /// \param[in] _frameTime Time spent on the last frame, in seconds.
+      private: void AdaptQuality(const double _frameTime);
+
+      /// \brief Apply a quality level.
+      /// \param[in] _level The level, zero for full quality.
+      private: void SetQualityLevel(const unsigned int _level);
+
       /// \brief Set whether to show the visual.
       /// \param[in] _show True to show the visual representation for this
       /// camera. Currently disabled.
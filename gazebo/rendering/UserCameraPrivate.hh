@@ -20,6 +20,8 @@
 #include <string>
 #include <ignition/math/Pose3.hh>
 
+#include "gazebo/common/Time.hh"
+
 namespace gazebo
 {
   namespace rendering
@@ -87,6 +89,25 @@ namespace gazebo
 
       /// \brief Initial camera pose.
       public: ignition::math::Pose3d initialPose;
+
+      /// \brief Frame time to hold, zero if the quality is fixed.
+      public: double targetFrameTime = 0.0;
+
+      /// \brief Current quality level, zero for full quality.
+      public: unsigned int qualityLevel = 0u;
+
+      /// \brief Moving average of the frame time, in seconds.
+      public: double frameTimeAvg = 0.0;
+
+      /// \brief Number of frames rendered at the current quality level.
+      public: unsigned int framesAtLevel = 0u;
+
+      /// \brief Wall time when the current frame started rendering.
+      public: common::Time renderStart;
+
+      /// \brief True if the shadows of the scene were turned off to hold
+      /// the target frame time.
+      public: bool shadowsLowered = false;
     };
   }
 }
@@ -14,6 +14,7 @@
  * limitations under the License.
  *
 */
+#include <cstring>
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
 #include <boost/lexical_cast.hpp>
@@ -29,6 +30,7 @@
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshLod.hh"
 #include "gazebo/common/Plugin.hh"
 #include "gazebo/common/Skeleton.hh"
 
@@ -36,11 +38,14 @@
 #include "gazebo/rendering/Conversions.hh"
 #include "gazebo/rendering/DynamicLines.hh"
 #include "gazebo/rendering/InertiaVisual.hh"
+#include "gazebo/rendering/InstancedVisuals.hh"
 #include "gazebo/rendering/JointVisual.hh"
 #include "gazebo/rendering/LinkFrameVisual.hh"
 #include "gazebo/rendering/Material.hh"
 #include "gazebo/rendering/MovableText.hh"
 #include "gazebo/rendering/ogre_gazebo.h"
+#include <OGRE/OgreInstancedEntity.h>
+#include <OGRE/OgrePixelCountLodStrategy.h>
 #include "gazebo/rendering/RenderEngine.hh"
 #include "gazebo/rendering/RenderEvents.hh"
 #include "gazebo/rendering/RTShaderSystem.hh"
@@ -56,6 +61,33 @@ using namespace rendering;
 // Note: The value of ignition::math::MAX_UI32 is reserved as a flag.
 uint32_t VisualPrivate::visualIdCount = ignition::math::MAX_UI32 - 1;
 
+namespace
+{
+  /// \brief Create the index data of a level of detail of a submesh.
+  /// \param[in] _indices Indices of the level.
+  /// \return The index data.
+  Ogre::IndexData *LodIndexData(const std::vector<unsigned int> &_indices)
+  {
+    Ogre::IndexData *indexData = new Ogre::IndexData();
+    indexData->indexStart = 0;
+    indexData->indexCount = _indices.size();
+
+    // Levels where the submesh collapsed draw nothing, but Ogre needs a
+    // buffer
+    std::vector<uint32_t> indices(_indices.begin(), _indices.end());
+    if (indices.empty())
+      indices.resize(3, 0u);
+
+    indexData->indexBuffer =
+        Ogre::HardwareBufferManager::getSingleton().createIndexBuffer(
+        Ogre::HardwareIndexBuffer::IT_32BIT, indices.size(),
+        Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY, false);
+    indexData->indexBuffer->writeData(0,
+        indices.size() * sizeof(uint32_t), indices.data(), true);
+    return indexData;
+  }
+}
+
 //////////////////////////////////////////////////
 Visual::Visual(const std::string &_name, VisualPtr _parent, bool _useRTShader)
   : dataPtr(new VisualPrivate)
@@ -216,6 +248,8 @@ void Visual::Fini()
 
   this->dataPtr->lines.clear();
 
+  this->StopInstancing();
+
   if (this->dataPtr->sceneNode)
   {
     this->DestroyAllAttachedMovableObjects(this->dataPtr->sceneNode);
@@ -632,6 +666,8 @@ void Visual::AttachObject(Ogre::MovableObject *_obj)
   // if (this->dataPtr->sdf->GetElement("geometry")->HasElement("plane"))
   // _obj->setRenderQueueGroup(Ogre::RENDER_QUEUE_SKIES_EARLY+1);
 
+  this->StopInstancing();
+
   if (!this->HasAttachedObject(_obj->getName()))
   {
     // update to use unique materials
@@ -663,7 +699,7 @@ void Visual::AttachObject(Ogre::MovableObject *_obj)
     if (this->dataPtr->useRTShader && this->dataPtr->scene->Initialized() &&
       _obj->getName().find("__COLLISION_VISUAL__") == std::string::npos)
     {
-      RTShaderSystem::Instance()->UpdateShaders();
+      RTShaderSystem::Instance()->InvalidateShaders(*this);
     }
     _obj->getUserObjectBindings().setUserAny(Ogre::Any(this->Name()));
   }
@@ -696,6 +732,8 @@ unsigned int Visual::GetAttachedObjectCount() const
 //////////////////////////////////////////////////
 void Visual::DetachObjects()
 {
+  this->StopInstancing();
+
   if (this->dataPtr->sceneNode)
     this->dataPtr->sceneNode->detachAllObjects();
   this->dataPtr->meshName = "";
@@ -923,6 +961,7 @@ void Visual::SetLighting(bool _lighting)
   if (this->dataPtr->lighting == _lighting)
     return;
 
+  this->StopInstancing();
   this->dataPtr->lighting = _lighting;
 
   try
@@ -996,6 +1035,8 @@ bool Visual::GetLighting() const
 void Visual::SetMaterial(const std::string &_materialName, bool _unique,
     const bool _cascade)
 {
+  this->StopInstancing();
+
   if (_materialName.empty() || _materialName == "__default__")
     return;
 
@@ -1118,7 +1159,7 @@ void Visual::SetMaterial(const std::string &_materialName, bool _unique,
       && this->dataPtr->lighting &&
       this->Name().find("__COLLISION_VISUAL__") == std::string::npos)
   {
-    RTShaderSystem::Instance()->UpdateShaders();
+    RTShaderSystem::Instance()->InvalidateShaders(*this);
   }
 
   this->dataPtr->sdf->GetElement("material")->GetElement("script")
@@ -1129,6 +1170,8 @@ void Visual::SetMaterial(const std::string &_materialName, bool _unique,
 void Visual::SetMaterialShaderParam(const std::string &_paramName,
     const std::string &_shaderType, const std::string &_value)
 {
+  this->StopInstancing();
+
   // currently only vertex and fragment shaders are supported
   if (_shaderType != "vertex" && _shaderType != "fragment")
   {
@@ -1242,6 +1285,8 @@ void Visual::SetMaterialShaderParam(const std::string &_paramName,
 void Visual::SetAmbient(const ignition::math::Color &_color,
     const bool _cascade)
 {
+  this->StopInstancing();
+
   if (!this->dataPtr->lighting)
     return;
 
@@ -1307,6 +1352,8 @@ void Visual::SetAmbient(const ignition::math::Color &_color,
 void Visual::SetDiffuse(const ignition::math::Color &_color,
     const bool _cascade)
 {
+  this->StopInstancing();
+
   if (!this->dataPtr->lighting)
     return;
 
@@ -1377,6 +1424,8 @@ void Visual::SetDiffuse(const ignition::math::Color &_color,
 void Visual::SetSpecular(const ignition::math::Color &_color,
     const bool _cascade)
 {
+  this->StopInstancing();
+
   if (!this->dataPtr->lighting)
     return;
 
@@ -1442,6 +1491,8 @@ void Visual::SetSpecular(const ignition::math::Color &_color,
 void Visual::SetEmissive(const ignition::math::Color &_color,
     const bool _cascade)
 {
+  this->StopInstancing();
+
   for (unsigned int i = 0; i < this->dataPtr->sceneNode->numAttachedObjects();
       i++)
   {
@@ -1520,6 +1571,8 @@ ignition::math::Color Visual::Emissive() const
 //////////////////////////////////////////////////
 void Visual::SetWireframe(bool _show)
 {
+  this->StopInstancing();
+
   if (this->dataPtr->type == VT_GUI || this->dataPtr->type == VT_PHYSICS ||
       this->dataPtr->type == VT_SENSOR)
     return;
@@ -1705,6 +1758,8 @@ void Visual::SetTransparencyInnerLoop(Ogre::SceneNode *_sceneNode)
 //////////////////////////////////////////////////
 void Visual::UpdateTransparency(const bool _cascade)
 {
+  this->StopInstancing();
+
   this->SetTransparencyInnerLoop(this->dataPtr->sceneNode);
 
   if (_cascade)
@@ -1723,7 +1778,7 @@ void Visual::UpdateTransparency(const bool _cascade)
   }
 
   if (this->dataPtr->useRTShader && this->dataPtr->scene->Initialized())
-    RTShaderSystem::Instance()->UpdateShaders();
+    RTShaderSystem::Instance()->InvalidateShaders(*this);
 
   this->dataPtr->sdf->GetElement("transparency")->Set(
       this->dataPtr->transparency);
@@ -2022,10 +2077,12 @@ std::string Visual::GetNormalMap() const
 //////////////////////////////////////////////////
 void Visual::SetNormalMap(const std::string &_nmap)
 {
+  this->StopInstancing();
+
   this->dataPtr->sdf->GetElement("material")->GetElement(
       "shader")->GetElement("normal_map")->GetValue()->Set(_nmap);
   if (this->dataPtr->useRTShader && this->dataPtr->scene->Initialized())
-    RTShaderSystem::Instance()->UpdateShaders();
+    RTShaderSystem::Instance()->InvalidateShaders(*this);
 }
 
 //////////////////////////////////////////////////
@@ -2038,10 +2095,12 @@ std::string Visual::GetShaderType() const
 //////////////////////////////////////////////////
 void Visual::SetShaderType(const std::string &_type)
 {
+  this->StopInstancing();
+
   this->dataPtr->sdf->GetElement("material")->GetElement(
       "shader")->GetAttribute("type")->Set(_type);
   if (this->dataPtr->useRTShader && this->dataPtr->scene->Initialized())
-    RTShaderSystem::Instance()->UpdateShaders();
+    RTShaderSystem::Instance()->InvalidateShaders(*this);
 }
 
 
@@ -2310,6 +2369,15 @@ void Visual::InsertMesh(const common::Mesh *_mesh, const std::string &_subMesh,
       ogreMesh->setSkeletonName(_mesh->GetName() + "_skeleton");
     }
 
+    // Levels of detail are generated for whole meshes, and share their
+    // vertices
+    std::vector<common::MeshLodLevel> lods;
+    if (_subMesh.empty())
+      lods = common::MeshManager::Instance()->MeshLods(_mesh);
+
+    // Reused by all the submeshes
+    common::SubMeshBuffer buffer;
+
     for (unsigned int i = 0; i < _mesh->GetSubMeshCount(); i++)
     {
       if (!_subMesh.empty() && _mesh->GetSubMesh(i)->GetName() != _subMesh)
@@ -2327,13 +2395,14 @@ void Visual::InsertMesh(const common::Mesh *_mesh, const std::string &_subMesh,
 
       size_t currOffset = 0;
 
-      // Copy the original submesh. We may need to modify the vertices, and
-      // we don't want to change the original.
-      common::SubMesh subMesh(_mesh->GetSubMesh(i));
+      const common::SubMesh &subMesh = *_mesh->GetSubMesh(i);
 
-      // Recenter the vertices if requested.
+      // Recenter the vertices if requested. They're converted to single
+      // precision in one pass, without copying the submesh.
+      ignition::math::Vector3d offset = ignition::math::Vector3d::Zero;
       if (_centerSubmesh)
-        subMesh.Center(ignition::math::Vector3d::Zero);
+        offset = -(subMesh.Min() + (subMesh.Max() - subMesh.Min()) * 0.5);
+      subMesh.FillBuffer(buffer, offset);
 
       ogreSubMesh = ogreMesh->createSubMesh();
       ogreSubMesh->useSharedVertices = false;
@@ -2464,32 +2533,18 @@ void Visual::InsertMesh(const common::Mesh *_mesh, const std::string &_subMesh,
       indices = static_cast<uint32_t*>(
           iBuf->lock(Ogre::HardwareBuffer::HBL_DISCARD));
 
-      unsigned int j;
-
-      // Add all the vertices
-      for (j = 0; j < subMesh.GetVertexCount(); j++)
+      // Add all the vertices, which match the layout of the declaration
+      std::memcpy(vertices, buffer.vertices.data(),
+          buffer.vertices.size() * sizeof(float));
+      if (texMappings)
       {
-        *vertices++ = subMesh.Vertex(j).X();
-        *vertices++ = subMesh.Vertex(j).Y();
-        *vertices++ = subMesh.Vertex(j).Z();
-
-        if (subMesh.GetNormalCount() > 0)
-        {
-          *vertices++ = subMesh.Normal(j).X();
-          *vertices++ = subMesh.Normal(j).Y();
-          *vertices++ = subMesh.Normal(j).Z();
-        }
-
-        if (subMesh.GetTexCoordCount() > 0)
-        {
-          *texMappings++ = subMesh.TexCoord(j).X();
-          *texMappings++ = subMesh.TexCoord(j).Y();
-        }
+        std::memcpy(texMappings, buffer.texCoords.data(),
+            buffer.texCoords.size() * sizeof(float));
       }
 
       // Add all the indices
-      for (j = 0; j < subMesh.GetIndexCount(); j++)
-        *indices++ = subMesh.GetIndex(j);
+      std::memcpy(indices, buffer.indices.data(),
+          buffer.indices.size() * sizeof(uint32_t));
 
       const common::Material *material;
       material = _mesh->GetMaterial(subMesh.GetMaterialIndex());
@@ -2532,6 +2587,37 @@ void Visual::InsertMesh(const common::Mesh *_mesh, const std::string &_subMesh,
           Ogre::Vector3(max.X(), max.Y(), max.Z())),
           false);
 
+    // Switch to a level once the bounding sphere of the mesh covers less
+    // than about two pixels per grid cell of the level. Cameras scale
+    // this with their LOD bias.
+    if (!lods.empty())
+    {
+#if OGRE_VERSION_MAJOR == 1 && OGRE_VERSION_MINOR >= 10
+      ogreMesh->setLodStrategy(
+          Ogre::AbsolutePixelCountLodStrategy::getSingletonPtr());
+      ogreMesh->_setLodInfo(lods.size() + 1);
+#else
+      ogreMesh->setLodStrategy(Ogre::PixelCountLodStrategy::getSingletonPtr());
+      ogreMesh->_setLodInfo(lods.size() + 1, false);
+#endif
+      for (unsigned short level = 1; level <= lods.size(); ++level)
+      {
+        const common::MeshLodLevel &lod = lods[level - 1];
+        Ogre::MeshLodUsage usage;
+        usage.userValue = IGN_PI * lod.resolution * lod.resolution;
+        usage.value =
+            ogreMesh->getLodStrategy()->transformUserValue(usage.userValue);
+        usage.edgeData = nullptr;
+        ogreMesh->_setLodUsage(level, usage);
+
+        for (unsigned short j = 0; j < ogreMesh->getNumSubMeshes(); ++j)
+        {
+          ogreMesh->_setSubMeshLodFaceList(j, level,
+              LodIndexData(lod.indices[j]));
+        }
+      }
+    }
+
     // this line makes clear the mesh is loaded (avoids memory leaks)
     ogreMesh->load();
   }
@@ -2726,6 +2812,8 @@ void Visual::UpdateFromMsg(const boost::shared_ptr< msgs::Visual const> &_msg)
     this->LoadPlugins();
   }
 
+  this->UpdateInstancing();
+
   /*if (msg->points.size() > 0)
   {
     DynamicLines *lines = this->AddDynamicLine(RENDERING_LINE_LIST);
@@ -3430,6 +3518,9 @@ void Visual::LoadPlugin(const std::string &_filename,
             << "Plugin filename[" << _filename << "] name[" << _name << "]\n";
       return;
     }
+
+    // Account the callbacks the plugin connects to it
+    event::ConnectionOwner owner(this->Name() + "::" + _name);
     plugin->Load(shared_from_this(), _sdf);
     this->dataPtr->plugins.push_back(plugin);
 
@@ -3602,6 +3693,76 @@ bool Visual::UseRTShader() const
   return this->dataPtr->useRTShader;
 }
 
+//////////////////////////////////////////////////
+void Visual::UpdateInstancing()
+{
+  if (!this->dataPtr->scene || !this->dataPtr->sceneNode)
+    return;
+
+  InstancedVisuals *instances = this->dataPtr->scene->Instances();
+  if (!instances || !instances->Supported() ||
+      !this->dataPtr->scene->Instancing() ||
+      this->dataPtr->type != VT_VISUAL || !this->dataPtr->children.empty() ||
+      !ignition::math::equal(this->DerivedTransparency(), 0.0f) ||
+      this->dataPtr->wireframe || this->dataPtr->skeleton)
+  {
+    this->StopInstancing();
+    return;
+  }
+
+  if (this->dataPtr->instancedEntity)
+    return;
+
+  // Only visuals drawing a single entity are instanced
+  Ogre::Entity *entity = nullptr;
+  for (unsigned int i = 0; i < this->dataPtr->sceneNode->numAttachedObjects();
+      ++i)
+  {
+    Ogre::MovableObject *obj = this->dataPtr->sceneNode->getAttachedObject(i);
+    entity = dynamic_cast<Ogre::Entity *>(obj);
+    if (!entity || this->dataPtr->sceneNode->numAttachedObjects() > 1)
+      return;
+  }
+
+  this->dataPtr->instances = instances->Create(entity);
+  if (this->dataPtr->instances.empty())
+    return;
+
+  this->dataPtr->sceneNode->detachObject(entity);
+  for (auto instance : this->dataPtr->instances)
+  {
+    instance->setVisibilityFlags(entity->getVisibilityFlags());
+    instance->setVisible(entity->getVisible());
+    instance->getUserObjectBindings().setUserAny(Ogre::Any(this->Name()));
+    this->dataPtr->sceneNode->attachObject(instance);
+  }
+  this->dataPtr->instancedEntity = entity;
+}
+
+//////////////////////////////////////////////////
+void Visual::StopInstancing()
+{
+  if (!this->dataPtr->instancedEntity)
+    return;
+
+  // The instanced entities are destroyed with the batches of the scene
+  InstancedVisuals *instances =
+      this->dataPtr->scene ? this->dataPtr->scene->Instances() : nullptr;
+  if (instances)
+    instances->Destroy(this->dataPtr->instances);
+  this->dataPtr->instances.clear();
+
+  if (this->dataPtr->sceneNode)
+    this->dataPtr->sceneNode->attachObject(this->dataPtr->instancedEntity);
+  this->dataPtr->instancedEntity = nullptr;
+}
+
+//////////////////////////////////////////////////
+bool Visual::Instanced() const
+{
+  return this->dataPtr->instancedEntity != nullptr;
+}
+
 //////////////////////////////////////////////////
 void Visual::SetTypeMsg(const google::protobuf::Message *_msg)
 {
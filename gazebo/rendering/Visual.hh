@@ -632,6 +632,19 @@ namespace gazebo
       /// \return True if RT shader is used.
       public: bool UseRTShader() const;
 
+      /// \brief Draw the visual with the instance batches of its scene, if
+      /// instancing is enabled on the scene and the visual can be
+      /// instanced, or stop instancing it otherwise. Only visuals of type
+      /// VT_VISUAL drawing a single opaque mesh, without children, are
+      /// instanced. Changing the appearance of the visual stops instancing
+      /// it until this is called again.
+      /// \sa Scene::SetInstancing
+      public: void UpdateInstancing();
+
+      /// \brief Get whether the visual is drawn with instance batches.
+      /// \return True if the visual is instanced.
+      public: bool Instanced() const;
+
       /// \brief Set a message specific for this visual type. For example, a
       /// link visual will have a link message.
       /// \param[in] _msg Message for this visual.
@@ -721,6 +734,10 @@ namespace gazebo
 
       private: void LoadPlugin(sdf::ElementPtr _sdf);
 
+      /// \brief Destroy the instanced entities of the visual and attach its
+      /// entity back, so that it can be modified.
+      private: void StopInstancing();
+
       /// \brief Helper function to get the bounding box for a visual.
       /// \param[in] _node Pointer to the Ogre Node to process.
       /// \param[in] _box Current bounding box information.
@@ -37,6 +37,8 @@
 
 namespace Ogre
 {
+  class Entity;
+  class InstancedEntity;
   class MovableObject;
   class SceneNode;
   class StaticGeometry;
@@ -222,6 +224,13 @@ namespace gazebo
 
       /// \brief Original ogre materials used by the submeshes in the visual
       public: std::map<std::string, Ogre::MaterialPtr> submeshMaterials;
+
+      /// \brief Instanced entities drawing the visual, one per sub entity,
+      /// empty if the visual is not instanced.
+      public: std::vector<Ogre::InstancedEntity *> instances;
+
+      /// \brief Entity of the visual, detached while it is instanced.
+      public: Ogre::Entity *instancedEntity = nullptr;
     };
     /// \}
   }
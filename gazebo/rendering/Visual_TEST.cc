@@ -20,6 +20,7 @@
 #include <ignition/math/Rand.hh>
 #include <ignition/math/Pose3.hh>
 #include <ignition/math/Vector3.hh>
+#include "gazebo/rendering/InstancedVisuals.hh"
 #include "gazebo/rendering/RenderingIface.hh"
 #include "gazebo/rendering/Scene.hh"
 #include "gazebo/rendering/Visual.hh"
@@ -2011,6 +2012,75 @@ TEST_F(Visual_TEST, Pose)
   EXPECT_EQ(sphereVis->InitialRelativePose(), spherePose);
 }
 
+/////////////////////////////////////////////////
+TEST_F(Visual_TEST, Instancing)
+{
+  Load("worlds/empty.world");
+
+  gazebo::rendering::ScenePtr scene = gazebo::rendering::get_scene();
+  ASSERT_TRUE(scene != nullptr);
+  ASSERT_TRUE(scene->Instances() != nullptr);
+  EXPECT_FALSE(scene->Instancing());
+
+  std::vector<gazebo::rendering::VisualPtr> visuals;
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    std::string name = "visual_box_" + std::to_string(i);
+    sdf::ElementPtr boxSDF(new sdf::Element);
+    sdf::initFile("visual.sdf", boxSDF);
+    sdf::readString(GetVisualSDFString(name), boxSDF);
+    gazebo::rendering::VisualPtr boxVis(
+        new gazebo::rendering::Visual(name, scene));
+    boxVis->Load(boxSDF);
+    boxVis->SetType(gazebo::rendering::Visual::VT_VISUAL);
+    visuals.push_back(boxVis);
+  }
+
+  // Visuals are not instanced unless the scene enables it
+  visuals[0]->UpdateInstancing();
+  EXPECT_FALSE(visuals[0]->Instanced());
+
+  scene->SetInstancing(true);
+  EXPECT_TRUE(scene->Instancing());
+  if (!scene->Instances()->Supported())
+  {
+    visuals[0]->UpdateInstancing();
+    EXPECT_FALSE(visuals[0]->Instanced());
+    return;
+  }
+
+  for (auto vis : visuals)
+  {
+    vis->UpdateInstancing();
+    EXPECT_TRUE(vis->Instanced());
+    EXPECT_EQ(vis->GetAttachedObjectCount(), 1u);
+  }
+  EXPECT_EQ(scene->Instances()->InstanceCount(), 2u);
+
+  // Changing the appearance stops instancing, and transparent visuals are
+  // not instanced again
+  visuals[1]->SetTransparency(0.5);
+  EXPECT_FALSE(visuals[1]->Instanced());
+  EXPECT_EQ(visuals[1]->GetAttachedObjectCount(), 1u);
+  visuals[1]->UpdateInstancing();
+  EXPECT_FALSE(visuals[1]->Instanced());
+  EXPECT_EQ(scene->Instances()->InstanceCount(), 1u);
+
+  // Visuals with children are not instanced
+  sdf::ElementPtr sphereSDF(new sdf::Element);
+  sdf::initFile("visual.sdf", sphereSDF);
+  sdf::readString(GetVisualSDFString("visual_sphere", "sphere"), sphereSDF);
+  gazebo::rendering::VisualPtr sphereVis(
+      new gazebo::rendering::Visual("sphere_visual", visuals[0]));
+  sphereVis->Load(sphereSDF);
+  visuals[0]->UpdateInstancing();
+  EXPECT_FALSE(visuals[0]->Instanced());
+  EXPECT_EQ(scene->Instances()->InstanceCount(), 0u);
+
+  scene->SetInstancing(false);
+  EXPECT_FALSE(scene->Instancing());
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -30,6 +30,10 @@
 
 #endif /* HAVE_OPENGL */
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include <ignition/math/Color.hh>
 
 #include "gazebo/rendering/ogre_gazebo.h"
@@ -392,6 +396,29 @@ void CameraLens::SetUniformVariables(Ogre::Pass *_pass, const float _ratio,
   uniforms_vs->setNamedConstant("ratio", static_cast<Ogre::Real>(_ratio));
 }
 
+//////////////////////////////////////////////////
+double CameraLens::Angle(const double _radius, const float _hfov) const
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->dataMutex);
+
+  // Same as wide_lens_map_fp.glsl, with the focal length of
+  // SetUniformVariables
+  double f = this->dataPtr->f;
+  if (this->ScaleToHFOV())
+  {
+    float param = (_hfov/2)/this->dataPtr->c2+this->dataPtr->c3;
+    float funRes = this->dataPtr->fun.Apply(static_cast<float>(param));
+    f = 1.0/(this->dataPtr->c1*funRes);
+  }
+
+  const double param = _radius/(this->dataPtr->c1*f);
+  const auto fun = this->dataPtr->fun.AsVector3d();
+  const double theta = fun.X()*std::asin(param) +
+      fun.Y()*std::atan(param) + fun.Z()*param;
+
+  return (theta-this->dataPtr->c3)*this->dataPtr->c2;
+}
+
 //////////////////////////////////////////////////
 void CameraLens::ConvertToCustom()
 {
@@ -467,6 +494,9 @@ void WideAngleCamera::Load()
 
     if (sdfLens->HasElement("env_texture_size"))
       this->dataPtr->envTextureSize = sdfLens->Get<int>("env_texture_size");
+
+    if (sdfLens->HasElement("gz:cull_env_faces"))
+      this->SetCullEnvFaces(sdfLens->Get<bool>("gz:cull_env_faces"));
   }
   else
     this->dataPtr->lens->Load();
@@ -681,8 +711,7 @@ void WideAngleCamera::CreateEnvRenderTexture(const std::string &_textureName)
 
     auto const &gzBgColor = this->scene->BackgroundColor();
     vp->setBackgroundColour(Conversions::Convert(gzBgColor));
-    vp->setVisibilityMask(GZ_VISIBILITY_ALL &
-        ~(GZ_VISIBILITY_GUI | GZ_VISIBILITY_SELECTABLE));
+    vp->setVisibilityMask(this->VisibilityMask());
 
     this->dataPtr->envViewports[i] = vp;
 
@@ -693,13 +722,123 @@ void WideAngleCamera::CreateEnvRenderTexture(const std::string &_textureName)
   }
 }
 
+//////////////////////////////////////////////////
+void WideAngleCamera::SetCullEnvFaces(const bool _cull)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->dataMutex);
+
+  this->dataPtr->cullEnvFaces = _cull;
+}
+
+//////////////////////////////////////////////////
+bool WideAngleCamera::CullEnvFaces() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->dataMutex);
+
+  return this->dataPtr->cullEnvFaces;
+}
+
+//////////////////////////////////////////////////
+std::vector<bool> WideAngleCamera::NeededEnvFaces() const
+{
+  std::vector<bool> faces(6, false);
+
+  // The face along the optical axis is always sampled
+  faces[4] = true;
+
+  const CameraLens *lens = this->Lens();
+  if (!lens)
+  {
+    faces.assign(6, true);
+    return faces;
+  }
+
+  const double ratio = this->AspectRatio();
+  const float hfov = static_cast<float>(this->HFOV().Radian());
+  const double cutOffAngle = lens->CutOffAngle();
+
+  // Faces whose edge is within two texels of a sampled direction are kept
+  // too, since the cube map is filtered across the edges.
+  const double margin = 4.0 / std::max(1, this->EnvTextureSize());
+
+  auto markFaces = [&](const double _x, const double _y)
+  {
+    // Position of the fragment, as computed by wide_lens_map_vs.glsl
+    const double fragX = -_x;
+    const double fragY = -_y / ratio;
+    const double r = std::sqrt(fragX * fragX + fragY * fragY);
+
+    const double theta = lens->Angle(r, hfov);
+    if (std::isnan(theta) || theta > cutOffAngle)
+      return;
+
+    // Direction sampled from the cube map, as in wide_lens_map_fp.glsl
+    double dir[3] = {0.0, 0.0, std::cos(theta)};
+    if (r > 0.0)
+    {
+      dir[0] = -std::sin(theta) * fragX / r;
+      dir[1] = std::sin(theta) * fragY / r;
+    }
+
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      const double other = std::max(std::abs(dir[(axis + 1) % 3]),
+          std::abs(dir[(axis + 2) % 3]));
+      if (std::abs(dir[axis]) >= other * (1.0 - margin))
+        faces[axis * 2 + (dir[axis] < 0.0 ? 1 : 0)] = true;
+    }
+  };
+
+  // The directions are continuous over the image, so a face that is
+  // sampled is reached on a grid over the image, and on the cut off circle.
+  const int samples = 32;
+  for (int i = 0; i <= samples; ++i)
+  {
+    for (int j = 0; j <= samples; ++j)
+    {
+      markFaces(2.0 * i / samples - 1.0, 2.0 * j / samples - 1.0);
+    }
+  }
+
+  for (int i = 0; i < samples * 4; ++i)
+  {
+    // Find the radius of the cut off angle along this direction
+    const double azimuth = 2.0 * IGN_PI * i / (samples * 4);
+    double lo = 0.0;
+    double hi = std::sqrt(1.0 + 1.0 / (ratio * ratio));
+    for (int k = 0; k < 20; ++k)
+    {
+      const double mid = 0.5 * (lo + hi);
+      const double theta = lens->Angle(mid, hfov);
+      if (std::isnan(theta) || theta > cutOffAngle)
+        hi = mid;
+      else
+        lo = mid;
+    }
+
+    const double x = -lo * std::cos(azimuth);
+    const double y = -lo * std::sin(azimuth) * ratio;
+    if (std::abs(x) <= 1.0 && std::abs(y) <= 1.0)
+      markFaces(x, y);
+  }
+
+  return faces;
+}
+
 //////////////////////////////////////////////////
 void WideAngleCamera::RenderImpl()
 {
   std::lock_guard<std::mutex> lock(this->dataPtr->renderMutex);
 
+  std::vector<bool> faces(6, true);
+  if (this->CullEnvFaces())
+    faces = this->NeededEnvFaces();
+
   for (int i = 0; i < 6; ++i)
-    this->dataPtr->envRenderTargets[i]->update();
+  {
+    if (faces[i])
+      this->dataPtr->envRenderTargets[i]->update();
+  }
 
   this->dataPtr->compMat->getTechnique(0)->getPass(0)->getTextureUnitState(0)->
       setTextureName(this->dataPtr->envCubeMapTexture->getName());
@@ -152,6 +152,15 @@ namespace gazebo
       ///   note: c1 and f parameters are ignored in this case
       public: void SetScaleToHFOV(const bool _scale);
 
+      /// \brief Get the angle from the optical axis of the direction the
+      /// lens maps to a distance from the image center, as the lens shader
+      /// computes it.
+      /// \param[in] _radius Distance from the image center, 1 being the
+      /// distance to the left and right edges.
+      /// \param[in] _hfov Horizontal field of view.
+      /// \return Angle in radians, or NaN outside of the mapping domain.
+      public: double Angle(const double _radius, const float _hfov) const;
+
       /// \brief Set uniform variables of a shader
       ///   for the provided material technique pass
       /// \param[in] _pass Ogre::Pass used for rendering
@@ -213,6 +222,24 @@ namespace gazebo
       /// \param[in] _size Texture size
       public: void SetEnvTextureSize(const int _size);
 
+      /// \brief Set whether only the faces of the environment cube map that
+      /// the lens samples are rendered. With a 180 degree fisheye lens for
+      /// example, the face behind the camera is skipped. It can also be set
+      /// with the <gz:cull_env_faces> element of <lens>.
+      /// \param[in] _cull True to skip the faces the lens doesn't sample.
+      public: void SetCullEnvFaces(const bool _cull);
+
+      /// \brief Get whether the faces of the environment cube map that the
+      /// lens doesn't sample are skipped.
+      /// \return True if the faces are culled.
+      public: bool CullEnvFaces() const;
+
+      /// \brief Get the faces of the environment cube map that the lens
+      /// samples, with the current lens, field of view and aspect ratio.
+      /// \return Six flags, in the order of the cube map faces: +X, -X, +Y,
+      /// -Y, +Z (along the optical axis) and -Z.
+      public: std::vector<bool> NeededEnvFaces() const;
+
       /// \brief Creates a set of 6 cameras pointing in different directions
       protected: void CreateEnvCameras();
 
@@ -68,6 +68,9 @@ namespace gazebo
       /// \brief Camera lens description
       public: CameraLens *lens;
 
+      /// \brief True to only render the cube map faces the lens samples
+      public: bool cullEnvFaces = false;
+
       /// \brief Mutex to lock while rendering the world
       public: std::mutex renderMutex;
 
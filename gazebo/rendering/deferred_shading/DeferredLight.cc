@@ -26,6 +26,7 @@
 #include "gazebo/common/Console.hh"
 
 #include "gazebo/rendering/Conversions.hh"
+#include "gazebo/rendering/RenderEngine.hh"
 
 #include "gazebo/rendering/deferred_shading/GeomUtils.hh"
 #include "gazebo/rendering/deferred_shading/TechniqueDefinitions.hh"
@@ -213,7 +214,7 @@ void DeferredLight::CreateSphere(float _radius, int _nRings, int _nSegments)
   // Set bounding box and sphere
   this->setBoundingBox(Ogre::AxisAlignedBox(
         Ogre::Vector3(-_radius, -_radius, -_radius),
-        Ogre::Vector3(radius, radius, radius)));
+        Ogre::Vector3(_radius, _radius, _radius)));
 
   this->radius = _radius;
   this->ignoreWorld = false;
@@ -353,7 +354,11 @@ bool DeferredLight::IsCameraInsideLight(Ogre::Camera *_camera)
 /////////////////////////////////////////////////
 bool DeferredLight::getCastShadows() const
 {
-  return this->parentLight->_getManager()->isShadowTechniqueInUse() &&
+  // The shadow textures of the forward path aren't reflective shadow maps,
+  // cameras that opt in to deferred shading there light without shadows.
+  return RenderEngine::Instance()->GetRenderPathType() ==
+         RenderEngine::DEFERRED &&
+         this->parentLight->_getManager()->isShadowTechniqueInUse() &&
          this->parentLight->getCastShadows() &&
          (this->parentLight->getType() == Ogre::Light::LT_DIRECTIONAL ||
           this->parentLight->getType() == Ogre::Light::LT_SPOTLIGHT);
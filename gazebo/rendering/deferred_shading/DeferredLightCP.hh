@@ -72,7 +72,9 @@ namespace gazebo
       public: virtual void execute(Ogre::SceneManager *_sm,
                                    Ogre::RenderSystem * /*_rs*/)
       {
-        if (!this->instanceManager)
+        // The virtual point lights only exist on the deferred render path
+        if (!this->instanceManager &&
+            _sm->hasInstanceManager("VPL_InstanceMgr"))
         {
           this->instanceManager = _sm->getInstanceManager("VPL_InstanceMgr");
         }
@@ -147,7 +149,7 @@ namespace gazebo
             dLight->UpdateShadowInvProj(invProj);
             */
 
-            if (this->rsmActive)
+            if (this->rsmActive && this->instanceManager)
             {
               dLight->RenderVPLs(_sm, this->instanceManager);
             }
@@ -162,8 +164,6 @@ namespace gazebo
              if (tus->_getTexturePtr() != shadowTex)
               tus->_setTexturePtr(shadowTex);
           }
-          else
-            printf("NO SHADOWS\n");
 
           InjectTechnique(_sm, tech, dLight, &ll);
         }
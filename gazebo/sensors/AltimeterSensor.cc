@@ -68,6 +68,14 @@ void AltimeterSensor::Load(const std::string &_worldName)
   this->dataPtr->parentLink =
     boost::dynamic_pointer_cast<physics::Link>(parentEntity);
 
+  // The parent link state is gathered once per step for all sensors
+  if (this->dataPtr->parentLink)
+  {
+    this->dataPtr->linkStates = LinkStateBatch::Acquire(this->world);
+    this->dataPtr->linkSlot =
+      this->dataPtr->linkStates->Add(this->dataPtr->parentLink);
+  }
+
   this->dataPtr->altPub =
     this->node->Advertise<msgs::Altimeter>(this->Topic(), 50);
 
@@ -110,6 +118,10 @@ void AltimeterSensor::Load(const std::string &_worldName)
 void AltimeterSensor::Fini()
 {
   Sensor::Fini();
+  if (this->dataPtr->linkStates)
+    this->dataPtr->linkStates->Remove(this->dataPtr->linkSlot);
+  this->dataPtr->linkStates.reset();
+  this->dataPtr->linkSlot = -1;
   this->dataPtr->parentLink.reset();
 }
 
@@ -125,15 +137,17 @@ bool AltimeterSensor::UpdateImpl(const bool /*_force*/)
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
   // Get latest pose information
-  if (this->dataPtr->parentLink)
+  LinkState state;
+  if (this->dataPtr->linkStates &&
+      this->dataPtr->linkStates->Read(this->dataPtr->linkSlot, state))
   {
-    ignition::math::Pose3d parentPose = this->dataPtr->parentLink->WorldPose();
+    ignition::math::Pose3d parentPose = state.pose;
 
     // Get pose in gazebo reference frame
     ignition::math::Pose3d altPose = this->pose + parentPose;
 
-    ignition::math::Vector3d altVel =
-      this->dataPtr->parentLink->WorldLinearVel(this->pose.Pos());
+    ignition::math::Vector3d altVel = state.linearVel +
+      state.angularVel.Cross(altPose.Pos() - parentPose.Pos());
 
     // Apply noise to the position and velocity
     if (this->noises.find(ALTIMETER_POSITION_NOISE_METERS) !=
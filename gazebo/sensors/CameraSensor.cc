@@ -15,8 +15,12 @@
  *
 */
 #include <boost/algorithm/string.hpp>
+#include <cstring>
 #include <functional>
+#include <sstream>
+#include <string>
 
+#include <ignition/math/Helpers.hh>
 #include <ignition/msgs/Utility.hh>
 
 #include "gazebo/common/Events.hh"
@@ -78,6 +82,12 @@ std::string CameraSensor::Topic() const
   return topicName;
 }
 
+//////////////////////////////////////////////////
+std::string CameraSensor::CompressedTopic() const
+{
+  return this->Topic() + "/compressed";
+}
+
 //////////////////////////////////////////////////
 std::string CameraSensor::TopicIgn() const
 {
@@ -98,6 +108,72 @@ void CameraSensor::Load(const std::string &_worldName)
   opts.SetMsgsPerSec(50);
   this->imagePubIgn = this->nodeIgn.Advertise<ignition::msgs::Image>(
       this->TopicIgn(), opts);
+
+  // Optional compressed images, encoded on a thread of their own
+  sdf::ElementPtr cameraSdf = this->sdf->GetElement("camera");
+  if (cameraSdf->HasElement("gz:compression"))
+  {
+    sdf::ElementPtr compressionElem = cameraSdf->GetElement("gz:compression");
+    const std::string format = compressionElem->HasElement("format") ?
+        compressionElem->Get<std::string>("format") : "jpeg";
+    if (format != "jpeg" && format != "png")
+    {
+      gzerr << "Unsupported image compression format[" << format
+            << "], use jpeg or png.\n";
+    }
+    else
+    {
+      this->dataPtr->compressionFormat = format;
+      if (compressionElem->HasElement("quality"))
+      {
+        this->dataPtr->compressionQuality = ignition::math::clamp(
+            compressionElem->Get<int>("quality"), 1, 100);
+      }
+      this->dataPtr->compressedPub =
+          this->node->Advertise<msgs::CompressedImage>(
+              this->CompressedTopic(), 50);
+      this->dataPtr->encodeThread = std::thread(
+          &CameraSensorPrivate::EncodeLoop, this->dataPtr.get());
+    }
+  }
+
+  // Optional crops and thumbnails of the image, on topics of their own
+  sdf::ElementPtr outputElem = cameraSdf->HasElement("gz:output") ?
+      cameraSdf->GetElement("gz:output") : sdf::ElementPtr();
+  for (; outputElem; outputElem = outputElem->GetNextElement("gz:output"))
+  {
+    CameraSensorOutput output;
+    output.name = outputElem->HasAttribute("name") ?
+        outputElem->Get<std::string>("name") : "";
+    if (output.name.empty())
+    {
+      gzerr << "A <gz:output> element of camera sensor[" << this->Name()
+            << "] has no name attribute, ignoring it.\n";
+      continue;
+    }
+
+    if (outputElem->HasElement("roi"))
+    {
+      std::istringstream roi(outputElem->Get<std::string>("roi"));
+      if (!(roi >> output.x >> output.y >> output.width >> output.height))
+      {
+        gzerr << "The <roi> of output[" << output.name << "] must hold "
+              << "x y width height, ignoring the output.\n";
+        continue;
+      }
+    }
+    if (outputElem->HasElement("scale"))
+      output.scale = outputElem->Get<double>("scale");
+
+    output.pub = this->node->Advertise<msgs::ImageStamped>(
+        this->Topic() + "/" + output.name, 50);
+    this->dataPtr->outputs.push_back(output);
+  }
+
+  // Plugins and frame saving read the full image from the camera
+  this->dataPtr->fullImageRequired = this->dataPtr->outputs.empty() ||
+      this->sdf->HasElement("plugin") || (cameraSdf->HasElement("save") &&
+      cameraSdf->GetElement("save")->Get<bool>("enabled"));
 }
 
 //////////////////////////////////////////////////
@@ -110,6 +186,24 @@ void CameraSensor::Init()
     return;
   }
 
+  // Plugins get the camera when they load, so only a sensor without them
+  // can wait for a consumer
+  if (this->LazyUpdate() && !this->sdf->HasElement("plugin") &&
+      !this->IsActive())
+  {
+    this->dataPtr->initPending = true;
+  }
+  else if (!this->InitCamera())
+  {
+    return;
+  }
+
+  Sensor::Init();
+}
+
+//////////////////////////////////////////////////
+bool CameraSensor::InitCamera()
+{
   std::string worldName = this->world->Name();
 
   if (!worldName.empty())
@@ -123,7 +217,7 @@ void CameraSensor::Init()
       if (!this->scene)
       {
         gzerr << "Unable to create CameraSensor.\n";
-        return;
+        return false;
       }
     }
 
@@ -133,7 +227,7 @@ void CameraSensor::Init()
     if (!this->camera)
     {
       gzerr << "Unable to create camera sensor[mono_camera]\n";
-      return;
+      return false;
     }
     this->camera->SetCaptureData(true);
 
@@ -149,6 +243,18 @@ void CameraSensor::Init()
 
     this->camera->Init();
     this->camera->CreateRenderTexture(scopedName + "_RttTex");
+
+    for (auto &output : this->dataPtr->outputs)
+    {
+      if (this->camera->ImageFormat().compare(0, 5, "BAYER") == 0)
+      {
+        gzerr << "Outputs of Bayer images aren't supported, ignoring output["
+              << output.name << "]\n";
+        continue;
+      }
+      output.index = this->camera->AddImageOutput(output.x, output.y,
+          output.width, output.height, output.scale);
+    }
     ignition::math::Pose3d cameraPose = this->pose;
     if (cameraSdf->HasElement("pose"))
       cameraPose = cameraSdf->Get<ignition::math::Pose3d>("pose") + cameraPose;
@@ -173,12 +279,15 @@ void CameraSensor::Init()
       ~rendering::Scene::GZ_SKYX_CLOUDS &
       ~rendering::Scene::GZ_SKYX_MOON);
 
-  Sensor::Init();
+  return true;
 }
 
 //////////////////////////////////////////////////
 void CameraSensor::Fini()
 {
+  this->dataPtr->StopEncoder();
+  this->dataPtr->compressedPub.reset();
+  this->dataPtr->outputs.clear();
   this->imagePub.reset();
 
   if (this->camera)
@@ -212,9 +321,37 @@ void CameraSensor::Update(bool _force)
 //////////////////////////////////////////////////
 void CameraSensor::Render()
 {
+  // A lazy camera is created on the rendering thread, when it's needed
+  if (this->dataPtr->initPending && this->IsActive())
+  {
+    this->dataPtr->initPending = false;
+    this->InitCamera();
+  }
+
   if (!this->camera || !this->IsActive() || !this->NeedsUpdate())
     return;
 
+  // The outputs are only read back while they have subscribers, and the
+  // full image only while something may use it
+  if (!this->dataPtr->outputs.empty())
+  {
+    for (const auto &output : this->dataPtr->outputs)
+    {
+      if (output.index >= 0)
+      {
+        this->camera->SetImageOutputEnabled(output.index,
+            output.pub->HasConnections());
+      }
+    }
+
+    this->camera->SetCaptureData(this->dataPtr->fullImageRequired ||
+        this->dataPtr->newFrame.ConnectionCount() > 0 ||
+        (this->imagePub && this->imagePub->HasConnections()) ||
+        (this->dataPtr->compressedPub &&
+         this->dataPtr->compressedPub->HasConnections()) ||
+        this->imagePubIgn.HasConnections());
+  }
+
   // Update all the cameras
   this->camera->Render();
 
@@ -230,11 +367,77 @@ bool CameraSensor::UpdateImpl(const bool /*_force*/)
 
   this->camera->PostRender();
 
+  // The outputs are read back synchronously, so they show the last render
+  for (const auto &output : this->dataPtr->outputs)
+  {
+    if (output.index < 0 || !output.pub->HasConnections() ||
+        !this->camera->ImageOutputData(output.index))
+    {
+      continue;
+    }
+
+    msgs::ImageStamped msg;
+    msgs::Set(msg.mutable_time(), this->scene->SimTime());
+    msg.mutable_image()->set_width(
+        this->camera->ImageOutputWidth(output.index));
+    msg.mutable_image()->set_height(
+        this->camera->ImageOutputHeight(output.index));
+    msg.mutable_image()->set_pixel_format(common::Image::ConvertPixelFormat(
+          this->camera->ImageFormat()));
+    msg.mutable_image()->set_step(msg.image().width() *
+        this->camera->ImageDepth());
+    msg.mutable_image()->set_data(this->camera->ImageOutputData(output.index),
+        msg.image().step() * msg.image().height());
+    output.pub->Publish(msg);
+  }
+
+  // With asynchronous readback, the image is the one of the previous
+  // render, and there is none the first time.
+  auto simTime = this->scene->SimTime();
+  if (this->camera->ReadbackLatency() > 0)
+  {
+    if (this->camera->ImageCount() == this->dataPtr->imageCount)
+    {
+      this->dataPtr->rendered = false;
+      return false;
+    }
+    simTime = this->camera->ImageSimTime();
+    this->lastMeasurementTime = simTime;
+  }
+  this->dataPtr->imageCount = this->camera->ImageCount();
+
+  // In-process subscribers and the encoder share one copy of the image,
+  // taken from the pool so its buffer is allocated only once.
+  const bool encode = this->dataPtr->compressedPub &&
+      this->dataPtr->compressedPub->HasConnections();
+  if ((this->dataPtr->newFrame.ConnectionCount() > 0 || encode) &&
+      this->camera->ImageData())
+  {
+    auto frame = this->dataPtr->framePool.Acquire();
+    frame->width = this->camera->ImageWidth();
+    frame->height = this->camera->ImageHeight();
+    frame->depth = this->camera->ImageDepth();
+    frame->format = this->camera->ImageFormat();
+    frame->simTime = simTime;
+    frame->data.resize(static_cast<size_t>(frame->width) * frame->height *
+        frame->depth);
+    std::memcpy(frame->data.data(), this->camera->ImageData(),
+        frame->data.size());
+
+    ImageFramePtr shared = frame;
+    this->dataPtr->newFrame(shared);
+
+    if (encode)
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->encodeMutex);
+      this->dataPtr->encodeFrame = shared;
+      this->dataPtr->encodeCondition.notify_one();
+    }
+  }
 
   if ((this->imagePub && this->imagePub->HasConnections()) ||
       this->imagePubIgn.HasConnections())
   {
-    auto simTime = this->scene->SimTime();
     if (this->imagePub && this->imagePub->HasConnections())
     {
       msgs::ImageStamped msg;
@@ -321,6 +524,13 @@ const unsigned char *CameraSensor::ImageData() const
     return nullptr;
 }
 
+//////////////////////////////////////////////////
+event::ConnectionPtr CameraSensor::ConnectImageFrame(
+    std::function<void(const ImageFramePtr &)> _subscriber)
+{
+  return this->dataPtr->newFrame.Connect(_subscriber);
+}
+
 //////////////////////////////////////////////////
 bool CameraSensor::SaveFrame(const std::string &_filename)
 {
@@ -337,6 +547,21 @@ bool CameraSensor::IsActive() const
 {
   return Sensor::IsActive() ||
     (this->imagePub && this->imagePub->HasConnections()) ||
+    (this->dataPtr->compressedPub &&
+     this->dataPtr->compressedPub->HasConnections()) ||
+    this->dataPtr->OutputsConnected() ||
+    this->imagePubIgn.HasConnections();
+}
+
+//////////////////////////////////////////////////
+bool CameraSensor::HasConsumers() const
+{
+  return this->HasLocalConsumers() ||
+    this->dataPtr->newFrame.ConnectionCount() > 0 ||
+    (this->imagePub && this->imagePub->HasConnections()) ||
+    (this->dataPtr->compressedPub &&
+     this->dataPtr->compressedPub->HasConnections()) ||
+    this->dataPtr->OutputsConnected() ||
     this->imagePubIgn.HasConnections();
 }
 
@@ -370,3 +595,83 @@ void CameraSensor::ResetLastUpdateTime()
   Sensor::ResetLastUpdateTime();
 }
 
+//////////////////////////////////////////////////
+void CameraSensorPrivate::EncodeLoop()
+{
+  std::unique_lock<std::mutex> lock(this->encodeMutex);
+  while (true)
+  {
+    this->encodeCondition.wait(lock, [this]
+        {
+          return this->encodeStop || this->encodeFrame;
+        });
+    if (this->encodeStop)
+      return;
+
+    ImageFramePtr frame = std::move(this->encodeFrame);
+    this->encodeFrame.reset();
+    lock.unlock();
+
+    const common::Image::PixelFormat format =
+        common::Image::ConvertPixelFormat(frame->format);
+    if (format != common::Image::L_INT8 &&
+        format != common::Image::RGB_INT8 &&
+        format != common::Image::RGBA_INT8 &&
+        format != common::Image::BGR_INT8)
+    {
+      if (!this->encodeFormatWarned)
+      {
+        gzerr << "Unable to compress images of format[" << frame->format
+              << "], only 8 bit gray and color images are compressed.\n";
+        this->encodeFormatWarned = true;
+      }
+    }
+    else
+    {
+      msgs::CompressedImage msg;
+      msgs::Set(msg.mutable_time(), frame->simTime);
+      msg.set_format(this->compressionFormat);
+      msg.set_width(frame->width);
+      msg.set_height(frame->height);
+
+      std::string data;
+      this->encodeImage.SetFromData(frame->data.data(), frame->width,
+          frame->height, format);
+      if (this->encodeImage.Encode(this->compressionFormat, data,
+            this->compressionQuality))
+      {
+        msg.set_data(std::move(data));
+        this->compressedPub->Publish(msg);
+      }
+    }
+
+    // Release the frame before waiting, so it goes back to the pool
+    frame.reset();
+    lock.lock();
+  }
+}
+
+//////////////////////////////////////////////////
+void CameraSensorPrivate::StopEncoder()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->encodeMutex);
+    this->encodeStop = true;
+    this->encodeFrame.reset();
+  }
+  this->encodeCondition.notify_all();
+
+  if (this->encodeThread.joinable())
+    this->encodeThread.join();
+}
+
+//////////////////////////////////////////////////
+bool CameraSensorPrivate::OutputsConnected() const
+{
+  for (const auto &output : this->outputs)
+  {
+    if (output.pub && output.pub->HasConnections())
+      return true;
+  }
+  return false;
+}
@@ -17,10 +17,12 @@
 #ifndef GAZEBO_SENSORS_CAMERASENSOR_HH_
 #define GAZEBO_SENSORS_CAMERASENSOR_HH_
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <ignition/transport/Node.hh>
 
+#include "gazebo/sensors/ImageFrame.hh"
 #include "gazebo/sensors/Sensor.hh"
 #include "gazebo/rendering/RenderTypes.hh"
 #include "gazebo/transport/TransportTypes.hh"
@@ -58,7 +60,10 @@ namespace gazebo
       /// \param[in] _worldName Name of world to load from
       public: virtual void Load(const std::string &_worldName) override;
 
-      /// \brief Initialize the camera
+      /// \brief Initialize the camera. A lazy sensor without plugins and
+      /// without consumers creates its camera and render texture once it
+      /// has a consumer, so that Camera() is null until then.
+      /// \sa Sensor::SetLazyUpdate
       public: virtual void Init() override;
 
       /// \brief reset timing related members
@@ -84,6 +89,11 @@ namespace gazebo
       /// \return Ignition topic name
       public: std::string TopicIgn() const;
 
+      /// \brief Gets the topic of the compressed images, which are
+      /// published when <camera> has a <gz:compression> element.
+      /// \return Topic of the msgs::CompressedImage messages.
+      public: std::string CompressedTopic() const;
+
       /// \brief Set whether the sensor is active or not.
       /// \param[in] _value True if active, false if not.
       public: void SetActive(bool _value) override;
@@ -104,6 +114,15 @@ namespace gazebo
       /// \return The pointer to the image data array.
       public: const unsigned char *ImageData() const;
 
+      /// \brief Connect to the images produced by the sensor. Subscribers
+      /// in the same process share one copy of each image, which they may
+      /// keep for as long as they need. Images are only copied out of the
+      /// camera while there are subscribers or transport connections.
+      /// \param[in] _subscriber Callback that receives each image.
+      /// \return A pointer to the connection. This must be kept in scope.
+      public: event::ConnectionPtr ConnectImageFrame(
+                  std::function<void(const ImageFramePtr &)> _subscriber);
+
       /// \brief Saves the image to the disk.
       /// \param[in] _filename The name of the file to be saved.
       /// \return True if successful, false if unsuccessful.
@@ -112,6 +131,9 @@ namespace gazebo
       // Documentation inherited
       public: virtual bool IsActive() const override;
 
+      // Documentation inherited
+      public: virtual bool HasConsumers() const override;
+
       // Documentation inherited
       protected: virtual bool UpdateImpl(const bool _force) override;
 
@@ -137,6 +159,10 @@ namespace gazebo
       /// \brief Publisher of image messages.
       protected: ignition::transport::Node::Publisher imagePubIgn;
 
+      /// \brief Create the camera and its render texture.
+      /// \return False if the camera can't be created.
+      private: bool InitCamera();
+
       /// \internal
       /// \brief Private data pointer
       private: std::unique_ptr<CameraSensorPrivate> dataPtr;
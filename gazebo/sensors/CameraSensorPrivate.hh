@@ -17,16 +17,128 @@
 #ifndef GAZEBO_SENSORS_CAMERASENSOR_PRIVATE_HH_
 #define GAZEBO_SENSORS_CAMERASENSOR_PRIVATE_HH_
 
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gazebo/common/Event.hh"
+#include "gazebo/common/Image.hh"
+#include "gazebo/sensors/ImageFrame.hh"
+#include "gazebo/transport/TransportTypes.hh"
+
 namespace gazebo
 {
   namespace sensors
   {
+    /// \internal
+    /// \brief A region of the image of a camera sensor, scaled down and
+    /// published on a topic of its own.
+    class CameraSensorOutput
+    {
+      /// \brief Name of the output, appended to the topic of the sensor.
+      public: std::string name;
+
+      /// \brief Left column of the region.
+      public: unsigned int x = 0;
+
+      /// \brief Top row of the region.
+      public: unsigned int y = 0;
+
+      /// \brief Width of the region, zero for the rest of the row.
+      public: unsigned int width = 0;
+
+      /// \brief Height of the region, zero for the rest of the image.
+      public: unsigned int height = 0;
+
+      /// \brief Scale of the output.
+      public: double scale = 1.0;
+
+      /// \brief Index of the output in the camera, -1 if the camera
+      /// couldn't add it.
+      public: int index = -1;
+
+      /// \brief Publisher of the output images.
+      public: transport::PublisherPtr pub;
+    };
+
     /// \internal
     /// \brief CameraSensor private data
     class CameraSensorPrivate
     {
       /// \brief True if the sensor was rendered.
       public: bool rendered = false;
+
+      /// \brief True if the camera is created when the sensor first has a
+      /// consumer.
+      public: bool initPending = false;
+
+      /// \brief Camera::ImageCount at the last update, used to skip the
+      /// frames an asynchronous readback didn't deliver.
+      public: uint64_t imageCount = 0;
+
+      /// \brief Frames shared with the in-process subscribers.
+      public: ImageFramePool framePool;
+
+      /// \brief Event triggered with each frame.
+      public: event::EventT<void(const ImageFramePtr &)> newFrame;
+
+      /// \brief Encode the frames handed to the encoder thread and publish
+      /// them, until StopEncoder is called.
+      public: void EncodeLoop();
+
+      /// \brief Stop the encoder thread and wait for it.
+      public: void StopEncoder();
+
+      /// \brief Get whether an output has subscribers.
+      /// \return True if any output publisher has connections.
+      public: bool OutputsConnected() const;
+
+      /// \brief File format of the compressed images, "jpeg" or "png".
+      public: std::string compressionFormat;
+
+      /// \brief JPEG quality of the compressed images.
+      public: int compressionQuality = 80;
+
+      /// \brief Publisher of the compressed images, null unless they are
+      /// enabled.
+      public: transport::PublisherPtr compressedPub;
+
+      /// \brief Thread encoding the compressed images, so that the render
+      /// thread only hands over the frames.
+      public: std::thread encodeThread;
+
+      /// \brief Protects encodeFrame and encodeStop.
+      public: std::mutex encodeMutex;
+
+      /// \brief Notified when a frame is handed to the encoder, or it's
+      /// stopped.
+      public: std::condition_variable encodeCondition;
+
+      /// \brief Latest frame to encode. A frame the encoder didn't get to
+      /// is replaced by the next one, so a slow encoder drops frames rather
+      /// than delaying them.
+      public: ImageFramePtr encodeFrame;
+
+      /// \brief True when the encoder thread must stop.
+      public: bool encodeStop = false;
+
+      /// \brief Image the frames are encoded from, only used by the
+      /// encoder thread. It's created with the sensor, since FreeImage
+      /// isn't initialized in a thread-safe way.
+      public: common::Image encodeImage;
+
+      /// \brief True once an unsupported pixel format has been reported.
+      public: bool encodeFormatWarned = false;
+
+      /// \brief Regions of the image published on their own, from the
+      /// <gz:output> elements of <camera>.
+      public: std::vector<CameraSensorOutput> outputs;
+
+      /// \brief True if the full image is always read back, even when the
+      /// sensor has outputs, because plugins or frame saving may use it.
+      public: bool fullImageRequired = true;
     };
   }
 }
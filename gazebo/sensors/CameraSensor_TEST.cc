@@ -16,6 +16,10 @@
 */
 
 #include <gtest/gtest.h>
+
+#include <mutex>
+#include <vector>
+
 #include "gazebo/test/ServerFixture.hh"
 #include "gazebo/test/helper_physics_generator.hh"
 
@@ -81,6 +85,59 @@ TEST_F(CameraSensor_TEST, CreateCamera)
   EXPECT_EQ(sensor->ImageHeight(), 0u);
 }
 
+/////////////////////////////////////////////////
+TEST_F(CameraSensor_TEST, ImageFrames)
+{
+  this->Load("worlds/empty.world");
+  this->SpawnCamera("camera", "camera", ignition::math::Vector3d::Zero,
+      ignition::math::Vector3d::Zero);
+
+  sensors::CameraSensorPtr sensor =
+     std::dynamic_pointer_cast<sensors::CameraSensor>(
+     sensors::SensorManager::Instance()->GetSensor(
+     "default::camera::body::camera"));
+  ASSERT_TRUE(sensor != nullptr);
+
+  std::mutex mutex;
+  std::vector<sensors::ImageFramePtr> frames;
+  event::ConnectionPtr connection = sensor->ConnectImageFrame(
+      [&](const sensors::ImageFramePtr &_frame)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        frames.push_back(_frame);
+      });
+
+  // wait for camera images
+  int sleep = 0;
+  int maxSleep = 50;
+  while (sleep < maxSleep)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (frames.size() >= 2u)
+        break;
+    }
+    sleep++;
+    common::Time::MSleep(100);
+  }
+  connection.reset();
+
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT_GE(frames.size(), 2u);
+
+  // Frames kept by a subscriber are not reused
+  EXPECT_NE(frames[0], frames[1]);
+  EXPECT_NE(frames[0]->data.data(), frames[1]->data.data());
+  for (auto const &frame : frames)
+  {
+    EXPECT_EQ(frame->width, 320u);
+    EXPECT_EQ(frame->height, 240u);
+    EXPECT_EQ(frame->Size(), static_cast<size_t>(frame->width) *
+        frame->height * frame->depth);
+  }
+  EXPECT_LE(frames[0]->simTime, frames[1]->simTime);
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
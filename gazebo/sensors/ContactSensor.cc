@@ -112,12 +112,16 @@ void ContactSensor::Load(const std::string &_worldName)
     // request the contact manager to publish messages to a custom topic for
     // this sensor
     physics::ContactManager *mgr = this->world->Physics()->GetContactManager();
-    std::string topic = mgr->CreateFilter(this->dataPtr->filterName,
-        this->dataPtr->collisions);
-    if (!this->dataPtr->contactSub)
+    mgr->CreateFilter(this->dataPtr->filterName, this->dataPtr->collisions);
+
+    // Receive the filtered contacts in process, so that the contact
+    // manager only builds messages for other subscribers of the topic.
+    if (!this->dataPtr->contactCallbackSet)
     {
-      this->dataPtr->contactSub = this->node->Subscribe(topic,
-          &ContactSensor::OnContacts, this);
+      this->dataPtr->contactCallbackSet = mgr->SetFilterCallback(
+          this->dataPtr->filterName,
+          std::bind(&ContactSensor::OnLocalContacts, this,
+            std::placeholders::_1));
     }
   }
 }
@@ -137,52 +141,32 @@ bool ContactSensor::UpdateImpl(const bool /*_force*/)
   if (this->dataPtr->incomingContacts.empty())
     return false;
 
-  std::vector<std::string>::iterator collIter;
-  std::string collision1;
-
   // Clear the outgoing contact message.
   this->dataPtr->contactsMsg.clear_contact();
 
-  // Iterate over all the contact messages
+  // Iterate over all the contact messages. They come from the contact
+  // manager filter of this sensor, which only holds contacts of the
+  // monitored collisions, so the collision names don't need matching.
   for (auto iter = this->dataPtr->incomingContacts.begin();
        iter != this->dataPtr->incomingContacts.end(); ++iter)
   {
     // Iterate over all the contacts in the message
     for (int i = 0; i < (*iter)->contact_size(); ++i)
     {
-      collision1 = (*iter)->contact(i).collision1();
-
-      // Try to find the first collision's name
-      collIter = std::find(this->dataPtr->collisions.begin(),
-          this->dataPtr->collisions.end(), collision1);
+      int count = (*iter)->contact(i).position_size();
 
-      // If unable to find the first collision's name, try the second
-      if (collIter == this->dataPtr->collisions.end())
+      // Check to see if the contact arrays all have the same size.
+      if (count != (*iter)->contact(i).normal_size() ||
+          count != (*iter)->contact(i).wrench_size() ||
+          count != (*iter)->contact(i).depth_size())
       {
-        collision1 = (*iter)->contact(i).collision2();
-        collIter = std::find(this->dataPtr->collisions.begin(),
-            this->dataPtr->collisions.end(), collision1);
+        gzerr << "Contact message has invalid array sizes\n";
+        continue;
       }
 
-      // If this sensor is monitoring one of the collision's in the
-      // contact, then add the contact to our outgoing message.
-      if (collIter != this->dataPtr->collisions.end())
-      {
-        int count = (*iter)->contact(i).position_size();
-
-        // Check to see if the contact arrays all have the same size.
-        if (count != (*iter)->contact(i).normal_size() ||
-            count != (*iter)->contact(i).wrench_size() ||
-            count != (*iter)->contact(i).depth_size())
-        {
-          gzerr << "Contact message has invalid array sizes\n";
-          continue;
-        }
-
-        // Copy the contact message.
-        msgs::Contact *contactMsg = this->dataPtr->contactsMsg.add_contact();
-        contactMsg->CopyFrom((*iter)->contact(i));
-      }
+      // Copy the contact message.
+      msgs::Contact *contactMsg = this->dataPtr->contactsMsg.add_contact();
+      contactMsg->CopyFrom((*iter)->contact(i));
     }
   }
 
@@ -212,8 +196,14 @@ void ContactSensor::Fini()
         this->world->Physics()->GetContactManager();
     mgr->RemoveFilter(this->dataPtr->filterName);
   }
+  else if (this->dataPtr->contactCallbackSet && this->world &&
+      this->world->Physics())
+  {
+    this->world->Physics()->GetContactManager()->SetFilterCallback(
+        this->dataPtr->filterName, nullptr);
+  }
+  this->dataPtr->contactCallbackSet = false;
 
-  this->dataPtr->contactSub.reset();
   this->dataPtr->contactsPub.reset();
   Sensor::Fini();
 }
@@ -311,6 +301,26 @@ void ContactSensor::OnContacts(ConstContactsPtr &_msg)
   }
 }
 
+//////////////////////////////////////////////////
+void ContactSensor::OnLocalContacts(
+    const std::vector<physics::Contact *> &_contacts)
+{
+  if (!this->IsActive())
+    return;
+
+  boost::shared_ptr<msgs::Contacts> msg(new msgs::Contacts);
+  for (auto const &contact : _contacts)
+  {
+    if (contact->count == 0)
+      continue;
+
+    contact->FillMsg(*msg->add_contact());
+  }
+  msgs::Set(msg->mutable_time(), this->world->SimTime());
+
+  this->OnContacts(msg);
+}
+
 //////////////////////////////////////////////////
 bool ContactSensor::IsActive() const
 {
@@ -19,6 +19,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 #include <memory>
 
 #include "gazebo/msgs/msgs.hh"
@@ -136,6 +137,12 @@ namespace gazebo
       /// \brief Callback for contact messages from the physics engine.
       private: void OnContacts(ConstContactsPtr &_msg);
 
+      /// \brief In-process callback for the contacts of this sensor's
+      /// contact manager filter, called from the physics thread.
+      /// \param[in] _contacts Contacts of the filter.
+      private: void OnLocalContacts(
+                   const std::vector<physics::Contact *> &_contacts);
+
       /// \internal
       /// \brief Private data pointer
       private: std::unique_ptr<ContactSensorPrivate> dataPtr;
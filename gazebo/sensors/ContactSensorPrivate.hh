@@ -39,8 +39,9 @@ namespace gazebo
       /// \brief Output contact information.
       public: transport::PublisherPtr contactsPub;
 
-      /// \brief Subscription to contact messages from the physics engine
-      public: transport::SubscriberPtr contactSub;
+      /// \brief True if the in-process contact callback is set on the
+      /// contact manager filter.
+      public: bool contactCallbackSet = false;
 
       /// \brief Mutex to protect reads and writes.
       public: mutable std::mutex mutex;
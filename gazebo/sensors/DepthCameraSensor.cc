@@ -15,10 +15,16 @@
  *
 */
 #include <functional>
+#include <string>
+
+#include "gazebo/common/CommonIface.hh"
+
+#include "gazebo/msgs/msgs.hh"
 
 #include "gazebo/physics/World.hh"
 
 #include "gazebo/rendering/DepthCamera.hh"
+#include "gazebo/rendering/DepthNoise.hh"
 #include "gazebo/rendering/RenderingIface.hh"
 #include "gazebo/rendering/RenderEngine.hh"
 #include "gazebo/rendering/Scene.hh"
@@ -45,6 +51,8 @@ DepthCameraSensor::DepthCameraSensor()
 //////////////////////////////////////////////////
 DepthCameraSensor::~DepthCameraSensor()
 {
+  this->dataPtr->pointsConnection.reset();
+
   if (this->dataPtr->depthBuffer)
     delete [] this->dataPtr->depthBuffer;
 }
@@ -53,6 +61,32 @@ DepthCameraSensor::~DepthCameraSensor()
 void DepthCameraSensor::Load(const std::string &_worldName)
 {
   CameraSensor::Load(_worldName);
+
+  sdf::ElementPtr cameraSdf = this->sdf->GetElement("camera");
+  if (cameraSdf->HasElement("depth_camera") &&
+      cameraSdf->GetElement("depth_camera")->Get<std::string>(
+      "output").find("points") != std::string::npos)
+  {
+    this->dataPtr->pointsPub =
+        this->node->Advertise<msgs::PointCloud>(this->PointsTopic(), 50);
+  }
+}
+
+//////////////////////////////////////////////////
+std::string DepthCameraSensor::PointsTopic() const
+{
+  std::string topicName = "~/";
+  topicName += this->ParentName() + "/" + this->Name() + "/points";
+  common::replaceAll(topicName, topicName, "::", "/");
+
+  return topicName;
+}
+
+//////////////////////////////////////////////////
+bool DepthCameraSensor::HasConsumers() const
+{
+  return CameraSensor::HasConsumers() ||
+    (this->dataPtr->pointsPub && this->dataPtr->pointsPub->HasConnections());
 }
 
 //////////////////////////////////////////////////
@@ -88,6 +122,16 @@ void DepthCameraSensor::Init()
     sdf::ElementPtr cameraSdf = this->sdf->GetElement("camera");
     this->dataPtr->depthCamera->Load(cameraSdf);
 
+    // The depth shader adds the noise, before the readback
+    if (cameraSdf->HasElement("depth_camera") &&
+        cameraSdf->GetElement("depth_camera")->HasElement("gz:noise"))
+    {
+      rendering::DepthNoise noise;
+      noise.Load(
+          cameraSdf->GetElement("depth_camera")->GetElement("gz:noise"));
+      this->dataPtr->depthCamera->SetDepthNoise(noise);
+    }
+
     // Do some sanity checks
     if (this->dataPtr->depthCamera->ImageWidth() == 0u ||
         this->dataPtr->depthCamera->ImageHeight() == 0u)
@@ -95,6 +139,16 @@ void DepthCameraSensor::Init()
       gzerr << "image has zero size" << std::endl;
     }
 
+    if (this->dataPtr->pointsPub)
+    {
+      this->dataPtr->pointsConnection =
+          this->dataPtr->depthCamera->ConnectNewRGBPointCloud(
+          std::bind(&DepthCameraSensor::OnNewRGBPointCloud, this,
+            std::placeholders::_1, std::placeholders::_2,
+            std::placeholders::_3, std::placeholders::_4,
+            std::placeholders::_5));
+    }
+
     this->dataPtr->depthCamera->Init();
     this->dataPtr->depthCamera->CreateRenderTexture(
         this->Name() + "_RttTex_Image");
@@ -137,13 +191,28 @@ bool DepthCameraSensor::UpdateImpl(const bool /*_force*/)
 
   this->camera->PostRender();
 
+  // With asynchronous readback, the depth is the one of the previous
+  // render, and there is none the first time.
+  auto simTime = this->scene->SimTime();
+  if (this->camera->ReadbackLatency() > 0)
+  {
+    if (this->camera->ImageCount() == this->dataPtr->imageCount)
+    {
+      this->SetRendered(false);
+      return false;
+    }
+    simTime = this->camera->ImageSimTime();
+    this->lastMeasurementTime = simTime;
+  }
+  this->dataPtr->imageCount = this->camera->ImageCount();
+
   if (this->imagePub && this->imagePub->HasConnections() &&
       // check if depth data is available. If not, the depth camera could be
       // generating point clouds instead
       this->dataPtr->depthCamera->DepthData())
   {
     msgs::ImageStamped msg;
-    msgs::Set(msg.mutable_time(), this->scene->SimTime());
+    msgs::Set(msg.mutable_time(), simTime);
     msg.mutable_image()->set_width(this->camera->ImageWidth());
     msg.mutable_image()->set_height(this->camera->ImageHeight());
     msg.mutable_image()->set_pixel_format(common::Image::R_FLOAT32);
@@ -183,6 +252,29 @@ bool DepthCameraSensor::UpdateImpl(const bool /*_force*/)
   return true;
 }
 
+//////////////////////////////////////////////////
+void DepthCameraSensor::OnNewRGBPointCloud(const float *_data,
+    unsigned int _width, unsigned int _height, unsigned int /*_depth*/,
+    const std::string &/*_format*/)
+{
+  if (!_data || !this->dataPtr->pointsPub->HasConnections())
+    return;
+
+  // The points are already in the camera's optical frame, only the 4th
+  // channel is dropped.
+  const unsigned int count = _width * _height;
+  msgs::PointCloud msg;
+  msg.mutable_points()->Reserve(count);
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    const float *point = _data + i * 4;
+    msgs::Set(msg.add_points(),
+        ignition::math::Vector3d(point[0], point[1], point[2]));
+  }
+
+  this->dataPtr->pointsPub->Publish(msg);
+}
+
 //////////////////////////////////////////////////
 const float *DepthCameraSensor::DepthData() const
 {
@@ -59,6 +59,15 @@ namespace gazebo
       /// \return Depth Camera pointer
       public: virtual rendering::DepthCameraPtr DepthCamera() const;
 
+      /// \brief Get the topic of the point clouds, published as
+      /// msgs::PointCloud when the "points" output of the depth camera is
+      /// enabled. The points come from the GPU, in the order of the pixels.
+      /// \return Name of the topic.
+      public: std::string PointsTopic() const;
+
+      // Documentation inherited
+      public: virtual bool HasConsumers() const override;
+
       /// \brief Load the sensor with default parameters
       /// \param[in] _worldName Name of world to load from
       protected: virtual void Load(const std::string &_worldName);
@@ -66,6 +75,16 @@ namespace gazebo
       // Documentation inherited
       protected: virtual bool UpdateImpl(const bool _force);
 
+      /// \brief Publish a point cloud rendered by the depth camera.
+      /// \param[in] _data Points, as 4 floats each.
+      /// \param[in] _width Width of the point cloud.
+      /// \param[in] _height Height of the point cloud.
+      /// \param[in] _depth Unused.
+      /// \param[in] _format Unused.
+      private: void OnNewRGBPointCloud(const float *_data,
+                   unsigned int _width, unsigned int _height,
+                   unsigned int _depth, const std::string &_format);
+
       /// \internal
       /// \brief Private data pointer
       private: std::unique_ptr<DepthCameraSensorPrivate> dataPtr;
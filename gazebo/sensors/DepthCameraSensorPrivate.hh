@@ -17,7 +17,9 @@
 #ifndef _GAZEBO_SENSORS_DEPTHCAMERASENSOR_PRIVATE_HH_
 #define _GAZEBO_SENSORS_DEPTHCAMERASENSOR_PRIVATE_HH_
 
+#include "gazebo/common/Event.hh"
 #include "gazebo/rendering/RenderTypes.hh"
+#include "gazebo/transport/TransportTypes.hh"
 
 namespace gazebo
 {
@@ -32,6 +34,17 @@ namespace gazebo
 
       /// \brief Local pointer to the depthCamera.
       public: rendering::DepthCameraPtr depthCamera;
+
+      /// \brief Camera::ImageCount at the last update, used to skip the
+      /// frames an asynchronous readback didn't deliver.
+      public: uint64_t imageCount = 0;
+
+      /// \brief Publisher of point clouds, if the depth camera outputs
+      /// points.
+      public: transport::PublisherPtr pointsPub;
+
+      /// \brief Connection to the point clouds of the depth camera.
+      public: event::ConnectionPtr pointsConnection;
     };
   }
 }
@@ -192,6 +192,90 @@ TEST_F(DepthCameraSensor_normals_TEST, CreateDepthCamera)
   EXPECT_GE(g_normalsCounter, framesToWait);
 }
 
+/////////////////////////////////////////////////
+class DepthCameraSensor_points_TEST : public ServerFixture
+{
+};
+
+std::mutex g_pointsMutex;
+unsigned int g_pointsCounter = 0;
+unsigned int g_pointsMsgCounter = 0;
+
+/////////////////////////////////////////////////
+void OnNewPointsFrame(const float *_points,
+    unsigned int _width, unsigned int _height,
+    unsigned int /*_depth*/, const std::string &/*_format*/)
+{
+  ASSERT_NE(nullptr, _points);
+  std::lock_guard<std::mutex> lock(g_pointsMutex);
+
+  // The box face is 2.5m ahead of the camera, in the optical frame
+  unsigned int index = (_height / 2) * _width + _width / 2;
+  EXPECT_NEAR(_points[4 * index], 0.0, 0.05);
+  EXPECT_NEAR(_points[4 * index + 1], 0.0, 0.05);
+  EXPECT_NEAR(_points[4 * index + 2], 2.5, 0.05);
+
+  // Left of the image center is -x, above it is -y
+  unsigned int left = (_height / 2) * _width + _width / 4;
+  unsigned int up = (_height / 4) * _width + _width / 2;
+  EXPECT_LT(_points[4 * left], 0.0);
+  EXPECT_LT(_points[4 * up + 1], 0.0);
+
+  g_pointsCounter++;
+}
+
+/////////////////////////////////////////////////
+void OnPointsMsg(ConstPointCloudPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(g_pointsMutex);
+  EXPECT_EQ(_msg->points_size(), 640 * 480);
+  g_pointsMsgCounter++;
+}
+
+/////////////////////////////////////////////////
+/// \brief Test point clouds reprojected from the depth texture
+TEST_F(DepthCameraSensor_points_TEST, PointsFromDepth)
+{
+  Load("worlds/depth_camera_points.world");
+  sensors::SensorManager *mgr = sensors::SensorManager::Instance();
+
+  std::string sensorName = "default::camera_model::my_link::camera";
+  sensors::DepthCameraSensorPtr sensor =
+     std::dynamic_pointer_cast<sensors::DepthCameraSensor>
+     (mgr->GetSensor(sensorName));
+  ASSERT_NE(nullptr, sensor);
+
+  rendering::DepthCameraPtr depthCamera = sensor->DepthCamera();
+  ASSERT_NE(nullptr, depthCamera);
+  EXPECT_TRUE(depthCamera->PointsFromDepth());
+
+  event::ConnectionPtr c = depthCamera->ConnectNewRGBPointCloud(
+      std::bind(&::OnNewPointsFrame, std::placeholders::_1,
+      std::placeholders::_2, std::placeholders::_3, std::placeholders::_4,
+      std::placeholders::_5));
+
+  transport::NodePtr node(new transport::Node());
+  node->Init();
+  transport::SubscriberPtr sub =
+      node->Subscribe(sensor->PointsTopic(), &::OnPointsMsg);
+
+  unsigned int framesToWait = 5;
+  int i = 0;
+  while (i < 300)
+  {
+    {
+      std::lock_guard<std::mutex> lock(g_pointsMutex);
+      if (g_pointsCounter >= framesToWait && g_pointsMsgCounter > 0)
+        break;
+    }
+    common::Time::MSleep(20);
+    i++;
+  }
+  std::lock_guard<std::mutex> lock(g_pointsMutex);
+  EXPECT_GE(g_pointsCounter, framesToWait);
+  EXPECT_GT(g_pointsMsgCounter, 0u);
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -167,12 +167,22 @@ void ForceTorqueSensor::Load(const std::string &_worldName)
 void ForceTorqueSensor::Init()
 {
   Sensor::Init();
-  this->dataPtr->parentJoint->SetProvideFeedback(true);
+
+  // Read the first measurement after the next step
+  if (this->dataPtr->parentJoint && !this->dataPtr->feedbackUser)
+  {
+    this->dataPtr->parentJoint->AddFeedbackUser();
+    this->dataPtr->feedbackUser = true;
+  }
 }
 
 //////////////////////////////////////////////////
 void ForceTorqueSensor::Fini()
 {
+  if (this->dataPtr->parentJoint && this->dataPtr->feedbackUser)
+    this->dataPtr->parentJoint->RemoveFeedbackUser();
+  this->dataPtr->feedbackUser = false;
+
   this->dataPtr->wrenchPub.reset();
   this->dataPtr->parentJoint.reset();
 
@@ -278,6 +288,24 @@ bool ForceTorqueSensor::IsActive() const
   return Sensor::IsActive() || this->dataPtr->wrenchPub->HasConnections();
 }
 
+//////////////////////////////////////////////////
+void ForceTorqueSensor::Update(const bool _force)
+{
+  // The feedback of the joint costs a wrench per step, keep it while the
+  // sensor is used
+  if (this->dataPtr->parentJoint && this->dataPtr->wrenchPub)
+  {
+    bool active = this->IsActive();
+    if (active && !this->dataPtr->feedbackUser)
+      this->dataPtr->parentJoint->AddFeedbackUser();
+    else if (!active && this->dataPtr->feedbackUser)
+      this->dataPtr->parentJoint->RemoveFeedbackUser();
+    this->dataPtr->feedbackUser = active;
+  }
+
+  Sensor::Update(_force);
+}
+
 //////////////////////////////////////////////////
 event::ConnectionPtr ForceTorqueSensor::ConnectUpdate(
     std::function<void (msgs::WrenchStamped)> _subscriber)
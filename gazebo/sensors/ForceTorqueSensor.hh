@@ -76,6 +76,11 @@ namespace gazebo
       // Documentation inherited.
       public: virtual bool IsActive() const;
 
+      /// \brief Update the sensor. The joint provides feedback only while
+      /// the sensor is active, or its topic has subscribers.
+      /// \param[in] _force True to update the sensor even if inactive.
+      public: virtual void Update(const bool _force) override;
+
       /// \brief Connect a to the  update signal.
       /// \param[in] _subscriber Callback function.
       /// \return The connection, which must be kept in scope.
@@ -37,6 +37,9 @@ namespace gazebo
       /// \brief Parent joint, from which we get force torque info.
       public: physics::JointPtr parentJoint;
 
+      /// \brief True if the sensor is a feedback user of parentJoint.
+      public: bool feedbackUser = false;
+
       /// \brief Publishes the wrenchMsg.
       public: transport::PublisherPtr wrenchPub;
 
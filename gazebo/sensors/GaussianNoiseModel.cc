@@ -14,6 +14,8 @@
  * limitations under the License.
  *
 */
+#include <atomic>
+#include <cmath>
 #include <ignition/math/Helpers.hh>
 #include <ignition/math/Rand.hh>
 
@@ -79,6 +81,59 @@ namespace gazebo
 using namespace gazebo;
 using namespace sensors;
 
+namespace
+{
+  /// \brief Id of the next noise model, part of the generator key so each
+  /// model draws its own sequence.
+  std::atomic<uint32_t> g_nextNoiseId(0);
+
+  /// \brief Philox4x32-10 counter-based generator. It has no state besides
+  /// the counter, so a sequence of blocks is cheap to draw and the same key
+  /// and counter always give the same block.
+  /// \param[in] _counter Counter of the block.
+  /// \param[in] _key Key of the generator.
+  /// \param[out] _out Four random 32 bit values.
+  inline void Philox4x32(const uint64_t _counter, const uint32_t _key[2],
+      uint32_t _out[4])
+  {
+    uint32_t c0 = static_cast<uint32_t>(_counter);
+    uint32_t c1 = static_cast<uint32_t>(_counter >> 32);
+    uint32_t c2 = 0;
+    uint32_t c3 = 0;
+    uint32_t k0 = _key[0];
+    uint32_t k1 = _key[1];
+
+    for (int round = 0; round < 10; ++round)
+    {
+      const uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * c0;
+      const uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * c2;
+      c0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+      c1 = static_cast<uint32_t>(p1);
+      c2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+      c3 = static_cast<uint32_t>(p0);
+      k0 += 0x9E3779B9u;
+      k1 += 0xBB67AE85u;
+    }
+
+    _out[0] = c0;
+    _out[1] = c1;
+    _out[2] = c2;
+    _out[3] = c3;
+  }
+
+  /// \brief Convert two random 32 bit values to a uniform variate in the
+  /// open interval (0, 1).
+  /// \param[in] _hi First value.
+  /// \param[in] _lo Second value.
+  /// \return The variate, with 53 random bits.
+  inline double Uniform(const uint32_t _hi, const uint32_t _lo)
+  {
+    const uint64_t bits =
+        ((static_cast<uint64_t>(_hi) << 32) | _lo) >> 11;
+    return (static_cast<double>(bits) + 0.5) * (1.0 / 9007199254740992.0);
+  }
+}
+
 //////////////////////////////////////////////////
 GaussianNoiseModel::GaussianNoiseModel()
   : Noise(Noise::GAUSSIAN),
@@ -90,8 +145,13 @@ GaussianNoiseModel::GaussianNoiseModel()
     biasMean(0),
     biasStdDev(0),
     dynamicBiasStdDev(0),
-    dynamicBiasCorrTime(0)
+    dynamicBiasCorrTime(0),
+    rngCounter(0),
+    spareNormal(0),
+    hasSpareNormal(false)
 {
+  this->rngKey[0] = ignition::math::Rand::Seed();
+  this->rngKey[1] = g_nextNoiseId++;
 }
 
 //////////////////////////////////////////////////
@@ -148,7 +208,7 @@ void GaussianNoiseModel::Fini()
 double GaussianNoiseModel::ApplyImpl(double _in, double _dt)
 {
   // Add independent (uncorrelated) Gaussian noise to each input value.
-  double whiteNoise = ignition::math::Rand::DblNormal(this->mean, this->stdDev);
+  double whiteNoise = this->mean + this->stdDev * this->Normal();
 
   // Generate varying (correlated) bias for each input value.
   // This implementation is based on the one available in Rotors:
@@ -168,8 +228,7 @@ double GaussianNoiseModel::ApplyImpl(double _in, double _dt)
         tau / 2 * expm1(-2 * _dt / tau));
 
     const double phiD = exp(-_dt / tau);
-    this->bias = phiD * this->bias +
-      ignition::math::Rand::DblNormal(0, sigmaBD);
+    this->bias = phiD * this->bias + sigmaBD * this->Normal();
   }
 
   double output = _in + this->bias + whiteNoise;
@@ -184,6 +243,90 @@ double GaussianNoiseModel::ApplyImpl(double _in, double _dt)
   return output;
 }
 
+//////////////////////////////////////////////////
+void GaussianNoiseModel::ApplyBatchImpl(double *_data, size_t _count,
+    double _dt)
+{
+  this->ApplyBatch(_data, _count, _dt);
+}
+
+//////////////////////////////////////////////////
+void GaussianNoiseModel::ApplyBatchImpl(float *_data, size_t _count,
+    double _dt)
+{
+  this->ApplyBatch(_data, _count, _dt);
+}
+
+//////////////////////////////////////////////////
+template<typename T>
+void GaussianNoiseModel::ApplyBatch(T *_data, size_t _count, double _dt)
+{
+  // The dynamic bias is a random walk updated before each value, so the
+  // values have to be processed one at a time.
+  if (this->dynamicBiasStdDev > 0 &&
+      this->dynamicBiasCorrTime > 0)
+  {
+    for (size_t i = 0; i < _count; ++i)
+    {
+      _data[i] = static_cast<T>(
+          this->GaussianNoiseModel::ApplyImpl(_data[i], _dt));
+    }
+    return;
+  }
+
+  const double offset = this->bias + this->mean;
+  double n0, n1;
+  size_t i = 0;
+  for (; i + 1 < _count; i += 2)
+  {
+    this->NormalPair(n0, n1);
+    _data[i] = static_cast<T>(_data[i] + offset + this->stdDev * n0);
+    _data[i + 1] = static_cast<T>(_data[i + 1] + offset + this->stdDev * n1);
+  }
+  if (i < _count)
+  {
+    _data[i] = static_cast<T>(
+        _data[i] + offset + this->stdDev * this->Normal());
+  }
+
+  if (this->quantized)
+  {
+    for (i = 0; i < _count; ++i)
+    {
+      _data[i] = static_cast<T>(
+          std::round(_data[i] / this->precision) * this->precision);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+double GaussianNoiseModel::Normal()
+{
+  if (this->hasSpareNormal)
+  {
+    this->hasSpareNormal = false;
+    return this->spareNormal;
+  }
+
+  double n0;
+  this->NormalPair(n0, this->spareNormal);
+  this->hasSpareNormal = true;
+  return n0;
+}
+
+//////////////////////////////////////////////////
+void GaussianNoiseModel::NormalPair(double &_n0, double &_n1)
+{
+  uint32_t bits[4];
+  Philox4x32(this->rngCounter++, this->rngKey, bits);
+
+  // Box-Muller transform
+  const double r = std::sqrt(-2.0 * std::log(Uniform(bits[0], bits[1])));
+  const double theta = 2.0 * IGN_PI * Uniform(bits[2], bits[3]);
+  _n0 = r * std::cos(theta);
+  _n1 = r * std::sin(theta);
+}
+
 //////////////////////////////////////////////////
 double GaussianNoiseModel::GetMean() const
 {
@@ -18,6 +18,7 @@
 #ifndef _GAZEBO_GAUSSIAN_NOISE_MODEL_HH_
 #define _GAZEBO_GAUSSIAN_NOISE_MODEL_HH_
 
+#include <cstdint>
 #include <vector>
 #include <string>
 
@@ -57,6 +58,14 @@ namespace gazebo
         // Documentation inherited.
         public: double ApplyImpl(double _in, double _dt);
 
+        // Documentation inherited.
+        public: virtual void ApplyBatchImpl(double *_data, size_t _count,
+                    double _dt);
+
+        // Documentation inherited.
+        public: virtual void ApplyBatchImpl(float *_data, size_t _count,
+                    double _dt);
+
         /// \brief Accessor for mean.
         /// \return Mean of Gaussian noise.
         public: double GetMean() const;
@@ -99,6 +108,22 @@ namespace gazebo
         /// \brief Sample the bias.
         private: void SampleBias();
 
+        /// \brief Draw a standard normal variate.
+        /// \return The variate.
+        private: double Normal();
+
+        /// \brief Draw a pair of standard normal variates.
+        /// \param[out] _n0 First variate.
+        /// \param[out] _n1 Second variate.
+        private: void NormalPair(double &_n0, double &_n1);
+
+        /// \brief Apply noise to an array of data values.
+        /// \param[in,out] _data Data values.
+        /// \param[in] _count Number of values in _data.
+        /// \param[in] _dt Time since the last update.
+        private: template<typename T>
+                 void ApplyBatch(T *_data, size_t _count, double _dt);
+
         /// \brief If type starts with GAUSSIAN, the mean of the distribution
         /// from which we sample when adding noise.
         protected: double mean;
@@ -132,6 +157,21 @@ namespace gazebo
         /// \biref If type starts with GAUSSIAN, the correlation time of the
         /// process from which the dynamic bias will be driven.
         private: double dynamicBiasCorrTime;
+
+        /// \brief Key of the counter-based generator drawing the white noise,
+        /// made of the ignition::math::Rand seed and an id unique to the
+        /// noise model.
+        private: uint32_t rngKey[2];
+
+        /// \brief Counter of the generator, incremented for each pair of
+        /// variates.
+        private: uint64_t rngCounter;
+
+        /// \brief Second variate of the last pair, if not used yet.
+        private: double spareNormal;
+
+        /// \brief True if spareNormal holds an unused variate.
+        private: bool hasSpareNormal;
     };
 
     /// \class GaussianNoiseModel
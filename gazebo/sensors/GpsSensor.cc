@@ -59,6 +59,14 @@ void GpsSensor::Load(const std::string &_worldName)
   this->dataPtr->parentLink =
     boost::dynamic_pointer_cast<physics::Link>(parentEntity);
 
+  // The parent link state is gathered once per step for all sensors
+  if (this->dataPtr->parentLink)
+  {
+    this->dataPtr->linkStates = LinkStateBatch::Acquire(this->world);
+    this->dataPtr->linkSlot =
+      this->dataPtr->linkStates->Add(this->dataPtr->parentLink);
+  }
+
   this->dataPtr->lastGpsMsg.set_link_name(this->ParentName());
 
   this->dataPtr->topicName = "~/" + this->ParentName() + '/' + this->Name();
@@ -108,6 +116,10 @@ void GpsSensor::Load(const std::string &_worldName)
 void GpsSensor::Fini()
 {
   Sensor::Fini();
+  if (this->dataPtr->linkStates)
+    this->dataPtr->linkStates->Remove(this->dataPtr->linkSlot);
+  this->dataPtr->linkStates.reset();
+  this->dataPtr->linkSlot = -1;
   this->dataPtr->parentLink.reset();
   this->dataPtr->sphericalCoordinates.reset();
 }
@@ -124,13 +136,14 @@ void GpsSensor::Init()
 bool GpsSensor::UpdateImpl(const bool /*_force*/)
 {
   // Get latest pose information
-  if (this->dataPtr->parentLink)
+  LinkState state;
+  if (this->dataPtr->linkStates &&
+      this->dataPtr->linkStates->Read(this->dataPtr->linkSlot, state))
   {
     // Measure position and apply noise
     {
       // Get postion in Cartesian gazebo frame
-      ignition::math::Pose3d gpsPose = this->pose +
-        this->dataPtr->parentLink->WorldPose();
+      ignition::math::Pose3d gpsPose = this->pose + state.pose;
 
       // Apply position noise before converting to global frame
       gpsPose.Pos().X(
@@ -153,8 +166,9 @@ bool GpsSensor::UpdateImpl(const bool /*_force*/)
 
     // Measure velocity and apply noise
     {
-      ignition::math::Vector3d gpsVelocity =
-        this->dataPtr->parentLink->WorldLinearVel(this->pose.Pos());
+      ignition::math::Vector3d gpsVelocity = state.linearVel +
+        state.angularVel.Cross(
+            state.pose.Rot().RotateVector(this->pose.Pos()));
 
       // Convert to global frame
       gpsVelocity =
@@ -22,6 +22,7 @@
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/common/CommonTypes.hh"
 #include "gazebo/msgs/msgs.hh"
+#include "gazebo/sensors/LinkStateBatch.hh"
 
 namespace gazebo
 {
@@ -40,6 +41,12 @@ namespace gazebo
       /// \brief Parent link of this sensor.
       public: physics::LinkPtr parentLink;
 
+      /// \brief Link states of the world, holding the parent link.
+      public: LinkStateBatchPtr linkStates;
+
+      /// \brief Slot of the parent link in linkStates.
+      public: int linkSlot = -1;
+
       /// \brief Pointer to SphericalCoordinates converter.
       public: common::SphericalCoordinatesPtr sphericalCoordinates;
 
@@ -30,6 +30,7 @@
 #include "gazebo/rendering/Scene.hh"
 #include "gazebo/rendering/RenderingIface.hh"
 #include "gazebo/rendering/RenderEngine.hh"
+#include "gazebo/rendering/DepthNoise.hh"
 #include "gazebo/rendering/GpuLaser.hh"
 
 #include "gazebo/sensors/Noise.hh"
@@ -111,12 +112,16 @@ void GpuRaySensor::Load(const std::string &_worldName)
   this->dataPtr->rangeMin = this->RangeMin();
   this->dataPtr->rangeMax = this->RangeMax();
 
-  // Handle noise model settings.
+  // Handle noise model settings. With <gz:gpu> the shader adds the noise
+  // before the readback, see Init.
   if (rayElem->HasElement("noise"))
   {
-    this->noises[GPU_RAY_NOISE] =
-        NoiseFactory::NewNoiseModel(rayElem->GetElement("noise"),
-        this->Type());
+    sdf::ElementPtr noiseElem = rayElem->GetElement("noise");
+    if (!noiseElem->HasElement("gz:gpu") || !noiseElem->Get<bool>("gz:gpu"))
+    {
+      this->noises[GPU_RAY_NOISE] =
+          NoiseFactory::NewNoiseModel(noiseElem, this->Type());
+    }
   }
 
   this->dataPtr->parentEntity =
@@ -301,6 +306,31 @@ void GpuRaySensor::Init()
     // Load camera sdf for GpuLaser
     this->dataPtr->laserCam->Load(this->dataPtr->cameraElem);
 
+    sdf::ElementPtr rayElem = this->sdf->GetElement("ray");
+    if (rayElem->HasElement("gz:async_readback"))
+    {
+      this->dataPtr->laserCam->SetAsyncReadback(
+          rayElem->Get<bool>("gz:async_readback"));
+    }
+
+    // Lidars mounted at the same point render their depth images once
+    if (rayElem->HasElement("gz:shared_depth"))
+    {
+      this->dataPtr->laserCam->SetSharedDepth(
+          rayElem->Get<bool>("gz:shared_depth"));
+    }
+
+    if (rayElem->HasElement("noise"))
+    {
+      sdf::ElementPtr noiseElem = rayElem->GetElement("noise");
+      if (noiseElem->HasElement("gz:gpu") && noiseElem->Get<bool>("gz:gpu"))
+      {
+        rendering::DepthNoise noise;
+        noise.Load(noiseElem);
+        this->dataPtr->laserCam->SetRangeNoise(noise);
+      }
+    }
+
     // initialize GpuLaser
     this->dataPtr->laserCam->Init();
     this->dataPtr->laserCam->SetRangeCount(
@@ -602,6 +632,19 @@ bool GpuRaySensor::UpdateImpl(const bool /*_force*/)
 
   this->dataPtr->laserCam->PostRender();
 
+  // With asynchronous readback, the ranges are the ones of the previous
+  // render, and there are none the first time.
+  if (this->dataPtr->laserCam->ReadbackLatency() > 0)
+  {
+    if (this->dataPtr->laserCam->ImageCount() == this->dataPtr->imageCount)
+    {
+      this->dataPtr->rendered = false;
+      return false;
+    }
+    this->lastMeasurementTime = this->dataPtr->laserCam->ImageSimTime();
+  }
+  this->dataPtr->imageCount = this->dataPtr->laserCam->ImageCount();
+
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
   msgs::Set(this->dataPtr->laserMsg.mutable_time(),
@@ -639,6 +682,14 @@ bool GpuRaySensor::UpdateImpl(const bool /*_force*/)
     }
   }
 
+  // The ranges are gathered and the noise is applied to all of them at once
+  NoisePtr noise;
+  auto noiseIter = this->noises.find(GPU_RAY_NOISE);
+  if (noiseIter != this->noises.end())
+    noise = noiseIter->second;
+  this->dataPtr->noiseRanges.clear();
+  this->dataPtr->noiseIndices.clear();
+
   auto dataIter = this->dataPtr->laserCam->LaserDataBegin();
   auto dataEnd = this->dataPtr->laserCam->LaserDataEnd();
   for (int i = 0; dataIter != dataEnd; ++dataIter, ++i)
@@ -656,11 +707,10 @@ bool GpuRaySensor::UpdateImpl(const bool /*_force*/)
     {
       range = -ignition::math::INF_D;
     }
-    else if (this->noises.find(GPU_RAY_NOISE) != this->noises.end())
+    else if (noise && !ignition::math::isnan(range))
     {
-      range = this->noises[GPU_RAY_NOISE]->Apply(range);
-      range = ignition::math::clamp(range,
-          this->dataPtr->rangeMin, this->dataPtr->rangeMax);
+      this->dataPtr->noiseIndices.push_back(i);
+      this->dataPtr->noiseRanges.push_back(range);
     }
 
     range = ignition::math::isnan(range) ? this->dataPtr->rangeMax : range;
@@ -668,6 +718,18 @@ bool GpuRaySensor::UpdateImpl(const bool /*_force*/)
     scan->set_intensities(i, intensity);
   }
 
+  if (!this->dataPtr->noiseRanges.empty())
+  {
+    noise->Apply(this->dataPtr->noiseRanges.data(),
+        this->dataPtr->noiseRanges.size());
+    for (size_t k = 0; k < this->dataPtr->noiseRanges.size(); ++k)
+    {
+      scan->set_ranges(this->dataPtr->noiseIndices[k],
+          ignition::math::clamp(this->dataPtr->noiseRanges[k],
+            this->dataPtr->rangeMin, this->dataPtr->rangeMax));
+    }
+  }
+
   if (this->dataPtr->scanPub && this->dataPtr->scanPub->HasConnections())
     this->dataPtr->scanPub->Publish(this->dataPtr->laserMsg);
 
@@ -683,6 +745,13 @@ bool GpuRaySensor::IsActive() const
     (this->dataPtr->scanPub && this->dataPtr->scanPub->HasConnections());
 }
 
+//////////////////////////////////////////////////
+bool GpuRaySensor::HasConsumers() const
+{
+  return this->HasLocalConsumers() ||
+    (this->dataPtr->scanPub && this->dataPtr->scanPub->HasConnections());
+}
+
 //////////////////////////////////////////////////
 rendering::GpuLaserPtr GpuRaySensor::LaserCamera() const
 {
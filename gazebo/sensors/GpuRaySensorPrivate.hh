@@ -18,6 +18,7 @@
 #define _GAZEBO_SENSORS_GPURAYENSOR_PRIVATE_HH_
 
 #include <mutex>
+#include <vector>
 #include <sdf/sdf.hh>
 
 #include "gazebo/rendering/RenderTypes.hh"
@@ -86,6 +87,16 @@ namespace gazebo
 
       /// \brief True if the sensor was rendered.
       public: bool rendered;
+
+      /// \brief Camera::ImageCount at the last update, used to skip the
+      /// frames an asynchronous readback didn't deliver.
+      public: uint64_t imageCount = 0;
+
+      /// \brief Ranges to apply noise to, gathered for one batch.
+      public: std::vector<double> noiseRanges;
+
+      /// \brief Index in the scan of each range in noiseRanges.
+      public: std::vector<int> noiseIndices;
     };
   }
 }
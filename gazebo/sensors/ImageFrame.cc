@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <mutex>
+
+#include "gazebo/sensors/ImageFrame.hh"
+
+using namespace gazebo;
+using namespace sensors;
+
+namespace gazebo
+{
+  namespace sensors
+  {
+    /// \internal
+    /// \brief Private data for the ImageFramePool class
+    class ImageFramePoolPrivate
+    {
+      /// \brief Take back a released frame, or delete it if the pool is
+      /// full.
+      /// \param[in] _frame The released frame.
+      public: void Release(ImageFrame *_frame)
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (this->free.size() < this->maxFree)
+          this->free.emplace_back(_frame);
+        else
+          delete _frame;
+      }
+
+      /// \brief Released frames waiting to be reused.
+      public: std::vector<std::unique_ptr<ImageFrame>> free;
+
+      /// \brief Maximum number of free frames.
+      public: unsigned int maxFree = 0;
+
+      /// \brief Protects the free frames, which are released from the
+      /// consumers' threads.
+      public: mutable std::mutex mutex;
+    };
+  }
+}
+
+//////////////////////////////////////////////////
+size_t ImageFrame::Size() const
+{
+  return this->data.size();
+}
+
+//////////////////////////////////////////////////
+ImageFramePool::ImageFramePool(const unsigned int _maxFree)
+  : dataPtr(std::make_shared<ImageFramePoolPrivate>())
+{
+  this->dataPtr->maxFree = _maxFree;
+}
+
+//////////////////////////////////////////////////
+ImageFramePool::~ImageFramePool()
+{
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<ImageFrame> ImageFramePool::Acquire()
+{
+  ImageFrame *frame = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    if (!this->dataPtr->free.empty())
+    {
+      frame = this->dataPtr->free.back().release();
+      this->dataPtr->free.pop_back();
+    }
+  }
+
+  if (!frame)
+    frame = new ImageFrame;
+
+  std::weak_ptr<ImageFramePoolPrivate> pool = this->dataPtr;
+  return std::shared_ptr<ImageFrame>(frame, [pool](ImageFrame *_frame)
+      {
+        auto owner = pool.lock();
+        if (owner)
+          owner->Release(_frame);
+        else
+          delete _frame;
+      });
+}
+
+//////////////////////////////////////////////////
+unsigned int ImageFramePool::FreeCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return static_cast<unsigned int>(this->dataPtr->free.size());
+}
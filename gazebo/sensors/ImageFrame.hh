@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_SENSORS_IMAGEFRAME_HH_
+#define GAZEBO_SENSORS_IMAGEFRAME_HH_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace sensors
+  {
+    // Forward declare private data class.
+    class ImageFramePoolPrivate;
+
+    /// \addtogroup gazebo_sensors
+    /// \{
+
+    /// \class ImageFrame ImageFrame.hh sensors/sensors.hh
+    /// \brief An image produced by a sensor, shared by reference with the
+    /// in-process consumers of the sensor. A frame must not be modified
+    /// once it has been handed out.
+    class GZ_SENSORS_VISIBLE ImageFrame
+    {
+      /// \brief Get the size of the image data.
+      /// \return Size in bytes.
+      public: size_t Size() const;
+
+      /// \brief Pixel data, row by row without padding.
+      public: std::vector<unsigned char> data;
+
+      /// \brief Width in pixels.
+      public: unsigned int width = 0;
+
+      /// \brief Height in pixels.
+      public: unsigned int height = 0;
+
+      /// \brief Number of bytes per pixel.
+      public: unsigned int depth = 0;
+
+      /// \brief Pixel format, as returned by rendering::Camera::ImageFormat.
+      public: std::string format;
+
+      /// \brief Simulation time at which the image was rendered.
+      public: common::Time simTime;
+    };
+
+    /// \def ImageFramePtr
+    /// \brief Shared pointer to a read-only ImageFrame.
+    typedef std::shared_ptr<const ImageFrame> ImageFramePtr;
+
+    /// \class ImageFramePool ImageFrame.hh sensors/sensors.hh
+    /// \brief Pool of image frames. A frame acquired from the pool goes
+    /// back to it when the last reference to it is released, so its data
+    /// is reused without being allocated again. Frames may outlive the
+    /// pool, in which case they are simply deleted.
+    class GZ_SENSORS_VISIBLE ImageFramePool
+    {
+      /// \brief Constructor.
+      /// \param[in] _maxFree Maximum number of released frames kept for
+      /// reuse.
+      public: explicit ImageFramePool(const unsigned int _maxFree = 4);
+
+      /// \brief Destructor.
+      public: virtual ~ImageFramePool();
+
+      /// \brief Get a frame, reusing a released one if possible. The data
+      /// of a reused frame holds the bytes of its previous image.
+      /// \return A frame that only the caller references.
+      public: std::shared_ptr<ImageFrame> Acquire();
+
+      /// \brief Get the number of released frames waiting to be reused.
+      /// \return Number of free frames.
+      public: unsigned int FreeCount() const;
+
+      /// \internal
+      /// \brief Private data pointer. Shared with the frames handed out,
+      /// which only hold a weak reference to it.
+      private: std::shared_ptr<ImageFramePoolPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
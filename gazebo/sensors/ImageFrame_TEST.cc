@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include "gazebo/sensors/ImageFrame.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class ImageFrameTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(ImageFrameTest, Pool)
+{
+  sensors::ImageFramePool pool(1);
+  EXPECT_EQ(pool.FreeCount(), 0u);
+
+  auto frame = pool.Acquire();
+  ASSERT_TRUE(frame != nullptr);
+  frame->data.resize(64, 7);
+  frame->width = 4;
+  frame->height = 4;
+  frame->depth = 4;
+  EXPECT_EQ(frame->Size(), 64u);
+  const unsigned char *data = frame->data.data();
+
+  // Consumers share the frame, it goes back to the pool with the last
+  // reference
+  sensors::ImageFramePtr shared = frame;
+  frame.reset();
+  EXPECT_EQ(pool.FreeCount(), 0u);
+  shared.reset();
+  EXPECT_EQ(pool.FreeCount(), 1u);
+
+  // The released frame is reused with its data
+  frame = pool.Acquire();
+  EXPECT_EQ(pool.FreeCount(), 0u);
+  EXPECT_EQ(frame->data.data(), data);
+  EXPECT_EQ(frame->Size(), 64u);
+
+  // The pool only keeps one free frame
+  auto other = pool.Acquire();
+  EXPECT_NE(other, frame);
+  frame.reset();
+  other.reset();
+  EXPECT_EQ(pool.FreeCount(), 1u);
+}
+
+/////////////////////////////////////////////////
+TEST_F(ImageFrameTest, OutlivePool)
+{
+  sensors::ImageFramePtr frame;
+  {
+    sensors::ImageFramePool pool;
+    frame = pool.Acquire();
+  }
+  ASSERT_TRUE(frame != nullptr);
+  EXPECT_EQ(frame->Size(), 0u);
+  frame.reset();
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -39,10 +39,6 @@ ImuSensor::ImuSensor()
 : Sensor(sensors::OTHER),
   dataPtr(new ImuSensorPrivate)
 {
-  this->dataPtr->dataIndex = 0;
-  this->dataPtr->dataDirty = false;
-  this->dataPtr->incomingLinkData[0].reset();
-  this->dataPtr->incomingLinkData[1].reset();
 }
 
 //////////////////////////////////////////////////
@@ -183,12 +179,15 @@ void ImuSensor::Load(const std::string &_worldName, sdf::ElementPtr _sdf)
     gzlog << out.str();
   }
 
-  // Start publishing measurements on the topic.
-  this->dataPtr->parentEntity->SetPublishData(true);
+  // Read the parent entity state from the world's link state batch,
+  // which gathers it once per step.
+  this->dataPtr->linkStates = LinkStateBatch::Acquire(this->world);
+  this->dataPtr->linkSlot =
+    this->dataPtr->linkStates->Add(this->dataPtr->parentEntity);
 
-  std::string topic = "~/" + this->dataPtr->parentEntity->GetScopedName();
-  this->dataPtr->linkDataSub = this->node->Subscribe(topic,
-    &ImuSensor::OnLinkData, this);
+  LinkState state;
+  if (this->dataPtr->linkStates->Read(this->dataPtr->linkSlot, state))
+    this->dataPtr->lastIterations = state.iterations;
 }
 
 //////////////////////////////////////////////////
@@ -225,18 +224,14 @@ void ImuSensor::Init()
 void ImuSensor::Fini()
 {
   // Clean transport
-  {
-    this->dataPtr->pub.reset();
-    this->dataPtr->linkDataSub.reset();
-  }
+  this->dataPtr->pub.reset();
 
-  if (this->dataPtr->parentEntity)
-    this->dataPtr->parentEntity->SetPublishData(false);
+  if (this->dataPtr->linkStates)
+    this->dataPtr->linkStates->Remove(this->dataPtr->linkSlot);
+  this->dataPtr->linkStates.reset();
+  this->dataPtr->linkSlot = -1;
   this->dataPtr->parentEntity.reset();
 
-  this->dataPtr->incomingLinkData[0].reset();
-  this->dataPtr->incomingLinkData[1].reset();
-
   Sensor::Fini();
 }
 
@@ -247,15 +242,6 @@ msgs::IMU ImuSensor::ImuMessage() const
   return this->dataPtr->imuMsg;
 }
 
-//////////////////////////////////////////////////
-void ImuSensor::OnLinkData(ConstLinkDataPtr &_msg)
-{
-  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
-  // Store the contacts message for processing in UpdateImpl
-  this->dataPtr->incomingLinkData[this->dataPtr->dataIndex] = _msg;
-  this->dataPtr->dataDirty = true;
-}
-
 //////////////////////////////////////////////////
 ignition::math::Vector3d ImuSensor::AngularVelocity(const bool _noiseFree) const
 {
@@ -300,25 +286,24 @@ void ImuSensor::SetWorldToReferenceOrientation(
 //////////////////////////////////////////////////
 bool ImuSensor::UpdateImpl(const bool /*_force*/)
 {
-  msgs::LinkData msg;
-  int readIndex = 0;
+  LinkState state;
 
   {
     std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
-    // Don't do anything if there is no new data to process.
-    if (!this->dataPtr->dataDirty)
+    // Don't do anything if the world has not stepped since the last
+    // measurement.
+    if (!this->dataPtr->linkStates ||
+        !this->dataPtr->linkStates->Read(this->dataPtr->linkSlot, state) ||
+        state.iterations == this->dataPtr->lastIterations)
+    {
       return false;
+    }
 
-    readIndex = this->dataPtr->dataIndex;
-    this->dataPtr->dataIndex ^= 1;
-    this->dataPtr->dataDirty = false;
+    this->dataPtr->lastIterations = state.iterations;
   }
 
-  // toggle the index
-  msg.CopyFrom(*this->dataPtr->incomingLinkData[readIndex].get());
-
-  common::Time timestamp = msgs::Convert(msg.time());
+  common::Time timestamp = state.time;
 
   double dt = (timestamp - this->lastMeasurementTime).Double();
 
@@ -334,13 +319,11 @@ bool ImuSensor::UpdateImpl(const bool /*_force*/)
 
     msgs::Set(this->dataPtr->imuMsg.mutable_stamp(), timestamp);
 
-    ignition::math::Pose3d parentEntityPose =
-      this->dataPtr->parentEntity->WorldPose();
+    ignition::math::Pose3d parentEntityPose = state.pose;
     ignition::math::Pose3d imuWorldPose = this->pose + parentEntityPose;
 
     // Get the angular velocity
-    ignition::math::Vector3d linkWorldAngularVel = msgs::ConvertIgn(
-        msg.angular_velocity());
+    ignition::math::Vector3d linkWorldAngularVel = state.angularVel;
 
     /////////////////////////////////////////////////////////////////////
     // Set the IMU angular velocity (defined in imu's local frame)
@@ -354,8 +337,7 @@ bool ImuSensor::UpdateImpl(const bool /*_force*/)
     // Compute and set the IMU linear acceleration in the imu local frame
     /////////////////////////////////////////////////////////////////////
     // first get imu link's linear velocity in world frame
-    ignition::math::Vector3d linkWorldLinearVel
-        = msgs::ConvertIgn(msg.linear_velocity());
+    ignition::math::Vector3d linkWorldLinearVel = state.linearVel;
     // next, account for vel in world frame of the imu
     // given the imu frame is offset from link frame, and link is rotating
     // compute the velocity of the imu axis origin in world frame
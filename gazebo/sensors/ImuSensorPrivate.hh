@@ -17,12 +17,13 @@
 #ifndef GAZEBO_SENSORS_IMUSENSOR_PRIVATE_HH_
 #define GAZEBO_SENSORS_IMUSENSOR_PRIVATE_HH_
 
-#include <array>
+#include <cstdint>
 #include <mutex>
 #include <ignition/math/Vector3.hh>
 #include <ignition/math/Pose3.hh>
 
 #include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/sensors/LinkStateBatch.hh"
 #include "gazebo/transport/TransportTypes.hh"
 
 namespace gazebo
@@ -50,8 +51,11 @@ namespace gazebo
       /// \brief Imu data publisher
       public: transport::PublisherPtr pub;
 
-      /// \brief Subscriber to link data published by parent entity
-      public: transport::SubscriberPtr linkDataSub;
+      /// \brief Link states of the world, holding the parent entity.
+      public: LinkStateBatchPtr linkStates;
+
+      /// \brief Slot of the parent entity in linkStates.
+      public: int linkSlot = -1;
 
       /// \brief Parent entity which the IMU is attached to
       public: physics::LinkPtr parentEntity;
@@ -62,15 +66,9 @@ namespace gazebo
       /// \brief Mutex to protect reads and writes.
       public: mutable std::mutex mutex;
 
-      /// \brief Buffer for storing link data
-      public: std::array<boost::shared_ptr<msgs::LinkData const>, 2>
-              incomingLinkData;
-
-      /// \brief Index for accessing element in the link data array
-      public: unsigned int dataIndex;
-
-      /// \brief True if new link data is received
-      public: bool dataDirty;
+      /// \brief World iteration of the last link state processed. A new
+      /// measurement is only made once the world has stepped.
+      public: uint64_t lastIterations = 0;
 
       /// \brief Noise free angular velocity.
       public: ignition::math::Vector3d angularVel;
@@ -0,0 +1,284 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <array>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gazebo/common/Events.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/sensors/LinkStateBatch.hh"
+
+using namespace gazebo;
+using namespace sensors;
+
+namespace
+{
+  /// \brief Components stored for each link.
+  enum LinkStateField
+  {
+    POS_X, POS_Y, POS_Z,
+    ROT_W, ROT_X, ROT_Y, ROT_Z,
+    LIN_VEL_X, LIN_VEL_Y, LIN_VEL_Z,
+    ANG_VEL_X, ANG_VEL_Y, ANG_VEL_Z,
+    FIELD_COUNT
+  };
+
+  /// \brief Batches of the worlds, by world name.
+  std::map<std::string, std::weak_ptr<LinkStateBatch>> g_batches;
+
+  /// \brief Protects g_batches.
+  std::mutex g_batchesMutex;
+}
+
+namespace gazebo
+{
+  namespace sensors
+  {
+    /// \internal
+    /// \brief Private data for the LinkStateBatch class
+    class LinkStateBatchPrivate
+    {
+      /// \brief Copy the state of a link into its slot.
+      /// \param[in] _slot The slot.
+      /// \return False if the link was deleted.
+      public: bool Store(const unsigned int _slot)
+      {
+        physics::LinkPtr link = this->links[_slot].lock();
+        if (!link)
+          return false;
+
+        ignition::math::Pose3d pose = link->WorldPose();
+        ignition::math::Vector3d linVel = link->WorldLinearVel();
+        ignition::math::Vector3d angVel = link->WorldAngularVel();
+
+        this->fields[POS_X][_slot] = pose.Pos().X();
+        this->fields[POS_Y][_slot] = pose.Pos().Y();
+        this->fields[POS_Z][_slot] = pose.Pos().Z();
+        this->fields[ROT_W][_slot] = pose.Rot().W();
+        this->fields[ROT_X][_slot] = pose.Rot().X();
+        this->fields[ROT_Y][_slot] = pose.Rot().Y();
+        this->fields[ROT_Z][_slot] = pose.Rot().Z();
+        this->fields[LIN_VEL_X][_slot] = linVel.X();
+        this->fields[LIN_VEL_Y][_slot] = linVel.Y();
+        this->fields[LIN_VEL_Z][_slot] = linVel.Z();
+        this->fields[ANG_VEL_X][_slot] = angVel.X();
+        this->fields[ANG_VEL_Y][_slot] = angVel.Y();
+        this->fields[ANG_VEL_Z][_slot] = angVel.Z();
+        return true;
+      }
+
+      /// \brief World the links belong to.
+      public: physics::WorldPtr world;
+
+      /// \brief Links by slot. Free slots hold an empty pointer.
+      public: std::vector<boost::weak_ptr<physics::Link>> links;
+
+      /// \brief Number of times each slot was added.
+      public: std::vector<unsigned int> refs;
+
+      /// \brief Slots by link id.
+      public: std::unordered_map<uint32_t, unsigned int> slots;
+
+      /// \brief State of the links, one array per component, indexed by
+      /// slot.
+      public: std::array<std::vector<double>, FIELD_COUNT> fields;
+
+      /// \brief Time of the last gather.
+      public: common::Time time;
+
+      /// \brief World iteration of the last gather.
+      public: uint64_t iterations = 0;
+
+      /// \brief True once a gather was done.
+      public: bool gathered = false;
+
+      /// \brief Connection to the world update end event.
+      public: event::ConnectionPtr updateConnection;
+
+      /// \brief Protects the slots and the state.
+      public: mutable std::mutex mutex;
+    };
+  }
+}
+
+//////////////////////////////////////////////////
+LinkStateBatch::LinkStateBatch(physics::WorldPtr _world)
+  : dataPtr(new LinkStateBatchPrivate)
+{
+  this->dataPtr->world = _world;
+  this->dataPtr->updateConnection = event::Events::ConnectWorldUpdateEnd(
+      std::bind(&LinkStateBatch::Gather, this));
+}
+
+//////////////////////////////////////////////////
+LinkStateBatch::~LinkStateBatch()
+{
+  this->dataPtr->updateConnection.reset();
+}
+
+//////////////////////////////////////////////////
+LinkStateBatchPtr LinkStateBatch::Acquire(physics::WorldPtr _world)
+{
+  if (!_world)
+    return LinkStateBatchPtr();
+
+  std::lock_guard<std::mutex> lock(g_batchesMutex);
+  std::weak_ptr<LinkStateBatch> &weak = g_batches[_world->Name()];
+  LinkStateBatchPtr batch = weak.lock();
+  if (!batch || batch->dataPtr->world != _world)
+  {
+    batch.reset(new LinkStateBatch(_world));
+    weak = batch;
+  }
+  return batch;
+}
+
+//////////////////////////////////////////////////
+int LinkStateBatch::Add(physics::LinkPtr _link)
+{
+  if (!_link)
+    return -1;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  auto iter = this->dataPtr->slots.find(_link->GetId());
+  if (iter != this->dataPtr->slots.end())
+  {
+    this->dataPtr->refs[iter->second]++;
+    return static_cast<int>(iter->second);
+  }
+
+  // Reuse a free slot, or grow the arrays
+  unsigned int slot = 0;
+  while (slot < this->dataPtr->refs.size() && this->dataPtr->refs[slot] > 0)
+    ++slot;
+
+  if (slot == this->dataPtr->refs.size())
+  {
+    this->dataPtr->links.emplace_back();
+    this->dataPtr->refs.push_back(0);
+    for (auto &field : this->dataPtr->fields)
+      field.push_back(0.0);
+  }
+
+  this->dataPtr->links[slot] = _link;
+  this->dataPtr->refs[slot] = 1;
+  this->dataPtr->slots[_link->GetId()] = slot;
+
+  if (!this->dataPtr->gathered)
+  {
+    this->dataPtr->time = this->dataPtr->world->SimTime();
+    this->dataPtr->iterations = this->dataPtr->world->Iterations();
+    this->dataPtr->gathered = true;
+  }
+  this->dataPtr->Store(slot);
+
+  return static_cast<int>(slot);
+}
+
+//////////////////////////////////////////////////
+void LinkStateBatch::Remove(const int _slot)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  if (_slot < 0 || _slot >= static_cast<int>(this->dataPtr->refs.size()) ||
+      this->dataPtr->refs[_slot] == 0)
+  {
+    return;
+  }
+
+  if (--this->dataPtr->refs[_slot] > 0)
+    return;
+
+  for (auto iter = this->dataPtr->slots.begin();
+       iter != this->dataPtr->slots.end(); ++iter)
+  {
+    if (iter->second == static_cast<unsigned int>(_slot))
+    {
+      this->dataPtr->slots.erase(iter);
+      break;
+    }
+  }
+  this->dataPtr->links[_slot].reset();
+}
+
+//////////////////////////////////////////////////
+bool LinkStateBatch::Read(const int _slot, LinkState &_state)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  if (_slot < 0 || _slot >= static_cast<int>(this->dataPtr->refs.size()) ||
+      this->dataPtr->refs[_slot] == 0)
+  {
+    return false;
+  }
+
+  // No gather happens while paused, and the link may have been moved
+  if (this->dataPtr->world->IsPaused() && !this->dataPtr->Store(_slot))
+    return false;
+
+  if (this->dataPtr->links[_slot].expired())
+    return false;
+
+  const auto &f = this->dataPtr->fields;
+  _state.time = this->dataPtr->time;
+  _state.iterations = this->dataPtr->iterations;
+  _state.pose.Set(
+      ignition::math::Vector3d(
+        f[POS_X][_slot], f[POS_Y][_slot], f[POS_Z][_slot]),
+      ignition::math::Quaterniond(
+        f[ROT_W][_slot], f[ROT_X][_slot], f[ROT_Y][_slot], f[ROT_Z][_slot]));
+  _state.linearVel.Set(
+      f[LIN_VEL_X][_slot], f[LIN_VEL_Y][_slot], f[LIN_VEL_Z][_slot]);
+  _state.angularVel.Set(
+      f[ANG_VEL_X][_slot], f[ANG_VEL_Y][_slot], f[ANG_VEL_Z][_slot]);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void LinkStateBatch::Gather()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  // The update end event is shared by all worlds
+  uint64_t iterations = this->dataPtr->world->Iterations();
+  if (this->dataPtr->gathered && iterations == this->dataPtr->iterations)
+    return;
+
+  this->dataPtr->time = this->dataPtr->world->SimTime();
+  this->dataPtr->iterations = iterations;
+  this->dataPtr->gathered = true;
+
+  for (unsigned int slot = 0; slot < this->dataPtr->refs.size(); ++slot)
+  {
+    if (this->dataPtr->refs[slot] > 0)
+      this->dataPtr->Store(slot);
+  }
+}
+
+//////////////////////////////////////////////////
+unsigned int LinkStateBatch::LinkCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->slots.size();
+}
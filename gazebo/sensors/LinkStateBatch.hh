@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_SENSORS_LINKSTATEBATCH_HH_
+#define GAZEBO_SENSORS_LINKSTATEBATCH_HH_
+
+#include <cstdint>
+#include <memory>
+
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace sensors
+  {
+    // Forward declare private data class.
+    class LinkStateBatchPrivate;
+
+    /// \internal
+    /// \brief Kinematic state of a link, as gathered by a LinkStateBatch.
+    class GZ_SENSORS_VISIBLE LinkState
+    {
+      /// \brief Simulation time the state was gathered at.
+      public: common::Time time;
+
+      /// \brief World iteration the state was gathered at.
+      public: uint64_t iterations = 0;
+
+      /// \brief World pose of the link.
+      public: ignition::math::Pose3d pose;
+
+      /// \brief World linear velocity of the link origin.
+      public: ignition::math::Vector3d linearVel;
+
+      /// \brief World angular velocity of the link.
+      public: ignition::math::Vector3d angularVel;
+    };
+
+    /// \internal
+    /// \class LinkStateBatch LinkStateBatch.hh
+    /// \brief Gathers the pose and velocity of the links that kinematic
+    /// sensors are attached to, once per world step, into contiguous
+    /// arrays. Sensors sharing a link share its slot, so the link is only
+    /// queried once per step however many sensors read it.
+    /// There is one batch per world, shared through Acquire.
+    class GZ_SENSORS_VISIBLE LinkStateBatch
+    {
+      /// \brief Constructor. Use Acquire to get the batch of a world.
+      /// \param[in] _world World the links belong to.
+      public: explicit LinkStateBatch(physics::WorldPtr _world);
+
+      /// \brief Destructor.
+      public: virtual ~LinkStateBatch();
+
+      /// \brief Get the batch of a world, creating it if no sensor holds
+      /// it.
+      /// \param[in] _world The world.
+      /// \return The batch, or nullptr if _world is null.
+      public: static std::shared_ptr<LinkStateBatch> Acquire(
+                  physics::WorldPtr _world);
+
+      /// \brief Add a link to the batch. Its state is gathered right away.
+      /// \param[in] _link The link.
+      /// \return Slot of the link, or -1 if _link is null. Adding a link
+      /// twice returns the same slot.
+      public: int Add(physics::LinkPtr _link);
+
+      /// \brief Release a slot returned by Add. The slot is freed once it
+      /// was released as many times as it was added.
+      /// \param[in] _slot The slot.
+      public: void Remove(const int _slot);
+
+      /// \brief Get the latest state of a link. While the world is paused
+      /// the state is read from the link, so that poses set by hand are
+      /// seen.
+      /// \param[in] _slot Slot of the link.
+      /// \param[out] _state The state.
+      /// \return False if the slot is invalid or its link was deleted.
+      public: bool Read(const int _slot, LinkState &_state);
+
+      /// \brief Gather the state of every link, unless it was already
+      /// gathered for the current world iteration.
+      public: void Gather();
+
+      /// \brief Get the number of links in the batch.
+      /// \return Number of used slots.
+      public: unsigned int LinkCount() const;
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<LinkStateBatchPrivate> dataPtr;
+    };
+
+    /// \def LinkStateBatchPtr
+    /// \brief Shared pointer to LinkStateBatch
+    typedef std::shared_ptr<LinkStateBatch> LinkStateBatchPtr;
+  }
+}
+#endif
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include "gazebo/physics/physics.hh"
+#include "gazebo/sensors/LinkStateBatch.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+class LinkStateBatch_TEST : public ServerFixture
+{
+};
+
+/////////////////////////////////////////////////
+TEST_F(LinkStateBatch_TEST, Slots)
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(1, 2, 3));
+  physics::ModelPtr model = world->ModelByName("box");
+  ASSERT_TRUE(model != nullptr);
+  physics::LinkPtr link = model->GetLink();
+  ASSERT_TRUE(link != nullptr);
+
+  sensors::LinkStateBatchPtr batch = sensors::LinkStateBatch::Acquire(world);
+  ASSERT_TRUE(batch != nullptr);
+  EXPECT_EQ(batch, sensors::LinkStateBatch::Acquire(world));
+  EXPECT_TRUE(sensors::LinkStateBatch::Acquire(physics::WorldPtr()) ==
+      nullptr);
+
+  EXPECT_EQ(batch->Add(physics::LinkPtr()), -1);
+  int slot = batch->Add(link);
+  EXPECT_GE(slot, 0);
+  EXPECT_EQ(batch->Add(link), slot);
+  EXPECT_EQ(batch->LinkCount(), 1u);
+
+  // The state is available before the world steps
+  sensors::LinkState state;
+  EXPECT_TRUE(batch->Read(slot, state));
+  EXPECT_EQ(state.pose, link->WorldPose());
+  EXPECT_FALSE(batch->Read(slot + 1, state));
+
+  // The slot is kept until it is removed as many times as it was added
+  batch->Remove(slot);
+  EXPECT_TRUE(batch->Read(slot, state));
+  batch->Remove(slot);
+  EXPECT_FALSE(batch->Read(slot, state));
+  EXPECT_EQ(batch->LinkCount(), 0u);
+
+  // Free slots are reused
+  EXPECT_EQ(batch->Add(link), slot);
+}
+
+/////////////////////////////////////////////////
+TEST_F(LinkStateBatch_TEST, Gather)
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 10));
+  physics::ModelPtr model = world->ModelByName("box");
+  ASSERT_TRUE(model != nullptr);
+  physics::LinkPtr link = model->GetLink();
+  ASSERT_TRUE(link != nullptr);
+
+  sensors::LinkStateBatchPtr batch = sensors::LinkStateBatch::Acquire(world);
+  int slot = batch->Add(link);
+
+  sensors::LinkState before;
+  ASSERT_TRUE(batch->Read(slot, before));
+
+  // The box falls, and the batch follows it
+  world->Step(10);
+
+  sensors::LinkState after;
+  ASSERT_TRUE(batch->Read(slot, after));
+  EXPECT_EQ(after.iterations, before.iterations + 10);
+  EXPECT_EQ(after.time, world->SimTime());
+  EXPECT_LT(after.pose.Pos().Z(), before.pose.Pos().Z());
+  EXPECT_LT(after.linearVel.Z(), 0.0);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
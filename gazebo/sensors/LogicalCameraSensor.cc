@@ -14,6 +14,7 @@
  * limitations under the License.
  *
 */
+#include <cmath>
 #include <boost/algorithm/string.hpp>
 #include "gazebo/transport/transport.hh"
 #include "gazebo/msgs/msgs.hh"
@@ -109,6 +110,35 @@ void LogicalCameraSensor::Fini()
   Sensor::Fini();
 }
 
+//////////////////////////////////////////////////
+ignition::math::AxisAlignedBox LogicalCameraSensorPrivate::FrustumBox() const
+{
+  const ignition::math::Pose3d &pose = this->frustum.Pose();
+  const double tanHalfFov = std::tan(this->frustum.FOV().Radian() * 0.5);
+
+  ignition::math::AxisAlignedBox box;
+  bool first = true;
+  for (auto const dist : {this->frustum.Near(), this->frustum.Far()})
+  {
+    const double halfWidth = dist * tanHalfFov;
+    const double halfHeight = halfWidth / this->frustum.AspectRatio();
+    for (auto const y : {-halfWidth, halfWidth})
+    {
+      for (auto const z : {-halfHeight, halfHeight})
+      {
+        ignition::math::Vector3d corner = pose.Pos() +
+          pose.Rot().RotateVector(ignition::math::Vector3d(dist, y, z));
+        if (first)
+          box = ignition::math::AxisAlignedBox(corner, corner);
+        else
+          box += ignition::math::AxisAlignedBox(corner, corner);
+        first = false;
+      }
+    }
+  }
+  return box;
+}
+
 //////////////////////////////////////////////////
 void LogicalCameraSensorPrivate::AddVisibleModels(
     ignition::math::Pose3d &_myPose, const physics::Model_V &_models)
@@ -128,11 +158,6 @@ void LogicalCameraSensorPrivate::AddVisibleModels(
       msgs::Set(modelMsg->mutable_pose(),
           model->WorldPose() - _myPose);
     }
-    // Check nested models
-    // Note, the model AABB does not necessarily contain the nested model
-    // so nested models must be searched even if the frustum does not contain
-    // the parent model.
-    AddVisibleModels(_myPose, model->NestedModels());
   }
 }
 
@@ -155,8 +180,9 @@ bool LogicalCameraSensor::UpdateImpl(const bool _force)
     // Set the camera's pose in the message.
     msgs::Set(this->dataPtr->msg.mutable_pose(), myPose);
 
-    // Recursively check if models and nested models are in the frustum.
-    this->dataPtr->AddVisibleModels(myPose, this->world->Models());
+    // Only test the models, nested ones included, near the frustum
+    this->dataPtr->AddVisibleModels(myPose,
+        this->world->ModelsInBox(this->dataPtr->FrustumBox()));
 
     // Send the message.
     this->dataPtr->pub->Publish(this->dataPtr->msg);
@@ -172,6 +198,13 @@ bool LogicalCameraSensor::IsActive() const
     (this->dataPtr->pub && this->dataPtr->pub->HasConnections());
 }
 
+//////////////////////////////////////////////////
+bool LogicalCameraSensor::HasConsumers() const
+{
+  return this->HasLocalConsumers() ||
+    (this->dataPtr->pub && this->dataPtr->pub->HasConnections());
+}
+
 //////////////////////////////////////////////////
 double LogicalCameraSensor::Near() const
 {
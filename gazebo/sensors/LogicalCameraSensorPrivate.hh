@@ -19,6 +19,7 @@
 
 #include <mutex>
 #include <string>
+#include <ignition/math/AxisAlignedBox.hh>
 #include <ignition/math/Frustum.hh>
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/msgs/msgs.hh"
@@ -32,9 +33,14 @@ namespace gazebo
     /// \brief Logical camera sensor private data.
     class LogicalCameraSensorPrivate
     {
+      /// \brief Get the world aligned box holding the frustum.
+      /// \return The box, in the world frame.
+      public: ignition::math::AxisAlignedBox FrustumBox() const;
+
       /// \brief Add models that are visible to the camera to a vector of models
       /// \param[in] _myPose pose of the logical camera
-      /// \param[in] _models list of models to test against frustum
+      /// \param[in] _models list of models to test against frustum, nested
+      /// models are not searched
       public: void AddVisibleModels(ignition::math::Pose3d &_myPose,
         const physics::Model_V &_models);
 
@@ -71,6 +71,14 @@ void MagnetometerSensor::Load(const std::string &_worldName)
   this->dataPtr->parentLink =
     boost::dynamic_pointer_cast<physics::Link>(parentEntity);
 
+  // The parent link state is gathered once per step for all sensors
+  if (this->dataPtr->parentLink)
+  {
+    this->dataPtr->linkStates = LinkStateBatch::Acquire(this->world);
+    this->dataPtr->linkSlot =
+      this->dataPtr->linkStates->Add(this->dataPtr->parentLink);
+  }
+
   this->dataPtr->magPub = this->node->Advertise<msgs::Magnetometer>(
       this->GetTopic(), 50);
 
@@ -115,6 +123,10 @@ void MagnetometerSensor::Load(const std::string &_worldName)
 void MagnetometerSensor::Fini()
 {
   Sensor::Fini();
+  if (this->dataPtr->linkStates)
+    this->dataPtr->linkStates->Remove(this->dataPtr->linkSlot);
+  this->dataPtr->linkStates.reset();
+  this->dataPtr->linkSlot = -1;
   this->dataPtr->parentLink.reset();
 }
 
@@ -130,11 +142,13 @@ bool MagnetometerSensor::UpdateImpl(const bool /*_force*/)
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
   // Get latest pose information
-  if (this->dataPtr->parentLink)
+  LinkState state;
+  if (this->dataPtr->linkStates &&
+      this->dataPtr->linkStates->Read(this->dataPtr->linkSlot, state))
   {
     // Get pose in gazebo reference frame
     ignition::math::Pose3d magPose =
-      this->pose + this->dataPtr->parentLink->WorldPose();
+      this->pose + state.pose;
 
     // Get the reference magnetic field
     ignition::math::Vector3d field =
@@ -258,6 +258,23 @@ bool MultiCameraSensor::UpdateImpl(const bool /*_force*/)
 
   bool publish = this->dataPtr->imagePub->HasConnections();
 
+  for (auto &camera : this->dataPtr->cameras)
+    camera->PostRender();
+
+  // With asynchronous readback, the images are the ones of the previous
+  // render, and there are none the first time.
+  const rendering::CameraPtr &first = this->dataPtr->cameras.front();
+  if (first->ReadbackLatency() > 0)
+  {
+    if (first->ImageCount() == this->dataPtr->imageCount)
+    {
+      this->dataPtr->rendered = false;
+      return false;
+    }
+    this->lastMeasurementTime = first->ImageSimTime();
+  }
+  this->dataPtr->imageCount = first->ImageCount();
+
   msgs::Set(this->dataPtr->msg.mutable_time(),
             this->lastMeasurementTime);
 
@@ -265,8 +282,6 @@ bool MultiCameraSensor::UpdateImpl(const bool /*_force*/)
   for (auto iter = this->dataPtr->cameras.begin();
        iter != this->dataPtr->cameras.end(); ++iter, ++index)
   {
-    (*iter)->PostRender();
-
     if (publish)
     {
       msgs::Image *image = this->dataPtr->msg.mutable_image(index);
@@ -338,3 +353,10 @@ bool MultiCameraSensor::IsActive() const
   return Sensor::IsActive() ||
     (this->dataPtr->imagePub && this->dataPtr->imagePub->HasConnections());
 }
+
+//////////////////////////////////////////////////
+bool MultiCameraSensor::HasConsumers() const
+{
+  return this->HasLocalConsumers() ||
+    (this->dataPtr->imagePub && this->dataPtr->imagePub->HasConnections());
+}
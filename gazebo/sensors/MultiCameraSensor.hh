@@ -96,6 +96,9 @@ namespace gazebo
       // Documentation inherited.
       public: virtual bool IsActive() const;
 
+      // Documentation inherited
+      public: virtual bool HasConsumers() const;
+
       // Documentation inherited.
       protected: virtual bool UpdateImpl(const bool _force);
 
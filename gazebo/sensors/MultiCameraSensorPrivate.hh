@@ -45,6 +45,10 @@ namespace gazebo
 
       /// \brief True if the sensor was rendered.
       public: bool rendered;
+
+      /// \brief Camera::ImageCount of the first camera at the last update,
+      /// used to skip the frames an asynchronous readback didn't deliver.
+      public: uint64_t imageCount = 0;
     };
   }
 }
@@ -118,12 +118,54 @@ double Noise::Apply(double _in, double _dt)
     return this->ApplyImpl(_in, _dt);
 }
 
+//////////////////////////////////////////////////
+void Noise::Apply(double *_data, size_t _count, double _dt)
+{
+  if (this->type == NONE)
+    return;
+  else if (this->type == CUSTOM)
+  {
+    for (size_t i = 0; i < _count; ++i)
+      _data[i] = this->Apply(_data[i], _dt);
+  }
+  else
+    this->ApplyBatchImpl(_data, _count, _dt);
+}
+
+//////////////////////////////////////////////////
+void Noise::Apply(float *_data, size_t _count, double _dt)
+{
+  if (this->type == NONE)
+    return;
+  else if (this->type == CUSTOM)
+  {
+    for (size_t i = 0; i < _count; ++i)
+      _data[i] = static_cast<float>(this->Apply(_data[i], _dt));
+  }
+  else
+    this->ApplyBatchImpl(_data, _count, _dt);
+}
+
 //////////////////////////////////////////////////
 double Noise::ApplyImpl(double _in, double /*_dt*/)
 {
   return _in;
 }
 
+//////////////////////////////////////////////////
+void Noise::ApplyBatchImpl(double *_data, size_t _count, double _dt)
+{
+  for (size_t i = 0; i < _count; ++i)
+    _data[i] = this->ApplyImpl(_data[i], _dt);
+}
+
+//////////////////////////////////////////////////
+void Noise::ApplyBatchImpl(float *_data, size_t _count, double _dt)
+{
+  for (size_t i = 0; i < _count; ++i)
+    _data[i] = static_cast<float>(this->ApplyImpl(_data[i], _dt));
+}
+
 //////////////////////////////////////////////////
 Noise::NoiseType Noise::GetNoiseType() const
 {
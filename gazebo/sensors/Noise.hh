@@ -82,12 +82,43 @@ namespace gazebo
       /// \return Data with noise applied.
       public: double Apply(double _in, double _dt = 0.0);
 
+      /// \brief Apply noise to an array of data values in place. This
+      /// avoids a virtual call per value, use it for sensors producing many
+      /// values per update.
+      /// \param[in,out] _data Data values.
+      /// \param[in] _count Number of values in _data.
+      /// \param[in] _dt Time since the last update.
+      public: void Apply(double *_data, size_t _count, double _dt = 0.0);
+
+      /// \brief Version of Apply(double *, size_t, double) for float values.
+      /// \param[in,out] _data Data values.
+      /// \param[in] _count Number of values in _data.
+      /// \param[in] _dt Time since the last update.
+      public: void Apply(float *_data, size_t _count, double _dt = 0.0);
+
       /// \brief Apply noise to input data value. This gets overriden by
       /// derived classes, and called by Apply.
       /// \param[in] _in Input data value.
       /// \return Data with noise applied.
       public: virtual double ApplyImpl(double _in, double _dt = 0.0);
 
+      /// \brief Apply noise to an array of data values. This can be
+      /// overriden by derived classes, and is called by Apply. The default
+      /// implementation calls ApplyImpl for each value.
+      /// \param[in,out] _data Data values.
+      /// \param[in] _count Number of values in _data.
+      /// \param[in] _dt Time since the last update.
+      public: virtual void ApplyBatchImpl(double *_data, size_t _count,
+                  double _dt);
+
+      /// \brief Version of ApplyBatchImpl(double *, size_t, double) for float
+      /// values.
+      /// \param[in,out] _data Data values.
+      /// \param[in] _count Number of values in _data.
+      /// \param[in] _dt Time since the last update.
+      public: virtual void ApplyBatchImpl(float *_data, size_t _count,
+                  double _dt);
+
       /// \brief Finalize the noise model
       public: virtual void Fini();
 
@@ -17,6 +17,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/stats.hpp>
 #include <boost/accumulators/statistics/mean.hpp>
@@ -348,6 +350,89 @@ TEST_F(NoiseTest, ApplyGaussianQuantized)
   }
 }
 
+//////////////////////////////////////////////////
+// Test noise applied to arrays
+TEST_F(NoiseTest, ApplyBatch)
+{
+  const unsigned int count = 10001;
+
+  // NONE leaves the values unchanged
+  {
+    sensors::NoisePtr noise = sensors::NoiseFactory::NewNoiseModel(
+        NoiseSdf("none", 0, 0, 0, 0, 0));
+    std::vector<double> values(count, 3.0);
+    noise->Apply(values.data(), values.size());
+    for (auto const v : values)
+      EXPECT_DOUBLE_EQ(v, 3.0);
+  }
+
+  // GAUSSIAN, an odd count checks the last value is also drawn
+  const double mean = 10.0;
+  const double stddev = 5.0;
+  const double biasMean = 100.0;
+  {
+    sensors::NoisePtr noise = sensors::NoiseFactory::NewNoiseModel(
+        NoiseSdf("gaussian", mean, stddev, biasMean, 0, 0));
+    sensors::GaussianNoiseModelPtr gaussianNoise =
+      std::dynamic_pointer_cast<sensors::GaussianNoiseModel>(noise);
+    ASSERT_TRUE(gaussianNoise != nullptr);
+
+    std::vector<double> values(count, 42.0);
+    noise->Apply(values.data(), values.size());
+    EXPECT_NE(values.back(), 42.0);
+
+    boost::accumulators::accumulator_set<double,
+      boost::accumulators::stats<boost::accumulators::tag::mean,
+                                 boost::accumulators::tag::variance > > acc;
+    for (auto const v : values)
+      acc(v);
+
+    // See comments in GaussianNoise function to explain these calculations.
+    double expectedMean = 42.0 + mean + gaussianNoise->GetBias();
+    EXPECT_NEAR(boost::accumulators::mean(acc), expectedMean,
+        g_sigma * stddev / sqrt(count));
+
+    double variance = stddev*stddev;
+    double sampleVariance2 = 2 * variance*variance / (count - 1);
+    EXPECT_NEAR(boost::accumulators::variance(acc),
+                variance, g_sigma*sqrt(sampleVariance2));
+
+    // Float values
+    std::vector<float> floats(count, 42.0f);
+    noise->Apply(floats.data(), floats.size());
+    boost::accumulators::accumulator_set<double,
+      boost::accumulators::stats<boost::accumulators::tag::mean> > accFloat;
+    for (auto const v : floats)
+      accFloat(v);
+    EXPECT_NEAR(boost::accumulators::mean(accFloat), expectedMean,
+        g_sigma * stddev / sqrt(count));
+  }
+
+  // Precision
+  {
+    sensors::NoisePtr noise = sensors::NoiseFactory::NewNoiseModel(
+        NoiseSdf("gaussian_quantized", 0, 0, 0, 0, 0.3));
+    std::vector<double> values = {0.32, 0.28, -12.92, -12.88};
+    noise->Apply(values.data(), values.size());
+    EXPECT_NEAR(values[0], 0.3, 1e-6);
+    EXPECT_NEAR(values[1], 0.3, 1e-6);
+    EXPECT_NEAR(values[2], -12.9, 1e-6);
+    EXPECT_NEAR(values[3], -12.9, 1e-6);
+  }
+
+  // CUSTOM calls the callback for each value
+  {
+    sensors::NoisePtr noise(new sensors::Noise(sensors::Noise::CUSTOM));
+    noise->SetCustomNoiseCallback(
+        [](double _in) { return _in * 2; });
+    std::vector<double> values = {1.0, 2.0, 3.0};
+    noise->Apply(values.data(), values.size());
+    EXPECT_DOUBLE_EQ(values[0], 2.0);
+    EXPECT_DOUBLE_EQ(values[1], 4.0);
+    EXPECT_DOUBLE_EQ(values[2], 6.0);
+  }
+}
+
 //////////////////////////////////////////////////
 // Callback function for applying custom noise
 double OnApplyCustomNoise(double _in)
@@ -14,6 +14,7 @@
  * limitations under the License.
  *
 */
+#include "gazebo/common/Console.hh"
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/transport/transport.hh"
 #include "gazebo/physics/World.hh"
@@ -63,6 +64,7 @@ void RFIDSensor::Load(const std::string &_worldName)
   }
 
   this->dataPtr->entity = this->world->EntityByName(this->ParentName());
+  this->dataPtr->tagIndex = RFIDTagIndex::Get(_worldName);
 
   // this->sdf->PrintDescription("something");
   /*std::cout << " setup ray" << std::endl;
@@ -131,9 +133,13 @@ bool RFIDSensor::UpdateImpl(const bool /*_force*/)
 //////////////////////////////////////////////////
 void RFIDSensor::EvaluateTags()
 {
+  // Only the tags in the cells around the sensor can be in range
+  this->dataPtr->tagIndex->Query(this->dataPtr->entity->WorldPose().Pos(),
+      5.0, this->world->SimTime(), this->dataPtr->tags);
+
   std::vector<RFIDTag*>::const_iterator ci;
 
-  // iterate through the tags contained given rfid tag manager
+  // iterate through the tags near the sensor
   for (ci = this->dataPtr->tags.begin(); ci != this->dataPtr->tags.end(); ++ci)
   {
     ignition::math::Pose3d pos = (*ci)->TagPose();
@@ -167,5 +173,12 @@ bool RFIDSensor::CheckTagRange(const ignition::math::Pose3d &_pose)
 //////////////////////////////////////////////////
 void RFIDSensor::AddTag(RFIDTag *_tag)
 {
-  this->dataPtr->tags.push_back(_tag);
+  // Tags add themselves to the index of their world when loaded, this adds
+  // the tags that weren't.
+  if (!this->dataPtr->tagIndex)
+  {
+    gzerr << "RFID sensor must be loaded before adding tags\n";
+    return;
+  }
+  this->dataPtr->tagIndex->Add(_tag, _tag->TagPose().Pos(), false);
 }
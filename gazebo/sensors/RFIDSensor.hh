@@ -57,7 +57,10 @@ namespace gazebo
       // Documentation inherited
       public: virtual void Init();
 
-      // Documentation inherited
+      /// \brief Add a tag to the index of the world of the sensor. Tags
+      /// add themselves when they are loaded, so this is only needed for
+      /// tags that weren't.
+      /// \param[in] _tag The tag, which is treated as moving.
       public: void AddTag(RFIDTag *_tag);
 
       // Documentation inherited.
@@ -66,8 +69,8 @@ namespace gazebo
       // Documentation inherited
       public: virtual void Fini();
 
-      /// \brief Iterates through all the RFID tags, and finds the ones which
-      /// are in range of the sensor.
+      /// \brief Iterates through the RFID tags in the cells around the
+      /// sensor, and finds the ones which are in range of the sensor.
       private: void EvaluateTags();
 
       /// \brief Check the range for one RFID tag.
@@ -17,10 +17,12 @@
 #ifndef _GAZEBO_SENSORS_RFIDSENSOR_PRIVATE_HH_
 #define _GAZEBO_SENSORS_RFIDSENSOR_PRIVATE_HH_
 
+#include <memory>
 #include <vector>
 
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/sensors/RFIDTag.hh"
+#include "gazebo/sensors/RFIDTagPrivate.hh"
 
 namespace gazebo
 {
@@ -36,7 +38,10 @@ namespace gazebo
       /// \brief Publisher for RFID pose messages.
       public: transport::PublisherPtr scanPub;
 
-      /// \brief All the RFID tags.
+      /// \brief Index of the RFID tags of the world.
+      public: std::shared_ptr<RFIDTagIndex> tagIndex;
+
+      /// \brief Tags near the sensor, found at the last update.
       public: std::vector<RFIDTag*> tags;
     };
   }
@@ -14,6 +14,10 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <cmath>
+#include <map>
+
 #include "gazebo/common/Exception.hh"
 
 #include "gazebo/physics/World.hh"
@@ -24,8 +28,6 @@
 #include "gazebo/msgs/msgs.hh"
 
 #include "gazebo/sensors/SensorFactory.hh"
-#include "gazebo/sensors/SensorManager.hh"
-#include "gazebo/sensors/RFIDSensor.hh"
 #include "gazebo/sensors/RFIDTagPrivate.hh"
 #include "gazebo/sensors/RFIDTag.hh"
 
@@ -45,6 +47,8 @@ RFIDTag::RFIDTag()
 /////////////////////////////////////////////////
 RFIDTag::~RFIDTag()
 {
+  if (this->dataPtr->index)
+    this->dataPtr->index->Remove(this);
 }
 
 /////////////////////////////////////////////////
@@ -66,20 +70,25 @@ void RFIDTag::Load(const std::string &_worldName)
 
   this->dataPtr->entity = this->world->EntityByName(this->ParentName());
 
-  // Add the tag to all the RFID sensors.
-  Sensor_V sensors = SensorManager::Instance()->GetSensors();
-  for (Sensor_V::iterator iter = sensors.begin(); iter != sensors.end(); ++iter)
+  // The RFID sensors of the world find the tag in the index, whether they
+  // are loaded before or after it.
+  if (this->dataPtr->entity)
   {
-    if ((*iter)->Type() == "rfid")
-    {
-      std::dynamic_pointer_cast<RFIDSensor>(*iter)->AddTag(this);
-    }
+    this->dataPtr->index = RFIDTagIndex::Get(_worldName);
+    this->dataPtr->index->Add(this,
+        this->dataPtr->entity->WorldPose().Pos(),
+        this->dataPtr->entity->IsStatic());
   }
 }
 
 /////////////////////////////////////////////////
 void RFIDTag::Fini()
 {
+  if (this->dataPtr->index)
+  {
+    this->dataPtr->index->Remove(this);
+    this->dataPtr->index.reset();
+  }
   Sensor::Fini();
   this->dataPtr->entity.reset();
 }
@@ -129,3 +138,130 @@ ignition::math::Pose3d RFIDTag::TagPose() const
 {
   return this->dataPtr->entity->WorldPose();
 }
+
+/////////////////////////////////////////////////
+std::shared_ptr<RFIDTagIndex> RFIDTagIndex::Get(const std::string &_worldName)
+{
+  static std::mutex indicesMutex;
+  static std::map<std::string, std::shared_ptr<RFIDTagIndex>> indices;
+
+  std::lock_guard<std::mutex> lock(indicesMutex);
+  std::shared_ptr<RFIDTagIndex> &index = indices[_worldName];
+  if (!index)
+    index.reset(new RFIDTagIndex());
+  return index;
+}
+
+/////////////////////////////////////////////////
+int64_t RFIDTagIndex::Key(const ignition::math::Vector3d &_pos) const
+{
+  // 21 bits per axis, cells that are far enough apart to share a key are
+  // told apart by the range check of the sensors.
+  int64_t x = static_cast<int64_t>(std::floor(_pos.X() / this->cellSize));
+  int64_t y = static_cast<int64_t>(std::floor(_pos.Y() / this->cellSize));
+  int64_t z = static_cast<int64_t>(std::floor(_pos.Z() / this->cellSize));
+  return ((x & 0x1FFFFF) << 42) | ((y & 0x1FFFFF) << 21) | (z & 0x1FFFFF);
+}
+
+/////////////////////////////////////////////////
+void RFIDTagIndex::Insert(RFIDTag *_tag, const int64_t _key)
+{
+  std::vector<RFIDTag *> &cell = this->cells[_key];
+  Entry &entry = this->entries[_tag];
+  entry.key = _key;
+  entry.slot = cell.size();
+  cell.push_back(_tag);
+}
+
+/////////////////////////////////////////////////
+void RFIDTagIndex::Erase(RFIDTag *_tag)
+{
+  Entry &entry = this->entries[_tag];
+  auto cell = this->cells.find(entry.key);
+
+  // Move the last tag of the cell to the free slot
+  if (entry.slot + 1 < cell->second.size())
+  {
+    RFIDTag *last = cell->second.back();
+    cell->second[entry.slot] = last;
+    this->entries[last].slot = entry.slot;
+  }
+  cell->second.pop_back();
+  if (cell->second.empty())
+    this->cells.erase(cell);
+}
+
+/////////////////////////////////////////////////
+void RFIDTagIndex::Add(RFIDTag *_tag, const ignition::math::Vector3d &_pos,
+    const bool _static)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  if (this->entries.find(_tag) != this->entries.end())
+    return;
+
+  this->Insert(_tag, this->Key(_pos));
+  this->entries[_tag].isStatic = _static;
+  if (!_static)
+    this->moving.push_back(_tag);
+}
+
+/////////////////////////////////////////////////
+void RFIDTagIndex::Remove(RFIDTag *_tag)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  auto iter = this->entries.find(_tag);
+  if (iter == this->entries.end())
+    return;
+
+  if (!iter->second.isStatic)
+  {
+    this->moving.erase(
+        std::find(this->moving.begin(), this->moving.end(), _tag));
+  }
+  this->Erase(_tag);
+  this->entries.erase(_tag);
+}
+
+/////////////////////////////////////////////////
+void RFIDTagIndex::Query(const ignition::math::Vector3d &_center,
+    const double _radius, const common::Time &_time,
+    std::vector<RFIDTag *> &_tags)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  _tags.clear();
+
+  // Bin the moving tags again, once per time step for all the sensors
+  if (_time != this->refreshTime)
+  {
+    this->refreshTime = _time;
+    for (auto tag : this->moving)
+    {
+      int64_t key = this->Key(tag->TagPose().Pos());
+      if (key != this->entries[tag].key)
+      {
+        this->Erase(tag);
+        this->Insert(tag, key);
+      }
+    }
+  }
+
+  // Cells overlapping the box around the sphere
+  const ignition::math::Vector3d low = (_center -
+      ignition::math::Vector3d(_radius, _radius, _radius)) / this->cellSize;
+  const ignition::math::Vector3d high = (_center +
+      ignition::math::Vector3d(_radius, _radius, _radius)) / this->cellSize;
+  for (double x = std::floor(low.X()); x <= std::floor(high.X()); ++x)
+  {
+    for (double y = std::floor(low.Y()); y <= std::floor(high.Y()); ++y)
+    {
+      for (double z = std::floor(low.Z()); z <= std::floor(high.Z()); ++z)
+      {
+        auto cell = this->cells.find(this->Key(ignition::math::Vector3d(
+                (x + 0.5) * this->cellSize, (y + 0.5) * this->cellSize,
+                (z + 0.5) * this->cellSize)));
+        if (cell != this->cells.end())
+          _tags.insert(_tags.end(), cell->second.begin(), cell->second.end());
+      }
+    }
+  }
+}
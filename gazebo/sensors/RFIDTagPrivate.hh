@@ -17,6 +17,16 @@
 #ifndef _GAZEBO_SENSORS_RFIDTAG_PRIVATE_HH_
 #define _GAZEBO_SENSORS_RFIDTAG_PRIVATE_HH_
 
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/common/Time.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/transport/TransportTypes.hh"
 
@@ -24,6 +34,90 @@ namespace gazebo
 {
   namespace sensors
   {
+    class RFIDTag;
+
+    /// \internal
+    /// \brief Spatial hash of the RFID tags of a world, shared by its RFID
+    /// sensors, so that each sensor only looks at the tags in the cells
+    /// around it. The tags of static models are binned once, the others
+    /// are binned again at most once per simulation time, by the first
+    /// query at that time.
+    class RFIDTagIndex
+    {
+      /// \brief Get the index of a world, created on first use.
+      /// \param[in] _worldName Name of the world.
+      /// \return The index.
+      public: static std::shared_ptr<RFIDTagIndex> Get(
+                  const std::string &_worldName);
+
+      /// \brief Add a tag. Does nothing if the tag is already indexed.
+      /// \param[in] _tag The tag.
+      /// \param[in] _pos World position of the tag.
+      /// \param[in] _static True if the tag never moves.
+      public: void Add(RFIDTag *_tag, const ignition::math::Vector3d &_pos,
+                  const bool _static);
+
+      /// \brief Remove a tag. Does nothing if the tag isn't indexed.
+      /// \param[in] _tag The tag.
+      public: void Remove(RFIDTag *_tag);
+
+      /// \brief Get the tags in the cells within a distance of a point.
+      /// \param[in] _center The point.
+      /// \param[in] _radius The distance.
+      /// \param[in] _time Current simulation time, the moving tags are
+      /// binned again when it changes.
+      /// \param[out] _tags The tags, some of which may be further away
+      /// than _radius.
+      public: void Query(const ignition::math::Vector3d &_center,
+                  const double _radius, const common::Time &_time,
+                  std::vector<RFIDTag *> &_tags);
+
+      /// \brief Get the key of the cell of a position.
+      /// \param[in] _pos The position.
+      /// \return The key.
+      private: int64_t Key(const ignition::math::Vector3d &_pos) const;
+
+      /// \brief Put a tag in a cell.
+      /// \param[in] _tag The tag.
+      /// \param[in] _key Key of the cell.
+      private: void Insert(RFIDTag *_tag, const int64_t _key);
+
+      /// \brief Take a tag out of its cell.
+      /// \param[in] _tag The tag.
+      private: void Erase(RFIDTag *_tag);
+
+      /// \brief Cell of a tag.
+      private: struct Entry
+               {
+                 /// \brief Key of the cell.
+                 int64_t key;
+
+                 /// \brief Index of the tag in the cell.
+                 size_t slot;
+
+                 /// \brief True if the tag never moves.
+                 bool isStatic;
+               };
+
+      /// \brief Size of the cells, which is the range of the sensors.
+      private: double cellSize = 5.0;
+
+      /// \brief Tags of each cell, by key.
+      private: std::unordered_map<int64_t, std::vector<RFIDTag *>> cells;
+
+      /// \brief Cell of each tag.
+      private: std::unordered_map<RFIDTag *, Entry> entries;
+
+      /// \brief Tags that aren't static.
+      private: std::vector<RFIDTag *> moving;
+
+      /// \brief Simulation time at which the moving tags were binned.
+      private: common::Time refreshTime;
+
+      /// \brief Protects the cells.
+      private: std::mutex mutex;
+    };
+
     /// \internal
     /// \brief RFID tag private data.
     class RFIDTagPrivate
@@ -33,6 +127,9 @@ namespace gazebo
 
       /// \brief Publisher for tag pose messages.
       public: transport::PublisherPtr scanPub;
+
+      /// \brief Index of the tags of the world.
+      public: std::shared_ptr<RFIDTagIndex> index;
     };
   }
 }
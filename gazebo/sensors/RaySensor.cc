@@ -14,6 +14,9 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <functional>
+#include <vector>
 #include <boost/algorithm/string.hpp>
 
 #include "gazebo/physics/World.hh"
@@ -24,6 +27,7 @@
 #include "gazebo/physics/Collision.hh"
 
 #include "gazebo/common/Assert.hh"
+#include "gazebo/common/Events.hh"
 #include "gazebo/common/Exception.hh"
 
 #include "gazebo/transport/Node.hh"
@@ -115,6 +119,24 @@ void RaySensor::Load(const std::string &_worldName)
 
   GZ_ASSERT(this->dataPtr->parentEntity != nullptr,
       "Unable to get the parent entity.");
+
+  // A time sliced lidar sweeps its horizontal samples once per update
+  // period, casting the ones due after each physics step
+  if (rayElem->HasElement("gz:time_sliced") &&
+      rayElem->Get<bool>("gz:time_sliced"))
+  {
+    if (this->UpdateRate() > 0)
+    {
+      this->dataPtr->timeSliced = true;
+      this->dataPtr->sliceConnection = event::Events::ConnectWorldUpdateEnd(
+          std::bind(&RaySensor::OnWorldUpdateEnd, this));
+    }
+    else
+    {
+      gzwarn << "Ray sensor [" << this->Name() << "] needs an update rate "
+        << "to be time sliced, the rays will be cast all at once.\n";
+    }
+  }
 }
 
 //////////////////////////////////////////////////
@@ -127,6 +149,8 @@ void RaySensor::Init()
 //////////////////////////////////////////////////
 void RaySensor::Fini()
 {
+  this->dataPtr->sliceConnection.reset();
+
   Sensor::Fini();
 
   this->dataPtr->scanPub.reset();
@@ -277,6 +301,26 @@ void RaySensor::Ranges(std::vector<double> &_ranges) const
          sizeof(_ranges[0]) * this->dataPtr->laserMsg.scan().ranges_size());
 }
 
+//////////////////////////////////////////////////
+void RaySensor::Scan(std::vector<float> &_ranges,
+    std::vector<float> &_intensities, common::Time &_stamp) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  const msgs::LaserScan &scan = this->dataPtr->laserMsg.scan();
+  _ranges.assign(scan.ranges().begin(), scan.ranges().end());
+  _intensities.assign(scan.intensities().begin(), scan.intensities().end());
+  _intensities.resize(_ranges.size(), 0.0f);
+  _stamp = msgs::Convert(this->dataPtr->laserMsg.time());
+}
+
+//////////////////////////////////////////////////
+void RaySensor::RangeTimes(std::vector<double> &_times) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  _times = this->dataPtr->rangeTimes;
+}
+
 //////////////////////////////////////////////////
 double RaySensor::Range(const unsigned int _index) const
 {
@@ -342,11 +386,22 @@ int RaySensor::Fiducial(const unsigned int _index) const
 //////////////////////////////////////////////////
 bool RaySensor::UpdateImpl(const bool /*_force*/)
 {
-  // do the collision checks
-  // this eventually call OnNewScans, so move mutex lock behind it in case
-  // need to move mutex lock after this? or make the OnNewLaserScan connection
-  // call somewhere else?
-  this->dataPtr->laserShape->Update();
+  // Time sliced sensors cast their rays after the physics steps, keep
+  // them from casting while the readings are gathered
+  std::unique_lock<std::mutex> sliceLock(this->dataPtr->sliceMutex,
+      std::defer_lock);
+  if (this->dataPtr->timeSliced)
+  {
+    sliceLock.lock();
+  }
+  else
+  {
+    // do the collision checks
+    // this eventually call OnNewScans, so move mutex lock behind it in case
+    // need to move mutex lock after this? or make the OnNewLaserScan
+    // connection call somewhere else?
+    this->dataPtr->laserShape->Update();
+  }
   this->lastMeasurementTime = this->world->SimTime();
 
   // moving this behind laserShape update
@@ -375,6 +430,7 @@ bool RaySensor::UpdateImpl(const bool /*_force*/)
 
   scan->clear_ranges();
   scan->clear_intensities();
+  this->dataPtr->rangeTimes.clear();
 
   unsigned int rayCount = this->RayCount();
   unsigned int rangeCount = this->RangeCount();
@@ -413,6 +469,15 @@ bool RaySensor::UpdateImpl(const bool /*_force*/)
   bool interp =
     ((rayCount != rangeCount) || (verticalRayCount != verticalRangeCount));
 
+  // currently supports only one noise model per laser sensor. The ranges are
+  // gathered and the noise is applied to all of them at once.
+  NoisePtr noise;
+  auto noiseIter = this->noises.find(RAY_NOISE);
+  if (noiseIter != this->noises.end())
+    noise = noiseIter->second;
+  this->dataPtr->noiseRanges.clear();
+  this->dataPtr->noiseIndices.clear();
+
   // interpolate in vertical direction
   for (unsigned int j = 0; j < verticalRangeCount; ++j)
   {
@@ -483,17 +548,33 @@ bool RaySensor::UpdateImpl(const bool /*_force*/)
       {
         range = -ignition::math::INF_D;
       }
-      else if (this->noises.find(RAY_NOISE) !=
-               this->noises.end())
+      else if (noise)
       {
-        // currently supports only one noise model per laser sensor
-        range = this->noises[RAY_NOISE]->Apply(range);
-        range = ignition::math::clamp(range,
-            this->RangeMin(), this->RangeMax());
+        this->dataPtr->noiseIndices.push_back(scan->ranges_size());
+        this->dataPtr->noiseRanges.push_back(range);
       }
 
       scan->add_ranges(range);
       scan->add_intensities(intensity);
+
+      // The time of the nearest horizontal sample at or before the range
+      const unsigned int column = interp ? hja : i;
+      this->dataPtr->rangeTimes.push_back(
+          column < this->dataPtr->columnTimes.size() ?
+          this->dataPtr->columnTimes[column].Double() :
+          this->lastMeasurementTime.Double());
+    }
+  }
+
+  if (!this->dataPtr->noiseRanges.empty())
+  {
+    noise->Apply(this->dataPtr->noiseRanges.data(),
+        this->dataPtr->noiseRanges.size());
+    for (size_t k = 0; k < this->dataPtr->noiseRanges.size(); ++k)
+    {
+      scan->set_ranges(this->dataPtr->noiseIndices[k],
+          ignition::math::clamp(this->dataPtr->noiseRanges[k],
+            this->RangeMin(), this->RangeMax()));
     }
   }
 
@@ -503,6 +584,54 @@ bool RaySensor::UpdateImpl(const bool /*_force*/)
   return true;
 }
 
+//////////////////////////////////////////////////
+void RaySensor::OnWorldUpdateEnd()
+{
+  if (!this->dataPtr->laserShape || !this->IsActive())
+    return;
+
+  const common::Time now = this->world->SimTime();
+  const double period = 1.0 / this->UpdateRate();
+  const unsigned int columns = std::max(this->RayCount(), 1);
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->sliceMutex);
+
+  auto cast = [&](const unsigned int _first, const unsigned int _last)
+  {
+    if (_last <= _first)
+      return;
+    this->dataPtr->laserShape->UpdateColumns(_first, _last - _first);
+    for (unsigned int c = _first; c < _last; ++c)
+      this->dataPtr->columnTimes[c] = now;
+  };
+
+  // Start a new sweep on the first step, after a reset, or when more
+  // than a sweep was missed while the sensor was inactive
+  if (this->dataPtr->columnTimes.size() != columns ||
+      now < this->dataPtr->sweepStart ||
+      (now - this->dataPtr->sweepStart).Double() >= 2.0 * period)
+  {
+    this->dataPtr->columnTimes.resize(columns, now);
+    this->dataPtr->sweepStart = now;
+    this->dataPtr->sweepColumns = 0;
+  }
+
+  double phase = (now - this->dataPtr->sweepStart).Double() / period;
+  if (phase >= 1.0)
+  {
+    // Finish the previous sweep
+    cast(this->dataPtr->sweepColumns, columns);
+    this->dataPtr->sweepStart += common::Time(period);
+    this->dataPtr->sweepColumns = 0;
+    phase = std::max(0.0, phase - 1.0);
+  }
+
+  const unsigned int due = std::min(columns,
+      static_cast<unsigned int>(phase * columns) + 1);
+  cast(this->dataPtr->sweepColumns, due);
+  this->dataPtr->sweepColumns = std::max(this->dataPtr->sweepColumns, due);
+}
+
 //////////////////////////////////////////////////
 bool RaySensor::IsActive() const
 {
@@ -510,6 +639,13 @@ bool RaySensor::IsActive() const
     (this->dataPtr->scanPub && this->dataPtr->scanPub->HasConnections());
 }
 
+//////////////////////////////////////////////////
+bool RaySensor::HasConsumers() const
+{
+  return this->HasLocalConsumers() ||
+    (this->dataPtr->scanPub && this->dataPtr->scanPub->HasConnections());
+}
+
 //////////////////////////////////////////////////
 physics::MultiRayShapePtr RaySensor::LaserShape() const
 {
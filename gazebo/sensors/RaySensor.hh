@@ -138,6 +138,27 @@ namespace gazebo
       /// \param[out] _ranges A vector that will contain all the range data
       public: void Ranges(std::vector<double> &_ranges) const;
 
+      /// \brief Get the latest scan in single precision, as separate range
+      /// and intensity arrays indexed like Ranges(). The arrays are the
+      /// same size, and are only reallocated when they are too small, so
+      /// consumers reusing them across scans don't allocate.
+      /// \param[out] _ranges Range of each ray, in meters.
+      /// \param[out] _intensities Retro (intensity) value of each ray.
+      /// \param[out] _stamp Simulation time the rays were cast at, all
+      /// the rays of a scan are cast at the same time.
+      public: void Scan(std::vector<float> &_ranges,
+                  std::vector<float> &_intensities,
+                  common::Time &_stamp) const;
+
+      /// \brief Get the sim time each range of the latest scan was
+      /// measured at. A time sliced sensor, enabled with
+      /// <ray><gz:time_sliced>, casts each horizontal sample when the
+      /// sweep reaches it, so the times spread over a sweep. Otherwise all
+      /// the ranges share the time of the scan.
+      /// \param[out] _times Time of each range in seconds, indexed like
+      /// Ranges().
+      public: void RangeTimes(std::vector<double> &_times) const;
+
       /// \brief Get detected retro (intensity) value for a ray.
       ///         Warning: If you are accessing all the ray data in a loop
       ///         it's possible that the Ray will update in the middle of
@@ -167,6 +188,13 @@ namespace gazebo
       // Documentation inherited
       public: virtual bool IsActive() const;
 
+      // Documentation inherited
+      public: virtual bool HasConsumers() const;
+
+      /// \brief Cast the slice of a time sliced sensor due since the
+      /// last physics step.
+      private: void OnWorldUpdateEnd();
+
       /// \internal
       /// \brief Private data pointer.
       private: std::unique_ptr<RaySensorPrivate> dataPtr;
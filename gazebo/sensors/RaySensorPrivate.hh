@@ -18,7 +18,10 @@
 #define _GAZEBO_SENSORS_RAYSENSOR_PRIVATE_HH_
 
 #include <mutex>
+#include <vector>
 
+#include "gazebo/common/Event.hh"
+#include "gazebo/common/Time.hh"
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/transport/TransportTypes.hh"
@@ -48,6 +51,40 @@ namespace gazebo
 
       /// \brief Laser message.
       public: msgs::LaserScanStamped laserMsg;
+
+      /// \brief Ranges to apply noise to, gathered for one batch.
+      public: std::vector<double> noiseRanges;
+
+      /// \brief Index in the scan of each range in noiseRanges.
+      public: std::vector<int> noiseIndices;
+
+      /// \brief True if the rays are cast in azimuth slices after each
+      /// physics step rather than all at once in each sensor update.
+      public: bool timeSliced = false;
+
+      /// \brief Sim time the current sweep of a time sliced sensor started
+      /// at. Protected by sliceMutex.
+      public: common::Time sweepStart;
+
+      /// \brief Number of horizontal samples cast in the current sweep.
+      /// Protected by sliceMutex.
+      public: unsigned int sweepColumns = 0;
+
+      /// \brief Sim time each horizontal sample was last cast at.
+      /// Protected by sliceMutex.
+      public: std::vector<common::Time> columnTimes;
+
+      /// \brief Sim time each range of laserMsg was measured at, in
+      /// seconds. Protected by mutex.
+      public: std::vector<double> rangeTimes;
+
+      /// \brief Mutex to protect the ray readings of a time sliced sensor,
+      /// cast in the physics thread and read in the sensor thread.
+      public: std::mutex sliceMutex;
+
+      /// \brief Connection to the world update end event, used to cast
+      /// the slices.
+      public: event::ConnectionPtr sliceConnection;
     };
   }
 }
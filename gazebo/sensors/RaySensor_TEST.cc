@@ -16,6 +16,7 @@
 */
 
 #include <gtest/gtest.h>
+#include <boost/algorithm/string/replace.hpp>
 #include <ignition/math/Helpers.hh>
 #include <sdf/sdf.hh>
 #include "gazebo/test/ServerFixture.hh"
@@ -133,6 +134,15 @@ TEST_F(RaySensor_TEST, CreateLaser)
   sensor->Ranges(ranges);
   EXPECT_EQ(ranges.size(), static_cast<size_t>(640));
 
+  // Get the single precision scan
+  std::vector<float> scanRanges;
+  std::vector<float> scanIntensities;
+  common::Time stamp;
+  sensor->Scan(scanRanges, scanIntensities, stamp);
+  EXPECT_EQ(scanRanges.size(), ranges.size());
+  EXPECT_EQ(scanIntensities.size(), ranges.size());
+  EXPECT_EQ(stamp, sensor->LastMeasurementTime());
+
   // Check that all the range values
   for (unsigned int i = 0; i < ranges.size(); ++i)
   {
@@ -140,7 +150,15 @@ TEST_F(RaySensor_TEST, CreateLaser)
     EXPECT_DOUBLE_EQ(sensor->Range(i), ranges[i]);
     EXPECT_NEAR(sensor->Retro(i), 0, 1e-6);
     EXPECT_EQ(sensor->Fiducial(i), -1);
+    EXPECT_FLOAT_EQ(scanRanges[i], ignition::math::INF_F);
+    EXPECT_NEAR(scanIntensities[i], 0, 1e-6);
   }
+
+  // Reading the next scan into the same arrays reuses their memory
+  const float *data = scanRanges.data();
+  sensor->Update(true);
+  sensor->Scan(scanRanges, scanIntensities, stamp);
+  EXPECT_EQ(scanRanges.data(), data);
 }
 
 /////////////////////////////////////////////////
@@ -198,6 +216,62 @@ TEST_F(RaySensor_TEST, LaserScanResolution)
   }
 }
 
+/////////////////////////////////////////////////
+/// \brief Test a ray sensor casting its rays in azimuth slices
+TEST_F(RaySensor_TEST, TimeSliced)
+{
+  Load("worlds/empty.world", true);
+  sensors::SensorManager *mgr = sensors::SensorManager::Instance();
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  // One sweep of 64 samples every 0.1 s
+  std::string sensorString = raySensorString;
+  boost::replace_first(sensorString, "<samples>640</samples>",
+      "<samples>64</samples>");
+  boost::replace_first(sensorString,
+      "<update_rate>20.000000</update_rate>",
+      "<update_rate>10.000000</update_rate>");
+  boost::replace_first(sensorString, "<ray>",
+      "<ray><gz:time_sliced>true</gz:time_sliced>");
+
+  sdf::ElementPtr sdf(new sdf::Element);
+  sdf::initFile("sensor.sdf", sdf);
+  sdf::readString(sensorString, sdf);
+
+  std::string sensorName = mgr->CreateSensor(sdf, "default",
+      "ground_plane::link", 0);
+  mgr->Update();
+
+  sensors::RaySensorPtr sensor = std::dynamic_pointer_cast<sensors::RaySensor>
+    (mgr->GetSensor(sensorName));
+  ASSERT_TRUE(sensor != nullptr);
+
+  // A sweep and a half
+  const double stepSize = world->Physics()->GetMaxStepSize();
+  world->Step(static_cast<unsigned int>(0.15 / stepSize));
+  sensor->Update(true);
+
+  std::vector<double> ranges;
+  std::vector<double> times;
+  sensor->Ranges(ranges);
+  sensor->RangeTimes(times);
+  ASSERT_EQ(times.size(), static_cast<size_t>(64));
+  EXPECT_EQ(times.size(), ranges.size());
+
+  // The first half was cast in the current sweep, after the second half
+  const double simTime = world->SimTime().Double();
+  EXPECT_GT(times.front(), times.back());
+  for (unsigned int i = 0; i < times.size(); ++i)
+  {
+    EXPECT_LE(times[i], simTime + 1e-6);
+    EXPECT_GE(times[i], simTime - 0.11);
+    if (i > 0 && i < 31)
+      EXPECT_GE(times[i], times[i - 1]);
+    EXPECT_DOUBLE_EQ(ranges[i], ignition::math::INF_D);
+  }
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
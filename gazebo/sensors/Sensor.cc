@@ -21,6 +21,7 @@
 #include "gazebo/physics/Joint.hh"
 #include "gazebo/physics/World.hh"
 
+#include "gazebo/common/Profiler.hh"
 #include "gazebo/common/Timer.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
@@ -62,7 +63,7 @@ Sensor::Sensor(SensorCategory _cat)
 
   this->node = transport::NodePtr(new transport::Node());
 
-  this->dataPtr->updateDelay = common::Time(0.0);
+  this->dataPtr->updateDelay = common::NanoTime();
   this->updatePeriod = common::Time(0.0);
 
   this->dataPtr->id = physics::getUniqueId();
@@ -137,6 +138,9 @@ void Sensor::Load(const std::string &_worldName)
   if (this->sdf->Get<bool>("always_on"))
     this->SetActive(true);
 
+  if (this->sdf->HasElement("gz:lazy_update"))
+    this->SetLazyUpdate(this->sdf->Get<bool>("gz:lazy_update"));
+
   if (this->dataPtr->category == IMAGE)
     this->scene = rendering::get_scene(_worldName);
 
@@ -218,13 +222,15 @@ bool Sensor::NeedsUpdate()
     return false;
   }
 
-  return (simTime - this->lastMeasurementTime +
-      this->dataPtr->updateDelay) >= this->updatePeriod;
+  return common::NanoTime(simTime) -
+      common::NanoTime(this->lastMeasurementTime) +
+      this->dataPtr->updateDelay >= common::NanoTime(this->updatePeriod);
 }
 
 //////////////////////////////////////////////////
 void Sensor::Update(const bool _force)
 {
+  GZ_PROFILE("Sensor::Update");
   if (this->IsActive() || _force)
   {
     common::Time simTime;
@@ -243,26 +249,37 @@ void Sensor::Update(const bool _force)
       // sensor's update in the same thread.
       // NOTE: If you change this equation, also change the matching equation in
       // Sensor::NeedsUpdate
-      common::Time adjustedElapsed = simTime -
-        this->lastUpdateTime + this->dataPtr->updateDelay;
+      const common::NanoTime period(this->updatePeriod);
+      const common::NanoTime adjustedElapsed = common::NanoTime(simTime) -
+        common::NanoTime(this->lastUpdateTime) + this->dataPtr->updateDelay;
 
-      if (adjustedElapsed < this->updatePeriod && !_force)
+      if (adjustedElapsed < period && !_force)
         return;
 
-      this->dataPtr->updateDelay = std::max(common::Time::Zero,
-          adjustedElapsed - this->updatePeriod);
+      this->dataPtr->updateDelay = std::max(common::NanoTime(),
+          adjustedElapsed - period);
 
       // if delay is more than a full update period, then give up trying
       // to catch up. This happens normally when the sensor just changed from
       // an inactive to an active state, or the sensor just cannot hit its
       // target update rate (worst case).
-      if (this->dataPtr->updateDelay >= this->updatePeriod)
-        this->dataPtr->updateDelay = common::Time::Zero;
+      if (this->dataPtr->updateDelay >= period)
+        this->dataPtr->updateDelay = common::NanoTime();
     }
 
-    if (this->UpdateImpl(_force))
+    common::Time start = common::Time::GetWallTime();
+    bool result = this->UpdateImpl(_force);
+    common::Time duration = common::Time::GetWallTime() - start;
+
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutexLastUpdateTime);
+    this->dataPtr->updateDuration = duration;
+    this->dataPtr->maxUpdateDuration =
+        std::max(this->dataPtr->maxUpdateDuration, duration);
+    this->dataPtr->totalUpdateDuration += duration;
+    ++this->dataPtr->updateCount;
+
+    if (result)
     {
-      std::lock_guard<std::mutex> lock(this->dataPtr->mutexLastUpdateTime);
       this->lastUpdateTime = simTime;
       this->updated();
     }
@@ -327,6 +344,9 @@ void Sensor::LoadPlugin(sdf::ElementPtr _sdf)
     }
 
     SensorPtr myself = shared_from_this();
+
+    // Account the callbacks the plugin connects to it
+    event::ConnectionOwner owner(this->ScopedName() + "::" + name);
     plugin->Load(myself, _sdf);
     plugin->Init();
     this->plugins.push_back(plugin);
@@ -342,7 +362,32 @@ void Sensor::SetActive(const bool _value)
 //////////////////////////////////////////////////
 bool Sensor::IsActive() const
 {
-  return this->active;
+  return this->active &&
+      (!this->dataPtr->lazyUpdate || this->HasConsumers());
+}
+
+//////////////////////////////////////////////////
+void Sensor::SetLazyUpdate(const bool _lazy)
+{
+  this->dataPtr->lazyUpdate = _lazy;
+}
+
+//////////////////////////////////////////////////
+bool Sensor::LazyUpdate() const
+{
+  return this->dataPtr->lazyUpdate;
+}
+
+//////////////////////////////////////////////////
+bool Sensor::HasConsumers() const
+{
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Sensor::HasLocalConsumers() const
+{
+  return !this->plugins.empty() || this->updated.ConnectionCount() > 0;
 }
 
 //////////////////////////////////////////////////
@@ -401,6 +446,31 @@ common::Time Sensor::LastMeasurementTime() const
   return this->lastMeasurementTime;
 }
 
+//////////////////////////////////////////////////
+common::Time Sensor::UpdateDuration() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutexLastUpdateTime);
+  return this->dataPtr->updateDuration;
+}
+
+//////////////////////////////////////////////////
+common::Time Sensor::MeanUpdateDuration() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutexLastUpdateTime);
+  if (this->dataPtr->updateCount == 0)
+    return common::Time::Zero;
+
+  return common::Time(this->dataPtr->totalUpdateDuration.Double() /
+      this->dataPtr->updateCount);
+}
+
+//////////////////////////////////////////////////
+common::Time Sensor::MaxUpdateDuration() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutexLastUpdateTime);
+  return this->dataPtr->maxUpdateDuration;
+}
+
 //////////////////////////////////////////////////
 std::string Sensor::Type() const
 {
@@ -502,7 +572,7 @@ void Sensor::ResetLastUpdateTime()
   std::lock_guard<std::mutex> lock(this->dataPtr->mutexLastUpdateTime);
   this->lastUpdateTime = 0.0;
   this->lastMeasurementTime = 0.0;
-  this->dataPtr->updateDelay = 0.0;
+  this->dataPtr->updateDelay = common::NanoTime();
 }
 
 //////////////////////////////////////////////////
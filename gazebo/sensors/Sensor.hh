@@ -122,6 +122,29 @@ namespace gazebo
       /// \return True if active, false if not.
       public: virtual bool IsActive() const;
 
+      /// \brief Set whether the sensor skips its updates while nothing
+      /// consumes its output. A sensor that is lazy and active is
+      /// considered inactive until it has a consumer, and resumes at its
+      /// next update when one appears. It can also be set with the
+      /// <gz:lazy_update> element of <sensor>, in which case a camera
+      /// sensor without plugins also waits for its first consumer before
+      /// creating its camera.
+      /// \param[in] _lazy True to skip updates without consumers.
+      /// \sa HasConsumers
+      public: void SetLazyUpdate(const bool _lazy);
+
+      /// \brief Get whether the sensor skips its updates while nothing
+      /// consumes its output.
+      /// \return True if the sensor is lazy.
+      public: bool LazyUpdate() const;
+
+      /// \brief Get whether anything consumes the output of the sensor,
+      /// such as sensor plugins, ConnectUpdated callbacks or subscribers
+      /// to its topics. Sensors that can't tell always return true, so
+      /// they never skip their updates.
+      /// \return True if the output of the sensor is consumed.
+      public: virtual bool HasConsumers() const;
+
       /// \brief Get sensor type.
       /// \return Type of sensor.
       public: std::string Type() const;
@@ -134,6 +157,20 @@ namespace gazebo
       /// \return Time of last measurement.
       public: common::Time LastMeasurementTime() const;
 
+      /// \brief Get the wall clock time the last update of the sensor took.
+      /// Updates that are skipped because the sensor is not due don't count.
+      /// \return Duration of the last update.
+      public: common::Time UpdateDuration() const;
+
+      /// \brief Get the mean wall clock time an update of the sensor takes.
+      /// \return Mean duration of the updates, zero if the sensor has not
+      /// been updated.
+      public: common::Time MeanUpdateDuration() const;
+
+      /// \brief Get the longest wall clock time an update of the sensor took.
+      /// \return Maximum duration of the updates.
+      public: common::Time MaxUpdateDuration() const;
+
       /// \brief Return true if user requests the sensor to be visualized
       ///        via tag:  <visualize>true</visualize> in SDF.
       /// \return True if visualized, false if not.
@@ -197,6 +234,12 @@ namespace gazebo
       /// \return True when sensor should be updated.
       protected: virtual bool NeedsUpdate();
 
+      /// \brief Get whether sensor plugins or ConnectUpdated callbacks
+      /// consume the output of the sensor, for the implementations of
+      /// HasConsumers.
+      /// \return True if the sensor has plugins or update callbacks.
+      protected: bool HasLocalConsumers() const;
+
       /// \brief Load a plugin for this sensor.
       /// \param[in] _sdf SDF parameters.
       private: void LoadPlugin(sdf::ElementPtr _sdf);
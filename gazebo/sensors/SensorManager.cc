@@ -14,9 +14,13 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
 #include <functional>
 #include <boost/bind.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 #include "gazebo/common/Assert.hh"
+#include "gazebo/common/Profiler.hh"
 #include "gazebo/common/Time.hh"
 
 #include "gazebo/physics/PhysicsIface.hh"
@@ -296,6 +300,22 @@ std::string SensorManager::CreateSensor(sdf::ElementPtr _elem,
 
   // Load the sensor
   sensor->Load(_worldName, _elem);
+
+  // The first sensor of a world applies the world's parallel update setting
+  if (this->worlds.find(_worldName) == this->worlds.end())
+  {
+    physics::WorldPtr world = physics::get_world(_worldName);
+    sdf::ElementPtr worldElem = world ? world->SDF() : nullptr;
+    if (worldElem && worldElem->HasElement("physics"))
+    {
+      sdf::ElementPtr physicsElem = worldElem->GetElement("physics");
+      if (physicsElem->HasElement("gz:parallel_sensor_update"))
+      {
+        this->SetParallelUpdate(
+            physicsElem->Get<bool>("gz:parallel_sensor_update"));
+      }
+    }
+  }
   this->worlds[_worldName] = physics::get_world(_worldName);
 
   // If the SensorManager has not been initialized, then it's okay to push
@@ -413,6 +433,25 @@ void SensorManager::RemoveSensors()
   this->removeAllSensors = true;
 }
 
+//////////////////////////////////////////////////
+void SensorManager::SetParallelUpdate(const bool _enable)
+{
+  boost::recursive_mutex::scoped_lock lock(this->mutex);
+
+  this->parallelUpdate = _enable;
+
+  // Image sensors render in the main thread, they stay serial.
+  this->sensorContainers[sensors::RAY]->SetParallel(_enable);
+  this->sensorContainers[sensors::OTHER]->SetParallel(_enable);
+}
+
+//////////////////////////////////////////////////
+bool SensorManager::ParallelUpdate() const
+{
+  boost::recursive_mutex::scoped_lock lock(this->mutex);
+  return this->parallelUpdate;
+}
+
 //////////////////////////////////////////////////
 SensorManager::SensorContainer::SensorContainer()
 {
@@ -457,6 +496,8 @@ void SensorManager::SensorContainer::Fini()
 
   // Remove all the sensors from the current sensor vector.
   this->sensors.clear();
+  this->updateOrder.clear();
+  this->updateGroupsDirty = true;
 
   this->initialized = false;
 }
@@ -605,18 +646,93 @@ void SensorManager::SensorContainer::RunLoop()
 //////////////////////////////////////////////////
 void SensorManager::SensorContainer::Update(bool _force)
 {
+  GZ_PROFILE("SensorManager::SensorContainer::Update");
   boost::recursive_mutex::scoped_lock lock(this->mutex);
 
   if (this->sensors.empty())
     gzlog << "Updating a sensor container without any sensors.\n";
 
-  // Update all the sensors in this container.
-  for (Sensor_V::iterator iter = this->sensors.begin();
-       iter != this->sensors.end(); ++iter)
+  if (this->parallel && this->updateGroupsDirty)
+    this->UpdateGroups();
+
+  // There is nothing to gain from spawning tasks for a single group.
+  if (!this->parallel || this->updateGroups.size() < 3)
   {
-    GZ_ASSERT((*iter) != nullptr, "Sensor is null");
-    (*iter)->Update(_force);
+    // Update all the sensors in this container.
+    for (Sensor_V::iterator iter = this->sensors.begin();
+         iter != this->sensors.end(); ++iter)
+    {
+      GZ_ASSERT((*iter) != nullptr, "Sensor is null");
+      (*iter)->Update(_force);
+    }
+    return;
   }
+
+  physics::WorldPtr world = physics::get_world();
+  GZ_ASSERT(world != nullptr, "Pointer to World is null");
+  physics::PhysicsEnginePtr engine = world->Physics();
+
+  // Each group holds the sensors of one parent, which are updated in order.
+  // Sensors that are not due return early from Sensor::Update, and idle
+  // worker threads take the remaining groups while a slow sensor updates.
+  tbb::parallel_for(tbb::blocked_range<size_t>(0,
+      this->updateGroups.size() - 1, 1),
+      [&](const tbb::blocked_range<size_t> &_r)
+      {
+        // The worker threads may query the physics engine, like the
+        // RunLoop thread does.
+        if (engine)
+          engine->InitForThread();
+
+        for (size_t g = _r.begin(); g != _r.end(); ++g)
+        {
+          for (size_t i = this->updateGroups[g];
+               i < this->updateGroups[g+1]; ++i)
+          {
+            this->updateOrder[i]->Update(_force);
+          }
+        }
+      });
+}
+
+//////////////////////////////////////////////////
+void SensorManager::SensorContainer::UpdateGroups()
+{
+  this->updateOrder = this->sensors;
+  this->updateGroups.clear();
+  this->updateGroupsDirty = false;
+
+  std::stable_sort(this->updateOrder.begin(), this->updateOrder.end(),
+      [](const SensorPtr &_a, const SensorPtr &_b)
+      {
+        return _a->ParentId() < _b->ParentId();
+      });
+
+  for (size_t i = 0; i < this->updateOrder.size(); ++i)
+  {
+    GZ_ASSERT(this->updateOrder[i] != nullptr, "Sensor is null");
+    if (i == 0 || this->updateOrder[i]->ParentId() !=
+        this->updateOrder[i-1]->ParentId())
+    {
+      this->updateGroups.push_back(i);
+    }
+  }
+  this->updateGroups.push_back(this->updateOrder.size());
+}
+
+//////////////////////////////////////////////////
+void SensorManager::SensorContainer::SetParallel(const bool _enable)
+{
+  boost::recursive_mutex::scoped_lock lock(this->mutex);
+  this->parallel = _enable;
+  this->updateGroupsDirty = true;
+}
+
+//////////////////////////////////////////////////
+bool SensorManager::SensorContainer::Parallel() const
+{
+  boost::recursive_mutex::scoped_lock lock(this->mutex);
+  return this->parallel;
 }
 
 //////////////////////////////////////////////////
@@ -654,6 +770,7 @@ void SensorManager::SensorContainer::AddSensor(SensorPtr _sensor)
   {
     boost::recursive_mutex::scoped_lock lock(this->mutex);
     this->sensors.push_back(_sensor);
+    this->updateGroupsDirty = true;
   }
 
   // Tell the run loop that we have received a sensor
@@ -678,6 +795,8 @@ bool SensorManager::SensorContainer::RemoveSensor(const std::string &_name)
     {
       (*iter)->Fini();
       this->sensors.erase(iter);
+      this->updateOrder.clear();
+      this->updateGroupsDirty = true;
       removed = true;
       break;
     }
@@ -719,6 +838,8 @@ void SensorManager::SensorContainer::RemoveSensors()
   }
 
   this->sensors.clear();
+  this->updateOrder.clear();
+  this->updateGroupsDirty = true;
 }
 
 //////////////////////////////////////////////////
@@ -738,6 +859,16 @@ void SensorManager::ImageSensorContainer::Update(bool _force)
 
 
 
+/////////////////////////////////////////////////
+/// \brief Heap ordering of SimTimeEvents, the earliest event is the top.
+/// \param[in] _a First event.
+/// \param[in] _b Second event.
+/// \return True if _a is later than _b.
+static bool LaterSimTimeEvent(const SimTimeEvent &_a, const SimTimeEvent &_b)
+{
+  return _a.time > _b.time;
+}
+
 /////////////////////////////////////////////////
 SimTimeEventHandler::SimTimeEventHandler()
 {
@@ -748,13 +879,6 @@ SimTimeEventHandler::SimTimeEventHandler()
 /////////////////////////////////////////////////
 SimTimeEventHandler::~SimTimeEventHandler()
 {
-  // Cleanup the events.
-  for (std::list<SimTimeEvent*>::iterator iter = this->events.begin();
-       iter != this->events.end(); ++iter)
-  {
-    GZ_ASSERT(*iter != nullptr, "SimTimeEvent is null");
-    delete *iter;
-  }
   this->events.clear();
 }
 
@@ -766,14 +890,21 @@ void SimTimeEventHandler::AddRelativeEvent(const common::Time &_time,
 
   physics::WorldPtr world = physics::get_world();
   GZ_ASSERT(world != nullptr, "World pointer is null");
+  GZ_ASSERT(_var != nullptr, "SimTimeEvent condition is null");
 
   // Create the new event.
-  SimTimeEvent *event = new SimTimeEvent;
-  event->time = world->SimTime() + _time;
-  event->condition = _var;
+  SimTimeEvent event;
+  event.time = world->SimTime() + _time;
+  event.condition = _var;
+
+  // Make sure a batch of world steps doesn't run past the event.
+  world->AddStepBarrier(event.time);
 
-  // Add the event to the list.
+  // Add the event to the heap. The vector keeps its capacity, so once it
+  // has grown to the number of sensors no more memory is allocated.
   this->events.push_back(event);
+  std::push_heap(this->events.begin(), this->events.end(),
+      LaterSimTimeEvent);
 }
 
 /////////////////////////////////////////////////
@@ -782,24 +913,16 @@ void SimTimeEventHandler::OnUpdate(const common::UpdateInfo &_info)
   boost::mutex::scoped_lock timingLock(g_sensorTimingMutex);
   boost::mutex::scoped_lock lock(this->mutex);
 
-  // Iterate over all the events.
-  for (std::list<SimTimeEvent*>::iterator iter = this->events.begin();
-      iter != this->events.end();)
+  // Pop the events that have a time less than or equal to simulation
+  // time.
+  while (!this->events.empty() && this->events.front().time <= _info.simTime)
   {
-    GZ_ASSERT(*iter != nullptr, "SimTimeEvent is null");
+    // Notify the event by triggering its condition.
+    this->events.front().condition->notify_all();
 
-    // Find events that have a time less than or equal to simulation
-    // time.
-    if ((*iter)->time <= _info.simTime)
-    {
-      // Notify the event by triggering its condition.
-      (*iter)->condition->notify_all();
-
-      // Remove the event.
-      delete *iter;
-      this->events.erase(iter++);
-    }
-    else
-      ++iter;
+    // Remove the event.
+    std::pop_heap(this->events.begin(), this->events.end(),
+        LaterSimTimeEvent);
+    this->events.pop_back();
   }
 }
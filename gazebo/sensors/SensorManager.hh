@@ -77,8 +77,10 @@ namespace gazebo
       /// \brief Mutex to mantain thread safety.
       private: boost::mutex mutex;
 
-      /// \brief The list of events to handle.
-      private: std::list<SimTimeEvent*> events;
+      /// \brief The events to handle, kept as a binary heap with the
+      /// earliest event at the front, so updates with no event due only
+      /// look at the front.
+      private: std::vector<SimTimeEvent> events;
 
       /// \brief Connect to the World::UpdateBegin event.
       private: event::ConnectionPtr updateConnection;
@@ -173,6 +175,22 @@ namespace gazebo
       /// \brief Reset last update times in all sensors.
       public: void ResetLastUpdateTimes();
 
+      /// \brief Set whether the non-image sensors are updated in parallel.
+      /// Sensors attached to the same parent are updated in order by the
+      /// same task, and the tasks are run by the TBB scheduler, so a slow
+      /// sensor doesn't delay the other sensors of its container. Image
+      /// sensors are always updated serially, because they render in the
+      /// main thread. The default can be set with the
+      /// <gz:parallel_sensor_update> element of the world's physics.
+      /// \param[in] _enable True to update the sensors in parallel.
+      /// \sa Sensor::UpdateDuration
+      public: void SetParallelUpdate(const bool _enable);
+
+      /// \brief Get whether the non-image sensors are updated in parallel.
+      /// \return True if the sensors are updated in parallel.
+      /// \sa SetParallelUpdate
+      public: bool ParallelUpdate() const;
+
       /// \brief Add a new sensor to a sensor container.
       /// \param[in] _sensor Pointer to a sensor to add.
       private: void AddSensor(SensorPtr _sensor);
@@ -235,10 +253,24 @@ namespace gazebo
                  /// \brief Reset last update times in all sensors.
                  public: void ResetLastUpdateTimes();
 
+                 /// \brief Set whether the sensors are updated in
+                 /// parallel.
+                 /// \param[in] _enable True to update in parallel.
+                 public: void SetParallel(const bool _enable);
+
+                 /// \brief Get whether the sensors are updated in
+                 /// parallel.
+                 /// \return True if the sensors are updated in parallel.
+                 public: bool Parallel() const;
+
                  /// \brief A loop to update the sensor. Used by the
                  /// runThread.
                  private: void RunLoop();
 
+                 /// \brief Group the sensors by parent for parallel
+                 /// updates.
+                 private: void UpdateGroups();
+
                  /// \brief The set of sensors to maintain.
                  public: Sensor_V sensors;
 
@@ -258,6 +290,20 @@ namespace gazebo
                  /// \brief Condition used to block the RunLoop if no
                  /// sensors are present.
                  private: boost::condition_variable runCondition;
+
+                 /// \brief True to update the sensors in parallel.
+                 private: bool parallel = false;
+
+                 /// \brief Sensors sorted by parent, for parallel updates.
+                 private: Sensor_V updateOrder;
+
+                 /// \brief Index in updateOrder of the first sensor of each
+                 /// parent, followed by the number of sensors.
+                 private: std::vector<size_t> updateGroups;
+
+                 /// \brief True if the sensors changed since the groups
+                 /// were computed.
+                 private: bool updateGroupsDirty = true;
                };
       /// \endcond
 
@@ -283,6 +329,9 @@ namespace gazebo
       /// \brief True removes all sensors from all sensor containers.
       private: bool removeAllSensors;
 
+      /// \brief True if the non-image sensors are updated in parallel.
+      private: bool parallelUpdate = false;
+
       /// \brief Mutex used when adding and removing sensors.
       private: mutable boost::recursive_mutex mutex;
 
@@ -23,6 +23,7 @@
 #include "gazebo/rendering/RenderTypes.hh"
 
 #include "gazebo/common/Event.hh"
+#include "gazebo/common/NanoTime.hh"
 #include "gazebo/common/Time.hh"
 #include "gazebo/sensors/SensorTypes.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
@@ -46,7 +47,22 @@ namespace gazebo
       public: SensorCategory category;
 
       /// \brief Keep track how much the update has been delayed.
-      public: common::Time updateDelay;
+      public: common::NanoTime updateDelay;
+
+      /// \brief Wall clock time of the last update.
+      public: common::Time updateDuration;
+
+      /// \brief Longest wall clock time of an update.
+      public: common::Time maxUpdateDuration;
+
+      /// \brief Sum of the wall clock times of the updates.
+      public: common::Time totalUpdateDuration;
+
+      /// \brief Number of updates included in totalUpdateDuration.
+      public: uint64_t updateCount = 0;
+
+      /// \brief True to skip updates while nothing consumes the output.
+      public: bool lazyUpdate = false;
 
       /// \brief The sensors unique ID.
       public: uint32_t id;
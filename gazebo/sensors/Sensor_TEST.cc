@@ -207,6 +207,86 @@ TEST_F(Sensor_TEST, SetPose)
   EXPECT_EQ(sensor.Pose(), ignition::math::Pose3d(0, 1, 2, 3, 4, 5));
 }
 
+/////////////////////////////////////////////////
+/// \brief Test that sensors update in parallel and track update durations.
+TEST_F(Sensor_TEST, ParallelUpdate)
+{
+  Load("worlds/ray_test.world");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  sensors::SensorManager *mgr = sensors::SensorManager::Instance();
+  EXPECT_FALSE(mgr->ParallelUpdate());
+  mgr->SetParallelUpdate(true);
+  EXPECT_TRUE(mgr->ParallelUpdate());
+
+  sensors::SensorPtr imuSensor =
+    mgr->GetSensor("default::box_model::box_link::box_imu_sensor");
+  ASSERT_TRUE(imuSensor != nullptr);
+
+  common::Time lastUpdate = imuSensor->LastUpdateTime();
+
+  // Wait for the sensors to update
+  for (unsigned int i = 0; i < 10; ++i)
+    common::Time::MSleep(100);
+
+  EXPECT_GT(imuSensor->LastUpdateTime(), lastUpdate);
+  EXPECT_GE(imuSensor->MaxUpdateDuration(), imuSensor->MeanUpdateDuration());
+  EXPECT_GE(imuSensor->MaxUpdateDuration(), imuSensor->UpdateDuration());
+  EXPECT_GT(imuSensor->MaxUpdateDuration(), common::Time::Zero);
+
+  mgr->SetParallelUpdate(false);
+  EXPECT_FALSE(mgr->ParallelUpdate());
+}
+
+/////////////////////////////////////////////////
+TEST_F(Sensor_TEST, LazyUpdate)
+{
+  Load("worlds/ray_test.world");
+  sensors::SensorManager *mgr = sensors::SensorManager::Instance();
+
+  sensors::SensorPtr sensor = mgr->GetSensor("default::hokuyo::link::laser");
+  ASSERT_TRUE(sensor != nullptr);
+  sensors::SensorPtr imuSensor =
+    mgr->GetSensor("default::box_model::box_link::box_imu_sensor");
+  ASSERT_TRUE(imuSensor != nullptr);
+
+  // The imu can't tell its consumers, it is never skipped
+  EXPECT_TRUE(imuSensor->HasConsumers());
+  imuSensor->SetLazyUpdate(true);
+  EXPECT_TRUE(imuSensor->IsActive());
+  imuSensor->SetLazyUpdate(false);
+
+  EXPECT_FALSE(sensor->LazyUpdate());
+  EXPECT_TRUE(sensor->IsActive());
+  EXPECT_FALSE(sensor->HasConsumers());
+
+  // Nothing consumes the scans, the laser stops updating
+  sensor->SetLazyUpdate(true);
+  EXPECT_TRUE(sensor->LazyUpdate());
+  EXPECT_FALSE(sensor->IsActive());
+  common::Time::MSleep(200);
+  common::Time lastUpdate = sensor->LastUpdateTime();
+  common::Time::MSleep(500);
+  EXPECT_EQ(sensor->LastUpdateTime(), lastUpdate);
+
+  // A subscriber resumes the updates
+  g_hokuyoMsgCount = 0;
+  transport::NodePtr node = transport::NodePtr(new transport::Node());
+  node->Init();
+  transport::SubscriberPtr laserSub = node->Subscribe(
+      "~/hokuyo/link/laser/scan", &ReceiveHokuyoMsg);
+
+  for (unsigned int i = 0; i < 50 && g_hokuyoMsgCount == 0; ++i)
+    common::Time::MSleep(100);
+  EXPECT_TRUE(sensor->HasConsumers());
+  EXPECT_TRUE(sensor->IsActive());
+  EXPECT_GT(g_hokuyoMsgCount, 0u);
+  EXPECT_GT(sensor->LastUpdateTime(), lastUpdate);
+
+  sensor->SetLazyUpdate(false);
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -14,6 +14,8 @@
  * limitations under the License.
  *
 */
+#include <cmath>
+#include <sstream>
 #include <boost/algorithm/string.hpp>
 
 #include <ignition/math/Vector3.hh>
@@ -21,6 +23,7 @@
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/SurfaceParams.hh"
 #include "gazebo/physics/MeshShape.hh"
+#include "gazebo/physics/MultiRayShape.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
 #include "gazebo/physics/ContactManager.hh"
 #include "gazebo/physics/Collision.hh"
@@ -50,11 +53,29 @@ SonarSensor::SonarSensor()
 //////////////////////////////////////////////////
 SonarSensor::~SonarSensor()
 {
-  this->dataPtr->sonarCollision->Fini();
-  this->dataPtr->sonarCollision.reset();
+  if (this->dataPtr->sonarCollision)
+  {
+    this->dataPtr->sonarCollision->Fini();
+    this->dataPtr->sonarCollision.reset();
+  }
+
+  if (this->dataPtr->sonarShape)
+  {
+    this->dataPtr->sonarShape->Fini();
+    this->dataPtr->sonarShape.reset();
+  }
 
-  this->dataPtr->sonarShape->Fini();
-  this->dataPtr->sonarShape.reset();
+  if (this->dataPtr->rayCollision)
+  {
+    this->dataPtr->rayCollision->Fini();
+    this->dataPtr->rayCollision.reset();
+  }
+
+  if (this->dataPtr->rayShape)
+  {
+    this->dataPtr->rayShape->Fini();
+    this->dataPtr->rayShape.reset();
+  }
 }
 
 //////////////////////////////////////////////////
@@ -121,6 +142,40 @@ void SonarSensor::Load(const std::string &_worldName)
   GZ_ASSERT(physicsEngine != nullptr,
       "Unable to get a pointer to the physics engine");
 
+  // Initialize the message that will be published on this->dataPtr->sonarPub.
+  this->dataPtr->sonarMsg.mutable_sonar()->set_geometry(geometry);
+  this->dataPtr->sonarMsg.mutable_sonar()->set_range_min(
+      this->dataPtr->rangeMin);
+  this->dataPtr->sonarMsg.mutable_sonar()->set_range_max(
+      this->dataPtr->rangeMax);
+  this->dataPtr->sonarMsg.mutable_sonar()->set_radius(
+      this->dataPtr->radius);
+
+  ignition::math::Pose3d referencePose =
+    this->pose + this->dataPtr->parentEntity->WorldPose();
+  msgs::Set(this->dataPtr->sonarMsg.mutable_sonar()->mutable_world_pose(),
+      referencePose);
+  this->dataPtr->sonarMsg.mutable_sonar()->set_range(0);
+
+  // Advertise the sensor's topic on which we will output range data.
+  this->dataPtr->sonarPub = this->node->Advertise<msgs::SonarStamped>(
+      this->Topic());
+
+  unsigned int rays = 0;
+  if (sonarElem->HasElement("gz:rays"))
+    rays = sonarElem->Get<unsigned int>("gz:rays");
+  if (rays > 0 && geometry == "sphere")
+  {
+    gzwarn << "Sonar [" << this->Name() << "] can't sample a sphere with "
+      << "rays, it collides a sphere mesh.\n";
+    rays = 0;
+  }
+  if (rays > 0)
+  {
+    this->LoadRayFan(rays);
+    return;
+  }
+
   /// \todo: Change the collision shape to a cone. Needs a collision shape
   /// within ODE. Or, switch out the collision engine.
   this->dataPtr->sonarCollision = physicsEngine->CreateCollision("mesh",
@@ -200,25 +255,87 @@ void SonarSensor::Load(const std::string &_worldName)
   // Subscribe to the contact topic
   this->dataPtr->contactSub = this->node->Subscribe(topic,
       &SonarSensor::OnContacts, this);
+}
 
-  // Advertise the sensor's topic on which we will output range data.
-  this->dataPtr->sonarPub = this->node->Advertise<msgs::SonarStamped>(
-      this->Topic());
+//////////////////////////////////////////////////
+void SonarSensor::LoadRayFan(const unsigned int _count)
+{
+  const double range = this->dataPtr->rangeMax - this->dataPtr->rangeMin;
+
+  std::ostringstream raySdf;
+  raySdf << "<sdf version='" << SDF_VERSION << "'>"
+    << "<sensor name='" << this->Name() << "_rays' type='ray'>"
+    << "  <ray>"
+    << "    <scan><horizontal>"
+    << "      <samples>" << _count << "</samples>"
+    << "      <min_angle>0</min_angle><max_angle>0</max_angle>"
+    << "    </horizontal></scan>"
+    << "    <range>"
+    << "      <min>" << this->dataPtr->rangeMin << "</min>"
+    << "      <max>" << this->dataPtr->rangeMax << "</max>"
+    << "    </range>"
+    << "  </ray>"
+    << "</sensor>"
+    << "</sdf>";
+  sdf::ElementPtr rayElem(new sdf::Element);
+  sdf::initFile("sensor.sdf", rayElem);
+  sdf::readString(raySdf.str(), rayElem);
+
+  this->dataPtr->rayCollision = this->world->Physics()->CreateCollision(
+      "multiray", this->ParentName());
+  GZ_ASSERT(this->dataPtr->rayCollision != nullptr,
+      "Unable to create a multiray collision using the physics engine.");
+
+  this->dataPtr->rayCollision->SetName(this->ScopedName() + "sensor_rays");
+  this->dataPtr->rayCollision->SetRelativePose(this->pose);
+  this->dataPtr->rayCollision->SetInitialRelativePose(this->pose);
+
+  this->dataPtr->rayShape =
+    boost::dynamic_pointer_cast<physics::MultiRayShape>(
+        this->dataPtr->rayCollision->GetShape());
+  GZ_ASSERT(this->dataPtr->rayShape != nullptr,
+      "Unable to get the ray shape from the multi-ray collision.");
+
+  this->dataPtr->rayShape->Load(rayElem);
+  this->dataPtr->rayShape->Init();
+
+  // Spread the rays evenly over the base of the cone, which points along
+  // -z, on a sunflower spiral with the first ray close to the axis.
+  const double tanHalfAngle = range > 0 ? this->dataPtr->radius / range : 0;
+  const double goldenAngle = IGN_PI * (3.0 - std::sqrt(5.0));
+  this->dataPtr->rayDirections.resize(_count);
+  for (unsigned int i = 0; i < _count; ++i)
+  {
+    const double r = tanHalfAngle * std::sqrt((i + 0.5) / _count);
+    const double theta = i * goldenAngle;
+    ignition::math::Vector3d dir(
+        r * std::cos(theta), r * std::sin(theta), -1.0);
+    dir.Normalize();
+    this->dataPtr->rayDirections[i] = dir;
+
+    const ignition::math::Vector3d axis = this->pose.Rot().RotateVector(dir);
+    this->dataPtr->rayShape->SetRay(i,
+        this->pose.Pos() + axis * this->dataPtr->rangeMin,
+        this->pose.Pos() + axis * this->dataPtr->rangeMax);
+  }
+}
 
-  // Initialize the message that will be published on this->dataPtr->sonarPub.
-  this->dataPtr->sonarMsg.mutable_sonar()->set_geometry(geometry);
-  this->dataPtr->sonarMsg.mutable_sonar()->set_range_min(
-      this->dataPtr->rangeMin);
-  this->dataPtr->sonarMsg.mutable_sonar()->set_range_max(
-      this->dataPtr->rangeMax);
-  this->dataPtr->sonarMsg.mutable_sonar()->set_radius(
-      this->dataPtr->radius);
+//////////////////////////////////////////////////
+void SonarSensor::UpdateRayFan()
+{
+  auto sonar = this->dataPtr->sonarMsg.mutable_sonar();
+  sonar->set_range(this->dataPtr->rangeMax);
 
-  ignition::math::Pose3d referencePose =
-    this->pose + this->dataPtr->parentEntity->WorldPose();
-  msgs::Set(this->dataPtr->sonarMsg.mutable_sonar()->mutable_world_pose(),
-      referencePose);
-  this->dataPtr->sonarMsg.mutable_sonar()->set_range(0);
+  for (unsigned int i = 0; i < this->dataPtr->rayDirections.size(); ++i)
+  {
+    const double len = this->dataPtr->rayShape->GetRange(i);
+    if (len < sonar->range())
+    {
+      sonar->set_range(len);
+      msgs::Set(sonar->mutable_contact(),
+          this->dataPtr->rayDirections[i] * len);
+    }
+  }
 }
 
 //////////////////////////////////////////////////
@@ -236,7 +353,7 @@ void SonarSensor::Init()
 //////////////////////////////////////////////////
 void SonarSensor::Fini()
 {
-  if (this->world && this->world->Running())
+  if (this->world && this->world->Running() && this->dataPtr->sonarCollision)
   {
     physics::ContactManager *mgr = this->world->Physics()->GetContactManager();
     mgr->RemoveFilter(this->dataPtr->sonarCollision->GetScopedName());
@@ -281,6 +398,10 @@ double SonarSensor::Range()
 //////////////////////////////////////////////////
 bool SonarSensor::UpdateImpl(const bool /*_force*/)
 {
+  // Cast the rays of the fan before locking, like the ray sensor
+  if (this->dataPtr->rayShape)
+    this->dataPtr->rayShape->Update();
+
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
   this->lastMeasurementTime = this->world->SimTime();
@@ -292,6 +413,15 @@ bool SonarSensor::UpdateImpl(const bool /*_force*/)
   msgs::Set(this->dataPtr->sonarMsg.mutable_sonar()->mutable_world_pose(),
       referencePose);
 
+  if (this->dataPtr->rayShape)
+  {
+    this->UpdateRayFan();
+    this->dataPtr->update(this->dataPtr->sonarMsg);
+    if (this->dataPtr->sonarPub)
+      this->dataPtr->sonarPub->Publish(this->dataPtr->sonarMsg);
+    return true;
+  }
+
   ignition::math::Vector3d pos;
 
   // A 5-step hysteresis window was chosen to reduce range value from
@@ -38,7 +38,10 @@ namespace gazebo
     /// \class SonarSensor SonarSensor.hh sensors/sensors.hh
     /// \brief Sensor with sonar cone.
     ///
-    /// This sensor uses a cone .
+    /// This sensor uses a cone . The cone is a mesh collision whose
+    /// contacts give the range, unless <gz:rays> sets a number of rays in
+    /// the <sonar> element, in which case the cone is sampled with a fan
+    /// of rays that stays out of the contact pipeline.
     class GZ_SENSORS_VISIBLE SonarSensor: public Sensor
     {
       /// \brief Constructor
@@ -101,6 +104,14 @@ namespace gazebo
       /// \brief Callback for contact messages from the physics engine.
       private: void OnContacts(ConstContactsPtr &_msg);
 
+      /// \brief Sample the cone with rays instead of colliding a cone mesh.
+      /// \param[in] _count Number of rays.
+      private: void LoadRayFan(const unsigned int _count);
+
+      /// \brief Set the range from the rays of the fan. The rays must
+      /// have been updated, and the mutex locked.
+      private: void UpdateRayFan();
+
       /// \internal
       /// \brief Internal data pointer
       private: std::unique_ptr<SonarSensorPrivate> dataPtr;
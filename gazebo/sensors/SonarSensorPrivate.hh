@@ -19,6 +19,7 @@
 
 #include <list>
 #include <mutex>
+#include <vector>
 #include <ignition/math/Pose3.hh>
 
 #include "gazebo/msgs/msgs.hh"
@@ -45,6 +46,16 @@ namespace gazebo
       /// \brief Shape used to generate contact information.
       public: physics::MeshShapePtr sonarShape;
 
+      /// \brief Collision that holds the rays sampling the cone, when the
+      /// sonar is a ray fan.
+      public: physics::CollisionPtr rayCollision;
+
+      /// \brief Rays sampling the cone, null unless the sonar is a ray fan.
+      public: physics::MultiRayShapePtr rayShape;
+
+      /// \brief Directions of the rays of the fan, in the sensor frame.
+      public: std::vector<ignition::math::Vector3d> rayDirections;
+
       /// \brief Parent entity of this sensor
       public: physics::EntityPtr parentEntity;
 
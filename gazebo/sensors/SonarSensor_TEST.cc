@@ -16,6 +16,7 @@
 */
 
 #include <gtest/gtest.h>
+#include <sstream>
 #include "gazebo/test/ServerFixture.hh"
 #include "gazebo/test/helper_physics_generator.hh"
 
@@ -39,6 +40,10 @@ class SonarSensor_TEST : public ServerFixture,
   /// \brief Test sonar with just a ground plane.
   /// \param[in] _physicsEngine Name of physics engine to use.
   public: void GroundPlane(const std::string &_physicsEngine);
+
+  /// \brief Test a sonar sampled with a fan of rays.
+  /// \param[in] _physicsEngine Name of physics engine to use.
+  public: void RayFan(const std::string &_physicsEngine);
 };
 
 static std::string sonarSensorString =
@@ -191,6 +196,65 @@ void SonarSensor_TEST::GroundPlane(const std::string &_physicsEngine)
   EXPECT_NEAR(sonar->Range(), 2.0, 0.01);
 }
 
+/////////////////////////////////////////////////
+void SonarSensor_TEST::RayFan(const std::string &_physicsEngine)
+{
+  if (_physicsEngine != "ode")
+  {
+    gzerr << "Sonar ray fans are only tested with ODE" << std::endl;
+    return;
+  }
+
+  Load("worlds/empty.world", false, _physicsEngine);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  std::ostringstream modelStr;
+  modelStr << "<sdf version='" << SDF_VERSION << "'>"
+    << "<model name ='sonar_model'>"
+    << "<static>true</static>"
+    << "<pose>0 0 1 0 0 0</pose>"
+    << "<link name ='body'>"
+    << "  <sensor name ='sonar_rays' type ='sonar'>"
+    << "    <sonar>"
+    << "      <min>0</min>"
+    << "      <max>2</max>"
+    << "      <radius>0.2</radius>"
+    << "      <gz:rays>16</gz:rays>"
+    << "    </sonar>"
+    << "    <always_on>true</always_on>"
+    << "  </sensor>"
+    << "</link>"
+    << "</model>"
+    << "</sdf>";
+  SpawnSDF(modelStr.str());
+  WaitUntilEntitySpawn("sonar_model", 100, 100);
+  WaitUntilSensorSpawn("sonar_rays", 100, 100);
+
+  sensors::SonarSensorPtr sonar =
+    std::dynamic_pointer_cast<sensors::SonarSensor>(
+        sensors::get_sensor("sonar_rays"));
+  ASSERT_TRUE(sonar != nullptr);
+
+  physics::ModelPtr model = world->ModelByName("sonar_model");
+  ASSERT_TRUE(model != nullptr);
+
+  // The rays see the ground plane, the closest one along the axis
+  sonar->Update(true);
+  EXPECT_NEAR(sonar->Range(), 1.0, 0.01);
+
+  // Rotated away from the ground plane, every ray misses
+  model->SetWorldPose(ignition::math::Pose3d(0, 0, 1, 0, 1.5707, 0));
+  sonar->Update(true);
+  EXPECT_NEAR(sonar->Range(), 2.0, 0.01);
+}
+
+TEST_P(SonarSensor_TEST, RayFan)
+{
+  std::string physics = std::get<0>(GetParam());
+  RayFan(physics);
+}
+
 TEST_P(SonarSensor_TEST, CreateSonar)
 {
   std::string physics = std::get<0>(GetParam());
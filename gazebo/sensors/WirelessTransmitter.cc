@@ -14,6 +14,9 @@
  * limitations under the License.
  *
 */
+#include <cmath>
+
+#include <ignition/math/AxisAlignedBox.hh>
 #include <ignition/math/Rand.hh>
 
 #include "gazebo/msgs/msgs.hh"
@@ -36,6 +39,11 @@ const double WirelessTransmitterPrivate::NObstacle = 12.0;
 const double WirelessTransmitterPrivate::ModelStdDev = 6.0;
 const double WirelessTransmitterPrivate::Step = 1.0;
 const double WirelessTransmitterPrivate::MaxRadius = 10.0;
+const double WirelessTransmitterPrivate::CacheResolution = 0.01;
+const size_t WirelessTransmitterPrivate::CacheMaxCells = 10000;
+
+/// \brief Models closer than this to their cached pose have not moved.
+static const double kCachePoseTolerance = 1e-3;
 
 /////////////////////////////////////////////////
 WirelessTransmitter::WirelessTransmitter()
@@ -167,12 +175,56 @@ double WirelessTransmitter::SignalStrength(
   // Compute the value of n depending on the obstacles between Tx and Rx
   double n = WirelessTransmitterPrivate::NEmpty;
 
-  // Looking for obstacles between start and end points
-  this->dataPtr->testRay->SetPoints(start, end);
-  this->dataPtr->testRay->GetIntersection(dist, entityName);
+  // The cached obstacle tests are relative to the transmitter position
+  if (this->dataPtr->cachePos.Distance(start) > kCachePoseTolerance ||
+      this->dataPtr->propagationCache.size() >=
+      WirelessTransmitterPrivate::CacheMaxCells)
+  {
+    this->dataPtr->propagationCache.clear();
+    this->dataPtr->cachePos = start;
+  }
+
+  // Models that could block the ray
+  std::vector<std::pair<uint32_t, ignition::math::Pose3d>> nearModels;
+  for (auto const &model : this->world->ModelsInBox(
+        ignition::math::AxisAlignedBox(start, end)))
+  {
+    nearModels.push_back(std::make_pair(model->GetId(), model->WorldPose()));
+  }
+
+  const double res = WirelessTransmitterPrivate::CacheResolution;
+  auto key = std::make_tuple(
+      static_cast<int64_t>(std::floor(end.X() / res)),
+      static_cast<int64_t>(std::floor(end.Y() / res)),
+      static_cast<int64_t>(std::floor(end.Z() / res)));
+
+  // Reuse the last obstacle test towards this point if none of the models
+  // near the ray moved, appeared or disappeared
+  WirelessTransmitterPrivate::PropagationCell &cell =
+    this->dataPtr->propagationCache[key];
+  bool valid = cell.tested && cell.models.size() == nearModels.size();
+  for (size_t i = 0; valid && i < nearModels.size(); ++i)
+  {
+    valid = cell.models[i].first == nearModels[i].first &&
+        cell.models[i].second.Pos().Distance(nearModels[i].second.Pos()) <=
+        kCachePoseTolerance &&
+        cell.models[i].second.Rot().Equal(nearModels[i].second.Rot(),
+            kCachePoseTolerance);
+  }
+
+  if (!valid)
+  {
+    // Looking for obstacles between start and end points
+    this->dataPtr->testRay->SetPoints(start, end);
+    this->dataPtr->testRay->GetIntersection(dist, entityName);
+
+    // ToDo: The ray intersects with my own collision model. Fix it.
+    cell.tested = true;
+    cell.obstructed = entityName != "";
+    cell.models = nearModels;
+  }
 
-  // ToDo: The ray intersects with my own collision model. Fix it.
-  if (entityName != "")
+  if (cell.obstructed)
   {
     n = WirelessTransmitterPrivate::NObstacle;
   }
@@ -17,7 +17,13 @@
 #ifndef _GAZEBO_SENSORS_WIRELESSTRANSMITTER_PRIVATE_HH_
 #define _GAZEBO_SENSORS_WIRELESSTRANSMITTER_PRIVATE_HH_
 
+#include <map>
 #include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
 #include "gazebo/physics/PhysicsTypes.hh"
 
 namespace gazebo
@@ -59,6 +65,35 @@ namespace gazebo
 
       // \brief Ray used to test for collisions when placing entities
       public: physics::RayShapePtr testRay;
+
+      /// \brief Result of the obstacle test towards a receiver point.
+      public: class PropagationCell
+      {
+        /// \brief True once the ray to the point has been cast.
+        public: bool tested = false;
+
+        /// \brief True if the ray to the point hit an obstacle.
+        public: bool obstructed = false;
+
+        /// \brief Ids and poses of the models near the ray when it was
+        /// cast. The result is reused while they stay the same.
+        public: std::vector<std::pair<uint32_t, ignition::math::Pose3d>>
+                models;
+      };
+
+      /// \brief Size of the cells the receiver points are keyed by.
+      public: static const double CacheResolution;
+
+      /// \brief The cache is cleared when it holds more cells.
+      public: static const size_t CacheMaxCells;
+
+      /// \brief Obstacle tests by receiver cell, in the world frame.
+      /// Cleared when the transmitter moves.
+      public: std::map<std::tuple<int64_t, int64_t, int64_t>,
+              PropagationCell> propagationCache;
+
+      /// \brief Position of the transmitter the cache was filled at.
+      public: ignition::math::Vector3d cachePos;
     };
   }
 }
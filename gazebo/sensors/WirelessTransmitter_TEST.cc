@@ -24,6 +24,7 @@ class WirelessTransmitter_TEST : public ServerFixture
     public: WirelessTransmitter_TEST();
     public: void TestCreateWirelessTransmitter();
     public: void TestSignalStrength();
+    public: void TestSignalStrengthObstacle();
     public: void TestUpdateImpl();
     public: void TestUpdateImplNoVisual();
     public: void TestInvalidFreq();
@@ -159,6 +160,40 @@ void WirelessTransmitter_TEST::TestSignalStrength()
   EXPECT_NEAR(signStrengthAvg, -62.0, this->tx->ModelStdDev());
 }
 
+/////////////////////////////////////////////////
+/// \brief Test that an obstacle added after the signal strength was
+/// computed towards a point is taken into account
+void WirelessTransmitter_TEST::TestSignalStrengthObstacle()
+{
+  int samples = 100;
+  ignition::math::Pose3d rxPose(
+      ignition::math::Vector3d(3.0, 0.0, 0.055),
+      ignition::math::Quaterniond(0, 0, 0));
+
+  auto average = [&]()
+  {
+    double avg = 0.0;
+    for (int i = 0; i < samples; ++i)
+    {
+      this->tx->Update(true);
+      avg += this->tx->SignalStrength(rxPose, tx->Gain());
+    }
+    return avg / samples;
+  };
+
+  double freeAvg = average();
+
+  // A wall between the transmitter and the point
+  SpawnBox("wall", ignition::math::Vector3d(0.2, 4, 1),
+      ignition::math::Vector3d(1.5, 0, 0.5),
+      ignition::math::Vector3d::Zero, true);
+
+  double wallAvg = average();
+
+  // The obstacle doubles the path loss exponent, about 28 dB at 3 m
+  EXPECT_LT(wallAvg, freeAvg - 20.0);
+}
+
 /////////////////////////////////////////////////
 /// \brief Callback executed for every propagation grid message received
 void WirelessTransmitter_TEST::TxMsg(const ConstPropagationGridPtr &_msg)
@@ -254,6 +289,12 @@ TEST_F(WirelessTransmitter_TEST, TestSignalStrength)
   TestSignalStrength();
 }
 
+/////////////////////////////////////////////////
+TEST_F(WirelessTransmitter_TEST, TestSignalStrengthObstacle)
+{
+  TestSignalStrengthObstacle();
+}
+
 /////////////////////////////////////////////////
 TEST_F(WirelessTransmitter_TEST, TestUpdateImpl)
 {
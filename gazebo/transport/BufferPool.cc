@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <array>
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "gazebo/common/MemoryTracker.hh"
+#include "gazebo/transport/BufferPool.hh"
+
+using namespace gazebo;
+using namespace transport;
+
+namespace
+{
+  /// \brief Smallest size class, as a power of two (256 bytes).
+  const unsigned int kMinClass = 8;
+
+  /// \brief Largest size class, as a power of two (16 MiB). Larger
+  /// buffers are not pooled.
+  const unsigned int kMaxClass = 24;
+
+  /// \brief Largest number of free buffers kept per size class.
+  const std::size_t kMaxFreeBuffers = 16;
+
+  /// \brief Get the smallest size class that holds a size.
+  /// \param[in] _size The size.
+  /// \return Size class, as a power of two.
+  unsigned int CeilClass(const std::size_t _size)
+  {
+    unsigned int c = kMinClass;
+    while (c <= kMaxClass && (std::size_t(1) << c) < _size)
+      ++c;
+    return c;
+  }
+
+  /// \brief Get the largest size class that fits in a capacity.
+  /// \param[in] _capacity The capacity.
+  /// \return Size class, as a power of two, 0 if the capacity is outside
+  /// of the pooled classes.
+  unsigned int FloorClass(const std::size_t _capacity)
+  {
+    if (_capacity < (std::size_t(1) << kMinClass) ||
+        _capacity >= (std::size_t(1) << (kMaxClass + 1)))
+    {
+      return 0;
+    }
+
+    unsigned int c = kMinClass;
+    while (c < kMaxClass && (std::size_t(1) << (c + 1)) <= _capacity)
+      ++c;
+    return c;
+  }
+}
+
+namespace gazebo
+{
+  namespace transport
+  {
+    /// \internal
+    /// \brief Private data for the BufferPool class
+    class BufferPoolPrivate
+    {
+      /// \brief Protects the free lists and counters.
+      public: std::mutex mutex;
+
+      /// \brief Free buffers by size class. The buffers of a class can
+      /// hold 2^class bytes without reallocating.
+      public: std::array<std::vector<std::string>, kMaxClass + 1> free;
+
+      /// \brief Number of allocated buffers.
+      public: uint64_t allocations = 0;
+
+      /// \brief Number of reused buffers.
+      public: uint64_t reuses = 0;
+
+      /// \brief Bytes of the free buffers, in the "transport" subsystem of
+      /// the common::MemoryTracker.
+      public: std::atomic<int64_t> *memory = nullptr;
+
+      /// \brief Id of the evictor of the free buffers.
+      public: int evictor = -1;
+
+      /// \brief Drop free buffers, the largest first.
+      /// \param[in] _bytes Number of bytes to free.
+      public: void Evict(const uint64_t _bytes)
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        uint64_t freed = 0;
+        for (unsigned int c = kMaxClass; c >= kMinClass && freed < _bytes;
+             --c)
+        {
+          while (!this->free[c].empty() && freed < _bytes)
+          {
+            freed += this->free[c].back().capacity();
+            this->free[c].pop_back();
+          }
+        }
+        *this->memory -= static_cast<int64_t>(freed);
+      }
+    };
+  }
+}
+
+//////////////////////////////////////////////////
+BufferPool::BufferPool()
+  : dataPtr(new BufferPoolPrivate)
+{
+  // The tracker is created first, so it outlives the pool
+  common::MemoryTracker *tracker = common::MemoryTracker::Instance();
+  this->dataPtr->memory = &tracker->Counter("transport");
+  BufferPoolPrivate *data = this->dataPtr.get();
+  this->dataPtr->evictor = tracker->AddEvictor("transport",
+      [data](const uint64_t _bytes)
+      {
+        data->Evict(_bytes);
+      });
+}
+
+//////////////////////////////////////////////////
+BufferPool::~BufferPool()
+{
+  common::MemoryTracker::Instance()->RemoveEvictor(this->dataPtr->evictor);
+  this->dataPtr->Evict(std::numeric_limits<uint64_t>::max());
+}
+
+//////////////////////////////////////////////////
+std::string BufferPool::Acquire(const std::size_t _size)
+{
+  std::string buffer;
+  const unsigned int c = CeilClass(_size);
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    if (c <= kMaxClass && !this->dataPtr->free[c].empty())
+    {
+      buffer = std::move(this->dataPtr->free[c].back());
+      this->dataPtr->free[c].pop_back();
+      *this->dataPtr->memory -= static_cast<int64_t>(buffer.capacity());
+      ++this->dataPtr->reuses;
+    }
+    else
+      ++this->dataPtr->allocations;
+  }
+
+  // Allocate the whole class, so the buffer can be reused for any size in
+  // it
+  if (c <= kMaxClass && buffer.capacity() < (std::size_t(1) << c))
+    buffer.reserve(std::size_t(1) << c);
+
+  buffer.resize(_size);
+  return buffer;
+}
+
+//////////////////////////////////////////////////
+void BufferPool::Release(std::string _buffer)
+{
+  const unsigned int c = FloorClass(_buffer.capacity());
+  if (c == 0)
+    return;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (this->dataPtr->free[c].size() < kMaxFreeBuffers)
+  {
+    *this->dataPtr->memory += static_cast<int64_t>(_buffer.capacity());
+    this->dataPtr->free[c].push_back(std::move(_buffer));
+  }
+}
+
+//////////////////////////////////////////////////
+uint64_t BufferPool::AllocationCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->allocations;
+}
+
+//////////////////////////////////////////////////
+uint64_t BufferPool::ReuseCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->reuses;
+}
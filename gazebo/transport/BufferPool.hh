@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_TRANSPORT_BUFFERPOOL_HH_
+#define GAZEBO_TRANSPORT_BUFFERPOOL_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "gazebo/common/SingletonT.hh"
+#include "gazebo/util/system.hh"
+
+GZ_SINGLETON_DECLARE(GZ_TRANSPORT_VISIBLE, gazebo, transport, BufferPool)
+
+namespace gazebo
+{
+  namespace transport
+  {
+    // Forward declare private data class.
+    class BufferPoolPrivate;
+
+    /// \addtogroup gazebo_transport
+    /// \{
+
+    /// \class BufferPool BufferPool.hh transport/transport.hh
+    /// \brief Pool of the buffers messages are read into.
+    /// Buffers are kept by size class, in powers of two, so that a
+    /// connection reading messages of similar sizes reuses the same
+    /// allocations instead of allocating a buffer for each message. The
+    /// free buffers count against the "transport" budget of the
+    /// common::MemoryTracker, over which they are dropped.
+    class GZ_TRANSPORT_VISIBLE BufferPool : public SingletonT<BufferPool>
+    {
+      /// \brief Constructor.
+      private: BufferPool();
+
+      /// \brief Destructor.
+      private: virtual ~BufferPool();
+
+      /// \brief Get a buffer.
+      /// \param[in] _size Size of the buffer.
+      /// \return A buffer of _size bytes, whose content is unspecified.
+      public: std::string Acquire(const std::size_t _size);
+
+      /// \brief Return a buffer to the pool, once its content is no
+      /// longer needed.
+      /// \param[in] _buffer The buffer.
+      public: void Release(std::string _buffer);
+
+      /// \brief Get the number of buffers that were allocated because the
+      /// pool had none of the requested size.
+      /// \return Number of allocations.
+      public: uint64_t AllocationCount() const;
+
+      /// \brief Get the number of buffers that were reused.
+      /// \return Number of reused buffers.
+      public: uint64_t ReuseCount() const;
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<BufferPoolPrivate> dataPtr;
+
+      // Singleton implementation
+      private: friend class SingletonT<BufferPool>;
+    };
+    /// \}
+  }
+}
+#endif
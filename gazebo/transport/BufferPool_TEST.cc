@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <string>
+
+#include "gazebo/common/MemoryTracker.hh"
+#include "gazebo/transport/BufferPool.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class BufferPool : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(BufferPool, Reuse)
+{
+  transport::BufferPool *pool = transport::BufferPool::Instance();
+  const uint64_t allocations = pool->AllocationCount();
+  const uint64_t reuses = pool->ReuseCount();
+
+  std::string buffer = pool->Acquire(1000);
+  EXPECT_EQ(1000u, buffer.size());
+  EXPECT_GE(buffer.capacity(), 1024u);
+  EXPECT_EQ(allocations + 1, pool->AllocationCount());
+  const char *data = buffer.data();
+  pool->Release(std::move(buffer));
+
+  // Sizes of the same class reuse the buffer
+  buffer = pool->Acquire(600);
+  EXPECT_EQ(600u, buffer.size());
+  EXPECT_EQ(data, buffer.data());
+  EXPECT_EQ(allocations + 1, pool->AllocationCount());
+  EXPECT_EQ(reuses + 1, pool->ReuseCount());
+  pool->Release(std::move(buffer));
+
+  // A larger class doesn't
+  buffer = pool->Acquire(5000);
+  EXPECT_EQ(5000u, buffer.size());
+  EXPECT_EQ(allocations + 2, pool->AllocationCount());
+  pool->Release(std::move(buffer));
+}
+
+/////////////////////////////////////////////////
+TEST_F(BufferPool, Large)
+{
+  transport::BufferPool *pool = transport::BufferPool::Instance();
+  const uint64_t allocations = pool->AllocationCount();
+
+  // Buffers larger than the largest class aren't kept
+  std::string buffer = pool->Acquire(40 << 20);
+  EXPECT_EQ(40u << 20, buffer.size());
+  pool->Release(std::move(buffer));
+
+  buffer = pool->Acquire(40 << 20);
+  EXPECT_EQ(allocations + 2, pool->AllocationCount());
+  pool->Release(std::move(buffer));
+}
+
+/////////////////////////////////////////////////
+TEST_F(BufferPool, Budget)
+{
+  transport::BufferPool *pool = transport::BufferPool::Instance();
+  common::MemoryTracker *tracker = common::MemoryTracker::Instance();
+
+  // Free buffers count against the transport
+  const uint64_t before = tracker->Bytes("transport");
+  std::string buffer = pool->Acquire(3000);
+  const uint64_t capacity = buffer.capacity();
+  pool->Release(std::move(buffer));
+  EXPECT_EQ(before + capacity, tracker->Bytes("transport"));
+
+  // Over budget, the free buffers are dropped
+  tracker->SetBudget("transport", 1);
+  tracker->Enforce();
+  EXPECT_LE(tracker->Bytes("transport"), 1u);
+  tracker->SetBudget("transport", 0);
+
+  const uint64_t allocations = pool->AllocationCount();
+  buffer = pool->Acquire(3000);
+  EXPECT_EQ(allocations + 1, pool->AllocationCount());
+  pool->Release(std::move(buffer));
+}
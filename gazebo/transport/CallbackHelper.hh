@@ -21,6 +21,7 @@
 #include <boost/function.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <memory>
 #include <vector>
 #include <string>
 #include <mutex>
@@ -64,6 +65,21 @@ namespace gazebo
       public: virtual bool HandleData(const std::string &_newdata,
                   boost::function<void(uint32_t)> _cb, uint32_t _id) = 0;
 
+      /// \brief Process new incoming data, shared with other callbacks.
+      /// The default implementation calls HandleData. Callbacks that keep
+      /// the data after returning can keep the buffer instead of a copy.
+      /// \param[in] _newdata Incoming data to be processed, not modified.
+      /// \return true if successfully processed; false otherwise
+      /// \param[in] _cb If non-null, callback to be invoked which signals
+      /// that transmission is complete.
+      /// \param[in] _id ID associated with the message data.
+      public: virtual bool HandleSharedData(
+                  const std::shared_ptr<const std::string> &_newdata,
+                  boost::function<void(uint32_t)> _cb, uint32_t _id)
+              {
+                return this->HandleData(*_newdata, _cb, _id);
+              }
+
       /// \brief Process new incoming message
       /// \param[in] _newMsg Incoming message to be processed
       /// \return true if successfully processed; false otherwise
@@ -156,7 +172,21 @@ namespace gazebo
       public: virtual bool HandleMessage(MessagePtr _newMsg)
               {
                 this->SetLatching(false);
-                this->callback(boost::dynamic_pointer_cast<M>(_newMsg));
+
+                // Messages of the subscribed type are passed as is, without
+                // a copy. Others, such as a message published with a
+                // different but compatible type, are converted.
+                boost::shared_ptr<M const> m =
+                    boost::dynamic_pointer_cast<M const>(_newMsg);
+                if (!m)
+                {
+                  std::string data;
+                  _newMsg->SerializeToString(&data);
+                  boost::shared_ptr<M> converted(new M);
+                  converted->ParseFromString(data);
+                  m = converted;
+                }
+                this->callback(m);
                 return true;
               }
 
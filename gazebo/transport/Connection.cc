@@ -49,11 +49,15 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <algorithm>
+
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
 #include <boost/lexical_cast.hpp>
 
 #include "gazebo/common/Console.hh"
+#include "gazebo/common/MemoryTracker.hh"
+#include "gazebo/common/Profiler.hh"
 #include "gazebo/msgs/msgs.hh"
 
 #include "gazebo/transport/IOManager.hh"
@@ -68,6 +72,13 @@ extern void dummy_callback_fn(uint32_t);
 unsigned int Connection::idCounter = 0;
 IOManager *Connection::iomanager = NULL;
 
+/// \brief Size up to which messages are batched in one socket write.
+static const size_t kWriteSize = 4096;
+
+/// \brief Largest number of writeQueue entries in one gather-write, which
+/// keeps the number of buffers well below the system's IOV_MAX.
+static const size_t kMaxWriteBatch = 128;
+
 // Version 1.52 of boost has an address::is_unspecfied function, but
 // Version 1.46.1 (installed on ubuntu) does not. So this helper function
 // is stolen from adress::is_unspecified function in boost v1.52.
@@ -93,16 +104,36 @@ Connection::Connection()
   if (iomanager == NULL)
     iomanager = new IOManager();
 
-  this->socket = new boost::asio::ip::tcp::socket(iomanager->GetIO());
+  this->id = idCounter++;
+
+  // Spread the connections across the IO threads
+  this->socket = new boost::asio::ip::tcp::socket(
+      iomanager->GetIO(this->id));
+  this->affineReads = iomanager->ThreadCount() > 1;
 
   iomanager->IncCount();
-  this->id = idCounter++;
 
   this->acceptor = NULL;
   this->readQuit = false;
   this->connectError = false;
   this->writeQueue.clear();
   this->writeCount = 0;
+  this->queuedMemory = &common::MemoryTracker::Instance()->Counter(
+      "transport");
+
+  char *coalesceEnv = getenv("GAZEBO_WRITE_COALESCE_US");
+  if (coalesceEnv && !std::string(coalesceEnv).empty())
+  {
+    try
+    {
+      this->coalesceWindow = boost::lexical_cast<unsigned int>(coalesceEnv);
+    }
+    catch(boost::bad_lexical_cast &)
+    {
+      gzerr << "Invalid GAZEBO_WRITE_COALESCE_US [" << coalesceEnv
+            << "], expected microseconds\n";
+    }
+  }
 
   this->localURI = std::string("http://") + this->GetLocalHostname() + ":" +
                    boost::lexical_cast<std::string>(this->GetLocalPort());
@@ -126,6 +157,9 @@ Connection::~Connection()
 {
   this->Shutdown();
 
+  // The timer must be destroyed before its io service
+  this->coalesceTimer.reset();
+
   if (iomanager)
   {
     iomanager->DecCount();
@@ -309,19 +343,83 @@ void Connection::EnqueueMsg(const std::string &_buffer,
   {
     boost::recursive_mutex::scoped_lock lock(this->writeMutex);
 
-    if (this->writeQueue.empty() ||
-        (this->writeCount > 0 && this->writeQueue.size() == 1) ||
-        (this->writeQueue.back().size() + HEADER_LENGTH + _buffer.size() >
-         4096))
+    // Entries being written can't be appended to
+    const bool nonePending = this->writeQueue.size() <= this->writeBatch;
+    if (nonePending)
+      this->pendingSince = std::chrono::steady_clock::now();
+
+    if (nonePending ||
+        this->writeQueue.back().shared ||
+        (this->writeQueue.back().data.size() + HEADER_LENGTH +
+         _buffer.size() > kWriteSize))
     {
-      this->writeQueue.push_back(std::string(headerBuffer) + _buffer);
+      this->writeQueue.push_back({std::string(headerBuffer) + _buffer,
+          nullptr, std::chrono::steady_clock::now()});
       this->callbacks.push_back({std::make_pair(_cb, _id)});
     }
     else
     {
-      this->writeQueue.back() += std::string(headerBuffer) + _buffer;
+      this->writeQueue.back().data += std::string(headerBuffer) + _buffer;
       this->callbacks.back().push_back(std::make_pair(_cb, _id));
     }
+
+    this->maxQueuedMessages = std::max(this->maxQueuedMessages,
+        ++this->queuedMessages);
+    this->flushRequested = this->flushRequested || _force;
+
+    const int64_t bytes = HEADER_LENGTH + _buffer.size();
+    this->queuedBytes += bytes;
+    *this->queuedMemory += bytes;
+  }
+
+  if (_force)
+  {
+    this->ProcessWriteQueue();
+  }
+  else
+  {
+    // Tell the connection manager that it needs to update
+    ConnectionManager::Instance()->TriggerUpdate();
+  }
+}
+
+//////////////////////////////////////////////////
+void Connection::EnqueueMsg(const std::shared_ptr<const std::string> &_buffer,
+    boost::function<void(uint32_t)> _cb, uint32_t _id, bool _force)
+{
+  if (!_buffer)
+    return;
+
+  // Small messages are copied, so that they're written together
+  if (_buffer->size() + HEADER_LENGTH <= kWriteSize)
+  {
+    this->EnqueueMsg(*_buffer, _cb, _id, _force);
+    return;
+  }
+
+  if (!this->IsOpen())
+    return;
+
+  char headerBuffer[HEADER_LENGTH + 1];
+  snprintf(headerBuffer, HEADER_LENGTH + 1, "%08x",
+      static_cast<unsigned int>(_buffer->size()));
+
+  {
+    boost::recursive_mutex::scoped_lock lock(this->writeMutex);
+    if (this->writeQueue.size() <= this->writeBatch)
+      this->pendingSince = std::chrono::steady_clock::now();
+
+    this->writeQueue.push_back({std::string(headerBuffer), _buffer,
+        std::chrono::steady_clock::now()});
+    this->callbacks.push_back({std::make_pair(_cb, _id)});
+
+    this->maxQueuedMessages = std::max(this->maxQueuedMessages,
+        ++this->queuedMessages);
+    this->flushRequested = this->flushRequested || _force;
+
+    const int64_t bytes = HEADER_LENGTH + _buffer->size();
+    this->queuedBytes += bytes;
+    *this->queuedMemory += bytes;
   }
 
   if (_force)
@@ -338,6 +436,7 @@ void Connection::EnqueueMsg(const std::string &_buffer,
 /////////////////////////////////////////////////
 void Connection::ProcessWriteQueue(bool _blocking)
 {
+  GZ_PROFILE("Connection::ProcessWriteQueue");
   boost::recursive_mutex::scoped_lock lock(this->writeMutex);
 
   if (!this->IsOpen())
@@ -352,16 +451,61 @@ void Connection::ProcessWriteQueue(bool _blocking)
     return;
   }
 
+  // Write all the queued data to the socket. We use "gather-write" to
+  // send the headers and data of many messages in a single write
+  // operation
+  std::vector<boost::asio::const_buffer> buffers;
+  size_t batch = 0;
+  size_t bytes = 0;
+  for (auto iter = this->writeQueue.begin();
+      iter != this->writeQueue.end() && batch < kMaxWriteBatch;
+      ++iter, ++batch)
+  {
+    buffers.push_back(boost::asio::buffer(iter->data.c_str(),
+        iter->data.size()));
+    bytes += iter->data.size();
+    if (iter->shared)
+    {
+      buffers.push_back(boost::asio::buffer(iter->shared->c_str(),
+          iter->shared->size()));
+      bytes += iter->shared->size();
+    }
+  }
+
+  // Give small messages a chance to be written together
+  if (!_blocking && !this->flushRequested && this->coalesceWindow > 0 &&
+      bytes < kWriteSize)
+  {
+    const std::chrono::steady_clock::time_point deadline =
+        this->pendingSince + std::chrono::microseconds(this->coalesceWindow);
+    if (std::chrono::steady_clock::now() < deadline)
+    {
+      if (!this->coalesceTimerArmed)
+      {
+        if (!this->coalesceTimer)
+        {
+          this->coalesceTimer.reset(
+              new boost::asio::steady_timer(iomanager->GetIO(this->id)));
+        }
+        this->coalesceTimer->expires_at(deadline);
+        this->coalesceTimer->async_wait(
+            common::weakBind(&Connection::OnCoalesceTimeout,
+              this->shared_from_this(), boost::asio::placeholders::error));
+        this->coalesceTimerArmed = true;
+      }
+      return;
+    }
+  }
+
+  this->flushRequested = false;
   this->writeCount++;
+  this->writeBatch = batch;
+  this->writeBytes = bytes;
+  this->writeCalls++;
 
-  // Write the serialized data to the socket. We use
-  // "gather-write" to send both the head and the data in
-  // a single write operation
   if (!_blocking)
   {
-    boost::asio::async_write(*this->socket,
-        boost::asio::buffer(this->writeQueue.front().c_str(),
-          this->writeQueue.front().size()),
+    boost::asio::async_write(*this->socket, buffers,
           common::weakBind(&Connection::OnWrite, this->shared_from_this(),
             boost::asio::placeholders::error));
   }
@@ -369,9 +513,7 @@ void Connection::ProcessWriteQueue(bool _blocking)
   {
     try
     {
-      boost::asio::write(*this->socket,
-          boost::asio::buffer(this->writeQueue.front().c_str(),
-            this->writeQueue.front().size()));
+      boost::asio::write(*this->socket, buffers);
     }
     catch(...)
     {
@@ -397,17 +539,42 @@ std::string Connection::GetRemoteURI() const
 //////////////////////////////////////////////////
 void Connection::PostWrite()
 {
+  const auto now = std::chrono::steady_clock::now();
+
   // Call the callbacks, if not NULL
-  if (!this->callbacks.empty())
+  for (size_t i = 0; i < this->writeBatch && !this->callbacks.empty(); ++i)
   {
+    if (i < this->writeQueue.size())
+    {
+      const uint64_t latency =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              now - this->writeQueue[i].queued).count();
+      for (size_t j = 0; j < this->callbacks.front().size(); ++j)
+        this->writeLatency.Record(latency);
+    }
+
     for (auto const &callback : this->callbacks.front())
       if (!callback.first.empty())
         callback.first(callback.second);
+    this->writtenMessages += this->callbacks.front().size();
+    this->queuedMessages -= std::min<unsigned int>(this->queuedMessages,
+        this->callbacks.front().size());
     this->callbacks.pop_front();
   }
 
-  if (!this->writeQueue.empty())
+  int64_t bytes = 0;
+  for (size_t i = 0; i < this->writeBatch && !this->writeQueue.empty(); ++i)
+  {
+    const WriteBuffer &buffer = this->writeQueue.front();
+    bytes += buffer.data.size() + (buffer.shared ? buffer.shared->size() : 0);
     this->writeQueue.pop_front();
+  }
+  bytes = std::min(bytes, this->queuedBytes);
+  this->queuedBytes -= bytes;
+  *this->queuedMemory -= bytes;
+  this->writtenBytes += this->writeBytes;
+  this->writeBytes = 0;
+  this->writeBatch = 0;
   this->writeCount--;
 }
 
@@ -425,6 +592,79 @@ void Connection::OnWrite(const boost::system::error_code &_e)
     // It will reach this point if the remote connection disconnects.
     this->Shutdown();
   }
+  else
+  {
+    // Write the messages queued meanwhile without waiting for the
+    // connection manager
+    this->ProcessWriteQueue();
+  }
+}
+
+//////////////////////////////////////////////////
+void Connection::OnCoalesceTimeout(const boost::system::error_code &_e)
+{
+  {
+    boost::recursive_mutex::scoped_lock lock(this->writeMutex);
+    this->coalesceTimerArmed = false;
+  }
+
+  if (!_e)
+    this->ProcessWriteQueue();
+}
+
+//////////////////////////////////////////////////
+void Connection::SetReadStrand(const std::shared_ptr<Strand> &_strand)
+{
+  this->readStrand = _strand;
+}
+
+//////////////////////////////////////////////////
+void Connection::SetCoalesceWindow(const unsigned int _window)
+{
+  boost::recursive_mutex::scoped_lock lock(this->writeMutex);
+  this->coalesceWindow = _window;
+}
+
+//////////////////////////////////////////////////
+unsigned int Connection::CoalesceWindow() const
+{
+  return this->coalesceWindow;
+}
+
+//////////////////////////////////////////////////
+unsigned int Connection::QueuedMessageCount() const
+{
+  return this->queuedMessages;
+}
+
+//////////////////////////////////////////////////
+unsigned int Connection::MaxQueuedMessageCount() const
+{
+  return this->maxQueuedMessages;
+}
+
+//////////////////////////////////////////////////
+uint64_t Connection::WriteCallCount() const
+{
+  return this->writeCalls;
+}
+
+//////////////////////////////////////////////////
+uint64_t Connection::WrittenMessageCount() const
+{
+  return this->writtenMessages;
+}
+
+//////////////////////////////////////////////////
+uint64_t Connection::WrittenByteCount() const
+{
+  return this->writtenBytes;
+}
+
+//////////////////////////////////////////////////
+const common::LatencyHistogram &Connection::WriteLatency() const
+{
+  return this->writeLatency;
 }
 
 //////////////////////////////////////////////////
@@ -490,6 +730,13 @@ void Connection::Close()
   boost::recursive_mutex::scoped_lock lock2(this->writeMutex);
   this->writeQueue.clear();
   this->callbacks.clear();
+  this->writeBatch = 0;
+  this->queuedMessages = 0;
+  *this->queuedMemory -= this->queuedBytes;
+  this->queuedBytes = 0;
+  this->flushRequested = false;
+  if (this->coalesceTimer)
+    this->coalesceTimer->cancel();
 }
 
 //////////////////////////////////////////////////
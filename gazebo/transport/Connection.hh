@@ -21,22 +21,29 @@
 #include <google/protobuf/message.h>
 
 #include <boost/asio.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
 #include <boost/thread.hpp>
 #include <boost/tuple/tuple.hpp>
 
+#include <atomic>
+#include <chrono>
 #include <string>
 #include <vector>
 #include <iostream>
 #include <iomanip>
 #include <deque>
+#include <memory>
 #include <utility>
 
 #include "gazebo/common/Event.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
+#include "gazebo/common/LatencyHistogram.hh"
 #include "gazebo/common/WeakBind.hh"
+#include "gazebo/transport/BufferPool.hh"
+#include "gazebo/transport/Strand.hh"
 #include "gazebo/util/system.hh"
 
 #define HEADER_LENGTH 8
@@ -59,12 +66,13 @@ namespace gazebo
       /// \brief Constructor
       /// \param[_in] _func Boost function pointer, which is the function
       /// that receives the data.
-      /// \param[in] _data Data to send to the boost function pointer.
+      /// \param[in] _data Data to send to the boost function pointer. It
+      /// is returned to the BufferPool once handled.
       public: ConnectionReadTask(
                   boost::function<void (const std::string &)> _func,
-                  const std::string &_data) :
+                  std::string _data) :
                 func(_func),
-                data(_data)
+                data(std::move(_data))
               {
               }
 
@@ -73,6 +81,7 @@ namespace gazebo
       public: tbb::task *execute()
               {
                 this->func(this->data);
+                BufferPool::Instance()->Release(std::move(this->data));
                 return NULL;
               }
 
@@ -95,6 +104,8 @@ namespace gazebo
     /// IP lookup.
     ///   - GAZEBO_HOSTNAME: Hostame to export. Setting this will override
     /// both GAZEBO_IP and the default IP lookup.
+    ///   - GAZEBO_WRITE_COALESCE_US: Default write coalescing window of
+    /// the connections, in microseconds. See SetCoalesceWindow.
     ///
     /// \class Connection Connection.hh transport/transport.hh
     /// \brief Single TCP/IP connection manager
@@ -162,6 +173,20 @@ namespace gazebo
                   boost::function<void(uint32_t)> _cb, uint32_t _id,
                   bool _force = false);
 
+      /// \brief Write data to the socket, without copying large buffers.
+      /// A buffer larger than a socket write is kept until it is written,
+      /// so it must not be modified, and can be shared by connections.
+      /// \param[in] _buffer Data to write
+      /// \param[in] _cb If non-null, callback to be invoked after
+      /// transmission is complete.
+      /// \param[in] _id ID associated with the message data.
+      /// \param[in] _force If true, block until the data has been written
+      /// to the socket, otherwise just enqueue the data for asynchronous write
+      public: void EnqueueMsg(
+                  const std::shared_ptr<const std::string> &_buffer,
+                  boost::function<void(uint32_t)> _cb, uint32_t _id,
+                  bool _force = false);
+
       /// \brief Write data to the socket
       /// \param[in] _buffer Data to write
       /// \param[in] _force If true, block until the data has been written
@@ -250,15 +275,18 @@ namespace gazebo
 
                  if (inboundData_size > 0)
                   {
-                    // Start the asynchronous call to receive data
-                    this->inboundData.resize(inboundData_size);
+                    // Start the asynchronous call to receive data, into a
+                    // pooled buffer which is handed to the callback
+                    this->inboundData =
+                        BufferPool::Instance()->Acquire(inboundData_size);
 
                     void (Connection::*f)(const boost::system::error_code &e,
                         boost::tuple<Handler>) =
                       &Connection::OnReadData<Handler>;
 
                     boost::asio::async_read(*this->socket,
-                        boost::asio::buffer(this->inboundData),
+                        boost::asio::buffer(&this->inboundData[0],
+                          this->inboundData.size()),
                         common::weakBind(f, this->shared_from_this(),
                                     boost::asio::placeholders::error,
                                     _handler));
@@ -300,9 +328,9 @@ namespace gazebo
                     this->isOpen = false;
                 }
 
-                // Inform caller that data has been received
-                std::string data(&this->inboundData[0],
-                                  this->inboundData.size());
+                // Inform caller that data has been received. The buffer is
+                // moved, not copied, to the callback.
+                std::string data = std::move(this->inboundData);
                 this->inboundData.clear();
 
                 if (data.empty())
@@ -310,13 +338,34 @@ namespace gazebo
 
                 if (!_e && !transport::is_stopped())
                 {
+                  // A strand handles the data in order, without holding
+                  // the IO thread
+                  if (this->readStrand)
+                  {
+                    this->readStrand->Post(boost::get<0>(_handler),
+                        std::move(data));
+                    return;
+                  }
+
+                  // With several IO threads, the data is handled on the
+                  // thread of this connection, so it stays in order
+                  if (this->affineReads)
+                  {
+                    boost::get<0>(_handler)(data);
+                    BufferPool::Instance()->Release(std::move(data));
+                    return;
+                  }
+
                   ConnectionReadTask *task = new(tbb::task::allocate_root())
-                        ConnectionReadTask(boost::get<0>(_handler), data);
+                        ConnectionReadTask(boost::get<0>(_handler),
+                            std::move(data));
                   tbb::task::enqueue(*task);
 
                   // Non-tbb version:
                   // boost::get<0>(_handler)(data);
                 }
+                else
+                  BufferPool::Instance()->Release(std::move(data));
               }
 
       /// \brief Register a function to be called when the connection is shut
@@ -326,9 +375,62 @@ namespace gazebo
                  _subscriber)
               { return this->shutdown.Connect(_subscriber); }
 
-      /// \brief Handle on-write callbacks
+      /// \brief Write the queued messages to the socket. All the queued
+      /// messages are written with a single gather-write, unless the
+      /// coalescing window delays them.
+      /// \param[in] _blocking True to wait until the data is written.
       public: void ProcessWriteQueue(bool _blocking = false);
 
+      /// \brief Handle the data read by the connection on a strand, so
+      /// that it's handled in order while the other connections are
+      /// handled in parallel. Without a strand, each message is handled
+      /// by its own TBB task, or on the IO thread of the connection.
+      /// \param[in] _strand The strand, null to stop using it. Set it
+      /// before the first read.
+      public: void SetReadStrand(const std::shared_ptr<Strand> &_strand);
+
+      /// \brief Set how long small messages may wait for more messages,
+      /// so that they're written together. Messages are written once the
+      /// oldest one has waited this long, or as soon as a full socket
+      /// write is queued. Forced messages are never delayed. The default
+      /// is GAZEBO_WRITE_COALESCE_US, or 0 to write messages immediately.
+      /// \param[in] _window Coalescing window, in microseconds.
+      public: void SetCoalesceWindow(const unsigned int _window);
+
+      /// \brief Get the write coalescing window.
+      /// \return Coalescing window, in microseconds.
+      public: unsigned int CoalesceWindow() const;
+
+      /// \brief Get the number of messages waiting to be written, or
+      /// being written.
+      /// \return Number of queued messages.
+      public: unsigned int QueuedMessageCount() const;
+
+      /// \brief Get the largest number of messages that were queued.
+      /// \return Largest number of queued messages.
+      public: unsigned int MaxQueuedMessageCount() const;
+
+      /// \brief Get the number of writes issued to the socket.
+      /// \return Number of socket writes.
+      public: uint64_t WriteCallCount() const;
+
+      /// \brief Get the number of messages written to the socket.
+      /// Together with WriteCallCount, this shows how well messages are
+      /// batched.
+      /// \return Number of written messages.
+      public: uint64_t WrittenMessageCount() const;
+
+      /// \brief Get the number of bytes written to the socket, headers
+      /// included.
+      /// \return Number of written bytes.
+      public: uint64_t WrittenByteCount() const;
+
+      /// \brief Get the times between the queueing of the messages and the
+      /// end of their write. Messages written together in one buffer count
+      /// from the first of them.
+      /// \return The histogram of the times.
+      public: const common::LatencyHistogram &WriteLatency() const;
+
       /// \brief Get the ID of the connection.
       /// \return The connection's unique ID.
       public: unsigned int GetId() const;
@@ -352,6 +454,11 @@ namespace gazebo
       /// \param[in] _b Buffer of the data that was written.
       private: void OnWrite(const boost::system::error_code &_e);
 
+      /// \brief Callback when the coalescing window of the queued
+      /// messages has elapsed.
+      /// \param[in] _e Error code, set if the timer was cancelled.
+      private: void OnCoalesceTimeout(const boost::system::error_code &_e);
+
       /// \brief Handle new connections, if this is a server
       /// \param[in] _e Error code for accept method
       private: void OnAccept(const boost::system::error_code &_e);
@@ -388,8 +495,21 @@ namespace gazebo
       /// \brief Accepts new connections.
       private: boost::asio::ip::tcp::acceptor *acceptor;
 
+      /// \brief Data of one write to the socket.
+      private: struct WriteBuffer
+               {
+                 /// \brief Headers and data of the small messages.
+                 std::string data;
+
+                 /// \brief Data of a large message, written after data.
+                 std::shared_ptr<const std::string> shared;
+
+                 /// \brief Time at which the first message was queued.
+                 std::chrono::steady_clock::time_point queued;
+               };
+
       /// \brief Outgoing data queue
-      private: std::deque<std::string> writeQueue;
+      private: std::deque<WriteBuffer> writeQueue;
 
       /// \brief List of callbacks, paired with writeQueue. The callbacks
       /// are used to notify a publisher when a message is successfully sent.
@@ -418,8 +538,8 @@ namespace gazebo
       /// \brief Header data from a new message.
       private: std::vector<char> inboundHeader;
 
-      /// \brief Content data from a new message.
-      private: std::vector<char> inboundData;
+      /// \brief Content data from a new message, in a pooled buffer.
+      private: std::string inboundData;
 
       /// \brief Set to true to stop reading on the connection.
       private: bool readQuit;
@@ -442,6 +562,65 @@ namespace gazebo
       /// \brief Number of writes that are being processed.
       private: unsigned int writeCount;
 
+      /// \brief True to handle the data read on the IO thread of the
+      /// connection, instead of a TBB task.
+      private: bool affineReads = false;
+
+      /// \brief Strand that handles the data read, null to use a TBB task
+      /// per message.
+      private: std::shared_ptr<Strand> readStrand;
+
+      /// \brief Number of writeQueue entries in the current write.
+      private: size_t writeBatch = 0;
+
+      /// \brief Number of messages in writeQueue.
+      private: unsigned int queuedMessages = 0;
+
+      /// \brief Bytes of the messages in writeQueue. Large messages shared
+      /// with other connections are counted by each of them.
+      private: int64_t queuedBytes = 0;
+
+      /// \brief Bytes queued by every connection, in the "transport"
+      /// subsystem of the common::MemoryTracker.
+      private: std::atomic<int64_t> *queuedMemory = nullptr;
+
+      /// \brief Largest value of queuedMessages.
+      private: unsigned int maxQueuedMessages = 0;
+
+      /// \brief Number of writes issued to the socket.
+      private: uint64_t writeCalls = 0;
+
+      /// \brief Number of messages written to the socket.
+      private: uint64_t writtenMessages = 0;
+
+      /// \brief Number of bytes written to the socket.
+      private: uint64_t writtenBytes = 0;
+
+      /// \brief Number of bytes in the current write.
+      private: size_t writeBytes = 0;
+
+      /// \brief Times from the queueing to the end of the write of the
+      /// messages.
+      private: common::LatencyHistogram writeLatency;
+
+      /// \brief Write coalescing window, in microseconds.
+      private: unsigned int coalesceWindow = 0;
+
+      /// \brief Time at which the oldest message not being written was
+      /// queued.
+      private: std::chrono::steady_clock::time_point pendingSince;
+
+      /// \brief True if a forced message is queued, so the queue must be
+      /// written without waiting.
+      private: bool flushRequested = false;
+
+      /// \brief Timer which writes the queue once the coalescing window
+      /// elapsed, null until a message is delayed.
+      private: std::unique_ptr<boost::asio::steady_timer> coalesceTimer;
+
+      /// \brief True while coalesceTimer is waiting.
+      private: bool coalesceTimerArmed = false;
+
       /// \brief Local URI string
       private: std::string localURI;
 
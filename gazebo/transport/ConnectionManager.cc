@@ -19,8 +19,10 @@
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Events.hh"
+#include "gazebo/common/MemoryTracker.hh"
 #include "gazebo/transport/TopicManager.hh"
 #include "gazebo/transport/ConnectionManager.hh"
+#include "gazebo/transport/DatagramChannel.hh"
 
 #include "gazebo/gazebo_config.h"
 
@@ -64,6 +66,10 @@ ConnectionManager::ConnectionManager()
   this->stop = false;
   this->stopped = true;
 
+  // The connections count their queues in the tracker, which is created
+  // first so that it outlives them
+  common::MemoryTracker::Instance();
+
   this->eventConnections.push_back(
       event::Events::ConnectStop(boost::bind(&ConnectionManager::Stop, this)));
 }
@@ -71,7 +77,7 @@ ConnectionManager::ConnectionManager()
 //////////////////////////////////////////////////
 ConnectionManager::~ConnectionManager()
 {
-  boost::mutex::scoped_lock lock(this->updateMutex);
+  // Not under updateMutex, which the update thread needs in order to stop
   this->eventConnections.clear();
 
   this->Fini();
@@ -242,6 +248,9 @@ void ConnectionManager::Fini()
 void ConnectionManager::Stop()
 {
   this->stop = true;
+  {
+    boost::mutex::scoped_lock lock(this->updateMutex);
+  }
   this->updateCondition.notify_all();
   if (this->initialized)
     while (this->stopped == false)
@@ -301,15 +310,20 @@ void ConnectionManager::RunUpdate()
 //////////////////////////////////////////////////
 void ConnectionManager::Run()
 {
-  boost::mutex::scoped_lock lock(this->updateMutex);
-
   this->stopped = false;
 
   while (!this->stop && this->masterConn && this->masterConn->IsOpen())
   {
+    // Updates triggered from now on get another pass
+    this->updatePending = false;
     this->RunUpdate();
+
+    // Wake up as soon as a message is published or received. The timeout
+    // watches the master connection.
+    boost::mutex::scoped_lock lock(this->updateMutex);
     this->updateCondition.timed_wait(lock,
-       boost::posix_time::milliseconds(100));
+        boost::posix_time::milliseconds(100),
+        [this] { return this->updatePending || this->stop; });
   }
   this->RunUpdate();
 
@@ -355,6 +369,14 @@ void ConnectionManager::ProcessMessage(const std::string &_data)
     result.ParseFromString(packet.serialized_data());
     this->publishers.push_back(result);
   }
+  else if (packet.type() == "publishers_add")
+  {
+    // The master batches the publishers advertised together
+    msgs::Publishers result;
+    result.ParseFromString(packet.serialized_data());
+    for (int i = 0; i < result.publisher_size(); ++i)
+      this->publishers.push_back(result.publisher(i));
+  }
   else if (packet.type() == "publisher_del")
   {
     msgs::Publish result;
@@ -483,6 +505,23 @@ void ConnectionManager::OnRead(ConnectionPtr _connection,
     SubscriptionTransportPtr subLink(new SubscriptionTransport());
     subLink->Init(_connection, sub.latching());
 
+    // Subscribers on the same host may offer a shared memory ring
+    if (sub.has_shm_name())
+      subLink->InitSharedMemory(sub.shm_name());
+
+    // Slow subscribers may ask for a lower rate or a bounded queue
+    if (sub.max_rate() > 0 || sub.queue_limit() > 0)
+      subLink->SetQoS(sub.max_rate(), sub.queue_limit());
+
+    // Subscribers which accept messages over UDP give a port
+    if (sub.datagram_port() > 0)
+    {
+      subLink->InitDatagrams(sub.topic(),
+          this->serverConn->GetLocalAddress() + ":" +
+          std::to_string(this->serverConn->GetLocalPort()),
+          sub.host(), sub.datagram_port());
+    }
+
     // Connect the publisher to this transport mechanism
     TopicManager::Instance()->ConnectPubToSub(sub.topic(), subLink);
   }
@@ -503,6 +542,15 @@ void ConnectionManager::Advertise(const std::string &topic,
   msg.set_host(this->serverConn->GetLocalAddress());
   msg.set_port(this->serverConn->GetLocalPort());
 
+  std::string group;
+  unsigned int port;
+  if (DatagramChannel::Configured(topic, group, port))
+  {
+    msg.set_datagram(true);
+    msg.set_datagram_group(group);
+    msg.set_datagram_port(port);
+  }
+
   this->masterConn->EnqueueMsg(msgs::Package("advertise", msg));
 }
 
@@ -547,6 +595,35 @@ void ConnectionManager::GetAllPublishers(std::list<msgs::Publish> &_publishers)
     _publishers.push_back(*iter);
 }
 
+//////////////////////////////////////////////////
+void ConnectionManager::FillStatistics(msgs::TransportStats &_msg)
+{
+  boost::recursive_mutex::scoped_lock lock(this->connectionMutex);
+  for (auto const &conn : this->connections)
+  {
+    if (!conn->IsOpen())
+      continue;
+
+    msgs::TransportStats::Connection *stats = _msg.add_connection();
+    stats->set_remote_uri(conn->GetRemoteURI());
+    stats->set_messages(conn->WrittenMessageCount());
+    stats->set_bytes(conn->WrittenByteCount());
+    stats->set_message_rate(0);
+    stats->set_byte_rate(0);
+    stats->set_queued(conn->QueuedMessageCount());
+    stats->set_max_queued(conn->MaxQueuedMessageCount());
+    stats->set_writes(conn->WriteCallCount());
+
+    const common::LatencyHistogram &latency = conn->WriteLatency();
+    if (latency.Count() > 0)
+    {
+      stats->set_latency_p50(latency.Percentile(50) * 1e-9);
+      stats->set_latency_p99(latency.Percentile(99) * 1e-9);
+      stats->set_latency_max(latency.Max() * 1e-9);
+    }
+  }
+}
+
 //////////////////////////////////////////////////
 void ConnectionManager::GetTopicNamespaces(std::list<std::string> &_namespaces)
 {
@@ -697,5 +774,13 @@ ConnectionPtr ConnectionManager::FindConnection(const std::string &_host,
 //////////////////////////////////////////////////
 void ConnectionManager::TriggerUpdate()
 {
-  this->updateCondition.notify_all();
+  // Only the first trigger of an update wakes the thread. Locking the
+  // mutex makes sure the thread either sees the flag or already waits.
+  if (!this->updatePending.exchange(true))
+  {
+    {
+      boost::mutex::scoped_lock lock(this->updateMutex);
+    }
+    this->updateCondition.notify_all();
+  }
 }
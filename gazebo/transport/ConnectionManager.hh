@@ -20,6 +20,7 @@
 
 #include <boost/shared_ptr.hpp>
 #include <boost/interprocess/sync/interprocess_semaphore.hpp>
+#include <atomic>
 #include <string>
 #include <list>
 #include <vector>
@@ -117,6 +118,11 @@ namespace gazebo
       /// \param[in] _conn The connection to be removed
       public: void RemoveConnection(ConnectionPtr &_conn);
 
+      /// \brief Add the counters of the open connections, since they were
+      /// created. The rates are left to the caller.
+      /// \param[in,out] _msg Message the connections are added to.
+      public: void FillStatistics(msgs::TransportStats &_msg);
+
       /// \brief Register a new topic namespace
       /// \param[in] _name The name of the topic namespace to be registered
       public: void RegisterTopicNamespace(const std::string &_name);
@@ -170,6 +176,10 @@ namespace gazebo
       /// \brief Mutex for updateCondition
       private: boost::mutex updateMutex;
 
+      /// \brief True if TriggerUpdate was called since the last update
+      /// began.
+      private: std::atomic<bool> updatePending{false};
+
       private: ConnectionPtr masterConn;
       private: ConnectionPtr serverConn;
 
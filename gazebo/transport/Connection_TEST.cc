@@ -64,6 +64,34 @@ TEST_F(Connection, IPWhiteList)
     setenv("GAZEBO_IP_WHITE_LIST", ipEnv, 1);
 }
 
+/////////////////////////////////////////////////
+TEST_F(Connection, CoalesceWindow)
+{
+  transport::Connection *connection = new transport::Connection();
+  EXPECT_EQ(0u, connection->CoalesceWindow());
+  EXPECT_EQ(0u, connection->QueuedMessageCount());
+  EXPECT_EQ(0u, connection->MaxQueuedMessageCount());
+  EXPECT_EQ(0u, connection->WriteCallCount());
+  EXPECT_EQ(0u, connection->WrittenMessageCount());
+
+  connection->SetCoalesceWindow(500);
+  EXPECT_EQ(500u, connection->CoalesceWindow());
+
+  // Messages aren't queued on a closed connection
+  connection->EnqueueMsg("data");
+  EXPECT_EQ(0u, connection->QueuedMessageCount());
+  delete connection;
+
+  // The default window comes from the environment
+  char *coalesceEnv = getenv("GAZEBO_WRITE_COALESCE_US");
+  setenv("GAZEBO_WRITE_COALESCE_US", "250", 1);
+  connection = new transport::Connection();
+  EXPECT_EQ(250u, connection->CoalesceWindow());
+  delete connection;
+
+  setenv("GAZEBO_WRITE_COALESCE_US", coalesceEnv ? coalesceEnv : "", 1);
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
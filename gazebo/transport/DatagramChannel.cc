@@ -0,0 +1,525 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <stdlib.h>
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/asio.hpp>
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/transport/DatagramChannel.hh"
+
+using namespace gazebo;
+using namespace transport;
+
+namespace
+{
+  /// \brief Identifies the datagrams of a DatagramChannel.
+  const uint32_t kDatagramMagic = 0x677a6467;
+
+  /// \brief Size of the header of a fragment: magic, topic, publisher,
+  /// source, sequence number, fragment index and fragment count.
+  const std::size_t kHeaderSize = 24;
+
+  /// \brief Largest payload of a fragment, so that fragments fit in a
+  /// typical Ethernet MTU without IP fragmentation.
+  const std::size_t kFragmentPayload = 1400 - kHeaderSize;
+
+  /// \brief Largest number of fragments of a message.
+  const std::size_t kMaxFragments = 0xffff;
+
+  /// \brief Largest number of senders a receiver tracks.
+  const std::size_t kMaxSources = 16;
+
+  /// \brief Default first port of the multicast groups.
+  const unsigned int kDefaultPort = 11400;
+
+  /// \brief Number of ports the topics are spread across.
+  const unsigned int kPortRange = 1000;
+
+  /// \brief Hash a string with 32-bit FNV-1a, which is the same on every
+  /// platform.
+  /// \param[in] _str The string.
+  /// \return The hash.
+  uint32_t Hash(const std::string &_str)
+  {
+    uint32_t hash = 2166136261u;
+    for (const char c : _str)
+    {
+      hash ^= static_cast<unsigned char>(c);
+      hash *= 16777619u;
+    }
+    return hash;
+  }
+
+  /// \brief Write a little-endian integer.
+  /// \param[out] _dst Destination of the bytes.
+  /// \param[in] _value The integer.
+  /// \param[in] _size Number of bytes.
+  void Put(char *_dst, const uint32_t _value, const std::size_t _size)
+  {
+    for (std::size_t i = 0; i < _size; ++i)
+      _dst[i] = static_cast<char>((_value >> (8 * i)) & 0xff);
+  }
+
+  /// \brief Read a little-endian integer.
+  /// \param[in] _src The bytes.
+  /// \param[in] _size Number of bytes.
+  /// \return The integer.
+  uint32_t Get(const char *_src, const std::size_t _size)
+  {
+    uint32_t value = 0;
+    for (std::size_t i = 0; i < _size; ++i)
+      value |= static_cast<uint32_t>(static_cast<unsigned char>(_src[i])) <<
+          (8 * i);
+    return value;
+  }
+
+  /// \brief Message being reassembled from the fragments of a sender.
+  struct Reassembly
+  {
+    /// \brief True once a message was delivered.
+    bool delivered = false;
+
+    /// \brief Sequence number of the last delivered message.
+    uint32_t lastSeq = 0;
+
+    /// \brief True while fragments of a message are received.
+    bool active = false;
+
+    /// \brief Sequence number of the message being received.
+    uint32_t seq = 0;
+
+    /// \brief Fragments received, by index.
+    std::vector<bool> received;
+
+    /// \brief Number of fragments received.
+    std::size_t count = 0;
+
+    /// \brief Size of the last fragment, once received.
+    std::size_t lastSize = 0;
+
+    /// \brief Content of the message.
+    std::string data;
+  };
+
+  /// \brief Compare sequence numbers, which wrap around.
+  /// \param[in] _a First sequence number.
+  /// \param[in] _b Second sequence number.
+  /// \return True if _a is newer than _b.
+  bool Newer(const uint32_t _a, const uint32_t _b)
+  {
+    return static_cast<int32_t>(_a - _b) > 0;
+  }
+}
+
+namespace gazebo
+{
+  namespace transport
+  {
+    /// \internal
+    /// \brief Private data for the DatagramChannel class
+    class DatagramChannelPrivate
+    {
+      /// \brief Receive the next datagram.
+      public: void Receive()
+      {
+        this->socket->async_receive_from(
+            boost::asio::buffer(this->inbound), this->sender,
+            boost::bind(&DatagramChannelPrivate::OnReceive, this,
+              boost::asio::placeholders::error,
+              boost::asio::placeholders::bytes_transferred));
+      }
+
+      /// \brief Handle a received datagram.
+      /// \param[in] _e Error code.
+      /// \param[in] _size Size of the datagram.
+      public: void OnReceive(const boost::system::error_code &_e,
+                  const std::size_t _size)
+      {
+        if (_e == boost::asio::error::operation_aborted)
+          return;
+
+        if (!_e)
+          this->HandleFragment(this->inbound.data(), _size);
+
+        this->Receive();
+      }
+
+      /// \brief Add a fragment to its message, and deliver the message
+      /// once complete.
+      /// \param[in] _data The fragment.
+      /// \param[in] _size Size of the fragment.
+      public: void HandleFragment(const char *_data, const std::size_t _size)
+      {
+        if (_size < kHeaderSize || Get(_data, 4) != kDatagramMagic ||
+            Get(_data + 4, 4) != this->topicHash ||
+            Get(_data + 8, 4) != this->publisherHash)
+        {
+          return;
+        }
+
+        const uint32_t source = Get(_data + 12, 4);
+        const uint32_t seq = Get(_data + 16, 4);
+        const std::size_t index = Get(_data + 20, 2);
+        const std::size_t count = Get(_data + 22, 2);
+        const std::size_t payload = _size - kHeaderSize;
+        if (count == 0 || index >= count || payload > kFragmentPayload ||
+            (index + 1 < count && payload != kFragmentPayload))
+        {
+          return;
+        }
+
+        // Each restart of the publisher is a new source, so forget the
+        // stale ones
+        if (this->sources.size() >= kMaxSources &&
+            this->sources.find(source) == this->sources.end())
+        {
+          this->sources.clear();
+        }
+        Reassembly &msg = this->sources[source];
+
+        // Latest-only: older messages are ignored
+        if (msg.delivered && !Newer(seq, msg.lastSeq))
+          return;
+        if (msg.active && seq != msg.seq)
+        {
+          if (!Newer(seq, msg.seq))
+            return;
+          ++this->dropped;
+          msg.active = false;
+        }
+
+        if (!msg.active)
+        {
+          msg.active = true;
+          msg.seq = seq;
+          msg.received.assign(count, false);
+          msg.count = 0;
+          msg.lastSize = 0;
+          msg.data.resize(count * kFragmentPayload);
+        }
+
+        if (msg.received.size() != count || msg.received[index])
+          return;
+
+        msg.received[index] = true;
+        ++msg.count;
+        std::copy(_data + kHeaderSize, _data + _size,
+            &msg.data[index * kFragmentPayload]);
+        if (index + 1 == count)
+          msg.lastSize = payload;
+
+        if (msg.count < count)
+          return;
+
+        msg.data.resize((count - 1) * kFragmentPayload + msg.lastSize);
+        msg.active = false;
+        msg.delivered = true;
+        msg.lastSeq = seq;
+
+        if (this->callback)
+          this->callback(msg.data);
+      }
+
+      /// \brief IO service of the channel.
+      public: boost::asio::io_service io;
+
+      /// \brief Socket, null if the channel isn't open.
+      public: std::unique_ptr<boost::asio::ip::udp::socket> socket;
+
+      /// \brief Thread running the IO service of a receiver.
+      public: std::unique_ptr<boost::thread> thread;
+
+      /// \brief Destination of the datagrams of a sender.
+      public: boost::asio::ip::udp::endpoint destination;
+
+      /// \brief Sender of the last received datagram.
+      public: boost::asio::ip::udp::endpoint sender;
+
+      /// \brief Buffer of the received datagrams.
+      public: std::vector<char> inbound = std::vector<char>(65536);
+
+      /// \brief Hash of the topic name.
+      public: uint32_t topicHash = 0;
+
+      /// \brief Hash of the publisher's address.
+      public: uint32_t publisherHash = 0;
+
+      /// \brief Random id of a sender, which changes when it restarts.
+      public: uint32_t source = 0;
+
+      /// \brief Sequence number of the next message sent.
+      public: uint32_t seq = 0;
+
+      /// \brief Messages being reassembled, by source.
+      public: std::map<uint32_t, Reassembly> sources;
+
+      /// \brief Callback of a receiver.
+      public: DatagramChannel::ReadCallback callback;
+
+      /// \brief Number of messages missing fragments.
+      public: uint64_t dropped = 0;
+    };
+  }
+}
+
+//////////////////////////////////////////////////
+DatagramChannel::DatagramChannel()
+  : dataPtr(new DatagramChannelPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+DatagramChannel::~DatagramChannel()
+{
+  this->Close();
+}
+
+//////////////////////////////////////////////////
+bool DatagramChannel::OpenSender(const std::string &_topic,
+    const std::string &_publisher, const std::string &_address,
+    const unsigned int _port)
+{
+  this->Close();
+
+  try
+  {
+    boost::asio::ip::address address =
+        boost::asio::ip::address::from_string(_address);
+    this->dataPtr->destination =
+        boost::asio::ip::udp::endpoint(address, _port);
+
+    this->dataPtr->socket.reset(
+        new boost::asio::ip::udp::socket(this->dataPtr->io));
+    this->dataPtr->socket->open(this->dataPtr->destination.protocol());
+
+    // Stay on the local network
+    if (address.is_multicast())
+    {
+      this->dataPtr->socket->set_option(
+          boost::asio::ip::multicast::hops(1));
+    }
+  }
+  catch(std::exception &_e)
+  {
+    gzerr << "Unable to send datagrams of [" << _topic << "] to ["
+          << _address << ":" << _port << "]: " << _e.what() << "\n";
+    this->dataPtr->socket.reset();
+    return false;
+  }
+
+  std::random_device device;
+  this->dataPtr->topicHash = Hash(_topic);
+  this->dataPtr->publisherHash = Hash(_publisher);
+  this->dataPtr->source = device();
+  this->dataPtr->seq = 0;
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool DatagramChannel::OpenReceiver(const std::string &_topic,
+    const std::string &_publisher, const std::string &_group,
+    const unsigned int _port, const ReadCallback &_cb)
+{
+  this->Close();
+
+  try
+  {
+    this->dataPtr->socket.reset(
+        new boost::asio::ip::udp::socket(this->dataPtr->io));
+    boost::asio::ip::udp::endpoint endpoint(boost::asio::ip::udp::v4(),
+        _port);
+    this->dataPtr->socket->open(endpoint.protocol());
+
+    // Subscribers on the same host share the port of a multicast group
+    this->dataPtr->socket->set_option(
+        boost::asio::ip::udp::socket::reuse_address(true));
+    this->dataPtr->socket->bind(endpoint);
+
+    if (!_group.empty())
+    {
+      this->dataPtr->socket->set_option(boost::asio::ip::multicast::join_group(
+          boost::asio::ip::address::from_string(_group)));
+    }
+  }
+  catch(std::exception &_e)
+  {
+    gzerr << "Unable to receive datagrams of [" << _topic << "] on ["
+          << _group << ":" << _port << "]: " << _e.what() << "\n";
+    this->dataPtr->socket.reset();
+    return false;
+  }
+
+  this->dataPtr->topicHash = Hash(_topic);
+  this->dataPtr->publisherHash = Hash(_publisher);
+  this->dataPtr->callback = _cb;
+  this->dataPtr->io.reset();
+  this->dataPtr->Receive();
+  this->dataPtr->thread.reset(new boost::thread(boost::bind(
+      &boost::asio::io_service::run, &this->dataPtr->io)));
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+void DatagramChannel::Close()
+{
+  this->dataPtr->io.stop();
+  if (this->dataPtr->thread)
+  {
+    if (this->dataPtr->thread->get_id() != boost::this_thread::get_id())
+      this->dataPtr->thread->join();
+    else
+      this->dataPtr->thread->detach();
+    this->dataPtr->thread.reset();
+  }
+
+  if (this->dataPtr->socket)
+  {
+    boost::system::error_code ec;
+    this->dataPtr->socket->close(ec);
+    this->dataPtr->socket.reset();
+  }
+
+  this->dataPtr->sources.clear();
+  this->dataPtr->callback.clear();
+}
+
+//////////////////////////////////////////////////
+bool DatagramChannel::Send(const std::string &_data)
+{
+  if (!this->dataPtr->socket || this->dataPtr->thread)
+    return false;
+
+  const std::size_t count = std::max<std::size_t>(1,
+      (_data.size() + kFragmentPayload - 1) / kFragmentPayload);
+  if (count > kMaxFragments)
+  {
+    gzerr << "Message of " << _data.size() << " bytes is too large to be "
+          << "sent as datagrams\n";
+    return false;
+  }
+
+  const uint32_t seq = this->dataPtr->seq++;
+  char header[kHeaderSize];
+  Put(header, kDatagramMagic, 4);
+  Put(header + 4, this->dataPtr->topicHash, 4);
+  Put(header + 8, this->dataPtr->publisherHash, 4);
+  Put(header + 12, this->dataPtr->source, 4);
+  Put(header + 16, seq, 4);
+  Put(header + 22, static_cast<uint32_t>(count), 2);
+
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    Put(header + 20, static_cast<uint32_t>(i), 2);
+    const std::size_t offset = i * kFragmentPayload;
+    const std::size_t size = std::min(kFragmentPayload,
+        _data.size() - offset);
+
+    // Gather-write the header and payload
+    std::vector<boost::asio::const_buffer> buffers;
+    buffers.push_back(boost::asio::buffer(header, kHeaderSize));
+    buffers.push_back(boost::asio::buffer(_data.data() + offset, size));
+
+    boost::system::error_code ec;
+    this->dataPtr->socket->send_to(buffers, this->dataPtr->destination, 0,
+        ec);
+    if (ec)
+      return false;
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+unsigned int DatagramChannel::LocalPort() const
+{
+  if (!this->dataPtr->socket)
+    return 0;
+
+  boost::system::error_code ec;
+  boost::asio::ip::udp::endpoint endpoint =
+      this->dataPtr->socket->local_endpoint(ec);
+  return ec ? 0 : endpoint.port();
+}
+
+//////////////////////////////////////////////////
+uint64_t DatagramChannel::DroppedCount() const
+{
+  return this->dataPtr->dropped;
+}
+
+//////////////////////////////////////////////////
+bool DatagramChannel::Configured(const std::string &_topic,
+    std::string &_group, unsigned int &_port)
+{
+  const char *topicsEnv = getenv("GAZEBO_DATAGRAM_TOPICS");
+  if (!topicsEnv || std::string(topicsEnv).empty())
+    return false;
+
+  std::vector<std::string> topics;
+  boost::split(topics, topicsEnv, boost::is_any_of(","));
+
+  bool found = false;
+  for (auto &topic : topics)
+  {
+    boost::trim(topic);
+    if (topic.empty())
+      continue;
+
+    if (_topic == topic || boost::ends_with(_topic, "/" + topic))
+    {
+      found = true;
+      break;
+    }
+  }
+
+  if (!found)
+    return false;
+
+  const char *groupEnv = getenv("GAZEBO_DATAGRAM_GROUP");
+  _group = groupEnv ? groupEnv : "";
+  _port = 0;
+  if (_group.empty())
+    return true;
+
+  unsigned int basePort = kDefaultPort;
+  const char *portEnv = getenv("GAZEBO_DATAGRAM_PORT");
+  if (portEnv && !std::string(portEnv).empty())
+  {
+    try
+    {
+      basePort = boost::lexical_cast<unsigned int>(portEnv);
+    }
+    catch(boost::bad_lexical_cast &)
+    {
+      gzerr << "Invalid GAZEBO_DATAGRAM_PORT [" << portEnv << "]\n";
+    }
+  }
+
+  _port = basePort + Hash(_topic) % kPortRange;
+  return true;
+}
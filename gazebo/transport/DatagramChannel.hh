@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_TRANSPORT_DATAGRAMCHANNEL_HH_
+#define GAZEBO_TRANSPORT_DATAGRAMCHANNEL_HH_
+
+#include <boost/function.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace transport
+  {
+    // Forward declare private data class.
+    class DatagramChannelPrivate;
+
+    /// \addtogroup gazebo_transport
+    /// \{
+
+    /// \class DatagramChannel DatagramChannel.hh transport/transport.hh
+    /// \brief Unreliable, latest-only delivery of the messages of a topic
+    /// over UDP, to a multicast group or to a single subscriber.
+    ///
+    /// Messages larger than a datagram are split into fragments. A
+    /// receiver only delivers complete messages, newer than the last one
+    /// it delivered: a message missing a fragment is dropped as soon as a
+    /// fragment of a newer message arrives. The latched message of a topic
+    /// is still sent over the subscriber's connection.
+    ///
+    /// \remarks
+    ///  Environment Variables:
+    ///   - GAZEBO_DATAGRAM_TOPICS: Comma separated list of topics sent over
+    /// UDP, such as "pose/info,pose/local/info". A topic matches if it is
+    /// equal to an entry, or ends with "/" followed by the entry. It must
+    /// be set on both the publisher and the subscribers.
+    ///   - GAZEBO_DATAGRAM_GROUP: Multicast group the publishers send to,
+    /// such as 239.255.0.43, so that one datagram serves all the
+    /// subscribers on the LAN. Leave this empty to send a datagram to each
+    /// subscriber instead.
+    ///   - GAZEBO_DATAGRAM_PORT: First port of the multicast group. Each
+    /// topic uses a port derived from its name, in the 1000 ports from
+    /// this one. Defaults to 11400.
+    class GZ_TRANSPORT_VISIBLE DatagramChannel
+    {
+      /// \brief The signature of a read callback
+      public: typedef boost::function<void(const std::string &_data)>
+              ReadCallback;
+
+      /// \brief Constructor
+      public: DatagramChannel();
+
+      /// \brief Destructor, closes the channel.
+      public: ~DatagramChannel();
+
+      /// \brief Open the channel for sending.
+      /// \param[in] _topic Topic of the messages.
+      /// \param[in] _publisher Address and port of the publisher's
+      /// server, as advertised, which identifies its messages.
+      /// \param[in] _address Multicast group, or address of the
+      /// subscriber.
+      /// \param[in] _port Port of the multicast group or subscriber.
+      /// \return True if the channel was opened.
+      public: bool OpenSender(const std::string &_topic,
+                  const std::string &_publisher, const std::string &_address,
+                  const unsigned int _port);
+
+      /// \brief Open the channel for receiving, and start delivering the
+      /// messages to a callback, from a thread of the channel.
+      /// \param[in] _topic Topic of the messages.
+      /// \param[in] _publisher Address and port of the publisher's
+      /// server, as advertised. Messages of other publishers are ignored.
+      /// \param[in] _group Multicast group to join, or empty to receive
+      /// datagrams sent to this host.
+      /// \param[in] _port Port to listen on, or 0 to pick any, see
+      /// LocalPort.
+      /// \param[in] _cb Callback invoked with each complete message.
+      /// \return True if the channel was opened.
+      public: bool OpenReceiver(const std::string &_topic,
+                  const std::string &_publisher, const std::string &_group,
+                  const unsigned int _port, const ReadCallback &_cb);
+
+      /// \brief Close the channel. Waits for a callback being invoked.
+      public: void Close();
+
+      /// \brief Send a message.
+      /// \param[in] _data The message.
+      /// \return False if the channel isn't open for sending or a
+      /// datagram couldn't be sent.
+      public: bool Send(const std::string &_data);
+
+      /// \brief Get the port the channel is bound to.
+      /// \return The port, 0 if the channel isn't open.
+      public: unsigned int LocalPort() const;
+
+      /// \brief Get the number of messages a receiver dropped because some
+      /// of their fragments didn't arrive before a newer message.
+      /// \return Number of dropped messages.
+      public: uint64_t DroppedCount() const;
+
+      /// \brief Get whether a topic is sent over UDP, from
+      /// GAZEBO_DATAGRAM_TOPICS, and where.
+      /// \param[in] _topic Fully qualified name of the topic.
+      /// \param[out] _group Multicast group, empty to send to each
+      /// subscriber.
+      /// \param[out] _port Port of the multicast group, 0 if _group is
+      /// empty.
+      /// \return True if the topic is sent over UDP.
+      public: static bool Configured(const std::string &_topic,
+                  std::string &_group, unsigned int &_port);
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<DatagramChannelPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
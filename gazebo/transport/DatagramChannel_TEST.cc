@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "gazebo/transport/DatagramChannel.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class DatagramChannel : public gazebo::testing::AutoLogFixture
+{
+  /// \brief Store a received message.
+  /// \param[in] _data The message.
+  public: void OnRead(const std::string &_data)
+  {
+    boost::mutex::scoped_lock lock(this->mutex);
+    this->received.push_back(_data);
+    this->condition.notify_all();
+  }
+
+  /// \brief Wait for a number of messages.
+  /// \param[in] _count Number of messages.
+  /// \return True if the messages were received in time.
+  public: bool WaitFor(const std::size_t _count)
+  {
+    boost::mutex::scoped_lock lock(this->mutex);
+    while (this->received.size() < _count)
+    {
+      if (!this->condition.timed_wait(lock,
+            boost::posix_time::seconds(2)))
+      {
+        return this->received.size() >= _count;
+      }
+    }
+    return true;
+  }
+
+  /// \brief Protects received.
+  public: boost::mutex mutex;
+
+  /// \brief Signaled when a message is received.
+  public: boost::condition_variable condition;
+
+  /// \brief Received messages.
+  public: std::vector<std::string> received;
+};
+
+/////////////////////////////////////////////////
+TEST_F(DatagramChannel, NotOpen)
+{
+  transport::DatagramChannel channel;
+  EXPECT_EQ(0u, channel.LocalPort());
+  EXPECT_FALSE(channel.Send("data"));
+  EXPECT_EQ(0u, channel.DroppedCount());
+  EXPECT_FALSE(channel.OpenSender("/gazebo/default/pose/info",
+        "127.0.0.1:11345", "not an address", 11400));
+}
+
+/////////////////////////////////////////////////
+TEST_F(DatagramChannel, Unicast)
+{
+  transport::DatagramChannel receiver;
+  ASSERT_TRUE(receiver.OpenReceiver("/gazebo/default/pose/info",
+        "127.0.0.1:11345", "", 0,
+        boost::bind(&DatagramChannel::OnRead, this, _1)));
+  ASSERT_NE(0u, receiver.LocalPort());
+
+  transport::DatagramChannel sender;
+  ASSERT_TRUE(sender.OpenSender("/gazebo/default/pose/info",
+        "127.0.0.1:11345", "127.0.0.1", receiver.LocalPort()));
+
+  // Messages of other topics and publishers are ignored
+  transport::DatagramChannel other;
+  ASSERT_TRUE(other.OpenSender("/gazebo/default/other",
+        "127.0.0.1:11345", "127.0.0.1", receiver.LocalPort()));
+  EXPECT_TRUE(other.Send("other"));
+  ASSERT_TRUE(other.OpenSender("/gazebo/default/pose/info",
+        "127.0.0.1:11346", "127.0.0.1", receiver.LocalPort()));
+  EXPECT_TRUE(other.Send("other"));
+
+  // Large messages are fragmented
+  std::string large(10000, 'a');
+  for (std::size_t i = 0; i < large.size(); ++i)
+    large[i] = static_cast<char>('a' + i % 26);
+
+  EXPECT_TRUE(sender.Send(""));
+  EXPECT_TRUE(sender.Send("small"));
+  EXPECT_TRUE(sender.Send(large));
+  ASSERT_TRUE(this->WaitFor(3));
+
+  // Loopback doesn't lose datagrams
+  boost::mutex::scoped_lock lock(this->mutex);
+  ASSERT_EQ(3u, this->received.size());
+  EXPECT_TRUE(this->received[0].empty());
+  EXPECT_EQ("small", this->received[1]);
+  EXPECT_EQ(large, this->received[2]);
+  EXPECT_EQ(0u, receiver.DroppedCount());
+}
+
+/////////////////////////////////////////////////
+#ifndef _WIN32
+TEST_F(DatagramChannel, Configured)
+{
+  std::string group;
+  unsigned int port = 1;
+
+  unsetenv("GAZEBO_DATAGRAM_TOPICS");
+  unsetenv("GAZEBO_DATAGRAM_GROUP");
+  unsetenv("GAZEBO_DATAGRAM_PORT");
+  EXPECT_FALSE(transport::DatagramChannel::Configured(
+        "/gazebo/default/pose/info", group, port));
+
+  setenv("GAZEBO_DATAGRAM_TOPICS", "pose/info, /gazebo/default/laser", 1);
+  EXPECT_TRUE(transport::DatagramChannel::Configured(
+        "/gazebo/default/pose/info", group, port));
+  EXPECT_TRUE(group.empty());
+  EXPECT_EQ(0u, port);
+  EXPECT_TRUE(transport::DatagramChannel::Configured(
+        "/gazebo/default/laser", group, port));
+  EXPECT_FALSE(transport::DatagramChannel::Configured(
+        "/gazebo/default/local/pose/information", group, port));
+  EXPECT_FALSE(transport::DatagramChannel::Configured(
+        "/gazebo/default/mypose/info", group, port));
+
+  // Each topic gets a port of the group
+  setenv("GAZEBO_DATAGRAM_GROUP", "239.255.0.43", 1);
+  setenv("GAZEBO_DATAGRAM_PORT", "20000", 1);
+  EXPECT_TRUE(transport::DatagramChannel::Configured(
+        "/gazebo/default/pose/info", group, port));
+  EXPECT_EQ("239.255.0.43", group);
+  EXPECT_GE(port, 20000u);
+  EXPECT_LT(port, 21000u);
+
+  unsigned int otherPort = 0;
+  EXPECT_TRUE(transport::DatagramChannel::Configured(
+        "/gazebo/default/pose/info", group, otherPort));
+  EXPECT_EQ(port, otherPort);
+
+  unsetenv("GAZEBO_DATAGRAM_TOPICS");
+  unsetenv("GAZEBO_DATAGRAM_GROUP");
+  unsetenv("GAZEBO_DATAGRAM_PORT");
+}
+#endif
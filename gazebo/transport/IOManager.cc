@@ -14,10 +14,16 @@
  * limitations under the License.
  *
 */
+#include <stdlib.h>
 #include <atomic>
 #include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/thread/thread.hpp>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "gazebo/common/Console.hh"
 #include "gazebo/transport/IOManager.hh"
 
 namespace gazebo
@@ -27,29 +33,60 @@ namespace transport
 /////////////////////////////////////////////////
 class IOManagerPrivate
 {
-  /// \brief IO service.
-  public: boost::asio::io_service *io_service = nullptr;
+  /// \brief IO services, one per thread.
+  public: std::vector<std::unique_ptr<boost::asio::io_service>> services;
 
-  /// \brief Use io_service::work to keep the io_service running in thread.
-  public: boost::asio::io_service::work *work = nullptr;
+  /// \brief Use io_service::work to keep the io_services running in their
+  /// threads.
+  public: std::vector<std::unique_ptr<boost::asio::io_service::work>> works;
 
   /// \brief Reference count of connections using this IOManager.
   public: std::atomic_int count;
 
-  /// \brief Thread for IOManager.
-  public: boost::thread *thread = nullptr;
+  /// \brief Threads running the IO services.
+  public: std::vector<std::unique_ptr<boost::thread>> threads;
 };
 
+/////////////////////////////////////////////////
+/// \brief Get the number of IO threads from GAZEBO_IO_THREADS.
+/// \return Number of IO threads, at least 1.
+static unsigned int ConfiguredThreadCount()
+{
+  const char *env = getenv("GAZEBO_IO_THREADS");
+  if (!env || std::string(env).empty())
+    return 1;
+
+  try
+  {
+    const unsigned int count = boost::lexical_cast<unsigned int>(env);
+    if (count > 0)
+      return count;
+  }
+  catch(boost::bad_lexical_cast &)
+  {
+  }
+
+  gzerr << "Invalid GAZEBO_IO_THREADS [" << env << "], using 1 IO thread\n";
+  return 1;
+}
+
 /////////////////////////////////////////////////
 IOManager::IOManager()
   : dataPtr(new IOManagerPrivate)
 {
-  this->dataPtr->io_service = new boost::asio::io_service;
-  this->dataPtr->work = new boost::asio::io_service::work(
-      *this->dataPtr->io_service);
   this->dataPtr->count = 0;
-  this->dataPtr->thread = new boost::thread(boost::bind(
-      &boost::asio::io_service::run, this->dataPtr->io_service));
+
+  const unsigned int threadCount = ConfiguredThreadCount();
+  for (unsigned int i = 0; i < threadCount; ++i)
+  {
+    this->dataPtr->services.emplace_back(new boost::asio::io_service);
+    boost::asio::io_service *service = this->dataPtr->services.back().get();
+
+    this->dataPtr->works.emplace_back(
+        new boost::asio::io_service::work(*service));
+    this->dataPtr->threads.emplace_back(new boost::thread(boost::bind(
+        &boost::asio::io_service::run, service)));
+  }
 }
 
 /////////////////////////////////////////////////
@@ -57,11 +94,8 @@ IOManager::~IOManager()
 {
   this->Stop();
 
-  delete this->dataPtr->work;
-  this->dataPtr->work = nullptr;
-
-  delete this->dataPtr->io_service;
-  this->dataPtr->io_service = nullptr;
+  this->dataPtr->works.clear();
+  this->dataPtr->services.clear();
 
   delete this->dataPtr;
   this->dataPtr = nullptr;
@@ -70,20 +104,33 @@ IOManager::~IOManager()
 /////////////////////////////////////////////////
 void IOManager::Stop()
 {
-  this->dataPtr->io_service->reset();
-  this->dataPtr->io_service->stop();
-  if (this->dataPtr->thread)
+  for (auto &service : this->dataPtr->services)
   {
-    this->dataPtr->thread->join();
-    delete this->dataPtr->thread;
-    this->dataPtr->thread = nullptr;
+    service->reset();
+    service->stop();
   }
+
+  for (auto &thread : this->dataPtr->threads)
+    thread->join();
+  this->dataPtr->threads.clear();
 }
 
 /////////////////////////////////////////////////
 boost::asio::io_service &IOManager::GetIO()
 {
-  return *this->dataPtr->io_service;
+  return *this->dataPtr->services.front();
+}
+
+/////////////////////////////////////////////////
+boost::asio::io_service &IOManager::GetIO(const unsigned int _shard)
+{
+  return *this->dataPtr->services[_shard % this->dataPtr->services.size()];
+}
+
+/////////////////////////////////////////////////
+unsigned int IOManager::ThreadCount() const
+{
+  return static_cast<unsigned int>(this->dataPtr->services.size());
 }
 
 /////////////////////////////////////////////////
@@ -32,6 +32,13 @@ namespace gazebo
 
     /// \class IOManager IOManager.hh transport/transport.hh
     /// \brief Manages boost::asio IO
+    ///
+    /// \remarks
+    ///  Environment Variables:
+    ///   - GAZEBO_IO_THREADS: Number of IO threads, each running its own
+    /// IO service. Connections are spread across them, and when there is
+    /// more than one, the messages read by a connection are handled on
+    /// its IO thread, in order, instead of by TBB tasks. Defaults to 1.
     class GZ_TRANSPORT_VISIBLE IOManager
     {
       /// \brief Constructor
@@ -44,6 +51,18 @@ namespace gazebo
       /// \return Handle to boost::asio IO service
       public: boost::asio::io_service &GetIO();
 
+      /// \brief Get the IO service of a shard. All the asynchronous
+      /// operations of a connection should use the same shard, so that
+      /// its handlers run on the same thread.
+      /// \param[in] _shard Shard number, such as a connection id. Any
+      /// number is valid, shards wrap around the number of IO threads.
+      /// \return Handle to boost::asio IO service
+      public: boost::asio::io_service &GetIO(const unsigned int _shard);
+
+      /// \brief Get the number of IO threads.
+      /// \return Number of IO services, each run by its own thread.
+      public: unsigned int ThreadCount() const;
+
       /// \brief Increment the event count by 1
       public: void IncCount();
 
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+
+#include "gazebo/transport/IOManager.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class IOManager : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+#ifndef _WIN32
+TEST_F(IOManager, ThreadCount)
+{
+  unsetenv("GAZEBO_IO_THREADS");
+  {
+    transport::IOManager manager;
+    EXPECT_EQ(1u, manager.ThreadCount());
+    EXPECT_EQ(&manager.GetIO(), &manager.GetIO(0));
+    EXPECT_EQ(&manager.GetIO(), &manager.GetIO(7));
+  }
+
+  setenv("GAZEBO_IO_THREADS", "3", 1);
+  {
+    transport::IOManager manager;
+    EXPECT_EQ(3u, manager.ThreadCount());
+    EXPECT_EQ(&manager.GetIO(), &manager.GetIO(0));
+    EXPECT_NE(&manager.GetIO(0), &manager.GetIO(1));
+    EXPECT_NE(&manager.GetIO(1), &manager.GetIO(2));
+    EXPECT_EQ(&manager.GetIO(1), &manager.GetIO(4));
+  }
+
+  setenv("GAZEBO_IO_THREADS", "none", 1);
+  {
+    transport::IOManager manager;
+    EXPECT_EQ(1u, manager.ThreadCount());
+  }
+
+  unsetenv("GAZEBO_IO_THREADS");
+}
+#endif
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -15,9 +15,13 @@
  *
 */
 
+#include <memory>
+#include <string>
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
 #include "gazebo/common/WeakBind.hh"
+#include "gazebo/transport/DatagramChannel.hh"
+#include "gazebo/transport/Publisher.hh"
 #include "SubscriptionTransport.hh"
 #include "Publication.hh"
 #include "Node.hh"
@@ -295,6 +299,8 @@ int Publication::Publish(MessagePtr _msg, boost::function<void(uint32_t)> _cb,
   int result = 0;
   std::list<NodePtr>::iterator iter, endIter;
 
+  this->messageCount.fetch_add(1, std::memory_order_relaxed);
+
   {
     boost::mutex::scoped_lock lock(this->nodeMutex);
 
@@ -319,14 +325,48 @@ int Publication::Publish(MessagePtr _msg, boost::function<void(uint32_t)> _cb,
 
     if (!this->callbacks.empty())
     {
-      std::string data;
-      _msg->SerializeToString(&data);
+      // Local callbacks get the message itself. It's only serialized,
+      // once, if a remote subscriber needs it, and shared by the
+      // connections that queue it.
+      std::shared_ptr<const std::string> sharedData;
+      bool multicastSent = false;
       std::list<CallbackHelperPtr>::iterator cbIter;
       cbIter = this->callbacks.begin();
 
       while (cbIter != this->callbacks.end())
       {
-        if ((*cbIter)->HandleData(data, _cb, _id))
+        bool handled;
+        if ((*cbIter)->IsLocal())
+        {
+          handled = (*cbIter)->HandleMessage(_msg);
+          if (handled && !_cb.empty())
+            _cb(_id);
+        }
+        else
+        {
+          if (!sharedData)
+          {
+            std::shared_ptr<std::string> data =
+                std::make_shared<std::string>();
+            _msg->SerializeToString(data.get());
+            sharedData = data;
+            this->byteCount.fetch_add(data->size(),
+                std::memory_order_relaxed);
+          }
+
+          // One datagram serves all the multicast subscribers
+          SubscriptionTransport *subLink =
+              dynamic_cast<SubscriptionTransport *>(cbIter->get());
+          if (subLink && subLink->IsMulticast() && !multicastSent)
+          {
+            this->SendMulticast(*sharedData, subLink->DatagramPublisher());
+            multicastSent = true;
+          }
+
+          handled = (*cbIter)->HandleSharedData(sharedData, _cb, _id);
+        }
+
+        if (handled)
         {
           ++result;
           ++cbIter;
@@ -349,6 +389,29 @@ int Publication::Publish(MessagePtr _msg, boost::function<void(uint32_t)> _cb,
   return result;
 }
 
+//////////////////////////////////////////////////
+void Publication::SendMulticast(const std::string &_data,
+    const std::string &_publisher)
+{
+  if (!this->datagrams)
+  {
+    std::string group;
+    unsigned int port;
+    if (!DatagramChannel::Configured(this->topic, group, port) ||
+        group.empty())
+    {
+      return;
+    }
+
+    // If the group can't be opened, Send keeps failing and the error is
+    // only reported once
+    this->datagrams.reset(new DatagramChannel());
+    this->datagrams->OpenSender(this->topic, _publisher, group, port);
+  }
+
+  this->datagrams->Send(_data);
+}
+
 //////////////////////////////////////////////////
 std::string Publication::GetMsgType() const
 {
@@ -417,6 +480,45 @@ void Publication::AddPublisher(PublisherPtr _pub)
   this->publishers.push_back(_pub);
 }
 
+//////////////////////////////////////////////////
+void Publication::RecordDrop()
+{
+  this->dropCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+void Publication::RecordLatency(const uint64_t _ns)
+{
+  this->latency.Record(_ns);
+}
+
+//////////////////////////////////////////////////
+void Publication::FillStatistics(msgs::TransportStats::Topic &_msg) const
+{
+  _msg.set_name(this->topic);
+  _msg.set_msg_type(this->msgType);
+  _msg.set_messages(this->messageCount.load(std::memory_order_relaxed));
+  _msg.set_bytes(this->byteCount.load(std::memory_order_relaxed));
+  _msg.set_message_rate(0);
+  _msg.set_byte_rate(0);
+  _msg.set_dropped(this->dropCount.load(std::memory_order_relaxed));
+
+  unsigned int queued = 0;
+  {
+    boost::mutex::scoped_lock lock(this->callbackMutex);
+    for (auto const &pub : this->publishers)
+      queued += pub->GetOutgoingCount();
+  }
+  _msg.set_queued(queued);
+
+  if (this->latency.Count() > 0)
+  {
+    _msg.set_latency_p50(this->latency.Percentile(50) * 1e-9);
+    _msg.set_latency_p99(this->latency.Percentile(99) * 1e-9);
+    _msg.set_latency_max(this->latency.Max() * 1e-9);
+  }
+}
+
 //////////////////////////////////////////////////
 void Publication::RemovePublisher(PublisherPtr _pub)
 {
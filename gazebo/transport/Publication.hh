@@ -18,15 +18,19 @@
 #ifndef _PUBLICATION_HH_
 #define _PUBLICATION_HH_
 
+#include <atomic>
 #include <utility>
 #include <boost/function.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/thread/mutex.hpp>
 #include <list>
+#include <memory>
 #include <string>
 #include <vector>
 #include <map>
 
+#include "gazebo/common/LatencyHistogram.hh"
+#include "gazebo/msgs/transport_stats.pb.h"
 #include "gazebo/transport/CallbackHelper.hh"
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/transport/PublicationTransport.hh"
@@ -36,6 +40,8 @@ namespace gazebo
 {
   namespace transport
   {
+    class DatagramChannel;
+
     /// \addtogroup gazebo_transport
     /// \{
 
@@ -164,9 +170,30 @@ namespace gazebo
       /// \param[in,out] _pub Pointer to publisher object to be added
       public: void AddPublisher(PublisherPtr _pub);
 
+      /// \brief Count a message dropped by a publisher because its queue
+      /// was full.
+      public: void RecordDrop();
+
+      /// \brief Record how long a message waited in its publisher before
+      /// it was published.
+      /// \param[in] _ns Nanoseconds.
+      public: void RecordLatency(const uint64_t _ns);
+
+      /// \brief Get the counters of the publication, since it was created.
+      /// The rates are left to the caller.
+      /// \param[out] _msg Counters of the topic.
+      public: void FillStatistics(msgs::TransportStats::Topic &_msg) const;
+
       /// \brief Remove nodes that have been marked for removal
       private: void RemoveNodes();
 
+      /// \brief Send a message to the multicast group of the topic.
+      /// \param[in] _data The message.
+      /// \param[in] _publisher Address and port of this publisher, as
+      /// advertised.
+      private: void SendMulticast(const std::string &_data,
+                   const std::string &_publisher);
+
       /// \brief Unique if of the publication.
       private: unsigned int id;
 
@@ -211,6 +238,22 @@ namespace gazebo
 
       /// \brief Publishers and their last messages.
       private: std::map<uint32_t, MessagePtr> prevMsgs;
+
+      /// \brief Sender to the multicast group of the topic, opened when
+      /// the first subscriber receives from it.
+      private: std::unique_ptr<DatagramChannel> datagrams;
+
+      /// \brief Number of messages published.
+      private: std::atomic<uint64_t> messageCount{0};
+
+      /// \brief Number of bytes serialized for remote subscribers.
+      private: std::atomic<uint64_t> byteCount{0};
+
+      /// \brief Number of messages dropped by the publishers.
+      private: std::atomic<uint64_t> dropCount{0};
+
+      /// \brief Time the messages waited in the publishers.
+      private: common::LatencyHistogram latency;
     };
     /// \}
   }
@@ -14,11 +14,25 @@
  * limitations under the License.
  *
 */
+#ifdef _WIN32
+  #include <process.h>
+  #define getpid _getpid
+#else
+  #include <unistd.h>
+#endif
+
+#include <stdlib.h>
+#include <boost/algorithm/string.hpp>
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
+#include <boost/lexical_cast.hpp>
+#include <string>
+#include <vector>
 #include "gazebo/transport/TopicManager.hh"
 #include "gazebo/transport/ConnectionManager.hh"
+#include "gazebo/transport/DatagramChannel.hh"
 #include "gazebo/transport/PublicationTransport.hh"
+#include "gazebo/transport/ShmRing.hh"
 #include "gazebo/common/WeakBind.hh"
 
 using namespace gazebo;
@@ -26,6 +40,10 @@ using namespace transport;
 
 int PublicationTransport::counter = 0;
 
+/// \brief Time a read of the shared memory ring waits for a message, in
+/// milliseconds.
+static const unsigned int kRingReadTimeout = 100;
+
 /////////////////////////////////////////////////
 PublicationTransport::PublicationTransport(const std::string &_topic,
                                            const std::string &_msgType)
@@ -38,6 +56,9 @@ PublicationTransport::PublicationTransport(const std::string &_topic,
 /////////////////////////////////////////////////
 PublicationTransport::~PublicationTransport()
 {
+  this->StopRing();
+  this->StopDatagrams();
+
   if (this->connection)
   {
     msgs::Subscribe sub;
@@ -65,8 +86,59 @@ void PublicationTransport::Init(const ConnectionPtr &_conn, bool _latched)
   sub.set_port(this->connection->GetLocalPort());
   sub.set_latching(_latched);
 
+  // Offer a shared memory ring to a publisher on the same host. If the
+  // publisher can't open it, it keeps using the connection.
+  const std::size_t capacity = ShmRing::ConfiguredCapacity();
+  if (capacity > 0 && !this->ring &&
+      this->connection->GetRemoteAddress() ==
+      this->connection->GetLocalAddress())
+  {
+    const std::string name = "gazebo_" + std::to_string(getpid()) + "_" +
+        std::to_string(this->id);
+    this->ring.reset(new ShmRing());
+    if (this->ring->Create(name, capacity))
+    {
+      sub.set_shm_name(name);
+      this->ringThread.reset(new boost::thread(
+            boost::bind(&PublicationTransport::RingLoop, this)));
+    }
+    else
+      this->ring.reset();
+  }
+
+  // Tell the publisher where to send the messages over UDP
+  if (!this->ring && !this->datagramPublisher.empty() && !this->datagrams)
+  {
+    this->datagrams.reset(new DatagramChannel());
+    if (this->datagrams->OpenReceiver(this->topic, this->datagramPublisher,
+          this->datagramGroup,
+          this->datagramGroup.empty() ? 0 : this->datagramPort,
+          boost::bind(&PublicationTransport::OnDatagram, this, _1)))
+    {
+      sub.set_datagram_port(this->datagrams->LocalPort());
+    }
+    else
+      this->datagrams.reset();
+  }
+
+  double maxRate;
+  unsigned int queueLimit;
+  if (ConfiguredQoS(this->topic, maxRate, queueLimit))
+  {
+    sub.set_max_rate(maxRate);
+    sub.set_queue_limit(queueLimit);
+  }
+
   this->connection->EnqueueMsg(msgs::Package("sub", sub));
 
+  // The messages are handled in order, in parallel with the other topics
+  if (!this->strand)
+  {
+    this->strand = std::make_shared<Strand>(
+        ConfiguredCoalesce(this->topic));
+    this->connection->SetReadStrand(this->strand);
+  }
+
   // Put this in PublicationTransportPtr
   // Start reading messages from the remote publisher
   this->connection->AsyncRead(common::weakBind(&PublicationTransport::OnPublish,
@@ -74,10 +146,20 @@ void PublicationTransport::Init(const ConnectionPtr &_conn, bool _latched)
 }
 
 
+/////////////////////////////////////////////////
+void PublicationTransport::InitDatagrams(const std::string &_publisher,
+    const std::string &_group, const unsigned int _port)
+{
+  this->datagramPublisher = _publisher;
+  this->datagramGroup = _group;
+  this->datagramPort = _port;
+}
+
 /////////////////////////////////////////////////
 void PublicationTransport::AddCallback(
     const boost::function<void(const std::string &)> &cb_)
 {
+  boost::mutex::scoped_lock lock(this->callbackMutex);
   this->callback = cb_;
 }
 
@@ -92,12 +174,168 @@ void PublicationTransport::OnPublish(const std::string &_data)
 
     if (!_data.empty())
     {
-      if (this->callback)
+      // Messages announced in the shared memory ring are handled by its
+      // thread, in order with the others
+      if (this->ring && this->ring->HasWriter() && this->ring->IsOpen())
+      {
+        {
+          boost::mutex::scoped_lock lock(this->ringMutex);
+          this->ringConnectionMsgs.push_back(_data);
+        }
+        this->ringCondition.notify_one();
+      }
+      else if (this->callback)
         (this->callback)(_data);
     }
   }
 }
 
+/////////////////////////////////////////////////
+void PublicationTransport::RingLoop()
+{
+  std::string data;
+  while (true)
+  {
+    // Messages written before the ring closed are read first
+    if (!this->ring->Read(data, kRingReadTimeout))
+    {
+      if (!this->ring->IsOpen())
+        break;
+      continue;
+    }
+
+    // An empty message stands for the next message received over the
+    // connection, which was too large for the ring
+    if (data.empty())
+    {
+      boost::mutex::scoped_lock lock(this->ringMutex);
+      while (this->ringConnectionMsgs.empty() && this->ring->IsOpen() &&
+          !transport::is_stopped())
+      {
+        this->ringCondition.timed_wait(lock,
+            boost::posix_time::milliseconds(kRingReadTimeout));
+      }
+
+      if (this->ringConnectionMsgs.empty())
+        break;
+      data.swap(this->ringConnectionMsgs.front());
+      this->ringConnectionMsgs.pop_front();
+    }
+
+    boost::function<void (const std::string &)> cb;
+    {
+      boost::mutex::scoped_lock lock(this->callbackMutex);
+      cb = this->callback;
+    }
+
+    if (cb && !data.empty() && !transport::is_stopped())
+      cb(data);
+  }
+}
+
+/////////////////////////////////////////////////
+void PublicationTransport::StopRing()
+{
+  if (!this->ring)
+    return;
+
+  this->ring->Close();
+  if (this->ringThread)
+  {
+    if (this->ringThread->get_id() != boost::this_thread::get_id())
+      this->ringThread->join();
+    else
+      this->ringThread->detach();
+    this->ringThread.reset();
+  }
+  this->ring.reset();
+}
+
+/////////////////////////////////////////////////
+void PublicationTransport::OnDatagram(const std::string &_data)
+{
+  boost::function<void (const std::string &)> cb;
+  {
+    boost::mutex::scoped_lock lock(this->callbackMutex);
+    cb = this->callback;
+  }
+
+  if (cb && !_data.empty() && !transport::is_stopped())
+    cb(_data);
+}
+
+/////////////////////////////////////////////////
+void PublicationTransport::StopDatagrams()
+{
+  if (this->datagrams)
+  {
+    this->datagrams->Close();
+    this->datagrams.reset();
+  }
+}
+
+/////////////////////////////////////////////////
+bool PublicationTransport::ConfiguredQoS(const std::string &_topic,
+    double &_maxRate, unsigned int &_queueLimit)
+{
+  const char *env = getenv("GAZEBO_SUBSCRIPTION_QOS");
+  if (!env || *env == '\0')
+    return false;
+
+  std::vector<std::string> entries;
+  boost::split(entries, env, boost::is_any_of(","));
+  for (auto &entry : entries)
+  {
+    std::vector<std::string> fields;
+    boost::split(fields, entry, boost::is_any_of("=:"));
+    for (auto &field : fields)
+      boost::trim(field);
+
+    if (fields.size() < 2 || fields.size() > 3 || fields[0].empty() ||
+        (_topic != fields[0] && !boost::ends_with(_topic, "/" + fields[0])))
+    {
+      continue;
+    }
+
+    try
+    {
+      _maxRate = boost::lexical_cast<double>(fields[1]);
+      _queueLimit = fields.size() == 3 ?
+          boost::lexical_cast<unsigned int>(fields[2]) : 0;
+    }
+    catch(boost::bad_lexical_cast &)
+    {
+      gzerr << "Invalid GAZEBO_SUBSCRIPTION_QOS entry [" << entry << "]\n";
+      return false;
+    }
+    return true;
+  }
+
+  return false;
+}
+
+/////////////////////////////////////////////////
+bool PublicationTransport::ConfiguredCoalesce(const std::string &_topic)
+{
+  const char *env = getenv("GAZEBO_SUBSCRIPTION_COALESCE");
+  if (!env || *env == '\0')
+    return false;
+
+  std::vector<std::string> entries;
+  boost::split(entries, env, boost::is_any_of(","));
+  for (auto &entry : entries)
+  {
+    boost::trim(entry);
+    if (!entry.empty() &&
+        (_topic == entry || boost::ends_with(_topic, "/" + entry)))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 /////////////////////////////////////////////////
 const ConnectionPtr PublicationTransport::GetConnection() const
 {
@@ -119,6 +357,9 @@ std::string PublicationTransport::GetMsgType() const
 /////////////////////////////////////////////////
 void PublicationTransport::Fini()
 {
+  this->StopRing();
+  this->StopDatagrams();
+
   /// Cancel all async operatiopns.
   if (this->connection)
   {
@@ -20,6 +20,11 @@
 
 #include <boost/function.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <deque>
+#include <memory>
 #include <string>
 
 #include "gazebo/transport/Connection.hh"
@@ -30,6 +35,9 @@ namespace gazebo
 {
   namespace transport
   {
+    class DatagramChannel;
+    class ShmRing;
+
     /// \addtogroup gazebo_transport
     /// \{
 
@@ -37,6 +45,22 @@ namespace gazebo
     /// transport/transport.hh
     /// \brief Reads data from a remote advertiser, and passes the data
     /// along to local subscribers
+    ///
+    /// \remarks
+    ///  Environment Variables:
+    ///   - GAZEBO_SUBSCRIPTION_QOS: Comma separated list of topics, with the
+    /// quality of service the publishers give this process, such as
+    /// "pose/info=30:1,camera/image=10". Each entry is a topic, matched as
+    /// in GAZEBO_DATAGRAM_TOPICS, the largest rate in Hz, 0 for no limit,
+    /// and optionally the number of messages kept while the connection is
+    /// busy, only the latest ones. Use it for slow subscribers, such as
+    /// GUIs and loggers, so that they don't hold back the publishers.
+    ///   - GAZEBO_SUBSCRIPTION_COALESCE: Comma separated list of topics,
+    /// matched as in GAZEBO_DATAGRAM_TOPICS, whose callbacks only get the
+    /// latest of the messages received while they were busy.
+    ///
+    /// The messages received over the connection are handled in order by
+    /// a Strand, in parallel with the other topics.
     class GZ_TRANSPORT_VISIBLE PublicationTransport :
         public boost::enable_shared_from_this<PublicationTransport>
     {
@@ -49,15 +73,46 @@ namespace gazebo
       /// \brief Destructor
       public: virtual ~PublicationTransport();
 
-      /// \brief Initialize the transport
+      /// \brief Initialize the transport. If GAZEBO_SHM_TRANSPORT is set
+      /// and the publisher is on the same host, a shared memory ring is
+      /// offered to the publisher, which sends the messages through it
+      /// instead of the connection when it can open it.
       /// \param[in] _conn The underlying connection.
       /// \param[in] _latched True to grab the last message sent on the
       /// topic.
       public: void Init(const ConnectionPtr &_conn, bool _latched);
 
+      /// \brief Receive the messages over UDP, as advertised by the
+      /// publisher. Must be called before Init, which tells the publisher
+      /// where to send them. A shared memory ring is preferred if both are
+      /// enabled.
+      /// \param[in] _publisher Address and port of the publisher, as
+      /// advertised.
+      /// \param[in] _group Multicast group, empty to receive the messages
+      /// sent to this host.
+      /// \param[in] _port Port of the multicast group.
+      public: void InitDatagrams(const std::string &_publisher,
+                  const std::string &_group, const unsigned int _port);
+
       /// \brief Finalize the transport
       public: void Fini();
 
+      /// \brief Get the quality of service requested for a topic, from
+      /// GAZEBO_SUBSCRIPTION_QOS.
+      /// \param[in] _topic Fully qualified name of the topic.
+      /// \param[out] _maxRate Largest rate in Hz, 0 for no limit.
+      /// \param[out] _queueLimit Number of messages kept while the
+      /// connection is busy, 0 for no limit.
+      /// \return True if the topic has a quality of service.
+      public: static bool ConfiguredQoS(const std::string &_topic,
+                  double &_maxRate, unsigned int &_queueLimit);
+
+      /// \brief Get whether a topic is in GAZEBO_SUBSCRIPTION_COALESCE.
+      /// \param[in] _topic Fully qualified name of the topic.
+      /// \return True if only the latest of the waiting messages is
+      /// handled.
+      public: static bool ConfiguredCoalesce(const std::string &_topic);
+
       /// \brief Add a callback to the transport
       /// \param[in] _cb The callback to be added
       public: void AddCallback(
@@ -79,6 +134,22 @@ namespace gazebo
       /// \param[in] _data Data to be published.
       private: void OnPublish(const std::string &_data);
 
+      /// \brief Pass the messages read from the shared memory ring to the
+      /// callback, until the ring is closed. Once the publisher opened the
+      /// ring, the messages received over the connection are passed by
+      /// this thread too, where the ring announces them.
+      private: void RingLoop();
+
+      /// \brief Pass a message received over UDP to the callback.
+      /// \param[in] _data The message.
+      private: void OnDatagram(const std::string &_data);
+
+      /// \brief Stop receiving messages over UDP.
+      private: void StopDatagrams();
+
+      /// \brief Close the shared memory ring and wait for its thread.
+      private: void StopRing();
+
       /// \brief The topic for this publication transport.
       private: std::string topic;
 
@@ -88,9 +159,47 @@ namespace gazebo
       /// \brief The connection for the publication transport
       private: ConnectionPtr connection;
 
+      /// \brief Handles the messages received over the connection in
+      /// order.
+      private: std::shared_ptr<Strand> strand;
+
       /// \brief Callback used when OnPublish is called.
       private: boost::function<void (const std::string &)> callback;
 
+      /// \brief Protects the callback from the ring thread.
+      private: boost::mutex callbackMutex;
+
+      /// \brief Shared memory ring offered to the publisher, null if
+      /// messages are only received over the connection.
+      private: std::unique_ptr<ShmRing> ring;
+
+      /// \brief Thread reading the shared memory ring.
+      private: std::unique_ptr<boost::thread> ringThread;
+
+      /// \brief Messages received over the connection, waiting for the
+      /// ring thread to reach them, oldest first.
+      private: std::deque<std::string> ringConnectionMsgs;
+
+      /// \brief Protects ringConnectionMsgs.
+      private: boost::mutex ringMutex;
+
+      /// \brief Signaled when a message is added to ringConnectionMsgs.
+      private: boost::condition_variable ringCondition;
+
+      /// \brief Address and port of the publisher, empty if messages
+      /// aren't received over UDP.
+      private: std::string datagramPublisher;
+
+      /// \brief Multicast group of the messages received over UDP.
+      private: std::string datagramGroup;
+
+      /// \brief Port of the multicast group.
+      private: unsigned int datagramPort = 0;
+
+      /// \brief Receiver of the messages sent over UDP, null if they
+      /// aren't.
+      private: std::unique_ptr<DatagramChannel> datagrams;
+
       /// \brief Counter to give the publication transport a unique id.
       private: static int counter;
 
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+
+#include "gazebo/transport/PublicationTransport.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class PublicationTransport : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+#ifndef _WIN32
+TEST_F(PublicationTransport, ConfiguredQoS)
+{
+  double rate = -1;
+  unsigned int limit = 10;
+
+  unsetenv("GAZEBO_SUBSCRIPTION_QOS");
+  EXPECT_FALSE(transport::PublicationTransport::ConfiguredQoS(
+        "/gazebo/default/pose/info", rate, limit));
+
+  setenv("GAZEBO_SUBSCRIPTION_QOS", "pose/info=30:1, camera/image = 10", 1);
+  EXPECT_TRUE(transport::PublicationTransport::ConfiguredQoS(
+        "/gazebo/default/pose/info", rate, limit));
+  EXPECT_DOUBLE_EQ(30.0, rate);
+  EXPECT_EQ(1u, limit);
+
+  EXPECT_TRUE(transport::PublicationTransport::ConfiguredQoS(
+        "/gazebo/default/box/link/camera/image", rate, limit));
+  EXPECT_DOUBLE_EQ(10.0, rate);
+  EXPECT_EQ(0u, limit);
+
+  EXPECT_FALSE(transport::PublicationTransport::ConfiguredQoS(
+        "/gazebo/default/mypose/info", rate, limit));
+
+  setenv("GAZEBO_SUBSCRIPTION_QOS", "pose/info=fast", 1);
+  EXPECT_FALSE(transport::PublicationTransport::ConfiguredQoS(
+        "/gazebo/default/pose/info", rate, limit));
+
+  unsetenv("GAZEBO_SUBSCRIPTION_QOS");
+}
+
+/////////////////////////////////////////////////
+TEST_F(PublicationTransport, ConfiguredCoalesce)
+{
+  unsetenv("GAZEBO_SUBSCRIPTION_COALESCE");
+  EXPECT_FALSE(transport::PublicationTransport::ConfiguredCoalesce(
+        "/gazebo/default/pose/info"));
+
+  setenv("GAZEBO_SUBSCRIPTION_COALESCE", "pose/info, camera/image", 1);
+  EXPECT_TRUE(transport::PublicationTransport::ConfiguredCoalesce(
+        "/gazebo/default/pose/info"));
+  EXPECT_TRUE(transport::PublicationTransport::ConfiguredCoalesce(
+        "/gazebo/default/box/link/camera/image"));
+  EXPECT_FALSE(transport::PublicationTransport::ConfiguredCoalesce(
+        "/gazebo/default/mypose/info"));
+  EXPECT_FALSE(transport::PublicationTransport::ConfiguredCoalesce(
+        "/gazebo/default/world_stats"));
+
+  unsetenv("GAZEBO_SUBSCRIPTION_COALESCE");
+}
+#endif
@@ -35,11 +35,10 @@ uint32_t Publisher::idCounter = 0;
 //////////////////////////////////////////////////
 Publisher::Publisher(const std::string &_topic, const std::string &_msgType,
                      unsigned int _limit, double _hzRate)
-  : topic(_topic), msgType(_msgType), queueLimit(_limit),
-    updatePeriod(0)
+  : topic(_topic), msgType(_msgType), queueLimit(_limit)
 {
   if (!ignition::math::equal(_hzRate, 0.0))
-    this->updatePeriod = 1.0 / _hzRate;
+    this->updatePeriod = common::NanoTime::FromSeconds(1.0 / _hzRate);
 
   this->queueLimitWarned = false;
   this->pubId = 0;
@@ -60,6 +59,19 @@ bool Publisher::HasConnections() const
        this->publication->GetNodeCount() > 0));
 }
 
+//////////////////////////////////////////////////
+bool Publisher::ReadyToPublish() const
+{
+  if (this->updatePeriod <= common::NanoTime() ||
+      this->prevPublishTime == common::NanoTime())
+  {
+    return true;
+  }
+
+  return common::NanoTime(common::Time::GetWallTime()) -
+      this->prevPublishTime >= this->updatePeriod;
+}
+
 //////////////////////////////////////////////////
 void Publisher::WaitForConnection() const
 {
@@ -86,6 +98,31 @@ bool Publisher::WaitForConnection(const common::Time &_timeout) const
 //////////////////////////////////////////////////
 void Publisher::PublishImpl(const google::protobuf::Message &_message,
                             bool _block)
+{
+  if (!this->ValidateMessage(_message))
+    return;
+
+  MessagePtr msgPtr(_message.New());
+  msgPtr->CopyFrom(_message);
+
+  this->QueueMessage(msgPtr, _block);
+}
+
+//////////////////////////////////////////////////
+void Publisher::PublishImpl(MessagePtr _message, bool _block)
+{
+  if (!_message)
+  {
+    gzerr << "Publishing a null message on topic[" << this->topic << "]\n";
+    return;
+  }
+
+  if (this->ValidateMessage(*_message))
+    this->QueueMessage(_message, _block);
+}
+
+//////////////////////////////////////////////////
+bool Publisher::ValidateMessage(const google::protobuf::Message &_message)
 {
   if (_message.GetTypeName() != this->msgType)
     gzthrow("Invalid message type\n");
@@ -95,41 +132,49 @@ void Publisher::PublishImpl(const google::protobuf::Message &_message,
     gzerr << "Publishing an uninitialized message on topic[" <<
       this->topic << "]. Required field [" <<
       _message.InitializationErrorString() << "] missing.\n";
-    return;
+    return false;
   }
 
   // Check if a throttling rate has been set
-  if (this->updatePeriod > 0)
+  if (this->updatePeriod > common::NanoTime())
   {
     // Get the current time
-    this->currentTime = common::Time::GetWallTime();
+    this->currentTime = common::NanoTime(common::Time::GetWallTime());
 
     // Skip publication if the time difference is less than the update period.
-    if (this->prevPublishTime != common::Time(0, 0) &&
-        (this->currentTime - this->prevPublishTime).Double() <
-        this->updatePeriod)
+    if (this->prevPublishTime != common::NanoTime() &&
+        this->currentTime - this->prevPublishTime < this->updatePeriod)
     {
-      return;
+      return false;
     }
 
     // Set the previous time a message was published
     this->prevPublishTime = this->currentTime;
   }
 
-  // Save the latest message
-  MessagePtr msgPtr(_message.New());
-  msgPtr->CopyFrom(_message);
+  return true;
+}
 
-  this->publication->SetPrevMsg(this->id, msgPtr);
+//////////////////////////////////////////////////
+void Publisher::QueueMessage(MessagePtr _message, bool _block)
+{
+  // Save the latest message
+  this->publication->SetPrevMsg(this->id, _message);
 
+  bool added = false;
   {
     boost::mutex::scoped_lock lock(this->mutex);
 
-    this->messages.push_back(msgPtr);
+    this->messages.push_back(_message);
+    this->messageTimes.push_back(std::chrono::steady_clock::now());
+    added = !this->ready;
+    this->ready = true;
 
     if (this->messages.size() > this->queueLimit)
     {
       this->messages.pop_front();
+      this->messageTimes.pop_front();
+      this->publication->RecordDrop();
 
       if (!queueLimitWarned)
       {
@@ -142,7 +187,9 @@ void Publisher::PublishImpl(const google::protobuf::Message &_message,
     }
   }
 
-  TopicManager::Instance()->AddNodeToProcess(this->node);
+  // Only the publishers with queued messages are sent out
+  if (added)
+    TopicManager::Instance()->AddPublisherToProcess(shared_from_this());
 
   if (_block)
   {
@@ -160,9 +207,14 @@ void Publisher::SendMessage()
 {
   std::list<MessagePtr> localBuffer;
   std::list<uint32_t> localIds;
+  std::list<std::chrono::steady_clock::time_point> localTimes;
 
   {
     boost::mutex::scoped_lock lock(this->mutex);
+
+    // Messages left because of pending publications are queued again by
+    // OnPublishComplete, or by the next message.
+    this->ready = false;
     if (!this->pubIds.empty() || this->messages.empty())
     {
       return;
@@ -178,17 +230,23 @@ void Publisher::SendMessage()
     std::copy(this->messages.begin(), this->messages.end(),
         std::back_inserter(localBuffer));
     this->messages.clear();
+    localTimes.swap(this->messageTimes);
   }
 
   // Only send messages if there is something to send
   if (!localBuffer.empty())
   {
     std::list<uint32_t>::iterator pubIter = localIds.begin();
+    auto timeIter = localTimes.begin();
 
     // Send all the current messages
     for (std::list<MessagePtr>::iterator iter = localBuffer.begin();
-        iter != localBuffer.end(); ++iter, ++pubIter)
+        iter != localBuffer.end(); ++iter, ++pubIter, ++timeIter)
     {
+      this->publication->RecordLatency(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - *timeIter).count());
+
       // Expected number of calls to the callback function
       // Publisher::OnPublishComplete() triggered by subscriber callbacks.
       // If there are no subscriber callbacks, OnPublishComplete()
@@ -289,11 +347,27 @@ void Publisher::OnPublishComplete(uint32_t _id)
     // This is the deeply unsatisfying way of dealing with a race
     // condition where the publisher is destroyed before all
     // OnPublishComplete callbacks are fired.
-    boost::mutex::scoped_lock lock(this->mutex);
+    bool added = false;
+    {
+      boost::mutex::scoped_lock lock(this->mutex);
+
+      std::map<uint32_t, int>::iterator iter = this->pubIds.find(_id);
+      if (iter != this->pubIds.end() && (--iter->second) <= 0)
+        this->pubIds.erase(iter);
 
-    std::map<uint32_t, int>::iterator iter = this->pubIds.find(_id);
-    if (iter != this->pubIds.end() && (--iter->second) <= 0)
-      this->pubIds.erase(iter);
+      // Send the messages which waited for the last publication
+      if (this->pubIds.empty() && !this->messages.empty() && !this->ready)
+      {
+        this->ready = true;
+        added = true;
+      }
+    }
+
+    if (added)
+    {
+      TopicManager::Instance()->AddPublisherToProcess(shared_from_this());
+      ConnectionManager::Instance()->TriggerUpdate();
+    }
   }
   catch(...)
   {
@@ -319,6 +393,7 @@ void Publisher::Fini()
   if (!this->messages.empty())
     this->SendMessage();
   this->messages.clear();
+  this->messageTimes.clear();
 
   if (!this->topic.empty())
     TopicManager::Instance()->Unadvertise(this->topic, this->id);
@@ -24,11 +24,13 @@
 #include <google/protobuf/message.h>
 #include <boost/thread.hpp>
 #include <boost/shared_ptr.hpp>
+#include <chrono>
 #include <string>
 #include <list>
 #include <map>
+#include <memory>
 
-#include "gazebo/common/Time.hh"
+#include "gazebo/common/NanoTime.hh"
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/util/system.hh"
 
@@ -101,10 +103,26 @@ namespace gazebo
               void Publish(M _message, bool _block = false)
               { this->PublishImpl(_message, _block); }
 
+      /// \brief Publish a message on the topic without copying it. The
+      /// publisher takes ownership of the message, which is kept as the
+      /// latest message of the topic and serialized once for all the
+      /// remote subscribers.
+      /// \param[in] _message Message to be published
+      /// \param[in] _block Whether to block until the message is actually
+      /// written into the local message buffer, and SendMessage() is called.
+      public: template< typename M>
+              void Publish(std::unique_ptr<M> _message, bool _block = false)
+              { this->PublishImpl(MessagePtr(_message.release()), _block); }
+
       /// \brief Get the number of outgoing messages
       /// \return The number of outgoing messages
       public: unsigned int GetOutgoingCount() const;
 
+      /// \brief Check whether a message published now would be sent, or
+      /// dropped because of the publication rate limit.
+      /// \return False if the next message would be throttled.
+      public: bool ReadyToPublish() const;
+
       /// \brief Get the topic name
       /// \return The topic name
       public: std::string GetTopic() const;
@@ -147,6 +165,24 @@ namespace gazebo
       private: void PublishImpl(const google::protobuf::Message &_message,
                                 bool _block);
 
+      /// \brief Implementation of Publish, for messages owned by the
+      /// publisher.
+      /// \param[in] _message Message to be published.
+      /// \param[in] _block Whether to block until the message is actually
+      /// written out.
+      private: void PublishImpl(MessagePtr _message, bool _block);
+
+      /// \brief Check that a message can be published now.
+      /// \param[in] _message Message to be published.
+      /// \return False if the message is invalid or throttled.
+      private: bool ValidateMessage(const google::protobuf::Message &_message);
+
+      /// \brief Queue a message for sending.
+      /// \param[in] _message Message to be published.
+      /// \param[in] _block Whether to block until the message is actually
+      /// written out.
+      private: void QueueMessage(MessagePtr _message, bool _block);
+
       /// \brief Callback when a publish is completed
       /// \param[in] _id ID associated with the publication.
       private: void OnPublishComplete(uint32_t _id);
@@ -163,7 +199,7 @@ namespace gazebo
 
       /// \brief Period at which messages are published. Zero indicates no
       /// limit.
-      private: double updatePeriod;
+      private: common::NanoTime updatePeriod;
 
       /// \brief True if queueLimit has been reached, and a warning message
       /// was produced.
@@ -172,6 +208,14 @@ namespace gazebo
       /// \brief List of messages to publish.
       private: std::list<MessagePtr> messages;
 
+      /// \brief Times at which the messages were queued, paired with
+      /// messages.
+      private: std::list<std::chrono::steady_clock::time_point> messageTimes;
+
+      /// \brief True while the publisher is in the TopicManager's list of
+      /// publishers with messages to send, protected by mutex.
+      private: bool ready = false;
+
       /// \brief For mutual exclusion.
       private: mutable boost::mutex mutex;
 
@@ -182,8 +226,8 @@ namespace gazebo
       /// \brief Pointer to our containing node.
       private: NodePtr node;
 
-      private: common::Time currentTime;
-      private: common::Time prevPublishTime;
+      private: common::NanoTime currentTime;
+      private: common::NanoTime prevPublishTime;
 
       /// \brief Current id of the sent message.
       private: uint32_t pubId;
@@ -0,0 +1,416 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <stdlib.h>
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/sync/interprocess_condition.hpp>
+#include <boost/interprocess/sync/interprocess_mutex.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/transport/ShmRing.hh"
+
+using namespace gazebo;
+using namespace transport;
+
+namespace bi = boost::interprocess;
+
+namespace
+{
+  /// \brief Identifies a segment created by ShmRing, and its layout.
+  const uint32_t kRingMagic = 0x677a7231;
+
+  /// \brief Size of the length which precedes each message.
+  const std::size_t kLengthSize = sizeof(uint32_t);
+
+  /// \brief Start of the shared memory segment, followed by the ring.
+  struct RingHeader
+  {
+    /// \brief Set to kRingMagic once the header is constructed.
+    uint32_t magic = 0;
+
+    /// \brief Protects the positions and flags.
+    bi::interprocess_mutex mutex;
+
+    /// \brief Signaled when a message is written, or the ring closed.
+    bi::interprocess_condition readable;
+
+    /// \brief Signaled when a message is read, or the ring closed.
+    bi::interprocess_condition writable;
+
+    /// \brief Number of bytes written since the ring was created.
+    uint64_t head = 0;
+
+    /// \brief Number of bytes read since the ring was created.
+    uint64_t tail = 0;
+
+    /// \brief Size of the ring, in bytes.
+    uint64_t capacity = 0;
+
+    /// \brief True once either side closed the ring.
+    bool closed = false;
+
+    /// \brief True once the writer opened the ring.
+    bool writer = false;
+  };
+
+  /// \brief Get a time point from now.
+  /// \param[in] _ms Milliseconds from now.
+  /// \return The time point.
+  boost::posix_time::ptime Deadline(const unsigned int _ms)
+  {
+    return boost::posix_time::microsec_clock::universal_time() +
+        boost::posix_time::milliseconds(_ms);
+  }
+}
+
+namespace gazebo
+{
+  namespace transport
+  {
+    /// \internal
+    /// \brief Private data for the ShmRing class
+    class ShmRingPrivate
+    {
+      /// \brief Copy bytes into the ring.
+      /// \param[in] _pos Position in the ring, wrapped around its capacity.
+      /// \param[in] _src Bytes to copy.
+      /// \param[in] _size Number of bytes.
+      public: void CopyIn(const uint64_t _pos, const char *_src,
+                  const std::size_t _size)
+      {
+        const std::size_t offset = _pos % this->header->capacity;
+        const std::size_t first = std::min<std::size_t>(_size,
+            this->header->capacity - offset);
+        std::memcpy(this->data + offset, _src, first);
+        std::memcpy(this->data, _src + first, _size - first);
+      }
+
+      /// \brief Copy bytes out of the ring.
+      /// \param[in] _pos Position in the ring, wrapped around its capacity.
+      /// \param[out] _dst Destination of the bytes.
+      /// \param[in] _size Number of bytes.
+      public: void CopyOut(const uint64_t _pos, char *_dst,
+                  const std::size_t _size) const
+      {
+        const std::size_t offset = _pos % this->header->capacity;
+        const std::size_t first = std::min<std::size_t>(_size,
+            this->header->capacity - offset);
+        std::memcpy(_dst, this->data + offset, first);
+        std::memcpy(_dst + first, this->data, _size - first);
+      }
+
+      /// \brief Unmap the shared memory segment.
+      public: void Unmap()
+      {
+        this->header = nullptr;
+        this->data = nullptr;
+        bi::mapped_region().swap(this->region);
+      }
+
+      /// \brief Name of the shared memory segment.
+      public: std::string name;
+
+      /// \brief True if this side created the ring.
+      public: bool creator = false;
+
+      /// \brief Mapping of the shared memory segment.
+      public: bi::mapped_region region;
+
+      /// \brief Header at the start of the segment, null if not open.
+      public: RingHeader *header = nullptr;
+
+      /// \brief Ring of messages, after the header.
+      public: char *data = nullptr;
+    };
+  }
+}
+
+//////////////////////////////////////////////////
+ShmRing::ShmRing()
+  : dataPtr(new ShmRingPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+ShmRing::~ShmRing()
+{
+  this->Close();
+  this->dataPtr->Unmap();
+}
+
+//////////////////////////////////////////////////
+bool ShmRing::Create(const std::string &_name, const std::size_t _capacity)
+{
+  this->Close();
+  this->dataPtr->Unmap();
+  if (_capacity <= kLengthSize)
+  {
+    gzerr << "Shared memory ring [" << _name << "] is too small\n";
+    return false;
+  }
+
+  try
+  {
+    // A crashed process may have left a segment with the same name
+    bi::shared_memory_object::remove(_name.c_str());
+    bi::shared_memory_object shm(bi::create_only, _name.c_str(),
+        bi::read_write);
+    shm.truncate(sizeof(RingHeader) + _capacity);
+    bi::mapped_region region(shm, bi::read_write);
+    region.swap(this->dataPtr->region);
+  }
+  catch(bi::interprocess_exception &_e)
+  {
+    gzerr << "Unable to create shared memory ring [" << _name << "]: "
+          << _e.what() << "\n";
+    bi::shared_memory_object::remove(_name.c_str());
+    return false;
+  }
+
+  this->dataPtr->name = _name;
+  this->dataPtr->creator = true;
+  this->dataPtr->header = new (this->dataPtr->region.get_address())
+      RingHeader;
+  this->dataPtr->header->capacity = _capacity;
+  this->dataPtr->header->magic = kRingMagic;
+  this->dataPtr->data = static_cast<char *>(
+      this->dataPtr->region.get_address()) + sizeof(RingHeader);
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool ShmRing::Open(const std::string &_name)
+{
+  this->Close();
+  this->dataPtr->Unmap();
+
+  try
+  {
+    bi::shared_memory_object shm(bi::open_only, _name.c_str(),
+        bi::read_write);
+    bi::mapped_region region(shm, bi::read_write);
+    region.swap(this->dataPtr->region);
+  }
+  catch(bi::interprocess_exception &)
+  {
+    // Expected when the reader is on another host
+    return false;
+  }
+
+  RingHeader *header = static_cast<RingHeader *>(
+      this->dataPtr->region.get_address());
+  if (this->dataPtr->region.get_size() < sizeof(RingHeader) ||
+      header->magic != kRingMagic ||
+      this->dataPtr->region.get_size() < sizeof(RingHeader) +
+      header->capacity)
+  {
+    gzerr << "Shared memory segment [" << _name << "] is not a ring\n";
+    this->dataPtr->Unmap();
+    return false;
+  }
+
+  // Both sides have it mapped now, so the name is no longer needed
+  bi::shared_memory_object::remove(_name.c_str());
+
+  {
+    bi::scoped_lock<bi::interprocess_mutex> lock(header->mutex);
+    header->writer = true;
+  }
+
+  this->dataPtr->name = _name;
+  this->dataPtr->creator = false;
+  this->dataPtr->header = header;
+  this->dataPtr->data = static_cast<char *>(
+      this->dataPtr->region.get_address()) + sizeof(RingHeader);
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+void ShmRing::Close()
+{
+  RingHeader *header = this->dataPtr->header;
+  if (!header)
+    return;
+
+  {
+    bi::scoped_lock<bi::interprocess_mutex> lock(header->mutex);
+    header->closed = true;
+  }
+  header->readable.notify_all();
+  header->writable.notify_all();
+
+  // The writer removes the name when it opens the ring
+  if (this->dataPtr->creator)
+    bi::shared_memory_object::remove(this->dataPtr->name.c_str());
+
+  // The segment stays mapped until the ring is destroyed, so Close can be
+  // called while another thread reads or writes
+}
+
+//////////////////////////////////////////////////
+bool ShmRing::IsOpen() const
+{
+  RingHeader *header = this->dataPtr->header;
+  if (!header)
+    return false;
+
+  bi::scoped_lock<bi::interprocess_mutex> lock(header->mutex);
+  return !header->closed;
+}
+
+//////////////////////////////////////////////////
+bool ShmRing::HasWriter() const
+{
+  RingHeader *header = this->dataPtr->header;
+  if (!header)
+    return false;
+
+  bi::scoped_lock<bi::interprocess_mutex> lock(header->mutex);
+  return header->writer;
+}
+
+//////////////////////////////////////////////////
+std::string ShmRing::Name() const
+{
+  return this->dataPtr->name;
+}
+
+//////////////////////////////////////////////////
+std::size_t ShmRing::MaxMessageSize() const
+{
+  if (!this->dataPtr->header)
+    return 0;
+  return this->dataPtr->header->capacity - kLengthSize;
+}
+
+//////////////////////////////////////////////////
+bool ShmRing::Write(const std::string &_data, const unsigned int _timeoutMs)
+{
+  RingHeader *header = this->dataPtr->header;
+  if (!header || _data.size() > this->MaxMessageSize())
+    return false;
+
+  const uint64_t size = kLengthSize + _data.size();
+  uint64_t pos;
+  {
+    bi::scoped_lock<bi::interprocess_mutex> lock(header->mutex);
+    const boost::posix_time::ptime deadline = Deadline(_timeoutMs);
+    while (!header->closed &&
+        header->capacity - (header->head - header->tail) < size)
+    {
+      if (!header->writable.timed_wait(lock, deadline) &&
+          header->capacity - (header->head - header->tail) < size)
+      {
+        return false;
+      }
+    }
+
+    if (header->closed)
+      return false;
+    pos = header->head;
+  }
+
+  // There is a single writer, and the reader doesn't go past the head, so
+  // the message is copied without holding the lock
+  const uint32_t length = static_cast<uint32_t>(_data.size());
+  this->dataPtr->CopyIn(pos, reinterpret_cast<const char *>(&length),
+      kLengthSize);
+  this->dataPtr->CopyIn(pos + kLengthSize, _data.data(), _data.size());
+
+  {
+    bi::scoped_lock<bi::interprocess_mutex> lock(header->mutex);
+    header->head = pos + size;
+  }
+  header->readable.notify_one();
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool ShmRing::Read(std::string &_data, const unsigned int _timeoutMs)
+{
+  RingHeader *header = this->dataPtr->header;
+  if (!header)
+    return false;
+
+  uint64_t pos;
+  {
+    bi::scoped_lock<bi::interprocess_mutex> lock(header->mutex);
+    const boost::posix_time::ptime deadline = Deadline(_timeoutMs);
+    while (!header->closed && header->head == header->tail)
+    {
+      if (!header->readable.timed_wait(lock, deadline) &&
+          header->head == header->tail)
+      {
+        return false;
+      }
+    }
+
+    // Messages written before the ring closed are still read
+    if (header->head == header->tail)
+      return false;
+    pos = header->tail;
+  }
+
+  uint32_t length = 0;
+  this->dataPtr->CopyOut(pos, reinterpret_cast<char *>(&length),
+      kLengthSize);
+  _data.resize(length);
+  if (length > 0)
+    this->dataPtr->CopyOut(pos + kLengthSize, &_data[0], length);
+
+  {
+    bi::scoped_lock<bi::interprocess_mutex> lock(header->mutex);
+    header->tail = pos + kLengthSize + length;
+  }
+  header->writable.notify_one();
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+std::size_t ShmRing::ConfiguredCapacity()
+{
+  const char *env = getenv("GAZEBO_SHM_TRANSPORT");
+  if (!env || *env == '\0')
+    return 0;
+
+  char *end = nullptr;
+  const unsigned long megabytes = strtoul(env, &end, 10);
+  if (*end != '\0')
+  {
+    static bool warned = false;
+    if (!warned)
+    {
+      gzwarn << "Invalid GAZEBO_SHM_TRANSPORT [" << env << "], expected a "
+             << "size in megabytes. Shared memory transport is disabled.\n";
+      warned = true;
+    }
+    return 0;
+  }
+
+  return static_cast<std::size_t>(megabytes) << 20;
+}
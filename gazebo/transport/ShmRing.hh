@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_TRANSPORT_SHMRING_HH_
+#define GAZEBO_TRANSPORT_SHMRING_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace transport
+  {
+    /// \addtogroup gazebo_transport
+    /// \{
+
+    // Forward declare private data class.
+    class ShmRingPrivate;
+
+    /// \class ShmRing ShmRing.hh transport/transport.hh
+    /// \brief A ring buffer of messages in a named shared memory segment,
+    /// with a single writer and a single reader, which may live in
+    /// different processes on the same host.
+    ///
+    /// The reader creates the ring, and the writer opens it by name. Once
+    /// opened, the name is removed, so the segment is released when both
+    /// processes have closed it, even if one of them crashes.
+    ///
+    /// \remarks
+    ///  Environment Variables:
+    ///   - GAZEBO_SHM_TRANSPORT: Size in megabytes of the ring used by
+    /// each subscription to a publisher on the same host. Leave this empty
+    /// to receive all the messages over TCP/IP.
+    class GZ_TRANSPORT_VISIBLE ShmRing
+    {
+      /// \brief Constructor, the ring must be created or opened before it
+      /// is used.
+      public: ShmRing();
+
+      /// \brief Destructor, closes the ring.
+      public: ~ShmRing();
+
+      /// \brief Create a ring, as its reader.
+      /// \param[in] _name Name of the shared memory segment.
+      /// \param[in] _capacity Size of the ring, in bytes.
+      /// \return True if the ring was created.
+      public: bool Create(const std::string &_name,
+                  const std::size_t _capacity);
+
+      /// \brief Open a ring created by another process, as its writer.
+      /// \param[in] _name Name of the shared memory segment.
+      /// \return True if the ring was opened, false if it doesn't exist,
+      /// for example because the reader is on a different host.
+      public: bool Open(const std::string &_name);
+
+      /// \brief Close the ring. Readers blocked in Read return, and the
+      /// other side sees the ring as closed. This may be called while
+      /// another thread reads or writes.
+      public: void Close();
+
+      /// \brief Get whether the ring is open.
+      /// \return False before Create or Open, and after either side called
+      /// Close.
+      public: bool IsOpen() const;
+
+      /// \brief Get whether a writer opened the ring.
+      /// \return True once Open succeeded on the other side, even if the
+      /// ring was closed since.
+      public: bool HasWriter() const;
+
+      /// \brief Get the name of the ring.
+      /// \return Name of the shared memory segment.
+      public: std::string Name() const;
+
+      /// \brief Get the size of the largest message the ring can hold.
+      /// \return Size in bytes, 0 if the ring is not open.
+      public: std::size_t MaxMessageSize() const;
+
+      /// \brief Write a message, waiting for the reader to make room if
+      /// the ring is full.
+      /// \param[in] _data The message.
+      /// \param[in] _timeoutMs Time to wait for room, in milliseconds.
+      /// \return False if the message is larger than MaxMessageSize, the
+      /// ring is closed, or the reader didn't make room in time.
+      public: bool Write(const std::string &_data,
+                  const unsigned int _timeoutMs);
+
+      /// \brief Read the oldest message, waiting for one if the ring is
+      /// empty.
+      /// \param[out] _data The message.
+      /// \param[in] _timeoutMs Time to wait for a message, in milliseconds.
+      /// \return False if no message was read.
+      public: bool Read(std::string &_data, const unsigned int _timeoutMs);
+
+      /// \brief Get whether shared memory transport is enabled, and the
+      /// size of its rings, from GAZEBO_SHM_TRANSPORT.
+      /// \return Size of a ring in bytes, 0 if disabled.
+      public: static std::size_t ConfiguredCapacity();
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<ShmRingPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
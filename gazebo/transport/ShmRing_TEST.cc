@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <string>
+
+#include "gazebo/transport/ShmRing.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class ShmRing : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(ShmRing, OpenMissing)
+{
+  transport::ShmRing writer;
+  EXPECT_FALSE(writer.IsOpen());
+  EXPECT_FALSE(writer.Open("gazebo_shm_ring_test_missing"));
+  EXPECT_FALSE(writer.IsOpen());
+  EXPECT_FALSE(writer.Write("data", 0));
+  EXPECT_EQ(0u, writer.MaxMessageSize());
+}
+
+/////////////////////////////////////////////////
+TEST_F(ShmRing, WriteRead)
+{
+  transport::ShmRing reader;
+  ASSERT_TRUE(reader.Create("gazebo_shm_ring_test_write_read", 64));
+  EXPECT_EQ("gazebo_shm_ring_test_write_read", reader.Name());
+  EXPECT_EQ(60u, reader.MaxMessageSize());
+
+  EXPECT_FALSE(reader.HasWriter());
+
+  transport::ShmRing writer;
+  ASSERT_TRUE(writer.Open("gazebo_shm_ring_test_write_read"));
+  EXPECT_TRUE(writer.IsOpen());
+  EXPECT_TRUE(reader.IsOpen());
+  EXPECT_TRUE(reader.HasWriter());
+
+  // The name is removed once opened
+  transport::ShmRing other;
+  EXPECT_FALSE(other.Open("gazebo_shm_ring_test_write_read"));
+
+  std::string data;
+  EXPECT_FALSE(reader.Read(data, 0));
+
+  // Messages wrap around the end of the ring
+  for (int i = 0; i < 20; ++i)
+  {
+    std::string msg = "message " + std::to_string(i);
+    EXPECT_TRUE(writer.Write(msg, 0));
+    EXPECT_TRUE(writer.Write("", 0));
+    ASSERT_TRUE(reader.Read(data, 0));
+    EXPECT_EQ(msg, data);
+    ASSERT_TRUE(reader.Read(data, 0));
+    EXPECT_TRUE(data.empty());
+  }
+}
+
+/////////////////////////////////////////////////
+TEST_F(ShmRing, Full)
+{
+  transport::ShmRing reader;
+  ASSERT_TRUE(reader.Create("gazebo_shm_ring_test_full", 32));
+  transport::ShmRing writer;
+  ASSERT_TRUE(writer.Open("gazebo_shm_ring_test_full"));
+
+  // Larger than the ring
+  EXPECT_FALSE(writer.Write(std::string(29, 'a'), 0));
+
+  EXPECT_TRUE(writer.Write(std::string(20, 'b'), 0));
+  EXPECT_FALSE(writer.Write(std::string(20, 'c'), 10));
+  EXPECT_TRUE(writer.IsOpen());
+
+  std::string data;
+  ASSERT_TRUE(reader.Read(data, 0));
+  EXPECT_EQ(std::string(20, 'b'), data);
+  EXPECT_TRUE(writer.Write(std::string(20, 'c'), 0));
+}
+
+/////////////////////////////////////////////////
+TEST_F(ShmRing, Close)
+{
+  transport::ShmRing reader;
+  ASSERT_TRUE(reader.Create("gazebo_shm_ring_test_close", 64));
+  transport::ShmRing writer;
+  ASSERT_TRUE(writer.Open("gazebo_shm_ring_test_close"));
+
+  EXPECT_TRUE(writer.Write("last", 0));
+  writer.Close();
+  EXPECT_FALSE(writer.IsOpen());
+  EXPECT_FALSE(reader.IsOpen());
+  EXPECT_FALSE(writer.Write("after", 0));
+
+  // Messages written before the ring closed are still read
+  std::string data;
+  EXPECT_TRUE(reader.Read(data, 0));
+  EXPECT_EQ("last", data);
+  EXPECT_FALSE(reader.Read(data, 10));
+}
+
+/////////////////////////////////////////////////
+#ifndef _WIN32
+TEST_F(ShmRing, ConfiguredCapacity)
+{
+  unsetenv("GAZEBO_SHM_TRANSPORT");
+  EXPECT_EQ(0u, transport::ShmRing::ConfiguredCapacity());
+
+  setenv("GAZEBO_SHM_TRANSPORT", "4", 1);
+  EXPECT_EQ(4u << 20, transport::ShmRing::ConfiguredCapacity());
+
+  setenv("GAZEBO_SHM_TRANSPORT", "four", 1);
+  EXPECT_EQ(0u, transport::ShmRing::ConfiguredCapacity());
+
+  unsetenv("GAZEBO_SHM_TRANSPORT");
+}
+#endif
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <tbb/task.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gazebo/transport/BufferPool.hh"
+#include "gazebo/transport/Strand.hh"
+
+using namespace gazebo;
+using namespace transport;
+
+/// \brief Number of messages a task handles before it lets the tasks of
+/// the other strands run.
+static const unsigned int kStrandBatch = 16;
+
+namespace
+{
+  /// \brief TBB task that drains a strand.
+  class StrandTask : public tbb::task
+  {
+    /// \brief Constructor.
+    /// \param[in] _strand The strand, kept alive until the task runs.
+    public: explicit StrandTask(std::shared_ptr<Strand> _strand)
+            : strand(std::move(_strand))
+            {
+            }
+
+    /// \brief Overridden function from tbb::task that drains the strand.
+    public: tbb::task *execute()
+            {
+              this->strand->Drain();
+              return NULL;
+            }
+
+    /// \brief The strand.
+    private: std::shared_ptr<Strand> strand;
+  };
+}
+
+//////////////////////////////////////////////////
+Strand::Strand(const bool _coalesce)
+  : coalesce(_coalesce)
+{
+}
+
+//////////////////////////////////////////////////
+Strand::~Strand()
+{
+  for (auto &entry : this->entries)
+    BufferPool::Instance()->Release(std::move(entry.second));
+}
+
+//////////////////////////////////////////////////
+void Strand::Post(const boost::function<void (const std::string &)> &_func,
+    std::string _data)
+{
+  std::vector<std::string> dropped;
+  bool schedule = false;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->coalesce)
+    {
+      for (auto &entry : this->entries)
+        dropped.push_back(std::move(entry.second));
+      this->entries.clear();
+      this->coalesced += dropped.size();
+    }
+    this->entries.push_back(Entry(_func, std::move(_data)));
+
+    // A single task drains the strand at a time
+    schedule = !this->scheduled;
+    this->scheduled = true;
+  }
+
+  for (auto &buffer : dropped)
+    BufferPool::Instance()->Release(std::move(buffer));
+
+  if (schedule)
+    this->Schedule();
+}
+
+//////////////////////////////////////////////////
+bool Strand::Coalescing() const
+{
+  return this->coalesce;
+}
+
+//////////////////////////////////////////////////
+std::size_t Strand::Pending() const
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->entries.size() + (this->handling ? 1 : 0);
+}
+
+//////////////////////////////////////////////////
+uint64_t Strand::CoalescedCount() const
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->coalesced;
+}
+
+//////////////////////////////////////////////////
+void Strand::Drain()
+{
+  for (unsigned int i = 0; i < kStrandBatch; ++i)
+  {
+    Entry entry;
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      if (this->entries.empty())
+      {
+        this->scheduled = false;
+        return;
+      }
+      entry = std::move(this->entries.front());
+      this->entries.pop_front();
+      this->handling = true;
+    }
+
+    entry.first(entry.second);
+    BufferPool::Instance()->Release(std::move(entry.second));
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->handling = false;
+  }
+
+  // The messages left are handled by another task, queued behind the
+  // tasks of the other strands
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->entries.empty())
+    {
+      this->scheduled = false;
+      return;
+    }
+  }
+  this->Schedule();
+}
+
+//////////////////////////////////////////////////
+void Strand::Schedule()
+{
+  StrandTask *task = new(tbb::task::allocate_root())
+      StrandTask(this->shared_from_this());
+  tbb::task::enqueue(*task);
+}
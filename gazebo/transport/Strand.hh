@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_TRANSPORT_STRAND_HH_
+#define GAZEBO_TRANSPORT_STRAND_HH_
+
+#include <boost/function.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace transport
+  {
+    /// \addtogroup gazebo_transport
+    /// \{
+
+    /// \class Strand Strand.hh transport/transport.hh
+    /// \brief Serial queue of the messages received by a subscription.
+    /// The messages are handled one at a time and in order, by tasks of
+    /// the TBB scheduler shared with the other strands, so that different
+    /// topics are handled in parallel without locking in the callbacks.
+    class GZ_TRANSPORT_VISIBLE Strand :
+      public std::enable_shared_from_this<Strand>
+    {
+      /// \brief Constructor.
+      /// \param[in] _coalesce True to keep only the latest of the
+      /// messages waiting to be handled, so that a slow callback always
+      /// gets the newest data instead of falling behind.
+      public: explicit Strand(const bool _coalesce = false);
+
+      /// \brief Destructor.
+      public: virtual ~Strand();
+
+      /// \brief Queue a message, handled after the messages queued before.
+      /// The strand must be owned by a shared pointer.
+      /// \param[in] _func Function that handles the message.
+      /// \param[in] _data The message. It is returned to the BufferPool
+      /// once handled or dropped.
+      public: void Post(
+                  const boost::function<void (const std::string &)> &_func,
+                  std::string _data);
+
+      /// \brief Get whether older waiting messages are dropped.
+      /// \return True if the strand coalesces its messages.
+      public: bool Coalescing() const;
+
+      /// \brief Get the number of messages waiting or being handled.
+      /// \return Number of messages.
+      public: std::size_t Pending() const;
+
+      /// \brief Get the number of messages dropped for newer ones.
+      /// \return Number of coalesced messages.
+      public: uint64_t CoalescedCount() const;
+
+      /// \internal
+      /// \brief Handle the queued messages, up to a batch, then queue
+      /// another task if messages are left. Called by the TBB tasks.
+      public: void Drain();
+
+      /// \brief Queue a task that drains the strand.
+      private: void Schedule();
+
+      /// \brief A message and the function that handles it.
+      private: typedef std::pair<boost::function<void (const std::string &)>,
+               std::string> Entry;
+
+      /// \brief True to keep only the latest waiting message.
+      private: const bool coalesce;
+
+      /// \brief Protects the members below.
+      private: mutable std::mutex mutex;
+
+      /// \brief Messages waiting to be handled, oldest first.
+      private: std::deque<Entry> entries;
+
+      /// \brief True while a task is queued or draining the strand.
+      private: bool scheduled = false;
+
+      /// \brief True while a message is being handled.
+      private: bool handling = false;
+
+      /// \brief Number of messages dropped for newer ones.
+      private: uint64_t coalesced = 0;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gazebo/transport/Strand.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class Strand : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief Wait for a strand to handle its messages.
+/// \param[in] _strand The strand.
+/// \return False if the messages weren't handled within 10 seconds.
+bool WaitIdle(const transport::Strand &_strand)
+{
+  for (int i = 0; i < 1000 && _strand.Pending() > 0; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  return _strand.Pending() == 0;
+}
+
+/////////////////////////////////////////////////
+TEST_F(Strand, Order)
+{
+  const unsigned int strandCount = 4;
+  const unsigned int messageCount = 200;
+
+  std::vector<std::shared_ptr<transport::Strand>> strands;
+  std::vector<std::vector<std::string>> handled(strandCount);
+  std::vector<std::unique_ptr<std::atomic<int>>> inFlight;
+  std::atomic<bool> overlapped(false);
+
+  for (unsigned int i = 0; i < strandCount; ++i)
+  {
+    strands.push_back(std::make_shared<transport::Strand>());
+    inFlight.emplace_back(new std::atomic<int>(0));
+    EXPECT_FALSE(strands.back()->Coalescing());
+  }
+
+  // The strands are fed from several threads, the messages of a strand
+  // are handled one at a time and in order
+  std::vector<std::thread> threads;
+  for (unsigned int i = 0; i < strandCount; ++i)
+  {
+    threads.push_back(std::thread([&, i]()
+    {
+      for (unsigned int m = 0; m < messageCount; ++m)
+      {
+        strands[i]->Post([&, i](const std::string &_data)
+            {
+              if (++(*inFlight[i]) != 1)
+                overlapped = true;
+              handled[i].push_back(_data);
+              --(*inFlight[i]);
+            }, std::to_string(m));
+      }
+    }));
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  for (unsigned int i = 0; i < strandCount; ++i)
+  {
+    ASSERT_TRUE(WaitIdle(*strands[i]));
+    ASSERT_EQ(messageCount, handled[i].size());
+    for (unsigned int m = 0; m < messageCount; ++m)
+      EXPECT_EQ(std::to_string(m), handled[i][m]);
+    EXPECT_EQ(0u, strands[i]->CoalescedCount());
+  }
+  EXPECT_FALSE(overlapped);
+}
+
+/////////////////////////////////////////////////
+TEST_F(Strand, Coalesce)
+{
+  auto strand = std::make_shared<transport::Strand>(true);
+  EXPECT_TRUE(strand->Coalescing());
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  bool started = false;
+  bool release = false;
+  std::vector<std::string> handled;
+
+  auto callback = [&](const std::string &_data)
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    handled.push_back(_data);
+    started = true;
+    condition.notify_all();
+    condition.wait(lock, [&]() {return release;});
+  };
+
+  // The messages received while the first one is handled are coalesced
+  strand->Post(callback, "0");
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    ASSERT_TRUE(condition.wait_for(lock, std::chrono::seconds(10),
+          [&]() {return started;}));
+  }
+  for (unsigned int m = 1; m <= 10; ++m)
+    strand->Post(callback, std::to_string(m));
+  EXPECT_EQ(2u, strand->Pending());
+  EXPECT_EQ(9u, strand->CoalescedCount());
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    release = true;
+    condition.notify_all();
+  }
+  ASSERT_TRUE(WaitIdle(*strand));
+
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT_EQ(2u, handled.size());
+  EXPECT_EQ("0", handled[0]);
+  EXPECT_EQ("10", handled[1]);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
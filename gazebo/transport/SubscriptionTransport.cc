@@ -16,7 +16,12 @@
 */
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
+#include <boost/thread/mutex.hpp>
+#include <deque>
+#include <vector>
 #include "gazebo/transport/ConnectionManager.hh"
+#include "gazebo/transport/DatagramChannel.hh"
+#include "gazebo/transport/ShmRing.hh"
 #include "gazebo/transport/SubscriptionTransport.hh"
 
 using namespace gazebo;
@@ -24,6 +29,101 @@ using namespace transport;
 
 extern void dummy_callback_fn(uint32_t);
 
+namespace gazebo
+{
+  namespace transport
+  {
+    /// \internal
+    /// \brief Bounded, latest-only queue of the messages of a
+    /// subscription, waiting to be written to its connection.
+    class SubscriptionQueue
+    {
+      /// \brief Queue a message, or write it if the connection has room.
+      /// \param[in] _queue The queue.
+      /// \param[in] _data The message.
+      public: static void Push(
+                  const std::shared_ptr<SubscriptionQueue> &_queue,
+                  const std::shared_ptr<const std::string> &_data)
+      {
+        {
+          boost::mutex::scoped_lock lock(_queue->mutex);
+          if (_queue->inFlight >= _queue->limit)
+          {
+            _queue->pending.push_back(_data);
+            if (_queue->pending.size() > _queue->limit)
+            {
+              _queue->pending.pop_front();
+              ++_queue->dropped;
+            }
+            return;
+          }
+          ++_queue->inFlight;
+        }
+
+        Write(_queue, _data);
+      }
+
+      /// \brief Write a message to the connection. The connection's mutex
+      /// is never taken with the queue's, since its callbacks lock the
+      /// queue.
+      /// \param[in] _queue The queue.
+      /// \param[in] _data The message.
+      public: static void Write(
+                  const std::shared_ptr<SubscriptionQueue> &_queue,
+                  const std::shared_ptr<const std::string> &_data)
+      {
+        std::weak_ptr<SubscriptionQueue> weak = _queue;
+        _queue->connection->EnqueueMsg(_data,
+            boost::bind(&SubscriptionQueue::OnWritten, weak, _1), 0);
+      }
+
+      /// \brief Write the next message once one was written.
+      /// \param[in] _queue The queue, which may have been destroyed.
+      public: static void OnWritten(
+                  const std::weak_ptr<SubscriptionQueue> &_queue,
+                  uint32_t /*_id*/)
+      {
+        std::shared_ptr<SubscriptionQueue> queue = _queue.lock();
+        if (!queue)
+          return;
+
+        std::shared_ptr<const std::string> next;
+        {
+          boost::mutex::scoped_lock lock(queue->mutex);
+          if (queue->pending.empty())
+          {
+            --queue->inFlight;
+            return;
+          }
+          next = queue->pending.front();
+          queue->pending.pop_front();
+        }
+
+        Write(queue, next);
+      }
+
+      /// \brief Protects the counters and pending messages.
+      public: boost::mutex mutex;
+
+      /// \brief Connection of the subscription.
+      public: ConnectionPtr connection;
+
+      /// \brief Largest number of messages in the connection, and of
+      /// pending messages.
+      public: unsigned int limit = 0;
+
+      /// \brief Number of messages in the connection.
+      public: unsigned int inFlight = 0;
+
+      /// \brief Messages waiting for room in the connection, oldest first.
+      public: std::deque<std::shared_ptr<const std::string> > pending;
+
+      /// \brief Number of pending messages dropped for newer ones.
+      public: uint64_t dropped = 0;
+    };
+  }
+}
+
 //////////////////////////////////////////////////
 SubscriptionTransport::SubscriptionTransport()
 {
@@ -32,6 +132,9 @@ SubscriptionTransport::SubscriptionTransport()
 //////////////////////////////////////////////////
 SubscriptionTransport::~SubscriptionTransport()
 {
+  this->ring.reset();
+  this->datagrams.reset();
+  this->queue.reset();
   ConnectionManager::Instance()->RemoveConnection(this->connection);
   this->connection.reset();
 }
@@ -43,11 +146,195 @@ void SubscriptionTransport::Init(ConnectionPtr _conn, bool _latching)
   this->latching = _latching;
 }
 
+//////////////////////////////////////////////////
+bool SubscriptionTransport::InitSharedMemory(const std::string &_name)
+{
+  this->ring.reset(new ShmRing());
+  if (!this->ring->Open(_name))
+  {
+    this->ring.reset();
+    return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool SubscriptionTransport::InitDatagrams(const std::string &_topic,
+    const std::string &_publisher, const std::string &_host,
+    const unsigned int _port)
+{
+  std::string group;
+  unsigned int groupPort;
+  if (!DatagramChannel::Configured(_topic, group, groupPort))
+    return false;
+
+  this->datagramPublisher = _publisher;
+  if (!group.empty())
+  {
+    this->multicast = true;
+    return true;
+  }
+
+  this->datagrams.reset(new DatagramChannel());
+  if (!this->datagrams->OpenSender(_topic, _publisher, _host, _port))
+  {
+    this->datagrams.reset();
+    this->datagramPublisher.clear();
+    return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+void SubscriptionTransport::SetQoS(const double _maxRate,
+    const unsigned int _queueLimit)
+{
+  this->minPeriod = std::chrono::steady_clock::duration::zero();
+  if (_maxRate > 0)
+  {
+    this->minPeriod = std::chrono::duration_cast<
+        std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / _maxRate));
+  }
+
+  this->queue.reset();
+  if (_queueLimit > 0 && this->connection)
+  {
+    this->queue = std::make_shared<SubscriptionQueue>();
+    this->queue->connection = this->connection;
+    this->queue->limit = _queueLimit;
+  }
+}
+
+//////////////////////////////////////////////////
+uint64_t SubscriptionTransport::DroppedCount() const
+{
+  uint64_t count = this->rateDropped + this->ringDropped;
+  if (this->queue)
+  {
+    boost::mutex::scoped_lock lock(this->queue->mutex);
+    count += this->queue->dropped;
+  }
+  return count;
+}
+
+//////////////////////////////////////////////////
+bool SubscriptionTransport::Admit()
+{
+  if (this->minPeriod == std::chrono::steady_clock::duration::zero())
+    return true;
+
+  const std::chrono::steady_clock::time_point now =
+      std::chrono::steady_clock::now();
+  if (now - this->lastAdmitted < this->minPeriod)
+  {
+    ++this->rateDropped;
+    return false;
+  }
+
+  this->lastAdmitted = now;
+  return true;
+}
+
+//////////////////////////////////////////////////
+void SubscriptionTransport::Enqueue(
+    const std::shared_ptr<const std::string> &_data,
+    boost::function<void(uint32_t)> _cb, uint32_t _id)
+{
+  // The subscriber waits for the messages announced in the ring, so they
+  // can't be dropped by the queue
+  if (!this->queue || this->ring)
+  {
+    this->connection->EnqueueMsg(_data, _cb, _id);
+    return;
+  }
+
+  // The queue owns the message now, so the publisher doesn't wait for a
+  // slow subscriber
+  SubscriptionQueue::Push(this->queue, _data);
+  if (_cb)
+    _cb(_id);
+}
+
+//////////////////////////////////////////////////
+bool SubscriptionTransport::IsMulticast() const
+{
+  return this->multicast;
+}
+
+//////////////////////////////////////////////////
+std::string SubscriptionTransport::DatagramPublisher() const
+{
+  return this->datagramPublisher;
+}
+
+//////////////////////////////////////////////////
+bool SubscriptionTransport::SendDatagram(const std::string &_data)
+{
+  // The Publication sends to the multicast group
+  if (this->multicast)
+    return true;
+
+  if (!this->datagrams)
+    return false;
+
+  // A failed send is a lost datagram
+  this->datagrams->Send(_data);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool SubscriptionTransport::WriteRing(const std::string &_data)
+{
+  if (!this->ring)
+    return false;
+
+  // A message too large for the ring is sent over the connection, and an
+  // empty message in its place tells the subscriber to wait for it, so the
+  // messages are still handled in order. The publisher never waits for
+  // room in the ring.
+  const bool large = _data.size() > this->ring->MaxMessageSize();
+  if (this->ring->Write(large ? std::string() : _data, 0))
+    return !large;
+
+  if (!this->ring->IsOpen())
+  {
+    this->ring.reset();
+    return false;
+  }
+
+  // The subscriber isn't keeping up, drop the message rather than block
+  // the publisher
+  ++this->ringDropped;
+  if (!this->ringFullWarned)
+  {
+    gzwarn << "Shared memory ring [" << this->ring->Name() << "] is full, "
+           << "dropping messages. Increase GAZEBO_SHM_TRANSPORT to avoid "
+           << "this.\n";
+    this->ringFullWarned = true;
+  }
+  return true;
+}
+
 //////////////////////////////////////////////////
 bool SubscriptionTransport::HandleMessage(MessagePtr _newMsg)
 {
   std::string data;
   _newMsg->SerializeToString(&data);
+
+  // Latched messages must arrive, so they don't go over UDP
+  if (!this->datagramPublisher.empty())
+  {
+    if (!this->connection->IsOpen())
+    {
+      this->connection.reset();
+      return false;
+    }
+    this->connection->EnqueueMsg(data,
+        boost::bind(&dummy_callback_fn, _1), 0);
+    return true;
+  }
+
   return this->HandleData(data, boost::bind(&dummy_callback_fn, _1), 0);
 }
 
@@ -58,7 +345,40 @@ bool SubscriptionTransport::HandleData(const std::string &_newdata,
   bool result = false;
   if (this->connection->IsOpen())
   {
-    this->connection->EnqueueMsg(_newdata, _cb, _id);
+    if (!this->Admit() || this->WriteRing(_newdata) ||
+        this->SendDatagram(_newdata))
+    {
+      if (_cb)
+        _cb(_id);
+    }
+    else if (this->queue && !this->ring)
+      this->Enqueue(std::make_shared<const std::string>(_newdata), _cb, _id);
+    else
+      this->connection->EnqueueMsg(_newdata, _cb, _id);
+    result = true;
+  }
+  else
+    this->connection.reset();
+
+  return result;
+}
+
+//////////////////////////////////////////////////
+bool SubscriptionTransport::HandleSharedData(
+    const std::shared_ptr<const std::string> &_newdata,
+    boost::function<void(uint32_t)> _cb, uint32_t _id)
+{
+  bool result = false;
+  if (this->connection->IsOpen())
+  {
+    if (!this->Admit() || this->WriteRing(*_newdata) ||
+        this->SendDatagram(*_newdata))
+    {
+      if (_cb)
+        _cb(_id);
+    }
+    else
+      this->Enqueue(_newdata, _cb, _id);
     result = true;
   }
   else
@@ -19,6 +19,8 @@
 
 #include <boost/function.hpp>
 #include <boost/shared_ptr.hpp>
+#include <chrono>
+#include <memory>
 #include <string>
 
 #include "Connection.hh"
@@ -29,6 +31,10 @@ namespace gazebo
 {
   namespace transport
   {
+    class DatagramChannel;
+    class ShmRing;
+    class SubscriptionQueue;
+
     /// \addtogroup gazebo_transport
     /// \{
 
@@ -50,6 +56,60 @@ namespace gazebo
       /// don't latch
       public: void Init(ConnectionPtr _conn, bool _latching);
 
+      /// \brief Send the messages through a shared memory ring offered by
+      /// the subscriber, instead of the connection. Messages too large for
+      /// the ring are still sent over the connection, announced in the
+      /// ring so that the subscriber handles them in order. Messages are
+      /// dropped while the ring is full.
+      /// \param[in] _name Name of the ring.
+      /// \return False if the ring can't be opened, for example because
+      /// the subscriber is on a different host.
+      public: bool InitSharedMemory(const std::string &_name);
+
+      /// \brief Send the messages over UDP, which the subscriber accepts
+      /// on a port. If this process sends the topic to a multicast group,
+      /// the Publication sends each message once for all its multicast
+      /// subscribers, otherwise it's sent to the subscriber's host. Latched
+      /// messages are still sent over the connection.
+      /// \param[in] _topic Topic of the messages.
+      /// \param[in] _publisher Address and port of this publisher, as
+      /// advertised.
+      /// \param[in] _host Address of the subscriber.
+      /// \param[in] _port Port the subscriber receives the messages on.
+      /// \return False if the messages are sent over the connection.
+      public: bool InitDatagrams(const std::string &_topic,
+                  const std::string &_publisher, const std::string &_host,
+                  const unsigned int _port);
+
+      /// \brief Set the quality of service requested by the subscriber,
+      /// so that a slow subscriber doesn't hold back the publisher and the
+      /// other subscribers. With a limit, the publisher is told a message
+      /// was sent as soon as it's queued for this subscriber.
+      /// \param[in] _maxRate Largest rate, in Hz, at which messages are
+      /// sent. Messages published faster are dropped. 0 for no limit.
+      /// \param[in] _queueLimit Largest number of messages queued in the
+      /// connection. While it's full, only the latest _queueLimit messages
+      /// are kept waiting, and older ones are dropped. 0 for no limit.
+      public: void SetQoS(const double _maxRate,
+                  const unsigned int _queueLimit);
+
+      /// \brief Get the number of messages dropped by the quality of
+      /// service of the subscriber, or because its shared memory ring was
+      /// full.
+      /// \return Number of dropped messages.
+      public: uint64_t DroppedCount() const;
+
+      /// \brief Get whether the subscriber receives the messages from the
+      /// multicast group of the topic.
+      /// \return True if the Publication sends the messages.
+      public: bool IsMulticast() const;
+
+      /// \brief Get the address and port of this publisher, which
+      /// identifies its messages sent over UDP.
+      /// \return The address and port, empty if messages aren't sent over
+      /// UDP.
+      public: std::string DatagramPublisher() const;
+
       /// \brief Output a message to a connection
       /// \param[in] _newdata The message to be handled
       /// \return true if the message was handled successfully, false otherwise
@@ -59,6 +119,11 @@ namespace gazebo
       public: virtual bool HandleData(const std::string &_newdata,
                   boost::function<void(uint32_t)> _cb, uint32_t _id);
 
+      // documentation inherited
+      public: virtual bool HandleSharedData(
+                  const std::shared_ptr<const std::string> &_newdata,
+                  boost::function<void(uint32_t)> _cb, uint32_t _id);
+
       // Documentation inherited
       public: virtual bool HandleMessage(MessagePtr _newMsg);
 
@@ -71,7 +136,68 @@ namespace gazebo
       /// is tied to a  remote connection
       public: virtual bool IsLocal() const;
 
+      /// \brief Write a message to the shared memory ring, without waiting
+      /// for room.
+      /// \param[in] _data The message.
+      /// \return True if the ring handled or dropped the message, false if
+      /// it must be sent over the connection.
+      private: bool WriteRing(const std::string &_data);
+
+      /// \brief Apply the rate limit of the subscriber.
+      /// \return True if the message must be sent, false if it's dropped.
+      private: bool Admit();
+
+      /// \brief Send a message over the connection, through the queue of
+      /// the subscriber if it has a limit.
+      /// \param[in] _data The message.
+      /// \param[in] _cb Callback invoked once the message was sent.
+      /// \param[in] _id ID associated with the message data.
+      private: void Enqueue(const std::shared_ptr<const std::string> &_data,
+                   boost::function<void(uint32_t)> _cb, uint32_t _id);
+
+      /// \brief Send a message over UDP.
+      /// \param[in] _data The message.
+      /// \return True if the message was sent over UDP, false if it must
+      /// be sent over the connection.
+      private: bool SendDatagram(const std::string &_data);
+
       private: ConnectionPtr connection;
+
+      /// \brief Shared memory ring of the subscriber, null if messages are
+      /// sent over the connection.
+      private: std::unique_ptr<ShmRing> ring;
+
+      /// \brief True once a message was dropped because the ring was full.
+      private: bool ringFullWarned = false;
+
+      /// \brief Number of messages dropped because the ring was full.
+      private: uint64_t ringDropped = 0;
+
+      /// \brief Address and port of this publisher, empty if messages are
+      /// sent over the connection.
+      private: std::string datagramPublisher;
+
+      /// \brief True if the Publication sends the messages to the
+      /// multicast group of the topic.
+      private: bool multicast = false;
+
+      /// \brief Sender of the messages to the subscriber's host, null
+      /// unless messages are sent over UDP without multicast.
+      private: std::unique_ptr<DatagramChannel> datagrams;
+
+      /// \brief Shortest time between two messages, zero for no limit.
+      private: std::chrono::steady_clock::duration minPeriod =
+               std::chrono::steady_clock::duration::zero();
+
+      /// \brief Time the last message was admitted.
+      private: std::chrono::steady_clock::time_point lastAdmitted;
+
+      /// \brief Number of messages dropped by the rate limit.
+      private: uint64_t rateDropped = 0;
+
+      /// \brief Messages waiting for room in the connection, null if the
+      /// queue has no limit. Shared with the callbacks of the connection.
+      private: std::shared_ptr<SubscriptionQueue> queue;
     };
     /// \}
   }
@@ -18,7 +18,9 @@
 #include <tbb/blocked_range.h>
 
 #include <boost/function.hpp>
+#include "gazebo/common/Profiler.hh"
 #include "gazebo/msgs/msgs.hh"
+#include "gazebo/transport/DatagramChannel.hh"
 #include "gazebo/transport/Node.hh"
 #include "gazebo/transport/Publication.hh"
 #include "gazebo/transport/TopicManager.hh"
@@ -150,17 +152,92 @@ void TopicManager::AddNodeToProcess(NodePtr _ptr)
 }
 
 //////////////////////////////////////////////////
-void TopicManager::ProcessNodes(bool _onlyOut)
+void TopicManager::FillStatistics(msgs::TransportStats &_msg)
+{
+  _msg.Clear();
+  msgs::Set(_msg.mutable_time(), common::Time::GetWallTime());
+
+  for (auto const &pub : this->advertisedTopics)
+  {
+    if (pub.second->GetLocallyAdvertised())
+      pub.second->FillStatistics(*_msg.add_topic());
+  }
+  ConnectionManager::Instance()->FillStatistics(_msg);
+
+  // Rates since the previous call
+  boost::mutex::scoped_lock lock(this->statsMutex);
+  const auto now = std::chrono::steady_clock::now();
+  const double dt = std::chrono::duration<double>(
+      now - this->prevStatsTime).count();
+  std::map<std::string, std::pair<uint64_t, uint64_t>> counts;
+
+  auto rates = [&](const std::string &_key, const uint64_t _messages,
+      const uint64_t _bytes, double &_messageRate, double &_byteRate)
+  {
+    counts[_key] = std::make_pair(_messages, _bytes);
+    auto prev = this->prevStatsCounts.find(_key);
+    if (prev == this->prevStatsCounts.end() || dt <= 0)
+      return;
+    _messageRate = (_messages - prev->second.first) / dt;
+    _byteRate = (_bytes - prev->second.second) / dt;
+  };
+
+  for (auto &topic : *_msg.mutable_topic())
+  {
+    double messageRate = 0;
+    double byteRate = 0;
+    rates(topic.name(), topic.messages(), topic.bytes(), messageRate,
+        byteRate);
+    topic.set_message_rate(messageRate);
+    topic.set_byte_rate(byteRate);
+  }
+
+  for (auto &conn : *_msg.mutable_connection())
+  {
+    double messageRate = 0;
+    double byteRate = 0;
+    rates(conn.remote_uri(), conn.messages(), conn.bytes(), messageRate,
+        byteRate);
+    conn.set_message_rate(messageRate);
+    conn.set_byte_rate(byteRate);
+  }
+
+  this->prevStatsCounts.swap(counts);
+  this->prevStatsTime = now;
+}
+
+//////////////////////////////////////////////////
+void TopicManager::AddPublisherToProcess(PublisherPtr _pub)
 {
+  if (_pub)
   {
     boost::mutex::scoped_lock lock(this->processNodesMutex);
-    for (boost::unordered_set<NodePtr>::iterator iter =
-        this->nodesToProcess.begin();
-        iter != this->nodesToProcess.end(); ++iter)
+    this->publishersToProcess.push_back(_pub);
+  }
+}
+
+//////////////////////////////////////////////////
+void TopicManager::ProcessNodes(bool _onlyOut)
+{
+  GZ_PROFILE("TopicManager::ProcessNodes");
+
+  // Send out the publishers with messages. They are taken out of the lists
+  // first, so that publishing, which adds to them, isn't blocked while they
+  // are sent.
+  {
+    boost::mutex::scoped_lock processLock(this->processPublishersMutex);
+    boost::unordered_set<NodePtr> nodesProcessed;
     {
-      (*iter)->ProcessPublishers();
+      boost::mutex::scoped_lock lock(this->processNodesMutex);
+      nodesProcessed.swap(this->nodesToProcess);
+      this->publishersProcessed.swap(this->publishersToProcess);
     }
-    this->nodesToProcess.clear();
+
+    for (auto &node : nodesProcessed)
+      node->ProcessPublishers();
+    for (auto &pub : this->publishersProcessed)
+      pub->SendMessage();
+    this->publishersProcessed.clear();
   }
 
   // Note: In general there are very few nodes. So, parallelization is not
@@ -354,6 +431,17 @@ void TopicManager::ConnectSubToPub(const msgs::Publish &_pub)
         }
       }
 
+      // Receive over UDP if both sides opted in
+      std::string group;
+      unsigned int port;
+      if (_pub.datagram() &&
+          DatagramChannel::Configured(_pub.topic(), group, port))
+      {
+        publink->InitDatagrams(
+            _pub.host() + ":" + std::to_string(_pub.port()),
+            _pub.datagram_group(), _pub.datagram_port());
+      }
+
       publink->Init(conn, latched);
 
       publication->AddTransport(publink);
@@ -19,6 +19,7 @@
 
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
+#include <chrono>
 #include <map>
 #include <list>
 #include <string>
@@ -237,9 +238,22 @@ namespace gazebo
       public: void PauseIncoming(bool _pause);
 
       /// \brief Add a node to the list of nodes that requires processing.
+      /// All the publishers of the node are sent out.
       /// \param[in] _ptr Node to process.
       public: void AddNodeToProcess(NodePtr _ptr);
 
+      /// \brief Get the counters of the topics advertised in the process
+      /// and of the connections to other processes. The rates are over the
+      /// time since the previous call.
+      /// \param[out] _msg The counters.
+      public: void FillStatistics(msgs::TransportStats &_msg);
+
+      /// \brief Add a publisher with queued messages to the publishers
+      /// that ProcessNodes sends out. Publishers without messages aren't
+      /// visited.
+      /// \param[in] _pub Publisher to process.
+      public: void AddPublisherToProcess(PublisherPtr _pub);
+
       /// \brief A map of string->list of Node pointers
       typedef std::map<std::string, std::list<NodePtr> > SubNodeMap;
 
@@ -252,6 +266,19 @@ namespace gazebo
       /// \brief Nodes that require processing.
       private: boost::unordered_set<NodePtr> nodesToProcess;
 
+      /// \brief Publishers with messages to send, in the order they were
+      /// added. Swapped with publishersProcessed by ProcessNodes, so that
+      /// neither reallocates once grown.
+      private: std::vector<PublisherPtr> publishersToProcess;
+
+      /// \brief Publishers being sent out by ProcessNodes, protected by
+      /// processPublishersMutex.
+      private: std::vector<PublisherPtr> publishersProcessed;
+
+      /// \brief Serializes the calls of ProcessNodes which send out the
+      /// publishers.
+      private: boost::mutex processPublishersMutex;
+
       private: boost::recursive_mutex nodeMutex;
 
       /// \brief Used to protect subscription connection creation.
@@ -262,6 +289,17 @@ namespace gazebo
 
       private: bool pauseIncoming;
 
+      /// \brief Message and byte counts of the previous FillStatistics, by
+      /// topic and by remote URI.
+      private: std::map<std::string, std::pair<uint64_t, uint64_t>>
+               prevStatsCounts;
+
+      /// \brief Time of the previous FillStatistics.
+      private: std::chrono::steady_clock::time_point prevStatsTime;
+
+      /// \brief Protects the previous counts of FillStatistics.
+      private: boost::mutex statsMutex;
+
       // Singleton implementation
       private: friend class SingletonT<TopicManager>;
     };
@@ -20,6 +20,7 @@
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Events.hh"
+#include "gazebo/common/Profiler.hh"
 #include "gazebo/common/SystemPaths.hh"
 #include "gazebo/transport/transport.hh"
 #include "gazebo/util/DiagnosticsPrivate.hh"
@@ -28,6 +29,43 @@
 using namespace gazebo;
 using namespace util;
 
+//////////////////////////////////////////////////
+/// \brief Start or stop the profiler on a message of the ~/profiler topic.
+/// \param[in] _msg "start", "stop", "plugins_start" or "plugins_stop".
+static void OnProfiler(ConstGzStringPtr &_msg)
+{
+  if (_msg->data() == "start")
+  {
+    common::Profiler::Clear();
+    common::Profiler::SetEnabled(true);
+    gzmsg << "Profiler started\n";
+  }
+  else if (_msg->data() == "stop")
+  {
+    common::Profiler::SetEnabled(false);
+
+    boost::filesystem::path path = DiagnosticManager::Instance()->LogPath();
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(path, ec);
+    path /= "profile.json";
+    if (common::Profiler::WriteChromeTrace(path.string()))
+      gzmsg << "Profiler trace written to " << path.string() << "\n";
+  }
+  else if (_msg->data() == "plugins_start")
+  {
+    event::CallbackCost::SetEnabled(true);
+  }
+  else if (_msg->data() == "plugins_stop")
+  {
+    event::CallbackCost::SetEnabled(false);
+  }
+  else
+  {
+    gzwarn << "Unknown profiler command[" << _msg->data()
+           << "], expected start, stop, plugins_start or plugins_stop\n";
+  }
+}
+
 //////////////////////////////////////////////////
 DiagnosticManager::DiagnosticManager()
 : dataPtr(new DiagnosticManagerPrivate)
@@ -71,6 +109,7 @@ DiagnosticManager::~DiagnosticManager()
 void DiagnosticManager::Fini()
 {
   this->dataPtr->updateConnection.reset();
+  this->dataPtr->profilerSub.reset();
 
   this->dataPtr->timers.clear();
 
@@ -90,6 +129,9 @@ void DiagnosticManager::Init(const std::string &_worldName)
   this->dataPtr->pub =
     this->dataPtr->node->Advertise<msgs::Diagnostics>("~/diagnostics");
 
+  this->dataPtr->profilerSub =
+    this->dataPtr->node->Subscribe("~/profiler", &OnProfiler);
+
   this->dataPtr->updateConnection = event::Events::ConnectWorldUpdateBegin(
       std::bind(&DiagnosticManager::Update, this, std::placeholders::_1));
 }
@@ -117,9 +159,26 @@ void DiagnosticManager::Update(const common::UpdateInfo &_info)
   msgs::Set(this->dataPtr->msg.mutable_sim_time(), _info.simTime);
 
   if (this->dataPtr->pub && this->dataPtr->pub->HasConnections())
+  {
+    if (event::CallbackCost::Enabled())
+    {
+      for (const auto &cost : event::CallbackCost::All())
+      {
+        msgs::Diagnostics::PluginCost *pluginCost =
+          this->dataPtr->msg.add_plugin_cost();
+        pluginCost->set_name(cost->owner);
+        pluginCost->set_calls(cost->calls);
+        const int64_t nanoseconds = cost->nanoseconds;
+        msgs::Set(pluginCost->mutable_elapsed(), common::Time(
+              static_cast<int32_t>(nanoseconds / 1000000000),
+              static_cast<int32_t>(nanoseconds % 1000000000)));
+      }
+    }
     this->dataPtr->pub->Publish(this->dataPtr->msg);
+  }
 
   this->dataPtr->msg.clear_time();
+  this->dataPtr->msg.clear_plugin_cost();
 }
 
 //////////////////////////////////////////////////
@@ -83,7 +83,13 @@ namespace gazebo
       /// \brief Destructor
       private: virtual ~DiagnosticManager();
 
-      /// \brief Initialize to report diagnostics about a world.
+      /// \brief Initialize to report diagnostics about a world. This also
+      /// subscribes to the ~/profiler topic of the world, where the
+      /// msgs::GzString "start" clears and enables common::Profiler, and
+      /// "stop" disables it and writes its trace under LogPath().
+      /// "plugins_start" and "plugins_stop" enable and disable
+      /// event::CallbackCost, whose costs are published with the
+      /// diagnostics.
       /// \param[in] _worldName Name of the world.
       public: void Init(const std::string &_worldName);
 
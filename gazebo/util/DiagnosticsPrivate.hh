@@ -53,6 +53,9 @@ namespace gazebo
 
       /// \brief Pointer to the update event connection
       public: event::ConnectionPtr updateConnection;
+
+      /// \brief Subscriber to the profiler commands.
+      public: transport::SubscriberPtr profilerSub;
     };
 
     /// \brief Private data for the DiagnosticTimer class
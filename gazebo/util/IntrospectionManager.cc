@@ -14,9 +14,12 @@
  * limitations under the License.
  *
  */
+#include <chrono>
 #include <functional>
+#include <map>
 #include <set>
 #include <string>
+#include <vector>
 #include <ignition/math/Rand.hh>
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Console.hh"
@@ -32,6 +35,87 @@
 using namespace gazebo;
 using namespace util;
 
+namespace
+{
+  /// \brief Options of a filter, which filter_new and filter_update
+  /// requests may set.
+  struct FilterOptions
+  {
+    /// \brief True if the request sets the rate.
+    bool hasPeriod = false;
+
+    /// \brief Minimum time between two updates, in seconds.
+    double period = 0.0;
+
+    /// \brief True if the request sets the deltas option.
+    bool hasDeltas = false;
+
+    /// \brief True to publish only the values that changed.
+    bool deltas = false;
+  };
+
+  /// \brief Parse a "rate" or "deltas" parameter of a filter request.
+  /// \param[in] _param Parameter, with a STRING value.
+  /// \param[out] _options Options to update.
+  /// \return True if the parameter is valid.
+  bool ParseFilterOption(const gazebo::msgs::Param &_param,
+      FilterOptions &_options)
+  {
+    const std::string &value = _param.value().string_value();
+    if (_param.name() == "rate")
+    {
+      double rate = -1.0;
+      try
+      {
+        rate = std::stod(value);
+      }
+      catch(...)
+      {
+        // Not a number, rejected below.
+      }
+
+      if (rate < 0.0)
+      {
+        gzwarn << "Invalid filter rate [" << value << "]." << std::endl;
+        return false;
+      }
+      _options.hasPeriod = true;
+      _options.period = rate > 0.0 ? 1.0 / rate : 0.0;
+      return true;
+    }
+
+    if (_param.name() == "deltas")
+    {
+      if (value != "true" && value != "false")
+      {
+        gzwarn << "Invalid filter deltas [" << value << "]. Expected 'true' "
+          << "or 'false'." << std::endl;
+        return false;
+      }
+      _options.hasDeltas = true;
+      _options.deltas = value == "true";
+      return true;
+    }
+
+    return false;
+  }
+
+  /// \brief Apply the options of a filter request to a filter.
+  /// \param[in] _options Options of the request.
+  /// \param[out] _filter Filter to update.
+  void ApplyFilterOptions(const FilterOptions &_options,
+      IntrospectionFilter &_filter)
+  {
+    if (_options.hasPeriod)
+      _filter.period = _options.period;
+    if (_options.hasDeltas)
+      _filter.deltas = _options.deltas;
+
+    // The next update contains all the items.
+    _filter.published.clear();
+  }
+}
+
 //////////////////////////////////////////////////
 IntrospectionManager::IntrospectionManager()
   : dataPtr(new IntrospectionManagerPrivate)
@@ -164,57 +248,56 @@ std::set<std::string> IntrospectionManager::Items() const
 //////////////////////////////////////////////////
 void IntrospectionManager::Update()
 {
-  std::map<std::string, IntrospectionFilter> filtersCopy;
-  std::map<std::string, ObservedItem> observedItemsCopy;
-  std::map<std::string, std::function <gazebo::msgs::Any ()>> usedItemsCopy;
+  // Filters due for an update, and the callbacks of their items.
+  std::vector<std::string> dueFilters;
+  std::map<std::string, std::function <gazebo::msgs::Any ()>> dueItems;
 
   {
     std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
-    filtersCopy = this->dataPtr->filters;
-    observedItemsCopy = this->dataPtr->observedItems;
-
-    for (const auto &observedItem: this->dataPtr->observedItems)
+    const auto now = std::chrono::steady_clock::now();
+    for (auto &filter : this->dataPtr->filters)
     {
-      auto &item = observedItem.first;
-      // Sanity check: Make sure that someone registered this item.
-      if (this->dataPtr->allItemsKeys.count(item) == 0)
+      // Skip the filters that nobody listens to.
+      auto pubIter = this->dataPtr->filterPubs.find(
+          this->dataPtr->prefix + "filter/" + filter.first);
+      if (pubIter == this->dataPtr->filterPubs.end() ||
+          !pubIter->second.HasConnections())
       {
         continue;
       }
 
-      usedItemsCopy[item] = this->dataPtr->allItems[item];
-    }
+      // Skip the filters updated less than a period ago.
+      auto &info = filter.second;
+      if (info.period > 0.0 &&
+          info.lastUpdate != std::chrono::steady_clock::time_point() &&
+          std::chrono::duration<double>(now - info.lastUpdate).count() <
+          info.period)
+      {
+        continue;
+      }
+      info.lastUpdate = now;
+      dueFilters.push_back(filter.first);
 
-    for (auto& filter: filtersCopy)
-    {
-      for (auto const &item : filter.second.items)
+      for (auto const &item : info.items)
       {
         // Sanity check: Make sure that someone registered this item.
-        if (this->dataPtr->allItemsKeys.count(item) == 0)
-        {
+        auto itemIter = this->dataPtr->allItems.find(item);
+        if (itemIter == this->dataPtr->allItems.end())
           continue;
-        }
-        usedItemsCopy[item] = this->dataPtr->allItems[item];
+
+        dueItems.emplace(item, itemIter->second);
       }
     }
   }
 
-  for (auto &observedItem : observedItemsCopy)
+  // Evaluate each item once, whatever the number of filters observing it.
+  std::map<std::string, gazebo::msgs::Any> values;
+  for (auto const &item : dueItems)
   {
-    auto &item = observedItem.first;
-    auto itemIter = usedItemsCopy.find(item);
-
-    // Sanity check: Make sure that we can update the item.
-    if (itemIter == usedItemsCopy.end())
-      continue;
-
     try
     {
-      // Update the values of the items under observation.
-      gazebo::msgs::Any value = itemIter->second();
-      auto &lastValue = observedItem.second.lastValue;
-      lastValue.CopyFrom(value);
+      values[item.first] = item.second();
     }
     catch(...)
     {
@@ -223,40 +306,54 @@ void IntrospectionManager::Update()
     }
   }
 
-  // Prepare the next message to be sent in each filter.
-  for (auto &filter : filtersCopy)
+  // Prepare and publish the next message of each filter.
   {
-    // First of all, clear the old message.
-    auto &nextMsg = filter.second.msg;
-    nextMsg.Clear();
-
-    // Insert the last value of each item under observation for this filter.
-    for (auto const &item : filter.second.items)
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    for (auto const &filterId : dueFilters)
     {
-      // Sanity check: Make sure that someone registered this item.
-      if (usedItemsCopy.find(item) == usedItemsCopy.end())
+      // The filter may have been removed while the items were evaluated.
+      auto filterIter = this->dataPtr->filters.find(filterId);
+      if (filterIter == this->dataPtr->filters.end())
         continue;
 
-      // Sanity check: Make sure that the value was updated.
-      // (e.g.: an exception was not raised).
-      auto &lastValue = observedItemsCopy[item].lastValue;
-      if (lastValue.type() == gazebo::msgs::Any::NONE)
-        continue;
+      // First of all, clear the old message.
+      auto &filter = filterIter->second;
+      auto &nextMsg = filter.msg;
+      nextMsg.Clear();
 
-      auto nextParam = nextMsg.add_param();
-      nextParam->set_name(item);
-      nextParam->mutable_value()->CopyFrom(lastValue);
-    }
+      // Insert the value of each item under observation for this filter.
+      for (auto const &item : filter.items)
+      {
+        // Sanity check: Make sure that the value was updated.
+        // (e.g.: the item is registered and an exception was not raised).
+        auto valueIter = values.find(item);
+        if (valueIter == values.end() ||
+            valueIter->second.type() == gazebo::msgs::Any::NONE)
+        {
+          continue;
+        }
 
-    // Sanity check: Make sure that we have at least one item updated.
-    if (nextMsg.param_size() == 0)
-      continue;
+        // Skip the values which didn't change since the previous update.
+        if (filter.deltas)
+        {
+          std::string serialized = valueIter->second.SerializeAsString();
+          auto &previous = filter.published[item];
+          if (previous == serialized)
+            continue;
+          previous.swap(serialized);
+        }
 
-    // Publish the update for this filter.
-    std::string topicName = this->dataPtr->prefix + "filter/" + filter.first;
+        auto nextParam = nextMsg.add_param();
+        nextParam->set_name(item);
+        nextParam->mutable_value()->CopyFrom(valueIter->second);
+      }
 
-    {
-      std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+      // Sanity check: Make sure that we have at least one item updated.
+      if (nextMsg.param_size() == 0)
+        continue;
+
+      // Publish the update for this filter.
+      std::string topicName = this->dataPtr->prefix + "filter/" + filterId;
       if (this->dataPtr->filterPubs.find(topicName) ==
           this->dataPtr->filterPubs.end() ||
           !this->dataPtr->filterPubs[topicName].Publish(nextMsg))
@@ -459,20 +556,29 @@ bool IntrospectionManager::NewFilter(const gazebo::msgs::Param_V &_req,
   }
 
   std::set<std::string> requestedItems;
+  FilterOptions options;
 
   // Store the new filter.
   for (auto i = 0; i < _req.param_size(); ++i)
   {
     auto param = _req.param(i);
-    if (!this->ValidateParameter(param, {"item"}))
+    if (!this->ValidateParameter(param, {"item", "rate", "deltas"}))
     {
       gzwarn << "Invalid parameter[" << param.name() << "] "
         << "Ignoring request." << std::endl;
       return false;
     }
 
-    auto item = param.value().string_value();
-    requestedItems.emplace(item);
+    if (param.name() == "item")
+    {
+      auto item = param.value().string_value();
+      requestedItems.emplace(item);
+    }
+    else if (!ParseFilterOption(param, options))
+    {
+      gzwarn << "Ignoring request." << std::endl;
+      return false;
+    }
   }
 
   std::string topicName;
@@ -482,6 +588,13 @@ bool IntrospectionManager::NewFilter(const gazebo::msgs::Param_V &_req,
     return false;
   }
 
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    auto filterIter = this->dataPtr->filters.find(topicName);
+    if (filterIter != this->dataPtr->filters.end())
+      ApplyFilterOptions(options, filterIter->second);
+  }
+
   // Answer with the custom topic created for the client.
   _rep.set_data(topicName);
   return true;
@@ -501,11 +614,13 @@ bool IntrospectionManager::UpdateFilter(const gazebo::msgs::Param_V &_req,
 
   std::set<std::string> newItems;
   std::string filterId;
+  FilterOptions options;
 
   for (auto i = 0; i < _req.param_size(); ++i)
   {
     auto param = _req.param(i);
-    if (!this->ValidateParameter(param, {"item", "filter_id"}))
+    if (!this->ValidateParameter(param,
+          {"item", "filter_id", "rate", "deltas"}))
     {
       gzwarn << "Ignoring request." << std::endl;
       return false;
@@ -529,6 +644,14 @@ bool IntrospectionManager::UpdateFilter(const gazebo::msgs::Param_V &_req,
       // Save filter ID to be updated.
       filterId = param.value().string_value();
     }
+    else if (param.name() == "rate" || param.name() == "deltas")
+    {
+      if (!ParseFilterOption(param, options))
+      {
+        gzwarn << "Ignoring request." << std::endl;
+        return false;
+      }
+    }
     else
     {
       gzwarn << "Unexpected param name [" << param.name() << "]." << std::endl;
@@ -545,7 +668,14 @@ bool IntrospectionManager::UpdateFilter(const gazebo::msgs::Param_V &_req,
     return false;
   }
 
-  return this->UpdateFilterImpl(filterId, newItems);
+  if (!this->UpdateFilterImpl(filterId, newItems))
+    return false;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto filterIter = this->dataPtr->filters.find(filterId);
+  if (filterIter != this->dataPtr->filters.end())
+    ApplyFilterOptions(options, filterIter->second);
+  return true;
 }
 
 //////////////////////////////////////////////////
@@ -86,7 +86,10 @@ namespace gazebo
       /// \brief Update all the items under observation and publish updates
       /// through all the topics. The message received in the update will
       /// contain the name and latest values of all the items specified
-      /// in the filter.
+      /// in the filter, or only the ones that changed if the filter
+      /// publishes deltas. Only the items of the filters with subscribers
+      /// and due for an update according to their rate are evaluated, once
+      /// each.
       /// If there are changes in the items list since the last update,
       /// a new message is published under the topic
       /// "/introspection/<manager_id>/items_update".
@@ -139,6 +142,10 @@ namespace gazebo
       /// \param[in] _req Input parameter of the service request. The service
       /// expects a collection of one or more parameters with name "item" and a
       /// value of type STRING containing the name of the item to observe.
+      /// Optionally, a parameter "rate" with the maximum number of updates
+      /// per second (e.g.: "30", or "0" for every update), and a parameter
+      /// "deltas" set to "true" to publish only the items whose value
+      /// changed since the previous update of the filter.
       /// \param[out] _rep Output parameter of the service request. It contains
       /// the filter ID created.
       /// \return True when the operation succeed or false
@@ -152,6 +159,8 @@ namespace gazebo
       /// containing the filter ID to be updated. Also, it's expected to have
       /// a collection of one or more parameters with name "item" and a
       /// value of type STRING containing the name of the item to observe.
+      /// The optional "rate" and "deltas" parameters of NewFilter() change
+      /// the options of the filter. The next update contains all the items.
       /// \param[out] _rep Not used.
       /// \return True when the filter was successfully updated or
       /// false otherwise.
@@ -17,6 +17,7 @@
 #ifndef GAZEBO_UTIL_INTROSPECTION_MANAGER_PRIVATE_HH_
 #define GAZEBO_UTIL_INTROSPECTION_MANAGER_PRIVATE_HH_
 
+#include <chrono>
 #include <functional>
 #include <map>
 #include <mutex>
@@ -38,8 +39,23 @@ namespace gazebo
       std::set<std::string> items;
 
       /// \brief Message containing the next update. A message is a collection
-      /// of items and values.
+      /// of items and values. It's reused between updates.
       msgs::Param_V msg;
+
+      /// \brief Minimum time between two updates, in seconds. Zero publishes
+      /// an update on every IntrospectionManager::Update().
+      double period = 0.0;
+
+      /// \brief Time of the last update.
+      std::chrono::steady_clock::time_point lastUpdate;
+
+      /// \brief True if an update only contains the items whose value
+      /// changed since the previous update.
+      bool deltas = false;
+
+      /// \brief Serialized value of each item in the previous update, used
+      /// when deltas is true.
+      std::map<std::string, std::string> published;
     };
 
     /// \brief Todo.
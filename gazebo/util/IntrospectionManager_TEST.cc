@@ -15,6 +15,10 @@
  *
 */
 
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <ignition/math/Pose3.hh>
 #include <ignition/math/Quaternion.hh>
 #include <ignition/math/Vector3.hh>
@@ -240,6 +244,129 @@ TEST_F(IntrospectionManagerTest, UpdateItems)
   EXPECT_EQ(items.param_size(), 0);
 }
 
+/////////////////////////////////////////////////
+TEST_F(IntrospectionManagerTest, FilterDeltasAndRate)
+{
+  // An item whose value changes on every update.
+  double counter = 0.0;
+  auto func = [&counter]()
+  {
+    counter += 1.0;
+    return counter;
+  };
+  EXPECT_TRUE(this->manager->Register<double>("item4", func));
+
+  const std::string prefix = "/introspection/" + this->manager->Id() + "/";
+  ignition::transport::Node node;
+
+  // Create a filter publishing deltas.
+  gazebo::msgs::Param_V req;
+  for (auto const &item : {"item1", "item4"})
+  {
+    auto param = req.add_param();
+    param->set_name("item");
+    param->mutable_value()->set_type(gazebo::msgs::Any::STRING);
+    param->mutable_value()->set_string_value(item);
+  }
+  auto deltas = req.add_param();
+  deltas->set_name("deltas");
+  deltas->mutable_value()->set_type(gazebo::msgs::Any::STRING);
+  deltas->mutable_value()->set_string_value("true");
+
+  gazebo::msgs::GzString rep;
+  bool result = false;
+  EXPECT_TRUE(node.Request(prefix + "filter_new", req, 1000u, rep, result));
+  EXPECT_TRUE(result);
+  const std::string filterId = rep.data();
+  EXPECT_FALSE(filterId.empty());
+
+  std::mutex mutex;
+  int received = 0;
+  gazebo::msgs::Param_V last;
+  std::function<void(const gazebo::msgs::Param_V&)> subCb =
+    [&mutex, &received, &last](const gazebo::msgs::Param_V &_msg)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      ++received;
+      last.CopyFrom(_msg);
+    };
+  EXPECT_TRUE(node.Subscribe(prefix + "filter/" + filterId, subCb));
+
+  auto waitFor = [&mutex, &received](const int _count)
+  {
+    for (int i = 0; i < 10; ++i)
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (received >= _count)
+          return;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+  };
+
+  // The first update contains all the items.
+  this->manager->Update();
+  waitFor(1);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(1, received);
+    EXPECT_EQ(2, last.param_size());
+  }
+
+  // The next ones only contain the item that changed.
+  this->manager->Update();
+  waitFor(2);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(2, received);
+    ASSERT_EQ(1, last.param_size());
+    EXPECT_EQ("item4", last.param(0).name());
+    EXPECT_DOUBLE_EQ(2.0, last.param(0).value().double_value());
+  }
+
+  // Limit the rate to one update every 100 seconds.
+  req.Clear();
+  auto id = req.add_param();
+  id->set_name("filter_id");
+  id->mutable_value()->set_type(gazebo::msgs::Any::STRING);
+  id->mutable_value()->set_string_value(filterId);
+  auto item = req.add_param();
+  item->set_name("item");
+  item->mutable_value()->set_type(gazebo::msgs::Any::STRING);
+  item->mutable_value()->set_string_value("item4");
+  auto rate = req.add_param();
+  rate->set_name("rate");
+  rate->mutable_value()->set_type(gazebo::msgs::Any::STRING);
+  rate->mutable_value()->set_string_value("0.01");
+
+  gazebo::msgs::Empty empty;
+  EXPECT_TRUE(node.Request(prefix + "filter_update", req, 1000u, empty,
+        result));
+  EXPECT_TRUE(result);
+
+  // The item isn't evaluated until the period elapses.
+  this->manager->Update();
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  EXPECT_DOUBLE_EQ(2.0, counter);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(2, received);
+  }
+
+  // An invalid rate is rejected.
+  rate->mutable_value()->set_string_value("-1");
+  node.Request(prefix + "filter_update", req, 1000u, empty, result);
+  EXPECT_FALSE(result);
+
+  gazebo::msgs::Param_V removeReq;
+  removeReq.add_param()->CopyFrom(*id);
+  EXPECT_TRUE(node.Request(prefix + "filter_remove", removeReq, 1000u, empty,
+        result));
+  EXPECT_TRUE(result);
+  EXPECT_TRUE(this->manager->Unregister("item4"));
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
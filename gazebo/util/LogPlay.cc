@@ -23,6 +23,14 @@
 #endif
 
 #include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/iostreams/filter/bzip2.hpp>
@@ -40,11 +48,20 @@
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Base64.hh"
+#include "gazebo/common/MemoryTracker.hh"
 #include "gazebo/util/LogRecord.hh"
 
 #include "gazebo/util/LogPlayPrivate.hh"
 #include "gazebo/util/LogPlay.hh"
 
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#ifdef HAVE_LZ4
+#include <lz4frame.h>
+#endif
+
 using namespace gazebo;
 using namespace util;
 
@@ -53,17 +70,36 @@ LogPlay::LogPlay()
 : dataPtr(new LogPlayPrivate)
 {
   this->dataPtr->logStartXml = NULL;
+
+  // The tracker is created first, so it outlives the player
+  common::MemoryTracker *tracker = common::MemoryTracker::Instance();
+  this->dataPtr->memory = &tracker->Counter("log");
+  LogPlayPrivate *data = this->dataPtr.get();
+  this->dataPtr->evictor = tracker->AddEvictor("log",
+      [data](const uint64_t _bytes)
+      {
+        data->EvictChunks(_bytes);
+      });
 }
 
 /////////////////////////////////////////////////
 LogPlay::~LogPlay()
 {
+  common::MemoryTracker::Instance()->RemoveEvictor(this->dataPtr->evictor);
+  this->dataPtr->ClearChunks();
 }
 
 /////////////////////////////////////////////////
 void LogPlay::Open(const std::string &_logFile)
 {
   this->dataPtr->currentChunk.clear();
+  this->dataPtr->ClearChunks();
+  this->dataPtr->chunks.clear();
+  this->dataPtr->index.clear();
+  this->dataPtr->logStartXml = nullptr;
+  this->dataPtr->xmlDoc.Clear();
+  if (this->dataPtr->mappedFile.is_open())
+    this->dataPtr->mappedFile.close();
 
   boost::filesystem::path path(_logFile);
   if (!boost::filesystem::exists(path))
@@ -72,12 +108,9 @@ void LogPlay::Open(const std::string &_logFile)
   if (boost::filesystem::is_directory(path))
     gzthrow("Invalid logfile [" + _logFile + "]. This is a directory.");
 
-  // Flag use to indicate if a parser failure has occurred
-  bool xmlParserFail = this->dataPtr->xmlDoc.LoadFile(_logFile.c_str()) !=
-    tinyxml2::XML_SUCCESS;
+  // Store the filename for future use.
+  this->dataPtr->filename = _logFile;
 
-  // Parse the log file
-  if (xmlParserFail)
   {
     std::string endTag = "</gazebo_log>";
     // Open the log file for reading, we will check if the end of the log
@@ -85,16 +118,17 @@ void LogPlay::Open(const std::string &_logFile)
     std::ifstream inFile(_logFile);
     if (inFile)
     {
-      // Move to the end of the file
-      int len = -1 - static_cast<int>(endTag.length());
-      inFile.seekg(len, std::ios::end);
-
-      // Get the last line
-      std::string lastLine;
-      std::getline(inFile, lastLine);
+      // Get the end of the file, with or without a trailing newline
+      inFile.seekg(0, std::ios::end);
+      const std::streamoff size = inFile.tellg();
+      const std::streamoff tailSize = endTag.length() + 2;
+      inFile.seekg(std::max<std::streamoff>(0, size - tailSize));
+      std::string lastLine((std::istreambuf_iterator<char>(inFile)),
+          std::istreambuf_iterator<char>());
       inFile.close();
 
-      // Add missing </gazebo_log> if not present.
+      // Add missing </gazebo_log> if not present. This happens when the
+      // recording didn't stop cleanly.
       if (lastLine.find(endTag) == std::string::npos)
       {
         // Open the log file for append
@@ -104,50 +138,65 @@ void LogPlay::Open(const std::string &_logFile)
           // Add the end tag
           fix << endTag << std::endl;
           fix.close();
-
-          // Retry loading the log file.
-          xmlParserFail = this->dataPtr->xmlDoc.LoadFile(_logFile.c_str()) !=
-            tinyxml2::XML_SUCCESS;
         }
       }
     }
   }
 
-  // Output error and throw if the log file had a problem.
-  // \todo Remove throws in this class. A failure to open a log file is not
-  // a critical failure.
-  if (xmlParserFail)
+  // Decode the chunks from the mapped file as they're played, rather than
+  // holding the whole log in memory. Logs the scanner doesn't understand
+  // are parsed in full.
+  if (!this->dataPtr->MapLog())
   {
-    gzerr << "Unable to load file[" << _logFile << "]. "
-      << "Check the Gazebo server log file for more information.\n";
+    // Flag use to indicate if a parser failure has occurred
+    bool xmlParserFail = this->dataPtr->xmlDoc.LoadFile(_logFile.c_str()) !=
+      tinyxml2::XML_SUCCESS;
+
+    // Output error and throw if the log file had a problem.
+    // \todo Remove throws in this class. A failure to open a log file is
+    // not a critical failure.
+    if (xmlParserFail)
+    {
+      gzerr << "Unable to load file[" << _logFile << "]. "
+        << "Check the Gazebo server log file for more information.\n";
 #ifdef TINYXML2_MAJOR_VERSION_GE_6
-    const char *errorStr1 = this->dataPtr->xmlDoc.ErrorStr();
-    const char *errorStr2 = nullptr;
+      const char *errorStr1 = this->dataPtr->xmlDoc.ErrorStr();
+      const char *errorStr2 = nullptr;
 #else
-    const char *errorStr1 = this->dataPtr->xmlDoc.GetErrorStr1();
-    const char *errorStr2 = this->dataPtr->xmlDoc.GetErrorStr2();
+      const char *errorStr1 = this->dataPtr->xmlDoc.GetErrorStr1();
+      const char *errorStr2 = this->dataPtr->xmlDoc.GetErrorStr2();
 #endif
-    if (errorStr1)
-      gzlog << "Log Error 1:\n" << errorStr1 << std::endl;
-    if (errorStr2)
-      gzlog << "Log Error 2:\n" << errorStr2 << std::endl;
-    gzthrow("Error parsing log file");
-  }
+      if (errorStr1)
+        gzlog << "Log Error 1:\n" << errorStr1 << std::endl;
+      if (errorStr2)
+        gzlog << "Log Error 2:\n" << errorStr2 << std::endl;
+      gzthrow("Error parsing log file");
+    }
 
-  // Get the gazebo_log element
-  this->dataPtr->logStartXml =
-    this->dataPtr->xmlDoc.FirstChildElement("gazebo_log");
+    // Get the gazebo_log element
+    this->dataPtr->logStartXml =
+      this->dataPtr->xmlDoc.FirstChildElement("gazebo_log");
 
-  if (!this->dataPtr->logStartXml)
-    gzthrow("Log file is missing the <gazebo_log> element");
+    if (!this->dataPtr->logStartXml)
+      gzthrow("Log file is missing the <gazebo_log> element");
 
-  // Store the filename for future use.
-  this->dataPtr->filename = _logFile;
+    // Collect the chunks once, so they can be reached by position.
+    for (auto xml = this->dataPtr->logStartXml->FirstChildElement("chunk");
+         xml; xml = xml->NextSiblingElement("chunk"))
+    {
+      LogChunk chunk;
+      chunk.xml = xml;
+      const char *encoding = xml->Attribute("encoding");
+      if (encoding)
+        chunk.encoding = encoding;
+      this->dataPtr->chunks.push_back(chunk);
+    }
+  }
 
   // Read in the header.
   this->ReadHeader();
 
-  this->dataPtr->logCurrXml = this->dataPtr->logStartXml;
+  this->dataPtr->ReadIndex();
   this->dataPtr->encoding.clear();
 
   // Extract the start/end log times from the log.
@@ -156,13 +205,11 @@ void LogPlay::Open(const std::string &_logFile)
   // Extract the initial "iterations" value from the log.
   this->dataPtr->iterationsFound = this->ReadIterations();
 
-  this->dataPtr->logCurrXml =
-    this->dataPtr->logStartXml->FirstChildElement("chunk");
-
-  if (!this->dataPtr->logCurrXml)
+  if (this->dataPtr->chunks.empty())
     gzthrow("Unable to find the first chunk");
 
-  if (!this->dataPtr->ChunkData(this->dataPtr->logCurrXml,
+  this->dataPtr->logCurrChunk = 0;
+  if (!this->dataPtr->ChunkData(this->dataPtr->logCurrChunk,
                                 this->dataPtr->currentChunk))
   {
     gzthrow("Unable to decode log file");
@@ -182,8 +229,13 @@ std::string LogPlay::Header() const
          << "<log_version>" << this->dataPtr->logVersion << "</log_version>\n"
          << "<gazebo_version>" << this->dataPtr->gazeboVersion
          << "</gazebo_version>\n"
-         << "<rand_seed>" << this->dataPtr->randSeed << "</rand_seed>\n"
-         << "<log_start>" << this->dataPtr->logStartTime << "</log_start>\n"
+         << "<rand_seed>" << this->dataPtr->randSeed << "</rand_seed>\n";
+  if (this->dataPtr->keyframePeriod > 0)
+  {
+    stream << "<keyframe_period>" << this->dataPtr->keyframePeriod
+           << "</keyframe_period>\n";
+  }
+  stream << "<log_start>" << this->dataPtr->logStartTime << "</log_start>\n"
          << "<log_end>" << this->dataPtr->logEndTime << "</log_end>\n"
          << "</header>\n";
 
@@ -211,6 +263,7 @@ void LogPlay::ReadHeader()
 
   this->dataPtr->logVersion.clear();
   this->dataPtr->gazeboVersion.clear();
+  this->dataPtr->keyframePeriod = 0;
 
   // Get the header element
   headerXml = this->dataPtr->logStartXml->FirstChildElement("header");
@@ -253,6 +306,21 @@ void LogPlay::ReadHeader()
 
   // Set the random number seed for simulation
   ignition::math::Rand::Seed(this->dataPtr->randSeed);
+
+  // Only logs recorded with keyframes have a keyframe period.
+  childXml = headerXml->FirstChildElement("keyframe_period");
+  if (childXml && childXml->GetText())
+  {
+    try
+    {
+      this->dataPtr->keyframePeriod = std::stod(childXml->GetText());
+    }
+    catch(...)
+    {
+      gzwarn << "Invalid keyframe period[" << childXml->GetText()
+             << "] in log file header.\n";
+    }
+  }
 }
 
 /////////////////////////////////////////////////
@@ -261,7 +329,16 @@ void LogPlay::ReadLogTimes()
   std::string chunk;
   bool found = false;
 
-  auto chunkXml = this->dataPtr->logStartXml->FirstChildElement("chunk");
+  // The index has the times without decompressing any chunk.
+  for (auto const &entry : this->dataPtr->index)
+  {
+    if (entry.hasTime)
+    {
+      this->dataPtr->logStartTime = entry.first;
+      this->dataPtr->logEndTime = this->dataPtr->index.back().last;
+      return;
+    }
+  }
 
   // Try to read the start time of the log.
   auto numChunksToTry =
@@ -269,13 +346,7 @@ void LogPlay::ReadLogTimes()
 
   for (unsigned int i = 0; i < numChunksToTry; ++i)
   {
-    if (!chunkXml)
-    {
-      gzerr << "Unable to find the first chunk" << std::endl;
-      return;
-    }
-
-    if (!this->dataPtr->ChunkData(chunkXml, chunk))
+    if (!this->dataPtr->ChunkData(i, chunk))
       return;
 
     // Find the first <sim_time> of the log.
@@ -292,22 +363,19 @@ void LogPlay::ReadLogTimes()
       found = true;
       break;
     }
-
-    chunkXml = chunkXml->NextSiblingElement("chunk");
   }
 
   if (!found)
     gzwarn << "Unable to find <sim_time> tags in any chunk." << std::endl;
 
   // Jump to the last chunk for finding the last <sim_time>.
-  auto lastChunk = this->dataPtr->logStartXml->LastChildElement("chunk");
-  if (!lastChunk)
+  if (this->dataPtr->chunks.empty())
   {
     gzerr << "Unable to jump to the last chunk of the log file\n";
     return;
   }
 
-  if (!this->dataPtr->ChunkData(lastChunk, chunk))
+  if (!this->dataPtr->ChunkData(this->ChunkCount() - 1, chunk))
     return;
 
   // Update the last <sim_time> of the log.
@@ -336,7 +404,14 @@ bool LogPlay::ReadIterations()
   const std::string kStartDelim = "<iterations>";
   const std::string kEndDelim = "</iterations>";
 
-  auto chunkXml = this->dataPtr->logStartXml->FirstChildElement("chunk");
+  for (auto const &entry : this->dataPtr->index)
+  {
+    if (entry.hasIterations)
+    {
+      this->dataPtr->initialIterations = entry.iterations;
+      return true;
+    }
+  }
 
   // Read the first "iterations" value of the log from the first chunk.
   auto numChunksToTry =
@@ -344,14 +419,8 @@ bool LogPlay::ReadIterations()
 
   for (unsigned int i = 0; i < numChunksToTry; ++i)
   {
-    if (!chunkXml)
-    {
-      gzerr << "Unable to find the first chunk" << std::endl;
-      return false;
-    }
-
     std::string chunk;
-    if (!this->dataPtr->ChunkData(chunkXml, chunk))
+    if (!this->dataPtr->ChunkData(i, chunk))
       return false;
 
     // Find the first <iterations> of the log.
@@ -365,8 +434,6 @@ bool LogPlay::ReadIterations()
       ss >> this->dataPtr->initialIterations;
       return true;
     }
-
-    chunkXml = chunkXml->NextSiblingElement("chunk");
   }
 
   gzwarn << "Unable to find <iterations>...</iterations> tags in the first "
@@ -536,16 +603,14 @@ bool LogPlay::Rewind()
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
   this->dataPtr->currentChunk.clear();
-  this->dataPtr->logCurrXml =
-    this->dataPtr->logStartXml->FirstChildElement("chunk");
-
-  if (!this->dataPtr->logCurrXml)
+  if (this->dataPtr->chunks.empty())
   {
     gzerr << "Unable to jump to the beginning of the log file\n";
     return false;
   }
 
-  if (!this->dataPtr->ChunkData(this->dataPtr->logCurrXml,
+  this->dataPtr->logCurrChunk = 0;
+  if (!this->dataPtr->ChunkData(this->dataPtr->logCurrChunk,
                                 this->dataPtr->currentChunk))
   {
     return false;
@@ -576,16 +641,14 @@ bool LogPlay::Forward()
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
   // Get the last chunk.
-  this->dataPtr->logCurrXml =
-    this->dataPtr->logStartXml->LastChildElement("chunk");
-
-  if (!this->dataPtr->logCurrXml)
+  if (this->dataPtr->chunks.empty())
   {
     gzerr << "Unable to jump to the end of the log file\n";
     return false;
   }
 
-  if (!this->dataPtr->ChunkData(this->dataPtr->logCurrXml,
+  this->dataPtr->logCurrChunk = this->dataPtr->chunks.size() - 1;
+  if (!this->dataPtr->ChunkData(this->dataPtr->logCurrChunk,
                                 this->dataPtr->currentChunk))
   {
     return false;
@@ -608,206 +671,825 @@ bool LogPlay::Seek(const common::Time &_time)
     return true;
   }
 
-  common::Time logTime = this->dataPtr->logStartTime;
+  if (this->dataPtr->index.empty() && !this->dataPtr->BuildIndex())
+    return false;
+
+  // The first frame at or after the target time is in the first chunk
+  // that ends at or after it.
+  auto entry = std::lower_bound(this->dataPtr->index.begin(),
+      this->dataPtr->index.end(), _time,
+      [](const LogChunkIndex &_entry, const common::Time &_target)
+      {
+        return _entry.last < _target;
+      });
+  if (entry == this->dataPtr->index.end())
+    --entry;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
-  // 1st step: Locate the chunk: We're looking for the first chunk that has
-  // a time greater than the target time.
-  int64_t imin = 0;
-  int64_t imax = this->ChunkCount() - 1;
-  while (imin <= imax)
+  this->dataPtr->logCurrChunk = entry - this->dataPtr->index.begin();
+  if (!this->dataPtr->ChunkData(this->dataPtr->logCurrChunk,
+                                this->dataPtr->currentChunk))
   {
-    int64_t imid = imin + ((imax - imin) / 2);
-    this->Chunk(imid, this->dataPtr->currentChunk);
+    return false;
+  }
 
-    this->dataPtr->start = 0;
-    this->dataPtr->end = -1 * this->dataPtr->kEndFrame.size();
+  // Stop on the frame before the first one at or after the target time,
+  // so that it's the next one returned by Step().
+  const std::string &chunk = this->dataPtr->currentChunk;
+  this->dataPtr->start = 0;
+  this->dataPtr->end = -1 * this->dataPtr->kEndFrame.size();
+
+  auto from = chunk.find(this->dataPtr->kStartFrame);
+  while (from != std::string::npos)
+  {
+    auto to = chunk.find(this->dataPtr->kEndFrame, from);
+    if (to == std::string::npos)
+      break;
 
-    // We try a few times looking for <sim_time>.
-    for (unsigned int i = 0; i < 2; ++i)
+    common::Time logTime;
+    if (this->dataPtr->FrameTime(chunk, from, to, logTime) &&
+        logTime >= _time)
     {
-      std::string frame;
-      if (!this->Step(frame))
-        return false;
+      break;
+    }
+
+    this->dataPtr->start = from;
+    this->dataPtr->end = to;
+    from = chunk.find(this->dataPtr->kStartFrame,
+        to + this->dataPtr->kEndFrame.size());
+  }
 
-      // Search the <sim_time> in the first frame of the current chunk.
-      auto from = frame.find(this->dataPtr->kStartTime);
-      auto to = frame.find(
-          this->dataPtr->kEndTime, from + this->dataPtr->kStartTime.size());
-      if (from != std::string::npos && to != std::string::npos)
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool LogPlay::Keyframe(const common::Time &_time,
+    std::vector<std::string> &_frames)
+{
+  _frames.clear();
+
+  if (this->dataPtr->index.empty() && !this->dataPtr->BuildIndex())
+    return false;
+
+  auto entry = std::lower_bound(this->dataPtr->index.begin(),
+      this->dataPtr->index.end(), _time,
+      [](const LogChunkIndex &_entry, const common::Time &_target)
+      {
+        return _entry.last < _target;
+      });
+  if (entry == this->dataPtr->index.end())
+    --entry;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  const std::string &kStartFrame = this->dataPtr->kStartFrame;
+  const std::string &kEndFrame = this->dataPtr->kEndFrame;
+
+  // Frames after the keyframe that insert or delete entities, newest first
+  std::vector<std::string> deltas;
+
+  // Walk the chunks back from the one of the target time
+  std::string chunk;
+  for (size_t c = entry - this->dataPtr->index.begin() + 1; c-- > 0;)
+  {
+    if (!this->dataPtr->ChunkData(c, chunk))
+      return false;
+
+    // Frames of the chunk before the target time, as [begin, end)
+    std::vector<std::pair<size_t, size_t>> frames;
+    auto from = chunk.find(kStartFrame);
+    while (from != std::string::npos)
+    {
+      auto to = chunk.find(kEndFrame, from);
+      if (to == std::string::npos)
+        break;
+
+      common::Time logTime;
+      if (this->dataPtr->FrameTime(chunk, from, to, logTime) &&
+          logTime >= _time)
       {
-        auto length = to - from - this->dataPtr->kStartTime.size();
-        auto logTimeStr = frame.substr(
-            from + this->dataPtr->kStartTime.size(), length);
-        std::stringstream ss(logTimeStr);
-        ss >> logTime;
         break;
       }
+
+      frames.emplace_back(from, to + kEndFrame.size());
+      from = chunk.find(kStartFrame, to + kEndFrame.size());
     }
 
-    // Chunk found.
-    if (logTime == _time)
-      break;
-    else if (logTime < _time)
-      imin = imid + 1;
-    else
-      imax = imid - 1;
+    for (auto frame = frames.rbegin(); frame != frames.rend(); ++frame)
+    {
+      auto contains = [&](const std::string &_tag)
+      {
+        auto pos = chunk.find(_tag, frame->first);
+        return pos != std::string::npos && pos < frame->second;
+      };
+
+      // The first frame of the log has the world's SDF
+      if (contains(this->dataPtr->kStartKeyframe) ||
+          (c == 0 && frame + 1 == frames.rend()))
+      {
+        _frames.push_back(chunk.substr(frame->first,
+              frame->second - frame->first));
+        _frames.insert(_frames.end(), deltas.rbegin(), deltas.rend());
+        return true;
+      }
+
+      if (contains(this->dataPtr->kInsertions) ||
+          contains(this->dataPtr->kDeletions))
+      {
+        deltas.push_back(chunk.substr(frame->first,
+              frame->second - frame->first));
+      }
+    }
   }
 
-  if (logTime < _time)
+  return false;
+}
+
+/////////////////////////////////////////////////
+double LogPlay::KeyframePeriod() const
+{
+  return this->dataPtr->keyframePeriod;
+}
+
+/////////////////////////////////////////////////
+double LogPlay::PlayPeriod() const
+{
+  return this->dataPtr->playPeriod;
+}
+
+/////////////////////////////////////////////////
+void LogPlay::SetPlayPeriod(const double _period)
+{
+  this->dataPtr->playPeriod = std::max(0.0, _period);
+}
+
+/////////////////////////////////////////////////
+bool LogPlay::Chunk(unsigned int _index, std::string &_data) const
+{
+  if (_index >= this->dataPtr->chunks.size())
+    return false;
+
+  this->dataPtr->logCurrChunk = _index;
+  return this->dataPtr->ChunkData(_index, _data);
+}
+
+/////////////////////////////////////////////////
+bool LogPlay::ChunkFrames(const unsigned int _index,
+    std::vector<std::string> &_frames) const
+{
+  _frames.clear();
+
+  if (_index >= this->dataPtr->chunks.size())
   {
-    if (!this->NextChunk())
-      this->Forward();
+    gzerr << "Invalid chunk index[" << _index << "]" << std::endl;
+    return false;
   }
 
-  // 2nd step: Locate the frame in the previous chunk.
-  while (true)
+  std::string chunk;
+  if (!this->dataPtr->DecodeChunk(_index, chunk))
+    return false;
+
+  // Split the chunk the same way Step does
+  const std::string &kStartFrame = this->dataPtr->kStartFrame;
+  const std::string &kEndFrame = this->dataPtr->kEndFrame;
+  auto from = chunk.find(kStartFrame);
+  auto to = chunk.find(kEndFrame);
+  while (from != std::string::npos && to != std::string::npos)
   {
-    std::string frame;
-    if (!this->StepBack(frame))
+    _frames.push_back(chunk.substr(from, to + kEndFrame.size() - from));
+    from = chunk.find(kStartFrame, to + kEndFrame.size());
+    to = chunk.find(kEndFrame, to + kEndFrame.size());
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool LogPlay::ChunkMessages(const unsigned int _index,
+    std::vector<LogMessage> &_messages) const
+{
+  _messages.clear();
+
+  if (_index >= this->dataPtr->chunks.size())
+  {
+    gzerr << "Invalid chunk index[" << _index << "]" << std::endl;
+    return false;
+  }
+
+  std::string chunk;
+  if (!this->dataPtr->DecodeChunk(_index, chunk))
+    return false;
+
+  const std::string kStartMessage = "<message ";
+  const std::string kEndMessage = "</message>";
+  auto from = chunk.find(kStartMessage);
+  while (from != std::string::npos)
+  {
+    auto to = chunk.find(kEndMessage, from);
+    if (to == std::string::npos)
       break;
+    to += kEndMessage.size();
 
-    // Search the <sim_time> in the frame of the current chunk.
-    auto from = frame.find(this->dataPtr->kStartTime);
-    auto to = frame.find(
-        this->dataPtr->kEndTime, from + this->dataPtr->kStartTime.size());
-    if (from != std::string::npos && to != std::string::npos)
+    tinyxml2::XMLDocument doc;
+    if (doc.Parse(chunk.c_str() + from, to - from) != tinyxml2::XML_SUCCESS ||
+        !doc.FirstChildElement("message"))
     {
-      auto length = to - from - this->dataPtr->kStartTime.size();
-      auto logTimeStr = frame.substr(
-          from + this->dataPtr->kStartTime.size(), length);
-      std::stringstream ss(logTimeStr);
-      ss >> logTime;
+      gzerr << "Unable to parse a message of chunk[" << _index << "]\n";
+      return false;
+    }
 
-      // frame found.
-      if (logTime < _time)
-        break;
+    auto messageXml = doc.FirstChildElement("message");
+    LogMessage msg;
+    if (messageXml->Attribute("topic"))
+      msg.topic = messageXml->Attribute("topic");
+    if (messageXml->Attribute("type"))
+      msg.type = messageXml->Attribute("type");
+    if (messageXml->Attribute("sim_time"))
+    {
+      std::istringstream stream(messageXml->Attribute("sim_time"));
+      stream >> msg.simTime;
     }
+    if (messageXml->GetText())
+      msg.data = Base64Decode(messageXml->GetText());
+    _messages.push_back(msg);
+
+    from = chunk.find(kStartMessage, to);
   }
 
   return true;
 }
 
 /////////////////////////////////////////////////
-bool LogPlay::Chunk(unsigned int _index, std::string &_data) const
+bool LogPlayPrivate::ChunkData(const unsigned int _index, std::string &_data)
 {
-  unsigned int count = 0;
-  this->dataPtr->logCurrXml =
-    this->dataPtr->logStartXml->FirstChildElement("chunk");
+  if (_index >= this->chunks.size())
+  {
+    gzerr << "Invalid chunk index[" << _index << "]" << std::endl;
+    return false;
+  }
+
+  // Get the chunk's encoding
+  this->encoding = this->chunks[_index].encoding;
 
-  while (this->dataPtr->logCurrXml && count < _index)
   {
-    count++;
-    this->dataPtr->logCurrXml =
-      this->dataPtr->logCurrXml->NextSiblingElement("chunk");
+    std::lock_guard<std::mutex> lock(this->decodedChunksMutex);
+    for (auto iter = this->decodedChunks.begin();
+         iter != this->decodedChunks.end(); ++iter)
+    {
+      if (iter->first == _index)
+      {
+        this->decodedChunks.splice(this->decodedChunks.begin(),
+            this->decodedChunks, iter);
+        _data = *iter->second;
+        return true;
+      }
+    }
   }
 
-  if (this->dataPtr->logCurrXml && count == _index)
-    return this->dataPtr->ChunkData(this->dataPtr->logCurrXml, _data);
-  else
+  auto data = std::make_shared<std::string>();
+  if (!this->DecodeChunk(_index, *data))
     return false;
+
+  {
+    std::lock_guard<std::mutex> lock(this->decodedChunksMutex);
+    this->decodedChunks.emplace_front(_index, data);
+    *this->memory += static_cast<int64_t>(data->size());
+    if (this->decodedChunks.size() > this->kDecodedChunks)
+    {
+      *this->memory -= static_cast<int64_t>(
+          this->decodedChunks.back().second->size());
+      this->decodedChunks.pop_back();
+    }
+  }
+
+  _data = *data;
+  return true;
 }
 
 /////////////////////////////////////////////////
-bool LogPlayPrivate::ChunkData(
-    tinyxml2::XMLElement *_xml,
-    std::string &_data)
+void LogPlayPrivate::EvictChunks(const uint64_t _bytes)
 {
-  // Make sure we have valid xml pointer
-  if (!_xml)
+  std::lock_guard<std::mutex> lock(this->decodedChunksMutex);
+  uint64_t freed = 0;
+  while (!this->decodedChunks.empty() && freed < _bytes)
   {
-    gzerr << "NULL XML element" << std::endl;
-    return false;
+    freed += this->decodedChunks.back().second->size();
+    this->decodedChunks.pop_back();
   }
+  *this->memory -= static_cast<int64_t>(freed);
+}
 
-  /// Get the chunk's encoding
-  this->encoding = _xml->Attribute("encoding");
+/////////////////////////////////////////////////
+void LogPlayPrivate::ClearChunks()
+{
+  this->EvictChunks(std::numeric_limits<uint64_t>::max());
+}
+
+/////////////////////////////////////////////////
+bool LogPlayPrivate::DecodeChunk(const unsigned int _index,
+    std::string &_data)
+{
+  const LogChunk &chunk = this->chunks[_index];
 
   // Make sure there is an encoding value.
-  if (this->encoding.empty())
+  if (chunk.encoding.empty())
   {
     gzthrow("Encoding missing for a chunk in log file[" + this->filename + "]");
   }
 
-  if (this->encoding == "txt")
-    _data = _xml->GetText();
-  else if (this->encoding == "bz2")
+  std::string data;
+  if (chunk.xml)
   {
-    std::string data = _xml->GetText();
-    std::string buffer;
+    const char *text = chunk.xml->GetText();
+    if (text)
+      data = text;
+  }
+  else
+  {
+    data.assign(this->mappedFile.data() + chunk.offset, chunk.size);
+  }
+
+  if (chunk.encoding == "txt")
+  {
+    _data.swap(data);
+    return true;
+  }
 
-    // Decode the base64 string
+  // Decode the base64 string
+  std::string buffer;
+  if (chunk.binary)
+    buffer.swap(data);
+  else
     buffer = Base64Decode(data);
 
-    // Decompress the bz2 data
-    {
-      boost::iostreams::filtering_istream in;
+  if (chunk.encoding == "bz2" || chunk.encoding == "zlib")
+  {
+    // Decompress the bz2 or zlib data
+    boost::iostreams::filtering_istream in;
+    if (chunk.encoding == "bz2")
       in.push(boost::iostreams::bzip2_decompressor());
-      in.push(boost::make_iterator_range(buffer));
+    else
+      in.push(boost::iostreams::zlib_decompressor());
+    in.push(boost::make_iterator_range(buffer));
 
-      // Get the data
-      std::getline(in, _data, '\0');
-      _data += '\0';
-    }
+    // Get the data
+    std::getline(in, _data, '\0');
   }
-  else if (this->encoding == "zlib")
+#ifdef HAVE_ZSTD
+  else if (chunk.encoding == "zstd")
   {
-    std::string data = _xml->GetText();
-    std::string buffer;
+    auto size = ZSTD_getFrameContentSize(buffer.data(), buffer.size());
+    if (size == ZSTD_CONTENTSIZE_ERROR || size == ZSTD_CONTENTSIZE_UNKNOWN)
+    {
+      gzerr << "Invalid zstd chunk in log file[" << this->filename << "]\n";
+      return false;
+    }
 
-    // Decode the base64 string
-    buffer = Base64Decode(data);
+    _data.resize(size);
+    size = ZSTD_decompress(&_data[0], _data.size(), buffer.data(),
+        buffer.size());
+    if (ZSTD_isError(size))
+    {
+      gzerr << "Unable to decompress a zstd chunk in log file["
+            << this->filename << "]: " << ZSTD_getErrorName(size) << "\n";
+      return false;
+    }
+    _data.resize(size);
+  }
+#endif
+#ifdef HAVE_LZ4
+  else if (chunk.encoding == "lz4")
+  {
+    LZ4F_dctx *context = nullptr;
+    if (LZ4F_isError(LZ4F_createDecompressionContext(&context, LZ4F_VERSION)))
+      return false;
 
-    // Decompress the zlib data
+    _data.clear();
+    char out[65536];
+    const char *in = buffer.data();
+    size_t left = buffer.size();
+    size_t hint = 1;
+    while (hint != 0)
     {
-      boost::iostreams::filtering_istream in;
-      in.push(boost::iostreams::zlib_decompressor());
-      in.push(boost::make_iterator_range(buffer));
+      size_t outSize = sizeof(out);
+      size_t inSize = left;
+      hint = LZ4F_decompress(context, out, &outSize, in, &inSize, nullptr);
+      if (LZ4F_isError(hint) || (inSize == 0 && outSize == 0))
+        break;
+      _data.append(out, outSize);
+      in += inSize;
+      left -= inSize;
+    }
+    LZ4F_freeDecompressionContext(context);
 
-      // Get the data
-      std::getline(in, _data, '\0');
-      _data += '\0';
+    if (hint != 0)
+    {
+      gzerr << "Unable to decompress an lz4 chunk in log file["
+            << this->filename << "]\n";
+      return false;
     }
   }
+#endif
   else
   {
-    gzerr << "Invalid encoding[" << this->encoding << "] in log file["
+    gzerr << "Invalid encoding[" << chunk.encoding << "] in log file["
       << this->filename << "]\n";
     return false;
   }
 
+  // Like the boost decompressors, which stop at the first null character
+  _data += '\0';
+
   return true;
 }
 
 /////////////////////////////////////////////////
-std::string LogPlay::Encoding() const
+/// \brief Find a string in a range of characters.
+/// \param[in] _begin Start of the range.
+/// \param[in] _end End of the range.
+/// \param[in] _str String to find.
+/// \return Position of the string, nullptr if it's not in the range.
+static const char *FindIn(const char *_begin, const char *_end,
+    const std::string &_str)
 {
-  return this->dataPtr->encoding;
+  while (_begin && static_cast<size_t>(_end - _begin) >= _str.size())
+  {
+    _begin = static_cast<const char *>(
+        memchr(_begin, _str[0], _end - _begin - _str.size() + 1));
+    if (!_begin)
+      return nullptr;
+    if (memcmp(_begin, _str.c_str(), _str.size()) == 0)
+      return _begin;
+    ++_begin;
+  }
+  return nullptr;
 }
 
 /////////////////////////////////////////////////
-unsigned int LogPlay::ChunkCount() const
+/// \brief Check if a range of characters is only white space.
+/// \param[in] _begin Start of the range.
+/// \param[in] _end End of the range.
+/// \return True if the range is empty or white space.
+static bool IsSpace(const char *_begin, const char *_end)
 {
-  unsigned int count = 0;
-  auto xml = this->dataPtr->logStartXml->FirstChildElement("chunk");
+  return std::all_of(_begin, _end,
+      [](const char _c) {return isspace(static_cast<unsigned char>(_c));});
+}
 
-  while (xml)
+/////////////////////////////////////////////////
+bool LogPlayPrivate::MapLog()
+{
+  const std::string kChunk = "<chunk";
+  const std::string kChunkEnd = "</chunk>";
+  const std::string kCData = "<![CDATA[";
+  const std::string kCDataEnd = "]]>";
+  const std::string kIndex = "<index>";
+  const std::string kIndexEnd = "</index>";
+  const std::string kLogEnd = "</gazebo_log>";
+
+  try
   {
-    count++;
-    xml = xml->NextSiblingElement("chunk");
+    this->mappedFile.open(this->filename);
   }
+  catch(std::exception &)
+  {
+    return false;
+  }
+  if (!this->mappedFile.is_open())
+    return false;
+
+  const char *begin = this->mappedFile.data();
+  const char *end = begin + this->mappedFile.size();
 
-  return count;
+  // The root element follows the XML declaration.
+  const char *root = FindIn(begin,
+      begin + std::min<size_t>(this->mappedFile.size(), 1024),
+      "<gazebo_log>");
+  const char *header = FindIn(root, end, "<header>");
+  const char *headerEnd = FindIn(header, end, "</header>");
+  if (!headerEnd)
+  {
+    this->mappedFile.close();
+    return false;
+  }
+  headerEnd += std::string("</header>").size();
+
+  // The header and index are small, parse them with the rest of the class.
+  std::string xml = "<gazebo_log>" + std::string(header, headerEnd);
+  std::vector<LogChunk> found;
+
+  const char *pos = headerEnd;
+  bool valid = true;
+  while (valid)
+  {
+    const char *tag = FindIn(pos, end, "<");
+    if (!tag || (!IsSpace(pos, tag)))
+    {
+      valid = tag == nullptr && IsSpace(pos, end);
+      break;
+    }
+
+    const size_t left = end - tag;
+    if (left > kChunk.size() && memcmp(tag, kChunk.c_str(), kChunk.size()) == 0
+        && (tag[kChunk.size()] == ' ' || tag[kChunk.size()] == '>'))
+    {
+      const char *tagEnd = FindIn(tag, end, ">");
+      if (!tagEnd)
+      {
+        valid = false;
+        break;
+      }
+
+      // Value of an attribute of the chunk's tag, empty if it's missing.
+      auto attribute = [tag, tagEnd](const std::string &_name)
+      {
+        const std::string key = " " + _name + "=";
+        const char *attr = FindIn(tag, tagEnd, key);
+        if (!attr || attr + key.size() >= tagEnd)
+          return std::string();
+        const char quote = attr[key.size()];
+        const char *value = attr + key.size() + 1;
+        const char *valueEnd = FindIn(value, tagEnd, std::string(1, quote));
+        return valueEnd ? std::string(value, valueEnd) : std::string();
+      };
+
+      LogChunk chunk;
+      chunk.encoding = attribute("encoding");
+
+      const char *chunkEnd = nullptr;
+      const std::string size = attribute("size");
+      if (!size.empty())
+      {
+        // The chunk's data is raw bytes.
+        chunk.binary = true;
+        chunk.offset = tagEnd + 1 - begin;
+        chunk.size = std::strtoull(size.c_str(), nullptr, 10);
+        const char *dataEnd = nullptr;
+        if (chunk.size < static_cast<size_t>(end - tagEnd - 1))
+        {
+          dataEnd = tagEnd + 1 + chunk.size;
+          chunkEnd = FindIn(dataEnd, end, kChunkEnd);
+        }
+
+        // Only this reader can play binary chunks, so a recording that
+        // didn't stop cleanly is played up to its last complete chunk.
+        if (!chunkEnd)
+        {
+          gzwarn << "Log file[" << this->filename << "] ends with an "
+                 << "incomplete chunk, which is skipped.\n";
+          break;
+        }
+
+        if (!IsSpace(dataEnd, chunkEnd))
+        {
+          valid = false;
+          break;
+        }
+      }
+      else
+      {
+        // The data of a chunk is a CDATA section.
+        const char *cdata = FindIn(tagEnd, end, kCData);
+        const char *cdataEnd =
+          cdata ? FindIn(cdata + kCData.size(), end, kCDataEnd) : nullptr;
+        chunkEnd = cdataEnd ?
+          FindIn(cdataEnd + kCDataEnd.size(), end, kChunkEnd) : nullptr;
+        if (!chunkEnd || !IsSpace(tagEnd + 1, cdata) ||
+            !IsSpace(cdataEnd + kCDataEnd.size(), chunkEnd))
+        {
+          valid = false;
+          break;
+        }
+
+        chunk.offset = cdata + kCData.size() - begin;
+        chunk.size = cdataEnd - (cdata + kCData.size());
+      }
+
+      found.push_back(chunk);
+      pos = chunkEnd + kChunkEnd.size();
+    }
+    else if (left >= kIndex.size() &&
+             memcmp(tag, kIndex.c_str(), kIndex.size()) == 0)
+    {
+      const char *indexEnd = FindIn(tag, end, kIndexEnd);
+      if (!indexEnd)
+      {
+        valid = false;
+        break;
+      }
+      pos = indexEnd + kIndexEnd.size();
+      xml.append(tag, pos);
+    }
+    else
+    {
+      valid = left >= kLogEnd.size() &&
+        memcmp(tag, kLogEnd.c_str(), kLogEnd.size()) == 0;
+      break;
+    }
+  }
+
+  xml += "</gazebo_log>";
+  if (!valid || this->xmlDoc.Parse(xml.c_str(), xml.size()) !=
+      tinyxml2::XML_SUCCESS)
+  {
+    this->xmlDoc.Clear();
+    this->mappedFile.close();
+    return false;
+  }
+
+  this->logStartXml = this->xmlDoc.FirstChildElement("gazebo_log");
+  this->chunks.swap(found);
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool LogPlayPrivate::ReadIndex()
+{
+  this->index.clear();
+
+  auto indexXml = this->logStartXml->FirstChildElement("index");
+  if (indexXml)
+  {
+    for (auto entryXml = indexXml->FirstChildElement("entry"); entryXml;
+         entryXml = entryXml->NextSiblingElement("entry"))
+    {
+      LogChunkIndex entry;
+
+      const char *first = entryXml->Attribute("first");
+      const char *last = entryXml->Attribute("last");
+      if (first && last)
+      {
+        std::istringstream firstStream(first);
+        std::istringstream lastStream(last);
+        firstStream >> entry.first;
+        lastStream >> entry.last;
+        entry.hasTime = true;
+      }
+
+      const char *iterations = entryXml->Attribute("iterations");
+      if (iterations)
+      {
+        std::istringstream stream(iterations);
+        stream >> entry.iterations;
+        entry.hasIterations = true;
+      }
+
+      this->index.push_back(entry);
+    }
+  }
+  else if (getenv("GAZEBO_LOG_INDEX_CACHE"))
+  {
+    std::ifstream in(this->IndexCacheFilename());
+    std::string magic, stamp;
+    int version = 0;
+    if (in >> magic >> version && std::getline(in, stamp) &&
+        magic == "gazebo_log_index" && version == 1 &&
+        stamp == " " + this->IndexCacheStamp())
+    {
+      LogChunkIndex entry;
+      while (in >> entry.hasTime >> entry.first >> entry.last >>
+             entry.hasIterations >> entry.iterations)
+      {
+        this->index.push_back(entry);
+      }
+    }
+  }
+
+  if (this->index.size() != this->chunks.size())
+  {
+    if (!this->index.empty())
+    {
+      gzwarn << "Ignoring the index of log file[" << this->filename
+             << "], it doesn't match the chunks.\n";
+    }
+    this->index.clear();
+    return false;
+  }
+
+  // Chunks without times keep the order of the index.
+  common::Time last;
+  for (auto &entry : this->index)
+  {
+    if (!entry.hasTime)
+      entry.first = entry.last = last;
+    last = entry.last;
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool LogPlayPrivate::BuildIndex()
+{
+  const std::string kStartIterations = "<iterations>";
+  const std::string kEndIterations = "</iterations>";
+
+  std::vector<LogChunkIndex> entries;
+  std::string data;
+  common::Time last;
+
+  for (unsigned int i = 0; i < this->chunks.size(); ++i)
+  {
+    // Bypass the cache, which holds the chunks being played
+    if (!this->DecodeChunk(i, data))
+      return false;
+
+    LogChunkIndex entry;
+    entry.hasTime = this->FrameTime(data, 0, data.size(), entry.first) &&
+      this->FrameTime(data, data.rfind(this->kStartTime), data.size(),
+          entry.last);
+    if (!entry.hasTime)
+      entry.first = entry.last = last;
+    last = entry.last;
+
+    auto from = data.find(kStartIterations);
+    auto to = data.find(kEndIterations, from);
+    if (from != std::string::npos && to != std::string::npos)
+    {
+      from += kStartIterations.size();
+      std::istringstream stream(data.substr(from, to - from));
+      entry.hasIterations = static_cast<bool>(stream >> entry.iterations);
+    }
+
+    entries.push_back(entry);
+  }
+
+  this->index.swap(entries);
+
+  if (!getenv("GAZEBO_LOG_INDEX_CACHE"))
+    return true;
+
+  std::ofstream out(this->IndexCacheFilename());
+  out << "gazebo_log_index 1 " << this->IndexCacheStamp() << "\n";
+  for (auto const &entry : this->index)
+  {
+    out << entry.hasTime << " " << entry.first << " " << entry.last << " "
+        << entry.hasIterations << " " << entry.iterations << "\n";
+  }
+
+  if (!out)
+  {
+    gzlog << "Unable to cache the index of log file[" << this->filename
+          << "] in [" << this->IndexCacheFilename() << "]\n";
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool LogPlayPrivate::FrameTime(const std::string &_data, const size_t _from,
+    const size_t _to, common::Time &_time) const
+{
+  auto from = _data.find(this->kStartTime, _from);
+  if (from == std::string::npos || from >= _to)
+    return false;
+
+  from += this->kStartTime.size();
+  auto to = _data.find(this->kEndTime, from);
+  if (to == std::string::npos || to >= _to)
+    return false;
+
+  std::istringstream stream(_data.substr(from, to - from));
+  return static_cast<bool>(stream >> _time);
+}
+
+/////////////////////////////////////////////////
+std::string LogPlayPrivate::IndexCacheFilename() const
+{
+  return this->filename + ".idx";
+}
+
+/////////////////////////////////////////////////
+std::string LogPlayPrivate::IndexCacheStamp() const
+{
+  boost::system::error_code ec;
+  std::ostringstream stream;
+  stream << boost::filesystem::file_size(this->filename, ec) << " "
+         << boost::filesystem::last_write_time(this->filename, ec);
+  return stream.str();
+}
+
+/////////////////////////////////////////////////
+std::string LogPlay::Encoding() const
+{
+  return this->dataPtr->encoding;
+}
+
+/////////////////////////////////////////////////
+unsigned int LogPlay::ChunkCount() const
+{
+  return this->dataPtr->chunks.size();
 }
 
 /////////////////////////////////////////////////
 bool LogPlay::NextChunk()
 {
-  auto next = this->dataPtr->logCurrXml->NextSiblingElement("chunk");
-  if (!next)
+  if (this->dataPtr->logCurrChunk + 1 >= this->dataPtr->chunks.size())
     return false;
 
-  this->dataPtr->logCurrXml = next;
-  if (!this->dataPtr->ChunkData(this->dataPtr->logCurrXml,
+  ++this->dataPtr->logCurrChunk;
+  if (!this->dataPtr->ChunkData(this->dataPtr->logCurrChunk,
                                 this->dataPtr->currentChunk))
   {
     return false;
@@ -822,12 +1504,11 @@ bool LogPlay::NextChunk()
 /////////////////////////////////////////////////
 bool LogPlay::PrevChunk()
 {
-  auto prev = this->dataPtr->logCurrXml->PreviousSiblingElement("chunk");
-  if (!prev)
+  if (this->dataPtr->logCurrChunk == 0 || this->dataPtr->chunks.empty())
     return false;
 
-  this->dataPtr->logCurrXml = prev;
-  if (!this->dataPtr->ChunkData(this->dataPtr->logCurrXml,
+  --this->dataPtr->logCurrChunk;
+  if (!this->dataPtr->ChunkData(this->dataPtr->logCurrChunk,
                                 this->dataPtr->currentChunk))
   {
     return false;
@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "gazebo/common/SingletonT.hh"
 #include "gazebo/common/Time.hh"
@@ -37,6 +38,24 @@ namespace gazebo
     /// \addtogroup gazebo_physics
     /// \{
 
+    /// \brief A topic message recorded in a log file.
+    /// \sa LogRecordParams::topics
+    class GZ_UTIL_VISIBLE LogMessage
+    {
+      /// \brief Name of the topic.
+      public: std::string topic;
+
+      /// \brief Message type, such as "gazebo.msgs.ImageStamped". Empty if
+      /// it wasn't known when the message was recorded.
+      public: std::string type;
+
+      /// \brief Simulation time at which the message was received.
+      public: common::Time simTime;
+
+      /// \brief The serialized message.
+      public: std::string data;
+    };
+
     /// \class Logplay Logplay.hh util/util.hh
     /// \brief Open and playback log files that were recorded using LogRecord.
     ///
@@ -46,6 +65,25 @@ namespace gazebo
     /// World using the Play functions. Replay involves reading and applying
     /// state information to a World.
     ///
+    /// The log file is memory mapped and its chunks are decompressed as
+    /// they're played, keeping the few most recent ones, so memory use
+    /// doesn't grow with the length of the log. Files that don't have the
+    /// layout LogRecord writes, such as chunks without a CDATA section, are
+    /// parsed in full instead.
+    ///
+    /// Seek uses the index that LogRecord writes at the end of a log file
+    /// to decompress a single chunk. Logs recorded without an index are
+    /// decompressed once, on the first Seek, to build it. The last few
+    /// decoded chunks are kept, and count against the "log" budget of the
+    /// common::MemoryTracker, over which the least recently used ones are
+    /// dropped.
+    ///
+    /// \remarks
+    ///  Environment Variables:
+    ///   - GAZEBO_LOG_INDEX_CACHE: If set, the index built for a log file
+    /// without one is cached next to it, in a file named after the log
+    /// followed by ".idx", and read back the next time the log is opened.
+    ///
     /// \sa LogRecord, State
     class GZ_UTIL_VISIBLE LogPlay : public SingletonT<LogPlay>
     {
@@ -130,6 +168,39 @@ namespace gazebo
       /// \return True If the function succeed or false otherwise.
       public: bool Forward();
 
+      /// \brief Get the frames that rebuild the models and lights of the
+      /// world just before a time, without moving the current frame. These
+      /// are the last keyframe before the time, or the log's first frame
+      /// with the world's SDF, followed by the frames after it that insert
+      /// or delete entities.
+      /// \param[in] _time Target simulation time.
+      /// \param[out] _frames The frames, in log order.
+      /// \return True if a keyframe was found.
+      /// \sa KeyframePeriod
+      public: bool Keyframe(const common::Time &_time,
+                  std::vector<std::string> &_frames);
+
+      /// \brief Get the simulation time between the keyframes of the open
+      /// log file.
+      /// \return Keyframe period in seconds, 0 if the log has no
+      /// keyframes.
+      /// \sa LogRecordParams::keyframePeriod
+      public: double KeyframePeriod() const;
+
+      /// \brief Get the simulation time between the states that are played.
+      /// \return Play period in seconds, 0 if every state is played.
+      /// \sa SetPlayPeriod
+      public: double PlayPeriod() const;
+
+      /// \brief Set the simulation time between the states that are played.
+      /// While playing, the states within the period of the last one played
+      /// are skipped, unless they insert or delete entities: they aren't
+      /// applied to the world, rendered or seen by sensors. Together with a
+      /// real time factor of 0 or more than 1, this plays a log faster than
+      /// real time. It is kept when another log file is opened.
+      /// \param[in] _period Play period in seconds, 0 to play every state.
+      public: void SetPlayPeriod(const double _period);
+
       /// \brief Get the number of chunks (steps) in the open log file.
       /// \return The number of recorded states in the log file.
       public: unsigned int ChunkCount() const;
@@ -140,6 +211,24 @@ namespace gazebo
       /// \return True if the _index was valid.
       public: bool Chunk(const unsigned int _index, std::string &_data) const;
 
+      /// \brief Get the frames of a chunk, without moving the current frame
+      /// or using the cache of decoded chunks. Unlike Chunk, this can be
+      /// called from several threads at once.
+      /// \param[in] _index Index of the chunk.
+      /// \param[out] _frames The <sdf> frames of the chunk, in log order.
+      /// \return True if the _index was valid and the chunk was decoded.
+      public: bool ChunkFrames(const unsigned int _index,
+                  std::vector<std::string> &_frames) const;
+
+      /// \brief Get the topic messages recorded in a chunk, without moving
+      /// the current frame or using the cache of decoded chunks.
+      /// \param[in] _index Index of the chunk.
+      /// \param[out] _messages The messages of the chunk, ordered by
+      /// simulation time.
+      /// \return True if the _index was valid and the chunk was decoded.
+      public: bool ChunkMessages(const unsigned int _index,
+                  std::vector<LogMessage> &_messages) const;
+
       /// \brief Get the type of encoding used for current chunck in the
       /// open log file.
       /// \return The type of encoding. An empty string will be returned if
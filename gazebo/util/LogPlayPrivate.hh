@@ -25,8 +25,14 @@
 #include <tinyxml2.h>
 #endif
 
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <atomic>
+#include <list>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "gazebo/common/Time.hh"
 #include "gazebo/util/system.hh"
@@ -35,17 +41,105 @@ namespace gazebo
 {
   namespace util
   {
+    /// \internal
+    /// \brief Index entry of a chunk of a log file.
+    class LogChunkIndex
+    {
+      /// \brief Simulation time of the first frame of the chunk.
+      public: common::Time first;
+
+      /// \brief Simulation time of the last frame of the chunk.
+      public: common::Time last;
+
+      /// \brief Iterations of the first frame of the chunk.
+      public: uint64_t iterations = 0;
+
+      /// \brief True if the chunk has a frame with a simulation time.
+      /// Otherwise first and last are the last time of the previous chunk.
+      public: bool hasTime = false;
+
+      /// \brief True if iterations was found in the chunk.
+      public: bool hasIterations = false;
+    };
+
+    /// \internal
+    /// \brief Location of a chunk of a log file.
+    class LogChunk
+    {
+      /// \brief Element of the chunk, if the whole log file was parsed.
+      /// Otherwise the chunk's data is in the mapped file.
+      public: tinyxml2::XMLElement *xml = nullptr;
+
+      /// \brief Offset of the chunk's data in the mapped file.
+      public: size_t offset = 0;
+
+      /// \brief Size of the chunk's data in the mapped file.
+      public: size_t size = 0;
+
+      /// \brief Encoding of the chunk.
+      public: std::string encoding;
+
+      /// \brief True if the chunk's data is raw bytes rather than Base64.
+      public: bool binary = false;
+    };
+
     /// \internal
     /// \brief Private data for log play
     class LogPlayPrivate
     {
-      /// \brief Helper function to get chunk data from XML.
-      /// \param[in] _xml Pointer to an xml block that has state data.
+      /// \brief Helper function to get the decoded data of a chunk, from
+      /// the cache of recently decoded chunks if it's there.
+      /// \param[in] _index Index of the chunk.
       /// \param[out] _data Storage for the chunk's data.
-      /// \return True if the chunk was successfully parsed.
-      public: bool ChunkData(
-                  tinyxml2::XMLElement *_xml,
-                  std::string &_data);
+      /// \return True if the chunk was successfully decoded.
+      public: bool ChunkData(const unsigned int _index, std::string &_data);
+
+      /// \brief Decode a chunk.
+      /// \param[in] _index Index of the chunk, which must be valid.
+      /// \param[out] _data Storage for the chunk's data.
+      /// \return True if the chunk was successfully decoded.
+      public: bool DecodeChunk(const unsigned int _index, std::string &_data);
+
+      /// \brief Drop the least recently used decoded chunks.
+      /// \param[in] _bytes Number of bytes to free.
+      public: void EvictChunks(const uint64_t _bytes);
+
+      /// \brief Drop every decoded chunk.
+      public: void ClearChunks();
+
+      /// \brief Map the log file, and find its chunks without parsing them.
+      /// Only the header and index are parsed, into xmlDoc.
+      /// \return False if the file couldn't be mapped, or doesn't have the
+      /// layout LogRecord writes. The caller then parses the whole file.
+      public: bool MapLog();
+
+      /// \brief Read the <index> element that LogRecord writes after the
+      /// chunks, or the index cached next to the log file.
+      /// \return True if an index matching the chunks was found.
+      public: bool ReadIndex();
+
+      /// \brief Build the index by decompressing every chunk, and cache it
+      /// next to the log file if GAZEBO_LOG_INDEX_CACHE is set.
+      /// \return True if every chunk could be decompressed.
+      public: bool BuildIndex();
+
+      /// \brief Get the simulation time of a frame.
+      /// \param[in] _data Data of a chunk.
+      /// \param[in] _from Start of the frame in _data.
+      /// \param[in] _to End of the frame in _data.
+      /// \param[out] _time Simulation time of the frame.
+      /// \return False if the frame has no simulation time.
+      public: bool FrameTime(const std::string &_data, const size_t _from,
+                  const size_t _to, common::Time &_time) const;
+
+      /// \brief Name of the file the index of the log file is cached in.
+      /// \return The log file's name followed by ".idx".
+      public: std::string IndexCacheFilename() const;
+
+      /// \brief Size and modification time of the log file, which identify
+      /// the log an index was cached for.
+      /// \return The size and modification time, separated by a space.
+      public: std::string IndexCacheStamp() const;
 
       /// \brief Max number of chunks to inspect when looking for XML elements.
       public: const unsigned int kNumChunksToTry = 2u;
@@ -62,14 +156,51 @@ namespace gazebo
       /// \brief XML tag delimiting the end of a simulation time element.
       public: const std::string kEndTime = "</sim_time>";
 
-      /// \brief The XML document of the log file.
+      /// \brief XML tag delimiting the beginning of a keyframe's entities.
+      public: const std::string kStartKeyframe = "<keyframe>";
+
+      /// \brief XML tag of the entities inserted by a frame.
+      public: const std::string kInsertions = "<insertions>";
+
+      /// \brief XML tag of the entities deleted by a frame.
+      public: const std::string kDeletions = "<deletions>";
+
+      /// \brief Number of decoded chunks kept in decodedChunks.
+      public: const size_t kDecodedChunks = 4u;
+
+      /// \brief The XML document of the log file's header and index, or of
+      /// the whole log file if it couldn't be mapped.
       public: tinyxml2::XMLDocument xmlDoc;
 
+      /// \brief The mapped log file.
+      public: boost::iostreams::mapped_file_source mappedFile;
+
       /// \brief Start of the log.
       public: tinyxml2::XMLElement *logStartXml = nullptr;
 
-      /// \brief Current position in the log file.
-      public: tinyxml2::XMLElement *logCurrXml = nullptr;
+      /// \brief Index of the current chunk.
+      public: size_t logCurrChunk = 0;
+
+      /// \brief The chunks of the log file, in order.
+      public: std::vector<LogChunk> chunks;
+
+      /// \brief Recently decoded chunks and their index, most recently
+      /// used first.
+      public: std::list<std::pair<unsigned int,
+              std::shared_ptr<const std::string>>> decodedChunks;
+
+      /// \brief Protects decodedChunks, which the evictor changes.
+      public: std::mutex decodedChunksMutex;
+
+      /// \brief Bytes of the decoded chunks, in the "log" subsystem of the
+      /// common::MemoryTracker.
+      public: std::atomic<int64_t> *memory = nullptr;
+
+      /// \brief Id of the evictor of the decoded chunks.
+      public: int evictor = -1;
+
+      /// \brief Index entry of each chunk, empty until it's read or built.
+      public: std::vector<LogChunkIndex> index;
 
       /// \brief Name of the log file.
       public: std::string filename;
@@ -84,6 +215,14 @@ namespace gazebo
       /// \brief The random number seed recorded in the open log file.
       public: uint32_t randSeed = 0;
 
+      /// \brief Simulation time between keyframes recorded in the open log
+      /// file, 0 if it has none.
+      public: double keyframePeriod = 0;
+
+      /// \brief Simulation time between the states that are played, 0 to
+      /// play all of them.
+      public: double playPeriod = 0;
+
       /// \brief Log start time (simulation time).
       public: common::Time logStartTime;
 
@@ -19,6 +19,8 @@
 #include <boost/filesystem.hpp>
 #include <string>
 #include <thread>
+#include <vector>
+#include "gazebo/common/Base64.hh"
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Time.hh"
 #include "gazebo/util/LogPlay.hh"
@@ -112,6 +114,15 @@ TEST_F(LogPlay_TEST, Accessors)
   EXPECT_NO_THROW(player->Open(logFilePath.string()));
   EXPECT_TRUE(player->HasIterations());
   EXPECT_EQ(player->InitialIterations(), 23700u);
+
+  // The play period isn't part of the log file
+  EXPECT_DOUBLE_EQ(player->PlayPeriod(), 0.0);
+  player->SetPlayPeriod(0.5);
+  EXPECT_DOUBLE_EQ(player->PlayPeriod(), 0.5);
+  EXPECT_NO_THROW(player->Open(logFilePath.string()));
+  EXPECT_DOUBLE_EQ(player->PlayPeriod(), 0.5);
+  player->SetPlayPeriod(-1);
+  EXPECT_DOUBLE_EQ(player->PlayPeriod(), 0.0);
 }
 
 /////////////////////////////////////////////////
@@ -146,6 +157,36 @@ TEST_F(LogPlay_TEST, Chunks)
   EXPECT_FALSE(player->Chunk(player->ChunkCount(), chunk));
 }
 
+/////////////////////////////////////////////////
+/// \brief Test that the frames of each chunk are the frames Step returns.
+TEST_F(LogPlay_TEST, ChunkFrames)
+{
+  gazebo::util::LogPlay *player = gazebo::util::LogPlay::Instance();
+
+  boost::filesystem::path logFilePath(TEST_PATH);
+  logFilePath /= boost::filesystem::path("logs");
+  logFilePath /= boost::filesystem::path("state.log");
+
+  EXPECT_NO_THROW(player->Open(logFilePath.string()));
+
+  std::vector<std::string> frames;
+  for (unsigned int i = 0; i < player->ChunkCount(); ++i)
+  {
+    EXPECT_TRUE(player->ChunkFrames(i, frames));
+    for (auto const &frame : frames)
+    {
+      std::string data;
+      EXPECT_TRUE(player->Step(data));
+      EXPECT_EQ(data, frame);
+    }
+  }
+
+  std::string data;
+  EXPECT_FALSE(player->Step(data));
+  EXPECT_FALSE(player->ChunkFrames(player->ChunkCount(), frames));
+  EXPECT_TRUE(frames.empty());
+}
+
 /////////////////////////////////////////////////
 /// \brief Test Rewind().
 TEST_F(LogPlay_TEST, Rewind)
@@ -457,6 +498,245 @@ TEST_F(LogPlay_TEST, NoEndTag)
 #endif
 }
 
+/////////////////////////////////////////////////
+/// \brief Test seeking with an index cached next to a log file that was
+/// recorded without one.
+TEST_F(LogPlay_TEST, IndexCache)
+{
+  // \todo Make temporary files work in windows.
+#ifndef _WIN32
+  gazebo::util::LogPlay *player = gazebo::util::LogPlay::Instance();
+
+  std::ifstream srcFile(std::string(TEST_PATH) + "/logs/state.log",
+      std::ios::binary);
+  ASSERT_TRUE(srcFile.good());
+
+  // Copy the log to a temporary file, the cache is written next to it.
+  std::ostringstream stream;
+  stream << "/tmp/__gz_log_index_test" << std::this_thread::get_id();
+  std::string tmpFilename = stream.str();
+  std::string cacheFilename = tmpFilename + ".idx";
+  std::ofstream destFile(tmpFilename, std::ios::binary);
+  ASSERT_TRUE(destFile.good());
+  destFile << srcFile.rdbuf();
+  destFile.close();
+  std::remove(cacheFilename.c_str());
+
+  setenv("GAZEBO_LOG_INDEX_CACHE", "1", 1);
+
+  std::string expectedShashum1 = "a2af44bc561194dfeae9526c224d56bb332a4233";
+  std::string expectedShashum2 = "113748a3c02575f514b27bc5b4307f621644ad41";
+
+  // The first seek builds the index and caches it.
+  std::string frame;
+  EXPECT_NO_THROW(player->Open(tmpFilename));
+  EXPECT_TRUE(player->Seek(common::Time(30.0)));
+  EXPECT_TRUE(player->Step(frame));
+  EXPECT_EQ(gazebo::common::get_sha1<std::string>(frame), expectedShashum1);
+  EXPECT_TRUE(boost::filesystem::exists(cacheFilename));
+
+  // Reopening uses the cached index.
+  EXPECT_NO_THROW(player->Open(tmpFilename));
+  EXPECT_EQ(player->LogStartTime(), gazebo::common::Time(28, 457000000));
+  EXPECT_EQ(player->LogEndTime(), gazebo::common::Time(31, 745000000));
+  EXPECT_TRUE(player->Seek(common::Time(31.5)));
+  EXPECT_TRUE(player->Step(frame));
+  EXPECT_EQ(gazebo::common::get_sha1<std::string>(frame), expectedShashum2);
+  EXPECT_TRUE(player->Seek(common::Time(30.0)));
+  EXPECT_TRUE(player->Step(frame));
+  EXPECT_EQ(gazebo::common::get_sha1<std::string>(frame), expectedShashum1);
+
+  unsetenv("GAZEBO_LOG_INDEX_CACHE");
+  std::remove(tmpFilename.c_str());
+  std::remove(cacheFilename.c_str());
+#endif
+}
+
+/////////////////////////////////////////////////
+/// \brief Test reading a log file whose chunks aren't CDATA sections, which
+/// is parsed in full rather than mapped.
+TEST_F(LogPlay_TEST, EscapedChunks)
+{
+  // \todo Make temporary files work in windows.
+#ifndef _WIN32
+  gazebo::util::LogPlay *player = gazebo::util::LogPlay::Instance();
+
+  std::ostringstream stream;
+  stream << "/tmp/__gz_log_escaped_test" << std::this_thread::get_id();
+  std::string tmpFilename = stream.str();
+
+  std::ofstream destFile(tmpFilename, std::ios::binary);
+  ASSERT_TRUE(destFile.good());
+  destFile << "<?xml version='1.0'?>\n<gazebo_log>\n<header>\n"
+    << "<log_version>1.0</log_version>\n"
+    << "<gazebo_version>6.0.0</gazebo_version>\n"
+    << "<rand_seed>1</rand_seed>\n</header>\n"
+    << "<chunk encoding='txt'>&lt;sdf version='1.6'&gt;&lt;state&gt;"
+    << "&lt;sim_time&gt;1 0&lt;/sim_time&gt;&lt;/state&gt;&lt;/sdf&gt;"
+    << "</chunk>\n</gazebo_log>\n";
+  destFile.close();
+
+  EXPECT_NO_THROW(player->Open(tmpFilename));
+  EXPECT_EQ(player->ChunkCount(), 1u);
+  EXPECT_EQ(player->LogStartTime(), gazebo::common::Time(1, 0));
+
+  std::string frame;
+  EXPECT_TRUE(player->Step(frame));
+  EXPECT_EQ(frame, "<sdf version='1.6'><state><sim_time>1 0</sim_time>"
+      "</state></sdf>");
+
+  std::remove(tmpFilename.c_str());
+#endif
+}
+
+/////////////////////////////////////////////////
+/// \brief Test LogPlay Keyframe.
+TEST_F(LogPlay_TEST, Keyframe)
+{
+  // \todo Make temporary files work in windows.
+#ifndef _WIN32
+  gazebo::util::LogPlay *player = gazebo::util::LogPlay::Instance();
+
+  std::ostringstream stream;
+  stream << "/tmp/__gz_log_keyframe_test" << std::this_thread::get_id();
+  std::string tmpFilename = stream.str();
+
+  auto frame = [](const int _sec, const std::string &_data)
+  {
+    return "<sdf version='1.6'><state world='default'><sim_time>" +
+      std::to_string(_sec) + " 0</sim_time>" + _data + "</state></sdf>";
+  };
+  const std::string world =
+    "<sdf version='1.6'><world name='default'><model name='a'/></world></sdf>";
+  const std::string inserted =
+    frame(1, "<insertions><model name='b'/></insertions>");
+  const std::string keyframe =
+    "<sdf version='1.6'><state world='default'><sim_time>2 0</sim_time>"
+    "</state><keyframe><model name='a'/><model name='b'/></keyframe></sdf>";
+  const std::string deleted = frame(4, "<deletions><name>a</name></deletions>");
+
+  std::ofstream destFile(tmpFilename, std::ios::binary);
+  ASSERT_TRUE(destFile.good());
+  destFile << "<?xml version='1.0'?>\n<gazebo_log>\n<header>\n"
+    << "<log_version>1.0</log_version>\n"
+    << "<gazebo_version>11.0.0</gazebo_version>\n"
+    << "<rand_seed>1</rand_seed>\n"
+    << "<keyframe_period>2</keyframe_period>\n</header>\n"
+    << "<chunk encoding='txt'><![CDATA[" << world << inserted << keyframe
+    << frame(3, "") << "]]></chunk>\n"
+    << "<chunk encoding='txt'><![CDATA[" << deleted << frame(5, "")
+    << frame(6, "") << "]]></chunk>\n</gazebo_log>\n";
+  destFile.close();
+
+  EXPECT_NO_THROW(player->Open(tmpFilename));
+  EXPECT_DOUBLE_EQ(player->KeyframePeriod(), 2.0);
+  EXPECT_NE(player->Header().find("<keyframe_period>2</keyframe_period>"),
+      std::string::npos);
+
+  // Before the first keyframe, the world's SDF is used
+  std::vector<std::string> frames;
+  EXPECT_TRUE(player->Keyframe(gazebo::common::Time(2, 0), frames));
+  ASSERT_EQ(frames.size(), 2u);
+  EXPECT_EQ(frames[0], world);
+  EXPECT_EQ(frames[1], inserted);
+
+  EXPECT_TRUE(player->Keyframe(gazebo::common::Time(3, 0), frames));
+  ASSERT_EQ(frames.size(), 1u);
+  EXPECT_EQ(frames[0], keyframe);
+
+  // Deletions after the keyframe, in another chunk
+  EXPECT_TRUE(player->Keyframe(gazebo::common::Time(6, 0), frames));
+  ASSERT_EQ(frames.size(), 2u);
+  EXPECT_EQ(frames[0], keyframe);
+  EXPECT_EQ(frames[1], deleted);
+
+  // The current frame doesn't move
+  std::string data;
+  EXPECT_TRUE(player->Rewind());
+  EXPECT_TRUE(player->Keyframe(gazebo::common::Time(6, 0), frames));
+  EXPECT_TRUE(player->Step(data));
+  EXPECT_EQ(data, inserted);
+
+  std::remove(tmpFilename.c_str());
+#endif
+}
+
+/////////////////////////////////////////////////
+/// \brief Test that playback skips recorded topic messages, and that
+/// ChunkMessages reads them.
+TEST_F(LogPlay_TEST, ChunkMessages)
+{
+  // \todo Make temporary files work in windows.
+#ifndef _WIN32
+  gazebo::util::LogPlay *player = gazebo::util::LogPlay::Instance();
+
+  std::ostringstream stream;
+  stream << "/tmp/__gz_log_messages_test" << std::this_thread::get_id();
+  std::string tmpFilename = stream.str();
+
+  auto frame = [](const int _sec)
+  {
+    return "<sdf version='1.6'><state world='default'><sim_time>" +
+      std::to_string(_sec) + " 0</sim_time></state></sdf>";
+  };
+  auto message = [](const std::string &_topic, const std::string &_time,
+      const std::string &_data)
+  {
+    std::string encoded;
+    Base64Encode(_data.c_str(), _data.size(), encoded);
+    return "<message topic='" + _topic + "' type='gazebo.msgs.Any' "
+      "sim_time='" + _time + "'>" + encoded + "</message>\n";
+  };
+  const std::string world =
+    "<sdf version='1.6'><world name='default'></world></sdf>";
+  const std::string binary("<sdf>\0\xff</sdf>", 14);
+
+  std::ofstream destFile(tmpFilename, std::ios::binary);
+  ASSERT_TRUE(destFile.good());
+  destFile << "<?xml version='1.0'?>\n<gazebo_log>\n<header>\n"
+    << "<log_version>1.0</log_version>\n"
+    << "<gazebo_version>11.0.0</gazebo_version>\n"
+    << "<rand_seed>1</rand_seed>\n</header>\n"
+    << "<chunk encoding='txt'><![CDATA[" << world << frame(1) << frame(2)
+    << message("/gazebo/default/a", "1 500", "first")
+    << message("/gazebo/default/b", "2 0", binary) << "]]></chunk>\n"
+    << "<chunk encoding='txt'><![CDATA[" << frame(3) << "]]></chunk>\n"
+    << "</gazebo_log>\n";
+  destFile.close();
+
+  EXPECT_NO_THROW(player->Open(tmpFilename));
+
+  std::vector<gazebo::util::LogMessage> messages;
+  EXPECT_TRUE(player->ChunkMessages(0, messages));
+  ASSERT_EQ(messages.size(), 2u);
+  EXPECT_EQ(messages[0].topic, "/gazebo/default/a");
+  EXPECT_EQ(messages[0].type, "gazebo.msgs.Any");
+  EXPECT_EQ(messages[0].simTime, gazebo::common::Time(1, 500));
+  EXPECT_EQ(messages[0].data, "first");
+  EXPECT_EQ(messages[1].topic, "/gazebo/default/b");
+  EXPECT_EQ(messages[1].simTime, gazebo::common::Time(2, 0));
+  EXPECT_EQ(messages[1].data, binary);
+
+  EXPECT_TRUE(player->ChunkMessages(1, messages));
+  EXPECT_TRUE(messages.empty());
+  EXPECT_FALSE(player->ChunkMessages(2, messages));
+
+  // Frames don't include the messages
+  std::string data;
+  EXPECT_TRUE(player->Step(data));
+  EXPECT_EQ(data, world);
+  EXPECT_TRUE(player->Step(data));
+  EXPECT_EQ(data, frame(1));
+  EXPECT_TRUE(player->Step(data));
+  EXPECT_EQ(data, frame(2));
+  EXPECT_TRUE(player->Step(data));
+  EXPECT_EQ(data, frame(3));
+  EXPECT_FALSE(player->Step(data));
+
+  std::remove(tmpFilename.c_str());
+#endif
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
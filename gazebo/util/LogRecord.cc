@@ -25,6 +25,7 @@
   #define access _access
 #endif
 
+#include <algorithm>
 #include <functional>
 
 #include <boost/archive/iterators/base64_from_binary.hpp>
@@ -38,6 +39,7 @@
 #include <boost/iostreams/filter/zlib.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
 #include <boost/iostreams/copy.hpp>
+#include <cstring>
 #include <iomanip>
 
 #include <ignition/math/Rand.hh>
@@ -48,9 +50,18 @@
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Events.hh"
 #include "gazebo/common/Exception.hh"
+#include "gazebo/common/MemoryTracker.hh"
 #include "gazebo/common/Time.hh"
 #include "gazebo/common/SystemPaths.hh"
 #include "gazebo/gazebo_config.h"
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#ifdef HAVE_LZ4
+#include <lz4frame.h>
+#endif
 #include "gazebo/transport/transport.hh"
 #include "gazebo/util/LogRecordPrivate.hh"
 #include "gazebo/util/LogRecord.hh"
@@ -58,10 +69,25 @@
 using namespace gazebo;
 using namespace util;
 
+/// \brief Largest number of times the recording period is doubled by
+/// LogBufferPolicy::DEGRADE_PERIOD.
+static const unsigned int kMaxDegradeLevel = 6;
+
+/// \brief Period doubled by LogBufferPolicy::DEGRADE_PERIOD when every
+/// iteration is recorded, in seconds.
+static const double kMinDegradedPeriod = 0.001;
+
+/// \brief Largest number of bytes of topic messages waiting to be logged.
+/// Messages received beyond it are dropped.
+static const std::size_t kMaxMessageBytes = 64 * 1024 * 1024;
+
 //////////////////////////////////////////////////
 LogRecord::LogRecord()
 : dataPtr(new LogRecordPrivate)
 {
+  // The tracker is created first, so it outlives the recorder
+  this->dataPtr->memory =
+      &common::MemoryTracker::Instance()->Counter("log");
   this->dataPtr->pauseState = false;
   this->dataPtr->running = false;
   this->dataPtr->paused = false;
@@ -140,6 +166,13 @@ bool LogRecord::Start(const LogRecordParams &_params)
   this->dataPtr->period = _params.period;
   this->dataPtr->filter = _params.filter;
   this->dataPtr->recordResources = _params.recordResources;
+  this->dataPtr->resourceStorePath = _params.resourceStore;
+  this->dataPtr->binaryStates = _params.binaryStates;
+  this->dataPtr->binaryChunks = _params.binaryChunks;
+  this->dataPtr->keyframePeriod = _params.keyframePeriod;
+  this->dataPtr->topics = _params.topics;
+  this->dataPtr->bufferLimit = _params.bufferLimit;
+  this->dataPtr->bufferPolicy = _params.bufferPolicy;
   return this->Start(_params.encoding, _params.path);
 }
 
@@ -186,9 +219,13 @@ bool LogRecord::Start(const std::string &_encoding, const std::string &_path)
   if (!boost::filesystem::exists(this->dataPtr->logCompletePath))
     boost::filesystem::create_directories(this->dataPtr->logCompletePath);
 
-  if (_encoding != "bz2" && _encoding != "txt" && _encoding != "zlib")
+  std::string encodingName;
+  int level;
+  if (!LogRecordPrivate::ParseEncoding(_encoding, encodingName, level))
+  {
     gzthrow("Invalid log encoding[" + _encoding +
-            "]. Must be one of [bz2, zlib, txt]");
+            "]. Must be one of [" + LogRecordPrivate::Encodings() + "]");
+  }
 
   this->dataPtr->encoding = _encoding;
 
@@ -210,6 +247,22 @@ bool LogRecord::Start(const std::string &_encoding, const std::string &_path)
 
   this->dataPtr->startTime = this->dataPtr->currTime = common::Time();
 
+  this->dataPtr->droppedChunks = 0;
+  this->dataPtr->degradeLevel = 0;
+  this->dataPtr->compressionLatency.Clear();
+  this->dataPtr->writeLatency.Clear();
+
+  // Keep the store across logs, so that files are only hashed once
+  if (this->dataPtr->resourceStorePath.empty())
+    this->dataPtr->resourceStore.reset();
+  else if (!this->dataPtr->resourceStore ||
+      this->dataPtr->resourceStore->Root() !=
+      this->dataPtr->resourceStorePath)
+  {
+    this->dataPtr->resourceStore.reset(
+        new LogResourceStore(this->dataPtr->resourceStorePath));
+  }
+
   // Create a thread to cleanup recording.
   this->dataPtr->cleanupThread.reset(new std::thread(
         std::bind(&LogRecord::Cleanup, this)));
@@ -235,6 +288,18 @@ bool LogRecord::Start(const std::string &_encoding, const std::string &_path)
     this->dataPtr->startThreadCondition.wait(writeLock);
   }
 
+  // Start the resource thread if it has not already been started
+  {
+    std::lock_guard<std::mutex> resourceLock(this->dataPtr->resourceMutex);
+    if (!this->dataPtr->resourceThread)
+    {
+      this->dataPtr->resourceThread.reset(new std::thread(
+          std::bind(&LogRecord::RunResources, this)));
+    }
+  }
+
+  this->SubscribeTopics();
+
   return true;
 }
 
@@ -252,6 +317,7 @@ void LogRecord::Fini()
   if (this->dataPtr->node)
     this->dataPtr->node->Fini();
   this->dataPtr->node.reset();
+  this->dataPtr->worldUpdateConnection.reset();
 
   {
     std::unique_lock<std::mutex> lock(this->dataPtr->controlMutex);
@@ -267,6 +333,7 @@ void LogRecord::Fini()
 
   // Remove all the logs.
   this->ClearLogs();
+  this->dataPtr->topicRecorders.clear();
 }
 
 //////////////////////////////////////////////////
@@ -285,6 +352,7 @@ void LogRecord::Stop()
 //////////////////////////////////////////////////
 void LogRecord::ClearLogs()
 {
+  std::lock_guard<std::mutex> fileLock(this->dataPtr->fileMutex);
   std::lock_guard<std::mutex> logLock(this->dataPtr->writeMutex);
 
   // Delete all the log objects
@@ -296,6 +364,7 @@ void LogRecord::ClearLogs()
 
   this->dataPtr->logs.clear();
   this->dataPtr->logsEnd = this->dataPtr->logs.end();
+  this->dataPtr->CountInFlight();
 }
 
 //////////////////////////////////////////////////
@@ -352,6 +421,205 @@ void LogRecord::SetRecordResources(const bool _record)
   this->dataPtr->recordResources = _record;
 }
 
+//////////////////////////////////////////////////
+std::string LogRecord::ResourceStore() const
+{
+  return this->dataPtr->resourceStorePath;
+}
+
+//////////////////////////////////////////////////
+void LogRecord::SetResourceStore(const std::string &_path)
+{
+  this->dataPtr->resourceStorePath = _path;
+}
+
+//////////////////////////////////////////////////
+bool LogRecord::BinaryStates() const
+{
+  return this->dataPtr->binaryStates;
+}
+
+//////////////////////////////////////////////////
+void LogRecord::SetBinaryStates(const bool _binary)
+{
+  this->dataPtr->binaryStates = _binary;
+}
+
+//////////////////////////////////////////////////
+bool LogRecord::BinaryChunks() const
+{
+  return this->dataPtr->binaryChunks;
+}
+
+//////////////////////////////////////////////////
+void LogRecord::SetBinaryChunks(const bool _binary)
+{
+  this->dataPtr->binaryChunks = _binary;
+}
+
+//////////////////////////////////////////////////
+double LogRecord::KeyframePeriod() const
+{
+  return this->dataPtr->keyframePeriod;
+}
+
+//////////////////////////////////////////////////
+void LogRecord::SetKeyframePeriod(const double _period)
+{
+  this->dataPtr->keyframePeriod = _period;
+}
+
+//////////////////////////////////////////////////
+std::size_t LogRecord::BufferLimit() const
+{
+  return this->dataPtr->bufferLimit;
+}
+
+//////////////////////////////////////////////////
+void LogRecord::SetBufferLimit(const std::size_t _limit)
+{
+  this->dataPtr->bufferLimit = _limit;
+  this->dataPtr->roomCondition.notify_all();
+}
+
+//////////////////////////////////////////////////
+LogBufferPolicy LogRecord::BufferPolicy() const
+{
+  return this->dataPtr->bufferPolicy;
+}
+
+//////////////////////////////////////////////////
+void LogRecord::SetBufferPolicy(const LogBufferPolicy _policy)
+{
+  this->dataPtr->bufferPolicy = _policy;
+  if (_policy != LogBufferPolicy::DEGRADE_PERIOD)
+    this->dataPtr->degradeLevel = 0;
+  this->dataPtr->roomCondition.notify_all();
+}
+
+//////////////////////////////////////////////////
+double LogRecord::EffectivePeriod() const
+{
+  const unsigned int level = this->dataPtr->degradeLevel;
+  if (level == 0)
+    return this->dataPtr->period;
+
+  return std::max(this->dataPtr->period, kMinDegradedPeriod) * (1u << level);
+}
+
+//////////////////////////////////////////////////
+std::size_t LogRecord::BytesInFlight() const
+{
+  return this->dataPtr->bytesInFlight;
+}
+
+//////////////////////////////////////////////////
+unsigned int LogRecord::QueueDepth() const
+{
+  return this->dataPtr->queueDepth;
+}
+
+//////////////////////////////////////////////////
+uint64_t LogRecord::DroppedChunks() const
+{
+  return this->dataPtr->droppedChunks;
+}
+
+//////////////////////////////////////////////////
+bool LogRecord::WaitForRoom(const common::Time &_timeout)
+{
+  auto hasRoom = [this]()
+  {
+    return !this->dataPtr->running || this->dataPtr->bufferLimit == 0 ||
+      this->dataPtr->bufferPolicy != LogBufferPolicy::BLOCK ||
+      this->dataPtr->bytesInFlight < this->dataPtr->bufferLimit;
+  };
+
+  if (hasRoom())
+    return true;
+
+  // Chunks compressed since the last update wait for the write thread
+  this->dataPtr->dataAvailableCondition.notify_one();
+
+  std::unique_lock<std::mutex> lock(this->dataPtr->roomMutex);
+  return this->dataPtr->roomCondition.wait_for(lock,
+      std::chrono::nanoseconds(static_cast<int64_t>(_timeout.sec) *
+        1000000000 + _timeout.nsec), hasRoom);
+}
+
+//////////////////////////////////////////////////
+void LogRecord::ApplyBufferPolicy()
+{
+  const std::size_t limit = this->dataPtr->bufferLimit;
+  if (limit == 0)
+    return;
+
+  switch (this->dataPtr->bufferPolicy)
+  {
+    case LogBufferPolicy::DROP_OLDEST:
+    {
+      if (this->dataPtr->bytesInFlight <= limit)
+        break;
+
+      // The oldest chunks of the first logs go first
+      bool dropped = true;
+      while (dropped && this->dataPtr->bytesInFlight > limit)
+      {
+        dropped = false;
+        for (auto &log : this->dataPtr->logs)
+        {
+          if (log.second->DropOldest() > 0)
+          {
+            dropped = true;
+            if (this->dataPtr->droppedChunks++ == 0)
+            {
+              gzwarn << "Log buffer is full, dropping chunks. "
+                     << "See LogRecord::DroppedChunks.\n";
+            }
+            break;
+          }
+        }
+        this->dataPtr->CountInFlight();
+      }
+      break;
+    }
+    case LogBufferPolicy::DEGRADE_PERIOD:
+    {
+      const unsigned int level = this->dataPtr->degradeLevel;
+      if (this->dataPtr->bytesInFlight > limit && level < kMaxDegradeLevel)
+      {
+        if (level == 0)
+        {
+          gzwarn << "Log buffer is full, lengthening the recording period. "
+                 << "See LogRecord::EffectivePeriod.\n";
+        }
+        this->dataPtr->degradeLevel = level + 1;
+      }
+      else if (this->dataPtr->bytesInFlight < limit / 2 && level > 0)
+      {
+        this->dataPtr->degradeLevel = level - 1;
+      }
+      break;
+    }
+    case LogBufferPolicy::BLOCK:
+    default:
+      // World waits in WaitForRoom
+      break;
+  }
+}
+
+//////////////////////////////////////////////////
+std::vector<std::string> LogRecord::Topics() const
+{
+  return this->dataPtr->topics;
+}
+
+//////////////////////////////////////////////////
+void LogRecord::SetTopics(const std::vector<std::string> &_topics)
+{
+  this->dataPtr->topics = _topics;
+}
+
 //////////////////////////////////////////////////
 void LogRecord::Add(const std::string &_name, const std::string &_filename,
                     std::function<bool (std::ostringstream &)> _logCallback)
@@ -382,7 +650,8 @@ void LogRecord::Add(const std::string &_name, const std::string &_filename,
   // Create a new log object
   try
   {
-    newLog = new LogRecordPrivate::Log(this, _filename, _logCallback);
+    newLog = new LogRecordPrivate::Log(this, this->dataPtr.get(), _filename,
+        _logCallback);
   }
   catch(...)
   {
@@ -398,22 +667,154 @@ void LogRecord::Add(const std::string &_name, const std::string &_filename,
   // Update the pointer to the end of the log objects list.
   this->dataPtr->logsEnd = this->dataPtr->logs.end();
 
-  if (!this->dataPtr->node)
+  this->InitNode();
+}
+
+//////////////////////////////////////////////////
+void LogRecord::InitNode()
+{
+  if (this->dataPtr->node)
+    return;
+
+  this->dataPtr->node = transport::NodePtr(new transport::Node());
+  this->dataPtr->node->Init();
+
+  this->dataPtr->logControlSub =
+    this->dataPtr->node->Subscribe("~/log/control",
+        &LogRecord::OnLogControl, this);
+  this->dataPtr->logStatusPub =
+    this->dataPtr->node->Advertise<msgs::LogStatus>("~/log/status");
+}
+
+//////////////////////////////////////////////////
+void LogRecord::SubscribeTopics()
+{
+  // The subscribers were reset by the previous Cleanup, which stopped
+  // their callbacks from storing messages.
+  this->dataPtr->topicRecorders.clear();
+  if (this->dataPtr->topics.empty())
+    return;
+
+  this->InitNode();
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->messageMutex);
+    this->dataPtr->messageBytes = 0;
+    this->dataPtr->messagesDropped = false;
+    this->dataPtr->simTime = common::Time();
+  }
+
+  this->dataPtr->worldUpdateConnection =
+    event::Events::ConnectWorldUpdateBegin(
+        std::bind(&LogRecord::OnWorldUpdateBegin, this,
+          std::placeholders::_1));
+
+  for (auto const &topic : this->dataPtr->topics)
+  {
+    std::unique_ptr<LogRecordPrivate::TopicRecorder> recorder(
+        new LogRecordPrivate::TopicRecorder);
+    recorder->owner = this->dataPtr.get();
+
+    // Raw callbacks get the serialized message, without parsing it
+    recorder->subscriber = this->dataPtr->node->Subscribe(topic,
+        &LogRecordPrivate::TopicRecorder::OnMessage, recorder.get());
+    recorder->topic = recorder->subscriber->GetTopic();
+    this->dataPtr->topicRecorders.push_back(std::move(recorder));
+  }
+}
+
+//////////////////////////////////////////////////
+void LogRecord::OnWorldUpdateBegin(const common::UpdateInfo &_info)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->messageMutex);
+  this->dataPtr->simTime = _info.simTime;
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::TopicRecorder::OnMessage(const std::string &_data)
+{
+  if (!this->owner->running || this->owner->paused)
+    return;
+
+  std::lock_guard<std::mutex> lock(this->owner->messageMutex);
+  if (this->owner->messageBytes + _data.size() > kMaxMessageBytes)
   {
-    this->dataPtr->node = transport::NodePtr(new transport::Node());
-    this->dataPtr->node->Init();
+    if (!this->owner->messagesDropped)
+    {
+      gzwarn << "Too many topic messages waiting to be logged, dropping "
+             << "messages of topic[" << this->topic << "].\n";
+      this->owner->messagesDropped = true;
+    }
+    return;
+  }
 
-    this->dataPtr->logControlSub =
-      this->dataPtr->node->Subscribe("~/log/control",
-          &LogRecord::OnLogControl, this);
-    this->dataPtr->logStatusPub =
-      this->dataPtr->node->Advertise<msgs::LogStatus>("~/log/status");
+  this->owner->messageBytes += _data.size();
+  this->messages.emplace_back(this->owner->simTime, _data);
+}
+
+//////////////////////////////////////////////////
+std::string LogRecordPrivate::CollectMessages()
+{
+  typedef std::vector<std::pair<common::Time, std::string>> Messages;
+  std::vector<std::pair<TopicRecorder *, Messages>> taken;
+  {
+    std::lock_guard<std::mutex> lock(this->messageMutex);
+    for (auto &recorder : this->topicRecorders)
+    {
+      if (!recorder->messages.empty())
+      {
+        taken.emplace_back(recorder.get(), Messages());
+        taken.back().second.swap(recorder->messages);
+      }
+    }
+    this->messageBytes = 0;
+  }
+
+  if (taken.empty())
+    return std::string();
+
+  // Messages of all the topics, ordered by simulation time
+  std::vector<std::pair<const TopicRecorder *,
+    const std::pair<common::Time, std::string> *>> ordered;
+  for (auto &topicMessages : taken)
+  {
+    // The type is known once the topic has a publisher
+    TopicRecorder *recorder = topicMessages.first;
+    if (recorder->type.empty())
+      recorder->type = transport::getTopicMsgType(recorder->topic);
+
+    for (auto const &msg : topicMessages.second)
+      ordered.emplace_back(recorder, &msg);
+  }
+  std::stable_sort(ordered.begin(), ordered.end(),
+      [](const std::pair<const TopicRecorder *,
+           const std::pair<common::Time, std::string> *> &_a,
+         const std::pair<const TopicRecorder *,
+           const std::pair<common::Time, std::string> *> &_b)
+      {
+        return _a.second->first < _b.second->first;
+      });
+
+  // Base64 keeps the serialized bytes from closing the element or looking
+  // like a frame
+  std::ostringstream stream;
+  for (auto const &msg : ordered)
+  {
+    std::string data;
+    Base64Encode(msg.second->second.c_str(), msg.second->second.size(),
+        data);
+    stream << "<message topic='" << msg.first->topic << "' type='"
+           << msg.first->type << "' sim_time='" << msg.second->first << "'>"
+           << data << "</message>\n";
   }
+
+  return stream.str();
 }
 
 //////////////////////////////////////////////////
 bool LogRecord::Remove(const std::string &_name)
 {
+  std::lock_guard<std::mutex> fileLock(this->dataPtr->fileMutex);
   std::lock_guard<std::mutex> logLock(this->dataPtr->writeMutex);
 
   bool result = false;
@@ -547,13 +948,10 @@ bool LogRecord::SaveModels(const std::set<std::string> &_models)
       if (boost::filesystem::exists(srcModelPath))
       {
         modelFound = true;
-        boost::filesystem::path destModelPath =
-          this->dataPtr->logCompletePath / model;
-        if (!gazebo::common::copyDir(srcModelPath, destModelPath))
-        {
-          gzerr << "Failed to copy model from '" << srcModelPath.string()
-                 << "' to '" << destModelPath.string() << "'" << std::endl;
-        }
+        LogRecordPrivate::ResourceCopy copy;
+        copy.source = srcModelPath;
+        copy.destination = this->dataPtr->logCompletePath / model;
+        this->dataPtr->Queue(copy);
         break;
       }
     }
@@ -628,36 +1026,18 @@ bool LogRecord::SaveFiles(const std::set<std::string> &_files)
       {
         auto modelPath =
             boost::filesystem::path(fileName.substr(0, meshIdx));
-        srcPath = srcPath / modelPath;
-        boost::filesystem::path destPath =
-          this->dataPtr->logCompletePath / modelPath;
-        boost::system::error_code errorCode;
-        boost::filesystem::create_directories(destPath, errorCode);
-        if (errorCode != boost::system::errc::success ||
-            !gazebo::common::copyDir(srcPath, destPath))
-        {
-          gzerr << "Failed to copy model from '" << srcPath.string()
-                 << "' to '" << destPath.string() << "'" << std::endl;
-          saveError = true;
-        }
+        LogRecordPrivate::ResourceCopy copy;
+        copy.source = srcPath / modelPath;
+        copy.destination = this->dataPtr->logCompletePath / modelPath;
+        this->dataPtr->Queue(copy);
       }
       // else copy only the specified file
       else
       {
-        srcPath = srcPath / fileName;
-        boost::filesystem::path destPath =
-          this->dataPtr->logCompletePath / fileName;
-        boost::system::error_code errorCode;
-        boost::filesystem::create_directories(
-            destPath.parent_path(), errorCode);
-        if (errorCode == boost::system::errc::success)
-          boost::filesystem::copy_file(srcPath, destPath, errorCode);
-        else
-        {
-          gzerr << "Failed to copy file from '" << srcPath.string()
-                 << "' to '" << destPath.string() << "'" << std::endl;
-          saveError = true;
-        }
+        LogRecordPrivate::ResourceCopy copy;
+        copy.source = srcPath / fileName;
+        copy.destination = this->dataPtr->logCompletePath / fileName;
+        this->dataPtr->Queue(copy);
       }
     }
     else
@@ -700,10 +1080,18 @@ void LogRecord::Update()
   if (!this->dataPtr->paused)
   {
     unsigned int size = 0;
+    const std::string messages = this->dataPtr->CollectMessages();
 
     {
       std::lock_guard<std::mutex> lock(this->dataPtr->writeMutex);
 
+      // Topic messages go to the first log, usually the world's
+      if (!messages.empty() &&
+          this->dataPtr->logs.begin() != this->dataPtr->logsEnd)
+      {
+        this->dataPtr->logs.begin()->second->messages.append(messages);
+      }
+
       // Collect all the new log data. This will not write data to disk.
       for (this->dataPtr->updateIter = this->dataPtr->logs.begin();
            this->dataPtr->updateIter != this->dataPtr->logsEnd;
@@ -711,6 +1099,9 @@ void LogRecord::Update()
       {
         size += this->dataPtr->updateIter->second->Update();
       }
+
+      this->dataPtr->CountInFlight();
+      this->ApplyBufferPolicy();
     }
 
     if (this->dataPtr->firstUpdate)
@@ -747,17 +1138,127 @@ void LogRecord::RunWrite()
 }
 
 //////////////////////////////////////////////////
-void LogRecord::Write(const bool /*_force*/)
+void LogRecord::RunResources()
 {
-  std::lock_guard<std::mutex> lock(this->dataPtr->writeMutex);
+  std::unique_lock<std::mutex> lock(this->dataPtr->resourceMutex);
+  while (true)
+  {
+    this->dataPtr->resourceCondition.wait(lock, [this]()
+        {
+          return this->dataPtr->stopThread ||
+            !this->dataPtr->resourceCopies.empty();
+        });
+
+    // Save everything queued before stopping
+    if (this->dataPtr->resourceCopies.empty())
+      break;
+
+    LogRecordPrivate::ResourceCopy copy =
+      this->dataPtr->resourceCopies.front();
+    this->dataPtr->resourceCopies.pop_front();
+
+    lock.unlock();
+    this->dataPtr->Save(copy);
+    lock.lock();
+  }
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::Queue(const ResourceCopy &_copy)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->resourceMutex);
+    if (this->resourceThread)
+    {
+      this->resourceCopies.push_back(_copy);
+      this->resourceCondition.notify_one();
+      return;
+    }
+  }
+
+  this->Save(_copy);
+}
+
+//////////////////////////////////////////////////
+bool LogRecordPrivate::Save(const ResourceCopy &_copy)
+{
+  if (this->resourceStore)
+  {
+    if (!this->resourceStore->Add(_copy.source.string(),
+          _copy.destination.string()))
+    {
+      gzerr << "Failed to save '" << _copy.source.string() << "' to '"
+            << _copy.destination.string() << "'" << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  boost::system::error_code errorCode;
+  if (boost::filesystem::is_directory(_copy.source))
+  {
+    boost::filesystem::create_directories(_copy.destination, errorCode);
+    if (errorCode != boost::system::errc::success ||
+        !gazebo::common::copyDir(_copy.source, _copy.destination))
+    {
+      gzerr << "Failed to copy model from '" << _copy.source.string()
+             << "' to '" << _copy.destination.string() << "'" << std::endl;
+      return false;
+    }
+    return true;
+  }
 
-  // Collect all the new log data.
-  for (this->dataPtr->updateIter = this->dataPtr->logs.begin();
-      this->dataPtr->updateIter != this->dataPtr->logsEnd;
-      ++this->dataPtr->updateIter)
+  boost::filesystem::create_directories(_copy.destination.parent_path(),
+      errorCode);
+  if (errorCode == boost::system::errc::success)
   {
-    this->dataPtr->updateIter->second->Write();
+    boost::filesystem::copy_file(_copy.source, _copy.destination,
+        errorCode);
+  }
+  if (errorCode != boost::system::errc::success)
+  {
+    gzerr << "Failed to copy file from '" << _copy.source.string()
+           << "' to '" << _copy.destination.string() << "'" << std::endl;
+    return false;
   }
+  return true;
+}
+
+//////////////////////////////////////////////////
+void LogRecord::Write(const bool _force)
+{
+  // Logs are only deleted with fileMutex held, which isn't needed to
+  // update them. A slow disk doesn't hold up the collection of new data.
+  std::lock_guard<std::mutex> fileLock(this->dataPtr->fileMutex);
+
+  std::vector<std::pair<LogRecordPrivate::Log *, std::string>> data;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->writeMutex);
+
+    // Collect all the new log data.
+    std::size_t bytes = 0;
+    for (auto iter = this->dataPtr->logs.begin();
+         iter != this->dataPtr->logsEnd; ++iter)
+    {
+      data.emplace_back(iter->second, std::string());
+      iter->second->TakeData(_force, data.back().second);
+      bytes += data.back().second.size();
+    }
+    this->dataPtr->bytesWriting = bytes;
+    this->dataPtr->CountInFlight();
+  }
+
+  for (auto const &logData : data)
+    logData.first->WriteData(logData.second);
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->writeMutex);
+    this->dataPtr->bytesWriting = 0;
+    this->dataPtr->CountInFlight();
+  }
+
+  std::lock_guard<std::mutex> roomLock(this->dataPtr->roomMutex);
+  this->dataPtr->roomCondition.notify_all();
 }
 
 //////////////////////////////////////////////////
@@ -767,11 +1268,12 @@ common::Time LogRecord::RunTime() const
 }
 
 //////////////////////////////////////////////////
-LogRecordPrivate::Log::Log(LogRecord *_parent,
+LogRecordPrivate::Log::Log(LogRecord *_parent, LogRecordPrivate *_owner,
     const std::string &_relativeFilename,
     std::function<bool (std::ostringstream &)> _logCB)
 {
   this->parent = _parent;
+  this->owner = _owner;
   this->logCB = _logCB;
 
   this->relativeFilename = _relativeFilename;
@@ -794,55 +1296,317 @@ unsigned int LogRecordPrivate::Log::Update()
     std::string data = stream.str();
     if (!data.empty())
     {
-      const std::string &encodingLocal = this->parent->Encoding();
-
-      this->buffer.append("<chunk encoding='");
-      this->buffer.append(encodingLocal);
-      this->buffer.append("'>\n");
-
-      this->buffer.append("<![CDATA[");
-      // Compress the data.
-      if (encodingLocal == "bz2")
+      Chunk chunk;
+      chunk.entry = IndexEntry(data);
+
+      // The first chunk has the world's SDF, and playback needs every
+      // insertion and deletion
+      chunk.droppable = this->chunkCount > 0 &&
+        data.find("<insertions>") == std::string::npos &&
+        data.find("<deletions>") == std::string::npos;
+      ++this->chunkCount;
+
+      // After the states, where playback skips them
+      data.append(this->messages);
+      this->messages.clear();
+
+      std::string encodingLocal;
+      int level;
+      ParseEncoding(this->parent->Encoding(), encodingLocal, level);
+      const bool binary = this->parent->BinaryChunks();
+
+      // Make room for the chunk, waiting for the oldest ones in order
+      const unsigned int threads = CompressionThreads();
+      unsigned int compressing = 0;
+      for (auto const &queued : this->chunks)
       {
-        std::string str;
-
-        // Compress to bzip2
-        {
-          boost::iostreams::filtering_ostream out;
-          out.push(boost::iostreams::bzip2_compressor());
-          out.push(std::back_inserter(str));
-          boost::iostreams::copy(boost::make_iterator_range(data), out);
-        }
-
-        // Encode in base64.
-        Base64Encode(str.c_str(), str.size(), this->buffer);
+        if (!queued.ready)
+          ++compressing;
       }
-      else if (encodingLocal == "zlib")
+      for (auto &queued : this->chunks)
       {
-        std::string str;
-
-        // Compress to zlib
+        if (compressing < threads)
+          break;
+        if (!queued.ready)
         {
-          boost::iostreams::filtering_ostream out;
-          out.push(boost::iostreams::zlib_compressor());
-          out.push(std::back_inserter(str));
-          boost::iostreams::copy(boost::make_iterator_range(data), out);
+          this->chunkBytes -= queued.bytes;
+          queued.data = queued.future.get();
+          queued.bytes = queued.data.size();
+          queued.ready = true;
+          this->chunkBytes += queued.bytes;
+          --compressing;
         }
+      }
 
-        // Encode in base64.
-        Base64Encode(str.c_str(), str.size(), this->buffer);
+      chunk.bytes = data.size();
+      LatencyHistogram *latency = &this->owner->compressionLatency;
+      auto encode = [latency](const std::string &_data,
+          const std::string &_encoding, const int _level, const bool _binary)
+      {
+        auto start = std::chrono::steady_clock::now();
+        std::string result = EncodeChunk(_data, _encoding, _level, _binary);
+        latency->Add(std::chrono::steady_clock::now() - start);
+        return result;
+      };
+
+      if (threads <= 1 || encodingLocal == "txt")
+      {
+        chunk.data = encode(data, encodingLocal, level, binary);
+        chunk.bytes = chunk.data.size();
+        chunk.ready = true;
       }
-      else if (encodingLocal == "txt")
-        this->buffer.append(data);
       else
-        gzerr << "Unknown log file encoding[" << encodingLocal << "]\n";
-      this->buffer.append("]]>\n");
+      {
+        chunk.future = std::async(std::launch::async, encode,
+              std::move(data), encodingLocal, level, binary);
+      }
 
-      this->buffer.append("</chunk>\n");
+      this->chunkBytes += chunk.bytes;
+      this->chunks.push_back(std::move(chunk));
+
+      this->CollectChunks(false);
     }
   }
 
-  return this->buffer.size();
+  return this->buffer.size() + this->chunks.size();
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::Log::CollectChunks(const bool _wait)
+{
+  for (auto &chunk : this->chunks)
+  {
+    if (chunk.ready)
+      continue;
+
+    if (!_wait && chunk.future.wait_for(std::chrono::seconds(0)) !=
+        std::future_status::ready)
+    {
+      break;
+    }
+
+    this->chunkBytes -= chunk.bytes;
+    chunk.data = chunk.future.get();
+    chunk.bytes = chunk.data.size();
+    chunk.ready = true;
+    this->chunkBytes += chunk.bytes;
+  }
+}
+
+//////////////////////////////////////////////////
+std::size_t LogRecordPrivate::Log::DropOldest()
+{
+  for (auto iter = this->chunks.begin(); iter != this->chunks.end(); ++iter)
+  {
+    if (iter->ready && iter->droppable)
+    {
+      const std::size_t bytes = iter->bytes;
+      this->chunkBytes -= bytes;
+      this->chunks.erase(iter);
+      return bytes;
+    }
+  }
+  return 0;
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::LatencyHistogram::Add(
+    const std::chrono::steady_clock::duration &_latency)
+{
+  const double ms =
+    std::chrono::duration<double, std::milli>(_latency).count();
+  unsigned int bucket = 0;
+  while (bucket < kBuckets - 1 && ms > Bound(bucket))
+    ++bucket;
+  ++this->counts[bucket];
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::LatencyHistogram::Clear()
+{
+  for (auto &count : this->counts)
+    count = 0;
+}
+
+//////////////////////////////////////////////////
+double LogRecordPrivate::LatencyHistogram::Bound(const unsigned int _bucket)
+{
+  return static_cast<double>(1u << _bucket);
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::CountInFlight()
+{
+  std::size_t bytes = this->bytesWriting;
+  unsigned int depth = 0;
+  for (auto const &log : this->logs)
+  {
+    bytes += log.second->chunkBytes;
+    depth += log.second->chunks.size();
+  }
+  *this->memory += static_cast<int64_t>(bytes) -
+      static_cast<int64_t>(this->bytesInFlight.load());
+  this->bytesInFlight = bytes;
+  this->queueDepth = depth;
+}
+
+//////////////////////////////////////////////////
+std::string LogRecordPrivate::EncodeChunk(const std::string &_data,
+    const std::string &_encoding, const int _level, const bool _binary)
+{
+  std::string compressed;
+
+  // Compress the data.
+  if (_encoding == "bz2")
+  {
+    // Compress to bzip2
+    boost::iostreams::filtering_ostream out;
+    out.push(boost::iostreams::bzip2_compressor());
+    out.push(std::back_inserter(compressed));
+    boost::iostreams::copy(boost::make_iterator_range(_data), out);
+  }
+  else if (_encoding == "zlib")
+  {
+    // Compress to zlib
+    boost::iostreams::filtering_ostream out;
+    out.push(boost::iostreams::zlib_compressor());
+    out.push(std::back_inserter(compressed));
+    boost::iostreams::copy(boost::make_iterator_range(_data), out);
+  }
+#ifdef HAVE_ZSTD
+  else if (_encoding == "zstd")
+  {
+    compressed.resize(ZSTD_compressBound(_data.size()));
+    size_t size = ZSTD_compress(&compressed[0], compressed.size(),
+        _data.data(), _data.size(), _level);
+    if (ZSTD_isError(size))
+    {
+      gzerr << "Unable to compress log data with zstd: "
+            << ZSTD_getErrorName(size) << "\n";
+      size = 0;
+    }
+    compressed.resize(size);
+  }
+#endif
+#ifdef HAVE_LZ4
+  else if (_encoding == "lz4")
+  {
+    LZ4F_preferences_t prefs;
+    memset(&prefs, 0, sizeof(prefs));
+    prefs.frameInfo.contentSize = _data.size();
+    compressed.resize(LZ4F_compressFrameBound(_data.size(), &prefs));
+    size_t size = LZ4F_compressFrame(&compressed[0], compressed.size(),
+        _data.data(), _data.size(), &prefs);
+    if (LZ4F_isError(size))
+    {
+      gzerr << "Unable to compress log data with lz4: "
+            << LZ4F_getErrorName(size) << "\n";
+      size = 0;
+    }
+    compressed.resize(size);
+  }
+#endif
+  else if (_encoding != "txt")
+    gzerr << "Unknown log file encoding[" << _encoding << "]\n";
+
+  std::string chunk = "<chunk encoding='" + _encoding + "'";
+  if (_encoding == "txt")
+  {
+    chunk.append(">\n<![CDATA[");
+    chunk.append(_data);
+    chunk.append("]]>\n");
+  }
+  else if (_binary)
+  {
+    // The compressed data as is, which only parsers that skip the given
+    // number of bytes can read
+    chunk.append(" size='" + std::to_string(compressed.size()) + "'>");
+    chunk.append(compressed);
+    chunk.append("\n");
+  }
+  else
+  {
+    chunk.append(">\n<![CDATA[");
+    // Encode in base64.
+    Base64Encode(compressed.c_str(), compressed.size(), chunk);
+    chunk.append("]]>\n");
+  }
+  chunk.append("</chunk>\n");
+
+  return chunk;
+}
+
+//////////////////////////////////////////////////
+bool LogRecordPrivate::ParseEncoding(const std::string &_encoding,
+    std::string &_name, int &_level)
+{
+  _name = _encoding.substr(0, _encoding.find(':'));
+  _level = 0;
+
+#ifdef HAVE_ZSTD
+  if (_name == "zstd")
+  {
+    _level = ZSTD_CLEVEL_DEFAULT;
+    if (_name.size() == _encoding.size())
+      return true;
+
+    try
+    {
+      size_t end;
+      _level = std::stoi(_encoding.substr(_name.size() + 1), &end);
+      return end == _encoding.size() - _name.size() - 1 &&
+        _level >= 1 && _level <= ZSTD_maxCLevel();
+    }
+    catch(...)
+    {
+      return false;
+    }
+  }
+#endif
+#ifdef HAVE_LZ4
+  if (_encoding == "lz4")
+    return true;
+#endif
+
+  return _encoding == "bz2" || _encoding == "zlib" || _encoding == "txt";
+}
+
+//////////////////////////////////////////////////
+std::string LogRecordPrivate::Encodings()
+{
+  std::string result = "bz2, zlib, txt";
+#ifdef HAVE_ZSTD
+  result += ", zstd, zstd:<level>";
+#endif
+#ifdef HAVE_LZ4
+  result += ", lz4";
+#endif
+  return result;
+}
+
+//////////////////////////////////////////////////
+unsigned int LogRecordPrivate::CompressionThreads()
+{
+  static const unsigned int threads = []() -> unsigned int
+  {
+    const char *env = getenv("GAZEBO_LOG_COMPRESSION_THREADS");
+    if (env)
+    {
+      try
+      {
+        return std::max(1, std::stoi(env));
+      }
+      catch(...)
+      {
+        gzwarn << "Invalid GAZEBO_LOG_COMPRESSION_THREADS[" << env
+               << "], compressing on the update thread.\n";
+        return 1;
+      }
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+  }();
+
+  return threads;
 }
 
 //////////////////////////////////////////////////
@@ -854,7 +1618,7 @@ void LogRecordPrivate::Log::ClearBuffer()
 //////////////////////////////////////////////////
 unsigned int LogRecordPrivate::Log::BufferSize()
 {
-  return this->buffer.size();
+  return this->buffer.size() + this->chunkBytes;
 }
 
 //////////////////////////////////////////////////
@@ -875,15 +1639,63 @@ void LogRecordPrivate::Log::Stop()
   if (this->logFile.is_open())
   {
     this->Update();
-    this->Write();
 
-    std::string xmlEnd = "</gazebo_log>";
+    std::string data;
+    this->TakeData(true, data);
+    this->WriteData(data);
+
+    // The index follows the chunks, where older readers ignore it
+    std::string xmlEnd = "<index>\n" + this->index + "</index>\n" +
+      "</gazebo_log>";
     this->logFile.write(xmlEnd.c_str(), xmlEnd.size());
 
     this->logFile.close();
   }
 
   this->completePath.clear();
+  this->index.clear();
+  this->messages.clear();
+  this->chunks.clear();
+  this->chunkBytes = 0;
+  this->chunkCount = 0;
+}
+
+//////////////////////////////////////////////////
+std::string LogRecordPrivate::Log::IndexEntry(const std::string &_data)
+{
+  const std::string kStartTime = "<sim_time>";
+  const std::string kEndTime = "</sim_time>";
+  const std::string kStartIterations = "<iterations>";
+  const std::string kEndIterations = "</iterations>";
+
+  // Text between the first pair of delimiters, searching from the end of
+  // the data if _last is true.
+  auto element = [&_data](const std::string &_start, const std::string &_end,
+      const bool _last) -> std::string
+  {
+    auto from = _last ? _data.rfind(_start) : _data.find(_start);
+    if (from == std::string::npos)
+      return std::string();
+    from += _start.size();
+    auto to = _data.find(_end, from);
+    if (to == std::string::npos)
+      return std::string();
+    return _data.substr(from, to - from);
+  };
+
+  std::string first = element(kStartTime, kEndTime, false);
+  std::string last = element(kStartTime, kEndTime, true);
+  std::string iterations = element(kStartIterations, kEndIterations, false);
+
+  std::string entry = "<entry";
+  if (!first.empty() && !last.empty())
+  {
+    entry.append(" first='" + first + "' last='" + last + "'");
+  }
+  if (!iterations.empty())
+    entry.append(" iterations='" + iterations + "'");
+  entry.append("/>\n");
+  return entry;
 }
 
 //////////////////////////////////////////////////
@@ -903,14 +1715,40 @@ void LogRecordPrivate::Log::Start(const boost::filesystem::path &_path)
          << "<header>\n"
          << "<log_version>" << GZ_LOG_VERSION << "</log_version>\n"
          << "<gazebo_version>" << GAZEBO_VERSION_FULL << "</gazebo_version>\n"
-         << "<rand_seed>" << ignition::math::Rand::Seed() << "</rand_seed>\n"
-         << "</header>\n";
+         << "<rand_seed>" << ignition::math::Rand::Seed() << "</rand_seed>\n";
+
+  // Tells LogPlay that it can seek from keyframes
+  if (this->parent->KeyframePeriod() > 0)
+  {
+    stream << "<keyframe_period>" << this->parent->KeyframePeriod()
+           << "</keyframe_period>\n";
+  }
+  stream << "</header>\n";
 
   this->buffer.append(stream.str());
 }
 
 //////////////////////////////////////////////////
-void LogRecordPrivate::Log::Write()
+void LogRecordPrivate::Log::TakeData(const bool _wait, std::string &_data)
+{
+  this->CollectChunks(_wait);
+
+  _data.swap(this->buffer);
+  this->buffer.clear();
+
+  // Chunks are written in order, and only once compressed
+  while (!this->chunks.empty() && this->chunks.front().ready)
+  {
+    Chunk &chunk = this->chunks.front();
+    _data.append(chunk.data);
+    this->index.append(chunk.entry);
+    this->chunkBytes -= chunk.bytes;
+    this->chunks.pop_front();
+  }
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::Log::WriteData(const std::string &_data)
 {
   // Make sure the file is open for writing
   if (!this->logFile.is_open())
@@ -931,18 +1769,17 @@ void LogRecordPrivate::Log::Write()
   {
     gzerr << "Log file[" << this->completePath << "] no longer exists. "
           << "Unable to write log data.\n";
-
-    // We have to clear the buffer, or else it may grow indefinitely.
-    this->buffer.clear();
     return;
   }
 
-  // Write out the contents of the buffer.
-  this->logFile.write(this->buffer.c_str(), this->buffer.size());
-  this->logFile.flush();
+  if (_data.empty())
+    return;
 
-  // Clear the buffer.
-  this->buffer.clear();
+  // Write out the data.
+  auto start = std::chrono::steady_clock::now();
+  this->logFile.write(_data.c_str(), _data.size());
+  this->logFile.flush();
+  this->owner->writeLatency.Add(std::chrono::steady_clock::now() - start);
 }
 
 //////////////////////////////////////////////////
@@ -1024,6 +1861,39 @@ void LogRecord::PublishLogStatus()
     msg.mutable_log_file()->set_size_units(msgs::LogStatus::LogFile::G_BYTES);
   }
 
+  // Set the state of the buffer, of all the logs
+  msgs::LogStatus::Buffer *buffer = msg.mutable_buffer();
+  buffer->set_queue_depth(this->dataPtr->queueDepth);
+  buffer->set_bytes_in_flight(this->dataPtr->bytesInFlight);
+  buffer->set_limit(this->dataPtr->bufferLimit);
+  switch (this->dataPtr->bufferPolicy)
+  {
+    case LogBufferPolicy::DROP_OLDEST:
+      buffer->set_policy(msgs::LogStatus::Buffer::DROP_OLDEST);
+      break;
+    case LogBufferPolicy::DEGRADE_PERIOD:
+      buffer->set_policy(msgs::LogStatus::Buffer::DEGRADE_PERIOD);
+      break;
+    case LogBufferPolicy::BLOCK:
+    default:
+      buffer->set_policy(msgs::LogStatus::Buffer::BLOCK);
+      break;
+  }
+  buffer->set_dropped_chunks(this->dataPtr->droppedChunks);
+  buffer->set_period(this->EffectivePeriod());
+  for (unsigned int i = 0;
+       i < LogRecordPrivate::LatencyHistogram::kBuckets; ++i)
+  {
+    if (i + 1 < LogRecordPrivate::LatencyHistogram::kBuckets)
+    {
+      buffer->add_latency_bounds(
+          LogRecordPrivate::LatencyHistogram::Bound(i));
+    }
+    buffer->add_compression_latency(
+        this->dataPtr->compressionLatency.counts[i]);
+    buffer->add_write_latency(this->dataPtr->writeLatency.counts[i]);
+  }
+
   this->dataPtr->logStatusPub->Publish(msg);
 }
 
@@ -1044,6 +1914,12 @@ void LogRecord::Cleanup()
   this->dataPtr->running = false;
   this->dataPtr->stopThread = true;
 
+  // Release the world, if it waits for room in the buffer
+  {
+    std::lock_guard<std::mutex> roomLock(this->dataPtr->roomMutex);
+    this->dataPtr->roomCondition.notify_all();
+  }
+
   // Kick the update thread
   {
     std::lock_guard<std::mutex> updateLock(this->dataPtr->updateMutex);
@@ -1067,6 +1943,11 @@ void LogRecord::Cleanup()
   this->dataPtr->updateThread.reset();
   this->dataPtr->writeThread.reset();
 
+  // Stop recording topics. The last messages are logged below.
+  this->dataPtr->worldUpdateConnection.reset();
+  for (auto &recorder : this->dataPtr->topicRecorders)
+    recorder->subscriber.reset();
+
   // Update and write one last time to make sure we log all data.
   this->Update();
 
@@ -1079,6 +1960,35 @@ void LogRecord::Cleanup()
     iter->second->Stop();
   }
 
+  {
+    std::lock_guard<std::mutex> logLock(this->dataPtr->writeMutex);
+    this->dataPtr->CountInFlight();
+  }
+
+  // Wait for the resources to be saved
+  std::unique_ptr<std::thread> resourceThread;
+  {
+    std::lock_guard<std::mutex> resourceLock(this->dataPtr->resourceMutex);
+    this->dataPtr->resourceCondition.notify_all();
+    resourceThread = std::move(this->dataPtr->resourceThread);
+  }
+  if (resourceThread)
+    resourceThread->join();
+
+  // Resources queued while the thread stopped
+  while (true)
+  {
+    LogRecordPrivate::ResourceCopy copy;
+    {
+      std::lock_guard<std::mutex> resourceLock(this->dataPtr->resourceMutex);
+      if (this->dataPtr->resourceCopies.empty())
+        break;
+      copy = this->dataPtr->resourceCopies.front();
+      this->dataPtr->resourceCopies.pop_front();
+    }
+    this->dataPtr->Save(copy);
+  }
+
   // Reset the times
   this->dataPtr->startTime = this->dataPtr->currTime = common::Time();
 
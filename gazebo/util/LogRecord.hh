@@ -17,12 +17,15 @@
 #ifndef _GAZEBO_UTIL_LOGRECORD_HH_
 #define _GAZEBO_UTIL_LOGRECORD_HH_
 
+#include <cstdint>
 #include <fstream>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/common/SingletonT.hh"
+#include "gazebo/common/UpdateInfo.hh"
 #include "gazebo/util/system.hh"
 
 #define GZ_LOG_VERSION "1.0"
@@ -34,11 +37,30 @@ namespace gazebo
 {
   namespace util
   {
+    /// \enum LogBufferPolicy
+    /// \brief What LogRecord does once the data it hasn't written to disk
+    /// yet reaches LogRecordParams::bufferLimit.
+    enum class LogBufferPolicy
+    {
+      /// \brief Block the simulation until the data is written.
+      BLOCK,
+
+      /// \brief Drop the oldest chunks not written yet. The first chunk of
+      /// a log, and chunks that insert or delete entities, are kept.
+      DROP_OLDEST,
+
+      /// \brief Double the recording period, up to 64 times, until the
+      /// data is written. The period is restored once the buffer is half
+      /// empty.
+      DEGRADE_PERIOD
+    };
+
     /// \brief Log recording parameters.
     /// \sa LogRecord::Start
     class LogRecordParams
     {
-      /// \brief The type of encoding (txt, zlib, or bz2).
+      /// \brief The type of encoding (txt, zlib, bz2, zstd, zstd:<level>
+      /// or lz4).
       public: std::string encoding = "zlib";
 
       /// \brief Path in which to store log files.
@@ -54,6 +76,41 @@ namespace gazebo
       /// \brief Recording resources. True will record state logs
       /// together with model meshes and materials.
       public: bool recordResources = false;
+
+      /// \brief Directory of a store of resources shared by all the logs,
+      /// empty to copy the resources into each log. With a store, each
+      /// file is stored once and linked from the logs.
+      /// \sa LogResourceStore
+      public: std::string resourceStore;
+
+      /// \brief True to record world states as binary msgs::WorldState
+      /// messages instead of SDF.
+      public: bool binaryStates = false;
+
+      /// \brief True to write compressed chunks as raw bytes instead of
+      /// Base64. The log is then no longer valid XML, and only LogPlay's
+      /// mapped reader can play it.
+      public: bool binaryChunks = false;
+
+      /// \brief Simulation time between keyframes, in seconds. A keyframe
+      /// is a recorded world state that also holds the SDF of every model
+      /// and light, so that playback can seek without replaying the
+      /// insertions and deletions from the start of the log. A value <= 0
+      /// disables keyframes.
+      public: double keyframePeriod = 0;
+
+      /// \brief Topics whose messages are recorded in the state log, such
+      /// as "~/camera/link/camera/image". Each message is written
+      /// serialized, with the simulation time at which it was received.
+      /// \sa LogPlay::ChunkMessages
+      public: std::vector<std::string> topics;
+
+      /// \brief Largest number of bytes of log data being compressed or
+      /// waiting to be written to disk, 0 for no limit.
+      public: std::size_t bufferLimit = 0;
+
+      /// \brief What to do when bufferLimit is reached.
+      public: LogBufferPolicy bufferPolicy = LogBufferPolicy::BLOCK;
     };
 
     // Forward declare private data class
@@ -78,6 +135,24 @@ namespace gazebo
     /// The LogRecord is updated at the start of each simulation step. This
     /// guarantees that all data is stored.
     ///
+    /// The messages of the topics set with LogRecord::SetTopics, such as
+    /// sensor data, are recorded in the chunks of the first log, after its
+    /// states. They're received in-process, without being copied again.
+    ///
+    /// Chunks are compressed on worker threads, several at a time, and
+    /// written in the order they were recorded. The zstd and lz4 encodings
+    /// are only available if Gazebo was built with those libraries.
+    /// Writing to disk doesn't hold up the collection of new data, which
+    /// can be bounded with LogRecordParams::bufferLimit. The size of the
+    /// queue and the latencies of compression and writing are published on
+    /// ~/log/status.
+    ///
+    /// \remarks
+    ///  Environment Variables:
+    ///   - GAZEBO_LOG_COMPRESSION_THREADS: Largest number of chunks
+    /// compressed at the same time. Defaults to the number of cores. Set it
+    /// to 1 to compress on the update thread.
+    ///
     /// \sa Logplay, State
     class GZ_UTIL_VISIBLE LogRecord : public SingletonT<LogRecord>
     {
@@ -162,6 +237,107 @@ namespace gazebo
       /// \param[in] _record True to save model resources when recording.
       public: void SetRecordResources(const bool _record);
 
+      /// \brief Get the directory of the store of recorded resources.
+      /// \return Directory of the store, empty if resources are copied
+      /// into each log.
+      /// \sa LogRecordParams::resourceStore
+      public: std::string ResourceStore() const;
+
+      /// \brief Set the directory of the store of recorded resources. Takes
+      /// effect on the next log file.
+      /// \param[in] _path Directory of the store, empty to copy resources
+      /// into each log.
+      public: void SetResourceStore(const std::string &_path);
+
+      /// \brief Get whether world states are recorded as binary
+      /// msgs::WorldState messages instead of SDF.
+      /// \return True if world states are recorded in binary.
+      public: bool BinaryStates() const;
+
+      /// \brief Set whether world states are recorded as binary
+      /// msgs::WorldState messages instead of SDF.
+      /// \param[in] _binary True to record world states in binary.
+      public: void SetBinaryStates(const bool _binary);
+
+      /// \brief Get whether compressed chunks are written as raw bytes
+      /// instead of Base64.
+      /// \return True if compressed chunks are written as raw bytes.
+      public: bool BinaryChunks() const;
+
+      /// \brief Set whether compressed chunks are written as raw bytes
+      /// instead of Base64. Such logs are no longer valid XML, and only
+      /// LogPlay's mapped reader can play them. Takes effect on the next
+      /// chunk.
+      /// \param[in] _binary True to write compressed chunks as raw bytes.
+      public: void SetBinaryChunks(const bool _binary);
+
+      /// \brief Get the simulation time between keyframes.
+      /// \return Keyframe period in seconds, <= 0 if keyframes are
+      /// disabled.
+      /// \sa LogRecordParams::keyframePeriod
+      public: double KeyframePeriod() const;
+
+      /// \brief Set the simulation time between keyframes. Takes effect on
+      /// the next log file.
+      /// \param[in] _period Keyframe period in seconds, <= 0 to disable
+      /// keyframes.
+      public: void SetKeyframePeriod(const double _period);
+
+      /// \brief Get the topics whose messages are recorded.
+      /// \return Names of the topics.
+      /// \sa LogRecordParams::topics
+      public: std::vector<std::string> Topics() const;
+
+      /// \brief Set the topics whose messages are recorded. Takes effect on
+      /// the next Start.
+      /// \param[in] _topics Names of the topics.
+      public: void SetTopics(const std::vector<std::string> &_topics);
+
+      /// \brief Get the limit of the log data not written to disk yet.
+      /// \return Limit in bytes, 0 if there's none.
+      /// \sa LogRecordParams::bufferLimit
+      public: std::size_t BufferLimit() const;
+
+      /// \brief Set the limit of the log data not written to disk yet.
+      /// \param[in] _limit Limit in bytes, 0 for no limit.
+      public: void SetBufferLimit(const std::size_t _limit);
+
+      /// \brief Get what is done when the buffer limit is reached.
+      /// \return The policy.
+      public: LogBufferPolicy BufferPolicy() const;
+
+      /// \brief Set what is done when the buffer limit is reached.
+      /// \param[in] _policy The policy.
+      public: void SetBufferPolicy(const LogBufferPolicy _policy);
+
+      /// \brief Get the recording period in use. It's Period(), unless
+      /// the buffer is full and the policy is
+      /// LogBufferPolicy::DEGRADE_PERIOD.
+      /// \return Recording period in seconds.
+      public: double EffectivePeriod() const;
+
+      /// \brief Get the number of bytes of log data being compressed or
+      /// waiting to be written to disk.
+      /// \return Number of bytes.
+      public: std::size_t BytesInFlight() const;
+
+      /// \brief Get the number of chunks being compressed or waiting to be
+      /// written to disk.
+      /// \return Number of chunks.
+      public: unsigned int QueueDepth() const;
+
+      /// \brief Get the number of chunks dropped since recording started,
+      /// because the buffer was full.
+      /// \return Number of chunks.
+      public: uint64_t DroppedChunks() const;
+
+      /// \brief Wait until the buffer has room for more log data. Returns
+      /// at once unless the policy is LogBufferPolicy::BLOCK, there's a
+      /// buffer limit and recording is running.
+      /// \param[in] _timeout Longest time to wait.
+      /// \return True if there's room.
+      public: bool WaitForRoom(const common::Time &_timeout);
+
       /// \brief Get whether the logger is ready to start, which implies
       /// that any previous runs have finished.
       // \return True if logger is ready to start.
@@ -176,14 +352,17 @@ namespace gazebo
       public: bool Start(const LogRecordParams &_params);
 
       /// \brief Start the logger.
-      /// \param[in] _encoding The type of encoding (txt, zlib, or bz2).
+      /// \param[in] _encoding The type of encoding (txt, zlib, bz2, zstd,
+      /// zstd:<level> or lz4). The zstd level goes from 1 to 22, and
+      /// defaults to 3.
       /// \param[in] _path Path in which to store log files.
       public: bool Start(const std::string &_encoding="zlib",
                          const std::string &_path="");
 
       /// \brief Get the encoding used.
-      /// \return Either [txt, zlib, or bz2], where txt is plain txt and bz2
-      /// and zlib are compressed data with Base64 encoding.
+      /// \return Either [txt, zlib, bz2, zstd, zstd:<level> or lz4], where
+      /// txt is plain txt and the others are compressed data with Base64
+      /// encoding, or raw if BinaryChunks is set.
       public: const std::string &Encoding() const;
 
       /// \brief Get the filename for a log object.
@@ -215,13 +394,16 @@ namespace gazebo
       /// \return True if an Update has not yet been completed.
       public: bool FirstUpdate() const;
 
-      /// \brief Return true if all the models are saved successfully.
+      /// \brief Save models in the log directory. The models are copied
+      /// by another thread, after this function returns, and are all saved
+      /// once the recording stops.
       /// \return True if all the models are saved successfully.
       public: bool SaveModels(const std::set<std::string> &models);
 
-      /// \brief Return true if all the files are saved successfully.
-      /// \return True if all the files are saved successfully, and false if
-      /// there are errors saving the files.
+      /// \brief Save files in the log directory. As with SaveModels, the
+      /// files are copied by another thread.
+      /// \return True if all the files were found, and false if there are
+      /// errors finding the files.
       public: bool SaveFiles(const std::set<std::string> &resources);
 
       /// \brief Write all logs.
@@ -244,12 +426,28 @@ namespace gazebo
       /// \brief Run the Write loop.
       private: void RunWrite();
 
+      /// \brief Run the loop that copies resources into the log directory.
+      private: void RunResources();
+
       /// \brief Clear and delete the log buffers.
       private: void ClearLogs();
 
       /// \brief Publish log status message.
       private: void PublishLogStatus();
 
+      /// \brief Apply the buffer policy, once new chunks were queued.
+      private: void ApplyBufferPolicy();
+
+      /// \brief Create the transport node, if it doesn't exist yet.
+      private: void InitNode();
+
+      /// \brief Subscribe to the recorded topics.
+      private: void SubscribeTopics();
+
+      /// \brief Store the simulation time, to stamp recorded messages.
+      /// \param[in] _info World update information.
+      private: void OnWorldUpdateBegin(const common::UpdateInfo &_info);
+
       /// \brief Called when a log control message is received.
       /// \param[in] _data The log control message.
       private: void OnLogControl(ConstLogControlPtr &_data);
@@ -17,15 +17,26 @@
 #ifndef _GAZEBO_UTIL_LOGRECORD_PRIVATE_HH_
 #define _GAZEBO_UTIL_LOGRECORD_PRIVATE_HH_
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 #include <functional>
 #include <condition_variable>
+#include <deque>
+#include <future>
 #include <boost/filesystem.hpp>
 
+#include "gazebo/util/LogResourceStore.hh"
+
 namespace gazebo
 {
   namespace util
@@ -39,16 +50,95 @@ namespace gazebo
       /// \brief Destructor (makes style checker happy)
       public: virtual ~LogRecordPrivate() = default;
 
+      /// \brief Compress the data of a chunk and wrap it in a <chunk>
+      /// element.
+      /// \param[in] _data Data of the chunk.
+      /// \param[in] _encoding Name of the encoding: txt, zlib, bz2, zstd or
+      /// lz4.
+      /// \param[in] _level Compression level, for zstd.
+      /// \param[in] _binary True to write compressed data as raw bytes
+      /// instead of Base64.
+      /// \return The <chunk> element.
+      public: static std::string EncodeChunk(const std::string &_data,
+                  const std::string &_encoding, const int _level,
+                  const bool _binary);
+
+      /// \brief Split an encoding such as "zstd:9" into its name and
+      /// compression level.
+      /// \param[in] _encoding The encoding.
+      /// \param[out] _name Name of the encoding.
+      /// \param[out] _level Compression level, 0 if it has none.
+      /// \return False if the encoding isn't supported.
+      public: static bool ParseEncoding(const std::string &_encoding,
+                  std::string &_name, int &_level);
+
+      /// \brief Get the supported encodings.
+      /// \return Comma separated list of encodings.
+      public: static std::string Encodings();
+
+      /// \brief Get the largest number of chunks compressed at the same
+      /// time, from GAZEBO_LOG_COMPRESSION_THREADS.
+      /// \return Number of chunks.
+      public: static unsigned int CompressionThreads();
+
+      /// \brief Counts of latencies, in buckets whose upper bounds are
+      /// powers of two milliseconds.
+      public: class LatencyHistogram
+      {
+        /// \brief Number of buckets. The last one has no upper bound.
+        public: static const unsigned int kBuckets = 12;
+
+        /// \brief Count a latency.
+        /// \param[in] _latency The latency.
+        public: void Add(const std::chrono::steady_clock::duration &_latency);
+
+        /// \brief Reset the counts to 0.
+        public: void Clear();
+
+        /// \brief Get the upper bound of a bucket.
+        /// \param[in] _bucket Index of the bucket, < kBuckets - 1.
+        /// \return Upper bound in milliseconds.
+        public: static double Bound(const unsigned int _bucket);
+
+        /// \brief Count of each bucket.
+        public: std::array<std::atomic<uint64_t>, kBuckets> counts {};
+      };
+
       /// \brief Log helper class
       public: class Log
       {
+        /// \brief A chunk being compressed, or waiting to be written.
+        public: class Chunk
+        {
+          /// \brief The <chunk> element, while it's being compressed.
+          public: std::future<std::string> future;
+
+          /// \brief The <chunk> element, once compressed.
+          public: std::string data;
+
+          /// \brief True once the chunk is compressed.
+          public: bool ready = false;
+
+          /// \brief Entry of the chunk in the log's index.
+          public: std::string entry;
+
+          /// \brief Bytes held by the chunk: its uncompressed size while
+          /// it's being compressed, then the size of data.
+          public: std::size_t bytes = 0;
+
+          /// \brief True if the log can be played without the chunk.
+          public: bool droppable = false;
+        };
+
         /// \brief Constructor
         /// \param[in] _parent Pointer to the LogRecord parent.
+        /// \param[in] _owner Private data of the parent.
         /// \param[in] _relativeFilename The name of the log file to
         /// generate, sans the complete path.
         /// \param[in] _logCB Callback function, which is used to get log
         /// data.
-        public: Log(LogRecord *_parent, const std::string &_relativeFilename,
+        public: Log(LogRecord *_parent, LogRecordPrivate *_owner,
+                    const std::string &_relativeFilename,
                     std::function<bool (std::ostringstream &)> _logCB);
 
         /// \brief Destructor
@@ -61,18 +151,43 @@ namespace gazebo
         /// \brief Stop logging.
         public: void Stop();
 
-        /// \brief Write data to disk.
-        public: void Write();
-
-        /// \brief Update the data buffer.
-        /// \return The size of the data buffer.
+        /// \brief Take the data to write to disk: the buffer, followed by
+        /// the compressed chunks in order. Called with writeMutex held.
+        /// \param[in] _wait True to wait for the chunks being compressed,
+        /// otherwise they're taken once compressed, by a later call.
+        /// \param[out] _data The data to write.
+        public: void TakeData(const bool _wait, std::string &_data);
+
+        /// \brief Write data to disk. Called with fileMutex held.
+        /// \param[in] _data Data from TakeData.
+        public: void WriteData(const std::string &_data);
+
+        /// \brief Update the data buffer, starting the compression of a
+        /// new chunk.
+        /// \return The size of the data buffer plus the number of chunks
+        /// being compressed, 0 if there's nothing to write.
         public: unsigned int Update();
 
+        /// \brief Get the compressed data of the chunks, in order.
+        /// \param[in] _wait True to wait for all of them, otherwise stop
+        /// at the first one still being compressed.
+        public: void CollectChunks(const bool _wait);
+
+        /// \brief Drop the oldest compressed chunk that can be dropped.
+        /// \return Number of bytes freed, 0 if no chunk was dropped.
+        public: std::size_t DropOldest();
+
         /// \brief Clear the data buffer.
         public: void ClearBuffer();
 
+        /// \brief Get the entry of a chunk in the index written at the end
+        /// of the log, with its simulation times and iterations.
+        /// \param[in] _data The chunk's data, before compression.
+        /// \return The <entry> element.
+        public: static std::string IndexEntry(const std::string &_data);
+
         /// \brief Get the byte size of the buffer.
-        /// \return Buffer byte size.
+        /// \return Buffer byte size, including the chunks not written yet.
         public: unsigned int BufferSize();
 
         /// \brief Get the relative filename. This is the filename passed
@@ -87,12 +202,34 @@ namespace gazebo
         /// \brief Pointer to the log record parent.
         public: LogRecord *parent;
 
+        /// \brief Private data of the parent.
+        public: LogRecordPrivate *owner;
+
         /// \brief Callback from which to get data.
         public: std::function<bool (std::ostringstream &)> logCB;
 
-        /// \brief Data buffer.
+        /// \brief Data buffer, written before the chunks.
         public: std::string buffer;
 
+        /// \brief Recorded topic messages, appended to the next chunk
+        /// after its states.
+        public: std::string messages;
+
+        /// \brief Chunks not written yet, oldest first.
+        public: std::deque<Chunk> chunks;
+
+        /// \brief Sum of the bytes of the chunks.
+        public: std::size_t chunkBytes = 0;
+
+        /// \brief Number of chunks recorded since the log started.
+        public: uint64_t chunkCount = 0;
+
+        /// \brief One <entry> element per chunk written, with the
+        /// simulation times of its first and last frames and the
+        /// iterations of its first frame. LogPlay uses it to find the chunk
+        /// of a time without decompressing the log.
+        public: std::string index;
+
         /// \brief The log file.
         public: std::ofstream logFile;
 
@@ -103,6 +240,35 @@ namespace gazebo
         public: boost::filesystem::path completePath;
       };
 
+      /// \brief Records the messages of a topic.
+      public: class TopicRecorder
+      {
+        /// \brief Store a message with the current simulation time.
+        /// \param[in] _data The serialized message.
+        public: void OnMessage(const std::string &_data);
+
+        /// \brief The private data of the recorder.
+        public: LogRecordPrivate *owner = nullptr;
+
+        /// \brief Name of the topic, fully qualified once subscribed.
+        public: std::string topic;
+
+        /// \brief Message type of the topic, empty until it's known.
+        public: std::string type;
+
+        /// \brief Subscriber to the topic.
+        public: transport::SubscriberPtr subscriber;
+
+        /// \brief Messages not logged yet, with their simulation times.
+        /// Protected by LogRecordPrivate::messageMutex.
+        public: std::vector<std::pair<common::Time, std::string>> messages;
+      };
+
+      /// \brief Format the messages stored by the topic recorders as
+      /// <message> elements, oldest first, and clear them.
+      /// \return The elements, empty if there are no messages.
+      public: std::string CollectMessages();
+
       /// \def Log_M
       /// \brief Map of names to logs.
       public: typedef std::map<std::string, Log*> Log_M;
@@ -212,11 +378,132 @@ namespace gazebo
       /// \brief Record with model resources.
       public: bool recordResources = false;
 
+      /// \brief Record world states as binary messages.
+      public: bool binaryStates = false;
+
+      /// \brief True to write compressed chunks as raw bytes.
+      public: bool binaryChunks = false;
+
+      /// \brief Simulation time between keyframes, in seconds.
+      public: double keyframePeriod = 0;
+
+      /// \brief Topics whose messages are recorded.
+      public: std::vector<std::string> topics;
+
+      /// \brief One recorder per topic, while logging.
+      public: std::vector<std::unique_ptr<TopicRecorder>> topicRecorders;
+
+      /// \brief Protects the messages of the recorders, messageBytes and
+      /// simTime.
+      public: std::mutex messageMutex;
+
+      /// \brief Bytes of the messages stored by the recorders.
+      public: std::size_t messageBytes = 0;
+
+      /// \brief True once messages were dropped for lack of room.
+      public: bool messagesDropped = false;
+
+      /// \brief Simulation time of the current world update.
+      public: common::Time simTime;
+
+      /// \brief Connection to the world update begin event, to track the
+      /// simulation time while recording topics.
+      public: event::ConnectionPtr worldUpdateConnection;
+
+      /// \brief Largest number of bytes of log data not written yet, 0 for
+      /// no limit.
+      public: std::size_t bufferLimit = 0;
+
+      /// \brief What to do when bufferLimit is reached.
+      public: LogBufferPolicy bufferPolicy = LogBufferPolicy::BLOCK;
+
+      /// \brief Protects the files of the logs. It's locked before
+      /// writeMutex, and held while writing, so that updates aren't held up
+      /// by a slow disk.
+      public: std::mutex fileMutex;
+
+      /// \brief Bytes of the chunks of all the logs and of the data being
+      /// written.
+      public: std::atomic<std::size_t> bytesInFlight {0};
+
+      /// \brief Bytes of the log buffers and of the playback chunks, in
+      /// the "log" subsystem of the common::MemoryTracker.
+      public: std::atomic<int64_t> *memory = nullptr;
+
+      /// \brief Bytes being written to disk.
+      public: std::atomic<std::size_t> bytesWriting {0};
+
+      /// \brief Number of chunks of all the logs not written yet.
+      public: std::atomic<unsigned int> queueDepth {0};
+
+      /// \brief Number of chunks dropped since recording started.
+      public: std::atomic<uint64_t> droppedChunks {0};
+
+      /// \brief The recording period is doubled this number of times.
+      public: std::atomic<unsigned int> degradeLevel {0};
+
+      /// \brief Mutex of roomCondition.
+      public: std::mutex roomMutex;
+
+      /// \brief Notified when data was written to disk.
+      public: std::condition_variable roomCondition;
+
+      /// \brief Latencies of chunk compressions.
+      public: LatencyHistogram compressionLatency;
+
+      /// \brief Latencies of writes to disk.
+      public: LatencyHistogram writeLatency;
+
+      /// \brief Sum the bytes and chunks of all the logs into
+      /// bytesInFlight and queueDepth. Called with writeMutex held.
+      public: void CountInFlight();
+
       /// \brief List of saved models if record with resources is enabled.
       public: std::set<std::string> savedModels;
 
       /// \brief List of saved files if record with resources is enabled.
       public: std::set<std::string> savedFiles;
+
+      /// \brief A model directory or file to save in the log directory.
+      public: class ResourceCopy
+      {
+        /// \brief The directory or file.
+        public: boost::filesystem::path source;
+
+        /// \brief Path in the log directory.
+        public: boost::filesystem::path destination;
+      };
+
+      /// \brief Copy a resource into the log directory.
+      /// \param[in] _copy The resource.
+      /// \return True on success.
+      public: bool Save(const ResourceCopy &_copy);
+
+      /// \brief Queue a resource for resourceThread, or save it right away
+      /// if the thread isn't running.
+      /// \param[in] _copy The resource.
+      public: void Queue(const ResourceCopy &_copy);
+
+      /// \brief Directory of the store of resources, empty to copy the
+      /// resources into each log.
+      public: std::string resourceStorePath;
+
+      /// \brief Store of resources, while recording to one.
+      public: std::unique_ptr<LogResourceStore> resourceStore;
+
+      /// \brief Resources waiting to be saved, oldest first.
+      public: std::deque<ResourceCopy> resourceCopies;
+
+      /// \brief Protects resourceCopies.
+      public: std::mutex resourceMutex;
+
+      /// \brief Notified when resources are queued, and when recording
+      /// stops.
+      public: std::condition_variable resourceCondition;
+
+      /// \brief Thread used to save resources, so that large meshes don't
+      /// hold up the recording.
+      public: std::unique_ptr<std::thread> resourceThread;
     };
     /// \}
   }
@@ -16,6 +16,8 @@
 */
 #include <gtest/gtest.h>
 #include <boost/filesystem.hpp>
+#include <string>
+#include <vector>
 
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Console.hh"
@@ -73,6 +75,9 @@ TEST_F(LogRecord_TEST, StartErrors)
   {
     EXPECT_TRUE(recorder->Init("test"));
     EXPECT_THROW(recorder->Start("garbage"), gazebo::common::Exception);
+    EXPECT_THROW(recorder->Start("bz2:9"), gazebo::common::Exception);
+    EXPECT_THROW(recorder->Start("zstd:0"), gazebo::common::Exception);
+    EXPECT_THROW(recorder->Start("zstd:fast"), gazebo::common::Exception);
   }
 
   // Double start
@@ -224,6 +229,63 @@ TEST_F(LogRecord_TEST, RecordResources)
 
   recorder->SetRecordResources(false);
   EXPECT_FALSE(recorder->RecordResources());
+
+  // resources are copied into each log by default
+  EXPECT_TRUE(recorder->ResourceStore().empty());
+
+  recorder->SetResourceStore("/tmp/gazebo_resources");
+  EXPECT_EQ(recorder->ResourceStore(), "/tmp/gazebo_resources");
+
+  recorder->SetResourceStore("");
+  EXPECT_TRUE(recorder->ResourceStore().empty());
+}
+
+/////////////////////////////////////////////////
+/// \brief Test LogRecord recorded topics
+TEST_F(LogRecord_TEST, Topics)
+{
+  gazebo::util::LogRecord *recorder = gazebo::util::LogRecord::Instance();
+
+  // check default values
+  EXPECT_TRUE(recorder->Topics().empty());
+
+  std::vector<std::string> topics = {"~/camera/link/camera/image",
+    "/gazebo/default/hokuyo/link/laser/scan"};
+  recorder->SetTopics(topics);
+  EXPECT_EQ(recorder->Topics(), topics);
+
+  recorder->SetTopics(std::vector<std::string>());
+  EXPECT_TRUE(recorder->Topics().empty());
+}
+
+/////////////////////////////////////////////////
+/// \brief Test LogRecord buffer limit and policy
+TEST_F(LogRecord_TEST, Buffer)
+{
+  gazebo::util::LogRecord *recorder = gazebo::util::LogRecord::Instance();
+
+  // check default values
+  EXPECT_EQ(recorder->BufferLimit(), 0u);
+  EXPECT_EQ(recorder->BufferPolicy(), gazebo::util::LogBufferPolicy::BLOCK);
+  EXPECT_EQ(recorder->DroppedChunks(), 0u);
+
+  recorder->SetBufferLimit(1000000);
+  EXPECT_EQ(recorder->BufferLimit(), 1000000u);
+
+  recorder->SetBufferPolicy(gazebo::util::LogBufferPolicy::DEGRADE_PERIOD);
+  EXPECT_EQ(recorder->BufferPolicy(),
+      gazebo::util::LogBufferPolicy::DEGRADE_PERIOD);
+
+  // The period isn't degraded while the buffer has room
+  recorder->SetPeriod(0.02);
+  EXPECT_DOUBLE_EQ(recorder->EffectivePeriod(), 0.02);
+
+  // There's always room when not recording
+  EXPECT_TRUE(recorder->WaitForRoom(gazebo::common::Time(0, 1000)));
+
+  recorder->SetBufferLimit(0);
+  recorder->SetBufferPolicy(gazebo::util::LogBufferPolicy::BLOCK);
+  recorder->SetPeriod(-1);
 }
 
 /////////////////////////////////////////////////
@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "gazebo/common/CommonIface.hh"
+#include "gazebo/common/Console.hh"
+#include "gazebo/util/LogResourceStorePrivate.hh"
+#include "gazebo/util/LogResourceStore.hh"
+
+using namespace gazebo;
+using namespace util;
+
+namespace fs = boost::filesystem;
+
+//////////////////////////////////////////////////
+LogResourceStore::LogResourceStore(const std::string &_root)
+  : dataPtr(new LogResourceStorePrivate)
+{
+  this->dataPtr->root = _root;
+
+  boost::system::error_code errorCode;
+  fs::create_directories(this->dataPtr->root / "objects", errorCode);
+  if (errorCode)
+  {
+    gzerr << "Unable to create the log resource store["
+          << this->dataPtr->root.string() << "]: " << errorCode.message()
+          << "\n";
+  }
+}
+
+//////////////////////////////////////////////////
+LogResourceStore::~LogResourceStore()
+{
+}
+
+//////////////////////////////////////////////////
+std::string LogResourceStore::Root() const
+{
+  return this->dataPtr->root.string();
+}
+
+//////////////////////////////////////////////////
+std::string LogResourceStore::ObjectPath(const std::string &_hash) const
+{
+  return (this->dataPtr->root / "objects" / _hash.substr(0, 2) /
+      _hash).string();
+}
+
+//////////////////////////////////////////////////
+bool LogResourceStore::Add(const std::string &_source,
+    const std::string &_destination)
+{
+  const fs::path source(_source);
+  const fs::path destination(_destination);
+
+  boost::system::error_code errorCode;
+  if (!fs::is_directory(source, errorCode))
+  {
+    fs::create_directories(destination.parent_path(), errorCode);
+    return this->dataPtr->AddFile(source, destination);
+  }
+
+  // Mirror the directory, with links in place of its files
+  fs::remove_all(destination, errorCode);
+  fs::create_directories(destination, errorCode);
+  if (errorCode)
+  {
+    gzerr << "Unable to create directory[" << destination.string() << "]: "
+          << errorCode.message() << "\n";
+    return false;
+  }
+
+  bool result = true;
+  for (fs::directory_iterator iter(source, errorCode), end;
+       !errorCode && iter != end; iter.increment(errorCode))
+  {
+    if (!this->Add(iter->path().string(),
+          (destination / iter->path().filename()).string()))
+    {
+      result = false;
+    }
+  }
+
+  if (errorCode)
+  {
+    gzerr << "Unable to read directory[" << source.string() << "]: "
+          << errorCode.message() << "\n";
+    return false;
+  }
+
+  return result;
+}
+
+//////////////////////////////////////////////////
+std::size_t LogResourceStore::Prune()
+{
+  // The store's own link is the last one of an unused file
+  std::vector<fs::path> unused;
+  boost::system::error_code errorCode;
+  for (fs::recursive_directory_iterator iter(
+         this->dataPtr->root / "objects", errorCode), end;
+       !errorCode && iter != end; iter.increment(errorCode))
+  {
+    boost::system::error_code linkError;
+    if (fs::is_regular_file(iter->path(), linkError) &&
+        fs::hard_link_count(iter->path(), linkError) == 1 && !linkError)
+    {
+      unused.push_back(iter->path());
+    }
+  }
+
+  std::size_t count = 0;
+  for (auto const &path : unused)
+  {
+    if (fs::remove(path, errorCode))
+      ++count;
+  }
+  return count;
+}
+
+//////////////////////////////////////////////////
+uint64_t LogResourceStore::StoredCount() const
+{
+  return this->dataPtr->stored;
+}
+
+//////////////////////////////////////////////////
+uint64_t LogResourceStore::ReusedCount() const
+{
+  return this->dataPtr->reused;
+}
+
+//////////////////////////////////////////////////
+bool LogResourceStorePrivate::Hash(const fs::path &_path, std::string &_hash)
+{
+  boost::system::error_code errorCode;
+  const uintmax_t size = fs::file_size(_path, errorCode);
+  const std::time_t writeTime = fs::last_write_time(_path, errorCode);
+  if (errorCode)
+    return false;
+
+  const std::string key = _path.string();
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto iter = this->hashes.find(key);
+    if (iter != this->hashes.end() && iter->second.size == size &&
+        iter->second.writeTime == writeTime)
+    {
+      _hash = iter->second.hash;
+      return true;
+    }
+  }
+
+  std::ifstream file(key, std::ios::binary);
+  if (!file)
+    return false;
+  const std::vector<char> contents((std::istreambuf_iterator<char>(file)),
+      std::istreambuf_iterator<char>());
+  if (file.bad())
+    return false;
+  _hash = common::get_sha1<std::vector<char>>(contents);
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  CachedHash &cached = this->hashes[key];
+  cached.size = size;
+  cached.writeTime = writeTime;
+  cached.hash = _hash;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool LogResourceStorePrivate::AddFile(const fs::path &_source,
+    const fs::path &_destination)
+{
+  std::string hash;
+  if (!this->Hash(_source, hash))
+  {
+    gzerr << "Unable to read file[" << _source.string() << "]\n";
+    return false;
+  }
+
+  const fs::path object = this->root / "objects" / hash.substr(0, 2) / hash;
+  boost::system::error_code errorCode;
+  if (fs::exists(object, errorCode))
+  {
+    ++this->reused;
+  }
+  else
+  {
+    // Copy under a temporary name first, so that other processes sharing
+    // the store never link a partial file
+    fs::create_directories(object.parent_path(), errorCode);
+    const fs::path tmp = object.parent_path() /
+      fs::unique_path(hash + ".%%%%-%%%%.tmp");
+    fs::copy_file(_source, tmp, errorCode);
+    if (!errorCode)
+      fs::rename(tmp, object, errorCode);
+    if (errorCode)
+    {
+      gzerr << "Unable to store file[" << _source.string() << "] as ["
+            << object.string() << "]: " << errorCode.message() << "\n";
+      fs::remove(tmp, errorCode);
+      return false;
+    }
+    ++this->stored;
+  }
+
+  fs::remove(_destination, errorCode);
+  fs::create_hard_link(object, _destination, errorCode);
+  if (!errorCode)
+    return true;
+
+  if (!this->copyWarned.exchange(true))
+  {
+    gzwarn << "Unable to link log resources from the store["
+           << this->root.string() << "] (" << errorCode.message()
+           << "), copying them instead. Keep the store on the file system "
+           << "of the logs to avoid this.\n";
+  }
+
+  fs::copy_file(object, _destination, errorCode);
+  if (errorCode)
+  {
+    gzerr << "Unable to copy file[" << object.string() << "] to ["
+          << _destination.string() << "]: " << errorCode.message() << "\n";
+    return false;
+  }
+  return true;
+}
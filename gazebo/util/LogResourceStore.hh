@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef _GAZEBO_UTIL_LOGRESOURCESTORE_HH_
+#define _GAZEBO_UTIL_LOGRESOURCESTORE_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace util
+  {
+    // Forward declare private data class
+    class LogResourceStorePrivate;
+
+    /// addtogroup gazebo_util
+    /// \{
+
+    /// \class LogResourceStore LogResourceStore.hh util/util.hh
+    /// \brief Content-addressed store of the resources of recorded logs,
+    /// shared by all the logs.
+    ///
+    /// Each file is stored once, under the SHA-1 hash of its contents, in
+    /// the objects directory of the store. Logs reference the stored file
+    /// through a hard link, so a log directory is laid out as if the file
+    /// was copied into it, and can be played or moved on its own. Where
+    /// hard links aren't supported, such as across file systems, the file
+    /// is copied instead.
+    ///
+    /// Objects no longer linked from any log are removed by Prune.
+    class GZ_UTIL_VISIBLE LogResourceStore
+    {
+      /// \brief Constructor.
+      /// \param[in] _root Directory of the store. It's created if needed.
+      public: explicit LogResourceStore(const std::string &_root);
+
+      /// \brief Destructor.
+      public: ~LogResourceStore();
+
+      /// \brief Get the directory of the store.
+      /// \return Directory of the store.
+      public: std::string Root() const;
+
+      /// \brief Add a file, or all the files of a directory, to the store,
+      /// and link them at a destination. An existing destination is
+      /// replaced. This function may be called from several threads.
+      /// \param[in] _source File or directory to add.
+      /// \param[in] _destination Path of the file or directory in a log.
+      /// \return True if every file was added and linked.
+      public: bool Add(const std::string &_source,
+                  const std::string &_destination);
+
+      /// \brief Get the path of the stored copy of a file.
+      /// \param[in] _hash SHA-1 hash of the contents of the file, as
+      /// returned by common::get_sha1.
+      /// \return Path of the stored file, which may not exist.
+      public: std::string ObjectPath(const std::string &_hash) const;
+
+      /// \brief Remove the stored files which no log links to anymore.
+      /// \return Number of files removed.
+      public: std::size_t Prune();
+
+      /// \brief Get the number of files stored by this object, which were
+      /// not in the store yet.
+      /// \return Number of new files.
+      public: uint64_t StoredCount() const;
+
+      /// \brief Get the number of files added by this object, which were
+      /// already in the store.
+      /// \return Number of reused files.
+      public: uint64_t ReusedCount() const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<LogResourceStorePrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
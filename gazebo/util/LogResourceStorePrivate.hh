@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef _GAZEBO_UTIL_LOGRESOURCESTOREPRIVATE_HH_
+#define _GAZEBO_UTIL_LOGRESOURCESTOREPRIVATE_HH_
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <string>
+#include <boost/filesystem.hpp>
+
+namespace gazebo
+{
+  namespace util
+  {
+    /// \internal
+    /// \brief Private data for the LogResourceStore class
+    class LogResourceStorePrivate
+    {
+      /// \brief Get the hash of the contents of a file, from the cache if
+      /// the file didn't change since it was hashed.
+      /// \param[in] _path Path of the file.
+      /// \param[out] _hash The hash.
+      /// \return False if the file couldn't be read.
+      public: bool Hash(const boost::filesystem::path &_path,
+                  std::string &_hash);
+
+      /// \brief Add a file to the store, and link it at a destination.
+      /// \param[in] _source The file.
+      /// \param[in] _destination Path of the link.
+      /// \return True on success.
+      public: bool AddFile(const boost::filesystem::path &_source,
+                  const boost::filesystem::path &_destination);
+
+      /// \brief Hash of a file, with the state of the file when it was
+      /// hashed.
+      public: class CachedHash
+      {
+        /// \brief Size of the file, in bytes.
+        public: uintmax_t size = 0;
+
+        /// \brief Last write time of the file.
+        public: std::time_t writeTime = 0;
+
+        /// \brief SHA-1 hash of the contents of the file.
+        public: std::string hash;
+      };
+
+      /// \brief Directory of the store.
+      public: boost::filesystem::path root;
+
+      /// \brief Protects hashes.
+      public: std::mutex mutex;
+
+      /// \brief Hashes of the files added, by path, so that files added to
+      /// every log are only read once.
+      public: std::map<std::string, CachedHash> hashes;
+
+      /// \brief Number of files stored, which were not in the store yet.
+      public: std::atomic<uint64_t> stored {0};
+
+      /// \brief Number of files added, which were already in the store.
+      public: std::atomic<uint64_t> reused {0};
+
+      /// \brief True once the lack of hard links was reported.
+      public: std::atomic<bool> copyWarned {false};
+    };
+  }
+}
+#endif
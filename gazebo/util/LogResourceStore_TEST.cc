@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <gtest/gtest.h>
+#include <fstream>
+#include <string>
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/CommonIface.hh"
+#include "gazebo/util/LogResourceStore.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class LogResourceStore_TEST : public gazebo::testing::AutoLogFixture { };
+
+/// \brief Write a file.
+/// \param[in] _path Path of the file.
+/// \param[in] _contents Contents of the file.
+static void WriteFile(const boost::filesystem::path &_path,
+    const std::string &_contents)
+{
+  boost::filesystem::create_directories(_path.parent_path());
+  std::ofstream file(_path.string(), std::ios::binary);
+  file << _contents;
+}
+
+/// \brief Read a file.
+/// \param[in] _path Path of the file.
+/// \return Contents of the file.
+static std::string ReadFile(const boost::filesystem::path &_path)
+{
+  std::ifstream file(_path.string(), std::ios::binary);
+  return std::string((std::istreambuf_iterator<char>(file)),
+      std::istreambuf_iterator<char>());
+}
+
+/////////////////////////////////////////////////
+#ifndef _WIN32
+TEST_F(LogResourceStore_TEST, Add)
+{
+  namespace fs = boost::filesystem;
+  const fs::path tmp = fs::temp_directory_path() /
+    fs::unique_path("gazebo-LogResourceStore-%%%%-%%%%");
+
+  // A model, with two identical meshes
+  const fs::path model = tmp / "models" / "box";
+  WriteFile(model / "model.config", "config");
+  WriteFile(model / "meshes" / "a.dae", "mesh");
+  WriteFile(model / "meshes" / "b.dae", "mesh");
+
+  util::LogResourceStore store((tmp / "store").string());
+  EXPECT_EQ((tmp / "store").string(), store.Root());
+
+  // Record the model in two logs
+  const fs::path log1 = tmp / "log1" / "box";
+  const fs::path log2 = tmp / "log2" / "box";
+  EXPECT_TRUE(store.Add(model.string(), log1.string()));
+  EXPECT_EQ(2u, store.StoredCount());
+  EXPECT_EQ(1u, store.ReusedCount());
+  EXPECT_TRUE(store.Add(model.string(), log2.string()));
+  EXPECT_EQ(2u, store.StoredCount());
+  EXPECT_EQ(4u, store.ReusedCount());
+
+  // The logs are laid out like copies
+  EXPECT_EQ("config", ReadFile(log1 / "model.config"));
+  EXPECT_EQ("mesh", ReadFile(log1 / "meshes" / "a.dae"));
+  EXPECT_EQ("mesh", ReadFile(log2 / "meshes" / "b.dae"));
+
+  // Each file of the logs links to the stored file
+  const fs::path object = store.ObjectPath(common::get_sha1(
+        std::string("mesh")));
+  EXPECT_EQ("mesh", ReadFile(object));
+  EXPECT_EQ(5u, fs::hard_link_count(object));
+
+  // A single file
+  EXPECT_TRUE(store.Add((model / "model.config").string(),
+        (tmp / "log3" / "files" / "model.config").string()));
+  EXPECT_EQ("config", ReadFile(tmp / "log3" / "files" / "model.config"));
+  EXPECT_FALSE(store.Add((model / "missing").string(),
+        (tmp / "log3" / "missing").string()));
+
+  // Changed files are hashed again
+  WriteFile(model / "model.config", "new config");
+  EXPECT_TRUE(store.Add(model.string(), log2.string()));
+  EXPECT_EQ("new config", ReadFile(log2 / "model.config"));
+  EXPECT_EQ(3u, store.StoredCount());
+
+  // Only the objects of deleted logs are pruned
+  EXPECT_EQ(0u, store.Prune());
+  fs::remove_all(tmp / "log1");
+  fs::remove_all(tmp / "log3");
+  EXPECT_EQ(1u, store.Prune());
+  EXPECT_FALSE(fs::exists(store.ObjectPath(common::get_sha1(
+          std::string("config")))));
+  EXPECT_TRUE(fs::exists(object));
+
+  fs::remove_all(tmp);
+}
+#endif
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
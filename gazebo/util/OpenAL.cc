@@ -20,6 +20,9 @@
   #include <iostream>
 #endif
 
+#include <algorithm>
+#include <cmath>
+
 #include <gazebo/gazebo_config.h>
 
 #ifdef HAVE_OPENAL
@@ -45,6 +48,157 @@ using namespace gazebo;
 using namespace util;
 
 #ifdef HAVE_OPENAL
+/// \brief Attenuated gain below which a source without a maximum distance
+/// is culled, -60 dB.
+static const double kMinAudibleGain = 1e-3;
+
+/////////////////////////////////////////////////
+/// \brief Get the playback position of a source from its state.
+/// \param[in] _src The source.
+/// \param[in] _now The current time.
+/// \return The position in the buffer, in seconds.
+static double PlaybackOffset(const OpenALSourcePrivate &_src,
+    const std::chrono::steady_clock::time_point &_now)
+{
+  if (_src.state != OpenALSourcePrivate::PLAYING)
+    return _src.offset;
+
+  if (_src.duration <= 0)
+    return 0;
+
+  double t = _src.offset + _src.pitch *
+    std::chrono::duration<double>(_now - _src.startTime).count();
+
+  return _src.loop ? std::fmod(t, _src.duration) : std::min(t, _src.duration);
+}
+
+/////////////////////////////////////////////////
+/// \brief Stop a source that played to the end of its buffer.
+/// \param[in] _src The source, which has no voice.
+/// \param[in] _now The current time.
+static void UpdateState(OpenALSourcePrivate &_src,
+    const std::chrono::steady_clock::time_point &_now)
+{
+  if (_src.state == OpenALSourcePrivate::PLAYING && !_src.loop &&
+      PlaybackOffset(_src, _now) >= _src.duration)
+  {
+    _src.state = OpenALSourcePrivate::STOPPED;
+    _src.offset = 0;
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Restart the playback clock of a source at its current position,
+/// before its pitch or looping changes.
+/// \param[in] _src The source.
+/// \param[in] _now The current time.
+static void Rebase(OpenALSourcePrivate &_src,
+    const std::chrono::steady_clock::time_point &_now)
+{
+  if (_src.state == OpenALSourcePrivate::PLAYING)
+  {
+    _src.offset = PlaybackOffset(_src, _now);
+    _src.startTime = _now;
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Give an OpenAL source to a source, and resume its playback.
+/// \param[in] _al The server, whose mutex is locked.
+/// \param[in] _src The source.
+/// \param[in] _now The current time.
+/// \return False if all the OpenAL sources are used.
+static bool AcquireVoice(OpenALPrivate &_al, OpenALSourcePrivate &_src,
+    const std::chrono::steady_clock::time_point &_now)
+{
+  if (_src.hasVoice)
+    return true;
+
+  if (!_al.context)
+    return false;
+
+  ALuint voice;
+  if (!_al.freeVoices.empty())
+  {
+    voice = _al.freeVoices.back();
+    _al.freeVoices.pop_back();
+  }
+  else if (_al.voiceCount < _al.maxVoices)
+  {
+    // Clear error state
+    alGetError();
+
+    alGenSources(1, &voice);
+    if (alGetError() != AL_NO_ERROR)
+    {
+      // The device has fewer sources than expected
+      _al.maxVoices = _al.voiceCount;
+      return false;
+    }
+    ++_al.voiceCount;
+  }
+  else
+    return false;
+
+  _src.alSource = voice;
+  _src.hasVoice = true;
+
+  alSourcei(voice, AL_BUFFER, _src.alBuffer);
+  alSourcef(voice, AL_PITCH, _src.pitch);
+  alSourcef(voice, AL_GAIN, _src.gain);
+  alSourcei(voice, AL_LOOPING, _src.loop);
+  alSource3f(voice, AL_POSITION, _src.pose.Pos().X(), _src.pose.Pos().Y(),
+      _src.pose.Pos().Z());
+  alSource3f(voice, AL_VELOCITY, _src.velocity.X(), _src.velocity.Y(),
+      _src.velocity.Z());
+  _src.dirty = false;
+
+  if (_src.state == OpenALSourcePrivate::PLAYING)
+  {
+    alSourcef(voice, AL_SEC_OFFSET, PlaybackOffset(_src, _now));
+    alSourcePlay(voice);
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+/// \brief Take the OpenAL source of a source back, the source keeps playing
+/// virtually.
+/// \param[in] _al The server, whose mutex is locked.
+/// \param[in] _src The source.
+/// \param[in] _now The current time.
+static void ReleaseVoice(OpenALPrivate &_al, OpenALSourcePrivate &_src,
+    const std::chrono::steady_clock::time_point &_now)
+{
+  if (!_src.hasVoice)
+    return;
+
+  if (_src.state != OpenALSourcePrivate::STOPPED)
+  {
+    // Resume from where OpenAL is
+    ALint sourceState;
+    ALfloat offset;
+    alGetSourcei(_src.alSource, AL_SOURCE_STATE, &sourceState);
+    alGetSourcef(_src.alSource, AL_SEC_OFFSET, &offset);
+    if (sourceState == AL_PLAYING || sourceState == AL_PAUSED)
+    {
+      _src.offset = offset;
+      _src.startTime = _now;
+    }
+    else
+    {
+      _src.state = OpenALSourcePrivate::STOPPED;
+      _src.offset = 0;
+    }
+  }
+
+  alSourceStop(_src.alSource);
+  alSourcei(_src.alSource, AL_BUFFER, 0);
+  _al.freeVoices.push_back(_src.alSource);
+  _src.hasVoice = false;
+}
+
 /////////////////////////////////////////////////
 OpenAL::OpenAL()
 : dataPtr(new OpenALPrivate)
@@ -103,12 +257,67 @@ bool OpenAL::Load(sdf::ElementPtr _sdf)
 
   alDistanceModel(AL_EXPONENT_DISTANCE);
 
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
+
+  this->dataPtr->maxVoices = 64;
+  if (_sdf && _sdf->HasElement("gz:max_voices"))
+  {
+    int maxVoices = _sdf->Get<int>("gz:max_voices");
+    if (maxVoices > 0)
+      this->dataPtr->maxVoices = maxVoices;
+    else
+      gzwarn << "<gz:max_voices> must be positive, using "
+        << this->dataPtr->maxVoices << "\n";
+  }
+
+  // Keep within the sources the device can mix
+  ALCint monoSources = 0;
+  alcGetIntegerv(this->dataPtr->audioDevice, ALC_MONO_SOURCES, 1,
+      &monoSources);
+  if (monoSources > 0 &&
+      static_cast<unsigned int>(monoSources) < this->dataPtr->maxVoices)
+  {
+    this->dataPtr->maxVoices = monoSources;
+  }
+
+  this->dataPtr->updatePeriod = std::chrono::milliseconds(20);
+  if (_sdf && _sdf->HasElement("gz:update_rate"))
+  {
+    double rate = _sdf->Get<double>("gz:update_rate");
+    if (rate > 0)
+    {
+      this->dataPtr->updatePeriod =
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(1.0 / rate));
+    }
+    else
+      gzwarn << "<gz:update_rate> must be positive, using 50 Hz\n";
+  }
+
   return true;
 }
 
 /////////////////////////////////////////////////
 void OpenAL::Fini()
 {
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
+
+  // The sources outlive the context without their voices
+  if (this->dataPtr->context)
+  {
+    auto now = std::chrono::steady_clock::now();
+    for (auto source : this->dataPtr->sources)
+      ReleaseVoice(*this->dataPtr, *source->dataPtr, now);
+
+    if (!this->dataPtr->freeVoices.empty())
+    {
+      alDeleteSources(this->dataPtr->freeVoices.size(),
+          this->dataPtr->freeVoices.data());
+    }
+  }
+  this->dataPtr->freeVoices.clear();
+  this->dataPtr->voiceCount = 0;
+
   if (this->dataPtr->audioDevice)
   {
     alcCloseDevice(this->dataPtr->audioDevice);
@@ -169,6 +378,120 @@ OpenALSourcePtr OpenAL::CreateSource(sdf::ElementPtr _sdf)
   return source;
 }
 
+/////////////////////////////////////////////////
+void OpenAL::Update()
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
+
+  if (!this->dataPtr->context)
+    return;
+
+  auto now = std::chrono::steady_clock::now();
+  if (now - this->dataPtr->lastUpdate < this->dataPtr->updatePeriod)
+    return;
+  this->dataPtr->lastUpdate = now;
+
+  ALfloat x, y, z;
+  alGetListener3f(AL_POSITION, &x, &y, &z);
+  const ignition::math::Vector3d listener(x, y, z);
+
+  // The playing sources close enough to be heard, with their attenuated
+  // gain
+  std::vector<std::pair<double, OpenALSourcePrivate *>> audible;
+  for (auto source : this->dataPtr->sources)
+  {
+    OpenALSourcePrivate &src = *source->dataPtr;
+
+    if (src.hasVoice)
+    {
+      // OpenAL stops the sources at the end of their buffer
+      ALint sourceState;
+      alGetSourcei(src.alSource, AL_SOURCE_STATE, &sourceState);
+      if (src.state == OpenALSourcePrivate::PLAYING &&
+          sourceState != AL_PLAYING)
+      {
+        src.state = OpenALSourcePrivate::STOPPED;
+        src.offset = 0;
+      }
+    }
+    else
+      UpdateState(src, now);
+
+    if (src.state != OpenALSourcePrivate::PLAYING)
+    {
+      ReleaseVoice(*this->dataPtr, src, now);
+      continue;
+    }
+
+    // Exponent distance model with the default reference distance and
+    // rolloff factor
+    double distance = (src.pose.Pos() - listener).Length();
+    double gain = src.gain / std::max(distance, 1.0);
+    if ((src.maxDistance > 0 && distance > src.maxDistance) ||
+        (src.maxDistance <= 0 && gain < kMinAudibleGain))
+    {
+      ReleaseVoice(*this->dataPtr, src, now);
+      continue;
+    }
+
+    audible.push_back(std::make_pair(gain, &src));
+  }
+
+  // The sources of highest priority, then the loudest, get the voices
+  if (audible.size() > this->dataPtr->maxVoices)
+  {
+    std::nth_element(audible.begin(),
+        audible.begin() + this->dataPtr->maxVoices, audible.end(),
+        [](const std::pair<double, OpenALSourcePrivate *> &_a,
+           const std::pair<double, OpenALSourcePrivate *> &_b)
+        {
+          if (_a.second->priority != _b.second->priority)
+            return _a.second->priority > _b.second->priority;
+          return _a.first > _b.first;
+        });
+
+    for (auto it = audible.begin() + this->dataPtr->maxVoices;
+        it != audible.end(); ++it)
+    {
+      ReleaseVoice(*this->dataPtr, *it->second, now);
+    }
+    audible.resize(this->dataPtr->maxVoices);
+  }
+
+  for (auto &a : audible)
+    AcquireVoice(*this->dataPtr, *a.second, now);
+
+  // Send the poses in one batch
+  alcSuspendContext(this->dataPtr->context);
+  for (auto source : this->dataPtr->sources)
+  {
+    OpenALSourcePrivate &src = *source->dataPtr;
+    if (!src.hasVoice || !src.dirty)
+      continue;
+
+    alSource3f(src.alSource, AL_POSITION, src.pose.Pos().X(),
+        src.pose.Pos().Y(), src.pose.Pos().Z());
+    alSource3f(src.alSource, AL_VELOCITY, src.velocity.X(),
+        src.velocity.Y(), src.velocity.Z());
+    src.dirty = false;
+  }
+  alcProcessContext(this->dataPtr->context);
+}
+
+/////////////////////////////////////////////////
+unsigned int OpenAL::MaxVoices() const
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->maxVoices;
+}
+
+/////////////////////////////////////////////////
+unsigned int OpenAL::ActiveVoices() const
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->voiceCount - this->dataPtr->freeVoices.size();
+}
+
 /////////////////////////////////////////////////
 std::set<std::string> OpenAL::DeviceList() const
 {
@@ -269,17 +592,28 @@ bool OpenALSink::SetVelocity(const ignition::math::Vector3d &_vel)
 OpenALSource::OpenALSource()
 : dataPtr(new OpenALSourcePrivate)
 {
-  // Create 1 source
-  alGenSources(1, &this->dataPtr->alSource);
+  this->dataPtr->manager = OpenAL::Instance()->dataPtr.get();
 
-  // Create 1 buffer
+  // Create 1 buffer, the source gets an OpenAL source when it plays
   alGenBuffers(1, &this->dataPtr->alBuffer);
+
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->manager->mutex);
+  this->dataPtr->manager->sources.push_back(this);
 }
 
 /////////////////////////////////////////////////
 OpenALSource::~OpenALSource()
 {
-  alDeleteSources(1, &this->dataPtr->alSource);
+  {
+    std::lock_guard<std::recursive_mutex> lock(
+        this->dataPtr->manager->mutex);
+    auto &sources = this->dataPtr->manager->sources;
+    sources.erase(std::remove(sources.begin(), sources.end(), this),
+        sources.end());
+    ReleaseVoice(*this->dataPtr->manager, *this->dataPtr,
+        std::chrono::steady_clock::now());
+  }
+
   alDeleteBuffers(1, &this->dataPtr->alBuffer);
 }
 
@@ -305,6 +639,12 @@ bool OpenALSource::Load(sdf::ElementPtr _sdf)
   if (_sdf->HasElement("loop"))
     result = result && this->SetLoop(_sdf->Get<bool>("loop"));
 
+  if (_sdf->HasElement("gz:priority"))
+    this->SetPriority(_sdf->Get<double>("gz:priority"));
+
+  if (_sdf->HasElement("gz:max_distance"))
+    this->SetMaxDistance(_sdf->Get<double>("gz:max_distance"));
+
   if (_sdf->HasElement("contact"))
   {
     sdf::ElementPtr collisionElem =
@@ -328,20 +668,14 @@ bool OpenALSource::Load(sdf::ElementPtr _sdf)
 /////////////////////////////////////////////////
 bool OpenALSource::SetPose(const ignition::math::Pose3d &_pose)
 {
-  ALfloat p[3] = {static_cast<float>(_pose.Pos().X()),
-    static_cast<float>(_pose.Pos().Y()), static_cast<float>(_pose.Pos().Z())};
-  ALenum error;
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->manager->mutex);
 
-  // Clear error state
-  alGetError();
-
-  alSourcefv(this->dataPtr->alSource, AL_POSITION, p);
-
-  if ((error = alGetError()) != AL_NO_ERROR)
-  {
-    gzerr << " Unable to set position. Error code[" << error << "]\n";
+  // Called every step, audio may be disabled
+  if (!this->dataPtr->manager->context)
     return false;
-  }
+
+  this->dataPtr->pose = _pose;
+  this->dataPtr->dirty = true;
 
   return true;
 }
@@ -349,79 +683,149 @@ bool OpenALSource::SetPose(const ignition::math::Pose3d &_pose)
 /////////////////////////////////////////////////
 bool OpenALSource::SetVelocity(const ignition::math::Vector3d &_vel)
 {
-  ALenum error;
-  ALfloat v[3] = {static_cast<float>(_vel.X()),
-    static_cast<float>(_vel.Y()), static_cast<float>(_vel.Z())};
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->manager->mutex);
 
-  // Clear error state
-  alGetError();
-
-  alSourcefv(this->dataPtr->alSource, AL_VELOCITY, v);
-
-  if ((error = alGetError()) != AL_NO_ERROR)
-  {
-    gzerr << " Unable to set velocity. Error code[" << error << "]\n";
+  // Called every step, audio may be disabled
+  if (!this->dataPtr->manager->context)
     return false;
-  }
+
+  this->dataPtr->velocity = _vel;
+  this->dataPtr->dirty = true;
 
   return true;
 }
 
 /////////////////////////////////////////////////
-bool OpenALSource::SetPitch(float _pitch)
+void OpenALSource::SetPriority(double _priority)
 {
-  ALenum error;
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->manager->mutex);
+  this->dataPtr->priority = _priority;
+}
 
-  // clear error state
-  alGetError();
+/////////////////////////////////////////////////
+double OpenALSource::Priority() const
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->manager->mutex);
+  return this->dataPtr->priority;
+}
 
-  alSourcef(this->dataPtr->alSource, AL_PITCH, _pitch);
+/////////////////////////////////////////////////
+void OpenALSource::SetMaxDistance(double _distance)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->manager->mutex);
+  this->dataPtr->maxDistance = std::max(_distance, 0.0);
+}
 
-  if ((error = alGetError()) != AL_NO_ERROR)
+/////////////////////////////////////////////////
+double OpenALSource::MaxDistance() const
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->manager->mutex);
+  return this->dataPtr->maxDistance;
+}
+
+/////////////////////////////////////////////////
+bool OpenALSource::HasVoice() const
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->manager->mutex);
+  return this->dataPtr->hasVoice;
+}
+
+/////////////////////////////////////////////////
+bool OpenALSource::SetPitch(float _pitch)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->manager->mutex);
+
+  if (!this->dataPtr->manager->context || _pitch <= 0)
   {
-    gzerr << " Unable to set pitch. Error code[" << error << "]\n";
+    gzerr << " Unable to set pitch[" << _pitch << "]\n";
     return false;
   }
 
+  if (this->dataPtr->hasVoice)
+  {
+    ALenum error;
+
+    // clear error state
+    alGetError();
+
+    alSourcef(this->dataPtr->alSource, AL_PITCH, _pitch);
+
+    if ((error = alGetError()) != AL_NO_ERROR)
+    {
+      gzerr << " Unable to set pitch. Error code[" << error << "]\n";
+      return false;
+    }
+  }
+
+  Rebase(*this->dataPtr, std::chrono::steady_clock::now());
+  this->dataPtr->pitch = _pitch;
+
   return true;
 }
 
 /////////////////////////////////////////////////
 bool OpenALSource::SetGain(float _gain)
 {
-  ALenum error;
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->manager->mutex);
 
-  // clear error state
-  alGetError();
-
-  alSourcef(this->dataPtr->alSource, AL_GAIN, _gain);
-
-  if ((error = alGetError()) != AL_NO_ERROR)
+  if (!this->dataPtr->manager->context || _gain < 0)
   {
-    gzerr << " Unable to set gain. Error code[" << error << "]\n";
+    gzerr << " Unable to set gain[" << _gain << "]\n";
     return false;
   }
 
+  if (this->dataPtr->hasVoice)
+  {
+    ALenum error;
+
+    // clear error state
+    alGetError();
+
+    alSourcef(this->dataPtr->alSource, AL_GAIN, _gain);
+
+    if ((error = alGetError()) != AL_NO_ERROR)
+    {
+      gzerr << " Unable to set gain. Error code[" << error << "]\n";
+      return false;
+    }
+  }
+
+  this->dataPtr->gain = _gain;
+
   return true;
 }
 
 /////////////////////////////////////////////////
 bool OpenALSource::SetLoop(bool _state)
 {
-  ALenum error;
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->manager->mutex);
 
-  // clear error state
-  alGetError();
-
-  // Set looping state
-  alSourcei(this->dataPtr->alSource, AL_LOOPING, _state);
-
-  if ((error = alGetError()) != AL_NO_ERROR)
+  if (!this->dataPtr->manager->context)
   {
-    gzerr << " Unable to set loop. Error code[" << error << "]\n";
+    gzerr << " Unable to set loop, audio is disabled\n";
     return false;
   }
 
+  if (this->dataPtr->hasVoice)
+  {
+    ALenum error;
+
+    // clear error state
+    alGetError();
+
+    // Set looping state
+    alSourcei(this->dataPtr->alSource, AL_LOOPING, _state);
+
+    if ((error = alGetError()) != AL_NO_ERROR)
+    {
+      gzerr << " Unable to set loop. Error code[" << error << "]\n";
+      return false;
+    }
+  }
+
+  Rebase(*this->dataPtr, std::chrono::steady_clock::now());
+  this->dataPtr->loop = _state;
+
   return true;
 }
 
@@ -440,57 +844,129 @@ bool OpenALSource::OnContact() const
 /////////////////////////////////////////////////
 void OpenALSource::Play()
 {
-  int sourceState;
-  alGetSourcei(this->dataPtr->alSource, AL_SOURCE_STATE, &sourceState);
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->manager->mutex);
+  auto now = std::chrono::steady_clock::now();
 
-  // Play the source, if it's not already playing
-  if (sourceState != AL_PLAYING)
-    alSourcePlay(this->dataPtr->alSource);
+  if (this->dataPtr->hasVoice)
+  {
+    int sourceState;
+    alGetSourcei(this->dataPtr->alSource, AL_SOURCE_STATE, &sourceState);
+
+    // Play the source, if it's not already playing
+    if (sourceState != AL_PLAYING)
+    {
+      if (sourceState != AL_PAUSED)
+        this->dataPtr->offset = 0;
+      this->dataPtr->state = OpenALSourcePrivate::PLAYING;
+      this->dataPtr->startTime = now;
+      alSourcePlay(this->dataPtr->alSource);
+    }
+    return;
+  }
+
+  UpdateState(*this->dataPtr, now);
+  if (this->dataPtr->state == OpenALSourcePrivate::PLAYING)
+    return;
+
+  if (this->dataPtr->state == OpenALSourcePrivate::STOPPED)
+    this->dataPtr->offset = 0;
+  this->dataPtr->state = OpenALSourcePrivate::PLAYING;
+  this->dataPtr->startTime = now;
+
+  // Start right away if a voice is free, OpenAL::Update sorts the sources
+  // otherwise
+  AcquireVoice(*this->dataPtr->manager, *this->dataPtr, now);
 }
 
 /////////////////////////////////////////////////
 void OpenALSource::Pause()
 {
-  int sourceState;
-  alGetSourcei(this->dataPtr->alSource, AL_SOURCE_STATE, &sourceState);
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->manager->mutex);
+  auto now = std::chrono::steady_clock::now();
+
+  if (this->dataPtr->hasVoice)
+  {
+    int sourceState;
+    alGetSourcei(this->dataPtr->alSource, AL_SOURCE_STATE, &sourceState);
+
+    // Pause the source if it playing
+    if (sourceState == AL_PLAYING)
+    {
+      alSourcePause(this->dataPtr->alSource);
+
+      ALfloat offset;
+      alGetSourcef(this->dataPtr->alSource, AL_SEC_OFFSET, &offset);
+      this->dataPtr->offset = offset;
+      this->dataPtr->state = OpenALSourcePrivate::PAUSED;
+    }
+    return;
+  }
 
-  // Pause the source if it playing
-  if (sourceState == AL_PLAYING)
-    alSourcePause(this->dataPtr->alSource);
+  UpdateState(*this->dataPtr, now);
+  if (this->dataPtr->state == OpenALSourcePrivate::PLAYING)
+  {
+    this->dataPtr->offset = PlaybackOffset(*this->dataPtr, now);
+    this->dataPtr->state = OpenALSourcePrivate::PAUSED;
+  }
 }
 
 /////////////////////////////////////////////////
 void OpenALSource::Stop()
 {
-  int sourceState;
-  alGetSourcei(this->dataPtr->alSource, AL_SOURCE_STATE, &sourceState);
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->manager->mutex);
+
+  if (this->dataPtr->hasVoice)
+  {
+    int sourceState;
+    alGetSourcei(this->dataPtr->alSource, AL_SOURCE_STATE, &sourceState);
 
-  // Stop the source if it is not already stopped
-  if (sourceState != AL_STOPPED)
-    alSourceStop(this->dataPtr->alSource);
+    // Stop the source if it is not already stopped
+    if (sourceState != AL_STOPPED)
+      alSourceStop(this->dataPtr->alSource);
+  }
+
+  this->dataPtr->state = OpenALSourcePrivate::STOPPED;
+  this->dataPtr->offset = 0;
 }
 
 /////////////////////////////////////////////////
 void OpenALSource::Rewind()
 {
-  alSourceRewind(this->dataPtr->alSource);
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->manager->mutex);
+
+  if (this->dataPtr->hasVoice)
+    alSourceRewind(this->dataPtr->alSource);
+
+  this->dataPtr->state = OpenALSourcePrivate::STOPPED;
+  this->dataPtr->offset = 0;
 }
 
 /////////////////////////////////////////////////
 bool OpenALSource::IsPlaying()
 {
-  int sourceState;
-  alGetSourcei(this->dataPtr->alSource, AL_SOURCE_STATE, &sourceState);
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->manager->mutex);
+
+  if (this->dataPtr->hasVoice)
+  {
+    int sourceState;
+    alGetSourcei(this->dataPtr->alSource, AL_SOURCE_STATE, &sourceState);
 
-  return sourceState == AL_PLAYING;
+    return sourceState == AL_PLAYING;
+  }
+
+  UpdateState(*this->dataPtr, std::chrono::steady_clock::now());
+  return this->dataPtr->state == OpenALSourcePrivate::PLAYING;
 }
 
 /////////////////////////////////////////////////
 bool OpenALSource::FillBufferFromPCM(uint8_t *_pcmData,
     unsigned int _dataCount, int _sampleRate)
 {
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->manager->mutex);
+
   // First detach the buffer
-  alSourcei(this->dataPtr->alSource, AL_BUFFER, 0);
+  if (this->dataPtr->hasVoice)
+    alSourcei(this->dataPtr->alSource, AL_BUFFER, 0);
 
   // Copy raw buffer into AL buffer
   // AL_FORMAT_MONO8, AL_FORMAT_MONO16, AL_FORMAT_STEREO8,
@@ -499,7 +975,8 @@ bool OpenALSource::FillBufferFromPCM(uint8_t *_pcmData,
       _sampleRate);
 
   // Attach buffer to source
-  alSourcei(this->dataPtr->alSource, AL_BUFFER, this->dataPtr->alBuffer);
+  if (this->dataPtr->hasVoice)
+    alSourcei(this->dataPtr->alSource, AL_BUFFER, this->dataPtr->alBuffer);
 
   if (alGetError() != AL_NO_ERROR)
   {
@@ -507,6 +984,10 @@ bool OpenALSource::FillBufferFromPCM(uint8_t *_pcmData,
     return false;
   }
 
+  // 16 bit mono samples
+  this->dataPtr->duration = _sampleRate > 0 ?
+    _dataCount / (2.0 * _sampleRate) : 0.0;
+
   return true;
 }
 
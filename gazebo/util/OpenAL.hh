@@ -17,6 +17,7 @@
 #ifndef _GAZEBO_UTIL_OPENAL_HH_
 #define _GAZEBO_UTIL_OPENAL_HH_
 
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -51,6 +52,13 @@ namespace gazebo
 
     /// \class OpenAL OpenAL.hh util/util.hh
     /// \brief 3D audio setup and playback.
+    ///
+    /// The sources are virtual voices: they keep their state and playback
+    /// position without holding an OpenAL source. Update hands the
+    /// limited number of OpenAL sources to the playing sources of highest
+    /// priority, then the loudest ones, and culls the sources too far
+    /// from the listener to be heard. The poses of the sources are sent
+    /// to OpenAL by Update, at the audio update rate.
     class GZ_UTIL_VISIBLE OpenAL : public SingletonT<OpenAL>
     {
       /// \brief Constructor
@@ -60,9 +68,27 @@ namespace gazebo
       private: virtual ~OpenAL();
 
       /// \brief Load the OpenAL server.
+      /// \param[in] _sdf The <audio> element, which may set the maximum
+      /// number of sources that play at once with <gz:max_voices>, and
+      /// the rate of Update in Hz with <gz:update_rate>.
       /// \return True on success.
       public: bool Load(sdf::ElementPtr _sdf = sdf::ElementPtr());
 
+      /// \brief Assign the OpenAL sources to the audible sources, and send
+      /// the poses of the sources to OpenAL. Does nothing until the
+      /// update period has elapsed since the last update, so it can be
+      /// called every simulation step.
+      public: void Update();
+
+      /// \brief Get the maximum number of sources that play at once.
+      /// \return The number of OpenAL sources.
+      public: unsigned int MaxVoices() const;
+
+      /// \brief Get the number of sources that play through an OpenAL
+      /// source.
+      /// \return The number of sources heard.
+      public: unsigned int ActiveVoices() const;
+
       /// \brief Finalize.
       public: void Fini();
 
@@ -87,6 +113,9 @@ namespace gazebo
 
       /// \brief This is a singleton
       private: friend class SingletonT<OpenAL>;
+
+      /// \brief The sources register with the server.
+      private: friend class OpenALSource;
     };
 
     /// \class OpenALSink OpenALSink.hh util/util.hh
@@ -121,20 +150,49 @@ namespace gazebo
       public: virtual ~OpenALSource();
 
       /// \brief Load the source from sdf.
-      /// \param[in] _sdf SDF element parameters for an audio_source.
+      /// \param[in] _sdf SDF element parameters for an audio_source. The
+      /// optional <gz:priority> element ranks the source when there are
+      /// more playing sources than OpenAL sources, and <gz:max_distance>
+      /// sets the distance to the listener beyond which the source is
+      /// culled.
       /// \return True on success.
       public: bool Load(sdf::ElementPtr _sdf);
 
-      /// \brief Set the position of the source.
+      /// \brief Set the position of the source. It is sent to OpenAL by
+      /// the next OpenAL::Update.
       /// \param[in] _pose New pose of the source.
       /// \return True on success.
       public: bool SetPose(const ignition::math::Pose3d &_pose);
 
-      /// \brief Set the velocity of the source.
+      /// \brief Set the velocity of the source. It is sent to OpenAL by
+      /// the next OpenAL::Update.
       /// \param[in] _vel New velocity of the source.
       /// \return True on success.
       public: bool SetVelocity(const ignition::math::Vector3d &_vel);
 
+      /// \brief Set the priority of the source. The sources of higher
+      /// priority play first when there are not enough OpenAL sources.
+      /// \param[in] _priority The priority, zero by default.
+      public: void SetPriority(double _priority);
+
+      /// \brief Get the priority of the source.
+      /// \return The priority.
+      public: double Priority() const;
+
+      /// \brief Set the distance to the listener beyond which the source
+      /// is culled.
+      /// \param[in] _distance The distance, or zero to cull the source
+      /// where its attenuated gain falls below 1e-3.
+      public: void SetMaxDistance(double _distance);
+
+      /// \brief Get the distance beyond which the source is culled.
+      /// \return The distance set, zero if it depends on the gain.
+      public: double MaxDistance() const;
+
+      /// \brief Get whether the source plays through an OpenAL source.
+      /// \return False if the source is stopped, culled or outranked.
+      public: bool HasVoice() const;
+
       /// \brief Set the pitch of the source.
       /// \param[in] _p Pitch value.
       /// \return True on success.
@@ -197,6 +255,9 @@ namespace gazebo
       /// \internal
       /// \brief Private data pointer
       private: std::unique_ptr<OpenALSourcePrivate> dataPtr;
+
+      /// \brief The server assigns the voices.
+      private: friend class OpenAL;
     };
     /// \}
   }
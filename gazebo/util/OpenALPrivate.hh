@@ -17,9 +17,14 @@
 #ifndef _GAZEBO_UTIL_OPENAL_PRIVATE_HH_
 #define _GAZEBO_UTIL_OPENAL_PRIVATE_HH_
 
+#include <chrono>
+#include <mutex>
 #include <string>
 #include <vector>
 
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+
 #include "gazebo/gazebo_config.h"
 #include "gazebo/util/UtilTypes.hh"
 
@@ -29,6 +34,8 @@ namespace gazebo
 {
   namespace util
   {
+    class OpenALSource;
+
     /// \internal
     /// \brief Private dat for OpenAL
     class OpenALPrivate
@@ -41,14 +48,56 @@ namespace gazebo
 
       /// \brief OpenAL sink pointer.
       public: OpenALSinkPtr sink;
+
+      /// \brief Protects the sources and the voices, the sources are
+      /// played from the transport threads.
+      public: std::recursive_mutex mutex;
+
+      /// \brief All the sources created, whether they have a voice or not.
+      public: std::vector<OpenALSource *> sources;
+
+      /// \brief Generated OpenAL sources that no source uses.
+      public: std::vector<unsigned int> freeVoices;
+
+      /// \brief Number of OpenAL sources generated.
+      public: unsigned int voiceCount = 0;
+
+      /// \brief Maximum number of OpenAL sources.
+      public: unsigned int maxVoices = 64;
+
+      /// \brief Period of Update.
+      public: std::chrono::steady_clock::duration updatePeriod =
+                  std::chrono::milliseconds(20);
+
+      /// \brief Time of the last Update.
+      public: std::chrono::steady_clock::time_point lastUpdate;
     };
 
     /// \internal
     /// \brief Private data for OpenALSource
     class OpenALSourcePrivate
     {
-      /// \brief OpenAL source index.
-      public: unsigned int alSource;
+      /// \brief Playback state, kept while the source has no voice.
+      public: enum State
+              {
+                /// \brief At the beginning of the buffer.
+                STOPPED,
+
+                /// \brief Playing.
+                PLAYING,
+
+                /// \brief Paused at the offset.
+                PAUSED
+              };
+
+      /// \brief The server private data, which owns the voices.
+      public: OpenALPrivate *manager = nullptr;
+
+      /// \brief OpenAL source index, valid if hasVoice is true.
+      public: unsigned int alSource = 0;
+
+      /// \brief Whether the source plays through alSource.
+      public: bool hasVoice = false;
 
       /// \brief OpenAL buffer index.
       public: unsigned int alBuffer;
@@ -56,6 +105,44 @@ namespace gazebo
       /// \brief Names of collision objects that should trigger audio
       /// playback.
       public: std::vector<std::string> collisionNames;
+
+      /// \brief Pose of the source.
+      public: ignition::math::Pose3d pose;
+
+      /// \brief Velocity of the source.
+      public: ignition::math::Vector3d velocity;
+
+      /// \brief True if the pose or the velocity changed since they were
+      /// sent to OpenAL.
+      public: bool dirty = true;
+
+      /// \brief Pitch of the source.
+      public: float pitch = 1.0f;
+
+      /// \brief Gain of the source.
+      public: float gain = 1.0f;
+
+      /// \brief Whether the source loops.
+      public: bool loop = false;
+
+      /// \brief Rank of the source among the audible ones.
+      public: double priority = 0.0;
+
+      /// \brief Culling distance, zero to derive it from the gain.
+      public: double maxDistance = 0.0;
+
+      /// \brief Playback state.
+      public: State state = STOPPED;
+
+      /// \brief Playback position in seconds when the source was paused,
+      /// or at startTime while it plays.
+      public: double offset = 0.0;
+
+      /// \brief Time the source started playing from offset.
+      public: std::chrono::steady_clock::time_point startTime;
+
+      /// \brief Length of the buffer in seconds.
+      public: double duration = 0.0;
     };
   }
 }
@@ -15,12 +15,16 @@
  *
 */
 
+#include <string>
+#include <vector>
+
 #include <boost/filesystem.hpp>
 #include <gtest/gtest.h>
 #include <sdf/sdf.hh>
 
 #include "test_config.h"
 #include "gazebo/common/CommonIface.hh"
+#include "gazebo/common/Time.hh"
 #include "gazebo/util/OpenAL.hh"
 #include "gazebo/gazebo_config.h"
 #include "test/util.hh"
@@ -309,6 +313,90 @@ TEST_F(OpenAL, Sourcevalid)
   ASSERT_NO_THROW(util::OpenAL::Instance()->Fini());
 }
 
+/////////////////////////////////////////////////
+TEST_F(OpenAL, Voices)
+{
+  common::load();
+
+  sdf::SDFPtr worldSDF(new sdf::SDF);
+  sdf::initFile("world.sdf", worldSDF->Root());
+  EXPECT_TRUE(sdf::readString("<sdf version='1.4'>"
+    "<world name='default'>"
+    "<audio>"
+    "<gz:max_voices>2</gz:max_voices>"
+    "<gz:update_rate>1000</gz:update_rate>"
+    "</audio>"
+    "</world>"
+    "</sdf>", worldSDF->Root()));
+  EXPECT_TRUE(util::OpenAL::Instance()->Load(
+      worldSDF->Root()->GetElement("audio")));
+  EXPECT_EQ(util::OpenAL::Instance()->MaxVoices(), 2u);
+
+  util::OpenALSinkPtr sink =
+    util::OpenAL::Instance()->CreateSink(sdf::ElementPtr());
+  ASSERT_TRUE(sink != NULL);
+  EXPECT_TRUE(sink->SetPose(ignition::math::Pose3d::Zero));
+
+  std::vector<util::OpenALSourcePtr> sources;
+  for (int i = 0; i < 4; ++i)
+  {
+    sdf::SDFPtr sdf(new sdf::SDF);
+    sdf::initFile("audio_source.sdf", sdf->Root());
+    EXPECT_TRUE(sdf::readString("<sdf version='1.4'>"
+      "<audio_source>"
+      "<uri>file://media/audio/cheer.wav</uri>"
+      "<loop>true</loop>"
+      "<gz:priority>" + std::to_string(i == 3 ? 1 : 0) + "</gz:priority>"
+      "</audio_source>"
+      "</sdf>", sdf->Root()));
+
+    sources.push_back(util::OpenAL::Instance()->CreateSource(sdf->Root()));
+    ASSERT_TRUE(sources.back() != NULL);
+    EXPECT_TRUE(sources.back()->SetPose(
+          ignition::math::Pose3d(1 + i * 10, 0, 0, 0, 0, 0)));
+  }
+  EXPECT_DOUBLE_EQ(sources[3]->Priority(), 1.0);
+
+  // The sources without a voice play virtually
+  EXPECT_EQ(util::OpenAL::Instance()->ActiveVoices(), 2u);
+  for (auto &source : sources)
+    EXPECT_TRUE(source->IsPlaying());
+
+  // The closest source and the one of highest priority are heard
+  common::Time::MSleep(5);
+  util::OpenAL::Instance()->Update();
+  EXPECT_TRUE(sources[0]->HasVoice());
+  EXPECT_FALSE(sources[1]->HasVoice());
+  EXPECT_FALSE(sources[2]->HasVoice());
+  EXPECT_TRUE(sources[3]->HasVoice());
+
+  // Sources out of range are culled
+  sources[0]->SetMaxDistance(0.5);
+  EXPECT_DOUBLE_EQ(sources[0]->MaxDistance(), 0.5);
+  EXPECT_TRUE(sources[3]->SetPose(
+        ignition::math::Pose3d(1e4, 0, 0, 0, 0, 0)));
+  common::Time::MSleep(5);
+  util::OpenAL::Instance()->Update();
+  EXPECT_FALSE(sources[0]->HasVoice());
+  EXPECT_TRUE(sources[1]->HasVoice());
+  EXPECT_TRUE(sources[2]->HasVoice());
+  EXPECT_FALSE(sources[3]->HasVoice());
+  EXPECT_TRUE(sources[0]->IsPlaying());
+
+  // Paused sources give their voice back
+  sources[1]->Pause();
+  EXPECT_FALSE(sources[1]->IsPlaying());
+  common::Time::MSleep(5);
+  util::OpenAL::Instance()->Update();
+  EXPECT_FALSE(sources[1]->HasVoice());
+  EXPECT_EQ(util::OpenAL::Instance()->ActiveVoices(), 1u);
+
+  sources.clear();
+  EXPECT_EQ(util::OpenAL::Instance()->ActiveVoices(), 0u);
+  sink.reset();
+  ASSERT_NO_THROW(util::OpenAL::Instance()->Fini());
+}
+
 /////////////////////////////////////////////////
 TEST_F(OpenAL, SinkCreate)
 {
@@ -3,11 +3,53 @@ uniform float pFar;
 
 varying float depth;
 
+// Noise of the distances, set by rendering::DepthNoise. Each sample is
+// dropped with probability noiseDropout, otherwise it gets Gaussian noise
+// and is rounded to noisePrecision. The samples at the far clip distance
+// hit nothing and keep their value.
+uniform vec3 noiseOffsets;
+uniform float noiseMean;
+uniform float noiseStdDev;
+uniform float noisePrecision;
+uniform float noiseDropout;
+uniform float noiseFar;
+
+float noise_rand(vec2 co)
+{
+  // Same generator as camera_noise_gaussian_fs.glsl, never returns 0
+  float r = fract(sin(dot(co, vec2(12.9898, 78.233))) * 43758.5453);
+  return max(r, 0.000000000001);
+}
+
+float depth_noise(float d, vec2 co)
+{
+  if (d >= noiseFar)
+    return d;
+
+  if (noiseDropout > 0.0 && noise_rand(co + noiseOffsets.zz) < noiseDropout)
+    return noiseFar;
+
+  if (noiseStdDev > 0.0 || noiseMean != 0.0)
+  {
+    // Box-Muller
+    float u = noise_rand(co + noiseOffsets.xx);
+    float v = noise_rand(co + noiseOffsets.yy);
+    d += sqrt(-2.0 * log(u)) * cos(6.28318530717958647692 * v) * noiseStdDev +
+        noiseMean;
+  }
+
+  if (noisePrecision > 0.0)
+    d = floor(d / noisePrecision + 0.5) * noisePrecision;
+
+  return min(d, noiseFar);
+}
+
 void main()
 {
   // This normalizes the depth value
   //gl_FragColor = vec4(vec3(depth / (pFar - pNear)), 1.0);
 
   // This returns the world position
-  gl_FragColor = vec4(vec3(depth), 1.0);
+  gl_FragColor = vec4(vec3(depth_noise(depth, gl_FragCoord.xy * 0.001)),
+      1.0);
 }
@@ -0,0 +1,31 @@
+#version 120
+
+// Depth along the optical axis, rendered by Gazebo/DepthMap
+uniform sampler2D depthTex;
+
+// Camera image, sampled for the color of each point
+uniform sampler2D colorTex;
+
+// P[0][0], P[1][1], P[0][2] and P[1][2] of the camera projection matrix
+uniform vec4 projParams;
+
+varying vec2 uv;
+
+void main()
+{
+  float depth = texture2D(depthTex, uv).r;
+
+  // Normalized device coordinates of the pixel, y up
+  vec2 ndc = vec2(2.0 * uv.x - 1.0, 1.0 - 2.0 * uv.y);
+
+  // Point in camera space, then in the optical frame (x right, y down,
+  // z forward) used by Gazebo/XYZPoints
+  float x = (ndc.x + projParams.z) * depth / projParams.x;
+  float y = (ndc.y + projParams.w) * depth / projParams.y;
+
+  // Color packed as r * 65536 + g * 256 + b, which a float holds exactly
+  vec3 color = floor(texture2D(colorTex, uv).rgb * 255.0 + 0.5);
+  float rgb = color.r * 65536.0 + color.g * 256.0 + color.b;
+
+  gl_FragColor = vec4(x, -y, depth, rgb);
+}
@@ -0,0 +1,67 @@
+// Fragment program of hardware instanced visuals, per pixel lighting of
+// the material colors by up to four lights.
+#define MAX_LIGHTS 4
+
+uniform vec4 ambientLight;
+uniform vec4 surfaceDiffuse;
+uniform vec4 surfaceSpecular;
+uniform vec4 surfaceEmissive;
+uniform float surfaceShininess;
+
+uniform vec4 lightPosition[MAX_LIGHTS];
+uniform vec4 lightDiffuse[MAX_LIGHTS];
+uniform vec4 lightSpecular[MAX_LIGHTS];
+uniform vec4 lightAttenuation[MAX_LIGHTS];
+uniform vec3 cameraPosition;
+
+#ifdef TEXTURED
+uniform sampler2D diffuseMap;
+#endif
+
+varying vec3 worldPos;
+varying vec3 worldNormal;
+varying vec2 texCoord;
+
+void main()
+{
+  vec3 normal = normalize(worldNormal);
+  vec3 toCamera = normalize(cameraPosition - worldPos);
+
+  vec3 diffuse = vec3(0.0);
+  vec3 specular = vec3(0.0);
+  for (int i = 0; i < MAX_LIGHTS; ++i)
+  {
+    // Directional lights have w == 0
+    vec3 toLight = lightPosition[i].xyz - worldPos * lightPosition[i].w;
+    float dist = length(toLight);
+    toLight = toLight / max(dist, 1e-4);
+
+    float attenuation = 1.0;
+    if (lightPosition[i].w > 0.0)
+    {
+      if (dist > lightAttenuation[i].x)
+        continue;
+      attenuation = 1.0 / max(lightAttenuation[i].y +
+          lightAttenuation[i].z * dist +
+          lightAttenuation[i].w * dist * dist, 1e-4);
+    }
+
+    float lambert = max(dot(normal, toLight), 0.0);
+    diffuse += lightDiffuse[i].rgb * lambert * attenuation;
+
+    if (lambert > 0.0)
+    {
+      vec3 halfVec = normalize(toLight + toCamera);
+      specular += lightSpecular[i].rgb * attenuation *
+          pow(max(dot(normal, halfVec), 0.0), surfaceShininess);
+    }
+  }
+
+  vec4 color = surfaceDiffuse;
+#ifdef TEXTURED
+  color *= texture2D(diffuseMap, texCoord);
+#endif
+
+  gl_FragColor = vec4(surfaceEmissive.rgb + ambientLight.rgb * color.rgb +
+      diffuse * color.rgb + specular * surfaceSpecular.rgb, color.a);
+}
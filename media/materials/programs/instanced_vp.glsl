@@ -0,0 +1,31 @@
+// Vertex program of hardware instanced visuals. The world matrix of each
+// instance comes in the texture coordinates following the mesh's own, as
+// three rows of a 3x4 matrix.
+attribute vec4 vertex;
+attribute vec3 normal;
+attribute vec4 uv0;
+attribute vec4 uv1;
+attribute vec4 uv2;
+attribute vec4 uv3;
+
+uniform mat4 viewProjMatrix;
+
+varying vec3 worldPos;
+varying vec3 worldNormal;
+varying vec2 texCoord;
+
+void main()
+{
+  mat4 worldMatrix;
+  worldMatrix[0] = uv1;
+  worldMatrix[1] = uv2;
+  worldMatrix[2] = uv3;
+  worldMatrix[3] = vec4(0.0, 0.0, 0.0, 1.0);
+
+  vec4 pos = vertex * worldMatrix;
+  worldPos = pos.xyz;
+  worldNormal = (vec4(normal, 0.0) * worldMatrix).xyz;
+  texCoord = uv0.xy;
+
+  gl_Position = viewProjMatrix * pos;
+}
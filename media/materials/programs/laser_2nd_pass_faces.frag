@@ -0,0 +1,75 @@
+uniform sampler2D tex1;
+uniform sampler2D tex2;
+uniform sampler2D tex3;
+uniform sampler2D tex4;
+uniform sampler2D tex5;
+uniform sampler2D tex6;
+
+// Index of the depth face divided by 1000
+varying float tex;
+
+// Noise of the distances, set by rendering::DepthNoise. Each sample is
+// dropped with probability noiseDropout, otherwise it gets Gaussian noise
+// and is rounded to noisePrecision. The samples at the far clip distance
+// hit nothing and keep their value.
+uniform vec3 noiseOffsets;
+uniform float noiseMean;
+uniform float noiseStdDev;
+uniform float noisePrecision;
+uniform float noiseDropout;
+uniform float noiseFar;
+
+float noise_rand(vec2 co)
+{
+  // Same generator as camera_noise_gaussian_fs.glsl, never returns 0
+  float r = fract(sin(dot(co, vec2(12.9898, 78.233))) * 43758.5453);
+  return max(r, 0.000000000001);
+}
+
+float depth_noise(float d, vec2 co)
+{
+  if (d >= noiseFar)
+    return d;
+
+  if (noiseDropout > 0.0 && noise_rand(co + noiseOffsets.zz) < noiseDropout)
+    return noiseFar;
+
+  if (noiseStdDev > 0.0 || noiseMean != 0.0)
+  {
+    // Box-Muller
+    float u = noise_rand(co + noiseOffsets.xx);
+    float v = noise_rand(co + noiseOffsets.yy);
+    d += sqrt(-2.0 * log(u)) * cos(6.28318530717958647692 * v) * noiseStdDev +
+        noiseMean;
+  }
+
+  if (noisePrecision > 0.0)
+    d = floor(d / noisePrecision + 0.5) * noisePrecision;
+
+  return min(d, noiseFar);
+}
+
+void main()
+{
+  if ((gl_TexCoord[0].s < 0.0) || (gl_TexCoord[0].s > 1.0) ||
+      (gl_TexCoord[0].t < 0.0) || (gl_TexCoord[0].t > 1.0))
+    gl_FragColor = vec4(1,1,1,1);
+  else
+  {
+    int face = int(floor(tex * 1000.0 + 0.5));
+    if (face == 0)
+      gl_FragColor = texture2D(tex1, gl_TexCoord[0].st);
+    else if (face == 1)
+      gl_FragColor = texture2D(tex2, gl_TexCoord[0].st);
+    else if (face == 2)
+      gl_FragColor = texture2D(tex3, gl_TexCoord[0].st);
+    else if (face == 3)
+      gl_FragColor = texture2D(tex4, gl_TexCoord[0].st);
+    else if (face == 4)
+      gl_FragColor = texture2D(tex5, gl_TexCoord[0].st);
+    else
+      gl_FragColor = texture2D(tex6, gl_TexCoord[0].st);
+
+    gl_FragColor.r = depth_noise(gl_FragColor.r, gl_TexCoord[0].st);
+  }
+}
@@ -36,6 +36,7 @@
 typedef SSIZE_T ssize_t;
 #endif
 
+#include <algorithm>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -260,6 +261,24 @@ class gazebo::ArduCopterPluginPrivate
   /// \brief number of times ArduCotper skips update
   /// before marking ArduCopter offline
   public: int connectionTimeoutMaxCount;
+
+  /// \brief Address of the controller.
+  public: std::string fdmAddr;
+
+  /// \brief Port receiving the servo packets.
+  public: int fdmPortIn;
+
+  /// \brief Port of the controller receiving the state.
+  public: int fdmPortOut;
+
+  /// \brief True to wait for the controller at every step.
+  public: bool lockstep;
+
+  /// \brief Milliseconds to wait for the controller in lockstep mode.
+  public: uint32_t lockstepTimeoutMs;
+
+  /// \brief Pointer to the update end event connection, in lockstep mode.
+  public: event::ConnectionPtr updateEndConnection;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -276,12 +295,6 @@ ArduCopterPlugin::ArduCopterPlugin()
   setsockopt(this->dataPtr->handle, IPPROTO_TCP, TCP_NODELAY,
       reinterpret_cast<const char *>(&one), sizeof(one));
 
-  if (!this->dataPtr->Bind("127.0.0.1", 9002))
-  {
-    gzerr << "failed to bind with 127.0.0.1:9002, aborting plugin.\n";
-    return;
-  }
-
   this->dataPtr->arduCopterOnline = false;
 
   this->dataPtr->connectionTimeoutCount = 0;
@@ -312,6 +325,26 @@ void ArduCopterPlugin::Load(physics::ModelPtr _model, sdf::ElementPtr _sdf)
 
   this->dataPtr->model = _model;
 
+  // Ports of the controller, each vehicle needs its own
+  getSdfParam<std::string>(_sdf, "fdm_addr", this->dataPtr->fdmAddr,
+      "127.0.0.1");
+  getSdfParam<int>(_sdf, "fdm_port_in", this->dataPtr->fdmPortIn, 9002);
+  getSdfParam<int>(_sdf, "fdm_port_out", this->dataPtr->fdmPortOut, 9003);
+
+  if (!this->dataPtr->Bind(this->dataPtr->fdmAddr.c_str(),
+        this->dataPtr->fdmPortIn))
+  {
+    gzerr << "failed to bind with " << this->dataPtr->fdmAddr << ":"
+          << this->dataPtr->fdmPortIn << ", aborting plugin.\n";
+    return;
+  }
+
+  getSdfParam<bool>(_sdf, "lockstep", this->dataPtr->lockstep, false);
+  double lockstepTimeout;
+  getSdfParam<double>(_sdf, "lockstep_timeout", lockstepTimeout, 1.0);
+  this->dataPtr->lockstepTimeoutMs =
+      static_cast<uint32_t>(std::max(0.0, lockstepTimeout) * 1000);
+
   // per rotor
   if (_sdf->HasElement("rotor"))
   {
@@ -459,6 +492,13 @@ void ArduCopterPlugin::Load(physics::ModelPtr _model, sdf::ElementPtr _sdf)
   this->dataPtr->updateConnection = event::Events::ConnectWorldUpdateBegin(
       std::bind(&ArduCopterPlugin::OnUpdate, this));
 
+  // The state is sent once the physics has been updated
+  if (this->dataPtr->lockstep)
+  {
+    this->dataPtr->updateEndConnection = event::Events::ConnectWorldUpdateEnd(
+        std::bind(&ArduCopterPlugin::OnUpdateEnd, this));
+  }
+
   gzlog << "ArduCopter ready to fly. The force will be with you" << std::endl;
 }
 
@@ -477,13 +517,23 @@ void ArduCopterPlugin::OnUpdate()
     {
       this->ApplyMotorForces((curTime -
         this->dataPtr->lastControllerUpdateTime).Double());
-      this->SendState();
+      if (!this->dataPtr->lockstep)
+        this->SendState();
     }
   }
 
   this->dataPtr->lastControllerUpdateTime = curTime;
 }
 
+/////////////////////////////////////////////////
+void ArduCopterPlugin::OnUpdateEnd()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  if (this->dataPtr->arduCopterOnline)
+    this->SendState();
+}
+
 /////////////////////////////////////////////////
 void ArduCopterPlugin::ResetPIDs()
 {
@@ -524,8 +574,13 @@ void ArduCopterPlugin::ReceiveMotorCommand()
   // missed receives before declaring the FCS offline.
 
   ServoPacket pkt;
-  int waitMs = 1;
-  if (this->dataPtr->arduCopterOnline)
+  uint32_t waitMs = 1;
+  if (this->dataPtr->lockstep)
+  {
+    // Every step waits for the controller
+    waitMs = this->dataPtr->lockstepTimeoutMs;
+  }
+  else if (this->dataPtr->arduCopterOnline)
   {
     // increase timeout for receive once we detect a packet from
     // ArduCopter FCS.
@@ -689,7 +744,8 @@ void ArduCopterPlugin::SendState() const
   pkt.velocityXYZ[2] = velNEDFrame.Z();
 
   struct sockaddr_in sockaddr;
-  this->dataPtr->MakeSockAddr("127.0.0.1", 9003, sockaddr);
+  this->dataPtr->MakeSockAddr(this->dataPtr->fdmAddr.c_str(),
+      this->dataPtr->fdmPortOut, sockaddr);
 
   ::sendto(this->dataPtr->handle,
            reinterpret_cast<raw_type *>(&pkt),
@@ -45,6 +45,23 @@ namespace gazebo
   /// <imuName>     scoped name for the imu sensor
   /// <connectionTimeoutMaxCount> timeout before giving up on
   ///                             controller synchronization
+  /// <fdm_addr>      address of the controller, 127.0.0.1 by default
+  /// <fdm_port_in>   port receiving the servo packets, 9002 by default
+  /// <fdm_port_out>  port of the controller receiving the state, 9003 by
+  ///                 default. Each vehicle needs ports of its own.
+  /// <lockstep>      true to wait for the servo packet of the controller
+  ///                 at every step, false by default
+  /// <lockstep_timeout> seconds to wait for the servo packet in lockstep
+  ///                    mode, 1 by default
+  ///
+  /// In lockstep mode, the state is sent after the physics update of a
+  /// step and the controller's answer is applied in the next step, so
+  /// that the world runs as fast as the controller answers, and the
+  /// controller sees the same sequence of states whatever the speed.
+  /// The states of all the vehicles are sent before any of them waits,
+  /// so the controllers compute concurrently and a step waits for the
+  /// slowest one rather than for all of them in turn.
+  /// Until the controller answers, every step waits for the timeout.
   class GZ_PLUGIN_VISIBLE ArduCopterPlugin : public ModelPlugin
   {
     /// \brief Constructor.
@@ -60,6 +77,9 @@ namespace gazebo
     /// \param[in] _info Update information provided by the server.
     private: void OnUpdate();
 
+    /// \brief Send the state after the physics update, in lockstep mode.
+    private: void OnUpdateEnd();
+
     /// \brief Update PID Joint controllers.
     /// \param[in] _dt time step size since last update.
     private: void ApplyMotorForces(const double _dt);
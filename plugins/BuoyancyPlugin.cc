@@ -30,13 +30,20 @@ BuoyancyPlugin::BuoyancyPlugin()
 {
 }
 
+/////////////////////////////////////////////////
+BuoyancyPlugin::~BuoyancyPlugin()
+{
+  for (const auto id : this->forceFieldIds)
+    this->world->ForceField().Remove(id);
+}
+
 /////////////////////////////////////////////////
 void BuoyancyPlugin::Load(physics::ModelPtr _model, sdf::ElementPtr _sdf)
 {
   GZ_ASSERT(_model != NULL, "Received NULL model pointer");
   this->model = _model;
-  physics::WorldPtr world = _model->GetWorld();
-  GZ_ASSERT(world != NULL, "Model is in a NULL world");
+  this->world = _model->GetWorld();
+  GZ_ASSERT(this->world != NULL, "Model is in a NULL world");
 
   GZ_ASSERT(_sdf != NULL, "Received NULL SDF pointer");
   this->sdf = _sdf;
@@ -146,31 +153,32 @@ void BuoyancyPlugin::Load(physics::ModelPtr _model, sdf::ElementPtr _sdf)
 /////////////////////////////////////////////////
 void BuoyancyPlugin::Init()
 {
+  // The world computes the buoyancy of all the links at once
+  for (auto link : this->model->GetLinks())
+  {
+    VolumeProperties volumeProperties = this->volPropsMap[link->GetId()];
+    GZ_ASSERT(volumeProperties.volume > 0,
+        "Nonpositive volume found in volume properties!");
+
+    this->forceFieldIds.push_back(this->world->ForceField().AddBuoyancy(
+          link, volumeProperties.volume, volumeProperties.cov,
+          this->fluidDensity));
+  }
+
+#ifndef _WIN32
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#endif
+
   this->updateConnection = event::Events::ConnectWorldUpdateBegin(
       std::bind(&BuoyancyPlugin::OnUpdate, this));
+
+#ifndef _WIN32
+#pragma GCC diagnostic pop
+#endif
 }
 
 /////////////////////////////////////////////////
 void BuoyancyPlugin::OnUpdate()
 {
-  for (auto link : this->model->GetLinks())
-  {
-    VolumeProperties volumeProperties = this->volPropsMap[link->GetId()];
-    double volume = volumeProperties.volume;
-    GZ_ASSERT(volume > 0, "Nonpositive volume found in volume properties!");
-
-    // By Archimedes' principle,
-    // buoyancy = -(mass*gravity)*fluid_density/object_density
-    // object_density = mass/volume, so the mass term cancels.
-    // Therefore,
-    ignition::math::Vector3d buoyancy =
-        -this->fluidDensity * volume * this->model->GetWorld()->Gravity();
-
-    ignition::math::Pose3d linkFrame = link->WorldPose();
-    // rotate buoyancy into the link frame before applying the force.
-    ignition::math::Vector3d buoyancyLinkFrame =
-        linkFrame.Rot().Inverse().RotateVector(buoyancy);
-
-    link->AddLinkForce(buoyancyLinkFrame, volumeProperties.cov);
-  }
 }
@@ -19,6 +19,7 @@
 #define GAZEBO_PLUGINS_BUOYANCYPLUGIN_HH_
 
 #include <map>
+#include <vector>
 #include <ignition/math/Vector3.hh>
 
 #include "gazebo/common/Event.hh"
@@ -62,6 +63,9 @@ namespace gazebo
     /// \brief Constructor.
     public: BuoyancyPlugin();
 
+    /// \brief Destructor.
+    public: virtual ~BuoyancyPlugin();
+
     /// \brief Read the model SDF to compute volume and center of volume for
     /// each link, and store those properties in volPropsMap.
     public: virtual void Load(physics::ModelPtr _model, sdf::ElementPtr _sdf);
@@ -69,8 +73,11 @@ namespace gazebo
     // Documentation inherited
     public: virtual void Init();
 
-    /// \brief Callback for World Update events.
-    protected: virtual void OnUpdate();
+    /// \brief Callback for World Update events. The force field of the
+    /// world applies the buoyancy, so this does nothing. It is still called
+    /// at each update for subclasses which override it.
+    /// \deprecated See physics::World::ForceField
+    protected: virtual void OnUpdate() GAZEBO_DEPRECATED(9.0);
 
     /// \brief Connection to World Update events.
     protected: event::ConnectionPtr updateConnection;
@@ -78,6 +85,13 @@ namespace gazebo
     /// \brief Pointer to model containing the plugin.
     protected: physics::ModelPtr model;
 
+    /// \brief Pointer to the world whose force field holds the buoyancy.
+    protected: physics::WorldPtr world;
+
+    /// \brief Identifiers of the buoyancy terms in the force field of the
+    /// world, one per link.
+    protected: std::vector<uint32_t> forceFieldIds;
+
     /// \brief Pointer to the plugin SDF.
     protected: sdf::ElementPtr sdf;
 
@@ -15,12 +15,9 @@
  *
 */
 
-#include <algorithm>
 #include <functional>
 #include <string>
 
-#include <ignition/math/Pose3.hh>
-
 #include "gazebo/common/Assert.hh"
 #include "gazebo/physics/physics.hh"
 #include "gazebo/sensors/SensorManager.hh"
@@ -60,6 +57,8 @@ LiftDragPlugin::LiftDragPlugin() : cla(1.0), cda(0.01), cma(0.01), rho(1.2041)
 /////////////////////////////////////////////////
 LiftDragPlugin::~LiftDragPlugin()
 {
+  if (this->forceFieldId)
+    this->world->ForceField().Remove(this->forceFieldId);
 }
 
 /////////////////////////////////////////////////
@@ -138,11 +137,6 @@ void LiftDragPlugin::Load(physics::ModelPtr _model,
       gzerr << "Link with name[" << linkName << "] not found. "
         << "The LiftDragPlugin will not generate forces\n";
     }
-    else
-    {
-      this->updateConnection = event::Events::ConnectWorldUpdateBegin(
-          std::bind(&LiftDragPlugin::OnUpdate, this));
-    }
   }
 
   if (_sdf->HasElement("control_joint_name"))
@@ -157,243 +151,45 @@ void LiftDragPlugin::Load(physics::ModelPtr _model,
 
   if (_sdf->HasElement("control_joint_rad_to_cl"))
     this->controlJointRadToCL = _sdf->Get<double>("control_joint_rad_to_cl");
+
+  if (!this->link)
+    return;
+
+  // The world computes the forces of all the surfaces at once
+  physics::LiftDragParams params;
+  params.cla = this->cla;
+  params.cda = this->cda;
+  params.cma = this->cma;
+  params.alphaStall = this->alphaStall;
+  params.claStall = this->claStall;
+  params.cdaStall = this->cdaStall;
+  params.cmaStall = this->cmaStall;
+  params.rho = this->rho;
+  params.radialSymmetry = this->radialSymmetry;
+  params.area = this->area;
+  params.alpha0 = this->alpha0;
+  params.cp = this->cp;
+  params.cp.Correct();
+  params.forward = this->forward;
+  params.upward = this->upward;
+  params.controlJointRadToCL = this->controlJointRadToCL;
+  this->forceFieldId = this->world->ForceField().AddLiftDrag(
+      this->link, params, this->controlJoint);
+
+#ifndef _WIN32
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#endif
+
+  this->updateConnection = event::Events::ConnectWorldUpdateBegin(
+      std::bind(&LiftDragPlugin::OnUpdate, this));
+
+#ifndef _WIN32
+#pragma GCC diagnostic pop
+#endif
 }
 
 /////////////////////////////////////////////////
 void LiftDragPlugin::OnUpdate()
 {
-  GZ_ASSERT(this->link, "Link was NULL");
-  // get linear velocity at cp in inertial frame
-  ignition::math::Vector3d vel = this->link->WorldLinearVel(this->cp);
-  ignition::math::Vector3d velI = vel;
-  velI.Normalize();
-
-  // smoothing
-  // double e = 0.8;
-  // this->velSmooth = e*vel + (1.0 - e)*velSmooth;
-  // vel = this->velSmooth;
-
-  if (vel.Length() <= 0.01)
-    return;
-
-  // pose of body
-  ignition::math::Pose3d pose = this->link->WorldPose();
-
-  // rotate forward and upward vectors into inertial frame
-  ignition::math::Vector3d forwardI = pose.Rot().RotateVector(this->forward);
-
-  ignition::math::Vector3d upwardI;
-  if (this->radialSymmetry)
-  {
-    // use inflow velocity to determine upward direction
-    // which is the component of inflow perpendicular to forward direction.
-    ignition::math::Vector3d tmp = forwardI.Cross(velI);
-    upwardI = forwardI.Cross(tmp).Normalize();
-  }
-  else
-  {
-    upwardI = pose.Rot().RotateVector(this->upward);
-  }
-
-  // spanwiseI: a vector normal to lift-drag-plane described in inertial frame
-  ignition::math::Vector3d spanwiseI = forwardI.Cross(upwardI).Normalize();
-
-  const double minRatio = -1.0;
-  const double maxRatio = 1.0;
-  // check sweep (angle between velI and lift-drag-plane)
-  double sinSweepAngle = ignition::math::clamp(
-      spanwiseI.Dot(velI), minRatio, maxRatio);
-
-  // get cos from trig identity
-  double cosSweepAngle = 1.0 - sinSweepAngle * sinSweepAngle;
-  this->sweep = asin(sinSweepAngle);
-
-  // truncate sweep to within +/-90 deg
-  while (fabs(this->sweep) > 0.5 * M_PI)
-    this->sweep = this->sweep > 0 ? this->sweep - M_PI
-                                  : this->sweep + M_PI;
-
-  // angle of attack is the angle between
-  // velI projected into lift-drag plane
-  //  and
-  // forward vector
-  //
-  // projected = spanwiseI Xcross ( vector Xcross spanwiseI)
-  //
-  // so,
-  // removing spanwise velocity from vel
-  ignition::math::Vector3d velInLDPlane = vel - vel.Dot(spanwiseI)*velI;
-
-  // get direction of drag
-  ignition::math::Vector3d dragDirection = -velInLDPlane;
-  dragDirection.Normalize();
-
-  // get direction of lift
-  ignition::math::Vector3d liftI = spanwiseI.Cross(velInLDPlane);
-  liftI.Normalize();
-
-  // get direction of moment
-  ignition::math::Vector3d momentDirection = spanwiseI;
-
-  // compute angle between upwardI and liftI
-  // in general, given vectors a and b:
-  //   cos(theta) = a.Dot(b)/(a.Length()*b.Lenghth())
-  // given upwardI and liftI are both unit vectors, we can drop the denominator
-  //   cos(theta) = a.Dot(b)
-  double cosAlpha =
-    ignition::math::clamp(liftI.Dot(upwardI), minRatio, maxRatio);
-
-  // Is alpha positive or negative? Test:
-  // forwardI points toward zero alpha
-  // if forwardI is in the same direction as lift, alpha is positive.
-  // liftI is in the same direction as forwardI?
-  if (liftI.Dot(forwardI) >= 0.0)
-    this->alpha = this->alpha0 + acos(cosAlpha);
-  else
-    this->alpha = this->alpha0 - acos(cosAlpha);
-
-  // normalize to within +/-90 deg
-  while (fabs(this->alpha) > 0.5 * M_PI)
-    this->alpha = this->alpha > 0 ? this->alpha - M_PI
-                                  : this->alpha + M_PI;
-
-  // compute dynamic pressure
-  double speedInLDPlane = velInLDPlane.Length();
-  double q = 0.5 * this->rho * speedInLDPlane * speedInLDPlane;
-
-  // compute cl at cp, check for stall, correct for sweep
-  double cl;
-  if (this->alpha > this->alphaStall)
-  {
-    cl = (this->cla * this->alphaStall +
-          this->claStall * (this->alpha - this->alphaStall))
-         * cosSweepAngle;
-    // make sure cl is still great than 0
-    cl = std::max(0.0, cl);
-  }
-  else if (this->alpha < -this->alphaStall)
-  {
-    cl = (-this->cla * this->alphaStall +
-          this->claStall * (this->alpha + this->alphaStall))
-         * cosSweepAngle;
-    // make sure cl is still less than 0
-    cl = std::min(0.0, cl);
-  }
-  else
-    cl = this->cla * this->alpha * cosSweepAngle;
-
-  // modify cl per control joint value
-  if (this->controlJoint)
-  {
-    double controlAngle = this->controlJoint->Position(0);
-    cl = cl + this->controlJointRadToCL * controlAngle;
-    /// \TODO: also change cm and cd
-  }
-
-  // compute lift force at cp
-  ignition::math::Vector3d lift = cl * q * this->area * liftI;
-
-  // compute cd at cp, check for stall, correct for sweep
-  double cd;
-  if (this->alpha > this->alphaStall)
-  {
-    cd = (this->cda * this->alphaStall +
-          this->cdaStall * (this->alpha - this->alphaStall))
-         * cosSweepAngle;
-  }
-  else if (this->alpha < -this->alphaStall)
-  {
-    cd = (-this->cda * this->alphaStall +
-          this->cdaStall * (this->alpha + this->alphaStall))
-         * cosSweepAngle;
-  }
-  else
-    cd = (this->cda * this->alpha) * cosSweepAngle;
-
-  // make sure drag is positive
-  cd = fabs(cd);
-
-  // drag at cp
-  ignition::math::Vector3d drag = cd * q * this->area * dragDirection;
-
-  // compute cm at cp, check for stall, correct for sweep
-  double cm;
-  if (this->alpha > this->alphaStall)
-  {
-    cm = (this->cma * this->alphaStall +
-          this->cmaStall * (this->alpha - this->alphaStall))
-         * cosSweepAngle;
-    // make sure cm is still great than 0
-    cm = std::max(0.0, cm);
-  }
-  else if (this->alpha < -this->alphaStall)
-  {
-    cm = (-this->cma * this->alphaStall +
-          this->cmaStall * (this->alpha + this->alphaStall))
-         * cosSweepAngle;
-    // make sure cm is still less than 0
-    cm = std::min(0.0, cm);
-  }
-  else
-    cm = this->cma * this->alpha * cosSweepAngle;
-
-  /// \TODO: implement cm
-  /// for now, reset cm to zero, as cm needs testing
-  cm = 0.0;
-
-  // compute moment (torque) at cp
-  ignition::math::Vector3d moment = cm * q * this->area * momentDirection;
-
-  // moment arm from cg to cp in inertial plane
-  ignition::math::Vector3d momentArm = pose.Rot().RotateVector(
-    this->cp - this->link->GetInertial()->CoG());
-  // gzerr << this->cp << " : " << this->link->GetInertial()->GetCoG() << "\n";
-
-  // force and torque about cg in inertial frame
-  ignition::math::Vector3d force = lift + drag;
-  // + moment.Cross(momentArm);
-
-  ignition::math::Vector3d torque = moment;
-  // - lift.Cross(momentArm) - drag.Cross(momentArm);
-
-  // debug
-  //
-  // if ((this->link->GetName() == "wing_1" ||
-  //      this->link->GetName() == "wing_2") &&
-  //     (vel.Length() > 50.0 &&
-  //      vel.Length() < 50.0))
-  if (0)
-  {
-    gzdbg << "=============================\n";
-    gzdbg << "sensor: [" << this->GetHandle() << "]\n";
-    gzdbg << "Link: [" << this->link->GetName()
-          << "] pose: [" << pose
-          << "] dynamic pressure: [" << q << "]\n";
-    gzdbg << "spd: [" << vel.Length()
-          << "] vel: [" << vel << "]\n";
-    gzdbg << "LD plane spd: [" << velInLDPlane.Length()
-          << "] vel : [" << velInLDPlane << "]\n";
-    gzdbg << "forward (inertial): " << forwardI << "\n";
-    gzdbg << "upward (inertial): " << upwardI << "\n";
-    gzdbg << "lift dir (inertial): " << liftI << "\n";
-    gzdbg << "Span direction (normal to LD plane): " << spanwiseI << "\n";
-    gzdbg << "sweep: " << this->sweep << "\n";
-    gzdbg << "alpha: " << this->alpha << "\n";
-    gzdbg << "lift: " << lift << "\n";
-    gzdbg << "drag: " << drag << " cd: "
-          << cd << " cda: " << this->cda << "\n";
-    gzdbg << "moment: " << moment << "\n";
-    gzdbg << "cp momentArm: " << momentArm << "\n";
-    gzdbg << "force: " << force << "\n";
-    gzdbg << "torque: " << torque << "\n";
-  }
-
-  // Correct for nan or inf
-  force.Correct();
-  this->cp.Correct();
-  torque.Correct();
-
-  // apply forces at cg (with torques for position shift)
-  this->link->AddForceAtRelativePosition(force, this->cp);
-  this->link->AddTorque(torque);
 }
@@ -40,12 +40,19 @@ namespace gazebo
     // Documentation Inherited.
     public: virtual void Load(physics::ModelPtr _model, sdf::ElementPtr _sdf);
 
-    /// \brief Callback for World Update events.
-    protected: virtual void OnUpdate();
+    /// \brief Callback for World Update events. The force field of the
+    /// world applies the lift and drag, so this does nothing. It is still
+    /// called at each update for subclasses which override it.
+    /// \deprecated See physics::World::ForceField
+    protected: virtual void OnUpdate() GAZEBO_DEPRECATED(9.0);
 
     /// \brief Connection to World Update events.
     protected: event::ConnectionPtr updateConnection;
 
+    /// \brief Identifier of the lift and drag term in the force field of
+    /// the world, 0 without a link.
+    protected: uint32_t forceFieldId = 0;
+
     /// \brief Pointer to world.
     protected: physics::WorldPtr world;
 
@@ -20,6 +20,7 @@
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Time.hh"
 #include "gazebo/common/Battery.hh"
+#include "gazebo/common/PowerSystem.hh"
 #include "gazebo/physics/physics.hh"
 #include "plugins/LinearBatteryPlugin.hh"
 
@@ -30,14 +31,10 @@ GZ_REGISTER_MODEL_PLUGIN(LinearBatteryPlugin)
 /////////////////////////////////////////////////
 LinearBatteryPlugin::LinearBatteryPlugin()
 {
-  this->iraw = 0.0;
-  this->ismooth = 0.0;
-
   this->e0 = 0.0;
   this->e1 = 0.0;
 
   this->q0 = 0.0;
-  this->q = this->q0;
 
   this->c = 0.0;
   this->r = 0.0;
@@ -96,12 +93,6 @@ void LinearBatteryPlugin::Load(physics::ModelPtr _parent, sdf::ElementPtr _sdf)
       gzerr << "Battery with name[" << batteryName << "] not found. "
             << "The LinearBatteryPlugin will not update its voltage\n";
     }
-    else
-    {
-      this->battery->SetUpdateFunc(
-        std::bind(&LinearBatteryPlugin::OnUpdateVoltage, this,
-          std::placeholders::_1));
-    }
   }
   else
   {
@@ -112,36 +103,23 @@ void LinearBatteryPlugin::Load(physics::ModelPtr _parent, sdf::ElementPtr _sdf)
 /////////////////////////////////////////////////
 void LinearBatteryPlugin::Init()
 {
-  this->q = this->q0;
+  if (!this->battery)
+    return;
+
+  // The power system of the world updates the voltage, along with the
+  // other batteries
+  common::LinearBatteryModel linearModel;
+  linearModel.e0 = this->e0;
+  linearModel.e1 = this->e1;
+  linearModel.c = this->c;
+  linearModel.r = this->r;
+  linearModel.tau = this->tau;
+  linearModel.q = this->q0;
+  this->world->PowerSystem().SetLinearModel(this->battery, linearModel);
 }
 
 /////////////////////////////////////////////////
 void LinearBatteryPlugin::Reset()
 {
-  this->iraw = 0.0;
-  this->ismooth = 0.0;
   this->Init();
 }
-
-/////////////////////////////////////////////////
-double LinearBatteryPlugin::OnUpdateVoltage(const common::BatteryPtr &_battery)
-{
-  double dt = this->world->Physics()->GetMaxStepSize();
-  double totalpower = 0.0;
-  double k = dt / this->tau;
-
-  if (fabs(_battery->Voltage()) < 1e-3)
-    return 0.0;
-
-  for (auto powerLoad : _battery->PowerLoads())
-    totalpower += powerLoad.second;
-
-  this->iraw = totalpower / _battery->Voltage();
-
-  this->ismooth = this->ismooth + k * (this->iraw - this->ismooth);
-
-  this->q = this->q - GZ_SEC_TO_HOUR(dt * this->ismooth);
-
-  return this->e0 + this->e1 * (1 - this->q / this->c)
-    - this->r * this->ismooth;
-}
@@ -26,7 +26,9 @@
 
 namespace gazebo
 {
-  /// \brief A plugin that simulates a linear battery.
+  /// \brief A plugin that simulates a linear battery. The voltage is
+  /// updated by the power system of the world, which also holds the charge
+  /// and current of the battery, see common::PowerSystem::LinearModel.
   class GZ_PLUGIN_VISIBLE LinearBatteryPlugin : public ModelPlugin
   {
     /// \brief Constructor.
@@ -41,11 +43,6 @@ namespace gazebo
     // Documentation Inherited.
     public: virtual void Reset();
 
-    /// \brief Callback for Battery Update events.
-    /// \param[in] _battery Pointer to the battery that is to be updated.
-    /// \return The new voltage.
-    private: double OnUpdateVoltage(const common::BatteryPtr &_battery);
-
     /// \brief Connection to World Update events.
     protected: event::ConnectionPtr updateConnection;
 
@@ -83,15 +80,6 @@ namespace gazebo
 
     /// \brief Current low-pass filter characteristic time in seconds.
     protected: double tau;
-
-    /// \brief Raw battery current in A.
-    protected: double iraw;
-
-    /// \brief Smoothed battery current in A.
-    protected: double ismooth;
-
-    /// \brief Instantaneous battery charge in Ah.
-    protected: double q;
   };
 }
 #endif
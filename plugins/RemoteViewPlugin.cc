@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <functional>
+#include <mutex>
+#include <ignition/math/Pose3.hh>
+
+#include "gazebo/common/CommonIface.hh"
+#include "gazebo/common/VideoEncoder.hh"
+#include "gazebo/rendering/Camera.hh"
+#include "gazebo/sensors/CameraSensor.hh"
+#include "gazebo/transport/Node.hh"
+#include "plugins/RemoteViewPlugin.hh"
+
+namespace gazebo
+{
+  /// \internal
+  /// \brief Private data for the RemoteViewPlugin class.
+  class RemoteViewPluginPrivate
+  {
+    /// \brief Publish a packet encoded by the encoder.
+    /// \param[in] _data Data of the packet.
+    /// \param[in] _size Size of the packet.
+    /// \param[in] _keyFrame True if the packet holds a key frame.
+    public: void OnPacket(const unsigned char *_data,
+                const std::size_t _size, const bool _keyFrame);
+
+    /// \brief Camera sensor that renders the frames.
+    public: sensors::CameraSensorPtr sensor;
+
+    /// \brief Camera of the sensor.
+    public: rendering::CameraPtr camera;
+
+    /// \brief Connection to the new frames of the camera.
+    public: event::ConnectionPtr newFrameConnection;
+
+    /// \brief Encoder of the frames, started when a client subscribes.
+    public: common::VideoEncoder encoder;
+
+    /// \brief Bit rate of the video, 0 to compute it.
+    public: unsigned int bitRate = 0;
+
+    /// \brief Communication node.
+    public: transport::NodePtr node;
+
+    /// \brief Publisher of the video packets.
+    public: transport::PublisherPtr videoPub;
+
+    /// \brief Subscriber to the camera poses sent by the clients.
+    public: transport::SubscriberPtr poseSub;
+
+    /// \brief Protects the members below, which are shared with the
+    /// transport and encoder threads.
+    public: std::mutex mutex;
+
+    /// \brief Latest camera pose sent by a client.
+    public: ignition::math::Pose3d pose;
+
+    /// \brief True if the pose is to be applied on the next frame.
+    public: bool poseChanged = false;
+
+    /// \brief Sensor time of the latest encoded frame.
+    public: common::Time frameTime;
+
+    /// \brief Width of the encoded frames.
+    public: unsigned int width = 0;
+
+    /// \brief Height of the encoded frames.
+    public: unsigned int height = 0;
+  };
+}
+
+using namespace gazebo;
+
+GZ_REGISTER_SENSOR_PLUGIN(RemoteViewPlugin)
+
+/////////////////////////////////////////////////
+void RemoteViewPluginPrivate::OnPacket(const unsigned char *_data,
+    const std::size_t _size, const bool _keyFrame)
+{
+  msgs::VideoPacket msg;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    msgs::Set(msg.mutable_time(), this->frameTime);
+    msg.set_width(this->width);
+    msg.set_height(this->height);
+  }
+  msg.set_data(_data, _size);
+  msg.set_key_frame(_keyFrame);
+  msg.set_format("h264");
+  this->videoPub->Publish(msg);
+}
+
+/////////////////////////////////////////////////
+RemoteViewPlugin::RemoteViewPlugin()
+    : dataPtr(new RemoteViewPluginPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+RemoteViewPlugin::~RemoteViewPlugin()
+{
+  this->dataPtr->newFrameConnection.reset();
+
+  // The encoder thread publishes until the encoder stops
+  this->dataPtr->encoder.Reset();
+  this->dataPtr->poseSub.reset();
+  this->dataPtr->videoPub.reset();
+  if (this->dataPtr->node)
+    this->dataPtr->node->Fini();
+}
+
+/////////////////////////////////////////////////
+void RemoteViewPlugin::Load(sensors::SensorPtr _sensor,
+    sdf::ElementPtr _sdf)
+{
+  this->dataPtr->sensor =
+    std::dynamic_pointer_cast<sensors::CameraSensor>(_sensor);
+  if (!this->dataPtr->sensor)
+  {
+    gzerr << "RemoteViewPlugin requires a CameraSensor." << std::endl;
+    return;
+  }
+
+  this->dataPtr->camera = this->dataPtr->sensor->Camera();
+  if (!this->dataPtr->camera)
+  {
+    gzerr << "RemoteViewPlugin's sensor has no camera." << std::endl;
+    return;
+  }
+
+  if (_sdf && _sdf->HasElement("hardware_encoder"))
+  {
+    this->dataPtr->encoder.SetHardwareEncoder(
+        _sdf->Get<std::string>("hardware_encoder"));
+  }
+  if (_sdf && _sdf->HasElement("bit_rate"))
+    this->dataPtr->bitRate = _sdf->Get<unsigned int>("bit_rate");
+
+  this->dataPtr->encoder.SetPacketCallback(
+      std::bind(&RemoteViewPluginPrivate::OnPacket, this->dataPtr.get(),
+        std::placeholders::_1, std::placeholders::_2,
+        std::placeholders::_3));
+
+  const std::string topic = "~/" +
+      common::replaceAll(_sensor->ScopedName(), "::", "/") + "/video";
+
+  this->dataPtr->node = transport::NodePtr(new transport::Node());
+  this->dataPtr->node->Init(_sensor->WorldName());
+  this->dataPtr->videoPub =
+      this->dataPtr->node->Advertise<msgs::VideoPacket>(topic, 10);
+  this->dataPtr->poseSub = this->dataPtr->node->Subscribe(topic + "/pose",
+      &RemoteViewPlugin::OnPose, this);
+
+  this->dataPtr->newFrameConnection =
+      this->dataPtr->camera->ConnectNewImageFrame(
+      std::bind(&RemoteViewPlugin::OnNewFrame, this,
+        std::placeholders::_1, std::placeholders::_2, std::placeholders::_3,
+        std::placeholders::_4, std::placeholders::_5));
+
+  this->dataPtr->sensor->SetActive(true);
+}
+
+/////////////////////////////////////////////////
+void RemoteViewPlugin::OnPose(ConstPosePtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->pose = msgs::ConvertIgn(*_msg);
+  this->dataPtr->poseChanged = true;
+}
+
+/////////////////////////////////////////////////
+void RemoteViewPlugin::OnNewFrame(const unsigned char *_image,
+    unsigned int _width, unsigned int _height, unsigned int /*_depth*/,
+    const std::string &_format)
+{
+  // The camera is moved on the rendering thread, for the next frame
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    if (this->dataPtr->poseChanged)
+    {
+      this->dataPtr->camera->SetWorldPose(this->dataPtr->pose);
+      this->dataPtr->poseChanged = false;
+    }
+  }
+
+  // Encode only while a client is watching, freeing the encoder otherwise
+  if (!this->dataPtr->videoPub->HasConnections())
+  {
+    if (this->dataPtr->encoder.IsEncoding())
+      this->dataPtr->encoder.Reset();
+    return;
+  }
+
+  if (_format != "R8G8B8")
+  {
+    gzerr << "RemoteViewPlugin can't encode " << _format << " images, "
+          << "the camera must output R8G8B8 images." << std::endl;
+    this->dataPtr->newFrameConnection.reset();
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->frameTime = this->dataPtr->sensor->LastMeasurementTime();
+    this->dataPtr->width = _width;
+    this->dataPtr->height = _height;
+  }
+
+  if (!this->dataPtr->encoder.IsEncoding())
+  {
+    // The encoder keeps the frame rate of the sensor
+    const double rate = this->dataPtr->sensor->UpdateRate();
+    const unsigned int fps = rate > 0 ?
+        static_cast<unsigned int>(rate) : VIDEO_ENCODER_FPS_DEFAULT;
+
+    if (!this->dataPtr->encoder.Start("h264", "", _width, _height, fps,
+          this->dataPtr->bitRate))
+    {
+      gzerr << "Unable to start the video stream of camera["
+            << this->dataPtr->sensor->ScopedName() << "]" << std::endl;
+      this->dataPtr->newFrameConnection.reset();
+      return;
+    }
+  }
+
+  this->dataPtr->encoder.AddFrame(_image, _width, _height);
+}
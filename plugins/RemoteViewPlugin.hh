@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PLUGINS_REMOTEVIEWPLUGIN_HH_
+#define GAZEBO_PLUGINS_REMOTEVIEWPLUGIN_HH_
+
+#include <memory>
+#include <string>
+
+#include <gazebo/common/Plugin.hh>
+#include <gazebo/msgs/msgs.hh>
+#include <gazebo/util/system.hh>
+
+namespace gazebo
+{
+  // Forward declare private data class.
+  class RemoteViewPluginPrivate;
+
+  /// \brief Plugin that streams the images of a camera sensor rendered on
+  /// the server as H.264 video, so that a thin client can view the world
+  /// without rendering it. The packets of the video are published as
+  /// msgs::VideoPacket on ~/<sensor scoped name>/video, only while a client
+  /// is subscribed, and a client moves the camera by publishing
+  /// msgs::Pose world poses on ~/<sensor scoped name>/video/pose. Several
+  /// clients can share a stream, or view their own cameras.
+  ///
+  /// The plugin has the following optional parameters:
+  /// <hardware_encoder>  "nvenc" or "vaapi" to encode on the GPU, which
+  ///                     falls back to software if it's not available.
+  /// <bit_rate>          Bit rate of the video, computed from the image
+  ///                     size by default.
+  class GZ_PLUGIN_VISIBLE RemoteViewPlugin : public SensorPlugin
+  {
+    /// \brief Constructor.
+    public: RemoteViewPlugin();
+
+    /// \brief Destructor.
+    public: ~RemoteViewPlugin();
+
+    // Documentation inherited
+    public: virtual void Load(sensors::SensorPtr _sensor,
+        sdf::ElementPtr _sdf);
+
+    /// \brief Called when the camera renders a frame.
+    /// \param[in] _image Pixels of the frame.
+    /// \param[in] _width Width of the frame.
+    /// \param[in] _height Height of the frame.
+    /// \param[in] _depth Bytes per pixel.
+    /// \param[in] _format Pixel format of the frame.
+    private: void OnNewFrame(const unsigned char *_image,
+        unsigned int _width, unsigned int _height, unsigned int _depth,
+        const std::string &_format);
+
+    /// \brief Called when a client moves the camera.
+    /// \param[in] _msg World pose of the camera.
+    private: void OnPose(ConstPosePtr &_msg);
+
+    /// \internal
+    /// \brief Private data pointer
+    private: std::unique_ptr<RemoteViewPluginPrivate> dataPtr;
+  };
+}
+#endif
@@ -23,11 +23,6 @@
 
 #include <boost/algorithm/string.hpp>
 
-#include <gazebo/physics/ode/ode_inc.h>
-#include <gazebo/physics/ode/ODELink.hh>
-#include <gazebo/physics/ode/ODECollision.hh>
-#include <gazebo/ode/contact.h>
-
 #include "gazebo/common/Plugin.hh"
 #include "gazebo/physics/physics.hh"
 #include "gazebo/transport/TransportTypes.hh"
@@ -42,8 +37,10 @@ namespace gazebo {
   ///        without grousers.
   /// \since 8.1
   ///
-  /// The motion model is based on adjusting motion1 in ODE contact properties
-  /// and on computing Instantaneous Center of Rotation for a tracked vehicle.
+  /// The motion model is based on driving the surface of the contacts of the
+  /// tracks (see physics::FrictionPyramid::SetTrackAxis) and on computing
+  /// Instantaneous Center of Rotation for a tracked vehicle. It works with
+  /// ODE and DART (6.10 and newer).
   /// A detailed description of the model is given in
   /// https://arxiv.org/abs/1703.04316 .
   ///
@@ -97,7 +94,8 @@ namespace gazebo {
     /// \brief Desired velocities of the tracks.
     protected: std::unordered_map<Tracks, double> trackVelocity;
 
-    /// \brief Compute and apply the forces that make the tracks move.
+    /// \brief Set the belt velocity and the center of rotation to the
+    ///        surfaces of the tracks, which the physics engine drives.
     protected: void DriveTracks(const common::UpdateInfo &/*_unused*/);
 
     /// \brief Return the number of tracks on the given side. Should always be
@@ -154,47 +152,6 @@ namespace gazebo {
     protected: static const unsigned int BELT_CATEGORY = 0x20000000;
     /// \brief Category for all items on the left side.
     protected: static const unsigned int LEFT_CATEGORY = 0x40000000;
-
-    private: physics::ContactManager *contactManager;
-
-    /// \class ContactIterator
-    /// \brief An iterator over all contacts between two geometries.
-    class ContactIterator : std::iterator<std::input_iterator_tag, dContact>
-    {
-      /// \brief The contact to return as the next element.
-      private: pointer currentContact;
-      /// \brief Index of the last examined joint.
-      private: size_t jointIndex;
-      /// \brief The body the contact should belong to.
-      private: dBodyID body;
-      /// \brief The geometries to search contacts for.
-      private: dGeomID geom1, geom2;
-      /// \brief True if at least one value has been returned.
-      private: bool initialized;
-
-      // Constructors.
-      public: ContactIterator();
-      public: explicit ContactIterator(bool _initialized);
-      public: ContactIterator(const ContactIterator &_rhs);
-      public: ContactIterator(dBodyID _body, dGeomID _geom1, dGeomID _geom2);
-
-      /// \brief Use to "instantiate" the iterator from user code
-      public: static ContactIterator begin(dBodyID _body, dGeomID _geom1,
-                                     dGeomID _geom2);
-      public: static ContactIterator end();
-
-      /// \brief Finding the next element; this is the main logic.
-      public: ContactIterator operator++();
-
-      // Operators. It is required to implement them in iterators.
-      public: bool operator==(const ContactIterator &_rhs);
-      public: ContactIterator &operator=(const ContactIterator &_rhs);
-      public: ContactIterator operator++(int _unused);
-      public: reference operator*();
-      public: pointer operator->();
-      public: pointer getPointer();
-      public: bool operator!=(const ContactIterator &_rhs);
-    };
   };
 }
 
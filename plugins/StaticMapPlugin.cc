@@ -16,6 +16,10 @@
 */
 
 #include <curl/curl.h>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <thread>
 #include <boost/filesystem.hpp>
 
 #include <ignition/math/Angle.hh>
@@ -24,7 +28,9 @@
 #include <ignition/math/Vector2.hh>
 #include <gazebo/physics/physics.hh>
 #include <gazebo/common/CommonIface.hh>
+#include <gazebo/common/Events.hh>
 #include <gazebo/transport/Node.hh>
+#include <gazebo/transport/TransportIface.hh>
 
 #include "StaticMapPlugin.hh"
 
@@ -50,6 +56,19 @@ namespace gazebo
   };
 
 
+  /// \brief A map tile image to download.
+  struct MapTile
+  {
+    /// \brief Static Maps API request.
+    std::string url;
+
+    /// \brief Path of the texture file.
+    std::string path;
+
+    /// \brief Path of the tile in the cache.
+    std::string cachePath;
+  };
+
   /// \brief Private data class for StaticMapPlugin
   class StaticMapPluginPrivate
   {
@@ -66,6 +85,8 @@ namespace gazebo
     /// \param[in] _apiKey Google API key
     /// \param[in] _saveDirPath Location in local filesystem to save tile
     /// images.
+    /// \return The tile image filenames, whether the download succeeded
+    /// or not.
     public: std::vector<std::string> DownloadMapTiles(const double _centerLat,
         const double _centerLon, const unsigned int _zoom,
         const unsigned int _tileSizePx,
@@ -73,6 +94,30 @@ namespace gazebo
         const std::string &_mapType, const std::string &_apiKey,
         const std::string &_saveDirPath);
 
+    /// \brief Download tiles that aren't in the cache, a few at a time.
+    /// The tiles that download successfully are copied into the cache.
+    /// \param[in] _tiles Tiles to download.
+    public: void FetchTiles(const std::vector<MapTile> &_tiles);
+
+    /// \brief Get the number of tiles along a side of the map.
+    /// \param[in] _metersPerPx Ground resolution.
+    /// \param[in] _tileSizePx Size of each map tile in pixels.
+    /// \param[in] _size Size of the side in meters.
+    /// \return Number of tiles.
+    public: unsigned int TileCount(const double _metersPerPx,
+        const unsigned int _tileSizePx, const double _size) const;
+
+    /// \brief Download the tiles, create the textured map model and spawn
+    /// it. Runs on fetchThread.
+    public: void CreateMap();
+
+    /// \brief Remove the placeholder once the map model is in the world.
+    public: void OnWorldUpdate();
+
+    /// \brief Spawn a plain ground in place of the map.
+    /// \param[in] _size Size of the map in meters.
+    public: void SpawnPlaceholder(const ignition::math::Vector2d &_size);
+
     /// \brief Create textured map model and save it in specified path.
     /// \param[in] _name Name of map model
     /// \param[in] _tileWorldSize Size of map tiles in meters
@@ -146,6 +191,22 @@ namespace gazebo
 
     /// \brief True if the plugin is loaded successfully
     public: bool loaded = false;
+
+    /// \brief Downloads the tiles and creates the model.
+    public: std::thread fetchThread;
+
+    /// \brief True to abort the downloads.
+    public: std::atomic<bool> stop{false};
+
+    /// \brief True once the map model was sent to the factory.
+    public: std::atomic<bool> mapSpawned{false};
+
+    /// \brief Name of the placeholder model.
+    public: std::string placeholderName;
+
+    /// \brief Connection to the world update, while the placeholder is
+    /// in the world.
+    public: event::ConnectionPtr updateConnection;
   };
 }
 
@@ -155,6 +216,8 @@ const unsigned int MercatorProjection::TILE_SIZE = 256;
 
 GZ_REGISTER_WORLD_PLUGIN(StaticMapPlugin)
 
+/// \brief Largest number of tiles downloaded at once.
+static const size_t kMaxTileTransfers = 8;
 
 /////////////////////////////////////////////////
 size_t WriteData(void *_ptr, size_t _size, size_t _nmemb, FILE *_stream)
@@ -162,60 +225,6 @@ size_t WriteData(void *_ptr, size_t _size, size_t _nmemb, FILE *_stream)
   return fwrite(_ptr, _size, _nmemb, _stream);
 }
 
-/////////////////////////////////////////////////
-bool DownloadFile(const std::string &_url, const std::string &_outputFile)
-{
-  if (_url.empty())
-    return false;
-
-  CURL *curl = curl_easy_init();
-
-  curl_easy_setopt(curl, CURLOPT_URL, _url.c_str());
-  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteData);
-
-  FILE *fp = fopen(_outputFile.c_str(), "wb");
-  if (!fp)
-  {
-    gzerr << "Could not download model[" << _url << "] because we were"
-      << "unable to write to file[" << _outputFile << "]."
-      << "Please fix file permissions.";
-    return false;
-  }
-  curl_easy_setopt(curl, CURLOPT_WRITEDATA, fp);
-
-  char errbuf[CURL_ERROR_SIZE];
-  // provide a buffer to store errors in
-  curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, errbuf);
-  // set the error buffer as empty before performing a request
-  errbuf[0] = 0;
-
-  CURLcode success = curl_easy_perform(curl);
-  if (success != CURLE_OK)
-  {
-    gzerr << "Error in REST request" << std::endl;
-    size_t len = strlen(errbuf);
-    fprintf(stderr, "\nlibcurl: (%d) ", success);
-    if (len)
-    {
-      fprintf(stderr, "%s%s", errbuf,
-              ((errbuf[len - 1] != '\n') ? "\n" : ""));
-    }
-    else
-      fprintf(stderr, "%s\n", curl_easy_strerror(success));
-  }
-  fclose(fp);
-
-  // Update the status code.
-  int statusCode = 0;
-  curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &statusCode);
-
-  // Cleaning.
-  curl_easy_cleanup(curl);
-
-  return true;
-}
-
-
 /////////////////////////////////////////////////
 ignition::math::Vector2d MercatorProjection::LatLonToPoint(
     const ignition::math::SphericalCoordinates &_latLon)
@@ -261,6 +270,15 @@ StaticMapPlugin::StaticMapPlugin()
 {
 }
 
+/////////////////////////////////////////////////
+StaticMapPlugin::~StaticMapPlugin()
+{
+  this->dataPtr->stop = true;
+  if (this->dataPtr->fetchThread.joinable())
+    this->dataPtr->fetchThread.join();
+  this->dataPtr->updateConnection.reset();
+}
+
 /////////////////////////////////////////////////
 void StaticMapPlugin::Load(physics::WorldPtr _world, sdf::ElementPtr _sdf)
 {
@@ -367,37 +385,63 @@ void StaticMapPlugin::Init()
     return;
   }
 
+  // Stand in for the map while the tiles download
+  double metersPerPx = this->dataPtr->GroundResolution(
+      IGN_DTOR(this->dataPtr->center.X()), this->dataPtr->zoom);
+  double tileWorldSize = metersPerPx * this->dataPtr->tileSizePx;
+  this->dataPtr->SpawnPlaceholder(ignition::math::Vector2d(
+      tileWorldSize * this->dataPtr->TileCount(metersPerPx,
+          this->dataPtr->tileSizePx, this->dataPtr->worldSize.X()),
+      tileWorldSize * this->dataPtr->TileCount(metersPerPx,
+          this->dataPtr->tileSizePx, this->dataPtr->worldSize.Y())));
+  this->dataPtr->updateConnection = event::Events::ConnectWorldUpdateBegin(
+      std::bind(&StaticMapPluginPrivate::OnWorldUpdate, this->dataPtr.get()));
+
+  // curl_global_init isn't thread safe
+  curl_global_init(CURL_GLOBAL_ALL);
+  this->dataPtr->fetchThread = std::thread(
+      &StaticMapPluginPrivate::CreateMap, this->dataPtr.get());
+}
+
+/////////////////////////////////////////////////
+void StaticMapPluginPrivate::CreateMap()
+{
+  auto basePath = common::SystemPaths::Instance()->GetLogPath() /
+        boost::filesystem::path("models");
+  boost::filesystem::path modelPath = basePath / this->modelName;
 
   // create tmp dir to save model files
   boost::filesystem::path tmpModelPath =
-      boost::filesystem::temp_directory_path() / this->dataPtr->modelName;
+      boost::filesystem::temp_directory_path() / this->modelName;
   boost::filesystem::path scriptsPath(tmpModelPath / "materials" / "scripts");
   boost::filesystem::create_directories(scriptsPath);
   boost::filesystem::path texturesPath(tmpModelPath / "materials" / "textures");
   boost::filesystem::create_directories(texturesPath);
 
   // download map tile images into model/materials/textures
-  std::vector<std::string> tiles = this->dataPtr->DownloadMapTiles(
-      this->dataPtr->center.X(),
-      this->dataPtr->center.Y(),
-      this->dataPtr->zoom,
-      this->dataPtr->tileSizePx,
-      this->dataPtr->worldSize,
-      this->dataPtr->mapType,
-      this->dataPtr->apiKey,
+  std::vector<std::string> tiles = this->DownloadMapTiles(
+      this->center.X(),
+      this->center.Y(),
+      this->zoom,
+      this->tileSizePx,
+      this->worldSize,
+      this->mapType,
+      this->apiKey,
       texturesPath.string());
 
+  if (this->stop)
+    return;
+
   // assume square model for now
   unsigned int xNumTiles = std::sqrt(tiles.size());
   unsigned int yNumTiles = xNumTiles;
 
-  double tileWorldSize = this->dataPtr->GroundResolution(
-      IGN_DTOR(this->dataPtr->center.X()), this->dataPtr->zoom)
-      * this->dataPtr->tileSizePx;
+  double tileWorldSize = this->GroundResolution(
+      IGN_DTOR(this->center.X()), this->zoom) * this->tileSizePx;
 
   // create model and spawn it into the world
-  if (this->dataPtr->CreateMapTileModel(
-      this->dataPtr->modelName, tileWorldSize,
+  if (this->CreateMapTileModel(
+      this->modelName, tileWorldSize,
       xNumTiles, yNumTiles, tiles, tmpModelPath.string()))
   {
     // verify model dir is created
@@ -429,14 +473,75 @@ void StaticMapPlugin::Init()
         }
       }
       // spawn the model
-      this->dataPtr->SpawnModel("model://" + this->dataPtr->modelName,
-          this->dataPtr->modelPose);
+      this->SpawnModel("model://" + this->modelName, this->modelPose);
+      this->mapSpawned = true;
     }
     else
       gzerr << "Failed to create model: " << tmpModelPath.string() << std::endl;
   }
 }
 
+/////////////////////////////////////////////////
+void StaticMapPluginPrivate::OnWorldUpdate()
+{
+  // Keep the placeholder until the map can replace it
+  if (!this->mapSpawned || !this->world->ModelByName(this->modelName))
+    return;
+
+  transport::requestNoReply(this->node, "entity_delete",
+      this->placeholderName);
+  this->updateConnection.reset();
+}
+
+/////////////////////////////////////////////////
+void StaticMapPluginPrivate::SpawnPlaceholder(
+    const ignition::math::Vector2d &_size)
+{
+  this->placeholderName = this->modelName + "_placeholder";
+
+  // Same collision as the map model
+  std::stringstream geometry;
+  geometry <<
+    "      <pose>0 0 -0.5 0 0 0</pose>\n"
+    "      <geometry>\n"
+    "        <box>\n"
+    "          <size>" << _size.X() << " " << _size.Y() << " 1</size>\n"
+    "        </box>\n"
+    "      </geometry>\n";
+
+  std::stringstream modelStr;
+  modelStr << "<sdf version='" << SDF_VERSION << "'>\n"
+    "<model name='" << this->placeholderName << "'>\n"
+    "  <static>true</static>\n"
+    "  <link name='link'>\n"
+    "    <collision name='collision'>\n" << geometry.str() <<
+    "    </collision>\n"
+    "    <visual name='visual'>\n" << geometry.str() <<
+    "      <material>\n"
+    "        <script>\n"
+    "          <uri>file://media/materials/scripts/gazebo.material</uri>\n"
+    "          <name>Gazebo/Grey</name>\n"
+    "        </script>\n"
+    "      </material>\n"
+    "    </visual>\n"
+    "  </link>\n"
+    "</model>\n"
+    "</sdf>";
+
+  msgs::Factory msg;
+  msg.set_sdf(modelStr.str());
+  msgs::Set(msg.mutable_pose(), this->modelPose);
+  this->factoryPub->Publish(msg);
+}
+
+/////////////////////////////////////////////////
+unsigned int StaticMapPluginPrivate::TileCount(const double _metersPerPx,
+    const unsigned int _tileSizePx, const double _size) const
+{
+  return static_cast<unsigned int>(
+      std::ceil(_size / _metersPerPx / _tileSizePx));
+}
+
 /////////////////////////////////////////////////
 double StaticMapPluginPrivate::GroundResolution(const double _lat,
     const unsigned int _zoom) const
@@ -467,13 +572,11 @@ std::vector<std::string> StaticMapPluginPrivate::DownloadMapTiles(
       this->GroundResolution(centerLatLon.LatitudeReference().Radian(), _zoom);
 
   // determine number of tiles necessary to cover specified world size
-  unsigned int xNumTiles = static_cast<unsigned int>(
-      std::ceil(_worldSize.X() / metersPerPx /
-      _tileSizePx));
+  unsigned int xNumTiles = this->TileCount(metersPerPx, _tileSizePx,
+      _worldSize.X());
   // y is only approximate because ground resolution is based on latitude
-  unsigned int yNumTiles = static_cast<unsigned int>(
-      std::ceil(_worldSize.Y() / metersPerPx /
-      _tileSizePx));
+  unsigned int yNumTiles = this->TileCount(metersPerPx, _tileSizePx,
+      _worldSize.Y());
 
   // scale for converting between pixel and world point
   double scale = std::pow(2, _zoom);
@@ -493,7 +596,14 @@ std::vector<std::string> StaticMapPluginPrivate::DownloadMapTiles(
     y += halfTileSize;
   double startx = x;
 
+  boost::filesystem::path cacheDir =
+      common::SystemPaths::Instance()->GetLogPath() /
+      boost::filesystem::path("map_tiles");
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(cacheDir, ec);
+
   // download map tiles using google static map API
+  std::vector<MapTile> toFetch;
   std::string url = "https://maps.googleapis.com/maps/api/staticmap";
   for (unsigned int i = 0; i < yNumTiles; ++i)
   {
@@ -521,18 +631,137 @@ std::vector<std::string> StaticMapPluginPrivate::DownloadMapTiles(
                << std::setprecision(9) << latLon.LatitudeReference().Degree()
                << "_" << latLon.LongitudeReference().Degree() << ".png";
       std::string fullPath = _saveDirPath + "/" + filename.str();
-      DownloadFile(fullURL, fullPath);
-      gzmsg << "Downloading map tile: " << filename.str() << std::endl;
       mapTileFilenames.push_back(filename.str());
 
+      // tiles are cached by map type, zoom, size and center
+      std::stringstream cacheName;
+      cacheName << _mapType << "_" << _zoom << "_" << _tileSizePx << "_"
+                << std::setprecision(9) << latLon.LatitudeReference().Degree()
+                << "_" << latLon.LongitudeReference().Degree() << ".png";
+      boost::filesystem::path cachePath = cacheDir / cacheName.str();
+
+      bool cached = false;
+      if (common::isFile(cachePath.string()) &&
+          boost::filesystem::file_size(cachePath) > 0)
+      {
+        boost::system::error_code ec;
+        boost::filesystem::remove(fullPath, ec);
+        boost::filesystem::copy_file(cachePath, fullPath, ec);
+        cached = !ec;
+      }
+
+      if (!cached)
+      {
+        gzmsg << "Downloading map tile: " << filename.str() << std::endl;
+        toFetch.push_back({fullURL, fullPath, cachePath.string()});
+      }
+
       x += _tileSizePx;
     }
     x = startx;
     y += _tileSizePx;
   }
+
+  this->FetchTiles(toFetch);
+
   return mapTileFilenames;
 }
 
+/////////////////////////////////////////////////
+void StaticMapPluginPrivate::FetchTiles(const std::vector<MapTile> &_tiles)
+{
+  CURLM *multi = curl_multi_init();
+
+  // Active transfers with their file and tile
+  std::map<CURL *, std::pair<FILE *, const MapTile *>> transfers;
+  size_t next = 0;
+
+  while (!this->stop && (next < _tiles.size() || !transfers.empty()))
+  {
+    // Keep a few downloads going
+    while (next < _tiles.size() && transfers.size() < kMaxTileTransfers)
+    {
+      const MapTile &tile = _tiles[next++];
+      FILE *fp = fopen(tile.path.c_str(), "wb");
+      if (!fp)
+      {
+        gzerr << "Could not download map tile[" << tile.path << "] because "
+          << "we were unable to write to the file. "
+          << "Please fix file permissions." << std::endl;
+        continue;
+      }
+
+      CURL *curl = curl_easy_init();
+      curl_easy_setopt(curl, CURLOPT_URL, tile.url.c_str());
+      curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteData);
+      curl_easy_setopt(curl, CURLOPT_WRITEDATA, fp);
+      curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+      curl_multi_add_handle(multi, curl);
+      transfers[curl] = std::make_pair(fp, &tile);
+    }
+
+    int running = 0;
+    curl_multi_perform(multi, &running);
+
+    CURLMsg *msg;
+    int queued;
+    while ((msg = curl_multi_info_read(multi, &queued)))
+    {
+      if (msg->msg != CURLMSG_DONE)
+        continue;
+
+      CURL *curl = msg->easy_handle;
+      CURLcode result = msg->data.result;
+      auto transfer = transfers.find(curl);
+      const MapTile &tile = *transfer->second.second;
+      fclose(transfer->second.first);
+
+      long statusCode = 0;
+      curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &statusCode);
+
+      if (result == CURLE_OK && statusCode == 200)
+      {
+        // Only complete tiles are cached
+        boost::system::error_code ec;
+        boost::filesystem::remove(tile.cachePath, ec);
+        boost::filesystem::copy_file(tile.path, tile.cachePath, ec);
+        if (ec)
+        {
+          gzwarn << "Unable to cache map tile[" << tile.cachePath << "]: "
+            << ec.message() << std::endl;
+        }
+      }
+      else if (result != CURLE_OK)
+      {
+        gzerr << "Error downloading map tile[" << tile.url << "]: "
+          << curl_easy_strerror(result) << std::endl;
+      }
+      else
+      {
+        gzerr << "Error downloading map tile[" << tile.url << "]: "
+          << "HTTP status " << statusCode << std::endl;
+      }
+
+      curl_multi_remove_handle(multi, curl);
+      curl_easy_cleanup(curl);
+      transfers.erase(transfer);
+    }
+
+    if (!transfers.empty())
+      curl_multi_wait(multi, nullptr, 0, 100, nullptr);
+  }
+
+  // Aborted downloads
+  for (auto &transfer : transfers)
+  {
+    curl_multi_remove_handle(multi, transfer.first);
+    curl_easy_cleanup(transfer.first);
+    fclose(transfer.second.first);
+  }
+
+  curl_multi_cleanup(multi);
+}
+
 /////////////////////////////////////////////////
 bool StaticMapPluginPrivate::CreateMapTileModel(
     const std::string &_name,
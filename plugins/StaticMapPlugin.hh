@@ -52,11 +52,19 @@ namespace gazebo
   ///              API documentation for more details.
   /// <use_cache>  Use model in gazebo model path if exists, otherwise
   ///              recreate the model and save it in <HOME>/.gazebo/models
+  ///
+  /// The tiles are downloaded in the background, several at a time, and
+  /// kept in <HOME>/.gazebo/map_tiles for the next maps that use them. A
+  /// plain ground model of the size of the map stands in until the
+  /// textured model is spawned.
   class GZ_PLUGIN_VISIBLE StaticMapPlugin : public WorldPlugin
   {
     /// \brief Constructor.
     public: StaticMapPlugin();
 
+    /// \brief Destructor, stops the tile downloads.
+    public: virtual ~StaticMapPlugin();
+
     /// \brief Load the plugin.
     /// \param[in] _world Pointer to world
     /// \param[in] _sdf Pointer to the SDF configuration.
@@ -14,8 +14,11 @@
  * limitations under the License.
  *
 */
+#include <functional>
 #include <map>
 #include <mutex>
+#include <utility>
+#include <vector>
 
 #include <gazebo/common/Assert.hh>
 #include <gazebo/common/CommonTypes.hh>
@@ -81,6 +84,17 @@ namespace gazebo
 
       /// \brief Publish slip for each wheel.
       public: transport::PublisherPtr slipPub;
+
+      /// \brief Link, joint and surface, cached for the updates. They are
+      /// valid while the plugin is registered to the WheelSlipService,
+      /// since the model unloads its plugins with its links.
+      public: physics::Link *linkHandle = nullptr;
+
+      /// \brief Cached wheel spin joint, see linkHandle.
+      public: physics::Joint *jointHandle = nullptr;
+
+      /// \brief Cached surface, see linkHandle.
+      public: physics::ODESurfaceParams *surfaceHandle = nullptr;
     };
 
     /// \brief Initial gravity direction in parent model frame.
@@ -100,6 +114,17 @@ namespace gazebo
     public: std::map<physics::LinkWeakPtr,
                         LinkSurfaceParams> mapLinkSurfaceParams;
 
+    /// \brief The wheels of mapLinkSurfaceParams, in a contiguous array for
+    /// the updates.
+    public: std::vector<LinkSurfaceParams *> wheels;
+
+    /// \brief Relative change of the ODE slip parameters below which they
+    /// aren't written to the surfaces.
+    public: double slipUpdateThreshold = 0;
+
+    /// \brief World whose WheelSlipService updates the plugin.
+    public: physics::World *world = nullptr;
+
     /// \brief Lateral slip compliance subscriber.
     /// \todo: Transition to ignition-transport in gazebo8.
     public: transport::SubscriberPtr lateralComplianceSub;
@@ -108,13 +133,100 @@ namespace gazebo
     /// \todo: Transition to ignition-transport in gazebo8.
     public: transport::SubscriberPtr longitudinalComplianceSub;
 
-    /// \brief Pointer to the update event connection
-    public: event::ConnectionPtr updateConnection;
   };
 }
 
 using namespace gazebo;
 
+namespace
+{
+  /// \brief Updates the wheel slip of all the plugins of a world, in a
+  /// single pass at the beginning of each world update, instead of
+  /// connecting each plugin to the event.
+  class WheelSlipService
+  {
+    /// \brief Update of a plugin.
+    private: using PluginUpdate =
+             std::pair<const WheelSlipPlugin *, std::function<void()>>;
+
+    /// \brief Register the update of a plugin.
+    /// \param[in] _world World of the plugin.
+    /// \param[in] _plugin The plugin.
+    /// \param[in] _update Function updating the wheels of the plugin.
+    public: static void Add(const physics::World *_world,
+                const WheelSlipPlugin *_plugin,
+                const std::function<void()> &_update)
+            {
+              std::lock_guard<std::mutex> lock(Mutex());
+              auto &service = Services()[_world];
+              if (!service)
+              {
+                service.reset(new WheelSlipService);
+                service->updateConnection =
+                  event::Events::ConnectWorldUpdateBegin(std::bind(
+                        &WheelSlipService::Update, service.get()));
+              }
+              service->updates.emplace_back(_plugin, _update);
+            }
+
+    /// \brief Unregister the update of a plugin. The service of the world
+    /// is removed with its last plugin.
+    /// \param[in] _world World of the plugin.
+    /// \param[in] _plugin The plugin.
+    public: static void Remove(const physics::World *_world,
+                const WheelSlipPlugin *_plugin)
+            {
+              std::lock_guard<std::mutex> lock(Mutex());
+              auto iter = Services().find(_world);
+              if (iter == Services().end())
+                return;
+
+              auto &updates = iter->second->updates;
+              for (auto update = updates.begin(); update != updates.end();
+                  ++update)
+              {
+                if (update->first == _plugin)
+                {
+                  updates.erase(update);
+                  break;
+                }
+              }
+              if (updates.empty())
+                Services().erase(iter);
+            }
+
+    /// \brief Update the wheels of all the plugins.
+    private: void Update()
+             {
+               std::lock_guard<std::mutex> lock(Mutex());
+               for (const auto &update : this->updates)
+                 update.second();
+             }
+
+    /// \brief Services, by world.
+    private: static std::map<const physics::World *,
+                 std::unique_ptr<WheelSlipService>> &Services()
+             {
+               static std::map<const physics::World *,
+                 std::unique_ptr<WheelSlipService>> services;
+               return services;
+             }
+
+    /// \brief Protects the services.
+    private: static std::mutex &Mutex()
+             {
+               static std::mutex mutex;
+               return mutex;
+             }
+
+    /// \brief Updates of the plugins, in registration order.
+    private: std::vector<PluginUpdate> updates;
+
+    /// \brief Connection to the world update event.
+    private: event::ConnectionPtr updateConnection;
+  };
+}
+
 // Register the plugin
 GZ_REGISTER_MODEL_PLUGIN(WheelSlipPlugin)
 
@@ -127,12 +239,18 @@ WheelSlipPlugin::WheelSlipPlugin()
 /////////////////////////////////////////////////
 WheelSlipPlugin::~WheelSlipPlugin()
 {
+  if (this->dataPtr->world)
+    WheelSlipService::Remove(this->dataPtr->world, this);
 }
 
 /////////////////////////////////////////////////
 void WheelSlipPlugin::Fini()
 {
-  this->dataPtr->updateConnection.reset();
+  if (this->dataPtr->world)
+  {
+    WheelSlipService::Remove(this->dataPtr->world, this);
+    this->dataPtr->world = nullptr;
+  }
 
   this->dataPtr->lateralComplianceSub.reset();
   this->dataPtr->longitudinalComplianceSub.reset();
@@ -161,6 +279,12 @@ void WheelSlipPlugin::Load(physics::ModelPtr _model, sdf::ElementPtr _sdf)
         initialModelRot.RotateVectorReverse(gravity.Normalized());
   }
 
+  if (_sdf->HasElement("slip_update_threshold"))
+  {
+    this->dataPtr->slipUpdateThreshold =
+      _sdf->Get<double>("slip_update_threshold");
+  }
+
   if (!_sdf->HasElement("wheel"))
   {
     gzerr << "No wheel tags specified, plugin is disabled" << std::endl;
@@ -241,6 +365,7 @@ void WheelSlipPlugin::Load(physics::ModelPtr _model, sdf::ElementPtr _sdf)
       continue;
     }
     params.surface = odeSurface;
+    params.surfaceHandle = odeSurface.get();
 
     auto joints = link->GetParentJoints();
     if (joints.empty() || joints.size() != 1)
@@ -260,6 +385,7 @@ void WheelSlipPlugin::Load(physics::ModelPtr _model, sdf::ElementPtr _sdf)
       continue;
     }
     params.joint = joint;
+    params.jointHandle = joint.get();
 
     if (params.wheelRadius <= 0)
     {
@@ -314,6 +440,7 @@ void WheelSlipPlugin::Load(physics::ModelPtr _model, sdf::ElementPtr _sdf)
       continue;
     }
 
+    params.linkHandle = link.get();
     this->dataPtr->mapLinkSurfaceParams[link] = params;
   }
 
@@ -335,6 +462,7 @@ void WheelSlipPlugin::Load(physics::ModelPtr _model, sdf::ElementPtr _sdf)
     auto &params = linkSurface.second;
     params.slipPub = this->dataPtr->gzNode->Advertise<msgs::Vector3d>(
         "~/" + _model->GetName() + "/wheel_slip/" + link->GetName());
+    this->dataPtr->wheels.push_back(&params);
   }
 
   this->dataPtr->lateralComplianceSub = this->dataPtr->gzNode->Subscribe(
@@ -345,8 +473,9 @@ void WheelSlipPlugin::Load(physics::ModelPtr _model, sdf::ElementPtr _sdf)
       "~/" + _model->GetName() + "/wheel_slip/longitudinal_compliance",
       &WheelSlipPlugin::OnLongitudinalCompliance, this);
 
-  // Connect to the update event
-  this->dataPtr->updateConnection = event::Events::ConnectWorldUpdateBegin(
+  // The wheels of all the plugins of the world are updated together
+  this->dataPtr->world = world.get();
+  WheelSlipService::Add(this->dataPtr->world, this,
       std::bind(&WheelSlipPlugin::Update, this));
 }
 
@@ -455,64 +584,73 @@ void WheelSlipPlugin::SetSlipComplianceLongitudinal(const double _compliance)
 /////////////////////////////////////////////////
 void WheelSlipPlugin::Update()
 {
-  // Get slip data so it can be published later
-  std::map<std::string, ignition::math::Vector3d> slips;
-  this->GetSlips(slips);
+  auto model = this->GetParentModel();
+  if (!model)
+    return;
+  const auto modelWorldRot = model->WorldPose().Rot();
 
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
-  for (const auto &linkSurface : this->dataPtr->mapLinkSurfaceParams)
+  for (auto *params : this->dataPtr->wheels)
   {
-    const auto &params = linkSurface.second;
-
-    // get user-defined normal force constant
-    double force = params.wheelNormalForce;
+    physics::Link *link = params->linkHandle;
+    physics::Joint *joint = params->jointHandle;
+
+    // Same slip as GetSlips, in a single pass with the slip compliance
+    const auto jointAxis = joint->GlobalAxis(0);
+    const auto wheelModelAxis =
+        modelWorldRot.RotateVectorReverse(jointAxis.Normalized());
+    const auto wheelModelLinearVel =
+        modelWorldRot.RotateVectorReverse(link->WorldLinearVel());
+    const auto longitudinalModelAxis =
+        this->dataPtr->initialGravityDirection.Cross(wheelModelAxis);
+    const double spinSpeed = params->wheelRadius * joint->GetVelocity(0);
 
     // get link angular velocity parallel to joint axis
-    ignition::math::Vector3d wheelAngularVelocity;
-    auto link = linkSurface.first.lock();
-    if (link)
-      wheelAngularVelocity = link->WorldAngularVel();
-
-    ignition::math::Vector3d jointAxis;
-    auto joint = params.joint.lock();
-    if (joint)
-      jointAxis = joint->GlobalAxis(0);
-
-    double spinAngularVelocity = wheelAngularVelocity.Dot(jointAxis);
-
-    auto surface = params.surface.lock();
-    if (surface)
+    const double spinAngularVelocity =
+        link->WorldAngularVel().Dot(jointAxis);
+
+    // As discussed in WheelSlipPlugin.hh, the ODE slip1 and slip2
+    // parameters have units of inverse viscous damping:
+    // [linear velocity / force] or [m / s / N].
+    // Since the slip compliance parameters supplied to the plugin
+    // are unitless, they must be scaled by a linear speed and force
+    // magnitude before being passed to ODE.
+    // The force is taken from a user-defined constant that should roughly
+    // match the steady-state normal force at the wheel.
+    // The linear speed is computed dynamically at each time step as
+    // radius * spin angular velocity.
+    // This choice of linear speed corresponds to the denominator of
+    // the slip ratio during acceleration (see equation (1) in
+    // Yoshida, Hamano 2002 DOI 10.1109/ROBOT.2002.1013712
+    // "Motion dynamics of a rover with slip-based traction model").
+    // The acceleration form is more well-behaved numerically at low-speed
+    // and when the vehicle is at rest than the braking form,
+    // so it is used for both slip directions.
+    const double speed = params->wheelRadius * std::abs(spinAngularVelocity);
+    const double slip1 =
+      speed / params->wheelNormalForce * params->slipComplianceLateral;
+    const double slip2 =
+      speed / params->wheelNormalForce * params->slipComplianceLongitudinal;
+
+    // Only write the surface when the slip changes enough
+    physics::ODESurfaceParams *surface = params->surfaceHandle;
+    const double threshold = this->dataPtr->slipUpdateThreshold;
+    if (std::abs(slip1 - surface->slip1) > threshold * std::abs(surface->slip1)
+        || std::abs(slip2 - surface->slip2) >
+        threshold * std::abs(surface->slip2))
     {
-      // As discussed in WheelSlipPlugin.hh, the ODE slip1 and slip2
-      // parameters have units of inverse viscous damping:
-      // [linear velocity / force] or [m / s / N].
-      // Since the slip compliance parameters supplied to the plugin
-      // are unitless, they must be scaled by a linear speed and force
-      // magnitude before being passed to ODE.
-      // The force is taken from a user-defined constant that should roughly
-      // match the steady-state normal force at the wheel.
-      // The linear speed is computed dynamically at each time step as
-      // radius * spin angular velocity.
-      // This choice of linear speed corresponds to the denominator of
-      // the slip ratio during acceleration (see equation (1) in
-      // Yoshida, Hamano 2002 DOI 10.1109/ROBOT.2002.1013712
-      // "Motion dynamics of a rover with slip-based traction model").
-      // The acceleration form is more well-behaved numerically at low-speed
-      // and when the vehicle is at rest than the braking form,
-      // so it is used for both slip directions.
-      double speed = params.wheelRadius * std::abs(spinAngularVelocity);
-      surface->slip1 = speed / force * params.slipComplianceLateral;
-      surface->slip2 = speed / force * params.slipComplianceLongitudinal;
+      surface->slip1 = slip1;
+      surface->slip2 = slip2;
     }
 
     // Try to publish slip data for this wheel
-    if (link)
+    if (params->slipPub)
     {
-      msgs::Vector3d msg;
-      auto name = link->GetName();
-      msg = msgs::Convert(slips[name]);
-      if (params.slipPub)
-        params.slipPub->Publish(msg);
+      ignition::math::Vector3d slip;
+      slip.X(longitudinalModelAxis.Dot(wheelModelLinearVel) - spinSpeed);
+      slip.Y(wheelModelAxis.Dot(wheelModelLinearVel));
+      slip.Z(spinSpeed);
+      params->slipPub->Publish(msgs::Convert(slip));
     }
   }
 }
@@ -50,6 +50,10 @@ namespace gazebo
   /// the linear wheel spin velocity and divided by the wheel_normal_force
   /// parameter specified below in order to match the units of the ODE
   /// slip parameters.
+  /// The wheels of all the plugins of a world are updated in a single pass.
+  /// The optional slip_update_threshold parameter is the relative change of
+  /// the ODE slip parameters below which they are not written to the
+  /// surface (default 0, writing every change).
   ///
   /// A graphical interpretation of these parameters is provided below
   /// for a positive value of slip compliance.
@@ -77,6 +81,7 @@ namespace gazebo
         |
 
     <plugin filename="libWheelSlipPlugin.so" name="wheel_slip">
+      <slip_update_threshold>0.01</slip_update_threshold>
       <wheel link_name="wheel_front_left">
         <slip_compliance_lateral>0</slip_compliance_lateral>
         <slip_compliance_longitudinal>0.1</slip_compliance_longitudinal>
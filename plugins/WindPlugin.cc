@@ -18,8 +18,6 @@
 #include <functional>
 
 #include "gazebo/common/Assert.hh"
-#include "gazebo/common/Event.hh"
-#include "gazebo/common/Events.hh"
 
 #include "gazebo/sensors/Noise.hh"
 
@@ -31,9 +29,6 @@ class gazebo::WindPluginPrivate
   /// \brief World pointer.
   public: physics::WorldPtr world;
 
-  /// \brief Connection to World Update events.
-  public: event::ConnectionPtr updateConnection;
-
   /// \brief Time for wind to rise
   public: double characteristicTimeForWindRise = 1;
 
@@ -223,8 +218,11 @@ void WindPlugin::Load(physics::WorldPtr _world, sdf::ElementPtr _sdf)
   wind.SetLinearVelFunc(std::bind(&WindPlugin::LinearVel, this,
         std::placeholders::_1, std::placeholders::_2));
 
-  this->dataPtr->updateConnection = event::Events::ConnectWorldUpdateBegin(
-          std::bind(&WindPlugin::OnUpdate, this));
+  // Drag towards the wind velocity, the force on mass approximation, which
+  // the world computes for all the links at once. This is not recommended.
+  // Please use the LiftDragPlugin instead.
+  this->dataPtr->world->ForceField().SetWindDrag(
+      this->dataPtr->forceApproximationScalingFactor);
 }
 
 /////////////////////////////////////////////////
@@ -287,33 +285,3 @@ ignition::math::Vector3d WindPlugin::LinearVel(const physics::Wind *_wind,
 
   return windVel;
 }
-
-/////////////////////////////////////////////////
-void WindPlugin::OnUpdate()
-{
-  // Update loop for using the force on mass approximation
-  // This is not recommended. Please use the LiftDragPlugin instead.
-
-  // Get all the models
-  physics::Model_V models = this->dataPtr->world->Models();
-
-  // Process each model.
-  for (auto const &model : models)
-  {
-    // Get all the links
-    physics::Link_V links = model->GetLinks();
-
-    // Process each link.
-    for (auto const &link : links)
-    {
-      // Skip links for which the wind is disabled
-      if (!link->WindMode())
-        continue;
-
-      // Add wind velocity as a force to the body
-      link->AddRelativeForce(link->GetInertial()->Mass() *
-          this->dataPtr->forceApproximationScalingFactor *
-          (link->RelativeWindLinearVel() - link->RelativeLinearVel()));
-    }
-  }
-}
@@ -62,9 +62,6 @@ namespace gazebo
             const physics::Wind *_wind,
             const physics::Entity *_entity);
 
-    /// \brief Callback for World Update events.
-    private: void OnUpdate();
-
     /// \internal
     /// \brief Pointer to private data.
     private: std::unique_ptr<WindPluginPrivate> dataPtr;
@@ -107,6 +107,11 @@ void InRegionEventSource::Update()
     return;
 
   ignition::math::Vector3d point = this->model->WorldPose().Pos();
+  if (this->checked && point == this->lastPoint)
+    return;
+  this->checked = true;
+  this->lastPoint = point;
+
   bool oldState = this->isInside;
   bool currentState = this->region->Contains(point);
 
@@ -73,6 +73,13 @@ namespace gazebo
 
     /// \brief true if the model is currently inside the region
     private: bool isInside;
+
+    /// \brief Position of the model at the last check. The region doesn't
+    /// move, so the check is skipped until the model does.
+    private: ignition::math::Vector3d lastPoint;
+
+    /// \brief True once the model was checked against the region.
+    private: bool checked = false;
   };
 }
 #endif
@@ -103,19 +103,13 @@ void OccupiedEventSource::Load(const sdf::ElementPtr _sdf)
 /////////////////////////////////////////////////
 void OccupiedEventSource::Update()
 {
-  // Get all the models.
-  physics::Model_V models = this->world->Models();
+  RegionPtr region = this->regions[this->regionName];
 
-  // Process each model.
-  for (physics::Model_V::iterator iter = models.begin();
-       iter != models.end(); ++iter)
+  // Process each model inside the region.
+  for (auto const &model : region->Models(*this->world))
   {
-    // Skip models that are static
-    if ((*iter)->IsStatic())
-      continue;
-
-    // If inside, then transmit the desired message.
-    if (this->regions[this->regionName]->Contains((*iter)->WorldPose().Pos()))
+    // If not static, then transmit the desired message.
+    if (!model->IsStatic())
     {
       this->msgPub->Publish(this->msg);
     }
@@ -15,7 +15,12 @@
  *
 */
 
+#include <algorithm>
+#include <set>
+
 #include <gazebo/common/Console.hh>
+#include <gazebo/physics/Model.hh>
+#include <gazebo/physics/World.hh>
 #include "plugins/events/Region.hh"
 
 using namespace gazebo;
@@ -33,6 +38,35 @@ bool Region::Contains(const ignition::math::Vector3d &_p) const
   return false;
 }
 
+/////////////////////////////////////////////
+physics::Model_V Region::Models(const physics::World &_world) const
+{
+  // Each box of the region can return the same model
+  std::set<unsigned int> seen;
+  physics::Model_V result;
+  for (auto const &box : this->boxes)
+  {
+    for (auto const &model : _world.ModelsInBox(box))
+    {
+      // Skip nested models
+      if (boost::dynamic_pointer_cast<physics::Model>(model->GetParent()))
+        continue;
+
+      if (seen.insert(model->GetId()).second &&
+          this->Contains(model->WorldPose().Pos()))
+      {
+        result.push_back(model);
+      }
+    }
+  }
+  std::sort(result.begin(), result.end(),
+      [](const physics::ModelPtr &_a, const physics::ModelPtr &_b)
+      {
+        return _a->GetId() < _b->GetId();
+      });
+  return result;
+}
+
 /////////////////////////////////////////////
 void Region::Load(const sdf::ElementPtr &_sdf)
 {
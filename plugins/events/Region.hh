@@ -25,6 +25,8 @@
 #include <ignition/math/Vector3.hh>
 #include <ignition/math/AxisAlignedBox.hh>
 
+#include "gazebo/physics/PhysicsTypes.hh"
+
 namespace gazebo
 {
   /// \brief A region, made of a list of boxes
@@ -45,6 +47,13 @@ namespace gazebo
     /// \return True if point is in region
     public: bool Contains(const ignition::math::Vector3d &_p) const;
 
+    /// \brief Get the top level models whose origin lies inside the region.
+    /// Only the models near the boxes are checked, as found by the spatial
+    /// index of the world, which all the regions share.
+    /// \param[in] _world The world of the models.
+    /// \return The models, ordered by id.
+    public: physics::Model_V Models(const physics::World &_world) const;
+
     /// \brief Output operator to print a region to the console.
     /// \param[in] _out The output stream.
     /// \param[in] _region The instance to write out.
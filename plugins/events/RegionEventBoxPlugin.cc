@@ -15,6 +15,10 @@
  *
 */
 
+#include <cmath>
+
+#include <ignition/math/Matrix3.hh>
+
 #include "RegionEventBoxPlugin.hh"
 
 using namespace gazebo;
@@ -119,24 +123,44 @@ void RegionEventBoxPlugin::OnUpdate(const common::UpdateInfo &_info)
     }
   }
 
-  // check if any model in the world is in the region or if a model that was
-  // previously in the region has exited the region.
-  for (unsigned int i = 0; i < this->world->ModelCount(); ++i)
+  // Only the models near the region can be inside it, the others are
+  // left out by the spatial index of the world. The models that were
+  // inside are tested too, to find those that exited.
+  std::map<std::string, physics::ModelPtr> candidates;
+  for (auto const &m : this->world->ModelsInBox(this->WorldBounds()))
+  {
+    // Skip nested models
+    if (!boost::dynamic_pointer_cast<physics::Model>(m->GetParent()))
+      candidates[m->GetName()] = m;
+  }
+  for (auto const &insider : this->insiders)
   {
-    physics::ModelPtr m = this->world->ModelByIndex(i);
-    std::string name = m->GetName();
+    if (candidates.find(insider.first) != candidates.end())
+      continue;
+
+    physics::ModelPtr m = this->world->ModelByName(insider.first);
+    if (m)
+      candidates[insider.first] = m;
+  }
+
+  // check if any model near the region is in the region or if a model that
+  // was previously in the region has exited the region.
+  for (auto const &candidate : candidates)
+  {
+    const std::string &name = candidate.first;
+    const physics::ModelPtr &m = candidate.second;
 
     if (name == "ground_plane" || name == this->modelName)
       continue;
 
-    auto it = this->insiders.find(m->GetName());
+    auto it = this->insiders.find(name);
 
     if (this->PointInRegion(m->WorldPose().Pos(), this->box,
         this->boxPose))
     {
       if (it == this->insiders.end())
       {
-        this->insiders[m->GetName()] = _info.simTime;
+        this->insiders[name] = _info.simTime;
         if (this->eventPub)
           this->SendEnteringRegionEvent(m);
       }
@@ -148,12 +172,30 @@ void RegionEventBoxPlugin::OnUpdate(const common::UpdateInfo &_info)
         if (this->eventPub)
           this->SendExitingRegionEvent(m);
 
-        this->insiders.erase(m->GetName());
+        this->insiders.erase(it);
       }
     }
   }
 }
 
+//////////////////////////////////////////////////
+ignition::math::AxisAlignedBox RegionEventBoxPlugin::WorldBounds() const
+{
+  // The region is a box of the size of this->box rotated about its center,
+  // this->boxPose
+  const ignition::math::Vector3d half = this->box.Size() * 0.5;
+  const ignition::math::Matrix3d rot(this->boxPose.Rot());
+  auto extent = [&](const unsigned int _row)
+  {
+    return std::fabs(rot(_row, 0)) * half.X() +
+      std::fabs(rot(_row, 1)) * half.Y() + std::fabs(rot(_row, 2)) * half.Z();
+  };
+  const ignition::math::Vector3d size(extent(0), extent(1), extent(2));
+
+  return ignition::math::AxisAlignedBox(this->boxPose.Pos() - size,
+      this->boxPose.Pos() + size);
+}
+
 //////////////////////////////////////////////////
 bool RegionEventBoxPlugin::PointInRegion(
     const ignition::math::Vector3d &_point,
@@ -73,6 +73,10 @@ namespace gazebo
     private: void UpdateRegion(const ignition::math::Vector3d &_size,
         const ignition::math::Pose3d &_pose);
 
+    /// \brief Get the world frame bounding box of the rotated region.
+    /// \return Bounding box of the region.
+    private: ignition::math::AxisAlignedBox WorldBounds() const;
+
     /// \brief Send event when model enters box region
     /// \param[in] _model Model that entered the box region.
     private: void SendEnteringRegionEvent(physics::ModelPtr _model) const;
@@ -16,6 +16,8 @@
 */
 #include <iostream>
 #include <cstring>
+#include <list>
+#include <vector>
 #include <stdlib.h>
 #include <curl/curl.h>
 #include <inttypes.h>
@@ -182,15 +184,89 @@ static size_t WriteMemoryCallback(void *_contents,
   return realsize;
 }
 
+/////////////////////////////////////////////////
+// callback for libcurl when data is read from the response of a queued post
+static size_t WriteStringCallback(void *_contents,
+                                  size_t _size,
+                                  size_t _nmemb,
+                                  void *_userp)
+{
+  size_t realsize = _size * _nmemb;
+  static_cast<std::string *>(_userp)->append(
+      static_cast<char *>(_contents), realsize);
+  return realsize;
+}
+
+/////////////////////////////////////////////////
+// Options shared by the login request and the posts
+static void SetRequestOptions(CURL *_curl,
+                              const std::string &_path,
+                              const std::string &_userpass)
+{
+  curl_easy_setopt(_curl, CURLOPT_URL, _path.c_str());
+
+  // skip peer verification
+  curl_easy_setopt(_curl, CURLOPT_SSL_VERIFYPEER, 0L);
+  // skip host verification
+  curl_easy_setopt(_curl, CURLOPT_SSL_VERIFYHOST, 0L);
+
+  // some servers don't like requests that are made without a user-agent
+  // field, so we provide one
+  curl_easy_setopt(_curl, CURLOPT_USERAGENT, "libcurl-agent/1.0");
+
+  // set user name and password for the authentication
+  curl_easy_setopt(_curl, CURLOPT_HTTPAUTH, CURLAUTH_BASIC);
+  curl_easy_setopt(_curl, CURLOPT_USERPWD, _userpass.c_str());
+
+  // connection timeout 10 sec
+  curl_easy_setopt(_curl, CURLOPT_CONNECTTIMEOUT, 10L);
+}
+
+// Maximum number of posts waiting to be sent
+static const size_t kMaxPosts = 1000;
+
+// Maximum number of posts sent at the same time
+static const size_t kMaxTransfers = 8;
+
+// Number of attempts after which a post is dropped
+static const unsigned int kMaxAttempts = 5;
+
+// Delay before the first retry, doubled at each attempt
+static const std::chrono::milliseconds kRetryDelay(500);
+
+// A post being sent by the posting thread
+struct Transfer
+{
+  CURL *handle = nullptr;
+  struct curl_slist *headers = nullptr;
+  std::string path;
+  std::string userpass;
+  std::string response;
+};
+
 /////////////////////////////////////////////////
 RestApi::RestApi()
-  :isLoggedIn(false)
+  :isLoggedIn(false), droppedPosts(0), stopPosts(false)
 {
+  curl_global_init(CURL_GLOBAL_ALL);
+  this->postsThread = std::thread(&RestApi::RunPosts, this);
 }
 
 /////////////////////////////////////////////////
 RestApi::~RestApi()
 {
+  {
+    std::lock_guard<std::mutex> lock(this->postsMutex);
+    this->stopPosts = true;
+  }
+  this->postsCondition.notify_all();
+  if (this->postsThread.joinable())
+    this->postsThread.join();
+
+  if (!this->posts.empty())
+  {
+    gzwarn << this->posts.size() << " post(s) were not sent" << std::endl;
+  }
   curl_global_cleanup();
 }
 
@@ -202,9 +278,24 @@ void RestApi::PostJsonData(const char *_route, const char *_json)
   post.json = _json;
   {
     std::lock_guard<std::mutex> lock(this->postsMutex);
+    if (this->posts.size() >= kMaxPosts)
+    {
+      if (this->droppedPosts++ % 100 == 0)
+      {
+        gzwarn << "REST post queue is full, dropping the oldest post ("
+               << this->droppedPosts << " dropped so far)" << std::endl;
+      }
+      this->posts.pop_front();
+    }
     this->posts.push_back(post);
+
+    if (!this->isLoggedIn)
+    {
+      gzmsg << this->posts.size() << " post(s) queued to be sent"
+            << std::endl;
+    }
   }
-  this->SendUnpostedPosts();
+  this->postsCondition.notify_one();
 }
 
 /////////////////////////////////////////////////
@@ -213,10 +304,13 @@ std::string RestApi::Login(const std::string &_urlStr,
                            const std::string &_userStr,
                            const std::string &_passStr)
 {
-  this->isLoggedIn = false;
-  this->url = _urlStr;
-  this->user = _userStr;
-  this->pass = _passStr;
+  {
+    std::lock_guard<std::mutex> lock(this->postsMutex);
+    this->isLoggedIn = false;
+    this->url = _urlStr;
+    this->user = _userStr;
+    this->pass = _passStr;
+  }
 
   // at this point we want to test the (user supplied) login data
   // so we're hitting the server on the login route ('/login')
@@ -228,7 +322,7 @@ std::string RestApi::Login(const std::string &_urlStr,
   gzmsg << "login response: " << resp << std::endl;
 
   this->isLoggedIn = true;
-  this->SendUnpostedPosts();
+  this->postsCondition.notify_one();
   return resp;
 }
 
@@ -240,29 +334,168 @@ void RestApi::Logout()
 }
 
 /////////////////////////////////////////////////
-void RestApi::SendUnpostedPosts()
+void RestApi::RunPosts()
 {
-  if (this->isLoggedIn)
+  CURLM *multi = curl_multi_init();
+
+  // Easy handles are kept between posts, so that connections to the
+  // server are reused.
+  std::vector<CURL *> idleHandles;
+  // A list, since curl keeps pointers to the transfers
+  std::list<std::pair<Transfer, Post>> transfers;
+
+  while (true)
   {
-    while (!this->posts.empty())
+    // Start as many ready posts as the transfer limit allows
     {
-      Post post;
+      std::unique_lock<std::mutex> lock(this->postsMutex);
+      if (transfers.empty())
       {
-        std::lock_guard<std::mutex> lock(this->postsMutex);
-        post = this->posts.front();
+        this->postsCondition.wait_for(lock, std::chrono::milliseconds(100));
+      }
+      if (this->stopPosts)
+        break;
+
+      auto now = std::chrono::steady_clock::now();
+      for (auto iter = this->posts.begin();
+           this->isLoggedIn && iter != this->posts.end() &&
+           transfers.size() < kMaxTransfers;)
+      {
+        if (iter->retryTime > now)
+        {
+          ++iter;
+          continue;
+        }
+
+        Transfer transfer;
+        if (idleHandles.empty())
+        {
+          transfer.handle = curl_easy_init();
+        }
+        else
+        {
+          transfer.handle = idleHandles.back();
+          idleHandles.pop_back();
+        }
+        transfer.path = this->url + iter->route;
+        transfer.userpass = this->user + ":" + this->pass;
+        transfers.emplace_back(transfer, *iter);
+        iter = this->posts.erase(iter);
+      }
+    }
+
+    // Configure the new transfers
+    for (auto &t : transfers)
+    {
+      Transfer &transfer = t.first;
+      if (transfer.headers)
+        continue;
+
+      CURL *curl = transfer.handle;
+      SetRequestOptions(curl, transfer.path, transfer.userpass);
+      curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteStringCallback);
+      curl_easy_setopt(curl, CURLOPT_WRITEDATA,
+          static_cast<void *>(&transfer.response));
+      curl_easy_setopt(curl, CURLOPT_PRIVATE, &t);
+
+      //  You can generate a similar request on the cmd line like so:
+      //  curl --verbose --connect-timeout 5 -X POST
+      //    -H \"Content-Type: application/json \" -k --user"
+      curl_easy_setopt(curl, CURLOPT_POST, 1L);
+      curl_easy_setopt(curl, CURLOPT_POSTFIELDS, t.second.json.c_str());
+      transfer.headers = curl_slist_append(transfer.headers,
+          "Content-Type: application/json");
+      transfer.headers = curl_slist_append(transfer.headers,
+          "charsets: utf-8");
+      curl_easy_setopt(curl, CURLOPT_HTTPHEADER, transfer.headers);
+      curl_multi_add_handle(multi, curl);
+    }
+
+    if (transfers.empty())
+      continue;
+
+    int running = 0;
+    curl_multi_perform(multi, &running);
+
+    bool done = false;
+    int queued = 0;
+    CURLMsg *info;
+    while ((info = curl_multi_info_read(multi, &queued)))
+    {
+      if (info->msg != CURLMSG_DONE)
+        continue;
+
+      std::pair<Transfer, Post> *t = nullptr;
+      curl_easy_getinfo(info->easy_handle, CURLINFO_PRIVATE, &t);
+      Transfer &transfer = t->first;
+      Post &post = t->second;
+
+      int64_t httpCode = 0;
+      curl_easy_getinfo(transfer.handle, CURLINFO_RESPONSE_CODE, &httpCode);
+
+      // Connection errors and server errors are retried, the posts which
+      // the server rejects are not.
+      bool retry = false;
+      if (info->data.result != CURLE_OK)
+      {
+        gzerr << "Request to " << transfer.path << " failed: "
+              << curl_easy_strerror(info->data.result) << std::endl;
+        retry = true;
+      }
+      else if (httpCode != 200)
+      {
+        gzerr << "Request to " << transfer.path << " error: "
+              << transfer.response << std::endl;
+        retry = httpCode >= 500;
+      }
 
-        //  You can generate a similar request on the cmd line like so:
-        //  curl --verbose --connect-timeout 5 -X POST
-        //    -H \"Content-Type: application/json \" -k --user"
-        this->Request(post.route, post.json);
-        this->posts.pop_front();
+      if (retry && ++post.attempts < kMaxAttempts)
+      {
+        post.retryTime = std::chrono::steady_clock::now() +
+            kRetryDelay * (1 << (post.attempts - 1));
+
+        std::lock_guard<std::mutex> lock(this->postsMutex);
+        if (this->posts.size() < kMaxPosts)
+          this->posts.push_front(post);
+        else
+          ++this->droppedPosts;
+      }
+      else if (retry)
+      {
+        gzerr << "Giving up on a post to " << transfer.path << " after "
+              << post.attempts << " attempts" << std::endl;
       }
+
+      curl_multi_remove_handle(multi, transfer.handle);
+      curl_slist_free_all(transfer.headers);
+      curl_easy_reset(transfer.handle);
+      idleHandles.push_back(transfer.handle);
+      transfer.handle = nullptr;
+      done = true;
+    }
+
+    if (done)
+    {
+      transfers.remove_if([](const std::pair<Transfer, Post> &_t)
+          {
+            return _t.first.handle == nullptr;
+          });
+      continue;
     }
+
+    // Wait for some activity on the connections, or for new posts
+    curl_multi_wait(multi, nullptr, 0, 100, nullptr);
   }
-  else
+
+  for (auto &t : transfers)
   {
-    gzmsg << posts.size() << " post(s) queued to be sent" << std::endl;
+    curl_multi_remove_handle(multi, t.first.handle);
+    curl_slist_free_all(t.first.headers);
+    curl_easy_cleanup(t.first.handle);
   }
+  for (auto handle : idleHandles)
+    curl_easy_cleanup(handle);
+  curl_multi_cleanup(multi);
 }
 
 /////////////////////////////////////////////////
@@ -285,8 +518,9 @@ std::string RestApi::Request(const std::string &_reqUrl,
   }
   // build full url (with server)
   std::string path = url + _reqUrl;
+  std::string userpass = this->user + ":" + this->pass;
   CURL *curl = curl_easy_init();
-  curl_easy_setopt(curl, CURLOPT_URL, path.c_str() );
+  SetRequestOptions(curl, path, userpass);
 
   // in case things go wrong
   if (trace_requests)
@@ -309,14 +543,6 @@ std::string RestApi::Request(const std::string &_reqUrl,
   // will be grown as needed by the realloc above
   chunk.memory = static_cast<char*>(malloc(1));
   chunk.size = 0;            // no data at this point
-  // bool secure = false;
-  // if (!secure)
-  {
-    // skip peer verification
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
-    // skip host verification
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
-  }
 
   // send all data to this function
   curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteMemoryCallback);
@@ -325,18 +551,6 @@ std::string RestApi::Request(const std::string &_reqUrl,
                    CURLOPT_WRITEDATA,
                    static_cast<void *>(&chunk));
 
-  // some servers don't like requests that are made without a user-agent
-  // field, so we provide one
-  curl_easy_setopt(curl, CURLOPT_USERAGENT, "libcurl-agent/1.0");
-
-  // set user name and password for the authentication
-  curl_easy_setopt(curl, CURLOPT_HTTPAUTH, CURLAUTH_BASIC);
-  std::string userpass = this->user + ":" + this->pass;
-  curl_easy_setopt(curl, CURLOPT_USERPWD, userpass.c_str());
-
-  // connection timeout 10 sec
-  curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 10);
-
   // is this a POST?
   struct curl_slist *slist = NULL;
   if (!_postJsonStr.empty())
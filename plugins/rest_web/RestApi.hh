@@ -18,9 +18,13 @@
 #ifndef GAZEBO_PLUGINS_REST_WEB_RESTAPI_HH_
 #define GAZEBO_PLUGINS_REST_WEB_RESTAPI_HH_
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <string>
-#include <list>
 #include <mutex>
+#include <thread>
 #include <gazebo/common/Console.hh>
 
 #include "RestException.hh"
@@ -28,7 +32,9 @@
 namespace gazebo
 {
   /// \class RestApi RestApi.hh RestApi.hh
-  /// \brief REST interface
+  /// \brief REST interface. Posts are queued and sent by a background
+  /// thread, which keeps a few requests in flight on a curl multi handle
+  /// and retries the failed ones.
   class RestApi
   {
     /// \brief Constructor
@@ -53,7 +59,9 @@ namespace gazebo
     /// a new call to Login has to be made to resume sending messages.
     public: void Logout();
 
-    /// \brief Notify the service with a http POST
+    /// \brief Notify the service with a http POST. The post is queued
+    /// and this returns without waiting for the server. When the queue
+    /// is full, the oldest post is dropped.
     /// \param[in] _route on the web server
     /// \param[in] _json the data to send to the server
     public: void PostJsonData(const char *_route, const char *_json);
@@ -71,8 +79,8 @@ namespace gazebo
     private: std::string Request(const std::string &_requestUrl,
                                  const std::string &_postStr);
 
-    /// \brief Sends unposted posts
-    private: void SendUnpostedPosts();
+    /// \brief Entry point of the thread that sends the queued posts
+    private: void RunPosts();
 
     /// \brief Login information: REST service host url
     private: std::string url;
@@ -87,20 +95,40 @@ namespace gazebo
     private: std::string loginRoute;
 
     /// \brief True when a previous Login attempt was successful
-    private: bool isLoggedIn;
+    private: std::atomic<bool> isLoggedIn;
 
     /// \brief A post: what (json) and where (route)
     private: struct Post
       {
         std::string route;
         std::string json;
+
+        /// \brief Number of failed attempts to send the post
+        unsigned int attempts = 0;
+
+        /// \brief The post isn't sent again before this time
+        std::chrono::steady_clock::time_point retryTime;
       };
 
-    /// \brief List of unposted posts. Posts await when isLoggedIn is false
-    private: std::list<Post> posts;
+    /// \brief Queue of unposted posts. Posts await when isLoggedIn is
+    /// false, and while their retry time is in the future.
+    private: std::deque<Post> posts;
+
+    /// \brief Number of posts dropped because the queue was full
+    private: unsigned int droppedPosts;
 
-    /// \brief A mutex to ensure integrity of the post list
+    /// \brief A mutex to ensure integrity of the post list and of the
+    /// login information
     private: std::mutex postsMutex;
+
+    /// \brief Wakes up the posting thread
+    private: std::condition_variable postsCondition;
+
+    /// \brief True to stop the posting thread
+    private: bool stopPosts;
+
+    /// \brief Thread that sends the posts
+    private: std::thread postsThread;
   };
 }
 
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <benchmark/benchmark.h>
+#include <string>
+
+#include "gazebo/common/ColladaLoader.hh"
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshManager.hh"
+#include "gazebo/common/Time.hh"
+#include "gazebo/msgs/msgs.hh"
+#include "test_config.h"
+
+using namespace gazebo;
+
+/// \brief Mesh loaded by the mesh benchmarks.
+static const std::string kMesh = PROJECT_SOURCE_PATH
+    "/test/data/cordless_drill/meshes/cordless_drill.dae";
+
+/////////////////////////////////////////////////
+/// \brief Conversion of a pose to a message and back.
+static void BM_MsgsConvertPose(::benchmark::State &_state)
+{
+  ignition::math::Pose3d pose(1, 2, 3, 0.1, 0.2, 0.3);
+  for (auto _ : _state)
+  {
+    const msgs::Pose msg = msgs::Convert(pose);
+    pose = msgs::ConvertIgn(msg);
+  }
+  ::benchmark::DoNotOptimize(pose);
+}
+BENCHMARK(BM_MsgsConvertPose);
+
+/////////////////////////////////////////////////
+/// \brief Conversion of a time to a message and back.
+static void BM_MsgsConvertTime(::benchmark::State &_state)
+{
+  common::Time time(12, 345);
+  for (auto _ : _state)
+  {
+    const msgs::Time msg = msgs::Convert(time);
+    time = msgs::Convert(msg);
+  }
+  ::benchmark::DoNotOptimize(time);
+}
+BENCHMARK(BM_MsgsConvertTime);
+
+/////////////////////////////////////////////////
+/// \brief Serialization and parsing of a pose message, as the transport
+/// does for every message.
+static void BM_MsgsSerializePose(::benchmark::State &_state)
+{
+  const msgs::Pose msg = msgs::Convert(ignition::math::Pose3d(
+        1, 2, 3, 0.1, 0.2, 0.3));
+  std::string data;
+  msgs::Pose parsed;
+  for (auto _ : _state)
+  {
+    msg.SerializeToString(&data);
+    parsed.ParseFromString(data);
+  }
+  _state.SetBytesProcessed(_state.iterations() * data.size());
+}
+BENCHMARK(BM_MsgsSerializePose);
+
+/////////////////////////////////////////////////
+/// \brief Load of a Collada mesh which isn't in the cache of the mesh
+/// manager.
+static void BM_MeshLoadCollada(::benchmark::State &_state)
+{
+  common::ColladaLoader loader;
+  for (auto _ : _state)
+  {
+    common::Mesh *mesh = loader.Load(kMesh);
+    ::benchmark::DoNotOptimize(mesh);
+    delete mesh;
+  }
+}
+BENCHMARK(BM_MeshLoadCollada)->Unit(::benchmark::kMillisecond);
+
+/////////////////////////////////////////////////
+/// \brief MeshManager::Load of a mesh already in the cache, as every
+/// visual and collision of a model using it does.
+static void BM_MeshManagerLoadCached(::benchmark::State &_state)
+{
+  common::MeshManager *manager = common::MeshManager::Instance();
+  manager->Load(kMesh);
+  for (auto _ : _state)
+    ::benchmark::DoNotOptimize(manager->Load(kMesh));
+}
+BENCHMARK(BM_MeshManagerLoadCached);
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <benchmark/benchmark.h>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/gazebo.hh"
+#include "gazebo/physics/World.hh"
+#include "test_config.h"
+#include "BenchmarkWorld.hh"
+
+using namespace gazebo;
+
+namespace
+{
+  /// \brief The world shared by the benchmarks.
+  physics::WorldPtr g_world;
+}
+
+/////////////////////////////////////////////////
+physics::WorldPtr gazebo::BenchmarkWorld()
+{
+  return g_world;
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+
+  common::Console::SetQuiet(true);
+  if (!gazebo::setupServer())
+  {
+    gzerr << "Unable to set up the server\n";
+    return 1;
+  }
+
+  g_world = gazebo::loadWorld(PROJECT_SOURCE_PATH
+      "/test/worlds/benchmark.world");
+  if (!g_world)
+  {
+    gzerr << "Unable to load the benchmark world\n";
+    gazebo::shutdown();
+    return 1;
+  }
+
+  // Let the boxes settle on the ground
+  gazebo::runWorld(g_world, 100);
+
+  ::benchmark::RunSpecifiedBenchmarks();
+
+  g_world.reset();
+  gazebo::shutdown();
+  return 0;
+}
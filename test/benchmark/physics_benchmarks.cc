@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "gazebo/gazebo.hh"
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/physics/ContactManager.hh"
+#include "gazebo/physics/PhysicsEngine.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/physics/WorldState.hh"
+#include "gazebo/transport/Node.hh"
+#include "BenchmarkWorld.hh"
+
+using namespace gazebo;
+
+/////////////////////////////////////////////////
+/// \brief Contacts callback, which only makes ~/physics/contacts have a
+/// subscriber.
+static void OnContacts(ConstContactsPtr &/*_msg*/)
+{
+}
+
+/////////////////////////////////////////////////
+/// \brief Whole steps of the world: physics, contacts, plugins and the
+/// publication of its state. Each iteration runs 100 steps, so that the
+/// start of the world's loop is amortized. Items are steps.
+static void BM_WorldStep(::benchmark::State &_state)
+{
+  physics::WorldPtr world = BenchmarkWorld();
+  for (auto _ : _state)
+    gazebo::runWorld(world, 100);
+  _state.SetItemsProcessed(_state.iterations() * 100);
+}
+BENCHMARK(BM_WorldStep)->Unit(::benchmark::kMicrosecond);
+
+/////////////////////////////////////////////////
+/// \brief The collision phase of a step, ODEPhysics::UpdateCollision with
+/// the default engine.
+static void BM_PhysicsUpdateCollision(::benchmark::State &_state)
+{
+  physics::PhysicsEnginePtr engine = BenchmarkWorld()->Physics();
+  for (auto _ : _state)
+    engine->UpdateCollision();
+}
+BENCHMARK(BM_PhysicsUpdateCollision)->Unit(::benchmark::kMicrosecond);
+
+/////////////////////////////////////////////////
+/// \brief The dynamics phase of a step.
+static void BM_PhysicsUpdatePhysics(::benchmark::State &_state)
+{
+  physics::PhysicsEnginePtr engine = BenchmarkWorld()->Physics();
+  for (auto _ : _state)
+  {
+    engine->UpdateCollision();
+    engine->UpdatePhysics();
+  }
+}
+BENCHMARK(BM_PhysicsUpdatePhysics)->Unit(::benchmark::kMicrosecond);
+
+/////////////////////////////////////////////////
+/// \brief Publication of the contacts of the resting boxes, to a
+/// subscriber of ~/physics/contacts.
+static void BM_ContactManagerPublishContacts(::benchmark::State &_state)
+{
+  physics::WorldPtr world = BenchmarkWorld();
+  transport::NodePtr node(new transport::Node());
+  node->Init(world->Name());
+  transport::SubscriberPtr sub = node->Subscribe("~/physics/contacts",
+      &OnContacts);
+
+  // Wait for the publisher to see the subscriber
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  physics::PhysicsEnginePtr engine = world->Physics();
+  physics::ContactManager *manager = engine->GetContactManager();
+  engine->UpdateCollision();
+  for (auto _ : _state)
+    manager->PublishContacts();
+  _state.counters["contacts"] = manager->GetContactCount();
+}
+BENCHMARK(BM_ContactManagerPublishContacts)->Unit(::benchmark::kMicrosecond);
+
+/////////////////////////////////////////////////
+/// \brief Serialization of the state of the world, as the state log does.
+static void BM_WorldStateSerialize(::benchmark::State &_state)
+{
+  physics::WorldState worldState(BenchmarkWorld());
+  std::size_t bytes = 0;
+  for (auto _ : _state)
+  {
+    std::ostringstream stream;
+    stream << worldState;
+    bytes += stream.str().size();
+  }
+  _state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_WorldStateSerialize)->Unit(::benchmark::kMicrosecond);
+
+/////////////////////////////////////////////////
+/// \brief Parsing of the state of the world, as log playback does.
+static void BM_WorldStateParse(::benchmark::State &_state)
+{
+  physics::WorldPtr world = BenchmarkWorld();
+  physics::WorldState worldState(world);
+
+  std::ostringstream stream;
+  stream << "<sdf version='" << SDF_VERSION << "'>" << worldState << "</sdf>";
+  const std::string data = stream.str();
+
+  sdf::ElementPtr stateElem(new sdf::Element);
+  sdf::initFile("state.sdf", stateElem);
+  for (auto _ : _state)
+  {
+    stateElem->Clear();
+    sdf::readString(data, stateElem);
+    physics::WorldState parsed;
+    parsed.Load(stateElem);
+    ::benchmark::DoNotOptimize(parsed.GetModelStateCount());
+  }
+  _state.SetBytesProcessed(_state.iterations() * data.size());
+}
+BENCHMARK(BM_WorldStateParse)->Unit(::benchmark::kMicrosecond);
+
+/////////////////////////////////////////////////
+/// \brief Conversion of the state of the world to a message, as the world
+/// publishes it.
+static void BM_WorldStateFillMsg(::benchmark::State &_state)
+{
+  physics::WorldState worldState(BenchmarkWorld());
+  for (auto _ : _state)
+  {
+    msgs::WorldState msg;
+    worldState.FillMsg(msg);
+    ::benchmark::DoNotOptimize(msg.ByteSizeLong());
+  }
+}
+BENCHMARK(BM_WorldStateFillMsg)->Unit(::benchmark::kMicrosecond);
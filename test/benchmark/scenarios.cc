@@ -0,0 +1,441 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// Scenario benchmarks: generate a world which scales with a count, run it
+// headless for a fixed simulation time, and report its real time factor,
+// step times, memory and the time of each profiled zone in JSON.
+//
+// Usage: gazebo_scenarios --scenario <robots|boxes|imu|ray|camera>
+//            [--count N] [--sim-time seconds] [--output file.json]
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Events.hh"
+#include "gazebo/common/Profiler.hh"
+#include "gazebo/common/UpdateInfo.hh"
+#include "gazebo/gazebo.hh"
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/PhysicsEngine.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/sensors/SensorsIface.hh"
+#include "gazebo/transport/Node.hh"
+#include "gazebo/transport/Publisher.hh"
+
+using namespace gazebo;
+
+namespace
+{
+  /// \brief Maximum number of boxes in a stack.
+  const int kBoxesPerStack = 10;
+
+  /// \brief Number of steps run before the measured ones, in which the
+  /// populations insert their models.
+  const unsigned int kWarmupSteps = 100;
+
+  /// \brief Get the number of rows and columns of a grid of _count models.
+  /// \param[in] _count Number of models.
+  /// \param[out] _rows Number of rows.
+  /// \param[out] _cols Number of columns.
+  void GridSize(const int _count, int &_rows, int &_cols)
+  {
+    _cols = std::max(1, static_cast<int>(std::ceil(std::sqrt(_count))));
+    _rows = (_count + _cols - 1) / _cols;
+  }
+
+  /// \brief Generate a population on a grid, which clones a model.
+  /// \param[in] _name Name of the population.
+  /// \param[in] _model SDF of the model, named _name.
+  /// \param[in] _count Number of models.
+  /// \param[in] _step Distance between two models of the grid.
+  /// \return SDF of the population.
+  std::string GridPopulation(const std::string &_name,
+      const std::string &_model, const int _count, const double _step)
+  {
+    int rows, cols;
+    GridSize(_count, rows, cols);
+
+    // The grid has rows * cols models, and a last partial row would need
+    // a second population
+    std::ostringstream sdf;
+    const int fullRows = _count / cols;
+    const int rest = _count % cols;
+    for (int i = 0; i < (rest ? 2 : 1); ++i)
+    {
+      const int populationRows = i == 0 ? fullRows : 1;
+      const int populationCols = i == 0 ? cols : rest;
+      if (populationRows == 0)
+        continue;
+
+      sdf << "<population name='" << _name << "_" << i << "'>"
+          << "<model name='" << _name << "_" << i << "'>" << _model
+          << "</model>"
+          << "<pose>" << -cols * _step * 0.5 << " "
+          << (i == 0 ? -rows * _step * 0.5 : (fullRows - rows * 0.5) * _step)
+          << " 0 0 0 0</pose>"
+          << "<distribution><type>grid</type>"
+          << "<rows>" << populationRows << "</rows>"
+          << "<cols>" << populationCols << "</cols>"
+          << "<step>" << _step << " " << _step << " 0</step>"
+          << "</distribution></population>";
+    }
+    return sdf.str();
+  }
+
+  /// \brief Generate the content of a box link.
+  /// \param[in] _size Size of the box.
+  /// \param[in] _mass Mass of the box.
+  /// \return SDF of the collision, visual and inertial of the link.
+  std::string BoxLink(const std::string &_size, const double _mass)
+  {
+    std::ostringstream sdf;
+    sdf << "<inertial><mass>" << _mass << "</mass></inertial>"
+        << "<collision name='collision'><geometry><box><size>" << _size
+        << "</size></box></geometry></collision>"
+        << "<visual name='visual'><geometry><box><size>" << _size
+        << "</size></box></geometry></visual>";
+    return sdf.str();
+  }
+
+  /// \brief Generate a differential drive robot, driven by DiffDrivePlugin.
+  /// \return SDF of the content of the model.
+  std::string Robot()
+  {
+    std::ostringstream sdf;
+    sdf << "<link name='chassis'><pose>0 0 0.1 0 0 0</pose>"
+        << BoxLink("0.4 0.3 0.1", 5.0)
+        << "<collision name='caster'><pose>0.15 0 -0.05 0 0 0</pose>"
+        << "<geometry><sphere><radius>0.05</radius></sphere></geometry>"
+        << "<surface><friction><ode><mu>0</mu><mu2>0</mu2></ode>"
+        << "</friction></surface></collision></link>";
+
+    for (const std::string side : {"left", "right"})
+    {
+      const double y = side == "left" ? 0.175 : -0.175;
+      sdf << "<link name='" << side << "_wheel'>"
+          << "<pose>-0.1 " << y << " 0.1 -1.5707 0 0</pose>"
+          << "<inertial><mass>0.5</mass></inertial>"
+          << "<collision name='collision'><geometry><cylinder>"
+          << "<radius>0.1</radius><length>0.05</length>"
+          << "</cylinder></geometry></collision>"
+          << "<visual name='visual'><geometry><cylinder>"
+          << "<radius>0.1</radius><length>0.05</length>"
+          << "</cylinder></geometry></visual></link>"
+          << "<joint name='" << side << "_joint' type='revolute'>"
+          << "<parent>chassis</parent><child>" << side << "_wheel</child>"
+          << "<axis><xyz>0 0 1</xyz></axis></joint>";
+    }
+
+    sdf << "<plugin name='diff_drive' filename='libDiffDrivePlugin.so'>"
+        << "<left_joint>left_joint</left_joint>"
+        << "<right_joint>right_joint</right_joint></plugin>";
+    return sdf.str();
+  }
+
+  /// \brief Generate stacks of boxes, whose contacts the scenario stresses.
+  /// \param[in] _count Number of boxes.
+  /// \return SDF of the populations.
+  std::string BoxStacks(const int _count)
+  {
+    const std::string box = "<link name='link'>" +
+        BoxLink("0.5 0.5 0.5", 1.0) + "</link>";
+
+    // A population per stack, with the boxes 0.51 m apart along z
+    int rows, cols;
+    const int stacks = (_count + kBoxesPerStack - 1) / kBoxesPerStack;
+    GridSize(stacks, rows, cols);
+
+    std::ostringstream sdf;
+    for (int i = 0; i < stacks; ++i)
+    {
+      const int boxes = std::min(kBoxesPerStack, _count - i * kBoxesPerStack);
+      sdf << "<population name='stack_" << i << "'>"
+          << "<model name='box_" << i << "'>" << box << "</model>"
+          << "<pose>" << (i % cols) * 1.5 - 0.25 << " "
+          << (i / cols) * 1.5 - 0.25 << " 0.25 0 0 0</pose>"
+          << "<box><size>0.5 0.5 " << boxes * 0.51 << "</size></box>"
+          << "<model_count>" << boxes << "</model_count>"
+          << "<distribution><type>linear-z</type></distribution>"
+          << "</population>";
+    }
+    return sdf.str();
+  }
+
+  /// \brief Generate a static model with a sensor.
+  /// \param[in] _type Sensor type: imu, ray or camera.
+  /// \return SDF of the content of the model.
+  std::string SensorModel(const std::string &_type)
+  {
+    std::ostringstream sdf;
+    sdf << "<static>true</static><link name='link'>"
+        << "<pose>0 0 0.5 0 0 0</pose>" << BoxLink("0.1 0.1 0.1", 0.1)
+        << "<sensor name='sensor' type='" << _type << "'>"
+        << "<always_on>1</always_on>";
+    if (_type == "imu")
+    {
+      sdf << "<update_rate>100</update_rate>";
+    }
+    else if (_type == "ray")
+    {
+      sdf << "<update_rate>10</update_rate><ray><scan><horizontal>"
+          << "<samples>640</samples><resolution>1</resolution>"
+          << "<min_angle>-2.26889</min_angle><max_angle>2.268899</max_angle>"
+          << "</horizontal></scan><range><min>0.1</min><max>10</max>"
+          << "<resolution>0.01</resolution></range></ray>";
+    }
+    else
+    {
+      sdf << "<update_rate>30</update_rate><camera>"
+          << "<horizontal_fov>1.047</horizontal_fov>"
+          << "<image><width>320</width><height>240</height></image>"
+          << "<clip><near>0.1</near><far>100</far></clip></camera>";
+    }
+    sdf << "</sensor></link>";
+    return sdf.str();
+  }
+
+  /// \brief Generate the world of a scenario.
+  /// \param[in] _scenario Name of the scenario.
+  /// \param[in] _count Number of robots, boxes or sensors.
+  /// \param[out] _sdf SDF of the world.
+  /// \return False if the scenario is unknown.
+  bool ScenarioWorld(const std::string &_scenario, const int _count,
+      std::string &_sdf)
+  {
+    std::string models;
+    if (_scenario == "robots")
+      models = GridPopulation("robot", Robot(), _count, 1.0);
+    else if (_scenario == "boxes")
+      models = BoxStacks(_count);
+    else if (_scenario == "imu" || _scenario == "ray" ||
+        _scenario == "camera")
+      models = GridPopulation(_scenario, SensorModel(_scenario), _count, 1.0);
+    else
+      return false;
+
+    // Unthrottled, so that the real time factor shows the cost of a step
+    std::ostringstream sdf;
+    sdf << "<?xml version='1.0' ?><sdf version='1.6'>"
+        << "<world name='default'>"
+        << "<physics type='ode'>"
+        << "<real_time_update_rate>0</real_time_update_rate></physics>"
+        << "<include><uri>model://ground_plane</uri></include>"
+        << "<include><uri>model://sun</uri></include>"
+        << models << "</world></sdf>";
+    _sdf = sdf.str();
+    return true;
+  }
+
+  /// \brief Drive the robots of the robots scenario in circles.
+  /// \param[in] _world The world.
+  /// \param[in] _node Node advertising the velocity commands.
+  /// \param[out] _pubs Publishers of the commands, kept until the end.
+  void DriveRobots(const physics::WorldPtr &_world,
+      const transport::NodePtr &_node,
+      std::vector<transport::PublisherPtr> &_pubs)
+  {
+    const msgs::Pose cmd = msgs::Convert(ignition::math::Pose3d(
+          0.5, 0, 0, 0, 0, 0.3));
+    for (unsigned int i = 0; i < _world->ModelCount(); ++i)
+    {
+      const std::string name = _world->ModelByIndex(i)->GetName();
+      if (name.find("robot_") != 0)
+        continue;
+
+      transport::PublisherPtr pub = _node->Advertise<msgs::Pose>(
+          "~/" + name + "/vel_cmd");
+      pub->WaitForConnection(common::Time(1, 0));
+      pub->Publish(cmd);
+      _pubs.push_back(pub);
+    }
+  }
+
+  /// \brief Get a percentile of sorted values.
+  /// \param[in] _values Sorted values.
+  /// \param[in] _percentile Percentile, in [0, 100].
+  /// \return The value, or 0 if there is none.
+  double Percentile(const std::vector<double> &_values,
+      const double _percentile)
+  {
+    if (_values.empty())
+      return 0.0;
+    const std::size_t index = std::min(_values.size() - 1,
+        static_cast<std::size_t>(_percentile / 100.0 * _values.size()));
+    return _values[index];
+  }
+
+  /// \brief Escape a string for JSON.
+  /// \param[in] _str The string.
+  /// \return The escaped string, in quotes.
+  std::string Quote(const std::string &_str)
+  {
+    std::string quoted = "\"";
+    for (const char c : _str)
+    {
+      if (c == '"' || c == '\\')
+        quoted += '\\';
+      quoted += c;
+    }
+    return quoted + "\"";
+  }
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  std::string scenario;
+  int count = 10;
+  double simTime = 5.0;
+  std::string output;
+  for (int i = 1; i + 1 < argc; i += 2)
+  {
+    const std::string arg = argv[i];
+    if (arg == "--scenario")
+      scenario = argv[i + 1];
+    else if (arg == "--count")
+      count = std::atoi(argv[i + 1]);
+    else if (arg == "--sim-time")
+      simTime = std::atof(argv[i + 1]);
+    else if (arg == "--output")
+      output = argv[i + 1];
+  }
+
+  std::string worldSdf;
+  if (count <= 0 || simTime <= 0.0 ||
+      !ScenarioWorld(scenario, count, worldSdf))
+  {
+    std::cerr << "Usage: gazebo_scenarios --scenario "
+              << "<robots|boxes|imu|ray|camera> [--count N] "
+              << "[--sim-time seconds] [--output file.json]\n";
+    return 1;
+  }
+
+  // The generated world is kept with the results, to reproduce them
+  const std::string worldFile = "scenario_" + scenario + "_" +
+      std::to_string(count) + ".world";
+  {
+    std::ofstream file(worldFile);
+    file << worldSdf;
+  }
+
+  common::Console::SetQuiet(true);
+  if (!gazebo::setupServer())
+  {
+    std::cerr << "Unable to set up the server\n";
+    return 1;
+  }
+
+  physics::WorldPtr world = gazebo::loadWorld(worldFile);
+  if (!world)
+  {
+    std::cerr << "Unable to load the world of the scenario\n";
+    gazebo::shutdown();
+    return 1;
+  }
+
+  sensors::run_threads();
+  gazebo::runWorld(world, kWarmupSteps);
+
+  transport::NodePtr node(new transport::Node());
+  node->Init(world->Name());
+  std::vector<transport::PublisherPtr> pubs;
+  if (scenario == "robots")
+    DriveRobots(world, node, pubs);
+
+  // Wall time of each step, from the start of an update to the next one
+  std::vector<double> stepTimes;
+  const unsigned int steps = static_cast<unsigned int>(
+      simTime / world->Physics()->GetMaxStepSize());
+  stepTimes.reserve(steps);
+  std::chrono::steady_clock::time_point previous;
+  event::ConnectionPtr updateConnection =
+    event::Events::ConnectWorldUpdateBegin(
+        [&](const common::UpdateInfo &)
+        {
+          const auto now = std::chrono::steady_clock::now();
+          if (previous != std::chrono::steady_clock::time_point())
+          {
+            stepTimes.push_back(
+                std::chrono::duration<double, std::micro>(
+                  now - previous).count());
+          }
+          previous = now;
+        });
+
+  common::Profiler::Clear();
+  common::Profiler::SetEnabled(true);
+  const common::Time simStart = world->SimTime();
+  const auto wallStart = std::chrono::steady_clock::now();
+  gazebo::runWorld(world, steps);
+  const double wallTime = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - wallStart).count();
+  const double simElapsed = (world->SimTime() - simStart).Double();
+  common::Profiler::SetEnabled(false);
+  updateConnection.reset();
+
+  std::sort(stepTimes.begin(), stepTimes.end());
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+
+  std::ostringstream json;
+  json << "{\"scenario\":" << Quote(scenario)
+       << ",\"count\":" << count
+       << ",\"models\":" << world->ModelCount()
+       << ",\"steps\":" << steps
+       << ",\"sim_time\":" << simElapsed
+       << ",\"wall_time\":" << wallTime
+       << ",\"rtf\":" << (wallTime > 0.0 ? simElapsed / wallTime : 0.0)
+       << ",\"step_time_us\":{"
+       << "\"p50\":" << Percentile(stepTimes, 50)
+       << ",\"p90\":" << Percentile(stepTimes, 90)
+       << ",\"p99\":" << Percentile(stepTimes, 99)
+       << ",\"max\":" << (stepTimes.empty() ? 0.0 : stepTimes.back())
+       << "}"
+       << ",\"max_rss_kb\":" << usage.ru_maxrss
+       << ",\"zones_s\":{";
+  bool first = true;
+  for (const auto &zone : common::Profiler::ZoneTotals())
+  {
+    json << (first ? "" : ",") << Quote(zone.first) << ":" << zone.second;
+    first = false;
+  }
+  json << "}}\n";
+
+  std::cout << json.str();
+  if (!output.empty())
+  {
+    std::ofstream file(output);
+    file << json.str();
+  }
+
+  pubs.clear();
+  node.reset();
+  world.reset();
+  gazebo::shutdown();
+  return 0;
+}
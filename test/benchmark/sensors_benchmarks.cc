@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <benchmark/benchmark.h>
+#include <string>
+
+#include "gazebo/physics/World.hh"
+#include "gazebo/rendering/RenderingIface.hh"
+#include "gazebo/rendering/Scene.hh"
+#include "gazebo/sensors/RaySensor.hh"
+#include "gazebo/sensors/SensorsIface.hh"
+#include "BenchmarkWorld.hh"
+
+using namespace gazebo;
+
+/////////////////////////////////////////////////
+/// \brief Update of a ray sensor of 640x8 rays, around the boxes.
+static void BM_RaySensorUpdate(::benchmark::State &_state)
+{
+  // Initialize the sensors of the world
+  sensors::run_once(true);
+  sensors::RaySensorPtr sensor = std::dynamic_pointer_cast<
+    sensors::RaySensor>(sensors::get_sensor("laser"));
+  if (!sensor)
+  {
+    _state.SkipWithError("Unable to get the ray sensor");
+    return;
+  }
+
+  for (auto _ : _state)
+    sensor->Update(true);
+  _state.SetItemsProcessed(_state.iterations() * sensor->RayCount() *
+      sensor->VerticalRayCount());
+}
+BENCHMARK(BM_RaySensorUpdate)->Unit(::benchmark::kMicrosecond);
+
+/////////////////////////////////////////////////
+/// \brief Scene::PreRender of the scene of the world, which applies the
+/// poses of the visuals. It's skipped when the rendering engine can't be
+/// initialized, such as without a display.
+static void BM_ScenePreRender(::benchmark::State &_state)
+{
+  const std::string name = BenchmarkWorld()->Name();
+  rendering::ScenePtr scene = rendering::get_scene(name);
+  if (!scene)
+  {
+    try
+    {
+      scene = rendering::create_scene(name, false, true);
+    }
+    catch(...)
+    {
+      // Skipped below
+    }
+  }
+
+  if (!scene)
+  {
+    _state.SkipWithError("Unable to create a rendering scene");
+    return;
+  }
+
+  for (auto _ : _state)
+    scene->PreRender();
+}
+BENCHMARK(BM_ScenePreRender)->Unit(::benchmark::kMicrosecond);
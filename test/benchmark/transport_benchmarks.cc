@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/transport/Connection.hh"
+#include "gazebo/transport/Node.hh"
+#include "gazebo/transport/Publisher.hh"
+
+using namespace gazebo;
+
+/// \brief Number of messages received by OnPose.
+static std::atomic<uint64_t> g_poses(0);
+
+/////////////////////////////////////////////////
+/// \brief Pose callback, which counts the messages.
+static void OnPose(ConstPosePtr &/*_msg*/)
+{
+  ++g_poses;
+}
+
+/////////////////////////////////////////////////
+/// \brief Publication of a pose to a subscriber of the same process.
+static void BM_PublisherPublish(::benchmark::State &_state)
+{
+  transport::NodePtr node(new transport::Node());
+  node->Init("benchmark");
+  transport::PublisherPtr pub =
+    node->Advertise<msgs::Pose>("~/benchmark/pose", 1000);
+  transport::SubscriberPtr sub = node->Subscribe("~/benchmark/pose",
+      &OnPose);
+  pub->WaitForConnection(common::Time(1, 0));
+
+  const msgs::Pose msg = msgs::Convert(ignition::math::Pose3d(
+        1, 2, 3, 0.1, 0.2, 0.3));
+  for (auto _ : _state)
+    pub->Publish(msg);
+  _state.SetItemsProcessed(_state.iterations());
+}
+BENCHMARK(BM_PublisherPublish);
+
+/////////////////////////////////////////////////
+/// \brief Throughput of a TCP connection on the loopback interface, from
+/// the enqueueing of the messages to their reception.
+static void BM_ConnectionThroughput(::benchmark::State &_state)
+{
+  std::atomic<uint64_t> received(0);
+  std::mutex mutex;
+  transport::ConnectionPtr accepted;
+  std::thread reader;
+
+  transport::ConnectionPtr server(new transport::Connection());
+  server->Listen(0, [&](const transport::ConnectionPtr &_conn)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        accepted = _conn;
+        reader = std::thread([_conn, &received]()
+            {
+              std::string data;
+              while (_conn->Read(data))
+                ++received;
+            });
+      });
+
+  transport::ConnectionPtr client(new transport::Connection());
+  if (!client->Connect("127.0.0.1", server->GetLocalPort()))
+  {
+    _state.SkipWithError("Unable to connect on the loopback interface");
+    return;
+  }
+
+  const std::string payload(_state.range(0), 'x');
+  uint64_t sent = 0;
+  for (auto _ : _state)
+  {
+    client->EnqueueMsg(payload, true);
+    ++sent;
+  }
+
+  // Wait for the messages to arrive, for at most 10 seconds
+  for (int i = 0; i < 10000 && received < sent; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  _state.SetBytesProcessed(received * payload.size());
+  _state.SetItemsProcessed(received);
+
+  client->Shutdown();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (accepted)
+      accepted->Shutdown();
+  }
+  if (reader.joinable())
+    reader.join();
+  server->Shutdown();
+}
+BENCHMARK(BM_ConnectionThroughput)->Arg(64)->Arg(4096)->Arg(1 << 20);
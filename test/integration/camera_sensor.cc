@@ -1868,3 +1868,205 @@ TEST_F(CameraSensor, Light)
   }
   EXPECT_EQ(newColor, sun->DiffuseColor());
 }
+
+/////////////////////////////////////////////////
+// Compressed images received by the Compressed test
+std::vector<gazebo::msgs::CompressedImage> g_compressedImages;
+
+/////////////////////////////////////////////////
+void OnCompressedImage(ConstCompressedImagePtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  g_compressedImages.push_back(*_msg);
+}
+
+/////////////////////////////////////////////////
+TEST_F(CameraSensor, Compressed)
+{
+  this->Load("worlds/empty.world");
+
+  // Make sure the render engine is available.
+  if (rendering::RenderEngine::Instance()->GetRenderPathType() ==
+      rendering::RenderEngine::NONE)
+  {
+    gzerr << "No rendering engine, unable to run camera test\n";
+    return;
+  }
+
+  const std::string cameraName = "compressed_camera";
+  std::ostringstream sdfStream;
+  sdfStream << "<sdf version='" << SDF_VERSION << "'>"
+    << "<model name='compressed_model'>"
+    << "  <static>true</static>"
+    << "  <pose>-5 0 0.5 0 0 0</pose>"
+    << "  <link name='body'>"
+    << "    <sensor name='" << cameraName << "' type='camera'>"
+    << "      <always_on>1</always_on>"
+    << "      <update_rate>10</update_rate>"
+    << "      <camera>"
+    << "        <horizontal_fov>1.0</horizontal_fov>"
+    << "        <image>"
+    << "          <width>320</width>"
+    << "          <height>240</height>"
+    << "        </image>"
+    << "        <clip><near>0.1</near><far>100</far></clip>"
+    << "        <gz:compression>"
+    << "          <format>jpeg</format>"
+    << "          <quality>50</quality>"
+    << "        </gz:compression>"
+    << "      </camera>"
+    << "    </sensor>"
+    << "  </link>"
+    << "</model>"
+    << "</sdf>";
+  SpawnSDF(sdfStream.str());
+  WaitUntilSensorSpawn(cameraName, 100, 100);
+
+  sensors::CameraSensorPtr camSensor =
+    std::dynamic_pointer_cast<sensors::CameraSensor>(
+        sensors::get_sensor(cameraName));
+  ASSERT_TRUE(camSensor != nullptr);
+  EXPECT_EQ(camSensor->CompressedTopic(), camSensor->Topic() + "/compressed");
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    g_compressedImages.clear();
+  }
+  transport::SubscriberPtr sub = this->node->Subscribe(
+      camSensor->CompressedTopic(), OnCompressedImage);
+
+  int sleep = 0;
+  while (sleep++ < 100)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (g_compressedImages.size() >= 3)
+        break;
+    }
+    common::Time::MSleep(50);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT_GE(g_compressedImages.size(), 3u);
+  for (const auto &msg : g_compressedImages)
+  {
+    EXPECT_EQ(msg.format(), "jpeg");
+    EXPECT_EQ(msg.width(), 320u);
+    EXPECT_EQ(msg.height(), 240u);
+    ASSERT_GT(msg.data().size(), 2u);
+
+    // Much smaller than the raw image
+    EXPECT_LT(msg.data().size(), 320u * 240u * 3u);
+    EXPECT_EQ(static_cast<unsigned char>(msg.data()[0]), 0xFF);
+    EXPECT_EQ(static_cast<unsigned char>(msg.data()[1]), 0xD8);
+  }
+}
+
+/////////////////////////////////////////////////
+// Images received by the Outputs test
+std::vector<gazebo::msgs::ImageStamped> g_cropImages;
+std::vector<gazebo::msgs::ImageStamped> g_thumbnailImages;
+
+/////////////////////////////////////////////////
+void OnCropImage(ConstImageStampedPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  g_cropImages.push_back(*_msg);
+}
+
+/////////////////////////////////////////////////
+void OnThumbnailImage(ConstImageStampedPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  g_thumbnailImages.push_back(*_msg);
+}
+
+/////////////////////////////////////////////////
+TEST_F(CameraSensor, Outputs)
+{
+  this->Load("worlds/empty.world");
+
+  // Make sure the render engine is available.
+  if (rendering::RenderEngine::Instance()->GetRenderPathType() ==
+      rendering::RenderEngine::NONE)
+  {
+    gzerr << "No rendering engine, unable to run camera test\n";
+    return;
+  }
+
+  const std::string cameraName = "outputs_camera";
+  std::ostringstream sdfStream;
+  sdfStream << "<sdf version='" << SDF_VERSION << "'>"
+    << "<model name='outputs_model'>"
+    << "  <static>true</static>"
+    << "  <pose>-5 0 0.5 0 0 0</pose>"
+    << "  <link name='body'>"
+    << "    <sensor name='" << cameraName << "' type='camera'>"
+    << "      <always_on>1</always_on>"
+    << "      <update_rate>10</update_rate>"
+    << "      <camera>"
+    << "        <horizontal_fov>1.0</horizontal_fov>"
+    << "        <image>"
+    << "          <width>320</width>"
+    << "          <height>240</height>"
+    << "        </image>"
+    << "        <clip><near>0.1</near><far>100</far></clip>"
+    << "        <gz:output name='crop'>"
+    << "          <roi>100 80 64 32</roi>"
+    << "        </gz:output>"
+    << "        <gz:output name='thumbnail'>"
+    << "          <scale>0.25</scale>"
+    << "        </gz:output>"
+    << "      </camera>"
+    << "    </sensor>"
+    << "  </link>"
+    << "</model>"
+    << "</sdf>";
+  SpawnSDF(sdfStream.str());
+  WaitUntilSensorSpawn(cameraName, 100, 100);
+
+  sensors::CameraSensorPtr camSensor =
+    std::dynamic_pointer_cast<sensors::CameraSensor>(
+        sensors::get_sensor(cameraName));
+  ASSERT_TRUE(camSensor != nullptr);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    g_cropImages.clear();
+    g_thumbnailImages.clear();
+  }
+  transport::SubscriberPtr cropSub = this->node->Subscribe(
+      camSensor->Topic() + "/crop", OnCropImage);
+  transport::SubscriberPtr thumbnailSub = this->node->Subscribe(
+      camSensor->Topic() + "/thumbnail", OnThumbnailImage);
+
+  int sleep = 0;
+  while (sleep++ < 100)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (g_cropImages.size() >= 3 && g_thumbnailImages.size() >= 3)
+        break;
+    }
+    common::Time::MSleep(50);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT_GE(g_cropImages.size(), 3u);
+  ASSERT_GE(g_thumbnailImages.size(), 3u);
+  for (const auto &msg : g_cropImages)
+  {
+    EXPECT_EQ(msg.image().width(), 64u);
+    EXPECT_EQ(msg.image().height(), 32u);
+    EXPECT_EQ(msg.image().data().size(), 64u * 32u * 3u);
+  }
+  for (const auto &msg : g_thumbnailImages)
+  {
+    EXPECT_EQ(msg.image().width(), 80u);
+    EXPECT_EQ(msg.image().height(), 60u);
+    EXPECT_EQ(msg.image().data().size(), 80u * 60u * 3u);
+  }
+
+  // No one uses the full image
+  EXPECT_TRUE(camSensor->ImageData() == nullptr);
+}
@@ -15,7 +15,12 @@
  *
 */
 
+#include <cmath>
+#include <string>
+#include <vector>
+
 #include <ignition/math/Helpers.hh>
+#include "gazebo/rendering/GpuLaser.hh"
 #include "gazebo/test/ServerFixture.hh"
 #include "gazebo/sensors/sensors.hh"
 
@@ -610,6 +615,82 @@ TEST_F(GPURaySensorTest, LaserScanResolution)
   delete [] scan;
 }
 
+/////////////////////////////////////////////////
+/// \brief Test GPU ray sensors sharing their depth images give the same
+/// ranges as a sensor rendering its own.
+TEST_F(GPURaySensorTest, SharedDepth)
+{
+  Load("worlds/gpu_laser_shared_depth.world");
+
+  // Make sure the render engine is available.
+  if (rendering::RenderEngine::Instance()->GetRenderPathType() ==
+      rendering::RenderEngine::NONE)
+  {
+    gzerr << "No rendering engine, unable to run gpu laser test\n";
+    return;
+  }
+
+  const std::vector<std::string> names =
+      {"shared_front", "shared_left", "reference_front"};
+  std::vector<sensors::GpuRaySensorPtr> raySensors;
+  std::vector<event::ConnectionPtr> connections;
+  std::vector<int> scanCounts(names.size(), 0);
+  std::vector<std::vector<float>> scans(names.size());
+  for (unsigned int i = 0; i < names.size(); ++i)
+  {
+    sensors::GpuRaySensorPtr raySensor =
+        std::dynamic_pointer_cast<sensors::GpuRaySensor>(
+        sensors::get_sensor(names[i]));
+    ASSERT_TRUE(raySensor != nullptr);
+    raySensor->SetActive(true);
+    raySensors.push_back(raySensor);
+
+    scans[i].resize(raySensor->RayCount() * raySensor->VerticalRayCount() * 3);
+    connections.push_back(raySensor->ConnectNewLaserFrame(
+        std::bind(&::OnNewLaserFrame, &scanCounts[i], scans[i].data(),
+          std::placeholders::_1, std::placeholders::_2, std::placeholders::_3,
+          std::placeholders::_4, std::placeholders::_5)));
+  }
+
+  EXPECT_TRUE(raySensors[0]->LaserCamera()->SharedDepth());
+  EXPECT_FALSE(raySensors[2]->LaserCamera()->SharedDepth());
+
+  // wait for a few laser scans
+  int i = 0;
+  while ((scanCounts[0] < 5 || scanCounts[1] < 5 || scanCounts[2] < 5) &&
+      i < 300)
+  {
+    common::Time::MSleep(10);
+    i++;
+  }
+  EXPECT_LT(i, 300);
+
+  // The faces texels are coarser than the images of a single laser
+  const double tol = 0.02;
+  const int mid = raySensors[0]->RayCount() / 2;
+  EXPECT_NEAR(raySensors[0]->Range(mid), 1.5, tol);
+  EXPECT_NEAR(raySensors[1]->Range(mid), 2.5, tol);
+  EXPECT_NEAR(raySensors[2]->Range(mid), 1.5, tol);
+
+  // Rays on the edges of the box may hit or miss it
+  int mismatches = 0;
+  for (int r = 0; r < raySensors[0]->RayCount(); ++r)
+  {
+    double shared = raySensors[0]->Range(r);
+    double reference = raySensors[2]->Range(r);
+    if (std::isinf(shared) || std::isinf(reference))
+    {
+      if (shared != reference)
+        ++mismatches;
+    }
+    else
+    {
+      EXPECT_NEAR(shared, reference, tol);
+    }
+  }
+  EXPECT_LE(mismatches, 2);
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -61,6 +61,12 @@ class JointForceTorqueTest : public ServerFixture,
   /// Apply force and check acceleration against analytical solution.
   /// \param[in] _physicsEngine Type of physics engine to use.
   public: void JointTorqueTest(const std::string &_physicsEngine);
+
+  /// \brief Load example world with a few joints.
+  /// Disable the feedback of a joint, then check that it is provided
+  /// while the joint has feedback users.
+  /// \param[in] _physicsEngine Type of physics engine to use.
+  public: void FeedbackUsers(const std::string &_physicsEngine);
 };
 
 /////////////////////////////////////////////////
@@ -622,6 +628,46 @@ void JointForceTorqueTest::JointTorqueTest(const std::string &_physicsEngine)
   }
 }
 
+/////////////////////////////////////////////////
+void JointForceTorqueTest::FeedbackUsers(const std::string &_physicsEngine)
+{
+  Load("worlds/force_torque_test.world", true, _physicsEngine);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+  world->Physics()->SetGravity(ignition::math::Vector3d(0, 0, -50));
+
+  physics::ModelPtr model = world->ModelByName("model_1");
+  ASSERT_TRUE(model != NULL);
+  physics::JointPtr joint = model->GetJoint("joint_01");
+  ASSERT_TRUE(joint != NULL);
+
+  joint->SetProvideFeedback(false);
+  EXPECT_FALSE(joint->ProvideFeedback());
+
+  // Feedback is provided until the last user is removed
+  joint->AddFeedbackUser();
+  joint->AddFeedbackUser();
+  EXPECT_TRUE(joint->ProvideFeedback());
+  joint->RemoveFeedbackUser();
+  EXPECT_TRUE(joint->ProvideFeedback());
+
+  world->Step(2);
+  physics::JointWrench wrench = joint->GetForceTorque(0u);
+  EXPECT_FLOAT_EQ(wrench.body1Force.Z(), 1000.0);
+
+  // Repeated queries within a step give the same wrench
+  EXPECT_EQ(joint->GetForceTorque(0u).body1Force, wrench.body1Force);
+
+  joint->RemoveFeedbackUser();
+  EXPECT_FALSE(joint->ProvideFeedback());
+
+  // <provide_feedback> outlives the users
+  joint->SetProvideFeedback(true);
+  joint->AddFeedbackUser();
+  joint->RemoveFeedbackUser();
+  EXPECT_TRUE(joint->ProvideFeedback());
+}
+
 TEST_P(JointForceTorqueTest, ForceTorque1)
 {
   ForceTorque1(GetParam());
@@ -647,6 +693,11 @@ TEST_P(JointForceTorqueTest, JointTorqueTest)
   JointTorqueTest(GetParam());
 }
 
+TEST_P(JointForceTorqueTest, FeedbackUsers)
+{
+  FeedbackUsers(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(PhysicsEngines, JointForceTorqueTest,
                         PHYSICS_ENGINE_VALUES,);  // NOLINT
 
@@ -496,6 +496,32 @@ void Marker_TEST::CornerCases()
     QVERIFY(rep.marker(0).type() == ignition::msgs::Marker::SPHERE);
   }
 
+  // Add several markers with one request
+  {
+    auto visCount = scene->VisualCount();
+
+    ignition::msgs::Marker_V markersMsg;
+    for (int i = 1; i <= 2; ++i)
+    {
+      ignition::msgs::Marker *markerMsg = markersMsg.add_marker();
+      markerMsg->set_ns("array");
+      markerMsg->set_id(i);
+      markerMsg->set_action(ignition::msgs::Marker::ADD_MODIFY);
+      markerMsg->set_type(ignition::msgs::Marker::BOX);
+    }
+
+    ignition::msgs::Boolean rep;
+    bool result;
+    QVERIFY(node.Request("/marker_array", markersMsg, 5000u, rep, result));
+    QVERIFY(result);
+    QVERIFY(rep.data());
+
+    this->ProcessEventsAndDraw(mainWindow);
+
+    // Visuals were added
+    QCOMPARE(scene->VisualCount(), visCount + 2);
+  }
+
   // Attempt to clear inexistent namespace
   {
     auto visCount = scene->VisualCount();
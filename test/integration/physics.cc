@@ -841,6 +841,53 @@ TEST_F(PhysicsTest, StateDeletion)
   EXPECT_EQ(0u, newWorldState.LightStateCount());
 }
 
+//////////////////////////////////////////////////
+TEST_F(PhysicsTest, StateRepeated)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  physics::WorldState oldWorldState(world);
+  const ignition::math::Pose3d boxPose(0, 0, 0.5, 0, 0, 0);
+  const ignition::math::Pose3d spherePose =
+      world->ModelByName("sphere")->WorldPose();
+
+  // The states are resolved on the first call, then reused
+  for (int i = 0; i < 3; ++i)
+  {
+    for (auto const &name : {"box", "sphere"})
+    {
+      physics::ModelPtr model = world->ModelByName(name);
+      ASSERT_TRUE(model != NULL);
+      model->SetWorldPose(ignition::math::Pose3d(5 + i, 2, 3, 0, 0.1, 0));
+      model->SetLinearVel(ignition::math::Vector3d(1, 0, 0));
+    }
+
+    world->SetState(oldWorldState);
+
+    // The engine got the poses too, stepping doesn't move the models back
+    world->Step(1);
+    physics::ModelPtr box = world->ModelByName("box");
+    EXPECT_NEAR(boxPose.Pos().Distance(box->WorldPose().Pos()), 0, 1e-3);
+    EXPECT_NEAR(boxPose.Pos().Distance(box->GetLink()->WorldPose().Pos()), 0,
+        1e-3);
+    EXPECT_NEAR(box->WorldLinearVel().X(), 0.0, 1e-3);
+    EXPECT_NEAR(spherePose.Pos().Distance(
+        world->ModelByName("sphere")->WorldPose().Pos()), 0, 1e-3);
+  }
+
+  // Removed models are resolved again
+  world->RemoveModel("box");
+  EXPECT_TRUE(world->ModelByName("box") == NULL);
+  physics::ModelPtr sphere = world->ModelByName("sphere");
+  ASSERT_TRUE(sphere != NULL);
+  sphere->SetWorldPose(ignition::math::Pose3d(5, 2, 3, 0, 0, 0));
+  world->SetState(oldWorldState);
+  world->Step(1);
+  EXPECT_NEAR(spherePose.Pos().Distance(sphere->WorldPose().Pos()), 0, 1e-3);
+}
+
 ////////////////////////////////////////////////////////////////////////
 void PhysicsTest::JointDampingTest(const std::string &_physicsEngine)
 {
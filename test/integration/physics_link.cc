@@ -68,6 +68,11 @@ class PhysicsLinkTest : public ServerFixture,
   /// \param[in] _physicsEngine Physics engine to use.
   public: void GetWorldInertia(const std::string &_physicsEngine);
 
+  /// \brief Test that the cached world quantities of a link follow its
+  /// pose and inertial.
+  /// \param[in] _physicsEngine Physics engine to use.
+  public: void WorldCache(const std::string &_physicsEngine);
+
   /// \brief Test wrench subscriber.
   /// \param[in] _physicsEngine Type of physics engine to use.
   public: void OnWrenchMsg(const std::string &_physicsEngine);
@@ -593,6 +598,57 @@ void PhysicsLinkTest::GetWorldInertia(const std::string &_physicsEngine)
   }
 }
 
+/////////////////////////////////////////////////
+void PhysicsLinkTest::WorldCache(const std::string &_physicsEngine)
+{
+  Load("worlds/blank.world", true, _physicsEngine);
+  auto world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+  world->SetGravity(ignition::math::Vector3d::Zero);
+
+  msgs::Model msgModel;
+  msgModel.set_name(this->GetUniqueString("model"));
+  msgs::AddBoxLink(msgModel, 10.0, ignition::math::Vector3d(1, 4, 9));
+  msgs::Set(msgModel.mutable_pose(), ignition::math::Pose3d(0, 0, 9, 0, 0, 0));
+  msgs::Set(msgModel.mutable_link(0)->mutable_inertial()->mutable_pose(),
+      ignition::math::Pose3d(0.5, 0, 0, 0, 0, 0));
+
+  auto model = this->SpawnModel(msgModel);
+  ASSERT_TRUE(model != NULL);
+  auto link = model->GetLink();
+  ASSERT_TRUE(link != NULL);
+
+  // Repeated queries return the same values
+  const ignition::math::Matrix3d inertia = link->WorldInertiaMatrix();
+  EXPECT_EQ(inertia, link->WorldInertiaMatrix());
+  EXPECT_EQ(link->WorldCoGPose().Pos(), ignition::math::Vector3d(0.5, 0, 9));
+  EXPECT_EQ(link->WorldCoGPose(), link->WorldCoGPose());
+
+  // Setting the pose within an update refreshes them
+  const ignition::math::Pose3d rotated(0, 0, 9, 0, 0, IGN_PI / 2.0);
+  model->SetWorldPose(rotated);
+  EXPECT_EQ(link->WorldCoGPose().Pos(), ignition::math::Vector3d(0, 0.5, 9));
+  EXPECT_EQ(link->WorldInertiaMatrix(), link->GetInertial()->MOI(
+        ignition::math::Pose3d(ignition::math::Vector3d(0.5, 0, 0),
+        rotated.Rot().Inverse())));
+  EXPECT_NEAR(link->WorldInertiaMatrix()(0, 0), inertia(1, 1), g_tolerance);
+
+  // So does changing the inertial
+  link->GetInertial()->SetIYY(2 * inertia(1, 1));
+  link->UpdateMass();
+  EXPECT_NEAR(link->WorldInertiaMatrix()(0, 0), 2 * inertia(1, 1),
+      g_tolerance);
+
+  // And the motion of a step
+  const uint64_t updates = world->PhysicsUpdateCount();
+  link->SetAngularVel(ignition::math::Vector3d(0, 0, 10));
+  world->Step(10);
+  EXPECT_EQ(world->PhysicsUpdateCount(), updates + 10);
+  EXPECT_NE(link->WorldPose().Rot(), rotated.Rot());
+  EXPECT_EQ(link->WorldCoGPose().Pos(), link->WorldPose().Pos() +
+      link->WorldPose().Rot().RotateVector(link->GetInertial()->CoG()));
+}
+
 /////////////////////////////////////////////////
 void PhysicsLinkTest::OnWrenchMsg(const std::string &_physicsEngine)
 {
@@ -844,6 +900,12 @@ TEST_P(PhysicsLinkTest, GetWorldInertia)
   GetWorldInertia(GetParam());
 }
 
+/////////////////////////////////////////////////
+TEST_P(PhysicsLinkTest, WorldCache)
+{
+  WorldCache(GetParam());
+}
+
 /////////////////////////////////////////////////
 TEST_P(PhysicsLinkTest, OnWrenchMsg)
 {
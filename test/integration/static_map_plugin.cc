@@ -55,6 +55,12 @@ TEST_F(StaticMapTest, StaticMapPlugin)
   physics::ModelPtr mapModel = world->ModelByName(modelName);
   ASSERT_TRUE(mapModel != nullptr);
 
+  // the plain ground that stood in for the map is removed
+  std::string placeholderName = modelName + "_placeholder";
+  for (int i = 0; i < 300 && world->ModelByName(placeholderName); ++i)
+    common::Time::MSleep(10);
+  EXPECT_TRUE(world->ModelByName(placeholderName) == nullptr);
+
   // verify basic model properties
   EXPECT_TRUE(mapModel->IsStatic());
   EXPECT_EQ(mapModel->WorldPose(), ignition::math::Pose3d::Zero);
@@ -18,6 +18,7 @@
 #ifndef _WIN32
 #include <unistd.h>
 #endif
+#include <atomic>
 #include "gazebo/test/ServerFixture.hh"
 
 using namespace gazebo;
@@ -91,6 +92,15 @@ void ReceiveStringMsg4(ConstGzStringPtr &/*_msg*/)
   g_stringMsg4 = true;
 }
 
+size_t g_ownedMsgSize = 0;
+const msgs::GzString *g_ownedMsgPtr = nullptr;
+
+void ReceiveOwnedMsg(ConstGzStringPtr &_msg)
+{
+  g_ownedMsgPtr = _msg.get();
+  g_ownedMsgSize = _msg->data().size();
+}
+
 void ReceiveSceneMsg(ConstScenePtr &/*_msg*/)
 {
   g_sceneMsg = true;
@@ -153,6 +163,125 @@ TEST_F(TransportTest, PubSub)
   subs.clear();
 }
 
+/////////////////////////////////////////////////
+// A rate limited publisher reports when the next message would be dropped
+TEST_F(TransportTest, ReadyToPublish)
+{
+  Load("worlds/empty.world");
+
+  transport::NodePtr node = transport::NodePtr(new transport::Node());
+  node->Init();
+  transport::PublisherPtr throttledPub =
+      node->Advertise<msgs::Scene>("~/throttled_scene", 10, 10);
+  transport::PublisherPtr scenePub =
+      node->Advertise<msgs::Scene>("~/unthrottled_scene");
+
+  msgs::Scene msg;
+  msgs::Init(msg, "test");
+  msg.set_name("default");
+
+  EXPECT_TRUE(throttledPub->ReadyToPublish());
+  throttledPub->Publish(msg);
+  EXPECT_FALSE(throttledPub->ReadyToPublish());
+  common::Time::MSleep(150);
+  EXPECT_TRUE(throttledPub->ReadyToPublish());
+
+  scenePub->Publish(msg);
+  EXPECT_TRUE(scenePub->ReadyToPublish());
+}
+
+std::atomic<int> g_dispatchCount(0);
+
+void ReceiveDispatchMsg(ConstGzStringPtr &/*_msg*/)
+{
+  ++g_dispatchCount;
+}
+
+/////////////////////////////////////////////////
+// Published messages are dispatched right away rather than on the next
+// poll of the connection manager, whatever the number of idle nodes.
+TEST_F(TransportTest, DispatchLatency)
+{
+  Load("worlds/empty.world");
+
+  std::vector<transport::NodePtr> idleNodes;
+  std::vector<transport::PublisherPtr> idlePubs;
+  for (unsigned int i = 0; i < 50; ++i)
+  {
+    transport::NodePtr idle(new transport::Node());
+    idle->Init();
+    idlePubs.push_back(idle->Advertise<msgs::GzString>(
+          "~/idle" + std::to_string(i)));
+    idleNodes.push_back(idle);
+  }
+
+  transport::NodePtr node = transport::NodePtr(new transport::Node());
+  node->Init();
+  transport::PublisherPtr pub = node->Advertise<msgs::GzString>("~/dispatch");
+  transport::SubscriberPtr sub = node->Subscribe("~/dispatch",
+      &ReceiveDispatchMsg);
+
+  msgs::GzString msg;
+  msg.set_data("dispatch");
+
+  // Wait for the subscription
+  g_dispatchCount = 0;
+  int timeout = 1000;
+  pub->Publish(msg);
+  while (g_dispatchCount == 0 && --timeout > 0)
+    common::Time::MSleep(10);
+  ASSERT_EQ(1, g_dispatchCount);
+
+  // Round trips, each waiting for the previous message
+  const common::Time start = common::Time::GetWallTime();
+  for (int i = 2; i <= 21; ++i)
+  {
+    pub->Publish(msg);
+    timeout = 10000;
+    while (g_dispatchCount < i && --timeout > 0)
+      common::Time::NSleep(100000);
+    ASSERT_EQ(i, g_dispatchCount);
+  }
+
+  // Polling every 100 ms would take about a second
+  EXPECT_LT((common::Time::GetWallTime() - start).Double(), 0.5);
+}
+
+/////////////////////////////////////////////////
+// A message published through a unique_ptr is not copied
+TEST_F(TransportTest, OwnedPublish)
+{
+  Load("worlds/empty.world");
+
+  transport::NodePtr node = transport::NodePtr(new transport::Node());
+  node->Init();
+  transport::PublisherPtr pub = node->Advertise<msgs::GzString>("~/owned");
+  transport::SubscriberPtr sub = node->Subscribe("~/owned",
+      &ReceiveOwnedMsg);
+
+  // Larger than a socket write, so remote connections share its buffer
+  std::unique_ptr<msgs::GzString> msg(new msgs::GzString);
+  msg->set_data(std::string(100000, 'x'));
+  const msgs::GzString *raw = msg.get();
+
+  g_ownedMsgSize = 0;
+  pub->Publish(std::move(msg), true);
+  EXPECT_TRUE(msg == nullptr);
+  EXPECT_EQ(raw, pub->GetPrevMsgPtr().get());
+
+  int timeout = 1000;
+  while (g_ownedMsgSize == 0 && --timeout > 0)
+    common::Time::MSleep(10);
+  EXPECT_EQ(100000u, g_ownedMsgSize);
+
+  // Subscribers in the same process get the published message itself
+  EXPECT_EQ(raw, g_ownedMsgPtr);
+
+  // Null messages are not published
+  pub->Publish(std::unique_ptr<msgs::GzString>(), true);
+  EXPECT_EQ(raw, pub->GetPrevMsgPtr().get());
+}
+
 /////////////////////////////////////////////////
 TEST_F(TransportTest, DirectPublish)
 {
@@ -16,6 +16,8 @@
 */
 #include <mutex>
 #include <functional>
+#include <string>
+#include <vector>
 
 #include "gazebo/sensors/sensors.hh"
 #include "gazebo/common/Time.hh"
@@ -225,3 +227,81 @@ TEST_F(WideAngleCameraSensor, Projection)
   EXPECT_LT(screenPt.Z(), 1.0);
 #endif
 }
+
+/////////////////////////////////////////////////
+TEST_F(WideAngleCameraSensor, CullEnvFaces)
+{
+#if not defined(__APPLE__)
+  Load("worlds/usercamera_test.world");
+
+  // Make sure the render engine is available.
+  if (rendering::RenderEngine::Instance()->GetRenderPathType() ==
+      rendering::RenderEngine::NONE)
+  {
+    gzerr << "No rendering engine, unable to run wide angle camera test\n";
+    return;
+  }
+
+  // Spawn 180 degree and 1 radian equidistant cameras
+  SpawnWideAngleCamera("fisheye_model", "fisheye_sensor",
+      ignition::math::Vector3d::Zero, ignition::math::Vector3d::Zero,
+      320, 240, 10, IGN_PI, "equidistant", true, IGN_PI * 0.5);
+  SpawnWideAngleCamera("narrow_model", "narrow_sensor",
+      ignition::math::Vector3d::Zero, ignition::math::Vector3d::Zero,
+      320, 240, 10, 1.0, "equidistant", true, IGN_PI * 0.5);
+
+  auto fisheyeSensor = std::dynamic_pointer_cast<sensors::CameraSensor>(
+      sensors::get_sensor("fisheye_sensor"));
+  auto narrowSensor = std::dynamic_pointer_cast<sensors::CameraSensor>(
+      sensors::get_sensor("narrow_sensor"));
+  ASSERT_NE(fisheyeSensor, nullptr);
+  ASSERT_NE(narrowSensor, nullptr);
+
+  rendering::WideAngleCameraPtr fisheye =
+      boost::dynamic_pointer_cast<rendering::WideAngleCamera>(
+      fisheyeSensor->Camera());
+  rendering::WideAngleCameraPtr narrow =
+      boost::dynamic_pointer_cast<rendering::WideAngleCamera>(
+      narrowSensor->Camera());
+  ASSERT_NE(fisheye, nullptr);
+  ASSERT_NE(narrow, nullptr);
+
+  // The fisheye samples every face but the one behind it
+  EXPECT_EQ(fisheye->NeededEnvFaces(),
+      std::vector<bool>({true, true, true, true, true, false}));
+
+  // The narrow lens only samples the face in front of it
+  EXPECT_EQ(narrow->NeededEnvFaces(),
+      std::vector<bool>({false, false, false, false, true, false}));
+
+  EXPECT_FALSE(fisheye->CullEnvFaces());
+  fisheye->SetCullEnvFaces(true);
+  narrow->SetCullEnvFaces(true);
+  EXPECT_TRUE(fisheye->CullEnvFaces());
+
+  // The cameras keep producing images
+  unsigned int imageCount = 0;
+  std::mutex mutex;
+  event::ConnectionPtr c = fisheye->ConnectNewImageFrame(
+      [&](const unsigned char *, unsigned int, unsigned int, unsigned int,
+      const std::string &)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        imageCount++;
+      });
+
+  for (int i = 0; i < 100; ++i)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (imageCount >= 3)
+        break;
+    }
+    common::Time::MSleep(50);
+  }
+  c.reset();
+
+  std::lock_guard<std::mutex> lock(mutex);
+  EXPECT_GE(imageCount, 3u);
+#endif
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "gazebo/physics/physics.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+class WorldCopiesTest : public ServerFixture
+{
+};
+
+/////////////////////////////////////////////////
+/// \brief Load several copies of a world and step them in lockstep.
+TEST_F(WorldCopiesTest, StepWorlds)
+{
+  this->LoadArgs("-u --copies 3 worlds/shapes.world");
+
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    std::string name = "default_" + std::to_string(i);
+    ASSERT_TRUE(physics::has_world(name)) << name;
+    auto world = physics::get_world(name);
+    EXPECT_TRUE(world->IsPaused());
+    EXPECT_NE(nullptr, world->ModelByName("box"));
+  }
+  EXPECT_FALSE(physics::has_world("default"));
+
+  // Move the box of a single copy
+  physics::get_world("default_1")->ModelByName("box")->SetWorldPose(
+      ignition::math::Pose3d(0, 0, 5, 0, 0, 0));
+
+  physics::step_worlds(100);
+
+  auto states = physics::get_world_states();
+  ASSERT_EQ(3u, states.size());
+  for (unsigned int i = 0; i < states.size(); ++i)
+  {
+    EXPECT_EQ("default_" + std::to_string(i), states[i].GetName());
+    EXPECT_EQ(common::Time(0.1), states[i].GetSimTime());
+    EXPECT_TRUE(states[i].HasModelState("box"));
+  }
+
+  // The copies are independent
+  EXPECT_NE(states[0].GetModelState("box").Pose(),
+      states[1].GetModelState("box").Pose());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
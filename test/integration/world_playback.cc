@@ -14,6 +14,7 @@
  * limitations under the License.
  *
 */
+#include <atomic>
 #include <chrono>
 #include <map>
 #include <string>
@@ -22,6 +23,7 @@
 #include <boost/filesystem.hpp>
 #include "gazebo/common/Time.hh"
 #include "gazebo/physics/physics.hh"
+#include "gazebo/util/LogPlay.hh"
 #include "gazebo/test/ServerFixture.hh"
 #include "gazebo/transport/TransportTypes.hh"
 
@@ -291,6 +293,44 @@ TEST_P(WorldPlaybackTest, Seek)
   EXPECT_EQ(this->world->SimTime(), expectedSimTime);
 }
 
+/////////////////////////////////////////////////
+/// \brief Check "play_period".
+TEST_P(WorldPlaybackTest, PlayPeriod)
+{
+  ASSERT_TRUE(this->world != NULL);
+  common::Time expectedSimTime;
+
+  // Rewind the world.
+  msgs::LogPlaybackControl msg;
+  expectedSimTime.Set(std::get<0>(this->features));
+  msg.set_rewind(true);
+  this->logPlaybackPub->Publish(msg);
+  this->WaitUntilSimTime(expectedSimTime, 10, 20);
+
+  // Count the states played, about one per second of the log
+  std::atomic<int> updates(0);
+  event::ConnectionPtr connection = event::Events::ConnectWorldUpdateBegin(
+      [&updates](const common::UpdateInfo &) { ++updates; });
+
+  msg.Clear();
+  msg.set_play_period(1.0);
+  msg.set_pause(false);
+  this->logPlaybackPub->Publish(msg);
+
+  // The last state is played
+  expectedSimTime.Set(std::get<3>(this->features));
+  this->WaitUntilSimTime(expectedSimTime, 50, 400);
+  EXPECT_EQ(this->world->SimTime(), expectedSimTime);
+  connection.reset();
+
+  const double duration = std::get<3>(this->features) -
+    std::get<0>(this->features);
+  EXPECT_GT(updates, 0);
+  EXPECT_LE(updates, static_cast<int>(duration) + 2);
+
+  util::LogPlay::Instance()->SetPlayPeriod(0);
+}
+
 // Test with different log files.
 //   - state.log:  File without <iterations> in each frame.
 //   - state2.log: File with <iterations> in each frame.
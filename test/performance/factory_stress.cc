@@ -14,6 +14,11 @@
  * limitations under the License.
  *
 */
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "gazebo/test/ServerFixture.hh"
 
 using namespace gazebo;
@@ -44,6 +49,44 @@ TEST_F(FactoryStressTest, Bookshelf)
   sub.reset();
 }
 
+/////////////////////////////////////////////////
+TEST_F(FactoryStressTest, ManyBoxes)
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  const size_t initialCount = world->ModelCount();
+
+  // One SDF for all the boxes
+  std::ostringstream sdf;
+  sdf << "<sdf version='" << SDF_VERSION << "'>"
+      << "<model name='box'><link name='link'><collision name='collision'>"
+      << "<geometry><box><size>1 1 1</size></box></geometry></collision>"
+      << "</link></model></sdf>";
+
+  const unsigned int count = 1000;
+  std::vector<std::pair<std::string, ignition::math::Pose3d>> instances;
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    instances.emplace_back(i == 0 ? "first_box" : "",
+        ignition::math::Pose3d(2.0 * (i % 32), 2.0 * (i / 32), 0.5, 0, 0, 0));
+  }
+
+  const common::Time start = common::Time::GetWallTime();
+  world->InsertModelsString(sdf.str(), instances);
+  world->Step(1);
+  gzmsg << "Spawned " << count << " boxes in "
+        << (common::Time::GetWallTime() - start).Double() << " s"
+        << std::endl;
+
+  EXPECT_EQ(initialCount + count, world->ModelCount());
+  physics::ModelPtr first = world->ModelByName("first_box");
+  ASSERT_TRUE(first != nullptr);
+  EXPECT_NEAR(0.0, first->WorldPose().Pos().X(), 1e-6);
+  EXPECT_NEAR(0.0, first->WorldPose().Pos().Y(), 1e-6);
+  EXPECT_TRUE(world->ModelByName("box_0") != nullptr);
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
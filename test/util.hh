@@ -65,6 +65,9 @@ namespace gazebo
       /// \return A string will all the log content.
       protected: std::string GetLogContent() const
       {
+        // Wait for the messages queued for the log file
+        gazebo::common::Console::Flush();
+
         // Open the log file, and read back the string
         std::ifstream ifs(this->GetFullLogPath().c_str(), std::ios::in);
         std::string loggedString;
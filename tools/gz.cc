@@ -853,7 +853,9 @@ StatsCommand::StatsCommand()
     ("world-name,w", po::value<std::string>(), "World name.")
     ("duration,d", po::value<uint64_t>(), "Duration (seconds) to run.")
     ("plot,p", "Output comma-separated values, useful for processing and "
-     "plotting.");
+     "plotting.")
+    ("plugins,g", "Output the time spent in the event callbacks of each "
+     "plugin, every second.");
 }
 
 /////////////////////////////////////////////////
@@ -863,6 +865,9 @@ void StatsCommand::HelpDetailed()
     "\tPrint gzserver statics to standard out. If a name for the world, \n"
     "\toption -w, is not specified, the first world found on \n"
     "\tthe Gazebo master will be used.\n"
+    "\tThe step times are percentiles of the wall time of the steps since\n"
+    "\tthe world started, and overruns count the steps longer than the\n"
+    "\tperiod of the real time update rate.\n"
     << std::endl;
 }
 
@@ -877,19 +882,78 @@ bool StatsCommand::RunImpl()
   transport::NodePtr node(new transport::Node());
   node->Init(worldName);
 
-  transport::SubscriberPtr sub =
-    node->Subscribe("~/world_stats", &StatsCommand::CB, this);
-
-  boost::mutex::scoped_lock lock(this->sigMutex);
-  if (this->vm.count("duration"))
-    this->sigCondition.timed_wait(lock,
-        boost::posix_time::seconds(this->vm["duration"].as<uint64_t>()));
+  transport::SubscriberPtr sub;
+  transport::PublisherPtr profilerPub;
+  if (this->vm.count("plugins"))
+  {
+    // Enable the plugin costs while printing them
+    profilerPub = node->Advertise<msgs::GzString>("~/profiler");
+    profilerPub->WaitForConnection();
+    msgs::GzString command;
+    command.set_data("plugins_start");
+    profilerPub->Publish(command);
+
+    sub = node->Subscribe("~/diagnostics", &StatsCommand::OnDiagnostics,
+        this);
+  }
   else
-    this->sigCondition.wait(lock);
+  {
+    sub = node->Subscribe("~/world_stats", &StatsCommand::CB, this);
+  }
+
+  {
+    boost::mutex::scoped_lock lock(this->sigMutex);
+    if (this->vm.count("duration"))
+      this->sigCondition.timed_wait(lock,
+          boost::posix_time::seconds(this->vm["duration"].as<uint64_t>()));
+    else
+      this->sigCondition.wait(lock);
+  }
+
+  if (profilerPub)
+  {
+    msgs::GzString command;
+    command.set_data("plugins_stop");
+    profilerPub->Publish(command, true);
+  }
 
   return true;
 }
 
+/////////////////////////////////////////////////
+void StatsCommand::OnDiagnostics(ConstDiagnosticsPtr &_msg)
+{
+  GZ_ASSERT(_msg, "Invalid message received");
+
+  // Diagnostics are published every step, costs are printed every second
+  const common::Time realTime = msgs::Convert(_msg->real_time());
+  if (this->costsTime != common::Time::Zero &&
+      realTime - this->costsTime < common::Time(1, 0))
+  {
+    return;
+  }
+  const double period = (realTime - this->costsTime).Double();
+  const bool first = this->costsTime == common::Time::Zero;
+  this->costsTime = realTime;
+
+  for (const auto &cost : _msg->plugin_cost())
+  {
+    const common::Time elapsed = msgs::Convert(cost.elapsed());
+    auto &prev = this->costs[cost.name()];
+    const uint64_t calls = cost.calls() - prev.first;
+    const common::Time time = elapsed - prev.second;
+    prev = std::make_pair(cost.calls(), elapsed);
+    if (first || calls == 0)
+      continue;
+
+    // Share of the real time, and mean time of a call
+    printf("Plugin[%s] Calls[%llu] Time[%4.2f%%] Mean[%8.3f us]\n",
+        cost.name().c_str(), static_cast<unsigned long long>(calls),
+        100.0 * time.Double() / period, 1e6 * time.Double() / calls);
+  }
+  fflush(stdout);
+}
+
 /////////////////////////////////////////////////
 void StatsCommand::CB(ConstWorldStatisticsPtr &_msg)
 {
@@ -951,8 +1015,36 @@ void StatsCommand::CB(ConstWorldStatisticsPtr &_msg)
     fflush(stdout);
   }
   else
-    printf("Factor[%4.2f] SimTime[%4.2f] RealTime[%4.2f] Paused[%c]\n",
+  {
+    printf("Factor[%4.2f] SimTime[%4.2f] RealTime[%4.2f] Paused[%c]",
         percent, simTime.Double(), realTime.Double(), paused);
+
+    // Tail latency of the steps, in milliseconds
+    if (_msg->has_step_time_p50())
+    {
+      printf(" StepTime[p50 %.3f p99 %.3f p99.9 %.3f max %.3f ms]"
+          " Overruns[%llu]",
+          _msg->step_time_p50() * 1e3, _msg->step_time_p99() * 1e3,
+          _msg->step_time_p999() * 1e3, _msg->step_time_max() * 1e3,
+          static_cast<unsigned long long>(_msg->overrun_steps()));
+    }
+
+    // Memory of the subsystems, in MiB, with their budget if they have one
+    if (_msg->memory_size() > 0)
+    {
+      printf(" Memory[");
+      for (int i = 0; i < _msg->memory_size(); ++i)
+      {
+        const msgs::WorldStatistics::Memory &memory = _msg->memory(i);
+        printf("%s%s %.1f", i > 0 ? " " : "", memory.subsystem().c_str(),
+            memory.bytes() / 1048576.0);
+        if (memory.budget() > 0)
+          printf("/%.1f", memory.budget() / 1048576.0);
+      }
+      printf(" MiB]");
+    }
+    printf("\n");
+  }
 }
 
 /////////////////////////////////////////////////
@@ -19,6 +19,8 @@
 
 #include <string>
 #include <list>
+#include <map>
+#include <utility>
 #include <boost/thread.hpp>
 #include <boost/program_options.hpp>
 #include <ignition/math/Pose3.hh>
@@ -195,6 +197,17 @@ namespace gazebo
     /// \param[in] _msg World statistics message.
     private: void CB(ConstWorldStatisticsPtr &_msg);
 
+    /// \brief Diagnostics callback, which prints the plugin costs.
+    /// \param[in] _msg Diagnostics message.
+    private: void OnDiagnostics(ConstDiagnosticsPtr &_msg);
+
+    /// \brief Real time of the last printed plugin costs.
+    private: common::Time costsTime;
+
+    /// \brief Calls and elapsed time of each plugin, when the costs were
+    /// last printed.
+    private: std::map<std::string, std::pair<uint64_t, common::Time>> costs;
+
     /// \brief Sim time buffer
     private: std::list<common::Time> simTimes;
 
@@ -14,6 +14,17 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <cctype>
+#include <deque>
+#include <future>
+#include <iomanip>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/date_time/posix_time/posix_time_io.hpp>
@@ -32,6 +43,209 @@ sdf::ElementPtr g_stateSdf;
 
 using namespace gazebo;
 
+/// \brief Element that holds a Base64 encoded msgs::WorldState inside a
+/// log frame, see World::LogWorker.
+static const std::string kBinaryStateStart = "<binary_state>";
+static const std::string kBinaryStateEnd = "</binary_state>";
+
+/// \brief Element that holds the SDF of the models and lights of a log
+/// keyframe, after its world state.
+static const std::string kKeyframeStart = "<keyframe>";
+static const std::string kKeyframeEnd = "</keyframe>";
+
+/// \brief Number of chunks decoded ahead of the output, per thread.
+static const unsigned int kChunksPerThread = 2;
+
+/////////////////////////////////////////////////
+/// \brief Compile a filter part into a regular expression, where '*'
+/// matches any sequence of characters.
+/// \param[in] _part The filter part.
+/// \return The regular expression.
+static boost::regex FilterRegex(const std::string &_part)
+{
+  std::string regexStr = _part;
+  boost::replace_all(regexStr, "*", ".*");
+  return boost::regex(regexStr);
+}
+
+/////////////////////////////////////////////////
+/// \brief Find the end of an XML element.
+/// \param[in] _xml The XML text.
+/// \param[in] _start Position of the element's start tag.
+/// \param[in] _tag Name of the element.
+/// \return Position after the element, std::string::npos if it isn't
+/// closed.
+static size_t ElementEnd(const std::string &_xml, const size_t _start,
+    const std::string &_tag)
+{
+  const std::string open = "<" + _tag + " ";
+  const std::string close = "</" + _tag + ">";
+
+  int depth = 0;
+  size_t pos = _start;
+  while (true)
+  {
+    auto openPos = _xml.find(open, pos);
+    auto closePos = _xml.find(close, pos);
+    if (openPos == std::string::npos && closePos == std::string::npos)
+      return std::string::npos;
+
+    if (openPos < closePos)
+    {
+      auto tagEnd = _xml.find('>', openPos);
+      if (tagEnd == std::string::npos)
+        return std::string::npos;
+
+      // An empty element, <tag .../>
+      if (_xml[tagEnd - 1] != '/')
+        ++depth;
+      else if (depth == 0)
+        return tagEnd + 1;
+
+      pos = tagEnd + 1;
+    }
+    else
+    {
+      pos = closePos + close.size();
+      if (--depth <= 0)
+        return pos;
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the name attribute of an XML element.
+/// \param[in] _xml The XML text.
+/// \param[in] _start Position of the element's start tag.
+/// \return The name, empty if the element has none.
+static std::string ElementName(const std::string &_xml, const size_t _start)
+{
+  auto tagEnd = _xml.find('>', _start);
+  auto name = _xml.find("name=", _start);
+  if (name == std::string::npos || name > tagEnd ||
+      name + 6 >= _xml.size())
+  {
+    return std::string();
+  }
+
+  const char quote = _xml[name + 5];
+  auto end = _xml.find(quote, name + 6);
+  if (end == std::string::npos || end > tagEnd)
+    return std::string();
+
+  return _xml.substr(name + 6, end - name - 6);
+}
+
+/////////////////////////////////////////////////
+/// \brief Remove the XML elements with a tag that aren't kept.
+/// \param[in] _xml The XML text.
+/// \param[in] _tag Name of the elements.
+/// \param[in] _from Position of the text from which to look for elements.
+/// Elements inside the ones found aren't looked at.
+/// \param[in] _keep Check if the element with a name is kept.
+/// \param[in] _inner Transform the text of each kept element, may be null.
+/// \return The XML text without the elements.
+static std::string PruneElements(const std::string &_xml,
+    const std::string &_tag, const size_t _from,
+    const std::function<bool(const std::string &)> &_keep,
+    const std::function<std::string(const std::string &)> &_inner = nullptr)
+{
+  const std::string open = "<" + _tag + " ";
+
+  std::string result;
+  size_t copied = 0;
+  auto start = _xml.find(open, _from);
+  while (start != std::string::npos)
+  {
+    auto end = ElementEnd(_xml, start, _tag);
+    if (end == std::string::npos)
+      break;
+
+    result.append(_xml, copied, start - copied);
+    if (_keep(ElementName(_xml, start)))
+    {
+      if (_inner)
+        result += _inner(_xml.substr(start, end - start));
+      else
+        result.append(_xml, start, end - start);
+    }
+
+    copied = end;
+    start = _xml.find(open, end);
+  }
+
+  if (copied == 0)
+    return _xml;
+
+  result.append(_xml, copied, std::string::npos);
+  return result;
+}
+
+/////////////////////////////////////////////////
+/// \brief Remove the messages of a repeated field that aren't kept,
+/// keeping the order of the others.
+/// \param[in,out] _field The repeated field.
+/// \param[in] _keep Check if a message is kept, and prune it.
+template<typename T>
+static void PruneRepeated(google::protobuf::RepeatedPtrField<T> *_field,
+    const std::function<bool(T &)> &_keep)
+{
+  int kept = 0;
+  for (int i = 0; i < _field->size(); ++i)
+  {
+    if (_keep(*_field->Mutable(i)))
+      _field->SwapElements(i, kept++);
+  }
+  _field->DeleteSubrange(kept, _field->size() - kept);
+}
+
+/////////////////////////////////////////////////
+/// \brief Split a list of filter elements, such as [x,y].
+/// \param[in] _filter The filter elements.
+/// \return The elements, empty if there are none.
+static std::list<std::string> FilterElements(std::string _filter)
+{
+  std::list<std::string> elements;
+
+  // Remove brackets, if they exist
+  boost::erase_all(_filter, "[");
+  boost::erase_all(_filter, "]");
+
+  if (!_filter.empty())
+    boost::split(elements, _filter, boost::is_any_of(","));
+
+  return elements;
+}
+
+/////////////////////////////////////////////////
+/// \brief Separate the values of each line of raw output with commas.
+/// \param[in] _raw Raw output, with values separated by whitespace.
+/// \return Comma separated values, with a row for each non-empty line.
+static std::string ToCsv(const std::string &_raw)
+{
+  std::string result;
+  std::istringstream lines(_raw);
+  std::string line;
+  while (std::getline(lines, line))
+  {
+    std::istringstream values(line);
+    std::string value;
+    bool first = true;
+    while (values >> value)
+    {
+      if (!first)
+        result += ',';
+      result += value;
+      first = false;
+    }
+
+    if (!first)
+      result += '\n';
+  }
+
+  return result;
+}
+
 /////////////////////////////////////////////////
 FilterBase::FilterBase(bool _xmlOutput, const std::string &_stamp)
 : xmlOutput(_xmlOutput), stamp(_stamp)
@@ -149,6 +363,53 @@ std::string FilterBase::FilterPose(const ignition::math::Pose3d &_pose,
   return result.str();
 }
 
+/////////////////////////////////////////////////
+void FilterBase::PoseValues(const ignition::math::Pose3d &_pose,
+    const std::string &_name, std::string _filter, StateValues &_values)
+{
+  std::list<std::string> elements = FilterElements(_filter);
+  if (elements.empty())
+    elements = {"x", "y", "z", "r", "p", "a"};
+
+  ignition::math::Vector3d rpy = _pose.Rot().Euler();
+  for (auto const &element : elements)
+  {
+    double value;
+    switch (element[0])
+    {
+      case 'X':
+      case 'x':
+        value = _pose.Pos().X();
+        break;
+      case 'Y':
+      case 'y':
+        value = _pose.Pos().Y();
+        break;
+      case 'Z':
+      case 'z':
+        value = _pose.Pos().Z();
+        break;
+      case 'R':
+      case 'r':
+        value = rpy.X();
+        break;
+      case 'P':
+      case 'p':
+        value = rpy.Y();
+        break;
+      case 'A':
+      case 'a':
+        value = rpy.Z();
+        break;
+      default:
+        std::cerr << "Invalid pose value[" << element << "]\n";
+        continue;
+    }
+
+    _values.values.emplace_back(_name + "." +
+        static_cast<char>(std::tolower(element[0])), value);
+  }
+}
 
 /////////////////////////////////////////////////
 JointFilter::JointFilter(bool _xmlOutput, const std::string &_stamp)
@@ -168,6 +429,15 @@ void JointFilter::Init(const std::string &_filter)
     if (this->parts.empty())
       this->parts.push_back(_filter);
   }
+
+  if (!this->parts.empty())
+    this->regex = FilterRegex(this->parts.front());
+}
+
+/////////////////////////////////////////////////
+bool JointFilter::Selects(const std::string &_name) const
+{
+  return this->parts.empty() || boost::regex_match(_name, this->regex);
 }
 
 /////////////////////////////////////////////////
@@ -235,10 +505,7 @@ std::string JointFilter::Filter(gazebo::physics::ModelState &_state)
   partIter = this->parts.begin();
 
   // The first element in the filter must be a link name or a star.
-  std::string regexStr = *partIter;
-  boost::replace_all(regexStr, "*", ".*");
-  boost::regex regex(regexStr);
-  states = _state.GetJointStates(regex);
+  states = _state.GetJointStates(this->regex);
 
   ++partIter;
 
@@ -271,6 +538,47 @@ std::string JointFilter::Filter(gazebo::physics::ModelState &_state)
   return result.str();
 }
 
+/////////////////////////////////////////////////
+void JointFilter::Values(const gazebo::physics::ModelState &_state,
+    StateValues &_values) const
+{
+  std::list<std::string> elements;
+  if (this->parts.size() > 1)
+    elements = FilterElements(*std::next(this->parts.begin()));
+
+  for (auto const &joint : _state.GetJointStates())
+  {
+    const gazebo::physics::JointState &state = joint.second;
+    if (!this->Selects(state.GetName()))
+      continue;
+
+    const std::string name = _state.GetName() + "//" + state.GetName() + ".";
+    if (elements.empty())
+    {
+      for (unsigned int axis = 0; axis < state.GetAngleCount(); ++axis)
+      {
+        _values.values.emplace_back(name + std::to_string(axis),
+            state.Position(axis));
+      }
+      continue;
+    }
+
+    for (auto const &element : elements)
+    {
+      try
+      {
+        unsigned int axis = boost::lexical_cast<unsigned int>(element);
+        if (axis < state.GetAngleCount())
+          _values.values.emplace_back(name + element, state.Position(axis));
+      }
+      catch(...)
+      {
+        std::cerr << "Invalid axis value[" << element << "]\n";
+      }
+    }
+  }
+}
+
 /////////////////////////////////////////////////
 LinkFilter::LinkFilter(bool _xmlOutput, const std::string &_stamp)
 : FilterBase(_xmlOutput, _stamp)
@@ -289,6 +597,16 @@ void LinkFilter::Init(const std::string &_filter)
     if (this->parts.empty())
       this->parts.push_back(_filter);
   }
+
+  this->all = this->parts.empty() || this->parts.front() == "*";
+  if (!this->all)
+    this->regex = FilterRegex(this->parts.front());
+}
+
+/////////////////////////////////////////////////
+bool LinkFilter::Selects(const std::string &_name) const
+{
+  return this->all || boost::regex_match(_name, this->regex);
 }
 
 /////////////////////////////////////////////////
@@ -339,13 +657,8 @@ std::string LinkFilter::Filter(gazebo::physics::ModelState &_state)
   partIter = this->parts.begin();
 
   // The first element in the filter must be a link name or a star.
-  if (*partIter != "*")
-  {
-    std::string regexStr = *partIter;
-    boost::replace_all(regexStr, "*", ".*");
-    boost::regex regex(regexStr);
-    states = _state.GetLinkStates(regex);
-  }
+  if (!this->all)
+    states = _state.GetLinkStates(this->regex);
   else
     states = _state.GetLinkStates();
 
@@ -375,6 +688,41 @@ std::string LinkFilter::Filter(gazebo::physics::ModelState &_state)
   return result.str();
 }
 
+/////////////////////////////////////////////////
+void LinkFilter::Values(const gazebo::physics::ModelState &_state,
+    StateValues &_values) const
+{
+  // The part of the link, and its elements
+  std::string part, elements;
+  auto partIter = this->parts.begin();
+  if (partIter != this->parts.end() && ++partIter != this->parts.end())
+  {
+    part = *partIter;
+    if (++partIter != this->parts.end())
+      elements = *partIter;
+  }
+
+  for (auto const &link : _state.GetLinkStates())
+  {
+    const gazebo::physics::LinkState &state = link.second;
+    if (!this->Selects(state.GetName()))
+      continue;
+
+    const std::string name = _state.GetName() + "/" + state.GetName() + ".";
+    if (part.empty() || part == "pose")
+      this->PoseValues(state.Pose(), name + "pose", elements, _values);
+    if (part.empty() || part == "velocity")
+      this->PoseValues(state.Velocity(), name + "velocity", elements, _values);
+    if (part.empty() || part == "acceleration")
+    {
+      this->PoseValues(state.Acceleration(), name + "acceleration", elements,
+          _values);
+    }
+    if (part.empty() || part == "wrench")
+      this->PoseValues(state.Wrench(), name + "wrench", elements, _values);
+  }
+}
+
 /////////////////////////////////////////////////
 ModelFilter::ModelFilter(bool _xmlOutput, const std::string &_stamp)
 : FilterBase(_xmlOutput, _stamp)
@@ -396,6 +744,7 @@ void ModelFilter::Init(const std::string &_filter)
   this->linkFilter = NULL;
   this->jointFilter = NULL;
   this->parts.clear();
+  this->all = true;
 
   if (_filter.empty())
     return;
@@ -412,6 +761,11 @@ void ModelFilter::Init(const std::string &_filter)
       this->parts.push_back(mainParts.front());
   }
 
+  this->all = this->parts.empty() || this->parts.front().empty() ||
+      this->parts.front() == "*";
+  if (!this->all)
+    this->regex = FilterRegex(this->parts.front());
+
   if (mainParts.empty())
     return;
 
@@ -475,14 +829,8 @@ std::string ModelFilter::Filter(gazebo::physics::WorldState &_state)
   std::list<std::string>::iterator partIter = this->parts.begin();
 
   // The first element in the filter must be a model name or a star.
-  if (partIter != this->parts.end() && !this->parts.empty() &&
-      !(*partIter).empty() && (*partIter) != "*")
-  {
-    std::string regexStr = *partIter;
-    boost::replace_all(regexStr, "*", ".*");
-    boost::regex regex(regexStr);
-    states = _state.GetModelStates(regex);
-  }
+  if (!this->all)
+    states = _state.GetModelStates(this->regex);
   else
     states = _state.GetModelStates();
 
@@ -522,11 +870,172 @@ std::string ModelFilter::Filter(gazebo::physics::WorldState &_state)
   return result.str();
 }
 
+/////////////////////////////////////////////////
+bool ModelFilter::Selects(const std::string &_name) const
+{
+  return this->all || boost::regex_match(_name, this->regex);
+}
+
+/////////////////////////////////////////////////
+bool ModelFilter::Whole() const
+{
+  return !this->linkFilter && !this->jointFilter && this->parts.size() <= 1;
+}
+
+/////////////////////////////////////////////////
+std::string ModelFilter::Prune(const std::string &_stateString) const
+{
+  if (this->all && this->Whole())
+    return _stateString;
+
+  auto from = _stateString.find("<state");
+  if (from == std::string::npos)
+    return _stateString;
+
+  // The models of the insertions are SDF, not states
+  for (auto const &tag : {"</insertions>", "</deletions>"})
+  {
+    auto pos = _stateString.find(tag, from);
+    if (pos != std::string::npos)
+      from = std::max(from, pos);
+  }
+
+  return PruneElements(_stateString, "model", from,
+      [this](const std::string &_name)
+      {
+        return this->Selects(_name);
+      },
+      [this](const std::string &_model)
+      {
+        return this->PruneModel(_model);
+      });
+}
+
+/////////////////////////////////////////////////
+std::string ModelFilter::PruneModel(const std::string &_model) const
+{
+  if (this->Whole())
+    return _model;
+
+  // Only the pose, links and joints of the model are output
+  auto body = _model.find('>');
+  if (body == std::string::npos)
+    return _model;
+
+  auto none = [](const std::string &)
+  {
+    return false;
+  };
+
+  std::string result = PruneElements(_model, "model", body, none);
+  if (this->linkFilter)
+  {
+    result = PruneElements(result, "link", 0,
+        [this](const std::string &_name)
+        {
+          return this->linkFilter->Selects(_name);
+        });
+  }
+  else
+    result = PruneElements(result, "link", 0, none);
+
+  if (this->jointFilter)
+  {
+    result = PruneElements(result, "joint", 0,
+        [this](const std::string &_name)
+        {
+          return this->jointFilter->Selects(_name);
+        });
+  }
+  else
+    result = PruneElements(result, "joint", 0, none);
+
+  return result;
+}
+
+/////////////////////////////////////////////////
+void ModelFilter::Prune(gazebo::msgs::WorldState &_msg) const
+{
+  if (this->all && this->Whole())
+    return;
+
+  PruneRepeated<gazebo::msgs::ModelState>(_msg.mutable_model(),
+      [this](gazebo::msgs::ModelState &_model)
+      {
+        if (!this->Selects(_model.name()))
+          return false;
+
+        if (this->Whole())
+          return true;
+
+        _model.clear_model();
+        PruneRepeated<gazebo::msgs::LinkState>(_model.mutable_link(),
+            [this](gazebo::msgs::LinkState &_link)
+            {
+              return this->linkFilter &&
+                  this->linkFilter->Selects(_link.name());
+            });
+        PruneRepeated<gazebo::msgs::JointState>(_model.mutable_joint(),
+            [this](gazebo::msgs::JointState &_joint)
+            {
+              return this->jointFilter &&
+                  this->jointFilter->Selects(_joint.name());
+            });
+        return true;
+      });
+}
+
+/////////////////////////////////////////////////
+void ModelFilter::Values(const gazebo::physics::WorldState &_state,
+    StateValues &_values) const
+{
+  for (auto const &model : _state.GetModelStates())
+  {
+    const gazebo::physics::ModelState &state = model.second;
+    if (!this->Selects(state.GetName()))
+      continue;
+
+    // All the values of the model
+    if (this->Whole())
+    {
+      this->PoseValues(state.Pose(), state.GetName() + ".pose", "", _values);
+      LinkFilter(false, "").Values(state, _values);
+      JointFilter(false, "").Values(state, _values);
+      continue;
+    }
+
+    // Currently a model can only have a pose.
+    auto partIter = this->parts.begin();
+    if (partIter != this->parts.end() && ++partIter != this->parts.end())
+    {
+      if (*partIter == "pose")
+      {
+        std::string elements;
+        if (++partIter != this->parts.end())
+          elements = *partIter;
+        this->PoseValues(state.Pose(), state.GetName() + ".pose", elements,
+            _values);
+      }
+      else
+      {
+        std::cerr << "Invalid model state component["
+          << *partIter << "]\n";
+      }
+    }
+
+    if (this->linkFilter)
+      this->linkFilter->Values(state, _values);
+
+    if (this->jointFilter)
+      this->jointFilter->Values(state, _values);
+  }
+}
+
 /////////////////////////////////////////////////
 StateFilter::StateFilter(bool _xmlOutput, const std::string &_stamp,
-              double _hz)
+              double _hz, bool _csv)
 : FilterBase(_xmlOutput, _stamp), filter(_xmlOutput, _stamp),
-  hz(_hz)
+  hz(_hz), csv(_csv && !_xmlOutput)
 {}
 
 /////////////////////////////////////////////////
@@ -541,31 +1050,83 @@ std::string StateFilter::Filter(const std::string &_stateString)
   gazebo::physics::WorldState state;
 
   // Read and parse the state information
-  g_stateSdf->Clear();
-  sdf::readString(_stateString, g_stateSdf);
-  state.Load(g_stateSdf);
+  this->Load(_stateString, g_stateSdf, state);
 
-  std::ostringstream result;
+  if (!this->Admit(state.GetSimTime()))
+    return std::string();
 
-  if (this->hz > 0.0 && this->prevTime != gazebo::common::Time::Zero)
+  return this->Format(state);
+}
+
+/////////////////////////////////////////////////
+void StateFilter::Load(const std::string &_stateString,
+    const sdf::ElementPtr &_sdf, gazebo::physics::WorldState &_state) const
+{
+  auto binaryStart = _stateString.find(kBinaryStateStart);
+  auto binaryEnd = _stateString.find(kBinaryStateEnd);
+  if (binaryStart != std::string::npos && binaryEnd != std::string::npos)
   {
-    if ((state.GetSimTime() - this->prevTime).Double() <
-        1.0 / this->hz)
+    binaryStart += kBinaryStateStart.size();
+    gazebo::msgs::WorldState msg;
+    if (!msg.ParseFromString(Base64Decode(
+          _stateString.substr(binaryStart, binaryEnd - binaryStart))))
     {
-      return result.str();
+      std::cerr << "Unable to parse a binary state\n";
+      return;
     }
+
+    this->filter.Prune(msg);
+    _state.Load(msg);
+    return;
+  }
+
+  // The keyframe isn't part of the state
+  std::string stateString;
+  auto keyframeStart = _stateString.find(kKeyframeStart);
+  auto keyframeEnd = _stateString.find(kKeyframeEnd);
+  if (keyframeStart != std::string::npos && keyframeEnd != std::string::npos)
+  {
+    stateString = _stateString;
+    stateString.erase(keyframeStart,
+        keyframeEnd + kKeyframeEnd.size() - keyframeStart);
+    stateString = this->filter.Prune(stateString);
   }
+  else
+    stateString = this->filter.Prune(_stateString);
+
+  _sdf->Clear();
+  sdf::readString(stateString, _sdf);
+  _state.Load(_sdf);
+}
+
+/////////////////////////////////////////////////
+bool StateFilter::Admit(const gazebo::common::Time &_simTime)
+{
+  if (this->hz > 0.0 && this->prevTime != gazebo::common::Time::Zero)
+  {
+    if ((_simTime - this->prevTime).Double() < 1.0 / this->hz)
+      return false;
+  }
+
+  this->prevTime = _simTime;
+  return true;
+}
+
+/////////////////////////////////////////////////
+std::string StateFilter::Format(gazebo::physics::WorldState &_state)
+{
+  std::ostringstream result;
 
   if (this->xmlOutput)
   {
     result << "<sdf version='" << SDF_VERSION << "'>\n"
-      << "<state world_name='" << state.GetName() << "'>\n"
-      << "<sim_time>" << state.GetSimTime() << "</sim_time>\n"
-      << "<real_time>" << state.GetRealTime() << "</real_time>\n"
-      << "<wall_time>" << state.GetWallTime() << "</wall_time>\n"
-      << "<iterations>" << state.GetIterations() << "</iterations>\n";
+      << "<state world_name='" << _state.GetName() << "'>\n"
+      << "<sim_time>" << _state.GetSimTime() << "</sim_time>\n"
+      << "<real_time>" << _state.GetRealTime() << "</real_time>\n"
+      << "<wall_time>" << _state.GetWallTime() << "</wall_time>\n"
+      << "<iterations>" << _state.GetIterations() << "</iterations>\n";
 
-    auto insertions = state.Insertions();
+    auto insertions = _state.Insertions();
     if (insertions.size() > 0)
       result << "<insertions>" << std::endl;
     for (auto insertion : insertions)
@@ -573,7 +1134,7 @@ std::string StateFilter::Filter(const std::string &_stateString)
     if (insertions.size() > 0)
       result << "</insertions>" << std::endl;
 
-    auto deletions = state.Deletions();
+    auto deletions = _state.Deletions();
     if (deletions.size() > 0)
       result << "<deletions>" << std::endl;
     for (auto deletion : deletions)
@@ -582,15 +1143,29 @@ std::string StateFilter::Filter(const std::string &_stateString)
       result << "</deletions>" << std::endl;
   }
 
-  result << this->filter.Filter(state);
+  result << this->filter.Filter(_state);
 
   if (this->xmlOutput)
     result << "</state></sdf>\n";
 
-  this->prevTime = state.GetSimTime();
+  if (this->csv)
+    return ToCsv(result.str());
+
   return result.str();
 }
 
+/////////////////////////////////////////////////
+void StateFilter::Values(const gazebo::physics::WorldState &_state,
+    StateValues &_values) const
+{
+  _values.simTime = _state.GetSimTime();
+  _values.realTime = _state.GetRealTime();
+  _values.wallTime = _state.GetWallTime();
+  _values.iterations = _state.GetIterations();
+  _values.values.clear();
+  this->filter.Values(_state, _values);
+}
+
 /////////////////////////////////////////////////
 LogCommand::LogCommand()
   : Command("log", "Introspects and manipulates Gazebo log files.")
@@ -622,7 +1197,16 @@ LogCommand::LogCommand()
      "Valid in conjunction with the output command. See also the "
      "--output argument.")
     ("filter", po::value<std::string>(),
-     "Filter output. Valid only with the echo, step, and output commands");
+     "Filter output. Valid only with the echo, step, and output commands")
+    ("csv", "Output the data from echo, step and output as comma separated "
+     "values, a row for each line of raw output. Implies --raw.")
+    ("columns", po::value<std::string>(), "Export the filtered values of "
+     "the states to a file of columns of numbers, which can be "
+     "memory-mapped. Valid in conjunction with the filter, hz and threads "
+     "commands.")
+    ("threads", po::value<unsigned int>(), "Number of threads that decode "
+     "and filter the states of a log file. Valid only with the echo, "
+     "output and columns commands. Defaults to the number of cores.");
 }
 
 /////////////////////////////////////////////////
@@ -647,6 +1231,8 @@ bool LogCommand::RunImpl()
   std::string filename, filter, stamp, worldName;
   double hz = 0;
   bool raw = false;
+  bool csv = false;
+  unsigned int threads = 1;
 
   if (this->vm.count("world-name"))
     worldName = this->vm["world-name"].as<std::string>();
@@ -666,7 +1252,14 @@ bool LogCommand::RunImpl()
   // Get hz
   hz = this->vm.count("hz") ? this->vm["hz"].as<double>() : 0;
 
-  raw = this->vm.count("raw");
+  csv = this->vm.count("csv");
+  raw = this->vm.count("raw") || csv;
+
+  // Get threads
+  threads = this->vm.count("threads") ?
+    this->vm["threads"].as<unsigned int>() :
+    std::thread::hardware_concurrency();
+  threads = std::max(1u, threads);
 
   if (!this->vm.count("record"))
   {
@@ -692,18 +1285,20 @@ bool LogCommand::RunImpl()
   g_stateSdf.reset(new sdf::Element);
   sdf::initFile("state.sdf", g_stateSdf);
 
-  if (this->vm.count("output"))
+  if (this->vm.count("columns"))
+    this->Columns(this->vm["columns"].as<std::string>(), filter, hz, threads);
+  else if (this->vm.count("output"))
   {
     std::string encoding = this->vm.count("encoding") ?
       this->vm["encoding"].as<std::string>() : "";
 
     this->Output(this->vm["output"].as<std::string>(), filter, raw, stamp, hz,
-        encoding);
+        encoding, csv, threads);
   }
   else if (this->vm.count("echo"))
-    this->Echo(filter, raw, stamp, hz);
+    this->Echo(filter, raw, stamp, hz, csv, threads);
   else if (this->vm.count("step"))
-    this->Step(filter, raw, stamp, hz);
+    this->Step(filter, raw, stamp, hz, csv);
   else if (this->vm.count("record"))
     this->Record(this->vm["record"].as<bool>());
   else if (this->vm.count("info"))
@@ -820,7 +1415,8 @@ void LogCommand::Info(const std::string &_filename)
 /////////////////////////////////////////////////
 void LogCommand::Output(const std::string &_outFilename,
     const std::string &_filter, const bool _raw,
-    const std::string &_stamp, const double _hz, const std::string &_encoding)
+    const std::string &_stamp, const double _hz, const std::string &_encoding,
+    const bool _csv, const unsigned int _threads)
 {
   std::ofstream outFile(_outFilename, std::fstream::out | std::ios::binary);
 
@@ -838,7 +1434,7 @@ void LogCommand::Output(const std::string &_outFilename,
     return;
   }
 
-  std::string stateString, bufferString;
+  std::string bufferString;
 
   std::string encoding = _encoding.empty() ? play->Encoding() : _encoding;
   if (encoding != "txt" && encoding != "zlib" && encoding != "bz2")
@@ -856,29 +1452,27 @@ void LogCommand::Output(const std::string &_outFilename,
     outFile.write(header.c_str(), header.size());
   }
 
-  StateFilter filter(!_raw, _stamp, _hz);
+  StateFilter filter(!_raw, _stamp, _hz, _csv);
   filter.Init(_filter);
 
-  unsigned int i = 0;
-  while (play->Step(stateString))
-  {
-    if (i == 0 && !_raw)
-    {
-      this->OutputWriter(outFile, stateString, _raw, encoding);
-    }
-    else
-    {
-      bufferString += filter.Filter(stateString);
-
-      if (i%1000 == 0 && !bufferString.empty())
+  this->FilterFrames(filter, _threads,
+      [&](const unsigned int _i, const std::string &_state)
       {
-        this->OutputWriter(outFile, bufferString, _raw, encoding);
-        bufferString.clear();
-      }
-    }
+        if (_i == 0 && !_raw)
+        {
+          this->OutputWriter(outFile, _state, _raw, encoding);
+        }
+        else
+        {
+          bufferString += _i == 0 ? filter.Filter(_state) : _state;
 
-    ++i;
-  }
+          if (_i%1000 == 0 && !bufferString.empty())
+          {
+            this->OutputWriter(outFile, bufferString, _raw, encoding);
+            bufferString.clear();
+          }
+        }
+      });
 
   if (!bufferString.empty())
     this->OutputWriter(outFile, bufferString, _raw, encoding);
@@ -892,41 +1486,151 @@ void LogCommand::Output(const std::string &_outFilename,
   outFile.close();
 }
 
+/////////////////////////////////////////////////
+void LogCommand::Columns(const std::string &_outFilename,
+    const std::string &_filter, const double _hz,
+    const unsigned int _threads)
+{
+  gazebo::util::LogPlay *play = gazebo::util::LogPlay::Instance();
+  if (!play->IsOpen())
+  {
+    std::cerr << "No source log file specified. Use the -f command line "
+      << "argument.\n";
+    return;
+  }
+
+  std::ofstream outFile(_outFilename, std::fstream::out | std::ios::binary);
+  if (!outFile.is_open())
+  {
+    std::cerr << "Unable to open file[" << _outFilename << "] for writing.\n";
+    return;
+  }
+
+  StateFilter filter(false, "", _hz);
+  filter.Init(_filter);
+
+  // The columns are kept in memory until the row count is known
+  std::vector<double> simTimes, realTimes, wallTimes;
+  std::vector<uint64_t> iterations;
+  std::vector<std::string> names;
+  std::vector<std::vector<double>> columns;
+  std::unordered_map<std::string, size_t> columnIndex;
+  const double missing = std::numeric_limits<double>::quiet_NaN();
+
+  this->FilterFrames(filter, _threads, nullptr,
+      [&](const StateValues &_values)
+      {
+        const size_t row = simTimes.size();
+        simTimes.push_back(_values.simTime.Double());
+        realTimes.push_back(_values.realTime.Double());
+        wallTimes.push_back(_values.wallTime.Double());
+        iterations.push_back(_values.iterations);
+
+        for (auto const &value : _values.values)
+        {
+          auto iter = columnIndex.find(value.first);
+          if (iter == columnIndex.end())
+          {
+            iter = columnIndex.emplace(value.first, columns.size()).first;
+            names.push_back(value.first);
+            columns.emplace_back(row, missing);
+          }
+
+          std::vector<double> &column = columns[iter->second];
+          if (column.size() > row)
+            column[row] = value.second;
+          else
+            column.push_back(value.second);
+        }
+
+        for (auto &column : columns)
+          column.resize(row + 1, missing);
+      });
+
+  // Offsets are padded, so that the size of the header doesn't depend on
+  // them.
+  const unsigned int offsetWidth = 20;
+  const uint16_t byteOrder = 1;
+  std::vector<std::pair<std::string, std::string>> header = {
+      {"u64", "iterations"}, {"f64", "sim_time"}, {"f64", "real_time"},
+      {"f64", "wall_time"}};
+  for (auto const &name : names)
+    header.emplace_back("f64", name);
+
+  std::ostringstream prefix;
+  prefix << "gazebo_columns 1\n"
+    << "byte_order "
+    << (*reinterpret_cast<const uint8_t *>(&byteOrder) ? "little" : "big")
+    << "\n"
+    << "rows " << simTimes.size() << "\n";
+
+  size_t headerSize = prefix.str().size() + std::string("end\n").size();
+  for (auto const &column : header)
+  {
+    headerSize += column.first.size() + 1 + offsetWidth + 1 +
+        column.second.size() + 1;
+  }
+
+  // Each column starts on a multiple of 8 bytes
+  const size_t dataStart = (headerSize + 7) / 8 * 8;
+  const size_t columnSize = simTimes.size() * sizeof(double);
+
+  std::ostringstream text;
+  text << prefix.str();
+  for (size_t c = 0; c < header.size(); ++c)
+  {
+    text << header[c].first << " " << std::setfill('0')
+      << std::setw(offsetWidth) << dataStart + c * columnSize << " "
+      << header[c].second << "\n";
+  }
+  text << "end\n";
+
+  std::string headerString = text.str();
+  headerString.resize(dataStart, '\n');
+  outFile.write(headerString.c_str(), headerString.size());
+
+  auto write = [&outFile](const void *_data, const size_t _size)
+  {
+    outFile.write(static_cast<const char *>(_data), _size);
+  };
+  write(iterations.data(), columnSize);
+  write(simTimes.data(), columnSize);
+  write(realTimes.data(), columnSize);
+  write(wallTimes.data(), columnSize);
+  for (auto const &column : columns)
+    write(column.data(), columnSize);
+
+  outFile.close();
+}
+
 /////////////////////////////////////////////////
 void LogCommand::Echo(const std::string &_filter, bool _raw,
-    const std::string &_stamp, double _hz)
+    const std::string &_stamp, double _hz, const bool _csv,
+    const unsigned int _threads)
 {
   gazebo::util::LogPlay *play = gazebo::util::LogPlay::Instance();
-  std::string stateString;
 
   // Output the header
   if (!_raw)
     std::cout << play->Header() << std::endl;
 
-  StateFilter filter(!_raw, _stamp, _hz);
+  StateFilter filter(!_raw, _stamp, _hz, _csv);
   filter.Init(_filter);
 
-  unsigned int i = 0;
-  while (play->Step(stateString))
-  {
-    if (i > 0)
-      stateString = filter.Filter(stateString);
-    else if (i == 0 && _raw)
-      stateString.clear();
-
-    if (!stateString.empty())
-    {
-      if (!_raw)
-        std::cout << "<chunk encoding='txt'><![CDATA[\n";
+  this->FilterFrames(filter, _threads,
+      [&](const unsigned int _i, const std::string &_state)
+      {
+        if (_state.empty() || (_i == 0 && _raw))
+          return;
 
-      std::cout << stateString;
+        if (!_raw)
+          std::cout << "<chunk encoding='txt'><![CDATA[\n";
 
-      if (!_raw)
-        std::cout << "]]></chunk>\n";
-    }
+        std::cout << _state;
 
-    ++i;
-  }
+        if (!_raw)
+          std::cout << "]]></chunk>\n";
+      });
 
   if (!_raw)
     std::cout << "</gazebo_log>\n";
@@ -934,7 +1638,7 @@ void LogCommand::Echo(const std::string &_filter, bool _raw,
 
 /////////////////////////////////////////////////
 void LogCommand::Step(const std::string &_filter, bool _raw,
-    const std::string &_stamp, double _hz)
+    const std::string &_stamp, double _hz, const bool _csv)
 {
   std::string stateString;
   gazebo::util::LogPlay *play = gazebo::util::LogPlay::Instance();
@@ -944,7 +1648,7 @@ void LogCommand::Step(const std::string &_filter, bool _raw,
 
   char c = '\0';
 
-  StateFilter filter(!_raw, _stamp, _hz);
+  StateFilter filter(!_raw, _stamp, _hz, _csv);
   filter.Init(_filter);
 
   unsigned int i = 0;
@@ -980,6 +1684,98 @@ void LogCommand::Step(const std::string &_filter, bool _raw,
     std::cout << "</gazebo_log>\n";
 }
 
+/////////////////////////////////////////////////
+void LogCommand::FilterFrames(StateFilter &_filter,
+    const unsigned int _threads,
+    const std::function<void(const unsigned int, const std::string &)> &_cb,
+    const std::function<void(const StateValues &)> &_valuesCb)
+{
+  gazebo::util::LogPlay *play = gazebo::util::LogPlay::Instance();
+
+  // Filtered state of a frame
+  struct Frame
+  {
+    /// \brief Output of the state, or the first frame.
+    std::string output;
+
+    /// \brief Values of the state, if they are requested.
+    StateValues values;
+  };
+  using Frames = std::vector<Frame>;
+
+  // Decode and filter a chunk. The first frame of the log is the world's
+  // SDF, which is left as it is.
+  const bool values = static_cast<bool>(_valuesCb);
+  auto filterChunk = [play, values, &_filter](const unsigned int _chunk,
+      sdf::ElementPtr _sdf)
+  {
+    Frames result;
+    std::vector<std::string> frames;
+    play->ChunkFrames(_chunk, frames);
+    result.resize(frames.size());
+    for (size_t f = 0; f < frames.size(); ++f)
+    {
+      if (_chunk == 0 && f == 0)
+      {
+        result[f].output.swap(frames[f]);
+        continue;
+      }
+
+      gazebo::physics::WorldState state;
+      _filter.Load(frames[f], _sdf, state);
+      if (values)
+        _filter.Values(state, result[f].values);
+      else
+      {
+        result[f].values.simTime = state.GetSimTime();
+        result[f].output = _filter.Format(state);
+      }
+    }
+    return result;
+  };
+
+  // Chunks are filtered in order, a few ahead of the output
+  const std::launch policy = _threads > 1 ?
+      std::launch::async : std::launch::deferred;
+  const unsigned int window = _threads > 1 ? _threads * kChunksPerThread : 1;
+
+  std::deque<std::future<Frames>> pending;
+  unsigned int next = 0;
+  unsigned int i = 0;
+  while (next < play->ChunkCount() || !pending.empty())
+  {
+    while (next < play->ChunkCount() && pending.size() < window)
+    {
+      pending.push_back(std::async(policy, filterChunk, next,
+            g_stateSdf->Clone()));
+      ++next;
+    }
+
+    Frames frames = pending.front().get();
+    pending.pop_front();
+
+    // The output rate is checked in log order
+    for (auto const &frame : frames)
+    {
+      if (i == 0)
+      {
+        if (!values)
+          _cb(i, frame.output);
+      }
+      else if (!_filter.Admit(frame.values.simTime))
+      {
+        if (!values)
+          _cb(i, std::string());
+      }
+      else if (values)
+        _valuesCb(frame.values);
+      else
+        _cb(i, frame.output);
+      ++i;
+    }
+  }
+}
+
 /////////////////////////////////////////////////
 void LogCommand::Record(bool _start)
 {
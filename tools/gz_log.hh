@@ -17,14 +17,42 @@
 #ifndef GAZEBO_TOOLS_GZLOG_HH_
 #define GAZEBO_TOOLS_GZLOG_HH_
 
+#include <functional>
 #include <string>
 #include <list>
+#include <utility>
+#include <vector>
 
+#include <boost/regex.hpp>
+#include <sdf/sdf.hh>
+
+#include <gazebo/msgs/msgs.hh>
 #include <gazebo/physics/WorldState.hh>
 #include "gz.hh"
 
 namespace gazebo
 {
+  /// \brief Values of the filtered parts of a state, for columnar output.
+  class StateValues
+  {
+    /// \brief Simulation time of the state.
+    public: gazebo::common::Time simTime;
+
+    /// \brief Real time of the state.
+    public: gazebo::common::Time realTime;
+
+    /// \brief Wall time of the state.
+    public: gazebo::common::Time wallTime;
+
+    /// \brief Iterations of the state.
+    public: uint64_t iterations = 0;
+
+    /// \brief Names and values, named like the filter that selects them,
+    /// such as "model.pose.x", "model/link.velocity.y" and
+    /// "model//joint.0".
+    public: std::vector<std::pair<std::string, double>> values;
+  };
+
   /// \brief Base class for all filters.
   class FilterBase
   {
@@ -52,6 +80,17 @@ namespace gazebo
                 std::string _filter,
                 const gazebo::physics::State &_state);
 
+    /// \brief Get the filtered values of a pose.
+    /// \param[in] _pose The pose to filter.
+    /// \param[in] _name Name of the pose's values, which is followed by
+    /// the element of each value.
+    /// \param[in] _filter The filter string [x,y,z,r,p,a], empty for all
+    /// elements.
+    /// \param[in,out] _values Values to append to.
+    public: static void PoseValues(const ignition::math::Pose3d &_pose,
+                const std::string &_name, std::string _filter,
+                StateValues &_values);
+
     /// \brief True if XML output is requested.
     protected: bool xmlOutput;
 
@@ -85,8 +124,22 @@ namespace gazebo
     /// \return Filtered string.
     public: std::string Filter(gazebo::physics::ModelState &_state);
 
+    /// \brief Check if the filter outputs a joint.
+    /// \param[in] _name Name of the joint.
+    /// \return True if the joint's name matches the filter.
+    public: bool Selects(const std::string &_name) const;
+
+    /// \brief Get the filtered joint positions of a model state.
+    /// \param[in] _state The model state to filter.
+    /// \param[in,out] _values Values to append to.
+    public: void Values(const gazebo::physics::ModelState &_state,
+                StateValues &_values) const;
+
     /// \brief The list of filter strings.
     public: std::list<std::string> parts;
+
+    /// \brief Joint names matched by the filter.
+    private: boost::regex regex;
   };
 
   /// \brief Filter for link state.
@@ -115,8 +168,26 @@ namespace gazebo
     /// \return Filtered string.
     public: std::string Filter(gazebo::physics::ModelState &_state);
 
+    /// \brief Check if the filter outputs a link.
+    /// \param[in] _name Name of the link.
+    /// \return True if the link's name matches the filter.
+    public: bool Selects(const std::string &_name) const;
+
+    /// \brief Get the filtered link values of a model state.
+    /// \param[in] _state The model state to filter.
+    /// \param[in,out] _values Values to append to.
+    public: void Values(const gazebo::physics::ModelState &_state,
+                StateValues &_values) const;
+
     /// \brief The list of filter strings.
     public: std::list<std::string> parts;
+
+    /// \brief True if the filter outputs all links.
+    private: bool all = true;
+
+    /// \brief Link names matched by the filter, if it doesn't output all
+    /// links.
+    private: boost::regex regex;
   };
 
   /// \brief Filter for model state.
@@ -148,6 +219,40 @@ namespace gazebo
     /// \return Filtered string.
     public: std::string Filter(gazebo::physics::WorldState &_state);
 
+    /// \brief Check if the filter outputs a model.
+    /// \param[in] _name Name of the model.
+    /// \return True if the model's name matches the filter.
+    public: bool Selects(const std::string &_name) const;
+
+    /// \brief Remove the models, links and joints that the filter doesn't
+    /// output from a state, so that they aren't parsed.
+    /// \param[in] _stateString The <sdf> frame of a state.
+    /// \return The frame without the unused parts of the state.
+    public: std::string Prune(const std::string &_stateString) const;
+
+    /// \brief Remove the models, links and joints that the filter doesn't
+    /// output from a binary state, so that they aren't loaded.
+    /// \param[in,out] _msg The state.
+    public: void Prune(gazebo::msgs::WorldState &_msg) const;
+
+    /// \brief Get the filtered values of the models in a World state.
+    /// A model without pose, link or joint filters has all its values.
+    /// \param[in] _state The World state to filter.
+    /// \param[in,out] _values Values to append to.
+    public: void Values(const gazebo::physics::WorldState &_state,
+                StateValues &_values) const;
+
+    /// \brief Remove the links, joints and nested models that the filter
+    /// doesn't output from the <model> element of a selected model.
+    /// \param[in] _model The model element.
+    /// \return The model element without the unused parts.
+    private: std::string PruneModel(const std::string &_model) const;
+
+    /// \brief True if the filter outputs the whole state of the models
+    /// it selects.
+    /// \return True if there are no pose, link or joint filters.
+    private: bool Whole() const;
+
     /// \brief The list of model parts to filter.
     public: std::list<std::string> parts;
 
@@ -156,6 +261,13 @@ namespace gazebo
 
     /// \brief Pointer to the joint filter.
     public: JointFilter *jointFilter;
+
+    /// \brief True if the filter outputs all models.
+    private: bool all = true;
+
+    /// \brief Model names matched by the filter, if it doesn't output all
+    /// models.
+    private: boost::regex regex;
   };
 
   /// \brief Filter interface for an entire state.
@@ -165,8 +277,11 @@ namespace gazebo
     /// \param[in] _xmlOutput True to format output as XML
     /// \param[in] _stamp Type of stamp to apply.
     /// Valid values are (sim,real,wall)
+    /// \param[in] _hz Rate at which to output states, 0 for all states.
+    /// \param[in] _csv True to separate the values of each line of output
+    /// with commas. Only used without XML output.
     public: StateFilter(bool _xmlOutput, const std::string &_stamp,
-                double _hz = 0);
+                double _hz = 0, bool _csv = false);
 
     /// \brief Initialize the filter with a set of parameters.
     /// \param[_in] _filter The filter parameters
@@ -177,12 +292,45 @@ namespace gazebo
     /// \return Filtered string
     public: std::string Filter(const std::string &_stateString);
 
+    /// \brief Parse a state, leaving out the models, links and joints
+    /// that the filter doesn't output. This can be called from several
+    /// threads at once, each with its own _sdf element.
+    /// \param[in] _stateString The <sdf> frame of a state, in text or
+    /// binary format.
+    /// \param[in] _sdf State element used to parse text states.
+    /// \param[out] _state The parsed state.
+    public: void Load(const std::string &_stateString,
+                const sdf::ElementPtr &_sdf,
+                gazebo::physics::WorldState &_state) const;
+
+    /// \brief Format the filtered output of a state, whatever the output
+    /// rate. This can be called from several threads at once.
+    /// \param[in] _state The state.
+    /// \return Filtered string
+    public: std::string Format(gazebo::physics::WorldState &_state);
+
+    /// \brief Get the filtered values of a state, whatever the output
+    /// rate. This can be called from several threads at once.
+    /// \param[in] _state The state.
+    /// \param[out] _values The values.
+    public: void Values(const gazebo::physics::WorldState &_state,
+                StateValues &_values) const;
+
+    /// \brief Check the output rate for the next state. States have to
+    /// be checked in log order.
+    /// \param[in] _simTime Simulation time of the state.
+    /// \return True if the state should be output.
+    public: bool Admit(const gazebo::common::Time &_simTime);
+
     /// \brief Filter for a model.
     private: ModelFilter filter;
 
     /// \brief Rate at which to output states.
     private: double hz;
 
+    /// \brief True to output comma separated values.
+    private: bool csv;
+
     /// \brief Previous time a state was output.
     private: gazebo::common::Time prevTime;
   };
@@ -217,10 +365,37 @@ namespace gazebo
     /// \param[in] _encoding Specify output log file encoding. If empty, the
     /// encoding from the source log file is used.
     /// Valid values include (txt, zlib, bz2)
+    /// \param[in] _csv True to output comma separated values. Implies _raw.
+    /// \param[in] _threads Number of threads that filter states.
     private: void Output(const std::string &_outFilename,
                  const std::string &_filter, const bool _raw,
                  const std::string &_stamp, const double _hz,
-                 const std::string &_encoding = "");
+                 const std::string &_encoding = "", const bool _csv = false,
+                 const unsigned int _threads = 1);
+
+    /// \brief Export the filtered values of the states of a log file to a
+    /// file of columns, which can be memory-mapped. The file starts with a
+    /// text header:
+    ///
+    ///     gazebo_columns 1
+    ///     byte_order little
+    ///     rows <row count>
+    ///     <type> <offset> <name>
+    ///     ...
+    ///     end
+    ///
+    /// with a line for each column. The type is f64 or u64, and the offset
+    /// is the position in the file of the column's values, a multiple of 8.
+    /// The sim_time, real_time and wall_time columns hold seconds, and the
+    /// iterations column the iterations of each state. A value missing from
+    /// a state, such as the pose of a model that wasn't inserted yet, is NaN.
+    /// \param[in] _outFilename Output filename
+    /// \param[in] _filter Filter string
+    /// \param[in] _hz Hertz rate.
+    /// \param[in] _threads Number of threads that filter states.
+    private: void Columns(const std::string &_outFilename,
+                 const std::string &_filter, const double _hz,
+                 const unsigned int _threads);
 
     /// \brief Dump the contents of a log file to screen
     /// \param[in] _filter Filter string
@@ -228,8 +403,11 @@ namespace gazebo
     /// \param[in] _stamp Type of stamp to apply.
     /// Valid values are (sim,real,wall)
     /// \param[in] _hz Hertz rate.
+    /// \param[in] _csv True to output comma separated values. Implies _raw.
+    /// \param[in] _threads Number of threads that filter states.
     private: void Echo(const std::string &_filter,
-                 bool _raw, const std::string &_stamp, double _hz);
+                 bool _raw, const std::string &_stamp, double _hz,
+                 const bool _csv = false, const unsigned int _threads = 1);
 
     /// \brief Step through a log file.
     /// \param[in] _filter Filter string
@@ -237,8 +415,28 @@ namespace gazebo
     /// \param[in] _stamp Type of stamp to apply.
     /// Valid values are (sim,real,wall)
     /// \param[in] _hz Hertz rate.
+    /// \param[in] _csv True to output comma separated values. Implies _raw.
     private: void Step(const std::string &_filter, bool _raw,
-                 const std::string &_stamp, double _hz);
+                 const std::string &_stamp, double _hz,
+                 const bool _csv = false);
+
+    /// \brief Filter the frames of the open log file in log order. The
+    /// chunks of the log are decoded and filtered on several threads, while
+    /// the output rate is checked and the results are used on the calling
+    /// thread.
+    /// \param[in] _filter Filter of the states.
+    /// \param[in] _threads Number of threads that filter states.
+    /// \param[in] _cb Called with the index of each frame and its
+    /// filtered state, which is empty if the state isn't output. The first
+    /// frame, with the world's SDF, isn't filtered.
+    /// \param[in] _valuesCb If set, called instead of _cb with the values
+    /// of each state that is output, after the first frame.
+    private: void FilterFrames(StateFilter &_filter,
+                 const unsigned int _threads,
+                 const std::function<void(const unsigned int,
+                   const std::string &)> &_cb,
+                 const std::function<void(const StateValues &)> &_valuesCb =
+                   nullptr);
 
     /// \brief Start or stop logging
     /// \param[in] _start True to start logging
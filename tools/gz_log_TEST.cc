@@ -24,7 +24,13 @@
 #include <sdf/sdf_config.h>
 
 #include <stdio.h>
+#include <string.h>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <sstream>
 #include <string>
+#include <utility>
 
 // This header file isn't needed if shasums are used
 // #include "test/data/pr2_state_log_expected.h"
@@ -331,6 +337,93 @@ TEST(gz_log, RawFilterStamp)
   EXPECT_EQ(validEcho, echo);
 }
 
+/////////////////////////////////////////////////
+/// Check comma separated output
+TEST(gz_log, Csv)
+{
+  std::string echo = custom_exec(std::string(GZ_LOG_PATH +
+        " --echo --csv --stamp sim --filter pr2.pose.x -f ") +
+      PROJECT_SOURCE_PATH + "/test/data/pr2_state.log");
+  EXPECT_EQ("0.021344,0.000000\n0.028958,0.000000\n", echo);
+}
+
+/////////////////////////////////////////////////
+/// Check the columns export
+TEST(gz_log, Columns)
+{
+  std::ostringstream filename;
+  filename << "/tmp/__gz_log_columns" << std::this_thread::get_id();
+
+  custom_exec(std::string(GZ_LOG_PATH + " --columns ") + filename.str() +
+      " --filter pr2.pose.[x,z]/base_footprint.velocity.z -f " +
+      PROJECT_SOURCE_PATH + "/test/data/pr2_state.log");
+
+  std::ifstream file(filename.str(), std::ios::binary);
+  ASSERT_TRUE(file.good());
+  std::string data((std::istreambuf_iterator<char>(file)),
+      std::istreambuf_iterator<char>());
+
+  // Read the header
+  std::istringstream header(data);
+  std::string line;
+  std::getline(header, line);
+  EXPECT_EQ("gazebo_columns 1", line);
+  std::getline(header, line);
+  EXPECT_EQ(0u, line.find("byte_order "));
+  std::getline(header, line);
+  EXPECT_EQ("rows 2", line);
+
+  std::map<std::string, std::pair<std::string, size_t>> columns;
+  while (std::getline(header, line) && line != "end")
+  {
+    std::istringstream column(line);
+    std::string type, name;
+    size_t offset;
+    column >> type >> offset >> name;
+    EXPECT_EQ(0u, offset % 8);
+    EXPECT_LE(offset + 2 * 8, data.size());
+    columns[name] = std::make_pair(type, offset);
+  }
+  EXPECT_EQ("end", line);
+  ASSERT_EQ(7u, columns.size());
+
+  auto value = [&](const std::string &_name, const int _row)
+  {
+    double result;
+    memcpy(&result, data.data() + columns[_name].second + _row * 8, 8);
+    return result;
+  };
+
+  EXPECT_EQ("u64", columns["iterations"].first);
+  EXPECT_EQ("f64", columns["sim_time"].first);
+  EXPECT_NEAR(0.021343973, value("sim_time", 0), 1e-9);
+  EXPECT_NEAR(0.028958, value("sim_time", 1), 1e-6);
+  EXPECT_NEAR(0.001, value("real_time", 0), 1e-9);
+  EXPECT_NEAR(1360301758.939690376, value("wall_time", 0), 1e-6);
+  EXPECT_NEAR(0.0, value("pr2.pose.x", 0), 1e-6);
+  EXPECT_NEAR(-8e-06, value("pr2.pose.z", 0), 1e-9);
+  EXPECT_NEAR(-0.007966, value("pr2/base_footprint.velocity.z", 0), 1e-9);
+  EXPECT_TRUE(columns.find("pr2.pose.y") == columns.end());
+
+  std::remove(filename.str().c_str());
+}
+
+/////////////////////////////////////////////////
+/// Check that filtering on several threads doesn't change the output
+TEST(gz_log, Threads)
+{
+  for (auto const &filter : {"", " --filter pr2", " --filter pr2.pose",
+      " --filter pr2/r_upper*.pose", " --filter pr2//*", " -z 30"})
+  {
+    std::string cmd = std::string(GZ_LOG_PATH + " -e") + filter + " -f " +
+      PROJECT_SOURCE_PATH + "/test/data/pr2_state.log";
+
+    std::string echo = custom_exec(cmd + " --threads 1");
+    EXPECT_FALSE(echo.empty());
+    EXPECT_EQ(echo, custom_exec(cmd + " --threads 4")) << filter;
+  }
+}
+
 /////////////////////////////////////////////////
 /// Check to make sure that 'gz log -s' returns correct information
 TEST(gz_log, Step)
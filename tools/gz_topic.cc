@@ -52,11 +52,15 @@ TopicCommand::TopicCommand()
      "View topic data using a QT widget.")
     ("hz,z", po::value<std::string>(), "Get publish frequency.")
     ("bw,b", po::value<std::string>(), "Get topic bandwidth.")
+    ("stats,s", po::value<std::string>()->implicit_value(""),
+     "Print the transport counters of the server, for the topics and "
+     "connections whose name contains the value if given. The counters "
+     "are gathered by the server, without subscribing to the topics.")
     ("publish,p", po::value<std::string>(), "Publish message on a topic.")
     ("request,r", po::value<std::string>(), "Send a request.")
     ("unformatted,u", "Output data from echo without formatting.")
     ("duration,d", po::value<uint64_t>(), "Duration (seconds) to run. "
-     "Applicable with echo, hz, and bw")
+     "Applicable with echo, hz, bw and stats")
     ("msg,m", po::value<std::string>(), "Message to send on topic. "
      "Applicable with publish and request")
     ("file,f", po::value<std::string>(), "Path to a file containing the "
@@ -96,6 +100,8 @@ bool TopicCommand::RunImpl()
     this->Hz(this->vm["hz"].as<std::string>());
   else if (this->vm.count("bw"))
     this->Bw(this->vm["bw"].as<std::string>());
+  else if (this->vm.count("stats"))
+    this->Stats(this->vm["stats"].as<std::string>());
   else if (this->vm.count("view"))
     this->View(this->vm["view"].as<std::string>());
   else if (this->vm.count("publish"))
@@ -347,6 +353,59 @@ void TopicCommand::Bw(const std::string &_topic)
     this->sigCondition.wait(lock);
 }
 
+/////////////////////////////////////////////////
+void TopicCommand::StatsCB(ConstTransportStatsPtr &_msg)
+{
+  auto contains = [this](const std::string &_name)
+  {
+    return this->statsFilter.empty() ||
+        _name.find(this->statsFilter) != std::string::npos;
+  };
+
+  printf("%-40s %9s %10s %7s %8s %9s %9s %9s\n", "Topic", "Msg/s", "KB/s",
+      "Queued", "Dropped", "p50 ms", "p99 ms", "Max ms");
+  for (auto const &topic : _msg->topic())
+  {
+    if (!contains(topic.name()))
+      continue;
+    printf("%-40s %9.1f %10.1f %7u %8lu %9.3f %9.3f %9.3f\n",
+        topic.name().c_str(), topic.message_rate(),
+        topic.byte_rate() / 1024.0, topic.queued(),
+        static_cast<unsigned long>(topic.dropped()),
+        topic.latency_p50() * 1e3, topic.latency_p99() * 1e3,
+        topic.latency_max() * 1e3);
+  }
+
+  printf("\n%-40s %9s %10s %7s %8s %9s %9s %9s\n", "Connection", "Msg/s",
+      "KB/s", "Queued", "Max", "p50 ms", "p99 ms", "Max ms");
+  for (auto const &conn : _msg->connection())
+  {
+    if (!contains(conn.remote_uri()))
+      continue;
+    printf("%-40s %9.1f %10.1f %7u %8u %9.3f %9.3f %9.3f\n",
+        conn.remote_uri().c_str(), conn.message_rate(),
+        conn.byte_rate() / 1024.0, conn.queued(), conn.max_queued(),
+        conn.latency_p50() * 1e3, conn.latency_p99() * 1e3,
+        conn.latency_max() * 1e3);
+  }
+  printf("\n");
+}
+
+/////////////////////////////////////////////////
+void TopicCommand::Stats(const std::string &_filter)
+{
+  this->statsFilter = _filter;
+  transport::SubscriberPtr sub = this->node->Subscribe("~/transport/stats",
+      &TopicCommand::StatsCB, this);
+
+  boost::mutex::scoped_lock lock(this->sigMutex);
+  if (this->vm.count("duration"))
+    this->sigCondition.timed_wait(lock,
+        boost::posix_time::seconds(this->vm["duration"].as<uint64_t>()));
+  else
+    this->sigCondition.wait(lock);
+}
+
 /////////////////////////////////////////////////
 void TopicCommand::View(const std::string &_topic)
 {
@@ -103,6 +103,18 @@ namespace gazebo
 
     /// \brief Buffer of message publish times, used by Bw().
     private: std::vector<common::Time> bwTime;
+
+    /// \brief Print the transport counters of the server.
+    /// \param[in] _filter Only the topics and connections whose name
+    /// contains it are printed, all if empty.
+    private: void Stats(const std::string &_filter);
+
+    /// \brief Callback of the transport counters, used by Stats().
+    /// \param[in] _msg The counters.
+    private: void StatsCB(ConstTransportStatsPtr &_msg);
+
+    /// \brief Filter of Stats().
+    private: std::string statsFilter;
   };
 }
 #endif